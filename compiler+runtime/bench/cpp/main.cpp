@@ -0,0 +1,550 @@
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <regex>
+#include <sstream>
+#include <thread>
+
+#include <gc/gc.h>
+#include <nanobench.h>
+
+#include <jank/c_api.h>
+#include <jank/read/lex.hpp>
+#include <jank/read/parse.hpp>
+#include <jank/analyze/arena.hpp>
+#include <jank/analyze/processor.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/seq.hpp>
+#include <jank/runtime/behavior/callable.hpp>
+#include <jank/runtime/executor.hpp>
+#include <jank/runtime/obj/big_integer.hpp>
+#include <jank/runtime/obj/multi_function.hpp>
+#include <jank/runtime/obj/persistent_array_map.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
+#include <jank/runtime/obj/persistent_vector.hpp>
+#include <jank/runtime/regex.hpp>
+#include <jank/runtime/var.hpp>
+#include <jank/util/cli.hpp>
+#include <jank/util/fmt/print.hpp>
+#include <jank/util/scope_exit.hpp>
+#include <jtl/string_builder.hpp>
+#include <jank/perf_native.hpp>
+#include <jank/math_native.hpp>
+#include <jank/columnar_native.hpp>
+#include <jank/async_native.hpp>
+#include <jank/cache_native.hpp>
+#include <jank/binary_native.hpp>
+#include <jank/mapped_native.hpp>
+#include <jank/reload_native.hpp>
+#include <jank/io_async_native.hpp>
+#include <clojure/core_native.hpp>
+
+#ifdef JANK_PHASE_2
+extern "C" void jank_load_clojure_core();
+#endif
+
+/* A standing suite of the runtime's hot paths. Each run prints nanobench's table to
+ * stderr and writes the results as JSON, either to stdout or to the path given as the
+ * first arg, so runs across jank versions can be compared. */
+namespace jank::bench
+{
+  using namespace jank::runtime;
+
+  static object_ref core_fn(char const * const name)
+  {
+    return __rt_ctx->find_var("clojure.core", name)->deref();
+  }
+
+  static jtl::immutable_string slurp(char const * const path)
+  {
+    std::ifstream const in{ path };
+    if(!in)
+    {
+      throw std::runtime_error{ util::format("Unable to read {}", path) };
+    }
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+  }
+
+  static void allocation(ankerl::nanobench::Bench &bench)
+  {
+    i64 n{};
+    bench.run("make_box integer", [&] { ankerl::nanobench::doNotOptimizeAway(make_box(++n)); });
+    bench.run("make_box real", [&] {
+      ankerl::nanobench::doNotOptimizeAway(make_box(static_cast<f64>(++n)));
+    });
+    bench.run("make_box string", [&] { ankerl::nanobench::doNotOptimizeAway(make_box("jank")); });
+  }
+
+  static void calls(ankerl::nanobench::Bench &bench)
+  {
+    auto const fn{
+      __rt_ctx->eval_string("(fn* ([] nil) ([a] a) ([a b] b) ([a b c] c) ([a b c d] d))").unwrap()
+    };
+    auto const a{ make_box(1) };
+
+    bench.run("dynamic_call arity 0", [&] {
+      ankerl::nanobench::doNotOptimizeAway(dynamic_call(fn));
+    });
+    bench.run("dynamic_call arity 1", [&] {
+      ankerl::nanobench::doNotOptimizeAway(dynamic_call(fn, a));
+    });
+    bench.run("dynamic_call arity 2", [&] {
+      ankerl::nanobench::doNotOptimizeAway(dynamic_call(fn, a, a));
+    });
+    bench.run("dynamic_call arity 3", [&] {
+      ankerl::nanobench::doNotOptimizeAway(dynamic_call(fn, a, a, a));
+    });
+    bench.run("dynamic_call arity 4", [&] {
+      ankerl::nanobench::doNotOptimizeAway(dynamic_call(fn, a, a, a, a));
+    });
+
+    auto const v{ __rt_ctx->find_var("clojure.core", "*ns*") };
+    bench.run("var deref", [&] { ankerl::nanobench::doNotOptimizeAway(v->deref()); });
+
+    /* The first intern creates the keyword, so this measures the lookup of an existing one. */
+    bench.run("keyword intern", [&] {
+      ankerl::nanobench::doNotOptimizeAway(__rt_ctx->intern_keyword("bench-keyword").expect_ok());
+    });
+  }
+
+  static void collections(ankerl::nanobench::Bench &bench)
+  {
+    object_ref array_map{ obj::persistent_array_map::empty() };
+    for(i64 i{}; i < 4; ++i)
+    {
+      array_map = assoc(array_map, make_box(i), make_box(i));
+    }
+    object_ref hash_map{ obj::persistent_hash_map::empty() };
+    for(i64 i{}; i < 64; ++i)
+    {
+      hash_map = assoc(hash_map, make_box(i), make_box(i));
+    }
+    object_ref vector{ obj::persistent_vector::empty() };
+    for(i64 i{}; i < 64; ++i)
+    {
+      vector = conj(vector, make_box(i));
+    }
+    auto const key{ make_box(3) }, val{ make_box(-1) }, idx{ make_box(33) };
+
+    bench.run("array map get", [&] { ankerl::nanobench::doNotOptimizeAway(get(array_map, key)); });
+    bench.run("array map assoc", [&] {
+      ankerl::nanobench::doNotOptimizeAway(assoc(array_map, key, val));
+    });
+    bench.run("hash map get", [&] { ankerl::nanobench::doNotOptimizeAway(get(hash_map, key)); });
+    bench.run("hash map assoc", [&] {
+      ankerl::nanobench::doNotOptimizeAway(assoc(hash_map, key, val));
+    });
+    bench.run("vector conj", [&] { ankerl::nanobench::doNotOptimizeAway(conj(vector, val)); });
+    bench.run("vector nth", [&] { ankerl::nanobench::doNotOptimizeAway(nth(vector, idx)); });
+  }
+
+  /* Keyword keys, at each size an array map can reach, compared with a hash map of the
+   * same keys. This is useful when choosing a different jank_array_map_max_size. */
+  static void array_map_sizes(ankerl::nanobench::Bench &bench)
+  {
+    for(usize const size : { 2, 4, 8, 16, 32 })
+    {
+      if(obj::persistent_array_map::max_size < size)
+      {
+        break;
+      }
+
+      object_ref array_map{ obj::persistent_array_map::empty() };
+      object_ref hash_map{ obj::persistent_hash_map::empty() };
+      native_vector<object_ref> keys;
+      for(usize i{}; i < size; ++i)
+      {
+        auto const name{ util::format("k{}", i) };
+        auto const k{ __rt_ctx->intern_keyword("jank.bench", name, true).expect_ok() };
+        keys.emplace_back(k);
+        array_map = assoc(array_map, k, make_box(i));
+        hash_map = assoc(hash_map, k, make_box(i));
+      }
+      auto const last{ keys.back() }, val{ make_box(0) };
+
+      auto const label([=](char const * const op) {
+        return static_cast<std::string>(util::format("{} with {} keyword keys", op, size));
+      });
+      bench.run(label("array map get"),
+                [&] { ankerl::nanobench::doNotOptimizeAway(get(array_map, last)); });
+      bench.run(label("hash map get"),
+                [&] { ankerl::nanobench::doNotOptimizeAway(get(hash_map, last)); });
+      bench.run(label("array map assoc"),
+                [&] { ankerl::nanobench::doNotOptimizeAway(assoc(array_map, last, val)); });
+      bench.run(label("hash map assoc"),
+                [&] { ankerl::nanobench::doNotOptimizeAway(assoc(hash_map, last, val)); });
+    }
+  }
+
+  /* Big integer math, both on values which fit in an i64 and on ones which don't. */
+  static void big_integers(ankerl::nanobench::Bench &bench)
+  {
+    for(auto const &[size, value] :
+        { std::make_pair("small", make_box<obj::big_integer>(i64{ 123456789 })),
+          std::make_pair("large",
+                         make_box<obj::big_integer>(
+                           jtl::immutable_string{ "123456789012345678901234567890123456789" })) })
+    {
+      object_ref const l{ value }, r{ make_box<obj::big_integer>(value->data) };
+      object_ref const i{ make_box(42) };
+
+      auto const label([=](char const * const op) {
+        return static_cast<std::string>(util::format("{} big integer {}", size, op));
+      });
+      bench.run(label("add"), [&] { ankerl::nanobench::doNotOptimizeAway(add(l, r)); });
+      bench.run(label("add integer"), [&] { ankerl::nanobench::doNotOptimizeAway(add(l, i)); });
+      bench.run(label("mul"), [&] { ankerl::nanobench::doNotOptimizeAway(mul(l, r)); });
+      bench.run(label("lt"), [&] { ankerl::nanobench::doNotOptimizeAway(lt(l, r)); });
+      bench.run(label("to_real"), [&] { ankerl::nanobench::doNotOptimizeAway(value->to_real()); });
+      bench.run(label("to_hash"), [&] { ankerl::nanobench::doNotOptimizeAway(value->to_hash()); });
+    }
+  }
+
+  static void sequences(ankerl::nanobench::Bench &bench)
+  {
+    auto const plus{ core_fn("+") };
+    auto const range{ dynamic_call(core_fn("range"), make_box(1000)) };
+    auto const zero{ make_box(0) };
+    bench.run("reduce + over (range 1000)", [&] {
+      ankerl::nanobench::doNotOptimizeAway(reduce(plus, zero, range));
+    });
+
+    auto const str{ core_fn("str") };
+    auto const pr_str{ core_fn("pr-str") };
+    auto const s{ make_box("jank") }, n{ make_box(42) };
+    auto const m{ __rt_ctx->read_string("{:a [1 2.0 \"three\"] :b #{:c} :d nil}") };
+    bench.run("str", [&] { ankerl::nanobench::doNotOptimizeAway(dynamic_call(str, s, n, s)); });
+    bench.run("pr-str", [&] { ankerl::nanobench::doNotOptimizeAway(dynamic_call(pr_str, m)); });
+  }
+
+  /* Readers of a var's root shouldn't slow each other down, nor be held up much by a
+   * writer. */
+  static void var_contention(ankerl::nanobench::Bench &bench)
+  {
+    auto const v{ __rt_ctx->intern_var("jank.bench", "contention").expect_ok() };
+    v->bind_root(make_box(0));
+
+    for(auto const thread_count : { 1, 4 })
+    {
+      std::atomic_bool done{};
+      std::vector<std::thread> threads;
+      for(auto i{ 0 }; i < thread_count; ++i)
+      {
+        threads.emplace_back([&] {
+          while(!done.load(std::memory_order_relaxed))
+          {
+            ankerl::nanobench::doNotOptimizeAway(v->deref());
+          }
+        });
+      }
+
+      bench.run(static_cast<std::string>(
+                  util::format("var deref with {} other readers", thread_count)),
+                [&] { ankerl::nanobench::doNotOptimizeAway(v->deref()); });
+
+      done.store(true);
+      for(auto &t : threads)
+      {
+        t.join();
+      }
+    }
+
+    /* The writer thread isn't registered with the GC, so it must not allocate. */
+    native_vector<object_ref> const roots{ make_box(1), make_box(2), make_box(3) };
+    std::atomic_bool done{};
+    std::thread writer{ [&] {
+      usize i{};
+      while(!done.load(std::memory_order_relaxed))
+      {
+        v->bind_root(roots[++i % roots.size()]);
+      }
+    } };
+
+    bench.run("var deref with a concurrent writer",
+              [&] { ankerl::nanobench::doNotOptimizeAway(v->deref()); });
+
+    done.store(true);
+    writer.join();
+  }
+
+  /* Multimethod dispatch, alone and while other threads dispatch on the same one. */
+  static void multimethod_dispatch(ankerl::nanobench::Bench &bench)
+  {
+    auto const mm{ expect_object<obj::multi_function>(
+      deref(__rt_ctx
+              ->eval_string(R"((do
+                                 (defmulti jank-bench-mm :type)
+                                 (defmethod jank-bench-mm :a [m] 1)
+                                 (defmethod jank-bench-mm :b [m] 2)
+                                 #'jank-bench-mm))")
+              .unwrap())) };
+    auto const arg{ __rt_ctx->eval_string("{:type :a}").unwrap() };
+
+    bench.run("multimethod dispatch", [&] { ankerl::nanobench::doNotOptimizeAway(mm->call(arg)); });
+
+    GC_allow_register_threads();
+    for(auto const thread_count : { 1, 4 })
+    {
+      std::atomic_bool done{};
+      std::vector<std::thread> threads;
+      for(auto i{ 0 }; i < thread_count; ++i)
+      {
+        threads.emplace_back([&] {
+          gc_thread_scope const scope;
+          while(!done.load(std::memory_order_relaxed))
+          {
+            ankerl::nanobench::doNotOptimizeAway(mm->call(arg));
+          }
+        });
+      }
+
+      bench.run(static_cast<std::string>(
+                  util::format("multimethod dispatch with {} other callers", thread_count)),
+                [&] { ankerl::nanobench::doNotOptimizeAway(mm->call(arg)); });
+
+      done.store(true);
+      for(auto &t : threads)
+      {
+        t.join();
+      }
+    }
+  }
+
+  static void analyze_form(object_ref const form)
+  {
+    analyze::node_arena const nodes;
+    util::scope_exit const forget_nodes{ [&] { analyze::processor::forget_nodes(nodes); } };
+    analyze::processor an_prc;
+    ankerl::nanobench::doNotOptimizeAway(
+      an_prc.analyze(form, analyze::expression_position::statement).expect_ok().data);
+  }
+
+  static void analysis(ankerl::nanobench::Bench &bench)
+  {
+    /* Each value refers to the binding before it, as well as to a var, which is looked
+     * for as a local first. */
+    jtl::string_builder flat;
+    flat("(let* [x0 0");
+    for(usize i{ 1 }; i < 5'000; ++i)
+    {
+      flat(" x")(i)(" (inc x")(i - 1)(')');
+    }
+    flat("] x4999)");
+
+    /* This is what the likes of threading macros and `for` expand into, where the
+     * nesting depth, rather than the binding count, is what grows. */
+    jtl::string_builder nested;
+    nested("(let* [y0 (inc 0)] ");
+    for(usize i{ 1 }; i < 1'000; ++i)
+    {
+      nested("(let* [y")(i)(" (inc y")(i - 1)(")] ");
+    }
+    nested("y0");
+    for(usize i{}; i < 1'000; ++i)
+    {
+      nested(')');
+    }
+
+    auto const flat_form{ __rt_ctx->read_string(flat.release()) };
+    auto const nested_form{ __rt_ctx->read_string(nested.release()) };
+
+    bench.minEpochIterations(1).warmup(1);
+    bench.run("analyze let with 5,000 bindings", [&] { analyze_form(flat_form); });
+    bench.run("analyze 1,000 nested lets", [&] { analyze_form(nested_form); });
+  }
+
+  /* A typical REPL form, with each backend. Every eval compiles a new fn, so this is the
+   * time from analysis to having something callable. */
+  static void codegen_latency(ankerl::nanobench::Bench &bench)
+  {
+    auto const old_codegen{ util::cli::opts.codegen };
+    util::scope_exit const finally{ [=] { util::cli::opts.codegen = old_codegen; } };
+
+    auto const form{ "((fn* [a b] (let* [c (+ a b)] (if (< c 10) [a b c] {:a a :c c}))) 1 2)" };
+
+    util::cli::opts.codegen = util::cli::codegen_type::llvm_ir;
+    bench.run("eval a new fn with llvm-ir codegen",
+              [&] { ankerl::nanobench::doNotOptimizeAway(__rt_ctx->eval_string(form)); });
+
+    util::cli::opts.codegen = util::cli::codegen_type::cpp;
+    bench.run("eval a new fn with cpp codegen",
+              [&] { ankerl::nanobench::doNotOptimizeAway(__rt_ctx->eval_string(form)); });
+  }
+
+  static void reading(ankerl::nanobench::Bench &bench)
+  {
+    auto const source{ slurp(JANK_BENCH_CORE_PATH) };
+
+    /* These are measured per byte, so they give throughput. */
+    bench.unit("byte").batch(source.size()).minEpochIterations(1).warmup(1);
+    bench.run("lex clojure/core.jank", [&] {
+      usize tokens{};
+      read::lex::processor l_prc{ source };
+      for(auto const &token : l_prc)
+      {
+        ankerl::nanobench::doNotOptimizeAway(token);
+        ++tokens;
+      }
+      ankerl::nanobench::doNotOptimizeAway(tokens);
+    });
+    bench.run("parse clojure/core.jank", [&] {
+      read::lex::processor l_prc{ source };
+      read::parse::processor p_prc{ l_prc.begin(), l_prc.end() };
+      for(auto const &form : p_prc)
+      {
+        ankerl::nanobench::doNotOptimizeAway(form.expect_ok().ptr);
+      }
+    });
+
+    /* Long comments and strings, with escapes and non-ASCII characters, which are what the
+     * lexer's block scanning speeds up. */
+    jtl::string_builder sb;
+    for(usize i{}; i < 1'000; ++i)
+    {
+      sb(";; A comment which goes on for a while, like a doc comment would.\n");
+      sb("(defn some-fn-name [first-arg second-arg] (str \"a string which is ");
+      sb("about as long as a docstring, with an escape \\n and ሴ 你好 in it\" ");
+      sb(":some.ns/keyword first-arg))\n");
+    }
+    auto const mixed{ sb.release() };
+
+    bench.batch(mixed.size());
+    bench.run("lex mixed source", [&] {
+      usize tokens{};
+      read::lex::processor l_prc{ mixed };
+      for(auto const &token : l_prc)
+      {
+        ankerl::nanobench::doNotOptimizeAway(token);
+        ++tokens;
+      }
+      ankerl::nanobench::doNotOptimizeAway(tokens);
+    });
+  }
+
+  /* Finding every match in a log, with jank's regex engine and with std::regex. These are
+   * measured per byte, like reading. */
+  static void regexes(ankerl::nanobench::Bench &bench)
+  {
+    jtl::string_builder sb;
+    for(usize i{}; i < 1'000; ++i)
+    {
+      sb("2024-03-14 12:00:");
+      sb(i % 60);
+      sb(" INFO [worker-");
+      sb(i % 8);
+      sb("] handled request id=");
+      sb(i);
+      sb(" status=200 in 14ms\n");
+    }
+    auto const log{ sb.release() };
+    auto const pattern{ "id=(\\d+) status=(\\d+)" };
+
+    bench.batch(log.size());
+
+    auto const compiled(regex::compile(pattern));
+    if(compiled.is_err())
+    {
+      throw std::runtime_error{
+        util::format("Unable to compile {}: {}", pattern, compiled.expect_err()) };
+    }
+    auto const &p(*compiled.expect_ok());
+    auto const backend(regex::backend_name());
+    bench.run(static_cast<std::string>(util::format("regex search with {}", backend)), [&] {
+      native_vector<regex::span> groups;
+      usize count{};
+      usize start{};
+      while(regex::search(p, log, start, regex::anchor::none, groups))
+      {
+        start = groups[0].offset + groups[0].size;
+        ++count;
+      }
+      ankerl::nanobench::doNotOptimizeAway(count);
+    });
+
+    std::regex const re{ pattern };
+    bench.run("regex search with std::regex_search", [&] {
+      std::cmatch match;
+      usize count{};
+      auto it(log.data());
+      while(std::regex_search(it, log.data() + log.size(), match, re))
+      {
+        it = match[0].second;
+        ++count;
+      }
+      ankerl::nanobench::doNotOptimizeAway(count);
+    });
+  }
+
+  static int run(int const argc, char const **argv)
+  {
+    ankerl::nanobench::Bench bench;
+    bench.title("jank runtime").output(&std::cerr).warmup(100).minEpochIterations(1000);
+
+    allocation(bench);
+    calls(bench);
+    collections(bench);
+    array_map_sizes(bench);
+    big_integers(bench);
+    sequences(bench);
+    var_contention(bench);
+    multimethod_dispatch(bench);
+    analysis(bench);
+    codegen_latency(bench);
+    reading(bench);
+    regexes(bench);
+
+    if(argc < 2)
+    {
+      ankerl::nanobench::render(ankerl::nanobench::templates::json(), bench, std::cout);
+      return 0;
+    }
+
+    std::ofstream out{ argv[1] };
+    if(!out)
+    {
+      util::println(stderr, "Unable to write {}", argv[1]);
+      return 1;
+    }
+    ankerl::nanobench::render(ankerl::nanobench::templates::json(), bench, out);
+    return 0;
+  }
+}
+
+/* NOLINTNEXTLINE(bugprone-exception-escape): println can throw. */
+int main(int const argc, char const **argv)
+try
+{
+  return jank_init(argc, argv, /*init_default_ctx=*/true, [](int const argc, char const **argv) {
+    jank_load_clojure_core_native();
+    jank_load_jank_perf_native();
+    jank_load_jank_math_native();
+    jank_load_jank_columnar_native();
+    jank_load_jank_async_native();
+    jank_load_jank_cache_native();
+    jank_load_jank_binary_native();
+    jank_load_jank_mapped_native();
+    jank_load_jank_reload_native();
+    jank_load_jank_io_async_native();
+
+#ifdef JANK_PHASE_2
+    jank_load_clojure_core();
+    jank::runtime::__rt_ctx->module_loader.set_is_loaded("/clojure.core");
+#else
+    jank::runtime::__rt_ctx->load_module("/clojure.core", jank::runtime::module::origin::latest)
+      .expect_ok();
+#endif
+
+    return jank::bench::run(argc, argv);
+  });
+}
+/* Most exceptions are being caught in `jank_init`.
+ * This piece here catches rest of them. */
+catch(...)
+{
+  jank::util::println("Unknown exception thrown");
+  return 1;
+}
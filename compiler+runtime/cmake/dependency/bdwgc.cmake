@@ -21,6 +21,10 @@ set(CMAKE_CXX_CLANG_TIDY_OLD ${CMAKE_CXX_CLANG_TIDY})
   set(build_cord OFF CACHE BOOL "Build cord")
   set(enable_docs OFF CACHE BOOL "Enable docs")
   set(enable_threads ON CACHE BOOL "Enable multi-threading support")
+  # Each registered thread allocates from its own free lists, so allocation heavy threads
+  # don't contend on the allocator lock, and collections mark with every core.
+  set(enable_thread_local_alloc ON CACHE BOOL "Turn on thread-local allocation optimization")
+  set(enable_parallel_mark ON CACHE BOOL "Parallelize marking and free list construction")
   set(enable_large_config ON CACHE BOOL "Optimize for large heap or root set")
   set(enable_throw_bad_alloc_library ON CACHE BOOL "Enable C++ gctba library build")
   set(enable_gc_debug OFF CACHE BOOL "Support for pointer back-tracing")
@@ -44,6 +48,8 @@ set(CMAKE_CXX_CLANG_TIDY_OLD ${CMAKE_CXX_CLANG_TIDY})
   unset(build_cord)
   unset(enable_docs)
   unset(enable_threads)
+  unset(enable_thread_local_alloc)
+  unset(enable_parallel_mark)
   unset(enable_large_config)
   unset(enable_throw_bad_alloc_library)
   unset(enable_valgrind_tracking)
@@ -30,9 +30,12 @@ namespace clojure::core_native
   object_ref ns_map(object_ref const ns);
   object_ref var_ns(object_ref const v);
   object_ref ns_resolve(object_ref const ns, object_ref const sym);
+  object_ref completions(object_ref const ns, object_ref const prefix, object_ref const max);
   object_ref alias(object_ref const current_ns, object_ref const remote_ns, object_ref const alias);
   object_ref refer(object_ref const current_ns, object_ref const sym, object_ref const var);
   object_ref load_module(object_ref const path);
+  object_ref
+  defer_segment(object_ref const current_ns, object_ref const module, object_ref const syms);
   object_ref compile(object_ref const path);
 
   object_ref not_(object_ref const o);
@@ -54,11 +57,35 @@ namespace clojure::core_native
   object_ref get_method(object_ref const multifn, object_ref const dispatch_val);
   object_ref prefers(object_ref const multifn);
 
+  object_ref is_protocol(object_ref const o);
+  object_ref protocol(object_ref const name, object_ref const method_names);
+  object_ref protocol_method(object_ref const protocol, object_ref const name);
+  object_ref extend(object_ref const protocol, object_ref const type, object_ref const impls);
+  object_ref extends(object_ref const protocol, object_ref const type);
+  object_ref satisfies(object_ref const protocol, object_ref const o);
+
   object_ref sleep(object_ref const ms);
   object_ref current_time();
 
   object_ref eval(object_ref const expr);
   object_ref read_string(object_ref const /* opts */, object_ref const str);
+  object_ref read_data(object_ref const str);
+  object_ref read_all_data(object_ref const str);
+  object_ref stream_reader(object_ref const source);
+  object_ref close_stream_reader(object_ref const reader);
+  object_ref
+  read_stream(object_ref const reader, object_ref const eof_error, object_ref const eof_value);
+  object_ref load_reader(object_ref const reader);
+
+  object_ref slurp(object_ref const f);
+  object_ref spit(object_ref const f, object_ref const content, object_ref const append);
+  object_ref reader(object_ref const f, object_ref const buffer_size);
+  object_ref writer(object_ref const f, object_ref const append, object_ref const buffer_size);
+  object_ref read_line(object_ref const reader);
+  object_ref read_lines(object_ref const reader, object_ref const max);
+  object_ref write(object_ref const writer, object_ref const s);
+  object_ref flush_writer(object_ref const writer);
+  object_ref close(object_ref const o);
 
   object_ref lazy_seq(object_ref const o);
 
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <jank/runtime/object.hpp>
+
+namespace clojure::set_native
+{
+  using namespace jank;
+  using namespace jank::runtime;
+
+  /* These only handle two hash sets, and give nil for anything else, so clojure.set can
+   * fall back to its generic versions. Where the sets share structure, such as when one
+   * was made from the other, only the parts which differ are walked. */
+  object_ref union_(object_ref const l, object_ref const r);
+  object_ref intersection(object_ref const l, object_ref const r);
+  object_ref difference(object_ref const l, object_ref const r);
+}
@@ -14,6 +14,7 @@ namespace clojure::string_native
   object_ref ends_with(object_ref const s, object_ref const substr);
   object_ref includes(object_ref const s, object_ref const substr);
   object_ref upper_case(object_ref const s);
+  object_ref replace(object_ref const s, object_ref const match, object_ref const replacement);
   object_ref
   replace_first(object_ref const s, object_ref const match, object_ref const replacement);
 
@@ -27,4 +28,5 @@ namespace clojure::string_native
 
   object_ref split(object_ref const s, object_ref const re);
   object_ref split(object_ref const s, object_ref const re, object_ref const limit);
+  object_ref split_lines(object_ref const s);
 }
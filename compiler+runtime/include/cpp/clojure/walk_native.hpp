@@ -0,0 +1,18 @@
+#pragma once
+
+#include <jank/runtime/object.hpp>
+
+namespace clojure::walk_native
+{
+  using namespace jank;
+  using namespace jank::runtime;
+
+  /* Applies inner to each element of a vector, map, or set, building up a collection of
+   * the same type, with the same meta. When inner gives back every element as is, the
+   * form itself is given back, and a vector or map with only some elements changed is
+   * updated in place through a transient, so the unchanged parts keep being shared.
+   *
+   * This gives nil for any other form, so clojure.walk can fall back to its generic
+   * version. */
+  object_ref walk_coll(object_ref const inner, object_ref const form);
+}
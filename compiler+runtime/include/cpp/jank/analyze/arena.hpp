@@ -0,0 +1,49 @@
+#pragma once
+
+#include <jank/type.hpp>
+
+namespace jank::analyze
+{
+  /* Expressions and local frames are garbage as soon as their module has been emitted, but
+   * left to the GC, a big module fills the heap with them and triggers collections partway
+   * through compiling it. While one of these is active on a thread, new expressions and
+   * frames are bump allocated from its chunks instead, and the chunks are all freed at
+   * once when it goes out of scope.
+   *
+   * That's only safe when nothing can hold onto the tree past the scope, which rules out
+   * anything we evaluate, since interpreted fns keep their AST. It's meant for compiling
+   * modules, where the tree only lives until the module has been written. Runtime objects
+   * made during analysis, like constants, still come from the GC, since they outlive the
+   * tree. */
+  struct node_arena
+  {
+    static constexpr usize chunk_size{ 256 * 1024 };
+
+    node_arena();
+    node_arena(node_arena const &) = delete;
+    node_arena(node_arena &&) = delete;
+    ~node_arena();
+
+    node_arena &operator=(node_arena const &) = delete;
+    node_arena &operator=(node_arena &&) = delete;
+
+    [[gnu::returns_nonnull]]
+    void *allocate(usize size);
+
+    /* Whether the pointer is into one of this arena's chunks. */
+    bool owns(void const *p) const;
+
+    static node_arena *current();
+
+    /* The chunks are GC memory, which needs to be scanned, since nodes point at runtime
+     * objects and at other GC memory. */
+    native_vector<char *> chunks;
+    char *next{};
+    usize remaining{};
+    node_arena *previous{};
+  };
+
+  /* The allocation used by expressions and local frames, through their operator new. */
+  [[gnu::returns_nonnull]]
+  void *allocate_node(usize size);
+}
@@ -52,6 +52,8 @@ namespace jank::analyze::cpp_util
   bool is_member_function(jtl::ptr<void> scope);
   bool is_non_static_member_function(jtl::ptr<void> scope);
   bool is_nullptr(jtl::ptr<void> type);
+  /* Whether this is a native bool, ignoring any reference and cv qualifiers. */
+  bool is_bool(jtl::ptr<void> type);
   bool is_implicitly_convertible(jtl::ptr<void> from, jtl::ptr<void> to);
 
   jtl::ptr<void> untyped_object_ptr_type();
@@ -31,5 +31,14 @@ namespace jank::analyze::expr
     /* We keep the original form from the call expression so we can point
      * back to it if an exception is thrown during eval. */
     runtime::obj::persistent_list_ref form{};
+    /* When direct linking is enabled and the source is a static var holding a fn which
+     * takes this call with a fixed arity, codegen can call that fn directly. */
+    bool is_direct_linked{};
+    /* When the source is a static var holding a protocol method, codegen can give the call
+     * its own inline cache. */
+    bool is_protocol_call{};
+    /* When this is (:k m) with a keyword literal, or (m :k) on a local, with an optional
+     * fallback, codegen can give the lookup its own inline cache. */
+    bool is_keyword_lookup{};
   };
 }
@@ -26,6 +26,9 @@ namespace jank::analyze::expr
     runtime::object_ref to_runtime_data() const override;
     void walk(std::function<void(jtl::ref<expression>)> const &f) override;
 
+    /* A key which none of the branches use, for values which can't match any of them. */
+    i64 unused_key() const;
+
     expression_ref value_expr;
     i64 shift{};
     i64 mask{};
@@ -33,5 +36,9 @@ namespace jank::analyze::expr
     /* TODO: Should be uhash, I think. */
     native_vector<i64> keys{};
     native_vector<expression_ref> exprs{};
+    /* Set when the case* form has a :test-type of :int in its meta. Every key is then an
+     * exact integer, with no shift or mask, and the branches don't check the value again,
+     * so only integer values may match. Codegen can then switch on the value itself. */
+    bool is_int_test{};
   };
 }
@@ -14,7 +14,8 @@ namespace jank::analyze::expr
             local_frame_ptr frame,
             bool needs_box,
             jtl::ptr<void> type,
-            expression_ref value_expr);
+            expression_ref value_expr,
+            bool scoped);
 
     void propagate_position(expression_position const pos) override;
     runtime::object_ref to_runtime_data() const override;
@@ -22,5 +23,8 @@ namespace jank::analyze::expr
 
     jtl::ptr<void> type{};
     expression_ref value_expr;
+    /* Scoped objects are always deleted explicitly, such as by with-native, so they're not
+     * registered with the GC for finalization. */
+    bool scoped{};
   };
 }
@@ -3,6 +3,7 @@
 #include <jank/runtime/obj/symbol.hpp>
 #include <jank/runtime/obj/persistent_hash_map.hpp>
 #include <jank/analyze/expr/do.hpp>
+#include <jank/read/source.hpp>
 
 namespace jank::analyze
 {
@@ -27,6 +28,14 @@ namespace jank::analyze::expr
     /* Is there any named recrusion within this function (tail or otherwise)?
      * This counts any named recursion reference, not just calls. */
     bool is_named_recursive{};
+    /* Does any recur or named recursion jump back into this arity from tail position? */
+    bool has_self_tail_call{};
+    /* Does every value this arity returns come out as a number? Set by the numeric_arities
+     * pass, so calls to this arity can skip boxing, as with :unboxed-output? meta. */
+    bool is_numeric{};
+    /* Do the rest args of this variadic arity, and every seq made from them, stay within
+     * each call? Set by the local_rest_args pass, so callers can pack them on the stack. */
+    bool has_local_rest{};
     /* TODO: is_pure */
   };
 
@@ -75,6 +84,11 @@ namespace jank::analyze::expr
     jtl::immutable_string unique_name;
     native_vector<function_arity> arities;
     runtime::obj::persistent_hash_map_ref meta{};
+    /* Where the fn form was read from, for debug info. */
+    read::source source{ read::source::unknown() };
+    /* Set by escape analysis when this fn can't outlive the fn which creates it. Codegen
+     * can then put its closure context on the stack, rather than allocating it. */
+    bool has_stack_context{};
   };
 }
 
@@ -28,5 +28,8 @@ namespace jank::analyze::expr
     recursion_reference recursion_ref;
     runtime::obj::persistent_list_ref args{};
     native_vector<expression_ref> arg_exprs;
+    /* Set by the self_tail_calls pass when this can jump back into the current arity,
+     * rather than making a new call. */
+    bool is_self_tail_call{};
   };
 }
@@ -36,5 +36,8 @@ namespace jank::analyze::expr
     /* If this recur is targeting a loop*, we'll have the expression here so we
      * can know how many args are needed. Otherwise, we use the current fn context. */
     jtl::option<let_ref> loop_target;
+    /* Set by the self_tail_calls pass when this can jump back into the current arity,
+     * rather than making a new call. */
+    bool is_self_tail_call{};
   };
 }
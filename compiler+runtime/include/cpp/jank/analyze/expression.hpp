@@ -161,6 +161,12 @@ namespace jank::analyze
                bool needs_box);
     virtual ~expression() = default;
 
+    /* Nodes come from the current analyze::node_arena, if there is one. They're GC
+     * memory either way, so they're never deleted. */
+    static void *operator new(usize const size, GCPlacement);
+    static void operator delete(void *) noexcept;
+    static void operator delete(void *, GCPlacement) noexcept;
+
     virtual void propagate_position(expression_position const pos);
     virtual runtime::object_ref to_runtime_data() const;
     virtual void walk(std::function<void(jtl::ref<expression>)> const &f);
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <immer/map.hpp>
+
 #include <jtl/ptr.hpp>
 #include <jtl/option.hpp>
 
@@ -42,6 +44,9 @@ namespace jank::analyze
     /* TODO: This gets stomped when a binding is shadowed. Do we
      * need to handle shadowing more delicately? */
     jtl::ptr<void> type{ analyze::cpp_util::untyped_object_ptr_type() };
+    /* Whether this is bound to a scoped cpp/new, such as from with-native. Its object is
+     * destroyed once the let ends, so it mustn't escape the let. */
+    bool scoped{};
 
     runtime::object_ref to_runtime_data() const;
   };
@@ -85,11 +90,26 @@ namespace jank::analyze
 
     static constexpr bool pointer_free{ false };
 
+    /* Every local which can be seen from a frame, including those of its parents, mapped
+     * to the frame which binds it. Each frame starts with its parent's map, which is O(1)
+     * to copy, so resolving a local doesn't depend on how deeply it's nested. */
+    using scope_map = immer::map<runtime::obj::symbol_ref,
+                                 jtl::ptr<local_frame>,
+                                 std::hash<runtime::obj::symbol_ref>,
+                                 std::equal_to<runtime::obj::symbol_ref>,
+                                 jank::memory_policy>;
+
     local_frame() = delete;
     local_frame(local_frame const &) = default;
     local_frame(local_frame &&) noexcept = default;
     local_frame(frame_type const &type, jtl::option<jtl::ptr<local_frame>> const &p);
 
+    /* Nodes come from the current analyze::node_arena, if there is one. They're GC
+     * memory either way, so they're never deleted. */
+    static void *operator new(usize const size, GCPlacement);
+    static void operator delete(void *) noexcept;
+    static void operator delete(void *, GCPlacement) noexcept;
+
     struct binding_find_result
     {
       local_binding_ptr binding;
@@ -102,8 +122,16 @@ namespace jank::analyze
       native_vector<jtl::ptr<local_frame>> crossed_fns;
     };
 
+    /* Locals must be added through here, rather than to `locals` directly, so that they're
+     * in the scope. An existing local of the same name is kept. */
+    void add_local(runtime::obj::symbol_ref const sym, local_binding &&binding);
+    /* Moves this frame under another parent. Frames which are already nested within this
+     * one keep the scope they were made with. */
+    void set_parent(jtl::option<jtl::ptr<local_frame>> const &p);
+
     /* This is used to find both captures and regular locals, since it's
-     * impossible to know which one a sym is without finding it. */
+     * impossible to know which one a sym is without finding it. Only the fn frames
+     * between here and the local are visited, to check their captures. */
     jtl::option<binding_find_result> find_local_or_capture(runtime::obj::symbol_ref const sym);
     static void register_captures(binding_find_result const &result);
     static void
@@ -129,6 +157,10 @@ namespace jank::analyze
     native_unordered_map<runtime::obj::symbol_ref, local_binding> captures;
     /* This is only set if the frame type is fn. */
     jtl::ptr<expr::function_context> fn_ctx;
+    scope_map scope;
+    /* The closest fn frame above this one or, if there isn't one, the outermost frame. */
+    jtl::ptr<local_frame> outer_fn;
+    usize depth{};
   };
 
   /* TODO: Use a ref. */
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <jank/analyze/expression.hpp>
+
+namespace jank::analyze::pass
+{
+  expression_ref escape_analysis(expression_ref expr);
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <jank/analyze/expression.hpp>
+
+namespace jank::analyze::pass
+{
+  expression_ref local_rest_args(expression_ref expr);
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <jank/analyze/expression.hpp>
+
+namespace jank::runtime
+{
+  using var_ref = oref<struct var>;
+}
+
+namespace jank::analyze::pass
+{
+  expression_ref numeric_arities(expression_ref expr);
+
+  /* Whether calling the fn in this var, with this many args, gives a number. This comes
+   * from the var's arity meta, if it has some, or from what this pass inferred. */
+  bool is_numeric_call(runtime::var_ref var, usize arg_count);
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <jank/analyze/expression.hpp>
+
+namespace jank::analyze::pass
+{
+  expression_ref self_tail_calls(expression_ref expr);
+}
@@ -2,6 +2,8 @@
 
 #include <functional>
 
+#include <folly/Synchronized.h>
+
 #include <jtl/option.hpp>
 
 #include <jank/read/parse.hpp>
@@ -25,6 +27,8 @@ namespace jank::runtime
 
 namespace jank::analyze
 {
+  struct node_arena;
+
   namespace expr
   {
     using cpp_value_ref = jtl::ref<struct cpp_value>;
@@ -39,6 +43,11 @@ namespace jank::analyze
 
   enum class literal_kind : u8;
 
+  /* A processor only holds the state of a single compilation, so each thread analyzing
+   * something needs its own. They're cheap to make. What's shared between compilations,
+   * such as the special forms and the analyzed values of vars, lives in static storage and
+   * is either immutable or synchronized. Vars and namespaces are resolved through the
+   * runtime context, which synchronizes those itself. */
   struct processor
   {
     using expression_result = jtl::result<expression_ref, error_ref>;
@@ -165,6 +174,10 @@ namespace jank::analyze
                                          expression_position,
                                          jtl::option<expr::function_context_ref> const &,
                                          bool needs_box);
+    /* For a call to an fn form, such as ((fn [x] ...) 1), gives the let* form the call can
+     * be analyzed as instead, if there is one. */
+    jtl::option<runtime::object_ref>
+    inline_immediate_fn_call(runtime::obj::persistent_list_ref const);
     expression_result analyze_cpp_call(runtime::obj::persistent_list_ref const,
                                        expression_ref,
                                        local_frame_ptr,
@@ -225,7 +238,11 @@ namespace jank::analyze
                                                 bool needs_box);
 
     /* Returns whether the form is a special symbol. */
-    bool is_special(runtime::object_ref const form);
+    static bool is_special(runtime::object_ref const form);
+
+    /* Drops anything which is remembered across compilations and was allocated from the
+     * arena, so it can be freed. */
+    static void forget_nodes(node_arena const &arena);
 
     using special_function_type
       = expression_result (processor::*)(runtime::obj::persistent_list_ref const,
@@ -233,9 +250,14 @@ namespace jank::analyze
                                          expression_position,
                                          jtl::option<expr::function_context_ref> const &,
                                          bool);
+    using var_value_map = native_unordered_map<runtime::var_ref, expression_ref>;
+
+    /* These never change once built. */
+    static native_unordered_map<runtime::obj::symbol_ref, special_function_type> const &
+    special_forms();
+    /* The analyzed value of each def, by var, from every compilation so far. */
+    static folly::Synchronized<var_value_map> &var_values();
 
-    native_unordered_map<runtime::obj::symbol_ref, special_function_type> specials;
-    native_unordered_map<runtime::var_ref, expression_ref> vars;
     local_frame_ptr root_frame;
     native_vector<runtime::object_ref> macro_expansions;
     jtl::option<expr::let_ptr> loop_details;
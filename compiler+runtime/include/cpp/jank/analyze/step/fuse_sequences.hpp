@@ -0,0 +1,14 @@
+#pragma once
+
+#include <jank/runtime/obj/persistent_list.hpp>
+#include <jank/analyze/local_frame.hpp>
+
+namespace jank::analyze::step
+{
+  /* Rewrites a chain of lazy seq fns, such as (into [] (filter even? (map inc xs))), which is
+   * consumed right away by reduce, into, vec, count, some, or doseq, into a single transducer
+   * over the source, so no lazy seq is built for any stage. Gives nil when the call isn't
+   * such a chain. */
+  runtime::object_ref
+  fuse_sequences(runtime::obj::persistent_list_ref const call, local_frame_ptr const frame);
+}
@@ -44,6 +44,18 @@ extern "C"
   typedef jank_u32 jank_uhash;
   /* NOLINTNEXTLINE(modernize-use-using) */
   typedef jank_u8 jank_arity_flags;
+  /* NOLINTNEXTLINE(modernize-use-using) */
+  typedef void *jank_isolate_ref;
+
+  /* One var which a module needs, along with the slot its global lives in. Modules
+   * register all of these in one table, grouped by ns. */
+  /* NOLINTNEXTLINE(modernize-use-using) */
+  typedef struct
+  {
+    char const *ns;
+    char const *name;
+    jank_object_ref *slot;
+  } jank_var_record;
 
   jank_object_ref jank_eval(jank_object_ref s);
   jank_object_ref jank_read_string(jank_object_ref s);
@@ -55,8 +67,18 @@ extern "C"
 
   jank_object_ref jank_var_intern(jank_object_ref ns, jank_object_ref name);
   jank_object_ref jank_var_intern_c(char const * const ns, char const * const name);
+  void jank_var_intern_table(jank_var_record const * const records, jank_usize const count);
   jank_object_ref jank_var_bind_root(jank_object_ref var, jank_object_ref val);
+  jank_object_ref jank_var_bind_lazy_root(jank_object_ref var, jank_object_ref (*init)());
   jank_object_ref jank_var_set_dynamic(jank_object_ref var, jank_object_ref dynamic);
+  /* Equivalent to jank_deref, but skips the type dispatch, since the var is known. */
+  jank_object_ref jank_var_deref(jank_object_ref var);
+  /* Finds an existing var, without interning anything, giving nil if there is none. Hosts
+   * can resolve a var once and then invoke it as often as they like. */
+  jank_object_ref jank_var_resolve_c(char const * const ns, char const * const name);
+  /* Calls the var's current root with arity args, so redefinitions are still seen. */
+  jank_object_ref
+  jank_var_invoke(jank_object_ref var, jank_usize arity, jank_object_ref const *args);
 
   jank_object_ref jank_keyword_intern(jank_object_ref ns, jank_object_ref name);
 
@@ -135,6 +157,21 @@ extern "C"
                               jank_object_ref a9,
                               jank_object_ref a10,
                               jank_object_ref rest);
+  /* Calls f once for each of count tuples. The tuples are laid out back to back in args,
+   * each with arity args, and each result goes in the matching slot of out. */
+  void jank_call_batch(jank_object_ref f,
+                       jank_usize arity,
+                       jank_object_ref const *args,
+                       jank_usize count,
+                       jank_object_ref *out);
+
+  /* Keyword lookups with an inline cache. The site is a zeroed keyword_call_site. */
+  jank_object_ref jank_keyword_get1(void *site, jank_object_ref kw, jank_object_ref m);
+  jank_object_ref
+  jank_keyword_get2(void *site, jank_object_ref kw, jank_object_ref m, jank_object_ref fallback);
+  jank_object_ref jank_keyword_call1(void *site, jank_object_ref m, jank_object_ref kw);
+  jank_object_ref
+  jank_keyword_call2(void *site, jank_object_ref m, jank_object_ref kw, jank_object_ref fallback);
 
   jank_object_ref jank_const_nil();
   jank_object_ref jank_const_true();
@@ -155,6 +192,9 @@ extern "C"
   jank_object_ref jank_vector_create(jank_u64 size, ...);
   jank_object_ref jank_map_create(jank_u64 pairs, ...);
   jank_object_ref jank_set_create(jank_u64 size, ...);
+  jank_object_ref jank_vector_from_array(jank_object_ref const *items, jank_usize size);
+  jank_object_ref
+  jank_map_from_arrays(jank_object_ref const *keys, jank_object_ref const *vals, jank_usize size);
 
   jank_object_ref jank_box(char const *type, void const *o);
   void *jank_unbox(char const *type, jank_object_ref o);
@@ -162,8 +202,11 @@ extern "C"
 
   jank_arity_flags jank_function_build_arity_flags(jank_u8 highest_fixed_arity,
                                                    jank_bool is_variadic,
-                                                   jank_bool is_variadic_ambiguous);
+                                                   jank_bool is_variadic_ambiguous,
+                                                   jank_bool has_local_rest);
   jank_object_ref jank_function_create(jank_arity_flags arity_flags);
+  /* For a fn which is made once and shared by every evaluation of its fn form. */
+  jank_object_ref jank_function_create_lifted(jank_arity_flags arity_flags);
   void jank_function_set_arity0(jank_object_ref fn, jank_object_ref (*f)(jank_object_ref));
   void jank_function_set_arity1(jank_object_ref fn,
                                 jank_object_ref (*f)(jank_object_ref, jank_object_ref));
@@ -238,6 +281,9 @@ extern "C"
                                                       jank_object_ref));
 
   jank_object_ref jank_closure_create(jank_arity_flags arity_flags, void *context);
+  /* The closure's context is made along with it, in the same allocation, with room for the
+   * given number of captures. */
+  jank_object_ref jank_closure_create_flat(jank_arity_flags arity_flags, jank_usize capture_count);
   void jank_closure_set_arity0(jank_object_ref fn, jank_object_ref (*f)(jank_object_ref));
   void jank_closure_set_arity1(jank_object_ref fn,
                                jank_object_ref (*f)(jank_object_ref, jank_object_ref));
@@ -316,6 +362,9 @@ extern "C"
   jank_uhash jank_to_hash(jank_object_ref o);
   jank_i64 jank_to_integer(jank_object_ref o);
   jank_i64 jank_shift_mask_case_integer(jank_object_ref o, jank_i64 shift, jank_i64 mask);
+  jank_i64 jank_case_integer(jank_object_ref o, jank_i64 unused_key);
+  void jank_feedback_record(jank_u8 *site, jank_object_ref o);
+  void *jank_osr_find_optimized(void *tier0);
 
   void jank_set_meta(jank_object_ref o, jank_object_ref meta);
 
@@ -340,6 +389,17 @@ extern "C"
 
   jank_object_ref jank_parse_command_line_args(int const argc, char const **argv);
 
+  /* Isolates give each tenant of a host its own namespaces and dynamic state, over a base
+   * of whatever was loaded before, like clojure.core. Create them after jank_init has
+   * loaded the base. A thread enters an isolate before evaluating anything for it and
+   * exits it after, within the same thread. An isolate can only be entered by one thread
+   * at a time, but separate isolates can be used by separate threads at once. */
+  jank_isolate_ref jank_isolate_create();
+  void jank_isolate_enter(jank_isolate_ref iso);
+  void jank_isolate_exit(jank_isolate_ref iso);
+  /* The isolate must not be entered. Its namespaces are left for the GC. */
+  void jank_isolate_destroy(jank_isolate_ref iso);
+
 #ifdef __cplusplus
 }
 #endif
@@ -121,6 +121,9 @@ namespace jank::codegen
     llvm::orc::ThreadSafeModule &get_module() const;
     jtl::immutable_string const &get_module_name() const;
     jtl::immutable_string get_root_fn_name() const;
+    /* The fn which initializes the module's globals. Objects which are loaded don't get
+     * their global ctors run, so this needs to be called for them. */
+    jtl::immutable_string const &get_ctor_name() const;
 
     jtl::ptr<impl> _impl{};
   };
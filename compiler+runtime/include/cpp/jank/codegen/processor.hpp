@@ -196,6 +196,10 @@ namespace jank::codegen
                          std::hash<runtime::object_ref>,
                          runtime::very_equal_to>
       lifted_constants;
+    /* The name of the lifted constant holding the root fn's meta. */
+    jtl::immutable_string lifted_meta;
+    /* For variadic fns, the expression for the arity flags given to the base. */
+    jtl::immutable_string arity_flags;
     bool generated_declaration{};
     bool generated_expression{};
   };
@@ -9,7 +9,7 @@
 
 namespace cpptrace
 {
-  struct stacktrace;
+  struct raw_trace;
 }
 
 namespace jank::error
@@ -377,8 +377,11 @@ namespace jank::error
     kind kind{ kind::error };
   };
 
-  /* We need gc_cleanup to run the dtor for the unique_ptr<stacktrace>. This
-   * is because cpptrace doesn't use our GC allocator. */
+  /* We need gc_cleanup to run the dtor for the unique_ptr<raw_trace>. This
+   * is because cpptrace doesn't use our GC allocator.
+   *
+   * The trace is only the return addresses. Symbolizing them is much slower than capturing
+   * them, so that's not done until the error is actually reported. */
   struct base
   {
     static constexpr bool is_error{ true };
@@ -397,7 +400,7 @@ namespace jank::error
          jtl::immutable_string const &message,
          read::source const &source,
          runtime::object_ref const expansion,
-         std::unique_ptr<cpptrace::stacktrace> trace);
+         std::unique_ptr<cpptrace::raw_trace> trace);
     base(kind k,
          jtl::immutable_string const &message,
          read::source const &source,
@@ -432,7 +435,7 @@ namespace jank::error
          read::source const &source,
          runtime::object_ref const expansion,
          jtl::ref<base> cause,
-         std::unique_ptr<cpptrace::stacktrace> trace);
+         std::unique_ptr<cpptrace::raw_trace> trace);
 
     bool operator==(base const &rhs) const;
     bool operator!=(base const &rhs) const;
@@ -445,7 +448,7 @@ namespace jank::error
     read::source source;
     native_vector<note> notes;
     jtl::ptr<base> cause;
-    std::unique_ptr<cpptrace::stacktrace> trace;
+    std::unique_ptr<cpptrace::raw_trace> trace;
     /* TODO: context */
     /* TODO: suggestions */
   };
@@ -77,19 +77,19 @@ namespace jank::error
                                       read::source const &source,
                                       runtime::object_ref const expansion);
   error_ref analyze_macro_expansion_exception(std::exception const &e,
-                                              cpptrace::stacktrace const &trace,
+                                              cpptrace::raw_trace const *trace,
                                               read::source const &source,
                                               runtime::object_ref const expansion);
   error_ref analyze_macro_expansion_exception(runtime::object_ref const e,
-                                              cpptrace::stacktrace const &trace,
+                                              cpptrace::raw_trace const *trace,
                                               read::source const &source,
                                               runtime::object_ref const expansion);
   error_ref analyze_macro_expansion_exception(jtl::immutable_string const &e,
-                                              cpptrace::stacktrace const &trace,
+                                              cpptrace::raw_trace const *trace,
                                               read::source const &source,
                                               runtime::object_ref const expansion);
   error_ref analyze_macro_expansion_exception(error_ref e,
-                                              cpptrace::stacktrace const &trace,
+                                              cpptrace::raw_trace const *trace,
                                               read::source const &source,
                                               runtime::object_ref const expansion);
   error_ref analyze_invalid_conversion(jtl::immutable_string const &message);
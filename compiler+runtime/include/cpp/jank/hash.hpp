@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+
 #include <jank/type.hpp>
 
 namespace jtl
@@ -44,16 +46,38 @@ namespace jank::hash
   u32 ordered(runtime::object const * const sequence);
   u32 unordered(runtime::object const * const sequence);
 
+  /* Elements are hashed four at a time, so their hashes don't wait on each other. The
+   * powers of 31 are worked out up front, which gives the same result as one at a time,
+   * since it all wraps around the same way. */
   template <typename It>
   u32 ordered(It const &begin, It const &end)
   {
     u32 n{};
     u32 hash{ 1 };
 
-    for(auto it(begin); it != end; ++it)
+    auto it(begin);
+    while(it != end)
     {
-      hash = (31 * hash) + visit((*it));
-      ++n;
+      std::array<u32, 4> lanes{};
+      usize filled{};
+      for(; filled < lanes.size() && it != end; ++filled, ++it)
+      {
+        lanes[filled] = visit((*it));
+      }
+
+      if(filled == lanes.size())
+      {
+        hash = (923521 * hash) + (29791 * lanes[0]) + (961 * lanes[1]) + (31 * lanes[2])
+          + lanes[3];
+      }
+      else
+      {
+        for(usize i{}; i < filled; ++i)
+        {
+          hash = (31 * hash) + lanes[i];
+        }
+      }
+      n += static_cast<u32>(filled);
     }
 
     return mix_collection_hash(hash, n);
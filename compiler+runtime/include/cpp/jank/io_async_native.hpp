@@ -0,0 +1,5 @@
+#pragma once
+
+#include <jank/c_api.h>
+
+extern "C" void jank_load_jank_io_async_native();
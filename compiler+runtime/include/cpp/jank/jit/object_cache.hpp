@@ -0,0 +1,46 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <jtl/immutable_string.hpp>
+
+namespace llvm
+{
+  class Module;
+  class MemoryBuffer;
+}
+
+namespace jank::jit
+{
+  /* An on disk cache of the object code which the JIT compiles for eval'd IR modules, with
+   * --cache-eval-objects. Each object is keyed on the SHA256 of its module's unoptimized
+   * bitcode. The cache lives within the binary cache dir, which is already specific to the
+   * jank version, the compiler flags, and the target, so a hit means the same IR compiled
+   * the same way. Those modules skip optimization and codegen entirely.
+   *
+   * The names of eval'd fns come from a counter in each ns, so a form hits when it's eval'd
+   * at the same point as before, such as a namespace which is loaded from source again
+   * after a restart. Forms which direct link to a var have its address in their IR, so they
+   * never hit in another process. */
+  struct object_cache
+  {
+    object_cache(jtl::immutable_string const &dir);
+
+    /* Gives the cached object for the module, if there is one. Otherwise, the module's
+     * object will be written to the cache once the JIT compiles it. */
+    std::unique_ptr<llvm::MemoryBuffer> find(llvm::Module const &m);
+    /* Called with every object the JIT compiles, so the ones for modules which missed can
+     * be cached. */
+    void compiled(llvm::MemoryBuffer const &object);
+
+    jtl::immutable_string path_of(jtl::immutable_string const &key) const;
+
+    jtl::immutable_string dir;
+    std::mutex mutex;
+    /* The name of each module which missed, to its key, until it's compiled. */
+    std::unordered_map<std::string, jtl::immutable_string> pending;
+  };
+}
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <filesystem>
 #include <memory>
+#include <mutex>
 
 #include <jtl/result.hpp>
 #include <jtl/string_builder.hpp>
@@ -10,6 +13,7 @@ namespace llvm
 {
   class Module;
   class LLVMContext;
+  class MemoryBuffer;
 
   namespace orc
   {
@@ -29,6 +33,19 @@ namespace Cpp
 
 namespace jank::jit
 {
+  /* Keeps the code of a reclaimable IR module loaded. See load_reclaimable_ir_module. */
+  struct code_owner;
+  struct object_cache;
+
+  /* The JIT's PCH only has the headers plain jank code needs. The rest of the headers
+   * are split into groups, which are only parsed once something needs them. */
+  enum class header_group : u8
+  {
+    /* Object conversions and the rest of what C++ interop needs. */
+    interop,
+    count
+  };
+
   struct processor
   {
     processor(jtl::immutable_string const &binary_version);
@@ -37,24 +54,83 @@ namespace jank::jit
     void eval_string(jtl::immutable_string const &s) const;
     void eval_string(jtl::immutable_string const &s, clang::Value *) const;
     void load_object(jtl::immutable_string_view const &path) const;
+    void load_object(std::unique_ptr<llvm::MemoryBuffer> object) const;
     void load_dynamic_library(jtl::immutable_string const &path) const;
     void load_ir_module(llvm::orc::ThreadSafeModule &&m) const;
+    /* Loads the module with its own resource tracker, which belongs to the GC allocated
+     * owner this gives. Once the owner is collected, the module is unloaded. Every fn made
+     * by the module's code holds onto its owner, through find_code_owner, and the caller
+     * needs to keep the owner reachable while it runs the module's code itself. Modules
+     * whose functions could be reached some other way are loaded as usual, giving null. */
+    code_owner *load_reclaimable_ir_module(llvm::orc::ThreadSafeModule &&m) const;
+    /* The owner of the reclaimable module with the code containing the address, if any. */
+    code_owner *find_code_owner(uintptr_t const address) const;
+    /* Unloads the modules whose owners have been collected. This also happens before
+     * any IR module is loaded. */
+    void reclaim_code() const;
     void load_bitcode(jtl::immutable_string const &module,
                       jtl::immutable_string_view const &bitcode) const;
+    /* With --cache-eval-objects, gives the cached object for the module, which needs to be
+     * unoptimized, if the same module has been compiled before. On a miss, the module's
+     * object is cached once it's loaded with load_ir_module. See jit::object_cache. */
+    std::unique_ptr<llvm::MemoryBuffer> find_cached_object(llvm::Module const &m) const;
 
     jtl::string_result<void> remove_symbol(jtl::immutable_string const &name) const;
     jtl::string_result<void *> find_symbol(jtl::immutable_string const &name) const;
 
-    jtl::result<void, jtl::immutable_string>
-    load_dynamic_libs(native_vector<jtl::immutable_string> const &libs) const;
     jtl::option<jtl::immutable_string> find_dynamic_lib(jtl::immutable_string const &lib) const;
 
-    std::unique_ptr<Cpp::Interpreter> interpreter;
+    /* Includes the group's headers into the interpreter, if they haven't been already. This
+     * is cheap after the first time, so it can be called whenever the group may be needed. */
+    void require_header_group(header_group group) const;
+
+    /* Creating the Clang interpreter is the slowest part of starting jank, since it needs to
+     * load the PCH and set up the JIT. AOT compiled programs which never eval anything don't
+     * need it at all, so it's only created the first time something uses it. This acts like
+     * a pointer to the interpreter. Any number of threads can race to create it. */
+    struct lazy_interpreter
+    {
+      lazy_interpreter(processor &owner);
+      ~lazy_interpreter();
+
+      Cpp::Interpreter *get() const;
+      Cpp::Interpreter *operator->() const;
+      Cpp::Interpreter &operator*() const;
+
+      /* This doesn't create the interpreter. */
+      bool is_created() const;
+
+      processor &owner;
+      mutable std::atomic<Cpp::Interpreter *> created{};
+      mutable std::once_flag once;
+      mutable std::unique_ptr<Cpp::Interpreter> value;
+    };
+
+    jtl::immutable_string binary_version;
     native_vector<std::filesystem::path> library_dirs;
+    lazy_interpreter interpreter{ *this };
 
     /* The files within this map will get added into Clang's VFS prior to the creation of
      * the `clang::Interpreter`. This allows us to embed the PCH into AOT compiled programs
      * while still being able to include it. */
     std::map<char const *, std::string_view> vfs;
+
+    mutable std::array<std::once_flag, static_cast<usize>(header_group::count)>
+      header_groups_included;
+
+    /* Called once, by the lazy interpreter. */
+    std::unique_ptr<Cpp::Interpreter> create_interpreter();
+
+    /* Only with --cache-eval-objects. This is created along with the interpreter, since it
+     * hooks into the JIT to see each object it compiles. */
+    std::unique_ptr<object_cache> objects;
+
+    /* IR modules can be loaded from the background compile thread, for tiered compilation,
+     * so loading them is serialized. */
+    mutable std::mutex ir_load_mutex;
+
+    /* Bumped whenever C++ is parsed which could declare something new, so that caches of
+     * C++ lookups, like those in analyze::cpp_util, know to start over. */
+    mutable std::atomic<u64> cpp_generation{};
   };
 }
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+
+#include <jank/runtime/object.hpp>
+
+/* What JIT compilation is costing, kept for jank.perf/jit-stats and check-health. Along
+ * with the process wide totals, the work done while loading each module is charged to
+ * that module, and the work done by each top level eval, such as a REPL eval, is charged
+ * to that eval. Nested module loads are charged to themselves, not their parents.
+ *
+ * Attribution is per thread, so background work, like tiered recompiles, only counts
+ * towards the totals. */
+namespace jank::jit::stats
+{
+  struct counts
+  {
+    /* C++ source given to Clang, and how long it took to parse, compile, and run. */
+    u64 cpp_evals{};
+    u64 cpp_bytes{};
+    u64 clang_parse_ns{};
+    /* IR modules added to the JIT, by their instruction count once they're added. */
+    u64 ir_modules{};
+    u64 ir_instructions{};
+    u64 llvm_optimize_ns{};
+    /* Objects linked by the JIT, whether compiled from C++ or IR or loaded from disk. */
+    u64 objects{};
+    u64 object_bytes{};
+    u64 symbols{};
+
+    counts &operator+=(counts const &rhs);
+  };
+
+  /* Where a module was loaded from. Loading its binary is a hit on the module cache,
+   * while compiling its source is a miss. */
+  enum class module_origin : u8
+  {
+    binary,
+    source,
+    cpp
+  };
+
+  struct totals
+  {
+    counts jit;
+    u64 cache_hits{};
+    u64 cache_misses{};
+    u64 cpp_loads{};
+    /* Objects which have since been removed from the JIT, such as with --reclaim-jit-code. */
+    u64 unlinked_objects{};
+    u64 unlinked_bytes{};
+    /* The bytes linked which are still loaded. This is kept across resets. */
+    u64 live_bytes{};
+  };
+
+  inline u64 since(std::chrono::steady_clock::time_point const start)
+  {
+    return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              std::chrono::steady_clock::now() - start)
+                              .count());
+  }
+
+  void record_cpp(usize bytes, u64 ns);
+  void record_ir(u64 instructions);
+  void record_optimize(u64 ns);
+  void record_link(u64 bytes, u64 symbols);
+  /* Only counts towards the totals, since it isn't any particular module's work. */
+  void record_unlink(u64 bytes);
+
+  /* Charges this thread's JIT work to a module until the scope ends. The time is the
+   * module's own, without the loads of the modules it requires. */
+  struct module_scope
+  {
+    module_scope(jtl::immutable_string const &module, module_origin origin);
+    module_scope(module_scope const &) = delete;
+    module_scope(module_scope &&) noexcept = delete;
+    ~module_scope();
+
+    module_scope &operator=(module_scope const &) = delete;
+    module_scope &operator=(module_scope &&) noexcept = delete;
+
+    std::string name;
+    module_origin origin{};
+    std::chrono::steady_clock::time_point start{ std::chrono::steady_clock::now() };
+    u64 nested_ns{};
+    counts self;
+    module_scope *parent{};
+  };
+
+  /* Charges this thread's JIT work to a top level eval until the scope ends. This does
+   * nothing within a module load or another eval, so only the outermost eval counts. */
+  struct eval_scope
+  {
+    eval_scope();
+    eval_scope(eval_scope const &) = delete;
+    eval_scope(eval_scope &&) noexcept = delete;
+    ~eval_scope();
+
+    eval_scope &operator=(eval_scope const &) = delete;
+    eval_scope &operator=(eval_scope &&) noexcept = delete;
+
+    bool is_active() const;
+    /* Whatever uniquely shows what was evaluated, such as its first form. */
+    void set_label(jtl::immutable_string const &label);
+
+    std::string label;
+    std::chrono::steady_clock::time_point start{ std::chrono::steady_clock::now() };
+    counts self;
+    bool active{};
+  };
+
+  jank::jit::stats::totals totals();
+
+  /* A map of the :total counts, along with the :cache-hits, :cache-misses, and
+   * :cpp-loads of the module loader, the :unlinked-objects and :unlinked-bytes which
+   * have been removed from the JIT, the :live-bytes still linked, the :modules which
+   * have been loaded, slowest first, and the most recent top level :evals, oldest
+   * first. */
+  runtime::object_ref snapshot();
+  void reset();
+}
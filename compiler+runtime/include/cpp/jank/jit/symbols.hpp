@@ -0,0 +1,33 @@
+#pragma once
+
+#include <jtl/option.hpp>
+#include <jank/type.hpp>
+
+namespace llvm::orc
+{
+  class ObjectLinkingLayer;
+}
+
+/* JIT compiled code has no symbols for dladdr to find, so we keep our own table of
+ * where each JIT compiled function was linked, much like the perf map which --perf
+ * writes. This is what lets in-process tools, like the sampling profiler, name the
+ * JIT compiled frames they find. */
+namespace jank::jit::symbols
+{
+  /* Adds a plugin to the linking layer, which records every function it links and
+   * forgets them once they're removed. It also counts what's linked, for jit::stats. */
+  void track(llvm::orc::ObjectLinkingLayer &layer);
+  /* Whether track has been called. Without it, none of this knows about any code. */
+  bool is_tracking();
+
+  /* The key of the ORC resource which owns the JIT compiled function containing the
+   * address, if any. */
+  jtl::option<uptr> find_resource(uintptr_t const address);
+
+  /* The demangled name of the JIT compiled function containing the address, if any. */
+  jtl::option<jtl::immutable_string> find(uintptr_t const address);
+
+  /* The name of whichever function contains the address, JIT compiled or not. Failing
+   * that, this is just the address. */
+  jtl::immutable_string describe(uintptr_t const address);
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <jank/runtime/object.hpp>
+
+namespace llvm::orc
+{
+  class ThreadSafeModule;
+}
+
+namespace jank::runtime::obj
+{
+  using jit_function_ref = oref<struct jit_function>;
+}
+
+namespace jank::jit
+{
+  struct processor;
+}
+
+/* Tiered compilation, enabled with --tiered-compilation.
+ *
+ * Tier 0 modules are JIT compiled without running any optimization passes, so they're
+ * quick to load at startup and in the REPL. We keep a copy of each one's IR. Once one of
+ * a fn's arities has been called enough, the module which defines it is optimized and
+ * loaded again, on a background compile thread, with all of its symbols renamed. Then
+ * the fn's arities are swapped over to the optimized code.
+ *
+ * Only jit_function arities are swapped. Closures created by optimized code will use
+ * optimized code, but closures which already exist keep their tier 0 code. Direct linked
+ * call sites also keep calling the tier 0 code they were linked to.
+ *
+ * Tier 0 code also records the types it sees at each call to a core arithmetic fn, like
+ * + or <, in a byte of its own, called a feedback site. Each such call has a fast path for
+ * integers, which tier 0 takes once its site has only seen integers, after checking that
+ * its args still are. When the module is optimized, each site's feedback is baked in, so
+ * the optimizer keeps only the unboxed path, behind its type checks, for sites which have
+ * only seen integers and only the generic call for the rest. A failed type check always
+ * falls back to the generic call.
+ *
+ * Loops in tier 0 code can also be replaced on the stack. See
+ * codegen::llvm_processor::impl::gen_loop. */
+namespace jank::jit::tiering
+{
+  namespace feedback
+  {
+    /* Every feedback site's global has this in its name. */
+    static constexpr char const *site_name{ "jank_feedback_site" };
+
+    /* The bits of a feedback site, one for each kind of arg it has seen. */
+    static constexpr u8 integer{ 1 << 0 };
+    static constexpr u8 real{ 1 << 1 };
+    static constexpr u8 other{ 1 << 2 };
+  }
+
+  /* Tier 0 loops check for their optimized code this often, in iterations. This must be a
+   * power of two. */
+  static constexpr u64 osr_interval{ 1 << 16 };
+
+  bool is_enabled();
+
+  /* Loads an unoptimized module and remembers its IR, so it can be optimized later. */
+  void load_tier0_module(processor const &jit_prc, llvm::orc::ThreadSafeModule &&m);
+
+  /* Schedules the module defining this fn's arities to be optimized, if it isn't already.
+   * Once that's done, the fn's arities are swapped. This is safe to call repeatedly and
+   * does nothing for fns which weren't loaded at tier 0. */
+  void request_tier_up(runtime::obj::jit_function_ref const fn);
+
+  /* For on-stack replacement. Gives the optimized address of a tier 0 fn, once its module
+   * has been optimized, and null until then. The first call schedules the module to be
+   * optimized. */
+  void *find_optimized(void * const tier0);
+
+  /* Blocks until every scheduled optimization has been loaded. */
+  void wait_for_pending();
+}
@@ -1,14 +1,8 @@
 #pragma once
 
-/* This file is turned into a pre-compiled header which is included at run-time
- * to provide fast access to jank's C++ API. */
+/* Everything jank's generated C++ may need. AOT compilation includes all of this. The
+ * JIT's PCH is only built from the core group, though, and the rest is included as it's
+ * needed. See `jit::processor::require_header_group`. */
 
-#include <jank/runtime/convert/builtin.hpp>
-#include <jank/runtime/visit.hpp>
-#include <jank/runtime/context.hpp>
-#include <jank/runtime/core/truthy.hpp>
-#include <jank/runtime/core/seq.hpp>
-#include <jank/runtime/core/meta.hpp>
-#include <jank/runtime/core.hpp>
-#include <jank/util/scope_exit.hpp>
-#include <jank/c_api.h>
+#include <jank/prelude/core.hpp>
+#include <jank/prelude/interop.hpp>
@@ -0,0 +1,15 @@
+#pragma once
+
+/* This file is turned into a pre-compiled header which is included at run-time
+ * to provide fast access to jank's C++ API. It's only what plain jank code needs, since
+ * every JIT compiled program pays to load it. Headers which are only needed for C++
+ * interop are in `prelude/interop.hpp`. */
+
+#include <jank/runtime/visit.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core/truthy.hpp>
+#include <jank/runtime/core/seq.hpp>
+#include <jank/runtime/core/meta.hpp>
+#include <jank/runtime/core.hpp>
+#include <jank/util/scope_exit.hpp>
+#include <jank/c_api.h>
@@ -0,0 +1,9 @@
+#pragma once
+
+/* These headers are only needed for C++ interop, such as converting between objects and
+ * native types. They're not in the JIT's PCH. Instead, the JIT includes this the first
+ * time something is analyzed which uses interop. Everything here builds on the core
+ * prelude, so only these headers need to be parsed. */
+
+#include <jank/prelude/core.hpp>
+#include <jank/runtime/convert/builtin.hpp>
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <array>
+
+#include <jank/type.hpp>
+
+namespace jank::profile
+{
+  /* The phases of the compiler pipeline, for bench-compile. Phases nest, such as
+   * macroexpansion within analysis, so each one is only charged for its own time and
+   * allocations, not those of the phases within it. */
+  enum class phase : u8
+  {
+    read,
+    macroexpand,
+    analyze,
+    optimize,
+    cpp_gen,
+    ir_gen,
+    /* Clang parsing, compiling, and running generated C++. */
+    clang_parse,
+    llvm_optimize,
+    /* Adding IR modules to the JIT and looking up their symbols, which is when ORC
+     * actually compiles them. */
+    jit_materialize,
+    /* Running the compiled code, once it's been JIT compiled. */
+    eval,
+    count
+  };
+
+  constexpr char const *phase_str(phase const p)
+  {
+    switch(p)
+    {
+      case phase::read:
+        return "read";
+      case phase::macroexpand:
+        return "macroexpand";
+      case phase::analyze:
+        return "analyze";
+      case phase::optimize:
+        return "optimize";
+      case phase::cpp_gen:
+        return "cpp gen";
+      case phase::ir_gen:
+        return "ir gen";
+      case phase::clang_parse:
+        return "clang parse";
+      case phase::llvm_optimize:
+        return "llvm optimize";
+      case phase::jit_materialize:
+        return "jit materialize";
+      case phase::eval:
+        return "eval";
+      default:
+        return "unknown";
+    }
+  }
+
+  struct phase_stats
+  {
+    u64 count{};
+    i64 self_ns{};
+    /* Allocations are counted by the GC, across every thread, so background work which
+     * overlaps a phase is charged to it. */
+    u64 self_bytes{};
+  };
+
+  /* A point in time and allocation, to measure a form from. */
+  struct phase_mark
+  {
+    i64 ns{};
+    u64 bytes{};
+  };
+
+  struct form_stats
+  {
+    jtl::immutable_string label;
+    i64 ns{};
+    u64 bytes{};
+  };
+
+  /* Nothing is recorded until this is called. Until then, phase timers are a single
+   * relaxed load. */
+  void enable_phases();
+  bool phases_enabled();
+
+  phase_mark phase_now();
+  /* Records one top level form, from the start mark until now, including every phase
+   * within it. */
+  void record_form(jtl::immutable_string const &label, phase_mark const &start);
+
+  std::array<phase_stats, static_cast<usize>(phase::count)> phase_totals();
+  native_vector<form_stats> form_totals();
+
+  struct phase_timer
+  {
+    phase_timer() = delete;
+    phase_timer(phase const p);
+    phase_timer(phase_timer const &) = delete;
+    phase_timer(phase_timer &&) = delete;
+    ~phase_timer();
+
+    phase p;
+    bool active{};
+  };
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <jtl/result.hpp>
+
+#include <jank/type.hpp>
+
+/* An in-process sampling profiler, for when perf can't be run. A SIGPROF timer
+ * interrupts whichever thread is using the CPU and the handler walks its frame
+ * pointers. Symbolizing waits until the profiler is stopped, since it can't be done
+ * from a signal handler. JIT compiled fns are named from jit::symbols.
+ *
+ * Frames which don't keep a frame pointer end the walk early, wherever they are in the
+ * stack, so JIT compiled code should be built with --frame-pointers. */
+namespace jank::profile::sampler
+{
+  struct result
+  {
+    /* Each unique stack, root first, separated by semicolons, and how many samples had
+     * it. This is the folded format which flamegraph.pl and speedscope read. */
+    native_unordered_map<jtl::immutable_string, u64> stacks;
+    u64 samples{};
+    /* Samples which didn't fit into the buffer. */
+    u64 dropped{};
+  };
+
+  /* Only one profile can be running at a time. This gives an error if one already is. */
+  jtl::result<void, jtl::immutable_string> start(u32 const hz);
+  /* Stops the running profile, if any, and gives its samples. */
+  result stop();
+  bool is_running();
+
+  /* One line per stack, as "root;...;leaf count". */
+  jtl::immutable_string folded(result const &r);
+}
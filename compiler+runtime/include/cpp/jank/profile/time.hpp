@@ -5,6 +5,9 @@
 namespace jank::profile
 {
   void configure();
+  /* Closes out the profile file. This is registered to run at exit, but it's safe to call
+   * early. Nothing is recorded after it's called. */
+  void finish();
   bool is_enabled();
   void enter(jtl::immutable_string_view const &region);
   void exit(jtl::immutable_string_view const &region);
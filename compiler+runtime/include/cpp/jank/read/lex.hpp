@@ -153,7 +153,7 @@ namespace jank::read::lex
 
   /* Tokens have movable_positions, rather than just source_positions, which allows us to
    * increment them and add offsets. Doing this requires more than just math, since we need
-   * to step one byte at a time to find newline characters and update the line/col accordingly. */
+   * to find the newline characters we skip over and update the line/col accordingly. */
   struct movable_position : source_position
   {
     movable_position &operator++();
@@ -254,8 +254,23 @@ namespace jank::read::lex
       processor &p;
     };
 
+    /* Everything the lexer carries from one token to the next, so that lexing can be
+     * picked back up from between any two tokens, such as by the REPL's highlighter. */
+    struct state
+    {
+      bool operator==(state const &rhs) const;
+      bool operator!=(state const &rhs) const;
+
+      source_position pos;
+      bool require_space{};
+      bool found_slash_after_number{};
+    };
+
     processor(jtl::immutable_string_view const &f);
     processor(jtl::immutable_string_view const &f, usize offset);
+    processor(jtl::immutable_string_view const &f, state const &s);
+
+    state save() const;
 
     jtl::result<token, error_ref> next();
     jtl::result<codepoint, error_ref> peek(usize const ahead = 1) const;
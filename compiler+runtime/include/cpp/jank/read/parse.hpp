@@ -6,6 +6,7 @@
 
 #include <jtl/result.hpp>
 #include <jank/read/lex.hpp>
+#include <jank/read/reparse.hpp>
 #include <jank/runtime/object.hpp>
 #include <jank/runtime/var.hpp>
 
@@ -81,6 +82,8 @@ namespace jank::read::parse
     object_result parse_reader_macro_tagged();
     object_result parse_reader_macro_comment();
     object_result parse_reader_macro_conditional(bool splice);
+    /* Moves past the next form without building it. */
+    jtl::result<void, error_ref> skip_form(lex::token const &start_token);
     object_result parse_syntax_quote();
     object_result parse_unquote(bool splice);
     object_result parse_deref();
@@ -100,6 +103,11 @@ namespace jank::read::parse
     iterator end();
 
   private:
+    /* The source meta for a form, unless we're only reading data. */
+    jtl::option<runtime::object_ref>
+    form_meta(source_position const &start, source_position const &end) const;
+    /* For reparse_nth, which looks these up rather than reading the source again. */
+    void record_form_positions(lex::token const &start, native_vector<form_position> &&positions);
     jtl::result<runtime::object_ref, error_ref> syntax_quote(runtime::object_ref const form);
     jtl::result<runtime::object_ref, error_ref>
     syntax_quote_expand_seq(runtime::object_ref const seq);
@@ -113,8 +121,23 @@ namespace jank::read::parse
     lex::processor::iterator token_current, token_end;
     jtl::option<lex::token_kind> expected_closer;
     /* Splicing, in reader conditionals, is not allowed at the top level. When we're parsing
-     * some other form, such as a list, we'll bind this var to true. */
-    runtime::var_ref splicing_allowed_var;
+     * some other form, such as a list, we'll set this to true until we're done with it. */
+    bool splicing_allowed{};
+    /* When we're only reading data, rather than code which will be analyzed, we don't attach
+     * source info to each form, which is most of the cost of reading large collections. */
+    bool data_only{};
+    /* Data tends to use the same keys over and over, so, when reading data, we remember each
+     * keyword we've interned, by its source. Auto-resolved keywords depend on the current ns,
+     * so they're not kept. */
+    native_unordered_map<jtl::immutable_string_view, runtime::object_ref> keyword_cache;
+    /* Whether to record where each form within a list or vector is, for reparse_nth. Reparsing
+     * itself doesn't, since the file may be done loading by then. */
+    bool records_positions{ true };
+    /* The positions within the top level form we're reading. These are recorded together
+     * once that form is done, so we're not taking a lock for every list and vector. */
+    file_positions pending_positions;
+    /* How many lists and vectors we're within. */
+    usize collection_depth{};
     /* When we've spliced some forms, we'll put them into this list. Before reading the next
      * token, we should check this list to see if there's already a form we should pull out.
      * This is needed because parse iteration works one form at a time and splicing potentially
@@ -127,4 +150,15 @@ namespace jank::read::parse
     /* Whether or not the next form is considered syntax-quoted. */
     bool syntax_quoted{};
   };
+
+  /* Reads the first form in the code as plain data, like clojure.edn/read-string, giving nil
+   * when there's none. This is meant for large data payloads, rather than code, so the forms
+   * have no source info. */
+  jtl::result<runtime::object_ref, error_ref> read_data(jtl::immutable_string_view const &code);
+
+  /* Reads every form in the code as plain data, giving them in a vector, in order. Large
+   * code, such as an EDN log or fixture file, is split between its top level forms and the
+   * chunks are read at the same time on the pooled executor. */
+  jtl::result<runtime::object_ref, error_ref>
+  read_all_data(jtl::immutable_string_view const &code);
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <jtl/option.hpp>
+
 #include <jank/read/source.hpp>
 #include <jank/runtime/object.hpp>
 
@@ -17,9 +19,32 @@ namespace jank::runtime::obj
  *
  * To remedy this, when we have some code like `(def :foo 1)` and we want to point at
  * `:foo`, we take the full list, which we know has meta, and we go back to the source
- * to parse the nth form inside that list. That gives us the source for `:foo`. */
+ * to parse the nth form inside that list. That gives us the source for `:foo`.
+ *
+ * The parser records where each form within a list or vector from a file is, so reparsing
+ * is usually just a lookup. We only go back to the source when nothing was recorded. */
 namespace jank::read::parse
 {
+  /* Kept small, since there's one of these for nearly every form read from a file. */
+  struct form_position
+  {
+    u32 start_offset{}, start_line{}, start_col{};
+    u32 end_offset{}, end_line{}, end_col{};
+  };
+
+  /* The positions of the forms within each list or vector, by the offset of that list or
+   * vector within its file. */
+  using file_positions = native_unordered_map<usize, native_vector<form_position>>;
+
+  /* Records the positions read from the file, replacing anything recorded for the same
+   * spots before. */
+  void record_positions(jtl::immutable_string const &file, file_positions &&positions);
+  jtl::option<form_position>
+  find_position(jtl::immutable_string const &file, usize const offset, usize const n);
+  /* Drops everything recorded for the file. This is done once the file has been loaded,
+   * since its forms have been analyzed by then. */
+  void forget_positions(jtl::immutable_string const &file);
+
   source reparse_nth(runtime::obj::persistent_list_ref const o, usize n);
   source reparse_nth(runtime::obj::persistent_vector_ref const o, usize n);
   source reparse_nth(runtime::object_ref const o, usize n);
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <jtl/option.hpp>
+#include <jtl/result.hpp>
+
+#include <jank/error.hpp>
+#include <jank/runtime/object.hpp>
+
+namespace jank::read
+{
+  /* Reads forms from a file descriptor, such as a file, pipe, or socket, as they come in,
+   * rather than needing all of the source in memory up front. Only the source of the form
+   * being read is kept, so memory usage is bounded by the largest top-level form, not by
+   * the size of the stream.
+   *
+   * The lexer and parser still work on a contiguous buffer. When they reach the end of it
+   * partway through a form, we read more and start that form again. Each retry reads
+   * twice as much as the last, so a large form is still read in linear time.
+   *
+   * A reader keeps track of the line and col of each form, but the offsets in the source
+   * info of forms are relative to the start of the form's buffer. This isn't thread safe. */
+  struct stream_reader
+  {
+    static constexpr usize chunk_size{ 64 * 1024 };
+
+    /* When owns_fd is set, closing the reader closes the fd as well. */
+    stream_reader(int fd, bool owns_fd);
+    stream_reader(stream_reader const &) = delete;
+    stream_reader(stream_reader &&) noexcept = delete;
+    ~stream_reader();
+
+    stream_reader &operator=(stream_reader const &) = delete;
+    stream_reader &operator=(stream_reader &&) noexcept = delete;
+
+    /* Gives the next form, or none once the stream has ended. After an error, reading
+     * picks up after the erroneous source. */
+    jtl::result<jtl::option<runtime::object_ref>, error_ref> next();
+    void close();
+
+    /* Moves whatever is left after the head to the front of the buffer and then reads up
+     * to size more bytes onto the end. Hitting the end of the stream sets at_eof. */
+    jtl::result<void, error_ref> refill(usize size);
+
+    int fd{ -1 };
+    bool owns_fd{};
+    bool at_eof{};
+    native_vector<char> buffer;
+    /* Where, in the buffer, the next form starts. */
+    usize head{};
+    /* The line and col of the head. */
+    usize line{ 1 }, col{ 1 };
+  };
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+
+#include <jtl/result.hpp>
+
+#include <jank/type.hpp>
+
+namespace jank::runtime
+{
+  /* This is included by oref.hpp, so it can't include object.hpp. */
+  enum class object_type : u8;
+}
+
+/* Allocation tracking by jank call site. While tracking, one box is sampled every so many
+ * bytes on each thread, and the stack is unwound to find the jank fn which allocated it.
+ * That's the nearest JIT compiled frame, so allocations made within the runtime, such as
+ * by conj, are charged to the jank fn which called into it. Without a JIT compiled frame,
+ * the allocation is charged to wherever the box was made.
+ *
+ * Unlike the jank_profile_gc build option, this is always built in. When it's off, the
+ * cost is one relaxed load per box. */
+namespace jank::runtime::allocation_sites
+{
+  namespace detail
+  {
+    /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+    extern std::atomic<bool> is_tracking;
+  }
+
+  struct site
+  {
+    jtl::immutable_string fn;
+    object_type type{};
+    u64 samples{};
+    /* The total size of the sampled boxes. Each sample stands for interval bytes, though,
+     * so this is only useful for telling big boxes from small ones. */
+    u64 sampled_bytes{};
+  };
+
+  struct result
+  {
+    /* The most sampled first. */
+    native_vector<site> sites;
+    usize interval{};
+    u64 samples{};
+  };
+
+  /* Only one tracking session can run at a time. This gives an error if one already is. */
+  jtl::result<void, jtl::immutable_string> start(usize const interval);
+  /* Stops tracking, if it's running, and gives its samples. */
+  result stop();
+  bool is_tracking();
+
+  /* Called by make_box for every box, while tracking. */
+  void record(object_type const type, usize const size);
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+
+#include <jank/type.hpp>
+
+namespace jank::runtime
+{
+  /* A bump allocator for short lived work, like handling a single request. While one is
+   * active on a thread, make_box takes objects from it, rather than going through the GC's
+   * allocator for each one.
+   *
+   * The arena allocates its chunks from the GC, as normal scanned memory, and since the GC
+   * is configured to recognize interior pointers, a chunk stays alive for as long as any
+   * object within it is reachable. That means objects may freely escape the scope, by being
+   * returned or stored into an atom or var, without being copied out. The cost is that one
+   * escaped object keeps its whole chunk alive, so this is best for work which keeps very
+   * little of what it allocates.
+   *
+   * Arenas are per thread and they nest. They need to live on the stack, since the stack is
+   * what keeps the current chunk alive while it's being filled. */
+  struct arena
+  {
+    static constexpr usize chunk_size{ 64 * 1024 };
+    /* Anything bigger than this goes straight to the GC, so we don't waste most of a
+     * chunk on it. */
+    static constexpr usize max_object_size{ chunk_size / 16 };
+
+    arena();
+    arena(arena const &) = delete;
+    arena(arena &&) = delete;
+    ~arena();
+
+    arena &operator=(arena const &) = delete;
+    arena &operator=(arena &&) = delete;
+
+    [[gnu::malloc, gnu::returns_nonnull]]
+    void *allocate(usize size);
+
+    /* The arena which make_box uses on this thread, if any. */
+    static arena *current();
+
+    char *chunk{};
+    usize remaining{};
+    arena *previous{};
+  };
+
+  namespace detail
+  {
+    /* The number of arenas active across all threads. make_box checks this before looking
+     * up the current arena, so there's no thread local lookup on each allocation unless
+     * some thread is using an arena. */
+    /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+    extern std::atomic<u32> active_arenas;
+  }
+}
@@ -11,6 +11,8 @@ namespace jank::runtime
     using persistent_list_ref = oref<struct persistent_list>;
   }
 
+  using var_ref = oref<struct var>;
+
   constexpr usize const max_params{ 10 };
 
   struct variadic_tag
@@ -96,6 +98,15 @@ namespace jank::runtime
                           obj::persistent_list_ref const);
 
   object_ref apply_to(object_ref const source, object_ref const args);
+  /* The same as applying to the args consed onto args, without the conses. */
+  object_ref apply_to(object_ref const source, object_ref const a1, object_ref const args);
+  object_ref
+  apply_to(object_ref const source, object_ref const a1, object_ref const a2, object_ref const args);
+  object_ref apply_to(object_ref const source,
+                      object_ref const a1,
+                      object_ref const a2,
+                      object_ref const a3,
+                      object_ref const args);
 
   namespace behavior
   {
@@ -170,7 +181,9 @@ namespace jank::runtime
        *
        * We cannot perform the correct call without all of this information. Since function calls
        * are on the hottest path there is, we pack all of this into a single byte. Questions
-       * 1 and 2 each get a bit and question 3 gets 6 bits to store the fixed arg count.
+       * 1 and 2 each get a bit and question 3 gets the low 4 bits to store the fixed arg count.
+       * One more bit says whether the packed args stay local to the call, which lets them be
+       * packed on the caller's stack. See has_local_rest.
        *
        * From there, when we use it, we strip out the bit for question 2 and we switch/case on
        * the rest. This allows us to do a O(1) jump on the combination of whether it's variadic
@@ -208,11 +221,37 @@ namespace jank::runtime
         return (arity_flags & 0b01000000);
       }
 
+      /* Determines whether a call with the specified number of args will go straight to
+       * a fixed arity, rather than needing to be packed into a variadic arity. This matches
+       * the dispatch done by dynamic_call. */
+      static constexpr bool
+      is_fixed_arity_call(arity_flag_t const arity_flags, usize const arg_count)
+      {
+        if(!(arity_flags & 0b10000000))
+        {
+          return true;
+        }
+
+        auto const required_args(arity_flags & 0b00001111);
+        return arg_count < required_args
+          || (arg_count == required_args && is_variadic_ambiguous(arity_flags));
+      }
+
+      /* Set when escape analysis found that the variadic arity never lets its packed args,
+       * or any seq made from them, outlive the call. The caller can then pack them into an
+       * array seq on its own stack, rather than allocating one. */
+      static constexpr bool has_local_rest(arity_flag_t const arity_flags)
+      {
+        return (arity_flags & 0b00100000);
+      }
+
       static constexpr arity_flag_t build_arity_flags(u8 const highest_fixed_arity,
                                                       bool const is_variadic,
-                                                      bool const is_variadic_ambiguous)
+                                                      bool const is_variadic_ambiguous,
+                                                      bool const has_local_rest)
       {
-        return (is_variadic << 7) | (is_variadic_ambiguous << 6) | highest_fixed_arity;
+        return (is_variadic << 7) | (is_variadic_ambiguous << 6) | (has_local_rest << 5)
+          | highest_fixed_arity;
       }
     };
 
@@ -267,4 +306,8 @@ namespace jank::runtime
       { t->get_arity_flags() } -> std::convertible_to<size_t>;
     };
   }
+
+  /* Direct linked calls resolve the var once, through this, and then call the resulting
+   * callable without needing to deref the var or dispatch on the arity again. */
+  behavior::callable_ref direct_link(var_ref const var);
 }
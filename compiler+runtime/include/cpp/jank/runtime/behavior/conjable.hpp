@@ -14,4 +14,11 @@ namespace jank::runtime::behavior
   concept conjable_in_place = requires(T * const t) {
     { t->conj_in_place(object_ref{}) } -> std::convertible_to<object_ref>;
   };
+
+  /* Transients which can take a whole collection at once, rather than one element at a
+   * time. */
+  template <typename T>
+  concept conjable_all_in_place = requires(T * const t) {
+    { t->conj_all_in_place(object_ref{}) } -> std::convertible_to<object_ref>;
+  } && conjable_in_place<T>;
 }
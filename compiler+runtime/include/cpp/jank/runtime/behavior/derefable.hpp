@@ -6,4 +6,18 @@ namespace jank::runtime::behavior
   concept derefable = requires(T * const t) {
     { t->deref() } -> std::convertible_to<object_ref>;
   };
+
+  /* Blocking refs, like futures and promises, can also give up waiting after a timeout,
+   * in milliseconds, and give back the timeout value instead. This is IBlockingDeref. */
+  template <typename T>
+  concept blocking_derefable = requires(T * const t) {
+    { t->deref(i64{}, object_ref{}) } -> std::convertible_to<object_ref>;
+  };
+
+  /* Pending values know whether they've been produced yet, without needing to produce
+   * them. This is IPending, which backs realized?. */
+  template <typename T>
+  concept pending = requires(T const * const t) {
+    { t->is_realized() } -> std::convertible_to<bool>;
+  };
 }
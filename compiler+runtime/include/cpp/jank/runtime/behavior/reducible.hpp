@@ -0,0 +1,73 @@
+#pragma once
+
+#include <jank/runtime/object.hpp>
+#include <jank/runtime/behavior/callable.hpp>
+#include <jank/runtime/obj/reduced.hpp>
+#include <jank/runtime/rtti.hpp>
+
+namespace jank::runtime::behavior
+{
+  /* Reducible collections can reduce over their own data, without allocating a seq for
+   * each step. This is Clojure's IReduceInit. Implementations must stop as soon as the
+   * fn returns a reduced value, and return what it wraps. */
+  template <typename T>
+  concept reducible = requires(T * const t) {
+    { t->reduce(object_ref{}, object_ref{}) } -> std::convertible_to<object_ref>;
+  };
+
+  /* Like reducible, but for maps and vectors, with the fn called with each key and value
+   * separately, rather than with an entry. This is Clojure's IKVReduce. */
+  template <typename T>
+  concept kv_reducible = requires(T * const t) {
+    { t->reduce_kv(object_ref{}, object_ref{}) } -> std::convertible_to<object_ref>;
+  };
+}
+
+namespace jank::runtime::behavior::detail
+{
+  /* If a reducing fn's result is reduced, this unwraps it and returns true, meaning the
+   * reduction is done. */
+  inline bool unwrap_reduced(object_ref &res)
+  {
+    if(res->type != object_type::reduced)
+    {
+      return false;
+    }
+    res = expect_object<obj::reduced>(res)->val;
+    return true;
+  }
+
+  /* Reduces over any native range. The box fn turns each element into an object. */
+  template <typename It, typename B>
+  object_ref
+  reduce_range(object_ref const f, object_ref const init, It begin, It const end, B const &box)
+  {
+    object_ref res{ init };
+    for(; begin != end; ++begin)
+    {
+      res = dynamic_call(f, res, box(*begin));
+      if(unwrap_reduced(res))
+      {
+        break;
+      }
+    }
+    return res;
+  }
+
+  /* Reduces over a native range of key/value pairs. */
+  template <typename It>
+  object_ref reduce_kv_range(object_ref const f, object_ref const init, It begin, It const end)
+  {
+    object_ref res{ init };
+    for(; begin != end; ++begin)
+    {
+      auto const &entry{ *begin };
+      res = dynamic_call(f, res, entry.first, entry.second);
+      if(unwrap_reduced(res))
+      {
+        break;
+      }
+    }
+    return res;
+  }
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <array>
+
+#include <jtl/string_builder.hpp>
+
+#include <jank/runtime/object.hpp>
+
+namespace jank::runtime
+{
+  /* A table of the most common behaviors of one object type, as plain function pointers.
+   * Every visit_object call site instantiates its visitor for each of our object types, so
+   * generic helpers which only want to hash, compare, print, or seq something end up as
+   * huge switches, and there are many copies of each. Dispatching through these tables
+   * instead is one indexed load and an indirect call, with each behavior compiled once per
+   * type, in behavior_table.cpp.
+   *
+   * Use visit_object whenever the typed object is needed for more than one of these, or
+   * for anything which benefits from inlining across the dispatch.
+   *
+   * The optional behaviors are null for types which don't have them. */
+  struct behavior_table
+  {
+    uhash (*to_hash)(object *o);
+    bool (*equal)(object *o, object const &rhs);
+    void (*to_string)(object *o, jtl::string_builder &buff);
+    void (*to_code_string)(object *o, jtl::string_builder &buff);
+
+    /* behavior::seqable. nil is its own seq, and it's empty. */
+    object_ref (*seq)(object *o);
+    object_ref (*fresh_seq)(object *o);
+    /* behavior::countable. nil counts as empty. */
+    usize (*count)(object *o);
+    /* behavior::associatively_readable */
+    object_ref (*get)(object *o, object_ref key);
+    object_ref (*get_default)(object *o, object_ref key, object_ref fallback);
+  };
+
+  /* Indexed by object_type. These are constant initialized, so they're usable at any
+   * point, even during static initialization. */
+  extern std::array<behavior_table, object_type_count> const behavior_tables;
+
+  [[gnu::hot]]
+  inline behavior_table const &behaviors_of(object_ref const o)
+  {
+    return behavior_tables[static_cast<usize>(o->type)];
+  }
+}
@@ -6,9 +6,13 @@
 
 #include <jtl/result.hpp>
 #include <jank/analyze/processor.hpp>
+#include <jank/runtime/macroexpand_cache.hpp>
 #include <jank/runtime/module/loader.hpp>
+#include <jank/runtime/module/reload.hpp>
 #include <jank/runtime/ns.hpp>
 #include <jank/runtime/var.hpp>
+#include <jank/runtime/detail/intern_table.hpp>
+#include <jank/runtime/detail/name_index.hpp>
 #include <jank/jit/processor.hpp>
 #include <jank/util/cli.hpp>
 
@@ -77,11 +81,22 @@ namespace jank::runtime
     jtl::result<obj::keyword_ref, jtl::immutable_string>
     intern_keyword(jtl::immutable_string const &s);
 
+    /* Gives the one symbol with this ns and name, which has no meta. Symbols are usually
+     * made fresh, since each one read from code has its own source meta, but lookups made
+     * by the runtime use these, so they can often be matched by identity. Interned symbols
+     * are shared, so they must never be changed in place. */
+    obj::symbol_ref
+    intern_symbol(jtl::immutable_string const &ns, jtl::immutable_string const &name);
+    obj::symbol_ref intern_symbol(jtl::immutable_string const &s);
+
     object_ref macroexpand1(object_ref const o);
     object_ref macroexpand(object_ref const o);
 
     jtl::option<object_ref> eval_file(jtl::immutable_string const &path);
-    jtl::option<object_ref> eval_string(jtl::immutable_string const &code);
+    /* With batch set, and --batch-jit enabled, each run of top-level fn defs is held back
+     * and JIT compiled as one module. Files are evaluated this way. */
+    jtl::option<object_ref>
+    eval_string(jtl::immutable_string const &code, bool const batch = false);
     jtl::result<void, error_ref> eval_cpp_string(jtl::immutable_string const &code) const;
     object_ref read_string(jtl::immutable_string const &code);
     native_vector<analyze::expression_ref>
@@ -107,9 +122,14 @@ namespace jank::runtime
     object_ref eval(object_ref const o);
 
     jtl::immutable_string get_output_module_name(jtl::immutable_string const &module_name) const;
+    /* With -j, object files are emitted in the background, so they may not exist yet
+     * when this returns. */
     jtl::string_result<void> write_module(jtl::immutable_string const &module_name,
                                           jtl::immutable_string const &cpp_code,
                                           jtl::ref<llvm::Module> const &module) const;
+    /* Waits for any object files still being emitted. If any of them failed, the error
+     * describes every failure. */
+    jtl::string_result<void> wait_for_modules() const;
 
     /* Generates a unique name for use with anything from codgen structs,
      * lifted vars, to shadowed locals. Prefixes with current namespace. */
@@ -120,8 +140,12 @@ namespace jank::runtime
     obj::symbol_ref unique_symbol() const;
     obj::symbol_ref unique_symbol(jtl::immutable_string const &prefix) const;
 
-    folly::Synchronized<native_unordered_map<obj::symbol_ref, ns_ref>> namespaces;
-    folly::Synchronized<native_unordered_map<jtl::immutable_string, obj::keyword_ref>> keywords;
+    /* All of these are keyed on the ns and name of the symbol or keyword. */
+    detail::intern_table<ns_ref> namespaces;
+    detail::intern_table<obj::keyword_ref> keywords;
+    detail::intern_table<obj::symbol_ref> symbols;
+    /* The names of the namespaces, vars, and keywords above, sorted for completion. */
+    detail::name_index names;
 
     struct binding_scope
     {
@@ -137,12 +161,6 @@ namespace jank::runtime
     obj::persistent_hash_map_ref get_thread_bindings() const;
     jtl::option<thread_binding_frame> current_thread_binding_frame();
 
-    /* The analyze processor is reused across evaluations so we can keep the semantic information
-     * of previous code. This is essential for REPL use.
-     *
-     * TODO: Is it? I think we can remove this. */
-    /* TODO: This needs to be synchronized, if it's kept. */
-    analyze::processor an_prc;
     jtl::immutable_string binary_version;
     /* TODO: This needs to be a dynamic var. */
     native_unordered_map<jtl::immutable_string, native_vector<jtl::immutable_string>>
@@ -150,6 +168,8 @@ namespace jank::runtime
     folly::Synchronized<native_deque<jtl::immutable_string>> loaded_modules_in_order;
     jtl::immutable_string binary_cache_dir;
     module::loader module_loader;
+    module::reloader module_reloader;
+    macroexpand_cache macro_cache;
 
     var_ref current_file_var;
     var_ref current_ns_var;
@@ -158,10 +178,15 @@ namespace jank::runtime
     var_ref loaded_libs_var;
     var_ref current_module_var;
     var_ref assert_var;
+    var_ref print_length_var;
+    var_ref print_level_var;
     var_ref no_recur_var;
     var_ref gensym_env_var;
 
     static thread_local native_list<thread_binding_frame> thread_binding_frames;
+    /* Bumped on every push and pop of this thread's binding frames, so lookups cached
+     * against the current frame can tell when they've gone stale. */
+    static thread_local u64 thread_binding_frame_version;
 
     /* This must go last, since it'll try to access other bits in the runtime context during
      * its initialization and we need them to be ready. */
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <span>
+
 #include <jank/runtime/convert.hpp>
 #include <jank/runtime/object.hpp>
 #include <jank/runtime/detail/type.hpp>
@@ -7,6 +9,8 @@
 #include <jank/runtime/obj/nil.hpp>
 #include <jank/runtime/obj/number.hpp>
 #include <jank/runtime/obj/persistent_vector.hpp>
+#include <jank/runtime/obj/array.hpp>
+#include <jank/runtime/obj/native_array_sequence.hpp>
 #include <jank/runtime/core/make_box.hpp>
 
 namespace jank::runtime
@@ -313,4 +317,62 @@ namespace jank::runtime
       return ret;
     }
   };
+
+  /* Spans are views, so neither direction copies any elements. A span of objects becomes a
+   * seq over its storage and a span of primitives becomes an array which borrows it. That
+   * storage needs to outlive the object, and the GC doesn't see objects in it, so they
+   * need to be held elsewhere too. Going the other way, an array with the matching
+   * element type gives a span over its own storage and so does a small vector, for
+   * spans of const objects. */
+  template <typename T>
+  requires(obj::array::is_element<std::remove_const_t<T>>
+           && (jtl::is_same<std::remove_const_t<T>, object_ref> || !std::is_const_v<T>))
+  struct convert<std::span<T>>
+  {
+    using element_type = std::remove_const_t<T>;
+
+    static object_ref into_object(std::span<T> const o)
+    {
+      if constexpr(jtl::is_same<element_type, object_ref>)
+      {
+        if(o.empty())
+        {
+          return jank_nil();
+        }
+        /* Seqs never write through this. */
+        return make_box<obj::native_array_sequence>(const_cast<object_ref *>(o.data()),
+                                                    o.size());
+      }
+      else
+      {
+        return make_box<obj::array>(obj::array::element_type_of<element_type>(),
+                                    o.data(),
+                                    o.size());
+      }
+    }
+
+    static std::span<T> from_object(object_ref const o)
+    {
+      if constexpr(std::is_const_v<T>)
+      {
+        if(o->type == object_type::persistent_vector)
+        {
+          auto const data(expect_object<obj::persistent_vector>(o)->contiguous_data());
+          if(data.is_none())
+          {
+            throw std::runtime_error{ "This vector isn't stored contiguously, so it can't be "
+                                      "viewed as a span." };
+          }
+          return data.unwrap();
+        }
+      }
+
+      auto const a(try_object<obj::array>(o));
+      if(a->element != obj::array::element_type_of<element_type>())
+      {
+        throw std::runtime_error{ "This array's element type doesn't match the span." };
+      }
+      return { a->data_as<element_type>(), a->length };
+    }
+  };
 }
@@ -1,7 +1,5 @@
 #pragma once
 
-#include <regex>
-
 /* TODO: Remove these so that people include only what they need. */
 #include <jank/runtime/core/make_box.hpp>
 #include <jank/runtime/core/to_string.hpp>
@@ -9,6 +7,9 @@
 #include <jank/runtime/core/truthy.hpp>
 #include <jank/runtime/core/munge.hpp>
 #include <jank/runtime/core/math.hpp>
+#include <jank/runtime/core/monitor.hpp>
+#include <jank/runtime/transaction.hpp>
+#include <jank/runtime/regex.hpp>
 
 namespace jank::runtime
 {
@@ -31,6 +32,13 @@ namespace jank::runtime
   object_ref println(object_ref const args);
   object_ref pr(object_ref const args);
   object_ref prn(object_ref const args);
+  /* Like print and pr, but giving the string. These follow *print-length* and
+   * *print-level*, as the printing fns do, unlike to_string and to_code_string. */
+  jtl::immutable_string print_str(object_ref const args);
+  jtl::immutable_string pr_str(object_ref const args);
+  /* Calls f, giving back everything it printed on this thread. Printing from other
+   * threads, such as within futures it starts, still goes to stdout. */
+  jtl::immutable_string with_out_str(object_ref const f);
 
   obj::persistent_string_ref subs(object_ref const s, object_ref const start);
   obj::persistent_string_ref subs(object_ref const s, object_ref const start, object_ref const end);
@@ -57,6 +65,10 @@ namespace jank::runtime
 
   object_ref atom(object_ref const o);
   object_ref deref(object_ref const o);
+  /* Only blocking refs, like futures and promises, support a timeout. Anything else
+   * derefable is derefed without one. */
+  object_ref
+  deref(object_ref const o, object_ref const timeout_ms, object_ref const timeout_val);
   object_ref swap_atom(object_ref const atom, object_ref const fn);
   object_ref swap_atom(object_ref const atom, object_ref const fn, object_ref const a1);
   object_ref
@@ -92,6 +104,54 @@ namespace jank::runtime
 
   object_ref force(object_ref const o);
 
+  object_ref eduction(object_ref const xform, object_ref const coll);
+
+  object_ref future_call(object_ref const fn);
+  bool is_future(object_ref const o);
+  bool is_future_done(object_ref const o);
+  bool future_cancel(object_ref const o);
+  bool is_future_cancelled(object_ref const o);
+
+  object_ref promise();
+  bool is_promise(object_ref const o);
+  /* Gives back the promise, if this was the first delivery, or nil otherwise. */
+  object_ref deliver(object_ref const p, object_ref const v);
+  object_ref on_deliver(object_ref const p, object_ref const f);
+  bool is_realized(object_ref const o);
+
+  object_ref agent(object_ref const state);
+  bool is_agent(object_ref const o);
+  /* Sends run on the pooled executor and sends off on the solo executor. Sends via
+   * take either :pooled or :solo, since executors aren't jank objects. */
+  object_ref send(object_ref const a, object_ref const fn, object_ref const args);
+  object_ref send_off(object_ref const a, object_ref const fn, object_ref const args);
+  object_ref send_via(object_ref const executor,
+                      object_ref const a,
+                      object_ref const fn,
+                      object_ref const args);
+  i64 release_pending_sends();
+  object_ref agent_error(object_ref const a);
+  object_ref
+  restart_agent(object_ref const a, object_ref const new_state, bool const clear_actions);
+  object_ref set_error_handler(object_ref const a, object_ref const fn);
+  object_ref error_handler(object_ref const a);
+  object_ref set_error_mode(object_ref const a, object_ref const mode);
+  object_ref error_mode(object_ref const a);
+  void shutdown_agents();
+
+  object_ref ref(object_ref const val);
+  bool is_ref(object_ref const o);
+  object_ref ref_set(object_ref const r, object_ref const val);
+  object_ref alter(object_ref const r, object_ref const fn, object_ref const args);
+  object_ref commute(object_ref const r, object_ref const fn, object_ref const args);
+  object_ref ensure(object_ref const r);
+  i64 ref_history_count(object_ref const r);
+  i64 ref_min_history(object_ref const r);
+  object_ref ref_min_history(object_ref const r, object_ref const n);
+  i64 ref_max_history(object_ref const r);
+  object_ref ref_max_history(object_ref const r, object_ref const n);
+  i64 available_processors();
+
   object_ref tagged_literal(object_ref const tag, object_ref const form);
   bool is_tagged_literal(object_ref const o);
 
@@ -107,7 +167,10 @@ namespace jank::runtime
   object_ref re_find(object_ref const m);
   object_ref re_groups(object_ref const m);
   object_ref re_matches(object_ref const re, object_ref const s);
-  object_ref smatch_to_vector(std::smatch const &match_results);
+  /* Gives what re-groups would for these groups: the whole match if there are no capturing
+   * groups, otherwise a vector of the whole match and then each group. */
+  object_ref regex_groups(jtl::immutable_string const &input,
+                          native_vector<regex::span> const &groups);
 
   object_ref add_watch(object_ref const reference, object_ref const key, object_ref const fn);
   object_ref remove_watch(object_ref const reference, object_ref const key);
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <jank/runtime/obj/array.hpp>
+
+/* Bulk numeric operations over typed arrays, which back jank.math. Each one works through
+ * the unboxed elements in a tight loop, which the compiler vectorizes. On x86_64, each
+ * kernel is also built for AVX2 and AVX-512, and the best version for the CPU is picked at
+ * load time.
+ *
+ * Arrays need a numeric element type. For operations over more than one array, the arrays
+ * need the same element type and length. Integer arithmetic wraps, like Java's. */
+namespace jank::runtime::array_math
+{
+  obj::array_ref add(object_ref const l, object_ref const r);
+  obj::array_ref mul(object_ref const l, object_ref const r);
+  /* (a * b) + c, for each element. */
+  obj::array_ref fma(object_ref const a, object_ref const b, object_ref const c);
+
+  /* These give a long for integer arrays and a double for floating point arrays. */
+  object_ref dot(object_ref const l, object_ref const r);
+  object_ref sum(object_ref const a);
+  /* These give nil for an empty array. */
+  object_ref min(object_ref const a);
+  object_ref max(object_ref const a);
+
+  /* These work on a single number, like their clojure.core counterparts, or on each element
+   * of an array. The sqrt and pow of an integer array is a double array. */
+  object_ref sqrt(object_ref const o);
+  object_ref pow(object_ref const o, object_ref const exponent);
+  object_ref abs(object_ref const o);
+}
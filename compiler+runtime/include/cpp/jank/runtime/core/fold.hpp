@@ -0,0 +1,18 @@
+#pragma once
+
+#include <jank/runtime/object.hpp>
+
+namespace jank::runtime
+{
+  /* A parallel reduce, as in clojure.core.reducers/fold. Vectors, hash maps, integer ranges,
+   * and arrays are split structurally, without being turned into seqs, into groups of
+   * roughly n elements. Each group is reduced with reducef on the pooled executor, seeded
+   * with (combinef), and the results are combined in order with combinef. Maps are reduced
+   * with (reducef acc k v).
+   *
+   * Any other collection is reduced sequentially on the calling thread. */
+  object_ref fold(object_ref const n,
+                  object_ref const combinef,
+                  object_ref const reducef,
+                  object_ref const coll);
+}
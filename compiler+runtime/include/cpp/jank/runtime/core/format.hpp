@@ -0,0 +1,15 @@
+#pragma once
+
+#include <jank/runtime/object.hpp>
+
+namespace jank::runtime
+{
+  /* Formats the args with a format string in the syntax of java.util.Formatter, which is
+   * what clojure.core/format takes. This supports the common conversions, which are
+   * %s, %S, %d, %x, %X, %o, %f, %e, %E, %g, %G, %c, %b, %B, %h, %n, and %%, along with
+   * arg indices, flags, widths, and precisions. Dates aren't supported.
+   *
+   * Each format string is parsed once and then kept, so formatting with a literal format
+   * string, as is usual, only pays for the args. */
+  jtl::immutable_string format(object_ref const fmt, object_ref const args);
+}
@@ -105,7 +105,7 @@ namespace jank::runtime
   [[gnu::flatten, gnu::hot, gnu::visibility("default")]]
   inline auto make_box(T const d)
   {
-    return make_box<obj::integer>(d);
+    return make_box<obj::integer>(static_cast<i64>(d));
   }
 
   template <typename T>
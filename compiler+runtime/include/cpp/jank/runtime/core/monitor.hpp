@@ -0,0 +1,19 @@
+#pragma once
+
+#include <jank/runtime/object.hpp>
+
+namespace jank::runtime
+{
+  /* Monitors back clojure.core/locking. Any object can be locked, without it needing any
+   * space of its own for a lock, since objects are mapped by address onto a fixed table of
+   * lock stripes. Locking is reentrant, the same as JVM monitors.
+   *
+   * Contended locks spin briefly before parking the thread, since the critical sections
+   * which use locking tend to be small. Unrelated objects may share a stripe, which costs
+   * some contention. It also means that threads which each hold one monitor while taking
+   * another can deadlock on a stripe, even with a consistent lock order, so nesting
+   * locking on different objects is best avoided. */
+  void monitor_enter(object_ref const o);
+  /* Throws if the current thread doesn't hold the monitor. */
+  void monitor_exit(object_ref const o);
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <limits>
+
+#include <jank/runtime/object.hpp>
+
+namespace jank::runtime
+{
+  /* wyrand, which is a 64 bit PRNG with a single word of state. It's a handful of
+   * instructions per number and passes BigCrush, which is plenty for rand, shuffle, and
+   * the like. It's not for cryptography.
+   *
+   * This meets UniformRandomBitGenerator, so it works with std::shuffle and the std
+   * distributions. */
+  struct random_generator
+  {
+    using result_type = u64;
+
+    static constexpr result_type min()
+    {
+      return 0;
+    }
+
+    static constexpr result_type max()
+    {
+      return std::numeric_limits<result_type>::max();
+    }
+
+    result_type operator()()
+    {
+      state += 0xa0761d6478bd642fULL;
+      auto const product{ static_cast<unsigned __int128>(state)
+                          * (state ^ 0xe7037ed1a0b428dbULL) };
+      return static_cast<u64>(product >> 64) ^ static_cast<u64>(product);
+    }
+
+    u64 state{};
+  };
+
+  /* Each thread has its own generator, so nothing is shared between threads. Each starts
+   * from a different seed, unless it's been seeded. */
+  random_generator &thread_random();
+  /* Reseeds the calling thread's generator, so what it gives from then on is the same with
+   * each run. */
+  void seed_thread_random(u64 const seed);
+
+  /* Uniform in [0, 1). */
+  f64 random_real();
+  /* Uniform in [0, n), without any modulo bias. n must not be 0. */
+  u64 random_below(u64 const n);
+
+  object_ref seed_random(object_ref const seed);
+  /* A vector of n random uuids, which is quicker than calling random-uuid n times. */
+  object_ref random_uuids(object_ref const n);
+}
@@ -90,10 +90,14 @@ namespace jank::runtime
   bool is_counted(object_ref const o);
   bool is_transientable(object_ref const o);
   bool is_sorted(object_ref const o);
+  object_ref sorted_seq(object_ref const coll, object_ref const ascending);
+  object_ref
+  sorted_seq_from(object_ref const coll, object_ref const key, object_ref const ascending);
 
   object_ref transient(object_ref const o);
   object_ref persistent(object_ref const o);
   object_ref conj_in_place(object_ref const coll, object_ref const o);
+  object_ref conj_all_in_place(object_ref const coll, object_ref const from);
   object_ref disj_in_place(object_ref const coll, object_ref const o);
 
   template <typename T>
@@ -129,8 +133,13 @@ namespace jank::runtime
   object_ref merge(object_ref const m, object_ref const other);
   object_ref merge_in_place(object_ref const m, object_ref const other);
   object_ref subvec(object_ref const o, i64 start, i64 end);
+  /* The items of l followed by those of r, in a vector with the meta of l. */
+  object_ref concat_vectors(object_ref const l, object_ref const r);
   object_ref nth(object_ref const o, object_ref const idx);
   object_ref nth(object_ref const o, object_ref const idx, object_ref const fallback);
+  /* The seq of what's after the first n items, or nil if there's nothing after them. Vectors
+   * give a seq which starts at n right away. */
+  object_ref nthnext(object_ref const o, i64 const n);
   object_ref peek(object_ref const o);
   object_ref pop(object_ref const o);
   object_ref empty(object_ref const o);
@@ -147,6 +156,15 @@ namespace jank::runtime
   usize sequence_length(object_ref const s, usize const max);
 
   object_ref reduce(object_ref const f, object_ref const init, object_ref const s);
+  object_ref reduce_kv(object_ref const f, object_ref const init, object_ref const coll);
+  object_ref zipmap(object_ref const keys, object_ref const vals);
+  object_ref frequencies(object_ref const coll);
+  object_ref group_by(object_ref const f, object_ref const coll);
+  /* Merges other into m, calling f with both values for each key they share. */
+  object_ref merge_with(object_ref const f, object_ref const m, object_ref const other);
+  /* These only handle hash maps, and give nil for anything else. */
+  object_ref update_vals(object_ref const m, object_ref const f);
+  object_ref update_keys(object_ref const m, object_ref const f);
   object_ref reduced(object_ref const o);
   bool is_reduced(object_ref const o);
 
@@ -158,6 +176,9 @@ namespace jank::runtime
   object_ref chunk_rest(object_ref const o);
   object_ref chunk_cons(object_ref const chunk, object_ref const rest);
   bool is_chunked_seq(object_ref const o);
+  /* Whether doseq can walk the coll with a plain loop over its indices, using count and
+   * nth, which are both constant time for these. */
+  bool is_index_loopable(object_ref const o);
 
   object_ref iterate(object_ref const fn, object_ref const o);
 
@@ -165,6 +186,10 @@ namespace jank::runtime
   object_ref repeat(object_ref const n, object_ref const val);
 
   object_ref sort(object_ref const coll);
+  /* comp can give a number, like compare, or a boolean, like <. */
+  object_ref sort(object_ref const comp, object_ref const coll);
+  object_ref sort_by(object_ref const keyfn, object_ref const coll);
+  object_ref sort_by(object_ref const keyfn, object_ref const comp, object_ref const coll);
 
   object_ref shuffle(object_ref const coll);
 }
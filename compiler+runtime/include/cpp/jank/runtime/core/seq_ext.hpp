@@ -5,6 +5,7 @@
 #include <jank/runtime/behavior/seqable.hpp>
 #include <jank/runtime/core/equal.hpp>
 #include <jank/runtime/sequence_range.hpp>
+#include <jank/util/fmt.hpp>
 
 /* TODO: Why does this not live in seq.hpp again? Document if you find out. */
 namespace jank::runtime
@@ -43,6 +44,48 @@ namespace jank::runtime
       end);
   }
 
+  /* Calls the fn with each element of the coll, which may be anything seqable, or a chunk.
+   * Vectors and chunks are walked directly, rather than through a seq. */
+  template <typename F>
+  void for_each(object_ref const coll, F const &fn)
+  {
+    visit_object(
+      [](auto const typed_coll, F const &fn) -> void {
+        using T = typename jtl::decay_t<decltype(typed_coll)>::value_type;
+
+        if constexpr(std::same_as<T, obj::nil>)
+        {
+        }
+        else if constexpr(std::same_as<T, obj::persistent_vector>)
+        {
+          for(auto const e : typed_coll->data)
+          {
+            fn(e);
+          }
+        }
+        else if constexpr(std::same_as<T, obj::array_chunk>)
+        {
+          for(auto i(typed_coll->offset); i < typed_coll->buffer.size(); ++i)
+          {
+            fn(typed_coll->buffer[i]);
+          }
+        }
+        else if constexpr(behavior::seqable<T>)
+        {
+          for(auto const e : make_sequence_range(typed_coll))
+          {
+            fn(e);
+          }
+        }
+        else
+        {
+          throw std::runtime_error{ util::format("not seqable: {}", typed_coll->to_code_string()) };
+        }
+      },
+      coll,
+      fn);
+  }
+
   template <typename T>
   requires behavior::sequenceable<T>
   auto rest(oref<T> const &seq)
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <jtl/option.hpp>
+
 #include <jank/runtime/object.hpp>
 #include <jank/runtime/behavior/seqable.hpp>
 
@@ -8,8 +10,77 @@ namespace jank::runtime
   object_ref first(object_ref const s);
   object_ref next(object_ref const s);
 
+  /* *print-length* and *print-level* are only followed while a print_limits_scope is alive,
+   * which the printing fns, like pr and pr-str, open. Plain to_string and to_code_string
+   * ignore them, since the compiler relies on being able to turn any value into a string and
+   * read it back. The vars are read once, when the scope opens, and then followed while
+   * walking the data, so nested collections don't each deref them. */
+  struct print_limits_scope
+  {
+    print_limits_scope();
+    print_limits_scope(print_limits_scope const &) = delete;
+    print_limits_scope(print_limits_scope &&) noexcept = delete;
+    ~print_limits_scope();
+
+    print_limits_scope &operator=(print_limits_scope const &) = delete;
+    print_limits_scope &operator=(print_limits_scope &&) noexcept = delete;
+
+    /* Prints can nest, if a to_string ends up printing, so we put back whatever was there. */
+    jtl::option<usize> previous_length, previous_level;
+    usize previous_depth{};
+  };
+
+  namespace detail
+  {
+    struct print_state
+    {
+      jtl::option<usize> length, level;
+      /* How many collections deep the current walk is. */
+      usize depth{};
+    };
+
+    print_state &current_print_state();
+
+    /* Opened by each collection as it's printed, to follow *print-level* and
+     * *print-length*. */
+    struct print_collection_scope
+    {
+      print_collection_scope()
+        : state{ current_print_state() }
+        , too_deep{ state.level.is_some() && state.depth >= state.level.unwrap() }
+      {
+        ++state.depth;
+      }
+
+      print_collection_scope(print_collection_scope const &) = delete;
+      print_collection_scope(print_collection_scope &&) noexcept = delete;
+
+      ~print_collection_scope()
+      {
+        --state.depth;
+      }
+
+      print_collection_scope &operator=(print_collection_scope const &) = delete;
+      print_collection_scope &operator=(print_collection_scope &&) noexcept = delete;
+
+      /* Whether we've already printed as many elements as we're allowed to. */
+      bool is_too_long(usize const printed) const
+      {
+        return state.length.is_some() && printed >= state.length.unwrap();
+      }
+
+      print_state &state;
+      /* When set, the collection is printed as just #. */
+      bool const too_deep{};
+    };
+  }
+
   jtl::immutable_string to_string(object_ref const o);
   void to_string(char ch, jtl::string_builder &buff);
+  /* About how many bytes to_string will write for the object, for sizing a buffer up front.
+   * This is exact for strings and characters and a guess for everything else, since it
+   * must be much cheaper than printing. */
+  usize to_string_size(object_ref const o);
   void to_string(object_ref const o, jtl::string_builder &buff);
 
   jtl::immutable_string to_code_string(object_ref const o);
@@ -30,18 +101,30 @@ namespace jank::runtime
                  char const close,
                  jtl::string_builder &buff)
   {
+    detail::print_collection_scope const scope;
+    if(scope.too_deep)
+    {
+      buff('#');
+      return;
+    }
+
     for(auto const c : open)
     {
       buff(c);
     }
-    for(auto i(begin); i != end; ++i)
+    usize printed{};
+    for(auto i(begin); i != end; ++i, ++printed)
     {
-      runtime::to_string(*i, buff);
-      auto n(i);
-      if(++n != end)
+      if(printed != 0)
       {
         buff(' ');
       }
+      if(scope.is_too_long(printed))
+      {
+        buff("...");
+        break;
+      }
+      runtime::to_string(*i, buff);
     }
     buff(close);
   }
@@ -56,30 +139,45 @@ namespace jank::runtime
       return;
     }
 
+    detail::print_collection_scope const scope;
+    if(scope.too_deep)
+    {
+      buff('#');
+      return;
+    }
+
     buff('(');
-    bool needs_space{};
+    usize printed{};
     if constexpr(behavior::sequenceable_in_place<T>)
     {
-      for(auto it{ s->fresh_seq() }; it.is_some(); it = it->next_in_place())
+      for(auto it{ s->fresh_seq() }; it.is_some(); it = it->next_in_place(), ++printed)
       {
-        if(needs_space)
+        if(printed != 0)
         {
           buff(' ');
         }
+        if(scope.is_too_long(printed))
+        {
+          buff("...");
+          break;
+        }
         runtime::to_string(it->first(), buff);
-        needs_space = true;
       }
     }
     else
     {
-      for(object_ref it{ s->seq() }; it.is_some(); it = runtime::next(it))
+      for(object_ref it{ s->seq() }; it.is_some(); it = runtime::next(it), ++printed)
       {
-        if(needs_space)
+        if(printed != 0)
         {
           buff(' ');
         }
+        if(scope.is_too_long(printed))
+        {
+          buff("...");
+          break;
+        }
         runtime::to_string(runtime::first(it), buff);
-        needs_space = true;
       }
     }
     buff(')');
@@ -98,7 +196,17 @@ namespace jank::runtime
   requires(behavior::object_like<T> && !behavior::sequenceable<T>)
   void to_code_string(oref<T> const &s, jtl::string_builder &buff)
   {
-    buff(s->to_code_string());
+    /* Anything which can be nested, or which has a code string that differs from its
+     * string, writes straight into the builder. The rest only print their own name or
+     * address, so going through a string doesn't cost much. */
+    if constexpr(requires { s->to_code_string(buff); })
+    {
+      s->to_code_string(buff);
+    }
+    else
+    {
+      buff(s->to_code_string());
+    }
   }
 
   template <typename It>
@@ -108,18 +216,30 @@ namespace jank::runtime
                       char const close,
                       jtl::string_builder &buff)
   {
+    detail::print_collection_scope const scope;
+    if(scope.too_deep)
+    {
+      buff('#');
+      return;
+    }
+
     for(auto const c : open)
     {
       buff(c);
     }
-    for(auto i(begin); i != end; ++i)
+    usize printed{};
+    for(auto i(begin); i != end; ++i, ++printed)
     {
-      runtime::to_code_string(*i, buff);
-      auto n(i);
-      if(++n != end)
+      if(printed != 0)
       {
         buff(' ');
       }
+      if(scope.is_too_long(printed))
+      {
+        buff("...");
+        break;
+      }
+      runtime::to_code_string(*i, buff);
     }
     buff(close);
   }
@@ -134,30 +254,47 @@ namespace jank::runtime
       return;
     }
 
+    detail::print_collection_scope const scope;
+    if(scope.too_deep)
+    {
+      buff('#');
+      return;
+    }
+
+    /* With *print-length*, this is what lets us print infinite sequences, since we stop
+     * realizing them once we've printed enough. */
     buff('(');
-    bool needs_space{};
+    usize printed{};
     if constexpr(behavior::sequenceable_in_place<T>)
     {
-      for(auto it{ s->fresh_seq() }; it.is_some(); it = it->next_in_place())
+      for(auto it{ s->fresh_seq() }; it.is_some(); it = it->next_in_place(), ++printed)
       {
-        if(needs_space)
+        if(printed != 0)
         {
           buff(' ');
         }
+        if(scope.is_too_long(printed))
+        {
+          buff("...");
+          break;
+        }
         runtime::to_code_string(it->first(), buff);
-        needs_space = true;
       }
     }
     else
     {
-      for(object_ref it{ s->seq() }; it.is_some(); it = runtime::next(it))
+      for(object_ref it{ s->seq() }; it.is_some(); it = runtime::next(it), ++printed)
       {
-        if(needs_space)
+        if(printed != 0)
         {
           buff(' ');
         }
+        if(scope.is_too_long(printed))
+        {
+          buff("...");
+          break;
+        }
         runtime::to_code_string(runtime::first(it), buff);
-        needs_space = true;
       }
     }
     buff(')');
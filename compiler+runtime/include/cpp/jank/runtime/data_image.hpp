@@ -0,0 +1,84 @@
+#pragma once
+
+#include <jank/runtime/object.hpp>
+
+namespace jank::runtime
+{
+  /* A data image holds a tree of jank data in a file which is mapped into memory as is, so
+   * opening one doesn't read or parse any of it, no matter how big it is. Its maps and
+   * vectors are given as mapped_map and mapped_vector, which read their entries straight
+   * from the mapping and only box them as they're looked at. Since the pages are mapped
+   * read only, processes which open the same image share them.
+   *
+   * The file is a header followed by nodes. Each node is a tag byte and its data, and
+   * nodes refer to each other by their offset from the start of the file, so an image can
+   * be mapped anywhere. A node's children always come before it, which is how we know an
+   * image can't have cycles, even if it's been tampered with. Identical nodes are written
+   * once and shared, so repeated keys and values only take up space once.
+   *
+   * Maps keep their entries sorted by the hash of each key, so a lookup is a binary search
+   * which only compares the keys with a matching hash. That ties an image to the hashing of
+   * the jank which wrote it, which is checked when it's opened.
+   *
+   * Images hold nil, booleans, integers, reals, strings, characters, keywords, symbols,
+   * vectors, maps, sets, and lists. Any other seq is written as a list. Sets and lists are
+   * built in full each time they're read, so big ones should be written as vectors or maps.
+   * Metadata isn't kept. */
+  struct data_image
+  {
+    enum class tag : u8
+    {
+      nil,
+      boolean_false,
+      boolean_true,
+      integer,
+      real,
+      string,
+      character,
+      keyword,
+      symbol,
+      list,
+      vector,
+      map,
+      set
+    };
+
+    /* Each map entry is the key's hash, then the offsets of the key and the value. */
+    static constexpr usize map_entry_size{ sizeof(u32) + 2 * sizeof(u64) };
+
+    data_image(jtl::immutable_string const &path, char const *head, usize const size);
+
+    object_ref root() const;
+    /* Boxes the value at the offset. Vectors and maps refer back to the image, rather than
+     * reading any of their items. */
+    object_ref read(u64 const offset) const;
+    /* Gives whether the value at the offset is equal to o. Keywords, strings, and integers
+     * are compared in place, without boxing them, since they're the usual map keys. */
+    bool equal(u64 const offset, object_ref const o) const;
+
+    tag tag_at(u64 const offset) const;
+    u32 u32_at(u64 const offset) const;
+    u64 u64_at(u64 const offset) const;
+    /* A child of a collection, which is checked to come before the collection. */
+    u64 child_at(u64 const parent, u64 const offset) const;
+    /* A size followed by that many bytes. */
+    jtl::immutable_string_view bytes_at(u64 const offset) const;
+    /* The count of a collection node, after checking that all of its items are within
+     * the image. */
+    usize count_at(u64 const offset, usize const item_size) const;
+
+    /* Throws if the range isn't within the image. */
+    void check(u64 const offset, u64 const length) const;
+
+    jtl::immutable_string path;
+    char const *head{};
+    usize size{};
+  };
+
+  /* Writes the value to a new image at the path. This throws for anything an image can't
+   * hold. */
+  void write_data_image(jtl::immutable_string const &path, object_ref const o);
+  /* Maps the image at the path and gives its root value. The mapping is kept until the
+   * image's values are no longer reachable. */
+  object_ref open_data_image(jtl::immutable_string const &path);
+}
@@ -0,0 +1,229 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+
+#include <jank/runtime/object.hpp>
+#include <jank/hash.hpp>
+
+namespace jank::runtime::detail
+{
+  /* A table of interned objects, such as keywords and namespaces, keyed on a namespace and
+   * a name. Looking up something which has already been interned is by far the most common
+   * case, so lookups are lock free. Interning something new, or removing it, takes a lock,
+   * but never blocks lookups.
+   *
+   * This is an open addressed hash table in which each slot is only ever written twice:
+   * once when an entry is added and once more if it's removed. Growing the table builds a
+   * new one and publishes it. Any lookup still probing the old one keeps it alive, since
+   * the GC can see it on that thread's stack. */
+  template <typename V>
+  struct intern_table
+  {
+    struct entry
+    {
+      jtl::immutable_string ns;
+      jtl::immutable_string name;
+      uhash hash{};
+      V value{};
+    };
+
+    struct table
+    {
+      table(usize const capacity)
+        : capacity{ capacity }
+        , slots{ new(GC) std::atomic<entry *>[capacity] {} }
+      {
+      }
+
+      /* Always a power of two. */
+      usize const capacity;
+      /* The slots which are no longer empty, including removed entries. Only writers,
+       * holding the lock, touch this. */
+      usize used{};
+      std::atomic<entry *> * const slots;
+    };
+
+    static constexpr usize initial_capacity{ 256 };
+
+    intern_table()
+      : current{ new(GC) table{ initial_capacity } }
+    {
+    }
+
+    intern_table(intern_table const &) = delete;
+    intern_table(intern_table &&) = delete;
+
+    intern_table &operator=(intern_table const &) = delete;
+    intern_table &operator=(intern_table &&) = delete;
+
+    static uhash hash_of(jtl::immutable_string_view const &ns,
+                         jtl::immutable_string_view const &name)
+    {
+      return hash::combine(hash::string(name), hash::string(ns));
+    }
+
+    /* Returns an empty value if nothing is interned under this key. */
+    V find(jtl::immutable_string_view const &ns, jtl::immutable_string_view const &name) const
+    {
+      auto const found{
+        find_entry(current.load(std::memory_order_acquire), hash_of(ns, name), ns, name)
+      };
+      return found ? found->value : V{};
+    }
+
+    /* Returns the value interned under this key, if there is one. Otherwise, the value from
+     * the make function is interned. Only the thread which wins the race to intern the key
+     * will call make. */
+    template <typename F>
+    V intern(jtl::immutable_string_view const &ns,
+             jtl::immutable_string_view const &name,
+             F const &make)
+    {
+      auto const hash{ hash_of(ns, name) };
+      if(auto const found{ find_entry(current.load(std::memory_order_acquire), hash, ns, name) })
+      {
+        return found->value;
+      }
+
+      std::lock_guard<std::mutex> const lock{ mutex };
+      auto t{ current.load(std::memory_order_relaxed) };
+      if(auto const found{ find_entry(t, hash, ns, name) })
+      {
+        return found->value;
+      }
+
+      /* We keep at least a quarter of the slots empty, so probes stay short and always
+       * terminate. */
+      if((t->used + 1) * 4 > t->capacity * 3)
+      {
+        t = grow(t);
+        current.store(t, std::memory_order_release);
+      }
+
+      auto const e{ new(GC) entry{ ns, name, hash, make() } };
+      add_entry(t, e);
+      return e->value;
+    }
+
+    /* Returns the value which was removed, or an empty value if there was none. */
+    V remove(jtl::immutable_string_view const &ns, jtl::immutable_string_view const &name)
+    {
+      auto const hash{ hash_of(ns, name) };
+      std::lock_guard<std::mutex> const lock{ mutex };
+      auto const t{ current.load(std::memory_order_relaxed) };
+      auto const mask{ t->capacity - 1 };
+      for(usize i{ hash & mask };; i = (i + 1) & mask)
+      {
+        auto const e{ t->slots[i].load(std::memory_order_relaxed) };
+        if(!e)
+        {
+          return {};
+        }
+        if(matches(e, hash, ns, name))
+        {
+          t->slots[i].store(removed(), std::memory_order_release);
+          return e->value;
+        }
+      }
+    }
+
+    /* Calls the function with each value, as of when this is called. Anything interned
+     * meanwhile may or may not be seen. */
+    template <typename F>
+    void for_each(F const &f) const
+    {
+      auto const t{ current.load(std::memory_order_acquire) };
+      for(usize i{}; i < t->capacity; ++i)
+      {
+        auto const e{ t->slots[i].load(std::memory_order_acquire) };
+        if(e && e != removed())
+        {
+          f(e->value);
+        }
+      }
+    }
+
+  private:
+    /* Removed entries leave this behind, rather than an empty slot, so that probes for
+     * entries past it still find them. */
+    static entry *removed()
+    {
+      static auto * const e{ new(GC) entry{} };
+      return e;
+    }
+
+    static bool matches(entry const * const e,
+                        uhash const hash,
+                        jtl::immutable_string_view const &ns,
+                        jtl::immutable_string_view const &name)
+    {
+      return e != removed() && e->hash == hash && e->name == name && e->ns == ns;
+    }
+
+    static entry *find_entry(table const * const t,
+                             uhash const hash,
+                             jtl::immutable_string_view const &ns,
+                             jtl::immutable_string_view const &name)
+    {
+      auto const mask{ t->capacity - 1 };
+      for(usize i{ hash & mask };; i = (i + 1) & mask)
+      {
+        auto const e{ t->slots[i].load(std::memory_order_acquire) };
+        if(!e)
+        {
+          return nullptr;
+        }
+        if(matches(e, hash, ns, name))
+        {
+          return e;
+        }
+      }
+    }
+
+    /* The entry must be fully built before this, since it's visible to lookups as soon as
+     * it's stored. */
+    static void add_entry(table * const t, entry * const e)
+    {
+      auto const mask{ t->capacity - 1 };
+      usize i{ e->hash & mask };
+      while(t->slots[i].load(std::memory_order_relaxed))
+      {
+        i = (i + 1) & mask;
+      }
+      t->slots[i].store(e, std::memory_order_release);
+      ++t->used;
+    }
+
+    /* Removed entries are dropped along the way, so this may not actually get bigger. */
+    static table *grow(table const * const t)
+    {
+      usize live{};
+      for(usize i{}; i < t->capacity; ++i)
+      {
+        auto const e{ t->slots[i].load(std::memory_order_relaxed) };
+        live += e && e != removed();
+      }
+
+      auto capacity{ t->capacity };
+      while((live + 1) * 2 > capacity)
+      {
+        capacity *= 2;
+      }
+
+      auto const ret{ new(GC) table{ capacity } };
+      for(usize i{}; i < t->capacity; ++i)
+      {
+        auto const e{ t->slots[i].load(std::memory_order_relaxed) };
+        if(e && e != removed())
+        {
+          add_entry(ret, e);
+        }
+      }
+      return ret;
+    }
+
+    std::atomic<table *> current;
+    std::mutex mutex;
+  };
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <functional>
+
+#include <folly/Synchronized.h>
+
+#include <jank/runtime/object.hpp>
+
+namespace jank::runtime
+{
+  using ns_ref = oref<struct ns>;
+  using var_ref = oref<struct var>;
+
+  namespace obj
+  {
+    using keyword_ref = oref<struct keyword>;
+  }
+}
+
+namespace jank::runtime::detail
+{
+  /* A sorted index of the names of every namespace, var, and keyword, which is updated
+   * as they're interned and removed. Completion uses this, so finding every name with some
+   * prefix is a couple of tree walks, rather than a scan over the vars of each namespace.
+   *
+   * Only vars which a namespace owns are indexed; referred vars are indexed under their
+   * own namespace. Namespaces within an isolate aren't indexed, nor are their vars. */
+  struct name_index
+  {
+    name_index() = default;
+    name_index(name_index const &) = delete;
+    name_index(name_index &&) = delete;
+
+    name_index &operator=(name_index const &) = delete;
+    name_index &operator=(name_index &&) = delete;
+
+    void add_ns(ns_ref const n);
+    /* Removes the namespace and all of its vars. */
+    void remove_ns(ns_ref const n);
+    /* Vars of namespaces which haven't been added are ignored. */
+    void add_var(var_ref const v);
+    void remove_var(var_ref const v);
+    void add_keyword(obj::keyword_ref const kw);
+
+    /* Finds up to max names starting with the prefix, in sorted order.
+     *
+     * 1. A prefix with a slash, like `clojure.core/ma`, finds the vars in the namespace
+     *    before the slash
+     * 2. A prefix starting with a colon finds keywords
+     * 3. Anything else finds namespaces and then vars in any namespace, by their name
+     *
+     * Each result is the ns, var, or keyword itself. Results which keep rejects don't count
+     * towards max. It's called with the index locked, so it mustn't take any lock which is
+     * held while interning. */
+    native_vector<object_ref> complete(jtl::immutable_string const &prefix,
+                                       usize max,
+                                       std::function<bool(object_ref)> const &keep = {}) const;
+
+    /* The number of names which are indexed. */
+    usize size() const;
+
+  private:
+    using key = std::pair<jtl::immutable_string, jtl::immutable_string>;
+
+    struct state
+    {
+      native_map<jtl::immutable_string, ns_ref> namespaces;
+      /* Keyed on the ns and then the name. */
+      native_map<key, var_ref> qualified_vars;
+      /* Keyed on the name and then the ns. */
+      native_map<key, var_ref> vars;
+      /* Keyed on the keyword's string, including the colon. */
+      native_map<jtl::immutable_string, obj::keyword_ref> keywords;
+    };
+
+    folly::Synchronized<state> data;
+  };
+}
@@ -7,6 +7,11 @@
 
 #include <jank/runtime/object.hpp>
 
+#ifndef JANK_ARRAY_MAP_MAX_SIZE
+  /* NOLINTNEXTLINE(cppcoreguidelines-macro-usage) */
+  #define JANK_ARRAY_MAP_MAX_SIZE 8
+#endif
+
 namespace jank::runtime::detail
 {
   /* TODO: Move this somewhere more general. It's used by other collections. */
@@ -19,9 +24,11 @@ namespace jank::runtime::detail
   struct native_array_map
   {
     /* Array maps are fast only for a small number of keys. Clojure JVM uses a threshold of 8
-     * k/v pairs, thus 16 elements. We follow the same. */
-    /* TODO: Benchmark difference thresholds. */
-    static constexpr u8 max_size{ 8 };
+     * k/v pairs, thus 16 elements, which is our default. It can be changed at build time,
+     * with jank_array_map_max_size, and the "array map" benchmark in the test suite will
+     * show how a given size performs. */
+    static constexpr u8 max_size{ JANK_ARRAY_MAP_MAX_SIZE };
+    static_assert(0 < max_size && max_size <= 64, "array maps must hold 1 to 64 entries");
 
     native_array_map() = default;
     native_array_map(native_array_map const &s) = default;
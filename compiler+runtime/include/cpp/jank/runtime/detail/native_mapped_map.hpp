@@ -0,0 +1,62 @@
+#pragma once
+
+#include <jtl/option.hpp>
+
+#include <jank/runtime/object.hpp>
+
+namespace jank::runtime
+{
+  struct data_image;
+}
+
+namespace jank::runtime::detail
+{
+  /* The data behind a map within a data image. Its entries are in the image, sorted by the
+   * hash of their keys, and each key and value is boxed when it's reached. */
+  struct native_mapped_map
+  {
+    struct iterator
+    {
+      using iterator_category = std::forward_iterator_tag;
+      using difference_type = std::ptrdiff_t;
+      using value_type = std::pair<object_ref, object_ref>;
+      using pointer = value_type *;
+      using reference = value_type;
+
+      value_type operator*() const;
+      iterator &operator++();
+      bool operator==(iterator const &rhs) const;
+      bool operator!=(iterator const &rhs) const;
+
+      data_image const *image{};
+      u64 offset{};
+      usize index{};
+    };
+
+    using const_iterator = iterator;
+
+    native_mapped_map() = default;
+    native_mapped_map(native_mapped_map const &) = default;
+    native_mapped_map(native_mapped_map &&) noexcept = default;
+    native_mapped_map(data_image const * const image, u64 const offset);
+
+    native_mapped_map &operator=(native_mapped_map const &) = default;
+    native_mapped_map &operator=(native_mapped_map &&) noexcept = default;
+
+    jtl::option<object_ref> find(object_ref const key) const;
+
+    object_ref key_at(usize const index) const;
+    object_ref value_at(usize const index) const;
+
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    usize size() const;
+    bool empty() const;
+
+    data_image const *image{};
+    /* The offset of the map's node. */
+    u64 offset{};
+    usize count{};
+  };
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <iterator>
+
+#include <jtl/option.hpp>
+
+#include <jank/runtime/object.hpp>
+
+namespace jank::runtime::obj
+{
+  using integer_ref = oref<struct integer>;
+}
+
+namespace jank::runtime::detail
+{
+  struct native_transient_int_map;
+
+  /* The data behind an int map. It's a big-endian Patricia trie on the bits of each key,
+   * so finding a key is a walk of at most 64 branches, each of which tests one bit. Keys
+   * are never hashed or compared as objects.
+   *
+   * Each branch holds the bits which all of its keys share, above the highest bit at which
+   * they differ, and the keys with that bit clear are on its left. The sign bit of each key
+   * is flipped before it goes into the trie, so walking it from left to right gives the
+   * keys in ascending order, negative keys included.
+   *
+   * Since the shape of the trie depends only on its keys, two maps can be merged by
+   * walking both tries at once. Any subtree which is only in one of them, or which they
+   * share, is taken as is.
+   *
+   * Transients tag the nodes they copy with an owner, just like sorted trees, so a batch
+   * of updates only copies each node once. */
+  struct native_persistent_int_map
+  {
+    struct node
+    {
+      static constexpr bool pointer_free{ false };
+
+      /* The transient which is allowed to mutate this node, if any. */
+      u64 owner{};
+      /* The number of leaves at or below this node. */
+      usize size{ 1 };
+      /* For a leaf, its key. For a branch, the bits above its mask. */
+      u64 prefix{};
+      /* The single bit this branch tests, or 0 for a leaf. */
+      u64 mask{};
+      node *left{};
+      node *right{};
+      /* Only leaves have these. We keep the boxed key so we never need to box it again. */
+      object_ref key{};
+      object_ref value{};
+    };
+
+    struct const_iterator
+    {
+      using iterator_category = std::forward_iterator_tag;
+      using difference_type = std::ptrdiff_t;
+      using value_type = std::pair<object_ref, object_ref>;
+      using pointer = value_type *;
+      using reference = value_type;
+
+      value_type operator*() const;
+      const_iterator &operator++();
+      bool operator==(const_iterator const &rhs) const;
+      bool operator!=(const_iterator const &rhs) const;
+
+      /* Every node knows its size, so we find each leaf by its index, walking down from
+       * the root. That keeps the iterator small, since each seq over the map holds two. */
+      static node const *nth(node const *n, usize index);
+
+      node const *root{};
+      node const *current{};
+      usize index{};
+    };
+
+    using value_type = const_iterator::value_type;
+    using iterator = const_iterator;
+    using transient_type = native_transient_int_map;
+
+    native_persistent_int_map() = default;
+    native_persistent_int_map(node * const root);
+
+    jtl::option<object_ref> find(i64 const key) const;
+    bool contains(i64 const key) const;
+
+    native_persistent_int_map set(obj::integer_ref const key, object_ref const val) const;
+    native_persistent_int_map erase(i64 const key) const;
+
+    /* Every entry of both maps. Where they share a key, the value from rhs wins, unless
+     * there's a function, in which case it's called with both values, ours first, and its
+     * result is taken. */
+    native_persistent_int_map merge(native_persistent_int_map const &rhs,
+                                    jtl::option<object_ref> const &f) const;
+
+    transient_type transient() const;
+
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    usize size() const;
+    bool empty() const;
+
+    node *root{};
+  };
+
+  struct native_transient_int_map
+  {
+    using value_type = native_persistent_int_map::value_type;
+    using const_iterator = native_persistent_int_map::const_iterator;
+    using iterator = const_iterator;
+    using persistent_type = native_persistent_int_map;
+
+    native_transient_int_map();
+    native_transient_int_map(native_persistent_int_map::node * const root);
+    /* Copies can't share an owner, or they'd see each other's updates. */
+    native_transient_int_map(native_transient_int_map const &rhs);
+    native_transient_int_map(native_transient_int_map &&rhs) noexcept;
+
+    native_transient_int_map &operator=(native_transient_int_map const &rhs);
+    native_transient_int_map &operator=(native_transient_int_map &&rhs) noexcept;
+
+    jtl::option<object_ref> find(i64 const key) const;
+    bool contains(i64 const key) const;
+
+    void set(obj::integer_ref const key, object_ref const val);
+    void erase(i64 const key);
+
+    persistent_type persistent();
+
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    usize size() const;
+    bool empty() const;
+
+    native_persistent_int_map::node *root{};
+    u64 owner{};
+  };
+}
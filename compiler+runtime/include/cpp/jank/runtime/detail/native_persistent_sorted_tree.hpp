@@ -0,0 +1,887 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <iterator>
+
+#include <jank/runtime/object.hpp>
+
+namespace jank::runtime::detail
+{
+  /* Sorted maps and sets are persistent B-trees. An update copies only the nodes on the
+   * path to the entry it changes, so it's O(log n) and the rest of the tree is shared
+   * with the previous version.
+   *
+   * Transients tag every node they copy with an owner. A node owned by the transient
+   * doing the update is mutated in place, rather than copied again, so a batch of updates
+   * on a transient only copies each node once.
+   *
+   * Every node also knows the size of its subtree, which lets us count the entries on
+   * either side of any position without walking them. */
+  template <typename Traits, typename Compare>
+  struct sorted_tree
+  {
+    using entry_type = typename Traits::entry_type;
+
+    /* Every node, apart from the root, holds between min_entries and max_entries. */
+    static constexpr u8 min_degree{ 16 };
+    static constexpr u8 min_entries{ min_degree - 1 };
+    static constexpr u8 max_entries{ 2 * min_degree - 1 };
+    /* Every branch below the root has at least min_degree children, so this is enough
+     * for more entries than could fit in memory. */
+    static constexpr u8 max_depth{ 12 };
+
+    struct node
+    {
+      static constexpr bool pointer_free{ false };
+
+      /* The transient which is allowed to mutate this node, if any. */
+      u64 owner{};
+      /* The number of entries in this node and all of its descendants. */
+      usize size{};
+      u8 count{};
+      bool leaf{ true };
+      std::array<entry_type, max_entries> entries{};
+      std::array<node *, max_entries + 1> children{};
+    };
+
+    struct const_iterator
+    {
+      using iterator_category = std::forward_iterator_tag;
+      using difference_type = std::ptrdiff_t;
+      using value_type = entry_type;
+      using pointer = value_type const *;
+      using reference = value_type const &;
+
+      reference operator*() const
+      {
+        return nodes[depth - 1]->entries[indices[depth - 1]];
+      }
+
+      pointer operator->() const
+      {
+        return &**this;
+      }
+
+      /* Descending iterators step backward, so both directions can share one end. */
+      const_iterator &operator++()
+      {
+        if(ascending)
+        {
+          step_forward();
+        }
+        else
+        {
+          step_backward();
+        }
+        return *this;
+      }
+
+      const_iterator operator++(int)
+      {
+        auto const ret{ *this };
+        ++*this;
+        return ret;
+      }
+
+      bool operator==(const_iterator const &rhs) const
+      {
+        if(depth == 0 || rhs.depth == 0)
+        {
+          return depth == rhs.depth;
+        }
+        return nodes[depth - 1] == rhs.nodes[rhs.depth - 1]
+          && indices[depth - 1] == rhs.indices[rhs.depth - 1];
+      }
+
+      bool operator!=(const_iterator const &rhs) const
+      {
+        return !(*this == rhs);
+      }
+
+      void push(node const * const n, u8 const index)
+      {
+        nodes[depth] = n;
+        indices[depth] = index;
+        ++depth;
+      }
+
+      void push_leftmost(node const *n)
+      {
+        while(!n->leaf)
+        {
+          push(n, 0);
+          n = n->children[0];
+        }
+        push(n, 0);
+      }
+
+      void push_rightmost(node const *n)
+      {
+        while(!n->leaf)
+        {
+          push(n, n->count);
+          n = n->children[n->count];
+        }
+        push(n, n->count - 1);
+      }
+
+      /* The top of the stack is the current entry. Every branch under it is paired with
+       * the index of the child we went down, which is also the index of the entry
+       * which follows that child. */
+      void step_forward()
+      {
+        auto const n{ nodes[depth - 1] };
+        if(!n->leaf)
+        {
+          push_leftmost(n->children[++indices[depth - 1]]);
+          return;
+        }
+        if(++indices[depth - 1] < n->count)
+        {
+          return;
+        }
+        pop_forward();
+      }
+
+      void step_backward()
+      {
+        auto const n{ nodes[depth - 1] };
+        if(!n->leaf)
+        {
+          push_rightmost(n->children[indices[depth - 1]]);
+          return;
+        }
+        if(indices[depth - 1] > 0)
+        {
+          --indices[depth - 1];
+          return;
+        }
+        pop_backward();
+      }
+
+      /* Leaves the exhausted leaf on top of the stack for the next entry after it. */
+      void pop_forward()
+      {
+        while(--depth > 0)
+        {
+          if(indices[depth - 1] < nodes[depth - 1]->count)
+          {
+            return;
+          }
+        }
+      }
+
+      /* Leaves the exhausted leaf on top of the stack for the entry before it. */
+      void pop_backward()
+      {
+        while(--depth > 0)
+        {
+          if(indices[depth - 1] > 0)
+          {
+            --indices[depth - 1];
+            return;
+          }
+        }
+      }
+
+      std::array<node const *, max_depth> nodes{};
+      std::array<u8, max_depth> indices{};
+      u8 depth{};
+      bool ascending{ true };
+    };
+
+    sorted_tree() = default;
+
+    sorted_tree(node * const root)
+      : root{ root }
+    {
+    }
+
+    const_iterator begin() const
+    {
+      const_iterator ret;
+      if(root)
+      {
+        ret.push_leftmost(root);
+      }
+      return ret;
+    }
+
+    const_iterator end() const
+    {
+      return {};
+    }
+
+    /* A descending iterator, starting from the last entry. It shares the same end. */
+    const_iterator rbegin() const
+    {
+      const_iterator ret;
+      ret.ascending = false;
+      if(root)
+      {
+        ret.push_rightmost(root);
+      }
+      return ret;
+    }
+
+    usize size() const
+    {
+      return root ? root->size : 0;
+    }
+
+    bool empty() const
+    {
+      return !root;
+    }
+
+    /* For maps, this is the value for the key. For sets, it's the element. */
+    object_ref const *find(object_ref const key) const
+    {
+      node const *n{ root };
+      while(n)
+      {
+        auto const i{ lower_index(n, key) };
+        if(matches(n, i, key))
+        {
+          return &Traits::value(n->entries[i]);
+        }
+        if(n->leaf)
+        {
+          return nullptr;
+        }
+        n = n->children[i];
+      }
+      return nullptr;
+    }
+
+    bool contains(object_ref const key) const
+    {
+      return find(key) != nullptr;
+    }
+
+    /* When ascending, this starts from the first entry which isn't less than the key.
+     * Otherwise, it starts from the last entry which isn't greater than it. */
+    const_iterator seek(object_ref const key, bool const ascending) const
+    {
+      const_iterator ret;
+      ret.ascending = ascending;
+      node const *n{ root };
+      while(n)
+      {
+        if(ascending)
+        {
+          auto const i{ lower_index(n, key) };
+          ret.push(n, i);
+          if(matches(n, i, key))
+          {
+            return ret;
+          }
+          if(n->leaf)
+          {
+            if(i == n->count)
+            {
+              ret.pop_forward();
+            }
+            return ret;
+          }
+          n = n->children[i];
+        }
+        else
+        {
+          auto const i{ upper_index(n, key) };
+          if(i > 0 && !Compare{}(Traits::key(n->entries[i - 1]), key))
+          {
+            ret.push(n, i - 1);
+            return ret;
+          }
+          if(n->leaf)
+          {
+            ret.push(n, i == 0 ? 0 : i - 1);
+            if(i == 0)
+            {
+              ret.pop_backward();
+            }
+            return ret;
+          }
+          ret.push(n, i);
+          n = n->children[i];
+        }
+      }
+      return ret;
+    }
+
+    /* The number of entries the iterator has yet to visit, including the current one. */
+    usize remaining(const_iterator const &it) const
+    {
+      if(it.depth == 0)
+      {
+        return 0;
+      }
+
+      usize before{};
+      for(u8 d{}; d < it.depth; ++d)
+      {
+        auto const n{ it.nodes[d] };
+        auto const index{ it.indices[d] };
+        before += index;
+        if(!n->leaf)
+        {
+          /* The current entry comes after the child with the same index. Any child we only
+           * went down comes after the entry we're on. */
+          auto const last_child{ d + 1 == it.depth ? index + 1 : index };
+          for(u8 c{}; c < last_child; ++c)
+          {
+            before += n->children[c]->size;
+          }
+        }
+      }
+      return it.ascending ? size() - before : before + 1;
+    }
+
+    static u8 lower_index(node const * const n, object_ref const key)
+    {
+      Compare const less;
+      u8 low{}, high{ n->count };
+      while(low < high)
+      {
+        u8 const mid = (low + high) / 2;
+        if(less(Traits::key(n->entries[mid]), key))
+        {
+          low = mid + 1;
+        }
+        else
+        {
+          high = mid;
+        }
+      }
+      return low;
+    }
+
+    static u8 upper_index(node const * const n, object_ref const key)
+    {
+      Compare const less;
+      u8 low{}, high{ n->count };
+      while(low < high)
+      {
+        u8 const mid = (low + high) / 2;
+        if(less(key, Traits::key(n->entries[mid])))
+        {
+          high = mid;
+        }
+        else
+        {
+          low = mid + 1;
+        }
+      }
+      return low;
+    }
+
+    static bool matches(node const * const n, u8 const i, object_ref const key)
+    {
+      return i < n->count && !Compare{}(key, Traits::key(n->entries[i]));
+    }
+
+    static node *editable(node * const n, u64 const owner)
+    {
+      if(owner && n->owner == owner)
+      {
+        return n;
+      }
+      auto const ret{ new(GC) node{ *n } };
+      ret->owner = owner;
+      return ret;
+    }
+
+    /* Drops references past the end of the node, so they can be collected. */
+    static void trim(node * const n)
+    {
+      for(u8 i{ n->count }; i < max_entries; ++i)
+      {
+        n->entries[i] = {};
+        n->children[i + 1] = nullptr;
+      }
+    }
+
+    static void update_size(node * const n)
+    {
+      usize size{ n->count };
+      if(!n->leaf)
+      {
+        for(u8 i{}; i <= n->count; ++i)
+        {
+          size += n->children[i]->size;
+        }
+      }
+      n->size = size;
+    }
+
+    /* The parent must be editable and the child must be full. */
+    static void split_child(node * const parent, u8 const i, u64 const owner)
+    {
+      auto const left{ editable(parent->children[i], owner) };
+      auto const right{ new(GC) node{} };
+      right->owner = owner;
+      right->leaf = left->leaf;
+      right->count = min_entries;
+      for(u8 j{}; j < min_entries; ++j)
+      {
+        right->entries[j] = left->entries[j + min_degree];
+      }
+      if(!left->leaf)
+      {
+        for(u8 j{}; j < min_degree; ++j)
+        {
+          right->children[j] = left->children[j + min_degree];
+        }
+      }
+
+      auto const middle{ left->entries[min_entries] };
+      left->count = min_entries;
+      trim(left);
+      update_size(left);
+      update_size(right);
+
+      for(u8 j{ parent->count }; j > i; --j)
+      {
+        parent->entries[j] = parent->entries[j - 1];
+        parent->children[j + 1] = parent->children[j];
+      }
+      parent->entries[i] = middle;
+      parent->children[i] = left;
+      parent->children[i + 1] = right;
+      ++parent->count;
+    }
+
+    /* Replaces the entry with an equal key, which must exist. */
+    static node *replace(node * const n, entry_type const &entry, u64 const owner)
+    {
+      auto const ret{ editable(n, owner) };
+      auto const key{ Traits::key(entry) };
+      auto const i{ lower_index(ret, key) };
+      if(matches(ret, i, key))
+      {
+        ret->entries[i] = entry;
+      }
+      else
+      {
+        ret->children[i] = replace(ret->children[i], entry, owner);
+      }
+      return ret;
+    }
+
+    /* Inserts an entry with a new key, splitting full nodes on the way down so there's
+     * always room in the parent for a split child. */
+    static node *insert(node * const root, entry_type const &entry, u64 const owner)
+    {
+      if(!root)
+      {
+        auto const ret{ new(GC) node{} };
+        ret->owner = owner;
+        ret->count = 1;
+        ret->size = 1;
+        ret->entries[0] = entry;
+        return ret;
+      }
+
+      node *ret{};
+      if(root->count == max_entries)
+      {
+        ret = new(GC) node{};
+        ret->owner = owner;
+        ret->leaf = false;
+        ret->size = root->size;
+        ret->children[0] = root;
+        split_child(ret, 0, owner);
+      }
+      else
+      {
+        ret = editable(root, owner);
+      }
+
+      auto const key{ Traits::key(entry) };
+      auto n{ ret };
+      while(true)
+      {
+        ++n->size;
+        auto i{ lower_index(n, key) };
+        if(n->leaf)
+        {
+          for(u8 j{ n->count }; j > i; --j)
+          {
+            n->entries[j] = n->entries[j - 1];
+          }
+          n->entries[i] = entry;
+          ++n->count;
+          return ret;
+        }
+
+        if(n->children[i]->count == max_entries)
+        {
+          split_child(n, i, owner);
+          if(Compare{}(Traits::key(n->entries[i]), key))
+          {
+            ++i;
+          }
+        }
+        else
+        {
+          n->children[i] = editable(n->children[i], owner);
+        }
+        n = n->children[i];
+      }
+    }
+
+    static entry_type const &last_entry(node const *n)
+    {
+      while(!n->leaf)
+      {
+        n = n->children[n->count];
+      }
+      return n->entries[n->count - 1];
+    }
+
+    static entry_type const &first_entry(node const *n)
+    {
+      while(!n->leaf)
+      {
+        n = n->children[0];
+      }
+      return n->entries[0];
+    }
+
+    /* Moves the last entry of the left sibling up into the parent and the parent's entry
+     * down into the front of the child. */
+    static void borrow_from_left(node * const parent, u8 const i, u64 const owner)
+    {
+      auto const child{ editable(parent->children[i], owner) };
+      auto const sibling{ editable(parent->children[i - 1], owner) };
+
+      for(u8 j{ child->count }; j > 0; --j)
+      {
+        child->entries[j] = child->entries[j - 1];
+      }
+      child->entries[0] = parent->entries[i - 1];
+      usize moved{ 1 };
+      if(!child->leaf)
+      {
+        for(u8 j{ static_cast<u8>(child->count + 1) }; j > 0; --j)
+        {
+          child->children[j] = child->children[j - 1];
+        }
+        child->children[0] = sibling->children[sibling->count];
+        moved += child->children[0]->size;
+      }
+      parent->entries[i - 1] = sibling->entries[sibling->count - 1];
+
+      ++child->count;
+      --sibling->count;
+      trim(sibling);
+      child->size += moved;
+      sibling->size -= moved;
+      parent->children[i] = child;
+      parent->children[i - 1] = sibling;
+    }
+
+    static void borrow_from_right(node * const parent, u8 const i, u64 const owner)
+    {
+      auto const child{ editable(parent->children[i], owner) };
+      auto const sibling{ editable(parent->children[i + 1], owner) };
+
+      child->entries[child->count] = parent->entries[i];
+      usize moved{ 1 };
+      if(!child->leaf)
+      {
+        child->children[child->count + 1] = sibling->children[0];
+        moved += sibling->children[0]->size;
+      }
+      parent->entries[i] = sibling->entries[0];
+
+      for(u8 j{ 1 }; j < sibling->count; ++j)
+      {
+        sibling->entries[j - 1] = sibling->entries[j];
+      }
+      if(!sibling->leaf)
+      {
+        for(u8 j{ 1 }; j <= sibling->count; ++j)
+        {
+          sibling->children[j - 1] = sibling->children[j];
+        }
+      }
+
+      ++child->count;
+      --sibling->count;
+      trim(sibling);
+      child->size += moved;
+      sibling->size -= moved;
+      parent->children[i] = child;
+      parent->children[i + 1] = sibling;
+    }
+
+    /* Merges the child at i, the parent's entry at i, and the child after it. Both children
+     * must have min_entries. */
+    static void merge(node * const parent, u8 const i, u64 const owner)
+    {
+      auto const left{ editable(parent->children[i], owner) };
+      auto const right{ parent->children[i + 1] };
+
+      left->entries[left->count] = parent->entries[i];
+      for(u8 j{}; j < right->count; ++j)
+      {
+        left->entries[left->count + 1 + j] = right->entries[j];
+      }
+      if(!left->leaf)
+      {
+        for(u8 j{}; j <= right->count; ++j)
+        {
+          left->children[left->count + 1 + j] = right->children[j];
+        }
+      }
+      left->count += right->count + 1;
+      left->size += right->size + 1;
+
+      for(u8 j{ static_cast<u8>(i + 1) }; j < parent->count; ++j)
+      {
+        parent->entries[j - 1] = parent->entries[j];
+        parent->children[j] = parent->children[j + 1];
+      }
+      --parent->count;
+      trim(parent);
+      parent->children[i] = left;
+    }
+
+    /* Makes sure the child at i can lose an entry, returning where that child now is. */
+    static u8 fill(node * const parent, u8 const i, u64 const owner)
+    {
+      if(parent->children[i]->count > min_entries)
+      {
+        parent->children[i] = editable(parent->children[i], owner);
+        return i;
+      }
+      if(i > 0 && parent->children[i - 1]->count > min_entries)
+      {
+        borrow_from_left(parent, i, owner);
+        return i;
+      }
+      if(i < parent->count && parent->children[i + 1]->count > min_entries)
+      {
+        borrow_from_right(parent, i, owner);
+        return i;
+      }
+      if(i < parent->count)
+      {
+        merge(parent, i, owner);
+        return i;
+      }
+      merge(parent, i - 1, owner);
+      return i - 1;
+    }
+
+    /* Erases the entry with the key, which must exist. On the way down, every node we
+     * enter is given more than min_entries, so removing from it can't underflow. */
+    static node *erase(node * const root, object_ref key, u64 const owner)
+    {
+      auto const ret{ editable(root, owner) };
+      auto n{ ret };
+      while(true)
+      {
+        --n->size;
+        auto const i{ lower_index(n, key) };
+        if(matches(n, i, key))
+        {
+          if(n->leaf)
+          {
+            for(u8 j{ static_cast<u8>(i + 1) }; j < n->count; ++j)
+            {
+              n->entries[j - 1] = n->entries[j];
+            }
+            --n->count;
+            trim(n);
+            break;
+          }
+
+          /* A branch's entry is replaced with its neighbor from a leaf, which we then
+           * erase instead. */
+          if(n->children[i]->count > min_entries)
+          {
+            auto const child{ editable(n->children[i], owner) };
+            n->children[i] = child;
+            n->entries[i] = last_entry(child);
+            key = Traits::key(n->entries[i]);
+            n = child;
+          }
+          else if(n->children[i + 1]->count > min_entries)
+          {
+            auto const child{ editable(n->children[i + 1], owner) };
+            n->children[i + 1] = child;
+            n->entries[i] = first_entry(child);
+            key = Traits::key(n->entries[i]);
+            n = child;
+          }
+          else
+          {
+            merge(n, i, owner);
+            n = n->children[i];
+          }
+          continue;
+        }
+
+        /* The comparator must be inconsistent, since we know the key is here. */
+        if(n->leaf)
+        {
+          break;
+        }
+        n = n->children[fill(n, i, owner)];
+      }
+
+      if(ret->count == 0)
+      {
+        return ret->leaf ? nullptr : ret->children[0];
+      }
+      return ret;
+    }
+
+    node *root{};
+  };
+
+  inline u64 next_sorted_tree_owner()
+  {
+    static std::atomic<u64> next{ 1 };
+    return next.fetch_add(1);
+  }
+
+  template <typename Traits, typename Compare>
+  struct native_transient_sorted_tree;
+
+  template <typename Traits, typename Compare>
+  struct native_persistent_sorted_tree : sorted_tree<Traits, Compare>
+  {
+    using base = sorted_tree<Traits, Compare>;
+    using value_type = typename Traits::entry_type;
+    using const_iterator = typename base::const_iterator;
+    using iterator = const_iterator;
+    using transient_type = native_transient_sorted_tree<Traits, Compare>;
+
+    using base::base;
+
+    native_persistent_sorted_tree set(object_ref const key, object_ref const val) const
+    requires Traits::is_map
+    {
+      auto const found{ this->find(key) };
+      if(found && *found == val)
+      {
+        return *this;
+      }
+      return found ? native_persistent_sorted_tree{ base::replace(this->root, { key, val }, 0) }
+                   : native_persistent_sorted_tree{ base::insert(this->root, { key, val }, 0) };
+    }
+
+    native_persistent_sorted_tree insert(object_ref const elem) const
+    requires(!Traits::is_map)
+    {
+      if(this->contains(elem))
+      {
+        return *this;
+      }
+      return { base::insert(this->root, elem, 0) };
+    }
+
+    native_persistent_sorted_tree erase(object_ref const key) const
+    {
+      if(!this->contains(key))
+      {
+        return *this;
+      }
+      return { base::erase(this->root, key, 0) };
+    }
+
+    transient_type transient() const
+    {
+      return { this->root };
+    }
+  };
+
+  template <typename Traits, typename Compare>
+  struct native_transient_sorted_tree : sorted_tree<Traits, Compare>
+  {
+    using base = sorted_tree<Traits, Compare>;
+    using value_type = typename Traits::entry_type;
+    using const_iterator = typename base::const_iterator;
+    using iterator = const_iterator;
+    using persistent_type = native_persistent_sorted_tree<Traits, Compare>;
+
+    native_transient_sorted_tree() = default;
+
+    native_transient_sorted_tree(typename base::node * const root)
+      : base{ root }
+    {
+    }
+
+    /* Copies can't share an owner, or they'd see each other's updates. */
+    native_transient_sorted_tree(native_transient_sorted_tree const &rhs)
+      : base{ rhs.root }
+    {
+    }
+
+    native_transient_sorted_tree(native_transient_sorted_tree &&rhs) noexcept
+      : base{ rhs.root }
+      , owner{ rhs.owner }
+    {
+      rhs.owner = next_sorted_tree_owner();
+    }
+
+    native_transient_sorted_tree &operator=(native_transient_sorted_tree const &rhs)
+    {
+      this->root = rhs.root;
+      owner = next_sorted_tree_owner();
+      return *this;
+    }
+
+    native_transient_sorted_tree &operator=(native_transient_sorted_tree &&rhs) noexcept
+    {
+      this->root = rhs.root;
+      owner = rhs.owner;
+      rhs.owner = next_sorted_tree_owner();
+      return *this;
+    }
+
+    void set(object_ref const key, object_ref const val)
+    requires Traits::is_map
+    {
+      auto const found{ this->find(key) };
+      if(found && *found == val)
+      {
+        return;
+      }
+      this->root = found ? base::replace(this->root, { key, val }, owner)
+                         : base::insert(this->root, { key, val }, owner);
+    }
+
+    void insert(object_ref const elem)
+    requires(!Traits::is_map)
+    {
+      if(!this->contains(elem))
+      {
+        this->root = base::insert(this->root, elem, owner);
+      }
+    }
+
+    void erase(object_ref const key)
+    {
+      if(this->contains(key))
+      {
+        this->root = base::erase(this->root, key, owner);
+      }
+    }
+
+    /* The nodes we own are now shared, so we take a new owner in case we're updated
+     * again. */
+    persistent_type persistent()
+    {
+      owner = next_sorted_tree_owner();
+      return { this->root };
+    }
+
+    u64 owner{ next_sorted_tree_owner() };
+  };
+}
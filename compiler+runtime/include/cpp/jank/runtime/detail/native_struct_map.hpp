@@ -0,0 +1,70 @@
+#pragma once
+
+#include <jtl/option.hpp>
+
+#include <jank/runtime/object.hpp>
+#include <jank/runtime/detail/type.hpp>
+
+namespace jank::runtime::obj
+{
+  using struct_basis_ref = oref<struct struct_basis>;
+}
+
+namespace jank::runtime::detail
+{
+  /* The data behind a struct map. Each basis key has a slot, in the order of the basis, so
+   * the values for those keys are stored without the keys themselves. Any other keys go
+   * into a regular hash map alongside the slots. */
+  struct native_struct_map
+  {
+    using ext_type = native_persistent_hash_map;
+
+    struct iterator
+    {
+      using iterator_category = std::forward_iterator_tag;
+      using difference_type = std::ptrdiff_t;
+      using value_type = std::pair<object_ref, object_ref>;
+      using pointer = value_type *;
+      using reference = value_type;
+
+      value_type operator*() const;
+      iterator &operator++();
+      bool operator==(iterator const &rhs) const;
+      bool operator!=(iterator const &rhs) const;
+
+      object_ref const *keys{};
+      object_ref const *slots{};
+      usize slot{};
+      usize slot_count{};
+      /* Only used once we're past the slots. */
+      ext_type::const_iterator ext{};
+    };
+
+    using const_iterator = iterator;
+
+    native_struct_map(native_struct_map const &) = default;
+    native_struct_map(native_struct_map &&) noexcept = default;
+    /* Every basis key starts out as nil. */
+    native_struct_map(obj::struct_basis_ref const basis);
+    native_struct_map(obj::struct_basis_ref const basis, object_ref * const slots, ext_type ext);
+
+    native_struct_map &operator=(native_struct_map const &) = default;
+    native_struct_map &operator=(native_struct_map &&) noexcept = default;
+
+    jtl::option<object_ref> find(object_ref const key) const;
+    native_struct_map assoc(object_ref const key, object_ref const val) const;
+    /* Basis keys can't be removed, so this throws for them. */
+    native_struct_map dissoc(object_ref const key) const;
+
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    usize slot_count() const;
+    usize size() const;
+    bool empty() const;
+
+    obj::struct_basis_ref basis;
+    object_ref *slots{};
+    ext_type ext;
+  };
+}
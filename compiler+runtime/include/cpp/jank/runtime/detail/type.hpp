@@ -1,7 +1,12 @@
 #pragma once
 
-#include <immer/vector.hpp>
-#include <immer/vector_transient.hpp>
+#ifdef JANK_FLEX_VECTOR
+  #include <immer/flex_vector.hpp>
+  #include <immer/flex_vector_transient.hpp>
+#else
+  #include <immer/vector.hpp>
+  #include <immer/vector_transient.hpp>
+#endif
 #include <immer/map.hpp>
 #include <immer/map_transient.hpp>
 #include <immer/set.hpp>
@@ -10,6 +15,7 @@
 
 #include <jank/runtime/object.hpp>
 #include <jank/runtime/detail/native_persistent_list.hpp>
+#include <jank/runtime/detail/native_persistent_sorted_tree.hpp>
 
 namespace jank::runtime::detail
 {
@@ -17,11 +23,47 @@ namespace jank::runtime::detail
   {
     bool operator()(object_ref const l, object_ref const r) const;
   };
+
+  struct sorted_set_traits
+  {
+    using entry_type = object_ref;
+    static constexpr bool is_map{ false };
+
+    static object_ref const &key(entry_type const &e)
+    {
+      return e;
+    }
+
+    static object_ref const &value(entry_type const &e)
+    {
+      return e;
+    }
+  };
+
+  struct sorted_map_traits
+  {
+    using entry_type = std::pair<object_ref, object_ref>;
+    static constexpr bool is_map{ true };
+
+    static object_ref const &key(entry_type const &e)
+    {
+      return e.first;
+    }
+
+    static object_ref const &value(entry_type const &e)
+    {
+      return e.second;
+    }
+  };
 }
 
 namespace immer
 {
+#ifdef JANK_FLEX_VECTOR
+  extern template class flex_vector<jank::runtime::object_ref, jank::memory_policy>;
+#else
   extern template class vector<jank::runtime::object_ref, jank::memory_policy>;
+#endif
   extern template class set<jank::runtime::object_ref,
                             std::hash<jank::runtime::object_ref>,
                             std::equal_to<jank::runtime::object_ref>,
@@ -35,17 +77,22 @@ namespace immer
 
 namespace jank::runtime::detail
 {
+  /* An RRB tree can be sliced and concatenated in O(log n), rather than copied, at the
+   * cost of slightly slower indexing once it has been. */
+#ifdef JANK_FLEX_VECTOR
+  using native_persistent_vector = immer::flex_vector<object_ref, memory_policy>;
+#else
   using native_persistent_vector = immer::vector<object_ref, memory_policy>;
+#endif
   using native_transient_vector = native_persistent_vector::transient_type;
 
   using native_persistent_hash_set = immer::
     set<object_ref, std::hash<object_ref>, std::equal_to<jank::runtime::object_ref>, memory_policy>;
   using native_transient_hash_set = native_persistent_hash_set::transient_type;
 
-  /* TODO: Bring in proper immutable sorted maps/sets. */
   using native_persistent_sorted_set
-    = std::set<object_ref, object_ref_compare, native_allocator<object_ref>>;
-  using native_transient_sorted_set = native_persistent_sorted_set;
+    = native_persistent_sorted_tree<sorted_set_traits, object_ref_compare>;
+  using native_transient_sorted_set = native_persistent_sorted_set::transient_type;
 
   using native_persistent_hash_map = immer::map<object_ref,
                                                 object_ref,
@@ -55,11 +102,8 @@ namespace jank::runtime::detail
   using native_transient_hash_map = native_persistent_hash_map::transient_type;
 
   using native_persistent_sorted_map
-    = std::map<object_ref,
-               object_ref,
-               object_ref_compare,
-               native_allocator<std::pair<object_ref const, object_ref>>>;
-  using native_transient_sorted_map = native_persistent_sorted_map;
+    = native_persistent_sorted_tree<sorted_map_traits, object_ref_compare>;
+  using native_transient_sorted_map = native_persistent_sorted_map::transient_type;
 
   /* If an object requires this in its constructor, use your runtime context to intern
    * it instead. */
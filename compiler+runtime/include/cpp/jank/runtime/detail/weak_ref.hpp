@@ -0,0 +1,35 @@
+#pragma once
+
+#include <jtl/option.hpp>
+
+#include <jank/runtime/object.hpp>
+
+namespace jank::runtime::detail
+{
+  /* Refers to an object without keeping it alive. The GC doesn't see the pointer, since
+   * it's hidden, and it clears this once the object is collected, using a disappearing
+   * link. The link is to this, so a weak_ref can't be copied or moved while it's set and
+   * it needs to be reset before its memory is freed by hand. Destroying one resets it, so
+   * erasing one from a container is fine.
+   *
+   * A weak_ref which is set needs to be in the GC heap, or in memory it scans, such as a
+   * GC allocated container. */
+  struct weak_ref
+  {
+    weak_ref() = default;
+    weak_ref(weak_ref const &) = delete;
+    weak_ref(weak_ref &&) = delete;
+    ~weak_ref();
+
+    weak_ref &operator=(weak_ref const &) = delete;
+    weak_ref &operator=(weak_ref &&) = delete;
+
+    void set(object_ref const o);
+    void reset();
+    /* None if this was never set or the object has been collected. */
+    jtl::option<object_ref> get() const;
+    bool is_cleared() const;
+
+    uptr hidden{};
+  };
+}
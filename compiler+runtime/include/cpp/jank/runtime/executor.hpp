@@ -0,0 +1,131 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <jank/type.hpp>
+#include <jank/util/cli.hpp>
+
+namespace jank::runtime
+{
+  /* Any thread which touches jank objects needs to be known by the GC, so that
+   * it can be paused during collection and so its stack can be scanned. Every
+   * thread we spawn holds one of these for its whole life. */
+  struct gc_thread_scope
+  {
+    gc_thread_scope();
+    gc_thread_scope(gc_thread_scope const &) = delete;
+    gc_thread_scope(gc_thread_scope &&) = delete;
+    ~gc_thread_scope();
+
+    gc_thread_scope &operator=(gc_thread_scope const &) = delete;
+    gc_thread_scope &operator=(gc_thread_scope &&) = delete;
+  };
+
+  struct executor
+  {
+    using task = std::function<void()>;
+
+    virtual ~executor() = default;
+
+    /* Tasks must not throw. Anything they throw is dropped, since there's nobody
+     * to receive it. */
+    virtual void submit(task &&t) = 0;
+
+    /* Runs a single queued task on the calling thread, if there is one. This allows
+     * a thread which is waiting on another task to help out, rather than block. */
+    virtual bool run_pending_task();
+  };
+
+  /* A fixed pool of workers, one per core by default, meant for CPU bound work. Each
+   * worker has its own deque of tasks. Tasks submitted from within a worker go onto
+   * its own deque, where they're popped LIFO for cache locality. Idle workers steal
+   * FIFO from the other end of their peers' deques.
+   *
+   * With an affinity, each worker is pinned to a core, or to the cores of one NUMA node,
+   * with the workers spread evenly across nodes. Each worker then steals from the others
+   * on its own node before any on another node, so tasks and the memory they touch tend
+   * to stay on one node. The GC has a single heap, without any per node arenas, but each
+   * worker's object pool is refilled from its own thread, so memory the GC maps fresh for
+   * it is first touched, and placed, on its node. Without an affinity, or where the
+   * topology can't be read, all of the cores count as one node. */
+  struct work_stealing_executor : executor
+  {
+    work_stealing_executor(usize const thread_count);
+    work_stealing_executor(usize const thread_count, util::cli::executor_affinity const affinity);
+    work_stealing_executor(work_stealing_executor const &) = delete;
+    work_stealing_executor(work_stealing_executor &&) = delete;
+    ~work_stealing_executor() override;
+
+    work_stealing_executor &operator=(work_stealing_executor const &) = delete;
+    work_stealing_executor &operator=(work_stealing_executor &&) = delete;
+
+    void submit(task &&t) override;
+    bool run_pending_task() override;
+
+    usize thread_count() const;
+    /* Whether or not the calling thread is one of this pool's workers. */
+    bool is_worker_thread() const;
+
+  private:
+    struct worker
+    {
+      std::mutex mutex;
+      native_deque<task> tasks;
+      std::thread thread;
+      usize node{};
+      /* The cores the worker is pinned to, which is empty when it's not pinned. */
+      native_vector<u32> cpus;
+      /* The workers to steal from, in order. Those on the same node come first and the
+       * worker itself is last. */
+      native_vector<usize> victims;
+    };
+
+    void run_worker(usize const index);
+    bool try_pop(usize const index, task &out);
+    bool try_steal(usize const thief_index, task &out);
+
+    std::vector<std::unique_ptr<worker>> workers;
+    /* The number of tasks sitting in any deque, used to know when to sleep. */
+    std::atomic<usize> pending{};
+    std::atomic<usize> next_worker{};
+    std::atomic_bool stopping{};
+    std::mutex sleep_mutex;
+    std::condition_variable wake;
+  };
+
+  /* An unbounded pool for work which may block for a long time, such as IO. A new
+   * thread is spawned whenever there's no idle thread to take a task. Idle threads
+   * exit after a while without work. */
+  struct blocking_executor : executor
+  {
+    blocking_executor() = default;
+    blocking_executor(blocking_executor const &) = delete;
+    blocking_executor(blocking_executor &&) = delete;
+    ~blocking_executor() override = default;
+
+    blocking_executor &operator=(blocking_executor const &) = delete;
+    blocking_executor &operator=(blocking_executor &&) = delete;
+
+    void submit(task &&t) override;
+
+  private:
+    void run_thread();
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    native_deque<task> tasks;
+    usize idle_threads{};
+  };
+
+  /* The pool for CPU bound work, such as futures and pmap. These match the naming
+   * of Clojure's pooled and solo agent executors. */
+  work_stealing_executor &pooled_executor();
+  /* The pool for potentially blocking work, such as send-off. */
+  blocking_executor &solo_executor();
+}
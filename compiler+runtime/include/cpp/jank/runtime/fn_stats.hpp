@@ -0,0 +1,53 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <string>
+
+#include <jank/runtime/object.hpp>
+#include <jank/util/cli.hpp>
+
+/* Per fn call counts, and optionally timings, enabled with --fn-stats or --fn-timing.
+ * Calls are counted as they go through a jit_function, the same as for tiered
+ * compilation, so direct linked calls and self tail calls aren't seen.
+ *
+ * Stats are kept by fn name, so every closure made from the same fn adds up into the
+ * same block. */
+namespace jank::runtime::fn_stats
+{
+  static constexpr usize max_arity{ 11 };
+
+  struct block
+  {
+    /* Not GC allocated, so the GC won't be scanning this for the name. */
+    std::string name;
+    std::array<std::atomic<u64>, max_arity> calls{};
+    /* Cycles spent within each arity, including whatever it calls. Recursive calls are
+     * counted at every level. */
+    std::array<std::atomic<u64>, max_arity> cycles{};
+  };
+
+  /* These are checked on every call, so they're kept inline. */
+  inline bool is_enabled()
+  {
+    return util::cli::opts.fn_stats || util::cli::opts.fn_timing;
+  }
+
+  inline bool is_timing()
+  {
+    return util::cli::opts.fn_timing;
+  }
+
+  /* Blocks live for the rest of the process, so these can be held onto. */
+  block &find_or_create(jtl::immutable_string const &name);
+
+  /* A vector of {:name :arity :calls} maps, along with :cycles when timing, for every
+   * arity which has been called, with the most called first. */
+  object_ref snapshot();
+  void reset();
+
+  inline u64 cycles()
+  {
+    return __builtin_readcyclecounter();
+  }
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <jtl/immutable_string.hpp>
+#include <jtl/result.hpp>
+
+#include <jank/runtime/object.hpp>
+
+namespace jank::runtime::heap_snapshot
+{
+  /* A snapshot is everything reachable from the loaded namespaces, as a graph of objects.
+   * The file holds each object's type, its shallow size, and its immediate dominator, which
+   * is the closest object that everything else reaching it has to go through. That's
+   * enough to work out how much memory each object keeps alive, its retained size, which
+   * is what it'd free up if it were gone.
+   *
+   * Shallow sizes are the size of the box, plus an estimate for what it owns, such as
+   * string bytes and collection nodes. Objects which are only reachable through the
+   * stack, or through things we don't walk, like closures and unrealized lazy seqs, aren't
+   * in the snapshot. */
+
+  struct type_stats
+  {
+    object_type type{};
+    usize count{};
+    usize bytes{};
+  };
+
+  /* A namespace or a var, along with what it keeps alive. */
+  struct retainer
+  {
+    jtl::immutable_string name;
+    usize retained_bytes{};
+    usize retained_count{};
+  };
+
+  struct summary
+  {
+    usize count{};
+    usize bytes{};
+    /* Biggest first. */
+    native_vector<type_stats> types;
+    /* Biggest first. */
+    native_vector<retainer> retainers;
+  };
+
+  /* Walks the heap and writes the snapshot to the file, which is overwritten. This
+   * allocates, but it doesn't stop other threads, so what they change while it runs may or
+   * may not be in the snapshot. */
+  jtl::result<summary, jtl::immutable_string> write(jtl::immutable_string const &path);
+
+  jtl::result<summary, jtl::immutable_string> read(jtl::immutable_string const &path);
+
+  /* Prints the biggest types and retainers, for the heap-summary command. */
+  void print(summary const &s, usize const top);
+}
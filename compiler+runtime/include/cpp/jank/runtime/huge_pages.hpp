@@ -0,0 +1,14 @@
+#pragma once
+
+namespace jank::runtime
+{
+  /* Asks the kernel to back the GC heap with 2MB transparent huge pages, which cuts down
+   * on TLB misses for big heaps. bdwgc has no hook for how it maps its heap, so instead,
+   * each time the heap grows, we find its sections in the process's mappings and advise
+   * them. The kernel only gives huge pages to whole, aligned 2MB ranges, which the
+   * sections are merged into as they grow next to each other.
+   *
+   * This only does anything on Linux, with transparent huge pages set to `madvise` or
+   * `always`. It gives back whether it's supported. */
+  bool enable_gc_huge_pages();
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <jtl/option.hpp>
+#include <jtl/result.hpp>
+
+#include <jank/error.hpp>
+
+namespace jank::runtime::io
+{
+  /* Large enough that reading or writing a big file takes few syscalls, but small enough
+   * that having a handful of readers and writers open doesn't matter. */
+  static constexpr usize default_buffer_size{ 256 * 1024 };
+
+  /* Regular files up to this size are read, rather than mapped, by slurp. */
+  static constexpr usize small_file_size{ 256 * 1024 };
+
+  /* Reads the whole file into a string. Large regular files are mapped and copied straight
+   * into the string, so the file is only copied once. Anything else is read into a buffer
+   * which each thread keeps, so it's also only allocated once. That includes small files,
+   * for which a read is cheaper than a map, along with pipes and files in /proc, which
+   * can't be mapped or don't know their size. This is safe to call from any thread. */
+  jtl::result<jtl::immutable_string, error_ref> slurp(jtl::immutable_string const &path);
+  jtl::result<void, error_ref>
+  spit(jtl::immutable_string const &path, jtl::immutable_string_view const &content, bool append);
+
+  /* Opens a file for a reader or writer, giving the fd. */
+  jtl::result<int, error_ref> open_file(jtl::immutable_string const &path, int flags);
+
+  /* Reads lines from a file descriptor through a buffer, so reading a line is generally
+   * just a memchr. A line which doesn't fit in the buffer grows it, so the buffer size is
+   * only a lower bound.
+   *
+   * Nothing closes a reader for us, so it should always be closed once done. This isn't
+   * thread safe. */
+  struct buffered_reader
+  {
+    /* When owns_fd is set, closing the reader closes the fd as well. */
+    buffered_reader(int fd, bool owns_fd, usize buffer_size);
+    buffered_reader(buffered_reader const &) = delete;
+    buffered_reader(buffered_reader &&) noexcept = delete;
+    ~buffered_reader();
+
+    buffered_reader &operator=(buffered_reader const &) = delete;
+    buffered_reader &operator=(buffered_reader &&) noexcept = delete;
+
+    /* Gives the next line, without its "\n" or "\r\n", or none once the fd has ended. The
+     * last line doesn't need to end with a line break. */
+    jtl::result<jtl::option<jtl::immutable_string>, error_ref> read_line();
+    void close();
+
+    /* Moves whatever is left after the head to the front of the buffer and then fills up
+     * the rest of it, growing it first if it's already full. Hitting the end of the fd
+     * sets at_eof. */
+    jtl::result<void, error_ref> refill();
+
+    int fd{ -1 };
+    bool owns_fd{};
+    bool at_eof{};
+    native_vector<char> buffer;
+    /* The part of the buffer which has been read in but not yet given out. */
+    usize head{}, tail{};
+  };
+
+  /* Writes to a file descriptor through a buffer, so small writes don't each need a
+   * syscall. A write which is larger than the buffer goes straight through.
+   *
+   * Whatever is in the buffer is only written once the buffer fills up, or the writer is
+   * flushed or closed. Nothing closes a writer for us, so it must be closed to be sure
+   * everything is written. This isn't thread safe. */
+  struct buffered_writer
+  {
+    /* When owns_fd is set, closing the writer closes the fd as well. */
+    buffered_writer(int fd, bool owns_fd, usize buffer_size);
+    buffered_writer(buffered_writer const &) = delete;
+    buffered_writer(buffered_writer &&) noexcept = delete;
+    ~buffered_writer();
+
+    buffered_writer &operator=(buffered_writer const &) = delete;
+    buffered_writer &operator=(buffered_writer &&) noexcept = delete;
+
+    jtl::result<void, error_ref> write(jtl::immutable_string_view const &s);
+    jtl::result<void, error_ref> flush();
+    jtl::result<void, error_ref> close();
+
+    int fd{ -1 };
+    bool owns_fd{};
+    native_vector<char> buffer;
+    usize capacity{};
+  };
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+
+#include <jank/runtime/ns.hpp>
+#include <jank/runtime/detail/intern_table.hpp>
+
+namespace jank::runtime
+{
+  namespace obj
+  {
+    using persistent_hash_map_ref = oref<struct persistent_hash_map>;
+  }
+
+  /* An isolate is a separate world of namespaces within the one runtime context, for
+   * hosts which run code for independent tenants. The context stays a singleton, since
+   * the JIT, the keywords, and the symbols are still shared by every isolate. What's
+   * split is everything a tenant can change:
+   *
+   *   - Namespaces made within an isolate are only seen within it, including its own user
+   *     ns, so two tenants can each define the same ns without seeing each other's vars.
+   *   - Each isolate has its own *ns* and *loaded-libs*, so each requires its own libs.
+   *
+   * Every ns which exists before an isolate is entered, like clojure.core, is shared by all
+   * of them and can't be def'd into from an isolate, so the base is never changed by a
+   * tenant. Looking up a shared ns or var takes no locks, as before, and interning into an
+   * isolate only takes its own lock, so tenants on separate threads don't contend.
+   *
+   * A thread can be within at most one isolate at a time and an isolate can only be entered
+   * by one thread at a time. Modules which are loaded from object files are loaded once
+   * per process, so those belong in the base. */
+  struct isolate
+  {
+    isolate();
+    isolate(isolate const &) = delete;
+    isolate(isolate &&) = delete;
+
+    isolate &operator=(isolate const &) = delete;
+    isolate &operator=(isolate &&) = delete;
+
+    /* The isolate which this thread has entered, if any. */
+    static isolate *current();
+
+    /* Keeps what's left of this thread's dynamic state from leaving the isolate. Since
+     * in-ns sets *ns* in place, we save the current values for the next enter. Any
+     * bindings pushed within the isolate, which are still around, are popped. */
+    void enter();
+    void exit();
+
+    /* Doesn't look at the shared namespaces. */
+    ns_ref find_ns(jtl::immutable_string_view const &name) const;
+    ns_ref intern_ns(obj::symbol_ref const sym);
+    ns_ref remove_ns(obj::symbol_ref const sym);
+
+    /* Each isolate names its JIT compiled code from its own range of counter values, so
+     * the same ns in two isolates never defines the same symbol twice. */
+    u64 const id;
+    detail::intern_table<ns_ref> namespaces;
+    /* The values of *ns* and *loaded-libs* for this isolate, while it's not entered. */
+    obj::persistent_hash_map_ref bindings;
+    std::atomic_bool entered{};
+    /* The user ns doesn't refer clojure.core until the first enter, since it may not be
+     * loaded when the isolate is made. */
+    bool referred_core{};
+    usize binding_depth{};
+  };
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <functional>
+#include <mutex>
+
+#include <jank/runtime/object.hpp>
+
+namespace jank::runtime
+{
+  using var_ref = oref<struct var>;
+
+  /* Macro expansions which are kept on disk, across runs, so that loading an unchanged
+   * module from source doesn't need to call each of its macros again. There's one cache
+   * file per module, within the binary cache dir, so a new compiler version starts fresh.
+   *
+   * Each expansion is keyed by the expanded form, printed with all of its meta, which
+   * includes where it was read from. It's only used if the macro var is the same and the
+   * cache key of the macro's module, which covers its source and dependencies, is
+   * unchanged. Only forms read from files are cached and only expansions which can be read
+   * back exactly are kept; anything else is just expanded as normal. */
+  struct macroexpand_cache
+  {
+    struct entry
+    {
+      jtl::immutable_string fingerprint;
+      jtl::immutable_string expansion;
+      /* The symbol counter of the current ns, once the macro had been called. Any gensyms
+       * in the expansion came from below it, so we move the counter past it on a hit, to
+       * keep new gensyms from clashing with the cached ones. */
+      u64 symbol_counter{};
+    };
+
+    struct module_entries
+    {
+      native_unordered_map<jtl::immutable_string, entry> entries;
+      bool dirty{};
+    };
+
+    /* Finds the expansion of the form by the macro, calling expand when it's not cached. */
+    object_ref
+    expand(var_ref macro, object_ref form, std::function<object_ref()> const &expand_fn);
+    /* Writes out the cache file of each module which has new expansions. */
+    void flush();
+
+    module_entries &find_module(jtl::immutable_string const &module);
+    jtl::option<jtl::immutable_string> fingerprint(var_ref macro);
+
+    /* This isn't held while a macro is called, since macros can expand other forms. */
+    std::mutex mutex;
+    native_unordered_map<jtl::immutable_string, module_entries> modules;
+    native_unordered_map<jtl::immutable_string, jtl::immutable_string> module_keys;
+  };
+}
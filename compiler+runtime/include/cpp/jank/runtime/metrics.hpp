@@ -0,0 +1,110 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <limits>
+#include <vector>
+
+#include <jtl/ref.hpp>
+#include <jtl/result.hpp>
+
+#include <jank/runtime/object.hpp>
+
+/* A registry of named counters, gauges, and histograms, for production metrics. Recording
+ * is lock free and doesn't allocate, so it's cheap enough for timing each request. Each
+ * thread records into one of a set of stripes, like counter_atom, and the stripes are
+ * merged whenever the registry is read.
+ *
+ * Metrics live for the rest of the process, so references to them can be held onto. The
+ * runtime publishes its own GC, JIT, and executor metrics here, all prefixed with jank_. */
+namespace jank::runtime::metrics
+{
+  static constexpr usize stripe_count{ 16 };
+
+  /* Padded out to a cache line, so no two stripes share one. */
+  struct alignas(64) counter_stripe
+  {
+    std::atomic<i64> count{};
+  };
+
+  struct counter
+  {
+    void add(i64 const n);
+    i64 value() const;
+
+    std::array<counter_stripe, stripe_count> stripes{};
+  };
+
+  /* A value which goes up and down, where only the latest one matters. */
+  struct gauge
+  {
+    void set(f64 const v);
+    f64 value() const;
+
+    std::atomic<f64> current{};
+  };
+
+  struct histogram_summary
+  {
+    /* The value at or below which p percent of the values fall, to within the
+     * histogram's precision. */
+    u64 percentile(f64 const p) const;
+
+    u64 count{};
+    u64 sum{};
+    u64 min{};
+    u64 max{};
+    std::vector<u64> buckets;
+  };
+
+  /* An HDR histogram of non-negative integers, such as latencies in nanoseconds. Values
+   * below sub_bucket_count are kept exactly. Above that, each power of two is split into
+   * sub_bucket_count buckets, so every value is kept to within about 3%. Values past
+   * 2^max_exponent, which is over a day in nanoseconds, land in the last bucket. */
+  struct histogram
+  {
+    static constexpr usize sub_bucket_bits{ 5 };
+    static constexpr usize sub_bucket_count{ 1 << sub_bucket_bits };
+    static constexpr usize max_exponent{ 47 };
+    static constexpr usize bucket_count{ (max_exponent - sub_bucket_bits + 2)
+                                         * sub_bucket_count };
+    /* Fewer stripes than for counters, since each one is 11KB. */
+    static constexpr usize stripe_count{ 4 };
+
+    struct alignas(64) stripe
+    {
+      std::atomic<u64> count{};
+      std::atomic<u64> sum{};
+      std::atomic<u64> min{ std::numeric_limits<u64>::max() };
+      std::atomic<u64> max{};
+      std::array<std::atomic<u64>, bucket_count> buckets{};
+    };
+
+    static usize bucket_index(u64 const value);
+    /* The largest value which lands in the bucket. */
+    static u64 bucket_max(usize const index);
+
+    void record(u64 const value);
+    histogram_summary summarize() const;
+
+    std::array<stripe, stripe_count> stripes{};
+  };
+
+  /* Names must be valid for Prometheus, which means letters, digits, underscores, and
+   * colons, not starting with a digit. Asking for a name which already exists gives the
+   * existing metric, but only if it's the same kind. */
+  jtl::result<jtl::ref<counter>, jtl::immutable_string>
+  find_or_create_counter(jtl::immutable_string const &name, jtl::immutable_string const &help);
+  jtl::result<jtl::ref<gauge>, jtl::immutable_string>
+  find_or_create_gauge(jtl::immutable_string const &name, jtl::immutable_string const &help);
+  jtl::result<jtl::ref<histogram>, jtl::immutable_string>
+  find_or_create_histogram(jtl::immutable_string const &name, jtl::immutable_string const &help);
+
+  /* A map of each metric's name to a map of its :type and :help, along with its :value,
+   * for counters and gauges, or its :count, :sum, :min, :max, :mean, and :percentiles,
+   * for histograms. */
+  object_ref snapshot();
+  /* Every metric in the Prometheus text format. Histograms are given as summaries, with
+   * their 0.5, 0.9, 0.99, and 0.999 quantiles. */
+  jtl::immutable_string prometheus();
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <filesystem>
+#include <mutex>
 
 #include <jtl/result.hpp>
 
@@ -88,7 +89,7 @@ namespace jank::runtime::module
 
     /* In the case where we map a file, we track this information so we can read it and
      * later unmap it. */
-    int fd{};
+    int fd{ -1 };
     char const *head{};
     usize len{};
 
@@ -136,6 +137,28 @@ namespace jank::runtime::module
       jtl::option<file_entry> cljc;
     };
 
+    /* One entry of the module path. Entries are only looked into once a module is needed,
+     * rather than all being walked at startup. Jars are indexed the first time they're
+     * probed and each jar's index is saved in the user cache, keyed by the jar's size and a
+     * hash of its directory, so later processes can skip looking through the jar. */
+    struct module_root
+    {
+      enum class kind : u8
+      {
+        /* The path doesn't exist yet, so we'll check again next time. */
+        unknown,
+        directory,
+        jar,
+        file
+      };
+
+      jtl::immutable_string path;
+      kind type{};
+      jtl::immutable_string resolved_path;
+      /* For a file on its own, this is the module it provides. */
+      jtl::immutable_string module;
+    };
+
     struct find_result
     {
       /* All the sources for a module */
@@ -171,6 +194,51 @@ namespace jank::runtime::module
     jtl::result<void, error_ref> load_jank(file_entry const &entry) const;
     jtl::result<void, error_ref> load_cljc(file_entry const &entry) const;
 
+    /* Binaries are validated by content, rather than by timestamps, since timestamps aren't
+     * reliable across checkouts, containers, and build agents. Each object file has a key
+     * file next to it, as `foo.o.key`, holding the cache key it was compiled with and the
+     * modules it required. The key is a SHA256 of the binary version, which covers the
+     * compiler and its flags, the module's name and source, and the keys of its dependencies.
+     * There are no paths in it, so a binary cache can be shared and moved around. */
+    jtl::result<jtl::immutable_string, error_ref>
+    cache_key(jtl::immutable_string const &module,
+              file_entry const &source,
+              native_vector<jtl::immutable_string> const &dependencies);
+    /* The key of a module which is loaded, or being loaded, from source, using the modules
+     * it has required so far. This isn't remembered in cache_keys, since it may be taken
+     * before the module has required everything. */
+    jtl::result<jtl::immutable_string, error_ref>
+    loaded_cache_key(jtl::immutable_string const &module);
+    bool is_binary_current(jtl::immutable_string const &module,
+                           file_entry const &source,
+                           file_entry const &binary);
+    /* Before a top level load, this walks the binaries the module would be loaded from,
+     * using the dependencies in their key files, and hashes all of their sources in
+     * parallel. Checking the keys still happens in order, as part of the load, but it
+     * then only needs to look the hashes up. */
+    void prefetch_source_hashes(jtl::immutable_string const &module);
+    jtl::result<jtl::immutable_string, error_ref> source_hash(file_entry const &source);
+    /* Writes the key file of a freshly compiled module and, with a writable remote cache,
+     * publishes the binary along with it. */
+    jtl::result<void, error_ref> write_cache_key(jtl::immutable_string const &module);
+    /* Fetches a module's binary from the remote cache into the binary cache dir, along with
+     * its key file, when the remote has one which is current for the given source. The
+     * binary is checked against its digest and the key against our own, so a remote cache
+     * is never trusted any further than the local one. */
+    jtl::option<file_entry>
+    fetch_remote_binary(jtl::immutable_string const &module, file_entry const &source);
+    /* Writes the keys of every module compiled since the last call. This must only be
+     * called once their object files have been written. */
+    jtl::result<void, error_ref> write_pending_cache_keys();
+
+    /* A startup image lists the binary of each module which a run loaded from one, along
+     * with its cache key. With an image, those modules are loaded straight from their
+     * binaries, without finding or hashing their sources, so long as each binary still has
+     * the key it was saved with. The catch is that source changes aren't noticed until the
+     * binary is rebuilt, such as by a run without the image. */
+    jtl::result<void, error_ref> read_image(jtl::immutable_string const &path);
+    jtl::result<void, error_ref> write_image(jtl::immutable_string const &path);
+
     /* This only adds a single path, so it's assumed there's no separator present. */
     void add_path(jtl::immutable_string const &path);
 
@@ -178,8 +246,22 @@ namespace jank::runtime::module
 
     jtl::immutable_string paths;
     /* TODO: These will need synchonization. */
+    native_vector<module_root> roots;
     /* This maps module strings to entries. Module strings are like fully qualified namespace
-     * names. For example, `clojure.core`, `jank.compiler`, etc. */
+     * names. For example, `clojure.core`, `jank.compiler`, etc. Only modules which have
+     * been found are in here. */
     native_unordered_map<jtl::immutable_string, entry> entries;
+    /* The modules currently being loaded, innermost last, so we know who requires whom. */
+    native_vector<jtl::immutable_string> loading;
+    /* Cache keys are computed at most once per module for each top level load, since every
+     * one of them depends on the keys of its whole dependency tree. */
+    native_unordered_map<jtl::immutable_string, jtl::immutable_string> cache_keys;
+    native_vector<jtl::immutable_string> pending_cache_keys;
+    /* The SHA256 of each module source, by path, which are also only kept for the duration
+     * of a top level load. These are filled in from other threads. */
+    std::mutex source_hashes_mutex;
+    native_unordered_map<jtl::immutable_string, jtl::immutable_string> source_hashes;
+    /* The binaries read from the startup image, by module. */
+    native_unordered_map<jtl::immutable_string, file_entry> image_binaries;
   };
 }
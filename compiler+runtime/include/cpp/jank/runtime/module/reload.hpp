@@ -0,0 +1,90 @@
+#pragma once
+
+#include <condition_variable>
+#include <ctime>
+#include <mutex>
+#include <thread>
+
+#include <jtl/result.hpp>
+
+#include <jank/runtime/object.hpp>
+#include <jank/error.hpp>
+
+namespace jank::runtime::module
+{
+  /* Reloads the modules whose sources have changed on disk, without loading everything
+   * again. For each tracked module, we keep its source's modification time and a hash of
+   * the text of each of its top level forms. When the source changes, it's read again and
+   * only the forms whose text isn't among the old hashes are evaluated, in order, within
+   * the module's ns. Unchanged forms are only read, so that the forms after them are read
+   * in the right ns.
+   *
+   * Vars are dereferenced on each call, so the modules which require a patched one will
+   * see its new defs without being touched. That doesn't hold for everything, so some
+   * changes need a module, and then every module which depends on it, to be loaded again
+   * as a whole, in load order:
+   *
+   *   1. A changed macro, since its old expansion is baked into every form which used it.
+   *   2. Any change at all, when direct linking is enabled, since callers link right to
+   *      the old fns.
+   *
+   * Modules are tracked from the first scan after they're loaded, so a change made in
+   * between isn't noticed until the next one. Modules within JARs and core modules are
+   * never tracked. */
+  struct reloader
+  {
+    struct tracked_module
+    {
+      jtl::immutable_string path;
+      std::time_t modified_at{};
+      /* Sorted, so we can search them. */
+      native_vector<usize> form_hashes;
+    };
+
+    struct reload_result
+    {
+      object_ref to_runtime_data() const;
+
+      /* Modules which had only their changed forms evaluated, with how many there were. */
+      native_vector<std::pair<jtl::immutable_string, usize>> patched;
+      /* Modules which were loaded again as a whole, in the order they were loaded. */
+      native_vector<jtl::immutable_string> reloaded;
+    };
+
+    reloader() = default;
+    reloader(reloader const &) = delete;
+    reloader(reloader &&) = delete;
+    ~reloader();
+
+    reloader &operator=(reloader const &) = delete;
+    reloader &operator=(reloader &&) = delete;
+
+    /* Starts tracking each loaded module which isn't tracked yet. */
+    jtl::result<void, error_ref> track_loaded_modules();
+    /* Tracks any new modules and then reloads those which have changed. */
+    jtl::result<reload_result, error_ref> reload_changed();
+
+    /* Calls reload_changed every interval_ms on a thread of its own, until unwatch is
+     * called. The callback, if there is one, is called with the result of each reload
+     * which did anything. Failures are printed, and the failed module is tried again once
+     * it changes again. */
+    void watch(i64 const interval_ms, jtl::option<object_ref> const &on_reload);
+    void unwatch();
+
+  private:
+    jtl::result<void, error_ref> track(jtl::immutable_string const &module);
+    jtl::result<bool, error_ref>
+    patch(jtl::immutable_string const &module, tracked_module &tracked, reload_result &result);
+    jtl::result<void, error_ref> reload_whole(jtl::immutable_string const &module);
+
+    /* Held for the whole of each scan, so the watcher and explicit reloads don't step on
+     * each other. */
+    std::recursive_mutex mutex;
+    native_unordered_map<jtl::immutable_string, tracked_module> modules;
+
+    std::mutex watch_mutex;
+    std::condition_variable watch_cv;
+    std::thread watcher;
+    bool is_watching{};
+  };
+}
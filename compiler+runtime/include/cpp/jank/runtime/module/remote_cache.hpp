@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+#include <jtl/option.hpp>
+#include <jtl/result.hpp>
+#include <jtl/immutable_string.hpp>
+
+namespace jank::runtime::module
+{
+  /* A remote cache shares compiled binaries between machines, such as CI runners and
+   * developer machines, so that none of them needs to compile what another already has.
+   * It's laid out the same as bazel-remote's HTTP cache, so one of those can be used as is.
+   * Binaries are kept in the content store, by the SHA256 of their contents. The action
+   * store maps what went into a binary to its content key, along with anything needed to
+   * check that it's still current.
+   *
+   * A remote cache is only ever an optimization, so failing to reach one is never an
+   * error. The first failure is warned about and the cache isn't used again for the rest
+   * of the process. */
+  struct remote_cache
+  {
+    enum class store : u8
+    {
+      action,
+      content
+    };
+
+    virtual ~remote_cache() = default;
+
+    /* None on a miss, or when the cache can't be reached. */
+    jtl::option<jtl::immutable_string> get(store s, jtl::immutable_string const &key);
+    void put(store s, jtl::immutable_string const &key, jtl::immutable_string const &data);
+
+  protected:
+    virtual jtl::string_result<jtl::option<jtl::immutable_string>>
+    read(store s, jtl::immutable_string const &key) = 0;
+    virtual jtl::string_result<void>
+    write(store s, jtl::immutable_string const &key, jtl::immutable_string const &data) = 0;
+
+  private:
+    void fail(jtl::immutable_string const &message);
+
+    std::atomic_bool unreachable{};
+  };
+
+  /* Understands http://host[:port][/prefix] and plain directories, which may also be given
+   * as file:// URLs. A directory can be any shared file system. */
+  std::unique_ptr<remote_cache> make_remote_cache(jtl::immutable_string const &url);
+  /* The cache named by --remote-cache, or null when there isn't one. */
+  remote_cache *configured_remote_cache();
+  /* Whether binaries compiled by this process should be added to the remote cache. */
+  bool is_remote_cache_writable();
+
+  /* The PCH is shared the same way as module binaries are, keyed by the binary version.
+   * A fetched PCH is written to where it would have been built. */
+  jtl::option<jtl::immutable_string> fetch_remote_pch(jtl::immutable_string const &binary_version);
+  void publish_remote_pch(jtl::immutable_string const &binary_version,
+                          jtl::immutable_string const &path);
+}
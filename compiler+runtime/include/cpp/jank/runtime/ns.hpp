@@ -25,9 +25,18 @@ namespace jank::runtime
 
     var_ref intern_var(jtl::immutable_string_view const &);
     var_ref intern_var(obj::symbol_ref const);
+    /* Interns every one of these vars under a single lock, giving them back in the same
+     * order. This is how modules and native namespaces register their vars at load time. */
+    native_vector<var_ref> intern_vars(native_vector<obj::symbol_ref> const &syms);
     var_ref intern_owned_var(jtl::immutable_string_view const &);
     var_ref intern_owned_var(obj::symbol_ref const);
     var_ref find_var(obj::symbol_ref const);
+    /* A segment is a module which defines more of this ns, but is only loaded once one of
+     * its vars is first resolved. Until then, its vars are interned, but unbound, so they
+     * can still be referred. */
+    void defer_segment(jtl::immutable_string const &module,
+                       native_vector<obj::symbol_ref> const &syms);
+    void load_segment_of(obj::symbol_ref const sym);
     jtl::result<void, jtl::immutable_string> unmap(obj::symbol_ref const sym);
 
     jtl::result<void, jtl::immutable_string> add_alias(obj::symbol_ref const sym, ns_ref const ns);
@@ -38,10 +47,17 @@ namespace jank::runtime
 
     obj::persistent_hash_map_ref get_mappings() const;
 
+    /* The names starting with the prefix which can be typed within this ns, each with the
+     * ns, var, or keyword it names. Vars of other namespaces are only given when they're
+     * referred here or the prefix names their ns, or an alias of it, like `str/jo`. */
+    native_vector<std::pair<jtl::immutable_string, object_ref>>
+    completions(jtl::immutable_string const &prefix, usize const max) const;
+
     /* behavior::object_like */
     bool equal(object const &) const;
     jtl::immutable_string to_string() const;
     jtl::immutable_string to_code_string() const;
+    void to_code_string(jtl::string_builder &buff) const;
     void to_string(jtl::string_builder &buff) const;
     uhash to_hash() const;
 
@@ -56,6 +72,9 @@ namespace jank::runtime
     /* TODO: Benchmark the use of atomics here. That's what Clojure uses. */
     folly::Synchronized<obj::persistent_hash_map_ref> vars;
     folly::Synchronized<obj::persistent_hash_map_ref> aliases;
+    /* Each var of a segment which hasn't yet been loaded, to the module of its segment. */
+    folly::Synchronized<native_unordered_map<obj::symbol_ref, jtl::immutable_string>> segments;
+    std::atomic_bool has_segments{};
 
     std::atomic_uint64_t symbol_counter{};
   };
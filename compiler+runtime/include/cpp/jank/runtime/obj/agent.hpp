@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+
+#include <folly/Synchronized.h>
+
+#include <jank/runtime/object.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
+
+namespace jank::runtime
+{
+  struct executor;
+}
+
+namespace jank::runtime::obj
+{
+  using agent_ref = oref<struct agent>;
+
+  /* An agent runs the actions sent to it one at a time, on an executor, each with the
+   * agent's state as its first arg and returning the new state.
+   *
+   * Senders push actions onto a lock free stack, without ever blocking. Only one batch
+   * of actions is scheduled on an executor at a time, and each batch takes everything
+   * which has been sent so far and runs it in order, up to a quantum, before yielding
+   * its thread. A busy agent then costs one task submission per batch, rather than one
+   * per action. */
+  struct agent
+  {
+    static constexpr object_type obj_type{ object_type::agent };
+    static constexpr bool pointer_free{ false };
+
+    struct action
+    {
+      object_ref fn;
+      object_ref args;
+      /* The sender's thread bindings, which are conveyed to the action. */
+      persistent_hash_map_ref bindings;
+      executor *exec{};
+      action *next{};
+    };
+
+    agent() = default;
+    agent(object_ref const state);
+
+    /* behavior::object_like */
+    bool equal(object const &) const;
+    jtl::immutable_string to_string() const;
+    void to_string(jtl::string_builder &buff) const;
+    jtl::immutable_string to_code_string() const;
+    void to_code_string(jtl::string_builder &buff) const;
+    uhash to_hash() const;
+
+    /* behavior::derefable */
+    object_ref deref() const;
+
+    /* behavior::ref_like */
+    void add_watch(object_ref const key, object_ref const fn);
+    void remove_watch(object_ref const key);
+
+    /* Queues (apply fn state args) to be run on the executor. Sends made from within an
+     * action are held until that action has finished, unless they're released sooner
+     * with release_pending_sends. This throws if the agent is failed. */
+    void dispatch(object_ref const fn, object_ref const args, executor &e);
+    /* Dispatches the sends held by the action running on this thread. Gives back how
+     * many there were. */
+    static usize release_pending_sends();
+    /* Stops all agents from accepting new actions. Queued actions still run. */
+    static void shutdown();
+
+    object_ref get_error() const;
+    /* Throws if the agent isn't failed. Held actions then run, unless they're cleared. */
+    void restart(object_ref const new_state, bool const clear_actions);
+    object_ref get_error_handler() const;
+    void set_error_handler(object_ref const fn);
+    object_ref get_error_mode() const;
+    void set_error_mode(object_ref const mode);
+
+  private:
+    void enqueue(action * const act);
+    void schedule();
+    void take_incoming();
+    void run_batch();
+    void run_action(action const &act);
+    void handle_error(object_ref const err);
+    bool is_failed() const;
+
+  public:
+    object base{ obj_type };
+    std::atomic<object *> state{};
+    /* Newly sent actions, newest first. */
+    std::atomic<action *> incoming{};
+    /* Actions taken from incoming, oldest first. These are only touched by whoever holds
+     * the scheduled flag. */
+    action *backlog{};
+    action *backlog_tail{};
+    /* Set while a batch is queued or running. This is what keeps actions serial. */
+    std::atomic_bool scheduled{};
+
+    mutable std::mutex error_mutex;
+    object_ref error{};
+    object_ref error_handler{};
+    object_ref error_mode{};
+
+    folly::Synchronized<persistent_hash_map_ref> watches{};
+  };
+}
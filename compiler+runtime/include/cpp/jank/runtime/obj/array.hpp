@@ -0,0 +1,157 @@
+#pragma once
+
+#include <jtl/trait/predicate.hpp>
+
+#include <jank/runtime/object.hpp>
+#include <jank/runtime/obj/native_vector_sequence.hpp>
+
+namespace jank::runtime::obj
+{
+  using array_ref = oref<struct array>;
+
+  /* A mutable array with a fixed length, like a Java array. Primitive arrays, such as those
+   * from long-array or double-array, keep their elements unboxed and next to each other,
+   * so numeric code can work through them without allocating. Their storage is aligned to
+   * a cache line, which is enough for any SIMD loads and stores. Object arrays hold refs.
+   *
+   * As in Clojure, arrays are compared by identity and aren't thread safe. */
+  struct array
+  {
+    static constexpr object_type obj_type{ object_type::array };
+    static constexpr bool pointer_free{ false };
+    static constexpr usize alignment{ 64 };
+
+    enum class element_type : u8
+    {
+      object,
+      boolean,
+      byte,
+      short_,
+      char_,
+      int_,
+      long_,
+      float_,
+      double_
+    };
+
+    array() = delete;
+    array(array &&) noexcept = default;
+    array(array const &) = default;
+    array(element_type const element, usize const length);
+    /* Wraps native storage, without copying it. The storage is still owned by its native
+     * code and it needs to outlive the array. */
+    array(element_type const element, void * const borrowed, usize const length);
+
+    /* The type is a keyword or symbol naming the element type, like :long or 'double. */
+    static element_type parse_element_type(object_ref const type);
+    static usize element_size(element_type const element);
+
+    template <typename T>
+    static constexpr bool
+      is_element{ jtl::is_any_same<T, object_ref, bool, i8, i16, char32_t, i32, i64, f32, f64> };
+
+    /* The element type which stores a T, for arrays which borrow native storage. */
+    template <typename T>
+    requires is_element<T>
+    static constexpr element_type element_type_of()
+    {
+      if constexpr(jtl::is_same<T, object_ref>)
+      {
+        return element_type::object;
+      }
+      else if constexpr(jtl::is_same<T, bool>)
+      {
+        return element_type::boolean;
+      }
+      else if constexpr(jtl::is_same<T, i8>)
+      {
+        return element_type::byte;
+      }
+      else if constexpr(jtl::is_same<T, i16>)
+      {
+        return element_type::short_;
+      }
+      else if constexpr(jtl::is_same<T, char32_t>)
+      {
+        return element_type::char_;
+      }
+      else if constexpr(jtl::is_same<T, i32>)
+      {
+        return element_type::int_;
+      }
+      else if constexpr(jtl::is_same<T, i64>)
+      {
+        return element_type::long_;
+      }
+      else if constexpr(jtl::is_same<T, f32>)
+      {
+        return element_type::float_;
+      }
+      else
+      {
+        return element_type::double_;
+      }
+    }
+
+    /* These convert one element to and from its boxed form, just as get and set do. */
+    template <typename T>
+    requires is_element<T>
+    static object_ref box(T const e);
+    template <typename T>
+    requires is_element<T>
+    static T unbox(object_ref const o);
+
+    /* These back the typed array fns, like long-array. A number is a length, which is
+     * filled with zeroes, and anything else is a seq of the elements. */
+    static array_ref create(object_ref const type, object_ref const size_or_seq);
+    /* The init is either a value for every element or a seq of the first elements. Any
+     * elements the seq doesn't reach are zero. */
+    static array_ref
+    create_filled(object_ref const type, object_ref const size, object_ref const init_or_seq);
+    /* Backs make-array. Each dimension past the first is an object array of arrays. */
+    static array_ref make(object_ref const type, object_ref const dims);
+    /* Backs to-array and into-array. */
+    static array_ref from_seq(object_ref const type, object_ref const coll);
+
+    /* These back aget, aset, alength, and aclone, which are inlined as calls to them. */
+    static object_ref aget(object_ref const a, object_ref const index);
+    static object_ref aset(object_ref const a, object_ref const index, object_ref const val);
+    static object_ref alength(object_ref const a);
+    static array_ref aclone(object_ref const a);
+
+    /* behavior::object_like */
+    bool equal(object const &) const;
+    jtl::immutable_string to_string() const;
+    void to_string(jtl::string_builder &buff) const;
+    jtl::immutable_string to_code_string() const;
+    uhash to_hash() const;
+
+    /* behavior::seqable */
+    native_vector_sequence_ref seq() const;
+    native_vector_sequence_ref fresh_seq() const;
+
+    /* behavior::countable */
+    usize count() const;
+
+    /* behavior::indexable */
+    object_ref nth(object_ref const index) const;
+    object_ref nth(object_ref const index, object_ref const fallback) const;
+
+    /* These box and unbox the element, for the element type. */
+    object_ref get(usize const index) const;
+    void set(usize const index, object_ref const val);
+
+    /* Direct access to the elements, which needs to match the element type. */
+    template <typename T>
+    T *data_as() const
+    {
+      return static_cast<T *>(data);
+    }
+
+    object base{ obj_type };
+    element_type element{};
+    usize length{};
+    /* Primitive elements are allocated as pointer free, so the GC doesn't scan them. */
+    void *data{};
+  };
+}
@@ -10,6 +10,7 @@ namespace jank::runtime::obj
   {
     static constexpr object_type obj_type{ object_type::array_chunk };
     static constexpr bool pointer_free{ false };
+    static constexpr bool pooled{ true };
 
     array_chunk() = default;
     array_chunk(native_vector<object_ref> const &buffer);
@@ -21,6 +22,7 @@ namespace jank::runtime::obj
     jtl::immutable_string to_string() const;
     void to_string(jtl::string_builder &buff) const;
     jtl::immutable_string to_code_string() const;
+    void to_code_string(jtl::string_builder &buff) const;
     uhash to_hash() const;
 
     /* behavior::chunk_like */
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+
 #include <folly/Synchronized.h>
 
 #include <jank/runtime/object.hpp>
@@ -23,6 +25,7 @@ namespace jank::runtime::obj
     jtl::immutable_string to_string() const;
     void to_string(jtl::string_builder &buff) const;
     jtl::immutable_string to_code_string() const;
+    void to_code_string(jtl::string_builder &buff) const;
     uhash to_hash() const;
 
     /* behavior::derefable */
@@ -33,7 +36,9 @@ namespace jank::runtime::obj
     /* Same as reset, but returns a vector of the old value and the new value. */
     persistent_vector_ref reset_vals(object_ref const o);
 
-    /* Atomically updates the value of the atom with the specified fn. Returns the new value. */
+    /* Atomically updates the value of the atom with the specified fn. Returns the new value.
+     * When another thread gets in first, the fn is called again, after a back off which
+     * grows with each failed attempt. */
     object_ref swap(object_ref const fn);
     object_ref swap(object_ref const fn, object_ref const a1);
     object_ref swap(object_ref const fn, object_ref const a1, object_ref const a2);
@@ -61,5 +66,8 @@ namespace jank::runtime::obj
     /* Since watches is a 'persistent_hash_map", there in no guarantee in which
      * order watches are invoked. */
     folly::Synchronized<persistent_hash_map_ref> watches{};
+    /* How many swaps had to retry, and how many retries they needed in total. */
+    std::atomic<u64> contended_swaps{};
+    std::atomic<u64> retries{};
   };
 }
@@ -52,6 +52,7 @@ namespace jank::runtime::obj
     jtl::immutable_string to_string() const;
     void to_string(jtl::string_builder &buff) const;
     jtl::immutable_string to_code_string() const;
+    void to_code_string(jtl::string_builder &buff) const;
     uhash to_hash() const;
 
     /* behavior::comparable */
@@ -50,6 +50,7 @@ namespace jank::runtime::obj
     jtl::immutable_string to_string() const;
     void to_string(jtl::string_builder &buff) const;
     jtl::immutable_string to_code_string() const;
+    void to_code_string(jtl::string_builder &buff) const;
     uhash to_hash() const;
 
     /* behavior::comparable */
@@ -63,6 +64,14 @@ namespace jank::runtime::obj
     f64 to_real() const;
 
     static native_big_integer gcd(native_big_integer const &, native_big_integer const &);
+    /* Boost keeps values of up to 128 bits inline, so small big integers never touch the
+     * heap. These go one step further: when both sides fit in an i64, which is the common
+     * case, they do the math natively in 128 bits rather than looping over limbs. */
+    static native_big_integer add(native_big_integer const &, native_big_integer const &);
+    static native_big_integer sub(native_big_integer const &, native_big_integer const &);
+    static native_big_integer mul(native_big_integer const &, native_big_integer const &);
+    /* Gives whether the value fits in an i64, storing it in the out param if so. */
+    static bool to_small(native_big_integer const &, i64 &);
     static i64 to_i64(native_big_integer const &);
     static f64 to_f64(native_big_integer const &);
     static uhash to_hash(native_big_integer const &);
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <mutex>
+
+#include <jtl/option.hpp>
+
+#include <jank/runtime/object.hpp>
+#include <jank/runtime/detail/weak_ref.hpp>
+
+namespace jank::runtime::obj
+{
+  using cache_ref = oref<struct cache>;
+
+  /* A concurrent cache of values by key, which backs memoize and jank.cache. Keys are
+   * hashed onto a set of shards, each with its own lock and table, so threads working on
+   * different keys rarely wait on each other. A hit locks one shard and doesn't allocate.
+   *
+   * A cache can be bounded by size, in which case each shard evicts its least recently
+   * used entry when it's full. That's only an approximation of LRU across the whole cache,
+   * since it's the shard's oldest entry which goes. Small caches use a single shard, so
+   * they're exact. A cache can also be given a time to live, after which entries are
+   * treated as missing.
+   *
+   * Each key is a number of args, so memoized calls with up to three args don't need a
+   * seq made of them.
+   *
+   * A cache can hold its keys or values weakly, so that an entry goes away once its key,
+   * or its value, is collected. Weak keys are still compared by equality, but an entry is
+   * only found while the key it was stored with is alive. A value which refers to its
+   * own key keeps that key alive, so its entry is never collected. A soft cache holds its
+   * entries as usual, but it's cleared when the GC heap grows past the soft limit, so a
+   * cache can use spare memory without pushing the process into running out of it. */
+  struct cache
+  {
+    static constexpr object_type obj_type{ object_type::cache };
+    static constexpr bool pointer_free{ false };
+    static constexpr usize shard_count{ 16 };
+    /* A bounded cache only uses more than one shard once each can hold this many. */
+    static constexpr usize min_shard_size{ 64 };
+    static constexpr usize max_inline_args{ 3 };
+    /* A shard with weak keys or values is swept for entries which have been collected
+     * once it's grown to twice what was left after the last sweep, or to this. */
+    static constexpr usize min_sweep_size{ 64 };
+
+    struct entry;
+
+    struct key
+    {
+      bool operator==(key const &rhs) const;
+
+      /* These are nil and refs is set for a key within a cache with weak keys. */
+      mutable std::array<object_ref, max_inline_args> args{};
+      /* With more than max_inline_args args, all of them are in here, as a seq. */
+      mutable object_ref rest{};
+      /* The entry which weakly holds the args of this key. */
+      mutable entry const *refs{};
+      u8 arity{};
+      uhash hash{};
+    };
+
+    struct key_hash
+    {
+      usize operator()(key const &k) const
+      {
+        return k.hash;
+      }
+    };
+
+    struct entry
+    {
+      /* Nil with weak values, which are in weak_value instead. */
+      object_ref value;
+      runtime::detail::weak_ref weak_value;
+      /* With weak keys, the args of the entry's key. */
+      std::array<runtime::detail::weak_ref, max_inline_args> weak_args;
+      runtime::detail::weak_ref weak_rest;
+      native_list<key>::iterator lru;
+      /* On the steady clock, in nanoseconds. Zero if the cache has no time to live. */
+      i64 expires_at{};
+    };
+
+    struct shard
+    {
+      std::mutex mutex;
+      native_unordered_map<key, entry, key_hash> entries;
+      /* Most recently used first. This is only kept for bounded caches. */
+      native_list<key> lru;
+      usize sweep_at{ min_sweep_size };
+    };
+
+    struct options
+    {
+      /* Zero means no bound. */
+      usize max_size{};
+      i64 ttl_ms{};
+      bool weak_keys{};
+      bool weak_values{};
+      bool soft{};
+    };
+
+    cache() = default;
+    /* A max_size or ttl_ms of zero means no bound. */
+    cache(usize const max_size, i64 const ttl_ms);
+    cache(options const &opts);
+
+    static key make_key();
+    static key make_key(object_ref const a);
+    static key make_key(object_ref const a, object_ref const b);
+    static key make_key(object_ref const a, object_ref const b, object_ref const c);
+    static key make_key_rest(object_ref const args);
+
+    /* behavior::object_like */
+    bool equal(object const &) const;
+    jtl::immutable_string to_string() const;
+    void to_string(jtl::string_builder &buff) const;
+    jtl::immutable_string to_code_string() const;
+    void to_code_string(jtl::string_builder &buff) const;
+    uhash to_hash() const;
+
+    jtl::option<object_ref> find(key const &k);
+    void store(key const &k, object_ref const value);
+    /* Gives whether there was an entry to evict. */
+    bool evict(key const &k);
+    void clear();
+    usize size();
+    /* A map of :hits, :misses, :evictions, :collected, :cleared, and :size. Evictions only
+     * count entries pushed out by the size bound, not those which expired or were evicted
+     * by hand. Collected entries had a weak key or value collected, and :cleared is the
+     * number of times a soft cache was cleared. The size can include collected entries
+     * which haven't been swept yet. */
+    object_ref stats();
+
+    /* Clears a soft cache if the heap has grown past the soft limit since it last was.
+     * Shards which are locked, such as by this thread, are skipped. */
+    void relieve_pressure();
+
+    object base{ obj_type };
+    usize max_size{};
+    usize max_shard_size{};
+    usize shards_in_use{ shard_count };
+    i64 ttl_ns{};
+    bool weak_keys{};
+    bool weak_values{};
+    bool soft{};
+    std::array<shard, shard_count> shards;
+    std::atomic<u64> hits{};
+    std::atomic<u64> misses{};
+    std::atomic<u64> evictions{};
+    std::atomic<u64> collected{};
+    std::atomic<u64> cleared{};
+    /* The soft pressure epoch which this cache was last cleared for. */
+    std::atomic<u64> relieved_epoch{};
+  };
+}
+
+namespace jank::runtime
+{
+  /* Takes a map of :max-size, :ttl-ms, :weak-keys, :weak-values, and :soft, any of which
+   * can be left out. */
+  object_ref make_cache(object_ref const opts);
+
+  /* Soft caches are cleared once the GC heap grows past this many bytes. By default, it's
+   * three quarters of the --gc-max-heap-size, if there is one, or of the physical memory.
+   * Setting it to zero clears soft caches whenever the heap grows. */
+  usize soft_cache_limit();
+  void set_soft_cache_limit(usize const bytes);
+  /* Clears every soft cache, as though the heap had just grown past the limit. */
+  void clear_soft_caches();
+
+  /* Calls f with the args, unless the cache already has a value for them. Two threads
+   * missing on the same args at once will both call f, and the last one stores its value.
+   * The shard isn't locked while f runs, so f can use the same cache. */
+  object_ref cache_call(object_ref const c, object_ref const f);
+  object_ref cache_call(object_ref const c, object_ref const f, object_ref const a);
+  object_ref
+  cache_call(object_ref const c, object_ref const f, object_ref const a, object_ref const b);
+  object_ref cache_call(object_ref const c,
+                        object_ref const f,
+                        object_ref const a,
+                        object_ref const b,
+                        object_ref const d);
+  /* For more than three args, given as a seq. */
+  object_ref cache_call_rest(object_ref const c, object_ref const f, object_ref const args);
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <mutex>
+
+#include <jank/runtime/object.hpp>
+
+namespace jank::runtime::obj
+{
+  using channel_ref = oref<struct channel>;
+
+  /* A CSP channel, as in core.async. Puts and takes never block here. Each one either
+   * completes right away or leaves a handler on the channel, which is called once a
+   * matching take or put comes along. Blocking and parking are built on top of that, by
+   * handlers which deliver promises.
+   *
+   * Each handler has a flag, which is committed once the handler has been used. The
+   * handlers of an alts! share one flag, so only one of its ops can ever complete. */
+  struct channel
+  {
+    static constexpr object_type obj_type{ object_type::channel };
+    static constexpr bool pointer_free{ false };
+
+    enum class buffer_kind : u8
+    {
+      /* Every put waits for a take. */
+      none,
+      /* Puts wait once the buffer is full. */
+      fixed,
+      /* Puts into a full buffer are dropped. */
+      dropping,
+      /* Puts into a full buffer push out the oldest value. */
+      sliding
+    };
+
+    struct handler_flag
+    {
+      std::mutex mutex;
+      bool active{ true };
+    };
+
+    struct handler
+    {
+      handler_flag *flag{};
+      /* A promise to deliver, or a fn to call, with the result. */
+      object_ref callback;
+      /* For alts!, the port this handler is for. The result is then a [val port] vector. */
+      object_ref port;
+    };
+
+    struct result
+    {
+      /* Whether the op finished right away, in which case the handler won't be called. */
+      bool done{};
+      object_ref val;
+    };
+
+    channel() = default;
+    channel(buffer_kind const kind, usize const capacity);
+
+    /* behavior::object_like */
+    bool equal(object const &) const;
+    jtl::immutable_string to_string() const;
+    void to_string(jtl::string_builder &buff) const;
+    jtl::immutable_string to_code_string() const;
+    void to_code_string(jtl::string_builder &buff) const;
+    uhash to_hash() const;
+
+    /* A put gives true once the value is taken or buffered, or false if the channel is
+     * closed. Putting nil isn't allowed. */
+    result put(object_ref const val, handler * const h);
+    /* A take gives the value, or nil once the channel is closed and drained. */
+    result take(handler * const h);
+    void close();
+
+    /* Makes a handler with a flag of its own. */
+    static handler *make_handler(object_ref const callback);
+    /* Uses up a flag, so none of its handlers will fire. This gives false if one of them
+     * already has, or is about to. Handlers given up on this way are swept out of the
+     * channel later. */
+    static bool commit(handler_flag &flag);
+    static void fire(handler const &h, object_ref const val);
+
+    object base{ obj_type };
+    buffer_kind kind{};
+    usize capacity{};
+    native_deque<object_ref> buffer;
+    native_deque<std::pair<object_ref, handler *>> puts;
+    native_deque<handler *> takes;
+    /* How many handlers have been queued since the last sweep of inactive ones. */
+    usize dirty_puts{};
+    usize dirty_takes{};
+    bool closed{};
+    std::mutex mutex;
+  };
+}
@@ -22,6 +22,7 @@ namespace jank::runtime::obj
     jtl::immutable_string to_string() const;
     void to_string(jtl::string_builder &buff) const;
     jtl::immutable_string to_code_string() const;
+    void to_code_string(jtl::string_builder &buff) const;
     uhash to_hash() const;
 
     object base{ obj_type };
@@ -29,3 +30,32 @@ namespace jank::runtime::obj
     jtl::immutable_string data;
   };
 }
+
+namespace jank::runtime
+{
+  namespace detail
+  {
+    /* Every ASCII character is preallocated, since walking and parsing strings boxes them
+     * one at a time. Just like small integers, equal boxes in this range are identical. */
+    constexpr usize ascii_character_count{ 128 };
+
+    /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+    extern obj::character *ascii_characters;
+  }
+
+  template <typename T>
+  requires(T::obj_type == object_type::character)
+  oref<T> make_box(char const c)
+  {
+    if(auto const i{ static_cast<u8>(c) }; i < detail::ascii_character_count)
+    {
+      return detail::ascii_characters + i;
+    }
+
+    oref<T> ret{ detail::allocate_box<T>(c) };
+#ifdef JANK_PROFILE_GC
+    perf::record_allocation(T::obj_type, sizeof(T));
+#endif
+    return ret;
+  }
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <jank/runtime/object.hpp>
+
+namespace jank::runtime::obj
+{
+  using column_table_ref = oref<struct column_table>;
+  using column_table_sequence_ref = oref<struct column_table_sequence>;
+  using struct_basis_ref = oref<struct struct_basis>;
+  using persistent_struct_map_ref = oref<struct persistent_struct_map>;
+
+  /* A table of rows which all have the same keys, stored by column rather than by row.
+   * A column of integers is a long array and a column of reals is a double array, so
+   * scanning one works through contiguous unboxed memory. Any other column is a vector.
+   * Rows are only made when they're asked for, as struct maps over the table's keys.
+   *
+   * Tables are immutable and sequential, so they're equal to any sequential coll of equal
+   * maps. Working on a column gives a new table. */
+  struct column_table
+  {
+    static constexpr object_type obj_type{ object_type::column_table };
+    static constexpr bool pointer_free{ false };
+    static constexpr bool is_sequential{ true };
+
+    column_table() = delete;
+    column_table(column_table &&) noexcept = default;
+    column_table(column_table const &) = default;
+    column_table(struct_basis_ref const basis,
+                 native_vector<object_ref> &&columns,
+                 usize const length);
+
+    /* Builds a table with these keys from a seq of maps. A key which a row doesn't have
+     * is nil, for that row, and any other keys in the row are dropped. */
+    static column_table_ref create(object_ref const keys, object_ref const rows);
+
+    /* behavior::object_like */
+    bool equal(object const &) const;
+    jtl::immutable_string to_string() const;
+    void to_string(jtl::string_builder &buff) const;
+    jtl::immutable_string to_code_string() const;
+    void to_code_string(jtl::string_builder &buff) const;
+    uhash to_hash() const;
+
+    /* behavior::seqable */
+    column_table_sequence_ref seq() const;
+    column_table_sequence_ref fresh_seq() const;
+
+    /* behavior::countable */
+    usize count() const;
+
+    /* behavior::indexable */
+    object_ref nth(object_ref const index) const;
+    object_ref nth(object_ref const index, object_ref const fallback) const;
+
+    /* behavior::reducible */
+    object_ref reduce(object_ref const f, object_ref const init) const;
+
+    persistent_struct_map_ref row(usize const index) const;
+    /* The storage for a column, which is either an array or a vector. */
+    object_ref column(object_ref const key) const;
+    /* These work on the values of a single column, without making any rows. */
+    object_ref reduce_column(object_ref const key, object_ref const f, object_ref const init) const;
+    column_table_ref map_column(object_ref const key, object_ref const f) const;
+    /* Keeps the rows for which the pred is truthy, given the row's value in that column. */
+    column_table_ref filter_column(object_ref const key, object_ref const pred) const;
+
+    object base{ obj_type };
+    struct_basis_ref basis;
+    /* One for each basis key, in the same order. */
+    native_vector<object_ref> columns;
+    usize length{};
+    mutable uhash hash{};
+  };
+}
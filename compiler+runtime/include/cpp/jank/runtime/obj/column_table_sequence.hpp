@@ -0,0 +1,50 @@
+#pragma once
+
+#include <jank/runtime/object.hpp>
+
+namespace jank::runtime::obj
+{
+  using column_table_ref = oref<struct column_table>;
+  using column_table_sequence_ref = oref<struct column_table_sequence>;
+  using cons_ref = oref<struct cons>;
+
+  /* Walks the rows of a column table, making each one as it's reached. */
+  struct column_table_sequence
+  {
+    static constexpr object_type obj_type{ object_type::column_table_sequence };
+    static constexpr bool pointer_free{ false };
+    static constexpr bool is_sequential{ true };
+
+    column_table_sequence() = delete;
+    column_table_sequence(column_table_sequence &&) noexcept = default;
+    column_table_sequence(column_table_sequence const &) = default;
+    column_table_sequence(column_table_ref const table, usize const index);
+
+    /* behavior::object_like */
+    bool equal(object const &) const;
+    jtl::immutable_string to_string() const;
+    void to_string(jtl::string_builder &buff) const;
+    jtl::immutable_string to_code_string() const;
+    void to_code_string(jtl::string_builder &buff) const;
+    uhash to_hash() const;
+
+    /* behavior::seqable */
+    column_table_sequence_ref seq();
+    column_table_sequence_ref fresh_seq() const;
+
+    /* behavior::countable */
+    usize count() const;
+
+    /* behavior::sequence */
+    object_ref first() const;
+    column_table_sequence_ref next() const;
+    cons_ref conj(object_ref const head);
+
+    /* behavior::sequenceable_in_place */
+    column_table_sequence_ref next_in_place();
+
+    object base{ obj_type };
+    column_table_ref table;
+    usize index{};
+  };
+}
@@ -12,6 +12,7 @@ namespace jank::runtime::obj
   {
     static constexpr object_type obj_type{ object_type::cons };
     static constexpr bool pointer_free{ false };
+    static constexpr bool pooled{ true };
     static constexpr bool is_sequential{ true };
 
     cons() = default;
@@ -24,6 +25,7 @@ namespace jank::runtime::obj
     jtl::immutable_string to_string() const;
     void to_string(jtl::string_builder &buff) const;
     jtl::immutable_string to_code_string() const;
+    void to_code_string(jtl::string_builder &buff) const;
     uhash to_hash() const;
 
     /* behavior::metadatable */
@@ -44,6 +46,9 @@ namespace jank::runtime::obj
     object_ref head{};
     object_ref tail{};
     mutable uhash hash{};
+    /* Once something has counted this whole seq, the count is kept, so counting it again
+     * is constant time. Zero if it's not known yet. */
+    mutable usize cached_count{};
     jtl::option<object_ref> meta;
   };
 }
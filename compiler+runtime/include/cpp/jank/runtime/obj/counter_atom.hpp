@@ -0,0 +1,50 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+
+#include <jank/runtime/object.hpp>
+
+namespace jank::runtime::obj
+{
+  using counter_atom_ref = oref<struct counter_atom>;
+
+  /* A counter for commutative adds from many threads, like Java's LongAdder. Each thread
+   * adds into one of a set of stripes, so concurrent adds rarely touch the same cache line,
+   * where an atom would have every thread fighting over one. Derefing sums the stripes,
+   * which makes reads slower and only a snapshot while adds are still going on. */
+  struct counter_atom
+  {
+    static constexpr object_type obj_type{ object_type::counter_atom };
+    static constexpr bool pointer_free{ true };
+    static constexpr usize stripe_count{ 16 };
+
+    /* Padded out to a cache line. Objects are only 16 byte aligned, but the counts are
+     * still 64 bytes apart, so no two share a line. */
+    struct stripe
+    {
+      std::atomic<i64> count{};
+      char padding[64 - sizeof(std::atomic<i64>)]{};
+    };
+
+    counter_atom() = default;
+    counter_atom(i64 const initial);
+
+    /* behavior::object_like */
+    bool equal(object const &) const;
+    jtl::immutable_string to_string() const;
+    void to_string(jtl::string_builder &buff) const;
+    jtl::immutable_string to_code_string() const;
+    void to_code_string(jtl::string_builder &buff) const;
+    uhash to_hash() const;
+
+    /* behavior::derefable */
+    object_ref deref() const;
+
+    void add(i64 const n);
+    i64 sum() const;
+
+    object base{ obj_type };
+    std::array<stripe, stripe_count> stripes{};
+  };
+}
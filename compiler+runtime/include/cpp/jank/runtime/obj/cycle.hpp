@@ -0,0 +1,65 @@
+#pragma once
+
+#include <jtl/option.hpp>
+
+#include <jank/runtime/object.hpp>
+
+namespace jank::runtime::obj
+{
+  using cons_ref = oref<struct cons>;
+  using cycle_ref = oref<struct cycle>;
+
+  /* An infinite seq which repeats the items of a non-empty seq. Stepping through it with
+   * next makes a node for each step, which is cached, like iterate's, but reducing over it
+   * just walks the underlying seq, over and over, without making any nodes at all. */
+  struct cycle
+  {
+    static constexpr object_type obj_type{ object_type::cycle };
+    static constexpr bool pointer_free{ false };
+    static constexpr bool is_sequential{ true };
+
+    cycle() = default;
+    cycle(cycle &&) noexcept = default;
+    cycle(cycle const &) = default;
+    cycle(object_ref const all);
+    cycle(object_ref const all, object_ref const current);
+
+    /* Gives an empty list for an empty coll. */
+    static object_ref create(object_ref const coll);
+
+    /* behavior::object_like */
+    bool equal(object const &) const;
+    jtl::immutable_string to_string();
+    void to_string(jtl::string_builder &buff);
+    jtl::immutable_string to_code_string();
+    void to_code_string(jtl::string_builder &buff);
+    uhash to_hash() const;
+
+    /* behavior::seqable */
+    cycle_ref seq();
+    cycle_ref fresh_seq() const;
+
+    /* behavior::reducible */
+    object_ref reduce(object_ref const f, object_ref const init) const;
+
+    /* behavior::sequenceable */
+    object_ref first() const;
+    cycle_ref next() const;
+
+    /* behavior::sequenceable_in_place */
+    cycle_ref next_in_place();
+
+    /* behavior::conjable */
+    obj::cons_ref conj(object_ref const head) const;
+
+    /* behavior::metadatable */
+    cycle_ref with_meta(object_ref const m) const;
+
+    object base{ obj_type };
+    /* The seq of the whole coll, which we start over with once current runs out. */
+    object_ref all{};
+    object_ref current{};
+    mutable cycle_ref cached_next{};
+    jtl::option<object_ref> meta{};
+  };
+}
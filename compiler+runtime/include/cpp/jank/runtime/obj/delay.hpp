@@ -1,11 +1,18 @@
 #pragma once
 
+#include <atomic>
+#include <mutex>
+
 #include <jank/runtime/object.hpp>
 
 namespace jank::runtime::obj
 {
   using delay_ref = oref<struct delay>;
 
+  /* A delay runs its fn once, on the first deref, and then always gives the same value, or
+   * throws the same error. Once it's realized, a deref is just an atomic load, so delays
+   * can guard hot, lazily initialized values without every reader taking the mutex. The
+   * mutex is only for the first realization. */
   struct delay
   {
     static constexpr object_type obj_type{ object_type::delay };
@@ -19,15 +26,21 @@ namespace jank::runtime::obj
     jtl::immutable_string to_string() const;
     void to_string(jtl::string_builder &buff) const;
     jtl::immutable_string to_code_string() const;
+    void to_code_string(jtl::string_builder &buff) const;
     uhash to_hash() const;
 
     /* behavior::derefable */
     object_ref deref();
 
+    /* behavior::pending */
+    bool is_realized() const;
+
     object base{ obj_type };
     object_ref val{};
     object_ref fn{};
     object_ref error{};
-    std::mutex mutex;
+    /* Set once val or error has been, so both can be read without the mutex after that. */
+    std::atomic_bool realized{};
+    mutable std::mutex mutex;
   };
 }
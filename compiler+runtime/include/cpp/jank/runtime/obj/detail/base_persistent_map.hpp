@@ -42,6 +42,7 @@ namespace jank::runtime::obj::detail
 
     jtl::immutable_string to_string() const;
     jtl::immutable_string to_code_string() const;
+    void to_code_string(jtl::string_builder &buff) const;
     uhash to_hash() const;
 
     /* behavior::seqable */
@@ -51,6 +52,12 @@ namespace jank::runtime::obj::detail
     /* behavior::countable */
     usize count() const;
 
+    /* behavior::reducible */
+    object_ref reduce(object_ref const f, object_ref const init) const;
+
+    /* behavior::kv_reducible */
+    object_ref reduce_kv(object_ref const f, object_ref const init) const;
+
     /* behavior::metadatable */
     oref<PT> with_meta(object_ref const m) const;
 
@@ -5,6 +5,7 @@
 namespace jank::runtime::obj
 {
   using cons_ref = oref<struct cons>;
+  using array_chunk_ref = oref<struct array_chunk>;
 }
 
 namespace jank::runtime::obj::detail
@@ -12,6 +13,8 @@ namespace jank::runtime::obj::detail
   template <typename Derived, typename It>
   struct iterator_sequence
   {
+    static constexpr usize chunk_size{ 32 };
+
     /* NOLINTNEXTLINE(bugprone-crtp-constructor-accessibility) */
     iterator_sequence() = default;
 
@@ -23,6 +26,7 @@ namespace jank::runtime::obj::detail
     void to_string(jtl::string_builder &buff) const;
     jtl::immutable_string to_string() const;
     jtl::immutable_string to_code_string() const;
+    void to_code_string(jtl::string_builder &buff) const;
     uhash to_hash() const;
 
     /* behavior::seqable */
@@ -40,6 +44,10 @@ namespace jank::runtime::obj::detail
     /* behavior::sequenceable_in_place */
     oref<Derived> next_in_place();
 
+    /* behavior::chunkable */
+    obj::array_chunk_ref chunked_first() const;
+    oref<Derived> chunked_next() const;
+
     /* behavior::conjable */
     obj::cons_ref conj(object_ref const head);
 
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <jank/runtime/object.hpp>
+
+namespace jank::runtime::obj
+{
+  using eduction_ref = oref<struct eduction>;
+
+  /* A transducer applied to a collection, without the result being held anywhere. Each
+   * reduce runs the whole transduction again, straight over the collection, so a chain of
+   * eductions costs no intermediate seqs or collections. This is Clojure's Eduction.
+   *
+   * Unlike in Clojure, a seq of an eduction isn't lazy. The whole transduction is run into
+   * a vector, which is then seqed. Reduce over an eduction of an infinite collection,
+   * rather than seqing it, unless the transducer cuts the collection short. */
+  struct eduction
+  {
+    static constexpr object_type obj_type{ object_type::eduction };
+    static constexpr bool pointer_free{ false };
+    static constexpr bool is_sequential{ true };
+
+    eduction() = default;
+    eduction(object_ref const xform, object_ref const coll);
+
+    /* behavior::object_like */
+    bool equal(object const &) const;
+    jtl::immutable_string to_string() const;
+    void to_string(jtl::string_builder &buff) const;
+    jtl::immutable_string to_code_string() const;
+    void to_code_string(jtl::string_builder &buff) const;
+    uhash to_hash() const;
+
+    /* behavior::seqable */
+    object_ref seq() const;
+    object_ref fresh_seq() const;
+
+    /* behavior::reducible */
+    object_ref reduce(object_ref const f, object_ref const init) const;
+
+    object base{ obj_type };
+    object_ref xform{};
+    object_ref coll{};
+  };
+}
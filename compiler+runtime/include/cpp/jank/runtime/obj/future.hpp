@@ -0,0 +1,76 @@
+#pragma once
+
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+
+#include <jank/runtime/object.hpp>
+
+namespace jank::runtime
+{
+  struct executor;
+}
+
+namespace jank::runtime::obj
+{
+  using persistent_hash_map_ref = oref<struct persistent_hash_map>;
+  using future_ref = oref<struct future>;
+
+  /* A future runs its fn on an executor, with the thread bindings which were in place
+   * when it was created. Derefing it blocks until the fn has finished, unless a
+   * timeout is given. */
+  struct future
+  {
+    static constexpr object_type obj_type{ object_type::future };
+    static constexpr bool pointer_free{ false };
+
+    enum class state : u8
+    {
+      pending,
+      running,
+      done,
+      failed,
+      cancelled
+    };
+
+    future() = default;
+    future(object_ref const fn, persistent_hash_map_ref const bindings);
+
+    /* Creates a future and submits it to the executor. */
+    static future_ref submit(object_ref const fn, executor &e);
+
+    /* behavior::object_like */
+    bool equal(object const &) const;
+    jtl::immutable_string to_string() const;
+    void to_string(jtl::string_builder &buff) const;
+    jtl::immutable_string to_code_string() const;
+    void to_code_string(jtl::string_builder &buff) const;
+    uhash to_hash() const;
+
+    /* behavior::derefable */
+    object_ref deref();
+    object_ref deref(i64 const timeout_ms, object_ref const timeout_val);
+
+    /* behavior::pending */
+    bool is_realized() const;
+
+    bool is_done() const;
+    bool is_cancelled() const;
+    /* Only a future which hasn't yet started running can be cancelled. */
+    bool cancel();
+
+    /* Called by the executor. */
+    void run();
+
+    object base{ obj_type };
+    object_ref fn{};
+    persistent_hash_map_ref bindings{};
+    object_ref val{};
+    std::exception_ptr error{};
+    state current_state{ state::pending };
+    /* The executor we were submitted to, so a worker waiting on us can help it out. */
+    executor *owner{};
+    mutable std::mutex mutex;
+    std::condition_variable done_cv;
+  };
+}
@@ -48,12 +48,16 @@ namespace jank::runtime::obj
     jtl::immutable_string to_string() const;
     void to_string(jtl::string_builder &buff) const;
     jtl::immutable_string to_code_string() const;
+    void to_code_string(jtl::string_builder &buff) const;
     uhash to_hash() const;
 
     /* behavior::seqable */
     integer_range_ref seq() const;
     integer_range_ref fresh_seq() const;
 
+    /* behavior::reducible */
+    object_ref reduce(object_ref const f, object_ref const init) const;
+
     /* behavior::sequenceable */
     integer_ref first() const;
     integer_range_ref next() const;
@@ -25,12 +25,16 @@ namespace jank::runtime::obj
     jtl::immutable_string to_string();
     void to_string(jtl::string_builder &buff);
     jtl::immutable_string to_code_string();
+    void to_code_string(jtl::string_builder &buff);
     uhash to_hash() const;
 
     /* behavior::seqable */
     iterator_ref seq();
     iterator_ref fresh_seq() const;
 
+    /* behavior::reducible */
+    object_ref reduce(object_ref const f, object_ref const init) const;
+
     /* behavior::sequenceable */
     object_ref first() const;
     iterator_ref next() const;
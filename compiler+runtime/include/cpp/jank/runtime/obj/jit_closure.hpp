@@ -3,6 +3,11 @@
 #include <jank/runtime/object.hpp>
 #include <jank/runtime/behavior/callable.hpp>
 
+namespace jank::jit
+{
+  struct code_owner;
+}
+
 namespace jank::runtime::obj
 {
   using jit_closure_ref = oref<struct jit_closure>;
@@ -23,6 +28,7 @@ namespace jank::runtime::obj
     jtl::immutable_string to_string();
     void to_string(jtl::string_builder &buff);
     jtl::immutable_string to_code_string();
+    void to_code_string(jtl::string_builder &buff);
     uhash to_hash() const;
 
     /* behavior::metadatable */
@@ -137,5 +143,7 @@ namespace jank::runtime::obj
                         object *){};
     jtl::option<object_ref> meta;
     arity_flag_t arity_flags{};
+    /* With --reclaim-jit-code, this keeps the module with our code loaded. */
+    jit::code_owner *code_owner{};
   };
 }
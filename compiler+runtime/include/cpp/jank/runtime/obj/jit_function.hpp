@@ -1,8 +1,20 @@
 #pragma once
 
+#include <array>
+
 #include <jank/runtime/object.hpp>
 #include <jank/runtime/behavior/callable.hpp>
 
+namespace jank::runtime::fn_stats
+{
+  struct block;
+}
+
+namespace jank::jit
+{
+  struct code_owner;
+}
+
 namespace jank::runtime::obj
 {
   using jit_function_ref = oref<struct jit_function>;
@@ -17,17 +29,24 @@ namespace jank::runtime::obj
     jit_function(jit_function const &) = default;
     jit_function(arity_flag_t arity_flags);
     jit_function(object_ref const meta);
+    /* Generated fns pass their arity flags up, rather than each overriding get_arity_flags. */
+    jit_function(object_ref const meta, arity_flag_t const arity_flags);
 
     /* behavior::object_like */
     bool equal(object const &) const;
     jtl::immutable_string to_string();
     void to_string(jtl::string_builder &buff);
     jtl::immutable_string to_code_string();
+    void to_code_string(jtl::string_builder &buff);
     uhash to_hash() const;
 
     /* behavior::metadatable */
     jit_function_ref with_meta(object_ref const m);
 
+    /* Used by with_meta for shared fns. Generated fn types which can be shared give back a
+     * copy of themselves, rather than of the base. */
+    virtual jit_function_ref clone() const;
+
     /* behavior::callable */
     object_ref call() override;
     object_ref call(object_ref const) override;
@@ -84,6 +103,9 @@ namespace jank::runtime::obj
     arity_flag_t get_arity_flags() const override;
     object_ref this_object_ref() override;
 
+    /* The stats block for this fn's name, for --fn-stats. */
+    fn_stats::block &get_stats();
+
     object base{ obj_type };
     object *(*arity_0)(object *){};
     object *(*arity_1)(object *, object *){};
@@ -126,5 +148,42 @@ namespace jank::runtime::obj
                         object *){};
     jtl::option<object_ref> meta;
     arity_flag_t arity_flags{};
+    /* Calls to each arity, for tiered compilation. */
+    std::array<u32, 11> call_counts{};
+    /* Found on the first call, with --fn-stats. */
+    fn_stats::block *stats{};
+    /* With --reclaim-jit-code, this keeps the module with our code loaded. */
+    jit::code_owner *code_owner{};
+    /* Fns which don't close over anything are lifted, so one object is shared by every
+     * evaluation of their fn form. Giving one new meta then needs a copy. */
+    bool is_shared{};
+
+  private:
+    /* Counts a call to the arity and loads it. With tiered compilation, the compile thread
+     * may swap an arity for an optimized one at any time. */
+    template <typename F>
+    F load_arity(F &arity, usize const index);
   };
+
+  /* The C++ codegen emits a struct for each fn. For fns which don't close over anything,
+   * this is the one instance every use of the fn form gives back. */
+  template <typename T>
+  struct lifted_function : T
+  {
+    jit_function_ref clone() const final
+    {
+      return make_box<lifted_function<T>>(*this);
+    }
+  };
+
+  template <typename T>
+  object_ref lifted_function_instance()
+  {
+    static object_ref const ret{ [] {
+      auto const fn(make_box<lifted_function<T>>());
+      fn->is_shared = true;
+      return fn;
+    }() };
+    return ret;
+  }
 }
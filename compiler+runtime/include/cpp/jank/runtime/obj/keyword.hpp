@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+
 #include <jank/runtime/object.hpp>
 #include <jank/runtime/obj/symbol.hpp>
 #include <jank/runtime/detail/type.hpp>
@@ -27,6 +29,7 @@ namespace jank::runtime::obj
     jtl::immutable_string to_string() const;
     void to_string(jtl::string_builder &buff) const;
     jtl::immutable_string to_code_string() const;
+    void to_code_string(jtl::string_builder &buff) const;
     uhash to_hash() const;
 
     /* behavior::comparable */
@@ -46,10 +49,38 @@ namespace jank::runtime::obj
     bool operator==(keyword const &rhs) const;
 
     object base{ obj_type };
+    /* Computed once, when the keyword is interned, since keywords are the most common map
+     * keys. This fits in the padding after base. */
+    uhash hash{};
     symbol_ref sym;
   };
 
+  static_assert(sizeof(keyword) == 2 * sizeof(symbol_ref));
+
   using keyword_ref = oref<keyword>;
+
+  /* The inline cache for a single call site which looks up a keyword literal, such as
+   * (:k m) or (m :k). It remembers where the key was in the last array map and struct map
+   * seen at the site, so lookups in maps of the same shape skip the key scan. Each guess is
+   * checked against the key at that spot before it's used, so a stale guess, or one from
+   * another thread, only ever costs us the scan. The site holds no objects, so codegen can
+   * keep it in memory which the GC doesn't scan. */
+  struct keyword_call_site
+  {
+    /* (:k m) and (:k m fallback) */
+    object_ref get(object_ref const kw, object_ref const m);
+    object_ref get(object_ref const kw, object_ref const m, object_ref const fallback);
+    /* (m :k) and (m :k fallback), where m may not be a map at all. */
+    object_ref call(object_ref const m, object_ref const kw);
+    object_ref call(object_ref const m, object_ref const kw, object_ref const fallback);
+
+    /* This is none when m isn't a map we cache for. */
+    jtl::option<object_ref>
+    find(object_ref const kw, object_ref const m, object_ref const fallback);
+
+    std::atomic<u32> array_index{};
+    std::atomic<u32> struct_slot{};
+  };
 }
 
 /* TODO: Move to .cpp */
@@ -60,7 +91,7 @@ namespace std
   {
     size_t operator()(jank::runtime::obj::keyword_ref const o) const
     {
-      return o->to_hash();
+      return o->hash;
     }
   };
 
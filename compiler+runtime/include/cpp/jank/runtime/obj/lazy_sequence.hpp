@@ -1,5 +1,8 @@
 #pragma once
 
+#include <atomic>
+#include <thread>
+
 #include <jtl/option.hpp>
 
 #include <jank/runtime/object.hpp>
@@ -10,16 +13,20 @@ namespace jank::runtime::obj
   using cons_ref = oref<struct cons>;
   using lazy_sequence_ref = oref<struct lazy_sequence>;
 
-  /* TODO: IPending analog, to implement `realized?`. */
+  /* A lazy seq calls its fn once, the first time it's needed, and then holds the seq of
+   * whatever the fn gave. Realization is guarded by a small lock within the seq, so
+   * racing threads still only call the fn once. After that, the realized flag means
+   * every access is just an atomic load. */
   struct lazy_sequence
   {
     static constexpr object_type obj_type{ object_type::lazy_sequence };
     static constexpr bool pointer_free{ false };
+    static constexpr bool pooled{ true };
     static constexpr bool is_sequential{ true };
 
     lazy_sequence() = default;
-    lazy_sequence(lazy_sequence &&) noexcept = default;
-    lazy_sequence(lazy_sequence const &) = default;
+    lazy_sequence(lazy_sequence &&) noexcept;
+    lazy_sequence(lazy_sequence const &);
     lazy_sequence(object_ref const fn);
     lazy_sequence(object_ref const fn, object_ref const sequence);
 
@@ -28,6 +35,7 @@ namespace jank::runtime::obj
     jtl::immutable_string to_string() const;
     void to_string(jtl::string_builder &buff) const;
     jtl::immutable_string to_code_string() const;
+    void to_code_string(jtl::string_builder &buff) const;
     uhash to_hash() const;
 
     /* behavior::seqable */
@@ -45,22 +53,31 @@ namespace jank::runtime::obj
     /* behavior::metadatable */
     lazy_sequence_ref with_meta(object_ref const m) const;
 
-  private:
-    object_ref resolve_fn() const;
-    object_ref resolve_seq() const;
+    /* behavior::pending */
+    bool is_realized() const;
 
+  private:
     void realize() const;
     void force() const;
-    void lock_and_force() const;
     object_ref sval() const;
     object_ref unwrap(object_ref ls) const;
 
   public:
-    /* TODO: Synchronize. */
     object base{ obj_type };
+    /* These are only touched while holding the lock, until realized is set. From then on,
+     * fn and sv are nil and s never changes. */
     mutable object_ref fn{};
     mutable object_ref sv{};
     mutable object_ref s{};
     jtl::option<object_ref> meta;
+    mutable std::atomic_bool realized{};
+    /* Threads which lose the race to realize wait on this, rather than spin. */
+    mutable std::atomic_flag busy{};
+    /* The thread holding busy, so it can reenter. */
+    mutable std::atomic<std::thread::id> owner{};
+    /* Once something has counted this whole seq, the count is kept, so counting it again
+     * is constant time. Zero if it's not known yet, which is also the case for empty seqs,
+     * but those are cheap to count anyway. */
+    mutable std::atomic<usize> cached_count{};
   };
 }
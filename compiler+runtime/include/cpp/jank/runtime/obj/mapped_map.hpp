@@ -0,0 +1,51 @@
+#pragma once
+
+#include <jank/runtime/object.hpp>
+#include <jank/runtime/detail/native_mapped_map.hpp>
+#include <jank/runtime/obj/mapped_map_sequence.hpp>
+#include <jank/runtime/obj/detail/base_persistent_map.hpp>
+
+namespace jank::runtime::obj
+{
+  using mapped_map_ref = oref<struct mapped_map>;
+  using persistent_hash_map_ref = oref<struct persistent_hash_map>;
+
+  /* A map within a data image. Lookups are a binary search over the entries' key hashes,
+   * in the mapping, and only the value found is boxed. It's read only, so assoc and dissoc
+   * copy the entries into a persistent_hash_map first. It's equal to, and hashes the same
+   * as, any other map with the same entries. */
+  struct mapped_map
+    : obj::detail::base_persistent_map<mapped_map,
+                                       mapped_map_sequence,
+                                       runtime::detail::native_mapped_map>
+  {
+    static constexpr object_type obj_type{ object_type::mapped_map };
+    using parent_type = obj::detail::base_persistent_map<mapped_map,
+                                                         mapped_map_sequence,
+                                                         runtime::detail::native_mapped_map>;
+
+    mapped_map(mapped_map &&) noexcept = default;
+    mapped_map(mapped_map const &) = default;
+    mapped_map(value_type const &d);
+    mapped_map(jtl::option<object_ref> const &meta, value_type const &d);
+
+    /* A copy of the entries, which can be changed. */
+    persistent_hash_map_ref to_persistent() const;
+
+    /* behavior::associatively_readable */
+    object_ref get(object_ref const key) const;
+    object_ref get(object_ref const key, object_ref const fallback) const;
+    object_ref get_entry(object_ref const key) const;
+    bool contains(object_ref const key) const;
+
+    /* behavior::associatively_writable */
+    object_ref assoc(object_ref const key, object_ref const val) const;
+    object_ref dissoc(object_ref const key) const;
+
+    /* behavior::callable */
+    object_ref call(object_ref const) const;
+    object_ref call(object_ref const, object_ref const) const;
+
+    value_type data;
+  };
+}
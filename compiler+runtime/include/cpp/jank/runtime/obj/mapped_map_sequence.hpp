@@ -0,0 +1,18 @@
+#pragma once
+
+#include <jank/runtime/obj/detail/base_persistent_map_sequence.hpp>
+#include <jank/runtime/detail/native_mapped_map.hpp>
+
+namespace jank::runtime::obj
+{
+  using mapped_map_sequence_ref = oref<struct mapped_map_sequence>;
+
+  struct mapped_map_sequence
+    : detail::base_persistent_map_sequence<mapped_map_sequence,
+                                           runtime::detail::native_mapped_map::const_iterator>
+  {
+    static constexpr object_type obj_type{ object_type::mapped_map_sequence };
+
+    using base_persistent_map_sequence::base_persistent_map_sequence;
+  };
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <jank/runtime/object.hpp>
+
+namespace jank::runtime
+{
+  struct data_image;
+}
+
+namespace jank::runtime::obj
+{
+  using mapped_vector_ref = oref<struct mapped_vector>;
+  using mapped_vector_sequence_ref = oref<struct mapped_vector_sequence>;
+  using persistent_vector_ref = oref<struct persistent_vector>;
+
+  /* A vector within a data image. Its items are offsets into the mapping, so nth is a
+   * single read and only the item found is boxed. It's read only, so anything which
+   * changes it copies the items into a persistent_vector first. It's equal to, and hashes
+   * the same as, any other vector with equal items. */
+  struct mapped_vector
+  {
+    static constexpr object_type obj_type{ object_type::mapped_vector };
+    static constexpr bool pointer_free{ false };
+    static constexpr bool is_sequential{ true };
+
+    /* Gives each item boxed, so the generic range helpers can work through the items
+     * without a seq. */
+    struct boxed_iterator
+    {
+      using iterator_category = std::input_iterator_tag;
+      using difference_type = std::ptrdiff_t;
+      using value_type = object_ref;
+      using pointer = object_ref;
+      using reference = value_type;
+
+      object_ref operator*() const;
+      boxed_iterator &operator++();
+      bool operator==(boxed_iterator const &rhs) const;
+      bool operator!=(boxed_iterator const &rhs) const;
+
+      mapped_vector const *vec{};
+      usize index{};
+    };
+
+    mapped_vector() = delete;
+    mapped_vector(mapped_vector &&) noexcept = default;
+    mapped_vector(mapped_vector const &) = default;
+    mapped_vector(data_image const * const image, u64 const offset);
+
+    /* A copy of the items, which can be changed. */
+    persistent_vector_ref to_persistent() const;
+
+    /* Boxes the item at the index, which must be in bounds. */
+    object_ref at(usize const index) const;
+    boxed_iterator begin() const;
+    boxed_iterator end() const;
+
+    /* behavior::object_like */
+    bool equal(object const &) const;
+    jtl::immutable_string to_string() const;
+    void to_string(jtl::string_builder &buff) const;
+    jtl::immutable_string to_code_string() const;
+    void to_code_string(jtl::string_builder &buff) const;
+    uhash to_hash() const;
+
+    /* behavior::metadatable */
+    mapped_vector_ref with_meta(object_ref const m) const;
+
+    /* behavior::seqable */
+    mapped_vector_sequence_ref seq() const;
+    mapped_vector_sequence_ref fresh_seq() const;
+
+    /* behavior::reducible */
+    object_ref reduce(object_ref const f, object_ref const init) const;
+
+    /* behavior::kv_reducible */
+    object_ref reduce_kv(object_ref const f, object_ref const init) const;
+
+    /* behavior::countable */
+    usize count() const;
+
+    /* behavior::associatively_readable */
+    object_ref get(object_ref const key) const;
+    object_ref get(object_ref const key, object_ref const fallback) const;
+    object_ref get_entry(object_ref const key) const;
+    bool contains(object_ref const key) const;
+
+    /* behavior::associatively_writable */
+    persistent_vector_ref assoc(object_ref const key, object_ref const val) const;
+    persistent_vector_ref dissoc(object_ref const key) const;
+
+    /* behavior::conjable */
+    persistent_vector_ref conj(object_ref const head) const;
+
+    /* behavior::stackable */
+    object_ref peek() const;
+    persistent_vector_ref pop() const;
+
+    /* behavior::indexable */
+    object_ref nth(object_ref const index) const;
+    object_ref nth(object_ref const index, object_ref const fallback) const;
+
+    /* behavior::callable */
+    object_ref call(object_ref const) const;
+
+    object base{ obj_type };
+    data_image const *image{};
+    /* The offset of the vector's node. */
+    u64 offset{};
+    usize length{};
+    jtl::option<object_ref> meta;
+    mutable uhash hash{};
+  };
+}
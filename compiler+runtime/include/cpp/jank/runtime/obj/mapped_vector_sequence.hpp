@@ -0,0 +1,50 @@
+#pragma once
+
+#include <jank/runtime/object.hpp>
+
+namespace jank::runtime::obj
+{
+  using cons_ref = oref<struct cons>;
+  using mapped_vector_ref = oref<struct mapped_vector>;
+  using mapped_vector_sequence_ref = oref<struct mapped_vector_sequence>;
+
+  struct mapped_vector_sequence
+  {
+    static constexpr object_type obj_type{ object_type::mapped_vector_sequence };
+    static constexpr bool pointer_free{ false };
+    static constexpr bool pooled{ true };
+    static constexpr bool is_sequential{ true };
+
+    mapped_vector_sequence() = default;
+    mapped_vector_sequence(mapped_vector_sequence &&) noexcept = default;
+    mapped_vector_sequence(mapped_vector_sequence const &) = default;
+    mapped_vector_sequence(mapped_vector_ref const v, usize const i);
+
+    /* behavior::object_like */
+    bool equal(object const &) const;
+    void to_string(jtl::string_builder &buff) const;
+    jtl::immutable_string to_string() const;
+    jtl::immutable_string to_code_string() const;
+    void to_code_string(jtl::string_builder &buff) const;
+    uhash to_hash() const;
+
+    /* behavior::countable */
+    usize count() const;
+
+    /* behavior::seqable */
+    mapped_vector_sequence_ref seq();
+    mapped_vector_sequence_ref fresh_seq() const;
+
+    /* behavior::sequenceable */
+    object_ref first() const;
+    mapped_vector_sequence_ref next() const;
+    obj::cons_ref conj(object_ref const head);
+
+    /* behavior::sequenceable_in_place */
+    mapped_vector_sequence_ref next_in_place();
+
+    object base{ obj_type };
+    mapped_vector_ref vec{};
+    usize index{};
+  };
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <mutex>
 
 #include <jank/runtime/object.hpp>
@@ -27,6 +28,7 @@ namespace jank::runtime::obj
     jtl::immutable_string to_string();
     void to_string(jtl::string_builder &buff);
     jtl::immutable_string to_code_string();
+    void to_code_string(jtl::string_builder &buff);
     uhash to_hash() const;
 
     /* behavior::callable */
@@ -96,15 +98,26 @@ namespace jank::runtime::obj
     object_ref get_fn(object_ref const dispatch_val);
     object_ref get_method(object_ref const dispatch_val);
     object_ref find_and_cache_best_method(object_ref const dispatch_val);
+    /* Must be called with the data lock held. */
+    void publish_cache(object_ref const hierarchy, persistent_hash_map_ref const methods);
+
+    /* The methods which have been resolved for each dispatch value so far, along with the
+     * hierarchy they were resolved against. A snapshot is never changed once it's published,
+     * so dispatching reads it without any lock. Only cache misses and changes to the methods,
+     * the prefers, or the hierarchy take the lock, and each of them publishes a new one. */
+    struct dispatch_cache
+    {
+      object_ref hierarchy;
+      persistent_hash_map_ref methods;
+    };
 
     object base{ obj_type };
     object_ref dispatch{};
     object_ref default_dispatch_value{};
     object_ref hierarchy{};
-    mutable object_ref cached_hierarchy{};
     persistent_hash_map_ref method_table{};
-    mutable persistent_hash_map_ref method_cache{};
     persistent_hash_map_ref prefer_table{};
+    std::atomic<dispatch_cache const *> cache{};
     symbol_ref name{};
     std::recursive_mutex data_lock;
   };
@@ -11,6 +11,7 @@ namespace jank::runtime::obj
   {
     static constexpr object_type obj_type{ object_type::native_array_sequence };
     static constexpr bool pointer_free{ false };
+    static constexpr bool pooled{ true };
     static constexpr bool is_sequential{ true };
 
     native_array_sequence() = delete;
@@ -31,6 +32,7 @@ namespace jank::runtime::obj
     void to_string(jtl::string_builder &buff) const;
     jtl::immutable_string to_string() const;
     jtl::immutable_string to_code_string() const;
+    void to_code_string(jtl::string_builder &buff) const;
     uhash to_hash() const;
 
     /* behavior::seqable */
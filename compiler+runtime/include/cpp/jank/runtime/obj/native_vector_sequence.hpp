@@ -7,13 +7,16 @@
 namespace jank::runtime::obj
 {
   using cons_ref = oref<struct cons>;
+  using array_chunk_ref = oref<struct array_chunk>;
   using native_vector_sequence_ref = oref<struct native_vector_sequence>;
 
   struct native_vector_sequence
   {
     static constexpr object_type obj_type{ object_type::native_vector_sequence };
     static constexpr bool pointer_free{ false };
+    static constexpr bool pooled{ true };
     static constexpr bool is_sequential{ true };
+    static constexpr usize chunk_size{ 32 };
 
     native_vector_sequence() = default;
     native_vector_sequence(native_vector_sequence &&) noexcept = default;
@@ -28,6 +31,7 @@ namespace jank::runtime::obj
     void to_string(jtl::string_builder &buff) const;
     jtl::immutable_string to_string() const;
     jtl::immutable_string to_code_string() const;
+    void to_code_string(jtl::string_builder &buff) const;
     uhash to_hash();
 
     /* behavior::seqable */
@@ -45,6 +49,10 @@ namespace jank::runtime::obj
     /* behavior::sequenceable_in_place */
     native_vector_sequence_ref next_in_place();
 
+    /* behavior::chunkable */
+    obj::array_chunk_ref chunked_first() const;
+    native_vector_sequence_ref chunked_next() const;
+
     /* behavior::metadatable */
     native_vector_sequence_ref with_meta(object_ref const m) const;
 
@@ -46,6 +46,7 @@ namespace jank::runtime::obj
     jtl::immutable_string to_string() const;
     void to_string(jtl::string_builder &buff) const;
     jtl::immutable_string to_code_string() const;
+    void to_code_string(jtl::string_builder &buff) const;
     uhash to_hash() const;
 
     /* behavior::metadatable */
@@ -73,5 +74,6 @@ namespace jank::runtime::obj
     object base{ obj_type };
     value_type data;
     jtl::option<object_ref> meta;
+    mutable uhash hash{};
   };
 }
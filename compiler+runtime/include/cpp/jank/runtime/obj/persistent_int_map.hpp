@@ -0,0 +1,68 @@
+#pragma once
+
+#include <jank/runtime/object.hpp>
+#include <jank/runtime/obj/persistent_int_map_sequence.hpp>
+#include <jank/runtime/obj/detail/base_persistent_map.hpp>
+#include <jank/runtime/detail/native_persistent_int_map.hpp>
+
+namespace jank::runtime::obj
+{
+  using transient_int_map_ref = oref<struct transient_int_map>;
+  using persistent_int_map_ref = oref<struct persistent_int_map>;
+
+  /* A map whose keys are all integers, from int-map. Keys are found by their bits alone,
+   * rather than by hashing and comparing them, and entries are always seq'd in the order
+   * of their keys. Merging two int maps walks both at once, rather than going entry by
+   * entry, and keeps the subtrees which they share.
+   *
+   * It's equal to, and hashes the same as, any other map with equal entries. */
+  struct persistent_int_map
+    : obj::detail::base_persistent_map<persistent_int_map,
+                                       persistent_int_map_sequence,
+                                       runtime::detail::native_persistent_int_map>
+  {
+    static constexpr object_type obj_type{ object_type::persistent_int_map };
+
+    using transient_type = transient_int_map;
+    using parent_type
+      = obj::detail::base_persistent_map<persistent_int_map,
+                                         persistent_int_map_sequence,
+                                         runtime::detail::native_persistent_int_map>;
+
+    persistent_int_map() = default;
+    persistent_int_map(persistent_int_map &&) noexcept = default;
+    persistent_int_map(persistent_int_map const &) = default;
+    persistent_int_map(value_type &&d);
+    persistent_int_map(value_type const &d);
+    persistent_int_map(jtl::option<object_ref> const &meta, value_type &&d);
+
+    static persistent_int_map_ref empty();
+    static persistent_int_map_ref create_from_seq(object_ref const seq);
+
+    /* Throws unless the key is an integer. */
+    static obj::integer_ref expect_key(object_ref const key);
+
+    /* behavior::associatively_readable */
+    object_ref get(object_ref const key) const;
+    object_ref get(object_ref const key, object_ref const fallback) const;
+    object_ref get_entry(object_ref const key) const;
+    bool contains(object_ref const key) const;
+
+    /* behavior::associatively_writable */
+    persistent_int_map_ref assoc(object_ref const key, object_ref const val) const;
+    persistent_int_map_ref dissoc(object_ref const key) const;
+
+    /* behavior::callable */
+    object_ref call(object_ref const) const;
+    object_ref call(object_ref const, object_ref const) const;
+
+    /* behavior::transientable */
+    obj::transient_int_map_ref to_transient() const;
+
+    /* Backs merge and merge-with, when both maps are int maps. */
+    persistent_int_map_ref
+    merge(persistent_int_map_ref const other, jtl::option<object_ref> const &f) const;
+
+    value_type data{};
+  };
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <jank/runtime/obj/detail/base_persistent_map_sequence.hpp>
+#include <jank/runtime/detail/native_persistent_int_map.hpp>
+
+namespace jank::runtime::obj
+{
+  using persistent_int_map_sequence_ref = oref<struct persistent_int_map_sequence>;
+
+  struct persistent_int_map_sequence
+    : detail::base_persistent_map_sequence<
+        persistent_int_map_sequence,
+        runtime::detail::native_persistent_int_map::const_iterator>
+  {
+    static constexpr object_type obj_type{ object_type::persistent_int_map_sequence };
+
+    using base_persistent_map_sequence::base_persistent_map_sequence;
+  };
+}
@@ -54,6 +54,7 @@ namespace jank::runtime::obj
     jtl::immutable_string to_string() const;
     void to_string(jtl::string_builder &buff) const;
     jtl::immutable_string to_code_string() const;
+    void to_code_string(jtl::string_builder &buff) const;
     uhash to_hash() const;
 
     /* behavior::metadatable */
@@ -63,6 +64,9 @@ namespace jank::runtime::obj
     obj::persistent_list_ref seq() const;
     obj::persistent_list_ref fresh_seq() const;
 
+    /* behavior::reducible */
+    object_ref reduce(object_ref const f, object_ref const init) const;
+
     /* behavior::countable */
     usize count() const;
 
@@ -83,5 +87,6 @@ namespace jank::runtime::obj
     object base{ obj_type };
     value_type data;
     jtl::option<object_ref> meta;
+    mutable uhash hash{};
   };
 }
@@ -82,6 +82,12 @@ namespace jank::runtime::obj
     /* behavior::transientable */
     obj::transient_sorted_map_ref to_transient() const;
 
+    /* A seq in either direction. When given a key, it starts from the first entry which
+     * isn't before the key in that direction. */
+    persistent_sorted_map_sequence_ref sorted_seq(bool const ascending) const;
+    persistent_sorted_map_sequence_ref
+    sorted_seq_from(object_ref const key, bool const ascending) const;
+
     value_type data{};
   };
 }
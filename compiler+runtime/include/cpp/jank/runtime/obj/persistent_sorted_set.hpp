@@ -46,6 +46,7 @@ namespace jank::runtime::obj
     jtl::immutable_string to_string() const;
     void to_string(jtl::string_builder &buff) const;
     jtl::immutable_string to_code_string() const;
+    void to_code_string(jtl::string_builder &buff) const;
     uhash to_hash() const;
 
     /* behavior::metadatable */
@@ -70,9 +71,16 @@ namespace jank::runtime::obj
     bool contains(object_ref const o) const;
     persistent_sorted_set_ref disj(object_ref const o) const;
 
+    /* A seq in either direction. When given a key, it starts from the first element which
+     * isn't before the key in that direction. */
+    persistent_sorted_set_sequence_ref sorted_seq(bool const ascending) const;
+    persistent_sorted_set_sequence_ref
+    sorted_seq_from(object_ref const key, bool const ascending) const;
+
     object base{ obj_type };
     value_type data;
     jtl::option<object_ref> meta;
+    mutable uhash hash{};
   };
 }
 
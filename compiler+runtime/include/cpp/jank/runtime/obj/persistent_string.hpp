@@ -31,6 +31,7 @@ namespace jank::runtime::obj
     jtl::immutable_string const &to_string() const;
     void to_string(jtl::string_builder &buff) const;
     jtl::immutable_string to_code_string() const;
+    void to_code_string(jtl::string_builder &buff) const;
     uhash to_hash() const;
 
     /* behavior::comparable */
@@ -64,7 +65,48 @@ namespace jank::runtime::obj
     obj::persistent_string_sequence_ref seq() const;
     obj::persistent_string_sequence_ref fresh_seq() const;
 
+    /* behavior::reducible */
+    object_ref reduce(object_ref const f, object_ref const init) const;
+
     object base{ obj_type };
     jtl::immutable_string data;
   };
 }
+
+namespace jank::runtime
+{
+  namespace detail
+  {
+    /* The empty string and every single byte ASCII string are preallocated, since those are
+     * what splitting and walking strings, or str on characters, tends to make. */
+    constexpr usize single_byte_string_count{ 128 };
+
+    /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+    extern obj::persistent_string *single_byte_strings;
+  }
+
+  template <typename T, typename S>
+  requires(T::obj_type == object_type::persistent_string
+           && std::constructible_from<jtl::immutable_string_view, S const &>)
+  oref<T> make_box(S &&s)
+  {
+    jtl::immutable_string_view const view{ s };
+    if(view.empty())
+    {
+      return T::empty();
+    }
+    if(view.size() == 1)
+    {
+      if(auto const i{ static_cast<u8>(view[0]) }; i < detail::single_byte_string_count)
+      {
+        return detail::single_byte_strings + i;
+      }
+    }
+
+    oref<T> ret{ detail::allocate_box<T>(std::forward<S>(s)) };
+#ifdef JANK_PROFILE_GC
+    perf::record_allocation(T::obj_type, sizeof(T));
+#endif
+    return ret;
+  }
+}
@@ -5,6 +5,7 @@
 namespace jank::runtime::obj
 {
   using cons_ref = oref<struct cons>;
+  using array_chunk_ref = oref<struct array_chunk>;
   using persistent_string_ref = oref<struct persistent_string>;
   using persistent_string_sequence_ref = oref<struct persistent_string_sequence>;
 
@@ -12,7 +13,9 @@ namespace jank::runtime::obj
   {
     static constexpr object_type obj_type{ object_type::persistent_string_sequence };
     static constexpr bool pointer_free{ false };
+    static constexpr bool pooled{ true };
     static constexpr bool is_sequential{ true };
+    static constexpr usize chunk_size{ 32 };
 
     persistent_string_sequence() = default;
     persistent_string_sequence(persistent_string_sequence &&) noexcept = default;
@@ -25,6 +28,7 @@ namespace jank::runtime::obj
     void to_string(jtl::string_builder &buff) const;
     jtl::immutable_string to_string() const;
     jtl::immutable_string to_code_string() const;
+    void to_code_string(jtl::string_builder &buff) const;
     uhash to_hash() const;
 
     /* behavior::countable */
@@ -42,6 +46,10 @@ namespace jank::runtime::obj
     /* behavior::sequenceable_in_place */
     persistent_string_sequence_ref next_in_place();
 
+    /* behavior::chunkable */
+    obj::array_chunk_ref chunked_first() const;
+    persistent_string_sequence_ref chunked_next() const;
+
     object base{ obj_type };
     obj::persistent_string_ref str{};
     usize index{};
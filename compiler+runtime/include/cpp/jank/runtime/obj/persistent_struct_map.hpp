@@ -0,0 +1,60 @@
+#pragma once
+
+#include <jank/runtime/object.hpp>
+#include <jank/runtime/detail/native_struct_map.hpp>
+#include <jank/runtime/obj/persistent_struct_map_sequence.hpp>
+#include <jank/runtime/obj/detail/base_persistent_map.hpp>
+
+namespace jank::runtime::obj
+{
+  using persistent_struct_map_ref = oref<struct persistent_struct_map>;
+
+  /* A map with a fixed set of basis keys, from create-struct, followed by any number of
+   * other keys. The values for the basis keys live in slots, rather than next to their keys,
+   * so each one costs a single pointer and accessors can read them without a lookup. This
+   * is Clojure's PersistentStructMap. */
+  struct persistent_struct_map
+    : obj::detail::base_persistent_map<persistent_struct_map,
+                                       persistent_struct_map_sequence,
+                                       runtime::detail::native_struct_map>
+  {
+    static constexpr object_type obj_type{ object_type::persistent_struct_map };
+    using parent_type = obj::detail::base_persistent_map<persistent_struct_map,
+                                                         persistent_struct_map_sequence,
+                                                         runtime::detail::native_struct_map>;
+
+    persistent_struct_map(persistent_struct_map &&) noexcept = default;
+    persistent_struct_map(persistent_struct_map const &) = default;
+    persistent_struct_map(value_type &&d);
+    persistent_struct_map(value_type const &d);
+    persistent_struct_map(jtl::option<object_ref> const &meta, value_type &&d);
+
+    /* Backs struct-map. The keys and values alternate and needn't be basis keys. */
+    static persistent_struct_map_ref create(object_ref const basis, object_ref const kvs);
+    /* Backs struct. The values are for the basis keys, in order, and any which are left
+     * out are nil. */
+    static persistent_struct_map_ref construct(object_ref const basis, object_ref const vals);
+
+    /* These back accessor. The slot is looked up once, when the accessor is made, and is
+     * then read directly from each struct map it's given. */
+    static object_ref slot_of(object_ref const basis, object_ref const key);
+    static object_ref
+    get_slot(object_ref const m, object_ref const basis, object_ref const slot);
+
+    /* behavior::associatively_readable */
+    object_ref get(object_ref const key) const;
+    object_ref get(object_ref const key, object_ref const fallback) const;
+    object_ref get_entry(object_ref const key) const;
+    bool contains(object_ref const key) const;
+
+    /* behavior::associatively_writable */
+    persistent_struct_map_ref assoc(object_ref const key, object_ref const val) const;
+    persistent_struct_map_ref dissoc(object_ref const key) const;
+
+    /* behavior::callable */
+    object_ref call(object_ref const) const;
+    object_ref call(object_ref const, object_ref const) const;
+
+    value_type data;
+  };
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <span>
+
 #include <jank/runtime/object.hpp>
 #include <jank/runtime/detail/type.hpp>
 
@@ -47,6 +49,7 @@ namespace jank::runtime::obj
     jtl::immutable_string to_string() const;
     void to_string(jtl::string_builder &buff) const;
     jtl::immutable_string to_code_string() const;
+    void to_code_string(jtl::string_builder &buff) const;
     uhash to_hash() const;
 
     /* behavior::comparable */
@@ -62,6 +65,12 @@ namespace jank::runtime::obj
     persistent_vector_sequence_ref seq() const;
     persistent_vector_sequence_ref fresh_seq() const;
 
+    /* behavior::reducible */
+    object_ref reduce(object_ref const f, object_ref const init) const;
+
+    /* behavior::kv_reducible */
+    object_ref reduce_kv(object_ref const f, object_ref const init) const;
+
     /* behavior::countable */
     usize count() const;
 
@@ -92,6 +101,11 @@ namespace jank::runtime::obj
     /* behavior::transientable */
     obj::transient_vector_ref to_transient() const;
 
+    /* The elements, if they're all stored next to each other, as they are for small
+     * vectors. Native code can borrow these without copying, for as long as it holds
+     * onto the vector. */
+    jtl::option<std::span<object_ref const>> contiguous_data() const;
+
     object base{ obj_type };
     value_type data;
     jtl::option<object_ref> meta;
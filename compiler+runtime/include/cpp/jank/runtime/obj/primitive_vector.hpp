@@ -0,0 +1,136 @@
+#pragma once
+
+#include <variant>
+
+#include <immer/vector.hpp>
+
+#include <jank/runtime/object.hpp>
+#include <jank/runtime/obj/array.hpp>
+
+namespace jank::runtime::obj
+{
+  using primitive_vector_ref = oref<struct primitive_vector>;
+  using primitive_vector_sequence_ref = oref<struct primitive_vector_sequence>;
+
+  /* A persistent vector of unboxed primitives, from vector-of. It's the same kind of tree
+   * as a persistent_vector, but each leaf holds the primitives themselves, so a vector of
+   * longs takes a quarter of the memory of one holding boxed integers. Elements are only
+   * boxed as they're read, one at a time, including when it's reduced or seq'd.
+   *
+   * It's equal to, and hashes the same as, any other vector with equal elements. */
+  struct primitive_vector
+  {
+    static constexpr object_type obj_type{ object_type::primitive_vector };
+    static constexpr bool pointer_free{ false };
+    static constexpr bool is_sequential{ true };
+
+    template <typename T>
+    using storage = immer::vector<T, memory_policy>;
+    /* In the same order as array::element_type, skipping object. */
+    using value_type = std::variant<storage<bool>,
+                                    storage<i8>,
+                                    storage<i16>,
+                                    storage<char32_t>,
+                                    storage<i32>,
+                                    storage<i64>,
+                                    storage<f32>,
+                                    storage<f64>>;
+
+    /* Gives each element boxed, so the generic range helpers can work through the
+     * elements without a seq. */
+    struct boxed_iterator
+    {
+      using iterator_category = std::input_iterator_tag;
+      using difference_type = std::ptrdiff_t;
+      using value_type = object_ref;
+      using pointer = object_ref;
+      using reference = value_type;
+
+      object_ref operator*() const;
+      boxed_iterator &operator++();
+      bool operator==(boxed_iterator const &rhs) const;
+      bool operator!=(boxed_iterator const &rhs) const;
+
+      primitive_vector const *vec{};
+      usize index{};
+    };
+
+    primitive_vector() = delete;
+    primitive_vector(primitive_vector &&) noexcept = default;
+    primitive_vector(primitive_vector const &) = default;
+    primitive_vector(value_type &&d);
+    primitive_vector(jtl::option<object_ref> const &meta, value_type &&d);
+
+    static value_type empty_storage(array::element_type const element);
+
+    /* Backs vector-of. The type is a keyword naming the element type, like :long, and the
+     * elements are converted to it just as they are for arrays. Arrays and vectors of
+     * the same element type are copied in bulk. */
+    static primitive_vector_ref create(object_ref const type, object_ref const coll);
+    /* Backs into. Arrays and vectors of the same element type are appended without
+     * boxing anything. */
+    primitive_vector_ref conj_all(object_ref const coll) const;
+    /* Copies the elements into a new array of the given element type. When that's the
+     * vector's own, each leaf is copied in one go, without boxing. */
+    array_ref to_array(array::element_type const element) const;
+
+    array::element_type element() const;
+    /* Boxes the element at the index, which must be in bounds. */
+    object_ref at(usize const index) const;
+    boxed_iterator begin() const;
+    boxed_iterator end() const;
+
+    /* behavior::object_like */
+    bool equal(object const &) const;
+    jtl::immutable_string to_string() const;
+    void to_string(jtl::string_builder &buff) const;
+    jtl::immutable_string to_code_string() const;
+    void to_code_string(jtl::string_builder &buff) const;
+    uhash to_hash() const;
+
+    /* behavior::metadatable */
+    primitive_vector_ref with_meta(object_ref const m) const;
+
+    /* behavior::seqable */
+    primitive_vector_sequence_ref seq() const;
+    primitive_vector_sequence_ref fresh_seq() const;
+
+    /* behavior::reducible */
+    object_ref reduce(object_ref const f, object_ref const init) const;
+
+    /* behavior::kv_reducible */
+    object_ref reduce_kv(object_ref const f, object_ref const init) const;
+
+    /* behavior::countable */
+    usize count() const;
+
+    /* behavior::associatively_readable */
+    object_ref get(object_ref const key) const;
+    object_ref get(object_ref const key, object_ref const fallback) const;
+    object_ref get_entry(object_ref const key) const;
+    bool contains(object_ref const key) const;
+
+    /* behavior::associatively_writable */
+    primitive_vector_ref assoc(object_ref const key, object_ref const val) const;
+    primitive_vector_ref dissoc(object_ref const key) const;
+
+    /* behavior::conjable */
+    primitive_vector_ref conj(object_ref const head) const;
+
+    /* behavior::stackable */
+    object_ref peek() const;
+    primitive_vector_ref pop() const;
+
+    /* behavior::indexable */
+    object_ref nth(object_ref const index) const;
+    object_ref nth(object_ref const index, object_ref const fallback) const;
+
+    /* behavior::callable */
+    object_ref call(object_ref const) const;
+
+    object base{ obj_type };
+    value_type data;
+    jtl::option<object_ref> meta;
+    mutable uhash hash{};
+  };
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+#include <jank/runtime/object.hpp>
+
+namespace jank::runtime::obj
+{
+  using promise_ref = oref<struct promise>;
+
+  /* A promise can be delivered a value once. Derefing it blocks until then, unless a
+   * timeout is given. Rather than blocking, fns can also be registered to be called with
+   * the value once it's delivered, which lets async code chain without a waiting thread. */
+  struct promise
+  {
+    static constexpr object_type obj_type{ object_type::promise };
+    static constexpr bool pointer_free{ false };
+
+    promise() = default;
+
+    /* behavior::object_like */
+    bool equal(object const &) const;
+    jtl::immutable_string to_string() const;
+    void to_string(jtl::string_builder &buff) const;
+    jtl::immutable_string to_code_string() const;
+    void to_code_string(jtl::string_builder &buff) const;
+    uhash to_hash() const;
+
+    /* behavior::derefable */
+    object_ref deref();
+    object_ref deref(i64 const timeout_ms, object_ref const timeout_val);
+
+    /* behavior::pending */
+    bool is_realized() const;
+
+    /* Only the first delivery has any effect. The fns registered with on_deliver are
+     * called on the delivering thread, after any blocked derefs have been released. This
+     * returns whether this delivery was the first. */
+    bool deliver(object_ref const v);
+    /* If the promise has already been delivered, f is called right away, on this thread. */
+    void on_deliver(object_ref const f);
+
+    object base{ obj_type };
+    object_ref val{};
+    /* This is only set once val is, so a delivered promise can be read without locking. */
+    std::atomic_bool delivered{};
+    native_vector<object_ref> callbacks;
+    mutable std::mutex mutex;
+    std::condition_variable delivered_cv;
+  };
+}
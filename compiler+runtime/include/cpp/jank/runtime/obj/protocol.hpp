@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+
+#include <jank/runtime/object.hpp>
+
+namespace jank::runtime::obj
+{
+  using symbol_ref = oref<struct symbol>;
+  using protocol_ref = oref<struct protocol>;
+  using protocol_method_ref = oref<struct protocol_method>;
+
+  /* A named set of methods which dispatch on the type of their first arg. This is Clojure's
+   * protocol, with jank's object types standing in for classes. A protocol can be extended
+   * to nil, to any object type by the name which type returns for it, to :default, which
+   * covers everything else, and to struct maps of a given basis.
+   *
+   * Each method keeps its own table of impls, indexed by object type, so dispatching a
+   * call never locks or hashes. */
+  struct protocol
+  {
+    static constexpr object_type obj_type{ object_type::protocol };
+    static constexpr bool pointer_free{ false };
+
+    protocol() = delete;
+    protocol(object_ref const name);
+
+    /* Backs defprotocol. The method names are symbols and each one gets a method. */
+    static protocol_ref create(object_ref const name, object_ref const method_names);
+
+    /* behavior::object_like */
+    bool equal(object const &) const;
+    jtl::immutable_string to_string() const;
+    void to_string(jtl::string_builder &buff) const;
+    jtl::immutable_string to_code_string() const;
+    void to_code_string(jtl::string_builder &buff) const;
+    uhash to_hash() const;
+
+    /* Backs extend. The impls map method name keywords to fns. Any methods which aren't in
+     * the map are left as they were. */
+    protocol_ref extend(object_ref const type, object_ref const impls);
+    bool extends(object_ref const type) const;
+    bool satisfies(object_ref const o) const;
+
+    /* Returns nil if the protocol has no method with this name. */
+    protocol_method_ref find_method(object_ref const name) const;
+
+    object base{ obj_type };
+    symbol_ref name;
+    native_vector<protocol_method_ref> methods;
+    /* Satisfying a protocol only needs it to be extended to the type, not for every method
+     * to have an impl. So we track that separately. */
+    std::atomic_bool extended_types[object_type_count]{};
+    std::atomic_bool extended_default{};
+    /* A persistent_hash_set of struct bases, or null while there are none. */
+    std::atomic<object *> extended_bases{};
+    std::mutex extend_lock;
+  };
+}
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+
+#include <jank/runtime/object.hpp>
+#include <jank/runtime/behavior/callable.hpp>
+
+namespace jank::runtime::obj
+{
+  using symbol_ref = oref<struct symbol>;
+  using protocol_ref = oref<struct protocol>;
+  using protocol_method_ref = oref<struct protocol_method>;
+  using struct_basis_ref = oref<struct struct_basis>;
+
+  struct protocol_call_site;
+
+  /* A single method of a protocol. Calling it finds the impl for the type of the first
+   * arg and calls that with all of the args. */
+  struct protocol_method : behavior::callable
+  {
+    static constexpr object_type obj_type{ object_type::protocol_method };
+    static constexpr bool pointer_free{ false };
+
+    protocol_method() = delete;
+    protocol_method(protocol_ref const proto, symbol_ref const name);
+
+    /* behavior::object_like */
+    bool equal(object const &) const;
+    jtl::immutable_string to_string() const;
+    void to_string(jtl::string_builder &buff) const;
+    jtl::immutable_string to_code_string() const;
+    void to_code_string(jtl::string_builder &buff) const;
+    uhash to_hash() const;
+
+    /* behavior::callable */
+    object_ref call() override;
+    object_ref call(object_ref const) override;
+    object_ref call(object_ref const, object_ref const) override;
+    object_ref call(object_ref const, object_ref const, object_ref const) override;
+    object_ref
+    call(object_ref const, object_ref const, object_ref const, object_ref const) override;
+    object_ref call(object_ref const,
+                    object_ref const,
+                    object_ref const,
+                    object_ref const,
+                    object_ref const) override;
+    object_ref call(object_ref const,
+                    object_ref const,
+                    object_ref const,
+                    object_ref const,
+                    object_ref const,
+                    object_ref const) override;
+    object_ref call(object_ref const,
+                    object_ref const,
+                    object_ref const,
+                    object_ref const,
+                    object_ref const,
+                    object_ref const,
+                    object_ref const) override;
+    object_ref call(object_ref const,
+                    object_ref const,
+                    object_ref const,
+                    object_ref const,
+                    object_ref const,
+                    object_ref const,
+                    object_ref const,
+                    object_ref const) override;
+    object_ref call(object_ref const,
+                    object_ref const,
+                    object_ref const,
+                    object_ref const,
+                    object_ref const,
+                    object_ref const,
+                    object_ref const,
+                    object_ref const,
+                    object_ref const) override;
+    object_ref call(object_ref const,
+                    object_ref const,
+                    object_ref const,
+                    object_ref const,
+                    object_ref const,
+                    object_ref const,
+                    object_ref const,
+                    object_ref const,
+                    object_ref const,
+                    object_ref const) override;
+    object_ref this_object_ref() final;
+
+    /* Returns nil if there's no impl for this object, not even a default one. */
+    object_ref find_impl(object_ref const o) const;
+    /* Like find_impl, but throws if there's no impl. */
+    object_ref expect_impl(object_ref const o) const;
+    /* Whether impls for struct maps depend on their basis, rather than just their type. */
+    bool has_basis_impls() const;
+
+    /* These are only used by protocol::extend, which serializes them. Each one clears the
+     * inline caches of every call site, since their impls may now be stale. */
+    void set_type_impl(object_type const type, object_ref const fn);
+    void set_default_impl(object_ref const fn);
+    void set_basis_impl(struct_basis_ref const basis, object_ref const fn);
+
+    void add_call_site(protocol_call_site * const site);
+
+    object base{ obj_type };
+    protocol_ref proto;
+    symbol_ref name;
+    /* Null where there's no impl for the type. */
+    std::atomic<object *> impls[object_type_count]{};
+    std::atomic<object *> default_impl{};
+    /* A persistent_hash_map of struct bases to impls, or null while there are none. */
+    std::atomic<object *> basis_impls{};
+    /* Bumped on every change to the impls, so a call site can tell if an impl it's just
+     * looked up was changed before it could cache it. */
+    std::atomic<u64> version{};
+    std::mutex call_sites_lock;
+    native_vector<protocol_call_site *> call_sites;
+
+  private:
+    void clear_call_sites();
+  };
+
+  /* The inline cache for a single call site of a protocol method. The C++ codegen emits
+   * one of these for each call through a var which holds a protocol method. It remembers
+   * the impls for the last few types seen at the site, so a call with one of those types
+   * costs a load of the var's root, a type compare, and one indirect call. Extending the
+   * protocol clears the cache.
+   *
+   * If the var has since been bound to something else, calls go through that instead. */
+  struct protocol_call_site
+  {
+    struct entry
+    {
+      object_type type{};
+      object_ref fn;
+      /* Set when the fn takes calls with this many args at a fixed arity, in which case we
+       * can skip dynamic_call and call that arity directly. */
+      behavior::callable *direct{};
+    };
+
+    /* Past this many types, a site is megamorphic and any further types are looked up in
+     * the method's table on each call. */
+    static constexpr usize max_entries{ 4 };
+
+    protocol_call_site(var_ref const var, protocol_method_ref const method, usize const arg_count);
+
+    /* The site is kept alive for as long as the process is, since it lives in memory which
+     * the GC doesn't scan, such as JIT compiled statics. */
+    static protocol_call_site *create(var_ref const var, usize const arg_count);
+
+    template <typename... Args>
+    object_ref call(object_ref const a1, Args const &...args)
+    {
+      auto const root(get_root());
+      if(root.data != &method->base) [[unlikely]]
+      {
+        return dynamic_call(root, a1, args...);
+      }
+
+      auto const e(lookup(a1));
+      if(!e) [[unlikely]]
+      {
+        return dynamic_call(method->expect_impl(a1), a1, args...);
+      }
+      if(e->direct)
+      {
+        return e->direct->call(a1, args...);
+      }
+      return dynamic_call(e->fn, a1, args...);
+    }
+
+    /* Returns null when the impl can't be cached, in which case the caller needs to look
+     * it up in the method's table. */
+    entry const *lookup(object_ref const o)
+    {
+      for(auto const &slot : entries)
+      {
+        auto const e(slot.load(std::memory_order_acquire));
+        if(!e)
+        {
+          break;
+        }
+        if(e->type == o->type)
+        {
+          return e;
+        }
+      }
+      return miss(o);
+    }
+
+    void clear();
+
+    var_ref var;
+    protocol_method_ref method;
+    usize arg_count{};
+    std::atomic<entry const *> entries[max_entries]{};
+
+  private:
+    object_ref get_root() const;
+    entry const *miss(object_ref const o);
+  };
+}
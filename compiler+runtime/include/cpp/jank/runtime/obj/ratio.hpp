@@ -7,10 +7,16 @@ namespace jank::runtime::obj
 {
   struct ratio_data
   {
+    /* For parts which are already in lowest terms, with a positive denominator. */
+    struct normalized_tag
+    {
+    };
+
     ratio_data(i64 const, i64 const);
     ratio_data(native_big_integer const &, native_big_integer const &);
     ratio_data(big_integer const &, big_integer const &);
     ratio_data(object_ref const, object_ref const);
+    ratio_data(native_big_integer const &, native_big_integer const &, normalized_tag);
     ratio_data(ratio_data const &) = default;
 
     f64 to_real() const;
@@ -41,6 +47,7 @@ namespace jank::runtime::obj
     jtl::immutable_string to_string() const;
     void to_string(jtl::string_builder &buff) const;
     jtl::immutable_string to_code_string() const;
+    void to_code_string(jtl::string_builder &buff) const;
     uhash to_hash() const;
 
     /* behavior::comparable */
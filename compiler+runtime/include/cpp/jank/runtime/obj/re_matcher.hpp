@@ -1,8 +1,5 @@
 #pragma once
 
-#include <regex>
-#include <string>
-
 #include <jank/runtime/obj/re_pattern.hpp>
 #include <jank/runtime/object.hpp>
 
@@ -22,12 +19,19 @@ namespace jank::runtime::obj
     jtl::immutable_string to_string() const;
     void to_string(jtl::string_builder &buff) const;
     jtl::immutable_string to_code_string() const;
+    void to_code_string(jtl::string_builder &buff) const;
     uhash to_hash() const;
 
     object base{ obj_type };
 
     re_pattern_ref re;
-    std::string match_input{};
+    /* This shares the string's memory, rather than copying it. Groups are substrings of
+     * it, so they generally share it too. */
+    jtl::immutable_string input;
+    /* Where the next find starts. This is past the end once the input is used up. */
+    usize position{};
+    /* Reused by each find, so finding in a loop doesn't allocate for them. */
+    native_vector<regex::span> spans;
     object_ref groups{};
   };
 }
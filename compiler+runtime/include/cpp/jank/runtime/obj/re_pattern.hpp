@@ -1,9 +1,7 @@
 #pragma once
 
-#include <regex>
-#include <string>
-
 #include <jank/runtime/object.hpp>
+#include <jank/runtime/regex.hpp>
 
 namespace jank::runtime::obj
 {
@@ -21,11 +19,13 @@ namespace jank::runtime::obj
     jtl::immutable_string to_string() const;
     void to_string(jtl::string_builder &buff) const;
     jtl::immutable_string to_code_string() const;
+    void to_code_string(jtl::string_builder &buff) const;
     uhash to_hash() const;
 
     object base{ obj_type };
 
     jtl::immutable_string pattern{};
-    std::regex regex{};
+    /* Interned, so this is shared with every other pattern with the same source. */
+    regex::program const *program{};
   };
 }
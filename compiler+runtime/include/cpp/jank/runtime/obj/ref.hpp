@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <shared_mutex>
+
+#include <folly/Synchronized.h>
+
+#include <jank/runtime/object.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
+
+namespace jank::runtime::obj
+{
+  using ref_ref = oref<struct ref>;
+
+  /* A ref is only changed within a transaction. See transaction.hpp for how those work.
+   *
+   * Each ref keeps a short history of its committed values, newest first, each tagged with
+   * the point at which it was committed. A transaction reads the newest value which is no
+   * newer than the point it started at, which gives it a consistent snapshot of every ref
+   * without any of them being locked for the length of the transaction. If the history
+   * doesn't reach back far enough, the read faults and the transaction is retried. Each
+   * fault lets the history grow by one more value at the next commit, up to the max. */
+  struct ref
+  {
+    static constexpr object_type obj_type{ object_type::ref };
+    static constexpr bool pointer_free{ false };
+
+    struct version
+    {
+      object_ref val;
+      u64 point{};
+    };
+
+    ref() = default;
+    ref(object_ref const val);
+
+    /* behavior::object_like */
+    bool equal(object const &) const;
+    jtl::immutable_string to_string() const;
+    void to_string(jtl::string_builder &buff) const;
+    jtl::immutable_string to_code_string() const;
+    void to_code_string(jtl::string_builder &buff) const;
+    uhash to_hash() const;
+
+    /* behavior::derefable */
+    /* Within a transaction, this is the in transaction value. Outside of one, it's the
+     * newest committed value, which is read without locking. */
+    object_ref deref() const;
+
+    /* behavior::ref_like */
+    void add_watch(object_ref const key, object_ref const fn);
+    void remove_watch(object_ref const key);
+
+    /* These must all be called within a transaction. */
+    object_ref set(object_ref const val);
+    object_ref alter(object_ref const fn, object_ref const args);
+    object_ref commute(object_ref const fn, object_ref const args);
+    object_ref ensure();
+
+    /* This doesn't count the current value. */
+    usize history_count() const;
+    usize get_min_history() const;
+    ref_ref set_min_history(usize const n);
+    usize get_max_history() const;
+    ref_ref set_max_history(usize const n);
+
+    /* The caller must hold the lock exclusively. */
+    void push_version(object_ref const val, u64 const point);
+
+    object base{ obj_type };
+    std::atomic<object *> current{};
+    /* Newest first. This always has at least the current value. */
+    native_deque<version> history;
+    mutable std::shared_mutex lock;
+    std::atomic<usize> min_history{};
+    std::atomic<usize> max_history{ 10 };
+    /* Reads which couldn't find an old enough value since the last commit. */
+    std::atomic<usize> faults{};
+    folly::Synchronized<persistent_hash_map_ref> watches{};
+  };
+}
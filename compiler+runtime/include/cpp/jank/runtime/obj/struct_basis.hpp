@@ -0,0 +1,38 @@
+#pragma once
+
+#include <jtl/option.hpp>
+
+#include <jank/runtime/object.hpp>
+
+namespace jank::runtime::obj
+{
+  using struct_basis_ref = oref<struct struct_basis>;
+
+  /* The shared description of a struct map, from create-struct. It holds the basis keys,
+   * in order, and each key's index is the slot where every struct map with this basis
+   * keeps its value. */
+  struct struct_basis
+  {
+    static constexpr object_type obj_type{ object_type::struct_basis };
+    static constexpr bool pointer_free{ false };
+
+    struct_basis() = default;
+    struct_basis(native_vector<object_ref> &&keys);
+
+    static struct_basis_ref create(object_ref const keys);
+
+    /* behavior::object_like */
+    bool equal(object const &) const;
+    jtl::immutable_string to_string() const;
+    void to_string(jtl::string_builder &buff) const;
+    jtl::immutable_string to_code_string() const;
+    void to_code_string(jtl::string_builder &buff) const;
+    uhash to_hash() const;
+
+    /* The slot for this key, if it's one of the basis keys. */
+    jtl::option<usize> slot(object_ref const key) const;
+
+    object base{ obj_type };
+    native_vector<object_ref> keys;
+  };
+}
@@ -35,6 +35,7 @@ namespace jank::runtime::obj
     jtl::immutable_string to_string() const;
     void to_string(jtl::string_builder &buff) const;
     jtl::immutable_string to_code_string() const;
+    void to_code_string(jtl::string_builder &buff) const;
     uhash to_hash() const;
 
     /* behavior::countable */
@@ -52,6 +53,10 @@ namespace jank::runtime::obj
 
     /* behavior::conjable_in_place */
     transient_hash_map_ref conj_in_place(object_ref const head);
+    /* Conjoins each element of the coll, which can be anything seqable, or a chunk. This
+     * is the same as calling conj_in_place for each, but without a call per element. */
+    transient_hash_map_ref conj_all_in_place(object_ref const coll);
+    transient_hash_map_ref conj_all_in_place(native_vector<object_ref> const &elems);
 
     /* behavior::persistentable */
     persistent_type_ref to_persistent();
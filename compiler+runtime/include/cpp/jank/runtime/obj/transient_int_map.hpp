@@ -0,0 +1,64 @@
+#pragma once
+
+#include <jank/runtime/object.hpp>
+#include <jank/runtime/detail/native_persistent_int_map.hpp>
+
+namespace jank::runtime::obj
+{
+  using transient_int_map_ref = oref<struct transient_int_map>;
+
+  struct transient_int_map
+  {
+    static constexpr object_type obj_type{ object_type::transient_int_map };
+    static constexpr bool pointer_free{ false };
+
+    using value_type = runtime::detail::native_transient_int_map;
+    using persistent_type_ref = oref<struct persistent_int_map>;
+
+    transient_int_map() = default;
+    transient_int_map(transient_int_map &&) noexcept = default;
+    transient_int_map(transient_int_map const &) = default;
+    transient_int_map(runtime::detail::native_persistent_int_map const &d);
+    transient_int_map(value_type &&d);
+
+    static transient_int_map_ref empty();
+
+    /* behavior::object_like */
+    bool equal(object const &) const;
+    jtl::immutable_string to_string() const;
+    void to_string(jtl::string_builder &buff) const;
+    jtl::immutable_string to_code_string() const;
+    void to_code_string(jtl::string_builder &buff) const;
+    uhash to_hash() const;
+
+    /* behavior::countable */
+    usize count() const;
+
+    /* behavior::associatively_readable */
+    object_ref get(object_ref const key) const;
+    object_ref get(object_ref const key, object_ref const fallback) const;
+    object_ref get_entry(object_ref const key) const;
+    bool contains(object_ref const key) const;
+
+    /* behavior::associatively_writable_in_place */
+    transient_int_map_ref assoc_in_place(object_ref const key, object_ref const val);
+    transient_int_map_ref dissoc_in_place(object_ref const key);
+
+    /* behavior::conjable_in_place */
+    transient_int_map_ref conj_in_place(object_ref const head);
+
+    /* behavior::persistentable */
+    persistent_type_ref to_persistent();
+
+    /* behavior::callable */
+    object_ref call(object_ref const) const;
+    object_ref call(object_ref const, object_ref const) const;
+
+    void assert_active() const;
+
+    object base{ obj_type };
+    value_type data;
+    mutable uhash hash{};
+    bool active{ true };
+  };
+}
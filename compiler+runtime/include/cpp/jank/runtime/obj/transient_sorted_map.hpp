@@ -18,7 +18,8 @@ namespace jank::runtime::obj
     transient_sorted_map() = default;
     transient_sorted_map(transient_sorted_map &&) noexcept = default;
     transient_sorted_map(transient_sorted_map const &) = default;
-    transient_sorted_map(value_type const &d);
+    transient_sorted_map(runtime::detail::native_persistent_sorted_map const &d);
+    transient_sorted_map(runtime::detail::native_persistent_sorted_map &&d);
     transient_sorted_map(value_type &&d);
 
     static transient_sorted_map_ref empty();
@@ -28,6 +29,7 @@ namespace jank::runtime::obj
     jtl::immutable_string to_string() const;
     void to_string(jtl::string_builder &buff) const;
     jtl::immutable_string to_code_string() const;
+    void to_code_string(jtl::string_builder &buff) const;
     uhash to_hash() const;
 
     /* behavior::countable */
@@ -18,12 +18,14 @@ namespace jank::runtime::obj
 
     uuid();
     uuid(jtl::immutable_string const &s);
+    uuid(jtl::ref<uuids::uuid> const value);
 
     /* behavior::object_like */
     bool equal(object const &) const;
     jtl::immutable_string to_string() const;
     void to_string(jtl::string_builder &buff) const;
     jtl::immutable_string to_code_string() const;
+    void to_code_string(jtl::string_builder &buff) const;
     uhash to_hash() const;
 
     object base{ obj_type };
@@ -30,6 +30,10 @@ namespace jank::runtime
     persistent_vector,
     transient_vector,
     persistent_vector_sequence,
+    primitive_vector,
+    primitive_vector_sequence,
+    mapped_vector,
+    mapped_vector_sequence,
 
     persistent_array_map,
     transient_array_map,
@@ -43,6 +47,16 @@ namespace jank::runtime
     transient_sorted_map,
     persistent_sorted_map_sequence,
 
+    persistent_int_map,
+    transient_int_map,
+    persistent_int_map_sequence,
+    mapped_map,
+    mapped_map_sequence,
+
+    struct_basis,
+    persistent_struct_map,
+    persistent_struct_map_sequence,
+
     persistent_hash_set,
     transient_hash_set,
     persistent_hash_set_sequence,
@@ -51,12 +65,17 @@ namespace jank::runtime
     transient_sorted_set,
     persistent_sorted_set_sequence,
 
+    array,
+    column_table,
+    column_table_sequence,
+
     cons,
     lazy_sequence,
     range,
     integer_range,
     repeat,
     iterator,
+    cycle,
     native_array_sequence,
     native_vector_sequence,
 
@@ -68,6 +87,8 @@ namespace jank::runtime
     jit_function,
     jit_closure,
     multi_function,
+    protocol,
+    protocol_method,
 
     native_pointer_wrapper,
 
@@ -75,6 +96,14 @@ namespace jank::runtime
     volatile_,
     reduced,
     delay,
+    future,
+    promise,
+    agent,
+    ref,
+    channel,
+    counter_atom,
+    cache,
+    eduction,
     ns,
 
     var,
@@ -91,6 +120,10 @@ namespace jank::runtime
     opaque_box,
   };
 
+  /* The number of object types, for tables indexed by type. This relies on opaque_box
+   * being the last type. */
+  constexpr usize object_type_count{ static_cast<usize>(object_type::opaque_box) + 1 };
+
   [[gnu::visibility("default")]]
   constexpr char const *object_type_str(object_type const type)
   {
@@ -133,6 +166,14 @@ namespace jank::runtime
         return "transient_vector";
       case object_type::persistent_vector_sequence:
         return "persistent_vector_sequence";
+      case object_type::primitive_vector:
+        return "primitive_vector";
+      case object_type::primitive_vector_sequence:
+        return "primitive_vector_sequence";
+      case object_type::mapped_vector:
+        return "mapped_vector";
+      case object_type::mapped_vector_sequence:
+        return "mapped_vector_sequence";
 
       case object_type::persistent_array_map:
         return "persistent_array_map";
@@ -154,6 +195,22 @@ namespace jank::runtime
         return "transient_sorted_map";
       case object_type::persistent_sorted_map_sequence:
         return "persistent_sorted_map_sequence";
+      case object_type::persistent_int_map:
+        return "persistent_int_map";
+      case object_type::transient_int_map:
+        return "transient_int_map";
+      case object_type::persistent_int_map_sequence:
+        return "persistent_int_map_sequence";
+      case object_type::mapped_map:
+        return "mapped_map";
+      case object_type::mapped_map_sequence:
+        return "mapped_map_sequence";
+      case object_type::struct_basis:
+        return "struct_basis";
+      case object_type::persistent_struct_map:
+        return "persistent_struct_map";
+      case object_type::persistent_struct_map_sequence:
+        return "persistent_struct_map_sequence";
 
       case object_type::persistent_hash_set:
         return "persistent_hash_set";
@@ -169,6 +226,13 @@ namespace jank::runtime
       case object_type::persistent_sorted_set_sequence:
         return "persistent_sorted_set_sequence";
 
+      case object_type::array:
+        return "array";
+      case object_type::column_table:
+        return "column_table";
+      case object_type::column_table_sequence:
+        return "column_table_sequence";
+
       case object_type::cons:
         return "cons";
       case object_type::lazy_sequence:
@@ -181,6 +245,8 @@ namespace jank::runtime
         return "repeat";
       case object_type::iterator:
         return "iterator";
+      case object_type::cycle:
+        return "cycle";
       case object_type::native_array_sequence:
         return "native_array_sequence";
       case object_type::native_vector_sequence:
@@ -201,6 +267,10 @@ namespace jank::runtime
         return "jit_closure";
       case object_type::multi_function:
         return "multi_function";
+      case object_type::protocol:
+        return "protocol";
+      case object_type::protocol_method:
+        return "protocol_method";
 
       case object_type::native_pointer_wrapper:
         return "native_pointer_wrapper";
@@ -213,6 +283,22 @@ namespace jank::runtime
         return "reduced";
       case object_type::delay:
         return "delay";
+      case object_type::future:
+        return "future";
+      case object_type::promise:
+        return "promise";
+      case object_type::agent:
+        return "agent";
+      case object_type::ref:
+        return "ref";
+      case object_type::channel:
+        return "channel";
+      case object_type::counter_atom:
+        return "counter_atom";
+      case object_type::cache:
+        return "cache";
+      case object_type::eduction:
+        return "eduction";
       case object_type::ns:
         return "ns";
 
@@ -241,20 +327,28 @@ namespace jank::runtime
     return "unknown";
   }
 
+  /* The header at the start of every object. There are tens of millions of small objects
+   * live in a typical program, so this is kept to two bytes, which leaves a box like
+   * obj::integer at 16 bytes. Memory is managed by the GC, so there's no ref count. */
   struct object
   {
     object() = default;
-    object(object const &) noexcept;
-    object(object &&) noexcept;
+    object(object const &) noexcept = default;
+    object(object &&) noexcept = default;
     object(object_type) noexcept;
 
-    object &operator=(object const &) noexcept;
-    object &operator=(object &&) noexcept;
+    object &operator=(object const &) noexcept = default;
+    object &operator=(object &&) noexcept = default;
 
     object_type type{};
-    std::atomic<i32> ref_count{};
+    /* Spare bits for state which any object may have, such as whether its hash has been
+     * cached, so that it needn't take up a field in each object. These are copied along
+     * with the object, so they should describe the object's own data. */
+    u8 flags{};
   };
 
+  static_assert(sizeof(object) == 2);
+
   namespace obj
   {
     struct nil;
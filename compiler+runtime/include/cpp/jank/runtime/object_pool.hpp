@@ -0,0 +1,48 @@
+#pragma once
+
+#include <atomic>
+
+#include <jank/type.hpp>
+
+namespace jank::runtime
+{
+  /* Per thread free lists for the small, fixed size objects which the sequence machinery
+   * makes and drops at a huge rate, like conses and the various sequence wrappers. Types
+   * opt in with a `pooled` flag, next to `pointer_free`.
+   *
+   * Each size class has a list of free objects, linked through their first word. Taking
+   * one is a pointer pop, with no locking and no size or kind lookup. When a list runs dry,
+   * we refill it with a whole batch from the GC at once. We never put objects back on the
+   * lists; the GC still collects them as usual, so these are only a faster way in.
+   *
+   * The pools themselves are uncollectable, scanned memory and their objects are normal,
+   * scanned memory, so everything on a list stays reachable through the pool. That's
+   * also why pointer free types can't be pooled, since the links within atomic objects
+   * would never be seen by the GC. */
+  struct object_pool
+  {
+    static constexpr usize granule_size{ 16 };
+    static constexpr usize size_class_count{ 8 };
+    static constexpr usize max_object_size{ granule_size * size_class_count };
+
+    void *free_lists[size_class_count]{};
+    /* These are only ever written by the owning thread, but gc_stats reads them from
+     * others. Every allocation which isn't a refill is a hit. */
+    std::atomic<usize> allocations{};
+    std::atomic<usize> refills{};
+  };
+
+  struct object_pool_stats
+  {
+    usize allocations{};
+    usize refills{};
+  };
+
+  /* Takes an object of the given size from this thread's pool. The size must be no more
+   * than object_pool::max_object_size. The memory is zeroed. */
+  [[gnu::malloc, gnu::returns_nonnull]]
+  void *pool_allocate(usize size);
+
+  /* Totals across all threads, including those which have exited. */
+  object_pool_stats pool_stats();
+}
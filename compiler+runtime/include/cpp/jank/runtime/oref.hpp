@@ -8,6 +8,9 @@
 #include <jtl/assert.hpp>
 
 #include <jank/runtime/object.hpp>
+#include <jank/runtime/allocation_sites.hpp>
+#include <jank/runtime/arena.hpp>
+#include <jank/runtime/object_pool.hpp>
 
 extern "C" void *jank_const_nil();
 
@@ -17,6 +20,7 @@ namespace jank::runtime
   {
     struct nil;
     struct boolean;
+    struct integer;
   }
 
   /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
@@ -24,6 +28,18 @@ namespace jank::runtime
   /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
   extern oref<struct obj::boolean> jank_false;
 
+  namespace detail
+  {
+    /* Integers within this range are preallocated, so boxing them never touches the GC.
+     * Just like the JVM's Long cache, this means equal boxes in this range are identical. */
+    constexpr i64 small_integer_min{ -128 };
+    constexpr i64 small_integer_max{ 1023 };
+
+    /* Points at the box for 0, so it can be indexed directly by any value in range. */
+    /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+    extern obj::integer *small_integers;
+  }
+
   template <typename T>
   struct oref;
 
@@ -457,6 +473,80 @@ namespace jank::runtime
     value_type *data{ std::bit_cast<value_type *>(jank_const_nil()) };
   };
 
+#ifdef JANK_PROFILE_GC
+  namespace perf
+  {
+    /* Counts each box by its type, for jank.perf, and samples the call site every so
+     * many bytes. This is called on every allocation, so it's only built in with the
+     * jank_profile_gc build option. */
+    void record_allocation(object_type const type, usize const size);
+  }
+#endif
+
+  namespace detail
+  {
+    /* Objects which say they're pointer free are allocated as atomic memory, which the GC
+     * never scans. Numbers and such make up much of the heap, so skipping them cuts down on
+     * the marking work for each collection. Any type which holds a pointer to GC memory,
+     * including through a string, must not be pointer free, or what it points to may be
+     * collected out from under it. */
+    template <typename T>
+    constexpr GCPlacement gc_placement()
+    {
+      if constexpr(requires { T::pointer_free; })
+      {
+        return T::pointer_free ? PointerFreeGC : UseGC;
+      }
+      else
+      {
+        return UseGC;
+      }
+    }
+
+    /* Small, fixed size objects which are made and dropped at high rates can say they're
+     * pooled, so they come from this thread's free lists rather than the GC's allocator. */
+    template <typename T>
+    constexpr bool is_pooled()
+    {
+      if constexpr(requires { T::pooled; })
+      {
+        static_assert(!T::pointer_free, "pointer free objects can't be pooled");
+        return T::pooled;
+      }
+      else
+      {
+        return false;
+      }
+    }
+
+    /* New boxes come from the thread's arena, while it has one, then from the thread's
+     * pool, for pooled types, or from the GC. */
+    template <typename T, typename... Args>
+    T *allocate_box(Args &&...args)
+    {
+      if(allocation_sites::detail::is_tracking.load(std::memory_order_relaxed)) [[unlikely]]
+      {
+        allocation_sites::record(T::obj_type, sizeof(T));
+      }
+      if(active_arenas.load(std::memory_order_relaxed)) [[unlikely]]
+      {
+        if(auto const a{ arena::current() }; a)
+        {
+          return new(a->allocate(sizeof(T))) T{ std::forward<Args>(args)... };
+        }
+      }
+      if constexpr(is_pooled<T>())
+      {
+        static_assert(sizeof(T) <= object_pool::max_object_size);
+        return new(pool_allocate(sizeof(T))) T{ std::forward<Args>(args)... };
+      }
+      else
+      {
+        return new(gc_placement<T>()) T{ std::forward<Args>(args)... };
+      }
+    }
+  }
+
   template <typename T>
   jtl::ref<T> make_box(jtl::ref<T> const &o)
   {
@@ -477,7 +567,7 @@ namespace jank::runtime
   {
     static_assert(sizeof(jtl::ref<T>) == sizeof(T *));
     /* TODO: Figure out cleanup for this. */
-    T *ret{ new(GC) T{ std::forward<Args>(args)... } };
+    T *ret{ new(detail::gc_placement<T>()) T{ std::forward<Args>(args)... } };
     if(!ret)
     {
       throw std::runtime_error{ "unable to allocate box" };
@@ -492,12 +582,31 @@ namespace jank::runtime
     return b ? jank_true : jank_false;
   }
 
+  template <typename T>
+  requires(T::obj_type == object_type::integer)
+  oref<T> make_box(i64 const i)
+  {
+    if(detail::small_integer_min <= i && i <= detail::small_integer_max)
+    {
+      return detail::small_integers + i;
+    }
+
+    oref<T> ret{ detail::allocate_box<T>(i) };
+#ifdef JANK_PROFILE_GC
+    perf::record_allocation(T::obj_type, sizeof(T));
+#endif
+    return ret;
+  }
+
   template <typename T, typename... Args>
   requires behavior::object_like<T>
   oref<T> make_box(Args &&...args)
   {
     static_assert(sizeof(oref<T>) == sizeof(T *));
-    oref<T> ret{ new(GC) T{ std::forward<Args>(args)... } };
+    oref<T> ret{ detail::allocate_box<T>(std::forward<Args>(args)...) };
+#ifdef JANK_PROFILE_GC
+    perf::record_allocation(T::obj_type, sizeof(T));
+#endif
     return ret;
   }
 
@@ -4,5 +4,85 @@
 
 namespace jank::runtime::perf
 {
+  /* Runs f with nanobench and gives back a map of the timings, in the chosen time unit,
+   * along with the CPU's performance counters, when they can be read. The opts are
+   * :label, :time-unit, :warmup, :min-iterations, :epochs, :quiet, and :relative, which
+   * is a previous result to compare against. */
   object_ref benchmark(object_ref const opts, object_ref const f);
+  object_ref enter_region(object_ref const region);
+  object_ref exit_region(object_ref const region);
+
+  /* Calls f with an arena active on this thread, for the duration of the call. */
+  object_ref call_with_arena(object_ref const f);
+
+  /* Times each stop the world GC pause, for gc_stats. This replaces any other GC
+   * collection event callback. */
+  void track_gc_pauses();
+
+  /* A map of the heap size, free bytes, bytes allocated since start, collection count,
+   * and GC pause times, in milliseconds. It also has the number of objects taken from the
+   * object pools and how many of those needed a refill from the GC. With the
+   * jank_profile_gc build option, this also has the number of objects allocated of each
+   * type. */
+  object_ref gc_stats();
+
+  /* What the process has from the OS, as a map of the :peak-rss-bytes and the
+   * :minor-page-faults and :major-page-faults so far. On Linux, it also has the current
+   * :rss-bytes and how much of that is in transparent :huge-page-bytes. */
+  object_ref memory_stats();
+
+  /* With the jank_profile_gc build option, one allocation is sampled every
+   * allocation_sample_interval bytes. This gives the call sites which were sampled most,
+   * along with how many times they were sampled, as a vector of maps. Without the build
+   * option, it's always empty. */
+  object_ref allocation_samples();
+
+  /* Writes a heap snapshot to the path and returns a summary of it, as a map. */
+  object_ref heap_snapshot(object_ref const path);
+
+  /* A map of how many swaps on the atom had to retry, as :contended-swaps, and how many
+   * retries those took in total, as :retries. */
+  object_ref atom_stats(object_ref const a);
+
+  object_ref counter_atom(object_ref const initial);
+  object_ref counter_add(object_ref const c, object_ref const n);
+
+  /* With --fn-stats, the calls to each fn arity, most called first. See fn_stats. */
+  object_ref fn_stats();
+  object_ref reset_fn_stats();
+
+  /* What JIT compilation has cost so far, in total, per module, and per top level eval,
+   * along with the hits and misses of the module cache. See jit::stats. */
+  object_ref jit_stats();
+  object_ref reset_jit_stats();
+
+  /* Starts the sampling profiler at the given rate, in samples per second of CPU time. */
+  object_ref start_sampling(object_ref const hz);
+  /* Stops the sampling profiler and gives a map of its :samples and :dropped counts,
+   * along with its stacks, in the folded format, as :folded. */
+  object_ref stop_sampling();
+
+  /* Starts sampling one box every interval bytes, by the jank fn which made it. See
+   * allocation_sites. */
+  object_ref start_allocation_tracking(object_ref const interval);
+  /* Stops tracking and gives a map of the :interval, the total :samples, and the :sites,
+   * most sampled first, each with its :fn, :type, :samples, and estimated :bytes. */
+  object_ref stop_allocation_tracking();
+
+  /* Handles to the metrics registry, which are opaque boxes of the metric. Asking for
+   * the same name again gives the same metric. See metrics. */
+  object_ref metrics_counter(object_ref const name, object_ref const help);
+  object_ref metrics_gauge(object_ref const name, object_ref const help);
+  object_ref metrics_histogram(object_ref const name, object_ref const help);
+  object_ref inc_counter(object_ref const c, object_ref const n);
+  object_ref set_gauge(object_ref const g, object_ref const v);
+  object_ref record_histogram(object_ref const h, object_ref const v);
+  /* Calls f and records how long it took, in nanoseconds, even if it throws. */
+  object_ref time_call(object_ref const h, object_ref const f);
+  object_ref metrics_snapshot();
+  object_ref prometheus_metrics();
+
+#ifdef JANK_PROFILE_GC
+  constexpr usize allocation_sample_interval{ 512 * 1024 };
+#endif
 }
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <jtl/immutable_string.hpp>
+#include <jtl/result.hpp>
+
+namespace jank::runtime::regex
+{
+  /* A compiled pattern. What's in here depends on the regex engine jank was built with,
+   * which is picked by the jank_regex_backend CMake option. Keeping it opaque keeps the
+   * engine's headers out of everything which uses regexes, including JIT compiled code.
+   *
+   * Programs are interned by their pattern, much like keywords, so each distinct pattern is
+   * only compiled once for the life of the process, no matter how many times it's read,
+   * loaded, or passed to re-pattern. They're never changed once compiled, so any number of
+   * threads can match against one at once. */
+  struct program;
+
+  /* Where a group matched, as an offset into the input. */
+  struct span
+  {
+    usize offset{};
+    usize size{};
+    /* Optional groups may not take part in a match, in which case they're nil. */
+    bool matched{};
+  };
+
+  enum class anchor : u8
+  {
+    /* The match may start anywhere at or after the start position, like re-find. */
+    none,
+    /* The match needs to start right at the start position. */
+    start,
+    /* The match needs to span everything from the start position to the end, like
+     * re-matches. */
+    both
+  };
+
+  /* The name of the engine, for error messages and benchmarks. */
+  jtl::immutable_string_view backend_name();
+
+  jtl::result<program const *, jtl::immutable_string> compile(jtl::immutable_string const &pattern);
+
+  /* The number of capturing groups, not counting the whole match. */
+  usize group_count(program const &p);
+
+  /* Looks for a match in the input at or after start. Anything before start is still
+   * used for context, for things like ^ and \b. On a match, the groups are filled with the
+   * whole match first and then each capturing group. The groups are meant to be reused
+   * across searches, so matching in a loop doesn't allocate. */
+  bool search(program const &p,
+              jtl::immutable_string const &input,
+              usize start,
+              anchor a,
+              native_vector<span> &groups);
+
+  /* Where to search from after the given whole match. An empty match would just match
+   * again at the same spot, so we step over the next character instead. That needs to be a
+   * whole UTF-8 character, so we don't split it. */
+  usize next_start(jtl::immutable_string const &input, span const &whole);
+
+  namespace detail
+  {
+    /* Implemented by each backend. This always compiles, skipping the interning, so
+     * callers should generally use compile instead. */
+    jtl::result<program const *, jtl::immutable_string>
+    compile_program(jtl::immutable_string const &pattern);
+    void destroy_program(program const *p);
+  }
+}
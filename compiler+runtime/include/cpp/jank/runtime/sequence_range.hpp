@@ -1,5 +1,7 @@
 #pragma once
 
+#include <type_traits>
+
 #include <jank/runtime/object.hpp>
 #include <jank/runtime/visit.hpp>
 #include <jank/runtime/core/seq.hpp>
@@ -176,4 +178,97 @@ namespace jank::runtime
       return sequence_range<S>{ s.is_some() ? s->seq() : s };
     }
   }
+
+  /* Calls f with each item of a seqable, in order, until f returns false, if it returns
+   * anything at all. This is the cursor for native code which only needs to walk a
+   * collection once. Vectors, lists, arrays, and the native sequences are walked right over
+   * their storage, so they don't allocate anything at all, beyond boxing primitive array
+   * elements. Everything else is walked with one fresh seq and next_in_place, where the
+   * seq supports it, rather than a new seq for each step. Returns whether every item was
+   * visited. */
+  template <typename F>
+  bool for_each_item(object_ref const coll, F &&f)
+  {
+    auto const step([&](object_ref const o) -> bool {
+      if constexpr(std::is_void_v<decltype(f(o))>)
+      {
+        f(o);
+        return true;
+      }
+      else
+      {
+        return f(o);
+      }
+    });
+    auto const walk([&](auto begin, auto const end) -> bool {
+      for(; begin != end; ++begin)
+      {
+        if(!step(*begin))
+        {
+          return false;
+        }
+      }
+      return true;
+    });
+
+    return visit_seqable(
+      [&](auto const typed_coll) -> bool {
+        using T = typename jtl::decay_t<decltype(typed_coll)>::value_type;
+
+        if constexpr(std::same_as<T, obj::nil>)
+        {
+          return true;
+        }
+        else if constexpr(std::same_as<T, obj::persistent_vector>
+                          || std::same_as<T, obj::persistent_list>)
+        {
+          return walk(typed_coll->data.begin(), typed_coll->data.end());
+        }
+        else if constexpr(std::same_as<T, obj::persistent_vector_sequence>)
+        {
+          auto const &v(typed_coll->vec->data);
+          return walk(v.begin() + static_cast<std::ptrdiff_t>(typed_coll->index), v.end());
+        }
+        else if constexpr(std::same_as<T, obj::native_vector_sequence>)
+        {
+          auto const &v(typed_coll->data);
+          return walk(v.begin() + static_cast<std::ptrdiff_t>(typed_coll->index), v.end());
+        }
+        else if constexpr(std::same_as<T, obj::native_array_sequence>)
+        {
+          return walk(typed_coll->arr + typed_coll->index, typed_coll->arr + typed_coll->size);
+        }
+        else if constexpr(std::same_as<T, obj::array>)
+        {
+          /* A seq of an array copies out every element first, even those we'd stop
+           * before. Object arrays are walked right over their storage, while primitive
+           * elements still need to be boxed, one at a time. */
+          if(typed_coll->element == obj::array::element_type::object)
+          {
+            auto const data(typed_coll->template data_as<object_ref>());
+            return walk(data, data + typed_coll->length);
+          }
+          for(usize i{}; i < typed_coll->length; ++i)
+          {
+            if(!step(typed_coll->get(i)))
+            {
+              return false;
+            }
+          }
+          return true;
+        }
+        else
+        {
+          for(auto const e : make_sequence_range(typed_coll))
+          {
+            if(!step(e))
+            {
+              return false;
+            }
+          }
+          return true;
+        }
+      },
+      coll);
+  }
 }
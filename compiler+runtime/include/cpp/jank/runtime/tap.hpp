@@ -0,0 +1,23 @@
+#pragma once
+
+#include <jank/runtime/object.hpp>
+
+/* The backing for tap>, add-tap, and remove-tap. Values are offered to a bounded ring
+ * buffer which takes any number of producers and a single consumer. An offer is a CAS
+ * and a store, without any lock or allocation, so tap> is cheap enough to leave in
+ * production code. When the buffer is full, the value is dropped and counted in the
+ * jank_tap_dropped_total metric.
+ *
+ * The buffer is drained by one task on the solo executor, which is only submitted when
+ * there's no drain already running. It calls every tap with each value, in the order
+ * they were offered. Taps may block briefly, but values offered meanwhile are dropped
+ * once the buffer fills. Anything a tap throws is ignored. */
+namespace jank::runtime
+{
+  static constexpr usize tap_queue_capacity{ 1024 };
+
+  /* Gives whether there was room for the value. */
+  bool tap_offer(object_ref const o);
+  void add_tap(object_ref const f);
+  void remove_tap(object_ref const f);
+}
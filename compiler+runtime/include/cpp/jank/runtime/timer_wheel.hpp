@@ -0,0 +1,113 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include <jtl/option.hpp>
+
+#include <jank/type.hpp>
+
+namespace jank::runtime
+{
+  /* A hierarchical timer wheel, for running tasks after a delay or at a fixed rate, from
+   * a single thread, no matter how many timers are pending. Time is counted in ticks of
+   * one millisecond. Each of the four levels has 256 slots, each one covering 256 times
+   * as many ticks as a slot of the level below, so the wheel spans about 49 days. Later
+   * timers sit in the last level until they're close enough.
+   *
+   * A timer is put into the slot of the level which covers its deadline and, as time
+   * reaches that slot, the timers in it are cascaded down into the level below. That
+   * makes adding and cancelling O(1), with each timer moved at most once per level. The
+   * thread only wakes for a slot which has timers in it, or for a cascade.
+   *
+   * Tasks run on the wheel's thread, so they need to be quick. Anything more should be
+   * submitted to an executor from the task. As with executors, tasks must not throw.
+   *
+   * Timers are GC allocated, and only referenced from the wheel, so a wheel must itself
+   * be somewhere the GC scans, such as on the stack or in GC memory. */
+  struct timer_wheel
+  {
+    using task = std::function<void()>;
+    using clock = std::chrono::steady_clock;
+
+    struct timer
+    {
+      timer *prev{};
+      timer *next{};
+      u64 deadline{};
+      /* In ticks. Zero for a timer which only runs once. */
+      u64 period{};
+      u8 level{};
+      u8 slot{};
+      /* Whether the timer is in one of the slots. */
+      bool is_pending{};
+      task fn;
+    };
+
+    static constexpr usize level_count{ 4 };
+    static constexpr usize slot_bits{ 8 };
+    static constexpr usize slot_count{ 1 << slot_bits };
+
+    timer_wheel();
+    timer_wheel(timer_wheel const &) = delete;
+    timer_wheel(timer_wheel &&) = delete;
+    ~timer_wheel();
+
+    timer_wheel &operator=(timer_wheel const &) = delete;
+    timer_wheel &operator=(timer_wheel &&) = delete;
+
+    /* Runs the task once the delay has passed and then, with a non-zero period, again each
+     * time the period passes after that. The period is counted from when each run was due,
+     * rather than from when it ran, so a late run doesn't delay the ones after it. */
+    timer *schedule(std::chrono::milliseconds const delay,
+                    std::chrono::milliseconds const period,
+                    task &&t);
+    /* Gives whether the timer was still pending. A periodic timer which is cancelled while
+     * it's running won't run again. */
+    bool cancel(timer * const t);
+
+    usize pending_count();
+
+  private:
+    struct level
+    {
+      std::array<timer *, slot_count> heads{};
+      /* One bit for each slot which has timers in it. */
+      std::array<u64, slot_count / 64> occupied{};
+      usize count{};
+    };
+
+    u64 now_tick() const;
+    void insert(timer * const t);
+    void unlink(timer * const t);
+    /* Takes every timer out of the slot, leaving it empty. */
+    static timer *take_slot(level &l, usize const slot);
+    void cascade(usize const level_index, u64 const tick);
+    void expire(u64 const tick, native_vector<timer *> &due);
+    /* The next tick, from the current one, at which a slot expires or cascades. */
+    jtl::option<u64> next_event_tick() const;
+    void run();
+
+    clock::time_point epoch;
+    /* The next tick to be processed. Everything before it has already expired. */
+    u64 current_tick{};
+    std::array<level, level_count> levels{};
+    usize count{};
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::thread thread;
+    /* The tick the thread is sleeping until, so that adding a timer only wakes it when
+     * the new one is due sooner. */
+    u64 wake_tick{};
+    bool stopping{};
+  };
+
+  /* The wheel for the runtime's timers, such as jank.async's timeout channels and
+   * scheduled tasks. */
+  timer_wheel &scheduler();
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <jank/runtime/object.hpp>
+
+namespace jank::runtime
+{
+  namespace obj
+  {
+    using ref_ref = oref<struct ref>;
+  }
+
+  /* A software transaction over refs, which backs dosync.
+   *
+   * Transactions are optimistic. Reads come from each ref's history, as of the point at
+   * which the transaction started, and writes are kept in the transaction until it commits.
+   * To commit, we lock just the refs which were written or ensured, in address order so
+   * that two commits can't deadlock, and check that none of them has been committed to
+   * since we started. If any has, we retry the whole transaction. Otherwise, each ref gets
+   * its new value, with a fresh commit point, and its watches are notified.
+   *
+   * Commutes don't conflict with anything. At commit, each commute fn is run again on the
+   * newest committed value of its ref, under that ref's lock.
+   *
+   * Retries back off for a random, growing amount of time, so transactions which keep
+   * conflicting with each other spread out, rather than livelock. */
+  struct transaction;
+
+  /* Runs fn in a transaction. If this thread is already running one, fn just joins it. */
+  object_ref run_in_transaction(object_ref const fn);
+  bool is_in_transaction();
+
+  namespace detail
+  {
+    /* These throw if there's no transaction running. */
+    object_ref transaction_read(obj::ref_ref const r);
+    object_ref transaction_set(obj::ref_ref const r, object_ref const val);
+    object_ref transaction_commute(obj::ref_ref const r, object_ref const f, object_ref const args);
+    object_ref transaction_ensure(obj::ref_ref const r);
+  }
+}
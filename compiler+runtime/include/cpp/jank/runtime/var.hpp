@@ -1,8 +1,8 @@
 #pragma once
 
+#include <atomic>
 #include <functional>
-
-#include <folly/Synchronized.h>
+#include <mutex>
 
 #include <jtl/result.hpp>
 
@@ -35,6 +35,7 @@ namespace jank::runtime
     bool equal(object const &) const;
     jtl::immutable_string to_string() const;
     jtl::immutable_string to_code_string() const;
+    void to_code_string(jtl::string_builder &buff) const;
     void to_string(jtl::string_builder &buff) const;
     uhash to_hash() const;
 
@@ -45,9 +46,20 @@ namespace jank::runtime
     var_ref with_meta(object_ref const m);
 
     bool is_bound() const;
+    /* Reading the root never locks, so it's safe to do from hot paths on any thread. */
     object_ref get_root() const;
+    /* Every publish of a new root bumps this. It can be used to tell whether a cached
+     * root is still current without needing to compare the roots themselves. */
+    u64 get_root_version() const;
+    /* Where the root version is, from the start of the object, so generated code can load
+     * it without a call. */
+    static usize root_version_offset();
     /* Binding a root changes it for all threads. */
     var_ref bind_root(object_ref const r);
+    /* The initializer is called to find the root on its first read, on whichever thread
+     * gets there first, and then bound as the root. Until then, reading the root costs one
+     * extra check. */
+    var_ref bind_lazy_root(object *(*init)());
     object_ref alter_root(object_ref const f, object_ref const args);
     /* Setting a var does not change its root, it only affects the current thread
      * binding. If there is no thread binding, a var cannot be set. */
@@ -73,7 +85,16 @@ namespace jank::runtime
     mutable uhash hash{};
 
   private:
-    folly::Synchronized<object_ref> root;
+    object_ref initialize_lazy_root() const;
+
+    /* Readers load the root directly, without any lock. Writers are serialized through
+     * the root mutex and publish a new root, and then a new version, with release semantics.
+     * A lazy root is null until its initializer has run. */
+    std::atomic<object *> root;
+    object *(*lazy_init)(){};
+    mutable bool lazy_initializing{};
+    std::atomic<u64> root_version{};
+    std::mutex root_mutex;
 
   public:
     std::atomic_bool dynamic{ false };
@@ -92,6 +113,7 @@ namespace jank::runtime
     jtl::immutable_string to_string() const;
     void to_string(jtl::string_builder &buff) const;
     jtl::immutable_string to_code_string() const;
+    void to_code_string(jtl::string_builder &buff) const;
     uhash to_hash() const;
 
     object base{ obj_type };
@@ -107,7 +129,7 @@ namespace jank::runtime
   struct var_unbound_root
   {
     static constexpr object_type obj_type{ object_type::var_unbound_root };
-    static constexpr bool pointer_free{ true };
+    static constexpr bool pointer_free{ false };
 
     var_unbound_root(var_ref const var);
 
@@ -116,6 +138,7 @@ namespace jank::runtime
     jtl::immutable_string to_string() const;
     void to_string(jtl::string_builder &buff) const;
     jtl::immutable_string to_code_string() const;
+    void to_code_string(jtl::string_builder &buff) const;
     uhash to_hash() const;
 
     object base{ obj_type };
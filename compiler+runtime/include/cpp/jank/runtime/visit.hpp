@@ -6,6 +6,9 @@
 #include <jank/runtime/object.hpp>
 #include <jank/runtime/obj/nil.hpp>
 #include <jank/runtime/obj/number.hpp>
+#include <jank/runtime/obj/array.hpp>
+#include <jank/runtime/obj/column_table.hpp>
+#include <jank/runtime/obj/column_table_sequence.hpp>
 #include <jank/runtime/obj/cons.hpp>
 #include <jank/runtime/obj/persistent_string.hpp>
 #include <jank/runtime/obj/keyword.hpp>
@@ -24,12 +27,21 @@
 #include <jank/runtime/obj/persistent_hash_map_sequence.hpp>
 #include <jank/runtime/obj/persistent_sorted_map.hpp>
 #include <jank/runtime/obj/persistent_sorted_map_sequence.hpp>
+#include <jank/runtime/obj/persistent_int_map.hpp>
+#include <jank/runtime/obj/persistent_int_map_sequence.hpp>
+#include <jank/runtime/obj/transient_int_map.hpp>
+#include <jank/runtime/obj/mapped_map.hpp>
+#include <jank/runtime/obj/mapped_map_sequence.hpp>
+#include <jank/runtime/obj/persistent_struct_map.hpp>
+#include <jank/runtime/obj/persistent_struct_map_sequence.hpp>
+#include <jank/runtime/obj/struct_basis.hpp>
 #include <jank/runtime/obj/transient_hash_map.hpp>
 #include <jank/runtime/obj/transient_sorted_map.hpp>
 #include <jank/runtime/obj/transient_vector.hpp>
 #include <jank/runtime/obj/transient_hash_set.hpp>
 #include <jank/runtime/obj/transient_sorted_set.hpp>
 #include <jank/runtime/obj/iterator.hpp>
+#include <jank/runtime/obj/cycle.hpp>
 #include <jank/runtime/obj/lazy_sequence.hpp>
 #include <jank/runtime/obj/chunk_buffer.hpp>
 #include <jank/runtime/obj/array_chunk.hpp>
@@ -41,9 +53,15 @@
 #include <jank/runtime/obj/jit_function.hpp>
 #include <jank/runtime/obj/jit_closure.hpp>
 #include <jank/runtime/obj/multi_function.hpp>
+#include <jank/runtime/obj/protocol.hpp>
+#include <jank/runtime/obj/protocol_method.hpp>
 #include <jank/runtime/obj/native_function_wrapper.hpp>
 #include <jank/runtime/obj/native_pointer_wrapper.hpp>
 #include <jank/runtime/obj/persistent_vector_sequence.hpp>
+#include <jank/runtime/obj/primitive_vector.hpp>
+#include <jank/runtime/obj/primitive_vector_sequence.hpp>
+#include <jank/runtime/obj/mapped_vector.hpp>
+#include <jank/runtime/obj/mapped_vector_sequence.hpp>
 #include <jank/runtime/obj/persistent_string_sequence.hpp>
 #include <jank/runtime/obj/persistent_hash_set_sequence.hpp>
 #include <jank/runtime/obj/persistent_sorted_set_sequence.hpp>
@@ -52,6 +70,14 @@
 #include <jank/runtime/obj/atom.hpp>
 #include <jank/runtime/obj/volatile.hpp>
 #include <jank/runtime/obj/delay.hpp>
+#include <jank/runtime/obj/future.hpp>
+#include <jank/runtime/obj/promise.hpp>
+#include <jank/runtime/obj/agent.hpp>
+#include <jank/runtime/obj/ref.hpp>
+#include <jank/runtime/obj/channel.hpp>
+#include <jank/runtime/obj/counter_atom.hpp>
+#include <jank/runtime/obj/cache.hpp>
+#include <jank/runtime/obj/eduction.hpp>
 #include <jank/runtime/obj/reduced.hpp>
 #include <jank/runtime/obj/tagged_literal.hpp>
 #include <jank/runtime/obj/re_pattern.hpp>
@@ -125,10 +151,29 @@ namespace jank::runtime
       case object_type::persistent_sorted_map_sequence:
         return fn(expect_object<obj::persistent_sorted_map_sequence>(erased),
                   std::forward<Args>(args)...);
+      case object_type::persistent_int_map:
+        return fn(expect_object<obj::persistent_int_map>(erased), std::forward<Args>(args)...);
+      case object_type::persistent_int_map_sequence:
+        return fn(expect_object<obj::persistent_int_map_sequence>(erased),
+                  std::forward<Args>(args)...);
+      case object_type::mapped_map:
+        return fn(expect_object<obj::mapped_map>(erased), std::forward<Args>(args)...);
+      case object_type::mapped_map_sequence:
+        return fn(expect_object<obj::mapped_map_sequence>(erased),
+                  std::forward<Args>(args)...);
+      case object_type::struct_basis:
+        return fn(expect_object<obj::struct_basis>(erased), std::forward<Args>(args)...);
+      case object_type::persistent_struct_map:
+        return fn(expect_object<obj::persistent_struct_map>(erased), std::forward<Args>(args)...);
+      case object_type::persistent_struct_map_sequence:
+        return fn(expect_object<obj::persistent_struct_map_sequence>(erased),
+                  std::forward<Args>(args)...);
       case object_type::transient_hash_map:
         return fn(expect_object<obj::transient_hash_map>(erased), std::forward<Args>(args)...);
       case object_type::transient_sorted_map:
         return fn(expect_object<obj::transient_sorted_map>(erased), std::forward<Args>(args)...);
+      case object_type::transient_int_map:
+        return fn(expect_object<obj::transient_int_map>(erased), std::forward<Args>(args)...);
       case object_type::transient_vector:
         return fn(expect_object<obj::transient_vector>(erased), std::forward<Args>(args)...);
       case object_type::persistent_hash_set:
@@ -139,6 +184,12 @@ namespace jank::runtime
         return fn(expect_object<obj::transient_hash_set>(erased), std::forward<Args>(args)...);
       case object_type::transient_sorted_set:
         return fn(expect_object<obj::transient_sorted_set>(erased), std::forward<Args>(args)...);
+      case object_type::array:
+        return fn(expect_object<obj::array>(erased), std::forward<Args>(args)...);
+      case object_type::column_table:
+        return fn(expect_object<obj::column_table>(erased), std::forward<Args>(args)...);
+      case object_type::column_table_sequence:
+        return fn(expect_object<obj::column_table_sequence>(erased), std::forward<Args>(args)...);
       case object_type::cons:
         return fn(expect_object<obj::cons>(erased), std::forward<Args>(args)...);
       case object_type::range:
@@ -159,6 +210,16 @@ namespace jank::runtime
       case object_type::persistent_vector_sequence:
         return fn(expect_object<obj::persistent_vector_sequence>(erased),
                   std::forward<Args>(args)...);
+      case object_type::primitive_vector:
+        return fn(expect_object<obj::primitive_vector>(erased), std::forward<Args>(args)...);
+      case object_type::primitive_vector_sequence:
+        return fn(expect_object<obj::primitive_vector_sequence>(erased),
+                  std::forward<Args>(args)...);
+      case object_type::mapped_vector:
+        return fn(expect_object<obj::mapped_vector>(erased), std::forward<Args>(args)...);
+      case object_type::mapped_vector_sequence:
+        return fn(expect_object<obj::mapped_vector_sequence>(erased),
+                  std::forward<Args>(args)...);
       case object_type::persistent_hash_set_sequence:
         return fn(expect_object<obj::persistent_hash_set_sequence>(erased),
                   std::forward<Args>(args)...);
@@ -167,6 +228,8 @@ namespace jank::runtime
                   std::forward<Args>(args)...);
       case object_type::iterator:
         return fn(expect_object<obj::iterator>(erased), std::forward<Args>(args)...);
+      case object_type::cycle:
+        return fn(expect_object<obj::cycle>(erased), std::forward<Args>(args)...);
       case object_type::lazy_sequence:
         return fn(expect_object<obj::lazy_sequence>(erased), std::forward<Args>(args)...);
       case object_type::chunk_buffer:
@@ -185,6 +248,10 @@ namespace jank::runtime
         return fn(expect_object<obj::jit_closure>(erased), std::forward<Args>(args)...);
       case object_type::multi_function:
         return fn(expect_object<obj::multi_function>(erased), std::forward<Args>(args)...);
+      case object_type::protocol:
+        return fn(expect_object<obj::protocol>(erased), std::forward<Args>(args)...);
+      case object_type::protocol_method:
+        return fn(expect_object<obj::protocol_method>(erased), std::forward<Args>(args)...);
       case object_type::atom:
         return fn(expect_object<obj::atom>(erased), std::forward<Args>(args)...);
       case object_type::volatile_:
@@ -193,6 +260,22 @@ namespace jank::runtime
         return fn(expect_object<obj::reduced>(erased), std::forward<Args>(args)...);
       case object_type::delay:
         return fn(expect_object<obj::delay>(erased), std::forward<Args>(args)...);
+      case object_type::future:
+        return fn(expect_object<obj::future>(erased), std::forward<Args>(args)...);
+      case object_type::promise:
+        return fn(expect_object<obj::promise>(erased), std::forward<Args>(args)...);
+      case object_type::agent:
+        return fn(expect_object<obj::agent>(erased), std::forward<Args>(args)...);
+      case object_type::ref:
+        return fn(expect_object<obj::ref>(erased), std::forward<Args>(args)...);
+      case object_type::channel:
+        return fn(expect_object<obj::channel>(erased), std::forward<Args>(args)...);
+      case object_type::counter_atom:
+        return fn(expect_object<obj::counter_atom>(erased), std::forward<Args>(args)...);
+      case object_type::cache:
+        return fn(expect_object<obj::cache>(erased), std::forward<Args>(args)...);
+      case object_type::eduction:
+        return fn(expect_object<obj::eduction>(erased), std::forward<Args>(args)...);
       case object_type::ns:
         return fn(expect_object<ns>(erased), std::forward<Args>(args)...);
       case object_type::var:
@@ -267,10 +350,33 @@ namespace jank::runtime
       case object_type::persistent_sorted_map_sequence:
         return fn(expect_object<obj::persistent_sorted_map_sequence>(erased),
                   std::forward<Args>(args)...);
+      case object_type::persistent_int_map:
+        return fn(expect_object<obj::persistent_int_map>(erased), std::forward<Args>(args)...);
+      case object_type::persistent_int_map_sequence:
+        return fn(expect_object<obj::persistent_int_map_sequence>(erased),
+                  std::forward<Args>(args)...);
+      case object_type::mapped_map:
+        return fn(expect_object<obj::mapped_map>(erased), std::forward<Args>(args)...);
+      case object_type::mapped_map_sequence:
+        return fn(expect_object<obj::mapped_map_sequence>(erased),
+                  std::forward<Args>(args)...);
+      case object_type::persistent_struct_map:
+        return fn(expect_object<obj::persistent_struct_map>(erased), std::forward<Args>(args)...);
+      case object_type::persistent_struct_map_sequence:
+        return fn(expect_object<obj::persistent_struct_map_sequence>(erased),
+                  std::forward<Args>(args)...);
       case object_type::persistent_hash_set:
         return fn(expect_object<obj::persistent_hash_set>(erased), std::forward<Args>(args)...);
       case object_type::persistent_sorted_set:
         return fn(expect_object<obj::persistent_sorted_set>(erased), std::forward<Args>(args)...);
+      case object_type::array:
+        return fn(expect_object<obj::array>(erased), std::forward<Args>(args)...);
+      case object_type::column_table:
+        return fn(expect_object<obj::column_table>(erased), std::forward<Args>(args)...);
+      case object_type::column_table_sequence:
+        return fn(expect_object<obj::column_table_sequence>(erased), std::forward<Args>(args)...);
+      case object_type::eduction:
+        return fn(expect_object<obj::eduction>(erased), std::forward<Args>(args)...);
       case object_type::cons:
         return fn(expect_object<obj::cons>(erased), std::forward<Args>(args)...);
       case object_type::range:
@@ -289,6 +395,16 @@ namespace jank::runtime
       case object_type::persistent_vector_sequence:
         return fn(expect_object<obj::persistent_vector_sequence>(erased),
                   std::forward<Args>(args)...);
+      case object_type::primitive_vector:
+        return fn(expect_object<obj::primitive_vector>(erased), std::forward<Args>(args)...);
+      case object_type::primitive_vector_sequence:
+        return fn(expect_object<obj::primitive_vector_sequence>(erased),
+                  std::forward<Args>(args)...);
+      case object_type::mapped_vector:
+        return fn(expect_object<obj::mapped_vector>(erased), std::forward<Args>(args)...);
+      case object_type::mapped_vector_sequence:
+        return fn(expect_object<obj::mapped_vector_sequence>(erased),
+                  std::forward<Args>(args)...);
       case object_type::persistent_hash_set_sequence:
         return fn(expect_object<obj::persistent_hash_set_sequence>(erased),
                   std::forward<Args>(args)...);
@@ -297,6 +413,8 @@ namespace jank::runtime
                   std::forward<Args>(args)...);
       case object_type::iterator:
         return fn(expect_object<obj::iterator>(erased), std::forward<Args>(args)...);
+      case object_type::cycle:
+        return fn(expect_object<obj::cycle>(erased), std::forward<Args>(args)...);
       case object_type::lazy_sequence:
         return fn(expect_object<obj::lazy_sequence>(erased), std::forward<Args>(args)...);
       case object_type::chunked_cons:
@@ -344,6 +462,12 @@ namespace jank::runtime
         return fn(expect_object<obj::persistent_hash_map>(erased), std::forward<Args>(args)...);
       case object_type::persistent_sorted_map:
         return fn(expect_object<obj::persistent_sorted_map>(erased), std::forward<Args>(args)...);
+      case object_type::persistent_int_map:
+        return fn(expect_object<obj::persistent_int_map>(erased), std::forward<Args>(args)...);
+      case object_type::persistent_struct_map:
+        return fn(expect_object<obj::persistent_struct_map>(erased), std::forward<Args>(args)...);
+      case object_type::mapped_map:
+        return fn(expect_object<obj::mapped_map>(erased), std::forward<Args>(args)...);
       /* Not map-like. */
       default:
         return else_fn();
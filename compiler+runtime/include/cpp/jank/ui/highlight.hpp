@@ -1,10 +1,15 @@
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <map>
+#include <string>
 
 #include <jtl/primitive.hpp>
 
+#include <jank/type.hpp>
+#include <jank/read/lex.hpp>
+
 namespace ftxui
 {
   using Element = std::shared_ptr<struct Node>;
@@ -26,5 +31,48 @@ namespace jank
   {
     std::map<usize, ftxui::Element>
     highlight(runtime::module::file_view const &code, usize line_start, usize line_end);
+
+    /* For code which is highlighted over and over as it's edited, such as the input of a
+     * REPL. The lexer's state is kept at the start of each line, along with the line's
+     * highlighted tokens. On each update, lexing starts again from the first line which
+     * changed and stops as soon as it reaches a line, in the unchanged rest of the code,
+     * where it's in the same state it was in last time. The lines from there on are
+     * reused as they were. */
+    struct incremental_highlighter
+    {
+      void update(jtl::immutable_string_view const &code);
+      /* Lines are numbered from 1, as with highlight. This only gives lines which exist. */
+      std::map<usize, ftxui::Element> highlight(usize line_start, usize line_end);
+
+      usize line_count() const;
+      /* How many lines the last update had to lex again. */
+      usize relexed_line_count() const;
+
+    private:
+      struct segment
+      {
+        /* Byte offsets within the line. */
+        usize start{};
+        usize end{};
+        std::function<ftxui::Element(ftxui::Element)> color;
+      };
+
+      struct line
+      {
+        usize offset{};
+        /* The state between the last token which ended at or before the start of the line
+         * and the next one. Lexing from here gives every token which touches the line. */
+        read::lex::processor::state checkpoint;
+        native_vector<segment> segments;
+        /* Rendered the first time it's asked for. */
+        ftxui::Element element;
+      };
+
+      ftxui::Element render(usize const index);
+
+      std::string code;
+      native_vector<line> lines;
+      usize relexed_lines{};
+    };
   }
 }
@@ -17,4 +17,16 @@ namespace jank::util
   build_pch(std::vector<char const *> args, jtl::immutable_string const &binary_version);
 
   jtl::immutable_string default_target_triple();
+
+  /* The CPU compiled code is built for, as given by --target-cpu. By default, the JIT
+   * targets the host, with every feature it has. AOT programs stay generic, since they
+   * need to run on more than the machine which built them. So does the JIT within them,
+   * since it shares their embedded PCH. */
+  jtl::immutable_string target_cpu();
+  /* The Clang flag for the target CPU, which is none for a generic target. */
+  jtl::option<jtl::immutable_string> target_cpu_flag();
+  /* The LLVM CPU name and features of the target CPU, with native resolved. These are
+   * what a target machine needs for emitting objects. */
+  jtl::immutable_string target_cpu_name();
+  jtl::immutable_string target_cpu_features();
 }
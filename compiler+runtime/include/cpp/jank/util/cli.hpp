@@ -12,7 +12,10 @@ namespace jank::util::cli
     repl,
     cpp_repl,
     run_main,
-    check_health
+    check_health,
+    heap_summary,
+    bench_compile,
+    test
   };
 
   enum class codegen_type : u8
@@ -34,6 +37,31 @@ namespace jank::util::cli
     }
   }
 
+  /* How the workers of the pooled executor are pinned to cores. */
+  enum class executor_affinity : u8
+  {
+    none,
+    /* Each worker is pinned to one core, spread evenly across the NUMA nodes. */
+    core,
+    /* Each worker is pinned to all of the cores of one NUMA node. */
+    node
+  };
+
+  constexpr char const *executor_affinity_str(executor_affinity const affinity)
+  {
+    switch(affinity)
+    {
+      case executor_affinity::none:
+        return "none";
+      case executor_affinity::core:
+        return "core";
+      case executor_affinity::node:
+        return "node";
+      default:
+        return "unknown";
+    }
+  }
+
   enum class compilation_target : u8
   {
     /* The target will be determined based on the extension of the output.
@@ -65,11 +93,51 @@ namespace jank::util::cli
   {
     /* Runtime. */
     jtl::immutable_string module_path;
+    /* Compiled modules are stored in a subdirectory of this, named after the binary version. */
+    jtl::immutable_string binary_cache_dir{ "target" };
     jtl::immutable_string profiler_file{ "jank.profile" };
+    /* A startup image to trust module binaries from, and one to save once the run is done.
+     * See module::loader::read_image. */
+    jtl::immutable_string image_file;
+    jtl::immutable_string save_image_file;
+    /* A cache to share compiled modules through. See module::remote_cache. */
+    jtl::immutable_string remote_cache;
+    bool remote_cache_read_only{};
+    /* The CPU to build code for. See util::target_cpu. */
+    jtl::immutable_string target_cpu;
     bool profiler_enabled{};
+    /* JIT compiled code is registered with perf, through a jitdump. With IR codegen, this
+     * also gives it line tables for its jank source, as --debug does. */
     bool perf_profiling_enabled{};
+    /* JIT compiled code keeps its frame pointers, so the sampling profiler can walk the
+     * stack through it. */
+    bool frame_pointers{};
     bool gc_incremental{};
-    codegen_type codegen{ codegen_type::cpp };
+    /* Incremental collection without a time limit on each step, which means each
+     * collection only marks what's been allocated or written since the last one, with a
+     * full collection every gc_full_freq of those. */
+    bool gc_generational{};
+    /* The GC tuning knobs are left to bdwgc's defaults when they're 0. The number of
+     * parallel marker threads can only be set before the GC is initialized, so it's picked
+     * out of the args separately, by parse_gc_markers. */
+    u32 gc_markers{};
+    usize gc_initial_heap_size{};
+    usize gc_max_heap_size{};
+    /* See runtime::enable_gc_huge_pages. */
+    bool gc_huge_pages{};
+    /* Higher values collect more often, with a smaller heap. */
+    u32 gc_free_space_divisor{};
+    u32 gc_full_freq{};
+    /* The pooled executor, behind futures, agents, and pmap, has one worker per core when
+     * this is 0. With an affinity, its workers steal from others on their own NUMA node
+     * before the rest. */
+    u32 executor_threads{};
+    executor_affinity executor_affinity{ executor_affinity::none };
+    /* IR is much quicker to JIT compile, since Clang doesn't need to parse anything. C++
+     * codegen is still used for C++ output, since it's easier to read. */
+    codegen_type codegen{ codegen_type::llvm_ir };
+    /* Whether --codegen was given. When it wasn't, outputting C++ switches to C++ codegen. */
+    bool codegen_specified{};
 
     /* Native dependencies. */
     native_vector<jtl::immutable_string> include_dirs;
@@ -81,14 +149,75 @@ namespace jank::util::cli
     bool debug{};
     u8 optimization_level{};
     bool direct_call{};
+    /* Calls to non-dynamic vars are linked straight to the fn they hold when the call
+     * is compiled. Vars marked with ^:redef opt out. */
+    bool direct_linking{};
+    /* Defs in AOT compiled modules whose values are fns or literals are initialized on
+     * their first deref, rather than when the module is loaded. */
+    bool lazy_defs{};
+    /* Calls to pure clojure.core fns with literal args, and ifs with a literal condition,
+     * are evaluated during analysis. */
+    bool fold_constants{};
+    /* JIT compiled fns start out unoptimized and are recompiled with optimizations, in the
+     * background, once any of their arities have been called this many times. Only applies
+     * to the LLVM IR codegen. */
+    bool tiered_compilation{};
+    u32 tier_up_threshold{ 1000 };
+    /* Fns are interpreted from their AST, rather than JIT compiled, until they've been called
+     * this many times. Fns which use C++ interop, or whose var is ^:jit, are always JIT
+     * compiled. */
+    bool interpret{};
+    /* Calls through each jit_function are counted, by fn name and arity, for
+     * jank.perf/fn-stats. With fn_timing, they're also timed, in cycles. */
+    bool fn_stats{};
+    bool fn_timing{};
+    u32 jit_threshold{ 100 };
+    /* When loading a file, runs of top-level fn defs are JIT compiled together, into one
+     * module, rather than one module per def. Has no effect with interpret. */
+    bool batch_jit{};
+    /* Macro expansions of forms read from files are kept in the binary cache dir, so that
+     * loading the same module from source again skips calling its macros. */
+    bool macroexpand_cache{};
+    /* Symbols read as data, which have no source meta, are interned, so equal symbols
+     * share one object. This saves memory when reading lots of data, but it means that
+     * identical? can't tell such symbols apart. */
+    bool intern_symbols{};
+    /* Each eval'd IR module gets its own resource tracker, and it's unloaded once none of
+     * the fns made by its code are reachable, such as after their var is redefined. Has
+     * no effect with tiered compilation, which keeps pointers into tier 0 code. */
+    bool reclaim_jit_code{};
+    /* The object code of eval'd IR modules is cached within the binary cache dir, so the
+     * same forms are never optimized or compiled again, even by another process. Has no
+     * effect with tiered compilation or reclaimed JIT code. See jit::object_cache. */
+    bool cache_eval_objects{};
+    /* Errors and failed macro expansions don't keep the return addresses of where they were
+     * thrown, so they're reported without a stack trace. For programs which throw a lot,
+     * as part of normal control flow. Each thread can also change this for itself. */
+    bool no_stack_traces{};
+    /* Modules are still analyzed one at a time, in dependency order, but this many object
+     * files can be emitted in the background while that happens. For the test command,
+     * this is how many tests run at once. */
+    u32 jobs{ 1 };
 
     /* Run command. */
     jtl::immutable_string target_file;
 
+    /* Test command. */
+    native_vector<jtl::immutable_string> test_modules;
+
     /* Compile command. */
     jtl::immutable_string target_module;
     jtl::immutable_string target_runtime{ "dynamic" };
     jtl::immutable_string output_filename{ "a.out" };
+    /* Modules are compiled with ThinLTO and only the ones the entrypoint module depends on
+     * are linked in. Unused code is dropped at link time, which means the resulting program
+     * can't JIT compile anything against it. See aot::processor::build_executable. */
+    bool whole_program{};
+    /* The program is instrumented to write an LLVM profile of what it runs. That's merged
+     * with llvm-profdata and given back with profile_use_file, so that optimizations like
+     * inlining and block layout can favor the hot paths. */
+    bool profile_generate{};
+    jtl::immutable_string profile_use_file;
 
     /* Compile-module command. */
     jtl::immutable_string output_module_filename;
@@ -109,6 +238,10 @@ namespace jank::util::cli
   /* Affects the global opts. */
   jtl::result<void, int> parse_opts(int const argc, char const **argv);
 
+  /* Finds the --gc-markers value in the raw args, without allocating, since this needs to
+   * happen before the GC is initialized. This returns 0 if it's not specified. */
+  u32 parse_gc_markers(int const argc, char const **argv);
+
   /* Takes the CLI args and puts 'em in a vector. */
   native_vector<jtl::immutable_string> parse_into_vector(int const argc, char const **argv);
 }
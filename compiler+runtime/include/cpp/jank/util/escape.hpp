@@ -2,6 +2,7 @@
 
 #include <jtl/immutable_string.hpp>
 #include <jtl/result.hpp>
+#include <jtl/string_builder.hpp>
 
 namespace jank::util
 {
@@ -13,4 +14,6 @@ namespace jank::util
   /* These provide normal escaping/unescaping, with no quoting. */
   jtl::result<jtl::immutable_string, unescape_error> unescape(jtl::immutable_string const &input);
   jtl::immutable_string escape(jtl::immutable_string const &input);
+  /* Escapes straight into the builder, for when the result is part of a larger string. */
+  void escape(jtl::immutable_string const &input, jtl::string_builder &sb);
 }
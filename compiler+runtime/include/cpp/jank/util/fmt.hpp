@@ -8,18 +8,28 @@ namespace jank::util
   void format_to(jtl::string_builder &sb, char const * const fmt);
 
   /* TODO: We can extern template all common usages here, if they show up in the trace. */
+  /* The text between arguments is appended a run at a time, rather than a char at a time,
+   * since most of what codegen formats is text. */
   template <typename T>
   void format_to(jtl::string_builder &sb, char const *&fmt, T &&arg)
   {
+    auto const start{ fmt };
     for(; *fmt != '\0'; ++fmt)
     {
       if(*fmt == '{' && *(fmt + 1) == '}')
       {
+        if(fmt != start)
+        {
+          sb(jtl::immutable_string_view{ start, fmt });
+        }
         sb(std::forward<T>(arg));
         fmt += 2;
         return;
       }
-      sb(*fmt);
+    }
+    if(fmt != start)
+    {
+      sb(jtl::immutable_string_view{ start, fmt });
     }
   }
 
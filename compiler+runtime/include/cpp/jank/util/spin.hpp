@@ -0,0 +1,15 @@
+#pragma once
+
+namespace jank::util
+{
+  /* Tells the CPU we're in a spin loop, which saves power and gives the core to its
+   * hyperthread sibling, rather than hammering the cache line we're waiting on. */
+  inline void spin_pause()
+  {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+  }
+}
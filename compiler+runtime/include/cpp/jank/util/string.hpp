@@ -3,6 +3,7 @@
 #include <string>
 
 #include <jtl/primitive.hpp>
+#include <jtl/immutable_string_view.hpp>
 
 namespace jtl
 {
@@ -18,4 +19,21 @@ namespace jank::util
   void capitalize(std::string &s);
   std::string ordinal_under_100(usize n);
   std::string number_to_ordinal(usize n);
+
+  /* These scan bytes a vector register at a time, where the CPU has them. They're the
+   * kernels for clojure.string, which text heavy code calls in tight loops. */
+
+  /* Gives the offset of the first needle at or after pos, or npos. */
+  usize find(jtl::immutable_string_view const &haystack,
+             jtl::immutable_string_view const &needle,
+             usize pos = 0);
+  /* Gives the offset of the first byte which isn't ASCII whitespace, or the size. */
+  usize find_non_space(jtl::immutable_string_view const &s);
+  /* Gives one past the last byte which isn't ASCII whitespace, or 0. */
+  usize rfind_non_space(jtl::immutable_string_view const &s);
+  /* Writes the converted input to the output, which must be at least as large. Only ASCII
+   * is converted, since anything else needs Unicode aware conversion. So these return false,
+   * with the output partly written, if there's any non-ASCII input. */
+  bool ascii_to_lowercase(jtl::immutable_string_view const &input, char *output);
+  bool ascii_to_uppercase(jtl::immutable_string_view const &input, char *output);
 }
@@ -20,6 +20,16 @@ namespace jank::util
   void print_exception(runtime::object_ref const e);
   void print_exception(jtl::immutable_string const &e);
   void print_exception(error_ref e);
+
+  /* Whether errors made on this thread keep a trace of where they came from. This starts
+   * out as the opposite of --no-stack-traces, but each thread can change it for itself,
+   * such as one which throws as a matter of course. */
+  bool capturing_stack_traces();
+  void set_capturing_stack_traces(bool capture);
+
+  /* The return addresses of the exception being handled, within a JANK_CATCH, if stack
+   * traces are being captured. They're not symbolized until they're printed. */
+  cpptrace::raw_trace const *current_exception_trace();
 }
 
 /* We use cpptrace to wrap our try/catch blocks so that we
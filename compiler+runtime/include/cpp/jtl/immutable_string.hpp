@@ -162,34 +162,7 @@ namespace jtl
 
     constexpr immutable_string(immutable_string const &s, size_type const pos, size_type count)
     {
-      auto const s_length(s.size());
-      if(s_length < pos) [[unlikely]]
-      {
-        throw std::runtime_error{ "position outside of string" };
-      }
-      else if(count == npos || s_length < pos + count)
-      {
-        count = s_length - pos;
-      }
-
-      if(count <= max_small_size)
-      {
-        init_small(s.data() + pos, count);
-      }
-      /* If the size difference between our substring and its original string is too great, it's
-       * not worth keeping the original string alive just to share the substring. In that case,
-       * we deep copy. This prevents relatively small (yet still categorically large) substrings
-       * from a large file keeping that whole file in memory as long as the substrings live. */
-      else if((s_length - count) > max_shared_difference)
-      {
-        init_large_owned(s.store.large.data + pos, count);
-      }
-      else
-      {
-        /* NOTE: Not necessarily null-terminated! */
-        const_cast<immutable_string &>(s).store.large.set_category(category::large_shared);
-        init_large_shared(s.store.large.data + pos, count);
-      }
+      init_substr(s, pos, count, false);
     }
 
     template <typename It>
@@ -482,6 +455,17 @@ namespace jtl
       return { *this, pos, count };
     }
 
+    /* Like substr, but a large substring always shares our memory, no matter how small it is
+     * next to us. This is for when the substrings will together cover most of this string,
+     * like the pieces of a split, so keeping all of it alive costs nothing extra. */
+    constexpr immutable_string
+    shared_substr(size_type const pos = 0, size_type const count = npos) const
+    {
+      immutable_string ret;
+      ret.init_substr(*this, pos, count, true);
+      return ret;
+    }
+
     /*** Mutations. ***/
     constexpr immutable_string &operator=(immutable_string const &rhs)
     {
@@ -652,13 +636,29 @@ namespace jtl
         return store.hash;
       }
 
-      /* https://github.com/openjdk/jdk/blob/7e30130e354ebfed14617effd2a517ab2f4140a5/src/java.base/share/classes/java/lang/StringLatin1.java#L194 */
+      /* The hash is built up locally, so that another thread reading this string can only
+       * ever see no hash or the finished one, never a partial one.
+       *
+       * https://github.com/openjdk/jdk/blob/7e30130e354ebfed14617effd2a517ab2f4140a5/src/java.base/share/classes/java/lang/StringLatin1.java#L194 */
+      uhash hash{};
       auto const ptr(data());
-      for(size_type i{}; i != size(); ++i)
+      auto const length(size());
+      size_type i{};
+
+      /* Each step of the usual loop waits on the last one's multiply. Taking four bytes at
+       * a time, with the powers of 31 worked out up front, gives the same hash, since this
+       * all wraps around the same way, but only one step in four waits on the last. */
+      for(; i + 4 <= length; i += 4)
       {
-        store.hash = (31 * store.hash) + (ptr[i] & 0xff);
+        hash = (923521 * hash) + (29791 * static_cast<uhash>(ptr[i] & 0xff))
+          + (961 * static_cast<uhash>(ptr[i + 1] & 0xff))
+          + (31 * static_cast<uhash>(ptr[i + 2] & 0xff)) + static_cast<uhash>(ptr[i + 3] & 0xff);
       }
-      return store.hash = jank::hash::integer(store.hash);
+      for(; i != length; ++i)
+      {
+        hash = (31 * hash) + (ptr[i] & 0xff);
+      }
+      return store.hash = jank::hash::integer(hash);
     }
 
     /*** Conversions. ***/
@@ -692,6 +692,8 @@ namespace jtl
     static constexpr u8 last_char_index{ sizeof(large_storage) - 1 };
     static constexpr u8 max_small_size{ last_char_index / sizeof(value_type) };
     static constexpr u16 max_shared_difference{ 512 };
+    /* Substrings which are at least 1/max_shared_ratio of their original string share it. */
+    static constexpr u8 max_shared_ratio{ 8 };
     /* The size is shifted to/from storage, to account for the 2 extra data bits. */
     static constexpr u8 small_shift{ is_little_endian ? 0 : 2 };
     static constexpr u8 category_extraction_mask{ is_little_endian ? 0b11000000 : 0b00000011 };
@@ -722,8 +724,7 @@ namespace jtl
       /* NOTE: No performance difference between if/switch here. */
       if(get_category() == category::large_owned)
       {
-        /* NOLINTNEXTLINE(cppcoreguidelines-no-malloc) */
-        free(store.large.data);
+        GC_FREE(store.large.data);
       }
     }
 
@@ -822,6 +823,43 @@ namespace jtl
       set_small_size(size);
     }
 
+    constexpr void init_substr(immutable_string const &s,
+                               size_type const pos,
+                               size_type count,
+                               bool const always_share)
+    {
+      auto const s_length(s.size());
+      if(s_length < pos) [[unlikely]]
+      {
+        throw std::runtime_error{ "position outside of string" };
+      }
+      else if(count == npos || s_length < pos + count)
+      {
+        count = s_length - pos;
+      }
+
+      if(count <= max_small_size)
+      {
+        init_small(s.data() + pos, count);
+      }
+      /* If our substring is tiny next to its original string, it's not worth keeping the
+       * original string alive just to share the substring. In that case, we deep copy. This
+       * prevents a few small (yet still categorically large) substrings from a large file
+       * keeping that whole file in memory as long as the substrings live. Bigger slices of a
+       * large file share it, though, so we don't double its memory by slicing it up. */
+      else if(!always_share && (s_length - count) > max_shared_difference
+              && count < s_length / max_shared_ratio)
+      {
+        init_large_owned(s.store.large.data + pos, count);
+      }
+      else
+      {
+        /* NOTE: Not necessarily null-terminated! */
+        const_cast<immutable_string &>(s).store.large.set_category(category::large_shared);
+        init_large_shared(s.store.large.data + pos, count);
+      }
+    }
+
     [[gnu::always_inline, gnu::flatten, gnu::hot]]
     constexpr void init_large_shared(const_pointer_type const data, size_type const size) noexcept
     {
@@ -832,14 +870,20 @@ namespace jtl
       store.large.set_category(category::large_shared);
     }
 
+    /* Strings never hold pointers, so their bytes are atomic GC memory, which the GC doesn't
+     * need to scan. The extra byte is for the null terminator. */
+    [[gnu::malloc, gnu::returns_nonnull]]
+    static pointer_type allocate(size_type const size) noexcept
+    {
+      return std::assume_aligned<sizeof(pointer_type)>(
+        static_cast<pointer_type>(GC_MALLOC_ATOMIC(size + 1)));
+    }
+
     [[gnu::always_inline, gnu::flatten, gnu::hot]]
     constexpr void init_large_owned(const_pointer_type const data, size_type const size) noexcept
     {
       jank_debug_assert(max_small_size < size);
-      /* TODO: Apply gnu::malloc to this fn. */
-      store.large.data
-        /* NOLINTNEXTLINE(cppcoreguidelines-no-malloc) */
-        = std::assume_aligned<sizeof(pointer_type)>(static_cast<char *>(malloc(size + 1)));
+      store.large.data = allocate(size);
       traits_type::copy(store.large.data, data, size);
       store.large.data[size] = 0;
       store.large.size = size;
@@ -847,12 +891,10 @@ namespace jtl
     }
 
     [[gnu::always_inline, gnu::flatten, gnu::hot]]
-    constexpr void init_large_fill(value_type const fill, u8 const size) noexcept
+    constexpr void init_large_fill(value_type const fill, size_type const size) noexcept
     {
       jank_debug_assert(max_small_size < size);
-      store.large.data
-        /* NOLINTNEXTLINE(cppcoreguidelines-no-malloc) */
-        = std::assume_aligned<sizeof(pointer_type)>(static_cast<char *>(malloc(size + 1)));
+      store.large.data = allocate(size);
       traits_type::assign(store.large.data, size, fill);
       store.large.data[size] = 0;
       store.large.size = size;
@@ -867,9 +909,7 @@ namespace jtl
     {
       auto const size(lhs_size + rhs_size);
       jank_debug_assert(max_small_size < size);
-      store.large.data
-        /* NOLINTNEXTLINE(cppcoreguidelines-no-malloc) */
-        = std::assume_aligned<sizeof(pointer_type)>(static_cast<char *>(malloc(size + 1)));
+      store.large.data = allocate(size);
       traits_type::copy(store.large.data, lhs, lhs_size);
       traits_type::copy(store.large.data + lhs_size, rhs, rhs_size);
       store.large.data[size] = 0;
@@ -883,9 +923,7 @@ namespace jtl
     {
       auto const size(std::distance(begin, end));
       jank_debug_assert(max_small_size < size);
-      store.large.data
-        /* NOLINTNEXTLINE(cppcoreguidelines-no-malloc) */
-        = std::assume_aligned<sizeof(pointer_type)>(static_cast<char *>(malloc(size + 1)));
+      store.large.data = allocate(size);
       std::copy(begin, end, store.large.data);
       store.large.data[size] = 0;
       store.large.size = size;
@@ -41,6 +41,7 @@ namespace jtl
     string_builder &operator()(char const *d) &;
     string_builder &operator()(std::string const &d) &;
     string_builder &operator()(jtl::immutable_string const &d) &;
+    string_builder &operator()(jtl::immutable_string_view const &d) &;
     string_builder &operator()(terminal_style s) &;
 
     template <template <typename> typename V, typename T>
@@ -77,6 +78,7 @@ namespace jtl
     void push_back(char const *d) &;
     void push_back(std::string const &d) &;
     void push_back(jtl::immutable_string const &d) &;
+    void push_back(jtl::immutable_string_view const &d) &;
 
     void reserve(usize capacity);
     value_type *data() const;
@@ -1,3 +1,9 @@
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
 #include <clojure/core_native.hpp>
 #include <jank/runtime/convert/function.hpp>
 #include <jank/runtime/core.hpp>
@@ -7,6 +13,11 @@
 #include <jank/runtime/behavior/callable.hpp>
 #include <jank/runtime/visit.hpp>
 #include <jank/runtime/sequence_range.hpp>
+#include <jank/runtime/obj/array_chunk.hpp>
+#include <jank/runtime/obj/opaque_box.hpp>
+#include <jank/runtime/io.hpp>
+#include <jank/read/parse.hpp>
+#include <jank/read/stream.hpp>
 #include <jank/util/fmt/print.hpp>
 
 namespace clojure::core_native
@@ -170,6 +181,43 @@ namespace clojure::core_native
     return try_object<obj::multi_function>(multifn)->prefer_table;
   }
 
+  object_ref is_protocol(object_ref const o)
+  {
+    return make_box(o->type == object_type::protocol);
+  }
+
+  object_ref protocol(object_ref const name, object_ref const method_names)
+  {
+    return obj::protocol::create(name, method_names);
+  }
+
+  object_ref protocol_method(object_ref const protocol, object_ref const name)
+  {
+    auto const method(try_object<obj::protocol>(protocol)->find_method(name));
+    if(method.is_nil())
+    {
+      throw std::runtime_error{ util::format("{} is not a method of {}",
+                                             runtime::to_code_string(name),
+                                             runtime::to_code_string(protocol)) };
+    }
+    return method;
+  }
+
+  object_ref extend(object_ref const protocol, object_ref const type, object_ref const impls)
+  {
+    return try_object<obj::protocol>(protocol)->extend(type, impls);
+  }
+
+  object_ref extends(object_ref const protocol, object_ref const type)
+  {
+    return make_box(try_object<obj::protocol>(protocol)->extends(type));
+  }
+
+  object_ref satisfies(object_ref const protocol, object_ref const o)
+  {
+    return make_box(try_object<obj::protocol>(protocol)->satisfies(o));
+  }
+
   object_ref sleep(object_ref const ms)
   {
     std::this_thread::sleep_for(std::chrono::milliseconds(to_int(ms)));
@@ -236,6 +284,19 @@ namespace clojure::core_native
     return found;
   }
 
+  object_ref completions(object_ref const ns, object_ref const prefix, object_ref const max)
+  {
+    auto const found(try_object<runtime::ns>(ns)->completions(runtime::to_string(prefix),
+                                                              static_cast<usize>(to_int(max))));
+    runtime::detail::native_transient_vector ret;
+    for(auto const &[name, o] : found)
+    {
+      ret.push_back(
+        make_box<obj::persistent_vector>(std::in_place, make_box<obj::persistent_string>(name), o));
+    }
+    return make_box<obj::persistent_vector>(ret.persistent());
+  }
+
   object_ref alias(object_ref const current_ns, object_ref const remote_ns, object_ref const alias)
   {
     try_object<ns>(current_ns)
@@ -270,6 +331,17 @@ namespace clojure::core_native
     return jank_nil();
   }
 
+  object_ref
+  defer_segment(object_ref const current_ns, object_ref const module, object_ref const syms)
+  {
+    native_vector<obj::symbol_ref> segment_syms;
+    for_each_item(syms, [&](object_ref const sym) {
+      segment_syms.emplace_back(try_object<obj::symbol>(sym));
+    });
+    try_object<ns>(current_ns)->defer_segment(runtime::to_string(module), segment_syms);
+    return jank_nil();
+  }
+
   object_ref compile(object_ref const path)
   {
     __rt_ctx->compile_module(runtime::to_string(path)).expect_ok();
@@ -292,6 +364,264 @@ namespace clojure::core_native
     return __rt_ctx->read_string(runtime::to_string(str));
   }
 
+  object_ref read_data(object_ref const str)
+  {
+    return read::parse::read_data(runtime::to_string(str)).expect_ok();
+  }
+
+  object_ref read_all_data(object_ref const str)
+  {
+    return read::parse::read_all_data(runtime::to_string(str)).expect_ok();
+  }
+
+  static constexpr auto stream_reader_type{ "jank::read::stream_reader *" };
+
+  /* A nil stream, such as the default *in*, reads from stdin. */
+  static read::stream_reader &to_stream_reader(object_ref const o)
+  {
+    if(o == jank_nil())
+    {
+      static auto const stdin_reader{ new(GC) read::stream_reader{ STDIN_FILENO, false } };
+      return *stdin_reader;
+    }
+
+    auto const box{ try_object<obj::opaque_box>(o) };
+    if(box->canonical_type != stream_reader_type)
+    {
+      throw std::runtime_error{ util::format("{} is not a stream reader",
+                                             runtime::to_code_string(o)) };
+    }
+    return *static_cast<read::stream_reader *>(box->data.data);
+  }
+
+  object_ref stream_reader(object_ref const source)
+  {
+    if(source->type == object_type::integer)
+    {
+      auto const fd{ static_cast<int>(to_int(source)) };
+      return make_box<obj::opaque_box>(new(GC) read::stream_reader{ fd, false },
+                                       stream_reader_type);
+    }
+
+    auto const path(runtime::to_string(source));
+    auto const fd{ ::open(path.c_str(), O_RDONLY | O_CLOEXEC) };
+    if(fd < 0)
+    {
+      throw std::runtime_error{
+        util::format("Unable to open '{}': {}", path, std::strerror(errno))
+      };
+    }
+    return make_box<obj::opaque_box>(new(GC) read::stream_reader{ fd, true }, stream_reader_type);
+  }
+
+  object_ref close_stream_reader(object_ref const reader)
+  {
+    to_stream_reader(reader).close();
+    return jank_nil();
+  }
+
+  object_ref
+  read_stream(object_ref const reader, object_ref const eof_error, object_ref const eof_value)
+  {
+    auto const form(to_stream_reader(reader).next().expect_ok());
+    if(form.is_some())
+    {
+      return form.unwrap();
+    }
+    else if(truthy(eof_error))
+    {
+      throw std::runtime_error{ "EOF while reading" };
+    }
+    return eof_value;
+  }
+
+  /* Each form is evaluated before the next is read, so a form can depend on what was
+   * defined before it, like with a file. */
+  object_ref load_reader(object_ref const reader)
+  {
+    auto &r(to_stream_reader(reader));
+    object_ref ret{ jank_nil() };
+    while(true)
+    {
+      auto const form(r.next().expect_ok());
+      if(form.is_none())
+      {
+        return ret;
+      }
+      ret = __rt_ctx->eval(form.unwrap());
+    }
+  }
+
+  object_ref slurp(object_ref const f)
+  {
+    return make_box(runtime::io::slurp(runtime::to_string(f)).expect_ok());
+  }
+
+  object_ref spit(object_ref const f, object_ref const content, object_ref const append)
+  {
+    runtime::io::spit(runtime::to_string(f), runtime::to_string(content), truthy(append))
+      .expect_ok();
+    return jank_nil();
+  }
+
+  static constexpr auto buffered_reader_type{ "jank::runtime::io::buffered_reader *" };
+  static constexpr auto buffered_writer_type{ "jank::runtime::io::buffered_writer *" };
+
+  static usize to_buffer_size(object_ref const buffer_size)
+  {
+    if(buffer_size == jank_nil())
+    {
+      return runtime::io::default_buffer_size;
+    }
+
+    auto const size(to_int(buffer_size));
+    if(size < 1)
+    {
+      throw std::runtime_error{ util::format("Invalid buffer size {}", size) };
+    }
+    return static_cast<usize>(size);
+  }
+
+  /* Like with the stream reader, a nil reader, such as the default *in*, reads from
+   * stdin. */
+  static runtime::io::buffered_reader &to_buffered_reader(object_ref const o)
+  {
+    if(o == jank_nil())
+    {
+      static auto const stdin_reader{ new(GC) runtime::io::buffered_reader{
+        STDIN_FILENO,
+        false,
+        runtime::io::default_buffer_size } };
+      return *stdin_reader;
+    }
+
+    auto const box{ try_object<obj::opaque_box>(o) };
+    if(box->canonical_type != buffered_reader_type)
+    {
+      throw std::runtime_error{ util::format("{} is not a reader", runtime::to_code_string(o)) };
+    }
+    return *static_cast<runtime::io::buffered_reader *>(box->data.data);
+  }
+
+  static runtime::io::buffered_writer &to_buffered_writer(object_ref const o)
+  {
+    auto const box{ try_object<obj::opaque_box>(o) };
+    if(box->canonical_type != buffered_writer_type)
+    {
+      throw std::runtime_error{ util::format("{} is not a writer", runtime::to_code_string(o)) };
+    }
+    return *static_cast<runtime::io::buffered_writer *>(box->data.data);
+  }
+
+  object_ref reader(object_ref const f, object_ref const buffer_size)
+  {
+    auto const size(to_buffer_size(buffer_size));
+    if(f->type == object_type::integer)
+    {
+      auto const fd{ static_cast<int>(to_int(f)) };
+      return make_box<obj::opaque_box>(new(GC) runtime::io::buffered_reader{ fd, false, size },
+                                       buffered_reader_type);
+    }
+
+    auto const fd(runtime::io::open_file(runtime::to_string(f), O_RDONLY).expect_ok());
+    return make_box<obj::opaque_box>(new(GC) runtime::io::buffered_reader{ fd, true, size },
+                                     buffered_reader_type);
+  }
+
+  object_ref writer(object_ref const f, object_ref const append, object_ref const buffer_size)
+  {
+    auto const size(to_buffer_size(buffer_size));
+    if(f->type == object_type::integer)
+    {
+      auto const fd{ static_cast<int>(to_int(f)) };
+      return make_box<obj::opaque_box>(new(GC) runtime::io::buffered_writer{ fd, false, size },
+                                       buffered_writer_type);
+    }
+
+    auto const flags{ O_WRONLY | O_CREAT | (truthy(append) ? O_APPEND : O_TRUNC) };
+    auto const fd(runtime::io::open_file(runtime::to_string(f), flags).expect_ok());
+    return make_box<obj::opaque_box>(new(GC) runtime::io::buffered_writer{ fd, true, size },
+                                     buffered_writer_type);
+  }
+
+  object_ref read_line(object_ref const reader)
+  {
+    auto const line(to_buffered_reader(reader).read_line().expect_ok());
+    if(line.is_none())
+    {
+      return jank_nil();
+    }
+    return make_box(line.unwrap());
+  }
+
+  /* Gives up to max lines in one chunk, so line-seq only needs one lazy step per chunk,
+   * rather than per line. */
+  object_ref read_lines(object_ref const reader, object_ref const max)
+  {
+    auto &r(to_buffered_reader(reader));
+    auto const max_lines{ static_cast<usize>(std::max<i64>(to_int(max), 1)) };
+
+    native_vector<object_ref> lines;
+    lines.reserve(max_lines);
+    while(lines.size() < max_lines)
+    {
+      auto const line(r.read_line().expect_ok());
+      if(line.is_none())
+      {
+        break;
+      }
+      lines.emplace_back(make_box(line.unwrap()));
+    }
+
+    if(lines.empty())
+    {
+      return jank_nil();
+    }
+    return make_box<obj::array_chunk>(std::move(lines), 0);
+  }
+
+  object_ref write(object_ref const writer, object_ref const s)
+  {
+    auto const str(runtime::to_string(s));
+    to_buffered_writer(writer).write(str).expect_ok();
+    return jank_nil();
+  }
+
+  object_ref flush_writer(object_ref const writer)
+  {
+    to_buffered_writer(writer).flush().expect_ok();
+    return jank_nil();
+  }
+
+  /* Closes anything which can be opened through clojure.core, which is what with-open
+   * needs. */
+  object_ref close(object_ref const o)
+  {
+    if(o == jank_nil())
+    {
+      return jank_nil();
+    }
+
+    auto const box{ try_object<obj::opaque_box>(o) };
+    if(box->canonical_type == buffered_reader_type)
+    {
+      to_buffered_reader(o).close();
+    }
+    else if(box->canonical_type == buffered_writer_type)
+    {
+      to_buffered_writer(o).close().expect_ok();
+    }
+    else if(box->canonical_type == stream_reader_type)
+    {
+      to_stream_reader(o).close();
+    }
+    else
+    {
+      throw std::runtime_error{ util::format("Unable to close {}", runtime::to_code_string(o)) };
+    }
+    return jank_nil();
+  }
+
   object_ref jank_version()
   {
     return make_box(JANK_VERSION);
@@ -306,15 +636,23 @@ extern "C" void jank_load_clojure_core_native()
 
   auto const ns(__rt_ctx->intern_ns("clojure.core-native"));
 
-  auto const intern_val([=](jtl::immutable_string const &name, auto const val) {
-    ns->intern_var(name)->bind_root(convert<decltype(val)>::into_object(val));
+  /* Everything is gathered up first, so the vars can all be interned in one go. */
+  native_vector<obj::symbol_ref> names;
+  native_vector<object_ref> roots;
+  auto const name_kw(__rt_ctx->intern_keyword("name").expect_ok());
+  auto const current_ns_name(__rt_ctx->current_ns()->to_string());
+
+  auto const intern_val([&](jtl::immutable_string const &name, auto const val) {
+    names.emplace_back(make_box<obj::symbol>("", name));
+    roots.emplace_back(convert<decltype(val)>::into_object(val));
   });
-  auto const intern_fn([=](jtl::immutable_string const &name, auto const fn) {
-    ns->intern_var(name)->bind_root(
+  auto const intern_fn([&](jtl::immutable_string const &name, auto const fn) {
+    names.emplace_back(make_box<obj::symbol>("", name));
+    roots.emplace_back(
       make_box<obj::native_function_wrapper>(convert_function(fn))
-        ->with_meta(obj::persistent_hash_map::create_unique(std::make_pair(
-          __rt_ctx->intern_keyword("name").expect_ok(),
-          make_box(obj::symbol{ __rt_ctx->current_ns()->to_string(), name }.to_string())))));
+        ->with_meta(obj::persistent_hash_map::create_unique(
+          std::make_pair(name_kw,
+                         make_box(obj::symbol{ current_ns_name, name }.to_string())))));
   });
 
   intern_fn("type", &type);
@@ -497,15 +835,24 @@ extern "C" void jank_load_clojure_core_native()
   intern_fn("ns-map", &core_native::ns_map);
   intern_fn("var-ns", &core_native::var_ns);
   intern_fn("ns-resolve", &core_native::ns_resolve);
+  intern_fn("completions", &core_native::completions);
   intern_fn("alias", &core_native::alias);
   intern_fn("ns-unalias", &core_native::ns_unalias);
   intern_fn("ns-unmap", &core_native::ns_unmap);
   intern_fn("refer", &core_native::refer);
   intern_fn("load-module", &core_native::load_module);
+  intern_fn("defer-segment", &core_native::defer_segment);
   intern_fn("compile", &core_native::compile);
   intern_fn("eval", &core_native::eval);
   intern_fn("hash-unordered-coll", &core_native::hash_unordered);
   intern_fn("read-string", &core_native::read_string);
+  intern_fn("read-data", &core_native::read_data);
+  intern_fn("read-all-data", &core_native::read_all_data);
+  intern_fn("stream-reader", &core_native::stream_reader);
+  intern_fn("close-stream-reader", &core_native::close_stream_reader);
+  intern_fn("read-stream", &core_native::read_stream);
+  intern_fn("load-reader", &core_native::load_reader);
+  intern_fn("close", &core_native::close);
   intern_fn("jank-version", &core_native::jank_version);
   intern_fn("parse-long", &parse_long);
   intern_fn("parse-double", &parse_double);
@@ -531,4 +878,10 @@ extern "C" void jank_load_clojure_core_native()
   intern_fn("tan", static_cast<f64 (*)(object_ref const)>(&runtime::tan));
   intern_fn("abs", static_cast<object_ref (*)(object_ref const)>(&runtime::abs));
   intern_fn("pow", static_cast<f64 (*)(object_ref const, object_ref const)>(&runtime::pow));
+
+  auto const vars(ns->intern_vars(names));
+  for(usize i{}; i < vars.size(); ++i)
+  {
+    vars[i]->bind_root(roots[i]);
+  }
 }
@@ -0,0 +1,162 @@
+#include <immer/algorithm.hpp>
+
+#include <clojure/set_native.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/obj/persistent_hash_set.hpp>
+#include <jank/runtime/rtti.hpp>
+
+namespace clojure::set_native
+{
+  using namespace jank;
+  using namespace jank::runtime;
+
+  /* Once one set is this many times smaller than the other, looking up each of its
+   * elements in the other is cheaper than walking both. */
+  static constexpr usize lookup_ratio{ 16 };
+
+  static bool are_hash_sets(object_ref const l, object_ref const r)
+  {
+    return l->type == object_type::persistent_hash_set
+      && r->type == object_type::persistent_hash_set;
+  }
+
+  static void ignore(object_ref const)
+  {
+  }
+
+  static void ignore_change(object_ref const, object_ref const)
+  {
+  }
+
+  /* Like conj, this keeps the meta of the larger set. */
+  object_ref union_(object_ref const l, object_ref const r)
+  {
+    if(!are_hash_sets(l, r))
+    {
+      return jank_nil();
+    }
+
+    auto large(expect_object<obj::persistent_hash_set>(l));
+    auto small(expect_object<obj::persistent_hash_set>(r));
+    if(large->count() < small->count())
+    {
+      std::swap(large, small);
+    }
+
+    auto transient(large->data.transient());
+    auto const add([&](object_ref const e) { transient.insert(e); });
+    if(small->count() * lookup_ratio < large->count())
+    {
+      for(auto const e : small->data)
+      {
+        add(e);
+      }
+    }
+    else
+    {
+      /* Added are those only in the small set. */
+      immer::diff(large->data, small->data, add, ignore, ignore_change);
+    }
+
+    if(transient.size() == large->count())
+    {
+      return large;
+    }
+    return make_box<obj::persistent_hash_set>(large->meta, transient.persistent());
+  }
+
+  /* Like disj, this keeps the meta of the smaller set. */
+  object_ref intersection(object_ref const l, object_ref const r)
+  {
+    if(!are_hash_sets(l, r))
+    {
+      return jank_nil();
+    }
+
+    auto small(expect_object<obj::persistent_hash_set>(l));
+    auto large(expect_object<obj::persistent_hash_set>(r));
+    if(large->count() < small->count())
+    {
+      std::swap(large, small);
+    }
+
+    auto transient(small->data.transient());
+    if(small->count() * lookup_ratio < large->count())
+    {
+      for(auto const e : small->data)
+      {
+        if(!large->data.count(e))
+        {
+          transient.erase(e);
+        }
+      }
+    }
+    else
+    {
+      /* Removed are those only in the small set. */
+      immer::diff(small->data,
+                  large->data,
+                  ignore,
+                  [&](object_ref const e) { transient.erase(e); },
+                  ignore_change);
+    }
+
+    if(transient.size() == small->count())
+    {
+      return small;
+    }
+    return make_box<obj::persistent_hash_set>(small->meta, transient.persistent());
+  }
+
+  /* This keeps the meta of l. */
+  object_ref difference(object_ref const l, object_ref const r)
+  {
+    if(!are_hash_sets(l, r))
+    {
+      return jank_nil();
+    }
+
+    auto const typed_l(expect_object<obj::persistent_hash_set>(l));
+    auto const typed_r(expect_object<obj::persistent_hash_set>(r));
+    auto const done([&](runtime::detail::native_transient_hash_set &transient) -> object_ref {
+      if(transient.size() == typed_l->count())
+      {
+        return typed_l;
+      }
+      return make_box<obj::persistent_hash_set>(typed_l->meta, transient.persistent());
+    });
+
+    if(typed_r->count() * lookup_ratio < typed_l->count())
+    {
+      auto transient(typed_l->data.transient());
+      for(auto const e : typed_r->data)
+      {
+        transient.erase(e);
+      }
+      return done(transient);
+    }
+    if(typed_l->count() * lookup_ratio < typed_r->count())
+    {
+      auto transient(typed_l->data.transient());
+      for(auto const e : typed_l->data)
+      {
+        if(typed_r->data.count(e))
+        {
+          transient.erase(e);
+        }
+      }
+      return done(transient);
+    }
+
+    /* The diff doesn't give what's in both, only what's in l alone, so that's what the
+     * result is built from. */
+    runtime::detail::native_transient_hash_set transient;
+    immer::diff(
+      typed_l->data,
+      typed_r->data,
+      ignore,
+      [&](object_ref const e) { transient.insert(e); },
+      ignore_change);
+    return done(transient);
+  }
+}
@@ -1,9 +1,14 @@
+#include <algorithm>
+#include <cctype>
+#include <string_view>
+
 #include <clojure/string_native.hpp>
 #include <jank/runtime/core.hpp>
 #include <jank/runtime/obj/jit_function.hpp>
 #include <jank/runtime/obj/native_function_wrapper.hpp>
 #include <jank/runtime/obj/persistent_vector.hpp>
 #include <jank/runtime/obj/re_pattern.hpp>
+#include <jank/runtime/regex.hpp>
 #include <jank/runtime/rtti.hpp>
 #include <jank/util/fmt.hpp>
 #include <jank/util/string.hpp>
@@ -29,10 +34,26 @@ namespace clojure::string_native
     return make_box<obj::persistent_string>(jtl::immutable_string{ s_str.rbegin(), s_str.rend() });
   }
 
-  object_ref lower_case(object_ref const s)
+  /* Most strings are plain ASCII, which we can convert a vector register at a time. Anything
+   * else goes through the locale aware conversion. */
+  static object_ref convert_case(object_ref const s, bool const lower)
   {
     auto const s_str(runtime::to_string(s));
-    return make_box(util::to_lowercase(s_str));
+
+    jtl::string_builder buff{ s_str.size() + 1 };
+    if(lower ? util::ascii_to_lowercase(s_str, buff.data())
+             : util::ascii_to_uppercase(s_str, buff.data()))
+    {
+      buff.pos = s_str.size();
+      return make_box(buff.release());
+    }
+
+    return make_box(lower ? util::to_lowercase(s_str) : util::to_uppercase(s_str));
+  }
+
+  object_ref lower_case(object_ref const s)
+  {
+    return convert_case(s, true);
   }
 
   object_ref starts_with(object_ref const s, object_ref const substr)
@@ -53,113 +74,161 @@ namespace clojure::string_native
   {
     auto const s_str(runtime::to_string(s));
     auto const substr_str(runtime::to_string(substr));
-    return make_box(s_str.contains(substr_str));
+    return make_box(util::find(s_str, substr_str) != jtl::immutable_string::npos);
   }
 
   object_ref upper_case(object_ref const s)
   {
-    auto const s_str(runtime::to_string(s));
-    return make_box(util::to_uppercase(s_str));
+    return convert_case(s, false);
   }
 
-  static jtl::immutable_string replace_first(jtl::immutable_string const &s,
-                                             jtl::immutable_string const &match,
-                                             jtl::immutable_string const &replacement)
+  static jtl::immutable_string replace(jtl::immutable_string const &s,
+                                       jtl::immutable_string const &match,
+                                       jtl::immutable_string const &replacement,
+                                       bool const all)
   {
-    auto const i(s.find(match));
-
-    if(i == jtl::immutable_string::npos)
+    auto i(util::find(s, match));
+    if(i == jtl::immutable_string::npos || match.empty())
     {
       return s;
     }
 
-    auto const s_size(s.size());
-    auto const match_size(match.size());
-    auto const replacement_size(replacement.size());
-
-    jtl::string_builder buff{ s_size - match_size + replacement_size };
-    buff(s.substr(0, i));
-    buff(replacement);
-
-    auto const rest_i(i + match_size);
+    jtl::string_builder buff{ s.size() - match.size() + replacement.size() };
+    usize rest_i{};
+    while(i != jtl::immutable_string::npos)
+    {
+      buff(s.view().substr(rest_i, i - rest_i));
+      buff(replacement);
+      rest_i = i + match.size();
+      if(!all)
+      {
+        break;
+      }
+      i = util::find(s, match, rest_i);
+    }
 
-    if(rest_i < s_size)
+    if(rest_i < s.size())
     {
-      buff(s.substr(rest_i));
+      buff(s.view().substr(rest_i));
     }
 
     return buff.release();
   }
 
-  static jtl::immutable_string replace_first(jtl::immutable_string const &s,
-                                             std::regex const &match,
-                                             jtl::immutable_string const &replacement)
+  /* Appends the replacement with each $n swapped for what the nth group matched, like
+   * Java's Matcher.appendReplacement. A backslash makes the next character literal. */
+  static void append_replacement(jtl::string_builder &buff,
+                                 jtl::immutable_string const &s,
+                                 native_vector<regex::span> const &groups,
+                                 jtl::immutable_string const &replacement)
   {
-    auto const out_str(std::regex_replace(s.c_str(),
-                                          match,
-                                          replacement.c_str(),
-                                          std::regex_constants::format_first_only));
+    auto const is_digit([&](usize const i) {
+      return i < replacement.size() && std::isdigit(static_cast<unsigned char>(replacement[i]));
+    });
+
+    for(usize i{}; i < replacement.size(); ++i)
+    {
+      auto const c(replacement[i]);
+      if(c == '\\' && i + 1 < replacement.size())
+      {
+        buff(replacement[++i]);
+      }
+      else if(c == '$' && is_digit(i + 1))
+      {
+        /* Like Java, we take as many digits as still name a group. */
+        auto group{ static_cast<usize>(replacement[++i] - '0') };
+        while(is_digit(i + 1))
+        {
+          auto const next{ group * 10 + static_cast<usize>(replacement[i + 1] - '0') };
+          if(next >= groups.size())
+          {
+            break;
+          }
+          group = next;
+          ++i;
+        }
 
-    return jtl::immutable_string{ out_str.c_str() };
+        if(group >= groups.size())
+        {
+          throw std::runtime_error{ util::format("No group {} in the pattern", group) };
+        }
+        if(groups[group].matched)
+        {
+          buff(s.view().substr(groups[group].offset, groups[group].size));
+        }
+      }
+      else
+      {
+        buff(c);
+      }
+    }
   }
 
-  static jtl::immutable_string replace_first(jtl::immutable_string const &s,
-                                             std::regex const &match,
-                                             object_ref const replacement)
+  static jtl::immutable_string replace(jtl::immutable_string const &s,
+                                       regex::program const &match,
+                                       object_ref const replacement,
+                                       bool const all)
   {
-    std::smatch match_results{};
-    std::string const search_str{ s.c_str() };
-    std::regex_search(search_str, match_results, match);
-
-    if(match_results.empty())
+    native_vector<regex::span> groups;
+    if(!regex::search(match, s, 0, regex::anchor::none, groups))
     {
       return s;
     }
 
-    auto const i(match_results.position(0));
-
-    jtl::string_builder buff;
-    buff(s.substr(0, i));
-
-    auto const group(smatch_to_vector(match_results));
-    auto const replacement_value(dynamic_call(replacement, group));
-    buff(try_object<obj::persistent_string>(replacement_value)->data);
-
-    auto const rest_i(i + match_results[0].str().size());
+    auto const is_string(replacement->type == object_type::persistent_string);
+    jtl::string_builder buff{ s.size() };
+    usize rest_i{};
+    usize search_i{};
+    do
+    {
+      auto const &whole(groups[0]);
+      buff(s.view().substr(rest_i, whole.offset - rest_i));
+      if(is_string)
+      {
+        append_replacement(buff,
+                           s,
+                           groups,
+                           expect_object<obj::persistent_string>(replacement)->data);
+      }
+      else
+      {
+        auto const replacement_value(dynamic_call(replacement, regex_groups(s, groups)));
+        buff(try_object<obj::persistent_string>(replacement_value)->data);
+      }
+      rest_i = whole.offset + whole.size;
+      search_i = regex::next_start(s, whole);
+    } while(all && search_i <= s.size()
+            && regex::search(match, s, search_i, regex::anchor::none, groups));
 
     if(rest_i < s.size())
     {
-      buff(s.substr(rest_i));
+      buff(s.view().substr(rest_i));
     }
 
     return buff.release();
   }
 
-  static jtl::immutable_string replace_first(jtl::immutable_string const &s,
-                                             object_ref const match,
-                                             object_ref const replacement)
+  static jtl::immutable_string replace(jtl::immutable_string const &s,
+                                       object_ref const match,
+                                       object_ref const replacement,
+                                       bool const all)
   {
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wswitch-enum"
     switch(match->type)
     {
       case object_type::character:
-        return replace_first(s,
-                             try_object<obj::character>(match)->data,
-                             try_object<obj::character>(replacement)->data);
+        return replace(s,
+                       try_object<obj::character>(match)->data,
+                       try_object<obj::character>(replacement)->data,
+                       all);
       case object_type::persistent_string:
-        return replace_first(s,
-                             try_object<obj::persistent_string>(match)->data,
-                             try_object<obj::persistent_string>(replacement)->data);
+        return replace(s,
+                       try_object<obj::persistent_string>(match)->data,
+                       try_object<obj::persistent_string>(replacement)->data,
+                       all);
       case object_type::re_pattern:
-        if(replacement->type == object_type::persistent_string)
-        {
-          return replace_first(s,
-                               try_object<obj::re_pattern>(match)->regex,
-                               try_object<obj::persistent_string>(replacement)->data);
-        }
-
-        return replace_first(s, try_object<obj::re_pattern>(match)->regex, replacement);
+        return replace(s, *try_object<obj::re_pattern>(match)->program, replacement, all);
       default:
         throw std::runtime_error{ util::format("Invalid match arg: {}",
                                                runtime::to_code_string(match)) };
@@ -167,23 +236,35 @@ namespace clojure::string_native
 #pragma clang diagnostic pop
   }
 
-  object_ref replace_first(object_ref const s, object_ref const match, object_ref const replacement)
+  static object_ref
+  replace(object_ref const s, object_ref const match, object_ref const replacement, bool const all)
   {
     auto const is_string(s->type == object_type::persistent_string);
     auto const &s_str(is_string ? try_object<obj::persistent_string>(s)->data
                                 : runtime::to_string(s));
 
-    auto const output_str(replace_first(s_str, match, replacement));
+    auto const output_str(replace(s_str, match, replacement, all));
 
     return is_string && output_str == s_str ? s : make_box(output_str);
   }
 
+  object_ref replace(object_ref const s, object_ref const match, object_ref const replacement)
+  {
+    return replace(s, match, replacement, true);
+  }
+
+  object_ref replace_first(object_ref const s, object_ref const match, object_ref const replacement)
+  {
+    return replace(s, match, replacement, false);
+  }
+
   i64 index_of(object_ref const s, object_ref const value, object_ref const from_index)
   {
     auto const s_str(runtime::to_string(s));
     auto const value_str(runtime::to_string(value));
-    auto const pos(try_object<obj::integer>(from_index)->data);
-    return static_cast<i64>(s_str.find(value_str, pos));
+    /* Like Java, a negative index is the same as 0. */
+    auto const pos(std::max<i64>(try_object<obj::integer>(from_index)->data, 0));
+    return static_cast<i64>(util::find(s_str, value_str, static_cast<usize>(pos)));
   }
 
   i64 last_index_of(object_ref const s, object_ref const value, object_ref const from_index)
@@ -200,26 +281,10 @@ namespace clojure::string_native
     return s;
   }
 
-  static jtl::immutable_string::size_type triml_index(jtl::immutable_string const &s)
-  {
-    auto const s_size(s.size());
-    jtl::immutable_string::size_type i{ 0 };
-
-    for(; i < s_size; ++i)
-    {
-      if(!std::isspace(s[i]))
-      {
-        break;
-      }
-    }
-
-    return i;
-  }
-
   object_ref triml(object_ref const s)
   {
     auto const s_str(runtime::to_string(s));
-    auto const l(triml_index(s_str));
+    auto const l(util::find_non_space(s_str));
 
     if(l == 0)
     {
@@ -234,26 +299,10 @@ namespace clojure::string_native
     return make_box(s_str.substr(l));
   }
 
-  static jtl::immutable_string::size_type trimr_index(jtl::immutable_string const &s)
-  {
-    auto const s_size(s.size());
-    jtl::immutable_string::size_type i{ s_size };
-
-    for(; i > 0; --i)
-    {
-      if(!std::isspace(s[i - 1]))
-      {
-        break;
-      }
-    }
-
-    return i;
-  }
-
   object_ref trimr(object_ref const s)
   {
     auto const s_str(try_object<obj::persistent_string>(s)->data);
-    auto const r(trimr_index(s_str));
+    auto const r(util::rfind_non_space(s_str));
 
     if(r == s_str.size())
     {
@@ -271,14 +320,14 @@ namespace clojure::string_native
   object_ref trim(object_ref const s)
   {
     auto const s_str(try_object<obj::persistent_string>(s)->data);
-    auto const r(trimr_index(s_str));
+    auto const r(util::rfind_non_space(s_str));
 
     if(r == 0)
     {
       return empty_string();
     }
 
-    auto const l(triml_index(s_str));
+    auto const l(util::find_non_space(s_str));
 
     if(l == 0 && r == s_str.size())
     {
@@ -318,68 +367,176 @@ namespace clojure::string_native
     return make_box(s_str.substr(0, r));
   }
 
-  object_ref split(object_ref const s, object_ref const re)
+  /* This follows Java's String.split, which Clojure uses. A limit above 0 caps the number of
+   * pieces, with the rest of the string in the last one. A limit of 0 drops any empty pieces
+   * at the end, while a negative limit keeps them. The separator finder fills in where the
+   * next separator at or after the given offset is, if there is one. */
+  template <typename F>
+  static object_ref split(object_ref const s, i64 const limit, F const &find_separator)
   {
-    auto const s_str(try_object<obj::persistent_string>(s)->data);
-    auto const regex(try_object<obj::re_pattern>(re)->regex);
+    auto const &s_str(try_object<obj::persistent_string>(s)->data);
+
+    /* The pieces share the memory of the input, so we only allocate their boxes. */
+    runtime::detail::native_transient_vector pieces;
+    regex::span whole;
+    usize rest_i{};
+    usize search_i{};
+    usize trailing_empty{};
+    while((limit <= 0 || pieces.size() + 1 < static_cast<usize>(limit))
+          && search_i <= s_str.size() && find_separator(s_str, search_i, whole))
+    {
+      search_i = regex::next_start(s_str, whole);
 
-    std::string const search_str{ s_str.c_str() };
+      /* An empty match at the very start doesn't give an empty first piece. */
+      if(whole.offset == 0 && whole.size == 0)
+      {
+        continue;
+      }
 
-    native_vector<object_ref> vec;
-    std::sregex_token_iterator iter(search_str.begin(), search_str.end(), regex, -1);
-    std::sregex_token_iterator const end;
+      auto const size(whole.offset - rest_i);
+      trailing_empty = size == 0 ? trailing_empty + 1 : 0;
+      pieces.push_back(size == 0 ? empty_string() : make_box(s_str.shared_substr(rest_i, size)));
+      rest_i = whole.offset + whole.size;
+    }
 
-    if(iter != end && iter->str().empty())
+    if(rest_i == 0)
     {
-      ++iter;
+      return make_box<obj::persistent_vector>(std::in_place, s);
     }
 
-    for(; iter != end; ++iter)
+    if(rest_i < s_str.size())
+    {
+      pieces.push_back(make_box(s_str.shared_substr(rest_i)));
+    }
+    else if(limit != 0)
     {
-      vec.emplace_back(make_box<obj::persistent_string>(iter->str().c_str()));
+      pieces.push_back(empty_string());
+    }
+    else
+    {
+      pieces.take(pieces.size() - trailing_empty);
     }
 
-    return make_box<obj::persistent_vector>(
-      runtime::detail::native_persistent_vector{ vec.begin(), vec.end() });
+    return make_box<obj::persistent_vector>(pieces.persistent());
   }
 
-  object_ref split(object_ref const s, object_ref const re, object_ref const limit)
+  /* Patterns without any special characters, or which are just one escaped punctuation
+   * character, match themselves. Java skips the regex engine for those, so we do too. */
+  static jtl::option<jtl::immutable_string> literal_pattern(jtl::immutable_string const &pattern)
   {
-    auto const limit_int(try_object<obj::integer>(limit)->data);
-
-    if(limit_int < 1)
+    static constexpr std::string_view special{ "\\^$.|?*+()[]{}" };
+    if(pattern.size() == 2 && pattern[0] == '\\'
+       && !std::isalnum(static_cast<unsigned char>(pattern[1])))
     {
-      return split(s, re);
+      return pattern.substr(1);
     }
 
-    auto const s_str(try_object<obj::persistent_string>(s)->data);
-    auto const regex(try_object<obj::re_pattern>(re)->regex);
-
-    std::string const search_str{ s_str.c_str() };
+    for(auto const c : pattern)
+    {
+      if(special.find(c) != std::string_view::npos)
+      {
+        return none;
+      }
+    }
+    return pattern;
+  }
 
-    native_vector<object_ref> vec;
-    vec.reserve(limit_int);
+  static object_ref split_literal(object_ref const s,
+                                  jtl::immutable_string const &separator,
+                                  i64 const limit)
+  {
+    return split(s,
+                 limit,
+                 [&](jtl::immutable_string const &s_str, usize const from, regex::span &whole) {
+                   auto const found(util::find(s_str, separator, from));
+                   if(found == jtl::immutable_string::npos)
+                   {
+                     return false;
+                   }
+                   whole = { found, separator.size(), true };
+                   return true;
+                 });
+  }
 
-    std::sregex_token_iterator iter(search_str.begin(), search_str.end(), regex, -1);
-    std::sregex_token_iterator const end;
+  static object_ref split(object_ref const s, object_ref const separator, i64 const limit)
+  {
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wswitch-enum"
+    switch(separator->type)
+    {
+      case object_type::character:
+        return split_literal(s, expect_object<obj::character>(separator)->data, limit);
+      case object_type::persistent_string:
+        return split_literal(s, expect_object<obj::persistent_string>(separator)->data, limit);
+      default:
+        break;
+    }
+#pragma clang diagnostic pop
 
-    if(iter != end && iter->str().empty())
+    auto const re(try_object<obj::re_pattern>(separator));
+    auto const literal(literal_pattern(re->pattern));
+    if(literal.is_some())
     {
-      ++iter;
+      return split_literal(s, literal.unwrap(), limit);
     }
 
-    int i{ 1 };
-    for(; i < limit_int && iter != end; ++i, ++iter)
+    native_vector<regex::span> groups;
+    return split(s,
+                 limit,
+                 [&](jtl::immutable_string const &s_str, usize const from, regex::span &whole) {
+                   if(!regex::search(*re->program, s_str, from, regex::anchor::none, groups))
+                   {
+                     return false;
+                   }
+                   whole = groups[0];
+                   return true;
+                 });
+  }
+
+  object_ref split(object_ref const s, object_ref const re)
+  {
+    return split(s, re, 0);
+  }
+
+  object_ref split(object_ref const s, object_ref const re, object_ref const limit)
+  {
+    return split(s, re, try_object<obj::integer>(limit)->data);
+  }
+
+  /* Lines end at each \n, and a \r right before one is dropped too. This is the same as
+   * splitting on #"\r?\n", but without the regex. */
+  object_ref split_lines(object_ref const s)
+  {
+    auto const &s_str(try_object<obj::persistent_string>(s)->data);
+    if(s_str.find('\n') == jtl::immutable_string::npos)
     {
-      vec.emplace_back(make_box<obj::persistent_string>(iter->str().c_str()));
+      return make_box<obj::persistent_vector>(std::in_place, s);
     }
 
-    if(i == limit_int)
+    runtime::detail::native_transient_vector lines;
+    usize trailing_empty{};
+    usize start{};
+    while(start < s_str.size())
     {
-      vec.emplace_back(make_box(s_str.substr(iter->first - search_str.begin())));
+      auto end(s_str.find('\n', start));
+      auto const next(end == jtl::immutable_string::npos ? s_str.size() : end + 1);
+      if(end == jtl::immutable_string::npos)
+      {
+        end = s_str.size();
+      }
+      else if(end > start && s_str[end - 1] == '\r')
+      {
+        --end;
+      }
+
+      trailing_empty = end == start ? trailing_empty + 1 : 0;
+      lines.push_back(end == start ? empty_string()
+                                   : make_box(s_str.shared_substr(start, end - start)));
+      start = next;
     }
 
-    return make_box<obj::persistent_vector>(
-      runtime::detail::native_persistent_vector{ vec.begin(), vec.end() });
+    lines.take(lines.size() - trailing_empty);
+
+    return make_box<obj::persistent_vector>(lines.persistent());
   }
 }
@@ -0,0 +1,124 @@
+#include <clojure/walk_native.hpp>
+#include <jank/runtime/core.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/meta.hpp>
+#include <jank/runtime/core/seq.hpp>
+#include <jank/runtime/behavior/callable.hpp>
+
+namespace clojure::walk_native
+{
+  using namespace jank;
+  using namespace jank::runtime;
+
+  static bool is_walkable(object_ref const form)
+  {
+    switch(form->type)
+    {
+      case object_type::persistent_vector:
+      case object_type::persistent_array_map:
+      case object_type::persistent_hash_map:
+      case object_type::persistent_sorted_map:
+      case object_type::persistent_hash_set:
+      case object_type::persistent_sorted_set:
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  /* The transients don't carry meta through, so it's put back on at the end. */
+  static object_ref finish(object_ref const form, object_ref const transient)
+  {
+    auto const ret(persistent(transient));
+    auto const m(meta(form));
+    if(m.is_nil())
+    {
+      return ret;
+    }
+    return with_meta(ret, m);
+  }
+
+  /* A map entry which inner gave back with the same key can be assoc'd in place. If any
+   * key changed, the map has to be built up again from nothing, since the new key may be
+   * the same as one further along, which then needs to win, as it would with into. */
+  static bool has_same_key(object_ref const entry, object_ref const result)
+  {
+    return result->type == object_type::persistent_vector
+      && sequence_length(result, 3) == 2
+      && nth(result, make_box(0)) == nth(entry, make_box(0));
+  }
+
+  object_ref walk_coll(object_ref const inner, object_ref const form)
+  {
+    if(!is_walkable(form))
+    {
+      return jank_nil();
+    }
+
+    native_vector<object_ref> elements;
+    native_vector<object_ref> results;
+    auto const size(sequence_length(form));
+    elements.reserve(size);
+    results.reserve(size);
+
+    bool changed{};
+    for(auto it(fresh_seq(form)); !it.is_nil(); it = next_in_place(it))
+    {
+      auto const element(first(it));
+      auto const result(dynamic_call(inner, element));
+      changed = changed || result != element;
+      elements.emplace_back(element);
+      results.emplace_back(result);
+    }
+
+    if(!changed)
+    {
+      return form;
+    }
+
+    if(form->type == object_type::persistent_vector)
+    {
+      auto ret(transient(form));
+      for(usize i{}; i < results.size(); ++i)
+      {
+        if(results[i] != elements[i])
+        {
+          ret = assoc_in_place(ret, make_box(static_cast<i64>(i)), results[i]);
+        }
+      }
+      return finish(form, ret);
+    }
+
+    if(is_map(form))
+    {
+      bool same_keys{ true };
+      for(usize i{}; i < results.size() && same_keys; ++i)
+      {
+        same_keys = results[i] == elements[i] || has_same_key(elements[i], results[i]);
+      }
+
+      if(same_keys)
+      {
+        auto ret(transient(form));
+        for(usize i{}; i < results.size(); ++i)
+        {
+          if(results[i] != elements[i])
+          {
+            ret = assoc_in_place(ret,
+                                 nth(results[i], make_box(0)),
+                                 nth(results[i], make_box(1)));
+          }
+        }
+        return finish(form, ret);
+      }
+    }
+
+    /* Sets, and maps with changed keys. */
+    auto ret(transient(empty(form)));
+    for(auto const &result : results)
+    {
+      ret = conj_in_place(ret, result);
+    }
+    return finish(form, ret);
+  }
+}
@@ -0,0 +1,87 @@
+#include <cstddef>
+#include <new>
+
+#include <gc/gc.h>
+
+#include <jank/analyze/arena.hpp>
+
+namespace jank::analyze
+{
+  /* This only points at an arena on the stack, so the GC doesn't need to see it. */
+  static thread_local node_arena *current_arena{};
+
+  static void *gc_allocate(usize const size)
+  {
+    auto const ret{ GC_MALLOC(size) };
+    if(!ret)
+    {
+      throw std::bad_alloc{};
+    }
+    return ret;
+  }
+
+  node_arena::node_arena()
+    : previous{ current_arena }
+  {
+    current_arena = this;
+  }
+
+  node_arena::~node_arena()
+  {
+    current_arena = previous;
+    for(auto const chunk : chunks)
+    {
+      GC_FREE(chunk);
+    }
+  }
+
+  void *node_arena::allocate(usize const size)
+  {
+    auto const aligned_size{ (size + alignof(std::max_align_t) - 1)
+                             & ~(alignof(std::max_align_t) - 1) };
+    if(chunk_size < aligned_size)
+    {
+      chunks.emplace_back(static_cast<char *>(gc_allocate(size)));
+      return chunks.back();
+    }
+
+    if(remaining < aligned_size)
+    {
+      next = static_cast<char *>(gc_allocate(chunk_size));
+      chunks.emplace_back(next);
+      remaining = chunk_size;
+    }
+
+    auto const ret{ next };
+    next += aligned_size;
+    remaining -= aligned_size;
+    return ret;
+  }
+
+  bool node_arena::owns(void const * const p) const
+  {
+    auto const base{ GC_base(const_cast<void *>(p)) };
+    for(auto const chunk : chunks)
+    {
+      if(chunk == base)
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  node_arena *node_arena::current()
+  {
+    return current_arena;
+  }
+
+  void *allocate_node(usize const size)
+  {
+    if(current_arena)
+    {
+      return current_arena->allocate(size);
+    }
+    return gc_allocate(size);
+  }
+}
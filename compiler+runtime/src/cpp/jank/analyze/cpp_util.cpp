@@ -1,4 +1,7 @@
 #include <algorithm>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 
 #include <clang/Interpreter/CppInterOp.h>
 #include <clang/Sema/Sema.h>
@@ -26,6 +29,92 @@ namespace jank::analyze::cpp_util
     static_cast<void>(runtime::__rt_ctx->jit_prc.interpreter->Parse("1"));
   }
 
+  struct overload_key
+  {
+    bool operator==(overload_key const &rhs) const = default;
+
+    std::vector<void *> fns;
+    std::vector<void *> arg_types;
+    std::vector<void *> arg_scopes;
+  };
+
+  struct overload_key_hash
+  {
+    usize operator()(overload_key const &k) const
+    {
+      usize seed{ k.fns.size() };
+      auto const mix([&](std::vector<void *> const &ptrs) {
+        for(auto const p : ptrs)
+        {
+          seed ^= std::hash<void *>{}(p) + 0x9e3779b97f4a7c15 + (seed << 6) + (seed >> 2);
+        }
+      });
+      mix(k.fns);
+      mix(k.arg_types);
+      mix(k.arg_scopes);
+      return seed;
+    }
+  };
+
+  struct overload_match
+  {
+    void *fn{};
+    /* Overload resolution can instantiate templates, which changes the arg types. */
+    std::vector<void *> arg_types;
+  };
+
+  /* Interop heavy code resolves the same names, types, and overloads in form after form,
+   * each time going through Clang. The answers can only change once more C++ has been
+   * declared, so they're kept until the JIT's cpp_generation moves on. Only successful
+   * lookups are kept, so errors are always reported fresh. */
+  struct lookup_cache
+  {
+    u64 generation{};
+    std::unordered_map<std::string, void *> types;
+    std::unordered_map<std::string, void *> scopes;
+    std::unordered_map<void *, bool> trait_convertible;
+    std::unordered_map<overload_key, overload_match, overload_key_hash> overloads;
+  };
+
+  /* Clang is used from one thread at a time, but the lock is only held while touching the
+   * maps, never during a lookup. */
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+  static std::mutex lookup_cache_mutex;
+
+  template <typename F>
+  static auto with_lookup_cache(F const &f)
+  {
+    static lookup_cache cache;
+    std::lock_guard<std::mutex> const lock{ lookup_cache_mutex };
+    auto const generation{ runtime::__rt_ctx->jit_prc.cpp_generation.load(
+      std::memory_order_acquire) };
+    if(cache.generation != generation)
+    {
+      cache = {};
+      cache.generation = generation;
+    }
+    return f(cache);
+  }
+
+  /* Where there's no entry, this gives null, which no scope or type can be. */
+  static void *find_cached(std::unordered_map<std::string, void *> lookup_cache::*const map,
+                           jtl::immutable_string const &key)
+  {
+    return with_lookup_cache([&](lookup_cache &cache) -> void * {
+      auto const found{ (cache.*map).find(std::string{ key.data(), key.size() }) };
+      return found == (cache.*map).end() ? nullptr : found->second;
+    });
+  }
+
+  static void store_cached(std::unordered_map<std::string, void *> lookup_cache::*const map,
+                           jtl::immutable_string const &key,
+                           void * const value)
+  {
+    with_lookup_cache([&](lookup_cache &cache) {
+      (cache.*map).insert_or_assign(std::string{ key.data(), key.size() }, value);
+    });
+  }
+
   jtl::string_result<void> instantiate_if_needed(jtl::ptr<void> const scope)
   {
     if(!scope)
@@ -71,12 +160,17 @@ namespace jank::analyze::cpp_util
 
   jtl::ptr<void> resolve_type(jtl::immutable_string const &sym, u8 const ptr_count)
   {
-    auto const type{ Cpp::GetType(sym) };
-    if(type)
+    jtl::ptr<void> type{ find_cached(&lookup_cache::types, sym) };
+    if(!type)
     {
-      return apply_pointers(type, ptr_count);
+      type = Cpp::GetType(sym);
+      if(!type)
+      {
+        return type;
+      }
+      store_cached(&lookup_cache::types, sym, type);
     }
-    return type;
+    return apply_pointers(type, ptr_count);
   }
 
   /* Resolves the specified dot-separated symbol into its scope.
@@ -90,7 +184,7 @@ namespace jank::analyze::cpp_util
    * C++ function calls, we end up looking for all functions within the parent scope
    * of the one we chose.
    */
-  jtl::string_result<jtl::ptr<void>> resolve_scope(jtl::immutable_string const &sym)
+  static jtl::string_result<jtl::ptr<void>> resolve_scope_uncached(jtl::immutable_string const &sym)
   {
     jtl::ptr<void> scope{ Cpp::GetGlobalScope() };
     usize new_start{};
@@ -154,6 +248,23 @@ namespace jank::analyze::cpp_util
     return ok(scope);
   }
 
+  /* Anything found has already been instantiated, if it needed to be, so a cached scope
+   * can be used as is. */
+  jtl::string_result<jtl::ptr<void>> resolve_scope(jtl::immutable_string const &sym)
+  {
+    if(auto const cached{ find_cached(&lookup_cache::scopes, sym) })
+    {
+      return ok(jtl::ptr<void>{ cached });
+    }
+
+    auto res{ resolve_scope_uncached(sym) };
+    if(res.is_ok() && res.expect_ok())
+    {
+      store_cached(&lookup_cache::scopes, sym, res.expect_ok());
+    }
+    return res;
+  }
+
   jtl::string_result<jtl::ptr<void>> resolve_literal_type(jtl::immutable_string const &literal)
   {
     auto &diag{ runtime::__rt_ctx->jit_prc.interpreter->getCompilerInstance()->getDiagnostics() };
@@ -391,6 +502,12 @@ namespace jank::analyze::cpp_util
     return Cpp::GetCanonicalType(type) == ret;
   }
 
+  bool is_bool(jtl::ptr<void> const type)
+  {
+    static jtl::ptr<void> const ret{ Cpp::GetCanonicalType(Cpp::GetType("bool")) };
+    return Cpp::GetCanonicalType(Cpp::GetTypeWithoutCv(Cpp::GetNonReferenceType(type))) == ret;
+  }
+
   bool is_implicitly_convertible(jtl::ptr<void> const from, jtl::ptr<void> const to)
   {
     auto const from_no_ref{ Cpp::GetCanonicalType(Cpp::GetNonReferenceType(from)) };
@@ -592,10 +709,10 @@ namespace jank::analyze::cpp_util
     return ok(std::move(converted_args));
   }
 
-  jtl::string_result<jtl::ptr<void>>
-  find_best_overload(std::vector<void *> const &fns,
-                     std::vector<Cpp::TemplateArgInfo> &arg_types,
-                     std::vector<Cpp::TCppScope_t> const &arg_scopes)
+  static jtl::string_result<jtl::ptr<void>>
+  find_best_overload_uncached(std::vector<void *> const &fns,
+                              std::vector<Cpp::TemplateArgInfo> &arg_types,
+                              std::vector<Cpp::TCppScope_t> const &arg_scopes)
   {
     if(fns.empty())
     {
@@ -657,12 +774,79 @@ namespace jank::analyze::cpp_util
     return ok(nullptr);
   }
 
-  /* TODO: Cache result. */
+  jtl::string_result<jtl::ptr<void>>
+  find_best_overload(std::vector<void *> const &fns,
+                     std::vector<Cpp::TemplateArgInfo> &arg_types,
+                     std::vector<Cpp::TCppScope_t> const &arg_scopes)
+  {
+    /* Non-type template args are given by their value, which we don't key on. */
+    auto const cacheable{ std::ranges::none_of(arg_types, [](auto const &arg) {
+      return arg.m_IntegralValue != nullptr;
+    }) };
+    if(!cacheable)
+    {
+      return find_best_overload_uncached(fns, arg_types, arg_scopes);
+    }
+
+    overload_key key{ fns, {}, { arg_scopes.begin(), arg_scopes.end() } };
+    key.arg_types.reserve(arg_types.size());
+    for(auto const &arg : arg_types)
+    {
+      key.arg_types.emplace_back(arg.m_Type);
+    }
+
+    auto const cached{ with_lookup_cache([&](lookup_cache &cache) -> jtl::option<overload_match> {
+      auto const found{ cache.overloads.find(key) };
+      if(found == cache.overloads.end())
+      {
+        return none;
+      }
+      return found->second;
+    }) };
+    if(cached.is_some())
+    {
+      auto const &match{ cached.unwrap() };
+      for(usize i{}; i < arg_types.size(); ++i)
+      {
+        arg_types[i].m_Type = match.arg_types[i];
+      }
+      return ok(jtl::ptr<void>{ match.fn });
+    }
+
+    auto res{ find_best_overload_uncached(fns, arg_types, arg_scopes) };
+    if(res.is_ok() && res.expect_ok())
+    {
+      overload_match match{ res.expect_ok(), {} };
+      match.arg_types.reserve(arg_types.size());
+      for(auto const &arg : arg_types)
+      {
+        match.arg_types.emplace_back(arg.m_Type);
+      }
+      with_lookup_cache([&](lookup_cache &cache) {
+        cache.overloads.insert_or_assign(std::move(key), std::move(match));
+      });
+    }
+    return res;
+  }
+
   bool is_trait_convertible(jtl::ptr<void> const type)
   {
     static auto const convert_template{ Cpp::GetScopeFromCompleteName("jank::runtime::convert") };
     Cpp::TemplateArgInfo const arg{ Cpp::GetCanonicalType(
       Cpp::GetTypeWithoutCv(Cpp::GetNonReferenceType(type))) };
+    auto const cached{ with_lookup_cache([&](lookup_cache &cache) -> jtl::option<bool> {
+      auto const found{ cache.trait_convertible.find(arg.m_Type) };
+      if(found == cache.trait_convertible.end())
+      {
+        return none;
+      }
+      return found->second;
+    }) };
+    if(cached.is_some())
+    {
+      return cached.unwrap();
+    }
+
     clang::Sema::SFINAETrap const trap{ runtime::__rt_ctx->jit_prc.interpreter->getSema(), true };
     Cpp::TCppScope_t instantiation{};
     {
@@ -672,7 +856,10 @@ namespace jank::analyze::cpp_util
       util::scope_exit const finally{ [&] { diag.setClient(old_client.release(), true); } };
       instantiation = Cpp::InstantiateTemplate(convert_template, &arg, 1);
     }
-    return !trap.hasErrorOccurred() && Cpp::IsComplete(instantiation);
+    auto const convertible{ !trap.hasErrorOccurred() && Cpp::IsComplete(instantiation) };
+    with_lookup_cache(
+      [&](lookup_cache &cache) { cache.trait_convertible.insert_or_assign(arg.m_Type, convertible); });
+    return convertible;
   }
 
   usize offset_to_typed_object_base(jtl::ptr<void> const type)
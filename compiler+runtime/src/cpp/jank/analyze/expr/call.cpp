@@ -32,7 +32,13 @@ namespace jank::analyze::expr
                                                           make_box("form"),
                                                           form,
                                                           make_box("arg_exprs"),
-                                                          arg_expr_maps));
+                                                          arg_expr_maps,
+                                                          make_box("is_direct_linked"),
+                                                          make_box(is_direct_linked),
+                                                          make_box("is_protocol_call"),
+                                                          make_box(is_protocol_call),
+                                                          make_box("is_keyword_lookup"),
+                                                          make_box(is_keyword_lookup)));
   }
 
   void call::walk(std::function<void(jtl::ref<expression>)> const &f)
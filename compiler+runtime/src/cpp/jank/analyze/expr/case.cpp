@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <limits>
+
 #include <jank/analyze/expr/case.hpp>
 #include <jank/detail/to_runtime_data.hpp>
 #include <jank/runtime/obj/persistent_hash_map.hpp>
@@ -35,6 +38,17 @@ namespace jank::analyze::expr
     position = pos;
   }
 
+  i64 case_::unused_key() const
+  {
+    if(keys.empty())
+    {
+      return 0;
+    }
+
+    auto const [min, max](std::ranges::minmax(keys));
+    return min == std::numeric_limits<i64>::min() ? max + 1 : min - 1;
+  }
+
   object_ref case_::to_runtime_data() const
   {
     auto pairs{ make_box<obj::persistent_vector>() };
@@ -51,7 +65,8 @@ namespace jank::analyze::expr
                    std::make_pair(make_box("pairs"), pairs),
                    std::make_pair(make_box(shift), make_box("shift")),
                    std::make_pair(make_box("mask"), make_box(mask)),
-                   std::make_pair(make_box("default_expr"), default_expr->to_runtime_data())));
+                   std::make_pair(make_box("default_expr"), default_expr->to_runtime_data()),
+                   std::make_pair(make_box("is_int_test"), make_box(is_int_test))));
   }
 
   void case_::walk(std::function<void(jtl::ref<expression>)> const &f)
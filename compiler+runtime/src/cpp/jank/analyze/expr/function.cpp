@@ -77,7 +77,9 @@ namespace jank::analyze::expr
                                                make_box("unique_name"),
                                                jank::detail::to_runtime_data(unique_name),
                                                make_box("arities"),
-                                               arity_maps));
+                                               arity_maps,
+                                               make_box("has_stack_context"),
+                                               make_box(has_stack_context)));
   }
 
   void function::walk(std::function<void(jtl::ref<expression>)> const &f)
@@ -30,7 +30,9 @@ namespace jank::analyze::expr
                  obj::persistent_array_map::create_unique(make_box("args"),
                                                           args,
                                                           make_box("arg_exprs"),
-                                                          arg_expr_maps));
+                                                          arg_expr_maps,
+                                                          make_box("is_self_tail_call"),
+                                                          make_box(is_self_tail_call)));
   }
 
   void named_recursion::walk(std::function<void(jtl::ref<expression>)> const &f)
@@ -1,4 +1,5 @@
 #include <jank/analyze/expression.hpp>
+#include <jank/analyze/arena.hpp>
 #include <jank/runtime/obj/persistent_array_map.hpp>
 #include <jank/runtime/core/make_box.hpp>
 #include <jank/analyze/visit.hpp>
@@ -23,6 +24,19 @@ namespace jank::analyze
   {
   }
 
+  void *expression::operator new(usize const size, GCPlacement)
+  {
+    return allocate_node(size);
+  }
+
+  void expression::operator delete(void *) noexcept
+  {
+  }
+
+  void expression::operator delete(void *, GCPlacement) noexcept
+  {
+  }
+
   void expression::propagate_position(expression_position const pos)
   {
     position = pos;
@@ -6,6 +6,7 @@
 #include <jank/runtime/behavior/number_like.hpp>
 #include <jank/analyze/processor.hpp>
 #include <jank/analyze/local_frame.hpp>
+#include <jank/analyze/arena.hpp>
 #include <jank/analyze/cpp_util.hpp>
 #include <jank/detail/to_runtime_data.hpp>
 #include <jank/util/fmt.hpp>
@@ -28,13 +29,67 @@ namespace jank::analyze
       make_box("has_boxed_usage"),
       make_box(has_boxed_usage),
       make_box("has_unboxed_usage"),
-      make_box(has_unboxed_usage));
+      make_box(has_unboxed_usage),
+      make_box("scoped"),
+      make_box(scoped));
   }
 
   local_frame::local_frame(frame_type const &type, jtl::option<jtl::ptr<local_frame>> const &p)
     : type{ type }
-    , parent{ p }
   {
+    set_parent(p);
+  }
+
+  void *local_frame::operator new(usize const size, GCPlacement)
+  {
+    return allocate_node(size);
+  }
+
+  void local_frame::operator delete(void *) noexcept
+  {
+  }
+
+  void local_frame::operator delete(void *, GCPlacement) noexcept
+  {
+  }
+
+  void local_frame::add_local(obj::symbol_ref const sym, local_binding &&binding)
+  {
+    if(locals.emplace(sym, jtl::move(binding)).second)
+    {
+      scope = scope.set(sym, this);
+    }
+  }
+
+  void local_frame::set_parent(jtl::option<jtl::ptr<local_frame>> const &p)
+  {
+    parent = p;
+    if(p.is_none())
+    {
+      scope = {};
+      outer_fn = nullptr;
+      depth = 0;
+    }
+    else
+    {
+      auto const &parent_frame(p.unwrap());
+      scope = parent_frame->scope;
+      outer_fn = (parent_frame->type == frame_type::fn || parent_frame->outer_fn == nullptr)
+        ? parent_frame
+        : parent_frame->outer_fn;
+      depth = parent_frame->depth + 1;
+    }
+
+    for(auto const &local : locals)
+    {
+      scope = scope.set(local.first, this);
+    }
+  }
+
+  /* The fn frames from the start, outwards. */
+  static local_frame_ptr first_fn_frame(local_frame_ptr const start)
+  {
+    return start->type == local_frame::frame_type::fn ? start : start->outer_fn;
   }
 
   static jtl::option<local_frame::binding_find_result>
@@ -42,39 +97,44 @@ namespace jank::analyze
   {
     decltype(local_frame::binding_find_result::crossed_fns) crossed_fns;
 
-    for(local_frame_ptr it{ start }; it != nullptr;)
+    auto const found(start->scope.find(sym));
+    local_frame_ptr const owner{ found ? *found : local_frame_ptr{} };
+    if(owner == nullptr && !allow_captures)
     {
-      auto const local_result(it->locals.find(sym));
-      if(local_result != it->locals.end())
-      {
-        return local_frame::binding_find_result{ &local_result->second, std::move(crossed_fns) };
-      }
+      return none;
+    }
 
+    /* Captures only ever live in fn frames, so those are the only frames between here and
+     * the local which need to be checked. A capture without a local is for a fn's name,
+     * which is why we still look when there's no local. */
+    for(auto it{ first_fn_frame(start) };
+        it != nullptr && it->type == local_frame::frame_type::fn
+        && (owner == nullptr || owner->depth < it->depth);
+        it = it->outer_fn)
+    {
       if(allow_captures)
       {
         auto const capture_result(it->captures.find(sym));
-        if(capture_result != it->locals.end())
+        if(capture_result != it->captures.end())
         {
           return local_frame::binding_find_result{ &capture_result->second,
                                                    std::move(crossed_fns) };
         }
       }
 
-      if(it->parent.is_some())
+      if(it->parent.is_none())
       {
-        if(it->type == local_frame::frame_type::fn)
-        {
-          crossed_fns.emplace_back(it);
-        }
-        it = it->parent.unwrap();
-      }
-      else
-      {
-        return none;
+        break;
       }
+      crossed_fns.emplace_back(it);
     }
 
-    throw std::runtime_error{ util::format("unable to find local: {}", sym->to_string()) };
+    if(owner == nullptr)
+    {
+      return none;
+    }
+    return local_frame::binding_find_result{ &owner->locals.find(sym)->second,
+                                             std::move(crossed_fns) };
   }
 
   jtl::option<local_frame::binding_find_result>
@@ -130,25 +190,19 @@ namespace jank::analyze
     decltype(local_frame::named_recursion_find_result::crossed_fns) crossed_fns;
 
     auto const sym_str(sym->to_string());
-    for(local_frame_ptr it{ this }; it != nullptr;)
+    for(auto it{ first_fn_frame(this) }; it != nullptr && it->type == frame_type::fn;
+        it = it->outer_fn)
     {
-      if(it->type == frame_type::fn && it->fn_ctx->name == sym_str)
+      if(it->fn_ctx->name == sym_str)
       {
         return local_frame::named_recursion_find_result{ it, jtl::move(crossed_fns) };
       }
 
-      if(it->parent.is_some())
-      {
-        if(it->type == local_frame::frame_type::fn)
-        {
-          crossed_fns.emplace_back(it);
-        }
-        it = it->parent.unwrap();
-      }
-      else
+      if(it->parent.is_none())
       {
         break;
       }
+      crossed_fns.emplace_back(it);
     }
     return none;
   }
@@ -160,9 +214,9 @@ namespace jank::analyze
       /* NOLINTNEXTLINE(bugprone-return-const-ref-from-parameter): I expect this to not be a temporary. */
       return frame;
     }
-    else if(frame.parent.is_some())
+    else if(frame.outer_fn != nullptr)
     {
-      return find_closest_fn_frame(*frame.parent.unwrap());
+      return *frame.outer_fn;
     }
 
     /* Default to the root frame, if there is no fn frame. */
@@ -0,0 +1,98 @@
+#include <jank/analyze/pass/escape_analysis.hpp>
+#include <jank/analyze/pass/walk.hpp>
+#include <jank/analyze/local_frame.hpp>
+#include <jank/analyze/rtti.hpp>
+#include <jank/analyze/expr/call.hpp>
+#include <jank/analyze/expr/function.hpp>
+#include <jank/analyze/expr/let.hpp>
+#include <jank/analyze/expr/local_reference.hpp>
+
+namespace jank::analyze::pass
+{
+  /* Every closure allocates a context to hold its captures. When no reference to the
+   * closure can outlive the fn which creates it, that context can live on the stack
+   * instead, which takes a lot of short lived garbage away from the GC.
+   *
+   * We're conservative about this. A closure doesn't escape if it's called right where
+   * it's made or if it's bound to a local which is only ever called, within the same fn.
+   * Anything else, such as passing it along, returning it, storing it in a collection,
+   * or capturing it in another fn, counts as escaping. Named recursion can hand out the
+   * closure from within itself, so named recursive closures always escape. */
+  expression_ref escape_analysis(expression_ref const expr)
+  {
+    native_set<expression const *> call_sources;
+    native_set<expr::function *> candidates;
+    native_set<expr::function const *> escaped;
+
+    postwalk(expr, [&](expression_ref const e) {
+      if(auto const call = llvm::dyn_cast<expr::call>(e.data))
+      {
+        call_sources.emplace(call->source_expr.data);
+        if(auto const fn = llvm::dyn_cast<expr::function>(call->source_expr.data))
+        {
+          candidates.emplace(fn);
+        }
+      }
+      else if(auto const let = llvm::dyn_cast<expr::let>(e.data))
+      {
+        for(auto const &pair : let->pairs)
+        {
+          if(auto const fn = llvm::dyn_cast<expr::function>(pair.second.data))
+          {
+            candidates.emplace(fn);
+
+            /* Without a value expr, we can't trace references to the binding back to this
+             * fn, so we can't know that they don't let it escape. */
+            auto const &binding(let->frame->locals.find(pair.first)->second);
+            if(binding.value_expr.is_none() || binding.value_expr.unwrap().data != fn)
+            {
+              escaped.emplace(fn);
+            }
+          }
+        }
+      }
+    });
+
+    if(candidates.empty())
+    {
+      return expr;
+    }
+
+    postwalk(expr, [&](expression_ref const e) {
+      auto const ref{ llvm::dyn_cast<expr::local_reference>(e.data) };
+      if(!ref || ref->binding->value_expr.is_none())
+      {
+        return;
+      }
+
+      auto const fn{ llvm::dyn_cast<expr::function>(ref->binding->value_expr.unwrap().data) };
+      if(!fn)
+      {
+        return;
+      }
+
+      if(!call_sources.contains(ref)
+         || !local_frame::within_same_fn(ref->frame, ref->binding->originating_frame))
+      {
+        escaped.emplace(fn);
+      }
+    });
+
+    for(auto const fn : candidates)
+    {
+      if(escaped.contains(fn) || fn->captures().empty())
+      {
+        continue;
+      }
+
+      auto named_recursive{ false };
+      for(auto const &arity : fn->arities)
+      {
+        named_recursive |= arity.fn_ctx->is_named_recursive;
+      }
+      fn->has_stack_context = !named_recursive;
+    }
+
+    return expr;
+  }
+}
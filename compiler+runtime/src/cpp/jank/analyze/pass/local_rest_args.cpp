@@ -0,0 +1,305 @@
+#include <algorithm>
+#include <array>
+
+#include <jank/analyze/pass/local_rest_args.hpp>
+#include <jank/analyze/pass/walk.hpp>
+#include <jank/analyze/local_frame.hpp>
+#include <jank/analyze/rtti.hpp>
+#include <jank/analyze/expr/call.hpp>
+#include <jank/analyze/expr/cpp_call.hpp>
+#include <jank/analyze/expr/cpp_value.hpp>
+#include <jank/analyze/expr/do.hpp>
+#include <jank/analyze/expr/function.hpp>
+#include <jank/analyze/expr/if.hpp>
+#include <jank/analyze/expr/let.hpp>
+#include <jank/analyze/expr/local_reference.hpp>
+#include <jank/analyze/expr/recur.hpp>
+#include <jank/analyze/expr/var_deref.hpp>
+#include <jank/runtime/core/equal.hpp>
+#include <jank/runtime/obj/symbol.hpp>
+
+namespace jank::analyze::pass
+{
+  /* A variadic arity's rest args are packed into a seq for every call. When neither that
+   * seq nor any seq made from it can outlive the call, the caller can pack it on its own
+   * stack, which saves an allocation for each call to fns like str, max, and merge.
+   *
+   * We follow the rest args through locals, loop locals, and recur, along with the seqs
+   * which next, rest, and seq make from them, since those share the packed args. Every
+   * use of any of them has to only read through them, as first, count, nth, reduce, and
+   * if tests do. Anything else, such as returning them, passing them to any other fn,
+   * putting them in a collection, or closing over them, counts as escaping. */
+
+  /* These only read from the coll they're given and never hold onto it. Most calls to the
+   * clojure.core fns are inlined into calls to the jank::runtime fns, so we know both. */
+  static constexpr std::array reader_fns{
+    "clojure.core/first",  "clojure.core/second",   "clojure.core/last",
+    "clojure.core/count",  "clojure.core/empty?",   "clojure.core/nth",
+    "clojure.core/reduce", "clojure.core/some",     "clojure.core/every?",
+    "clojure.core/str",    "clojure.core/=",        "clojure.core/format",
+    "jank.runtime.first",  "jank.runtime.second",   "jank.runtime.nth",
+    "jank.runtime.str",    "jank.runtime.is_empty", "jank.runtime.sequence_length",
+    "jank.runtime.format",
+  };
+
+  /* These give a seq which shares the coll they're given. */
+  static constexpr std::array sharing_fns{
+    "clojure.core/next",    "clojure.core/rest",    "clojure.core/seq",
+    "clojure.core/nnext",   "clojure.core/nthnext", "clojure.core/nthrest",
+    "jank.runtime.next",    "jank.runtime.rest",    "jank.runtime.seq",
+  };
+
+  struct rest_flow
+  {
+    bool is_shared(local_binding const &binding) const
+    {
+      return std::ranges::any_of(shared, [&](local_binding const * const s) {
+        return s == &binding
+          || (s->originating_frame == binding.originating_frame
+              && runtime::equal(s->name, binding.name));
+      });
+    }
+
+    void share(local_binding const &binding)
+    {
+      if(std::ranges::find(shared, &binding) == shared.end())
+      {
+        shared.emplace_back(&binding);
+        changed = true;
+      }
+    }
+
+    /* Every local which may hold the rest args or a seq over them. */
+    native_vector<local_binding const *> shared;
+    native_vector<local_binding const *> params;
+    usize fn_depth{};
+    bool changed{};
+    bool escaped{};
+  };
+
+  enum class callee_kind : u8
+  {
+    reader,
+    sharing,
+    other
+  };
+
+  template <usize N>
+  static bool contains(std::array<char const *, N> const &names, jtl::immutable_string const &name)
+  {
+    return std::ranges::any_of(names, [&](char const * const n) { return name == n; });
+  }
+
+  static callee_kind callee_of(expression const &e)
+  {
+    jtl::immutable_string name;
+    if(auto const call = llvm::dyn_cast<expr::call>(&e))
+    {
+      if(auto const var = llvm::dyn_cast<expr::var_deref>(call->source_expr.data))
+      {
+        name = var->qualified_name->to_string();
+      }
+    }
+    else if(auto const cpp_call = llvm::dyn_cast<expr::cpp_call>(&e))
+    {
+      auto const value{ llvm::dyn_cast<expr::cpp_value>(cpp_call->source_expr.data) };
+      if(value && value->form.is_some() && value->form->type == runtime::object_type::symbol)
+      {
+        name = runtime::expect_object<runtime::obj::symbol>(value->form)->name;
+      }
+    }
+
+    if(name.empty())
+    {
+      return callee_kind::other;
+    }
+    if(contains(reader_fns, name))
+    {
+      return callee_kind::reader;
+    }
+    if(contains(sharing_fns, name))
+    {
+      return callee_kind::sharing;
+    }
+    return callee_kind::other;
+  }
+
+  static native_vector<expression_ref> const &args_of(expression const &e)
+  {
+    if(auto const call = llvm::dyn_cast<expr::call>(&e))
+    {
+      return call->arg_exprs;
+    }
+    return llvm::cast<expr::cpp_call>(&e)->arg_exprs;
+  }
+
+  /* Whether the value of this expression may be the rest args, or a seq over them. */
+  static bool is_shared(rest_flow const &flow, expression const &e)
+  {
+    if(auto const ref = llvm::dyn_cast<expr::local_reference>(&e))
+    {
+      return flow.is_shared(*ref->binding);
+    }
+    if(auto const if_ = llvm::dyn_cast<expr::if_>(&e))
+    {
+      return is_shared(flow, *if_->then)
+        || (if_->else_.is_some() && is_shared(flow, *if_->else_.unwrap()));
+    }
+    if(auto const do_ = llvm::dyn_cast<expr::do_>(&e))
+    {
+      return !do_->values.empty() && is_shared(flow, *do_->values.back());
+    }
+    if(auto const let = llvm::dyn_cast<expr::let>(&e))
+    {
+      return is_shared(flow, *let->body);
+    }
+    if(callee_of(e) == callee_kind::sharing)
+    {
+      return std::ranges::any_of(args_of(e),
+                                 [&](expression_ref const arg) { return is_shared(flow, *arg); });
+    }
+    return false;
+  }
+
+  /* Each expression checks the positions of its own children. Children whose values are
+   * given back as this expression's value, such as the branches of an if, are left for the
+   * parent to check, through is_shared. */
+  static void visit(rest_flow &flow, expression_ref const e)
+  {
+    auto const visit_escaping([&](expression_ref const child) {
+      visit(flow, child);
+      flow.escaped |= is_shared(flow, *child);
+    });
+
+    if(auto const ref = llvm::dyn_cast<expr::local_reference>(e.data))
+    {
+      /* A captured local is a copy of the binding, in the closure. */
+      if(flow.is_shared(*ref->binding)
+         && (std::ranges::find(flow.shared, ref->binding.data) == flow.shared.end()
+             || !local_frame::within_same_fn(ref->frame, ref->binding->originating_frame)))
+      {
+        flow.escaped = true;
+      }
+    }
+    else if(llvm::isa<expr::call>(e.data) || llvm::isa<expr::cpp_call>(e.data))
+    {
+      if(callee_of(*e) == callee_kind::other)
+      {
+        e->walk(visit_escaping);
+        return;
+      }
+      for(auto const &arg : args_of(*e))
+      {
+        visit(flow, arg);
+      }
+    }
+    else if(auto const if_ = llvm::dyn_cast<expr::if_>(e.data))
+    {
+      visit(flow, if_->condition);
+      visit(flow, if_->then);
+      if(if_->else_.is_some())
+      {
+        visit(flow, if_->else_.unwrap());
+      }
+    }
+    else if(auto const do_ = llvm::dyn_cast<expr::do_>(e.data))
+    {
+      for(auto const &value : do_->values)
+      {
+        visit(flow, value);
+      }
+    }
+    else if(auto const let = llvm::dyn_cast<expr::let>(e.data))
+    {
+      for(auto const &pair : let->pairs)
+      {
+        visit(flow, pair.second);
+        if(is_shared(flow, *pair.second))
+        {
+          flow.share(let->frame->locals.find(pair.first)->second);
+        }
+      }
+      visit(flow, let->body);
+    }
+    else if(auto const recur = llvm::dyn_cast<expr::recur>(e.data))
+    {
+      for(usize i{}; i < recur->arg_exprs.size(); ++i)
+      {
+        auto const &arg(recur->arg_exprs[i]);
+        visit(flow, arg);
+        if(!is_shared(flow, *arg))
+        {
+          continue;
+        }
+
+        if(recur->loop_target.is_some())
+        {
+          auto const loop(recur->loop_target.unwrap());
+          flow.share(loop->frame->locals.find(loop->pairs[i].first)->second);
+        }
+        else if(flow.fn_depth == 0 && i < flow.params.size())
+        {
+          flow.share(*flow.params[i]);
+        }
+        else
+        {
+          flow.escaped = true;
+        }
+      }
+    }
+    else if(llvm::isa<expr::function>(e.data))
+    {
+      ++flow.fn_depth;
+      e->walk(visit_escaping);
+      --flow.fn_depth;
+    }
+    else
+    {
+      e->walk(visit_escaping);
+    }
+  }
+
+  static bool has_local_rest(expr::function_arity const &arity)
+  {
+    rest_flow flow;
+    for(auto const &param : arity.params)
+    {
+      flow.params.emplace_back(&arity.frame->locals.find(param)->second);
+    }
+    flow.shared.emplace_back(flow.params.back());
+
+    /* Each pass can find more locals which hold the rest args, so we go until there are
+     * no new ones. There are only so many locals, so this always ends. */
+    do
+    {
+      flow.changed = false;
+      flow.escaped = false;
+      visit(flow, arity.body);
+      flow.escaped |= is_shared(flow, *arity.body);
+    }
+    while(flow.changed);
+
+    return !flow.escaped;
+  }
+
+  expression_ref local_rest_args(expression_ref const expr)
+  {
+    postwalk(expr, [&](expression_ref const e) {
+      auto const fn{ llvm::dyn_cast<expr::function>(e.data) };
+      if(!fn)
+      {
+        return;
+      }
+
+      for(auto &arity : fn->arities)
+      {
+        if(arity.fn_ctx->is_variadic && !arity.params.empty())
+        {
+          arity.fn_ctx->has_local_rest = has_local_rest(arity);
+        }
+      }
+    });
+
+    return expr;
+  }
+}
@@ -0,0 +1,313 @@
+#include <clang/Interpreter/CppInterOp.h>
+
+#include <jank/analyze/pass/numeric_arities.hpp>
+#include <jank/analyze/pass/walk.hpp>
+#include <jank/analyze/processor.hpp>
+#include <jank/analyze/cpp_util.hpp>
+#include <jank/analyze/local_frame.hpp>
+#include <jank/analyze/rtti.hpp>
+#include <jank/analyze/expr/call.hpp>
+#include <jank/analyze/expr/cpp_box.hpp>
+#include <jank/analyze/expr/do.hpp>
+#include <jank/analyze/expr/function.hpp>
+#include <jank/analyze/expr/if.hpp>
+#include <jank/analyze/expr/let.hpp>
+#include <jank/analyze/expr/letfn.hpp>
+#include <jank/analyze/expr/local_reference.hpp>
+#include <jank/analyze/expr/named_recursion.hpp>
+#include <jank/analyze/expr/primitive_literal.hpp>
+#include <jank/analyze/expr/recur.hpp>
+#include <jank/analyze/expr/throw.hpp>
+#include <jank/analyze/expr/var_deref.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/seq.hpp>
+#include <jank/runtime/core/truthy.hpp>
+#include <jank/runtime/obj/persistent_vector.hpp>
+
+namespace jank::analyze::pass
+{
+  /* An arity is numeric when every value it can return is a number. Calls to a numeric
+   * arity are then treated as though it had the :supports-unboxed-input? and
+   * :unboxed-output? arity meta, just like the arithmetic fns in clojure.core, without
+   * anyone needing to write that meta by hand.
+   *
+   * We look at each tail expression of the arity. Number literals, native numbers, and
+   * calls to other numeric arities are numeric. We see through let chains, by following
+   * each local to the value it was bound to, and through loop locals, so long as each
+   * recur into the loop also gives a number. A recur, a throw, or a call back into the
+   * arity itself doesn't return anything new, so those don't count either way. */
+  enum class numeric_kind : u8
+  {
+    numeric,
+    neutral,
+    other
+  };
+
+  static numeric_kind combine(numeric_kind const l, numeric_kind const r)
+  {
+    if(l == numeric_kind::other || r == numeric_kind::other)
+    {
+      return numeric_kind::other;
+    }
+    if(l == numeric_kind::numeric || r == numeric_kind::numeric)
+    {
+      return numeric_kind::numeric;
+    }
+    return numeric_kind::neutral;
+  }
+
+  static bool is_native_number(expression_ref const expr)
+  {
+    if(expr->kind < expression_kind::cpp_value_min || expression_kind::cpp_value_max < expr->kind)
+    {
+      return false;
+    }
+
+    static auto const double_type{ Cpp::GetCanonicalType(Cpp::GetType("double")) };
+    static auto const float_type{ Cpp::GetCanonicalType(Cpp::GetType("float")) };
+    static auto const bool_type{ Cpp::GetCanonicalType(Cpp::GetType("bool")) };
+    auto const type{ Cpp::GetCanonicalType(
+      Cpp::GetTypeWithoutCv(Cpp::GetNonReferenceType(cpp_util::expression_type(expr)))) };
+    return type == double_type || type == float_type
+      || (Cpp::IsIntegral(type) && type != bool_type);
+  }
+
+  static jtl::ptr<expr::function_arity>
+  find_arity(jtl::ptr<expr::function> const fn, usize const arg_count)
+  {
+    for(auto &arity : fn->arities)
+    {
+      if(!arity.fn_ctx->is_variadic && arity.params.size() == arg_count)
+      {
+        return &arity;
+      }
+    }
+    return nullptr;
+  }
+
+  struct inference
+  {
+    /* The arity we're inferring, so calls back into it are neutral. */
+    jtl::ptr<expr::function_context> current{};
+    /* Locals without a single value expr, such as loop locals, mapped to each of the lets
+     * and binding indices which give them a value. */
+    native_unordered_map<local_binding const *, native_vector<std::pair<expr::let *, usize>>>
+      rebound_locals;
+    /* Rebound locals we're already looking at, so a recur which passes one along as-is
+     * doesn't send us around in circles. */
+    native_set<local_binding const *> visiting_locals;
+
+    numeric_kind tail_kind(expression_ref const expr);
+    numeric_kind binding_kind(local_binding const &binding);
+  };
+
+  numeric_kind inference::binding_kind(local_binding const &binding)
+  {
+    if(!cpp_util::is_any_object(binding.type))
+    {
+      static auto const double_type{ Cpp::GetCanonicalType(Cpp::GetType("double")) };
+      static auto const float_type{ Cpp::GetCanonicalType(Cpp::GetType("float")) };
+      static auto const bool_type{ Cpp::GetCanonicalType(Cpp::GetType("bool")) };
+      auto const type{ Cpp::GetCanonicalType(
+        Cpp::GetTypeWithoutCv(Cpp::GetNonReferenceType(binding.type))) };
+      return (type == double_type || type == float_type
+              || (Cpp::IsIntegral(type) && type != bool_type))
+        ? numeric_kind::numeric
+        : numeric_kind::other;
+    }
+
+    if(binding.value_expr.is_some())
+    {
+      return tail_kind(binding.value_expr.unwrap());
+    }
+
+    auto const found(rebound_locals.find(&binding));
+    if(found == rebound_locals.end())
+    {
+      /* Params and the like. */
+      return numeric_kind::other;
+    }
+    if(!visiting_locals.emplace(&binding).second)
+    {
+      return numeric_kind::neutral;
+    }
+
+    auto ret{ numeric_kind::neutral };
+    for(auto const &[let, index] : found->second)
+    {
+      ret = combine(ret, tail_kind(let->pairs[index].second));
+      if(!let->is_loop)
+      {
+        continue;
+      }
+
+      postwalk(let->body, [&](expression_ref const e) {
+        auto const recur(llvm::dyn_cast<expr::recur>(e.data));
+        if(recur && recur->loop_target.is_some() && recur->loop_target.unwrap().data == let)
+        {
+          ret = combine(ret, tail_kind(recur->arg_exprs[index]));
+        }
+      });
+    }
+
+    visiting_locals.erase(&binding);
+    return ret;
+  }
+
+  numeric_kind inference::tail_kind(expression_ref const expr)
+  {
+    if(auto const literal = llvm::dyn_cast<expr::primitive_literal>(expr.data))
+    {
+      return (literal->data->type == runtime::object_type::integer
+              || literal->data->type == runtime::object_type::real)
+        ? numeric_kind::numeric
+        : numeric_kind::other;
+    }
+    if(auto const box = llvm::dyn_cast<expr::cpp_box>(expr.data))
+    {
+      return is_native_number(box->value_expr) ? numeric_kind::numeric : numeric_kind::other;
+    }
+    if(is_native_number(expr))
+    {
+      return numeric_kind::numeric;
+    }
+    if(llvm::isa<expr::recur>(expr.data) || llvm::isa<expr::throw_>(expr.data))
+    {
+      return numeric_kind::neutral;
+    }
+    if(auto const named = llvm::dyn_cast<expr::named_recursion>(expr.data))
+    {
+      return named->recursion_ref.fn_ctx.data == current.data ? numeric_kind::neutral
+                                                              : numeric_kind::other;
+    }
+    if(auto const do_ = llvm::dyn_cast<expr::do_>(expr.data))
+    {
+      return do_->values.empty() ? numeric_kind::other : tail_kind(do_->values.back());
+    }
+    if(auto const let = llvm::dyn_cast<expr::let>(expr.data))
+    {
+      return tail_kind(let->body);
+    }
+    if(auto const letfn = llvm::dyn_cast<expr::letfn>(expr.data))
+    {
+      return tail_kind(letfn->body);
+    }
+    if(auto const if_ = llvm::dyn_cast<expr::if_>(expr.data))
+    {
+      if(if_->else_.is_none())
+      {
+        return numeric_kind::other;
+      }
+      return combine(tail_kind(if_->then), tail_kind(if_->else_.unwrap()));
+    }
+    if(auto const ref = llvm::dyn_cast<expr::local_reference>(expr.data))
+    {
+      return binding_kind(*ref->binding);
+    }
+    if(auto const call = llvm::dyn_cast<expr::call>(expr.data))
+    {
+      auto const var_deref(llvm::dyn_cast<expr::var_deref>(call->source_expr.data));
+      if(!var_deref)
+      {
+        return numeric_kind::other;
+      }
+
+      /* A call back into this very arity, through its own var. */
+      if(current != nullptr)
+      {
+        auto const locked_values{ processor::var_values().rlock() };
+        auto const found(locked_values->find(var_deref->var));
+        if(found != locked_values->end())
+        {
+          if(auto const fn = llvm::dyn_cast<expr::function>(found->second.data))
+          {
+            auto const arity(find_arity(fn, call->arg_exprs.size()));
+            if(arity != nullptr && arity->fn_ctx.data == current.data)
+            {
+              return numeric_kind::neutral;
+            }
+          }
+        }
+      }
+
+      return is_numeric_call(var_deref->var, call->arg_exprs.size()) ? numeric_kind::numeric
+                                                                      : numeric_kind::other;
+    }
+
+    return numeric_kind::other;
+  }
+
+  expression_ref numeric_arities(expression_ref const expr)
+  {
+    /* This is a postwalk, so nested fns are inferred before the fns which hold them. */
+    postwalk(expr, [](expression_ref const e) {
+      auto const fn(llvm::dyn_cast<expr::function>(e.data));
+      if(!fn)
+      {
+        return;
+      }
+
+      for(auto &arity : fn->arities)
+      {
+        if(arity.fn_ctx->is_variadic)
+        {
+          continue;
+        }
+
+        inference inf{ .current = arity.fn_ctx.data };
+        postwalk(arity.body, [&](expression_ref const body_e) {
+          auto const let(llvm::dyn_cast<expr::let>(body_e.data));
+          if(!let)
+          {
+            return;
+          }
+          for(usize i{}; i < let->pairs.size(); ++i)
+          {
+            auto const &binding(let->frame->locals.find(let->pairs[i].first)->second);
+            if(binding.value_expr.is_none())
+            {
+              inf.rebound_locals[&binding].emplace_back(let, i);
+            }
+          }
+        });
+        arity.fn_ctx->is_numeric = inf.tail_kind(arity.body) == numeric_kind::numeric;
+      }
+    });
+    return expr;
+  }
+
+  bool is_numeric_call(runtime::var_ref const var, usize const arg_count)
+  {
+    using namespace runtime;
+
+    if(var->meta.is_some())
+    {
+      auto const arities(
+        get(var->meta.unwrap(), __rt_ctx->intern_keyword("", "arities", true).expect_ok()));
+      if(arities.is_some())
+      {
+        auto const arity_meta(get(arities, make_box(arg_count)));
+        if(arity_meta.is_some())
+        {
+          return truthy(
+            get(arity_meta, __rt_ctx->intern_keyword("", "unboxed-output?", true).expect_ok()));
+        }
+      }
+    }
+
+    auto const locked_values{ processor::var_values().rlock() };
+    auto const found(locked_values->find(var));
+    if(found == locked_values->end())
+    {
+      return false;
+    }
+    auto const fn(llvm::dyn_cast<expr::function>(found->second.data));
+    if(!fn)
+    {
+      return false;
+    }
+    auto const arity(find_arity(fn, arg_count));
+    return arity != nullptr && arity->fn_ctx->is_numeric;
+  }
+}
@@ -1,6 +1,11 @@
 #include <jank/analyze/pass/optimize.hpp>
+#include <jank/analyze/pass/escape_analysis.hpp>
+#include <jank/analyze/pass/local_rest_args.hpp>
+#include <jank/analyze/pass/numeric_arities.hpp>
+#include <jank/analyze/pass/self_tail_calls.hpp>
 #include <jank/analyze/pass/strip_source_meta.hpp>
 #include <jank/profile/time.hpp>
+#include <jank/profile/phase.hpp>
 
 namespace jank::analyze::pass
 {
@@ -13,8 +18,13 @@ namespace jank::analyze::pass
   expression_ref optimize(expression_ref expr)
   {
     profile::timer const timer{ "optimize ast" };
+    profile::phase_timer const phase{ profile::phase::optimize };
 
     expr = strip_source_meta(expr);
+    expr = escape_analysis(expr);
+    expr = local_rest_args(expr);
+    expr = self_tail_calls(expr);
+    expr = numeric_arities(expr);
 
     /* TODO: Port force_boxed to use this system. */
 
@@ -0,0 +1,63 @@
+#include <jank/analyze/pass/self_tail_calls.hpp>
+#include <jank/analyze/rtti.hpp>
+#include <jank/analyze/expr/function.hpp>
+#include <jank/analyze/expr/let.hpp>
+#include <jank/analyze/expr/named_recursion.hpp>
+#include <jank/analyze/expr/recur.hpp>
+#include <jank/analyze/expr/try.hpp>
+
+namespace jank::analyze::pass
+{
+  /* A self tail call is a call, in tail position, back into the very arity we're in. These
+   * don't need a new stack frame; codegen can rebind the params and jump back to the start
+   * of the arity instead. That's what fn level recur promises, but named recursion gets the
+   * same treatment here, so deep self recursion doesn't blow the stack.
+   *
+   * Jumping out of a try would skip its cleanup, so nothing within a try is a self tail
+   * call. We also leave loops alone, since they manage their own stack and locals. */
+  static void mark(expression_ref const expr,
+                   jtl::ptr<expr::function_arity> const arity,
+                   bool const blocked)
+  {
+    if(auto const fn = llvm::dyn_cast<expr::function>(expr.data))
+    {
+      for(auto &fn_arity : fn->arities)
+      {
+        mark(fn_arity.body, &fn_arity, false);
+      }
+      return;
+    }
+
+    if(arity != nullptr && !blocked && expr->position == expression_position::tail)
+    {
+      if(auto const named = llvm::dyn_cast<expr::named_recursion>(expr.data))
+      {
+        auto const &fn_ctx(arity->fn_ctx);
+        if(named->recursion_ref.fn_ctx->fn == fn_ctx->fn && !fn_ctx->is_variadic
+           && named->arg_exprs.size() == arity->params.size())
+        {
+          named->is_self_tail_call = true;
+          fn_ctx->has_self_tail_call = true;
+        }
+      }
+      else if(auto const recur = llvm::dyn_cast<expr::recur>(expr.data))
+      {
+        if(recur->loop_target.is_none() && recur->arg_exprs.size() == arity->params.size())
+        {
+          recur->is_self_tail_call = true;
+          arity->fn_ctx->has_self_tail_call = true;
+        }
+      }
+    }
+
+    auto const let(llvm::dyn_cast<expr::let>(expr.data));
+    auto const now_blocked{ blocked || llvm::isa<expr::try_>(expr.data) || (let && let->is_loop) };
+    expr->walk([&](expression_ref const e) { mark(e, arity, now_blocked); });
+  }
+
+  expression_ref self_tail_calls(expression_ref const expr)
+  {
+    mark(expr, nullptr, false);
+    return expr;
+  }
+}
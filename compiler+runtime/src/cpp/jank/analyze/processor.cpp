@@ -16,15 +16,22 @@
 #include <jank/runtime/core/make_box.hpp>
 #include <jank/runtime/core/seq.hpp>
 #include <jank/runtime/core/munge.hpp>
+#include <jank/runtime/obj/native_vector_sequence.hpp>
+#include <jank/runtime/sequence_range.hpp>
 #include <jank/analyze/processor.hpp>
+#include <jank/analyze/arena.hpp>
 #include <jank/analyze/step/force_boxed.hpp>
+#include <jank/analyze/step/fuse_sequences.hpp>
+#include <jank/analyze/pass/numeric_arities.hpp>
 #include <jank/evaluate.hpp>
+#include <jank/profile/phase.hpp>
 #include <jtl/result.hpp>
 #include <jank/util/scope_exit.hpp>
 #include <jank/util/fmt/print.hpp>
 #include <jank/util/try.hpp>
 #include <jank/util/string.hpp>
 #include <jank/error/analyze.hpp>
+#include <jank/error/report.hpp>
 #include <jank/analyze/expr/def.hpp>
 #include <jank/analyze/expr/var_deref.hpp>
 #include <jank/analyze/expr/var_ref.hpp>
@@ -1185,34 +1192,51 @@ namespace jank::analyze
   processor::processor()
     : root_frame{ jtl::make_ref<local_frame>(local_frame::frame_type::root, none) }
   {
-    using runtime::obj::symbol;
-    for(auto const &p :
-        std::initializer_list<std::pair<runtime::obj::symbol_ref, special_function_type>>{
-          {        make_box<symbol>("def"),        &processor::analyze_def },
-          {        make_box<symbol>("fn*"),         &processor::analyze_fn },
-          {      make_box<symbol>("recur"),      &processor::analyze_recur },
-          {         make_box<symbol>("do"),         &processor::analyze_do },
-          {       make_box<symbol>("let*"),        &processor::analyze_let },
-          {     make_box<symbol>("letfn*"),      &processor::analyze_letfn },
-          {      make_box<symbol>("loop*"),       &processor::analyze_loop },
-          {         make_box<symbol>("if"),         &processor::analyze_if },
-          {      make_box<symbol>("quote"),      &processor::analyze_quote },
-          {        make_box<symbol>("var"),   &processor::analyze_var_call },
-          {      make_box<symbol>("throw"),      &processor::analyze_throw },
-          {        make_box<symbol>("try"),        &processor::analyze_try },
-          {      make_box<symbol>("case*"),       &processor::analyze_case },
-          {    make_box<symbol>("cpp/raw"),    &processor::analyze_cpp_raw },
-          {   make_box<symbol>("cpp/type"),   &processor::analyze_cpp_type },
-          {  make_box<symbol>("cpp/value"),  &processor::analyze_cpp_value },
-          {   make_box<symbol>("cpp/cast"),   &processor::analyze_cpp_cast },
-          {    make_box<symbol>("cpp/box"),    &processor::analyze_cpp_box },
-          {  make_box<symbol>("cpp/unbox"),  &processor::analyze_cpp_unbox },
-          {    make_box<symbol>("cpp/new"),    &processor::analyze_cpp_new },
-          { make_box<symbol>("cpp/delete"), &processor::analyze_cpp_delete },
-    })
-    {
-      specials.insert(p);
-    }
+  }
+
+  native_unordered_map<runtime::obj::symbol_ref, processor::special_function_type> const &
+  processor::special_forms()
+  {
+    /* These are GC allocated, so the GC can see the symbols in them. */
+    static auto const * const specials{ [] {
+      auto const ret{ new(GC) native_unordered_map<obj::symbol_ref, special_function_type>{} };
+      using runtime::obj::symbol;
+      for(auto const &p :
+          std::initializer_list<std::pair<runtime::obj::symbol_ref, special_function_type>>{
+            {        make_box<symbol>("def"),        &processor::analyze_def },
+            {        make_box<symbol>("fn*"),         &processor::analyze_fn },
+            {      make_box<symbol>("recur"),      &processor::analyze_recur },
+            {         make_box<symbol>("do"),         &processor::analyze_do },
+            {       make_box<symbol>("let*"),        &processor::analyze_let },
+            {     make_box<symbol>("letfn*"),      &processor::analyze_letfn },
+            {      make_box<symbol>("loop*"),       &processor::analyze_loop },
+            {         make_box<symbol>("if"),         &processor::analyze_if },
+            {      make_box<symbol>("quote"),      &processor::analyze_quote },
+            {        make_box<symbol>("var"),   &processor::analyze_var_call },
+            {      make_box<symbol>("throw"),      &processor::analyze_throw },
+            {        make_box<symbol>("try"),        &processor::analyze_try },
+            {      make_box<symbol>("case*"),       &processor::analyze_case },
+            {    make_box<symbol>("cpp/raw"),    &processor::analyze_cpp_raw },
+            {   make_box<symbol>("cpp/type"),   &processor::analyze_cpp_type },
+            {  make_box<symbol>("cpp/value"),  &processor::analyze_cpp_value },
+            {   make_box<symbol>("cpp/cast"),   &processor::analyze_cpp_cast },
+            {    make_box<symbol>("cpp/box"),    &processor::analyze_cpp_box },
+            {  make_box<symbol>("cpp/unbox"),  &processor::analyze_cpp_unbox },
+            {    make_box<symbol>("cpp/new"),    &processor::analyze_cpp_new },
+            { make_box<symbol>("cpp/delete"), &processor::analyze_cpp_delete },
+      })
+      {
+        ret->insert(p);
+      }
+      return ret;
+    }() };
+    return *specials;
+  }
+
+  folly::Synchronized<processor::var_value_map> &processor::var_values()
+  {
+    static auto * const values{ new(GC) folly::Synchronized<var_value_map>{} };
+    return *values;
   }
 
   processor::expression_result processor::analyze(read::parse::processor::iterator parse_current,
@@ -1318,7 +1342,7 @@ namespace jank::analyze
       }
       value_expr = some(value_result.expect_ok());
 
-      vars.insert_or_assign(var_res.expect_ok(), value_expr.unwrap());
+      var_values().wlock()->insert_or_assign(var_res.expect_ok(), value_expr.unwrap());
     }
 
     if(has_docstring)
@@ -1477,15 +1501,25 @@ namespace jank::analyze
 
     auto pairs{ keys_exprs.expect_ok() };
 
-    return jtl::make_ref<expr::case_>(position,
-                                      current_frame,
-                                      needs_box,
-                                      value_expr.expect_ok(),
-                                      shift->data,
-                                      mask->data,
-                                      default_expr.expect_ok(),
-                                      std::move(pairs.keys),
-                                      std::move(pairs.exprs));
+    auto const ret{ jtl::make_ref<expr::case_>(position,
+                                               current_frame,
+                                               needs_box,
+                                               value_expr.expect_ok(),
+                                               shift->data,
+                                               mask->data,
+                                               default_expr.expect_ok(),
+                                               std::move(pairs.keys),
+                                               std::move(pairs.exprs)) };
+
+    /* The case macro tells us when the keys are exact integers, since it has already left
+     * out the equality check from each branch. A shift or mask would make that unsound. */
+    static auto const test_type_kw{ __rt_ctx->intern_keyword("", "test-type", true).expect_ok() };
+    static auto const int_kw{ __rt_ctx->intern_keyword("", "int", true).expect_ok() };
+    ret->is_int_test = o->meta.is_some()
+      && runtime::equal(runtime::get(o->meta.unwrap(), test_type_kw), int_kw)
+      && shift->data == 0 && mask->data == 0;
+
+    return ret;
   }
 
   processor::expression_result
@@ -1526,6 +1560,15 @@ namespace jank::analyze
         }
       }
 
+      if(unwrapped_local.binding->scoped && !unwrapped_local.crossed_fns.empty())
+      {
+        error::warn(util::format("'{}' is captured by a fn, at {}, but its object is destroyed "
+                                 "as soon as its with-native ends, which may be before the fn "
+                                 "is called.",
+                                 sym->to_string(),
+                                 meta_source(sym->meta).to_string()));
+      }
+
       local_frame::register_captures(unwrapped_local);
 
       /* Since we're referring to a local, we're boxed if it is boxed. */
@@ -1686,7 +1729,7 @@ namespace jank::analyze
         }
       }
 
-      frame->locals.emplace(sym, local_binding{ sym, sym->name, none, current_frame });
+      frame->add_local(sym, local_binding{ sym, sym->name, none, current_frame });
       param_symbols.emplace_back(sym);
     }
 
@@ -1934,6 +1977,7 @@ namespace jank::analyze
     }
 
     static_ref_cast<expr::function>(ret)->arities = std::move(arities);
+    static_ref_cast<expr::function>(ret)->source = meta_source(full_list->meta);
 
     return ret;
   }
@@ -2002,6 +2046,7 @@ namespace jank::analyze
 
     native_vector<expression_ref> arg_exprs;
     arg_exprs.reserve(arg_count);
+    usize arg_index{};
     for(auto const &form : list->data.rest())
     {
       auto arg_expr(analyze(form, current_frame, expression_position::value, fn_ctx, true));
@@ -2009,9 +2054,36 @@ namespace jank::analyze
       {
         return arg_expr;
       }
-      arg_expr = apply_implicit_conversion(arg_expr.expect_ok(),
-                                           cpp_util::untyped_object_ptr_type(),
-                                           macro_expansions);
+
+      /* Loop bindings may have a native type, in which case each recur needs to give us
+       * a value of that same type. Fn params are always boxed. */
+      jtl::ptr<void> expected_type{ cpp_util::untyped_object_ptr_type() };
+      if(is_loop)
+      {
+        auto const &pair{ loop_details.unwrap()->pairs[arg_index] };
+        expected_type = loop_details.unwrap()->frame->locals.find(pair.first)->second.type;
+
+        /* Silently truncating a floating point value into an integer loop binding would
+         * be surprising, so we require an explicit conversion. */
+        auto const arg_type{ Cpp::GetNonReferenceType(
+          cpp_util::expression_type(arg_expr.expect_ok())) };
+        if(cpp_util::is_primitive(expected_type) && Cpp::IsIntegral(expected_type)
+           && cpp_util::is_primitive(arg_type) && !Cpp::IsIntegral(arg_type)
+           && !Cpp::IsPointerType(arg_type))
+        {
+          return error::analyze_invalid_recur_args(
+            util::format("The loop binding '{}' is a native '{}', but this 'recur' gives it a "
+                         "'{}'. Use an explicit conversion, if that's intended.",
+                         pair.first->to_string(),
+                         Cpp::GetTypeAsString(expected_type),
+                         Cpp::GetTypeAsString(arg_type)),
+            object_source(form),
+            latest_expansion(macro_expansions));
+        }
+      }
+      ++arg_index;
+
+      arg_expr = apply_implicit_conversion(arg_expr.expect_ok(), expected_type, macro_expansions);
       if(arg_expr.is_err())
       {
         return arg_expr;
@@ -2087,6 +2159,42 @@ namespace jank::analyze
     return jtl::make_ref<expr::do_>(std::move(ret));
   }
 
+  /* Whether the value of the expression may be the local itself, following the forms which
+   * give the value of their last form. */
+  static bool returns_local(expression_ref const expr, local_binding const &binding)
+  {
+    if(expr->kind == expression_kind::local_reference)
+    {
+      return llvm::cast<expr::local_reference>(expr.data)->binding.data == &binding;
+    }
+    else if(expr->kind == expression_kind::cpp_box)
+    {
+      return returns_local(llvm::cast<expr::cpp_box>(expr.data)->value_expr, binding);
+    }
+    else if(expr->kind == expression_kind::do_)
+    {
+      auto const &values(llvm::cast<expr::do_>(expr.data)->values);
+      return !values.empty() && returns_local(values.back(), binding);
+    }
+    else if(expr->kind == expression_kind::let)
+    {
+      return returns_local(llvm::cast<expr::let>(expr.data)->body, binding);
+    }
+    else if(expr->kind == expression_kind::try_)
+    {
+      auto const t(llvm::cast<expr::try_>(expr.data));
+      return returns_local(t->body, binding)
+        || (t->catch_body.is_some() && returns_local(t->catch_body.unwrap().body, binding));
+    }
+    else if(expr->kind == expression_kind::if_)
+    {
+      auto const i(llvm::cast<expr::if_>(expr.data));
+      return returns_local(i->then, binding)
+        || (i->else_.is_some() && returns_local(i->else_.unwrap(), binding));
+    }
+    return false;
+  }
+
   processor::expression_result
   processor::analyze_let(runtime::obj::persistent_list_ref const o,
                          local_frame_ptr const current_frame,
@@ -2162,13 +2270,27 @@ namespace jank::analyze
       }
       auto const it(ret->pairs.emplace_back(sym, res.expect_ok()));
       auto const expr_type{ cpp_util::non_void_expression_type(it.second) };
-      ret->frame->locals.emplace(sym,
-                                 local_binding{ sym,
-                                                __rt_ctx->unique_namespaced_string(sym->name),
-                                                it.second,
-                                                current_frame,
-                                                it.second->needs_box,
-                                                .type = expr_type });
+
+      /* A binding only has a single value expr if nothing can rebind it. Loop bindings are
+       * rebound by each recur and a name bound twice within this let shares one binding. */
+      auto const shadowed(ret->frame->locals.find(sym));
+      auto const has_value{ shadowed == ret->frame->locals.end()
+                            && (loop_details.is_none() || loop_details.unwrap() != ret.data) };
+      if(shadowed != ret->frame->locals.end())
+      {
+        shadowed->second.value_expr = none;
+      }
+
+      auto const scoped{ it.second->kind == expression_kind::cpp_new
+                         && llvm::cast<expr::cpp_new>(it.second.data)->scoped };
+      ret->frame->add_local(sym,
+                            local_binding{ sym,
+                                           __rt_ctx->unique_namespaced_string(sym->name),
+                                           has_value ? some(it.second) : none,
+                                           current_frame,
+                                           it.second->needs_box,
+                                           .type = expr_type,
+                                           .scoped = scoped });
     }
 
     usize const form_count{ o->count() - 2 };
@@ -2206,6 +2328,18 @@ namespace jank::analyze
       ret->body->values.emplace_back(nil.expect_ok());
     }
 
+    for(auto const &local : ret->frame->locals)
+    {
+      if(local.second.scoped
+         && returns_local(ret->body->values.back(), local.second))
+      {
+        error::warn(util::format("'{}' is returned from its with-native, at {}, but its object "
+                                 "is destroyed as soon as the with-native ends.",
+                                 local.first->to_string(),
+                                 object_source(o).to_string()));
+      }
+    }
+
     return ret;
   }
 
@@ -2274,7 +2408,7 @@ namespace jank::analyze
                                             meta_source(sym_obj),
                                             latest_expansion(macro_expansions));
       }
-      ret->frame->locals.emplace(sym, local_binding{ sym, sym->name, none, current_frame });
+      ret->frame->add_local(sym, local_binding{ sym, sym->name, none, current_frame });
     }
 
     for(usize i{}; i < binding_parts; i += 2)
@@ -2410,13 +2544,18 @@ namespace jank::analyze
     {
       return condition_expr.expect_err();
     }
-    /* TODO: Support native types if they're compatible with bool. */
-    condition_expr = apply_implicit_conversion(condition_expr.expect_ok(),
-                                               cpp_util::untyped_object_ptr_type(),
-                                               macro_expansions);
-    if(condition_expr.is_err())
+    /* A native bool can be branched on as it is, so conditions from interop comparisons
+     * don't need to be converted into objects just to have their truthiness checked.
+     * TODO: Support other native types, if they're compatible with bool. */
+    if(!cpp_util::is_bool(cpp_util::expression_type(condition_expr.expect_ok())))
     {
-      return condition_expr.expect_err();
+      condition_expr = apply_implicit_conversion(condition_expr.expect_ok(),
+                                                 cpp_util::untyped_object_ptr_type(),
+                                                 macro_expansions);
+      if(condition_expr.is_err())
+      {
+        return condition_expr.expect_err();
+      }
     }
 
     auto const then(o->data.rest().rest().first().unwrap());
@@ -2477,6 +2616,23 @@ namespace jank::analyze
       else_expr_opt = else_expr.expect_ok();
     }
 
+    /* Both branches are still analyzed, so errors in the one which isn't taken are still
+     * reported. */
+    if(util::cli::opts.fold_constants
+       && condition_expr.expect_ok()->kind == expression_kind::primitive_literal)
+    {
+      auto const literal(llvm::cast<expr::primitive_literal>(condition_expr.expect_ok().data));
+      if(runtime::truthy(literal->data))
+      {
+        return then_expr;
+      }
+      else if(else_expr_opt.is_some())
+      {
+        return else_expr_opt.unwrap();
+      }
+      return analyze_primitive_literal(jank_nil(), current_frame, position, fn_ctx, needs_box);
+    }
+
     return jtl::make_ref<expr::if_>(position,
                                     current_frame,
                                     needs_box,
@@ -2740,7 +2896,7 @@ namespace jank::analyze
                                                 latest_expansion(macro_expansions));
             }
 
-            catch_frame->locals.emplace(sym, local_binding{ sym, sym->name, none, catch_frame });
+            catch_frame->add_local(sym, local_binding{ sym, sym->name, none, catch_frame });
 
             /* Now we just turn the body into a do block and have the do analyzer handle the rest. */
             auto const do_list(
@@ -2871,11 +3027,11 @@ namespace jank::analyze
   {
     auto const pop_macro_expansions{ push_macro_expansions(*this, o) };
 
-    /* TODO: Detect literal and act accordingly. */
     return visit_map_like(
       [&](auto const typed_o) -> processor::expression_result {
         native_vector<std::pair<expression_ref, expression_ref>> exprs;
         exprs.reserve(typed_o->data.size());
+        bool literal{ true };
 
         for(auto const &kv : typed_o->data)
         {
@@ -2908,6 +3064,24 @@ namespace jank::analyze
           }
 
           exprs.emplace_back(k_expr.expect_ok(), v_expr.expect_ok());
+          if(exprs.back().first->kind != expression_kind::primitive_literal
+             || exprs.back().second->kind != expression_kind::primitive_literal)
+          {
+            literal = false;
+          }
+        }
+
+        if(literal)
+        {
+          /* Eval the literal to resolve exprs such as quotes. */
+          auto const pre_eval_expr(jtl::make_ref<expr::map>(position,
+                                                            current_frame,
+                                                            true,
+                                                            std::move(exprs),
+                                                            typed_o->meta));
+          auto const constant(evaluate::eval(pre_eval_expr));
+
+          return jtl::make_ref<expr::primitive_literal>(position, current_frame, true, constant);
         }
 
         return jtl::make_ref<expr::map>(position,
@@ -2976,6 +3150,551 @@ namespace jank::analyze
       o);
   }
 
+  /* Direct linking trades the ability to redefine a var for skipping both the var deref and
+   * the dynamic dispatch of each call through it. We only link to vars which aren't dynamic,
+   * haven't opted out with ^:redef, and currently hold a fn which takes this call with a
+   * fixed arity. */
+  static bool is_direct_linkable(runtime::var_ref const var, usize const arg_count)
+  {
+    if(!util::cli::opts.direct_linking || var->dynamic.load() || runtime::max_params < arg_count)
+    {
+      return false;
+    }
+
+    if(var->meta.is_some()
+       && runtime::truthy(
+         get(var->meta.unwrap(), __rt_ctx->intern_keyword("", "redef", true).expect_ok())))
+    {
+      return false;
+    }
+
+    return runtime::visit_object(
+      [=](auto const typed_root) -> bool {
+        using T = typename jtl::decay_t<decltype(typed_root)>::value_type;
+
+        if constexpr(std::is_base_of_v<runtime::behavior::callable, T>)
+        {
+          return runtime::behavior::callable::is_fixed_arity_call(typed_root->get_arity_flags(),
+                                                                  arg_count);
+        }
+        else
+        {
+          return false;
+        }
+      },
+      var->get_root());
+  }
+
+  /* Whether the object can be emitted by codegen as a constant. */
+  static bool is_foldable_constant(object_ref const o)
+  {
+    return runtime::visit_object(
+      [](auto const typed_o) -> bool {
+        using T = typename jtl::decay_t<decltype(typed_o)>::value_type;
+
+        if constexpr(jtl::is_any_same<T,
+                                      obj::nil,
+                                      obj::boolean,
+                                      obj::integer,
+                                      obj::real,
+                                      obj::ratio,
+                                      obj::big_integer,
+                                      obj::big_decimal,
+                                      obj::character,
+                                      obj::symbol,
+                                      obj::keyword,
+                                      obj::persistent_string>)
+        {
+          return true;
+        }
+        else if constexpr(jtl::is_any_same<T,
+                                           obj::persistent_list,
+                                           obj::persistent_vector,
+                                           obj::persistent_hash_set>)
+        {
+          for(auto const &e : make_sequence_range(typed_o))
+          {
+            if(!is_foldable_constant(e))
+            {
+              return false;
+            }
+          }
+          return true;
+        }
+        else if constexpr(jtl::is_any_same<T, obj::persistent_array_map, obj::persistent_hash_map>)
+        {
+          for(auto const &kv : typed_o->data)
+          {
+            if(!is_foldable_constant(kv.first) || !is_foldable_constant(kv.second))
+            {
+              return false;
+            }
+          }
+          return true;
+        }
+        else
+        {
+          return false;
+        }
+      },
+      o);
+  }
+
+  /* With constant folding, calls to these clojure.core fns with only literal args are
+   * evaluated during analysis and replaced by their result. Each of them is pure, so
+   * the result is the same as it would be at runtime. If the call throws, it's left
+   * alone, so it'll throw at runtime instead. */
+  static jtl::option<object_ref>
+  fold_call(runtime::var_ref const var, native_vector<expression_ref> const &arg_exprs)
+  {
+    static native_set<jtl::immutable_string> const pure_fns{
+      "+", "-", "*", "/", "inc", "dec", "quot", "rem", "mod", "max", "min", "=", "not=", "==", "<",
+      ">", "<=", ">=", "not", "zero?", "pos?", "neg?", "even?", "odd?", "str", "keyword", "symbol",
+      "name", "namespace", "get", "get-in", "count", "nth", "first", "second", "contains?", "assoc",
+      "dissoc", "conj", "merge", "vector", "hash-map", "hash-set",
+    };
+
+    if(!util::cli::opts.fold_constants || var->n->name->name != "clojure.core"
+       || !pure_fns.contains(var->name->name) || var->dynamic.load())
+    {
+      return none;
+    }
+
+    if(var->meta.is_some()
+       && runtime::truthy(
+         get(var->meta.unwrap(), __rt_ctx->intern_keyword("", "redef", true).expect_ok())))
+    {
+      return none;
+    }
+
+    native_vector<object_ref> args;
+    args.reserve(arg_exprs.size());
+    for(auto const &arg_expr : arg_exprs)
+    {
+      if(arg_expr->kind != expression_kind::primitive_literal)
+      {
+        return none;
+      }
+      args.emplace_back(llvm::cast<expr::primitive_literal>(arg_expr.data)->data);
+    }
+
+    object_ref ret;
+    try
+    {
+      ret = runtime::apply_to(var->deref(),
+                              make_box<obj::native_vector_sequence>(std::move(args)));
+    }
+    catch(...)
+    {
+      return none;
+    }
+
+    if(!is_foldable_constant(ret))
+    {
+      return none;
+    }
+    return ret;
+  }
+
+  /* Meta isn't evaluated, so an :inline fn given in a defn's attr map is still a form the
+   * first time we see it. We evaluate it then and keep the resulting fn in the var's meta. */
+  static object_ref
+  realize_meta_fn(runtime::var_ref const var, object_ref const key, object_ref const value)
+  {
+    if(value->type != object_type::symbol && !runtime::is_seq(value))
+    {
+      return value;
+    }
+
+    processor an_prc;
+    auto const fn(
+      evaluate::eval(an_prc.analyze(value, expression_position::value).expect_ok()));
+    var->with_meta(runtime::assoc(var->meta.unwrap(), key, fn));
+    return fn;
+  }
+
+  static bool is_cpp_symbol(object_ref const o)
+  {
+    return o->type == object_type::symbol && expect_object<obj::symbol>(o)->ns == "cpp";
+  }
+
+  /* As with Clojure's definline, a var can hold an :inline fn in its meta. A call to the var
+   * is then replaced by the form which that fn returns, given the call's arg forms. For fns
+   * which only wrap a C++ fn, :inline can instead be a cpp/ symbol naming it, in which case
+   * the call goes straight to that C++ fn. If there's an :inline-arities, it's called with
+   * the arg count to see if the call may be inlined. The fn itself can also give nil, to
+   * leave the call as it is, such as when it needs literal args and didn't get them.
+   *
+   * As with direct linking, redefining the var won't affect callers which were inlined, so
+   * vars which are dynamic or ^:redef are never inlined. Returns nil when the call can't be
+   * inlined. */
+  static object_ref find_inline(runtime::var_ref const var, usize const arg_count)
+  {
+    if(var->meta.is_none() || var->dynamic.load() || runtime::max_params < arg_count)
+    {
+      return {};
+    }
+
+    auto const meta(var->meta.unwrap());
+    auto const inline_kw(__rt_ctx->intern_keyword("", "inline", true).expect_ok());
+    auto const inliner(get(meta, inline_kw));
+    if(inliner.is_nil()
+       || runtime::truthy(get(meta, __rt_ctx->intern_keyword("", "redef", true).expect_ok())))
+    {
+      return {};
+    }
+
+    auto const arities_kw(__rt_ctx->intern_keyword("", "inline-arities", true).expect_ok());
+    if(auto const arities = get(meta, arities_kw); arities.is_some())
+    {
+      auto const allowed(
+        runtime::dynamic_call(realize_meta_fn(var, arities_kw, arities), make_box(arg_count)));
+      if(!runtime::truthy(allowed))
+      {
+        return {};
+      }
+    }
+
+    if(is_cpp_symbol(inliner))
+    {
+      return inliner;
+    }
+    return realize_meta_fn(var, inline_kw, inliner);
+  }
+
+  struct native_arithmetic_op
+  {
+    Cpp::Operator op{};
+    jtl::immutable_string op_name;
+    usize arg_count{};
+    /* Integer division in Clojure gives a ratio, so we can only use the C++ operator
+     * when at least one side is floating point. */
+    bool needs_floating{};
+  };
+
+  /* These clojure.core fns have a C++ operator which behaves the same way, as long as
+   * the inputs are native numbers. */
+  static jtl::option<native_arithmetic_op>
+  find_native_arithmetic_op(runtime::var_ref const var, usize const arg_count)
+  {
+    static native_unordered_map<jtl::immutable_string, native_arithmetic_op> const ops{
+      {   "+",         { Cpp::OP_Plus, "+", 2 } },
+      {   "-",        { Cpp::OP_Minus, "-", 2 } },
+      {   "*",         { Cpp::OP_Star, "*", 2 } },
+      {   "/",  { Cpp::OP_Slash, "/", 2, true } },
+      {   "<",         { Cpp::OP_Less, "<", 2 } },
+      {   ">",      { Cpp::OP_Greater, ">", 2 } },
+      {  "<=",   { Cpp::OP_LessEqual, "<=", 2 } },
+      {  ">=", { Cpp::OP_GreaterEqual, ">=", 2 } },
+      {  "==",  { Cpp::OP_EqualEqual, "==", 2 } },
+      { "inc",         { Cpp::OP_Plus, "+", 1 } },
+      { "dec",        { Cpp::OP_Minus, "-", 1 } },
+    };
+
+    if(var->n->name->name != "clojure.core")
+    {
+      return none;
+    }
+
+    auto const found{ ops.find(var->name->name) };
+    if(found == ops.end() || found->second.arg_count != arg_count)
+    {
+      return none;
+    }
+
+    if(var->meta.is_some()
+       && runtime::truthy(
+         get(var->meta.unwrap(), __rt_ctx->intern_keyword("", "redef", true).expect_ok())))
+    {
+      return none;
+    }
+
+    return found->second;
+  }
+
+  static void *native_integer_type()
+  {
+    static auto const type{ Cpp::GetCanonicalType(Cpp::GetType("long long")) };
+    return type;
+  }
+
+  static void *native_real_type()
+  {
+    static auto const type{ Cpp::GetCanonicalType(Cpp::GetType("double")) };
+    return type;
+  }
+
+  /* Infers the native type of an argument to a native arithmetic op. Native integers and
+   * reals are used as-is, while number literals take on their native type. Anything else
+   * stays boxed, which means we can't use the native op. */
+  static jtl::ptr<void> native_arithmetic_arg_type(expression_ref const expr, bool &is_literal)
+  {
+    is_literal = false;
+    if(auto const literal{ llvm::dyn_cast<expr::primitive_literal>(expr.data) })
+    {
+      is_literal = true;
+      switch(literal->data->type)
+      {
+        case runtime::object_type::integer:
+          return native_integer_type();
+        case runtime::object_type::real:
+          return native_real_type();
+        default:
+          return nullptr;
+      }
+    }
+
+    auto const type{ Cpp::GetCanonicalType(
+      Cpp::GetTypeWithoutCv(Cpp::GetNonReferenceType(cpp_util::expression_type(expr)))) };
+    if(type == native_real_type() || type == Cpp::GetCanonicalType(Cpp::GetType("float"))
+       || (Cpp::IsIntegral(type) && type != Cpp::GetCanonicalType(Cpp::GetType("bool"))))
+    {
+      return type;
+    }
+    return nullptr;
+  }
+
+  /* Turns a call to something like clojure.core/+ into the equivalent C++ operator call,
+   * if every input is a native number (or a number literal) and at least one of them is
+   * native. This keeps unboxed values unboxed through arithmetic, so boxing only happens
+   * once the result escapes into something which needs an object. */
+  static jtl::option<processor::expression_result>
+  build_native_arithmetic_call(native_arithmetic_op const &op,
+                               native_vector<expression_ref> const &arg_exprs,
+                               local_frame_ptr const current_frame,
+                               expression_position const position,
+                               bool const needs_box,
+                               native_vector<runtime::object_ref> const &macro_expansions)
+  {
+    native_vector<expression_ref> native_arg_exprs{ arg_exprs };
+    /* inc and dec are just + and - with an implicit 1. */
+    if(native_arg_exprs.size() == 1)
+    {
+      native_arg_exprs.emplace_back(jtl::make_ref<expr::primitive_literal>(
+        expression_position::value,
+        current_frame,
+        true,
+        make_box(1)));
+    }
+
+    std::vector<Cpp::TemplateArgInfo> arg_types;
+    native_vector<bool> literals;
+    bool any_native{}, any_floating{};
+    for(auto const &arg_expr : native_arg_exprs)
+    {
+      bool is_literal{};
+      auto const type{ native_arithmetic_arg_type(arg_expr, is_literal) };
+      if(!type)
+      {
+        return none;
+      }
+
+      any_native |= !is_literal;
+      any_floating |= !Cpp::IsIntegral(type);
+      arg_types.emplace_back(type);
+      literals.emplace_back(is_literal);
+    }
+
+    if(!any_native || (op.needs_floating && !any_floating))
+    {
+      return none;
+    }
+
+    for(usize i{}; i < native_arg_exprs.size(); ++i)
+    {
+      if(!literals[i])
+      {
+        continue;
+      }
+
+      auto const converted{ apply_implicit_conversion(native_arg_exprs[i],
+                                                      arg_types[i].m_Type,
+                                                      macro_expansions) };
+      if(converted.is_err())
+      {
+        return converted.expect_err();
+      }
+      native_arg_exprs[i] = converted.expect_ok();
+    }
+
+    auto const val{ jtl::make_ref<expr::cpp_value>(position,
+                                                   current_frame,
+                                                   needs_box,
+                                                   make_box<obj::symbol>(op.op_name),
+                                                   nullptr,
+                                                   nullptr,
+                                                   expr::cpp_value::value_kind::operator_call) };
+    return build_builtin_operator_call(val,
+                                       op.op,
+                                       jtl::move(native_arg_exprs),
+                                       arg_types,
+                                       current_frame,
+                                       position,
+                                       needs_box,
+                                       macro_expansions);
+  }
+
+  /* Calls through a var holding a protocol method get an inline cache at the call site.
+   * The cache checks the var's root on each call, so the var can still be redefined, but
+   * a dynamic var could be rebound per thread, so we leave those alone. */
+  static bool is_protocol_call(runtime::var_ref const var, usize const arg_count)
+  {
+    return !var->dynamic.load() && 0 < arg_count && arg_count <= runtime::max_params
+      && var->get_root()->type == runtime::object_type::protocol_method;
+  }
+
+  static bool is_keyword_literal(expression_ref const expr)
+  {
+    auto const literal(llvm::dyn_cast<expr::primitive_literal>(expr.data));
+    return literal && literal->data->type == runtime::object_type::keyword;
+  }
+
+  /* Keyword lookups, such as (:k m) and (m :k), with an optional fallback, get an inline
+   * cache at the call site. For (m :k), we only do this when m is a local, since a var is
+   * more likely to hold a fn which just takes a keyword. */
+  static bool
+  is_keyword_lookup(expression_ref const source, native_vector<expression_ref> const &arg_exprs)
+  {
+    if(arg_exprs.empty() || 2 < arg_exprs.size())
+    {
+      return false;
+    }
+
+    return is_keyword_literal(source)
+      || (source->kind == expression_kind::local_reference && is_keyword_literal(arg_exprs[0]));
+  }
+
+  /* Whether the form has a recur which isn't within some nested fn* or loop*, and so would
+   * target the fn being inlined. This is a walk over the unexpanded forms, so a recur
+   * beneath a macro which introduces its own fn or loop, like doseq, still counts. That
+   * only keeps the call from being inlined. */
+  static bool has_own_recur(object_ref const form)
+  {
+    if(auto const sym = dyn_cast<obj::symbol>(form); sym.is_some())
+    {
+      return sym->ns.empty() && sym->name == "recur";
+    }
+    if(!runtime::is_seq(form) && !runtime::is_vector(form) && !runtime::is_map(form)
+       && !runtime::is_set(form))
+    {
+      return false;
+    }
+
+    if(runtime::is_seq(form))
+    {
+      if(auto const head = dyn_cast<obj::symbol>(runtime::first(form));
+         head.is_some() && head->ns.empty()
+         && (head->name == "fn*" || head->name == "loop*" || head->name == "quote"))
+      {
+        return false;
+      }
+    }
+
+    for(auto const &e : make_sequence_range(form))
+    {
+      if(has_own_recur(e))
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /* Macros like to wrap their bodies in an fn which is called right away, which would
+   * otherwise allocate an fn object on each evaluation just to call it once. Such a call
+   * means the same as binding its params to its args, so long as the fn doesn't recur to
+   * itself, and that binding doesn't need an fn at all.
+   *
+   * The args are bound to fresh locals before the params, since let* binds in order and
+   * an arg may refer to an outer local which a param shadows. */
+  jtl::option<object_ref>
+  processor::inline_immediate_fn_call(runtime::obj::persistent_list_ref const o)
+  {
+    auto const first(o->data.first().unwrap());
+    if(first->type != runtime::object_type::persistent_list)
+    {
+      return none;
+    }
+
+    object_ref expanded;
+    JANK_TRY
+    {
+      expanded = __rt_ctx->macroexpand(first);
+    }
+    JANK_CATCH_THEN([](auto const &) {}, return none)
+
+    auto const fn_list(dyn_cast<obj::persistent_list>(expanded));
+    if(fn_list.is_nil() || fn_list->count() < 2)
+    {
+      return none;
+    }
+    auto const head(dyn_cast<obj::symbol>(fn_list->data.first().unwrap()));
+    if(head.is_nil() || !head->ns.empty() || head->name != "fn*")
+    {
+      return none;
+    }
+
+    /* Only an unnamed fn with a single arity, given as a param vector, is inlined. */
+    auto const params(dyn_cast<obj::persistent_vector>(fn_list->data.rest().first().unwrap()));
+    auto const arg_count(o->count() - 1);
+    if(params.is_nil() || params->count() != arg_count)
+    {
+      return none;
+    }
+    for(auto const param : params->data)
+    {
+      auto const sym(dyn_cast<obj::symbol>(param));
+      if(sym.is_nil() || sym->name == "&")
+      {
+        return none;
+      }
+    }
+
+    /* A recur within the body would target the fn, which won't exist once it's inlined. */
+    for(auto it(fn_list->data.rest().rest()); !it.empty(); it = it.rest())
+    {
+      if(has_own_recur(it.first().unwrap()))
+      {
+        return none;
+      }
+    }
+
+    runtime::detail::native_transient_vector bindings;
+    if(arg_count == 1)
+    {
+      bindings.push_back(params->data[0]);
+      bindings.push_back(o->data.rest().first().unwrap());
+    }
+    else
+    {
+      native_vector<obj::symbol_ref> temps;
+      temps.reserve(arg_count);
+      for(auto it(o->data.rest()); !it.empty(); it = it.rest())
+      {
+        auto const temp(__rt_ctx->unique_symbol("arg"));
+        temps.emplace_back(temp);
+        bindings.push_back(temp);
+        bindings.push_back(it.first().unwrap());
+      }
+      for(usize i{}; i < arg_count; ++i)
+      {
+        bindings.push_back(params->data[i]);
+        bindings.push_back(temps[i]);
+      }
+    }
+
+    runtime::detail::native_transient_vector let;
+    let.push_back(make_box<obj::symbol>("let*"));
+    let.push_back(make_box<obj::persistent_vector>(bindings.persistent()));
+    for(auto it(fn_list->data.rest().rest()); !it.empty(); it = it.rest())
+    {
+      let.push_back(it.first().unwrap());
+    }
+    auto const ret(make_box<obj::persistent_list>(std::in_place, let.rbegin(), let.rend()));
+    ret->meta = o->meta;
+    return ret.erase();
+  }
+
   processor::expression_result
   processor::analyze_call(runtime::obj::persistent_list_ref const o,
                           local_frame_ptr const current_frame,
@@ -2998,14 +3717,24 @@ namespace jank::analyze
     jtl::ptr<expression> source;
     bool needs_ret_box{ true };
     bool needs_arg_box{ true };
+    bool direct_linked{};
+    bool protocol_call{};
+    jtl::option<native_arithmetic_op> native_op;
+    /* When the source is a var whose :inline is a C++ fn. */
+    obj::symbol_ref inline_cpp_fn;
 
     /* TODO: If this is a recursive call, note that and skip the var lookup. */
     if(first->type == runtime::object_type::symbol)
     {
       auto const sym(runtime::expect_object<runtime::obj::symbol>(first));
+      auto const &specials(special_forms());
       auto const found_special(specials.find(sym));
       if(found_special != specials.end())
       {
+        if(sym->ns == "cpp")
+        {
+          runtime::__rt_ctx->jit_prc.require_header_group(jit::header_group::interop);
+        }
         return (*this.*found_special->second)(o, current_frame, position, fn_ctx, needs_box);
       }
 
@@ -3039,6 +3768,13 @@ namespace jank::analyze
         return analyze_cpp_call(o, source.data, current_frame, position, fn_ctx, needs_box);
       }
 
+      /* This comes before macro expansion, since doseq is a macro. */
+      auto const fused(step::fuse_sequences(o, current_frame));
+      if(fused.is_some())
+      {
+        return analyze(fused, current_frame, position, fn_ctx, needs_box);
+      }
+
       object_ref expanded{ o };
       jtl::ptr<error::base> expansion_error{};
       JANK_TRY
@@ -3049,7 +3785,7 @@ namespace jank::analyze
         [&](auto const &e) {
           expansion_error
             = error::analyze_macro_expansion_exception(e,
-                                                       cpptrace::from_current_exception(),
+                                                       util::current_exception_trace(),
                                                        object_source(o),
                                                        latest_expansion(macro_expansions));
         },
@@ -3062,9 +3798,45 @@ namespace jank::analyze
 
       source = sym_result.expect_ok();
       auto const var_deref(llvm::dyn_cast<expr::var_deref>(source.data));
+      protocol_call = var_deref && is_protocol_call(var_deref->var, arg_count);
+      direct_linked
+        = !protocol_call && var_deref && is_direct_linkable(var_deref->var, arg_count);
+      if(var_deref)
+      {
+        native_op = find_native_arithmetic_op(var_deref->var, arg_count);
+
+        auto const inliner(find_inline(var_deref->var, arg_count));
+        if(inliner.is_some() && is_cpp_symbol(inliner))
+        {
+          inline_cpp_fn = expect_object<obj::symbol>(inliner);
+        }
+        else if(inliner.is_some())
+        {
+          object_ref inlined;
+          JANK_TRY
+          {
+            inlined = runtime::apply_to(inliner, o->next());
+          }
+          JANK_CATCH_THEN(
+            [&](auto const &e) {
+              expansion_error = error::analyze_macro_expansion_exception(
+                e,
+                util::current_exception_trace(),
+                object_source(o),
+                latest_expansion(macro_expansions));
+            },
+            return expansion_error.as_ref())
+
+          if(inlined.is_some())
+          {
+            return analyze(inlined, current_frame, position, fn_ctx, needs_box);
+          }
+        }
+      }
 
       /* If this expression doesn't need to be boxed, based on where it's called, we can dig
        * into the call details itself to see if the function supports unboxed returns. Most don't. */
+      bool has_unboxed_meta{};
       if(var_deref && var_deref->var->meta.is_some())
       {
         auto const arity_meta(
@@ -3085,14 +3857,22 @@ namespace jank::analyze
 
         if(supports_unboxed_input || supports_unboxed_output)
         {
-          auto const fn_res(vars.find(var_deref->var));
           /* If we don't have a valid var_deref, we know the var exists, but we
            * don't have an AST node for it. This means the var came in through
            * a pre-compiled module. In that case, we can only rely on meta to
            * tell us what we need. */
-          if(fn_res != vars.end())
+          auto const value_kind{ [&]() -> jtl::option<expression_kind> {
+            auto const locked_values{ var_values().rlock() };
+            auto const fn_res(locked_values->find(var_deref->var));
+            if(fn_res == locked_values->end())
+            {
+              return none;
+            }
+            return fn_res->second.data->kind;
+          }() };
+          if(value_kind.is_some())
           {
-            if(fn_res->second.data->kind != expression_kind::function)
+            if(value_kind.unwrap() != expression_kind::function)
             {
               return error::internal_analyze_failure("Unsupported arity meta on non-function var.",
                                                      object_source(first),
@@ -3102,13 +3882,28 @@ namespace jank::analyze
 
           needs_arg_box = !supports_unboxed_input;
           needs_ret_box = needs_box | !supports_unboxed_output;
+          has_unboxed_meta = true;
         }
       }
+
+      /* Without meta of its own, a fn which only ever returns numbers gets the same
+       * treatment. The numeric_arities pass works that out when the fn is analyzed. */
+      if(var_deref && !has_unboxed_meta && pass::is_numeric_call(var_deref->var, arg_count))
+      {
+        needs_arg_box = false;
+        needs_ret_box = needs_box;
+      }
     }
     else
     {
       pop_macro_expansions = push_macro_expansions(*this, o);
 
+      auto const inlined(inline_immediate_fn_call(o));
+      if(inlined.is_some())
+      {
+        return analyze(inlined.unwrap(), current_frame, position, fn_ctx, needs_box);
+      }
+
       auto const callable_expr(
         analyze(first, current_frame, expression_position::value, fn_ctx, needs_box));
       if(callable_expr.is_err())
@@ -3153,14 +3948,86 @@ namespace jank::analyze
       {
         return arg_expr;
       }
-      arg_expr = apply_implicit_conversion(arg_expr.expect_ok(),
-                                           cpp_util::untyped_object_ptr_type(),
-                                           macro_expansions);
-      if(arg_expr.is_err())
+      arg_exprs.emplace_back(arg_expr.expect_ok());
+    }
+
+    if(auto const var_deref = llvm::dyn_cast<expr::var_deref>(source.data);
+       var_deref && arg_count <= runtime::max_params)
+    {
+      auto const folded(fold_call(var_deref->var, arg_exprs));
+      if(folded.is_some())
       {
-        return arg_expr;
+        return jtl::make_ref<expr::primitive_literal>(position,
+                                                      current_frame,
+                                                      needs_box,
+                                                      folded.unwrap());
+      }
+    }
+
+    if(native_op.is_some())
+    {
+      auto const native_call{ build_native_arithmetic_call(native_op.unwrap(),
+                                                           arg_exprs,
+                                                           current_frame,
+                                                           position,
+                                                           needs_box,
+                                                           macro_expansions) };
+      if(native_call.is_some())
+      {
+        return native_call.unwrap();
+      }
+    }
+
+    for(auto &arg_expr : arg_exprs)
+    {
+      auto converted(apply_implicit_conversion(arg_expr,
+                                               cpp_util::untyped_object_ptr_type(),
+                                               macro_expansions));
+      if(converted.is_err())
+      {
+        return converted;
+      }
+      arg_expr = converted.expect_ok();
+    }
+
+    /* If the C++ fn can't take these args, we just leave it as a normal call. The
+     * interpreter can't evaluate C++ calls, so it'd have to JIT compile every fn which used
+     * one of these. */
+    if(inline_cpp_fn.is_some() && arg_count <= runtime::max_params && !util::cli::opts.interpret)
+    {
+      auto const fn_res(
+        analyze_symbol(inline_cpp_fn, current_frame, expression_position::value, fn_ctx, true));
+      if(fn_res.is_ok() && fn_res.expect_ok()->kind == expression_kind::cpp_value)
+      {
+        std::vector<Cpp::TemplateArgInfo> arg_types;
+        std::vector<Cpp::TCppScope_t> arg_scopes;
+        for(auto const &arg_expr : arg_exprs)
+        {
+          arg_types.emplace_back(cpp_util::expression_type(arg_expr));
+          arg_scopes.emplace_back(cpp_util::expression_scope(arg_expr));
+        }
+
+        auto inlined(build_cpp_call(llvm::cast<expr::cpp_value>(fn_res.expect_ok().data),
+                                    arg_exprs,
+                                    jtl::move(arg_types),
+                                    arg_scopes,
+                                    current_frame,
+                                    position,
+                                    needs_box,
+                                    macro_expansions));
+        /* The call used to give an object, so we keep it that way, even if the C++ fn
+         * returns something native. */
+        if(inlined.is_ok())
+        {
+          inlined = apply_implicit_conversion(inlined.expect_ok(),
+                                              cpp_util::untyped_object_ptr_type(),
+                                              macro_expansions);
+        }
+        if(inlined.is_ok())
+        {
+          return inlined;
+        }
       }
-      arg_exprs.emplace_back(arg_expr.expect_ok());
     }
 
     /* If we have more args than a fn allows, we need to pack all of the extras
@@ -3205,12 +4072,16 @@ namespace jank::analyze
     }
     else
     {
-      return jtl::make_ref<expr::call>(position,
-                                       current_frame,
-                                       needs_ret_box,
-                                       source.as_ref(),
-                                       std::move(arg_exprs),
-                                       o);
+      auto const call{ jtl::make_ref<expr::call>(position,
+                                                 current_frame,
+                                                 needs_ret_box,
+                                                 source.as_ref(),
+                                                 std::move(arg_exprs),
+                                                 o) };
+      call->is_direct_linked = direct_linked;
+      call->is_protocol_call = protocol_call;
+      call->is_keyword_lookup = is_keyword_lookup(call->source_expr, call->arg_exprs);
+      return call;
     }
   }
 
@@ -3380,6 +4251,7 @@ namespace jank::analyze
   {
     auto const pop_macro_expansions{ push_macro_expansions(*this, sym) };
     jank_debug_assert(sym->ns == "cpp");
+    runtime::__rt_ctx->jit_prc.require_header_group(jit::header_group::interop);
 
     /* TODO: Error if sym ends in . and we're not in a cpp call. */
 
@@ -4197,11 +5069,16 @@ namespace jank::analyze
       return value_expr_res.expect_err();
     }
 
+    /* with-native marks its cpp/new forms as scoped, since it deletes them itself. */
+    static auto const scoped_kw{ __rt_ctx->intern_keyword("scoped").expect_ok() };
+    auto const scoped{ l->meta.is_some() && truthy(get(l->meta.unwrap(), scoped_kw)) };
+
     return jtl::make_ref<expr::cpp_new>(position,
                                         current_frame,
                                         needs_box,
                                         type_expr->type,
-                                        value_expr_res.expect_ok());
+                                        value_expr_res.expect_ok(),
+                                        scoped);
   }
 
   processor::expression_result
@@ -4369,6 +5246,10 @@ namespace jank::analyze
   processor::expression_result
   processor::analyze(object_ref const o, expression_position const position)
   {
+    /* Interop analysis goes through CppInterOp, which needs the interpreter to exist, even
+     * if it's never used directly. */
+    static_cast<void>(runtime::__rt_ctx->jit_prc.interpreter.get());
+    profile::phase_timer const phase{ profile::phase::analyze };
     return analyze(o, root_frame, position, none, true);
   }
 
@@ -4454,7 +5335,12 @@ namespace jank::analyze
       return true;
     }
 
-    auto const found_special(specials.find(sym));
-    return found_special != specials.end();
+    return special_forms().contains(sym);
+  }
+
+  void processor::forget_nodes(node_arena const &arena)
+  {
+    std::erase_if(*var_values().wlock(),
+                  [&](auto const &entry) { return arena.owns(entry.second.data); });
   }
 }
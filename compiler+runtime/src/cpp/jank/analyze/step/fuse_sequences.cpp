@@ -0,0 +1,287 @@
+#include <algorithm>
+
+#include <jank/analyze/step/fuse_sequences.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core.hpp>
+#include <jank/runtime/rtti.hpp>
+#include <jank/runtime/obj/persistent_vector.hpp>
+
+/* Each stage becomes the transducer arity of the same fn and each consumer becomes
+ * transduce, or into with a transducer, so the result is the same, item for item. Only the
+ * laziness goes away, which nothing can see, since the chain is consumed in full right
+ * away. The one difference is that a chunked seq may have called a stage fn on a few more
+ * items than some needed, whereas the fused loop stops right at the first match.
+ *
+ * The stages' fns are evaluated before the source, rather than interleaved with it, so we
+ * only fuse stages whose fn can't have side effects when evaluated: a symbol, a keyword, or
+ * a fn form. */
+namespace jank::analyze::step
+{
+  using namespace jank::runtime;
+
+  /* The name of the clojure.core var which the symbol refers to, or an empty string when
+   * it's something else, such as a local or a var from another ns. */
+  static jtl::immutable_string core_name(object_ref const o, local_frame_ptr const frame)
+  {
+    auto const sym(dyn_cast<obj::symbol>(o));
+    if(sym.is_nil() || (!sym->ns.empty() && sym->ns != "clojure.core"))
+    {
+      return "";
+    }
+    if(sym->ns.empty() && frame->find_local_or_capture(sym).is_some())
+    {
+      return "";
+    }
+
+    auto const var(__rt_ctx->find_var(__rt_ctx->qualify_symbol(sym)));
+    if(var.is_nil() || var->n->name->name != "clojure.core" || var->dynamic.load())
+    {
+      return "";
+    }
+    return var->name->name;
+  }
+
+  static bool is_pure_fn_form(object_ref const o, local_frame_ptr const frame)
+  {
+    if(o->type == object_type::symbol || o->type == object_type::keyword)
+    {
+      return true;
+    }
+
+    auto const list(dyn_cast<obj::persistent_list>(o));
+    if(list.is_nil() || list->data.empty())
+    {
+      return false;
+    }
+    auto const head(list->data.first().unwrap());
+    auto const head_sym(dyn_cast<obj::symbol>(head));
+    return (head_sym.is_some() && head_sym->ns.empty() && head_sym->name == "fn*")
+      || core_name(head, frame) == "fn";
+  }
+
+  static obj::symbol_ref core_sym(jtl::immutable_string const &name)
+  {
+    return make_box<obj::symbol>("clojure.core", name);
+  }
+
+  struct chain
+  {
+    /* The transducer form for each stage, from the source outward. */
+    native_vector<object_ref> stages;
+    object_ref source;
+  };
+
+  /* Peels stages off of the form until reaching something which isn't one. That's the
+   * source, which may be any form. */
+  static chain find_chain(object_ref form, local_frame_ptr const frame)
+  {
+    chain ret;
+    while(true)
+    {
+      auto const list(dyn_cast<obj::persistent_list>(form));
+      if(list.is_nil() || list->count() != 3)
+      {
+        break;
+      }
+
+      auto const it(list->data.rest());
+      auto const fn(it.first().unwrap());
+      auto const name(core_name(list->data.first().unwrap(), frame));
+      if((name != "map" && name != "filter" && name != "remove" && name != "keep"
+          && name != "take-while" && name != "mapcat")
+         || !is_pure_fn_form(fn, frame))
+      {
+        break;
+      }
+
+      ret.stages.emplace_back(make_box<obj::persistent_list>(std::in_place, core_sym(name), fn));
+      form = it.rest().first().unwrap();
+    }
+
+    std::reverse(ret.stages.begin(), ret.stages.end());
+    ret.source = form;
+    return ret;
+  }
+
+  static object_ref xform_of(chain const &c)
+  {
+    if(c.stages.size() == 1)
+    {
+      return c.stages[0];
+    }
+
+    runtime::detail::native_transient_vector comp;
+    comp.push_back(core_sym("comp"));
+    for(auto const &stage : c.stages)
+    {
+      comp.push_back(stage);
+    }
+    return make_box<obj::persistent_list>(std::in_place, comp.rbegin(), comp.rend());
+  }
+
+  static bool is_fusable_consumer(jtl::immutable_string const &name, usize const count)
+  {
+    return ((name == "into" || name == "some") && count == 3)
+      || ((name == "vec" || name == "count") && count == 2) || (name == "reduce" && count == 4)
+      || (name == "doseq" && 3 <= count);
+  }
+
+  object_ref fuse_sequences(obj::persistent_list_ref const call, local_frame_ptr const frame)
+  {
+    /* This is called for every call we analyze, so we rule out most of them by name alone. */
+    auto const head(dyn_cast<obj::symbol>(call->data.first().unwrap()));
+    if(head.is_nil() || !is_fusable_consumer(head->name, call->count())
+       /* Within clojure.core, the fns we'd fuse into may not exist yet. */
+       || __rt_ctx->current_ns()->name->name == "clojure.core")
+    {
+      return {};
+    }
+
+    auto const name(core_name(head, frame));
+    if(!is_fusable_consumer(name, call->count()))
+    {
+      return {};
+    }
+    auto const args(call->data.rest());
+    auto const last_arg([&] {
+      object_ref ret;
+      for(auto it(args); !it.empty(); it = it.rest())
+      {
+        ret = it.first().unwrap();
+      }
+      return ret;
+    });
+
+    /* doseq only fuses its simplest form, a single binding without modifiers. */
+    obj::persistent_vector_ref doseq_bindings;
+    object_ref chain_form;
+    if(name == "doseq")
+    {
+      doseq_bindings = dyn_cast<obj::persistent_vector>(args.first().unwrap());
+      if(doseq_bindings.is_nil() || doseq_bindings->count() != 2)
+      {
+        return {};
+      }
+      chain_form = doseq_bindings->data[1];
+    }
+    else
+    {
+      chain_form = last_arg();
+    }
+
+    auto const c(find_chain(chain_form, frame));
+    if(c.stages.empty())
+    {
+      return {};
+    }
+
+    auto const xform(xform_of(c));
+    auto const transduce(core_sym("transduce"));
+    auto const completing(core_sym("completing"));
+    obj::persistent_list_ref ret;
+    if(name == "into")
+    {
+      ret = make_box<obj::persistent_list>(std::in_place,
+                                           core_sym("into"),
+                                           args.first().unwrap(),
+                                           xform,
+                                           c.source);
+    }
+    else if(name == "vec")
+    {
+      ret = make_box<obj::persistent_list>(std::in_place,
+                                           core_sym("into"),
+                                           obj::persistent_vector::empty(),
+                                           xform,
+                                           c.source);
+    }
+    else if(name == "reduce")
+    {
+      ret = make_box<obj::persistent_list>(
+        std::in_place,
+        transduce,
+        xform,
+        make_box<obj::persistent_list>(std::in_place, completing, args.first().unwrap()),
+        args.rest().first().unwrap(),
+        c.source);
+    }
+    else if(name == "count")
+    {
+      auto const n(__rt_ctx->unique_symbol("n"));
+      auto const step(make_box<obj::persistent_list>(
+        std::in_place,
+        make_box<obj::symbol>("fn*"),
+        make_box<obj::persistent_vector>(std::in_place, n, __rt_ctx->unique_symbol("x")),
+        make_box<obj::persistent_list>(std::in_place, core_sym("inc"), n)));
+      ret = make_box<obj::persistent_list>(
+        std::in_place,
+        transduce,
+        xform,
+        make_box<obj::persistent_list>(std::in_place, completing, step),
+        make_box(0),
+        c.source);
+    }
+    else if(name == "some")
+    {
+      /* The pred is bound first, since it's evaluated before the chain. */
+      auto const pred(__rt_ctx->unique_symbol("pred"));
+      auto const x(__rt_ctx->unique_symbol("x"));
+      auto const v(__rt_ctx->unique_symbol("v"));
+      auto const step(make_box<obj::persistent_list>(
+        std::in_place,
+        make_box<obj::symbol>("fn*"),
+        make_box<obj::persistent_vector>(std::in_place, __rt_ctx->unique_symbol("acc"), x),
+        make_box<obj::persistent_list>(
+          std::in_place,
+          make_box<obj::symbol>("let*"),
+          make_box<obj::persistent_vector>(
+            std::in_place,
+            v,
+            make_box<obj::persistent_list>(std::in_place, pred, x)),
+          make_box<obj::persistent_list>(
+            std::in_place,
+            make_box<obj::symbol>("if"),
+            v,
+            make_box<obj::persistent_list>(std::in_place, core_sym("reduced"), v),
+            jank_nil()))));
+      ret = make_box<obj::persistent_list>(
+        std::in_place,
+        make_box<obj::symbol>("let*"),
+        make_box<obj::persistent_vector>(std::in_place, pred, args.first().unwrap()),
+        make_box<obj::persistent_list>(
+          std::in_place,
+          transduce,
+          xform,
+          make_box<obj::persistent_list>(std::in_place, completing, step),
+          jank_nil(),
+          c.source));
+    }
+    else
+    {
+      /* The same fn doseq would reduce with, so the body sees the same binding. */
+      runtime::detail::native_transient_vector step;
+      step.push_back(core_sym("fn"));
+      step.push_back(make_box<obj::persistent_vector>(std::in_place,
+                                                      __rt_ctx->unique_symbol("acc"),
+                                                      doseq_bindings->data[0]));
+      for(auto it(args.rest()); !it.empty(); it = it.rest())
+      {
+        step.push_back(it.first().unwrap());
+      }
+      step.push_back(jank_nil());
+      ret = make_box<obj::persistent_list>(
+        std::in_place,
+        transduce,
+        xform,
+        make_box<obj::persistent_list>(
+          std::in_place,
+          completing,
+          make_box<obj::persistent_list>(std::in_place, step.rbegin(), step.rend())),
+        jank_nil(),
+        c.source);
+    }
+
+    ret->meta = call->meta;
+    return ret;
+  }
+}
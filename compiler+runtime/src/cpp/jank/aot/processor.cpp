@@ -27,8 +27,53 @@ namespace jank::aot
     return util::format("{}/{}", __rt_ctx->binary_cache_dir, file_path);
   }
 
+  /* The modules to link into the program, in the order they were loaded. Normally, that's
+   * every module loaded while compiling. For whole program builds, it's only the ones the
+   * entrypoint module depends on, directly or not, plus the core modules. If one of those
+   * was loaded before we started tracking dependencies, we can't tell what it needs, so
+   * we keep everything. */
+  static native_vector<jtl::immutable_string> linked_modules(jtl::immutable_string const &module)
+  {
+    auto const modules_rlocked{ __rt_ctx->loaded_modules_in_order.rlock() };
+    native_vector<jtl::immutable_string> all{ modules_rlocked->begin(), modules_rlocked->end() };
+    if(!util::cli::opts.whole_program)
+    {
+      return all;
+    }
+
+    native_set<jtl::immutable_string> reachable;
+    native_vector<jtl::immutable_string> pending{ module };
+    while(!pending.empty())
+    {
+      auto const next{ pending.back() };
+      pending.pop_back();
+      if(!reachable.emplace(next).second || module::is_core_module(next))
+      {
+        continue;
+      }
+
+      auto const found{ __rt_ctx->module_dependencies.find(next) };
+      if(found == __rt_ctx->module_dependencies.end())
+      {
+        return all;
+      }
+      pending.insert(pending.end(), found->second.begin(), found->second.end());
+    }
+
+    native_vector<jtl::immutable_string> ret;
+    for(auto const &it : all)
+    {
+      if(module::is_core_module(it) || reachable.contains(it))
+      {
+        ret.emplace_back(it);
+      }
+    }
+    return ret;
+  }
+
   // TODO: Generate an object file instead of a cpp
-  static jtl::immutable_string gen_entrypoint(jtl::immutable_string const &module)
+  static jtl::immutable_string gen_entrypoint(jtl::immutable_string const &module,
+                                              native_vector<jtl::immutable_string> const &modules)
   {
     jtl::string_builder sb;
     sb(R"(/* DO NOT MODIFY: Autogenerated by jank. */
@@ -53,8 +98,7 @@ extern "C" void jank_module_set_loaded(char const *module);
 extern "C" jank_object_ref jank_parse_command_line_args(int, char const **);
 )");
 
-    auto const modules_rlocked{ __rt_ctx->loaded_modules_in_order.rlock() };
-    for(auto const &it : *modules_rlocked)
+    for(auto const &it : modules)
     {
       util::format_to(sb, R"(extern "C" void {}();)", module::module_to_load_function(it));
       sb("\n");
@@ -85,7 +129,7 @@ int main(int argc, const char** argv)
 
     )");
 
-    for(auto const &it : *modules_rlocked)
+    for(auto const &it : modules)
     {
       util::format_to(sb, "{}();\n", module::module_to_load_function(it));
     }
@@ -203,13 +247,44 @@ int main(int argc, const char** argv)
       compiler_args.push_back(strdup(util::format("-D{}", define).c_str()));
     }
 
+    if(auto const cpu_flag{ util::target_cpu_flag() }; cpu_flag.is_some())
+    {
+      compiler_args.push_back(strdup(cpu_flag.unwrap().c_str()));
+    }
+
     compiler_args.push_back(strdup("-std=c++20"));
     compiler_args.push_back(strdup("-Wno-c23-extensions"));
-    if constexpr(jtl::current_platform == jtl::platform::linux_like)
+
+    /* These use LLVM's IR level instrumentation, rather than Clang's front-end
+     * instrumentation, so the profiles match the ones for modules compiled from LLVM IR. */
+    if(util::cli::opts.profile_generate)
     {
-      compiler_args.push_back(strdup("-Wl,--export-dynamic"));
+      compiler_args.push_back(strdup("-fprofile-generate"));
+    }
+    else if(!util::cli::opts.profile_use_file.empty())
+    {
+      compiler_args.push_back(
+        strdup(util::format("-fprofile-use={}", util::cli::opts.profile_use_file).c_str()));
+      compiler_args.push_back(strdup("-Wno-profile-instr-unprofiled"));
+      compiler_args.push_back(strdup("-Wno-profile-instr-out-of-date"));
+    }
+
+    /* Exporting everything lets JIT compiled code link against the program, but it also
+     * keeps the linker from dropping anything. Whole program builds give that up. */
+    if(util::cli::opts.whole_program)
+    {
+      compiler_args.push_back(strdup("-flto=thin"));
+      compiler_args.push_back(strdup("-ffunction-sections"));
+      compiler_args.push_back(strdup("-fdata-sections"));
+    }
+    else
+    {
+      if constexpr(jtl::current_platform == jtl::platform::linux_like)
+      {
+        compiler_args.push_back(strdup("-Wl,--export-dynamic"));
+      }
+      compiler_args.push_back(strdup("-rdynamic"));
     }
-    compiler_args.push_back(strdup("-rdynamic"));
     /* TODO: Change this based on the CLI optimization level. */
     compiler_args.push_back(strdup("-O2"));
 
@@ -234,8 +309,8 @@ int main(int argc, const char** argv)
     }
     std::vector<char const *> compiler_args{ jtl::move(compiler_args_res.expect_ok()) };
 
-    auto const modules_rlocked{ __rt_ctx->loaded_modules_in_order.rlock() };
-    for(auto const &it : *modules_rlocked)
+    auto const modules{ linked_modules(module) };
+    for(auto const &it : modules)
     {
       /* Core modules will be linked as part of libjank-standalone.a. */
       if(runtime::module::is_core_module(it))
@@ -264,7 +339,7 @@ int main(int argc, const char** argv)
       }
     }
 
-    auto const entrypoint_path{ gen_entrypoint(module) };
+    auto const entrypoint_path{ gen_entrypoint(module, modules) };
     compiler_args.push_back(strdup("-x"));
     compiler_args.push_back(strdup("c++"));
     compiler_args.push_back(strdup(entrypoint_path.c_str()));
@@ -281,6 +356,10 @@ int main(int argc, const char** argv)
       compiler_args.push_back(strdup(lib));
     }
 
+#ifdef JANK_REGEX_RE2
+    compiler_args.push_back(strdup("-lre2"));
+#endif
+
     for(auto const &lib : util::cli::opts.libs)
     {
       compiler_args.push_back(strdup(util::format("-l{}", lib).c_str()));
@@ -304,6 +383,18 @@ int main(int argc, const char** argv)
       }
     } };
 
+    if(util::cli::opts.whole_program)
+    {
+      if constexpr(jtl::current_platform == jtl::platform::macos_like)
+      {
+        compiler_args.push_back(strdup("-Wl,-dead_strip"));
+      }
+      else
+      {
+        compiler_args.push_back(strdup("-Wl,--gc-sections"));
+      }
+    }
+
     compiler_args.push_back(strdup("-o"));
     compiler_args.push_back(strdup(util::cli::opts.output_filename.c_str()));
 
@@ -0,0 +1,393 @@
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+#include <jank/async_native.hpp>
+#include <jank/runtime/convert/function.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core.hpp>
+#include <jank/runtime/core/equal.hpp>
+#include <jank/runtime/core/seq_ext.hpp>
+#include <jank/runtime/executor.hpp>
+#include <jank/runtime/obj/channel.hpp>
+#include <jank/runtime/obj/promise.hpp>
+#include <jank/runtime/obj/native_function_wrapper.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
+#include <jank/runtime/obj/persistent_vector.hpp>
+#include <jank/runtime/obj/keyword.hpp>
+#include <jank/runtime/obj/opaque_box.hpp>
+#include <jank/runtime/rtti.hpp>
+#include <jank/runtime/timer_wheel.hpp>
+#include <jank/util/fmt/print.hpp>
+
+namespace jank::async_native
+{
+  using namespace jank;
+  using namespace jank::runtime;
+
+  static object_ref keyword(char const * const name)
+  {
+    return __rt_ctx->intern_keyword(name).expect_ok();
+  }
+
+  static obj::channel_ref to_channel(object_ref const o)
+  {
+    return try_object<obj::channel>(o);
+  }
+
+  /* There's no coroutine transform for go blocks, so a parked op waits on its promise.
+   * On a pool worker, that means running other queued tasks until it's delivered, the
+   * same as derefing a future does, so that parked go blocks don't starve the pool of
+   * the very blocks which would wake them. */
+  static object_ref park(obj::promise_ref const p)
+  {
+    auto &pool{ pooled_executor() };
+    if(!pool.is_worker_thread())
+    {
+      return p->deref();
+    }
+
+    while(!p->is_realized())
+    {
+      if(!pool.run_pending_task())
+      {
+        p->deref(1, jank_nil());
+      }
+    }
+    return p->deref();
+  }
+
+  static object_ref chan(object_ref const kind, object_ref const n)
+  {
+    using buffer_kind = obj::channel::buffer_kind;
+
+    auto const size{ static_cast<usize>(std::max<i64>(to_int(n), 0)) };
+    if(runtime::equal(kind, keyword("none")))
+    {
+      return make_box<obj::channel>(buffer_kind::none, 0);
+    }
+    if(runtime::equal(kind, keyword("fixed")))
+    {
+      return make_box<obj::channel>(buffer_kind::fixed, size);
+    }
+    if(runtime::equal(kind, keyword("dropping")))
+    {
+      return make_box<obj::channel>(buffer_kind::dropping, size);
+    }
+    if(runtime::equal(kind, keyword("sliding")))
+    {
+      return make_box<obj::channel>(buffer_kind::sliding, size);
+    }
+    throw make_box(util::format("Invalid channel buffer: {}", runtime::to_code_string(kind)))
+      .erase();
+  }
+
+  static object_ref close(object_ref const ch)
+  {
+    to_channel(ch)->close();
+    return jank_nil();
+  }
+
+  static object_ref put(object_ref const ch, object_ref const val, object_ref const fn)
+  {
+    auto const res{ to_channel(ch)->put(val, obj::channel::make_handler(fn)) };
+    if(!res.done)
+    {
+      return jank_true;
+    }
+    if(fn.is_some())
+    {
+      dynamic_call(fn, res.val);
+    }
+    return res.val;
+  }
+
+  static object_ref take(object_ref const ch, object_ref const fn)
+  {
+    auto const res{ to_channel(ch)->take(obj::channel::make_handler(fn)) };
+    if(res.done)
+    {
+      dynamic_call(fn, res.val);
+    }
+    return jank_nil();
+  }
+
+  static object_ref wait_put(object_ref const ch, object_ref const val, bool const parks)
+  {
+    auto const p{ make_box<obj::promise>() };
+    auto const res{ to_channel(ch)->put(val, obj::channel::make_handler(p)) };
+    if(res.done)
+    {
+      return res.val;
+    }
+    return parks ? park(p) : p->deref();
+  }
+
+  static object_ref wait_take(object_ref const ch, bool const parks)
+  {
+    auto const p{ make_box<obj::promise>() };
+    auto const res{ to_channel(ch)->take(obj::channel::make_handler(p)) };
+    if(res.done)
+    {
+      return res.val;
+    }
+    return parks ? park(p) : p->deref();
+  }
+
+  static object_ref blocking_put(object_ref const ch, object_ref const val)
+  {
+    return wait_put(ch, val, false);
+  }
+
+  static object_ref parking_put(object_ref const ch, object_ref const val)
+  {
+    return wait_put(ch, val, true);
+  }
+
+  static object_ref blocking_take(object_ref const ch)
+  {
+    return wait_take(ch, false);
+  }
+
+  static object_ref parking_take(object_ref const ch)
+  {
+    return wait_take(ch, true);
+  }
+
+  static object_ref offer(object_ref const ch, object_ref const val)
+  {
+    auto const p{ make_box<obj::promise>() };
+    auto const h{ obj::channel::make_handler(p) };
+    auto const res{ to_channel(ch)->put(val, h) };
+    if(res.done)
+    {
+      return res.val;
+    }
+    /* If we can't give it up, a take got to it first, and the promise is on its way. */
+    if(obj::channel::commit(*h->flag))
+    {
+      return jank_nil();
+    }
+    return p->deref();
+  }
+
+  static object_ref poll(object_ref const ch)
+  {
+    auto const p{ make_box<obj::promise>() };
+    auto const h{ obj::channel::make_handler(p) };
+    auto const res{ to_channel(ch)->take(h) };
+    if(res.done)
+    {
+      return res.val;
+    }
+    if(obj::channel::commit(*h->flag))
+    {
+      return jank_nil();
+    }
+    return p->deref();
+  }
+
+  static object_ref alts(object_ref const ops, object_ref const opts, bool const parks)
+  {
+    native_vector<object_ref> shuffled;
+    runtime::for_each(ops, [&](object_ref const op) { shuffled.push_back(op); });
+    if(!truthy(get(opts, keyword("priority"))))
+    {
+      static thread_local std::minstd_rand rng{ std::random_device{}() };
+      std::shuffle(shuffled.begin(), shuffled.end(), rng);
+    }
+
+    /* Every op shares one flag, so only the first to complete counts. The rest stay
+     * queued as inactive handlers until their channels sweep them out. */
+    auto const p{ make_box<obj::promise>() };
+    auto const flag{ new(GC) obj::channel::handler_flag{} };
+    for(auto const &op : shuffled)
+    {
+      auto const h{ new(GC) obj::channel::handler{ flag, p, jank_nil() } };
+      obj::channel::result res;
+      if(is_vector(op))
+      {
+        h->port = nth(op, make_box(0));
+        res = to_channel(h->port)->put(nth(op, make_box(1)), h);
+      }
+      else
+      {
+        h->port = op;
+        res = to_channel(op)->take(h);
+      }
+
+      if(res.done)
+      {
+        return make_box<obj::persistent_vector>(std::in_place, res.val, h->port);
+      }
+    }
+
+    auto const default_kw{ keyword("default") };
+    if(contains(opts, default_kw) && obj::channel::commit(*flag))
+    {
+      return make_box<obj::persistent_vector>(std::in_place, get(opts, default_kw), default_kw);
+    }
+    return parks ? park(p) : p->deref();
+  }
+
+  static object_ref blocking_alts(object_ref const ops, object_ref const opts)
+  {
+    return alts(ops, opts, false);
+  }
+
+  static object_ref parking_alts(object_ref const ops, object_ref const opts)
+  {
+    return alts(ops, opts, true);
+  }
+
+  static object_ref timeout(object_ref const ms)
+  {
+    auto const ret{ make_box<obj::channel>() };
+    /* The wheel's timers are GC allocated, so the channel is kept alive by the task. */
+    scheduler().schedule(std::chrono::milliseconds{ to_int(ms) },
+                         std::chrono::milliseconds{},
+                         [ch = ret.data] { ch->close(); });
+    return ret;
+  }
+
+  struct block
+  {
+    object_ref fn;
+    persistent_hash_map_ref bindings;
+    obj::channel_ref ret;
+  };
+
+  static void run_block(block const &b)
+  {
+    object_ref val{};
+    try
+    {
+      context::binding_scope const scope{ b.bindings };
+      val = dynamic_call(b.fn);
+    }
+    catch(std::exception const &e)
+    {
+      util::println(stderr, "Uncaught exception in go block: {}", e.what());
+    }
+    catch(object_ref const e)
+    {
+      util::println(stderr, "Uncaught exception in go block: {}", runtime::to_code_string(e));
+    }
+
+    if(val.is_some())
+    {
+      b.ret->put(val, obj::channel::make_handler(jank_nil()));
+    }
+    b.ret->close();
+  }
+
+  /* Runs fn on the executor, conveying the thread bindings. This gives a channel which
+   * receives fn's result, unless it's nil, and then closes. */
+  static object_ref spawn(object_ref const fn, executor &e)
+  {
+    auto const ret{ make_box<obj::channel>(obj::channel::buffer_kind::fixed, 1) };
+    auto const b{ new(GC) block{ fn, __rt_ctx->get_thread_bindings(), ret } };
+    e.submit([b] { run_block(*b); });
+    return ret;
+  }
+
+  struct scheduled
+  {
+    object_ref fn;
+    persistent_hash_map_ref bindings;
+    timer_wheel::timer *timer{};
+  };
+
+  static constexpr auto scheduled_type{ "jank::async_native::scheduled *" };
+
+  static void run_scheduled(scheduled const &s)
+  {
+    try
+    {
+      context::binding_scope const scope{ s.bindings };
+      dynamic_call(s.fn);
+    }
+    catch(std::exception const &e)
+    {
+      util::println(stderr, "Uncaught exception in scheduled task: {}", e.what());
+    }
+    catch(object_ref const e)
+    {
+      util::println(stderr,
+                    "Uncaught exception in scheduled task: {}",
+                    runtime::to_code_string(e));
+    }
+  }
+
+  /* The timer only hands the task over to the pooled executor, so that a slow task doesn't
+   * hold up every other timer. The thread bindings are conveyed, as with go blocks. */
+  static object_ref
+  schedule_at_fixed_rate(object_ref const delay_ms, object_ref const period_ms, object_ref const fn)
+  {
+    auto const s{ new(GC) scheduled{ fn, __rt_ctx->get_thread_bindings() } };
+    s->timer = scheduler().schedule(std::chrono::milliseconds{ to_int(delay_ms) },
+                                    std::chrono::milliseconds{ to_int(period_ms) },
+                                    [s] { pooled_executor().submit([s] { run_scheduled(*s); }); });
+    return make_box<obj::opaque_box>(s, scheduled_type);
+  }
+
+  static object_ref schedule(object_ref const delay_ms, object_ref const fn)
+  {
+    return schedule_at_fixed_rate(delay_ms, make_box(0), fn);
+  }
+
+  static object_ref cancel(object_ref const o)
+  {
+    auto const box{ try_object<obj::opaque_box>(o) };
+    if(box->canonical_type != scheduled_type)
+    {
+      throw make_box(util::format("{} is not a scheduled task", runtime::to_code_string(o)))
+        .erase();
+    }
+    return make_box(scheduler().cancel(static_cast<scheduled *>(box->data.data)->timer));
+  }
+
+  static object_ref go(object_ref const fn)
+  {
+    return spawn(fn, pooled_executor());
+  }
+
+  static object_ref thread(object_ref const fn)
+  {
+    return spawn(fn, solo_executor());
+  }
+}
+
+extern "C" void jank_load_jank_async_native()
+{
+  using namespace jank;
+  using namespace jank::runtime;
+
+  auto const ns(__rt_ctx->intern_ns("jank.async-native"));
+
+  auto const intern_fn([=](jtl::immutable_string const &name, auto const fn) {
+    ns->intern_var(name)->bind_root(
+      make_box<obj::native_function_wrapper>(convert_function(fn))
+        ->with_meta(obj::persistent_hash_map::create_unique(std::make_pair(
+          __rt_ctx->intern_keyword("name").expect_ok(),
+          make_box(obj::symbol{ __rt_ctx->current_ns()->to_string(), name }.to_string())))));
+  });
+  intern_fn("chan", &async_native::chan);
+  intern_fn("close!", &async_native::close);
+  intern_fn("put!", &async_native::put);
+  intern_fn("take!", &async_native::take);
+  intern_fn(">!!", &async_native::blocking_put);
+  intern_fn(">!", &async_native::parking_put);
+  intern_fn("<!!", &async_native::blocking_take);
+  intern_fn("<!", &async_native::parking_take);
+  intern_fn("offer!", &async_native::offer);
+  intern_fn("poll!", &async_native::poll);
+  intern_fn("alts!!", &async_native::blocking_alts);
+  intern_fn("alts!", &async_native::parking_alts);
+  intern_fn("timeout", &async_native::timeout);
+  intern_fn("schedule", &async_native::schedule);
+  intern_fn("schedule-at-fixed-rate", &async_native::schedule_at_fixed_rate);
+  intern_fn("cancel", &async_native::cancel);
+  intern_fn("go*", &async_native::go);
+  intern_fn("thread*", &async_native::thread);
+}
@@ -0,0 +1,830 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+
+#include <uuid.h>
+
+#include <jank/binary_native.hpp>
+#include <jank/runtime/convert/function.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/obj/big_decimal.hpp>
+#include <jank/runtime/obj/big_integer.hpp>
+#include <jank/runtime/obj/character.hpp>
+#include <jank/runtime/obj/inst.hpp>
+#include <jank/runtime/obj/keyword.hpp>
+#include <jank/runtime/obj/native_function_wrapper.hpp>
+#include <jank/runtime/obj/opaque_box.hpp>
+#include <jank/runtime/obj/persistent_array_map.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
+#include <jank/runtime/obj/persistent_hash_set.hpp>
+#include <jank/runtime/obj/persistent_list.hpp>
+#include <jank/runtime/obj/persistent_sorted_map.hpp>
+#include <jank/runtime/obj/persistent_int_map.hpp>
+#include <jank/runtime/obj/persistent_sorted_set.hpp>
+#include <jank/runtime/obj/persistent_vector.hpp>
+#include <jank/runtime/obj/ratio.hpp>
+#include <jank/runtime/obj/tagged_literal.hpp>
+#include <jank/runtime/obj/uuid.hpp>
+#include <jank/runtime/rtti.hpp>
+#include <jank/runtime/sequence_range.hpp>
+#include <jank/util/fmt.hpp>
+
+/* A compact binary format for jank data, which is much quicker to write and read than EDN.
+ *
+ * Each message is the size of its body, as a varint, followed by the body, which is one
+ * value. Each value is a tag byte followed by its data. Sizes, counts, and integers are
+ * LEB128 varints, with signed integers zigzag encoded so small negative numbers stay
+ * small. Reals are their 8 bytes, little endian. Big numbers and ratios are their decimal
+ * digits, since that's what boost gives us round trips for. Collections are their count
+ * followed by their items, or keys and values for maps.
+ *
+ * Keywords and short strings are put into a dictionary the first time they're written, so
+ * each later one is only a reference to its index. An encoder and a decoder each keep
+ * their dictionary across messages, so a stream of messages which have the same keys
+ * only spells each key out once. Metadata isn't encoded. */
+namespace jank::binary_native
+{
+  using namespace jank;
+  using namespace jank::runtime;
+
+  enum class tag : u8
+  {
+    nil,
+    boolean_false,
+    boolean_true,
+    integer,
+    real,
+    big_integer,
+    big_decimal,
+    ratio,
+    string,
+    keyword,
+    symbol,
+    character,
+    list,
+    vector,
+    map,
+    sorted_map,
+    set,
+    sorted_set,
+    uuid,
+    inst,
+    tagged_literal,
+    /* Followed by a keyword or string, which is added to the dictionary. */
+    dictionary_def,
+    /* Followed by the dictionary index of a keyword or string written before. */
+    dictionary_ref
+  };
+
+  /* Both of these bound what a peer can make us hold on to. */
+  static constexpr usize max_dictionary_size{ 4096 };
+  static constexpr usize max_dictionary_string_size{ 32 };
+  /* Decoding is recursive, so untrusted data can't be allowed to nest without bound. */
+  static constexpr usize max_depth{ 512 };
+  static constexpr usize max_varint_size{ 10 };
+
+  static u64 zigzag(i64 const i)
+  {
+    return (static_cast<u64>(i) << 1) ^ static_cast<u64>(i >> 63);
+  }
+
+  static i64 unzigzag(u64 const u)
+  {
+    return static_cast<i64>(u >> 1) ^ -static_cast<i64>(u & 1);
+  }
+
+  static i64 to_epoch_ns(obj::inst_time_point const &t)
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+  }
+
+  static obj::inst_time_point from_epoch_ns(i64 const ns)
+  {
+    return obj::inst_time_point{ std::chrono::duration_cast<std::chrono::system_clock::duration>(
+      std::chrono::nanoseconds{ ns }) };
+  }
+
+  /* Encodes messages straight into a buffer which is kept between messages, so once the
+   * buffer has grown to fit the largest message, encoding doesn't allocate for it. The
+   * first max_varint_size bytes are left for the size, which is only known once the body
+   * is written, so the body never needs to be moved. The encoded message is valid until
+   * the next one is encoded.
+   *
+   * Lists, vectors, maps, and sets are written right from their storage. Any other seq
+   * is written as a list, and any other map as a map. This isn't thread safe. */
+  struct encoder
+  {
+    jtl::immutable_string_view encode(object_ref const o)
+    {
+      buffer.assign(max_varint_size, '\0');
+      auto const mark(dictionary.size());
+      try
+      {
+        write(o, 0);
+      }
+      catch(...)
+      {
+        /* The decoder won't see this message, so it mustn't see its dictionary entries
+         * referenced by later messages either. */
+        forget_since(mark);
+        throw;
+      }
+
+      std::array<char, max_varint_size> size{};
+      auto const size_length(encode_varint(size.data(), buffer.size() - max_varint_size));
+      auto const start(max_varint_size - size_length);
+      std::copy_n(size.data(), size_length, buffer.data() + start);
+      return { buffer.data() + start, buffer.size() - start };
+    }
+
+    static usize encode_varint(char * const out, u64 u)
+    {
+      usize length{};
+      while(0x80 <= u)
+      {
+        out[length++] = static_cast<char>((u & 0x7f) | 0x80);
+        u >>= 7;
+      }
+      out[length++] = static_cast<char>(u);
+      return length;
+    }
+
+    void write_tag(tag const t)
+    {
+      buffer.push_back(static_cast<char>(t));
+    }
+
+    void write_varint(u64 const u)
+    {
+      std::array<char, max_varint_size> out{};
+      buffer.append(out.data(), encode_varint(out.data(), u));
+    }
+
+    void write_bytes(jtl::immutable_string_view const &s)
+    {
+      write_varint(s.size());
+      buffer.append(s.data(), s.size());
+    }
+
+    /* Gives whether o was written as a reference to an earlier entry. Otherwise, o is
+     * added to the dictionary, if there's room, and the caller writes it out in full. */
+    template <typename K>
+    bool write_dictionary(native_unordered_map<K, u32> &entries, K const &key, object_ref const o)
+    {
+      auto const found(entries.find(key));
+      if(found != entries.end())
+      {
+        write_tag(tag::dictionary_ref);
+        write_varint(found->second);
+        return true;
+      }
+      if(dictionary.size() < max_dictionary_size)
+      {
+        entries.emplace(key, static_cast<u32>(dictionary.size()));
+        dictionary.push_back(o);
+        write_tag(tag::dictionary_def);
+      }
+      return false;
+    }
+
+    void forget_since(usize const mark)
+    {
+      for(auto i(mark); i < dictionary.size(); ++i)
+      {
+        auto const o(dictionary[i]);
+        if(o->type == object_type::keyword)
+        {
+          keywords.erase(o.data);
+        }
+        else
+        {
+          strings.erase(expect_object<obj::persistent_string>(o)->data);
+        }
+      }
+      dictionary.resize(mark);
+    }
+
+    template <typename C>
+    void write_items(tag const t, C const &items, usize const depth)
+    {
+      write_tag(t);
+      write_varint(items.size());
+      for(auto const &e : items)
+      {
+        write(e, depth + 1);
+      }
+    }
+
+    template <typename C>
+    void write_entries(tag const t, C const &entries, usize const depth)
+    {
+      write_tag(t);
+      write_varint(entries.size());
+      for(auto const &kv : entries)
+      {
+        write(kv.first, depth + 1);
+        write(kv.second, depth + 1);
+      }
+    }
+
+    void write(object_ref const o, usize const depth)
+    {
+      if(max_depth < depth)
+      {
+        throw std::runtime_error{ "binary encode error: data is nested too deeply" };
+      }
+
+      switch(o->type)
+      {
+        case object_type::nil:
+          write_tag(tag::nil);
+          return;
+        case object_type::boolean:
+          write_tag(expect_object<obj::boolean>(o)->data ? tag::boolean_true
+                                                         : tag::boolean_false);
+          return;
+        case object_type::integer:
+          write_tag(tag::integer);
+          write_varint(zigzag(expect_object<obj::integer>(o)->data));
+          return;
+        case object_type::real:
+          {
+            write_tag(tag::real);
+            auto const bits(std::bit_cast<u64>(expect_object<obj::real>(o)->data));
+            for(usize i{}; i < sizeof(bits); ++i)
+            {
+              buffer.push_back(static_cast<char>(bits >> (i * 8)));
+            }
+            return;
+          }
+        case object_type::big_integer:
+          write_tag(tag::big_integer);
+          write_bytes(expect_object<obj::big_integer>(o)->data.str());
+          return;
+        case object_type::big_decimal:
+          write_tag(tag::big_decimal);
+          write_bytes(expect_object<obj::big_decimal>(o)->data.str());
+          return;
+        case object_type::ratio:
+          {
+            auto const &data(expect_object<obj::ratio>(o)->data);
+            write_tag(tag::ratio);
+            write_bytes(data.numerator.str());
+            write_bytes(data.denominator.str());
+            return;
+          }
+        case object_type::persistent_string:
+          {
+            auto const &s(expect_object<obj::persistent_string>(o)->data);
+            if(!s.empty() && s.size() <= max_dictionary_string_size
+               && write_dictionary(strings, s, o))
+            {
+              return;
+            }
+            write_tag(tag::string);
+            write_bytes(s);
+            return;
+          }
+        case object_type::keyword:
+          {
+            if(write_dictionary(keywords, o.data, o))
+            {
+              return;
+            }
+            auto const sym(expect_object<obj::keyword>(o)->sym);
+            write_tag(tag::keyword);
+            write_bytes(sym->ns);
+            write_bytes(sym->name);
+            return;
+          }
+        case object_type::symbol:
+          {
+            auto const sym(expect_object<obj::symbol>(o));
+            write_tag(tag::symbol);
+            write_bytes(sym->ns);
+            write_bytes(sym->name);
+            return;
+          }
+        case object_type::character:
+          write_tag(tag::character);
+          write_bytes(expect_object<obj::character>(o)->data);
+          return;
+        case object_type::persistent_list:
+          write_items(tag::list, expect_object<obj::persistent_list>(o)->data, depth);
+          return;
+        case object_type::persistent_vector:
+          write_items(tag::vector, expect_object<obj::persistent_vector>(o)->data, depth);
+          return;
+        case object_type::persistent_array_map:
+          write_entries(tag::map, expect_object<obj::persistent_array_map>(o)->data, depth);
+          return;
+        case object_type::persistent_hash_map:
+          write_entries(tag::map, expect_object<obj::persistent_hash_map>(o)->data, depth);
+          return;
+        case object_type::persistent_sorted_map:
+          write_entries(tag::sorted_map,
+                        expect_object<obj::persistent_sorted_map>(o)->data,
+                        depth);
+          return;
+        case object_type::persistent_int_map:
+          write_entries(tag::map, expect_object<obj::persistent_int_map>(o)->data, depth);
+          return;
+        case object_type::persistent_hash_set:
+          write_items(tag::set, expect_object<obj::persistent_hash_set>(o)->data, depth);
+          return;
+        case object_type::persistent_sorted_set:
+          write_items(tag::sorted_set, expect_object<obj::persistent_sorted_set>(o)->data, depth);
+          return;
+        case object_type::uuid:
+          {
+            write_tag(tag::uuid);
+            for(auto const b : expect_object<obj::uuid>(o)->value->as_bytes())
+            {
+              buffer.push_back(static_cast<char>(b));
+            }
+            return;
+          }
+        case object_type::inst:
+          write_tag(tag::inst);
+          write_varint(zigzag(to_epoch_ns(expect_object<obj::inst>(o)->value)));
+          return;
+        case object_type::tagged_literal:
+          {
+            auto const typed_o(expect_object<obj::tagged_literal>(o));
+            write_tag(tag::tagged_literal);
+            write(typed_o->tag, depth + 1);
+            write(typed_o->form, depth + 1);
+            return;
+          }
+        default:
+          break;
+      }
+
+      /* The count of anything else may not be known up front, so we gather it first. */
+      if(is_map(o))
+      {
+        native_vector<std::pair<object_ref, object_ref>> entries;
+        for_each_item(o, [&](object_ref const e) {
+          entries.emplace_back(runtime::first(e), runtime::second(e));
+        });
+        write_entries(tag::map, entries, depth);
+        return;
+      }
+      if(is_seqable(o))
+      {
+        native_vector<object_ref> items;
+        for_each_item(o, [&](object_ref const e) { items.push_back(e); });
+        write_items(tag::list, items, depth);
+        return;
+      }
+
+      throw std::runtime_error{ util::format("binary encode error: unable to encode {}",
+                                             runtime::to_code_string(o)) };
+    }
+
+    native_transient_string buffer;
+    /* Everything in the dictionary, by index. */
+    native_vector<object_ref> dictionary;
+    native_unordered_map<object *, u32> keywords;
+    native_unordered_map<jtl::immutable_string, u32> strings;
+  };
+
+  [[noreturn]]
+  static void invalid_data(jtl::immutable_string const &message)
+  {
+    throw std::runtime_error{ util::format("binary decode error: {}", message) };
+  }
+
+  /* Reads the body of a single, whole message. */
+  struct reader
+  {
+    usize remaining() const
+    {
+      return static_cast<usize>(end - pos);
+    }
+
+    u8 byte()
+    {
+      if(pos == end)
+      {
+        invalid_data("unexpected end of message");
+      }
+      return static_cast<u8>(*pos++);
+    }
+
+    u64 varint()
+    {
+      u64 ret{};
+      for(u32 shift{}; shift < 64; shift += 7)
+      {
+        auto const b(byte());
+        ret |= static_cast<u64>(b & 0x7f) << shift;
+        if((b & 0x80) == 0)
+        {
+          return ret;
+        }
+      }
+      invalid_data("varint is too long");
+    }
+
+    /* Every item takes at least a byte, so a count larger than what's left can't be
+     * right, and we don't want to reserve room for it. */
+    usize count()
+    {
+      auto const ret(varint());
+      if(remaining() < ret)
+      {
+        invalid_data("count is larger than the message");
+      }
+      return ret;
+    }
+
+    jtl::immutable_string_view bytes()
+    {
+      auto const size(count());
+      jtl::immutable_string_view const ret{ pos, size };
+      pos += size;
+      return ret;
+    }
+
+    char const *pos{};
+    char const *end{};
+  };
+
+  /* Decodes a stream of messages, which can come in chunks of any size. Only the bytes of
+   * a message which is cut off are held on to between chunks. Each collection is built
+   * through a transient, or straight into an array map when it's small enough.
+   *
+   * The decoder keeps the dictionary of the encoder which wrote the stream, so it has to
+   * see every message that encoder wrote, in order. This isn't thread safe. */
+  struct decoder
+  {
+    /* Decodes all of the chunk, pushing each message which it completes onto the end of
+     * messages. After an error, the decoder is reset, since we can't tell where the next
+     * message would start. */
+    void feed(jtl::immutable_string_view const &chunk, native_vector<object_ref> &messages)
+    {
+      try
+      {
+        if(pending.empty())
+        {
+          auto const used(decode_messages(chunk.data(), chunk.size(), messages));
+          pending.append(chunk.data() + used, chunk.size() - used);
+        }
+        else
+        {
+          pending.append(chunk.data(), chunk.size());
+          auto const used(decode_messages(pending.data(), pending.size(), messages));
+          pending.erase(0, used);
+        }
+      }
+      catch(...)
+      {
+        reset();
+        throw;
+      }
+    }
+
+    void reset()
+    {
+      pending.clear();
+      dictionary.clear();
+    }
+
+    /* Gives the size of the body and the size of the varint before it, if all of the
+     * varint is here. */
+    static jtl::option<std::pair<usize, usize>>
+    message_header(char const * const data, usize const size)
+    {
+      u64 body_size{};
+      for(usize i{}; i < max_varint_size; ++i)
+      {
+        if(i == size)
+        {
+          return none;
+        }
+        auto const b(static_cast<u8>(data[i]));
+        body_size |= static_cast<u64>(b & 0x7f) << (i * 7);
+        if((b & 0x80) == 0)
+        {
+          return std::make_pair(static_cast<usize>(body_size), i + 1);
+        }
+      }
+      invalid_data("message size is too long");
+    }
+
+    /* Gives how many bytes were used by the messages which were complete. */
+    usize decode_messages(char const * const data,
+                          usize const size,
+                          native_vector<object_ref> &messages)
+    {
+      usize used{};
+      while(used < size)
+      {
+        auto const header(message_header(data + used, size - used));
+        if(header.is_none())
+        {
+          break;
+        }
+        auto const [body_size, header_size](header.unwrap());
+        if(size - used - header_size < body_size)
+        {
+          break;
+        }
+
+        reader r{ data + used + header_size, data + used + header_size + body_size };
+        messages.push_back(read(r, 0));
+        if(r.pos != r.end)
+        {
+          invalid_data("trailing bytes after value");
+        }
+        used += header_size + body_size;
+      }
+      return used;
+    }
+
+    object_ref read(reader &r, usize const depth)
+    {
+      if(max_depth < depth)
+      {
+        invalid_data("data is nested too deeply");
+      }
+      return read_tagged(r, static_cast<tag>(r.byte()), depth);
+    }
+
+    object_ref read_tagged(reader &r, tag const t, usize const depth)
+    {
+      switch(t)
+      {
+        case tag::nil:
+          return jank_nil();
+        case tag::boolean_false:
+          return jank_false;
+        case tag::boolean_true:
+          return jank_true;
+        case tag::integer:
+          return make_box(unzigzag(r.varint()));
+        case tag::real:
+          {
+            u64 bits{};
+            for(usize i{}; i < sizeof(bits); ++i)
+            {
+              bits |= static_cast<u64>(r.byte()) << (i * 8);
+            }
+            return make_box(std::bit_cast<f64>(bits));
+          }
+        case tag::big_integer:
+          return make_box<obj::big_integer>(jtl::immutable_string{ r.bytes() });
+        case tag::big_decimal:
+          return make_box<obj::big_decimal>(jtl::immutable_string{ r.bytes() });
+        case tag::ratio:
+          {
+            auto const numerator(r.bytes());
+            auto const denominator(r.bytes());
+            return obj::ratio::create(
+              native_big_integer{ std::string{ numerator.data(), numerator.size() } },
+              native_big_integer{ std::string{ denominator.data(), denominator.size() } });
+          }
+        case tag::string:
+          return make_box(r.bytes());
+        case tag::keyword:
+          {
+            jtl::immutable_string const ns{ r.bytes() };
+            jtl::immutable_string const name{ r.bytes() };
+            auto const res(__rt_ctx->intern_keyword(ns, name, true));
+            if(res.is_err())
+            {
+              invalid_data(res.expect_err());
+            }
+            return res.expect_ok();
+          }
+        case tag::symbol:
+          {
+            jtl::immutable_string ns{ r.bytes() };
+            jtl::immutable_string name{ r.bytes() };
+            return make_box<obj::symbol>(jtl::move(ns), jtl::move(name));
+          }
+        case tag::character:
+          return make_box<obj::character>(jtl::immutable_string{ r.bytes() });
+        case tag::list:
+          {
+            native_vector<object_ref> items;
+            auto const count(r.count());
+            items.reserve(count);
+            for(usize i{}; i < count; ++i)
+            {
+              items.push_back(read(r, depth + 1));
+            }
+            return make_box<obj::persistent_list>(std::in_place, items.rbegin(), items.rend());
+          }
+        case tag::vector:
+          {
+            runtime::detail::native_transient_vector transient;
+            auto const count(r.count());
+            for(usize i{}; i < count; ++i)
+            {
+              transient.push_back(read(r, depth + 1));
+            }
+            return make_box<obj::persistent_vector>(transient.persistent());
+          }
+        case tag::map:
+          {
+            auto const count(r.count());
+            if(count <= runtime::detail::native_array_map::max_size)
+            {
+              runtime::detail::native_array_map map;
+              map.reserve(static_cast<u8>(count));
+              for(usize i{}; i < count; ++i)
+              {
+                auto const key(read(r, depth + 1));
+                map.insert_or_assign(key, read(r, depth + 1));
+              }
+              return make_box<obj::persistent_array_map>(jtl::move(map));
+            }
+
+            runtime::detail::native_transient_hash_map transient;
+            for(usize i{}; i < count; ++i)
+            {
+              auto const key(read(r, depth + 1));
+              transient.set(key, read(r, depth + 1));
+            }
+            return make_box<obj::persistent_hash_map>(jtl::option<object_ref>{},
+                                                      transient.persistent());
+          }
+        case tag::sorted_map:
+          {
+            runtime::detail::native_transient_sorted_map transient;
+            auto const count(r.count());
+            for(usize i{}; i < count; ++i)
+            {
+              auto const key(read(r, depth + 1));
+              transient.set(key, read(r, depth + 1));
+            }
+            return make_box<obj::persistent_sorted_map>(transient.persistent());
+          }
+        case tag::set:
+          {
+            runtime::detail::native_transient_hash_set transient;
+            auto const count(r.count());
+            for(usize i{}; i < count; ++i)
+            {
+              transient.insert(read(r, depth + 1));
+            }
+            return make_box<obj::persistent_hash_set>(transient.persistent());
+          }
+        case tag::sorted_set:
+          {
+            runtime::detail::native_transient_sorted_set transient;
+            auto const count(r.count());
+            for(usize i{}; i < count; ++i)
+            {
+              transient.insert(read(r, depth + 1));
+            }
+            return make_box<obj::persistent_sorted_set>(transient.persistent());
+          }
+        case tag::uuid:
+          {
+            std::array<uuids::uuid::value_type, 16> bytes{};
+            for(auto &b : bytes)
+            {
+              b = r.byte();
+            }
+            return make_box<obj::uuid>(jtl::make_ref<uuids::uuid>(bytes));
+          }
+        case tag::inst:
+          {
+            auto const ret(make_box<obj::inst>());
+            ret->value = from_epoch_ns(unzigzag(r.varint()));
+            return ret;
+          }
+        case tag::tagged_literal:
+          {
+            auto const literal_tag(read(r, depth + 1));
+            return make_box<obj::tagged_literal>(literal_tag, read(r, depth + 1));
+          }
+        case tag::dictionary_def:
+          {
+            auto const entry_tag(static_cast<tag>(r.byte()));
+            if(entry_tag != tag::keyword && entry_tag != tag::string)
+            {
+              invalid_data("only keywords and strings can be in the dictionary");
+            }
+            auto const ret(read_tagged(r, entry_tag, depth));
+            if(dictionary.size() < max_dictionary_size)
+            {
+              dictionary.push_back(ret);
+            }
+            return ret;
+          }
+        case tag::dictionary_ref:
+          {
+            auto const index(r.varint());
+            if(dictionary.size() <= index)
+            {
+              invalid_data(util::format("unknown dictionary entry {}", index));
+            }
+            return dictionary[index];
+          }
+      }
+
+      invalid_data(util::format("unknown tag {}", static_cast<u32>(t)));
+    }
+
+    native_transient_string pending;
+    native_vector<object_ref> dictionary;
+  };
+
+  static constexpr auto encoder_type{ "jank::binary_native::encoder *" };
+  static constexpr auto decoder_type{ "jank::binary_native::decoder *" };
+
+  static encoder &to_encoder(object_ref const o)
+  {
+    auto const box{ try_object<obj::opaque_box>(o) };
+    if(box->canonical_type != encoder_type)
+    {
+      throw std::runtime_error{ util::format("{} is not a binary encoder",
+                                             runtime::to_code_string(o)) };
+    }
+    return *static_cast<encoder *>(box->data.data);
+  }
+
+  static decoder &to_decoder(object_ref const o)
+  {
+    auto const box{ try_object<obj::opaque_box>(o) };
+    if(box->canonical_type != decoder_type)
+    {
+      throw std::runtime_error{ util::format("{} is not a binary decoder",
+                                             runtime::to_code_string(o)) };
+    }
+    return *static_cast<decoder *>(box->data.data);
+  }
+
+  static object_ref make_encoder()
+  {
+    return make_box<obj::opaque_box>(new(GC) encoder{}, encoder_type);
+  }
+
+  static object_ref make_decoder()
+  {
+    return make_box<obj::opaque_box>(new(GC) decoder{}, decoder_type);
+  }
+
+  static object_ref encode_with(object_ref const e, object_ref const o)
+  {
+    return make_box(to_encoder(e).encode(o));
+  }
+
+  static object_ref encode(object_ref const o)
+  {
+    encoder e;
+    return make_box(e.encode(o));
+  }
+
+  /* Gives a vector of each message which this chunk completes, which may be empty if the
+   * chunk only has part of a message. */
+  static object_ref feed(object_ref const d, object_ref const chunk)
+  {
+    native_vector<object_ref> messages;
+    to_decoder(d).feed(runtime::to_string(chunk), messages);
+    return make_box<obj::persistent_vector>(
+      runtime::detail::native_persistent_vector{ messages.begin(), messages.end() });
+  }
+
+  /* Decodes a single, whole message. */
+  static object_ref decode(object_ref const data)
+  {
+    decoder d;
+    native_vector<object_ref> messages;
+    auto const s(runtime::to_string(data));
+    if(d.decode_messages(s.data(), s.size(), messages) != s.size() || messages.size() != 1)
+    {
+      invalid_data("expected one whole message");
+    }
+    return messages[0];
+  }
+}
+
+extern "C" void jank_load_jank_binary_native()
+{
+  using namespace jank;
+  using namespace jank::runtime;
+
+  auto const ns(__rt_ctx->intern_ns("jank.binary-native"));
+
+  auto const intern_fn([=](jtl::immutable_string const &name, auto const fn) {
+    ns->intern_var(name)->bind_root(
+      make_box<obj::native_function_wrapper>(convert_function(fn))
+        ->with_meta(obj::persistent_hash_map::create_unique(std::make_pair(
+          __rt_ctx->intern_keyword("name").expect_ok(),
+          make_box(obj::symbol{ __rt_ctx->current_ns()->to_string(), name }.to_string())))));
+  });
+  intern_fn("encode", &binary_native::encode);
+  intern_fn("decode", &binary_native::decode);
+  intern_fn("encoder", &binary_native::make_encoder);
+  intern_fn("encode-with", &binary_native::encode_with);
+  intern_fn("decoder", &binary_native::make_decoder);
+  intern_fn("feed!", &binary_native::feed);
+}
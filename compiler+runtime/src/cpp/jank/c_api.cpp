@@ -8,14 +8,18 @@
 #include <llvm/Support/TargetSelect.h>
 #include <llvm/ExecutionEngine/Orc/Mangling.h>
 
+#include <atomic>
+#include <cstring>
 #include <utility>
 
 #include <jank/c_api.h>
 #include <jank/runtime/visit.hpp>
 #include <jank/runtime/context.hpp>
+#include <jank/runtime/isolate.hpp>
 #include <jank/runtime/core.hpp>
 #include <jank/runtime/core/meta.hpp>
 #include <jank/aot/resource.hpp>
+#include <jank/jit/tiering.hpp>
 #include <jank/error/runtime.hpp>
 #include <jank/profile/time.hpp>
 #include <jank/util/scope_exit.hpp>
@@ -49,6 +53,61 @@ struct make_function_arity<std::index_sequence<>>
 template <usize N>
 using function_arity = typename make_function_arity<std::make_index_sequence<N>>::type;
 
+/* Calls f with args laid out in an array, as the batched entry points give them to us. */
+static object_ref
+call_with_array(object_ref const f, jank_object_ref const * const args, usize const arity)
+{
+  auto const a([&](usize const i) -> object_ref { return reinterpret_cast<object *>(args[i]); });
+
+  switch(arity)
+  {
+    case 0:
+      return dynamic_call(f);
+    case 1:
+      return dynamic_call(f, a(0));
+    case 2:
+      return dynamic_call(f, a(0), a(1));
+    case 3:
+      return dynamic_call(f, a(0), a(1), a(2));
+    case 4:
+      return dynamic_call(f, a(0), a(1), a(2), a(3));
+    case 5:
+      return dynamic_call(f, a(0), a(1), a(2), a(3), a(4));
+    case 6:
+      return dynamic_call(f, a(0), a(1), a(2), a(3), a(4), a(5));
+    case 7:
+      return dynamic_call(f, a(0), a(1), a(2), a(3), a(4), a(5), a(6));
+    case 8:
+      return dynamic_call(f, a(0), a(1), a(2), a(3), a(4), a(5), a(6), a(7));
+    case 9:
+      return dynamic_call(f, a(0), a(1), a(2), a(3), a(4), a(5), a(6), a(7), a(8));
+    case 10:
+      return dynamic_call(f, a(0), a(1), a(2), a(3), a(4), a(5), a(6), a(7), a(8), a(9));
+    default:
+      {
+        native_vector<object_ref> rest;
+        rest.reserve(arity - max_params);
+        for(usize i{ max_params }; i < arity; ++i)
+        {
+          rest.emplace_back(a(i));
+        }
+        runtime::detail::native_persistent_list const npl{ rest.rbegin(), rest.rend() };
+        return dynamic_call(f,
+                            a(0),
+                            a(1),
+                            a(2),
+                            a(3),
+                            a(4),
+                            a(5),
+                            a(6),
+                            a(7),
+                            a(8),
+                            a(9),
+                            make_box<obj::persistent_list>(std::move(npl)));
+      }
+  }
+}
+
 extern "C"
 {
   jank_object_ref jank_eval(jank_object_ref const s)
@@ -100,6 +159,33 @@ extern "C"
     return __rt_ctx->intern_var(ns, name).expect_ok().erase().data;
   }
 
+  void jank_var_intern_table(jank_var_record const * const records, jank_usize const count)
+  {
+    native_vector<obj::symbol_ref> syms;
+    for(jank_usize begin{}; begin < count;)
+    {
+      auto const ns_name(records[begin].ns);
+      auto end(begin + 1);
+      while(end < count && std::strcmp(records[end].ns, ns_name) == 0)
+      {
+        ++end;
+      }
+
+      syms.clear();
+      for(auto i(begin); i < end; ++i)
+      {
+        syms.emplace_back(make_box<obj::symbol>("", records[i].name));
+      }
+
+      auto const vars(__rt_ctx->intern_ns(ns_name)->intern_vars(syms));
+      for(auto i(begin); i < end; ++i)
+      {
+        *records[i].slot = vars[i - begin].erase().data;
+      }
+      begin = end;
+    }
+  }
+
   jank_object_ref jank_var_bind_root(jank_object_ref const var, jank_object_ref const val)
   {
     auto const var_obj(try_object<runtime::var>(reinterpret_cast<object *>(var)));
@@ -107,6 +193,12 @@ extern "C"
     return var_obj->bind_root(val_obj).erase().data;
   }
 
+  jank_object_ref jank_var_bind_lazy_root(jank_object_ref const var, jank_object_ref (*init)())
+  {
+    auto const var_obj(try_object<runtime::var>(reinterpret_cast<object *>(var)));
+    return var_obj->bind_lazy_root(reinterpret_cast<object *(*)()>(init)).erase().data;
+  }
+
   jank_object_ref jank_var_set_dynamic(jank_object_ref const var, jank_object_ref const dynamic)
   {
     auto const var_obj(try_object<runtime::var>(reinterpret_cast<object *>(var)));
@@ -114,6 +206,25 @@ extern "C"
     return var_obj->set_dynamic(truthy(dynamic_obj)).erase().data;
   }
 
+  jank_object_ref jank_var_deref(jank_object_ref const var)
+  {
+    auto const var_obj(expect_object<runtime::var>(reinterpret_cast<object *>(var)));
+    return var_obj->deref().data;
+  }
+
+  jank_object_ref jank_var_resolve_c(char const * const ns, char const * const name)
+  {
+    return __rt_ctx->find_var(ns, name).erase().data;
+  }
+
+  jank_object_ref jank_var_invoke(jank_object_ref const var,
+                                  jank_usize const arity,
+                                  jank_object_ref const * const args)
+  {
+    auto const var_obj(expect_object<runtime::var>(reinterpret_cast<object *>(var)));
+    return call_with_array(var_obj->deref(), args, arity).erase().data;
+  }
+
   jank_object_ref jank_keyword_intern(jank_object_ref const ns, jank_object_ref const name)
   {
     auto const ns_obj(reinterpret_cast<object *>(ns));
@@ -370,6 +481,63 @@ extern "C"
       .data;
   }
 
+  void jank_call_batch(jank_object_ref const f,
+                       jank_usize const arity,
+                       jank_object_ref const * const args,
+                       jank_usize const count,
+                       jank_object_ref * const out)
+  {
+    auto const f_obj(reinterpret_cast<object *>(f));
+    for(usize i{}; i < count; ++i)
+    {
+      out[i] = call_with_array(f_obj, args + (i * arity), arity).erase().data;
+    }
+  }
+
+  jank_object_ref
+  jank_keyword_get1(void * const site, jank_object_ref const kw, jank_object_ref const m)
+  {
+    auto const kw_obj(reinterpret_cast<object *>(kw));
+    auto const m_obj(reinterpret_cast<object *>(m));
+    return static_cast<obj::keyword_call_site *>(site)->get(kw_obj, m_obj).erase().data;
+  }
+
+  jank_object_ref jank_keyword_get2(void * const site,
+                                    jank_object_ref const kw,
+                                    jank_object_ref const m,
+                                    jank_object_ref const fallback)
+  {
+    auto const kw_obj(reinterpret_cast<object *>(kw));
+    auto const m_obj(reinterpret_cast<object *>(m));
+    auto const fallback_obj(reinterpret_cast<object *>(fallback));
+    return static_cast<obj::keyword_call_site *>(site)
+      ->get(kw_obj, m_obj, fallback_obj)
+      .erase()
+      .data;
+  }
+
+  jank_object_ref
+  jank_keyword_call1(void * const site, jank_object_ref const m, jank_object_ref const kw)
+  {
+    auto const m_obj(reinterpret_cast<object *>(m));
+    auto const kw_obj(reinterpret_cast<object *>(kw));
+    return static_cast<obj::keyword_call_site *>(site)->call(m_obj, kw_obj).erase().data;
+  }
+
+  jank_object_ref jank_keyword_call2(void * const site,
+                                     jank_object_ref const m,
+                                     jank_object_ref const kw,
+                                     jank_object_ref const fallback)
+  {
+    auto const m_obj(reinterpret_cast<object *>(m));
+    auto const kw_obj(reinterpret_cast<object *>(kw));
+    auto const fallback_obj(reinterpret_cast<object *>(fallback));
+    return static_cast<obj::keyword_call_site *>(site)
+      ->call(m_obj, kw_obj, fallback_obj)
+      .erase()
+      .data;
+  }
+
   jank_object_ref jank_const_nil()
   {
     return jank_nil().data;
@@ -513,6 +681,42 @@ extern "C"
     return trans.to_persistent().erase().data;
   }
 
+  jank_object_ref jank_vector_from_array(jank_object_ref const * const items, jank_usize const size)
+  {
+    obj::transient_vector trans;
+    for(usize i{}; i < size; ++i)
+    {
+      trans.conj_in_place(reinterpret_cast<object *>(items[i]));
+    }
+    return trans.to_persistent().erase().data;
+  }
+
+  jank_object_ref jank_map_from_arrays(jank_object_ref const * const keys,
+                                       jank_object_ref const * const vals,
+                                       jank_usize const size)
+  {
+    /* Small maps are built in place, as an array map, without any transient. Later keys
+     * win over earlier ones, just like with assoc. */
+    if(size <= obj::persistent_array_map::max_size)
+    {
+      runtime::detail::native_array_map data;
+      for(usize i{}; i < size; ++i)
+      {
+        data.insert_or_assign(reinterpret_cast<object *>(keys[i]),
+                              reinterpret_cast<object *>(vals[i]));
+      }
+      return make_box<obj::persistent_array_map>(std::move(data)).erase().data;
+    }
+
+    obj::transient_hash_map trans;
+    for(usize i{}; i < size; ++i)
+    {
+      trans.assoc_in_place(reinterpret_cast<object *>(keys[i]),
+                           reinterpret_cast<object *>(vals[i]));
+    }
+    return trans.to_persistent().erase().data;
+  }
+
   jank_object_ref jank_set_create(u64 const size, ...)
   {
     /* NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) */
@@ -574,16 +778,39 @@ extern "C"
 
   jank_arity_flags jank_function_build_arity_flags(jank_u8 const highest_fixed_arity,
                                                    jank_bool const is_variadic,
-                                                   jank_bool const is_variadic_ambiguous)
+                                                   jank_bool const is_variadic_ambiguous,
+                                                   jank_bool const has_local_rest)
   {
     return behavior::callable::build_arity_flags(highest_fixed_arity,
                                                  is_variadic,
-                                                 is_variadic_ambiguous);
+                                                 is_variadic_ambiguous,
+                                                 has_local_rest);
+  }
+
+  /* Fns are only made by JIT compiled code, so whichever module our caller is in holds
+   * the code for this fn. */
+  static jit::code_owner *caller_code_owner(void const * const return_address)
+  {
+    if(!util::cli::opts.reclaim_jit_code)
+    {
+      return nullptr;
+    }
+    return __rt_ctx->jit_prc.find_code_owner(reinterpret_cast<uintptr_t>(return_address));
   }
 
   jank_object_ref jank_function_create(jank_arity_flags const arity_flags)
   {
-    return make_box<obj::jit_function>(arity_flags).erase().data;
+    auto const fn(make_box<obj::jit_function>(arity_flags));
+    fn->code_owner = caller_code_owner(__builtin_return_address(0));
+    return fn.erase().data;
+  }
+
+  jank_object_ref jank_function_create_lifted(jank_arity_flags const arity_flags)
+  {
+    auto const fn(make_box<obj::jit_function>(arity_flags));
+    fn->code_owner = caller_code_owner(__builtin_return_address(0));
+    fn->is_shared = true;
+    return fn.erase().data;
   }
 
   void
@@ -750,7 +977,25 @@ extern "C"
 
   jank_object_ref jank_closure_create(jank_arity_flags const arity_flags, void * const context)
   {
-    return make_box<obj::jit_closure>(arity_flags, context).erase().data;
+    auto const fn(make_box<obj::jit_closure>(arity_flags, context));
+    fn->code_owner = caller_code_owner(__builtin_return_address(0));
+    return fn.erase().data;
+  }
+
+  jank_object_ref
+  jank_closure_create_flat(jank_arity_flags const arity_flags, jank_usize const capture_count)
+  {
+    auto * const mem(static_cast<char *>(
+      GC_malloc(sizeof(obj::jit_closure) + capture_count * sizeof(jank_object_ref))));
+    if(!mem)
+    {
+      throw std::runtime_error{ "Unable to allocate closure" };
+    }
+    obj::jit_closure_ref const fn{ new(mem)
+                                     obj::jit_closure{ arity_flags,
+                                                       mem + sizeof(obj::jit_closure) } };
+    fn->code_owner = caller_code_owner(__builtin_return_address(0));
+    return fn.erase().data;
   }
 
   void
@@ -971,6 +1216,34 @@ extern "C"
     return integer;
   }
 
+  /* For case* with an :int test type. Anything but an integer gets a key which no branch
+   * uses, so it falls through to the default. */
+  jank_i64 jank_case_integer(jank_object_ref const o, jank_i64 const unused_key)
+  {
+    auto const o_obj(reinterpret_cast<object *>(o));
+    if(o_obj->type == object_type::integer)
+    {
+      return expect_object<obj::integer>(o_obj)->data;
+    }
+    return unused_key;
+  }
+
+  /* For tiered compilation. Adds the kind of the arg to what its feedback site has seen. */
+  void jank_feedback_record(jank_u8 * const site, jank_object_ref const o)
+  {
+    auto const o_obj(reinterpret_cast<object *>(o));
+    auto const seen(o_obj->type == object_type::integer ? jit::tiering::feedback::integer
+                      : o_obj->type == object_type::real ? jit::tiering::feedback::real
+                                                         : jit::tiering::feedback::other);
+    std::atomic_ref<jank_u8>{ *site }.fetch_or(seen, std::memory_order_relaxed);
+  }
+
+  /* For on-stack replacement of tier 0 loops. */
+  void *jank_osr_find_optimized(void * const tier0)
+  {
+    return jit::tiering::find_optimized(tier0);
+  }
+
   void jank_set_meta(jank_object_ref const o, jank_object_ref const meta)
   {
     auto const o_obj(reinterpret_cast<object *>(o));
@@ -1093,4 +1366,33 @@ extern "C"
 
     return trans.to_persistent().erase().data;
   }
+
+  jank_isolate_ref jank_isolate_create()
+  {
+    /* Hosts hold on to these outside of the GC's view, so they're uncollectable, but still
+     * scanned, since they hold the isolate's namespaces. */
+    return new(GC_MALLOC_UNCOLLECTABLE(sizeof(isolate))) isolate{};
+  }
+
+  void jank_isolate_enter(jank_isolate_ref const iso)
+  {
+    static_cast<isolate *>(iso)->enter();
+  }
+
+  void jank_isolate_exit(jank_isolate_ref const iso)
+  {
+    static_cast<isolate *>(iso)->exit();
+  }
+
+  void jank_isolate_destroy(jank_isolate_ref const iso)
+  {
+    auto const i(static_cast<isolate *>(iso));
+    if(i->entered.load())
+    {
+      throw std::runtime_error{ "can't destroy an isolate which is entered" };
+    }
+    i->~isolate();
+    GC_FREE(i);
+  }
+
 }
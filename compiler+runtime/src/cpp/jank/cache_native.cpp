@@ -0,0 +1,131 @@
+#include <jank/cache_native.hpp>
+#include <jank/runtime/convert/function.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/obj/cache.hpp>
+#include <jank/runtime/obj/native_function_wrapper.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
+#include <jank/runtime/obj/keyword.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/math.hpp>
+#include <jank/runtime/rtti.hpp>
+
+namespace jank::cache_native
+{
+  using namespace jank;
+  using namespace jank::runtime;
+
+  static object_ref cache(object_ref const opts)
+  {
+    return make_cache(opts);
+  }
+
+  static object_ref lookup(object_ref const c, object_ref const k, object_ref const fallback)
+  {
+    auto const found(try_object<obj::cache>(c)->find(obj::cache::make_key(k)));
+    return found.is_some() ? found.unwrap() : fallback;
+  }
+
+  static object_ref store(object_ref const c, object_ref const k, object_ref const v)
+  {
+    try_object<obj::cache>(c)->store(obj::cache::make_key(k), v);
+    return v;
+  }
+
+  static object_ref evict(object_ref const c, object_ref const k)
+  {
+    return make_box(try_object<obj::cache>(c)->evict(obj::cache::make_key(k)));
+  }
+
+  static object_ref clear(object_ref const c)
+  {
+    try_object<obj::cache>(c)->clear();
+    return jank_nil();
+  }
+
+  static object_ref stats(object_ref const c)
+  {
+    return try_object<obj::cache>(c)->stats();
+  }
+
+  static object_ref soft_limit()
+  {
+    return make_box(static_cast<i64>(soft_cache_limit()));
+  }
+
+  static object_ref set_soft_limit(object_ref const bytes)
+  {
+    auto const n(to_int(bytes));
+    if(n < 0)
+    {
+      throw make_box("The soft cache limit can't be negative").erase();
+    }
+    set_soft_cache_limit(static_cast<usize>(n));
+    return bytes;
+  }
+
+  static object_ref clear_soft()
+  {
+    clear_soft_caches();
+    return jank_nil();
+  }
+
+  static object_ref call_0(object_ref const c, object_ref const f)
+  {
+    return cache_call(c, f);
+  }
+
+  static object_ref call_1(object_ref const c, object_ref const f, object_ref const a)
+  {
+    return cache_call(c, f, a);
+  }
+
+  static object_ref
+  call_2(object_ref const c, object_ref const f, object_ref const a, object_ref const b)
+  {
+    return cache_call(c, f, a, b);
+  }
+
+  static object_ref call_3(object_ref const c,
+                           object_ref const f,
+                           object_ref const a,
+                           object_ref const b,
+                           object_ref const d)
+  {
+    return cache_call(c, f, a, b, d);
+  }
+
+  static object_ref call_n(object_ref const c, object_ref const f, object_ref const args)
+  {
+    return cache_call_rest(c, f, args);
+  }
+}
+
+extern "C" void jank_load_jank_cache_native()
+{
+  using namespace jank;
+  using namespace jank::runtime;
+
+  auto const ns(__rt_ctx->intern_ns("jank.cache-native"));
+
+  auto const intern_fn([=](jtl::immutable_string const &name, auto const fn) {
+    ns->intern_var(name)->bind_root(
+      make_box<obj::native_function_wrapper>(convert_function(fn))
+        ->with_meta(obj::persistent_hash_map::create_unique(std::make_pair(
+          __rt_ctx->intern_keyword("name").expect_ok(),
+          make_box(obj::symbol{ __rt_ctx->current_ns()->to_string(), name }.to_string())))));
+  });
+  intern_fn("cache", &cache_native::cache);
+  intern_fn("lookup", &cache_native::lookup);
+  intern_fn("store!", &cache_native::store);
+  intern_fn("evict!", &cache_native::evict);
+  intern_fn("clear!", &cache_native::clear);
+  intern_fn("stats", &cache_native::stats);
+  intern_fn("soft-limit", &cache_native::soft_limit);
+  intern_fn("set-soft-limit!", &cache_native::set_soft_limit);
+  intern_fn("clear-soft!", &cache_native::clear_soft);
+  intern_fn("call-0", &cache_native::call_0);
+  intern_fn("call-1", &cache_native::call_1);
+  intern_fn("call-2", &cache_native::call_2);
+  intern_fn("call-3", &cache_native::call_3);
+  intern_fn("call-n", &cache_native::call_n);
+}
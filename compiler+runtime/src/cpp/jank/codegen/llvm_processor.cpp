@@ -1,4 +1,9 @@
+#include <algorithm>
+#include <filesystem>
+#include <functional>
+#include <limits>
 #include <list>
+#include <optional>
 
 #include <Interpreter/Compatibility.h>
 #include <clang/Interpreter/CppInterOp.h>
@@ -7,6 +12,7 @@
 #include <llvm/Analysis/LoopAnalysisManager.h>
 #include <llvm/ExecutionEngine/Orc/LLJIT.h>
 #include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
+#include <llvm/IR/DIBuilder.h>
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/Module.h>
@@ -14,14 +20,20 @@
 #include <llvm/Linker/Linker.h>
 #include <llvm/Passes/PassBuilder.h>
 #include <llvm/Passes/StandardInstrumentations.h>
+#include <llvm/Support/PGOOptions.h>
+#include <llvm/Support/VirtualFileSystem.h>
 #include <llvm/Transforms/Scalar/GVN.h>
 #include <llvm/Transforms/Utils/ModuleUtils.h>
 
 #include <jank/analyze/cpp_util.hpp>
+#include <jank/analyze/pass/walk.hpp>
 #include <jank/analyze/rtti.hpp>
 #include <jank/analyze/visit.hpp>
 #include <jank/codegen/llvm_processor.hpp>
+#include <jank/jit/stats.hpp>
+#include <jank/jit/tiering.hpp>
 #include <jank/profile/time.hpp>
+#include <jank/profile/phase.hpp>
 #include <jank/runtime/context.hpp>
 #include <jank/runtime/core.hpp>
 #include <jank/runtime/core/meta.hpp>
@@ -47,7 +59,9 @@ namespace jank::codegen
   struct reusable_context
   {
     reusable_context(jtl::immutable_string const &module_name,
-                     std::unique_ptr<llvm::LLVMContext> llvm_ctx);
+                     std::unique_ptr<llvm::LLVMContext> llvm_ctx,
+                     llvm::OptimizationLevel const optimization_level,
+                     std::optional<llvm::PGOOptions> const &pgo);
 
     jtl::immutable_string module_name;
     jtl::immutable_string ctor_name;
@@ -65,6 +79,16 @@ namespace jank::codegen
     native_unordered_map<obj::symbol_ref, llvm::Value *> var_globals;
     native_unordered_map<obj::symbol_ref, llvm::Value *> var_root_globals;
     native_unordered_map<jtl::immutable_string, llvm::Value *> c_string_globals;
+    /* Every fn which we generate into this module. Only these can be called directly, since
+     * others, such as those which the interpreter made, have no IR fns for us to call. */
+    native_set<analyze::expr::function const *> module_fns;
+
+    /* With --perf or --debug, fns get line tables which point back at their jank source,
+     * so that perf, through its jitdump, and debuggers can attribute their code to jank
+     * lines. Without either, there's no builder. */
+    std::unique_ptr<llvm::DIBuilder> di_builder;
+    llvm::DICompileUnit *di_unit{};
+    native_unordered_map<jtl::immutable_string, llvm::DIFile *> di_files;
 
     /* Optimization details. */
     std::unique_ptr<llvm::LoopAnalysisManager> lam;
@@ -76,6 +100,21 @@ namespace jank::codegen
     llvm::ModulePassManager mpm;
   };
 
+  /* The core fns which tier 0 code speculates on. See jit::tiering. */
+  enum class speculated_op : u8
+  {
+    add,
+    subtract,
+    multiply,
+    increment,
+    decrement,
+    less,
+    less_equal,
+    greater,
+    greater_equal,
+    equal
+  };
+
   struct llvm_processor::impl
   {
     impl(analyze::expr::function_ref const expr,
@@ -128,11 +167,19 @@ namespace jank::codegen
     llvm::Value *gen(analyze::expr::cpp_delete_ref, analyze::expr::function_arity const &);
 
     llvm::Value *gen_var(obj::symbol_ref const qualified_name) const;
+    llvm::Value *gen_loop_deref(runtime::var const * const var,
+                                llvm::Value * const ref,
+                                llvm::FunctionCallee const deref_fn);
+    void gen_var_table() const;
     llvm::Value *gen_var_root(obj::symbol_ref const qualified_name, var_root_kind kind) const;
     llvm::Value *gen_c_string(jtl::immutable_string const &s) const;
 
     void create_function();
     void create_function(analyze::expr::function_arity const &arity);
+    void create_subprogram();
+    llvm::DIFile *debug_file(jtl::immutable_string const &path) const;
+    /* With debug info, points what's generated within the scope at the form's line. */
+    util::scope_exit gen_debug_location(runtime::object_ref const form);
     void create_global_ctor() const;
     llvm::GlobalVariable *create_global_var(jtl::immutable_string const &name) const;
 
@@ -178,6 +225,24 @@ namespace jank::codegen
     void gen_stack_restore();
     jtl::ptr<llvm::Value> gen_ret(jtl::ptr<llvm::Value> const value);
     jtl::ptr<llvm::Value> gen_ret();
+    llvm::Value *gen_self_tail_call(native_vector<expression_ref> const &arg_exprs,
+                                    expr::function_arity const &arity);
+    llvm::Function *gen_detached_fn(jtl::immutable_string const &name,
+                                    llvm::FunctionType * const type,
+                                    std::function<void(llvm::Function *)> const &body);
+    bool can_be_lazy(analyze::expr::def_ref const expr) const;
+    bool can_replace_on_stack(analyze::expr::let_ref const expr) const;
+    llvm::Value *gen_loop(analyze::expr::let_ref const expr,
+                          analyze::expr::function_arity const &arity,
+                          bool const replaceable);
+    llvm::Function *
+    gen_loop_continuation(analyze::expr::let_ref const expr,
+                          analyze::expr::function_arity const &arity,
+                          native_vector<std::pair<obj::symbol_ref, llvm::Value *>> const &live);
+    std::pair<llvm::BasicBlock *, llvm::Value *>
+    gen_speculation(speculated_op const op,
+                    llvm::ArrayRef<llvm::Value *> const args,
+                    llvm::BasicBlock * const slow);
 
     compilation_target target{};
     analyze::expr::function_ref root_fn;
@@ -202,6 +267,25 @@ namespace jank::codegen
      * the fn gen which is above us, all the way up to the module level. */
     native_unordered_map<jtl::immutable_string, Cpp::AotCall> global_rtti;
     native_vector<jtl::ptr<llvm::Value>> stack_saves;
+    /* Self tail calls store new values into these param allocas and then branch back to
+     * the start of the arity body, after restoring the stack to how it was there. */
+    jtl::ptr<llvm::BasicBlock> self_call_block;
+    jtl::ptr<llvm::Value> self_call_stack;
+    native_vector<llvm::Value *> self_call_params;
+    /* Whether we're generating a loop's continuation, for on-stack replacement. */
+    bool in_loop_continuation{};
+    /* Within the outermost loop of a fn, each non-dynamic var keeps its last deref, along
+     * with the root version it was read at. A use only derefs again when the var's version
+     * has changed, so a new root is still seen on the next use, from any thread. */
+    struct loop_deref
+    {
+      llvm::AllocaInst *value{};
+      llvm::AllocaInst *version{};
+    };
+
+    /* The branch into the outermost loop, before which each cached version is reset. */
+    llvm::Instruction *loop_deref_point{};
+    native_unordered_map<runtime::var const *, loop_deref> loop_derefs;
   };
 
   struct llvm_type_info
@@ -524,7 +608,9 @@ namespace jank::codegen
   }
 
   reusable_context::reusable_context(jtl::immutable_string const &module_name,
-                                     std::unique_ptr<llvm::LLVMContext> llvm_ctx)
+                                     std::unique_ptr<llvm::LLVMContext> llvm_ctx,
+                                     llvm::OptimizationLevel const optimization_level,
+                                     std::optional<llvm::PGOOptions> const &pgo)
     : module_name{ module_name }
     , ctor_name{ unique_munged_string("jank_global_init") }
     //, llvm_ctx{ std::make_unique<llvm::LLVMContext>() }
@@ -553,19 +639,78 @@ namespace jank::codegen
     raw_module->setTargetTriple(llvm::Triple{ util::default_target_triple().c_str() });
     raw_module->setDataLayout(__rt_ctx->jit_prc.interpreter->getExecutionEngine()->getDataLayout());
 
+    if(util::cli::opts.debug || util::cli::opts.perf_profiling_enabled)
+    {
+      di_builder = std::make_unique<llvm::DIBuilder>(*raw_module);
+      /* DWARF has no code for jank. Nothing which reads our line tables cares, though. */
+      di_unit = di_builder->createCompileUnit(llvm::dwarf::DW_LANG_C_plus_plus,
+                                              di_builder->createFile(module_name.c_str(), "."),
+                                              "jank",
+                                              util::cli::opts.optimization_level > 0,
+                                              "",
+                                              0);
+      raw_module->addModuleFlag(llvm::Module::Warning,
+                                "Debug Info Version",
+                                llvm::DEBUG_METADATA_VERSION);
+      raw_module->addModuleFlag(llvm::Module::Warning, "Dwarf Version", 4);
+    }
+
     /* TODO: Add more passes and measure the order of the passes. */
 
     si->registerCallbacks(*pic, mam.get());
 
-    llvm::PassBuilder pb;
+    llvm::PassBuilder pb{ nullptr, llvm::PipelineTuningOptions{}, pgo };
     pb.registerModuleAnalyses(*mam);
     pb.registerCGSCCAnalyses(*cgam);
     pb.registerFunctionAnalyses(*fam);
     pb.registerLoopAnalyses(*lam);
     pb.crossRegisterProxies(*lam, *fam, *cgam, *mam);
+    if(optimization_level == llvm::OptimizationLevel::O0)
+    {
+      mpm = pb.buildO0DefaultPipeline(optimization_level);
+    }
+    else
+    {
+      mpm = pb.buildPerModuleDefaultPipeline(optimization_level);
+    }
+  }
+
+  /* With tiered compilation, anything we JIT compile for eval starts out unoptimized. It's
+   * optimized later, if it gets hot. See jit::tiering. */
+  static llvm::OptimizationLevel optimization_level(compilation_target const target)
+  {
+    if(target == compilation_target::eval && jit::tiering::is_enabled())
+    {
+      return llvm::OptimizationLevel::O0;
+    }
     /* TODO: Configure this level based on the CLI optimization flag.
      * Benchmark to find the best default. */
-    mpm = pb.buildPerModuleDefaultPipeline(llvm::OptimizationLevel::O2);
+    return llvm::OptimizationLevel::O2;
+  }
+
+  /* Only modules are compiled with profiles. Code for eval is JIT compiled, where there's
+   * no profile runtime to write to, and its generated names aren't stable across runs, so
+   * a profile couldn't be matched back to it anyway. */
+  static std::optional<llvm::PGOOptions> pgo_options(compilation_target const target)
+  {
+    auto const &opts(util::cli::opts);
+    if(target != compilation_target::module
+       || (!opts.profile_generate && opts.profile_use_file.empty()))
+    {
+      return std::nullopt;
+    }
+
+    /* The raw profile is written wherever LLVM_PROFILE_FILE says, when the program exits. */
+    if(opts.profile_generate)
+    {
+      return llvm::PGOOptions{
+        "", "", "", "", llvm::vfs::getRealFileSystem(), llvm::PGOOptions::IRInstr
+      };
+    }
+    return llvm::PGOOptions{
+      opts.profile_use_file.c_str(), "", "", "", llvm::vfs::getRealFileSystem(),
+      llvm::PGOOptions::IRUse
+    };
   }
 
   /* There are three places where a var-root could be generated,
@@ -607,10 +752,19 @@ namespace jank::codegen
                              compilation_target const target)
     : target{ target }
     , root_fn{ expr }
-    , ctx{ make_ref<reusable_context>(module_name, std::make_unique<llvm::LLVMContext>()) }
+    , ctx{ make_ref<reusable_context>(module_name,
+                                      std::make_unique<llvm::LLVMContext>(),
+                                      optimization_level(target),
+                                      pgo_options(target)) }
     , llvm_ctx{ extract_context(ctx->module) }
     , llvm_module{ ctx->module.getModuleUnlocked() }
   {
+    analyze::pass::prewalk(expr, [this](analyze::expression_ref const e) {
+      if(auto const fn = llvm::dyn_cast<expr::function>(e.data))
+      {
+        ctx->module_fns.emplace(fn);
+      }
+    });
   }
 
   llvm_processor::impl::impl(expr::function_ref const expr, jtl::ref<reusable_context> ctx)
@@ -622,6 +776,46 @@ namespace jank::codegen
   {
   }
 
+  /* The builder's debug location sticks around when switching blocks, so code which is
+   * generated into another fn, such as the global ctor, can pick up a location from the
+   * wrong fn, which the verifier rejects. Every instruction in a fn with debug info also
+   * needs a location, for calls to be inlined. So this tidies both up, once we're done. */
+  static void finish_debug_info(reusable_context &ctx)
+  {
+    for(auto &fn : *ctx.module.getModuleUnlocked())
+    {
+      auto const subprogram{ fn.getSubprogram() };
+      for(auto &block : fn)
+      {
+        for(auto &inst : block)
+        {
+          if(!subprogram)
+          {
+            inst.setDebugLoc({});
+            continue;
+          }
+
+          auto const &loc{ inst.getDebugLoc() };
+          if(!loc || loc->getScope()->getSubprogram() != subprogram)
+          {
+            inst.setDebugLoc(
+              llvm::DILocation::get(fn.getContext(), subprogram->getLine(), 0, subprogram));
+          }
+        }
+      }
+    }
+    ctx.di_builder->finalize();
+  }
+
+  /* With --frame-pointers, the sampling profiler can walk through our frames. */
+  static void keep_frame_pointer(llvm::Function * const fn)
+  {
+    if(util::cli::opts.frame_pointers)
+    {
+      fn->addFnAttr("frame-pointer", "all");
+    }
+  }
+
   void llvm_processor::impl::create_function()
   {
     auto const fn_type(llvm::FunctionType::get(ctx->builder->getPtrTy(), false));
@@ -630,11 +824,76 @@ namespace jank::codegen
                                      llvm::Function::ExternalLinkage,
                                      name.c_str(),
                                      *llvm_module);
+    keep_frame_pointer(llvm_fn);
 
     auto const entry(llvm::BasicBlock::Create(*llvm_ctx, "entry", llvm_fn));
     ctx->builder->SetInsertPoint(entry);
   }
 
+  llvm::DIFile *llvm_processor::impl::debug_file(jtl::immutable_string const &path) const
+  {
+    auto const found{ ctx->di_files.find(path) };
+    if(found != ctx->di_files.end())
+    {
+      return found->second;
+    }
+
+    std::filesystem::path const p{ path.c_str() };
+    auto const file{ ctx->di_builder->createFile(p.filename().c_str(),
+                                                 p.parent_path().c_str()) };
+    ctx->di_files.emplace(path, file);
+    return file;
+  }
+
+  void llvm_processor::impl::create_subprogram()
+  {
+    auto &di{ *ctx->di_builder };
+    auto const &source{ root_fn->source };
+    auto const file{ debug_file(source.file) };
+    auto const line{ static_cast<unsigned>(source.start.line) };
+    auto const subprogram{ di.createFunction(file,
+                                             root_fn->name.c_str(),
+                                             llvm_fn->getName(),
+                                             file,
+                                             line,
+                                             di.createSubroutineType(di.getOrCreateTypeArray({})),
+                                             line,
+                                             llvm::DINode::FlagZero,
+                                             llvm::DISubprogram::SPFlagDefinition) };
+    llvm_fn->setSubprogram(subprogram);
+    ctx->builder->SetCurrentDebugLocation(
+      llvm::DILocation::get(*llvm_ctx, line, static_cast<unsigned>(source.start.col), subprogram));
+  }
+
+  util::scope_exit llvm_processor::impl::gen_debug_location(object_ref const form)
+  {
+    auto const subprogram{ llvm_fn.data ? llvm_fn->getSubprogram() : nullptr };
+    if(!subprogram)
+    {
+      return { [] {} };
+    }
+    auto const source{ object_source(form) };
+    if(source.file == read::no_source_path)
+    {
+      return { [] {} };
+    }
+
+    /* Forms from macros, or inlined fns, can come from another file than the fn. */
+    llvm::DIScope *scope{ subprogram };
+    if(source.file != root_fn->source.file)
+    {
+      scope = ctx->di_builder->createLexicalBlockFile(subprogram, debug_file(source.file));
+    }
+
+    auto const previous{ ctx->builder->getCurrentDebugLocation() };
+    ctx->builder->SetCurrentDebugLocation(
+      llvm::DILocation::get(*llvm_ctx,
+                            static_cast<unsigned>(source.start.line),
+                            static_cast<unsigned>(source.start.col),
+                            scope));
+    return { [this, previous] { ctx->builder->SetCurrentDebugLocation(previous); } };
+  }
+
   void llvm_processor::impl::create_function(expr::function_arity const &arity)
   {
     auto const captures(root_fn->captures());
@@ -653,9 +912,23 @@ namespace jank::codegen
     auto fn_value(llvm_module->getOrInsertFunction(fn_name.c_str(), fn_type));
     llvm_fn = llvm::cast<llvm::Function>(fn_value.getCallee());
     llvm_fn->setLinkage(llvm::Function::ExternalLinkage);
+    keep_frame_pointer(llvm_fn);
 
     auto const entry(llvm::BasicBlock::Create(*llvm_ctx, "entry", llvm_fn));
     ctx->builder->SetInsertPoint(entry);
+    if(ctx->di_builder)
+    {
+      create_subprogram();
+    }
+
+    /* With --reclaim-jit-code, our module is unloaded once no fn made by it is reachable.
+     * The fn object may not be used again once its arity is running, so it's stored into
+     * a volatile slot in our frame, where the GC will keep finding it until we return. */
+    if(util::cli::opts.reclaim_jit_code && target == compilation_target::eval)
+    {
+      auto const slot(ctx->builder->CreateAlloca(ctx->builder->getPtrTy(), nullptr, "self_ref"));
+      ctx->builder->CreateStore(llvm_fn->getArg(0), slot, true);
+    }
 
     /* JIT-loaded object files don't support global ctors, so we need to call ours manually.
      * Fortunately, we have our load function, which we can hook into. So, if we're compiling
@@ -736,6 +1009,28 @@ namespace jank::codegen
                                                          capture.first->name.c_str());
       }
     }
+
+    self_call_block = nullptr;
+    self_call_stack = nullptr;
+    self_call_params.clear();
+    if(arity.fn_ctx->has_self_tail_call)
+    {
+      for(usize i{}; i < arity.params.size(); ++i)
+      {
+        auto &param(arity.params[i]);
+        auto const alloc{ ctx->builder->CreateAlloca(ctx->builder->getPtrTy(),
+                                                     nullptr,
+                                                     param->get_name().c_str()) };
+        ctx->builder->CreateStore(llvm_fn->getArg(i + 1), alloc);
+        locals[param] = alloc;
+        self_call_params.emplace_back(alloc);
+      }
+
+      self_call_block = llvm::BasicBlock::Create(*llvm_ctx, "self_call", llvm_fn);
+      ctx->builder->CreateBr(self_call_block);
+      ctx->builder->SetInsertPoint(self_call_block);
+      self_call_stack = ctx->builder->CreateStackSave();
+    }
   }
 
   jtl::string_result<void> llvm_processor::gen() const
@@ -746,6 +1041,7 @@ namespace jank::codegen
   jtl::string_result<void> llvm_processor::impl::gen()
   {
     profile::timer const timer{ util::format("ir gen {}", root_fn->name) };
+    profile::phase_timer const phase{ profile::phase::ir_gen };
     if(target != compilation_target::function)
     {
       create_global_ctor();
@@ -791,6 +1087,7 @@ namespace jank::codegen
       }
 
       gen_ret();
+      gen_var_table();
     }
 
     /* For modules, we need to make sure to define RTTI symbols manually. Since
@@ -806,6 +1103,11 @@ namespace jank::codegen
       }
     }
 
+    if(ctx->di_builder && target != compilation_target::function)
+    {
+      finish_debug_info(*ctx);
+    }
+
     return ok();
   }
 
@@ -817,12 +1119,69 @@ namespace jank::codegen
     return ret;
   }
 
+  /* Only values which can't have any effects when they're made, and don't depend on
+   * anything at all, can wait until they're needed. Those are fns which don't close over
+   * anything and literal data. With direct calls, the module holds var roots of its own,
+   * which are set as the defs are loaded, so nothing can be lazy. */
+  bool llvm_processor::impl::can_be_lazy(expr::def_ref const expr) const
+  {
+    if(!util::cli::opts.lazy_defs || util::cli::opts.direct_call
+       || target != compilation_target::module || expr->value.is_none())
+    {
+      return false;
+    }
+
+    auto const value(expr->value.unwrap());
+    if(auto const fn = llvm::dyn_cast<expr::function>(value.data))
+    {
+      return fn->captures().empty();
+    }
+
+    bool literal{ true };
+    analyze::pass::prewalk(value, [&](expression_ref const e) {
+      switch(e->kind)
+      {
+        case expression_kind::primitive_literal:
+        case expression_kind::list:
+        case expression_kind::vector:
+        case expression_kind::map:
+        case expression_kind::set:
+          break;
+        default:
+          literal = false;
+          break;
+      }
+    });
+    return literal;
+  }
+
   llvm::Value *
   llvm_processor::impl::gen(expr::def_ref const expr, expr::function_arity const &arity)
   {
     auto const ref(gen_var(expr->name));
 
-    if(expr->value.is_some())
+    /* With --lazy-defs, the value is made by an initializer of its own, which the var calls
+     * on its first deref. */
+    if(can_be_lazy(expr))
+    {
+      auto const ptr_type(ctx->builder->getPtrTy());
+      auto const init(gen_detached_fn(
+        unique_munged_string(util::format("jank_lazy_init_{}", munge(expr->name->name))),
+        llvm::FunctionType::get(ptr_type, false),
+        [&](llvm::Function *) {
+          auto const value(gen(expr->value.unwrap(), arity));
+          if(!ctx->builder->GetInsertBlock()->getTerminator())
+          {
+            gen_ret(load_if_needed(ctx, value));
+          }
+        }));
+
+      auto const fn(llvm_module->getOrInsertFunction(
+        "jank_var_bind_lazy_root",
+        llvm::FunctionType::get(ptr_type, { ptr_type, ptr_type }, false)));
+      ctx->builder->CreateCall(fn, { ref, init });
+    }
+    else if(expr->value.is_some())
     {
       auto const fn_type(
         llvm::FunctionType::get(ctx->builder->getPtrTy(),
@@ -903,13 +1262,20 @@ namespace jank::codegen
     }
     else
     {
-      auto const ref(gen_var(var_qualified_name));
       auto const fn_type(
         llvm::FunctionType::get(ctx->builder->getPtrTy(), { ctx->builder->getPtrTy() }, false));
-      auto const fn(llvm_module->getOrInsertFunction("jank_deref", fn_type));
+      auto const fn(llvm_module->getOrInsertFunction("jank_var_deref", fn_type));
 
-      llvm::SmallVector<llvm::Value *, 1> const args{ ref };
-      call = ctx->builder->CreateCall(fn, args);
+      auto const ref(gen_var(var_qualified_name));
+      if(loop_deref_point && !expr->var->dynamic)
+      {
+        call = gen_loop_deref(expr->var.data, ref, fn);
+      }
+      else
+      {
+        llvm::SmallVector<llvm::Value *, 1> const args{ ref };
+        call = ctx->builder->CreateCall(fn, args);
+      }
     }
     if(expr->position == expression_position::tail)
     {
@@ -945,21 +1311,358 @@ namespace jank::codegen
     }
   }
 
+  /* When we're JIT compiling, the fn held by a direct linked var, and its arities, are
+   * already in memory. So we can embed their addresses and call the arity without going
+   * through the var at all. AOT compiled code can't embed addresses, so it doesn't do this. */
+  /* (:k m) is a get, where the source is the keyword, and (m :k) is a call, where the source
+   * is the map. */
+  static jtl::immutable_string keyword_lookup_fn(expr::call_ref const expr)
+  {
+    auto const is_keyword_source{ expr->source_expr->kind == expression_kind::primitive_literal };
+    return util::format("jank_keyword_{}{}",
+                        (is_keyword_source ? "get" : "call"),
+                        expr->arg_exprs.size());
+  }
+
+  static void *direct_linked_arity(expr::call_ref const expr)
+  {
+    if(!expr->is_direct_linked || truthy(__rt_ctx->compile_files_var->deref()))
+    {
+      return nullptr;
+    }
+
+    auto const var_deref(llvm::cast<expr::var_deref>(expr->source_expr.data));
+    auto const fn(dyn_cast<obj::jit_function>(var_deref->var->get_root()));
+    if(fn.is_nil())
+    {
+      return nullptr;
+    }
+    /* This keeps the fn alive, even if the var is redefined, since our generated code will
+     * embed its address. */
+    runtime::direct_link(var_deref->var);
+
+    switch(expr->arg_exprs.size())
+    {
+      case 0:
+        return reinterpret_cast<void *>(fn->arity_0);
+      case 1:
+        return reinterpret_cast<void *>(fn->arity_1);
+      case 2:
+        return reinterpret_cast<void *>(fn->arity_2);
+      case 3:
+        return reinterpret_cast<void *>(fn->arity_3);
+      case 4:
+        return reinterpret_cast<void *>(fn->arity_4);
+      case 5:
+        return reinterpret_cast<void *>(fn->arity_5);
+      case 6:
+        return reinterpret_cast<void *>(fn->arity_6);
+      case 7:
+        return reinterpret_cast<void *>(fn->arity_7);
+      case 8:
+        return reinterpret_cast<void *>(fn->arity_8);
+      case 9:
+        return reinterpret_cast<void *>(fn->arity_9);
+      case 10:
+        return reinterpret_cast<void *>(fn->arity_10);
+      default:
+        return nullptr;
+    }
+  }
+
+  /* Finds the fn which a call's source is known to evaluate to. That's either a fn literal
+   * being called right away or a let or letfn local bound to one, since those can't be
+   * rebound. The analyzer leaves out the value expr for loop bindings and for bindings
+   * shadowed within the same let, so those aren't known. */
+  static jtl::ptr<expr::function> known_source_fn(expr::call_ref const expr)
+  {
+    if(auto const fn = llvm::dyn_cast<expr::function>(expr->source_expr.data))
+    {
+      return fn;
+    }
+
+    auto const ref(llvm::dyn_cast<expr::local_reference>(expr->source_expr.data));
+    if(!ref)
+    {
+      return nullptr;
+    }
+
+    for(local_frame_ptr it{ ref->frame }; it != nullptr;)
+    {
+      auto const found(it->locals.find(ref->name));
+      if(found != it->locals.end())
+      {
+        if((it->type != local_frame::frame_type::let
+            && it->type != local_frame::frame_type::letfn)
+           || found->second.value_expr.is_none())
+        {
+          return nullptr;
+        }
+        return llvm::dyn_cast<expr::function>(found->second.value_expr.unwrap().data);
+      }
+
+      it = it->parent.is_some() ? it->parent.unwrap() : nullptr;
+    }
+
+    return nullptr;
+  }
+
+  /* When we know which fn a call lands in and it has a fixed arity for this many args, we
+   * can call that arity's IR fn directly. This skips the virtual call and the arity checks
+   * of dynamic dispatch. In tail position, it also lets LLVM turn mutually recursive calls
+   * between letfn fns into sibling calls. */
+  static jtl::option<jtl::immutable_string>
+  known_arity_fn(expr::call_ref const expr, native_set<expr::function const *> const &module_fns)
+  {
+    auto const fn(known_source_fn(expr));
+    if(fn == nullptr || !module_fns.contains(fn.data))
+    {
+      return none;
+    }
+
+    for(auto const &fn_arity : fn->arities)
+    {
+      if(!fn_arity.fn_ctx->is_variadic && fn_arity.params.size() == expr->arg_exprs.size())
+      {
+        return util::format("{}_{}", munge(fn->unique_name), expr->arg_exprs.size());
+      }
+    }
+    return none;
+  }
+
+  /* In tier 0 code, calls to these core fns, with this many args, get a feedback site and
+   * a fast path for integers. See jit::tiering. */
+  static jtl::option<speculated_op>
+  speculated_op_of(expr::call_ref const expr, compilation_target const target)
+  {
+    if(target != compilation_target::eval || !jit::tiering::is_enabled())
+    {
+      return none;
+    }
+
+    auto const var_deref(llvm::dyn_cast<expr::var_deref>(expr->source_expr.data));
+    if(!var_deref || var_deref->var->dynamic || var_deref->var->n->name->name != "clojure.core")
+    {
+      return none;
+    }
+
+    auto const &name(var_deref->var->name->name);
+    if(expr->arg_exprs.size() == 1)
+    {
+      if(name == "inc")
+      {
+        return speculated_op::increment;
+      }
+      else if(name == "dec")
+      {
+        return speculated_op::decrement;
+      }
+    }
+    else if(expr->arg_exprs.size() == 2)
+    {
+      if(name == "+")
+      {
+        return speculated_op::add;
+      }
+      else if(name == "-")
+      {
+        return speculated_op::subtract;
+      }
+      else if(name == "*")
+      {
+        return speculated_op::multiply;
+      }
+      else if(name == "<")
+      {
+        return speculated_op::less;
+      }
+      else if(name == "<=")
+      {
+        return speculated_op::less_equal;
+      }
+      else if(name == ">")
+      {
+        return speculated_op::greater;
+      }
+      else if(name == ">=")
+      {
+        return speculated_op::greater_equal;
+      }
+      else if(name == "=" || name == "==")
+      {
+        return speculated_op::equal;
+      }
+    }
+    return none;
+  }
+
+  /* Branches to the slow block unless the call's feedback site has only seen integers and
+   * the args are still integers. Past that, the op is done on the unboxed integers and we
+   * give back the block this ends in, along with the boxed result. Arithmetic which
+   * overflows also goes to the slow block, so the generic call decides what to do.
+   *
+   * This leaves the builder in the slow block, once it's recorded the args' kinds there, so
+   * the generic call can be generated right after. */
+  std::pair<llvm::BasicBlock *, llvm::Value *>
+  llvm_processor::impl::gen_speculation(speculated_op const op,
+                                        llvm::ArrayRef<llvm::Value *> const args,
+                                        llvm::BasicBlock * const slow)
+  {
+    auto &builder(*ctx->builder);
+    auto const i8_type(builder.getInt8Ty());
+    auto const i64_type(builder.getInt64Ty());
+    auto const ptr_type(builder.getPtrTy());
+
+    auto const site(
+      new llvm::GlobalVariable{ *llvm_module,
+                                i8_type,
+                                false,
+                                llvm::GlobalVariable::ExternalLinkage,
+                                builder.getInt8(0),
+                                unique_munged_string(jit::tiering::feedback::site_name).c_str() });
+
+    auto const seen(builder.CreateLoad(i8_type, site, "feedback"));
+    seen->setAtomic(llvm::AtomicOrdering::Monotonic);
+    seen->setAlignment(llvm::Align{ 1 });
+    auto const check_bb(llvm::BasicBlock::Create(*llvm_ctx, "speculate.check", llvm_fn));
+    auto const fast_bb(llvm::BasicBlock::Create(*llvm_ctx, "speculate.fast", llvm_fn));
+    builder.CreateCondBr(builder.CreateICmpEQ(seen, builder.getInt8(jit::tiering::feedback::integer)),
+                         check_bb,
+                         slow);
+
+    /* The type is the first byte of every object. */
+    builder.SetInsertPoint(check_bb);
+    llvm::Value *all_integers{ builder.getTrue() };
+    for(auto const arg : args)
+    {
+      auto const type(builder.CreateLoad(i8_type, arg));
+      all_integers = builder.CreateAnd(
+        all_integers,
+        builder.CreateICmpEQ(type, builder.getInt8(static_cast<u8>(object_type::integer))));
+    }
+    builder.CreateCondBr(all_integers, fast_bb, slow);
+
+    builder.SetInsertPoint(fast_bb);
+    static constexpr auto offset_of_data{ offsetof(obj::integer, data)
+                                          - offsetof(obj::integer, base) };
+    llvm::SmallVector<llvm::Value *, 2> values;
+    for(auto const arg : args)
+    {
+      values.emplace_back(builder.CreateLoad(
+        i64_type,
+        builder.CreateInBoundsGEP(i8_type, arg, { builder.getInt64(offset_of_data) })));
+    }
+
+    auto const checked([&](llvm::Intrinsic::ID const id, llvm::Value * const r) {
+      auto const res(builder.CreateBinaryIntrinsic(id, values[0], r));
+      auto const ok_bb(llvm::BasicBlock::Create(*llvm_ctx, "speculate.ok", llvm_fn));
+      builder.CreateCondBr(builder.CreateExtractValue(res, 1), slow, ok_bb);
+      builder.SetInsertPoint(ok_bb);
+      return builder.CreateCall(
+        llvm_module->getOrInsertFunction("jank_integer_create",
+                                         llvm::FunctionType::get(ptr_type, { i64_type }, false)),
+        { builder.CreateExtractValue(res, 0) });
+    });
+    auto const compared([&](llvm::CmpInst::Predicate const pred) {
+      auto const fn_type(llvm::FunctionType::get(ptr_type, false));
+      return builder.CreateSelect(
+        builder.CreateICmp(pred, values[0], values[1]),
+        builder.CreateCall(llvm_module->getOrInsertFunction("jank_const_true", fn_type)),
+        builder.CreateCall(llvm_module->getOrInsertFunction("jank_const_false", fn_type)));
+    });
+
+    llvm::Value *result{};
+    switch(op)
+    {
+      case speculated_op::add:
+        result = checked(llvm::Intrinsic::sadd_with_overflow, values[1]);
+        break;
+      case speculated_op::subtract:
+        result = checked(llvm::Intrinsic::ssub_with_overflow, values[1]);
+        break;
+      case speculated_op::multiply:
+        result = checked(llvm::Intrinsic::smul_with_overflow, values[1]);
+        break;
+      case speculated_op::increment:
+        result = checked(llvm::Intrinsic::sadd_with_overflow, builder.getInt64(1));
+        break;
+      case speculated_op::decrement:
+        result = checked(llvm::Intrinsic::ssub_with_overflow, builder.getInt64(1));
+        break;
+      case speculated_op::less:
+        result = compared(llvm::CmpInst::ICMP_SLT);
+        break;
+      case speculated_op::less_equal:
+        result = compared(llvm::CmpInst::ICMP_SLE);
+        break;
+      case speculated_op::greater:
+        result = compared(llvm::CmpInst::ICMP_SGT);
+        break;
+      case speculated_op::greater_equal:
+        result = compared(llvm::CmpInst::ICMP_SGE);
+        break;
+      case speculated_op::equal:
+        result = compared(llvm::CmpInst::ICMP_EQ);
+        break;
+    }
+    auto const fast_end(builder.GetInsertBlock());
+
+    builder.SetInsertPoint(slow);
+    auto const record_fn(llvm_module->getOrInsertFunction(
+      "jank_feedback_record",
+      llvm::FunctionType::get(builder.getVoidTy(), { ptr_type, ptr_type }, false)));
+    for(auto const arg : args)
+    {
+      builder.CreateCall(record_fn, { site, arg });
+    }
+
+    return { fast_end, result };
+  }
+
   llvm::Value *
   llvm_processor::impl::gen(expr::call_ref const expr, expr::function_arity const &arity)
   {
-    auto const callee(gen(expr->source_expr, arity));
-
+    auto const debug_location{ gen_debug_location(expr->form) };
     llvm::SmallVector<llvm::Value *> arg_handles;
     llvm::SmallVector<llvm::Type *> arg_types;
     /* We add one for the fn object. */
     arg_handles.reserve(expr->arg_exprs.size() + 1);
     arg_types.reserve(expr->arg_exprs.size() + 1);
 
+    auto const linked_arity(direct_linked_arity(expr));
+    auto const known_arity(linked_arity ? none : known_arity_fn(expr, ctx->module_fns));
+
     llvm::Value *call{};
     if(cpp_util::is_any_object(cpp_util::expression_type(expr->source_expr)))
     {
-      arg_handles.emplace_back(callee);
+      if(linked_arity)
+      {
+        auto const var_deref(llvm::cast<expr::var_deref>(expr->source_expr.data));
+        auto const linked_fn(var_deref->var->get_root());
+        /* jit_function arities take the fn object, not the var, as their first param. */
+        arg_handles.emplace_back(llvm::ConstantExpr::getIntToPtr(
+          ctx->builder->getInt64(reinterpret_cast<uptr>(linked_fn.data)),
+          ctx->builder->getPtrTy()));
+      }
+      else
+      {
+        /* Keyword lookups each get a zeroed keyword_call_site, as their inline cache. It
+         * only holds indices, so it's fine for it to live outside of the GC's view. */
+        if(expr->is_keyword_lookup && known_arity.is_none())
+        {
+          static_assert(sizeof(obj::keyword_call_site) == sizeof(u32) * 2);
+          auto const site_type(llvm::ArrayType::get(ctx->builder->getInt32Ty(), 2));
+          auto const site(new llvm::GlobalVariable{ *llvm_module,
+                                                    site_type,
+                                                    false,
+                                                    llvm::GlobalVariable::InternalLinkage,
+                                                    llvm::ConstantAggregateZero::get(site_type),
+                                                    unique_munged_string("keyword_site").c_str() });
+          arg_handles.emplace_back(site);
+          arg_types.emplace_back(ctx->builder->getPtrTy());
+        }
+        arg_handles.emplace_back(gen(expr->source_expr, arity));
+      }
       arg_types.emplace_back(ctx->builder->getPtrTy());
 
       for(auto const &arg_expr : expr->arg_exprs)
@@ -974,13 +1677,37 @@ namespace jank::codegen
         arg_types.emplace_back(ctx->builder->getPtrTy());
       }
 
-      auto const call_fn_name(arity_to_call_fn(expr->arg_exprs.size()));
+      auto const speculation(speculated_op_of(expr, target));
+      std::pair<llvm::BasicBlock *, llvm::Value *> fast{};
+      if(speculation.is_some())
+      {
+        fast = gen_speculation(
+          speculation.unwrap(),
+          llvm::ArrayRef<llvm::Value *>{ arg_handles }.take_back(expr->arg_exprs.size()),
+          llvm::BasicBlock::Create(*llvm_ctx, "speculate.slow", llvm_fn));
+      }
+
+      auto const call_fn_name(linked_arity              ? jtl::immutable_string{ "direct_link" }
+                              : known_arity.is_some()   ? known_arity.unwrap()
+                              : expr->is_keyword_lookup ? keyword_lookup_fn(expr)
+                                                        : arity_to_call_fn(expr->arg_exprs.size()));
       auto const fn_type(llvm::FunctionType::get(ctx->builder->getPtrTy(), arg_types, false));
-      auto const fn(llvm_module->getOrInsertFunction(call_fn_name.c_str(), fn_type));
+      auto const fn(linked_arity
+                      ? llvm::FunctionCallee{ fn_type,
+                                              llvm::ConstantExpr::getIntToPtr(
+                                                ctx->builder->getInt64(
+                                                  reinterpret_cast<uptr>(linked_arity)),
+                                                ctx->builder->getPtrTy()) }
+                      : llvm_module->getOrInsertFunction(call_fn_name.c_str(), fn_type));
 
       if(lpad_and_catch_body_stack.empty())
       {
-        call = ctx->builder->CreateCall(fn, arg_handles);
+        auto const direct_call(ctx->builder->CreateCall(fn, arg_handles));
+        if(known_arity.is_some() && expr->position == expression_position::tail)
+        {
+          direct_call->setTailCall();
+        }
+        call = direct_call;
       }
       else
       {
@@ -994,6 +1721,21 @@ namespace jank::codegen
                                           arg_handles);
         ctx->builder->SetInsertPoint(normal_dest);
       }
+
+      if(speculation.is_some())
+      {
+        auto const slow_end(ctx->builder->GetInsertBlock());
+        auto const join_bb(llvm::BasicBlock::Create(*llvm_ctx, "speculate.join", llvm_fn));
+        ctx->builder->CreateBr(join_bb);
+        ctx->builder->SetInsertPoint(fast.first);
+        ctx->builder->CreateBr(join_bb);
+
+        ctx->builder->SetInsertPoint(join_bb);
+        auto const phi(ctx->builder->CreatePHI(ctx->builder->getPtrTy(), 2));
+        phi->addIncoming(fast.second, fast.first);
+        phi->addIncoming(call, slow_end);
+        call = phi;
+      }
     }
     /* TODO: This can be deleted, I'm pretty sure. */
     else
@@ -1248,6 +1990,10 @@ namespace jank::codegen
       gen_stack_restore();
       return ctx->builder->CreateBr(current_loop.data);
     }
+    else if(expr->is_self_tail_call && self_call_block != nullptr)
+    {
+      return gen_self_tail_call(expr->arg_exprs, arity);
+    }
     else
     {
       /* The codegen for the special recur form is very similar to the named recursion
@@ -1353,6 +2099,10 @@ namespace jank::codegen
      * closure context. */
 
     auto const crosses_fn(expr->recursion_ref.fn_ctx->fn != arity.fn_ctx->fn);
+    if(expr->is_self_tail_call && self_call_block != nullptr && !crosses_fn)
+    {
+      return gen_self_tail_call(expr->arg_exprs, arity);
+    }
 
     llvm::SmallVector<llvm::Value *> arg_handles;
     llvm::SmallVector<llvm::Type *> arg_types;
@@ -1438,43 +2188,343 @@ namespace jank::codegen
         locals[pair.first] = alloc;
       }
 
-      auto const current_fn(ctx->builder->GetInsertBlock()->getParent());
-      auto const loop_block(llvm::BasicBlock::Create(*llvm_ctx, "loop", current_fn));
-      auto const old_loop{ current_loop };
-      current_loop = loop_block;
-      util::scope_exit const finally{ [&]() { current_loop = old_loop; } };
-
-      ctx->builder->CreateBr(loop_block);
-      ctx->builder->SetInsertPoint(loop_block);
-
-      auto const stack_save{ gen_stack_save() };
-
+      auto const ret(gen_loop(expr, arity, can_replace_on_stack(expr)));
+      locals = std::move(old_locals);
+      return ret;
+    }
+    else
+    {
       auto const ret(gen(expr->body, arity));
       locals = std::move(old_locals);
 
       /* XXX: No return creation, since we rely on the body to do that. */
-      if(expr->position != expression_position::tail)
+
+      return ret;
+    }
+  }
+
+  /* A loop's continuation is generated apart from the loop itself, so anything in it which
+   * can only be generated once, like a nested fn, rules it out. So does any local which
+   * isn't a pointer, since the live locals are handed over as pointers. */
+  bool llvm_processor::impl::can_replace_on_stack(expr::let_ref const expr) const
+  {
+    if(target != compilation_target::eval || !jit::tiering::is_enabled() || in_loop_continuation
+       || ctx->di_builder || !lpad_and_catch_body_stack.empty()
+       || !cpp_util::is_any_object(cpp_util::expression_type(expr)))
+    {
+      return false;
+    }
+
+    for(auto const &local : locals)
+    {
+      auto const alloc(llvm::dyn_cast<llvm::AllocaInst>(local.second.data));
+      if(!local.second->getType()->isPointerTy()
+         || (alloc && !alloc->getAllocatedType()->isPointerTy()))
+      {
+        return false;
+      }
+    }
+
+    bool replaceable{ true };
+    analyze::pass::prewalk(expr->body, [&](expression_ref const e) {
+      switch(e->kind)
+      {
+        case expression_kind::function:
+        case expression_kind::letfn:
+        case expression_kind::try_:
+          replaceable = false;
+          break;
+        default:
+          replaceable &= e->kind < expression_kind::cpp_value_min;
+          break;
+      }
+    });
+    return replaceable;
+  }
+
+  /* Loads the var's root version and only calls jank_var_deref when it differs from the
+   * version of the cached deref. The cached version starts out as one which no var has, so
+   * a var is only derefed once it's actually used, which keeps lazy defs lazy. The version
+   * is read before the deref, so a root published in between is picked up next time. */
+  llvm::Value *llvm_processor::impl::gen_loop_deref(runtime::var const * const var,
+                                                    llvm::Value * const ref,
+                                                    llvm::FunctionCallee const deref_fn)
+  {
+    auto &builder(*ctx->builder);
+    auto const ptr_type(builder.getPtrTy());
+    auto const i64_type(builder.getInt64Ty());
+    auto const current_fn(builder.GetInsertBlock()->getParent());
+
+    auto &slots(loop_derefs[var]);
+    if(!slots.value)
+    {
+      auto &entry_bb{ current_fn->getEntryBlock() };
+      llvm::IRBuilder<> entry_builder(&entry_bb, entry_bb.getFirstInsertionPt());
+      slots.value = entry_builder.CreateAlloca(ptr_type, nullptr, "var.cached");
+      slots.version = entry_builder.CreateAlloca(i64_type, nullptr, "var.cached_version");
+
+      llvm::IRBuilder<> reset_builder(loop_deref_point);
+      reset_builder.CreateStore(llvm::ConstantPointerNull::get(ptr_type), slots.value);
+      reset_builder.CreateStore(builder.getInt64(std::numeric_limits<u64>::max()),
+                                slots.version);
+    }
+
+    auto const version_ptr(builder.CreateConstInBoundsGEP1_64(builder.getInt8Ty(),
+                                                              ref,
+                                                              runtime::var::root_version_offset()));
+    auto const version(builder.CreateLoad(i64_type, version_ptr, "var.version"));
+    version->setAtomic(llvm::AtomicOrdering::Acquire);
+    version->setAlignment(llvm::Align{ alignof(u64) });
+
+    auto const reload_bb(llvm::BasicBlock::Create(*llvm_ctx, "var.reload", current_fn));
+    auto const cached_bb(llvm::BasicBlock::Create(*llvm_ctx, "var.cached", current_fn));
+    builder.CreateCondBr(
+      builder.CreateICmpEQ(version, builder.CreateLoad(i64_type, slots.version)),
+      cached_bb,
+      reload_bb);
+
+    builder.SetInsertPoint(reload_bb);
+    llvm::SmallVector<llvm::Value *, 1> const args{ ref };
+    builder.CreateStore(builder.CreateCall(deref_fn, args), slots.value);
+    builder.CreateStore(version, slots.version);
+    builder.CreateBr(cached_bb);
+
+    builder.SetInsertPoint(cached_bb);
+    return builder.CreateLoad(ptr_type, slots.value);
+  }
+
+  /* The loop's bindings must already be in their allocas.
+   *
+   * With tiered compilation, tier 0 loops count their iterations. Every so often, a hot loop
+   * checks whether its module has been optimized, asking for it to be, if it hasn't. Once
+   * it has, the loop hands its live locals over to the optimized version of its
+   * continuation, which runs the rest of the loop and gives back its value. That's how a
+   * long running loop gets to optimized code without its fn being called again. */
+  llvm::Value *llvm_processor::impl::gen_loop(expr::let_ref const expr,
+                                              expr::function_arity const &arity,
+                                              bool const replaceable)
+  {
+    auto &builder(*ctx->builder);
+    auto const ptr_type(builder.getPtrTy());
+    auto const i64_type(builder.getInt64Ty());
+    auto const current_fn(builder.GetInsertBlock()->getParent());
+
+    native_vector<std::pair<obj::symbol_ref, llvm::Value *>> live;
+    llvm::Function *continuation{};
+    llvm::Value *counter{};
+    llvm::Value *live_values{};
+    llvm::ArrayType *live_type{};
+    if(replaceable)
+    {
+      for(auto const &local : locals)
+      {
+        live.emplace_back(local.first, local.second.data);
+      }
+      continuation = gen_loop_continuation(expr, arity, live);
+
+      counter = builder.CreateAlloca(i64_type, nullptr, "osr.count");
+      builder.CreateStore(builder.getInt64(0), counter);
+      live_type = llvm::ArrayType::get(ptr_type, live.size());
+      live_values = builder.CreateAlloca(live_type, nullptr, "osr.locals");
+    }
+
+    auto const loop_block(llvm::BasicBlock::Create(*llvm_ctx, "loop", current_fn));
+    auto const old_loop{ current_loop };
+    current_loop = loop_block;
+    util::scope_exit const finally{ [&]() { current_loop = old_loop; } };
+
+    auto const entry(builder.CreateBr(loop_block));
+    builder.SetInsertPoint(loop_block);
+
+    auto const hoisting(!loop_deref_point);
+    if(hoisting)
+    {
+      loop_deref_point = entry;
+    }
+    util::scope_exit const clear_derefs{ [&]() {
+      if(hoisting)
+      {
+        loop_deref_point = nullptr;
+        loop_derefs.clear();
+      }
+    } };
+
+    llvm::BasicBlock *osr_exit{};
+    llvm::Value *osr_result{};
+    if(replaceable)
+    {
+      auto const check_bb(llvm::BasicBlock::Create(*llvm_ctx, "osr.check", current_fn));
+      auto const enter_bb(llvm::BasicBlock::Create(*llvm_ctx, "osr.enter", current_fn));
+      auto const body_bb(llvm::BasicBlock::Create(*llvm_ctx, "loop.body", current_fn));
+
+      auto const count(builder.CreateAdd(builder.CreateLoad(i64_type, counter), builder.getInt64(1)));
+      builder.CreateStore(count, counter);
+      builder.CreateCondBr(
+        builder.CreateICmpEQ(builder.CreateAnd(count, jit::tiering::osr_interval - 1),
+                             builder.getInt64(0)),
+        check_bb,
+        body_bb);
+
+      builder.SetInsertPoint(check_bb);
+      auto const optimized(builder.CreateCall(
+        llvm_module->getOrInsertFunction("jank_osr_find_optimized",
+                                         llvm::FunctionType::get(ptr_type, { ptr_type }, false)),
+        { continuation }));
+      builder.CreateCondBr(builder.CreateIsNull(optimized), body_bb, enter_bb);
+
+      builder.SetInsertPoint(enter_bb);
+      for(usize i{}; i < live.size(); ++i)
+      {
+        builder.CreateStore(load_if_needed(ctx, live[i].second),
+                            builder.CreateConstInBoundsGEP2_64(live_type, live_values, 0, i));
+      }
+      osr_result
+        = builder.CreateCall(llvm::FunctionCallee{ continuation->getFunctionType(), optimized },
+                             { current_fn->getArg(0), live_values });
+      if(expr->position == expression_position::tail)
+      {
+        gen_ret(osr_result);
+      }
+      else
+      {
+        osr_exit = builder.GetInsertBlock();
+      }
+
+      builder.SetInsertPoint(body_bb);
+    }
+
+    auto const stack_save{ gen_stack_save() };
+
+    llvm::Value *ret(gen(expr->body, arity));
+
+    /* XXX: No return creation, since we rely on the body to do that. */
+    if(expr->position != expression_position::tail)
+    {
+      auto const postloop_block(llvm::BasicBlock::Create(*llvm_ctx, "postloop", current_fn));
+      llvm::BasicBlock *body_end{};
+      if(!builder.GetInsertBlock()->getTerminator())
       {
-        auto const postloop_block(llvm::BasicBlock::Create(*llvm_ctx, "postloop", current_fn));
-        if(!ctx->builder->GetInsertBlock()->getTerminator())
+        if(osr_exit)
         {
-          gen_stack_restore();
-          ctx->builder->CreateBr(postloop_block);
+          ret = load_if_needed(ctx, ret);
         }
-        ctx->builder->SetInsertPoint(postloop_block);
+        gen_stack_restore();
+        body_end = builder.GetInsertBlock();
+        builder.CreateBr(postloop_block);
+      }
+      if(osr_exit)
+      {
+        builder.SetInsertPoint(osr_exit);
+        builder.CreateBr(postloop_block);
       }
+      builder.SetInsertPoint(postloop_block);
 
-      return ret;
+      if(osr_exit)
+      {
+        auto const phi(builder.CreatePHI(ptr_type, 2));
+        if(body_end)
+        {
+          phi->addIncoming(ret, body_end);
+        }
+        phi->addIncoming(osr_result, osr_exit);
+        ret = phi;
+      }
     }
-    else
-    {
-      auto const ret(gen(expr->body, arity));
+
+    return ret;
+  }
+
+  /* Generates a fn of its own, apart from the one we're in the middle of, such as for a
+   * loop's continuation or a lazy def's initializer. Everything which describes the fn
+   * being generated is put back once we're done. */
+  llvm::Function *
+  llvm_processor::impl::gen_detached_fn(jtl::immutable_string const &name,
+                                        llvm::FunctionType * const type,
+                                        std::function<void(llvm::Function *)> const &body)
+  {
+    auto &builder(*ctx->builder);
+    auto const fn(
+      llvm::Function::Create(type, llvm::Function::ExternalLinkage, name.c_str(), *llvm_module));
+    keep_frame_pointer(fn);
+
+    auto const old_block(builder.GetInsertBlock());
+    auto const old_point(builder.GetInsertPoint());
+    auto const old_fn(std::exchange(llvm_fn, fn));
+    auto old_locals(std::exchange(locals, {}));
+    auto old_stack_saves(std::exchange(stack_saves, {}));
+    auto const old_self_call_block(std::exchange(self_call_block, nullptr));
+    auto const old_self_call_stack(std::exchange(self_call_stack, nullptr));
+    auto old_self_call_params(std::exchange(self_call_params, {}));
+    util::scope_exit const finally{ [&]() {
+      llvm_fn = old_fn;
       locals = std::move(old_locals);
+      stack_saves = std::move(old_stack_saves);
+      self_call_block = old_self_call_block;
+      self_call_stack = old_self_call_stack;
+      self_call_params = std::move(old_self_call_params);
+      builder.SetInsertPoint(old_block, old_point);
+    } };
 
-      /* XXX: No return creation, since we rely on the body to do that. */
+    builder.SetInsertPoint(llvm::BasicBlock::Create(*llvm_ctx, "entry", fn));
+    body(fn);
+    return fn;
+  }
 
-      return ret;
-    }
+  /* For on-stack replacement. The continuation takes the fn object, like our arities do, and
+   * an array of the values of the loop's live locals, in the same order as they're given.
+   * It picks the loop up from the top of an iteration and runs it to the end. It's in the
+   * same module as the loop, so it's optimized along with everything else. */
+  llvm::Function *llvm_processor::impl::gen_loop_continuation(
+    expr::let_ref const expr,
+    expr::function_arity const &arity,
+    native_vector<std::pair<obj::symbol_ref, llvm::Value *>> const &live)
+  {
+    auto &builder(*ctx->builder);
+    auto const ptr_type(builder.getPtrTy());
+
+    /* The continuation is a fn of its own, so it can't use the derefs of the loop we're in. */
+    auto const outer_deref_point(loop_deref_point);
+    auto outer_derefs(std::move(loop_derefs));
+    loop_deref_point = nullptr;
+    loop_derefs.clear();
+
+    in_loop_continuation = true;
+    util::scope_exit const finally{ [&]() {
+      in_loop_continuation = false;
+      loop_deref_point = outer_deref_point;
+      loop_derefs = std::move(outer_derefs);
+    } };
+
+    return gen_detached_fn(
+      unique_munged_string("jank_osr_loop"),
+      llvm::FunctionType::get(ptr_type, { ptr_type, ptr_type }, false),
+      [&](llvm::Function * const fn) {
+        auto const live_type(llvm::ArrayType::get(ptr_type, live.size()));
+        for(usize i{}; i < live.size(); ++i)
+        {
+          auto const &[name, original](live[i]);
+          auto const value(
+            builder.CreateLoad(ptr_type,
+                               builder.CreateConstInBoundsGEP2_64(live_type, fn->getArg(1), 0, i),
+                               name->to_string().c_str()));
+          if(llvm::isa<llvm::AllocaInst>(original))
+          {
+            auto const alloc(builder.CreateAlloca(ptr_type, nullptr, name->to_string().c_str()));
+            builder.CreateStore(value, alloc);
+            locals[name] = alloc;
+          }
+          else
+          {
+            locals[name] = value;
+          }
+        }
+
+        auto const ret(gen_loop(expr, arity, false));
+        if(!builder.GetInsertBlock()->getTerminator())
+        {
+          gen_ret(load_if_needed(ctx, ret));
+        }
+      });
   }
 
   llvm::Value *
@@ -1488,13 +2538,13 @@ namespace jank::codegen
      *
      *   (jank.compiler/native-source '(letfn [(a [] b) (b [] a)]))
      *   =>
-     *   1 | %1 = call ptr @GC_malloc(i64 8)
-     *   2 | ...                                                     // %b not in scope. store moved to line 8
-     *   3 | %a = call ptr @jank_closure_create(..., ptr %1)
-     *   4 | ...
-     *   5 | %4 = call ptr @GC_malloc(i64 8)
+     *   1 | %a = call ptr @jank_closure_create_flat(..., i64 1)
+     *   2 | %1 = getelementptr inbounds i8, ptr %a, i64 ...          // %b not in scope. store moved to line 8
+     *   3 | ...
+     *   4 | %b = call ptr @jank_closure_create_flat(..., i64 1)
+     *   5 | %4 = getelementptr inbounds i8, ptr %b, i64 ...
      *   6 | store ptr %a, ptr %4, align 8                           // %a is in scope, ok to store
-     *   7 | %b = call ptr @jank_closure_create(..., ptr nonnull %4)
+     *   7 | ...
      *   8 | store ptr %b, ptr %1, align 8                           // deferred initialization of %a since %b is in scope
      * */
     auto old_deferred_inits(deferred_inits);
@@ -1553,13 +2603,35 @@ namespace jank::codegen
      * for us. Since LLVM basic blocks can only have one terminating instruction, we need
      * to take care to not generate our own, too. */
     auto const is_return(expr->position == expression_position::tail);
-    auto const condition(load_if_needed(ctx, gen(expr->condition, arity)));
-    auto const truthy_fn_type(
-      llvm::FunctionType::get(ctx->builder->getInt8Ty(), { ctx->builder->getPtrTy() }, false));
-    auto const fn(llvm_module->getOrInsertFunction("jank_truthy", truthy_fn_type));
-    llvm::SmallVector<llvm::Value *, 1> const args{ condition };
-    auto const call(ctx->builder->CreateCall(fn, args));
-    auto const cmp(ctx->builder->CreateICmpEQ(call, ctx->builder->getInt8(1), "iftmp"));
+    auto const condition_type{ cpp_util::expression_type(expr->condition) };
+    llvm::Value *cmp{};
+
+    /* Native bool conditions are branched on directly, rather than going through
+     * jank_truthy. */
+    if(cpp_util::is_bool(condition_type))
+    {
+      auto condition(gen(expr->condition, arity));
+      if(Cpp::IsReferenceType(condition_type))
+      {
+        condition = ctx->builder->CreateLoad(ctx->builder->getPtrTy(), condition);
+      }
+      auto const value(ctx->builder->CreateLoad(
+        llvm_builtin_type(*ctx, llvm_ctx, Cpp::GetNonReferenceType(condition_type)),
+        condition));
+      cmp = ctx->builder->CreateICmpNE(value,
+                                       llvm::ConstantInt::get(value->getType(), 0),
+                                       "iftmp");
+    }
+    else
+    {
+      auto const condition(load_if_needed(ctx, gen(expr->condition, arity)));
+      auto const truthy_fn_type(
+        llvm::FunctionType::get(ctx->builder->getInt8Ty(), { ctx->builder->getPtrTy() }, false));
+      auto const fn(llvm_module->getOrInsertFunction("jank_truthy", truthy_fn_type));
+      llvm::SmallVector<llvm::Value *, 1> const args{ condition };
+      auto const call(ctx->builder->CreateCall(fn, args));
+      cmp = ctx->builder->CreateICmpEQ(call, ctx->builder->getInt8(1), "iftmp");
+    }
 
     auto const current_fn(ctx->builder->GetInsertBlock()->getParent());
     auto then_block(llvm::BasicBlock::Create(*llvm_ctx, "then", current_fn));
@@ -2086,18 +3158,37 @@ namespace jank::codegen
     auto const position{ expr->position };
     auto const value(gen(expr->value_expr, arity));
     auto const is_return{ position == expression_position::tail };
-    auto const integer_fn_type(llvm::FunctionType::get(
-      ctx->builder->getInt64Ty(),
-      { ctx->builder->getPtrTy(), ctx->builder->getInt64Ty(), ctx->builder->getInt64Ty() },
-      false));
-    auto const fn(
-      llvm_module->getOrInsertFunction("jank_shift_mask_case_integer", integer_fn_type));
-    llvm::SmallVector<llvm::Value *, 3> const args{
-      value,
-      llvm::ConstantInt::getSigned(ctx->builder->getInt64Ty(), expr->shift),
-      llvm::ConstantInt::getSigned(ctx->builder->getInt64Ty(), expr->mask)
-    };
-    auto const call(ctx->builder->CreateCall(fn, args));
+    llvm::Value *call{};
+    /* With an :int test type, we switch on the integer itself. Since the keys are then the
+     * values, a dense set of them becomes a jump table. */
+    if(expr->is_int_test)
+    {
+      auto const integer_fn_type(
+        llvm::FunctionType::get(ctx->builder->getInt64Ty(),
+                                { ctx->builder->getPtrTy(), ctx->builder->getInt64Ty() },
+                                false));
+      auto const fn(llvm_module->getOrInsertFunction("jank_case_integer", integer_fn_type));
+      llvm::SmallVector<llvm::Value *, 2> const args{
+        value,
+        llvm::ConstantInt::getSigned(ctx->builder->getInt64Ty(), expr->unused_key())
+      };
+      call = ctx->builder->CreateCall(fn, args);
+    }
+    else
+    {
+      auto const integer_fn_type(llvm::FunctionType::get(
+        ctx->builder->getInt64Ty(),
+        { ctx->builder->getPtrTy(), ctx->builder->getInt64Ty(), ctx->builder->getInt64Ty() },
+        false));
+      auto const fn(
+        llvm_module->getOrInsertFunction("jank_shift_mask_case_integer", integer_fn_type));
+      llvm::SmallVector<llvm::Value *, 3> const args{
+        value,
+        llvm::ConstantInt::getSigned(ctx->builder->getInt64Ty(), expr->shift),
+        llvm::ConstantInt::getSigned(ctx->builder->getInt64Ty(), expr->mask)
+      };
+      call = ctx->builder->CreateCall(fn, args);
+    }
     auto const switch_val(ctx->builder->CreateIntCast(call, ctx->builder->getInt64Ty(), true));
     auto const default_block{ llvm::BasicBlock::Create(*llvm_ctx, "default", current_fn) };
     auto const switch_{ ctx->builder->CreateSwitch(switch_val, default_block, expr->keys.size()) };
@@ -2152,6 +3243,7 @@ namespace jank::codegen
   llvm::Value *llvm_processor::impl::gen(expr::cpp_raw_ref const expr, expr::function_arity const &)
   {
     auto parse_res{ __rt_ctx->jit_prc.interpreter->Parse(expr->code.c_str()) };
+    __rt_ctx->jit_prc.cpp_generation.fetch_add(1, std::memory_order_release);
     if(!parse_res)
     {
       throw std::runtime_error{ "Unable to parse 'cpp/raw' expression." };
@@ -2759,7 +3851,9 @@ namespace jank::codegen
     auto const gc_alloc(ctx->builder->CreateCall(fn, args));
     ctx->builder->CreateStore(gc_alloc, alloc);
 
-    if(!Cpp::IsTriviallyDestructible(expr->type))
+    /* Scoped objects are destroyed by their cpp/delete, which saves the GC from having to
+     * track a finalizer for each of them. */
+    if(!expr->scoped && !Cpp::IsTriviallyDestructible(expr->type))
     {
       auto const dtor{ Cpp::GetDestructor(Cpp::GetScopeFromType(expr->type)) };
       auto const dtor_callable{ Cpp::MakeAotCallable(dtor, unique_munged_string()) };
@@ -2840,6 +3934,8 @@ namespace jank::codegen
     return ret;
   }
 
+  /* Vars aren't interned where they're used. Every one this module needs gets a slot, which
+   * is filled in by one table, registered at the top of the global ctor. */
   llvm::Value *llvm_processor::impl::gen_var(obj::symbol_ref const qualified_name) const
   {
     auto const found(ctx->var_globals.find(qualified_name));
@@ -2854,28 +3950,59 @@ namespace jank::codegen
     llvm_module->insertGlobalVariable(var);
     global = var;
 
-    auto const prev_block(ctx->builder->GetInsertBlock());
-    {
-      llvm::IRBuilder<>::InsertPointGuard const guard{ *ctx->builder };
-      ctx->builder->SetInsertPoint(ctx->global_ctor_block);
-      auto const fn_type(
-        llvm::FunctionType::get(ctx->builder->getPtrTy(),
-                                { ctx->builder->getPtrTy(), ctx->builder->getPtrTy() },
-                                false));
-      auto const fn(llvm_module->getOrInsertFunction("jank_var_intern_c", fn_type));
+    return ctx->builder->CreateLoad(ctx->builder->getPtrTy(), global);
+  }
 
-      llvm::SmallVector<llvm::Value *, 2> const args{ gen_c_string(qualified_name->ns),
-                                                      gen_c_string(qualified_name->name) };
-      auto const call(ctx->builder->CreateCall(fn, args));
-      ctx->builder->CreateStore(call, global);
+  /* The records are sorted so that each ns's vars are together, which lets the runtime
+   * intern each ns's vars in one go, rather than locking and rebuilding the ns's mappings
+   * for every var. */
+  void llvm_processor::impl::gen_var_table() const
+  {
+    if(ctx->var_globals.empty())
+    {
+      return;
+    }
 
-      if(prev_block == ctx->global_ctor_block)
+    native_vector<std::pair<obj::symbol_ref, llvm::Value *>> vars{ ctx->var_globals.begin(),
+                                                                   ctx->var_globals.end() };
+    std::ranges::sort(vars, [](auto const &l, auto const &r) {
+      if(l.first->ns != r.first->ns)
       {
-        return call;
+        return l.first->ns < r.first->ns;
       }
-    }
+      return l.first->name < r.first->name;
+    });
 
-    return ctx->builder->CreateLoad(ctx->builder->getPtrTy(), global);
+    llvm::IRBuilder<>::InsertPointGuard const guard{ *ctx->builder };
+    ctx->builder->SetInsertPoint(ctx->global_ctor_block,
+                                 ctx->global_ctor_block->getFirstInsertionPt());
+
+    auto const ptr_type(ctx->builder->getPtrTy());
+    auto const record_type(llvm::StructType::get(ptr_type, ptr_type, ptr_type));
+    std::vector<llvm::Constant *> records;
+    records.reserve(vars.size());
+    for(auto const &v : vars)
+    {
+      records.emplace_back(llvm::ConstantStruct::get(
+        record_type,
+        { llvm::cast<llvm::Constant>(gen_c_string(v.first->ns)),
+          llvm::cast<llvm::Constant>(gen_c_string(v.first->name)),
+          llvm::cast<llvm::Constant>(v.second) }));
+    }
+
+    auto const table_type(llvm::ArrayType::get(record_type, records.size()));
+    auto const table(new llvm::GlobalVariable{ *llvm_module,
+                                               table_type,
+                                               true,
+                                               llvm::GlobalVariable::PrivateLinkage,
+                                               llvm::ConstantArray::get(table_type, records),
+                                               "var_table" });
+
+    auto const fn_type(llvm::FunctionType::get(ctx->builder->getVoidTy(),
+                                               { ptr_type, ctx->builder->getInt64Ty() },
+                                               false));
+    auto const fn(llvm_module->getOrInsertFunction("jank_var_intern_table", fn_type));
+    ctx->builder->CreateCall(fn, { table, ctx->builder->getInt64(records.size()) });
   }
 
   llvm::Value *llvm_processor::impl::gen_var_root(obj::symbol_ref const qualified_name,
@@ -2913,7 +4040,7 @@ namespace jank::codegen
     {
       auto const fn_type(
         llvm::FunctionType::get(ctx->builder->getPtrTy(), { ctx->builder->getPtrTy() }, false));
-      auto const fn(llvm_module->getOrInsertFunction("jank_deref", fn_type));
+      auto const fn(llvm_module->getOrInsertFunction("jank_var_deref", fn_type));
 
       llvm::SmallVector<llvm::Value *, 1> const args{ gen_var(qualified_name) };
       auto const call(ctx->builder->CreateCall(fn, args));
@@ -2930,7 +4057,7 @@ namespace jank::codegen
       ctx->builder->SetInsertPoint(ctx->global_ctor_block);
       auto const fn_type(
         llvm::FunctionType::get(ctx->builder->getPtrTy(), { ctx->builder->getPtrTy() }, false));
-      auto const fn(llvm_module->getOrInsertFunction("jank_deref", fn_type));
+      auto const fn(llvm_module->getOrInsertFunction("jank_var_deref", fn_type));
 
       llvm::SmallVector<llvm::Value *, 1> const args{ gen_var(qualified_name) };
       auto const call(ctx->builder->CreateCall(fn, args));
@@ -3573,27 +4700,49 @@ namespace jank::codegen
                                      * NOLINTNEXTLINE(clang-analyzer-core.CallAndMessage) */
                                     : highest_fixed_arity->fn_ctx->param_count);
 
-    auto const arity_flags_fn_type(llvm::FunctionType::get(
-      ctx->builder->getInt8Ty(),
-      { ctx->builder->getInt8Ty(), ctx->builder->getInt8Ty(), ctx->builder->getInt8Ty() },
-      false));
+    auto const has_local_rest(variadic_arity && variadic_arity->fn_ctx->has_local_rest);
+
+    auto const is_closure(!captures.empty());
+
+    /* A fn which doesn't close over anything is the same every time its form is evaluated,
+     * so it's lifted into a global, which is made once, when the module is loaded. With
+     * --reclaim-jit-code, the global would keep the module loaded for good, so the fn is
+     * made each time instead. */
+    auto const is_lifted(!is_closure && !util::cli::opts.reclaim_jit_code);
+    auto const prev_block(ctx->builder->GetInsertBlock());
+    llvm::GlobalVariable *lifted_global{};
+    std::optional<llvm::IRBuilder<>::InsertPointGuard> lifted_guard;
+    if(is_lifted)
+    {
+      lifted_global = create_global_var(util::format("{}_lifted", munge(expr->unique_name)));
+      llvm_module->insertGlobalVariable(lifted_global);
+      lifted_guard.emplace(*ctx->builder);
+      ctx->builder->SetInsertPoint(ctx->global_ctor_block);
+    }
+
+    auto const arity_flags_fn_type(llvm::FunctionType::get(ctx->builder->getInt8Ty(),
+                                                           { ctx->builder->getInt8Ty(),
+                                                             ctx->builder->getInt8Ty(),
+                                                             ctx->builder->getInt8Ty(),
+                                                             ctx->builder->getInt8Ty() },
+                                                           false));
     auto const arity_flags_fn(
       llvm_module->getOrInsertFunction("jank_function_build_arity_flags", arity_flags_fn_type));
     auto const arity_flags(ctx->builder->CreateCall(arity_flags_fn,
                                                     { ctx->builder->getInt8(highest_fixed_args),
                                                       ctx->builder->getInt8(!!variadic_arity),
-                                                      ctx->builder->getInt8(variadic_ambiguous) }));
+                                                      ctx->builder->getInt8(variadic_ambiguous),
+                                                      ctx->builder->getInt8(has_local_rest) }));
 
     llvm::Value *fn_obj{};
 
-    auto const is_closure(!captures.empty());
-
     if(!is_closure)
     {
       auto const create_fn_type(
         llvm::FunctionType::get(ctx->builder->getPtrTy(), { ctx->builder->getInt8Ty() }, false));
-      auto const create_fn(
-        llvm_module->getOrInsertFunction("jank_function_create", create_fn_type));
+      auto const create_fn(llvm_module->getOrInsertFunction(
+        is_lifted ? "jank_function_create_lifted" : "jank_function_create",
+        create_fn_type));
       fn_obj = ctx->builder->CreateCall(create_fn, { arity_flags });
     }
     else
@@ -3603,11 +4752,39 @@ namespace jank::codegen
         get_or_insert_struct_type(util::format("{}_context", munge(expr->unique_name)),
                                   capture_types));
 
-      auto const malloc_fn_type(
-        llvm::FunctionType::get(ctx->builder->getPtrTy(), { ctx->builder->getInt64Ty() }, false));
-      auto const malloc_fn(llvm_module->getOrInsertFunction("GC_malloc", malloc_fn_type));
-      auto const closure_obj(
-        ctx->builder->CreateCall(malloc_fn, { llvm::ConstantExpr::getSizeOf(closure_ctx_type) }));
+      llvm::Value *closure_obj{};
+      /* When escape analysis has shown this closure can't outlive the current fn, its
+       * context goes on the stack. We put that in the entry block so a closure made within
+       * a loop reuses the same slot, rather than growing the stack on each iteration. The
+       * GC scans the stack, so the captures are still kept alive. */
+      if(expr->has_stack_context)
+      {
+        auto &entry_bb{ ctx->builder->GetInsertBlock()->getParent()->getEntryBlock() };
+        llvm::IRBuilder<> entry_builder(&entry_bb, entry_bb.getFirstInsertionPt());
+        closure_obj = entry_builder.CreateAlloca(closure_ctx_type, nullptr, "closure.context");
+      }
+      /* Otherwise, the captures are flattened into the closure object, right after it, so a
+       * closure is a single allocation. */
+      else
+      {
+        static constexpr auto offset_of_base{ offsetof(runtime::obj::jit_closure, base) };
+        static constexpr auto offset_of_captures_from_base{ sizeof(runtime::obj::jit_closure)
+                                                            - offset_of_base };
+
+        auto const create_fn_type(
+          llvm::FunctionType::get(ctx->builder->getPtrTy(),
+                                  { ctx->builder->getInt8Ty(), ctx->builder->getInt64Ty() },
+                                  false));
+        auto const create_fn(
+          llvm_module->getOrInsertFunction("jank_closure_create_flat", create_fn_type));
+        fn_obj = ctx->builder->CreateCall(create_fn,
+                                          { arity_flags, ctx->builder->getInt64(captures.size()) });
+        closure_obj = ctx->builder->CreateInBoundsGEP(
+          ctx->builder->getInt8Ty(),
+          fn_obj,
+          { ctx->builder->getInt64(offset_of_captures_from_base) },
+          "closure.context");
+      }
 
       usize index{};
       for(auto const &capture : captures)
@@ -3635,12 +4812,16 @@ namespace jank::codegen
         }
       }
 
-      auto const create_fn_type(
-        llvm::FunctionType::get(ctx->builder->getPtrTy(),
-                                { ctx->builder->getInt8Ty(), ctx->builder->getPtrTy() },
-                                false));
-      auto const create_fn(llvm_module->getOrInsertFunction("jank_closure_create", create_fn_type));
-      fn_obj = ctx->builder->CreateCall(create_fn, { arity_flags, closure_obj });
+      if(expr->has_stack_context)
+      {
+        auto const create_fn_type(
+          llvm::FunctionType::get(ctx->builder->getPtrTy(),
+                                  { ctx->builder->getInt8Ty(), ctx->builder->getPtrTy() },
+                                  false));
+        auto const create_fn(
+          llvm_module->getOrInsertFunction("jank_closure_create", create_fn_type));
+        fn_obj = ctx->builder->CreateCall(create_fn, { arity_flags, closure_obj });
+      }
     }
 
     for(auto const &arity : expr->arities)
@@ -3681,6 +4862,16 @@ namespace jank::codegen
       ctx->builder->CreateCall(set_meta_fn, { fn_obj, meta });
     }
 
+    if(is_lifted)
+    {
+      ctx->builder->CreateStore(fn_obj, lifted_global);
+      lifted_guard.reset();
+      if(prev_block != ctx->global_ctor_block)
+      {
+        fn_obj = ctx->builder->CreateLoad(ctx->builder->getPtrTy(), lifted_global);
+      }
+    }
+
     return fn_obj;
   }
 
@@ -3691,6 +4882,7 @@ namespace jank::codegen
                                            llvm::Function::ExternalLinkage,
                                            ctx->ctor_name.c_str(),
                                            *llvm_module));
+    keep_frame_pointer(init);
     ctx->global_ctor_block->insertInto(init);
 
     /* XXX: Modules are written to object files, which can't use global ctors until
@@ -3796,8 +4988,33 @@ namespace jank::codegen
     return ctx->builder->CreateRetVoid();
   }
 
+  /* All of the new values are computed before any are stored, since they may depend on the
+   * old param values. */
+  llvm::Value *
+  llvm_processor::impl::gen_self_tail_call(native_vector<expression_ref> const &arg_exprs,
+                                           expr::function_arity const &arity)
+  {
+    jank_debug_assert(arg_exprs.size() == self_call_params.size());
+
+    native_vector<llvm::Value *> values;
+    values.reserve(arg_exprs.size());
+    for(auto const &arg_expr : arg_exprs)
+    {
+      values.emplace_back(load_if_needed(ctx, gen(arg_expr, arity)));
+    }
+
+    for(usize i{}; i < values.size(); ++i)
+    {
+      ctx->builder->CreateStore(values[i], self_call_params[i]);
+    }
+
+    ctx->builder->CreateStackRestore(self_call_stack.data);
+    return ctx->builder->CreateBr(self_call_block.data);
+  }
+
   void llvm_processor::optimize() const
   {
+    profile::phase_timer const phase{ profile::phase::llvm_optimize };
     jtl::immutable_string_view const print_settings{ getenv("JANK_PRINT_IR") ?: "" };
     if(print_settings == "1")
     {
@@ -3813,7 +5030,9 @@ namespace jank::codegen
     }
 #endif
 
+    auto const start{ std::chrono::steady_clock::now() };
     _impl->ctx->mpm.run(*_impl->llvm_module, *_impl->ctx->mam);
+    jit::stats::record_optimize(jit::stats::since(start));
 
     if(print_settings == "2")
     {
@@ -3840,4 +5059,9 @@ namespace jank::codegen
   {
     return _impl->root_fn->unique_name;
   }
+
+  jtl::immutable_string const &llvm_processor::get_ctor_name() const
+  {
+    return _impl->ctx->ctor_name;
+  }
 }
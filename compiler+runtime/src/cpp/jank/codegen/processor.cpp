@@ -14,6 +14,7 @@
 #include <jank/util/escape.hpp>
 #include <jank/util/fmt/print.hpp>
 #include <jank/profile/time.hpp>
+#include <jank/profile/phase.hpp>
 #include <jank/detail/to_runtime_data.hpp>
 
 /* The strategy for codegen to C++ is quite simple. Codegen always happens on a
@@ -502,6 +503,10 @@ namespace jank::codegen
     , struct_name{ runtime::munge(root_fn->unique_name) }
   {
     assert(root_fn->frame.data);
+
+    /* Most fns need a few KB of code, so this saves growing the body a doubling at a time. */
+    body_buffer.reserve(4096);
+    header_buffer.reserve(1024);
   }
 
   jtl::option<handle>
@@ -1044,6 +1049,70 @@ namespace jank::codegen
       }
     }
 
+    /* Protocol calls make their inline cache the first time they're run. From then on, the
+     * cache dispatches them on the type of their first arg. */
+    if(!elided && expr->is_protocol_call)
+    {
+      auto const ref{ llvm::cast<analyze::expr::var_deref>(expr->source_expr.data) };
+      auto const &var(lift_var(lifted_vars, ref->var->to_qualified_symbol()->to_string(), false));
+      auto const site_tmp{ runtime::munge(__rt_ctx->unique_string("protocol_site")) };
+      util::format_to(body_buffer,
+                      "static auto const {}{ "
+                      "jank::runtime::obj::protocol_call_site::create({}, {}) };",
+                      site_tmp,
+                      var,
+                      expr->arg_exprs.size());
+      format_direct_call(site_tmp, ret_tmp.str(true), expr->arg_exprs, fn_arity);
+      elided = true;
+    }
+
+    /* Keyword lookups each get a cache of where the key was in the last map they saw. For
+     * (:k m), the map is the first arg. For (m :k), the map is the source. */
+    if(!elided && expr->is_keyword_lookup)
+    {
+      auto const source_tmp(gen(expr->source_expr, fn_arity).unwrap());
+      native_vector<handle> arg_tmps;
+      for(auto const &arg_expr : expr->arg_exprs)
+      {
+        arg_tmps.emplace_back(gen(arg_expr, fn_arity).unwrap());
+      }
+
+      auto const site_tmp{ runtime::munge(__rt_ctx->unique_string("keyword_site")) };
+      auto const is_keyword_source{ expr->source_expr->kind
+                                    == analyze::expression_kind::primitive_literal };
+      util::format_to(body_buffer, "static jank::runtime::obj::keyword_call_site {};", site_tmp);
+      util::format_to(body_buffer,
+                      "auto const {}({}.{}({}",
+                      ret_tmp.str(true),
+                      site_tmp,
+                      (is_keyword_source ? "get" : "call"),
+                      source_tmp.str(true));
+      for(auto const &arg_tmp : arg_tmps)
+      {
+        util::format_to(body_buffer, ", {}", arg_tmp.str(true));
+      }
+      util::format_to(body_buffer, "));");
+      elided = true;
+    }
+
+    /* Direct linked calls resolve the var's fn while we're compiling, just as the LLVM
+     * backend does, and then always call it directly. Its address is embedded into the
+     * generated code, so this can't be done when compiling files. The analyzer has already
+     * ensured the call hits a fixed arity. */
+    if(!elided && expr->is_direct_linked && !truthy(__rt_ctx->compile_files_var->deref()))
+    {
+      auto const ref{ llvm::cast<analyze::expr::var_deref>(expr->source_expr.data) };
+      auto const linked{ runtime::direct_link(ref->var) };
+      auto const link_tmp{ runtime::munge(__rt_ctx->unique_string("link")) };
+      util::format_to(body_buffer,
+                      "auto * const {}{ reinterpret_cast<jank::runtime::behavior::callable *>({}ull) "
+                      "};",
+                      link_tmp,
+                      reinterpret_cast<uintptr_t>(linked.data));
+      format_direct_call(link_tmp, ret_tmp.str(true), expr->arg_exprs, fn_arity);
+      elided = true;
+    }
+
     if(!elided)
     {
       auto const &source_tmp(gen(expr->source_expr, fn_arity));
@@ -1303,29 +1372,44 @@ namespace jank::codegen
     /* Since each codegen proc handles one callable struct, we create a new one for this fn. */
     processor prc{ expr, module, fn_target };
 
+    /* Nested fns share their parent's lifted constants, for eval as well as modules, so
+     * each constant is only created once, rather than every time a fn using it is
+     * instantiated. The root fn declares all of them. */
+    /* TODO: Share a context instead. */
     if(fn_target == compilation_target::function)
     {
-      /* TODO: Share a context instead. */
       prc.lifted_vars = lifted_vars;
-      prc.lifted_constants = lifted_constants;
+    }
+    prc.lifted_constants = lifted_constants;
 
-      prc.build_body();
+    prc.build_body();
 
+    if(fn_target == compilation_target::function)
+    {
       lifted_vars = jtl::move(prc.lifted_vars);
-      lifted_constants = jtl::move(prc.lifted_constants);
       prc.lifted_vars.clear();
-      prc.lifted_constants.clear();
     }
+    lifted_constants = jtl::move(prc.lifted_constants);
+    prc.lifted_constants.clear();
 
     util::format_to(deps_buffer, "{}", prc.declaration_str());
 
+    /* A fn which doesn't close over anything is the same every time its form is evaluated,
+     * so it's only made once. */
+    auto const instance{ expr->captures().empty()
+                           ? util::format("jank::runtime::obj::lifted_function_instance<{}>()",
+                                          runtime::module::nest_native_ns(
+                                            runtime::module::module_to_native_ns(module),
+                                            prc.struct_name))
+                           : prc.expression_str() };
+
     switch(expr->position)
     {
       case analyze::expression_position::statement:
       case analyze::expression_position::value:
-        return prc.expression_str();
+        return instance;
       case analyze::expression_position::tail:
-        util::format_to(body_buffer, "return {};", prc.expression_str());
+        util::format_to(body_buffer, "return {};", instance);
         return none;
     }
   }
@@ -1800,11 +1884,21 @@ namespace jank::codegen
 
     auto const &value_tmp{ gen(expr->value_expr, fn_arity) };
 
-    util::format_to(body_buffer,
-                    "switch(jank_shift_mask_case_integer({}.get(), {}, {})) {",
-                    value_tmp.unwrap().str(true),
-                    expr->shift,
-                    expr->mask);
+    if(expr->is_int_test)
+    {
+      util::format_to(body_buffer,
+                      "switch(jank_case_integer({}.get(), {})) {",
+                      value_tmp.unwrap().str(true),
+                      expr->unused_key());
+    }
+    else
+    {
+      util::format_to(body_buffer,
+                      "switch(jank_shift_mask_case_integer({}.get(), {}, {})) {",
+                      value_tmp.unwrap().str(true),
+                      expr->shift,
+                      expr->mask);
+    }
 
     jank_debug_assert(expr->keys.size() == expr->exprs.size());
     for(usize i{}; i < expr->keys.size(); ++i)
@@ -2353,7 +2447,8 @@ namespace jank::codegen
     auto finalizer_tmp{ runtime::munge(__rt_ctx->unique_string("finalizer")) };
     auto value_tmp{ gen(expr->value_expr, arity) };
     auto const type_name{ cpp_util::get_qualified_type_name(expr->type) };
-    auto const needs_finalizer{ !Cpp::IsTriviallyDestructible(expr->type) };
+    /* Scoped objects are destroyed by their cpp/delete, so they don't need a finalizer. */
+    auto const needs_finalizer{ !expr->scoped && !Cpp::IsTriviallyDestructible(expr->type) };
 
     if(needs_finalizer)
     {
@@ -2420,6 +2515,7 @@ namespace jank::codegen
     if(!generated_declaration)
     {
       profile::timer const timer{ util::format("cpp gen {}", root_fn->name) };
+      profile::phase_timer const phase{ profile::phase::cpp_gen };
 
       /* Module targeting works in a special way, with the goal of
        * cutting down the generated code size. Instead of each function
@@ -2516,14 +2612,38 @@ namespace jank::codegen
       }
 
 
-      for(auto const &v : lifted_constants)
+      /* For eval, there's no load function to initialize the constants in, but we still
+       * want them shared by every fn in the form, so they're initialized globals. */
+      if(target == compilation_target::eval)
       {
-        /* TODO: Typed lifted constants (in analysis). */
-        util::format_to(lifted_buffer,
-                        "{} {} {};",
-                        detail::gen_constant_type(v.first, true),
-                        lifted_const,
-                        v.second);
+        if(!lifted_constants.empty())
+        {
+          util::format_to(module_header_buffer,
+                          "namespace {} {",
+                          runtime::module::module_to_native_ns(module));
+          for(auto const &v : lifted_constants)
+          {
+            util::format_to(module_header_buffer,
+                            "{} const {}{",
+                            detail::gen_constant_type(v.first, true),
+                            v.second);
+            detail::gen_constant(v.first, module_header_buffer, true);
+            util::format_to(module_header_buffer, "};");
+          }
+          util::format_to(module_header_buffer, "}");
+        }
+      }
+      else
+      {
+        for(auto const &v : lifted_constants)
+        {
+          /* TODO: Typed lifted constants (in analysis). */
+          util::format_to(lifted_buffer,
+                          "{} {} {};",
+                          detail::gen_constant_type(v.first, true),
+                          lifted_const,
+                          v.second);
+        }
       }
     }
 
@@ -2555,11 +2675,19 @@ namespace jank::codegen
 
     {
       native_set<uhash> used_captures;
-      util::format_to(header_buffer, ") : jank::runtime::obj::jit_function{ ");
       /* TODO: All of the meta in clojure.core alone costs 2s to JIT compile at run-time.
        * How can this be faster? */
-      detail::gen_constant(root_fn->meta, header_buffer, true);
-      util::format_to(header_buffer, "}");
+      if(arity_flags.empty())
+      {
+        util::format_to(header_buffer, ") : jank::runtime::obj::jit_function{ {} }", lifted_meta);
+      }
+      else
+      {
+        util::format_to(header_buffer,
+                        ") : jank::runtime::obj::jit_function{ {}, {} }",
+                        lifted_meta,
+                        arity_flags);
+      }
 
       for(auto const &arity : root_fn->arities)
       {
@@ -2597,14 +2725,6 @@ namespace jank::codegen
                             v.first);
           }
         }
-
-
-        for(auto const &v : lifted_constants)
-        {
-          util::format_to(header_buffer, ", {}{", v.second);
-          detail::gen_constant(v.first, header_buffer, true);
-          util::format_to(header_buffer, "}");
-        }
       }
     }
 
@@ -2618,6 +2738,10 @@ namespace jank::codegen
       return;
     }
 
+    /* The meta is the same for every instance of the fn, so it's built once, with the
+     * other constants. */
+    lifted_meta = detail::lift_constant(lifted_constants, root_fn->meta);
+
     analyze::expr::function_arity const *variadic_arity{};
     analyze::expr::function_arity const *highest_fixed_arity{};
     for(auto const &arity : root_fn->arities)
@@ -2704,13 +2828,11 @@ namespace jank::codegen
                                      && highest_fixed_arity->fn_ctx->param_count
                                        == variadic_arity->fn_ctx->param_count - 1 };
 
-      util::format_to(body_buffer,
-                      R"(
-          callable::arity_flag_t get_arity_flags() const final
-          { return callable::build_arity_flags({}, true, {}); }
-        )",
-                      variadic_arity->fn_ctx->param_count - 1,
-                      variadic_ambiguous);
+      /* This goes to the base, in the header. */
+      arity_flags = util::format("callable::build_arity_flags({}, true, {}, {})",
+                                 variadic_arity->fn_ctx->param_count - 1,
+                                 variadic_ambiguous,
+                                 variadic_arity->fn_ctx->has_local_rest);
     }
   }
 
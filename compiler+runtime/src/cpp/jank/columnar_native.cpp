@@ -0,0 +1,61 @@
+#include <jank/columnar_native.hpp>
+#include <jank/runtime/convert/function.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/obj/column_table.hpp>
+#include <jank/runtime/obj/native_function_wrapper.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
+#include <jank/runtime/obj/keyword.hpp>
+#include <jank/runtime/rtti.hpp>
+
+namespace jank::columnar_native
+{
+  using namespace jank;
+  using namespace jank::runtime;
+
+  static object_ref table(object_ref const keys, object_ref const rows)
+  {
+    return obj::column_table::create(keys, rows);
+  }
+
+  static object_ref column(object_ref const t, object_ref const key)
+  {
+    return try_object<obj::column_table>(t)->column(key);
+  }
+
+  static object_ref
+  reduce_column(object_ref const f, object_ref const init, object_ref const t, object_ref const key)
+  {
+    return try_object<obj::column_table>(t)->reduce_column(key, f, init);
+  }
+
+  static object_ref map_column(object_ref const f, object_ref const t, object_ref const key)
+  {
+    return try_object<obj::column_table>(t)->map_column(key, f);
+  }
+
+  static object_ref filter_column(object_ref const pred, object_ref const t, object_ref const key)
+  {
+    return try_object<obj::column_table>(t)->filter_column(key, pred);
+  }
+}
+
+extern "C" void jank_load_jank_columnar_native()
+{
+  using namespace jank;
+  using namespace jank::runtime;
+
+  auto const ns(__rt_ctx->intern_ns("jank.columnar-native"));
+
+  auto const intern_fn([=](jtl::immutable_string const &name, auto const fn) {
+    ns->intern_var(name)->bind_root(
+      make_box<obj::native_function_wrapper>(convert_function(fn))
+        ->with_meta(obj::persistent_hash_map::create_unique(std::make_pair(
+          __rt_ctx->intern_keyword("name").expect_ok(),
+          make_box(obj::symbol{ __rt_ctx->current_ns()->to_string(), name }.to_string())))));
+  });
+  intern_fn("table", &columnar_native::table);
+  intern_fn("column", &columnar_native::column);
+  intern_fn("reduce-column", &columnar_native::reduce_column);
+  intern_fn("map-column", &columnar_native::map_column);
+  intern_fn("filter-column", &columnar_native::filter_column);
+}
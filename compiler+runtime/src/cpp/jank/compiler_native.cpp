@@ -57,12 +57,25 @@ extern "C" void jank_load_jank_compiler_native()
 
   auto const ns(__rt_ctx->intern_ns("jank.compiler-native"));
 
-  auto const intern_fn([=](jtl::immutable_string const &name, auto const fn) {
-    ns->intern_var(name)->bind_root(
+  /* Everything is gathered up first, so the vars can all be interned in one go. */
+  native_vector<obj::symbol_ref> names;
+  native_vector<object_ref> roots;
+  auto const name_kw(__rt_ctx->intern_keyword("name").expect_ok());
+  auto const current_ns_name(__rt_ctx->current_ns()->to_string());
+
+  auto const intern_fn([&](jtl::immutable_string const &name, auto const fn) {
+    names.emplace_back(make_box<obj::symbol>("", name));
+    roots.emplace_back(
       make_box<obj::native_function_wrapper>(convert_function(fn))
-        ->with_meta(obj::persistent_hash_map::create_unique(std::make_pair(
-          __rt_ctx->intern_keyword("name").expect_ok(),
-          make_box(obj::symbol{ __rt_ctx->current_ns()->to_string(), name }.to_string())))));
+        ->with_meta(obj::persistent_hash_map::create_unique(
+          std::make_pair(name_kw,
+                         make_box(obj::symbol{ current_ns_name, name }.to_string())))));
   });
   intern_fn("native-source", &compiler_native::native_source);
+
+  auto const vars(ns->intern_vars(names));
+  for(usize i{}; i < vars.size(); ++i)
+  {
+    vars[i]->bind_root(roots[i]);
+  }
 }
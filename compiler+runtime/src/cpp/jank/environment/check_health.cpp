@@ -15,6 +15,7 @@
 #include <jank/runtime/core/equal.hpp>
 #include <jank/runtime/core/make_box.hpp>
 #include <jank/aot/processor.hpp>
+#include <jank/jit/stats.hpp>
 #include <jank/util/clang.hpp>
 #include <jank/util/environment.hpp>
 #include <jank/util/fmt/print.hpp>
@@ -322,8 +323,6 @@ namespace jank::environment
                         terminal_style::reset);
   }
 
-  /* This is disabled until IR gen supports ref counting OR we switch back to using a GC. */
-  [[maybe_unused]]
   static jtl::immutable_string check_ir_jit()
   {
     bool error{};
@@ -449,6 +448,29 @@ namespace jank::environment
                         terminal_style::reset);
   }
 
+  /* A summary of what the checks above cost to JIT compile, so slow installs, such as
+   * those without a working module cache, stand out. */
+  static jtl::immutable_string jit_stats()
+  {
+    auto const t{ jit::stats::totals() };
+    auto const ms([](u64 const ns) { return ns / 1'000'000; });
+    return util::format("{}─ ✅{} jit compiled {} KB of c++ in {} ms, {} ir modules, optimized "
+                        "in {} ms, and linked {} KB with {} symbols\n"
+                        "{}─ ✅{} module cache had {} hits and {} misses",
+                        terminal_style::green,
+                        terminal_style::reset,
+                        t.jit.cpp_bytes / 1024,
+                        ms(t.jit.clang_parse_ns),
+                        t.jit.ir_modules,
+                        ms(t.jit.llvm_optimize_ns),
+                        t.jit.object_bytes / 1024,
+                        t.jit.symbols,
+                        terminal_style::green,
+                        terminal_style::reset,
+                        t.cache_hits,
+                        t.cache_misses);
+  }
+
   static jtl::immutable_string header(std::string const &title, usize const max_width)
   {
     auto const padding_count(max_width - 3 - title.size());
@@ -503,8 +525,9 @@ namespace jank::environment
                       terminal_style::reset);
         util::println("{}", pch_location());
         util::println("{}", check_cpp_jit());
-        //util::println("{}", check_ir_jit());
+        util::println("{}", check_ir_jit());
         util::println("{}", check_aot());
+        util::println("{}", jit_stats());
         util::println("");
 
         return 0;
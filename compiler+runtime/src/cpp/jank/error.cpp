@@ -5,6 +5,7 @@
 #include <jank/runtime/core/meta.hpp>
 #include <jank/runtime/core/to_string.hpp>
 #include <jank/runtime/obj/keyword.hpp>
+#include <jank/util/try.hpp>
 
 namespace jank::error
 {
@@ -289,7 +290,7 @@ namespace jank::error
              jtl::immutable_string const &message,
              read::source const &source,
              runtime::object_ref const expansion,
-             std::unique_ptr<cpptrace::stacktrace> trace)
+             std::unique_ptr<cpptrace::raw_trace> trace)
     : kind{
       k
   }
@@ -405,7 +406,7 @@ namespace jank::error
              read::source const &source,
              runtime::object_ref const expansion,
              jtl::ref<base> const cause,
-             std::unique_ptr<cpptrace::stacktrace> trace)
+             std::unique_ptr<cpptrace::raw_trace> trace)
     : kind{
       k
   }
@@ -475,7 +476,10 @@ namespace jank::error
   error_ref internal_failure(jtl::immutable_string const &message)
   {
     auto const e{ make_error(kind::internal_failure, message, read::source::unknown()) };
-    e->trace = std::make_unique<cpptrace::stacktrace>(cpptrace::generate_trace());
+    if(util::capturing_stack_traces())
+    {
+      e->trace = std::make_unique<cpptrace::raw_trace>(cpptrace::generate_raw_trace());
+    }
     return e;
   }
 
@@ -10,6 +10,15 @@
 
 namespace jank::error
 {
+  static std::unique_ptr<cpptrace::raw_trace> copy_trace(cpptrace::raw_trace const *const trace)
+  {
+    if(!trace)
+    {
+      return nullptr;
+    }
+    return std::make_unique<cpptrace::raw_trace>(*trace);
+  }
+
   error_ref analyze_invalid_case(jtl::immutable_string const &message,
                                  read::source const &source,
                                  runtime::object_ref const expansion)
@@ -171,7 +180,7 @@ namespace jank::error
   }
 
   error_ref analyze_macro_expansion_exception(std::exception const &e,
-                                              cpptrace::stacktrace const &trace,
+                                              cpptrace::raw_trace const *trace,
                                               read::source const &source,
                                               runtime::object_ref const expansion)
   {
@@ -179,11 +188,11 @@ namespace jank::error
                       e.what(),
                       source,
                       expansion,
-                      std::make_unique<cpptrace::stacktrace>(trace));
+                      copy_trace(trace));
   }
 
   error_ref analyze_macro_expansion_exception(runtime::object_ref const e,
-                                              cpptrace::stacktrace const &trace,
+                                              cpptrace::raw_trace const *trace,
                                               read::source const &source,
                                               runtime::object_ref const expansion)
   {
@@ -193,11 +202,11 @@ namespace jank::error
                         : runtime::to_code_string(e),
                       source,
                       expansion,
-                      std::make_unique<cpptrace::stacktrace>(trace));
+                      copy_trace(trace));
   }
 
   error_ref analyze_macro_expansion_exception(jtl::immutable_string const &e,
-                                              cpptrace::stacktrace const &trace,
+                                              cpptrace::raw_trace const *trace,
                                               read::source const &source,
                                               runtime::object_ref const expansion)
   {
@@ -205,11 +214,11 @@ namespace jank::error
                       e,
                       source,
                       expansion,
-                      std::make_unique<cpptrace::stacktrace>(trace));
+                      copy_trace(trace));
   }
 
   error_ref analyze_macro_expansion_exception(error_ref const e,
-                                              cpptrace::stacktrace const &trace,
+                                              cpptrace::raw_trace const *trace,
                                               read::source const &source,
                                               runtime::object_ref const expansion)
   {
@@ -219,7 +228,7 @@ namespace jank::error
                       source,
                       expansion,
                       e,
-                      std::make_unique<cpptrace::stacktrace>(trace));
+                      copy_trace(trace));
   }
 
   error_ref analyze_invalid_conversion(jtl::immutable_string const &message)
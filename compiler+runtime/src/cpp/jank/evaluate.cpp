@@ -1,19 +1,32 @@
+#include <array>
+#include <atomic>
+#include <mutex>
+
 #include <Interpreter/Compatibility.h>
 #include <Interpreter/CppInterOpInterpreter.h>
 #include <clang/Interpreter/CppInterOp.h>
 #include <llvm/ExecutionEngine/Orc/LLJIT.h>
 
+#include <folly/Synchronized.h>
+
 #include <jank/runtime/context.hpp>
 #include <jank/runtime/ns.hpp>
 #include <jank/runtime/visit.hpp>
 #include <jank/runtime/core.hpp>
 #include <jank/runtime/core/meta.hpp>
 #include <jank/runtime/behavior/callable.hpp>
+#include <jank/runtime/behavior/metadatable.hpp>
+#include <jank/runtime/obj/jit_closure.hpp>
+#include <jank/runtime/obj/jit_function.hpp>
+#include <jank/c_api.h>
 #include <jank/codegen/llvm_processor.hpp>
 #include <jank/codegen/processor.hpp>
 #include <jank/jit/processor.hpp>
+#include <jank/jit/tiering.hpp>
 #include <jank/evaluate.hpp>
 #include <jank/profile/time.hpp>
+#include <jank/profile/phase.hpp>
+#include <jank/util/cli.hpp>
 #include <jank/util/scope_exit.hpp>
 #include <jank/util/fmt/print.hpp>
 #include <jank/util/clang_format.hpp>
@@ -149,7 +162,7 @@ namespace jank::evaluate
                                 jtl::make_ref<expr::do_>(expression_position::tail, frame, true),
                                 frame,
                                 fn_ctx };
-    expr->frame->parent = arity.frame;
+    expr->frame->set_parent(arity.frame);
     ret->frame = arity.frame->parent.unwrap_or(arity.frame);
     fn_ctx->name = ret->name;
     fn_ctx->unique_name = ret->unique_name;
@@ -160,7 +173,7 @@ namespace jank::evaluate
     arity.fn_ctx->param_count = arity.params.size();
     for(auto const &sym : arity.params)
     {
-      arity.frame->locals.emplace(sym, local_binding{ sym, sym->name, none, arity.frame });
+      arity.frame->add_local(sym, local_binding{ sym, sym->name, none, arity.frame });
     }
 
     auto const expr_type{ cpp_util::expression_type(expr) };
@@ -253,15 +266,509 @@ namespace jank::evaluate
       expr);
   }
 
-  object_ref eval(expression_ref const ex)
+  /* Evaluates a sub-expression, within the current scope. */
+  static object_ref interpret(expression_ref const ex)
   {
-    profile::timer const timer{ util::format("eval ast node {}",
-                                             analyze::expression_kind_str(ex->kind)) };
     object_ref ret{};
     visit_expr([&ret](auto const typed_ex) { ret = eval(typed_ex); }, ex);
     return ret;
   }
 
+  /* The interpreter, enabled with --interpret.
+   *
+   * JIT compiling a fn costs far more than running it once, and most of what runs while
+   * loading a module only runs once. So, rather than JIT compiling every fn, we can
+   * interpret it straight from its AST. Once it's been called enough times, or if its var
+   * is ^:jit, it's JIT compiled instead. Anything which uses C++ interop is always JIT
+   * compiled, since there's nothing the interpreter can do with it.
+   *
+   * Interpreted fns are jit_closures, with arities which enter the interpreter and a context
+   * which holds the fn's expression and the locals it closed over. */
+
+  /* A local bound by the interpreter. These are linked together, newest first. Closures
+   * share the links which were in scope when they were made, so a link is never changed
+   * once it's in scope, other than to tie together the fns of a letfn. */
+  struct interpreted_local
+  {
+    static constexpr bool pointer_free{ false };
+
+    obj::symbol_ref name;
+    /* Set instead of the name for the fn itself, which named recursion refers to. */
+    expr::function const *fn{};
+    object_ref value;
+    interpreted_local *next{};
+  };
+
+  /* Where a recur leaves its args for its loop or fn. A recur is always in tail position, so
+   * nothing else is evaluated between it setting these and the loop or fn seeing them. */
+  struct recur_target
+  {
+    native_vector<object_ref> args;
+    bool is_pending{};
+  };
+
+  /* The locals and recur target for whatever the interpreter is evaluating. Scopes live on
+   * the stack, which keeps their locals reachable by the GC. The innermost one is found
+   * through a thread local, since eval doesn't take any state. Outside of the interpreter,
+   * there's no scope. */
+  struct interpreter_scope
+  {
+    interpreted_local *locals{};
+    recur_target *recur{};
+  };
+
+  static thread_local interpreter_scope const *current_scope{};
+
+  /* Makes a scope current, until the guard is destroyed. */
+  struct scope_guard
+  {
+    scope_guard(interpreter_scope const * const scope)
+      : previous{ current_scope }
+    {
+      current_scope = scope;
+    }
+
+    scope_guard(scope_guard const &) = delete;
+    scope_guard(scope_guard &&) = delete;
+
+    ~scope_guard()
+    {
+      current_scope = previous;
+    }
+
+    scope_guard &operator=(scope_guard const &) = delete;
+    scope_guard &operator=(scope_guard &&) = delete;
+
+    interpreter_scope const *previous{};
+  };
+
+  /* A new scope starts out with everything in the current one. */
+  static interpreter_scope nested_scope()
+  {
+    if(current_scope)
+    {
+      return *current_scope;
+    }
+    return {};
+  }
+
+  static interpreted_local *
+  bind_local(interpreted_local * const next, obj::symbol_ref const name, object_ref const value)
+  {
+    return new(GC) interpreted_local{ name, nullptr, value, next };
+  }
+
+  /* Tracks the calls to an interpreted fn, so it can be JIT compiled once it's hot. Each
+   * fn expression can only be JIT compiled once, so there's one of these per expression,
+   * shared by every fn made from it. Only fns which don't close over anything have one,
+   * since a JIT compiled fn can't see the interpreter's locals. */
+  struct jit_promotion
+  {
+    static constexpr bool pointer_free{ false };
+
+    expr::function_ref expr;
+    std::atomic<u32> calls{};
+    std::atomic_bool is_started{};
+    std::atomic<object *> compiled{};
+  };
+
+  /* This keeps each promotion, and so its expression, alive for good. There's only one per
+   * fn expression which has been interpreted, so this only grows with the code. */
+  /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+  static folly::Synchronized<native_unordered_map<expr::function const *, jit_promotion *>>
+    promotions;
+
+  /* The JIT isn't safe to use from multiple threads, but any thread may be the one which
+   * calls a fn enough to promote it. */
+  /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+  static std::mutex promotion_lock;
+
+  struct interpreted_fn
+  {
+    static constexpr bool pointer_free{ false };
+
+    expr::function_ref expr;
+    interpreted_local *closed_over{};
+    /* Null for fns which can't be JIT compiled on their own. */
+    jit_promotion *promotion{};
+  };
+
+  static object_ref jit_compile(expr::function_ref const expr);
+
+  /* Whether the interpreter can evaluate everything within this expression. */
+  static bool is_interpretable(expression_ref const expr)
+  {
+    if(expression_kind::cpp_value_min <= expr->kind && expr->kind <= expression_kind::cpp_value_max)
+    {
+      return false;
+    }
+
+    bool ret{ true };
+    expr->walk([&](expression_ref const child) { ret = ret && is_interpretable(child); });
+    return ret;
+  }
+
+  /* Within an interpreted fn, everything is known to be interpretable, so we only need to
+   * check from the top. */
+  static bool should_interpret(expression_ref const expr)
+  {
+    return current_scope || (util::cli::opts.interpret && is_interpretable(expr));
+  }
+
+  static bool has_jit_hint(object_ref const meta)
+  {
+    return truthy(get(meta, __rt_ctx->intern_keyword("jit").expect_ok()));
+  }
+
+  static behavior::callable::arity_flag_t arity_flags_of(expr::function const &fn)
+  {
+    expr::function_arity const *variadic_arity{};
+    expr::function_arity const *highest_fixed_arity{};
+    for(auto const &arity : fn.arities)
+    {
+      if(arity.fn_ctx->is_variadic)
+      {
+        variadic_arity = &arity;
+      }
+      else if(!highest_fixed_arity
+              || highest_fixed_arity->fn_ctx->param_count < arity.fn_ctx->param_count)
+      {
+        highest_fixed_arity = &arity;
+      }
+    }
+
+    auto const variadic_ambiguous(highest_fixed_arity && variadic_arity
+                                  && highest_fixed_arity->fn_ctx->param_count
+                                    == variadic_arity->fn_ctx->param_count - 1);
+    auto const highest_fixed_args(variadic_arity ? variadic_arity->fn_ctx->param_count - 1
+                                                 : highest_fixed_arity->fn_ctx->param_count);
+    return behavior::callable::build_arity_flags(static_cast<u8>(highest_fixed_args),
+                                                 variadic_arity != nullptr,
+                                                 variadic_ambiguous,
+                                                 variadic_arity
+                                                   && variadic_arity->fn_ctx->has_local_rest);
+  }
+
+  /* Calls exactly the arity which takes this many args. Unlike dynamic_call, this never
+   * packs args, since they've already been packed for the arity we're forwarding. */
+  static object_ref
+  call_arity(behavior::callable &fn, object_ref const * const args, usize const arg_count)
+  {
+    switch(arg_count)
+    {
+      case 0:
+        return fn.call();
+      case 1:
+        return fn.call(args[0]);
+      case 2:
+        return fn.call(args[0], args[1]);
+      case 3:
+        return fn.call(args[0], args[1], args[2]);
+      case 4:
+        return fn.call(args[0], args[1], args[2], args[3]);
+      case 5:
+        return fn.call(args[0], args[1], args[2], args[3], args[4]);
+      case 6:
+        return fn.call(args[0], args[1], args[2], args[3], args[4], args[5]);
+      case 7:
+        return fn.call(args[0], args[1], args[2], args[3], args[4], args[5], args[6]);
+      case 8:
+        return fn.call(args[0], args[1], args[2], args[3], args[4], args[5], args[6], args[7]);
+      case 9:
+        return fn.call(args[0],
+                       args[1],
+                       args[2],
+                       args[3],
+                       args[4],
+                       args[5],
+                       args[6],
+                       args[7],
+                       args[8]);
+      default:
+        return fn.call(args[0],
+                       args[1],
+                       args[2],
+                       args[3],
+                       args[4],
+                       args[5],
+                       args[6],
+                       args[7],
+                       args[8],
+                       args[9]);
+    }
+  }
+
+  /* Counts a call and returns the JIT compiled fn, once there is one. The call which
+   * reaches the threshold does the compiling. */
+  static behavior::callable *promoted_fn(jit_promotion &promotion)
+  {
+    if(auto const compiled = promotion.compiled.load(std::memory_order_acquire))
+    {
+      return try_object<obj::jit_function>(compiled).data;
+    }
+
+    if(promotion.calls.fetch_add(1, std::memory_order_relaxed) + 1 < util::cli::opts.jit_threshold
+       || promotion.is_started.exchange(true, std::memory_order_acq_rel))
+    {
+      return nullptr;
+    }
+
+    /* If this throws, the fn is left interpreted. Any fn which can be analyzed should be
+     * possible to compile, though, so this would've thrown without the interpreter, too. */
+    object_ref compiled;
+    {
+      std::lock_guard<std::mutex> const locked{ promotion_lock };
+      compiled = jit_compile(promotion.expr);
+    }
+    promotion.compiled.store(compiled.data, std::memory_order_release);
+    return try_object<obj::jit_function>(compiled).data;
+  }
+
+  static expr::function_arity const &find_arity(expr::function const &fn, usize const arg_count)
+  {
+    /* A variadic arity is called with its rest args already packed, so it takes as many args
+     * as it has params, just like a fixed arity. There can't be both for the same count. */
+    expr::function_arity const *ret{};
+    for(auto const &arity : fn.arities)
+    {
+      if(arity.params.size() == arg_count)
+      {
+        ret = &arity;
+        break;
+      }
+    }
+    jank_debug_assert(ret);
+    return *ret;
+  }
+
+  static object_ref
+  call_interpreted(object * const self, object_ref const * const args, usize const arg_count)
+  {
+    auto const &fn(*static_cast<interpreted_fn *>(expect_object<obj::jit_closure>(self)->context));
+    if(fn.promotion)
+    {
+      if(auto const compiled = promoted_fn(*fn.promotion))
+      {
+        return call_arity(*compiled, args, arg_count);
+      }
+    }
+
+    auto const &arity(find_arity(*fn.expr, arg_count));
+    recur_target recur;
+    interpreter_scope scope{ new(GC) interpreted_local{ {}, fn.expr.data, self, fn.closed_over },
+                             &recur };
+    scope_guard const guard{ &scope };
+
+    auto const fn_locals(scope.locals);
+    for(usize i{}; i < arg_count; ++i)
+    {
+      scope.locals = bind_local(scope.locals, arity.params[i], args[i]);
+    }
+
+    while(true)
+    {
+      auto const ret(eval(arity.body));
+      if(!recur.is_pending)
+      {
+        return ret;
+      }
+
+      recur.is_pending = false;
+      scope.locals = fn_locals;
+      for(usize i{}; i < arg_count; ++i)
+      {
+        scope.locals = bind_local(scope.locals, arity.params[i], recur.args[i]);
+      }
+    }
+  }
+
+  template <usize>
+  using arity_param = object *;
+
+  template <usize... I>
+  static object *interpret_arity(object * const self, arity_param<I> const... args)
+  {
+    std::array<object_ref, sizeof...(I)> const arg_refs{ object_ref{ args }... };
+    return call_interpreted(self, arg_refs.data(), arg_refs.size()).data;
+  }
+
+  static void set_interpreted_arity(obj::jit_closure &fn, usize const param_count)
+  {
+    switch(param_count)
+    {
+      case 0:
+        fn.arity_0 = &interpret_arity<>;
+        break;
+      case 1:
+        fn.arity_1 = &interpret_arity<0>;
+        break;
+      case 2:
+        fn.arity_2 = &interpret_arity<0, 1>;
+        break;
+      case 3:
+        fn.arity_3 = &interpret_arity<0, 1, 2>;
+        break;
+      case 4:
+        fn.arity_4 = &interpret_arity<0, 1, 2, 3>;
+        break;
+      case 5:
+        fn.arity_5 = &interpret_arity<0, 1, 2, 3, 4>;
+        break;
+      case 6:
+        fn.arity_6 = &interpret_arity<0, 1, 2, 3, 4, 5>;
+        break;
+      case 7:
+        fn.arity_7 = &interpret_arity<0, 1, 2, 3, 4, 5, 6>;
+        break;
+      case 8:
+        fn.arity_8 = &interpret_arity<0, 1, 2, 3, 4, 5, 6, 7>;
+        break;
+      case 9:
+        fn.arity_9 = &interpret_arity<0, 1, 2, 3, 4, 5, 6, 7, 8>;
+        break;
+      default:
+        jank_debug_assert(param_count == max_params);
+        fn.arity_10 = &interpret_arity<0, 1, 2, 3, 4, 5, 6, 7, 8, 9>;
+        break;
+    }
+  }
+
+  static jit_promotion *find_promotion(expr::function_ref const expr)
+  {
+    if(!expr->captures().empty())
+    {
+      return nullptr;
+    }
+
+    auto locked(promotions.wlock());
+    auto const found(locked->find(expr.data));
+    if(found != locked->end())
+    {
+      return found->second;
+    }
+    auto const ret(new(GC) jit_promotion{ expr });
+    locked->emplace(expr.data, ret);
+    return ret;
+  }
+
+  static object_ref
+  call_with_args(object_ref const source, native_vector<object_ref> const &arg_vals)
+  {
+    switch(arg_vals.size())
+    {
+      case 0:
+        return dynamic_call(source);
+      case 1:
+        return dynamic_call(source, arg_vals[0]);
+      case 2:
+        return dynamic_call(source, arg_vals[0], arg_vals[1]);
+      case 3:
+        return dynamic_call(source, arg_vals[0], arg_vals[1], arg_vals[2]);
+      case 4:
+        return dynamic_call(source, arg_vals[0], arg_vals[1], arg_vals[2], arg_vals[3]);
+      case 5:
+        return dynamic_call(source,
+                            arg_vals[0],
+                            arg_vals[1],
+                            arg_vals[2],
+                            arg_vals[3],
+                            arg_vals[4]);
+      case 6:
+        return dynamic_call(source,
+                            arg_vals[0],
+                            arg_vals[1],
+                            arg_vals[2],
+                            arg_vals[3],
+                            arg_vals[4],
+                            arg_vals[5]);
+      case 7:
+        return dynamic_call(source,
+                            arg_vals[0],
+                            arg_vals[1],
+                            arg_vals[2],
+                            arg_vals[3],
+                            arg_vals[4],
+                            arg_vals[5],
+                            arg_vals[6]);
+      case 8:
+        return dynamic_call(source,
+                            arg_vals[0],
+                            arg_vals[1],
+                            arg_vals[2],
+                            arg_vals[3],
+                            arg_vals[4],
+                            arg_vals[5],
+                            arg_vals[6],
+                            arg_vals[7]);
+      case 9:
+        return dynamic_call(source,
+                            arg_vals[0],
+                            arg_vals[1],
+                            arg_vals[2],
+                            arg_vals[3],
+                            arg_vals[4],
+                            arg_vals[5],
+                            arg_vals[6],
+                            arg_vals[7],
+                            arg_vals[8]);
+      case 10:
+        return dynamic_call(source,
+                            arg_vals[0],
+                            arg_vals[1],
+                            arg_vals[2],
+                            arg_vals[3],
+                            arg_vals[4],
+                            arg_vals[5],
+                            arg_vals[6],
+                            arg_vals[7],
+                            arg_vals[8],
+                            arg_vals[9]);
+      default:
+        {
+          return dynamic_call(source,
+                              arg_vals[0],
+                              arg_vals[1],
+                              arg_vals[2],
+                              arg_vals[3],
+                              arg_vals[4],
+                              arg_vals[5],
+                              arg_vals[6],
+                              arg_vals[7],
+                              arg_vals[8],
+                              arg_vals[9],
+                              try_object<obj::persistent_list>(arg_vals[10]));
+        }
+    }
+  }
+
+  static object_ref make_interpreted_fn(expr::function_ref const expr)
+  {
+    auto const fn(new(GC) interpreted_fn{ expr,
+                                          current_scope ? current_scope->locals : nullptr,
+                                          find_promotion(expr) });
+    auto const ret(make_box<obj::jit_closure>(arity_flags_of(*expr), fn));
+    for(auto const &arity : expr->arities)
+    {
+      set_interpreted_arity(*ret, arity.params.size());
+    }
+    if(expr->meta.is_some())
+    {
+      ret->meta = behavior::detail::validate_meta(strip_source_from_meta(expr->meta));
+    }
+    return ret;
+  }
+
+  object_ref eval(expression_ref const ex)
+  {
+    profile::timer const timer{ util::format("eval ast node {}",
+                                             analyze::expression_kind_str(ex->kind)) };
+    profile::phase_timer const phase{ profile::phase::eval };
+    /* Code which is evaluated from within an interpreted fn, such as by clojure.core/eval,
+     * can't see that fn's locals. */
+    scope_guard const guard{ nullptr };
+    return interpret(ex);
+  }
+
   object_ref eval(expr::def_ref const expr)
   {
     auto var(__rt_ctx->intern_var(expr->name).expect_ok());
@@ -276,7 +783,22 @@ namespace jank::evaluate
       return var;
     }
 
-    auto const evaluated_value(eval(expr->value.unwrap()));
+    auto const value_expr(expr->value.unwrap());
+    object_ref evaluated_value;
+    /* A ^:jit var skips the interpreter, so long as its fn can be compiled on its own. */
+    if(util::cli::opts.interpret && value_expr->kind == expression_kind::function
+       && has_jit_hint(meta))
+    {
+      auto const fn_expr(jtl::static_ref_cast<expr::function>(value_expr));
+      if(fn_expr->captures().empty())
+      {
+        evaluated_value = jit_compile(fn_expr);
+      }
+    }
+    if(evaluated_value.is_nil())
+    {
+      evaluated_value = interpret(value_expr);
+    }
     var->bind_root(evaluated_value);
 
     return var;
@@ -296,7 +818,7 @@ namespace jank::evaluate
 
   object_ref eval(expr::call_ref const expr)
   {
-    auto source(eval(expr->source_expr));
+    auto source(interpret(expr->source_expr));
     while(source->type == object_type::var)
     {
       source = deref(source);
@@ -314,94 +836,10 @@ namespace jank::evaluate
             arg_vals.reserve(expr->arg_exprs.size());
             for(auto const &arg_expr : expr->arg_exprs)
             {
-              arg_vals.emplace_back(eval(arg_expr));
+              arg_vals.emplace_back(interpret(arg_expr));
             }
 
-            switch(arg_vals.size())
-            {
-              case 0:
-                return dynamic_call(source);
-              case 1:
-                return dynamic_call(source, arg_vals[0]);
-              case 2:
-                return dynamic_call(source, arg_vals[0], arg_vals[1]);
-              case 3:
-                return dynamic_call(source, arg_vals[0], arg_vals[1], arg_vals[2]);
-              case 4:
-                return dynamic_call(source, arg_vals[0], arg_vals[1], arg_vals[2], arg_vals[3]);
-              case 5:
-                return dynamic_call(source,
-                                    arg_vals[0],
-                                    arg_vals[1],
-                                    arg_vals[2],
-                                    arg_vals[3],
-                                    arg_vals[4]);
-              case 6:
-                return dynamic_call(source,
-                                    arg_vals[0],
-                                    arg_vals[1],
-                                    arg_vals[2],
-                                    arg_vals[3],
-                                    arg_vals[4],
-                                    arg_vals[5]);
-              case 7:
-                return dynamic_call(source,
-                                    arg_vals[0],
-                                    arg_vals[1],
-                                    arg_vals[2],
-                                    arg_vals[3],
-                                    arg_vals[4],
-                                    arg_vals[5],
-                                    arg_vals[6]);
-              case 8:
-                return dynamic_call(source,
-                                    arg_vals[0],
-                                    arg_vals[1],
-                                    arg_vals[2],
-                                    arg_vals[3],
-                                    arg_vals[4],
-                                    arg_vals[5],
-                                    arg_vals[6],
-                                    arg_vals[7]);
-              case 9:
-                return dynamic_call(source,
-                                    arg_vals[0],
-                                    arg_vals[1],
-                                    arg_vals[2],
-                                    arg_vals[3],
-                                    arg_vals[4],
-                                    arg_vals[5],
-                                    arg_vals[6],
-                                    arg_vals[7],
-                                    arg_vals[8]);
-              case 10:
-                return dynamic_call(source,
-                                    arg_vals[0],
-                                    arg_vals[1],
-                                    arg_vals[2],
-                                    arg_vals[3],
-                                    arg_vals[4],
-                                    arg_vals[5],
-                                    arg_vals[6],
-                                    arg_vals[7],
-                                    arg_vals[8],
-                                    arg_vals[9]);
-              default:
-                {
-                  return dynamic_call(source,
-                                      arg_vals[0],
-                                      arg_vals[1],
-                                      arg_vals[2],
-                                      arg_vals[3],
-                                      arg_vals[4],
-                                      arg_vals[5],
-                                      arg_vals[6],
-                                      arg_vals[7],
-                                      arg_vals[8],
-                                      arg_vals[9],
-                                      try_object<obj::persistent_list>(arg_vals[10]));
-                }
-            }
+            return call_with_args(source, arg_vals);
           }
           else if constexpr(std::same_as<T, obj::persistent_hash_set>
                             || std::same_as<T, obj::persistent_vector>
@@ -414,7 +852,7 @@ namespace jank::evaluate
                 util::format("Invalid call with {} args to: {}", s, typed_source->to_string())
               };
             }
-            return typed_source->call(eval(expr->arg_exprs[0]));
+            return typed_source->call(interpret(expr->arg_exprs[0]));
           }
           else if constexpr(std::same_as<T, obj::keyword>
                             || std::same_as<T, obj::persistent_hash_map>
@@ -425,9 +863,10 @@ namespace jank::evaluate
             switch(s)
             {
               case 1:
-                return typed_source->call(eval(expr->arg_exprs[0]));
+                return typed_source->call(interpret(expr->arg_exprs[0]));
               case 2:
-                return typed_source->call(eval(expr->arg_exprs[0]), eval(expr->arg_exprs[1]));
+                return typed_source->call(interpret(expr->arg_exprs[0]),
+                                          interpret(expr->arg_exprs[1]));
               default:
                 throw std::runtime_error{
                   util::format("Invalid call with {} args to: {}", s, typed_source->to_string())
@@ -467,7 +906,7 @@ namespace jank::evaluate
     native_vector<object_ref> ret;
     for(auto const &e : expr->data_exprs)
     {
-      ret.emplace_back(eval(e));
+      ret.emplace_back(interpret(e));
     }
 
     runtime::detail::native_persistent_list const npl{ ret.rbegin(), ret.rend() };
@@ -486,7 +925,7 @@ namespace jank::evaluate
     runtime::detail::native_transient_vector ret;
     for(auto const &e : expr->data_exprs)
     {
-      ret.push_back(eval(e));
+      ret.push_back(interpret(e));
     }
     if(expr->meta.is_some())
     {
@@ -507,8 +946,8 @@ namespace jank::evaluate
       usize i{};
       for(auto const &e : expr->data_exprs)
       {
-        array_box.data[i++] = eval(e.first);
-        array_box.data[i++] = eval(e.second);
+        array_box.data[i++] = interpret(e.first);
+        array_box.data[i++] = interpret(e.second);
       }
 
       if(expr->meta.is_some())
@@ -530,7 +969,7 @@ namespace jank::evaluate
       runtime::detail::native_transient_hash_map trans;
       for(auto const &e : expr->data_exprs)
       {
-        trans.insert({ eval(e.first), eval(e.second) });
+        trans.insert({ interpret(e.first), interpret(e.second) });
       }
 
       if(expr->meta.is_some())
@@ -549,7 +988,7 @@ namespace jank::evaluate
     runtime::detail::native_transient_hash_set ret;
     for(auto const &e : expr->data_exprs)
     {
-      ret.insert(eval(e));
+      ret.insert(interpret(e));
     }
     if(expr->meta.is_some())
     {
@@ -561,13 +1000,34 @@ namespace jank::evaluate
     }
   }
 
-  object_ref eval(expr::local_reference_ref const)
-  /* Doesn't make sense to eval these, since let is wrapped in a fn and JIT compiled. */
+  object_ref eval(expr::local_reference_ref const expr)
   {
+    if(current_scope)
+    {
+      for(auto it(current_scope->locals); it; it = it->next)
+      {
+        if(!it->fn && it->name->equal(*expr->name))
+        {
+          return it->value;
+        }
+      }
+    }
+
+    /* Outside of the interpreter, lets are wrapped in a fn and JIT compiled, so there are
+     * no locals to find. */
     throw make_box("unsupported eval: local_reference").erase();
   }
 
   object_ref eval(expr::function_ref const expr)
+  {
+    if(should_interpret(expr))
+    {
+      return make_interpreted_fn(expr);
+    }
+    return jit_compile(expr);
+  }
+
+  static object_ref jit_compile(expr::function_ref const expr)
   {
     profile::timer const timer{ util::format("eval jit function {}", expr->name) };
     auto const &module(
@@ -583,14 +1043,41 @@ namespace jank::evaluate
                                             module,
                                             codegen::compilation_target::eval };
       cg_prc.gen().expect_ok();
-      cg_prc.optimize();
 
-      __rt_ctx->jit_prc.load_ir_module(jtl::move(cg_prc.get_module()));
+      jit::code_owner *owner{};
+      if(jit::tiering::is_enabled())
+      {
+        cg_prc.optimize();
+        jit::tiering::load_tier0_module(__rt_ctx->jit_prc, jtl::move(cg_prc.get_module()));
+      }
+      else if(util::cli::opts.reclaim_jit_code)
+      {
+        cg_prc.optimize();
+        owner = __rt_ctx->jit_prc.load_reclaimable_ir_module(jtl::move(cg_prc.get_module()));
+      }
+      else if(auto cached{
+                __rt_ctx->jit_prc.find_cached_object(*cg_prc.get_module().getModuleUnlocked()) })
+      {
+        /* This form has been compiled before, so we can skip right to its object. Loaded
+         * objects don't have their global ctors run, so we do that ourselves. */
+        __rt_ctx->jit_prc.load_object(jtl::move(cached));
+        auto const ctor(__rt_ctx->jit_prc.find_symbol(cg_prc.get_ctor_name()).expect_ok());
+        reinterpret_cast<void (*)()>(ctor)();
+      }
+      else
+      {
+        cg_prc.optimize();
+        __rt_ctx->jit_prc.load_ir_module(jtl::move(cg_prc.get_module()));
+      }
 
       auto const fn(
         __rt_ctx->jit_prc.find_symbol(util::format("{}_0", munge(cg_prc.get_root_fn_name())))
           .expect_ok());
-      return reinterpret_cast<object *(*)()>(fn)();
+      auto const ret(reinterpret_cast<object *(*)()>(fn)());
+      /* The wrapper isn't a fn object, so nothing else holds the module until the fn it
+       * returns does. */
+      GC_reachable_here(owner);
+      return ret;
     }
     else
     {
@@ -612,22 +1099,59 @@ namespace jank::evaluate
     }
   }
 
-  object_ref eval(expr::recur_ref const)
-  /* This will always be in a fn or loop, which will be JIT compiled. */
+  object_ref eval(expr::recur_ref const expr)
+  {
+    /* Outside of the interpreter, this will always be in a fn or loop, which will be
+     * JIT compiled. */
+    if(!current_scope || !current_scope->recur)
+    {
+      throw make_box("unsupported eval: recur").erase();
+    }
+
+    native_vector<object_ref> args;
+    args.reserve(expr->arg_exprs.size());
+    for(auto const &arg_expr : expr->arg_exprs)
+    {
+      args.emplace_back(interpret(arg_expr));
+    }
+    current_scope->recur->args = jtl::move(args);
+    current_scope->recur->is_pending = true;
+    return jank_nil();
+  }
+
+  /* Finds the interpreted fn which named recursion refers to. */
+  static object_ref find_recursion_target(expr::function_context_ref const fn_ctx)
   {
-    throw make_box("unsupported eval: recur").erase();
+    if(current_scope)
+    {
+      for(auto it(current_scope->locals); it; it = it->next)
+      {
+        if(it->fn == fn_ctx->fn.data)
+        {
+          return it->value;
+        }
+      }
+    }
+
+    /* Outside of the interpreter, this will always be in a fn, which will be JIT compiled. */
+    throw make_box("unsupported eval: named recursion").erase();
   }
 
-  object_ref eval(expr::recursion_reference_ref const)
-  /* This will always be in a fn, which will be JIT compiled. */
+  object_ref eval(expr::recursion_reference_ref const expr)
   {
-    throw make_box("unsupported eval: recursion_reference").erase();
+    return find_recursion_target(expr->fn_ctx);
   }
 
-  object_ref eval(expr::named_recursion_ref const)
-  /* This will always be in a fn, which will be JIT compiled. */
+  object_ref eval(expr::named_recursion_ref const expr)
   {
-    throw make_box("unsupported eval: named_recursion").erase();
+    auto const source(find_recursion_target(expr->recursion_ref.fn_ctx));
+    native_vector<object_ref> arg_vals;
+    arg_vals.reserve(expr->arg_exprs.size());
+    for(auto const &arg_expr : expr->arg_exprs)
+    {
+      arg_vals.emplace_back(interpret(arg_expr));
+    }
+    return call_with_args(source, arg_vals);
   }
 
   object_ref eval(expr::do_ref const expr)
@@ -635,31 +1159,86 @@ namespace jank::evaluate
     object_ref ret{ jank_nil() };
     for(auto const &form : expr->values)
     {
-      ret = eval(form);
+      ret = interpret(form);
     }
     return ret;
   }
 
   object_ref eval(expr::let_ref const expr)
   {
-    return dynamic_call(eval(wrap_expression(expr, "let", {})));
+    if(!should_interpret(expr))
+    {
+      return dynamic_call(eval(wrap_expression(expr, "let", {})));
+    }
+
+    auto scope(nested_scope());
+    recur_target recur;
+    if(expr->is_loop)
+    {
+      scope.recur = &recur;
+    }
+    scope_guard const guard{ &scope };
+
+    auto const outer_locals(scope.locals);
+    for(auto const &pair : expr->pairs)
+    {
+      scope.locals = bind_local(scope.locals, pair.first, interpret(pair.second));
+    }
+
+    while(true)
+    {
+      auto const ret(eval(expr->body));
+      if(!recur.is_pending)
+      {
+        return ret;
+      }
+
+      recur.is_pending = false;
+      scope.locals = outer_locals;
+      for(usize i{}; i < expr->pairs.size(); ++i)
+      {
+        scope.locals = bind_local(scope.locals, expr->pairs[i].first, recur.args[i]);
+      }
+    }
   }
 
   object_ref eval(expr::letfn_ref const expr)
   {
-    return dynamic_call(eval(wrap_expression(expr, "letfn", {})));
+    if(!should_interpret(expr))
+    {
+      return dynamic_call(eval(wrap_expression(expr, "letfn", {})));
+    }
+
+    auto scope(nested_scope());
+    scope_guard const guard{ &scope };
+
+    /* Each fn closes over all of them, itself included, so they're all bound before any
+     * of them are made. */
+    native_vector<interpreted_local *> fn_locals;
+    fn_locals.reserve(expr->pairs.size());
+    for(auto const &pair : expr->pairs)
+    {
+      scope.locals = bind_local(scope.locals, pair.first, jank_nil());
+      fn_locals.emplace_back(scope.locals);
+    }
+    for(usize i{}; i < expr->pairs.size(); ++i)
+    {
+      fn_locals[i]->value = eval(expr->pairs[i].second);
+    }
+
+    return eval(expr->body);
   }
 
   object_ref eval(expr::if_ref const expr)
   {
-    auto const condition(eval(expr->condition));
+    auto const condition(interpret(expr->condition));
     if(truthy(condition))
     {
-      return eval(expr->then);
+      return interpret(expr->then);
     }
     else if(expr->else_.is_some())
     {
-      return eval(expr->else_.unwrap());
+      return interpret(expr->else_.unwrap());
     }
     return jank_nil();
   }
@@ -670,7 +1249,7 @@ namespace jank::evaluate
      * clojure.main uses the stack trace to provide source info by stripping out
      * Clojure frames until the first non-Clojure frame is found. If we throw
      * from an eval, maybe that doesn't happen? For now, we support eval, however. */
-    throw eval(expr->value);
+    throw interpret(expr->value);
   }
 
   object_ref eval(expr::try_ref const expr)
@@ -692,16 +1271,39 @@ namespace jank::evaluate
     }
     catch(object_ref const e)
     {
-      return dynamic_call(eval(wrap_expression(expr->catch_body.unwrap().body,
-                                               "catch",
-                                               { expr->catch_body.unwrap().sym })),
-                          e);
+      auto const &catch_body(expr->catch_body.unwrap());
+      if(!should_interpret(catch_body.body))
+      {
+        return dynamic_call(eval(wrap_expression(catch_body.body, "catch", { catch_body.sym })),
+                            e);
+      }
+
+      auto scope(nested_scope());
+      scope.locals = bind_local(scope.locals, catch_body.sym, e);
+      scope_guard const guard{ &scope };
+      return eval(catch_body.body);
     }
   }
 
   object_ref eval(expr::case_ref const expr)
   {
-    return dynamic_call(eval(wrap_expression(expr, "case", {})));
+    if(!should_interpret(expr))
+    {
+      return dynamic_call(eval(wrap_expression(expr, "case", {})));
+    }
+
+    auto const value(interpret(expr->value_expr));
+    auto const key(expr->is_int_test
+                     ? jank_case_integer(value.data, expr->unused_key())
+                     : jank_shift_mask_case_integer(value.data, expr->shift, expr->mask));
+    for(usize i{}; i < expr->keys.size(); ++i)
+    {
+      if(expr->keys[i] == key)
+      {
+        return interpret(expr->exprs[i]);
+      }
+    }
+    return interpret(expr->default_expr);
   }
 
   object_ref eval(expr::cpp_raw_ref const expr)
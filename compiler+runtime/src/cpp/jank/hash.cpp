@@ -130,8 +130,23 @@ namespace jank::hash
   {
     auto const length(input.size());
     u32 h1{ seed };
+    usize i{ 1 };
 
-    for(usize i{ 1 }; i < length; i += 2)
+    /* Each block is mixed on its own before being folded into the hash, so we mix four at
+     * a time, which the CPU can do in parallel, and only the folding is done in order. */
+    for(; i + 6 < length; i += 8)
+    {
+      auto const k1(mix_k1(static_cast<u32>(input[i - 1] | (input[i] << 16))));
+      auto const k2(mix_k1(static_cast<u32>(input[i + 1] | (input[i + 2] << 16))));
+      auto const k3(mix_k1(static_cast<u32>(input[i + 3] | (input[i + 4] << 16))));
+      auto const k4(mix_k1(static_cast<u32>(input[i + 5] | (input[i + 6] << 16))));
+      h1 = mix_h1(h1, k1);
+      h1 = mix_h1(h1, k2);
+      h1 = mix_h1(h1, k3);
+      h1 = mix_h1(h1, k4);
+    }
+
+    for(; i < length; i += 2)
     {
       auto k1(static_cast<u32>(input[i - 1] | (input[i] << 16)));
       k1 = mix_k1(k1);
@@ -155,6 +170,12 @@ namespace jank::hash
 
   u32 visit(runtime::object_ref const o)
   {
+    /* Keywords are the most common map keys, and their hash is kept inline, so this skips
+     * the dispatch for them. */
+    if(o->type == runtime::object_type::keyword)
+    {
+      return runtime::expect_object<runtime::obj::keyword>(o)->hash;
+    }
     return runtime::visit_object([](auto const typed_o) -> u32 { return typed_o->to_hash(); }, o);
   }
 
@@ -173,15 +194,8 @@ namespace jank::hash
         using T = typename decltype(typed_sequence)::value_type;
         if constexpr(runtime::behavior::sequenceable<T>)
         {
-          u32 n{};
-          u32 hash{ 1 };
-          for(auto const e : make_sequence_range(typed_sequence))
-          {
-            hash = (31 * hash) + visit(e);
-            ++n;
-          }
-
-          return mix_collection_hash(hash, n);
+          auto const range(make_sequence_range(typed_sequence));
+          return ordered(range.begin(), range.end());
         }
         else
         {
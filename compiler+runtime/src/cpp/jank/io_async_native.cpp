@@ -0,0 +1,184 @@
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#include <jank/io_async_native.hpp>
+#include <jank/runtime/convert/function.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/executor.hpp>
+#include <jank/runtime/io.hpp>
+#include <jank/runtime/sequence_range.hpp>
+#include <jank/runtime/obj/channel.hpp>
+#include <jank/runtime/obj/keyword.hpp>
+#include <jank/runtime/obj/native_function_wrapper.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
+#include <jank/runtime/obj/persistent_vector.hpp>
+#include <jank/runtime/obj/promise.hpp>
+#include <jank/runtime/rtti.hpp>
+
+namespace jank::io_async_native
+{
+  using namespace jank;
+  using namespace jank::runtime;
+
+  /* The files of one call. The tasks only hold a pointer to this, so it needs to be GC
+   * memory, for everything it holds to stay alive until they're done. */
+  struct batch
+  {
+    native_vector<jtl::immutable_string> paths;
+    native_vector<jtl::immutable_string> contents;
+    native_vector<obj::promise_ref> promises;
+    /* Only set for read-files-chan, which closes it once every file is done. */
+    obj::channel_ref chan;
+    std::atomic<usize> remaining{};
+    bool append{};
+  };
+
+  static object_ref keyword(char const * const name)
+  {
+    return __rt_ctx->intern_keyword(name).expect_ok();
+  }
+
+  /* The same shape as ex-info gives. */
+  static object_ref io_error(jtl::immutable_string const &path, error_ref const e)
+  {
+    return obj::persistent_hash_map::create_unique(
+      std::make_pair(keyword("error"), make_box(e->message)),
+      std::make_pair(keyword("data"),
+                     obj::persistent_hash_map::create_unique(
+                       std::make_pair(keyword("path"), make_box(path)))));
+  }
+
+  /* Files are read and written on the solo executor, since each one can block. They're
+   * split between at most one task per core, each of which goes through its share one
+   * after the other, so thousands of files don't mean thousands of threads. */
+  template <typename F>
+  static void run_batched(batch * const b, F const &f)
+  {
+    auto const count{ b->paths.size() };
+    auto const tasks{ std::min<usize>(count,
+                                      std::max<usize>(1, std::thread::hardware_concurrency())) };
+    for(usize t{}; t < tasks; ++t)
+    {
+      solo_executor().submit([b, t, tasks, count, f] {
+        for(usize i{ t }; i < count; i += tasks)
+        {
+          f(b, i);
+        }
+      });
+    }
+  }
+
+  static batch *make_batch(object_ref const paths)
+  {
+    auto const b{ new(GC) batch{} };
+    for_each_item(paths, [&](object_ref const path) {
+      b->paths.emplace_back(runtime::to_string(path));
+    });
+    b->remaining.store(b->paths.size());
+    return b;
+  }
+
+  static obj::persistent_vector_ref promises_of(batch * const b, usize const count)
+  {
+    obj::transient_vector ret;
+    b->promises.reserve(count);
+    for(usize i{}; i < count; ++i)
+    {
+      auto const p{ make_box<obj::promise>() };
+      b->promises.emplace_back(p);
+      ret.conj_in_place(p);
+    }
+    return ret.to_persistent();
+  }
+
+  static object_ref read_file(jtl::immutable_string const &path)
+  {
+    auto const res{ io::slurp(path) };
+    if(res.is_err())
+    {
+      return io_error(path, res.expect_err());
+    }
+    return make_box(res.expect_ok());
+  }
+
+  static object_ref read_files(object_ref const paths)
+  {
+    auto const b{ make_batch(paths) };
+    auto const ret{ promises_of(b, b->paths.size()) };
+    run_batched(b, [](batch * const b, usize const i) {
+      b->promises[i]->deliver(read_file(b->paths[i]));
+    });
+    return ret;
+  }
+
+  static object_ref read_files_chan(object_ref const paths)
+  {
+    auto const b{ make_batch(paths) };
+    /* There's room for every file, so none of the puts ever wait. */
+    b->chan = make_box<obj::channel>(obj::channel::buffer_kind::fixed,
+                                     std::max<usize>(1, b->paths.size()));
+    auto const ret{ b->chan };
+    if(b->paths.empty())
+    {
+      b->chan->close();
+      return ret;
+    }
+
+    run_batched(b, [](batch * const b, usize const i) {
+      auto const &path{ b->paths[i] };
+      b->chan->put(make_box<obj::persistent_vector>(std::in_place, make_box(path), read_file(path)),
+                   obj::channel::make_handler(jank_nil()));
+      if(b->remaining.fetch_sub(1) == 1)
+      {
+        b->chan->close();
+      }
+    });
+    return ret;
+  }
+
+  static object_ref write_files(object_ref const entries, object_ref const append)
+  {
+    auto const b{ new(GC) batch{} };
+    b->append = truthy(append);
+    for_each_item(entries, [&](object_ref const e) {
+      b->paths.emplace_back(runtime::to_string(first(e)));
+      b->contents.emplace_back(runtime::to_string(second(e)));
+    });
+    auto const ret{ promises_of(b, b->paths.size()) };
+    run_batched(b, [](batch * const b, usize const i) {
+      auto const &path{ b->paths[i] };
+      auto const res{ io::spit(path, b->contents[i], b->append) };
+      if(res.is_err())
+      {
+        b->promises[i]->deliver(io_error(path, res.expect_err()));
+      }
+      else
+      {
+        b->promises[i]->deliver(make_box(path));
+      }
+    });
+    return ret;
+  }
+}
+
+extern "C" void jank_load_jank_io_async_native()
+{
+  using namespace jank;
+  using namespace jank::runtime;
+
+  auto const ns(__rt_ctx->intern_ns("jank.io.async-native"));
+
+  auto const intern_fn([=](jtl::immutable_string const &name, auto const fn) {
+    ns->intern_var(name)->bind_root(
+      make_box<obj::native_function_wrapper>(convert_function(fn))
+        ->with_meta(obj::persistent_hash_map::create_unique(std::make_pair(
+          __rt_ctx->intern_keyword("name").expect_ok(),
+          make_box(obj::symbol{ __rt_ctx->current_ns()->to_string(), name }.to_string())))));
+  });
+  intern_fn("read-files", &io_async_native::read_files);
+  intern_fn("read-files-chan", &io_async_native::read_files_chan);
+  intern_fn("write-files", &io_async_native::write_files);
+}
@@ -0,0 +1,93 @@
+#include <unistd.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <jank/jit/object_cache.hpp>
+#include <jank/profile/time.hpp>
+#include <jank/util/sha256.hpp>
+#include <jank/util/fmt.hpp>
+
+namespace jank::jit
+{
+  /* The JIT names each object it compiles after its module, with this suffix. */
+  static constexpr std::string_view object_suffix{ "-jitted-objectbuffer" };
+
+  object_cache::object_cache(jtl::immutable_string const &dir)
+    : dir{ dir }
+  {
+  }
+
+  jtl::immutable_string object_cache::path_of(jtl::immutable_string const &key) const
+  {
+    return util::format("{}/{}.o", dir, key);
+  }
+
+  std::unique_ptr<llvm::MemoryBuffer> object_cache::find(llvm::Module const &m)
+  {
+    profile::timer const timer{ "jit object cache find" };
+
+    std::string bitcode;
+    llvm::raw_string_ostream os{ bitcode };
+    llvm::WriteBitcodeToFile(m, os);
+    os.flush();
+    auto const key{ util::sha256(jtl::immutable_string{ bitcode.data(), bitcode.size() }) };
+
+    if(auto found{ llvm::MemoryBuffer::getFile(path_of(key).c_str()) })
+    {
+      return std::move(found.get());
+    }
+
+    std::lock_guard<std::mutex> const lock{ mutex };
+    pending.insert_or_assign(m.getModuleIdentifier(), key);
+    return nullptr;
+  }
+
+  void object_cache::compiled(llvm::MemoryBuffer const &object)
+  {
+    auto const id{ object.getBufferIdentifier() };
+    if(!id.ends_with(object_suffix))
+    {
+      return;
+    }
+
+    jtl::immutable_string key;
+    {
+      std::lock_guard<std::mutex> const lock{ mutex };
+      auto const found{ pending.find(id.drop_back(object_suffix.size()).str()) };
+      if(found == pending.end())
+      {
+        return;
+      }
+      key = found->second;
+      pending.erase(found);
+    }
+
+    /* The object is written beside its final path and then renamed into place, so that
+     * another process never loads part of one. Failing to cache it isn't an error. */
+    std::error_code ec;
+    std::filesystem::create_directories(dir.c_str(), ec);
+    auto const path{ path_of(key) };
+    auto const tmp{ util::format("{}.{}.tmp", path, ::getpid()) };
+    {
+      std::ofstream ofs{ tmp.c_str(), std::ios::binary };
+      ofs.write(object.getBufferStart(), static_cast<std::streamsize>(object.getBufferSize()));
+      if(!ofs)
+      {
+        std::filesystem::remove(tmp.c_str(), ec);
+        return;
+      }
+    }
+    std::filesystem::rename(tmp.c_str(), path.c_str(), ec);
+    if(ec)
+    {
+      std::filesystem::remove(tmp.c_str(), ec);
+    }
+  }
+}
@@ -1,3 +1,6 @@
+#include <unordered_map>
+#include <vector>
+
 #include <clang/AST/Type.h>
 #include <clang/Basic/Diagnostic.h>
 #include <clang/Frontend/CompilerInstance.h>
@@ -5,6 +8,7 @@
 #include <Interpreter/Compatibility.h>
 #include <clang/Interpreter/CppInterOp.h>
 #include <llvm/ExecutionEngine/Orc/Core.h>
+#include <llvm/IR/Instructions.h>
 #include <llvm/IR/Verifier.h>
 #include <llvm/Support/Signals.h>
 #include <llvm/ExecutionEngine/Orc/LLJIT.h>
@@ -16,14 +20,21 @@
 
 #include <cpptrace/gdb_jit.hpp>
 
+#include <gc/gc_cpp.h>
+
 #include <jank/jit/processor.hpp>
+#include <jank/jit/object_cache.hpp>
+#include <jank/jit/symbols.hpp>
+#include <jank/jit/stats.hpp>
 #include <jank/util/make_array.hpp>
 #include <jank/util/environment.hpp>
 #include <jank/util/fmt/print.hpp>
 #include <jank/util/clang.hpp>
 #include <jank/util/clang_format.hpp>
 #include <jank/runtime/context.hpp>
+#include <jank/runtime/module/remote_cache.hpp>
 #include <jank/profile/time.hpp>
+#include <jank/profile/phase.hpp>
 #include <jank/error/system.hpp>
 #include <jank/error/codegen.hpp>
 
@@ -78,14 +89,200 @@ namespace jank::jit
     }
   }
 
-  processor::processor(jtl::immutable_string const &binary_version)
+  /* Unloading code unregisters its objects from the debugger interface, but cpptrace
+   * keeps its own list, so we rebuild that from whatever is left. */
+  static void reregister_jit_stack_frames()
+  {
+    cpptrace::clear_all_jit_objects();
+    for(auto *entry = cpptrace::detail::__jit_debug_descriptor.first_entry; entry;
+        entry = entry->next_entry)
+    {
+      cpptrace::register_jit_object(entry->symfile_addr, entry->symfile_size);
+    }
+  }
+
+  /* gc_cleanup runs the dtor once the owner is unreachable. Finalizers can run on any
+   * thread which allocates, in the middle of anything, even a JIT link, so the tracker
+   * isn't removed right here. It's queued for reclaim_code instead. */
+  struct code_owner : gc_cleanup
+  {
+    code_owner(llvm::orc::ResourceTrackerSP tracker);
+    code_owner(code_owner const &) = delete;
+    code_owner(code_owner &&) noexcept = delete;
+    ~code_owner() override;
+
+    code_owner &operator=(code_owner const &) = delete;
+    code_owner &operator=(code_owner &&) noexcept = delete;
+
+    llvm::orc::ResourceTrackerSP tracker;
+  };
+
+  /* None of this holds GC memory, so it doesn't keep any owner reachable. */
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+  static std::mutex owners_mutex;
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+  static std::unordered_map<llvm::orc::ResourceKey, code_owner *> owners;
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+  static std::vector<llvm::orc::ResourceTrackerSP> collected_trackers;
+
+  code_owner::code_owner(llvm::orc::ResourceTrackerSP tracker)
+    : tracker{ std::move(tracker) }
+  {
+    std::lock_guard<std::mutex> const lock{ owners_mutex };
+    owners.emplace(this->tracker->getKeyUnsafe(), this);
+  }
+
+  code_owner::~code_owner()
   {
-    profile::timer const timer{ "jit ctor" };
+    std::lock_guard<std::mutex> const lock{ owners_mutex };
+    owners.erase(tracker->getKeyUnsafe());
+    collected_trackers.emplace_back(std::move(tracker));
+  }
 
+  /* Whether the user is part of the llvm.global_ctors list, which only has its fns called
+   * while the module is being loaded. */
+  static bool is_global_ctor_entry(llvm::User const * const user)
+  {
+    for(auto const * const u : user->users())
+    {
+      if(auto const global{ llvm::dyn_cast<llvm::GlobalVariable>(u) })
+      {
+        if(global->getName() != "llvm.global_ctors")
+        {
+          return false;
+        }
+      }
+      else if(!llvm::isa<llvm::Constant>(u) || !is_global_ctor_entry(u))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /* Owners are only held by the fn objects which the module's code makes, so that must
+   * be the only place any of its functions end up, apart from being called directly. One
+   * which is passed anywhere else, such as a finalizer for a C++ object, could still be
+   * called after every fn is gone. */
+  static bool is_reclaimable(llvm::Module const &m)
+  {
+    for(auto const &fn : m)
+    {
+      if(fn.isDeclaration())
+      {
+        continue;
+      }
+
+      for(auto const * const user : fn.users())
+      {
+        if(auto const call{ llvm::dyn_cast<llvm::CallBase>(user) })
+        {
+          if(call->getCalledOperand() == &fn)
+          {
+            continue;
+          }
+          auto const callee{ call->getCalledFunction() };
+          if(callee
+             && (callee->getName().starts_with("jank_function_set_arity")
+                 || callee->getName().starts_with("jank_closure_set_arity")))
+          {
+            continue;
+          }
+          return false;
+        }
+        if(!llvm::isa<llvm::Constant>(user) || !is_global_ctor_entry(user))
+        {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  static void load_library(Cpp::Interpreter &interpreter, jtl::immutable_string const &path)
+  {
+    llvm::cantFail(static_cast<clang::Interpreter &>(interpreter).LoadDynamicLibrary(path.data()));
+  }
+
+  /* This takes the interpreter directly, since it's used while the interpreter is still
+   * being created. */
+  static jtl::result<void, jtl::immutable_string>
+  load_dynamic_libs(processor const &prc,
+                    Cpp::Interpreter &interpreter,
+                    native_vector<jtl::immutable_string> const &libs)
+  {
+    for(auto const &lib : libs)
+    {
+      if(std::filesystem::path{ lib.c_str() }.is_absolute())
+      {
+        load_library(interpreter, lib);
+      }
+      else
+      {
+        auto const result{ prc.find_dynamic_lib(lib) };
+        if(result.is_none())
+        {
+          return err(util::format("Failed to load dynamic library '{}'.", lib));
+        }
+        else
+        {
+          load_library(interpreter, result.unwrap());
+        }
+      }
+    }
+
+    return ok();
+  }
+
+  processor::lazy_interpreter::lazy_interpreter(processor &owner)
+    : owner{ owner }
+  {
+  }
+
+  processor::lazy_interpreter::~lazy_interpreter() = default;
+
+  Cpp::Interpreter *processor::lazy_interpreter::get() const
+  {
+    if(auto const interpreter{ created.load(std::memory_order_acquire) }; interpreter)
+    {
+      return interpreter;
+    }
+
+    /* If creating it throws, the next use will try again. */
+    std::call_once(once, [this] {
+      value = owner.create_interpreter();
+      created.store(value.get(), std::memory_order_release);
+    });
+    return created.load(std::memory_order_acquire);
+  }
+
+  Cpp::Interpreter *processor::lazy_interpreter::operator->() const
+  {
+    return get();
+  }
+
+  Cpp::Interpreter &processor::lazy_interpreter::operator*() const
+  {
+    return *get();
+  }
+
+  bool processor::lazy_interpreter::is_created() const
+  {
+    return created.load(std::memory_order_acquire) != nullptr;
+  }
+
+  processor::processor(jtl::immutable_string const &binary_version)
+    : binary_version{ binary_version }
+  {
     for(auto const &library_dir : util::cli::opts.library_dirs)
     {
       library_dirs.emplace_back(std::filesystem::absolute(library_dir.c_str()));
     }
+  }
+
+  std::unique_ptr<Cpp::Interpreter> processor::create_interpreter()
+  {
+    profile::timer const timer{ "jit create interpreter" };
 
     /* When we AOT compile the jank compiler/runtime, we keep track of the compiler
      * flags used so we can use the same set during JIT compilation. Here we parse these
@@ -113,6 +310,14 @@ namespace jank::jit
     {
       args.emplace_back("-g");
     }
+    if(util::cli::opts.frame_pointers)
+    {
+      args.emplace_back("-fno-omit-frame-pointer");
+    }
+    if(auto const cpu_flag{ util::target_cpu_flag() }; cpu_flag.is_some())
+    {
+      args.emplace_back(strdup(cpu_flag.unwrap().c_str()));
+    }
 
     auto const clang_path_str{ util::find_clang() };
     if(clang_path_str.is_none())
@@ -152,16 +357,23 @@ namespace jank::jit
     args.emplace_back("-L");
     args.emplace_back(strdup(util::format("{}/lib", jank_resource_dir).c_str()));
 
-    /* We need to include our special runtime PCH. */
+    /* We need to include our special runtime PCH. This only has the core header group.
+     * See `require_header_group` for the rest. */
     auto pch_path{ util::find_pch(binary_version) };
     if(pch_path.is_none())
     {
+      pch_path = runtime::module::fetch_remote_pch(binary_version);
+    }
+    if(pch_path.is_none())
+    {
+      profile::timer const timer{ "jit build pch" };
       auto const res{ util::build_pch(args, binary_version) };
       if(res.is_err())
       {
         throw res.expect_err();
       }
       pch_path = res.expect_ok();
+      runtime::module::publish_remote_pch(binary_version, pch_path.unwrap());
     }
     auto const &pch_path_str{ pch_path.unwrap() };
     args.emplace_back("-include-pch");
@@ -191,8 +403,13 @@ namespace jank::jit
 
     //util::println("jit flags {}", args);
 
-    interpreter.reset(static_cast<Cpp::Interpreter *>(
-      Cpp::CreateInterpreter(args, {}, vfs, static_cast<int>(llvm::CodeModel::Large))));
+    /* Most of creating the interpreter is loading the PCH, so that's what this times. */
+    std::unique_ptr<Cpp::Interpreter> interp;
+    {
+      profile::timer const timer{ "jit load pch" };
+      interp.reset(static_cast<Cpp::Interpreter *>(
+        Cpp::CreateInterpreter(args, {}, vfs, static_cast<int>(llvm::CodeModel::Large))));
+    }
 
     /* Enabling perf support requires registering a couple of plugins with LLVM. These
      * plugins will generate files which perf can then use to inject additional info
@@ -206,7 +423,7 @@ namespace jank::jit
      */
     if(util::cli::opts.perf_profiling_enabled)
     {
-      auto const ee{ interpreter->getExecutionEngine() };
+      auto const ee{ interp->getExecutionEngine() };
       auto &es{ ee->getExecutionSession() };
       auto &ol{ ee->getObjLinkingLayer() };
       auto &oll{ llvm::cast<llvm::orc::ObjectLinkingLayer>(ol) };
@@ -231,11 +448,34 @@ namespace jank::jit
                                                                    true));
     }
 
-    auto const &load_result{ load_dynamic_libs(util::cli::opts.libs) };
+    /* The sampling profiler needs to name JIT compiled frames, even without --perf. */
+    if(auto * const oll{ llvm::dyn_cast<llvm::orc::ObjectLinkingLayer>(
+         &interp->getExecutionEngine()->getObjLinkingLayer()) })
+    {
+      symbols::track(*oll);
+    }
+
+    /* Every object the JIT compiles goes through the transform layer, which is where the
+     * object cache sees the objects for the modules which missed. */
+    if(util::cli::opts.cache_eval_objects)
+    {
+      objects = std::make_unique<object_cache>(
+        util::format("{}/eval", util::binary_cache_dir(binary_version)));
+      interp->getExecutionEngine()->getObjTransformLayer().setTransform(
+        [this](std::unique_ptr<llvm::MemoryBuffer> object)
+          -> llvm::Expected<std::unique_ptr<llvm::MemoryBuffer>> {
+          objects->compiled(*object);
+          return object;
+        });
+    }
+
+    auto const &load_result{ load_dynamic_libs(*this, *interp, util::cli::opts.libs) };
     if(load_result.is_err())
     {
       throw error::system_failure(load_result.expect_err().c_str());
     }
+
+    return interp;
   }
 
   processor::~processor()
@@ -251,11 +491,15 @@ namespace jank::jit
   void processor::eval_string(jtl::immutable_string const &s, clang::Value * const ret) const
   {
     profile::timer const timer{ "jit eval_string" };
+    profile::phase_timer const phase{ profile::phase::clang_parse };
     auto const &formatted{ s };
     /* TODO: There is some sort of immutable_string or result bug here. */
     //auto const &formatted{ util::format_cpp_source(s).expect_ok() };
     //util::println("// eval_string:\n{}\n", formatted);
+    auto const start{ std::chrono::steady_clock::now() };
     auto err(interpreter->ParseAndExecute({ formatted.data(), formatted.size() }, ret));
+    cpp_generation.fetch_add(1, std::memory_order_release);
+    stats::record_cpp(formatted.size(), stats::since(start));
     if(err)
     {
       llvm::logAllUnhandledErrors(jtl::move(err), llvm::errs(), "error: ");
@@ -266,33 +510,127 @@ namespace jank::jit
 
   void processor::load_object(jtl::immutable_string_view const &path) const
   {
-    auto const ee{ interpreter->getExecutionEngine() };
     auto file{ llvm::MemoryBuffer::getFile(std::string_view{ path }) };
     if(!file)
     {
       throw std::runtime_error{ util::format("failed to load object file: {}", path) };
     }
+    load_object(std::move(file.get()));
+  }
+
+  void processor::load_object(std::unique_ptr<llvm::MemoryBuffer> object) const
+  {
+    auto const ee{ interpreter->getExecutionEngine() };
     /* XXX: Object files won't be able to use global ctors until jank is on the ORC
      * runtime, which likely won't happen until clang::Interpreter is on the ORC runtime. */
     /* TODO: Return result on failure. */
-    llvm::cantFail(ee->addObjectFile(std::move(file.get())));
+    llvm::cantFail(ee->addObjectFile(std::move(object)));
     register_jit_stack_frames();
   }
 
+  std::unique_ptr<llvm::MemoryBuffer> processor::find_cached_object(llvm::Module const &m) const
+  {
+    /* The cache is made along with the interpreter. */
+    interpreter.get();
+    if(!objects)
+    {
+      return nullptr;
+    }
+    return objects->find(m);
+  }
+
   void processor::load_ir_module(llvm::orc::ThreadSafeModule &&m) const
   {
     auto const &module_name{ m.getModuleUnlocked()->getName() };
     profile::timer const timer{ util::format(
       "jit ir module {}",
       jtl::immutable_string_view{ module_name.data(), module_name.size() }) };
+    profile::phase_timer const phase{ profile::phase::jit_materialize };
     //m->print(llvm::outs(), nullptr);
 
+    u64 instructions{};
+    for(auto const &fn : *m.getModuleUnlocked())
+    {
+      instructions += fn.getInstructionCount();
+    }
+    stats::record_ir(instructions);
+
+    reclaim_code();
+    std::lock_guard<std::mutex> const lock{ ir_load_mutex };
     auto const ee(interpreter->getExecutionEngine());
     llvm::cantFail(ee->addIRModule(jtl::move(m)));
     llvm::cantFail(ee->initialize(ee->getMainJITDylib()));
     register_jit_stack_frames();
   }
 
+  code_owner *processor::load_reclaimable_ir_module(llvm::orc::ThreadSafeModule &&m) const
+  {
+    /* Without the symbol table, we can't tell which module a fn was made by. */
+    if(!symbols::is_tracking() || !is_reclaimable(*m.getModuleUnlocked()))
+    {
+      load_ir_module(jtl::move(m));
+      return nullptr;
+    }
+
+    auto const &module_name{ m.getModuleUnlocked()->getName() };
+    profile::timer const timer{ util::format(
+      "jit reclaimable ir module {}",
+      jtl::immutable_string_view{ module_name.data(), module_name.size() }) };
+    profile::phase_timer const phase{ profile::phase::jit_materialize };
+
+    u64 instructions{};
+    for(auto const &fn : *m.getModuleUnlocked())
+    {
+      instructions += fn.getInstructionCount();
+    }
+    stats::record_ir(instructions);
+
+    reclaim_code();
+    std::lock_guard<std::mutex> const lock{ ir_load_mutex };
+    auto const ee(interpreter->getExecutionEngine());
+    auto &dylib(ee->getMainJITDylib());
+    auto * const owner{ new code_owner{ dylib.createResourceTracker() } };
+    llvm::cantFail(ee->addIRModule(owner->tracker, jtl::move(m)));
+    llvm::cantFail(ee->initialize(dylib));
+    register_jit_stack_frames();
+    return owner;
+  }
+
+  code_owner *processor::find_code_owner(uintptr_t const address) const
+  {
+    auto const key{ symbols::find_resource(address) };
+    if(key.is_none())
+    {
+      return nullptr;
+    }
+    std::lock_guard<std::mutex> const lock{ owners_mutex };
+    auto const found{ owners.find(static_cast<llvm::orc::ResourceKey>(key.unwrap())) };
+    return found == owners.end() ? nullptr : found->second;
+  }
+
+  void processor::reclaim_code() const
+  {
+    std::vector<llvm::orc::ResourceTrackerSP> trackers;
+    {
+      std::lock_guard<std::mutex> const lock{ owners_mutex };
+      trackers.swap(collected_trackers);
+    }
+    if(trackers.empty())
+    {
+      return;
+    }
+
+    std::lock_guard<std::mutex> const lock{ ir_load_mutex };
+    for(auto const &tracker : trackers)
+    {
+      if(auto err{ tracker->remove() })
+      {
+        llvm::logAllUnhandledErrors(jtl::move(err), llvm::errs(), "error: ");
+      }
+    }
+    reregister_jit_stack_frames();
+  }
+
   void processor::load_bitcode(jtl::immutable_string const &module,
                                jtl::immutable_string_view const &bitcode) const
   {
@@ -328,6 +666,7 @@ namespace jank::jit
 
   jtl::string_result<void *> processor::find_symbol(jtl::immutable_string const &name) const
   {
+    profile::phase_timer const phase{ profile::phase::jit_materialize };
     if(auto symbol{ interpreter->getSymbolAddress(name.c_str()) })
     {
       return symbol.get().toPtr<void *>();
@@ -360,34 +699,35 @@ namespace jank::jit
     return none;
   }
 
-  jtl::result<void, jtl::immutable_string>
-  processor::load_dynamic_libs(native_vector<jtl::immutable_string> const &libs) const
+  void processor::load_dynamic_library(jtl::immutable_string const &path) const
   {
-    for(auto const &lib : libs)
+    load_library(*interpreter, path);
+  }
+
+  static char const *header_group_entrypoint(header_group const group)
+  {
+    switch(group)
     {
-      if(std::filesystem::path{ lib.c_str() }.is_absolute())
-      {
-        load_dynamic_library(lib);
-      }
-      else
-      {
-        auto const result{ processor::find_dynamic_lib(lib) };
-        if(result.is_none())
-        {
-          return err(util::format("Failed to load dynamic library '{}'.", lib));
-        }
-        else
-        {
-          load_dynamic_library(result.unwrap());
-        }
-      }
+      case header_group::interop:
+        return "jank/prelude/interop.hpp";
+      case header_group::count:
+        break;
     }
-
-    return ok();
+    jank_debug_assert(false);
+    return "";
   }
 
-  void processor::load_dynamic_library(jtl::immutable_string const &path) const
+  void processor::require_header_group(header_group const group) const
   {
-    llvm::cantFail(static_cast<clang::Interpreter &>(*interpreter).LoadDynamicLibrary(path.data()));
+    auto const index{ static_cast<usize>(group) };
+    jank_debug_assert(index < header_groups_included.size());
+
+    /* If including fails, the flag isn't set, so the next use will try again and report the
+     * error properly. */
+    std::call_once(header_groups_included[index], [&] {
+      auto const entrypoint{ header_group_entrypoint(group) };
+      profile::timer const timer{ util::format("jit include header group {}", entrypoint) };
+      eval_string(util::format("#include <{}>", entrypoint));
+    });
   }
 }
@@ -0,0 +1,273 @@
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <mutex>
+
+#include <jank/jit/stats.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
+#include <jank/runtime/obj/persistent_vector.hpp>
+
+namespace jank::jit::stats
+{
+  using namespace jank::runtime;
+
+  /* Only so many evals are kept, since a REPL session can go on for a while. */
+  static constexpr usize max_evals{ 32 };
+
+  struct module_entry
+  {
+    module_origin origin{};
+    u64 ns{};
+    counts self;
+  };
+
+  struct eval_entry
+  {
+    std::string label;
+    u64 ns{};
+    counts self;
+  };
+
+  /* None of this holds GC memory. */
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+  static std::mutex stats_mutex;
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+  static jank::jit::stats::totals all;
+  /* Only the latest load of each module is kept. */
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+  static std::map<std::string, module_entry> modules;
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+  static std::deque<eval_entry> evals;
+
+  static thread_local module_scope *current_module{};
+  static thread_local eval_scope *current_eval{};
+
+  counts &counts::operator+=(counts const &rhs)
+  {
+    cpp_evals += rhs.cpp_evals;
+    cpp_bytes += rhs.cpp_bytes;
+    clang_parse_ns += rhs.clang_parse_ns;
+    ir_modules += rhs.ir_modules;
+    ir_instructions += rhs.ir_instructions;
+    llvm_optimize_ns += rhs.llvm_optimize_ns;
+    objects += rhs.objects;
+    object_bytes += rhs.object_bytes;
+    symbols += rhs.symbols;
+    return *this;
+  }
+
+  /* The totals are shared, but the current scope is this thread's alone. */
+  static void record(counts const &c)
+  {
+    {
+      std::lock_guard<std::mutex> const lock{ stats_mutex };
+      all.jit += c;
+    }
+    if(current_module)
+    {
+      current_module->self += c;
+    }
+    else if(current_eval)
+    {
+      current_eval->self += c;
+    }
+  }
+
+  void record_cpp(usize const bytes, u64 const ns)
+  {
+    record({ .cpp_evals = 1, .cpp_bytes = bytes, .clang_parse_ns = ns });
+  }
+
+  void record_ir(u64 const instructions)
+  {
+    record({ .ir_modules = 1, .ir_instructions = instructions });
+  }
+
+  void record_optimize(u64 const ns)
+  {
+    record({ .llvm_optimize_ns = ns });
+  }
+
+  void record_link(u64 const bytes, u64 const symbols)
+  {
+    record({ .objects = 1, .object_bytes = bytes, .symbols = symbols });
+    std::lock_guard<std::mutex> const lock{ stats_mutex };
+    all.live_bytes += bytes;
+  }
+
+  void record_unlink(u64 const bytes)
+  {
+    std::lock_guard<std::mutex> const lock{ stats_mutex };
+    ++all.unlinked_objects;
+    all.unlinked_bytes += bytes;
+    all.live_bytes -= std::min(bytes, all.live_bytes);
+  }
+
+  module_scope::module_scope(jtl::immutable_string const &module, module_origin const origin)
+    : name{ module.data(), module.size() }
+    , origin{ origin }
+    , parent{ current_module }
+  {
+    current_module = this;
+  }
+
+  module_scope::~module_scope()
+  {
+    auto const total_ns{ since(start) };
+    current_module = parent;
+    if(parent)
+    {
+      parent->nested_ns += total_ns;
+    }
+
+    std::lock_guard<std::mutex> const lock{ stats_mutex };
+    switch(origin)
+    {
+      case module_origin::binary:
+        ++all.cache_hits;
+        break;
+      case module_origin::source:
+        ++all.cache_misses;
+        break;
+      case module_origin::cpp:
+        ++all.cpp_loads;
+        break;
+    }
+    modules.insert_or_assign(name, module_entry{ origin, total_ns - nested_ns, self });
+  }
+
+  eval_scope::eval_scope()
+    : active{ !current_module && !current_eval }
+  {
+    if(active)
+    {
+      current_eval = this;
+    }
+  }
+
+  eval_scope::~eval_scope()
+  {
+    if(!active)
+    {
+      return;
+    }
+    current_eval = nullptr;
+
+    std::lock_guard<std::mutex> const lock{ stats_mutex };
+    if(max_evals <= evals.size())
+    {
+      evals.pop_front();
+    }
+    evals.push_back({ std::move(label), since(start), self });
+  }
+
+  bool eval_scope::is_active() const
+  {
+    return active;
+  }
+
+  void eval_scope::set_label(jtl::immutable_string const &l)
+  {
+    label.assign(l.data(), l.size());
+  }
+
+  jank::jit::stats::totals totals()
+  {
+    std::lock_guard<std::mutex> const lock{ stats_mutex };
+    return all;
+  }
+
+  static object_ref keyword(char const * const name)
+  {
+    return __rt_ctx->intern_keyword(name).expect_ok();
+  }
+
+  static obj::persistent_hash_map_ref to_runtime_data(counts const &c)
+  {
+    auto const box([](u64 const n) { return make_box(static_cast<i64>(n)); });
+    return obj::persistent_hash_map::create_unique(
+      std::make_pair(keyword("cpp-evals"), box(c.cpp_evals)),
+      std::make_pair(keyword("cpp-bytes"), box(c.cpp_bytes)),
+      std::make_pair(keyword("clang-parse-ns"), box(c.clang_parse_ns)),
+      std::make_pair(keyword("ir-modules"), box(c.ir_modules)),
+      std::make_pair(keyword("ir-instructions"), box(c.ir_instructions)),
+      std::make_pair(keyword("llvm-optimize-ns"), box(c.llvm_optimize_ns)),
+      std::make_pair(keyword("objects"), box(c.objects)),
+      std::make_pair(keyword("object-bytes"), box(c.object_bytes)),
+      std::make_pair(keyword("symbols"), box(c.symbols)));
+  }
+
+  static object_ref origin_keyword(module_origin const origin)
+  {
+    switch(origin)
+    {
+      case module_origin::binary:
+        return keyword("binary");
+      case module_origin::source:
+        return keyword("source");
+      case module_origin::cpp:
+        return keyword("cpp");
+    }
+    return jank_nil();
+  }
+
+  object_ref snapshot()
+  {
+    jank::jit::stats::totals t;
+    std::vector<std::pair<std::string, module_entry>> ms;
+    std::deque<eval_entry> es;
+    {
+      std::lock_guard<std::mutex> const lock{ stats_mutex };
+      t = all;
+      ms.assign(modules.begin(), modules.end());
+      es = evals;
+    }
+    std::ranges::sort(ms, [](auto const &l, auto const &r) { return r.second.ns < l.second.ns; });
+
+    runtime::detail::native_transient_vector module_maps;
+    for(auto const &[name, e] : ms)
+    {
+      module_maps.push_back(
+        to_runtime_data(e.self)
+          ->assoc(keyword("name"), make_box(jtl::immutable_string{ name.data(), name.size() }))
+          ->assoc(keyword("origin"), origin_keyword(e.origin))
+          ->assoc(keyword("ns"), make_box(static_cast<i64>(e.ns))));
+    }
+
+    runtime::detail::native_transient_vector eval_maps;
+    for(auto const &e : es)
+    {
+      eval_maps.push_back(
+        to_runtime_data(e.self)
+          ->assoc(keyword("form"),
+                  make_box(jtl::immutable_string{ e.label.data(), e.label.size() }))
+          ->assoc(keyword("ns"), make_box(static_cast<i64>(e.ns))));
+    }
+
+    return obj::persistent_hash_map::create_unique(
+      std::make_pair(keyword("total"), to_runtime_data(t.jit)),
+      std::make_pair(keyword("cache-hits"), make_box(static_cast<i64>(t.cache_hits))),
+      std::make_pair(keyword("cache-misses"), make_box(static_cast<i64>(t.cache_misses))),
+      std::make_pair(keyword("cpp-loads"), make_box(static_cast<i64>(t.cpp_loads))),
+      std::make_pair(keyword("unlinked-objects"),
+                     make_box(static_cast<i64>(t.unlinked_objects))),
+      std::make_pair(keyword("unlinked-bytes"), make_box(static_cast<i64>(t.unlinked_bytes))),
+      std::make_pair(keyword("live-bytes"),
+                     make_box(static_cast<i64>(t.live_bytes))),
+      std::make_pair(keyword("modules"),
+                     make_box<obj::persistent_vector>(module_maps.persistent())),
+      std::make_pair(keyword("evals"), make_box<obj::persistent_vector>(eval_maps.persistent())));
+  }
+
+  void reset()
+  {
+    std::lock_guard<std::mutex> const lock{ stats_mutex };
+    auto const live_bytes{ all.live_bytes };
+    all = {};
+    all.live_bytes = live_bytes;
+    modules.clear();
+    evals.clear();
+  }
+}
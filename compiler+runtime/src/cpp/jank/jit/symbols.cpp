@@ -0,0 +1,189 @@
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+#include <dlfcn.h>
+
+#include <llvm/Demangle/Demangle.h>
+#include <llvm/ExecutionEngine/JITLink/JITLink.h>
+#include <llvm/ExecutionEngine/Orc/ObjectLinkingLayer.h>
+
+#include <jank/jit/symbols.hpp>
+#include <jank/jit/stats.hpp>
+#include <jank/util/fmt.hpp>
+
+namespace jank::jit::symbols
+{
+  struct entry
+  {
+    uintptr_t end{};
+    std::string name;
+    llvm::orc::ResourceKey key{};
+  };
+
+  struct resource
+  {
+    std::vector<uintptr_t> addresses;
+    u64 bytes{};
+  };
+
+  /* None of this holds GC memory, since it's only ever written by the linker. */
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+  static std::shared_mutex table_mutex;
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+  static std::map<uintptr_t, entry> table;
+  /* Which functions each resource owns, so they can be forgotten when it's removed. */
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+  static std::map<llvm::orc::ResourceKey, resource> owned;
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+  static std::atomic_bool tracking{};
+
+  struct plugin : llvm::orc::ObjectLinkingLayer::Plugin
+  {
+    void modifyPassConfig(llvm::orc::MaterializationResponsibility &mr,
+                          llvm::jitlink::LinkGraph &,
+                          llvm::jitlink::PassConfiguration &config) override
+    {
+      config.PostFixupPasses.push_back([&mr](llvm::jitlink::LinkGraph &g) {
+        std::vector<std::pair<uintptr_t, entry>> found;
+        u64 bytes{}, symbol_count{};
+        for(auto const * const block : g.blocks())
+        {
+          bytes += block->getSize();
+        }
+        for(auto const * const sym : g.defined_symbols())
+        {
+          symbol_count += sym->hasName();
+          if(!sym->hasName() || !sym->isCallable() || sym->getSize() == 0)
+          {
+            continue;
+          }
+          auto const start{ static_cast<uintptr_t>(sym->getAddress().getValue()) };
+          found.push_back({
+            start,
+            { start + sym->getSize(), llvm::demangle(std::string{ *sym->getName() }) }
+          });
+        }
+        stats::record_link(bytes, symbol_count);
+
+        return mr.withResourceKeyDo([&](llvm::orc::ResourceKey const key) {
+          std::unique_lock<std::shared_mutex> const lock{ table_mutex };
+          auto &r{ owned[key] };
+          r.bytes += bytes;
+          for(auto &[start, e] : found)
+          {
+            e.key = key;
+            r.addresses.push_back(start);
+            table.insert_or_assign(start, std::move(e));
+          }
+        });
+      });
+    }
+
+    llvm::Error notifyFailed(llvm::orc::MaterializationResponsibility &) override
+    {
+      return llvm::Error::success();
+    }
+
+    llvm::Error notifyRemovingResources(llvm::orc::JITDylib &,
+                                        llvm::orc::ResourceKey const key) override
+    {
+      std::unique_lock<std::shared_mutex> const lock{ table_mutex };
+      auto const found{ owned.find(key) };
+      if(found != owned.end())
+      {
+        for(auto const address : found->second.addresses)
+        {
+          table.erase(address);
+        }
+        stats::record_unlink(found->second.bytes);
+        owned.erase(found);
+      }
+      return llvm::Error::success();
+    }
+
+    void notifyTransferringResources(llvm::orc::JITDylib &,
+                                     llvm::orc::ResourceKey const dst,
+                                     llvm::orc::ResourceKey const src) override
+    {
+      std::unique_lock<std::shared_mutex> const lock{ table_mutex };
+      auto const found{ owned.find(src) };
+      if(found != owned.end())
+      {
+        auto &r{ owned[dst] };
+        for(auto const address : found->second.addresses)
+        {
+          table[address].key = dst;
+        }
+        r.addresses.insert(r.addresses.end(),
+                           found->second.addresses.begin(),
+                           found->second.addresses.end());
+        r.bytes += found->second.bytes;
+        owned.erase(src);
+      }
+    }
+  };
+
+  void track(llvm::orc::ObjectLinkingLayer &layer)
+  {
+    layer.addPlugin(std::make_unique<plugin>());
+    tracking.store(true, std::memory_order_release);
+  }
+
+  bool is_tracking()
+  {
+    return tracking.load(std::memory_order_acquire);
+  }
+
+  jtl::option<uptr> find_resource(uintptr_t const address)
+  {
+    std::shared_lock<std::shared_mutex> const lock{ table_mutex };
+    auto const found{ table.upper_bound(address) };
+    if(found == table.begin())
+    {
+      return none;
+    }
+    auto const &[start, e]{ *std::prev(found) };
+    if(address < start || e.end <= address)
+    {
+      return none;
+    }
+    return static_cast<uptr>(e.key);
+  }
+
+  jtl::option<jtl::immutable_string> find(uintptr_t const address)
+  {
+    std::shared_lock<std::shared_mutex> const lock{ table_mutex };
+    auto const found{ table.upper_bound(address) };
+    if(found == table.begin())
+    {
+      return none;
+    }
+    auto const &[start, e]{ *std::prev(found) };
+    if(address < start || e.end <= address)
+    {
+      return none;
+    }
+    return jtl::immutable_string{ e.name.data(), e.name.size() };
+  }
+
+  jtl::immutable_string describe(uintptr_t const address)
+  {
+    if(auto const jitted{ find(address) }; jitted.is_some())
+    {
+      return jitted.unwrap();
+    }
+
+    Dl_info info{};
+    // NOLINTNEXTLINE(performance-no-int-to-ptr): We're symbolizing raw addresses.
+    if(dladdr(reinterpret_cast<void const *>(address), &info) && info.dli_sname)
+    {
+      auto const name{ llvm::demangle(info.dli_sname) };
+      return { name.data(), name.size() };
+    }
+    return util::format("{}", reinterpret_cast<void const *>(address));
+  }
+}
@@ -0,0 +1,369 @@
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
+#include <llvm/ADT/STLExtras.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IRReader/IRReader.h>
+#include <llvm/Passes/PassBuilder.h>
+#include <llvm/Support/SourceMgr.h>
+
+#include <jank/jit/tiering.hpp>
+#include <jank/jit/processor.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/executor.hpp>
+#include <jank/runtime/obj/jit_function.hpp>
+#include <jank/profile/time.hpp>
+#include <jank/util/cli.hpp>
+#include <jank/util/fmt/print.hpp>
+
+namespace jank::jit::tiering
+{
+  /* Every symbol in an optimized module gets this suffix, so it doesn't clash with the
+   * tier 0 symbols which are already loaded. */
+  static constexpr char const *tier_up_suffix{ "_tier1" };
+
+  struct tier0_module
+  {
+    std::string name;
+    std::string bitcode;
+    /* Every fn the module defines, by name, along with its tier 0 address. */
+    std::vector<std::pair<std::string, void *>> fns;
+    bool requested{};
+    bool done{};
+    /* From each tier 0 address to its optimized address, once we're done. */
+    std::unordered_map<void *, void *> optimized;
+    /* Fns which asked to be tiered up before we were done. */
+    native_vector<runtime::obj::jit_function_ref> waiting;
+  };
+
+  struct registry
+  {
+    std::mutex mutex;
+    std::condition_variable idle;
+    usize in_flight{};
+    /* From the tier 0 address of every fn we've loaded to the module which defines it. */
+    std::unordered_map<void *, std::shared_ptr<tier0_module>> modules;
+  };
+
+  static registry &get_registry()
+  {
+    /* This is intentionally leaked, like the executors, since the compile thread may
+     * still be using it during static destruction. */
+    static auto * const r{ new registry{} };
+    return *r;
+  }
+
+  /* A single thread is plenty. Optimization isn't urgent and we don't want it competing
+   * with the program for cores. */
+  static runtime::work_stealing_executor &compile_executor()
+  {
+    static auto * const e{ new runtime::work_stealing_executor{ 1 } };
+    return *e;
+  }
+
+  template <typename F>
+  static void swap_arity(F &arity, tier0_module const &m)
+  {
+    auto const found{ m.optimized.find(reinterpret_cast<void *>(arity)) };
+    if(found != m.optimized.end())
+    {
+      std::atomic_ref<F>{ arity }.store(reinterpret_cast<F>(found->second),
+                                        std::memory_order_release);
+    }
+  }
+
+  static void swap_arities(runtime::obj::jit_function &fn, tier0_module const &m)
+  {
+    swap_arity(fn.arity_0, m);
+    swap_arity(fn.arity_1, m);
+    swap_arity(fn.arity_2, m);
+    swap_arity(fn.arity_3, m);
+    swap_arity(fn.arity_4, m);
+    swap_arity(fn.arity_5, m);
+    swap_arity(fn.arity_6, m);
+    swap_arity(fn.arity_7, m);
+    swap_arity(fn.arity_8, m);
+    swap_arity(fn.arity_9, m);
+    swap_arity(fn.arity_10, m);
+  }
+
+  /* All of a fn's arities are defined in the same module, so any of them will do. */
+  static std::shared_ptr<tier0_module>
+  find_module(registry const &r, runtime::obj::jit_function const &fn)
+  {
+    for(auto const arity : { reinterpret_cast<void *>(fn.arity_0),
+                             reinterpret_cast<void *>(fn.arity_1),
+                             reinterpret_cast<void *>(fn.arity_2),
+                             reinterpret_cast<void *>(fn.arity_3),
+                             reinterpret_cast<void *>(fn.arity_4),
+                             reinterpret_cast<void *>(fn.arity_5),
+                             reinterpret_cast<void *>(fn.arity_6),
+                             reinterpret_cast<void *>(fn.arity_7),
+                             reinterpret_cast<void *>(fn.arity_8),
+                             reinterpret_cast<void *>(fn.arity_9),
+                             reinterpret_cast<void *>(fn.arity_10) })
+    {
+      if(!arity)
+      {
+        continue;
+      }
+      auto const found{ r.modules.find(arity) };
+      if(found != r.modules.end())
+      {
+        return found->second;
+      }
+    }
+    return nullptr;
+  }
+
+  static void optimize(llvm::Module &m)
+  {
+    /* These need to be declared in this order, so they're destroyed in the right order. */
+    llvm::LoopAnalysisManager lam;
+    llvm::FunctionAnalysisManager fam;
+    llvm::CGSCCAnalysisManager cgam;
+    llvm::ModuleAnalysisManager mam;
+
+    llvm::PassBuilder pb;
+    pb.registerModuleAnalyses(mam);
+    pb.registerCGSCCAnalyses(cgam);
+    pb.registerFunctionAnalyses(fam);
+    pb.registerLoopAnalyses(lam);
+    pb.crossRegisterProxies(lam, fam, cgam, mam);
+
+    auto const level{ util::cli::opts.optimization_level == 3 ? llvm::OptimizationLevel::O3
+                                                              : llvm::OptimizationLevel::O2 };
+    auto mpm{ pb.buildPerModuleDefaultPipeline(level) };
+    mpm.run(m, mam);
+  }
+
+  /* Each feedback site of the tier 0 module is still being updated by its code, so what
+   * it's seen so far is read from there. That goes in place of every load of the site, so
+   * the optimizer can drop whichever path the site doesn't take. Recording stops, since
+   * the optimized code is never tiered up again. */
+  static void bake_feedback(llvm::Module &m)
+  {
+    for(auto &global : m.globals())
+    {
+      if(global.isDeclaration() || !global.getName().contains(feedback::site_name))
+      {
+        continue;
+      }
+
+      auto const found{ __rt_ctx->jit_prc.find_symbol(global.getName().str().c_str()) };
+      auto const seen{ found.is_ok()
+                         ? std::atomic_ref<u8>{ *static_cast<u8 *>(found.expect_ok()) }.load(
+                             std::memory_order_relaxed)
+                         : feedback::other };
+      auto const constant{ llvm::ConstantInt::get(global.getValueType(), seen) };
+      for(auto * const user : llvm::make_early_inc_range(global.users()))
+      {
+        if(auto * const load = llvm::dyn_cast<llvm::LoadInst>(user))
+        {
+          load->replaceAllUsesWith(constant);
+          load->eraseFromParent();
+        }
+      }
+      global.setInitializer(constant);
+      global.setConstant(true);
+      global.setLinkage(llvm::GlobalValue::InternalLinkage);
+    }
+
+    if(auto * const record = m.getFunction("jank_feedback_record"))
+    {
+      for(auto * const user : llvm::make_early_inc_range(record->users()))
+      {
+        if(auto * const call = llvm::dyn_cast<llvm::CallInst>(user))
+        {
+          call->eraseFromParent();
+        }
+      }
+    }
+  }
+
+  /* Optimizes and loads the module, returning the optimized address of each of its fns. */
+  static std::unordered_map<void *, void *> load_optimized(tier0_module const &m)
+  {
+    std::unordered_map<void *, void *> ret;
+
+    auto ctx{ std::make_unique<llvm::LLVMContext>() };
+    llvm::SMDiagnostic err{};
+    auto ir_module{ llvm::parseIR(llvm::MemoryBufferRef{ m.bitcode, m.name }, err, *ctx) };
+    if(!ir_module)
+    {
+      err.print("jank", llvm::errs());
+      return ret;
+    }
+
+    bake_feedback(*ir_module);
+
+    /* Renaming these also renames every reference to them within the module, so the
+     * optimized fns call each other and use their own globals, which their own global
+     * ctor initializes. */
+    for(auto &fn : ir_module->functions())
+    {
+      if(!fn.isDeclaration() && !fn.hasLocalLinkage())
+      {
+        fn.setName(fn.getName() + tier_up_suffix);
+      }
+    }
+    for(auto &global : ir_module->globals())
+    {
+      if(!global.isDeclaration() && !global.hasLocalLinkage()
+         && !global.getName().starts_with("llvm."))
+      {
+        global.setName(global.getName() + tier_up_suffix);
+      }
+    }
+
+    optimize(*ir_module);
+    __rt_ctx->jit_prc.load_ir_module({ std::move(ir_module), std::move(ctx) });
+
+    for(auto const &[name, tier0] : m.fns)
+    {
+      auto const found{ __rt_ctx->jit_prc.find_symbol(util::format("{}{}", name, tier_up_suffix)) };
+      if(found.is_ok())
+      {
+        ret.emplace(tier0, found.expect_ok());
+      }
+    }
+    return ret;
+  }
+
+  /* Runs on the compile thread. If anything goes wrong, we just keep running the tier 0
+   * code. */
+  static void tier_up(std::shared_ptr<tier0_module> const &m)
+  {
+    profile::timer const timer{ util::format("jit tier up {}", m->name) };
+    std::unordered_map<void *, void *> optimized;
+    try
+    {
+      optimized = load_optimized(*m);
+    }
+    catch(std::exception const &e)
+    {
+      util::println(stderr, "Unable to optimize {}: {}", m->name, e.what());
+    }
+
+    auto &r{ get_registry() };
+    {
+      std::lock_guard<std::mutex> const lock{ r.mutex };
+      m->optimized = std::move(optimized);
+      m->done = true;
+      for(auto const &fn : m->waiting)
+      {
+        swap_arities(*fn, *m);
+      }
+      m->waiting.clear();
+      /* We won't need to optimize this again. */
+      m->bitcode = {};
+      --r.in_flight;
+    }
+    r.idle.notify_all();
+  }
+
+  bool is_enabled()
+  {
+    return util::cli::opts.tiered_compilation;
+  }
+
+  void load_tier0_module(processor const &jit_prc, llvm::orc::ThreadSafeModule &&m)
+  {
+    auto const unit{ std::make_shared<tier0_module>() };
+    std::vector<std::string> fn_names;
+    {
+      auto const raw{ m.getModuleUnlocked() };
+      unit->name = raw->getName().str();
+      llvm::raw_string_ostream os{ unit->bitcode };
+      llvm::WriteBitcodeToFile(*raw, os);
+      os.flush();
+
+      for(auto const &fn : raw->functions())
+      {
+        if(!fn.isDeclaration() && !fn.hasLocalLinkage())
+        {
+          fn_names.emplace_back(fn.getName().str());
+        }
+      }
+    }
+
+    jit_prc.load_ir_module(std::move(m));
+
+    auto &r{ get_registry() };
+    std::lock_guard<std::mutex> const lock{ r.mutex };
+    for(auto &name : fn_names)
+    {
+      auto const found{ jit_prc.find_symbol(name.c_str()) };
+      if(found.is_ok())
+      {
+        r.modules.emplace(found.expect_ok(), unit);
+        unit->fns.emplace_back(std::move(name), found.expect_ok());
+      }
+    }
+  }
+
+  /* The registry must be locked. */
+  static void schedule(registry &r, std::shared_ptr<tier0_module> const &m)
+  {
+    if(m->requested)
+    {
+      return;
+    }
+    m->requested = true;
+    ++r.in_flight;
+
+    compile_executor().submit([m] { tier_up(m); });
+  }
+
+  void request_tier_up(runtime::obj::jit_function_ref const fn)
+  {
+    auto &r{ get_registry() };
+    std::lock_guard<std::mutex> const lock{ r.mutex };
+    auto const m{ find_module(r, *fn) };
+    if(!m)
+    {
+      return;
+    }
+    if(m->done)
+    {
+      swap_arities(*fn, *m);
+      return;
+    }
+
+    m->waiting.emplace_back(fn);
+    schedule(r, m);
+  }
+
+  void *find_optimized(void * const tier0)
+  {
+    auto &r{ get_registry() };
+    std::lock_guard<std::mutex> const lock{ r.mutex };
+    auto const found{ r.modules.find(tier0) };
+    if(found == r.modules.end())
+    {
+      return nullptr;
+    }
+
+    auto const &m{ found->second };
+    if(!m->done)
+    {
+      schedule(r, m);
+      return nullptr;
+    }
+    auto const optimized{ m->optimized.find(tier0) };
+    return optimized == m->optimized.end() ? nullptr : optimized->second;
+  }
+
+  void wait_for_pending()
+  {
+    auto &r{ get_registry() };
+    std::unique_lock<std::mutex> lock{ r.mutex };
+    r.idle.wait(lock, [&] { return r.in_flight == 0; });
+  }
+}
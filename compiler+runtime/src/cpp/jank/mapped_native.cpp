@@ -0,0 +1,43 @@
+#include <jank/mapped_native.hpp>
+#include <jank/runtime/convert/function.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/data_image.hpp>
+#include <jank/runtime/obj/native_function_wrapper.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
+
+namespace jank::mapped_native
+{
+  using namespace jank;
+  using namespace jank::runtime;
+
+  static object_ref write_image(object_ref const path, object_ref const o)
+  {
+    write_data_image(runtime::to_string(path), o);
+    return jank_nil();
+  }
+
+  static object_ref open_image(object_ref const path)
+  {
+    return open_data_image(runtime::to_string(path));
+  }
+}
+
+extern "C" void jank_load_jank_mapped_native()
+{
+  using namespace jank;
+  using namespace jank::runtime;
+
+  auto const ns(__rt_ctx->intern_ns("jank.mapped-native"));
+
+  auto const intern_fn([=](jtl::immutable_string const &name, auto const fn) {
+    ns->intern_var(name)->bind_root(
+      make_box<obj::native_function_wrapper>(convert_function(fn))
+        ->with_meta(obj::persistent_hash_map::create_unique(std::make_pair(
+          __rt_ctx->intern_keyword("name").expect_ok(),
+          make_box(obj::symbol{ __rt_ctx->current_ns()->to_string(), name }.to_string())))));
+  });
+  intern_fn("write!", &mapped_native::write_image);
+  intern_fn("open", &mapped_native::open_image);
+}
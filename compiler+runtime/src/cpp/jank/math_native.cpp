@@ -0,0 +1,36 @@
+#include <jank/math_native.hpp>
+#include <jank/runtime/convert/function.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core/array_math.hpp>
+#include <jank/runtime/core/math.hpp>
+#include <jank/runtime/obj/native_function_wrapper.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
+#include <jank/runtime/obj/keyword.hpp>
+#include <jank/runtime/rtti.hpp>
+
+extern "C" void jank_load_jank_math_native()
+{
+  using namespace jank;
+  using namespace jank::runtime;
+
+  auto const ns(__rt_ctx->intern_ns("jank.math-native"));
+
+  auto const intern_fn([=](jtl::immutable_string const &name, auto const fn) {
+    ns->intern_var(name)->bind_root(
+      make_box<obj::native_function_wrapper>(convert_function(fn))
+        ->with_meta(obj::persistent_hash_map::create_unique(std::make_pair(
+          __rt_ctx->intern_keyword("name").expect_ok(),
+          make_box(obj::symbol{ __rt_ctx->current_ns()->to_string(), name }.to_string())))));
+  });
+  intern_fn("add", &array_math::add);
+  intern_fn("mul", &array_math::mul);
+  intern_fn("fma", &array_math::fma);
+  intern_fn("dot", &array_math::dot);
+  intern_fn("sum", &array_math::sum);
+  intern_fn("min", &array_math::min);
+  intern_fn("max", &array_math::max);
+  intern_fn("sqrt", &array_math::sqrt);
+  intern_fn("pow", &array_math::pow);
+  intern_fn("abs", &array_math::abs);
+  intern_fn("tan", static_cast<f64 (*)(object_ref const)>(&runtime::tan));
+}
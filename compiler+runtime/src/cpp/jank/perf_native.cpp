@@ -23,4 +23,33 @@ extern "C" void jank_load_jank_perf_native()
           make_box(obj::symbol{ __rt_ctx->current_ns()->to_string(), name }.to_string())))));
   });
   intern_fn("benchmark", &perf::benchmark);
+  intern_fn("enter-region", &perf::enter_region);
+  intern_fn("exit-region", &perf::exit_region);
+  intern_fn("call-with-arena", &perf::call_with_arena);
+  intern_fn("gc-stats", &perf::gc_stats);
+  intern_fn("memory-stats", &perf::memory_stats);
+  intern_fn("allocation-samples", &perf::allocation_samples);
+  intern_fn("heap-snapshot", &perf::heap_snapshot);
+  intern_fn("atom-stats", &perf::atom_stats);
+  intern_fn("counter-atom", &perf::counter_atom);
+  intern_fn("counter-add!", &perf::counter_add);
+  intern_fn("fn-stats", &perf::fn_stats);
+  intern_fn("reset-fn-stats!", &perf::reset_fn_stats);
+  intern_fn("jit-stats", &perf::jit_stats);
+  intern_fn("reset-jit-stats!", &perf::reset_jit_stats);
+  intern_fn("start-sampling!", &perf::start_sampling);
+  intern_fn("stop-sampling!", &perf::stop_sampling);
+  intern_fn("start-allocation-tracking!", &perf::start_allocation_tracking);
+  intern_fn("stop-allocation-tracking!", &perf::stop_allocation_tracking);
+  intern_fn("counter", &perf::metrics_counter);
+  intern_fn("gauge", &perf::metrics_gauge);
+  intern_fn("histogram", &perf::metrics_histogram);
+  intern_fn("inc!", &perf::inc_counter);
+  intern_fn("set-gauge!", &perf::set_gauge);
+  intern_fn("record!", &perf::record_histogram);
+  intern_fn("time-call", &perf::time_call);
+  intern_fn("metrics", &perf::metrics_snapshot);
+  intern_fn("prometheus", &perf::prometheus_metrics);
+
+  perf::track_gc_pauses();
 }
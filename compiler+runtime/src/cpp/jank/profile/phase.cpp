@@ -0,0 +1,103 @@
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+#include <gc/gc.h>
+
+#include <jank/profile/phase.hpp>
+
+namespace jank::profile
+{
+  struct open_phase
+  {
+    phase p{};
+    phase_mark start;
+    /* What the phases within this one took, which isn't charged to this one. */
+    phase_mark nested;
+  };
+
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+  static std::atomic_bool enabled{};
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+  static std::mutex stats_mutex;
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+  static std::array<phase_stats, static_cast<usize>(phase::count)> totals;
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+  static native_vector<form_stats> forms;
+
+  /* Like the open regions in time.cpp, this holds no GC memory. */
+  static thread_local std::vector<open_phase> open_phases;
+
+  void enable_phases()
+  {
+    enabled.store(true, std::memory_order_relaxed);
+  }
+
+  bool phases_enabled()
+  {
+    return enabled.load(std::memory_order_relaxed);
+  }
+
+  phase_mark phase_now()
+  {
+    using namespace std::chrono;
+    return { duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count(),
+             static_cast<u64>(GC_get_total_bytes()) };
+  }
+
+  void record_form(jtl::immutable_string const &label, phase_mark const &start)
+  {
+    auto const end{ phase_now() };
+    std::lock_guard<std::mutex> const lock{ stats_mutex };
+    forms.push_back({ label, end.ns - start.ns, end.bytes - start.bytes });
+  }
+
+  std::array<phase_stats, static_cast<usize>(phase::count)> phase_totals()
+  {
+    std::lock_guard<std::mutex> const lock{ stats_mutex };
+    return totals;
+  }
+
+  native_vector<form_stats> form_totals()
+  {
+    std::lock_guard<std::mutex> const lock{ stats_mutex };
+    return forms;
+  }
+
+  phase_timer::phase_timer(phase const p)
+    : p{ p }
+    , active{ phases_enabled() }
+  {
+    if(active)
+    {
+      open_phases.push_back({ p, phase_now(), {} });
+    }
+  }
+
+  phase_timer::~phase_timer()
+  {
+    if(!active || open_phases.empty())
+    {
+      return;
+    }
+
+    auto const end{ phase_now() };
+    auto const open{ open_phases.back() };
+    open_phases.pop_back();
+
+    auto const total_ns{ end.ns - open.start.ns };
+    auto const total_bytes{ end.bytes - open.start.bytes };
+    if(!open_phases.empty())
+    {
+      open_phases.back().nested.ns += total_ns;
+      open_phases.back().nested.bytes += total_bytes;
+    }
+
+    std::lock_guard<std::mutex> const lock{ stats_mutex };
+    auto &stats{ totals[static_cast<usize>(open.p)] };
+    ++stats.count;
+    stats.self_ns += total_ns - open.nested.ns;
+    stats.self_bytes += total_bytes - open.nested.bytes;
+  }
+}
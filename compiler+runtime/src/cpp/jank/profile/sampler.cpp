@@ -0,0 +1,231 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <csignal>
+#include <mutex>
+#include <vector>
+
+#include <sys/time.h>
+#include <ucontext.h>
+
+#include <jank/profile/sampler.hpp>
+#include <jank/jit/symbols.hpp>
+#include <jank/util/fmt.hpp>
+
+namespace jank::profile::sampler
+{
+  static constexpr usize max_depth{ 128 };
+  static constexpr usize max_samples{ 1 << 15 };
+  /* No frame of ours is anywhere near this big, so a bigger step means we've followed a
+   * register which was never a frame pointer. */
+  static constexpr uintptr_t max_frame_size{ 1 << 20 };
+
+  struct sample
+  {
+    u32 depth{};
+    std::array<uintptr_t, max_depth> pcs{};
+  };
+
+  /* The handler can't allocate, so samples go into a buffer which is allocated up front.
+   * Each handler claims one slot, by bumping next. */
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+  static std::vector<sample> buffer;
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+  static std::atomic<usize> next{};
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+  static std::atomic<u64> dropped{};
+  /* Handlers which are still running, so stop can wait for them before reading. */
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+  static std::atomic<u32> in_flight{};
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+  static std::atomic_bool running{};
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+  static std::mutex control_mutex;
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+  static struct sigaction previous_action{};
+
+  static void registers(void * const context, uintptr_t &pc, uintptr_t &fp)
+  {
+    auto const uc{ static_cast<ucontext_t *>(context) };
+#if defined(__APPLE__) && defined(__x86_64__)
+    pc = uc->uc_mcontext->__ss.__rip;
+    fp = uc->uc_mcontext->__ss.__rbp;
+#elif defined(__APPLE__) && defined(__aarch64__)
+    pc = uc->uc_mcontext->__ss.__pc;
+    fp = uc->uc_mcontext->__ss.__fp;
+#elif defined(__linux__) && defined(__x86_64__)
+    pc = static_cast<uintptr_t>(uc->uc_mcontext.gregs[REG_RIP]);
+    fp = static_cast<uintptr_t>(uc->uc_mcontext.gregs[REG_RBP]);
+#elif defined(__linux__) && defined(__aarch64__)
+    pc = uc->uc_mcontext.pc;
+    fp = uc->uc_mcontext.regs[29];
+#else
+    static_cast<void>(uc);
+    pc = fp = 0;
+#endif
+  }
+
+  /* This is run in a signal handler, so it can only touch the preallocated buffer and
+   * atomics. Each frame starts with the caller's frame pointer, followed by the return
+   * address. The stack grows down, so every caller's frame is above ours. */
+  static void handle(int, siginfo_t *, void * const context)
+  {
+    in_flight.fetch_add(1, std::memory_order_acquire);
+    if(running.load(std::memory_order_relaxed))
+    {
+      auto const slot{ next.fetch_add(1, std::memory_order_relaxed) };
+      if(slot < buffer.size())
+      {
+        auto &s{ buffer[slot] };
+        uintptr_t pc{}, fp{};
+        registers(context, pc, fp);
+
+        /* The handler runs on the interrupted thread's stack, so its frames must be
+         * above this local. */
+        auto const stack_floor{ reinterpret_cast<uintptr_t>(&pc) };
+        s.depth = 0;
+        if(pc)
+        {
+          s.pcs[s.depth++] = pc;
+        }
+        while(s.depth < max_depth && stack_floor < fp && fp % sizeof(uintptr_t) == 0)
+        {
+          auto const frame{ reinterpret_cast<uintptr_t const *>(fp) };
+          auto const caller_fp{ frame[0] };
+          auto const ret{ frame[1] };
+          if(!ret)
+          {
+            break;
+          }
+          /* Return addresses point past the call, which may be the next fn already. */
+          s.pcs[s.depth++] = ret - 1;
+          if(caller_fp <= fp || max_frame_size < caller_fp - fp)
+          {
+            break;
+          }
+          fp = caller_fp;
+        }
+      }
+      else
+      {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+    in_flight.fetch_sub(1, std::memory_order_release);
+  }
+
+  static void set_timer(u32 const hz)
+  {
+    itimerval timer{};
+    if(hz)
+    {
+      timer.it_interval.tv_sec = 0;
+      timer.it_interval.tv_usec = std::max<long>(1'000'000 / hz, 1);
+      timer.it_value = timer.it_interval;
+    }
+    setitimer(ITIMER_PROF, &timer, nullptr);
+  }
+
+  jtl::result<void, jtl::immutable_string> start(u32 const hz)
+  {
+    std::lock_guard<std::mutex> const lock{ control_mutex };
+    if(running.load())
+    {
+      return err("The sampling profiler is already running");
+    }
+    if(hz == 0 || 1'000'000 < hz)
+    {
+      return err(util::format("Invalid sampling rate: {} hz", hz));
+    }
+
+    buffer.assign(max_samples, {});
+    next.store(0);
+    dropped.store(0);
+
+    struct sigaction action{};
+    action.sa_sigaction = handle;
+    action.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    if(sigaction(SIGPROF, &action, &previous_action) != 0)
+    {
+      return err("Unable to install the SIGPROF handler");
+    }
+
+    running.store(true);
+    set_timer(hz);
+    return ok();
+  }
+
+  bool is_running()
+  {
+    return running.load();
+  }
+
+  result stop()
+  {
+    std::lock_guard<std::mutex> const lock{ control_mutex };
+    result ret;
+    if(!running.load())
+    {
+      return ret;
+    }
+
+    set_timer(0);
+    running.store(false);
+    while(in_flight.load(std::memory_order_acquire) != 0)
+    {
+    }
+    sigaction(SIGPROF, &previous_action, nullptr);
+
+    /* Plenty of samples share frames, so each address is only symbolized once. */
+    native_unordered_map<uintptr_t, jtl::immutable_string> names;
+    auto const name([&](uintptr_t const pc) -> jtl::immutable_string const & {
+      auto const found{ names.find(pc) };
+      if(found != names.end())
+      {
+        return found->second;
+      }
+      return names.emplace(pc, jit::symbols::describe(pc)).first->second;
+    });
+
+    auto const count{ std::min(next.load(), buffer.size()) };
+    for(usize i{}; i < count; ++i)
+    {
+      auto const &s{ buffer[i] };
+      if(s.depth == 0)
+      {
+        continue;
+      }
+
+      jtl::string_builder sb;
+      for(auto d{ s.depth }; d > 0; --d)
+      {
+        sb(name(s.pcs[d - 1]));
+        if(d != 1)
+        {
+          sb(';');
+        }
+      }
+      ++ret.stacks[sb.release()];
+      ++ret.samples;
+    }
+    ret.dropped = dropped.load();
+
+    buffer.clear();
+    buffer.shrink_to_fit();
+    return ret;
+  }
+
+  jtl::immutable_string folded(result const &r)
+  {
+    std::vector<std::pair<jtl::immutable_string, u64>> sorted{ r.stacks.begin(), r.stacks.end() };
+    std::ranges::sort(sorted, [](auto const &a, auto const &b) { return b.second < a.second; });
+
+    jtl::string_builder sb;
+    for(auto const &[stack, n] : sorted)
+    {
+      util::format_to(sb, "{} {}\n", stack, n);
+    }
+    return sb.release();
+  }
+}
@@ -1,4 +1,15 @@
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
 #include <fstream>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <string_view>
+#include <vector>
 
 #include <jank/profile/time.hpp>
 #include <jank/util/fmt/print.hpp>
@@ -8,9 +19,36 @@ namespace jank::profile
 {
   using util::cli::opts;
 
-  static constexpr jtl::immutable_string_view tag{ "jank::profile" };
+  /* The output is in the Chrome trace event format, which can be loaded directly into
+   * Perfetto or chrome://tracing. Events are streamed as they happen. The per-region
+   * aggregates are written alongside them, under `jankRegions`, when we finish. */
+
+  struct region_stats
+  {
+    u64 count{};
+    i64 total{};
+    i64 min{ std::numeric_limits<i64>::max() };
+    i64 max{};
+  };
+
+  struct open_region
+  {
+    std::string name;
+    i64 start{};
+  };
+
   // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
   static std::ofstream output;
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+  static std::mutex output_mutex;
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+  static std::map<std::string, region_stats> aggregates;
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+  static bool first_event{ true };
+
+  /* Each thread's open regions, innermost last, so we can time them. This doesn't hold
+   * any GC memory, so it doesn't need to be visible to the GC. */
+  static thread_local std::vector<open_region> open_regions;
 
   static auto now()
   {
@@ -18,6 +56,75 @@ namespace jank::profile
     return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
   }
 
+  /* Thread ids only need to be stable and unique within the trace, so small numbers are
+   * easier to read than whatever the OS gives us. */
+  static u64 thread_id()
+  {
+    static std::atomic<u64> next_id{ 1 };
+    static thread_local u64 const id{ next_id.fetch_add(1) };
+    return id;
+  }
+
+  static void write_json_string(std::ostream &os, std::string_view const s)
+  {
+    os << '"';
+    for(auto const c : s)
+    {
+      switch(c)
+      {
+        case '"':
+          os << "\\\"";
+          break;
+        case '\\':
+          os << "\\\\";
+          break;
+        case '\n':
+          os << "\\n";
+          break;
+        case '\t':
+          os << "\\t";
+          break;
+        default:
+          if(static_cast<unsigned char>(c) < 0x20)
+          {
+            os << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+               << static_cast<int>(c) << std::dec;
+          }
+          else
+          {
+            os << c;
+          }
+      }
+    }
+    os << '"';
+  }
+
+  /* Trace event timestamps are in microseconds, but they may be fractional. */
+  static void write_event(char const phase,
+                          jtl::immutable_string_view const &name,
+                          i64 const timestamp,
+                          char const *extra = nullptr)
+  {
+    std::lock_guard<std::mutex> const lock{ output_mutex };
+    if(!output.is_open())
+    {
+      return;
+    }
+
+    output << (first_event ? "\n" : ",\n");
+    first_event = false;
+    output << R"({"name":)";
+    write_json_string(output, { name.data(), name.size() });
+    output << R"(,"ph":")" << phase << R"(","ts":)" << timestamp / 1000 << '.'
+           << std::setw(3) << std::setfill('0') << timestamp % 1000 << R"(,"pid":)" << getpid()
+           << R"(,"tid":)" << thread_id();
+    if(extra)
+    {
+      output << ',' << extra;
+    }
+    output << '}';
+  }
+
   void configure()
   {
     if(opts.profiler_enabled)
@@ -29,10 +136,36 @@ namespace jank::profile
         util::println(stderr,
                       "Unable to open profile file: {}\nProfiling is now disabled.",
                       opts.profiler_file);
+        return;
       }
+
+      output << R"({"displayTimeUnit":"ns","traceEvents":[)";
+      std::atexit(finish);
     }
   }
 
+  void finish()
+  {
+    std::lock_guard<std::mutex> const lock{ output_mutex };
+    if(!output.is_open())
+    {
+      return;
+    }
+
+    output << "\n],\"jankRegions\":{";
+    bool first{ true };
+    for(auto const &[name, stats] : aggregates)
+    {
+      output << (first ? "\n" : ",\n");
+      first = false;
+      write_json_string(output, name);
+      output << R"(:{"count":)" << stats.count << R"(,"total_ns":)" << stats.total
+             << R"(,"min_ns":)" << stats.min << R"(,"max_ns":)" << stats.max << '}';
+    }
+    output << "\n}}\n";
+    output.close();
+  }
+
   bool is_enabled()
   {
     return opts.profiler_enabled;
@@ -42,7 +175,9 @@ namespace jank::profile
   {
     if(opts.profiler_enabled)
     {
-      output << util::format("{} {} enter {}\n", tag, now(), region);
+      auto const timestamp{ now() };
+      open_regions.push_back({ std::string{ region.data(), region.size() }, timestamp });
+      write_event('B', region, timestamp);
     }
   }
 
@@ -50,7 +185,29 @@ namespace jank::profile
   {
     if(opts.profiler_enabled)
     {
-      output << util::format("{} {} exit {}\n", tag, now(), region);
+      auto const timestamp{ now() };
+      write_event('E', region, timestamp);
+
+      /* Regions should always be closed in order, but we don't want one which isn't to
+       * throw off the timing of every one around it. */
+      std::string_view const name{ region.data(), region.size() };
+      auto const found{ std::find_if(open_regions.rbegin(),
+                                     open_regions.rend(),
+                                     [&](auto const &r) { return r.name == name; }) };
+      if(found == open_regions.rend())
+      {
+        return;
+      }
+
+      auto const duration{ timestamp - found->start };
+      open_regions.erase(std::next(found).base());
+
+      std::lock_guard<std::mutex> const lock{ output_mutex };
+      auto &stats{ aggregates[std::string{ name }] };
+      ++stats.count;
+      stats.total += duration;
+      stats.min = std::min(stats.min, duration);
+      stats.max = std::max(stats.max, duration);
     }
   }
 
@@ -58,7 +215,7 @@ namespace jank::profile
   {
     if(opts.profiler_enabled)
     {
-      output << util::format("{} {} report {}\n", tag, now(), boundary);
+      write_event('i', boundary, now(), R"("s":"g")");
     }
   }
 
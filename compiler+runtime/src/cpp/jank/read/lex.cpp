@@ -1,6 +1,14 @@
+#include <algorithm>
+#include <bit>
 #include <iostream>
 #include <iomanip>
 
+#if defined(__SSE2__)
+  #include <immintrin.h>
+#elif defined(__ARM_NEON)
+  #include <arm_neon.h>
+#endif
+
 #include <jank/read/lex.hpp>
 #include <jank/error/lex.hpp>
 #include <jank/runtime/object.hpp>
@@ -335,6 +343,30 @@ namespace jank::read::lex
     pos += offset;
   }
 
+  processor::processor(jtl::immutable_string_view const &f, state const &s)
+    : pos{ s.pos, this }
+    , require_space{ s.require_space }
+    , found_slash_after_number{ s.found_slash_after_number }
+    , file{ f }
+  {
+  }
+
+  processor::state processor::save() const
+  {
+    return { pos, require_space, found_slash_after_number };
+  }
+
+  bool processor::state::operator==(state const &rhs) const
+  {
+    return pos == rhs.pos && require_space == rhs.require_space
+      && found_slash_after_number == rhs.found_slash_after_number;
+  }
+
+  bool processor::state::operator!=(state const &rhs) const
+  {
+    return !(*this == rhs);
+  }
+
   movable_position &movable_position::operator++()
   {
     jank_debug_assert(offset < proc->file.size());
@@ -360,12 +392,29 @@ namespace jank::read::lex
     return ret;
   }
 
+  /* The fast paths of the lexer skip whole runs at once, so we count the lines in the run
+   * rather than stepping over it. */
   movable_position &movable_position::operator+=(usize const count)
   {
-    for(usize i{}; i < count; ++i)
+    jank_debug_assert(offset + count <= proc->file.size());
+
+    auto const begin{ proc->file.data() + offset };
+    auto const end{ begin + count };
+    auto const newlines{ std::count(begin, end, '\n') };
+    if(newlines == 0)
+    {
+      col += count;
+    }
+    else
     {
-      ++(*this);
+      line += static_cast<usize>(newlines);
+      auto const last_newline{ std::find(std::make_reverse_iterator(end),
+                                         std::make_reverse_iterator(begin),
+                                         '\n') };
+      col = static_cast<usize>(std::distance(std::make_reverse_iterator(end), last_newline)) + 1;
     }
+
+    offset += count;
     return *this;
   }
 
@@ -382,10 +431,7 @@ namespace jank::read::lex
   movable_position movable_position::operator+(usize const count) const
   {
     movable_position ret{ *this };
-    for(usize i{}; i < count; ++i)
-    {
-      ++ret;
-    }
+    ret += count;
     return ret;
   }
 
@@ -481,7 +527,7 @@ namespace jank::read::lex
     return false;
   }
 
-  static bool is_special_char(char32_t const c)
+  static constexpr bool is_special_char(char32_t const c)
   {
     return c == '(' || c == ')' || c == '{' || c == '}' || c == '[' || c == ']' || c == '"'
       || c == '^' || c == '\\' || c == '`' || c == '~' || c == ',' || c == ';';
@@ -495,6 +541,101 @@ namespace jank::read::lex
           || c == '>' || c == '#' || c == '%' || is_utf8_char(c));
   }
 
+  /* Printable ASCII which is_symbol_char accepts. Spaces and control characters are left
+   * out, since whether they're spaces depends on the locale. */
+  static constexpr auto ascii_symbol_chars{ [] {
+    std::array<bool, 128> ret{};
+    for(char32_t c{ '!' }; c <= '~'; ++c)
+    {
+      ret[c] = !is_special_char(c);
+    }
+    return ret;
+  }() };
+
+  /* The length of the run of ASCII symbol characters from the offset on. Most symbols are
+   * all ASCII, so this lets us skip decoding them. The lexer then goes on with
+   * is_symbol_char from the end of the run, to handle anything else. */
+  static usize ascii_symbol_run(jtl::immutable_string_view const file, usize const offset)
+  {
+    auto end{ offset };
+    while(end < file.size())
+    {
+      auto const c{ static_cast<u8>(file[end]) };
+      if(c >= ascii_symbol_chars.size() || !ascii_symbol_chars[c])
+      {
+        break;
+      }
+      ++end;
+    }
+    return end - offset;
+  }
+
+  /* Finds the first byte, from the offset on, which is one of the stops or which isn't
+   * ASCII. String and comment bodies are mostly long runs of plain ASCII, so we scan them
+   * a block at a time and only decode characters once we find something interesting.
+   * Gives the size of the file if there's no such byte. */
+  template <char... Stops>
+  static usize find_ascii_stop(jtl::immutable_string_view const file, usize offset)
+  {
+    auto const data{ reinterpret_cast<u8 const *>(file.data()) };
+    auto const size{ file.size() };
+
+#if defined(__AVX2__)
+    for(; offset + 32 <= size; offset += 32)
+    {
+      auto const block{ _mm256_loadu_si256(reinterpret_cast<__m256i const *>(data + offset)) };
+      /* The movemask takes the high bit of each byte, which is set for non-ASCII. */
+      auto matches{ static_cast<u32>(_mm256_movemask_epi8(block)) };
+      ((matches |= static_cast<u32>(
+          _mm256_movemask_epi8(_mm256_cmpeq_epi8(block, _mm256_set1_epi8(Stops))))),
+       ...);
+      if(matches != 0)
+      {
+        return offset + std::countr_zero(matches);
+      }
+    }
+#endif
+#if defined(__SSE2__)
+    for(; offset + 16 <= size; offset += 16)
+    {
+      auto const block{ _mm_loadu_si128(reinterpret_cast<__m128i const *>(data + offset)) };
+      auto matches{ static_cast<u32>(_mm_movemask_epi8(block)) };
+      ((matches
+        |= static_cast<u32>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8(Stops))))),
+       ...);
+      if(matches != 0)
+      {
+        return offset + std::countr_zero(matches);
+      }
+    }
+#elif defined(__ARM_NEON)
+    for(; offset + 16 <= size; offset += 16)
+    {
+      auto const block{ vld1q_u8(data + offset) };
+      auto matches{ vcgeq_u8(block, vdupq_n_u8(0x80)) };
+      ((matches = vorrq_u8(matches, vceqq_u8(block, vdupq_n_u8(static_cast<u8>(Stops))))), ...);
+      /* NEON has no movemask, so we narrow each byte of the mask to four bits instead. */
+      auto const mask{ vget_lane_u64(
+        vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(matches), 4)),
+        0) };
+      if(mask != 0)
+      {
+        return offset + (std::countr_zero(mask) >> 2);
+      }
+    }
+#endif
+
+    for(; offset < size; ++offset)
+    {
+      auto const c{ data[offset] };
+      if(c >= 0x80 || ((c == static_cast<u8>(Stops)) || ...))
+      {
+        return offset;
+      }
+    }
+    return size;
+  }
+
   static bool is_lower_letter(char32_t const c)
   {
     return c >= 'a' && c <= 'z';
@@ -601,6 +742,7 @@ namespace jank::read::lex
 
           while(pos <= file.size())
           {
+            pos += ascii_symbol_run(file, pos.offset + 1);
             auto const pt(peek());
             if(pt.is_err() || !is_symbol_char(pt.expect_ok().character))
             {
@@ -624,6 +766,10 @@ namespace jank::read::lex
           bool hit_non_semi{};
           while(true)
           {
+            if(hit_non_semi)
+            {
+              pos += find_ascii_stop<'\n'>(file, pos.offset + 1) - pos.offset - 1;
+            }
             auto const oc(peek());
             if(oc.is_err())
             {
@@ -1147,6 +1293,7 @@ namespace jank::read::lex
           }
           while(true)
           {
+            pos += ascii_symbol_run(file, pos.offset + 1);
             auto const oc(peek());
             if(oc.is_err())
             {
@@ -1246,6 +1393,7 @@ namespace jank::read::lex
           }
           while(true)
           {
+            pos += ascii_symbol_run(file, pos.offset + 1);
             auto const oc(peek());
             if(oc.is_err())
             {
@@ -1288,6 +1436,10 @@ namespace jank::read::lex
           bool escaped{}, contains_escape{};
           while(true)
           {
+            if(!escaped)
+            {
+              pos += find_ascii_stop<'"', '\\'>(file, pos.offset + 1) - pos.offset - 1;
+            }
             auto const oc(peek());
             if(oc.is_err())
             {
@@ -1466,6 +1618,7 @@ namespace jank::read::lex
           pos += oc.expect_ok().len;
           while(pos <= file.size())
           {
+            pos += ascii_symbol_run(file, pos.offset);
             auto const result(convert_to_codepoint(file.substr(pos), pos));
             if(result.is_err())
             {
@@ -1492,11 +1645,11 @@ namespace jank::read::lex
 
   jtl::result<codepoint, error_ref> processor::peek(usize const ahead) const
   {
-    auto const peek_pos{ pos + ahead };
-    if(peek_pos >= file.size())
+    if(pos.offset + ahead >= file.size())
     {
       return error::lex_unexpected_eof(pos);
     }
+    auto const peek_pos{ pos + ahead };
     auto const oc{ convert_to_codepoint(file.substr(peek_pos), peek_pos) };
     return oc;
   }
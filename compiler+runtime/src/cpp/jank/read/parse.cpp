@@ -1,4 +1,8 @@
+#include <algorithm>
+#include <atomic>
 #include <codecvt>
+#include <limits>
+#include <thread>
 
 #include <jank/read/parse.hpp>
 #include <jank/error/parse.hpp>
@@ -7,13 +11,17 @@
 #include <jank/runtime/context.hpp>
 #include <jank/runtime/core.hpp>
 #include <jank/runtime/core/meta.hpp>
+#include <jank/runtime/executor.hpp>
 #include <jank/runtime/obj/symbol.hpp>
 #include <jank/runtime/obj/ratio.hpp>
+#include <jank/runtime/obj/persistent_vector.hpp>
 #include <jank/runtime/behavior/map_like.hpp>
 #include <jank/runtime/behavior/set_like.hpp>
 #include <jank/runtime/sequence_range.hpp>
+#include <jank/util/cli.hpp>
 #include <jank/util/scope_exit.hpp>
 #include <jank/util/fmt.hpp>
+#include <jank/profile/phase.hpp>
 
 /* TODO: Make common symbol boxes once and reuse those. */
 namespace jank::read::parse
@@ -118,6 +126,7 @@ namespace jank::read::parse
 
   processor::iterator &processor::iterator::operator++()
   {
+    profile::phase_timer const phase{ profile::phase::read };
     latest = some(p->next());
     return *this;
   }
@@ -135,14 +144,59 @@ namespace jank::read::parse
   processor::processor(lex::processor::iterator const &b, lex::processor::iterator const &e)
     : token_current{ b }
     , token_end{ e }
-    , splicing_allowed_var{ make_box<var>(
-                              __rt_ctx->intern_ns(make_box<obj::symbol>("clojure.core")),
-                              make_box<obj::symbol>("*splicing-allowed?*"),
-                              jank_false)
-                              ->set_dynamic(true) }
   {
   }
 
+  jtl::option<object_ref>
+  processor::form_meta(source_position const &start, source_position const &end) const
+  {
+    if(data_only)
+    {
+      return none;
+    }
+    return source_to_meta(start, end);
+  }
+
+  static form_position to_form_position(object_source_info const &form)
+  {
+    auto const &start(form.start.start);
+    auto const &end(form.end.end);
+    return { .start_offset = static_cast<u32>(start.offset),
+             .start_line = static_cast<u32>(start.line),
+             .start_col = static_cast<u32>(start.col),
+             .end_offset = static_cast<u32>(end.offset),
+             .end_line = static_cast<u32>(end.line),
+             .end_col = static_cast<u32>(end.col) };
+  }
+
+  /* These are keyed by the file which the collection's meta names, so reparse_nth can
+   * find them from that meta. Forms without a file can't be found again anyway. */
+  void processor::record_form_positions(lex::token const &start,
+                                        native_vector<form_position> &&positions)
+  {
+    if(data_only || !records_positions
+       || std::numeric_limits<u32>::max() < latest_token.end.offset)
+    {
+      return;
+    }
+
+    if(!positions.empty())
+    {
+      pending_positions.insert_or_assign(start.start.offset, std::move(positions));
+    }
+    if(collection_depth != 1 || pending_positions.empty())
+    {
+      return;
+    }
+
+    auto const file(runtime::to_string(runtime::__rt_ctx->current_file_var->deref()));
+    if(file != no_source_path)
+    {
+      parse::record_positions(file, std::move(pending_positions));
+    }
+    pending_positions.clear();
+  }
+
   processor::object_result processor::next()
   {
     if(token_current == token_end)
@@ -283,20 +337,32 @@ namespace jank::read::parse
     auto const prev_expected_closer(expected_closer);
     expected_closer = some(lex::token_kind::close_paren);
 
-    __rt_ctx
-      ->push_thread_bindings(
-        obj::persistent_hash_map::create_unique(std::make_pair(splicing_allowed_var, jank_true)))
-      .expect_ok();
-    util::scope_exit const finally{ [] { __rt_ctx->pop_thread_bindings().expect_ok(); } };
+    auto const prev_splicing_allowed(splicing_allowed);
+    splicing_allowed = true;
+    /* Anything left over from a top level form which failed to read is dropped. */
+    if(++collection_depth == 1)
+    {
+      pending_positions.clear();
+    }
+    util::scope_exit const finally{ [&] {
+      splicing_allowed = prev_splicing_allowed;
+      --collection_depth;
+    } };
 
     runtime::detail::native_transient_vector ret;
+    native_vector<form_position> positions;
     for(auto it(begin()); it != end(); ++it)
     {
       if(it.latest.unwrap().is_err())
       {
         return err(it.latest.unwrap().expect_err());
       }
-      ret.push_back(it.latest.unwrap().expect_ok().unwrap().ptr);
+      auto const &form(it.latest.unwrap().expect_ok().unwrap());
+      ret.push_back(form.ptr);
+      if(!data_only)
+      {
+        positions.push_back(to_form_position(form));
+      }
     }
     if(expected_closer.is_some())
     {
@@ -305,13 +371,10 @@ namespace jank::read::parse
 
     expected_closer = prev_expected_closer;
 
-    return object_source_info{ make_box<obj::persistent_list>(
-                                 source_to_meta(start_token.start, latest_token.end),
-                                 std::in_place,
-                                 ret.rbegin(),
-                                 ret.rend()),
-                               start_token,
-                               latest_token };
+    auto const list(make_box<obj::persistent_list>(std::in_place, ret.rbegin(), ret.rend()));
+    list->meta = form_meta(start_token.start, latest_token.end);
+    record_form_positions(start_token, std::move(positions));
+    return object_source_info{ list, start_token, latest_token };
   }
 
   processor::object_result processor::parse_vector()
@@ -321,20 +384,32 @@ namespace jank::read::parse
     auto const prev_expected_closer(expected_closer);
     expected_closer = some(lex::token_kind::close_square_bracket);
 
-    __rt_ctx
-      ->push_thread_bindings(
-        obj::persistent_hash_map::create_unique(std::make_pair(splicing_allowed_var, jank_true)))
-      .expect_ok();
-    util::scope_exit const finally{ [] { __rt_ctx->pop_thread_bindings().expect_ok(); } };
+    auto const prev_splicing_allowed(splicing_allowed);
+    splicing_allowed = true;
+    /* Anything left over from a top level form which failed to read is dropped. */
+    if(++collection_depth == 1)
+    {
+      pending_positions.clear();
+    }
+    util::scope_exit const finally{ [&] {
+      splicing_allowed = prev_splicing_allowed;
+      --collection_depth;
+    } };
 
     runtime::detail::native_transient_vector ret;
+    native_vector<form_position> positions;
     for(auto it(begin()); it != end(); ++it)
     {
       if(it.latest.unwrap().is_err())
       {
         return err(it.latest.unwrap().expect_err());
       }
-      ret.push_back(it.latest.unwrap().expect_ok().unwrap().ptr);
+      auto const &form(it.latest.unwrap().expect_ok().unwrap());
+      ret.push_back(form.ptr);
+      if(!data_only)
+      {
+        positions.push_back(to_form_position(form));
+      }
     }
     if(expected_closer.is_some())
     {
@@ -342,8 +417,9 @@ namespace jank::read::parse
     }
 
     expected_closer = prev_expected_closer;
+    record_form_positions(start_token, std::move(positions));
     return object_source_info{ make_box<obj::persistent_vector>(
-                                 source_to_meta(start_token.start, latest_token.end),
+                                 form_meta(start_token.start, latest_token.end),
                                  ret.persistent()),
                                start_token,
                                latest_token };
@@ -356,11 +432,9 @@ namespace jank::read::parse
     auto const prev_expected_closer(expected_closer);
     expected_closer = some(lex::token_kind::close_curly_bracket);
 
-    __rt_ctx
-      ->push_thread_bindings(
-        obj::persistent_hash_map::create_unique(std::make_pair(splicing_allowed_var, jank_true)))
-      .expect_ok();
-    util::scope_exit const finally{ [] { __rt_ctx->pop_thread_bindings().expect_ok(); } };
+    auto const prev_splicing_allowed(splicing_allowed);
+    splicing_allowed = true;
+    util::scope_exit const finally{ [&] { splicing_allowed = prev_splicing_allowed; } };
     native_vector<processor::object_result> const items(begin(), end());
 
     if(expected_closer.is_some())
@@ -395,7 +469,47 @@ namespace jank::read::parse
         }
         auto const value(item->expect_ok());
 
-        if(auto const parsed_key = parsed_keys.find(key.ptr); parsed_key != parsed_keys.end())
+        auto const insert([&] {
+          if constexpr(jtl::is_same<T, runtime::detail::native_array_map>)
+          {
+            map.insert_or_assign(key.ptr, value.unwrap().ptr);
+          }
+          else
+          {
+            map.insert(std::make_pair(key.ptr, value.unwrap().ptr));
+          }
+        });
+
+        jtl::option<object_source_info> original;
+        if(data_only)
+        {
+          /* When reading data, the map itself tells us about duplicates, so we don't need
+           * to keep the source of each key. We only look for the original on error. */
+          auto const size_before(map.size());
+          insert();
+          if(map.size() == size_before)
+          {
+            for(auto it(items.begin()); it != item; it += 2)
+            {
+              if(equal(it->expect_ok().unwrap().ptr, key.ptr))
+              {
+                original = it->expect_ok().unwrap();
+                break;
+              }
+            }
+          }
+        }
+        else if(auto const parsed_key = parsed_keys.find(key.ptr); parsed_key != parsed_keys.end())
+        {
+          original = parsed_key->second;
+        }
+        else
+        {
+          parsed_keys.insert({ key.ptr, key });
+          insert();
+        }
+
+        if(original.is_some())
         {
           return error::parse_duplicate_keys_in_map(
             {
@@ -403,20 +517,9 @@ namespace jank::read::parse
               key.end.end
           },
             { "Original key.",
-              { parsed_key->second.start.start, parsed_key->second.end.end },
+              { original.unwrap().start.start, original.unwrap().end.end },
               error::note::kind::info });
         }
-
-        parsed_keys.insert({ key.ptr, key });
-
-        if constexpr(jtl::is_same<T, runtime::detail::native_array_map>)
-        {
-          map.insert_or_assign(key.ptr, value.unwrap().ptr);
-        }
-        else
-        {
-          map.insert(std::make_pair(key.ptr, value.unwrap().ptr));
-        }
       }
 
       return jtl::ok();
@@ -434,7 +537,7 @@ namespace jank::read::parse
       }
 
       return object_source_info{ make_box<obj::persistent_array_map>(
-                                   source_to_meta(start_token.start, latest_token.end),
+                                   form_meta(start_token.start, latest_token.end),
                                    jtl::move(map)),
                                  start_token,
                                  latest_token };
@@ -452,7 +555,7 @@ namespace jank::read::parse
       auto map{ transient_map.persistent() };
 
       return object_source_info{ make_box<obj::persistent_hash_map>(
-                                   source_to_meta(start_token.start, latest_token.end),
+                                   form_meta(start_token.start, latest_token.end),
                                    jtl::move(map)),
                                  start_token,
                                  latest_token };
@@ -477,14 +580,11 @@ namespace jank::read::parse
                                         "Quote form is missing its value.");
     }
 
-    return object_source_info{ make_box<obj::persistent_list>(
-                                 source_to_meta(start_token.start, latest_token.end),
-                                 std::in_place,
-                                 make_box<obj::symbol>("quote"),
-                                 val_result.expect_ok().unwrap().ptr)
-                                 .erase(),
-                               start_token,
-                               latest_token };
+    auto const list(make_box<obj::persistent_list>(std::in_place,
+                                                   make_box<obj::symbol>("quote"),
+                                                   val_result.expect_ok().unwrap().ptr));
+    list->meta = form_meta(start_token.start, latest_token.end);
+    return object_source_info{ list.erase(), start_token, latest_token };
   }
 
   processor::object_result processor::parse_character()
@@ -649,13 +749,12 @@ namespace jank::read::parse
     auto const prev_expected_closer(expected_closer);
     expected_closer = some(lex::token_kind::close_curly_bracket);
 
-    __rt_ctx
-      ->push_thread_bindings(
-        obj::persistent_hash_map::create_unique(std::make_pair(splicing_allowed_var, jank_true)))
-      .expect_ok();
-    util::scope_exit const finally{ [] { __rt_ctx->pop_thread_bindings().expect_ok(); } };
+    auto const prev_splicing_allowed(splicing_allowed);
+    splicing_allowed = true;
+    util::scope_exit const finally{ [&] { splicing_allowed = prev_splicing_allowed; } };
 
     native_unordered_map<runtime::object_ref, object_source_info> parsed_items{};
+    native_vector<object_source_info> items;
     runtime::detail::native_transient_hash_set ret;
     for(auto it(begin()); it != end(); ++it)
     {
@@ -666,6 +765,30 @@ namespace jank::read::parse
 
       auto const item(it.latest.unwrap().expect_ok().unwrap());
 
+      if(data_only)
+      {
+        /* Like with maps, the set tells us about duplicates when we're reading data. */
+        auto const size_before(ret.size());
+        ret.insert(item.ptr);
+        if(ret.size() != size_before)
+        {
+          items.emplace_back(item);
+          continue;
+        }
+
+        auto const original(std::find_if(items.begin(), items.end(), [&](auto const &i) {
+          return equal(i.ptr, item.ptr);
+        }));
+        return error::parse_duplicate_items_in_set(
+          {
+            item.start.start,
+            item.end.end
+        },
+          { "Original item.",
+            { original->start.start, original->end.end },
+            error::note::kind::info });
+      }
+
       if(auto const parsed_item = parsed_items.find(item.ptr); parsed_item != parsed_items.end())
       {
         return error::parse_duplicate_items_in_set(
@@ -688,7 +811,7 @@ namespace jank::read::parse
 
     expected_closer = prev_expected_closer;
     return object_source_info{ make_box<obj::persistent_hash_set>(
-                                 source_to_meta(start_token.start, latest_token.end),
+                                 form_meta(start_token.start, latest_token.end),
                                  jtl::move(ret).persistent()),
                                start_token,
                                latest_token };
@@ -1036,89 +1159,244 @@ namespace jank::read::parse
     return ok(none);
   }
 
+  jtl::result<void, error_ref> processor::skip_form(lex::token const &start_token)
+  {
+    /* The forms which are left to skip, at the depth we started at. Some prefixes, like a
+     * meta hint or #_, are followed by two forms. */
+    usize remaining{ 1 };
+    usize depth{};
+    while(true)
+    {
+      auto const token_result(*token_current);
+      if(token_result.is_err())
+      {
+        return token_result.err().unwrap();
+      }
+      latest_token = token_result.expect_ok();
+      ++token_current;
+
+      bool completed{};
+      switch(latest_token.kind)
+      {
+        case lex::token_kind::comment:
+        case lex::token_kind::single_quote:
+        case lex::token_kind::syntax_quote:
+        case lex::token_kind::unquote:
+        case lex::token_kind::unquote_splice:
+        case lex::token_kind::deref:
+        case lex::token_kind::reader_macro_conditional:
+        case lex::token_kind::reader_macro_conditional_splice:
+          break;
+        case lex::token_kind::meta_hint:
+        case lex::token_kind::reader_macro_comment:
+          remaining += depth == 0;
+          break;
+        case lex::token_kind::reader_macro:
+          {
+            auto const next_token_result(*token_current);
+            if(next_token_result.is_err())
+            {
+              return next_token_result.err().unwrap();
+            }
+            /* A tag, like #inst, is followed by the form it tags, which is the form being
+             * skipped, so the tag itself is skipped along with the #. ##Inf and the like are
+             * a single form, which the symbol after the ## completes. */
+            auto const next_kind(next_token_result.expect_ok().kind);
+            if(next_kind == lex::token_kind::reader_macro || next_kind == lex::token_kind::symbol)
+            {
+              ++token_current;
+            }
+            break;
+          }
+        case lex::token_kind::open_paren:
+        case lex::token_kind::open_square_bracket:
+        case lex::token_kind::open_curly_bracket:
+          ++depth;
+          break;
+        case lex::token_kind::close_paren:
+        case lex::token_kind::close_square_bracket:
+        case lex::token_kind::close_curly_bracket:
+          if(depth == 0)
+          {
+            return error::parse_invalid_reader_conditional(
+              { start_token.start, latest_token.end },
+              "#? expects an even number of forms.");
+          }
+          completed = --depth == 0;
+          break;
+        case lex::token_kind::eof:
+          return error::parse_invalid_reader_conditional({ start_token.start, latest_token.end },
+                                                         "Unterminated #?.");
+        default:
+          completed = depth == 0;
+          break;
+      }
+
+      if(completed && --remaining == 0)
+      {
+        return ok();
+      }
+    }
+  }
+
+  /* Only the branch we take is parsed. The others are skipped over token by token, without
+   * building any objects for them, since .cljc files can have large branches for other
+   * platforms. */
   processor::object_result processor::parse_reader_macro_conditional(bool const splice)
   {
     auto const start_token(token_current.latest.unwrap().expect_ok());
     ++token_current;
 
-    auto list_result(next());
-    if(list_result.is_err())
+    auto const skip_comments([&]() -> jtl::result<lex::token, error_ref> {
+      while(true)
+      {
+        auto const token_result(*token_current);
+        if(token_result.is_err())
+        {
+          return token_result.err().unwrap();
+        }
+        latest_token = token_result.expect_ok();
+        if(latest_token.kind != lex::token_kind::comment)
+        {
+          return latest_token;
+        }
+        ++token_current;
+      }
+    });
+
+    auto const open_result(skip_comments());
+    if(open_result.is_err())
     {
-      return list_result;
+      return open_result.expect_err();
     }
-    else if(list_result.expect_ok().is_none())
+    auto const open_kind(open_result.expect_ok().kind);
+    if(open_kind == lex::token_kind::eof)
     {
       return error::parse_invalid_reader_conditional({ start_token.start, latest_token.end },
                                                      "Value after #? must be present.");
     }
-    else if(list_result.expect_ok().unwrap().ptr->type != object_type::persistent_list)
+    else if(open_kind != lex::token_kind::open_paren)
     {
       return error::parse_invalid_reader_conditional({ start_token.start, latest_token.end },
                                                      "Value after #? must be a list.");
     }
+    ++token_current;
 
-    auto const list(expect_object<obj::persistent_list>(list_result.expect_ok().unwrap().ptr));
-    auto const list_end(list_result.expect_ok().unwrap().end);
-
-    if(list->count() % 2 == 1)
-    {
-      return error::parse_invalid_reader_conditional({ start_token.start, latest_token.end },
-                                                     "#? expects an even number of forms.");
-    }
+    auto const outer_splicing_allowed(splicing_allowed);
+    auto const prev_expected_closer(expected_closer);
+    splicing_allowed = true;
+    expected_closer = some(lex::token_kind::close_paren);
+    util::scope_exit const finally{ [&] {
+      splicing_allowed = outer_splicing_allowed;
+      expected_closer = prev_expected_closer;
+    } };
 
     auto const jank_keyword(__rt_ctx->intern_keyword("", "jank").expect_ok());
     auto const default_keyword(__rt_ctx->intern_keyword("", "default").expect_ok());
 
-    auto const r{ make_sequence_range(list) };
-    for(auto it(r.begin()); it != r.end(); ++it, ++it)
+    jtl::option<object_ref> match;
+    while(true)
     {
-      auto const kw(*it);
+      auto const token_result(skip_comments());
+      if(token_result.is_err())
+      {
+        return token_result.expect_err();
+      }
+      if(token_result.expect_ok().kind == lex::token_kind::close_paren)
+      {
+        ++token_current;
+        break;
+      }
+
+      auto const feature_result(next());
+      if(feature_result.is_err())
+      {
+        return feature_result;
+      }
+      else if(feature_result.expect_ok().is_none())
+      {
+        return error::parse_invalid_reader_conditional({ start_token.start, latest_token.end },
+                                                       "Unterminated #?.");
+      }
+      auto const feature(feature_result.expect_ok().unwrap().ptr);
+
+      auto const value_token_result(skip_comments());
+      if(value_token_result.is_err())
+      {
+        return value_token_result.expect_err();
+      }
+      if(value_token_result.expect_ok().kind == lex::token_kind::close_paren)
+      {
+        return error::parse_invalid_reader_conditional({ start_token.start, latest_token.end },
+                                                       "#? expects an even number of forms.");
+      }
+
       /* We take the first match, checking for :jank first. If there are duplicates, it doesn't
        * matter. If :default comes first, we'll always take it. In short, order is important. This
        * matches Clojure's behavior. */
-      if(equal(kw, jank_keyword) || equal(kw, default_keyword))
+      if(match.is_some() || (!equal(feature, jank_keyword) && !equal(feature, default_keyword)))
       {
-        if(splice)
+        auto const skipped(skip_form(start_token));
+        if(skipped.is_err())
         {
-          if(!truthy(splicing_allowed_var->deref()))
-          {
-            return error::parse_invalid_reader_splice({ start_token.start, latest_token.end },
-                                                      "Top-level #?@ usage is not allowed.");
-          }
+          return skipped.expect_err();
+        }
+        continue;
+      }
 
-          auto const s(*(++it));
-          return visit_seqable(
-            [&](auto const typed_s) -> processor::object_result {
-              auto const r{ make_sequence_range(typed_s) };
-              if(r.begin() == r.end())
-              {
-                return ok(none);
-              }
-              auto const first(*r.begin());
+      auto const value_result(next());
+      if(value_result.is_err())
+      {
+        return value_result;
+      }
+      else if(value_result.expect_ok().is_none())
+      {
+        return error::parse_invalid_reader_conditional({ start_token.start, latest_token.end },
+                                                       "Unterminated #?.");
+      }
+      match = value_result.expect_ok().unwrap().ptr;
+    }
+    auto const list_end(latest_token);
 
-              auto const front(pending_forms.begin());
-              for(auto it(++r.begin()); it != r.end(); ++it)
-              {
-                pending_forms.insert(front, *it);
-              }
+    if(match.is_none())
+    {
+      return ok(none);
+    }
+
+    if(!splice)
+    {
+      return object_source_info{ match.unwrap(), start_token, list_end };
+    }
+
+    if(!outer_splicing_allowed)
+    {
+      return error::parse_invalid_reader_splice({ start_token.start, latest_token.end },
+                                                "Top-level #?@ usage is not allowed.");
+    }
 
-              return object_source_info{ first, start_token, list_end };
-            },
-            [&]() -> processor::object_result {
-              /* TODO: Get the source of just this form. */
-              return error::parse_invalid_reader_splice({ start_token.start, latest_token.end },
-                                                        "#?@ must be used on a sequence.");
-            },
-            s);
+    return visit_seqable(
+      [&](auto const typed_s) -> processor::object_result {
+        auto const r{ make_sequence_range(typed_s) };
+        if(r.begin() == r.end())
+        {
+          return ok(none);
         }
-        else
+        auto const first(*r.begin());
+
+        auto const front(pending_forms.begin());
+        for(auto it(++r.begin()); it != r.end(); ++it)
         {
-          return object_source_info{ *(++it), start_token, list_end };
+          pending_forms.insert(front, *it);
         }
-      }
-    }
 
-    return ok(none);
+        return object_source_info{ first, start_token, list_end };
+      },
+      [&]() -> processor::object_result {
+        /* TODO: Get the source of just this form. */
+        return error::parse_invalid_reader_splice({ start_token.start, latest_token.end },
+                                                  "#?@ must be used on a sequence.");
+      },
+      match.unwrap());
   }
 
   jtl::result<object_ref, error_ref> processor::syntax_quote_expand_seq(object_ref const seq)
@@ -1254,7 +1532,7 @@ namespace jank::read::parse
     object_ref ret{};
 
     /* Specials, such as fn*, let*, try, etc. just get left alone. We can't qualify them more. */
-    if(__rt_ctx->an_prc.is_special(form))
+    if(analyze::processor::is_special(form))
     {
       ret = make_box<obj::persistent_list>(std::in_place, make_box<obj::symbol>("quote"), form);
     }
@@ -1550,7 +1828,7 @@ namespace jank::read::parse
     auto const token((*token_current).expect_ok());
     ++token_current;
     auto const b(std::get<bool>(token.data));
-    return object_source_info{ make_box<obj::boolean>(b), token, token };
+    return object_source_info{ make_box(b), token, token };
   }
 
   processor::object_result processor::parse_symbol()
@@ -1641,11 +1919,15 @@ namespace jank::read::parse
         name = name + "#";
       }
     }
-    return object_source_info{
-      make_box<obj::symbol>(source_to_meta(start_token.start, latest_token.end), ns, name),
-      start_token,
-      start_token
-    };
+    auto const meta(form_meta(start_token.start, latest_token.end));
+    if(meta.is_none() && util::cli::opts.intern_symbols)
+    {
+      return object_source_info{ __rt_ctx->intern_symbol(ns, name), start_token, start_token };
+    }
+
+    auto const sym(make_box<obj::symbol>(ns, name));
+    sym->meta = meta;
+    return object_source_info{ sym, start_token, start_token };
   }
 
   processor::object_result processor::parse_keyword()
@@ -1676,12 +1958,25 @@ namespace jank::read::parse
       name = sv.substr(resolved ? 0 : 1);
     }
 
+    auto const cache{ data_only && resolved };
+    if(cache)
+    {
+      if(auto const found(keyword_cache.find(sv)); found != keyword_cache.end())
+      {
+        return object_source_info{ found->second, start_token, start_token };
+      }
+    }
+
     auto const intern_res(__rt_ctx->intern_keyword(ns, name, resolved));
     if(intern_res.is_err())
     {
       return error::parse_invalid_keyword(intern_res.expect_err(),
                                           { start_token.start, latest_token.end });
     }
+    if(cache)
+    {
+      keyword_cache.emplace(sv, intern_res.expect_ok());
+    }
     return object_source_info{ intern_res.expect_ok(), start_token, start_token };
   }
 
@@ -1776,6 +2071,7 @@ namespace jank::read::parse
 
   processor::iterator processor::begin()
   {
+    profile::phase_timer const phase{ profile::phase::read };
     return { some(next()), this };
   }
 
@@ -1783,4 +2079,375 @@ namespace jank::read::parse
   {
     return { some(ok(none)), this };
   }
+
+  jtl::result<object_ref, error_ref> read_data(jtl::immutable_string_view const &code)
+  {
+    lex::processor l_prc{ code };
+    processor p_prc{ l_prc.begin(), l_prc.end() };
+    p_prc.data_only = true;
+
+    auto const result(p_prc.next());
+    if(result.is_err())
+    {
+      return result.expect_err();
+    }
+    else if(result.expect_ok().is_none())
+    {
+      return ok(jank_nil());
+    }
+    return ok(result.expect_ok().unwrap().ptr);
+  }
+}
+
+namespace jank::read::parse
+{
+  using namespace jank::runtime;
+
+  /* Anything smaller than this is read on the calling thread, since splitting it up costs
+   * more than it saves. */
+  static constexpr usize parallel_read_size{ 1024 * 1024 };
+  static constexpr usize min_read_chunk_size{ 256 * 1024 };
+
+  static bool is_data_delimiter(char const c)
+  {
+    switch(c)
+    {
+      case ' ':
+      case '\t':
+      case '\n':
+      case '\r':
+      case ',':
+      case '(':
+      case ')':
+      case '[':
+      case ']':
+      case '{':
+      case '}':
+      case '"':
+      case ';':
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  /* Finds offsets, at least chunk_size apart, at which the code can be split between two
+   * top level forms. This only knows enough of the syntax to follow nesting, strings,
+   * comments, character literals, and the forms which apply to the forms after them, such
+   * as #_ and ^, so it runs far quicker than the lexer. If it ever splits a form, reading
+   * that chunk fails and the whole code is read again in order. */
+  static native_vector<usize>
+  find_form_boundaries(jtl::immutable_string_view const &code, usize const chunk_size)
+  {
+    native_vector<usize> ret;
+    auto const size(code.size());
+    usize i{}, depth{}, chunk_start{};
+    /* How many more forms the current top level form needs. Something like ^ needs two. */
+    usize needed{};
+
+    auto const finish_form([&] {
+      if(depth != 0)
+      {
+        return;
+      }
+      if(needed != 0)
+      {
+        --needed;
+      }
+      if(needed == 0 && chunk_size <= i - chunk_start && i < size)
+      {
+        ret.push_back(i);
+        chunk_start = i;
+      }
+    });
+    /* For something which takes the next n forms and gives back one. */
+    auto const takes_forms([&](usize const n) {
+      if(depth == 0)
+      {
+        needed = std::max<usize>(needed, 1) + n - 1;
+      }
+    });
+    auto const skip_atom([&] {
+      while(i < size && !is_data_delimiter(code[i]))
+      {
+        ++i;
+      }
+    });
+
+    while(i < size)
+    {
+      switch(code[i])
+      {
+        case ';':
+          while(i < size && code[i] != '\n')
+          {
+            ++i;
+          }
+          break;
+        case '"':
+          for(++i; i < size && code[i] != '"'; ++i)
+          {
+            if(code[i] == '\\')
+            {
+              ++i;
+            }
+          }
+          ++i;
+          finish_form();
+          break;
+        case '\\':
+          i += 2;
+          skip_atom();
+          finish_form();
+          break;
+        case '(':
+        case '[':
+        case '{':
+          ++depth;
+          ++i;
+          break;
+        case ')':
+        case ']':
+        case '}':
+          if(depth != 0)
+          {
+            --depth;
+          }
+          ++i;
+          finish_form();
+          break;
+        case '\'':
+        case '`':
+        case '@':
+          takes_forms(1);
+          ++i;
+          break;
+        case '~':
+          takes_forms(1);
+          ++i;
+          if(i < size && code[i] == '@')
+          {
+            ++i;
+          }
+          break;
+        case '^':
+          takes_forms(2);
+          ++i;
+          break;
+        case '#':
+          if(i + 1 == size)
+          {
+            ++i;
+            break;
+          }
+          switch(code[i + 1])
+          {
+            /* Sets, fns, and regexes are picked up by their opening character. */
+            case '{':
+            case '(':
+            case '"':
+              ++i;
+              break;
+            case '_':
+            case '\'':
+              takes_forms(1);
+              i += 2;
+              break;
+            /* Reader conditionals are followed by their list. */
+            case '?':
+              i += 2;
+              if(i < size && code[i] == '@')
+              {
+                ++i;
+              }
+              break;
+            /* Symbolic values, such as ##Inf. */
+            case '#':
+              skip_atom();
+              finish_form();
+              break;
+            /* Tagged literals and namespaced maps apply to the next form. */
+            default:
+              takes_forms(1);
+              ++i;
+              skip_atom();
+              break;
+          }
+          break;
+        case ' ':
+        case '\t':
+        case '\n':
+        case '\r':
+        case ',':
+          ++i;
+          break;
+        default:
+          skip_atom();
+          finish_form();
+          break;
+      }
+    }
+
+    return ret;
+  }
+
+  /* The position of an offset, found by counting lines from an earlier position. */
+  static source_position advance_position(jtl::immutable_string_view const &code,
+                                          source_position pos,
+                                          usize const offset)
+  {
+    auto const begin{ code.data() + pos.offset };
+    auto const end{ code.data() + offset };
+    auto const newlines{ std::count(begin, end, '\n') };
+    if(newlines == 0)
+    {
+      pos.col += offset - pos.offset;
+    }
+    else
+    {
+      pos.line += static_cast<usize>(newlines);
+      auto const last_newline{ std::find(std::make_reverse_iterator(end),
+                                         std::make_reverse_iterator(begin),
+                                         '\n') };
+      pos.col
+        = static_cast<usize>(std::distance(std::make_reverse_iterator(end), last_newline)) + 1;
+    }
+    pos.offset = offset;
+    return pos;
+  }
+
+  /* Reads each form from the start position up to the end offset. The lexer sees the code
+   * as ending at the end offset, but keeps the offsets of the whole code, so any error
+   * points to the right place. */
+  static jtl::result<void, error_ref> read_data_chunk(jtl::immutable_string_view const &code,
+                                                      source_position const &start,
+                                                      usize const end,
+                                                      native_vector<object_ref> &out)
+  {
+    lex::processor l_prc{ jtl::immutable_string_view{ code.data(), end },
+                          lex::processor::state{ .pos = start } };
+    processor p_prc{ l_prc.begin(), l_prc.end() };
+    p_prc.data_only = true;
+
+    while(true)
+    {
+      auto const result(p_prc.next());
+      if(result.is_err())
+      {
+        return result.expect_err();
+      }
+      else if(result.expect_ok().is_none())
+      {
+        return ok();
+      }
+      out.push_back(result.expect_ok().unwrap().ptr);
+    }
+  }
+
+  static jtl::result<object_ref, error_ref>
+  read_all_data_in_order(jtl::immutable_string_view const &code)
+  {
+    native_vector<object_ref> forms;
+    auto const res(read_data_chunk(code, source_position{}, code.size(), forms));
+    if(res.is_err())
+    {
+      return res.expect_err();
+    }
+    return ok(make_box<obj::persistent_vector>(
+      runtime::detail::native_persistent_vector{ forms.begin(), forms.end() }));
+  }
+
+  /* One chunk of the code, which is read on the pool. It's GC allocated so the GC can see the
+   * forms it holds from the worker which reads them. */
+  struct data_chunk
+  {
+    source_position start;
+    usize end{};
+    native_vector<object_ref> forms;
+    bool failed{};
+    std::atomic_bool done{};
+  };
+
+  jtl::result<object_ref, error_ref> read_all_data(jtl::immutable_string_view const &code)
+  {
+    auto &pool(pooled_executor());
+    if(code.size() < parallel_read_size || pool.thread_count() < 2)
+    {
+      return read_all_data_in_order(code);
+    }
+
+    auto const chunk_size(std::max(min_read_chunk_size, code.size() / (pool.thread_count() * 4)));
+    auto const boundaries(find_form_boundaries(code, chunk_size));
+    if(boundaries.empty())
+    {
+      return read_all_data_in_order(code);
+    }
+
+    native_vector<data_chunk *> chunks;
+    source_position start{};
+    for(usize i{}; i <= boundaries.size(); ++i)
+    {
+      auto const end(i == boundaries.size() ? code.size() : boundaries[i]);
+      auto * const chunk{ new(GC) data_chunk{} };
+      chunk->start = start;
+      chunk->end = end;
+      chunks.push_back(chunk);
+      if(end != code.size())
+      {
+        start = advance_position(code, start, end);
+      }
+    }
+
+    /* Auto-resolved keywords depend on the current ns, so each worker gets our bindings. */
+    auto const bindings(__rt_ctx->get_thread_bindings());
+    auto const read_chunk([code, bindings](data_chunk * const chunk) {
+      try
+      {
+        context::binding_scope const scope{ bindings };
+        chunk->failed = read_data_chunk(code, chunk->start, chunk->end, chunk->forms).is_err();
+      }
+      catch(...)
+      {
+        chunk->failed = true;
+      }
+      chunk->done.store(true, std::memory_order_release);
+    });
+
+    for(usize i{ 1 }; i < chunks.size(); ++i)
+    {
+      pool.submit([read_chunk, chunk = chunks[i]] { read_chunk(chunk); });
+    }
+    read_chunk(chunks[0]);
+
+    /* We always wait for every chunk, even once one has failed, since they all refer to the
+     * code. */
+    bool failed{};
+    runtime::detail::native_transient_vector ret;
+    for(auto const chunk : chunks)
+    {
+      while(!chunk->done.load(std::memory_order_acquire))
+      {
+        if(!pool.run_pending_task())
+        {
+          std::this_thread::yield();
+        }
+      }
+      failed |= chunk->failed;
+      if(!failed)
+      {
+        for(auto const form : chunk->forms)
+        {
+          ret.push_back(form);
+        }
+      }
+    }
+
+    /* Either the code is bad or a chunk was split in the middle of a form. Reading it in
+     * order sorts out which, and gives the right error if it's the former. */
+    if(failed)
+    {
+      return read_all_data_in_order(code);
+    }
+    return ok(make_box<obj::persistent_vector>(ret.persistent()));
+  }
 }
@@ -1,3 +1,7 @@
+#include <memory>
+
+#include <folly/Synchronized.h>
+
 #include <jank/read/reparse.hpp>
 #include <jank/read/parse.hpp>
 #include <jank/runtime/context.hpp>
@@ -12,6 +16,101 @@ namespace jank::read::parse
 {
   using namespace jank::runtime;
 
+  /* Each file has its own shard, so reading one file doesn't hold up reading another. The
+   * table itself is only locked long enough to find a shard. */
+  using position_shard = folly::Synchronized<file_positions>;
+  using position_table
+    = native_unordered_map<jtl::immutable_string, std::shared_ptr<position_shard>>;
+
+  /* Past this many lists and vectors in one file, which only happens when the same file
+   * is read over and over without being loaded, we start over. Anything dropped can still
+   * be found by reparsing. */
+  static constexpr usize max_recorded_collections{ 1 << 16 };
+
+  static folly::Synchronized<position_table> &positions()
+  {
+    static folly::Synchronized<position_table> table;
+    return table;
+  }
+
+  static std::shared_ptr<position_shard> find_shard(jtl::immutable_string const &file)
+  {
+    auto const table(positions().rlock());
+    auto const found(table->find(file));
+    if(found == table->end())
+    {
+      return nullptr;
+    }
+    return found->second;
+  }
+
+  void record_positions(jtl::immutable_string const &file, file_positions &&forms)
+  {
+    auto shard(find_shard(file));
+    if(!shard)
+    {
+      auto const table(positions().wlock());
+      auto &entry((*table)[file]);
+      if(!entry)
+      {
+        entry = std::make_shared<position_shard>();
+      }
+      shard = entry;
+    }
+
+    auto const locked(shard->wlock());
+    if(max_recorded_collections < locked->size() + forms.size())
+    {
+      locked->clear();
+    }
+    for(auto &entry : forms)
+    {
+      locked->insert_or_assign(entry.first, std::move(entry.second));
+    }
+  }
+
+  jtl::option<form_position>
+  find_position(jtl::immutable_string const &file, usize const offset, usize const n)
+  {
+    auto const shard(find_shard(file));
+    if(!shard)
+    {
+      return none;
+    }
+    auto const locked(shard->rlock());
+    auto const found(locked->find(offset));
+    if(found == locked->end() || found->second.size() <= n)
+    {
+      return none;
+    }
+    return found->second[n];
+  }
+
+  void forget_positions(jtl::immutable_string const &file)
+  {
+    positions().wlock()->erase(file);
+  }
+
+  static jtl::option<source> recorded_nth(source const &parent, usize const n)
+  {
+    if(parent.file == no_source_path)
+    {
+      return none;
+    }
+
+    auto const found(find_position(parent.file, parent.start.offset, n));
+    if(found.is_none())
+    {
+      return none;
+    }
+    auto const &p(found.unwrap());
+    return source{ parent.file,
+                   parent.module,
+                   { p.start_offset, p.start_line, p.start_col },
+                   { p.end_offset, p.end_line, p.end_col },
+                   parent.macro_expansion };
+  }
+
   static jtl::result<source, error_ref> reparse_nth(jtl::immutable_string const &file,
                                                     jtl::immutable_string const &module,
                                                     usize const offset,
@@ -38,6 +137,7 @@ namespace jank::read::parse
 
     lex::processor l_prc{ mapped_file.expect_ok().view(), offset };
     parse::processor p_prc{ l_prc.begin(), l_prc.end() };
+    p_prc.records_positions = false;
 
     auto it{ p_prc.begin() };
     for(usize i{}; i < n; ++i, ++it)
@@ -69,6 +169,10 @@ namespace jank::read::parse
     {
       return source;
     }
+    if(auto const recorded{ recorded_nth(source, n) }; recorded.is_some())
+    {
+      return recorded.unwrap();
+    }
 
     /* Add one to skip the ( for the list. */
     auto const res{
@@ -88,6 +192,10 @@ namespace jank::read::parse
     {
       return source;
     }
+    if(auto const recorded{ recorded_nth(source, n) }; recorded.is_some())
+    {
+      return recorded.unwrap();
+    }
 
     /* Add one to skip the [ for the vector. */
     auto const res{
@@ -0,0 +1,176 @@
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <jank/read/stream.hpp>
+#include <jank/read/lex.hpp>
+#include <jank/read/parse.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/obj/nil.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
+#include <jank/error/system.hpp>
+#include <jank/profile/time.hpp>
+#include <jank/util/fmt.hpp>
+
+namespace jank::read
+{
+  /* A UTF-8 character can take up to four bytes, so an invalid character this close to
+   * the end of the buffer may just be cut off. */
+  static constexpr usize max_codepoint_size{ 4 };
+
+  /* Forms which end with one of these are complete once we have that token. Anything else,
+   * like a symbol or a number, may go on in the part of the stream we haven't read yet. */
+  static bool is_self_delimiting(lex::token_kind const kind)
+  {
+    switch(kind)
+    {
+      case lex::token_kind::close_paren:
+      case lex::token_kind::close_square_bracket:
+      case lex::token_kind::close_curly_bracket:
+      case lex::token_kind::string:
+      case lex::token_kind::escaped_string:
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  /* Whether the error may go away once we have more of the stream. */
+  static bool is_incomplete(error_ref const e, usize const size)
+  {
+    switch(e->kind)
+    {
+      case error::kind::lex_unexpected_eof:
+      case error::kind::lex_unterminated_string:
+      case error::kind::parse_unterminated_list:
+      case error::kind::parse_unterminated_vector:
+      case error::kind::parse_unterminated_map:
+      case error::kind::parse_unterminated_set:
+        return true;
+      case error::kind::lex_invalid_unicode:
+        return e->source.end.offset + max_codepoint_size >= size;
+      /* Anything else which runs up to the end, like a cut off number, may be fine once
+       * we have the rest of it. */
+      default:
+        return e->source.end.offset >= size;
+    }
+  }
+
+  stream_reader::stream_reader(int const fd, bool const owns_fd)
+    : fd{ fd }
+    , owns_fd{ owns_fd }
+  {
+  }
+
+  stream_reader::~stream_reader()
+  {
+    close();
+  }
+
+  void stream_reader::close()
+  {
+    if(owns_fd && fd >= 0)
+    {
+      ::close(fd);
+    }
+    fd = -1;
+    at_eof = true;
+  }
+
+  jtl::result<void, error_ref> stream_reader::refill(usize const size)
+  {
+    if(head != 0)
+    {
+      buffer.erase(buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(head));
+      head = 0;
+    }
+
+    auto const old_size{ buffer.size() };
+    buffer.resize(old_size + size);
+    while(true)
+    {
+      auto const read_size{ ::read(fd, buffer.data() + old_size, size) };
+      if(read_size < 0 && errno == EINTR)
+      {
+        continue;
+      }
+      else if(read_size < 0)
+      {
+        buffer.resize(old_size);
+        return error::system_failure(
+          util::format("Unable to read from the stream: {}", std::strerror(errno)));
+      }
+
+      buffer.resize(old_size + static_cast<usize>(read_size));
+      at_eof = read_size == 0;
+      return ok();
+    }
+  }
+
+  jtl::result<jtl::option<runtime::object_ref>, error_ref> stream_reader::next()
+  {
+    profile::timer const timer{ "read stream next" };
+
+    /* Like read_string, there's no source file for these forms. */
+    runtime::context::binding_scope const preserve{
+      runtime::obj::persistent_hash_map::create_unique(
+        std::make_pair(runtime::__rt_ctx->current_file_var, runtime::jank_nil()))
+    };
+
+    auto read_size{ chunk_size };
+    while(true)
+    {
+      jtl::immutable_string_view const view{ buffer.data() + head, buffer.size() - head };
+      lex::processor l_prc{ view };
+      /* The offset has to stay relative to the buffer, since the lexer uses it to find each
+       * character, but the line and col can pick up from the last form. */
+      l_prc.pos.line = line;
+      l_prc.pos.col = col;
+      parse::processor p_prc{ l_prc.begin(), l_prc.end() };
+
+      auto const result(p_prc.next());
+      if(result.is_ok() && result.expect_ok().is_some())
+      {
+        auto const &info(result.expect_ok().unwrap());
+        if(at_eof || info.end.end.offset < view.size() || is_self_delimiting(info.end.kind))
+        {
+          head += info.end.end.offset;
+          line = info.end.end.line;
+          col = info.end.end.col;
+          return ok(some(info.ptr));
+        }
+      }
+      else if(result.is_ok())
+      {
+        if(at_eof)
+        {
+          head = buffer.size();
+          return ok(none);
+        }
+      }
+      else if(!is_incomplete(result.expect_err(), view.size()))
+      {
+        auto const &e(result.expect_err());
+        head = std::min(buffer.size(), head + std::max<usize>(e->source.end.offset, 1));
+        line = e->source.end.line;
+        col = e->source.end.col;
+        return e;
+      }
+      else if(at_eof)
+      {
+        /* The stream ended partway through a form, so there's nothing left to read. */
+        head = buffer.size();
+        return result.expect_err();
+      }
+
+      auto const refilled(refill(read_size));
+      if(refilled.is_err())
+      {
+        return refilled.expect_err();
+      }
+      read_size *= 2;
+    }
+  }
+}
@@ -0,0 +1,77 @@
+#include <jank/reload_native.hpp>
+#include <jank/runtime/convert/function.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/obj/keyword.hpp>
+#include <jank/runtime/obj/native_function_wrapper.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
+#include <jank/runtime/rtti.hpp>
+
+namespace jank::reload_native
+{
+  using namespace jank;
+  using namespace jank::runtime;
+
+  static object_ref track()
+  {
+    auto const res{ __rt_ctx->module_reloader.track_loaded_modules() };
+    if(res.is_err())
+    {
+      throw res.expect_err();
+    }
+    return jank_nil();
+  }
+
+  static object_ref reload()
+  {
+    auto const res{ __rt_ctx->module_reloader.reload_changed() };
+    if(res.is_err())
+    {
+      throw res.expect_err();
+    }
+    return res.expect_ok().to_runtime_data();
+  }
+
+  static object_ref watch(object_ref const opts)
+  {
+    auto const kw(
+      [](char const * const name) { return __rt_ctx->intern_keyword(name).expect_ok(); });
+    auto const interval_ms(get(opts, kw("interval-ms")));
+    auto const on_reload(get(opts, kw("on-reload")));
+
+    /* Whatever is loaded now is what we compare against, rather than whatever is on disk
+     * once the watcher gets to it. */
+    track();
+    __rt_ctx->module_reloader.watch(interval_ms.is_nil() ? 500 : to_int(interval_ms),
+                                    on_reload.is_nil() ? jtl::none
+                                                       : jtl::option<object_ref>{ on_reload });
+    return jank_nil();
+  }
+
+  static object_ref unwatch()
+  {
+    __rt_ctx->module_reloader.unwatch();
+    return jank_nil();
+  }
+}
+
+extern "C" void jank_load_jank_reload_native()
+{
+  using namespace jank;
+  using namespace jank::runtime;
+
+  auto const ns(__rt_ctx->intern_ns("jank.reload-native"));
+
+  auto const intern_fn([=](jtl::immutable_string const &name, auto const fn) {
+    ns->intern_var(name)->bind_root(
+      make_box<obj::native_function_wrapper>(convert_function(fn))
+        ->with_meta(obj::persistent_hash_map::create_unique(std::make_pair(
+          __rt_ctx->intern_keyword("name").expect_ok(),
+          make_box(obj::symbol{ __rt_ctx->current_ns()->to_string(), name }.to_string())))));
+  });
+  intern_fn("track!", &reload_native::track);
+  intern_fn("reload!", &reload_native::reload);
+  intern_fn("watch!", &reload_native::watch);
+  intern_fn("unwatch!", &reload_native::unwatch);
+}
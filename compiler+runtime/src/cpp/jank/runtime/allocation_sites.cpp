@@ -0,0 +1,149 @@
+#include <algorithm>
+#include <array>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include <execinfo.h>
+
+#include <jank/runtime/allocation_sites.hpp>
+#include <jank/jit/symbols.hpp>
+
+namespace jank::runtime::allocation_sites
+{
+  namespace detail
+  {
+    /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+    std::atomic<bool> is_tracking{};
+  }
+
+  static constexpr usize max_depth{ 64 };
+
+  struct counts
+  {
+    u64 samples{};
+    u64 sampled_bytes{};
+  };
+
+  /* None of this holds GC memory. */
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+  static std::mutex sites_mutex;
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+  static std::map<std::pair<std::string, object_type>, counts> sites;
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+  static std::atomic<usize> sample_interval{};
+  /* Bumped for each session, so each thread knows to start its count over. */
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+  static std::atomic<u32> session{};
+
+  struct countdown
+  {
+    u32 session{};
+    i64 remaining{};
+  };
+
+  static thread_local countdown bytes_until_sample{};
+  /* Symbolizing can make boxes of its own, which mustn't be sampled in turn. */
+  static thread_local bool is_sampling{};
+
+  /* The nearest JIT compiled frame is the jank fn responsible. The first two frames are
+   * this fn and record. */
+  [[gnu::noinline]]
+  static std::string find_site()
+  {
+    std::array<void *, max_depth> frames{};
+    auto const depth{ static_cast<usize>(backtrace(frames.data(), max_depth)) };
+    for(usize i{ 2 }; i < depth; ++i)
+    {
+      /* These are return addresses, so they point just past the call. */
+      auto const pc{ reinterpret_cast<uintptr_t>(frames[i]) - 1 };
+      if(auto const jitted{ jit::symbols::find(pc) }; jitted.is_some())
+      {
+        return { jitted.unwrap().data(), jitted.unwrap().size() };
+      }
+    }
+
+    if(depth <= 2)
+    {
+      return "unknown";
+    }
+    auto const name{ jit::symbols::describe(reinterpret_cast<uintptr_t>(frames[2]) - 1) };
+    return { name.data(), name.size() };
+  }
+
+  [[gnu::noinline]]
+  void record(object_type const type, usize const size)
+  {
+    auto &countdown{ bytes_until_sample };
+    auto const current{ session.load(std::memory_order_relaxed) };
+    if(countdown.session != current)
+    {
+      countdown = { current, static_cast<i64>(sample_interval.load(std::memory_order_relaxed)) };
+    }
+
+    countdown.remaining -= static_cast<i64>(size);
+    if(0 < countdown.remaining || is_sampling)
+    {
+      return;
+    }
+    countdown.remaining += static_cast<i64>(sample_interval.load(std::memory_order_relaxed));
+
+    is_sampling = true;
+    auto site{ find_site() };
+    is_sampling = false;
+
+    std::lock_guard<std::mutex> const lock{ sites_mutex };
+    auto &c{ sites[{ std::move(site), type }] };
+    ++c.samples;
+    c.sampled_bytes += size;
+  }
+
+  jtl::result<void, jtl::immutable_string> start(usize const interval)
+  {
+    if(interval == 0)
+    {
+      return err("The allocation sample interval must be at least one byte");
+    }
+
+    std::lock_guard<std::mutex> const lock{ sites_mutex };
+    if(detail::is_tracking.load())
+    {
+      return err("Allocations are already being tracked");
+    }
+    sites.clear();
+    sample_interval.store(interval);
+    session.fetch_add(1);
+    detail::is_tracking.store(true);
+    return ok();
+  }
+
+  result stop()
+  {
+    detail::is_tracking.store(false);
+
+    result ret;
+    ret.interval = sample_interval.load();
+    {
+      std::lock_guard<std::mutex> const lock{ sites_mutex };
+      for(auto const &[key, c] : sites)
+      {
+        ret.sites.push_back({
+          jtl::immutable_string{ key.first.data(), key.first.size() },
+          key.second,
+          c.samples,
+          c.sampled_bytes
+        });
+        ret.samples += c.samples;
+      }
+      sites.clear();
+    }
+    std::ranges::sort(ret.sites,
+                      [](auto const &l, auto const &r) { return r.samples < l.samples; });
+    return ret;
+  }
+
+  bool is_tracking()
+  {
+    return detail::is_tracking.load(std::memory_order_relaxed);
+  }
+}
@@ -0,0 +1,68 @@
+#include <cstddef>
+#include <memory>
+#include <new>
+
+#include <gc/gc.h>
+
+#include <jank/runtime/arena.hpp>
+
+namespace jank::runtime
+{
+  namespace detail
+  {
+    /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+    std::atomic<u32> active_arenas{};
+  }
+
+  /* This only points at an arena on the stack, so the GC doesn't need to see it. */
+  static thread_local arena *current_arena{};
+
+  arena::arena()
+    : previous{ current_arena }
+  {
+    current_arena = this;
+    detail::active_arenas.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  arena::~arena()
+  {
+    current_arena = previous;
+    detail::active_arenas.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  void *arena::allocate(usize const size)
+  {
+    /* Keep everything aligned, as the GC would. */
+    auto const aligned_size{ (size + alignof(std::max_align_t) - 1)
+                             & ~(alignof(std::max_align_t) - 1) };
+    if(max_object_size < aligned_size)
+    {
+      auto const ret{ GC_MALLOC(size) };
+      if(!ret)
+      {
+        throw std::bad_alloc{};
+      }
+      return ret;
+    }
+
+    if(remaining < aligned_size)
+    {
+      chunk = static_cast<char *>(GC_MALLOC(chunk_size));
+      if(!chunk)
+      {
+        throw std::bad_alloc{};
+      }
+      remaining = chunk_size;
+    }
+
+    auto const ret{ chunk };
+    chunk += aligned_size;
+    remaining -= aligned_size;
+    return std::assume_aligned<alignof(std::max_align_t)>(ret);
+  }
+
+  arena *arena::current()
+  {
+    return current_arena;
+  }
+}
@@ -1,8 +1,14 @@
+#include <array>
+#include <memory>
+
+#include <folly/Synchronized.h>
+
 #include <jank/runtime/behavior/callable.hpp>
 #include <jank/runtime/behavior/seqable.hpp>
 #include <jank/runtime/visit.hpp>
 #include <jank/runtime/core.hpp>
 #include <jank/runtime/sequence_range.hpp>
+#include <jank/runtime/var.hpp>
 #include <jank/util/make_array.hpp>
 #include <jank/util/fmt.hpp>
 
@@ -19,6 +25,31 @@ namespace jank::runtime
     return source;
   }
 
+  /* Storage for packing rest args on the caller's stack, for variadic arities which keep
+   * them local to the call. Nothing in here is constructed unless it's used, so it costs
+   * nothing otherwise. The GC scans the stack, so the args stay alive for the call. */
+  struct local_rest
+  {
+    template <typename... Args>
+    object_ref pack(callable::arity_flag_t const arity_flags, Args const... args)
+    {
+      if(!callable::has_local_rest(arity_flags))
+      {
+        return make_box<obj::native_array_sequence>(args...);
+      }
+
+      auto const arr(reinterpret_cast<object_ref *>(arg_storage));
+      usize i{};
+      (std::construct_at(arr + i++, args), ...);
+      return std::construct_at(reinterpret_cast<obj::native_array_sequence *>(seq_storage),
+                               arr,
+                               sizeof...(Args));
+    }
+
+    alignas(object_ref) std::byte arg_storage[sizeof(object_ref) * max_params];
+    alignas(obj::native_array_sequence) std::byte seq_storage[sizeof(obj::native_array_sequence)];
+  };
+
   object_ref dynamic_call(object_ref const source)
   {
     auto const processed_source(pass_through_vars(source));
@@ -29,8 +60,9 @@ namespace jank::runtime
         if constexpr(function_like<T> || std::is_base_of_v<callable, T>)
         {
           auto const arity_flags(typed_source->get_arity_flags());
+          auto const mask(callable::extract_variadic_arity_mask(arity_flags));
 
-          switch(arity_flags)
+          switch(mask)
           {
             case callable::mask_variadic_arity(0):
               return typed_source->call(jank_nil());
@@ -58,11 +90,12 @@ namespace jank::runtime
         {
           auto const arity_flags(typed_source->get_arity_flags());
           auto const mask(callable::extract_variadic_arity_mask(arity_flags));
+          local_rest rest_storage;
 
           switch(mask)
           {
             case callable::mask_variadic_arity(0):
-              return typed_source->call(make_box<obj::native_array_sequence>(a1));
+              return typed_source->call(rest_storage.pack(arity_flags, a1));
             case callable::mask_variadic_arity(1):
               if(!callable::is_variadic_ambiguous(arity_flags))
               {
@@ -102,13 +135,14 @@ namespace jank::runtime
         {
           auto const arity_flags(typed_source->get_arity_flags());
           auto const mask(callable::extract_variadic_arity_mask(arity_flags));
+          local_rest rest_storage;
 
           switch(mask)
           {
             case callable::mask_variadic_arity(0):
-              return typed_source->call(make_box<obj::native_array_sequence>(a1, a2));
+              return typed_source->call(rest_storage.pack(arity_flags, a1, a2));
             case callable::mask_variadic_arity(1):
-              return typed_source->call(a1, make_box<obj::native_array_sequence>(a2));
+              return typed_source->call(a1, rest_storage.pack(arity_flags, a2));
             case callable::mask_variadic_arity(2):
               if(!callable::is_variadic_ambiguous(arity_flags))
               {
@@ -148,15 +182,16 @@ namespace jank::runtime
         {
           auto const arity_flags(typed_source->get_arity_flags());
           auto const mask(callable::extract_variadic_arity_mask(arity_flags));
+          local_rest rest_storage;
 
           switch(mask)
           {
             case callable::mask_variadic_arity(0):
-              return typed_source->call(make_box<obj::native_array_sequence>(a1, a2, a3));
+              return typed_source->call(rest_storage.pack(arity_flags, a1, a2, a3));
             case callable::mask_variadic_arity(1):
-              return typed_source->call(a1, make_box<obj::native_array_sequence>(a2, a3));
+              return typed_source->call(a1, rest_storage.pack(arity_flags, a2, a3));
             case callable::mask_variadic_arity(2):
-              return typed_source->call(a1, a2, make_box<obj::native_array_sequence>(a3));
+              return typed_source->call(a1, a2, rest_storage.pack(arity_flags, a3));
             case callable::mask_variadic_arity(3):
               if(!callable::is_variadic_ambiguous(arity_flags))
               {
@@ -190,17 +225,18 @@ namespace jank::runtime
         {
           auto const arity_flags(typed_source->get_arity_flags());
           auto const mask(callable::extract_variadic_arity_mask(arity_flags));
+          local_rest rest_storage;
 
           switch(mask)
           {
             case callable::mask_variadic_arity(0):
-              return typed_source->call(make_box<obj::native_array_sequence>(a1, a2, a3, a4));
+              return typed_source->call(rest_storage.pack(arity_flags, a1, a2, a3, a4));
             case callable::mask_variadic_arity(1):
-              return typed_source->call(a1, make_box<obj::native_array_sequence>(a2, a3, a4));
+              return typed_source->call(a1, rest_storage.pack(arity_flags, a2, a3, a4));
             case callable::mask_variadic_arity(2):
-              return typed_source->call(a1, a2, make_box<obj::native_array_sequence>(a3, a4));
+              return typed_source->call(a1, a2, rest_storage.pack(arity_flags, a3, a4));
             case callable::mask_variadic_arity(3):
-              return typed_source->call(a1, a2, a3, make_box<obj::native_array_sequence>(a4));
+              return typed_source->call(a1, a2, a3, rest_storage.pack(arity_flags, a4));
             case callable::mask_variadic_arity(4):
               if(!callable::is_variadic_ambiguous(arity_flags))
               {
@@ -235,19 +271,20 @@ namespace jank::runtime
         {
           auto const arity_flags(typed_source->get_arity_flags());
           auto const mask(callable::extract_variadic_arity_mask(arity_flags));
+          local_rest rest_storage;
 
           switch(mask)
           {
             case callable::mask_variadic_arity(0):
-              return typed_source->call(make_box<obj::native_array_sequence>(a1, a2, a3, a4, a5));
+              return typed_source->call(rest_storage.pack(arity_flags, a1, a2, a3, a4, a5));
             case callable::mask_variadic_arity(1):
-              return typed_source->call(a1, make_box<obj::native_array_sequence>(a2, a3, a4, a5));
+              return typed_source->call(a1, rest_storage.pack(arity_flags, a2, a3, a4, a5));
             case callable::mask_variadic_arity(2):
-              return typed_source->call(a1, a2, make_box<obj::native_array_sequence>(a3, a4, a5));
+              return typed_source->call(a1, a2, rest_storage.pack(arity_flags, a3, a4, a5));
             case callable::mask_variadic_arity(3):
-              return typed_source->call(a1, a2, a3, make_box<obj::native_array_sequence>(a4, a5));
+              return typed_source->call(a1, a2, a3, rest_storage.pack(arity_flags, a4, a5));
             case callable::mask_variadic_arity(4):
-              return typed_source->call(a1, a2, a3, a4, make_box<obj::native_array_sequence>(a5));
+              return typed_source->call(a1, a2, a3, a4, rest_storage.pack(arity_flags, a5));
             case callable::mask_variadic_arity(5):
               if(!callable::is_variadic_ambiguous(arity_flags))
               {
@@ -283,33 +320,34 @@ namespace jank::runtime
         {
           auto const arity_flags(typed_source->get_arity_flags());
           auto const mask(callable::extract_variadic_arity_mask(arity_flags));
+          local_rest rest_storage;
 
           switch(mask)
           {
             case callable::mask_variadic_arity(0):
               return typed_source->call(
-                make_box<obj::native_array_sequence>(a1, a2, a3, a4, a5, a6));
+                rest_storage.pack(arity_flags, a1, a2, a3, a4, a5, a6));
             case callable::mask_variadic_arity(1):
               return typed_source->call(a1,
-                                        make_box<obj::native_array_sequence>(a2, a3, a4, a5, a6));
+                                        rest_storage.pack(arity_flags, a2, a3, a4, a5, a6));
             case callable::mask_variadic_arity(2):
               return typed_source->call(a1,
                                         a2,
-                                        make_box<obj::native_array_sequence>(a3, a4, a5, a6));
+                                        rest_storage.pack(arity_flags, a3, a4, a5, a6));
             case callable::mask_variadic_arity(3):
               return typed_source->call(a1,
                                         a2,
                                         a3,
-                                        make_box<obj::native_array_sequence>(a4, a5, a6));
+                                        rest_storage.pack(arity_flags, a4, a5, a6));
             case callable::mask_variadic_arity(4):
               return typed_source->call(a1,
                                         a2,
                                         a3,
                                         a4,
-                                        make_box<obj::native_array_sequence>(a5, a6));
+                                        rest_storage.pack(arity_flags, a5, a6));
             case callable::mask_variadic_arity(5):
               return typed_source
-                ->call(a1, a2, a3, a4, a5, make_box<obj::native_array_sequence>(a6));
+                ->call(a1, a2, a3, a4, a5, rest_storage.pack(arity_flags, a6));
             case callable::mask_variadic_arity(6):
               if(!callable::is_variadic_ambiguous(arity_flags))
               {
@@ -346,37 +384,38 @@ namespace jank::runtime
         {
           auto const arity_flags(typed_source->get_arity_flags());
           auto const mask(callable::extract_variadic_arity_mask(arity_flags));
+          local_rest rest_storage;
 
           switch(mask)
           {
             case callable::mask_variadic_arity(0):
               return typed_source->call(
-                make_box<obj::native_array_sequence>(a1, a2, a3, a4, a5, a6, a7));
+                rest_storage.pack(arity_flags, a1, a2, a3, a4, a5, a6, a7));
             case callable::mask_variadic_arity(1):
               return typed_source->call(
                 a1,
-                make_box<obj::native_array_sequence>(a2, a3, a4, a5, a6, a7));
+                rest_storage.pack(arity_flags, a2, a3, a4, a5, a6, a7));
             case callable::mask_variadic_arity(2):
               return typed_source->call(a1,
                                         a2,
-                                        make_box<obj::native_array_sequence>(a3, a4, a5, a6, a7));
+                                        rest_storage.pack(arity_flags, a3, a4, a5, a6, a7));
             case callable::mask_variadic_arity(3):
               return typed_source->call(a1,
                                         a2,
                                         a3,
-                                        make_box<obj::native_array_sequence>(a4, a5, a6, a7));
+                                        rest_storage.pack(arity_flags, a4, a5, a6, a7));
             case callable::mask_variadic_arity(4):
               return typed_source->call(a1,
                                         a2,
                                         a3,
                                         a4,
-                                        make_box<obj::native_array_sequence>(a5, a6, a7));
+                                        rest_storage.pack(arity_flags, a5, a6, a7));
             case callable::mask_variadic_arity(5):
               return typed_source
-                ->call(a1, a2, a3, a4, a5, make_box<obj::native_array_sequence>(a6, a7));
+                ->call(a1, a2, a3, a4, a5, rest_storage.pack(arity_flags, a6, a7));
             case callable::mask_variadic_arity(6):
               return typed_source
-                ->call(a1, a2, a3, a4, a5, a6, make_box<obj::native_array_sequence>(a7));
+                ->call(a1, a2, a3, a4, a5, a6, rest_storage.pack(arity_flags, a7));
             case callable::mask_variadic_arity(7):
               if(!callable::is_variadic_ambiguous(arity_flags))
               {
@@ -414,41 +453,42 @@ namespace jank::runtime
         {
           auto const arity_flags(typed_source->get_arity_flags());
           auto const mask(callable::extract_variadic_arity_mask(arity_flags));
+          local_rest rest_storage;
 
           switch(mask)
           {
             case callable::mask_variadic_arity(0):
               return typed_source->call(
-                make_box<obj::native_array_sequence>(a1, a2, a3, a4, a5, a6, a7, a8));
+                rest_storage.pack(arity_flags, a1, a2, a3, a4, a5, a6, a7, a8));
             case callable::mask_variadic_arity(1):
               return typed_source->call(
                 a1,
-                make_box<obj::native_array_sequence>(a2, a3, a4, a5, a6, a7, a8));
+                rest_storage.pack(arity_flags, a2, a3, a4, a5, a6, a7, a8));
             case callable::mask_variadic_arity(2):
               return typed_source->call(
                 a1,
                 a2,
-                make_box<obj::native_array_sequence>(a3, a4, a5, a6, a7, a8));
+                rest_storage.pack(arity_flags, a3, a4, a5, a6, a7, a8));
             case callable::mask_variadic_arity(3):
               return typed_source->call(a1,
                                         a2,
                                         a3,
-                                        make_box<obj::native_array_sequence>(a4, a5, a6, a7, a8));
+                                        rest_storage.pack(arity_flags, a4, a5, a6, a7, a8));
             case callable::mask_variadic_arity(4):
               return typed_source->call(a1,
                                         a2,
                                         a3,
                                         a4,
-                                        make_box<obj::native_array_sequence>(a5, a6, a7, a8));
+                                        rest_storage.pack(arity_flags, a5, a6, a7, a8));
             case callable::mask_variadic_arity(5):
               return typed_source
-                ->call(a1, a2, a3, a4, a5, make_box<obj::native_array_sequence>(a6, a7, a8));
+                ->call(a1, a2, a3, a4, a5, rest_storage.pack(arity_flags, a6, a7, a8));
             case callable::mask_variadic_arity(6):
               return typed_source
-                ->call(a1, a2, a3, a4, a5, a6, make_box<obj::native_array_sequence>(a7, a8));
+                ->call(a1, a2, a3, a4, a5, a6, rest_storage.pack(arity_flags, a7, a8));
             case callable::mask_variadic_arity(7):
               return typed_source
-                ->call(a1, a2, a3, a4, a5, a6, a7, make_box<obj::native_array_sequence>(a8));
+                ->call(a1, a2, a3, a4, a5, a6, a7, rest_storage.pack(arity_flags, a8));
             case callable::mask_variadic_arity(8):
               if(!callable::is_variadic_ambiguous(arity_flags))
               {
@@ -487,42 +527,43 @@ namespace jank::runtime
         {
           auto const arity_flags(typed_source->get_arity_flags());
           auto const mask(callable::extract_variadic_arity_mask(arity_flags));
+          local_rest rest_storage;
 
           switch(mask)
           {
             case callable::mask_variadic_arity(0):
               return typed_source->call(
-                make_box<obj::native_array_sequence>(a1, a2, a3, a4, a5, a6, a7, a8, a9));
+                rest_storage.pack(arity_flags, a1, a2, a3, a4, a5, a6, a7, a8, a9));
             case callable::mask_variadic_arity(1):
               return typed_source->call(
                 a1,
-                make_box<obj::native_array_sequence>(a2, a3, a4, a5, a6, a7, a8, a9));
+                rest_storage.pack(arity_flags, a2, a3, a4, a5, a6, a7, a8, a9));
             case callable::mask_variadic_arity(2):
               return typed_source->call(
                 a1,
                 a2,
-                make_box<obj::native_array_sequence>(a3, a4, a5, a6, a7, a8, a9));
+                rest_storage.pack(arity_flags, a3, a4, a5, a6, a7, a8, a9));
             case callable::mask_variadic_arity(3):
               return typed_source
-                ->call(a1, a2, a3, make_box<obj::native_array_sequence>(a4, a5, a6, a7, a8, a9));
+                ->call(a1, a2, a3, rest_storage.pack(arity_flags, a4, a5, a6, a7, a8, a9));
             case callable::mask_variadic_arity(4):
               return typed_source->call(a1,
                                         a2,
                                         a3,
                                         a4,
-                                        make_box<obj::native_array_sequence>(a5, a6, a7, a8, a9));
+                                        rest_storage.pack(arity_flags, a5, a6, a7, a8, a9));
             case callable::mask_variadic_arity(5):
               return typed_source
-                ->call(a1, a2, a3, a4, a5, make_box<obj::native_array_sequence>(a6, a7, a8, a9));
+                ->call(a1, a2, a3, a4, a5, rest_storage.pack(arity_flags, a6, a7, a8, a9));
             case callable::mask_variadic_arity(6):
               return typed_source
-                ->call(a1, a2, a3, a4, a5, a6, make_box<obj::native_array_sequence>(a7, a8, a9));
+                ->call(a1, a2, a3, a4, a5, a6, rest_storage.pack(arity_flags, a7, a8, a9));
             case callable::mask_variadic_arity(7):
               return typed_source
-                ->call(a1, a2, a3, a4, a5, a6, a7, make_box<obj::native_array_sequence>(a8, a9));
+                ->call(a1, a2, a3, a4, a5, a6, a7, rest_storage.pack(arity_flags, a8, a9));
             case callable::mask_variadic_arity(8):
               return typed_source
-                ->call(a1, a2, a3, a4, a5, a6, a7, a8, make_box<obj::native_array_sequence>(a9));
+                ->call(a1, a2, a3, a4, a5, a6, a7, a8, rest_storage.pack(arity_flags, a9));
             case callable::mask_variadic_arity(9):
               if(!callable::is_variadic_ambiguous(arity_flags))
               {
@@ -562,41 +603,42 @@ namespace jank::runtime
         {
           auto const arity_flags(typed_source->get_arity_flags());
           auto const mask(callable::extract_variadic_arity_mask(arity_flags));
+          local_rest rest_storage;
 
           switch(mask)
           {
             case callable::mask_variadic_arity(0):
               return typed_source->call(
-                make_box<obj::native_array_sequence>(a1, a2, a3, a4, a5, a6, a7, a8, a9, a10));
+                rest_storage.pack(arity_flags, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10));
             case callable::mask_variadic_arity(1):
               return typed_source->call(
                 a1,
-                make_box<obj::native_array_sequence>(a2, a3, a4, a5, a6, a7, a8, a9, a10));
+                rest_storage.pack(arity_flags, a2, a3, a4, a5, a6, a7, a8, a9, a10));
             case callable::mask_variadic_arity(2):
               return typed_source->call(
                 a1,
                 a2,
-                make_box<obj::native_array_sequence>(a3, a4, a5, a6, a7, a8, a9, a10));
+                rest_storage.pack(arity_flags, a3, a4, a5, a6, a7, a8, a9, a10));
             case callable::mask_variadic_arity(3):
               return typed_source->call(
                 a1,
                 a2,
                 a3,
-                make_box<obj::native_array_sequence>(a4, a5, a6, a7, a8, a9, a10));
+                rest_storage.pack(arity_flags, a4, a5, a6, a7, a8, a9, a10));
             case callable::mask_variadic_arity(4):
               return typed_source->call(
                 a1,
                 a2,
                 a3,
                 a4,
-                make_box<obj::native_array_sequence>(a5, a6, a7, a8, a9, a10));
+                rest_storage.pack(arity_flags, a5, a6, a7, a8, a9, a10));
             case callable::mask_variadic_arity(5):
               return typed_source->call(a1,
                                         a2,
                                         a3,
                                         a4,
                                         a5,
-                                        make_box<obj::native_array_sequence>(a6, a7, a8, a9, a10));
+                                        rest_storage.pack(arity_flags, a6, a7, a8, a9, a10));
             case callable::mask_variadic_arity(6):
               return typed_source->call(a1,
                                         a2,
@@ -604,7 +646,7 @@ namespace jank::runtime
                                         a4,
                                         a5,
                                         a6,
-                                        make_box<obj::native_array_sequence>(a7, a8, a9, a10));
+                                        rest_storage.pack(arity_flags, a7, a8, a9, a10));
             case callable::mask_variadic_arity(7):
               return typed_source->call(a1,
                                         a2,
@@ -613,7 +655,7 @@ namespace jank::runtime
                                         a5,
                                         a6,
                                         a7,
-                                        make_box<obj::native_array_sequence>(a8, a9, a10));
+                                        rest_storage.pack(arity_flags, a8, a9, a10));
             case callable::mask_variadic_arity(8):
               return typed_source->call(a1,
                                         a2,
@@ -623,7 +665,7 @@ namespace jank::runtime
                                         a6,
                                         a7,
                                         a8,
-                                        make_box<obj::native_array_sequence>(a9, a10));
+                                        rest_storage.pack(arity_flags, a9, a10));
             case callable::mask_variadic_arity(9):
               return typed_source->call(a1,
                                         a2,
@@ -634,7 +676,7 @@ namespace jank::runtime
                                         a7,
                                         a8,
                                         a9,
-                                        make_box<obj::native_array_sequence>(a10));
+                                        rest_storage.pack(arity_flags, a10));
             case callable::mask_variadic_arity(10):
               if(!callable::is_variadic_ambiguous(arity_flags))
               {
@@ -647,7 +689,7 @@ namespace jank::runtime
                                           a7,
                                           a8,
                                           a9,
-                                          make_box<obj::native_array_sequence>(a10));
+                                          rest_storage.pack(arity_flags, a10));
               }
             default:
               return typed_source->call(a1, a2, a3, a4, a5, a6, a7, a8, a9, a10);
@@ -827,147 +869,236 @@ namespace jank::runtime
       processed_source);
   }
 
-  object_ref apply_to(object_ref const source, object_ref const args)
+  /* The args from offset onward, as a seq over the collection's own storage where it has
+   * some, rather than a copy of them. Otherwise, this is a fresh seq stepped in place. */
+  static object_ref args_from(object_ref const args, usize const offset)
   {
+    auto const stepped([=]() {
+      auto rest(fresh_seq(args));
+      for(usize i{}; i < offset; ++i)
+      {
+        rest = next_in_place(rest);
+      }
+      return rest;
+    });
+
     return visit_seqable(
       [=](auto const typed_args) -> object_ref {
-        auto const s(typed_args->fresh_seq());
-        auto const length(sequence_length(s, max_params + 1));
-        auto const r{ make_sequence_range(s) };
-        auto it{ r.begin() };
-
-        /* XXX: It's UB to have multiple *(++it) in one expression, since the order in
-         * which they will run is not defined. This requires us to pull out all of the
-         * args into locals. */
-        switch(length)
+        using T = typename jtl::decay_t<decltype(typed_args)>::value_type;
+
+        if constexpr(std::same_as<T, obj::persistent_vector>)
+        {
+          return make_box<obj::persistent_vector_sequence>(typed_args, offset);
+        }
+        else if constexpr(std::same_as<T, obj::persistent_vector_sequence>)
+        {
+          return make_box<obj::persistent_vector_sequence>(typed_args->vec,
+                                                           typed_args->index + offset);
+        }
+        else if constexpr(std::same_as<T, obj::native_array_sequence>)
+        {
+          return make_box<obj::native_array_sequence>(typed_args->arr.data,
+                                                      typed_args->index + offset,
+                                                      typed_args->size);
+        }
+        else if constexpr(std::same_as<T, obj::array>)
+        {
+          /* Like a Clojure ArraySeq, this sees any later writes to the array. */
+          if(typed_args->element == obj::array::element_type::object)
+          {
+            return make_box<obj::native_array_sequence>(typed_args->template data_as<object_ref>(),
+                                                        offset,
+                                                        typed_args->length);
+          }
+          return stepped();
+        }
+        else
         {
-          case 0:
-            return dynamic_call(source);
-          case 1:
-            {
-              auto const a1{ *it };
-              return dynamic_call(source, a1);
-            }
-          case 2:
-            {
-              auto const a1{ *it };
-              auto const a2{ *(++it) };
-              return dynamic_call(source, a1, a2);
-            }
-          case 3:
-            {
-              auto const a1{ *it };
-              auto const a2{ *(++it) };
-              auto const a3{ *(++it) };
-              return dynamic_call(source, a1, a2, a3);
-            }
-          case 4:
-            {
-              auto const a1{ *it };
-              auto const a2{ *(++it) };
-              auto const a3{ *(++it) };
-              auto const a4{ *(++it) };
-              return dynamic_call(source, a1, a2, a3, a4);
-            }
-          case 5:
-            {
-              auto const a1{ *it };
-              auto const a2{ *(++it) };
-              auto const a3{ *(++it) };
-              auto const a4{ *(++it) };
-              auto const a5{ *(++it) };
-              return dynamic_call(source, a1, a2, a3, a4, a5);
-            }
-          case 6:
-            {
-              auto const a1{ *it };
-              auto const a2{ *(++it) };
-              auto const a3{ *(++it) };
-              auto const a4{ *(++it) };
-              auto const a5{ *(++it) };
-              auto const a6{ *(++it) };
-              return dynamic_call(source, a1, a2, a3, a4, a5, a6);
-            }
-          case 7:
-            {
-              auto const a1{ *it };
-              auto const a2{ *(++it) };
-              auto const a3{ *(++it) };
-              auto const a4{ *(++it) };
-              auto const a5{ *(++it) };
-              auto const a6{ *(++it) };
-              auto const a7{ *(++it) };
-              return dynamic_call(source, a1, a2, a3, a4, a5, a6, a7);
-            }
-          case 8:
-            {
-              auto const a1{ *it };
-              auto const a2{ *(++it) };
-              auto const a3{ *(++it) };
-              auto const a4{ *(++it) };
-              auto const a5{ *(++it) };
-              auto const a6{ *(++it) };
-              auto const a7{ *(++it) };
-              auto const a8{ *(++it) };
-              return dynamic_call(source, a1, a2, a3, a4, a5, a6, a7, a8);
-            }
-          case 9:
-            {
-              auto const a1{ *it };
-              auto const a2{ *(++it) };
-              auto const a3{ *(++it) };
-              auto const a4{ *(++it) };
-              auto const a5{ *(++it) };
-              auto const a6{ *(++it) };
-              auto const a7{ *(++it) };
-              auto const a8{ *(++it) };
-              auto const a9{ *(++it) };
-              return dynamic_call(source, a1, a2, a3, a4, a5, a6, a7, a8, a9);
-            }
-          case 10:
-            {
-              auto const a1{ *it };
-              auto const a2{ *(++it) };
-              auto const a3{ *(++it) };
-              auto const a4{ *(++it) };
-              auto const a5{ *(++it) };
-              auto const a6{ *(++it) };
-              auto const a7{ *(++it) };
-              auto const a8{ *(++it) };
-              auto const a9{ *(++it) };
-              auto const a10{ *(++it) };
-              return dynamic_call(source, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10);
-            }
-          default:
-            {
-              auto const a1{ *it };
-              auto const a2{ *(++it) };
-              auto const a3{ *(++it) };
-              auto const a4{ *(++it) };
-              auto const a5{ *(++it) };
-              auto const a6{ *(++it) };
-              auto const a7{ *(++it) };
-              auto const a8{ *(++it) };
-              auto const a9{ *(++it) };
-              auto const a10{ *(++it) };
-              return dynamic_call(source,
-                                  a1,
-                                  a2,
-                                  a3,
-                                  a4,
-                                  a5,
-                                  a6,
-                                  a7,
-                                  a8,
-                                  a9,
-                                  a10,
-                                  obj::persistent_list::create((++it).data));
-            }
+          return stepped();
         }
       },
       args);
   }
 
+  /* For calls with more than max_params args, which can only go to a variadic arity. The
+   * variadic args are given as a view of the rest of the collection, where possible,
+   * rather than being copied out into a list and then again into a vector. Only the
+   * prefix args which land within the variadic args need to be consed on. */
+  static object_ref apply_variadic(object_ref const source,
+                                   std::array<object_ref, max_params> const &a,
+                                   usize const prefix,
+                                   object_ref const args)
+  {
+    auto const rest([&](usize const pos) -> object_ref {
+      if(prefix <= pos)
+      {
+        return args_from(args, pos - prefix);
+      }
+
+      object_ref ret{ args };
+      for(auto i{ prefix }; pos < i; --i)
+      {
+        ret = make_box<obj::cons>(a[i - 1], ret);
+      }
+      return ret;
+    });
+
+    auto const processed_source(pass_through_vars(source));
+    return visit_object(
+      [&](auto const typed_source) -> object_ref {
+        using T = typename jtl::decay_t<decltype(typed_source)>::value_type;
+
+        if constexpr(function_like<T> || std::is_base_of_v<callable, T>)
+        {
+          auto const arity_flags(typed_source->get_arity_flags());
+          auto const mask(callable::extract_variadic_arity_mask(arity_flags));
+          switch(mask)
+          {
+            case callable::mask_variadic_arity(0):
+              return typed_source->call(rest(0));
+            case callable::mask_variadic_arity(1):
+              return typed_source->call(a[0], rest(1));
+            case callable::mask_variadic_arity(2):
+              return typed_source->call(a[0], a[1], rest(2));
+            case callable::mask_variadic_arity(3):
+              return typed_source->call(a[0], a[1], a[2], rest(3));
+            case callable::mask_variadic_arity(4):
+              return typed_source->call(a[0], a[1], a[2], a[3], rest(4));
+            case callable::mask_variadic_arity(5):
+              return typed_source->call(a[0], a[1], a[2], a[3], a[4], rest(5));
+            case callable::mask_variadic_arity(6):
+              return typed_source->call(a[0], a[1], a[2], a[3], a[4], a[5], rest(6));
+            case callable::mask_variadic_arity(7):
+              return typed_source->call(a[0], a[1], a[2], a[3], a[4], a[5], a[6], rest(7));
+            case callable::mask_variadic_arity(8):
+              return typed_source
+                ->call(a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7], rest(8));
+            case callable::mask_variadic_arity(9):
+              return typed_source
+                ->call(a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7], a[8], rest(9));
+            default:
+              throw std::runtime_error{ util::format("unsupported arity: {}",
+                                                     prefix + sequence_length(args)) };
+          }
+        }
+        else
+        {
+          throw std::runtime_error{ util::format("invalid call with {} args to: {}",
+                                                 prefix + sequence_length(args),
+                                                 typed_source->to_code_string()) };
+        }
+      },
+      processed_source);
+  }
+
+  /* The first prefix args are already in a. The rest are pulled straight out of the
+   * collection, without making a seq, unless it needs one anyway. Only a call with more
+   * args than max_params needs a seq for the rest. */
+  static object_ref apply_prefixed(object_ref const source,
+                                   std::array<object_ref, max_params> &a,
+                                   usize const prefix,
+                                   object_ref const args)
+  {
+    usize length{ prefix };
+    auto const all(for_each_item(args, [&](object_ref const o) {
+      if(length == max_params)
+      {
+        return false;
+      }
+      a[length++] = o;
+      return true;
+    }));
+
+    if(!all)
+    {
+      return apply_variadic(source, a, prefix, args);
+    }
+
+    switch(length)
+    {
+      case 0:
+        return dynamic_call(source);
+      case 1:
+        return dynamic_call(source, a[0]);
+      case 2:
+        return dynamic_call(source, a[0], a[1]);
+      case 3:
+        return dynamic_call(source, a[0], a[1], a[2]);
+      case 4:
+        return dynamic_call(source, a[0], a[1], a[2], a[3]);
+      case 5:
+        return dynamic_call(source, a[0], a[1], a[2], a[3], a[4]);
+      case 6:
+        return dynamic_call(source, a[0], a[1], a[2], a[3], a[4], a[5]);
+      case 7:
+        return dynamic_call(source, a[0], a[1], a[2], a[3], a[4], a[5], a[6]);
+      case 8:
+        return dynamic_call(source, a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7]);
+      case 9:
+        return dynamic_call(source, a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7], a[8]);
+      default:
+        return dynamic_call(source, a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7], a[8], a[9]);
+    }
+  }
+
+  object_ref apply_to(object_ref const source, object_ref const args)
+  {
+    std::array<object_ref, max_params> a{};
+    return apply_prefixed(source, a, 0, args);
+  }
+
+  object_ref apply_to(object_ref const source, object_ref const a1, object_ref const args)
+  {
+    std::array<object_ref, max_params> a{ a1 };
+    return apply_prefixed(source, a, 1, args);
+  }
+
+  object_ref
+  apply_to(object_ref const source, object_ref const a1, object_ref const a2, object_ref const args)
+  {
+    std::array<object_ref, max_params> a{ a1, a2 };
+    return apply_prefixed(source, a, 2, args);
+  }
+
+  object_ref apply_to(object_ref const source,
+                      object_ref const a1,
+                      object_ref const a2,
+                      object_ref const a3,
+                      object_ref const args)
+  {
+    std::array<object_ref, max_params> a{ a1, a2, a3 };
+    return apply_prefixed(source, a, 3, args);
+  }
+
+  /* Direct linked code holds onto its fns from memory which the GC doesn't scan, such as
+   * JIT compiled statics. Those fns need to outlive any redefinition of their vars, so we
+   * keep each one reachable from here. Every call site links on its own, so each root is
+   * only kept once. */
+  /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+  static folly::Synchronized<native_set<object *>> direct_linked_roots;
+
+  callable_ref direct_link(var_ref const var)
+  {
+    auto const root(var->get_root());
+    return visit_object(
+      [=](auto const typed_root) -> callable_ref {
+        using T = typename jtl::decay_t<decltype(typed_root)>::value_type;
+
+        if constexpr(std::is_base_of_v<callable, T>)
+        {
+          direct_linked_roots.wlock()->insert(root.data);
+          return &*typed_root;
+        }
+        else
+        {
+          throw std::runtime_error{ util::format("unable to direct link to {}, since it holds {}",
+                                                 var->to_string(),
+                                                 typed_root->to_code_string()) };
+        }
+      },
+      root);
+  }
+
   namespace behavior
   {
     object_ref callable::call()
@@ -0,0 +1,323 @@
+#include <algorithm>
+#include <utility>
+
+#include <jank/runtime/behavior_table.hpp>
+#include <jank/runtime/visit.hpp>
+
+namespace jank::runtime
+{
+  /* Each of these gives null when T doesn't have the behavior. Captureless lambdas can be
+   * turned into function pointers in a constant expression, which keeps the tables constant
+   * initialized. */
+
+  template <typename T>
+  constexpr auto seq_of()
+  {
+    using fn = object_ref (*)(object *);
+    if constexpr(std::same_as<T, obj::nil>)
+    {
+      return fn{ [](object * const o) -> object_ref { return o; } };
+    }
+    else if constexpr(behavior::seqable<T>)
+    {
+      return fn{ [](object * const o) -> object_ref { return expect_object<T>(o)->seq(); } };
+    }
+    else
+    {
+      return fn{};
+    }
+  }
+
+  template <typename T>
+  constexpr auto fresh_seq_of()
+  {
+    using fn = object_ref (*)(object *);
+    if constexpr(std::same_as<T, obj::nil>)
+    {
+      return fn{ [](object * const o) -> object_ref { return o; } };
+    }
+    else if constexpr(behavior::seqable<T>)
+    {
+      return fn{ [](object * const o) -> object_ref { return expect_object<T>(o)->fresh_seq(); } };
+    }
+    else
+    {
+      return fn{};
+    }
+  }
+
+  template <typename T>
+  constexpr auto count_of()
+  {
+    using fn = usize (*)(object *);
+    if constexpr(std::same_as<T, obj::nil>)
+    {
+      return fn{ [](object *) -> usize { return 0; } };
+    }
+    else if constexpr(behavior::countable<T>)
+    {
+      return fn{ [](object * const o) -> usize { return expect_object<T>(o)->count(); } };
+    }
+    else
+    {
+      return fn{};
+    }
+  }
+
+  template <typename T>
+  constexpr auto get_of()
+  {
+    using fn = object_ref (*)(object *, object_ref);
+    if constexpr(behavior::associatively_readable<T>)
+    {
+      return fn{ [](object * const o, object_ref const key) -> object_ref {
+        return expect_object<T>(o)->get(key);
+      } };
+    }
+    else
+    {
+      return fn{};
+    }
+  }
+
+  template <typename T>
+  constexpr auto get_default_of()
+  {
+    using fn = object_ref (*)(object *, object_ref, object_ref);
+    if constexpr(behavior::associatively_readable<T>)
+    {
+      return fn{ [](object * const o, object_ref const key, object_ref const fallback) -> object_ref {
+        return expect_object<T>(o)->get(key, fallback);
+      } };
+    }
+    else
+    {
+      return fn{};
+    }
+  }
+
+  template <typename T>
+  constexpr behavior_table table_of{
+    .to_hash = [](object * const o) -> uhash { return expect_object<T>(o)->to_hash(); },
+    .equal
+    = [](object * const o, object const &rhs) -> bool { return expect_object<T>(o)->equal(rhs); },
+    .to_string
+    = [](object * const o, jtl::string_builder &buff) { expect_object<T>(o)->to_string(buff); },
+    .to_code_string =
+      [](object * const o, jtl::string_builder &buff) {
+        auto const typed_o{ expect_object<T>(o) };
+        if constexpr(requires { typed_o->to_code_string(buff); })
+        {
+          typed_o->to_code_string(buff);
+        }
+        else
+        {
+          buff(typed_o->to_code_string());
+        }
+      },
+    .seq = seq_of<T>(),
+    .fresh_seq = fresh_seq_of<T>(),
+    .count = count_of<T>(),
+    .get = get_of<T>(),
+    .get_default = get_default_of<T>(),
+  };
+
+  /* This must list the same types as visit_object. Any type left out here hits the static
+   * assert below, since its table would be empty. */
+  static constexpr behavior_table table_for(object_type const type)
+  {
+    switch(type)
+    {
+      case object_type::nil:
+        return table_of<obj::nil>;
+      case object_type::boolean:
+        return table_of<obj::boolean>;
+      case object_type::integer:
+        return table_of<obj::integer>;
+      case object_type::big_integer:
+        return table_of<obj::big_integer>;
+      case object_type::big_decimal:
+        return table_of<obj::big_decimal>;
+      case object_type::real:
+        return table_of<obj::real>;
+      case object_type::persistent_string:
+        return table_of<obj::persistent_string>;
+      case object_type::keyword:
+        return table_of<obj::keyword>;
+      case object_type::symbol:
+        return table_of<obj::symbol>;
+      case object_type::character:
+        return table_of<obj::character>;
+      case object_type::persistent_vector:
+        return table_of<obj::persistent_vector>;
+      case object_type::persistent_list:
+        return table_of<obj::persistent_list>;
+      case object_type::persistent_array_map:
+        return table_of<obj::persistent_array_map>;
+      case object_type::persistent_array_map_sequence:
+        return table_of<obj::persistent_array_map_sequence>;
+      case object_type::transient_array_map:
+        return table_of<obj::transient_array_map>;
+      case object_type::persistent_hash_map:
+        return table_of<obj::persistent_hash_map>;
+      case object_type::persistent_hash_map_sequence:
+        return table_of<obj::persistent_hash_map_sequence>;
+      case object_type::persistent_sorted_map:
+        return table_of<obj::persistent_sorted_map>;
+      case object_type::persistent_sorted_map_sequence:
+        return table_of<obj::persistent_sorted_map_sequence>;
+      case object_type::persistent_int_map:
+        return table_of<obj::persistent_int_map>;
+      case object_type::transient_int_map:
+        return table_of<obj::transient_int_map>;
+      case object_type::persistent_int_map_sequence:
+        return table_of<obj::persistent_int_map_sequence>;
+      case object_type::mapped_map:
+        return table_of<obj::mapped_map>;
+      case object_type::mapped_map_sequence:
+        return table_of<obj::mapped_map_sequence>;
+      case object_type::struct_basis:
+        return table_of<obj::struct_basis>;
+      case object_type::persistent_struct_map:
+        return table_of<obj::persistent_struct_map>;
+      case object_type::persistent_struct_map_sequence:
+        return table_of<obj::persistent_struct_map_sequence>;
+      case object_type::transient_hash_map:
+        return table_of<obj::transient_hash_map>;
+      case object_type::transient_sorted_map:
+        return table_of<obj::transient_sorted_map>;
+      case object_type::transient_vector:
+        return table_of<obj::transient_vector>;
+      case object_type::persistent_hash_set:
+        return table_of<obj::persistent_hash_set>;
+      case object_type::persistent_sorted_set:
+        return table_of<obj::persistent_sorted_set>;
+      case object_type::transient_hash_set:
+        return table_of<obj::transient_hash_set>;
+      case object_type::transient_sorted_set:
+        return table_of<obj::transient_sorted_set>;
+      case object_type::array:
+        return table_of<obj::array>;
+      case object_type::column_table:
+        return table_of<obj::column_table>;
+      case object_type::column_table_sequence:
+        return table_of<obj::column_table_sequence>;
+      case object_type::cons:
+        return table_of<obj::cons>;
+      case object_type::range:
+        return table_of<obj::range>;
+      case object_type::integer_range:
+        return table_of<obj::integer_range>;
+      case object_type::repeat:
+        return table_of<obj::repeat>;
+      case object_type::ratio:
+        return table_of<obj::ratio>;
+      case object_type::native_array_sequence:
+        return table_of<obj::native_array_sequence>;
+      case object_type::native_vector_sequence:
+        return table_of<obj::native_vector_sequence>;
+      case object_type::persistent_string_sequence:
+        return table_of<obj::persistent_string_sequence>;
+      case object_type::persistent_vector_sequence:
+        return table_of<obj::persistent_vector_sequence>;
+      case object_type::primitive_vector:
+        return table_of<obj::primitive_vector>;
+      case object_type::primitive_vector_sequence:
+        return table_of<obj::primitive_vector_sequence>;
+      case object_type::mapped_vector:
+        return table_of<obj::mapped_vector>;
+      case object_type::mapped_vector_sequence:
+        return table_of<obj::mapped_vector_sequence>;
+      case object_type::persistent_hash_set_sequence:
+        return table_of<obj::persistent_hash_set_sequence>;
+      case object_type::persistent_sorted_set_sequence:
+        return table_of<obj::persistent_sorted_set_sequence>;
+      case object_type::iterator:
+        return table_of<obj::iterator>;
+      case object_type::cycle:
+        return table_of<obj::cycle>;
+      case object_type::lazy_sequence:
+        return table_of<obj::lazy_sequence>;
+      case object_type::chunk_buffer:
+        return table_of<obj::chunk_buffer>;
+      case object_type::array_chunk:
+        return table_of<obj::array_chunk>;
+      case object_type::chunked_cons:
+        return table_of<obj::chunked_cons>;
+      case object_type::native_function_wrapper:
+        return table_of<obj::native_function_wrapper>;
+      case object_type::native_pointer_wrapper:
+        return table_of<obj::native_pointer_wrapper>;
+      case object_type::jit_function:
+        return table_of<obj::jit_function>;
+      case object_type::jit_closure:
+        return table_of<obj::jit_closure>;
+      case object_type::multi_function:
+        return table_of<obj::multi_function>;
+      case object_type::protocol:
+        return table_of<obj::protocol>;
+      case object_type::protocol_method:
+        return table_of<obj::protocol_method>;
+      case object_type::atom:
+        return table_of<obj::atom>;
+      case object_type::volatile_:
+        return table_of<obj::volatile_>;
+      case object_type::reduced:
+        return table_of<obj::reduced>;
+      case object_type::delay:
+        return table_of<obj::delay>;
+      case object_type::future:
+        return table_of<obj::future>;
+      case object_type::promise:
+        return table_of<obj::promise>;
+      case object_type::agent:
+        return table_of<obj::agent>;
+      case object_type::ref:
+        return table_of<obj::ref>;
+      case object_type::channel:
+        return table_of<obj::channel>;
+      case object_type::counter_atom:
+        return table_of<obj::counter_atom>;
+      case object_type::cache:
+        return table_of<obj::cache>;
+      case object_type::eduction:
+        return table_of<obj::eduction>;
+      case object_type::ns:
+        return table_of<ns>;
+      case object_type::var:
+        return table_of<var>;
+      case object_type::var_thread_binding:
+        return table_of<var_thread_binding>;
+      case object_type::var_unbound_root:
+        return table_of<var_unbound_root>;
+      case object_type::tagged_literal:
+        return table_of<obj::tagged_literal>;
+      case object_type::re_pattern:
+        return table_of<obj::re_pattern>;
+      case object_type::re_matcher:
+        return table_of<obj::re_matcher>;
+      case object_type::uuid:
+        return table_of<obj::uuid>;
+      case object_type::inst:
+        return table_of<obj::inst>;
+      case object_type::opaque_box:
+        return table_of<obj::opaque_box>;
+    }
+    return {};
+  }
+
+  template <usize... I>
+  static constexpr std::array<behavior_table, object_type_count>
+  make_behavior_tables(std::index_sequence<I...>)
+  {
+    return { table_for(static_cast<object_type>(I))... };
+  }
+
+  static constexpr auto tables{ make_behavior_tables(
+    std::make_index_sequence<object_type_count>{}) };
+
+  static_assert(
+    std::ranges::all_of(tables, [](behavior_table const &t) { return t.to_hash != nullptr; }));
+
+  constinit std::array<behavior_table, object_type_count> const behavior_tables{ tables };
+}
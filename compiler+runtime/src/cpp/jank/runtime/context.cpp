@@ -1,4 +1,6 @@
+#include <condition_variable>
 #include <fstream>
+#include <mutex>
 
 #include <Interpreter/Compatibility.h>
 #include <clang/Interpreter/CppInterOp.h>
@@ -6,21 +8,28 @@
 #include <llvm/Bitcode/BitcodeWriter.h>
 #include <llvm/Target/TargetMachine.h>
 #include <llvm/IR/LegacyPassManager.h>
+#include <llvm/IRReader/IRReader.h>
 #include <llvm/MC/TargetRegistry.h>
+#include <llvm/Support/SourceMgr.h>
 #include <llvm/TargetParser/Host.h>
 
 #include <jank/read/lex.hpp>
 #include <jank/read/parse.hpp>
 #include <jank/runtime/context.hpp>
+#include <jank/runtime/isolate.hpp>
 #include <jank/runtime/visit.hpp>
 #include <jank/runtime/core.hpp>
 #include <jank/runtime/core/munge.hpp>
 #include <jank/runtime/core/meta.hpp>
+#include <jank/runtime/sequence_range.hpp>
+#include <jank/runtime/executor.hpp>
 #include <jank/analyze/processor.hpp>
+#include <jank/analyze/arena.hpp>
 #include <jank/analyze/expr/primitive_literal.hpp>
 #include <jank/analyze/pass/optimize.hpp>
 #include <jank/evaluate.hpp>
 #include <jank/jit/processor.hpp>
+#include <jank/jit/stats.hpp>
 #include <jank/util/clang.hpp>
 #include <jank/util/clang_format.hpp>
 #include <jank/util/environment.hpp>
@@ -32,11 +41,13 @@
 #include <jank/error/codegen.hpp>
 #include <jank/error/runtime.hpp>
 #include <jank/profile/time.hpp>
+#include <jank/profile/phase.hpp>
 
 namespace jank::runtime
 {
   /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
   thread_local decltype(context::thread_binding_frames) context::thread_binding_frames{};
+  thread_local u64 context::thread_binding_frame_version{};
 
   /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
   context *__rt_ctx{};
@@ -75,6 +86,16 @@ namespace jank::runtime
     assert_var->bind_root(jank_true);
     assert_var->dynamic.store(true);
 
+    auto const print_length_sym(make_box<obj::symbol>("*print-length*"));
+    print_length_var = core->intern_var(print_length_sym);
+    print_length_var->bind_root(jank_nil());
+    print_length_var->dynamic.store(true);
+
+    auto const print_level_sym(make_box<obj::symbol>("*print-level*"));
+    print_level_var = core->intern_var(print_level_sym);
+    print_level_var->bind_root(jank_nil());
+    print_level_var->dynamic.store(true);
+
     /* These are not actually interned. They're extra private. */
     current_module_var
       = make_box<runtime::var>(core, make_box<obj::symbol>("*current-module*"))->set_dynamic(true);
@@ -95,6 +116,19 @@ namespace jank::runtime
       .expect_ok();
   }
 
+  /* Within an isolate, its own namespaces shadow the shared ones. */
+  static ns_ref find_ns_named(context const &ctx, jtl::immutable_string_view const &name)
+  {
+    if(auto const iso{ isolate::current() })
+    {
+      if(auto const found{ iso->find_ns(name) }; found.is_some())
+      {
+        return found;
+      }
+    }
+    return ctx.namespaces.find("", name);
+  }
+
   obj::symbol_ref context::qualify_symbol(obj::symbol_ref const sym) const
   {
     obj::symbol_ref qualified_sym{ sym };
@@ -111,18 +145,13 @@ namespace jank::runtime
     profile::timer const timer{ "rt find_var" };
     if(!sym->ns.empty())
     {
-      ns_ref ns{};
+      auto const ns(find_ns_named(*this, sym->ns));
+      if(ns.is_nil())
       {
-        auto const locked_namespaces(namespaces.rlock());
-        auto const found(locked_namespaces->find(make_box<obj::symbol>("", sym->ns)));
-        if(found == locked_namespaces->end())
-        {
-          return {};
-        }
-        ns = found->second;
+        return {};
       }
 
-      return ns->find_var(make_box<obj::symbol>("", sym->name));
+      return ns->find_var(intern_symbol("", sym->name));
     }
     else
     {
@@ -133,7 +162,7 @@ namespace jank::runtime
 
   var_ref context::find_var(jtl::immutable_string const &ns, jtl::immutable_string const &name)
   {
-    return find_var(make_box<obj::symbol>(ns, name));
+    return find_var(intern_symbol(ns, name));
   }
 
   jtl::option<object_ref> context::find_local(obj::symbol_ref const)
@@ -151,19 +180,146 @@ namespace jank::runtime
 
     binding_scope const preserve{ obj::persistent_hash_map::create_unique(
       std::make_pair(current_file_var, make_box(path))) };
+    util::scope_exit const forget{ [&] { read::parse::forget_positions(path); } };
+
+    auto const ret(eval_string(file.expect_ok().view(), true));
+    if(util::cli::opts.macroexpand_cache)
+    {
+      macro_cache.flush();
+    }
+    return ret;
+  }
+
+  /* Whether the form calls, anywhere within it, a macro from the given ns. Such a macro
+   * may call fns which are still waiting in the batch, so the batch needs to be evaluated
+   * before the form is expanded. */
+  static bool calls_ns_macro(object_ref const form, ns_ref const current)
+  {
+    if(!is_seq(form) && !is_vector(form) && !is_map(form) && !is_set(form))
+    {
+      return false;
+    }
+
+    if(is_seq(form))
+    {
+      if(auto const sym = dyn_cast<obj::symbol>(first(form)); sym.is_some())
+      {
+        auto const var(__rt_ctx->find_var(sym));
+        if(var.is_some() && var->n.data == current.data && var->meta.is_some()
+           && truthy(get(var->meta.unwrap(), __rt_ctx->intern_keyword("macro").expect_ok())))
+        {
+          return true;
+        }
+      }
+    }
+
+    for(auto const &e : make_sequence_range(form))
+    {
+      if(calls_ns_macro(e, current))
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /* Whether the expanded form is a def of a fn, such as what defn expands to. These can
+   * be held back in a batch, since nothing else is able to see their vars until the next
+   * form which isn't batched, at which point the batch is evaluated. Macros are never
+   * batched, since they may be used to expand the very next form. */
+  static bool is_batchable_def(object_ref const expanded)
+  {
+    if(!is_seq(expanded) || sequence_length(expanded) != 3)
+    {
+      return false;
+    }
+
+    auto const head(dyn_cast<obj::symbol>(first(expanded)));
+    auto const name(dyn_cast<obj::symbol>(second(expanded)));
+    if(head.is_nil() || !head->ns.empty() || head->name != "def" || name.is_nil())
+    {
+      return false;
+    }
+
+    if(name->meta.is_some()
+       && truthy(get(name->meta.unwrap(), __rt_ctx->intern_keyword("macro").expect_ok())))
+    {
+      return false;
+    }
+
+    auto const value(__rt_ctx->macroexpand(first(next(next(expanded)))));
+    if(!is_seq(value))
+    {
+      return false;
+    }
+    auto const value_head(dyn_cast<obj::symbol>(first(value)));
+    return value_head.is_some() && value_head->ns.empty() && value_head->name == "fn*";
+  }
 
-    return eval_string(file.expect_ok().view());
+  /* A short name for a top level form, for bench-compile and jit::stats, such as
+   * `(defn foo`. */
+  static jtl::immutable_string form_label(object_ref const form)
+  {
+    if(!is_seq(form) || sequence_length(form) < 2)
+    {
+      return to_code_string(form);
+    }
+    return util::format("({} {}", to_code_string(first(form)), to_code_string(second(form)));
+  }
+
+  /* Evaluates the batched forms as the body of a single fn, so that all of the fns they
+   * define are JIT compiled into the same module. */
+  static object_ref eval_batch(native_vector<object_ref> &&forms)
+  {
+    profile::timer const timer{ "rt eval batch" };
+    auto const form{ runtime::conj(
+      runtime::conj(runtime::conj(make_box<obj::native_vector_sequence>(jtl::move(forms)),
+                                  obj::persistent_vector::empty()),
+                    __rt_ctx->unique_symbol("batch")),
+      make_box<obj::symbol>("fn*")) };
+    analyze::processor an_prc;
+    auto const expr(analyze::pass::optimize(
+      an_prc.analyze(form, analyze::expression_position::statement).expect_ok()));
+    return dynamic_call(evaluate::eval(expr));
   }
 
-  jtl::option<object_ref> context::eval_string(jtl::immutable_string const &code)
+  jtl::option<object_ref>
+  context::eval_string(jtl::immutable_string const &code, bool const batch)
   {
     profile::timer const timer{ "rt eval_string" };
+    jit::stats::eval_scope stats_scope;
     read::lex::processor l_prc{ code };
     read::parse::processor p_prc{ l_prc.begin(), l_prc.end() };
 
     bool no_op{ true };
     object_ref ret{ jank_nil() };
     native_vector<object_ref> forms{};
+
+    /* The interpreter would interpret the batch's fn, which defeats the point. */
+    auto const batching(batch && util::cli::opts.batch_jit && !util::cli::opts.interpret);
+    native_vector<object_ref> batched;
+
+    /* Each form is measured from the end of the last one, so it includes its reading.
+     * Batched defs are compiled together, so they're charged to the form which flushes
+     * the batch. */
+    auto const profiling(profile::phases_enabled());
+    auto form_start(profiling ? profile::phase_now() : profile::phase_mark{});
+    auto const record_form([&](object_ref const form) {
+      if(profiling)
+      {
+        profile::record_form(form_label(form), form_start);
+        form_start = profile::phase_now();
+      }
+    });
+
+    auto const flush_batch([&] {
+      if(!batched.empty())
+      {
+        ret = eval_batch(jtl::move(batched));
+        batched.clear();
+      }
+    });
+
     for(auto const &form : p_prc)
     {
       if(no_op && form.expect_ok().is_none())
@@ -172,14 +328,42 @@ namespace jank::runtime
       }
 
       no_op = false;
+      auto const form_obj(form.expect_ok().unwrap().ptr);
+      if(stats_scope.is_active() && forms.empty())
+      {
+        stats_scope.set_label(form_label(form_obj));
+      }
+      forms.emplace_back(form_obj);
+
+      if(batching)
+      {
+        if(calls_ns_macro(form_obj, current_ns()))
+        {
+          flush_batch();
+        }
+
+        auto const expanded(macroexpand(form_obj));
+        if(is_batchable_def(expanded))
+        {
+          batched.emplace_back(expanded);
+          record_form(form_obj);
+          continue;
+        }
+        flush_batch();
+      }
+
       analyze::processor an_prc;
       auto const expr(analyze::pass::optimize(
-        an_prc.analyze(form.expect_ok().unwrap().ptr, analyze::expression_position::statement)
-          .expect_ok()));
+        an_prc.analyze(form_obj, analyze::expression_position::statement).expect_ok()));
       ret = evaluate::eval(expr);
-
-      forms.emplace_back(form.expect_ok().unwrap().ptr);
+      record_form(form_obj);
     }
+    if(profiling && !batched.empty())
+    {
+      flush_batch();
+      profile::record_form("trailing batch", form_start);
+    }
+    flush_batch();
 
     if(no_op)
     {
@@ -195,6 +379,11 @@ namespace jank::runtime
     if(truthy(compile_files_var->deref()))
     {
       profile::timer const timer{ "rt compile-module" };
+      /* Nothing holds onto this tree once the module is written, so it can all be freed at
+       * once, rather than left for the GC. */
+      analyze::node_arena const nodes;
+      util::scope_exit const forget_nodes{ [&] { analyze::processor::forget_nodes(nodes); } };
+      analyze::processor an_prc;
       auto const &module(runtime::to_string(current_module_var->deref()));
       auto const name{ module::module_to_load_function(module) };
 
@@ -256,6 +445,7 @@ namespace jank::runtime
     profile::timer const timer{ "rt eval_cpp_string" };
 
     auto parse_res{ jit_prc.interpreter->Parse({ code.data(), code.size() }) };
+    jit_prc.cpp_generation.fetch_add(1, std::memory_order_release);
     if(!parse_res)
     {
       /* TODO: Helper to turn an llvm::Error into a string. */
@@ -310,6 +500,7 @@ namespace jank::runtime
     read::parse::processor p_prc{ l_prc.begin(), l_prc.end() };
 
     native_vector<analyze::expression_ref> ret{};
+    analyze::processor an_prc;
     for(auto const &form : p_prc)
     {
       if(eval)
@@ -381,11 +572,24 @@ namespace jank::runtime
     binding_scope const preserve{ obj::persistent_hash_map::create_unique(
       std::make_pair(compile_files_var, jank_true)) };
 
-    return load_module(util::format("/{}", module), module::origin::latest);
+    auto const res{ load_module(util::format("/{}", module), module::origin::latest) };
+    /* Even if loading failed, we can't leave objects being written behind us. */
+    auto const write_res{ wait_for_modules() };
+    if(res.is_err())
+    {
+      return res;
+    }
+    if(write_res.is_err())
+    {
+      return error::internal_codegen_failure(write_res.expect_err());
+    }
+
+    return module_loader.write_pending_cache_keys();
   }
 
   object_ref context::eval(object_ref const o)
   {
+    analyze::processor an_prc;
     auto const expr(
       analyze::pass::optimize(an_prc.analyze(o, analyze::expression_position::value).expect_ok()));
     return evaluate::eval(expr);
@@ -418,6 +622,116 @@ namespace jank::runtime
       : jtl::immutable_string{ util::cli::opts.output_module_filename };
   }
 
+  static jtl::string_result<void>
+  write_object(llvm::Module &module, std::filesystem::path const &path)
+  {
+    std::error_code file_error{};
+    llvm::raw_fd_ostream os(path.c_str(), file_error, llvm::sys::fs::OpenFlags::OF_None);
+    if(file_error)
+    {
+      return err(util::format("Failed to open module file '{}' with error '{}'.",
+                              path.c_str(),
+                              file_error.message()));
+    }
+    //module.print(llvm::outs(), nullptr);
+
+    auto const target_triple{ util::default_target_triple() };
+    std::string target_error;
+    auto const target{ llvm::TargetRegistry::lookupTarget(target_triple.c_str(), target_error) };
+    if(!target)
+    {
+      return err(target_error);
+    }
+    llvm::TargetOptions const opt;
+    auto const target_machine{ target->createTargetMachine(llvm::Triple{ target_triple.c_str() },
+                                                           util::target_cpu_name().c_str(),
+                                                           util::target_cpu_features().c_str(),
+                                                           opt,
+                                                           llvm::Reloc::PIC_,
+                                                           llvm::CodeModel::Large,
+                                                           llvm::CodeGenOptLevel::Default) };
+    if(!target_machine)
+    {
+      return err(util::format("Failed to create target machine for '{}'.", target_triple));
+    }
+    llvm::legacy::PassManager pass;
+
+    if(target_machine->addPassesToEmitFile(pass, os, nullptr, llvm::CodeGenFileType::ObjectFile))
+    {
+      return err(util::format("Failed to write module to object file for '{}'.", target_triple));
+    }
+
+    pass.run(module);
+    return ok();
+  }
+
+  static jtl::string_result<void>
+  write_object(std::string const &bitcode, std::filesystem::path const &path)
+  {
+    try
+    {
+      llvm::LLVMContext llvm_ctx;
+      llvm::SMDiagnostic diag;
+      auto const module{ llvm::parseIR(llvm::MemoryBufferRef{ bitcode, path.c_str() },
+                                       diag,
+                                       llvm_ctx) };
+      if(!module)
+      {
+        return err(util::format("Failed to read back the module for '{}': {}",
+                                path.c_str(),
+                                diag.getMessage().str()));
+      }
+      return write_object(*module, path);
+    }
+    catch(std::exception const &e)
+    {
+      return err(util::format("Failed to write '{}': {}", path.c_str(), e.what()));
+    }
+  }
+
+  /* Writing the object file for one module doesn't depend on any other module, so with
+   * -j this is done on a pool of workers while we move on to analyzing the next one. */
+  struct object_queue
+  {
+    std::mutex mutex;
+    std::condition_variable idle;
+    usize in_flight{};
+    native_vector<jtl::immutable_string> errors;
+  };
+
+  static object_queue &get_object_queue()
+  {
+    /* This is intentionally leaked, like the executors, since the workers may still be
+     * using it during static destruction. */
+    static auto * const q{ new object_queue{} };
+    return *q;
+  }
+
+  static work_stealing_executor &object_executor()
+  {
+    static auto * const e{ new work_stealing_executor{ util::cli::opts.jobs } };
+    return *e;
+  }
+
+  jtl::string_result<void> context::wait_for_modules() const
+  {
+    auto &queue{ get_object_queue() };
+    std::unique_lock<std::mutex> lock{ queue.mutex };
+    queue.idle.wait(lock, [&] { return queue.in_flight == 0; });
+    if(queue.errors.empty())
+    {
+      return ok();
+    }
+
+    jtl::string_builder sb;
+    for(auto const &e : queue.errors)
+    {
+      sb(e)('\n');
+    }
+    queue.errors.clear();
+    return err(sb.release());
+  }
+
   jtl::string_result<void> context::write_module(jtl::immutable_string const &module_name,
                                                  jtl::immutable_string const &cpp_code,
                                                  jtl::ref<llvm::Module> const &module) const
@@ -456,52 +770,35 @@ namespace jank::runtime
         }
       case util::cli::compilation_target::object:
         {
-          /* TODO: Is there a better place for this block of code? */
-          std::error_code file_error{};
-          llvm::raw_fd_ostream os(module_path.c_str(),
-                                  file_error,
-                                  llvm::sys::fs::OpenFlags::OF_None);
-          if(file_error)
+          if(util::cli::opts.jobs <= 1)
           {
-            return err(util::format("Failed to open module file '{}' with error '{}'.",
-                                    module_path.c_str(),
-                                    file_error.message()));
+            return write_object(*module, module_path);
           }
-          //module->print(llvm::outs(), nullptr);
 
-          auto const target_triple{ util::default_target_triple() };
-          std::string target_error;
-          auto const target{ llvm::TargetRegistry::lookupTarget(target_triple.c_str(),
-                                                                target_error) };
-          if(!target)
-          {
-            return err(target_error);
-          }
-          llvm::TargetOptions const opt;
-          auto const target_machine{ target->createTargetMachine(
-            llvm::Triple{ target_triple.c_str() },
-            "generic",
-            "",
-            opt,
-            llvm::Reloc::PIC_,
-            llvm::CodeModel::Large,
-            llvm::CodeGenOptLevel::Default) };
-          if(!target_machine)
-          {
-            return err(util::format("Failed to create target machine for '{}'.", target_triple));
-          }
-          llvm::legacy::PassManager pass;
+          /* The module belongs to an LLVM context which we're going to keep using, so the
+           * worker gets its own copy, by way of bitcode, in a context of its own. */
+          std::string bitcode;
+          llvm::raw_string_ostream os{ bitcode };
+          llvm::WriteBitcodeToFile(*module, os);
+          os.flush();
 
-          if(target_machine->addPassesToEmitFile(pass,
-                                                 os,
-                                                 nullptr,
-                                                 llvm::CodeGenFileType::ObjectFile))
+          auto &queue{ get_object_queue() };
           {
-            return err(
-              util::format("Failed to write module to object file for '{}'.", target_triple));
+            std::lock_guard<std::mutex> const lock{ queue.mutex };
+            ++queue.in_flight;
           }
-
-          pass.run(*module);
+          object_executor().submit([bitcode = std::move(bitcode), module_path] {
+            auto const res{ write_object(bitcode, module_path) };
+            {
+              std::lock_guard<std::mutex> const lock{ get_object_queue().mutex };
+              if(res.is_err())
+              {
+                get_object_queue().errors.emplace_back(res.expect_err());
+              }
+              --get_object_queue().in_flight;
+            }
+            get_object_queue().idle.notify_all();
+          });
           return ok();
         }
       case util::cli::compilation_target::unspecified:
@@ -559,39 +856,39 @@ namespace jank::runtime
       throw std::runtime_error{ util::format("Can't intern ns. Sym is qualified: {}",
                                              sym->to_string()) };
     }
-    auto locked_namespaces(namespaces.wlock());
-    auto const found(locked_namespaces->find(sym));
-    if(found != locked_namespaces->end())
+    if(auto const iso{ isolate::current() })
     {
-      return found->second;
+      if(auto const found{ find_ns_named(*this, sym->name) }; found.is_some())
+      {
+        return found;
+      }
+      return iso->intern_ns(sym);
     }
-
-    auto const result(locked_namespaces->emplace(sym, make_box<ns>(sym)));
-    return result.first->second;
+    return namespaces.intern(sym->ns, sym->name, [&] {
+      auto const ret{ make_box<ns>(sym) };
+      names.add_ns(ret);
+      return ret;
+    });
   }
 
+  /* An isolate can only remove its own namespaces. */
   ns_ref context::remove_ns(obj::symbol_ref const sym)
   {
-    auto locked_namespaces(namespaces.wlock());
-    auto const found(locked_namespaces->find(sym));
-    if(found != locked_namespaces->end())
+    if(auto const iso{ isolate::current() })
     {
-      auto const ret(found->second);
-      locked_namespaces->erase(found);
-      return ret;
+      return iso->remove_ns(sym);
+    }
+    auto const removed{ namespaces.remove(sym->ns, sym->name) };
+    if(removed.is_some())
+    {
+      names.remove_ns(removed);
     }
-    return {};
+    return removed;
   }
 
   ns_ref context::find_ns(obj::symbol_ref const sym)
   {
-    auto locked_namespaces(namespaces.rlock());
-    auto const found(locked_namespaces->find(sym));
-    if(found != locked_namespaces->end())
-    {
-      return found->second;
-    }
-    return {};
+    return find_ns_named(*this, sym->name);
   }
 
   ns_ref context::resolve_ns(obj::symbol_ref const target)
@@ -633,15 +930,13 @@ namespace jank::runtime
         util::format("Can't intern var. Sym isn't qualified: {}", qualified_name->to_string()));
     }
 
-    auto locked_namespaces(namespaces.wlock());
-    obj::symbol_ref const ns_sym{ make_box<obj::symbol>(qualified_name->ns) };
-    auto const found_ns(locked_namespaces->find(ns_sym));
-    if(found_ns == locked_namespaces->end())
+    auto const found_ns(find_ns_named(*this, qualified_name->ns));
+    if(found_ns.is_nil())
     {
       return err(util::format("Can't intern var. Namespace doesn't exist: {}", qualified_name->ns));
     }
 
-    return ok(found_ns->second->intern_var(qualified_name));
+    return ok(found_ns->intern_var(qualified_name));
   }
 
   jtl::result<var_ref, jtl::immutable_string>
@@ -667,15 +962,19 @@ namespace jank::runtime
         util::format("Can't intern var. Sym isn't qualified: {}", qualified_sym->to_string()));
     }
 
-    auto locked_namespaces(namespaces.wlock());
-    obj::symbol_ref const ns_sym{ make_box<obj::symbol>(qualified_sym->ns) };
-    auto const found_ns(locked_namespaces->find(ns_sym));
-    if(found_ns == locked_namespaces->end())
+    auto const found_ns(find_ns_named(*this, qualified_sym->ns));
+    if(found_ns.is_nil())
     {
       return err(util::format("Can't intern var. Namespace doesn't exist: {}", qualified_sym->ns));
     }
 
-    return ok(found_ns->second->intern_owned_var(qualified_sym));
+    if(auto const iso{ isolate::current() }; iso && iso->find_ns(qualified_sym->ns).is_nil())
+    {
+      return err(util::format("Can't intern var. Namespace {} is shared by every isolate.",
+                              qualified_sym->ns));
+    }
+
+    return ok(found_ns->intern_owned_var(qualified_sym));
   }
 
   jtl::result<obj::keyword_ref, jtl::immutable_string>
@@ -702,7 +1001,17 @@ namespace jank::runtime
         resolved_ns = current_ns->name->name;
       }
     }
-    return intern_keyword(resolved_ns.empty() ? name : util::format("{}/{}", resolved_ns, name));
+    if(resolved_ns.empty())
+    {
+      return intern_keyword(name);
+    }
+
+    profile::timer const timer{ "rt intern_keyword" };
+    return keywords.intern(resolved_ns, name, [&] {
+      auto const ret{ make_box<obj::keyword>(detail::must_be_interned{}, resolved_ns, name) };
+      names.add_keyword(ret);
+      return ret;
+    });
   }
 
   jtl::result<obj::keyword_ref, jtl::immutable_string>
@@ -710,21 +1019,50 @@ namespace jank::runtime
   {
     profile::timer const timer{ "rt intern_keyword" };
 
-    auto locked_keywords(keywords.wlock());
-    auto const found(locked_keywords->find(s));
-    if(found != locked_keywords->end())
+    /* This splits the same way symbols do, so each keyword has one key no matter which
+     * overload interned it. */
+    jtl::immutable_string_view ns{ "" }, name{ s };
+    auto const slash(s.find('/'));
+    if(slash != jtl::immutable_string::npos && s.size() > 1)
+    {
+      ns = { s.data(), slash };
+      name = { s.data() + slash + 1, s.size() - slash - 1 };
+    }
+
+    return keywords.intern(ns, name, [&] {
+      auto const ret{ make_box<obj::keyword>(detail::must_be_interned{}, ns, name) };
+      names.add_keyword(ret);
+      return ret;
+    });
+  }
+  obj::symbol_ref
+  context::intern_symbol(jtl::immutable_string const &ns, jtl::immutable_string const &name)
+  {
+    return symbols.intern(ns, name, [&] { return make_box<obj::symbol>(ns, name); });
+  }
+
+  obj::symbol_ref context::intern_symbol(jtl::immutable_string const &s)
+  {
+    /* This splits the same way the symbol ctor does, so each symbol has one key no matter
+     * which overload interned it. */
+    jtl::immutable_string_view ns{ "" }, name{ s };
+    auto const slash(s.find('/'));
+    if(slash != jtl::immutable_string::npos && s.size() > 1)
     {
-      return found->second;
+      ns = { s.data(), slash };
+      name = { s.data() + slash + 1, s.size() - slash - 1 };
     }
 
-    auto const res(
-      locked_keywords->emplace(s, make_box<obj::keyword>(detail::must_be_interned{}, s)));
-    return res.first->second;
+    return symbols.intern(ns, name, [&] {
+      return make_box<obj::symbol>(jtl::immutable_string{ ns }, jtl::immutable_string{ name });
+    });
   }
 
+
   object_ref context::macroexpand1(object_ref const o)
   {
     profile::timer const timer{ "rt macroexpand1" };
+    profile::phase_timer const phase{ profile::phase::macroexpand };
     return visit_seqable(
       [this](auto const typed_o) -> object_ref {
         using T = typename jtl::decay_t<decltype(typed_o)>::value_type;
@@ -757,6 +1095,10 @@ namespace jank::runtime
 
           /* TODO: Provide &env. */
           auto const args(cons(cons(rest(typed_o), jank_nil()), typed_o));
+          if(util::cli::opts.macroexpand_cache)
+          {
+            return macro_cache.expand(var, typed_o, [&] { return apply_to(var->deref(), args); });
+          }
           return apply_to(var->deref(), args);
         }
       },
@@ -877,6 +1219,7 @@ namespace jank::runtime
     }
 
     tbfs.push_front(std::move(frame));
+    ++thread_binding_frame_version;
     return ok();
   }
 
@@ -889,6 +1232,7 @@ namespace jank::runtime
     }
 
     tbfs.pop_front();
+    ++thread_binding_frame_version;
 
     return ok();
   }
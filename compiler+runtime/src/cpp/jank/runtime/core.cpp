@@ -4,8 +4,12 @@
 #include <jank/runtime/behavior/derefable.hpp>
 #include <jank/runtime/behavior/ref_like.hpp>
 #include <jank/runtime/context.hpp>
+#include <jank/runtime/core/equal.hpp>
+#include <jank/runtime/executor.hpp>
 #include <jank/runtime/sequence_range.hpp>
+#include <jank/runtime/behavior_table.hpp>
 #include <jank/util/fmt.hpp>
+#include <jank/util/scope_exit.hpp>
 
 namespace jank::runtime
 {
@@ -95,22 +99,38 @@ namespace jank::runtime
     return make_box<obj::symbol>(ns, name);
   }
 
-  object_ref print(object_ref const args)
+  /* Prints all of the args, separated by spaces, into the one builder, so printing nested
+   * data never needs a string per element. */
+  static void print_to(object_ref const args, jtl::string_builder &buff, bool const to_code)
   {
+    print_limits_scope const limits;
     visit_object(
-      [](auto const typed_args) {
+      [&](auto const typed_args) {
         using T = typename jtl::decay_t<decltype(typed_args)>::value_type;
 
-        if constexpr(behavior::sequenceable<T>)
+        if constexpr(std::same_as<T, obj::nil>)
+        {
+          /* No args, so nothing to print. */
+        }
+        else if constexpr(behavior::sequenceable<T>)
         {
-          jtl::string_builder buff;
-          runtime::to_string(typed_args->first().erase(), buff);
-          for(auto const e : make_sequence_range(typed_args).skip(1))
+          bool needs_space{};
+          for(auto const e : make_sequence_range(typed_args))
           {
-            buff(' ');
-            runtime::to_string(e.erase(), buff);
+            if(needs_space)
+            {
+              buff(' ');
+            }
+            if(to_code)
+            {
+              runtime::to_code_string(e.erase(), buff);
+            }
+            else
+            {
+              runtime::to_string(e.erase(), buff);
+            }
+            needs_space = true;
           }
-          std::fwrite(buff.data(), 1, buff.size(), stdout);
         }
         else
         {
@@ -119,98 +139,76 @@ namespace jank::runtime
         }
       },
       args);
-    return jank_nil();
   }
 
-  object_ref println(object_ref const args)
+  /* Set while within with_out_str, so this thread's printing goes there rather than to
+   * stdout. */
+  static thread_local jtl::string_builder *captured_out{};
+
+  static object_ref print_out(object_ref const args, bool const to_code, bool const newline)
   {
-    visit_object(
-      [](auto const typed_more) {
-        using T = typename jtl::decay_t<decltype(typed_more)>::value_type;
+    if(captured_out)
+    {
+      print_to(args, *captured_out, to_code);
+      if(newline)
+      {
+        (*captured_out)('\n');
+      }
+      return jank_nil();
+    }
 
-        if constexpr(std::same_as<T, obj::nil>)
-        {
-          std::putc('\n', stdout);
-        }
-        else if constexpr(behavior::sequenceable<T>)
-        {
-          jtl::string_builder buff;
-          runtime::to_string(typed_more->first().erase(), buff);
-          for(auto const e : make_sequence_range(typed_more).skip(1))
-          {
-            buff(' ');
-            runtime::to_string(e.erase(), buff);
-          }
-          std::fwrite(buff.data(), 1, buff.size(), stdout);
-          std::putc('\n', stdout);
-        }
-        else
-        {
-          throw std::runtime_error{ util::format("expected a sequence: {}",
-                                                 typed_more->to_string()) };
-        }
-      },
-      args);
+    jtl::string_builder buff;
+    print_to(args, buff, to_code);
+    if(newline)
+    {
+      buff('\n');
+    }
+    std::fwrite(buff.data(), 1, buff.size(), stdout);
     return jank_nil();
   }
 
-  object_ref pr(object_ref const args)
+  object_ref print(object_ref const args)
   {
-    visit_object(
-      [](auto const typed_args) {
-        using T = typename jtl::decay_t<decltype(typed_args)>::value_type;
+    return print_out(args, false, false);
+  }
 
-        if constexpr(behavior::sequenceable<T>)
-        {
-          jtl::string_builder buff;
-          runtime::to_code_string(typed_args->first().erase(), buff);
-          for(auto const e : make_sequence_range(typed_args).skip(1))
-          {
-            buff(' ');
-            runtime::to_code_string(e.erase(), buff);
-          }
-          std::fwrite(buff.data(), 1, buff.size(), stdout);
-        }
-        else
-        {
-          throw std::runtime_error{ util::format("expected a sequence: {}",
-                                                 typed_args->to_string()) };
-        }
-      },
-      args);
-    return jank_nil();
+  object_ref println(object_ref const args)
+  {
+    return print_out(args, false, true);
+  }
+
+  object_ref pr(object_ref const args)
+  {
+    return print_out(args, true, false);
   }
 
   object_ref prn(object_ref const args)
   {
-    visit_object(
-      [](auto const typed_args) {
-        using T = typename jtl::decay_t<decltype(typed_args)>::value_type;
+    return print_out(args, true, true);
+  }
 
-        if constexpr(std::same_as<T, obj::nil>)
-        {
-          std::putc('\n', stdout);
-        }
-        else if constexpr(behavior::sequenceable<T>)
-        {
-          jtl::string_builder buff;
-          runtime::to_code_string(typed_args->first().erase(), buff);
-          for(auto const e : make_sequence_range(typed_args).skip(1))
-          {
-            buff(' ');
-            runtime::to_code_string(e.erase(), buff);
-          }
-          std::fwrite(buff.data(), 1, buff.size(), stdout);
-          std::putc('\n', stdout);
-        }
-        else
-        {
-          throw std::runtime_error{ util::format("expected a sequence: {}",
-                                                 typed_args->to_string()) };
-        }
-      },
-      args);
-    return jank_nil();
+  jtl::immutable_string print_str(object_ref const args)
+  {
+    jtl::string_builder buff;
+    print_to(args, buff, false);
+    return buff.release();
+  }
+
+  jtl::immutable_string pr_str(object_ref const args)
+  {
+    jtl::string_builder buff;
+    print_to(args, buff, true);
+    return buff.release();
+  }
+
+  jtl::immutable_string with_out_str(object_ref const f)
+  {
+    jtl::string_builder buff;
+    auto const prev{ captured_out };
+    captured_out = &buff;
+    util::scope_exit const restore{ [&] { captured_out = prev; } };
+    dynamic_call(f);
+    return buff.release();
   }
 
   obj::persistent_string_ref subs(object_ref const s, object_ref const start)
@@ -357,7 +355,7 @@ namespace jank::runtime
 
   uhash to_hash(object_ref const o)
   {
-    return visit_object([=](auto const typed_o) -> uhash { return typed_o->to_hash(); }, o);
+    return behaviors_of(o).to_hash(o.data);
   }
 
   object_ref macroexpand1(object_ref const o)
@@ -464,6 +462,25 @@ namespace jank::runtime
       o);
   }
 
+  object_ref
+  deref(object_ref const o, object_ref const timeout_ms, object_ref const timeout_val)
+  {
+    return visit_object(
+      [=](auto const typed_o) -> object_ref {
+        using T = typename jtl::decay_t<decltype(typed_o)>::value_type;
+
+        if constexpr(behavior::blocking_derefable<T>)
+        {
+          return typed_o->deref(to_int(timeout_ms), timeout_val);
+        }
+        else
+        {
+          return deref(typed_o);
+        }
+      },
+      o);
+  }
+
   object_ref volatile_(object_ref const o)
   {
     return make_box<obj::volatile_>(o);
@@ -483,7 +500,7 @@ namespace jank::runtime
   object_ref vswap(object_ref const v, object_ref const fn, object_ref const args)
   {
     auto const v_obj(try_object<obj::volatile_>(v));
-    return v_obj->reset(apply_to(fn, make_box<obj::cons>(v_obj->deref(), args)));
+    return v_obj->reset(apply_to(fn, v_obj->deref(), args));
   }
 
   object_ref vreset(object_ref const v, object_ref const new_val)
@@ -515,6 +532,223 @@ namespace jank::runtime
     return o;
   }
 
+  object_ref eduction(object_ref const xform, object_ref const coll)
+  {
+    return make_box<obj::eduction>(xform, coll);
+  }
+
+  object_ref future_call(object_ref const fn)
+  {
+    return obj::future::submit(fn, pooled_executor());
+  }
+
+  bool is_future(object_ref const o)
+  {
+    return o->type == object_type::future;
+  }
+
+  bool is_future_done(object_ref const o)
+  {
+    return try_object<obj::future>(o)->is_done();
+  }
+
+  bool future_cancel(object_ref const o)
+  {
+    return try_object<obj::future>(o)->cancel();
+  }
+
+  bool is_future_cancelled(object_ref const o)
+  {
+    return try_object<obj::future>(o)->is_cancelled();
+  }
+
+  object_ref promise()
+  {
+    return make_box<obj::promise>();
+  }
+
+  bool is_promise(object_ref const o)
+  {
+    return o->type == object_type::promise;
+  }
+
+  object_ref deliver(object_ref const p, object_ref const v)
+  {
+    auto const typed_p(try_object<obj::promise>(p));
+    if(typed_p->deliver(v))
+    {
+      return typed_p;
+    }
+    return jank_nil();
+  }
+
+  object_ref on_deliver(object_ref const p, object_ref const f)
+  {
+    try_object<obj::promise>(p)->on_deliver(f);
+    return p;
+  }
+
+  object_ref agent(object_ref const state)
+  {
+    return make_box<obj::agent>(state);
+  }
+
+  bool is_agent(object_ref const o)
+  {
+    return o->type == object_type::agent;
+  }
+
+  object_ref send(object_ref const a, object_ref const fn, object_ref const args)
+  {
+    try_object<obj::agent>(a)->dispatch(fn, args, pooled_executor());
+    return a;
+  }
+
+  object_ref send_off(object_ref const a, object_ref const fn, object_ref const args)
+  {
+    try_object<obj::agent>(a)->dispatch(fn, args, solo_executor());
+    return a;
+  }
+
+  object_ref send_via(object_ref const executor,
+                      object_ref const a,
+                      object_ref const fn,
+                      object_ref const args)
+  {
+    if(equal(executor, __rt_ctx->intern_keyword("pooled").expect_ok()))
+    {
+      return send(a, fn, args);
+    }
+    if(equal(executor, __rt_ctx->intern_keyword("solo").expect_ok()))
+    {
+      return send_off(a, fn, args);
+    }
+    throw std::runtime_error{ util::format("Unknown agent executor {}, expected :pooled or :solo",
+                                           runtime::to_code_string(executor)) };
+  }
+
+  i64 release_pending_sends()
+  {
+    return static_cast<i64>(obj::agent::release_pending_sends());
+  }
+
+  object_ref agent_error(object_ref const a)
+  {
+    return try_object<obj::agent>(a)->get_error();
+  }
+
+  object_ref
+  restart_agent(object_ref const a, object_ref const new_state, bool const clear_actions)
+  {
+    try_object<obj::agent>(a)->restart(new_state, clear_actions);
+    return new_state;
+  }
+
+  object_ref set_error_handler(object_ref const a, object_ref const fn)
+  {
+    try_object<obj::agent>(a)->set_error_handler(fn);
+    return a;
+  }
+
+  object_ref error_handler(object_ref const a)
+  {
+    return try_object<obj::agent>(a)->get_error_handler();
+  }
+
+  object_ref set_error_mode(object_ref const a, object_ref const mode)
+  {
+    try_object<obj::agent>(a)->set_error_mode(mode);
+    return a;
+  }
+
+  object_ref error_mode(object_ref const a)
+  {
+    return try_object<obj::agent>(a)->get_error_mode();
+  }
+
+  void shutdown_agents()
+  {
+    obj::agent::shutdown();
+  }
+
+  object_ref ref(object_ref const val)
+  {
+    return make_box<obj::ref>(val);
+  }
+
+  bool is_ref(object_ref const o)
+  {
+    return o->type == object_type::ref;
+  }
+
+  object_ref ref_set(object_ref const r, object_ref const val)
+  {
+    return try_object<obj::ref>(r)->set(val);
+  }
+
+  object_ref alter(object_ref const r, object_ref const fn, object_ref const args)
+  {
+    return try_object<obj::ref>(r)->alter(fn, args);
+  }
+
+  object_ref commute(object_ref const r, object_ref const fn, object_ref const args)
+  {
+    return try_object<obj::ref>(r)->commute(fn, args);
+  }
+
+  object_ref ensure(object_ref const r)
+  {
+    return try_object<obj::ref>(r)->ensure();
+  }
+
+  i64 ref_history_count(object_ref const r)
+  {
+    return static_cast<i64>(try_object<obj::ref>(r)->history_count());
+  }
+
+  i64 ref_min_history(object_ref const r)
+  {
+    return static_cast<i64>(try_object<obj::ref>(r)->get_min_history());
+  }
+
+  object_ref ref_min_history(object_ref const r, object_ref const n)
+  {
+    return try_object<obj::ref>(r)->set_min_history(static_cast<usize>(to_int(n)));
+  }
+
+  i64 ref_max_history(object_ref const r)
+  {
+    return static_cast<i64>(try_object<obj::ref>(r)->get_max_history());
+  }
+
+  object_ref ref_max_history(object_ref const r, object_ref const n)
+  {
+    return try_object<obj::ref>(r)->set_max_history(static_cast<usize>(to_int(n)));
+  }
+
+  bool is_realized(object_ref const o)
+  {
+    return visit_object(
+      [=](auto const typed_o) -> bool {
+        using T = typename jtl::decay_t<decltype(typed_o)>::value_type;
+
+        if constexpr(behavior::pending<T>)
+        {
+          return typed_o->is_realized();
+        }
+        else
+        {
+          throw std::runtime_error{ util::format("not pending: {}", typed_o->to_code_string()) };
+        }
+      },
+      o);
+  }
+
+  i64 available_processors()
+  {
+    return static_cast<i64>(pooled_executor().thread_count());
+  }
+
   object_ref tagged_literal(object_ref const tag, object_ref const form)
   {
     return make_box<obj::tagged_literal>(tag, form);
@@ -536,48 +770,55 @@ namespace jank::runtime
                                      try_object<obj::persistent_string>(s)->data);
   }
 
-  object_ref smatch_to_vector(std::smatch const &match_results)
+  object_ref regex_groups(jtl::immutable_string const &input,
+                          native_vector<regex::span> const &groups)
   {
-    auto const size(match_results.size());
-    switch(size)
+    auto const group(
+      [&](regex::span const &g) -> object_ref {
+        if(!g.matched)
+        {
+          return jank_nil();
+        }
+        return make_box<obj::persistent_string>(input.substr(g.offset, g.size));
+      });
+
+    switch(groups.size())
     {
       case 0:
         return jank_nil();
       case 1:
-        {
-          return make_box<obj::persistent_string>(match_results[0].str());
-        }
+        return group(groups[0]);
       default:
         {
-          native_vector<object_ref> vec;
-          vec.reserve(size);
-
-          for(auto const s : match_results)
+          runtime::detail::native_transient_vector trans;
+          for(auto const &g : groups)
           {
-            vec.emplace_back(make_box<obj::persistent_string>(s.str()));
+            trans.push_back(group(g));
           }
-
-          return make_box<obj::persistent_vector>(
-            runtime::detail::native_persistent_vector{ vec.begin(), vec.end() });
+          return make_box<obj::persistent_vector>(trans.persistent());
         }
     }
   }
 
   object_ref re_find(object_ref const m)
   {
-    std::smatch match_results{};
     auto const matcher(try_object<obj::re_matcher>(m));
-    std::regex_search(matcher->match_input, match_results, matcher->re->regex);
-
-    // Copy out the match result substrings before mutating the source
-    // match_input string below.
-    matcher->groups = smatch_to_vector(match_results);
-
-    if(!match_results.empty())
+    auto const &input(matcher->input);
+    if(matcher->position > input.size()
+       || !regex::search(*matcher->re->program,
+                         input,
+                         matcher->position,
+                         regex::anchor::none,
+                         matcher->spans))
     {
-      matcher->match_input = match_results.suffix().str();
+      matcher->position = input.size() + 1;
+      matcher->groups = jank_nil();
+      return matcher->groups;
     }
 
+    matcher->groups = regex_groups(input, matcher->spans);
+    matcher->position = regex::next_start(input, matcher->spans[0]);
+
     return matcher->groups;
   }
 
@@ -595,20 +836,18 @@ namespace jank::runtime
 
   object_ref re_matches(object_ref const re, object_ref const s)
   {
-    std::smatch match_results{};
-    std::string const search_str{ try_object<obj::persistent_string>(s)->data.c_str() };
-
-    std::regex_search(search_str,
-                      match_results,
-                      try_object<obj::re_pattern>(re)->regex,
-                      std::regex_constants::match_continuous);
-
-    if(!match_results.suffix().str().empty())
+    auto const &input(try_object<obj::persistent_string>(s)->data);
+    native_vector<regex::span> groups;
+    if(!regex::search(*try_object<obj::re_pattern>(re)->program,
+                      input,
+                      0,
+                      regex::anchor::both,
+                      groups))
     {
       return jank_nil();
     }
 
-    return smatch_to_vector(match_results);
+    return regex_groups(input, groups);
   }
 
   object_ref parse_uuid(object_ref const o)
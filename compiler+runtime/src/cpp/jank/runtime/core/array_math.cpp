@@ -0,0 +1,445 @@
+#include <cmath>
+#include <type_traits>
+
+#include <jank/runtime/core/array_math.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/math.hpp>
+#include <jank/runtime/core/to_string.hpp>
+#include <jank/runtime/obj/nil.hpp>
+#include <jank/runtime/rtti.hpp>
+#include <jank/util/fmt.hpp>
+
+/* Function multiversioning needs ifunc support, which is only on ELF. The kernels flatten
+ * everything they call, so each version has its own copy of the loops to vectorize. The
+ * AVX-512 version asks for BW, which brings F along, so byte and short arrays get the
+ * full width too. */
+#if defined(__x86_64__) && defined(__ELF__)
+  #define JANK_ARRAY_KERNEL [[gnu::flatten, gnu::target_clones("avx512bw", "avx2", "default")]]
+#else
+  #define JANK_ARRAY_KERNEL [[gnu::flatten]]
+#endif
+
+namespace jank::runtime::array_math
+{
+  using element_type = obj::array::element_type;
+
+  /* Integer sums and dot products are accumulated as longs, so they don't wrap any sooner
+   * than they would in Clojure. */
+  template <typename T>
+  using wide_t = std::conditional_t<std::is_floating_point_v<T>, T, i64>;
+
+  /* sqrt and pow keep floats as floats, but anything else becomes a double. */
+  template <typename T>
+  using real_t = std::conditional_t<std::is_same_v<T, f32>, f32, f64>;
+
+  /* Signed overflow is undefined, so integers are added and multiplied as unsigned, which
+   * wraps. Anything smaller than an int gets promoted to int, so we use at least that. */
+  template <typename T>
+  using unsigned_t = std::conditional_t<(sizeof(T) < sizeof(unsigned)),
+                                        unsigned,
+                                        std::make_unsigned_t<T>>;
+
+  template <typename T>
+  [[gnu::always_inline]]
+  inline T wrapping_add(T const l, T const r)
+  {
+    if constexpr(std::is_integral_v<T>)
+    {
+      return static_cast<T>(static_cast<unsigned_t<T>>(l) + static_cast<unsigned_t<T>>(r));
+    }
+    else
+    {
+      return l + r;
+    }
+  }
+
+  template <typename T>
+  [[gnu::always_inline]]
+  inline T wrapping_mul(T const l, T const r)
+  {
+    if constexpr(std::is_integral_v<T>)
+    {
+      return static_cast<T>(static_cast<unsigned_t<T>>(l) * static_cast<unsigned_t<T>>(r));
+    }
+    else
+    {
+      return l * r;
+    }
+  }
+
+  template <typename T>
+  [[gnu::always_inline]]
+  inline T abs_of(T const o)
+  {
+    if constexpr(std::is_integral_v<T>)
+    {
+      /* The most negative value stays as it is, like Java's Math/abs. */
+      return o < 0 ? static_cast<T>(-static_cast<unsigned_t<T>>(o)) : o;
+    }
+    else
+    {
+      return std::fabs(o);
+    }
+  }
+
+  template <typename F>
+  [[gnu::always_inline]]
+  inline decltype(auto) visit_numeric(element_type const element, F &&f)
+  {
+    switch(element)
+    {
+      case element_type::byte:
+        return f(i8{});
+      case element_type::short_:
+        return f(i16{});
+      case element_type::int_:
+        return f(i32{});
+      case element_type::long_:
+        return f(i64{});
+      case element_type::float_:
+        return f(f32{});
+      case element_type::double_:
+        return f(f64{});
+      default:
+        /* Arrays are checked for this before we get here. */
+        __builtin_unreachable();
+    }
+  }
+
+  static bool is_numeric(element_type const element)
+  {
+    return element != element_type::object && element != element_type::boolean
+      && element != element_type::char_;
+  }
+
+  static obj::array &expect_numeric(object_ref const o, char const * const op)
+  {
+    if(o->type != object_type::array || !is_numeric(expect_object<obj::array>(o)->element))
+    {
+      throw std::runtime_error{ util::format("{} needs an array of numbers, not {}",
+                                             op,
+                                             runtime::to_code_string(o)) };
+    }
+    return *expect_object<obj::array>(o);
+  }
+
+  static void expect_same_shape(obj::array const &l, obj::array const &r, char const * const op)
+  {
+    if(l.element != r.element || l.length != r.length)
+    {
+      throw std::runtime_error{ util::format(
+        "{} needs arrays with the same element type and length, not {} and {}",
+        op,
+        l.to_string(),
+        r.to_string()) };
+    }
+  }
+
+  /* The loops. These are only ever inlined into a kernel, so they're compiled for the
+   * kernel's target. */
+
+  template <typename In, typename Out, typename F>
+  [[gnu::always_inline]]
+  inline void map1(In const * __restrict const in, Out * __restrict const out, usize const n, F f)
+  {
+    for(usize i{}; i < n; ++i)
+    {
+      out[i] = f(in[i]);
+    }
+  }
+
+  template <typename T, typename F>
+  [[gnu::always_inline]]
+  inline void map2(T const * __restrict const l,
+                   T const * __restrict const r,
+                   T * __restrict const out,
+                   usize const n,
+                   F f)
+  {
+    for(usize i{}; i < n; ++i)
+    {
+      out[i] = f(l[i], r[i]);
+    }
+  }
+
+  template <typename T>
+  [[gnu::always_inline]]
+  inline void fma_loop(T const * __restrict const a,
+                       T const * __restrict const b,
+                       T const * __restrict const c,
+                       T * __restrict const out,
+                       usize const n)
+  {
+#pragma clang fp contract(fast)
+    for(usize i{}; i < n; ++i)
+    {
+      out[i] = wrapping_add(wrapping_mul(a[i], b[i]), c[i]);
+    }
+  }
+
+  /* Vectorizing a floating point sum means adding in a different order, which can round a
+   * little differently from a scalar loop. That's worth it for bulk math. */
+  template <typename T>
+  [[gnu::always_inline]]
+  inline wide_t<T> sum_loop(T const * __restrict const data, usize const n)
+  {
+#pragma clang fp reassociate(on)
+    wide_t<T> ret{};
+    for(usize i{}; i < n; ++i)
+    {
+      ret = wrapping_add(ret, static_cast<wide_t<T>>(data[i]));
+    }
+    return ret;
+  }
+
+  template <typename T>
+  [[gnu::always_inline]]
+  inline wide_t<T> dot_loop(T const * __restrict const l, T const * __restrict const r, usize const n)
+  {
+#pragma clang fp reassociate(on) contract(fast)
+    wide_t<T> ret{};
+    for(usize i{}; i < n; ++i)
+    {
+      ret = wrapping_add(
+        ret,
+        wrapping_mul(static_cast<wide_t<T>>(l[i]), static_cast<wide_t<T>>(r[i])));
+    }
+    return ret;
+  }
+
+  template <typename T, typename F>
+  [[gnu::always_inline]]
+  inline T fold_loop(T const * __restrict const data, usize const n, F f)
+  {
+    T ret{ data[0] };
+    for(usize i{ 1 }; i < n; ++i)
+    {
+      ret = f(ret, data[i]);
+    }
+    return ret;
+  }
+
+  /* The kernels. Each one switches on the element type once and then runs a loop over
+   * the raw elements. */
+
+  JANK_ARRAY_KERNEL
+  static void add_kernel(obj::array const &l, obj::array const &r, obj::array &out)
+  {
+    visit_numeric(out.element, [&](auto const tag) {
+      using T = decltype(tag);
+      map2(l.data_as<T>(), r.data_as<T>(), out.data_as<T>(), out.length, [](T const a, T const b) {
+        return wrapping_add(a, b);
+      });
+    });
+  }
+
+  JANK_ARRAY_KERNEL
+  static void mul_kernel(obj::array const &l, obj::array const &r, obj::array &out)
+  {
+    visit_numeric(out.element, [&](auto const tag) {
+      using T = decltype(tag);
+      map2(l.data_as<T>(), r.data_as<T>(), out.data_as<T>(), out.length, [](T const a, T const b) {
+        return wrapping_mul(a, b);
+      });
+    });
+  }
+
+  JANK_ARRAY_KERNEL
+  static void
+  fma_kernel(obj::array const &a, obj::array const &b, obj::array const &c, obj::array &out)
+  {
+    visit_numeric(out.element, [&](auto const tag) {
+      using T = decltype(tag);
+      fma_loop(a.data_as<T>(), b.data_as<T>(), c.data_as<T>(), out.data_as<T>(), out.length);
+    });
+  }
+
+  JANK_ARRAY_KERNEL
+  static object_ref sum_kernel(obj::array const &a)
+  {
+    return visit_numeric(a.element, [&](auto const tag) -> object_ref {
+      using T = decltype(tag);
+      return make_box(static_cast<std::conditional_t<std::is_integral_v<T>, i64, f64>>(
+        sum_loop(a.data_as<T>(), a.length)));
+    });
+  }
+
+  JANK_ARRAY_KERNEL
+  static object_ref dot_kernel(obj::array const &l, obj::array const &r)
+  {
+    return visit_numeric(l.element, [&](auto const tag) -> object_ref {
+      using T = decltype(tag);
+      return make_box(static_cast<std::conditional_t<std::is_integral_v<T>, i64, f64>>(
+        dot_loop(l.data_as<T>(), r.data_as<T>(), l.length)));
+    });
+  }
+
+  JANK_ARRAY_KERNEL
+  static object_ref min_kernel(obj::array const &a)
+  {
+    return visit_numeric(a.element, [&](auto const tag) -> object_ref {
+      using T = decltype(tag);
+      return make_box(
+        static_cast<std::conditional_t<std::is_integral_v<T>, i64, f64>>(fold_loop(
+          a.data_as<T>(),
+          a.length,
+          [](T const acc, T const e) { return e < acc ? e : acc; })));
+    });
+  }
+
+  JANK_ARRAY_KERNEL
+  static object_ref max_kernel(obj::array const &a)
+  {
+    return visit_numeric(a.element, [&](auto const tag) -> object_ref {
+      using T = decltype(tag);
+      return make_box(
+        static_cast<std::conditional_t<std::is_integral_v<T>, i64, f64>>(fold_loop(
+          a.data_as<T>(),
+          a.length,
+          [](T const acc, T const e) { return acc < e ? e : acc; })));
+    });
+  }
+
+  JANK_ARRAY_KERNEL
+  static void sqrt_kernel(obj::array const &a, obj::array &out)
+  {
+    visit_numeric(a.element, [&](auto const tag) {
+      using T = decltype(tag);
+      using R = real_t<T>;
+      map1(a.data_as<T>(), out.data_as<R>(), a.length, [](T const e) {
+        return std::sqrt(static_cast<R>(e));
+      });
+    });
+  }
+
+  JANK_ARRAY_KERNEL
+  static void pow_kernel(obj::array const &a, f64 const exponent, obj::array &out)
+  {
+    visit_numeric(a.element, [&](auto const tag) {
+      using T = decltype(tag);
+      using R = real_t<T>;
+      auto const e(static_cast<R>(exponent));
+      map1(a.data_as<T>(), out.data_as<R>(), a.length, [=](T const o) {
+        return std::pow(static_cast<R>(o), e);
+      });
+    });
+  }
+
+  JANK_ARRAY_KERNEL
+  static void abs_kernel(obj::array const &a, obj::array &out)
+  {
+    visit_numeric(a.element, [&](auto const tag) {
+      using T = decltype(tag);
+      map1(a.data_as<T>(), out.data_as<T>(), a.length, [](T const e) { return abs_of(e); });
+    });
+  }
+
+  static element_type real_element(element_type const element)
+  {
+    return element == element_type::float_ ? element_type::float_ : element_type::double_;
+  }
+
+  obj::array_ref add(object_ref const l, object_ref const r)
+  {
+    auto const &typed_l(expect_numeric(l, "add"));
+    auto const &typed_r(expect_numeric(r, "add"));
+    expect_same_shape(typed_l, typed_r, "add");
+    auto const ret(make_box<obj::array>(typed_l.element, typed_l.length));
+    add_kernel(typed_l, typed_r, *ret);
+    return ret;
+  }
+
+  obj::array_ref mul(object_ref const l, object_ref const r)
+  {
+    auto const &typed_l(expect_numeric(l, "mul"));
+    auto const &typed_r(expect_numeric(r, "mul"));
+    expect_same_shape(typed_l, typed_r, "mul");
+    auto const ret(make_box<obj::array>(typed_l.element, typed_l.length));
+    mul_kernel(typed_l, typed_r, *ret);
+    return ret;
+  }
+
+  obj::array_ref fma(object_ref const a, object_ref const b, object_ref const c)
+  {
+    auto const &typed_a(expect_numeric(a, "fma"));
+    auto const &typed_b(expect_numeric(b, "fma"));
+    auto const &typed_c(expect_numeric(c, "fma"));
+    expect_same_shape(typed_a, typed_b, "fma");
+    expect_same_shape(typed_a, typed_c, "fma");
+    auto const ret(make_box<obj::array>(typed_a.element, typed_a.length));
+    fma_kernel(typed_a, typed_b, typed_c, *ret);
+    return ret;
+  }
+
+  object_ref dot(object_ref const l, object_ref const r)
+  {
+    auto const &typed_l(expect_numeric(l, "dot"));
+    auto const &typed_r(expect_numeric(r, "dot"));
+    expect_same_shape(typed_l, typed_r, "dot");
+    return dot_kernel(typed_l, typed_r);
+  }
+
+  object_ref sum(object_ref const a)
+  {
+    return sum_kernel(expect_numeric(a, "sum"));
+  }
+
+  object_ref min(object_ref const a)
+  {
+    auto const &typed_a(expect_numeric(a, "min"));
+    if(typed_a.length == 0)
+    {
+      return jank_nil();
+    }
+    return min_kernel(typed_a);
+  }
+
+  object_ref max(object_ref const a)
+  {
+    auto const &typed_a(expect_numeric(a, "max"));
+    if(typed_a.length == 0)
+    {
+      return jank_nil();
+    }
+    return max_kernel(typed_a);
+  }
+
+  object_ref sqrt(object_ref const o)
+  {
+    if(o->type != object_type::array)
+    {
+      return make_box(runtime::sqrt(o));
+    }
+
+    auto const &typed_o(expect_numeric(o, "sqrt"));
+    auto const ret(make_box<obj::array>(real_element(typed_o.element), typed_o.length));
+    sqrt_kernel(typed_o, *ret);
+    return ret;
+  }
+
+  object_ref pow(object_ref const o, object_ref const exponent)
+  {
+    if(o->type != object_type::array)
+    {
+      return make_box(runtime::pow(o, exponent));
+    }
+
+    auto const &typed_o(expect_numeric(o, "pow"));
+    auto const ret(make_box<obj::array>(real_element(typed_o.element), typed_o.length));
+    pow_kernel(typed_o, to_real(exponent), *ret);
+    return ret;
+  }
+
+  object_ref abs(object_ref const o)
+  {
+    if(o->type != object_type::array)
+    {
+      return runtime::abs(o);
+    }
+
+    auto const &typed_o(expect_numeric(o, "abs"));
+    auto const ret(make_box<obj::array>(typed_o.element, typed_o.length));
+    abs_kernel(typed_o, *ret);
+    return ret;
+  }
+}
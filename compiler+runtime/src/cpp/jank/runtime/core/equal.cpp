@@ -1,6 +1,7 @@
 #include <jank/runtime/core/equal.hpp>
 #include <jank/runtime/behavior/comparable.hpp>
 #include <jank/runtime/visit.hpp>
+#include <jank/runtime/behavior_table.hpp>
 #include <jank/util/fmt.hpp>
 
 namespace jank::runtime
@@ -16,18 +17,72 @@ namespace jank::runtime
     return typed_rhs->to_hash() == static_cast<uhash>(lhs);
   }
 
+  /* The hash which a collection has already cached, or zero if it hasn't been hashed yet.
+   * Equal collections hash the same, even across types, such as a vector and a list. */
+  static uhash cached_hash(object const &o)
+  {
+    switch(o.type)
+    {
+      case object_type::persistent_vector:
+        return expect_object<obj::persistent_vector>(&o)->hash;
+      case object_type::persistent_list:
+        return expect_object<obj::persistent_list>(&o)->hash;
+      case object_type::persistent_array_map:
+        return expect_object<obj::persistent_array_map>(&o)->hash;
+      case object_type::persistent_hash_map:
+        return expect_object<obj::persistent_hash_map>(&o)->hash;
+      case object_type::persistent_sorted_map:
+        return expect_object<obj::persistent_sorted_map>(&o)->hash;
+      case object_type::persistent_int_map:
+        return expect_object<obj::persistent_int_map>(&o)->hash;
+      case object_type::mapped_vector:
+        return expect_object<obj::mapped_vector>(&o)->hash;
+      case object_type::mapped_map:
+        return expect_object<obj::mapped_map>(&o)->hash;
+      case object_type::persistent_hash_set:
+        return expect_object<obj::persistent_hash_set>(&o)->hash;
+      case object_type::persistent_sorted_set:
+        return expect_object<obj::persistent_sorted_set>(&o)->hash;
+      default:
+        return 0;
+    }
+  }
+
   bool equal(object_ref const lhs, object_ref const rhs)
   {
-    if(lhs.is_nil())
+    /* Every object is equal to itself, which also covers nil, since there's only one. */
+    if(lhs.data == rhs.data)
     {
-      return rhs.is_nil();
+      return true;
     }
-    else if(rhs.is_nil())
+    if(lhs.is_nil() || rhs.is_nil())
     {
       return false;
     }
 
-    return visit_object([&](auto const typed_lhs) { return typed_lhs->equal(*rhs); }, lhs);
+    switch(lhs->type)
+    {
+      /* Keywords are interned, so different keywords are never equal. */
+      case object_type::keyword:
+        return false;
+      case object_type::boolean:
+        return rhs->type == object_type::boolean
+          && expect_object<obj::boolean>(lhs)->data == expect_object<obj::boolean>(rhs)->data;
+      default:
+        break;
+    }
+
+    /* Comparing collections means walking all of them, but if both have been hashed, such
+     * as by being used as keys, differing hashes tell us they're not equal right away. */
+    if(auto const lhs_hash{ cached_hash(*lhs) }; lhs_hash != 0)
+    {
+      if(auto const rhs_hash{ cached_hash(*rhs) }; rhs_hash != 0 && lhs_hash != rhs_hash)
+      {
+        return false;
+      }
+    }
+
+    return behaviors_of(lhs).equal(lhs.data, *rhs);
   }
 
   i64 compare(object_ref const l, object_ref const r)
@@ -0,0 +1,296 @@
+#include <atomic>
+#include <exception>
+#include <thread>
+
+#include <jank/runtime/core/fold.hpp>
+#include <jank/runtime/core/math.hpp>
+#include <jank/runtime/core/seq.hpp>
+#include <jank/runtime/behavior/callable.hpp>
+#include <jank/runtime/executor.hpp>
+#include <jank/runtime/rtti.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/obj/array.hpp>
+#include <jank/runtime/obj/integer_range.hpp>
+#include <jank/runtime/obj/persistent_vector.hpp>
+#include <jank/runtime/obj/persistent_array_map.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
+#include <jank/runtime/obj/persistent_sorted_map.hpp>
+#include <jank/runtime/obj/persistent_int_map.hpp>
+#include <jank/runtime/obj/reduced.hpp>
+
+namespace jank::runtime
+{
+  /* The half of a split which is handed off to the pool. */
+  struct fold_fork
+  {
+    object_ref result{};
+    std::exception_ptr error{};
+    std::atomic_bool done{};
+  };
+
+  /* Runs right on the pool and left on this thread, then combines them. While waiting on
+   * right, this thread runs other queued work, which is usually right itself or one of its
+   * own splits. */
+  template <typename L, typename R>
+  static object_ref fork_join(object_ref const combinef, L const &left, R const &right)
+  {
+    auto &pool{ pooled_executor() };
+    /* This is GC allocated, rather than on our stack, so the result is visible to the GC
+     * from the worker which writes it. */
+    auto * const forked{ new(GC) fold_fork{} };
+    pool.submit([forked, right] {
+      try
+      {
+        forked->result = right();
+      }
+      catch(...)
+      {
+        forked->error = std::current_exception();
+      }
+      forked->done.store(true, std::memory_order_release);
+    });
+
+    object_ref left_result{};
+    std::exception_ptr left_error{};
+    try
+    {
+      left_result = left();
+    }
+    catch(...)
+    {
+      left_error = std::current_exception();
+    }
+
+    /* We always join, even if left failed, since right refers to the collection we're
+     * folding. */
+    while(!forked->done.load(std::memory_order_acquire))
+    {
+      if(!pool.run_pending_task())
+      {
+        std::this_thread::yield();
+      }
+    }
+
+    if(left_error)
+    {
+      std::rethrow_exception(left_error);
+    }
+    if(forked->error)
+    {
+      std::rethrow_exception(forked->error);
+    }
+    return dynamic_call(combinef, left_result, forked->result);
+  }
+
+  /* Reduces a single group. A reduced value only stops the group it's in, as in Clojure. */
+  template <typename It>
+  static object_ref
+  reduce_group(object_ref const combinef, object_ref const reducef, It begin, It const end)
+  {
+    object_ref res{ dynamic_call(combinef) };
+    for(; begin != end; ++begin)
+    {
+      if constexpr(std::same_as<jtl::decay_t<decltype(*begin)>, object_ref>)
+      {
+        res = dynamic_call(reducef, res, *begin);
+      }
+      else
+      {
+        auto const &entry{ *begin };
+        res = dynamic_call(reducef, res, entry.first, entry.second);
+      }
+
+      if(res->type == object_type::reduced)
+      {
+        return expect_object<obj::reduced>(res)->val;
+      }
+    }
+    return res;
+  }
+
+  static object_ref fold_vector(runtime::detail::native_persistent_vector const &v,
+                                usize const start,
+                                usize const end,
+                                usize const n,
+                                object_ref const combinef,
+                                object_ref const reducef)
+  {
+    if(end - start <= n)
+    {
+      return reduce_group(combinef, reducef, v.begin() + start, v.begin() + end);
+    }
+
+    auto const mid{ start + ((end - start) / 2) };
+    return fork_join(
+      combinef,
+      [&] { return fold_vector(v, start, mid, n, combinef, reducef); },
+      [&v, mid, end, n, combinef, reducef] {
+        return fold_vector(v, mid, end, n, combinef, reducef);
+      });
+  }
+
+  /* Folds anything with constant time access to its elements by index. */
+  template <typename G>
+  static object_ref fold_indexed(G const &get,
+                                 usize const start,
+                                 usize const end,
+                                 usize const n,
+                                 object_ref const combinef,
+                                 object_ref const reducef)
+  {
+    if(end - start <= n)
+    {
+      object_ref res{ dynamic_call(combinef) };
+      for(usize i{ start }; i < end; ++i)
+      {
+        res = dynamic_call(reducef, res, get(i));
+        if(res->type == object_type::reduced)
+        {
+          return expect_object<obj::reduced>(res)->val;
+        }
+      }
+      return res;
+    }
+
+    auto const mid{ start + ((end - start) / 2) };
+    return fork_join(
+      combinef,
+      [&] { return fold_indexed(get, start, mid, n, combinef, reducef); },
+      [&get, mid, end, n, combinef, reducef] {
+        return fold_indexed(get, mid, end, n, combinef, reducef);
+      });
+  }
+
+  using hash_map_entry = runtime::detail::native_persistent_hash_map::value_type;
+
+  /* A leaf of the hash map's trie, along with how many entries come before it. */
+  struct hash_map_chunk
+  {
+    hash_map_entry const *begin{};
+    hash_map_entry const *end{};
+    usize offset{};
+  };
+
+  static object_ref fold_hash_map(native_vector<hash_map_chunk> const &chunks,
+                                  usize const start,
+                                  usize const end,
+                                  usize const n,
+                                  object_ref const combinef,
+                                  object_ref const reducef)
+  {
+    auto const last{ end - 1 };
+    auto const entry_count{ chunks[last].offset + (chunks[last].end - chunks[last].begin)
+                            - chunks[start].offset };
+    if(end - start == 1 || entry_count <= n)
+    {
+      object_ref res{ dynamic_call(combinef) };
+      for(usize i{ start }; i < end; ++i)
+      {
+        for(auto it{ chunks[i].begin }; it != chunks[i].end; ++it)
+        {
+          res = dynamic_call(reducef, res, it->first, it->second);
+          if(res->type == object_type::reduced)
+          {
+            return expect_object<obj::reduced>(res)->val;
+          }
+        }
+      }
+      return res;
+    }
+
+    auto const mid{ start + ((end - start) / 2) };
+    return fork_join(
+      combinef,
+      [&] { return fold_hash_map(chunks, start, mid, n, combinef, reducef); },
+      [&chunks, mid, end, n, combinef, reducef] {
+        return fold_hash_map(chunks, mid, end, n, combinef, reducef);
+      });
+  }
+
+  object_ref fold(object_ref const n,
+                  object_ref const combinef,
+                  object_ref const reducef,
+                  object_ref const coll)
+  {
+    auto const group_size{ static_cast<usize>(std::max<i64>(to_int(n), 1)) };
+
+    switch(coll->type)
+    {
+      case object_type::persistent_vector:
+        {
+          auto const &v{ expect_object<obj::persistent_vector>(coll)->data };
+          if(v.empty())
+          {
+            return dynamic_call(combinef);
+          }
+          return fold_vector(v, 0, v.size(), group_size, combinef, reducef);
+        }
+      case object_type::persistent_hash_map:
+        {
+          /* The trie's leaves are contiguous arrays of entries, so we split on those,
+           * rather than walking the map. */
+          native_vector<hash_map_chunk> chunks;
+          usize offset{};
+          expect_object<obj::persistent_hash_map>(coll)->data.for_each_chunk(
+            [&](hash_map_entry const *begin, hash_map_entry const *end) {
+              if(begin != end)
+              {
+                chunks.push_back({ begin, end, offset });
+                offset += end - begin;
+              }
+            });
+          if(chunks.empty())
+          {
+            return dynamic_call(combinef);
+          }
+          return fold_hash_map(chunks, 0, chunks.size(), group_size, combinef, reducef);
+        }
+      case object_type::integer_range:
+        {
+          auto const r{ expect_object<obj::integer_range>(coll) };
+          auto const count{ r->count() };
+          if(count == 0)
+          {
+            return dynamic_call(combinef);
+          }
+          auto const start{ r->start->data };
+          auto const step{ r->step->data };
+          auto const get([=](usize const i) -> object_ref {
+            return make_box(start + (static_cast<i64>(i) * step));
+          });
+          return fold_indexed(get, 0, count, group_size, combinef, reducef);
+        }
+      case object_type::array:
+        {
+          auto const a{ expect_object<obj::array>(coll) };
+          if(a->length == 0)
+          {
+            return dynamic_call(combinef);
+          }
+          return fold_indexed([a](usize const i) { return a->get(i); },
+                              0,
+                              a->length,
+                              group_size,
+                              combinef,
+                              reducef);
+        }
+      case object_type::persistent_array_map:
+        {
+          auto const &data{ expect_object<obj::persistent_array_map>(coll)->data };
+          return reduce_group(combinef, reducef, data.begin(), data.end());
+        }
+      case object_type::persistent_sorted_map:
+        {
+          auto const &data{ expect_object<obj::persistent_sorted_map>(coll)->data };
+          return reduce_group(combinef, reducef, data.begin(), data.end());
+        }
+      case object_type::persistent_int_map:
+        {
+          auto const &data{ expect_object<obj::persistent_int_map>(coll)->data };
+          return reduce_group(combinef, reducef, data.begin(), data.end());
+        }
+      default:
+        return reduce(reducef, dynamic_call(combinef), coll);
+    }
+  }
+}
@@ -0,0 +1,583 @@
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <string_view>
+
+#include <folly/Synchronized.h>
+
+#include <jank/runtime/core/format.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/math.hpp>
+#include <jank/runtime/core/to_string.hpp>
+#include <jank/runtime/obj/character.hpp>
+#include <jank/runtime/rtti.hpp>
+#include <jank/runtime/sequence_range.hpp>
+#include <jank/util/fmt.hpp>
+
+namespace jank::runtime
+{
+  namespace
+  {
+    struct segment
+    {
+      /* Literal text comes through as a conversion of zero. */
+      jtl::immutable_string text;
+      char conversion{};
+      bool upper{};
+      bool left{};
+      bool zero{};
+      bool plus{};
+      bool space{};
+      bool group{};
+      bool alt{};
+      bool paren{};
+      /* Negative when not given. */
+      i32 width{ -1 };
+      i32 precision{ -1 };
+      /* Zero for the next arg, negative for the same arg as last time, and otherwise the
+       * 1-based index of the arg. */
+      i32 index{};
+    };
+
+    struct format_spec
+    {
+      native_vector<segment> segments;
+      usize literal_size{};
+    };
+  }
+
+  [[noreturn]]
+  static void format_error(jtl::immutable_string const &msg)
+  {
+    throw make_box(msg).erase();
+  }
+
+  static i32 parse_number(char const *&it, char const * const end)
+  {
+    i32 ret{};
+    auto const [ptr, ec](std::from_chars(it, end, ret));
+    if(ec != std::errc{})
+    {
+      format_error("Invalid number in format string");
+    }
+    it = ptr;
+    return ret;
+  }
+
+  static format_spec parse(jtl::immutable_string const &fmt)
+  {
+    format_spec spec;
+    auto it(fmt.data());
+    auto const end(fmt.data() + fmt.size());
+    auto literal_start(it);
+
+    auto const flush_literal([&](char const * const literal_end) {
+      if(literal_start != literal_end)
+      {
+        spec.segments.push_back({ .text = jtl::immutable_string{
+                                    literal_start,
+                                    static_cast<usize>(literal_end - literal_start) } });
+        spec.literal_size += static_cast<usize>(literal_end - literal_start);
+      }
+    });
+
+    while(it != end)
+    {
+      if(*it != '%')
+      {
+        ++it;
+        continue;
+      }
+
+      flush_literal(it);
+      ++it;
+      segment seg;
+
+      /* An arg index, like %2$s, looks like a width until we see the $. */
+      if(it != end && '0' < *it && *it <= '9')
+      {
+        auto digits_end(it);
+        while(digits_end != end && '0' <= *digits_end && *digits_end <= '9')
+        {
+          ++digits_end;
+        }
+        if(digits_end != end && *digits_end == '$')
+        {
+          seg.index = parse_number(it, digits_end);
+          it = digits_end + 1;
+        }
+      }
+
+      for(; it != end; ++it)
+      {
+        switch(*it)
+        {
+          case '-':
+            seg.left = true;
+            continue;
+          case '0':
+            seg.zero = true;
+            continue;
+          case '+':
+            seg.plus = true;
+            continue;
+          case ' ':
+            seg.space = true;
+            continue;
+          case ',':
+            seg.group = true;
+            continue;
+          case '#':
+            seg.alt = true;
+            continue;
+          case '(':
+            seg.paren = true;
+            continue;
+          case '<':
+            seg.index = -1;
+            continue;
+          default:
+            break;
+        }
+        break;
+      }
+
+      if(it != end && '0' < *it && *it <= '9')
+      {
+        seg.width = parse_number(it, end);
+      }
+      if(it != end && *it == '.')
+      {
+        ++it;
+        seg.precision = parse_number(it, end);
+      }
+      if(it == end)
+      {
+        format_error("Format string ends in an incomplete specifier");
+      }
+
+      seg.conversion = *it;
+      ++it;
+      switch(seg.conversion)
+      {
+        case 'S':
+        case 'X':
+        case 'E':
+        case 'G':
+        case 'B':
+        case 'H':
+        case 'C':
+          seg.upper = true;
+          seg.conversion = static_cast<char>(seg.conversion - 'A' + 'a');
+          break;
+        case 's':
+        case 'd':
+        case 'x':
+        case 'o':
+        case 'f':
+        case 'e':
+        case 'g':
+        case 'b':
+        case 'h':
+        case 'c':
+          break;
+        case 'n':
+        case '%':
+          /* These take no arg, so they're just literal text. */
+          literal_start = it;
+          spec.segments.push_back(
+            { .text = seg.conversion == 'n' ? jtl::immutable_string{ "\n" }
+                                            : jtl::immutable_string{ "%" } });
+          ++spec.literal_size;
+          continue;
+        default:
+          format_error(util::format("Unknown format conversion '{}'", seg.conversion));
+      }
+      if(seg.left && seg.width < 0)
+      {
+        format_error("Format specifier with - needs a width");
+      }
+
+      spec.segments.push_back(std::move(seg));
+      literal_start = it;
+    }
+    flush_literal(end);
+
+    return spec;
+  }
+
+  /* Format strings are almost always literals, so there are only so many of them. Past
+   * this many, new ones are parsed each time rather than kept. Nothing is ever removed, so
+   * a spec can be used once the lock is released. */
+  static constexpr usize max_cached_specs{ 1024 };
+
+  static format_spec const &spec_for(jtl::immutable_string const &fmt)
+  {
+    static folly::Synchronized<native_unordered_map<jtl::immutable_string, format_spec>>
+      specs;
+    static thread_local format_spec uncached;
+
+    if(auto const locked = specs.rlock(); true)
+    {
+      if(auto const found(locked->find(fmt)); found != locked->end())
+      {
+        return found->second;
+      }
+    }
+
+    auto spec(parse(fmt));
+    auto locked(specs.wlock());
+    if(locked->size() < max_cached_specs)
+    {
+      return locked->try_emplace(fmt, std::move(spec)).first->second;
+    }
+    uncached = std::move(spec);
+    return uncached;
+  }
+
+  static void pad(jtl::string_builder &buff, i32 const count, char const c = ' ')
+  {
+    for(i32 i{}; i < count; ++i)
+    {
+      buff(c);
+    }
+  }
+
+  static void write(jtl::string_builder &buff, std::string_view const s)
+  {
+    if(!s.empty())
+    {
+      buff(jtl::immutable_string_view{ s });
+    }
+  }
+
+  static void write_upper(jtl::string_builder &buff, std::string_view const s)
+  {
+    for(auto const c : s)
+    {
+      buff(static_cast<char>(std::toupper(static_cast<unsigned char>(c))));
+    }
+  }
+
+  static void write_padded(jtl::string_builder &buff,
+                           segment const &seg,
+                           std::string_view const text)
+  {
+    auto const padding(seg.width - static_cast<i32>(text.size()));
+    if(!seg.left)
+    {
+      pad(buff, padding);
+    }
+    if(seg.upper)
+    {
+      write_upper(buff, text);
+    }
+    else
+    {
+      write(buff, text);
+    }
+    if(seg.left)
+    {
+      pad(buff, padding);
+    }
+  }
+
+  /* Writes a number, given its magnitude, with its sign and any grouping and padding. Only
+   * the leading digits of the magnitude are grouped. */
+  static void write_number(jtl::string_builder &buff,
+                           segment const &seg,
+                           bool const negative,
+                           std::string_view const magnitude,
+                           std::string_view const prefix = {})
+  {
+    jtl::string_builder digits{ magnitude.size() + magnitude.size() / 3 + 8 };
+    if(seg.group)
+    {
+      usize leading{};
+      while(leading < magnitude.size() && '0' <= magnitude[leading] && magnitude[leading] <= '9')
+      {
+        ++leading;
+      }
+      for(usize i{}; i < leading; ++i)
+      {
+        if(i != 0 && (leading - i) % 3 == 0)
+        {
+          digits(',');
+        }
+        digits(magnitude[i]);
+      }
+      write(digits, magnitude.substr(leading));
+    }
+    else
+    {
+      write(digits, magnitude);
+    }
+
+    std::string_view sign;
+    if(negative)
+    {
+      sign = seg.paren ? "(" : "-";
+    }
+    else if(seg.plus)
+    {
+      sign = "+";
+    }
+    else if(seg.space)
+    {
+      sign = " ";
+    }
+    auto const closing(negative && seg.paren ? 1 : 0);
+    auto const padding(seg.width
+                       - static_cast<i32>(sign.size() + prefix.size() + digits.size())
+                       - closing);
+
+    if(!seg.left && !seg.zero)
+    {
+      pad(buff, padding);
+    }
+    write(buff, sign);
+    write(buff, prefix);
+    if(!seg.left && seg.zero)
+    {
+      pad(buff, padding, '0');
+    }
+    std::string_view const grouped{ digits.data(), digits.size() };
+    if(seg.upper)
+    {
+      write_upper(buff, grouped);
+    }
+    else
+    {
+      write(buff, grouped);
+    }
+    if(closing)
+    {
+      buff(')');
+    }
+    if(seg.left)
+    {
+      pad(buff, padding);
+    }
+  }
+
+  static void write_integer(jtl::string_builder &buff, segment const &seg, object_ref const arg)
+  {
+    if(!is_integer(arg) && !is_big_integer(arg))
+    {
+      format_error(util::format("%{} can't format {}", seg.conversion, object_type_str(arg->type)));
+    }
+
+    if(seg.conversion == 'd')
+    {
+      auto const s(runtime::to_string(arg));
+      auto const negative(!s.empty() && s[0] == '-');
+      write_number(buff, seg, negative, std::string_view{ s.data(), s.size() }.substr(negative));
+      return;
+    }
+
+    /* As in Java, negative numbers are given in two's complement. */
+    auto const n(static_cast<u64>(to_int(arg)));
+    std::array<char, 24> digits{};
+    auto const res(std::to_chars(digits.data(),
+                                 digits.data() + digits.size(),
+                                 n,
+                                 seg.conversion == 'x' ? 16 : 8));
+    std::string_view prefix;
+    if(seg.alt)
+    {
+      prefix = seg.conversion == 'x' ? "0x" : "0";
+    }
+    write_number(buff,
+                 seg,
+                 false,
+                 { digits.data(), static_cast<usize>(res.ptr - digits.data()) },
+                 prefix);
+  }
+
+  static void write_floating(jtl::string_builder &buff, segment const &seg, object_ref const arg)
+  {
+    if(!is_number(arg))
+    {
+      format_error(util::format("%{} can't format {}", seg.conversion, object_type_str(arg->type)));
+    }
+
+    auto const d(to_real(arg));
+    if(std::isnan(d))
+    {
+      write_padded(buff, seg, "NaN");
+      return;
+    }
+    if(std::isinf(d))
+    {
+      auto const text(d < 0 ? (seg.paren ? "(Infinity)" : "-Infinity")
+                             : (seg.plus ? "+Infinity" : "Infinity"));
+      write_padded(buff, seg, text);
+      return;
+    }
+
+    auto precision(seg.precision < 0 ? 6 : seg.precision);
+    auto conversion(seg.conversion);
+    auto const magnitude(std::fabs(d));
+    /* Unlike C, Java's %g keeps trailing zeros and picks between %f and %e by the rounded
+     * value. */
+    if(conversion == 'g')
+    {
+      precision = std::max(precision, 1);
+      if(magnitude != 0 && (magnitude < 1e-4 || std::pow(10.0, precision) <= magnitude))
+      {
+        conversion = 'e';
+        --precision;
+      }
+      else
+      {
+        conversion = 'f';
+        auto const exponent(
+          magnitude == 0 ? 0 : static_cast<i32>(std::floor(std::log10(magnitude))));
+        precision = std::max(precision - exponent - 1, 0);
+      }
+    }
+
+    auto const chars_format(conversion == 'e' ? std::chars_format::scientific
+                                               : std::chars_format::fixed);
+    /* Room for the largest fixed doubles, along with their precision. Only unusually large
+     * precisions need to allocate. */
+    auto const required(328 + static_cast<usize>(precision));
+    std::array<char, 512> small;
+    native_vector<char> large;
+    auto digits(small.data());
+    if(small.size() < required)
+    {
+      large.resize(required);
+      digits = large.data();
+    }
+    auto const res(std::to_chars(digits, digits + required, magnitude, chars_format, precision));
+    auto size(static_cast<usize>(res.ptr - digits));
+    if(seg.alt && precision == 0 && conversion == 'f')
+    {
+      digits[size++] = '.';
+    }
+    write_number(buff, seg, std::signbit(d), { digits, size });
+  }
+
+  static void write_char(jtl::string_builder &buff, segment const &seg, object_ref const arg)
+  {
+    if(arg->type == object_type::character)
+    {
+      auto const &data(expect_object<obj::character>(arg)->data);
+      write_padded(buff, seg, { data.data(), data.size() });
+      return;
+    }
+    if(!is_integer(arg))
+    {
+      format_error(util::format("%c can't format {}", object_type_str(arg->type)));
+    }
+
+    jtl::string_builder c;
+    c(static_cast<char32_t>(to_int(arg)));
+    write_padded(buff, seg, { c.data(), c.size() });
+  }
+
+  static void write_segment(jtl::string_builder &buff, segment const &seg, object_ref const arg)
+  {
+    switch(seg.conversion)
+    {
+      case 's':
+        {
+          auto const s(arg.is_nil() ? jtl::immutable_string{ "null" } : runtime::to_string(arg));
+          std::string_view view{ s.data(), s.size() };
+          if(0 <= seg.precision && static_cast<usize>(seg.precision) < view.size())
+          {
+            view = view.substr(0, static_cast<usize>(seg.precision));
+          }
+          write_padded(buff, seg, view);
+          return;
+        }
+      case 'b':
+        {
+          auto const b(arg.is_nil() ? false
+                                    : (arg->type == object_type::boolean ? truthy(arg) : true));
+          write_padded(buff, seg, b ? "true" : "false");
+          return;
+        }
+      case 'h':
+        {
+          if(arg.is_nil())
+          {
+            write_padded(buff, seg, "null");
+            return;
+          }
+          std::array<char, 24> digits{};
+          auto const res(
+            std::to_chars(digits.data(), digits.data() + digits.size(), to_hash(arg), 16));
+          write_padded(buff, seg, { digits.data(), static_cast<usize>(res.ptr - digits.data()) });
+          return;
+        }
+      case 'c':
+        write_char(buff, seg, arg);
+        return;
+      case 'd':
+      case 'x':
+      case 'o':
+        write_integer(buff, seg, arg);
+        return;
+      default:
+        write_floating(buff, seg, arg);
+        return;
+    }
+  }
+
+  jtl::immutable_string format(object_ref const fmt, object_ref const args)
+  {
+    if(fmt->type != object_type::persistent_string)
+    {
+      format_error(util::format("format needs a string, not {}", object_type_str(fmt->type)));
+    }
+
+    auto const &spec(spec_for(expect_object<obj::persistent_string>(fmt)->data));
+    native_vector<object_ref> arg_values;
+    for_each_item(args, [&](object_ref const o) { arg_values.emplace_back(o); });
+
+    jtl::string_builder buff{ spec.literal_size + arg_values.size() * 8 + 1 };
+    usize next{};
+    usize last{};
+    bool has_last{};
+    for(auto const &seg : spec.segments)
+    {
+      if(seg.conversion == 0)
+      {
+        buff(seg.text);
+        continue;
+      }
+
+      usize index{};
+      if(seg.index < 0)
+      {
+        if(!has_last)
+        {
+          format_error("Format specifier with < has no previous arg");
+        }
+        index = last;
+      }
+      else if(seg.index == 0)
+      {
+        index = next++;
+      }
+      else
+      {
+        index = static_cast<usize>(seg.index - 1);
+      }
+      if(arg_values.size() <= index)
+      {
+        format_error(util::format("Format specifier %{} is missing its arg", seg.conversion));
+      }
+
+      write_segment(buff, seg, arg_values[index]);
+      last = index;
+      has_last = true;
+    }
+
+    return buff.release();
+  }
+}
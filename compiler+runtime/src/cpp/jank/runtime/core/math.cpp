@@ -1,9 +1,13 @@
-#include <random>
+#include <array>
+#include <tuple>
+#include <utility>
 
 #include <jank/runtime/core/math.hpp>
 #include <jank/runtime/behavior/number_like.hpp>
 #include <jank/runtime/visit.hpp>
 #include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/random.hpp>
+#include <jank/runtime/obj/big_integer.hpp>
 #include <jank/util/fmt/print.hpp>
 
 namespace jank::runtime
@@ -35,17 +39,127 @@ namespace jank::runtime
     }
   }
 
-  /* TODO: visit_number_like */
+  /* The number types are contiguous in object_type, from integer through ratio, so any
+   * pair of them maps onto a 2D table. Each binary op gets its own table, with one fn per
+   * pair of types, all instantiated from the same body. This is a single indirect call,
+   * rather than the nested visits which would branch on each operand in turn. */
+  using number_types
+    = std::tuple<obj::integer, obj::big_integer, obj::big_decimal, obj::real, obj::ratio>;
+  static constexpr usize number_type_count{ std::tuple_size_v<number_types> };
+
+  template <usize... Is>
+  static constexpr bool is_number_type_order(std::index_sequence<Is...>)
+  {
+    return ((std::tuple_element_t<Is, number_types>::obj_type
+             == static_cast<object_type>(static_cast<usize>(object_type::integer) + Is))
+            && ...);
+  }
+
+  static_assert(is_number_type_order(std::make_index_sequence<number_type_count>{}));
+
+  template <typename F, usize I>
+  static auto number_pair_entry(object_ref const l, object_ref const r)
+  {
+    using L = std::tuple_element_t<I / number_type_count, number_types>;
+    using R = std::tuple_element_t<I % number_type_count, number_types>;
+    return F{}(expect_object<L>(l), expect_object<R>(r));
+  }
+
+  template <typename F, usize... Is>
+  static constexpr auto number_pair_table(std::index_sequence<Is...>)
+  {
+    using R = decltype(F{}(obj::integer_ref{}, obj::integer_ref{}));
+    return std::array<R (*)(object_ref, object_ref), sizeof...(Is)>{
+      &number_pair_entry<F, Is>...
+    };
+  }
+
+  /* F needs to be a captureless lambda, since each table entry makes its own. Throws if
+   * either object isn't a number. */
+  template <typename F>
+  [[gnu::hot]]
+  static auto visit_number_pair(F const &, object_ref const l, object_ref const r)
+  {
+    static constexpr auto table{ number_pair_table<F>(
+      std::make_index_sequence<number_type_count * number_type_count>{}) };
+
+    /* Anything before integer wraps around to a huge index, so one check covers both. */
+    auto const l_index{ static_cast<usize>(l->type) - static_cast<usize>(object_type::integer) };
+    auto const r_index{ static_cast<usize>(r->type) - static_cast<usize>(object_type::integer) };
+    if(number_type_count <= l_index || number_type_count <= r_index) [[unlikely]]
+    {
+      throw std::runtime_error{ "not a number: "
+                                + to_code_string(number_type_count <= l_index ? l : r) };
+    }
+
+    return table[l_index * number_type_count + r_index](l, r);
+  }
+
+  /* Integer math where either side is a big_integer goes through its small value fast
+   * paths. Everything else uses the data's own operators. */
+  template <typename L, typename R>
+  static constexpr bool is_big_integer_math{
+    (std::same_as<L, native_big_integer> || std::same_as<R, native_big_integer>)
+    && (std::same_as<L, native_big_integer> || std::same_as<L, i64>)
+    && (std::same_as<R, native_big_integer> || std::same_as<R, i64>)
+  };
+
+  template <typename L, typename R>
+  static auto add_data(L const &l, R const &r)
+  {
+    if constexpr(is_big_integer_math<L, R>)
+    {
+      return obj::big_integer::add(native_big_integer{ l }, native_big_integer{ r });
+    }
+    else
+    {
+      return l + r;
+    }
+  }
+
+  template <typename L, typename R>
+  static auto sub_data(L const &l, R const &r)
+  {
+    if constexpr(is_big_integer_math<L, R>)
+    {
+      return obj::big_integer::sub(native_big_integer{ l }, native_big_integer{ r });
+    }
+    else
+    {
+      return l - r;
+    }
+  }
+
+  template <typename L, typename R>
+  static auto mul_data(L const &l, R const &r)
+  {
+    if constexpr(is_big_integer_math<L, R>)
+    {
+      return obj::big_integer::mul(native_big_integer{ l }, native_big_integer{ r });
+    }
+    else
+    {
+      return l * r;
+    }
+  }
+
   object_ref add(object_ref const l, object_ref const r)
   {
-    return visit_number_like(
-      [](auto const typed_l, auto const r) -> object_ref {
-        return visit_number_like(
-          [](auto const typed_r, auto const &typed_l) -> object_ref {
-            return make_box(typed_l + typed_r->data).erase();
-          },
-          r,
-          typed_l->data);
+    if(l->type == object_type::integer && r->type == object_type::integer)
+    {
+      i64 res{};
+      if(__builtin_add_overflow(expect_object<obj::integer>(l)->data,
+                                expect_object<obj::integer>(r)->data,
+                                &res)) [[unlikely]]
+      {
+        throw std::runtime_error{ "integer overflow" };
+      }
+      return make_box(res);
+    }
+
+    return visit_number_pair(
+      [](auto const typed_l, auto const typed_r) -> object_ref {
+        return make_box(add_data(typed_l->data, typed_r->data)).erase();
       },
       l,
       r);
@@ -173,33 +287,22 @@ namespace jank::runtime
 
   object_ref promoting_add(object_ref const l, object_ref const r)
   {
-    return visit_number_like(
-      [](auto const typed_l, auto const r) -> object_ref {
-        using LT = typename decltype(typed_l)::value_type;
-
-        return visit_number_like(
-          [](auto const typed_r, auto const &l_val) -> object_ref {
-            using RT = typename decltype(typed_r)::value_type;
-
-            if constexpr(std::same_as<LT, obj::integer> && std::same_as<RT, obj::integer>)
-            {
-              i64 res{};
-
-              if(static_cast<bool>(__builtin_add_overflow(l_val, typed_r->data, &res)))
-              {
-                native_big_integer const l{ l_val };
-                return make_box<obj::big_integer>(l + typed_r->data);
-              }
+    if(l->type == object_type::integer && r->type == object_type::integer)
+    {
+      auto const l_val{ expect_object<obj::integer>(l)->data };
+      auto const r_val{ expect_object<obj::integer>(r)->data };
+      i64 res{};
+      if(__builtin_add_overflow(l_val, r_val, &res)) [[unlikely]]
+      {
+        native_big_integer const big_l{ l_val };
+        return make_box<obj::big_integer>(big_l + r_val);
+      }
+      return make_box(res);
+    }
 
-              return make_box<obj::integer>(res);
-            }
-            else
-            {
-              return make_box(l_val + typed_r->data);
-            }
-          },
-          r,
-          typed_l->data);
+    return visit_number_pair(
+      [](auto const typed_l, auto const typed_r) -> object_ref {
+        return make_box(add_data(typed_l->data, typed_r->data)).erase();
       },
       l,
       r);
@@ -207,14 +310,21 @@ namespace jank::runtime
 
   object_ref sub(object_ref const l, object_ref const r)
   {
-    return visit_number_like(
-      [](auto const typed_l, auto const r) -> object_ref {
-        return visit_number_like(
-          [](auto const typed_r, auto const &typed_l) -> object_ref {
-            return make_box(typed_l - typed_r->data).erase();
-          },
-          r,
-          typed_l->data);
+    if(l->type == object_type::integer && r->type == object_type::integer)
+    {
+      i64 res{};
+      if(__builtin_sub_overflow(expect_object<obj::integer>(l)->data,
+                                expect_object<obj::integer>(r)->data,
+                                &res)) [[unlikely]]
+      {
+        throw std::runtime_error{ "integer overflow" };
+      }
+      return make_box(res);
+    }
+
+    return visit_number_pair(
+      [](auto const typed_l, auto const typed_r) -> object_ref {
+        return make_box(sub_data(typed_l->data, typed_r->data)).erase();
       },
       l,
       r);
@@ -342,33 +452,22 @@ namespace jank::runtime
 
   object_ref promoting_sub(object_ref const l, object_ref const r)
   {
-    return visit_number_like(
-      [](auto const typed_l, auto const r) -> object_ref {
-        using LT = typename decltype(typed_l)::value_type;
-
-        return visit_number_like(
-          [](auto const typed_r, auto const &l_val) -> object_ref {
-            using RT = typename decltype(typed_r)::value_type;
-
-            if constexpr(std::same_as<LT, obj::integer> && std::same_as<RT, obj::integer>)
-            {
-              i64 res{};
-
-              if(__builtin_sub_overflow(l_val, typed_r->data, &res))
-              {
-                native_big_integer const l{ l_val };
-                return make_box<obj::big_integer>(l_val - typed_r->data);
-              }
+    if(l->type == object_type::integer && r->type == object_type::integer)
+    {
+      auto const l_val{ expect_object<obj::integer>(l)->data };
+      auto const r_val{ expect_object<obj::integer>(r)->data };
+      i64 res{};
+      if(__builtin_sub_overflow(l_val, r_val, &res)) [[unlikely]]
+      {
+        native_big_integer const big_l{ l_val };
+        return make_box<obj::big_integer>(big_l - r_val);
+      }
+      return make_box(res);
+    }
 
-              return make_box<obj::integer>(res);
-            }
-            else
-            {
-              return make_box(l_val - typed_r->data);
-            }
-          },
-          r,
-          typed_l->data);
+    return visit_number_pair(
+      [](auto const typed_l, auto const typed_r) -> object_ref {
+        return make_box(sub_data(typed_l->data, typed_r->data)).erase();
       },
       l,
       r);
@@ -376,14 +475,9 @@ namespace jank::runtime
 
   object_ref div(object_ref const l, object_ref const r)
   {
-    return visit_number_like(
-      [](auto const typed_l, auto const r) -> object_ref {
-        return visit_number_like(
-          [](auto const typed_r, auto const &typed_l) -> object_ref {
-            return make_box(typed_l / typed_r->data).erase();
-          },
-          r,
-          typed_l->data);
+    return visit_number_pair(
+      [](auto const typed_l, auto const typed_r) -> object_ref {
+        return make_box(typed_l->data / typed_r->data).erase();
       },
       l,
       r);
@@ -511,14 +605,21 @@ namespace jank::runtime
 
   object_ref mul(object_ref const l, object_ref const r)
   {
-    return visit_number_like(
-      [](auto const typed_l, auto const r) -> object_ref {
-        return visit_number_like(
-          [](auto const typed_r, auto const &typed_l) -> object_ref {
-            return make_box(typed_l * typed_r->data).erase();
-          },
-          r,
-          typed_l->data);
+    if(l->type == object_type::integer && r->type == object_type::integer)
+    {
+      i64 res{};
+      if(__builtin_mul_overflow(expect_object<obj::integer>(l)->data,
+                                expect_object<obj::integer>(r)->data,
+                                &res)) [[unlikely]]
+      {
+        throw std::runtime_error{ "integer overflow" };
+      }
+      return make_box(res);
+    }
+
+    return visit_number_pair(
+      [](auto const typed_l, auto const typed_r) -> object_ref {
+        return make_box(mul_data(typed_l->data, typed_r->data)).erase();
       },
       l,
       r);
@@ -646,33 +747,22 @@ namespace jank::runtime
 
   object_ref promoting_mul(object_ref const l, object_ref const r)
   {
-    return visit_number_like(
-      [](auto const typed_l, auto const r) -> object_ref {
-        using LT = typename decltype(typed_l)::value_type;
-
-        return visit_number_like(
-          [](auto const typed_r, auto const &l_val) -> object_ref {
-            using RT = typename decltype(typed_r)::value_type;
-
-            if constexpr(std::same_as<LT, obj::integer> && std::same_as<RT, obj::integer>)
-            {
-              i64 res{};
-
-              if(__builtin_mul_overflow(l_val, typed_r->data, &res))
-              {
-                native_big_integer const l{ l_val };
-                return make_box<obj::big_integer>(l * typed_r->data);
-              }
+    if(l->type == object_type::integer && r->type == object_type::integer)
+    {
+      auto const l_val{ expect_object<obj::integer>(l)->data };
+      auto const r_val{ expect_object<obj::integer>(r)->data };
+      i64 res{};
+      if(__builtin_mul_overflow(l_val, r_val, &res)) [[unlikely]]
+      {
+        native_big_integer const big_l{ l_val };
+        return make_box<obj::big_integer>(big_l * r_val);
+      }
+      return make_box(res);
+    }
 
-              return make_box<obj::integer>(res);
-            }
-            else
-            {
-              return make_box(l_val * typed_r->data);
-            }
-          },
-          r,
-          typed_l->data);
+    return visit_number_pair(
+      [](auto const typed_l, auto const typed_r) -> object_ref {
+        return make_box(mul_data(typed_l->data, typed_r->data)).erase();
       },
       l,
       r);
@@ -680,44 +770,39 @@ namespace jank::runtime
 
   object_ref rem(object_ref const l, object_ref const r)
   {
-    return visit_number_like(
-      [](auto const typed_l, auto const r_obj) -> object_ref {
-        return visit_number_like(
-          []<typename T>(auto const typed_r, T const &typed_l_data) -> object_ref {
-            using LeftType = std::decay_t<T>;
-            using RightType = std::decay_t<decltype(typed_r->data)>;
-
-            constexpr bool left_is_int_like{ std::is_same_v<LeftType, i64>
-                                             || std::is_same_v<LeftType, native_big_integer> };
-            constexpr bool right_is_int_like{ std::is_same_v<RightType, i64>
-                                              || std::is_same_v<RightType, native_big_integer> };
-
-            if constexpr(left_is_int_like && right_is_int_like)
-            {
-              if constexpr(std::is_same_v<LeftType, i64>
-                           && std::is_same_v<RightType, native_big_integer>)
-              {
-                return make_box(native_big_integer(typed_l_data) % typed_r->data).erase();
-              }
-              else if constexpr(std::is_same_v<LeftType, native_big_integer>
-                                && std::is_same_v<RightType, i64>)
-              {
-                return make_box(typed_l_data % native_big_integer(typed_r->data)).erase();
-              }
-              else
-              {
-                return make_box(typed_l_data % typed_r->data).erase();
-              }
-            }
-            else
-            {
-              auto const l_real{ to_real(typed_l_data) };
-              auto const r_real{ to_real(typed_r->data) };
-              return make_box(std::fmod(l_real, r_real)).erase();
-            }
-          },
-          r_obj,
-          typed_l->data);
+    return visit_number_pair(
+      [](auto const typed_l, auto const typed_r) -> object_ref {
+        using LeftType = std::decay_t<decltype(typed_l->data)>;
+        using RightType = std::decay_t<decltype(typed_r->data)>;
+
+        constexpr bool left_is_int_like{ std::is_same_v<LeftType, i64>
+                                         || std::is_same_v<LeftType, native_big_integer> };
+        constexpr bool right_is_int_like{ std::is_same_v<RightType, i64>
+                                          || std::is_same_v<RightType, native_big_integer> };
+
+        if constexpr(left_is_int_like && right_is_int_like)
+        {
+          if constexpr(std::is_same_v<LeftType, i64>
+                       && std::is_same_v<RightType, native_big_integer>)
+          {
+            return make_box(native_big_integer(typed_l->data) % typed_r->data).erase();
+          }
+          else if constexpr(std::is_same_v<LeftType, native_big_integer>
+                            && std::is_same_v<RightType, i64>)
+          {
+            return make_box(typed_l->data % native_big_integer(typed_r->data)).erase();
+          }
+          else
+          {
+            return make_box(typed_l->data % typed_r->data).erase();
+          }
+        }
+        else
+        {
+          auto const l_real{ to_real(typed_l->data) };
+          auto const r_real{ to_real(typed_r->data) };
+          return make_box(std::fmod(l_real, r_real)).erase();
+        }
       },
       l,
       r);
@@ -725,26 +810,21 @@ namespace jank::runtime
 
   object_ref quot(object_ref const l, object_ref const r)
   {
-    return visit_number_like(
-      [](auto const typed_l, auto const r) -> object_ref {
-        return visit_number_like(
-          [](auto const typed_r, auto const &typed_l) -> object_ref {
-            auto const typed_l_data{ to_real(typed_l) };
-            auto const typed_r_data{ to_real(typed_r->data) };
+    return visit_number_pair(
+      [](auto const typed_l, auto const typed_r) -> object_ref {
+        auto const typed_l_data{ to_real(typed_l->data) };
+        auto const typed_r_data{ to_real(typed_r->data) };
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wfloat-equal"
-            if(typed_r_data == 0ll)
-            {
+        if(typed_r_data == 0ll)
+        {
 #pragma clang diagnostic pop
-              throw make_box("Illegal divide by zero in 'quot'").erase();
-            }
-            else
-            {
-              return make_box(static_cast<i64>(typed_l_data / typed_r_data)).erase();
-            }
-          },
-          r,
-          typed_l->data);
+          throw make_box("Illegal divide by zero in 'quot'").erase();
+        }
+        else
+        {
+          return make_box(static_cast<i64>(typed_l_data / typed_r_data)).erase();
+        }
       },
       l,
       r);
@@ -896,22 +976,22 @@ namespace jank::runtime
 
   bool is_equiv(object_ref const l, object_ref const r)
   {
-    return visit_number_like(
-      [](auto const typed_l, object_ref const r) -> bool {
-        return visit_number_like(
-          [](auto const typed_r, auto const &typed_l) -> bool {
-            auto const data_l{ to_real(typed_l) };
-            auto const data_r{ to_real(typed_r->data) };
+    if(l->type == object_type::integer && r->type == object_type::integer)
+    {
+      return expect_object<obj::integer>(l)->data == expect_object<obj::integer>(r)->data;
+    }
+
+    return visit_number_pair(
+      [](auto const typed_l, auto const typed_r) -> bool {
+        auto const data_l{ to_real(typed_l->data) };
+        auto const data_r{ to_real(typed_r->data) };
 
-            using C
-              = std::common_type_t<jtl::decay_t<decltype(data_l)>, jtl::decay_t<decltype(data_r)>>;
+        using C
+          = std::common_type_t<jtl::decay_t<decltype(data_l)>, jtl::decay_t<decltype(data_r)>>;
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wfloat-equal"
-            return static_cast<C>(data_l) == static_cast<C>(data_r);
+        return static_cast<C>(data_l) == static_cast<C>(data_r);
 #pragma clang diagnostic pop
-          },
-          r,
-          typed_l->data);
       },
       l,
       r);
@@ -1078,21 +1158,18 @@ namespace jank::runtime
 
   f64 rand()
   {
-    static std::random_device dev;
-    static std::mt19937 gen{ dev() };
-    static std::uniform_real_distribution<f64> dis(0.0, 1.0);
-    return dis(gen);
+    return random_real();
   }
 
   bool lt(object_ref const l, object_ref const r)
   {
-    return visit_number_like(
-      [](auto const typed_l, auto const r) -> bool {
-        return visit_number_like(
-          [](auto const typed_r, auto const &typed_l) -> bool { return typed_l < typed_r->data; },
-          r,
-          typed_l->data);
-      },
+    if(l->type == object_type::integer && r->type == object_type::integer)
+    {
+      return expect_object<obj::integer>(l)->data < expect_object<obj::integer>(r)->data;
+    }
+
+    return visit_number_pair(
+      [](auto const typed_l, auto const typed_r) -> bool { return typed_l->data < typed_r->data; },
       l,
       r);
   }
@@ -1203,13 +1280,13 @@ namespace jank::runtime
 
   bool lte(object_ref const l, object_ref const r)
   {
-    return visit_number_like(
-      [](auto const typed_l, auto const r) -> bool {
-        return visit_number_like(
-          [](auto const typed_r, auto const &typed_l) -> bool { return typed_l <= typed_r->data; },
-          r,
-          typed_l->data);
-      },
+    if(l->type == object_type::integer && r->type == object_type::integer)
+    {
+      return expect_object<obj::integer>(l)->data <= expect_object<obj::integer>(r)->data;
+    }
+
+    return visit_number_pair(
+      [](auto const typed_l, auto const typed_r) -> bool { return typed_l->data <= typed_r->data; },
       l,
       r);
   }
@@ -1320,15 +1397,15 @@ namespace jank::runtime
 
   object_ref min(object_ref const l, object_ref const r)
   {
-    return visit_number_like(
-      [](auto const typed_l, auto const r) -> object_ref {
-        return visit_number_like(
-          [](auto const typed_r, auto const &typed_l) -> object_ref {
-            return typed_l < typed_r->data ? make_box(typed_l).erase()
-                                           : make_box(typed_r->data).erase();
-          },
-          r,
-          typed_l->data);
+    if(l->type == object_type::integer && r->type == object_type::integer)
+    {
+      return expect_object<obj::integer>(l)->data < expect_object<obj::integer>(r)->data ? l : r;
+    }
+
+    return visit_number_pair(
+      [](auto const typed_l, auto const typed_r) -> object_ref {
+        return typed_l->data < typed_r->data ? make_box(typed_l->data).erase()
+                                             : make_box(typed_r->data).erase();
       },
       l,
       r);
@@ -1468,14 +1545,15 @@ namespace jank::runtime
 
   object_ref max(object_ref const l, object_ref const r)
   {
-    return visit_number_like(
-      [](auto const typed_l, auto const r) -> object_ref {
-        return visit_number_like(
-          [](auto const typed_r, auto const &typed_l) -> object_ref {
-            return typed_r->data > typed_l ? make_box(typed_r).erase() : make_box(typed_l).erase();
-          },
-          r,
-          typed_l->data);
+    if(l->type == object_type::integer && r->type == object_type::integer)
+    {
+      return expect_object<obj::integer>(r)->data > expect_object<obj::integer>(l)->data ? r : l;
+    }
+
+    return visit_number_pair(
+      [](auto const typed_l, auto const typed_r) -> object_ref {
+        return typed_r->data > typed_l->data ? make_box(typed_r).erase()
+                                             : make_box(typed_l->data).erase();
       },
       l,
       r);
@@ -1673,17 +1751,12 @@ namespace jank::runtime
 
   f64 pow(object_ref const l, object_ref const r)
   {
-    return visit_number_like(
-      [](auto const typed_l, auto const r) -> f64 {
-        return visit_number_like(
-          [](auto const typed_r, auto const &typed_l) -> f64 {
-            auto const typed_r_data{ to_real(typed_r->data) };
-            auto const typed_l_data{ to_real(typed_l) };
-            using C = std::common_type_t<decltype(typed_l_data), decltype(typed_r_data)>;
-            return std::pow(static_cast<C>(typed_l_data), static_cast<C>(typed_r_data));
-          },
-          r,
-          typed_l->data);
+    return visit_number_pair(
+      [](auto const typed_l, auto const typed_r) -> f64 {
+        auto const typed_r_data{ to_real(typed_r->data) };
+        auto const typed_l_data{ to_real(typed_l->data) };
+        using C = std::common_type_t<decltype(typed_l_data), decltype(typed_r_data)>;
+        return std::pow(static_cast<C>(typed_l_data), static_cast<C>(typed_r_data));
       },
       l,
       r);
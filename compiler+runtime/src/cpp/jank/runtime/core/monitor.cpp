@@ -0,0 +1,82 @@
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#include <jank/runtime/core/monitor.hpp>
+#include <jank/runtime/core/to_string.hpp>
+#include <jank/util/fmt.hpp>
+#include <jank/util/spin.hpp>
+
+namespace jank::runtime
+{
+  /* How many times we'll try for a contended lock before parking on it. */
+  static constexpr usize spin_limit{ 64 };
+  static constexpr usize stripe_count{ 1024 };
+
+  /* Each stripe is on its own cache line, so neighbouring stripes don't contend. */
+  struct alignas(64) monitor_stripe
+  {
+    std::mutex mutex;
+    std::atomic<std::thread::id> owner{};
+    /* Only ever touched by the owner, while holding the mutex. */
+    usize depth{};
+  };
+
+  static std::array<monitor_stripe, stripe_count> stripes;
+
+  static monitor_stripe &stripe_for(object_ref const o)
+  {
+    /* Objects are at least 16 byte aligned, so the low bits carry nothing. We mix in
+     * some higher bits, too, since neighbouring allocations tend to be locked together. */
+    auto const address{ reinterpret_cast<uintptr_t>(o.data) >> 4 };
+    return stripes[(address ^ (address >> 10)) % stripe_count];
+  }
+
+  void monitor_enter(object_ref const o)
+  {
+    auto &stripe{ stripe_for(o) };
+    auto const self{ std::this_thread::get_id() };
+
+    /* Only this thread can ever have stored its own id, so relaxed is enough here. */
+    if(stripe.owner.load(std::memory_order_relaxed) == self)
+    {
+      ++stripe.depth;
+      return;
+    }
+
+    auto acquired{ false };
+    for(usize i{}; i < spin_limit && !acquired; ++i)
+    {
+      acquired = stripe.mutex.try_lock();
+      if(!acquired)
+      {
+        util::spin_pause();
+      }
+    }
+    if(!acquired)
+    {
+      stripe.mutex.lock();
+    }
+
+    stripe.owner.store(self, std::memory_order_relaxed);
+    stripe.depth = 1;
+  }
+
+  void monitor_exit(object_ref const o)
+  {
+    auto &stripe{ stripe_for(o) };
+    if(stripe.owner.load(std::memory_order_relaxed) != std::this_thread::get_id())
+    {
+      throw std::runtime_error{ util::format("Unable to exit the monitor of {}, since it's not "
+                                             "held by this thread.",
+                                             runtime::to_code_string(o)) };
+    }
+
+    if(--stripe.depth == 0)
+    {
+      stripe.owner.store({}, std::memory_order_relaxed);
+      stripe.mutex.unlock();
+    }
+  }
+}
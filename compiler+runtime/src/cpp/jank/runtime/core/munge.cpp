@@ -1,3 +1,5 @@
+#include <array>
+#include <mutex>
 #include <regex>
 
 #include <jank/runtime/core/munge.hpp>
@@ -265,15 +267,57 @@ namespace jank::runtime
     "xor_eq__",
   };
 
+  /* The replacement for each char, indexed by the char, so munging doesn't need a hash lookup
+   * for every char. Chars without a replacement are null. */
+  static std::array<char const *, 256> const munge_table{ [] {
+    std::array<char const *, 256> ret{};
+    for(auto const &c : munge_chars)
+    {
+      ret[static_cast<u8>(c.first)] = c.second.data();
+    }
+    return ret;
+  }() };
+
+  /* Codegen munges the same names over and over, so the results are kept. Names which don't
+   * change are found without the cache. This is bounded, since many names, such as those
+   * with gensyms, are only munged a few times. */
+  static constexpr usize max_munge_cache_size{ 8192 };
+  static std::mutex munge_cache_mutex;
+  static native_unordered_map<jtl::immutable_string, jtl::immutable_string> munge_cache;
+
   jtl::immutable_string munge(jtl::immutable_string const &o)
   {
+    bool needs_replacement{};
+    for(auto const c : o)
+    {
+      if(munge_table[static_cast<u8>(c)])
+      {
+        needs_replacement = true;
+        break;
+      }
+    }
+    if(!needs_replacement && !cpp_keywords.contains(o))
+    {
+      return o;
+    }
+
+    {
+      std::lock_guard<std::mutex> const lock{ munge_cache_mutex };
+      auto const found(munge_cache.find(o));
+      if(found != munge_cache.end())
+      {
+        return found->second;
+      }
+    }
+
     native_transient_string munged;
-    for(auto const &c : o)
+    munged.reserve(o.size() * 2);
+    for(auto const c : o)
     {
-      auto const &replacement(munge_chars.find(c));
-      if(replacement != munge_chars.end())
+      auto const replacement(munge_table[static_cast<u8>(c)]);
+      if(replacement)
       {
-        munged.append(replacement->second);
+        munged.append(replacement);
       }
       else
       {
@@ -286,7 +330,14 @@ namespace jank::runtime
       munged += "__";
     }
 
-    return munged;
+    jtl::immutable_string ret{ munged };
+    std::lock_guard<std::mutex> const lock{ munge_cache_mutex };
+    if(munge_cache.size() == max_munge_cache_size)
+    {
+      munge_cache.clear();
+    }
+    munge_cache.emplace(o, ret);
+    return ret;
   }
 
   jtl::immutable_string munge_and_replace(jtl::immutable_string const &o,
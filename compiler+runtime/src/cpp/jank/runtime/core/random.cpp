@@ -0,0 +1,90 @@
+#include <atomic>
+#include <random>
+
+#include <jank/runtime/core/random.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/math.hpp>
+#include <jank/runtime/obj/persistent_vector.hpp>
+#include <jank/runtime/obj/uuid.hpp>
+#include <jank/util/fmt.hpp>
+
+namespace jank::runtime
+{
+  /* splitmix64, which spreads out seeds which are close together, such as 1, 2, and 3. */
+  static u64 mix_seed(u64 x)
+  {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+  }
+
+  /* Only the first thread pays for the random_device. Each thread after it gets the next
+   * seed along from that. */
+  static u64 next_thread_seed()
+  {
+    static u64 const base{ (static_cast<u64>(std::random_device{}()) << 32)
+                           | std::random_device{}() };
+    static std::atomic<u64> threads{};
+    return mix_seed(base + threads.fetch_add(1, std::memory_order_relaxed));
+  }
+
+  random_generator &thread_random()
+  {
+    static thread_local random_generator gen{ next_thread_seed() };
+    return gen;
+  }
+
+  void seed_thread_random(u64 const seed)
+  {
+    thread_random().state = mix_seed(seed);
+  }
+
+  f64 random_real()
+  {
+    /* The top 53 bits, which is all a double can hold. */
+    return static_cast<f64>(thread_random()() >> 11) * 0x1.0p-53;
+  }
+
+  /* Lemire's multiply and shift, which only needs a division in the rare case where the
+   * result would be biased. */
+  u64 random_below(u64 const n)
+  {
+    auto &gen(thread_random());
+    auto product{ static_cast<unsigned __int128>(gen()) * n };
+    auto low{ static_cast<u64>(product) };
+    if(low < n)
+    {
+      auto const threshold{ (0 - n) % n };
+      while(low < threshold)
+      {
+        product = static_cast<unsigned __int128>(gen()) * n;
+        low = static_cast<u64>(product);
+      }
+    }
+    return static_cast<u64>(product >> 64);
+  }
+
+  object_ref seed_random(object_ref const seed)
+  {
+    seed_thread_random(static_cast<u64>(to_int(seed)));
+    return jank_nil();
+  }
+
+  object_ref random_uuids(object_ref const n)
+  {
+    auto const count(to_int(n));
+    if(count < 0)
+    {
+      throw std::runtime_error{ util::format("The uuid count must not be negative; found {}",
+                                             count) };
+    }
+
+    runtime::detail::native_transient_vector ret;
+    for(i64 i{}; i < count; ++i)
+    {
+      ret.push_back(make_box<obj::uuid>());
+    }
+    return make_box<obj::persistent_vector>(ret.persistent());
+  }
+}
@@ -1,5 +1,13 @@
 #include <algorithm>
-#include <random>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <exception>
+#include <numeric>
+#include <thread>
+
+#include <immer/algorithm.hpp>
 
 #include <jank/runtime/visit.hpp>
 #include <jank/runtime/behavior/associatively_readable.hpp>
@@ -16,10 +24,16 @@
 #include <jank/runtime/behavior/stackable.hpp>
 #include <jank/runtime/behavior/chunkable.hpp>
 #include <jank/runtime/behavior/metadatable.hpp>
+#include <jank/runtime/behavior/reducible.hpp>
 #include <jank/runtime/core.hpp>
 #include <jank/runtime/core/equal.hpp>
+#include <jank/runtime/core/math.hpp>
 #include <jank/runtime/core/meta.hpp>
+#include <jank/runtime/core/random.hpp>
+#include <jank/runtime/core/seq_ext.hpp>
+#include <jank/runtime/executor.hpp>
 #include <jank/runtime/sequence_range.hpp>
+#include <jank/runtime/behavior_table.hpp>
 #include <jank/util/fmt/print.hpp>
 
 namespace jank::runtime
@@ -100,14 +114,18 @@ namespace jank::runtime
 
   bool is_vector(object_ref const o)
   {
-    return o->type == object_type::persistent_vector;
+    return o->type == object_type::persistent_vector || o->type == object_type::primitive_vector
+      || o->type == object_type::mapped_vector;
   }
 
   bool is_map(object_ref const o)
   {
     return (o->type == object_type::persistent_hash_map
             || o->type == object_type::persistent_array_map
-            || o->type == object_type::persistent_sorted_map);
+            || o->type == object_type::persistent_sorted_map
+            || o->type == object_type::persistent_int_map
+            || o->type == object_type::persistent_struct_map
+            || o->type == object_type::mapped_map);
   }
 
   bool is_associative(object_ref const o)
@@ -129,13 +147,8 @@ namespace jank::runtime
 
   bool is_counted(object_ref const o)
   {
-    return visit_object(
-      [=](auto const typed_o) -> bool {
-        using T = typename jtl::decay_t<decltype(typed_o)>::value_type;
-
-        return behavior::countable<T>;
-      },
-      o);
+    /* nil can be counted, but it isn't counted?, just like in Clojure. */
+    return !o.is_nil() && behaviors_of(o).count != nullptr;
   }
 
   bool is_transientable(object_ref const o)
@@ -155,6 +168,35 @@ namespace jank::runtime
       || o->type == object_type::persistent_sorted_set;
   }
 
+  object_ref sorted_seq(object_ref const coll, object_ref const ascending)
+  {
+    switch(coll->type)
+    {
+      case object_type::persistent_sorted_map:
+        return expect_object<obj::persistent_sorted_map>(coll)->sorted_seq(truthy(ascending));
+      case object_type::persistent_sorted_set:
+        return expect_object<obj::persistent_sorted_set>(coll)->sorted_seq(truthy(ascending));
+      default:
+        throw std::runtime_error{ util::format("not sorted: {}", runtime::to_code_string(coll)) };
+    }
+  }
+
+  object_ref
+  sorted_seq_from(object_ref const coll, object_ref const key, object_ref const ascending)
+  {
+    switch(coll->type)
+    {
+      case object_type::persistent_sorted_map:
+        return expect_object<obj::persistent_sorted_map>(coll)->sorted_seq_from(key,
+                                                                                truthy(ascending));
+      case object_type::persistent_sorted_set:
+        return expect_object<obj::persistent_sorted_set>(coll)->sorted_seq_from(key,
+                                                                                truthy(ascending));
+      default:
+        throw std::runtime_error{ util::format("not sorted: {}", runtime::to_code_string(coll)) };
+    }
+  }
+
   object_ref transient(object_ref const o)
   {
     return visit_object(
@@ -213,6 +255,34 @@ namespace jank::runtime
       o);
   }
 
+  object_ref conj_all_in_place(object_ref const coll, object_ref const from)
+  {
+    return visit_object(
+      [](auto const typed_coll, object_ref const from) -> object_ref {
+        using T = typename jtl::decay_t<decltype(typed_coll)>::value_type;
+
+        if constexpr(behavior::conjable_all_in_place<T>)
+        {
+          return typed_coll->conj_all_in_place(from);
+        }
+        else if constexpr(behavior::conjable_in_place<T>)
+        {
+          /* Some transients, like array maps, may give us back a different transient as
+           * they grow, so we can't hold onto the typed one. */
+          object_ref ret{ typed_coll };
+          for_each(from, [&](object_ref const e) { ret = conj_in_place(ret, e); });
+          return ret;
+        }
+        else
+        {
+          throw std::runtime_error{ util::format("not conjable_in_place: {}",
+                                                 typed_coll->to_code_string()) };
+        }
+      },
+      coll,
+      from);
+  }
+
   object_ref disj_in_place(object_ref const coll, object_ref const o)
   {
     /* TODO: disjoinable_in_place */
@@ -282,58 +352,22 @@ namespace jank::runtime
 
   object_ref seq(object_ref const s)
   {
-    return visit_object(
-      [](auto const typed_s) -> object_ref {
-        using T = typename jtl::decay_t<decltype(typed_s)>::value_type;
-
-        if constexpr(std::same_as<T, obj::nil>)
-        {
-          return typed_s;
-        }
-        else if constexpr(behavior::seqable<T>)
-        {
-          auto const ret(typed_s->seq());
-          if(ret.is_nil())
-          {
-            return ret;
-          }
-
-          return ret;
-        }
-        else
-        {
-          throw std::runtime_error{ util::format("not seqable: {}", typed_s->to_code_string()) };
-        }
-      },
-      s);
+    auto const fn{ behaviors_of(s).seq };
+    if(!fn)
+    {
+      throw std::runtime_error{ util::format("not seqable: {}", to_code_string(s)) };
+    }
+    return fn(s.data);
   }
 
   object_ref fresh_seq(object_ref const s)
   {
-    return visit_object(
-      [](auto const typed_s) -> object_ref {
-        using T = typename jtl::decay_t<decltype(typed_s)>::value_type;
-
-        if constexpr(std::same_as<T, obj::nil>)
-        {
-          return typed_s;
-        }
-        else if constexpr(behavior::seqable<T>)
-        {
-          auto const ret(typed_s->fresh_seq());
-          if(ret.is_nil())
-          {
-            return ret;
-          }
-
-          return ret;
-        }
-        else
-        {
-          throw std::runtime_error{ util::format("not seqable: {}", typed_s->to_code_string()) };
-        }
-      },
-      s);
+    auto const fn{ behaviors_of(s).fresh_seq };
+    if(!fn)
+    {
+      throw std::runtime_error{ util::format("not seqable: {}", to_code_string(s)) };
+    }
+    return fn(s.data);
   }
 
   object_ref first(object_ref const s)
@@ -389,13 +423,15 @@ namespace jank::runtime
         }
         else if constexpr(behavior::seqable<T>)
         {
-          auto const s(typed_s->seq());
+          /* Nobody else can see a fresh seq, so we can step it in place, rather than
+           * making a second seq for the next. */
+          auto const s(typed_s->fresh_seq());
           if(s.is_nil())
           {
             return s;
           }
 
-          return s->next();
+          return runtime::next_in_place(s);
         }
         else
         {
@@ -449,12 +485,28 @@ namespace jank::runtime
     }
     return visit_seqable(
       [=](auto const typed_s) -> object_ref {
-        auto const seq(typed_s->seq());
-        if(seq.is_nil())
+        using T = typename jtl::decay_t<decltype(typed_s)>::value_type;
+
+        object_ref ret;
+        if constexpr(behavior::sequenceable<T>)
         {
-          return obj::persistent_list::empty();
+          auto const seq(typed_s->seq());
+          if(seq.is_nil())
+          {
+            return obj::persistent_list::empty();
+          }
+          ret = next(seq);
+        }
+        else
+        {
+          /* As with next, a fresh seq is ours to step in place. */
+          auto const seq(typed_s->fresh_seq());
+          if(seq.is_nil())
+          {
+            return obj::persistent_list::empty();
+          }
+          ret = runtime::next_in_place(seq);
         }
-        auto ret(next(seq));
         if(ret.is_nil())
         {
           return obj::persistent_list::empty();
@@ -568,38 +620,14 @@ namespace jank::runtime
 
   object_ref get(object_ref const m, object_ref const key)
   {
-    return visit_object(
-      [&](auto const typed_m) -> object_ref {
-        using T = typename jtl::decay_t<decltype(typed_m)>::value_type;
-
-        if constexpr(behavior::associatively_readable<T>)
-        {
-          return typed_m->get(key);
-        }
-        else
-        {
-          return jank_nil();
-        }
-      },
-      m);
+    auto const fn{ behaviors_of(m).get };
+    return fn ? fn(m.data, key) : jank_nil();
   }
 
   object_ref get(object_ref const m, object_ref const key, object_ref const fallback)
   {
-    return visit_object(
-      [&](auto const typed_m) -> object_ref {
-        using T = typename jtl::decay_t<decltype(typed_m)>::value_type;
-
-        if constexpr(behavior::associatively_readable<T>)
-        {
-          return typed_m->get(key, fallback);
-        }
-        else
-        {
-          return fallback;
-        }
-      },
-      m);
+    auto const fn{ behaviors_of(m).get_default };
+    return fn ? fn(m.data, key, fallback) : fallback;
   }
 
   object_ref get_in(object_ref const m, object_ref const keys)
@@ -708,8 +736,88 @@ namespace jank::runtime
       s);
   }
 
+  /* Once one map is this many times smaller than the other, setting each of its entries
+   * is cheaper than diffing the two. */
+  static constexpr usize merge_lookup_ratio{ 16 };
+
+  /* The result keeps the meta of m, even when it's built from other. */
+  static object_ref
+  merge_hash_maps(obj::persistent_hash_map_ref const m, obj::persistent_hash_map_ref const other)
+  {
+    if(other->data.empty())
+    {
+      return m;
+    }
+
+    if(other->data.size() * merge_lookup_ratio < m->data.size())
+    {
+      auto transient(m->data.transient());
+      for(auto const &[k, v] : other->data)
+      {
+        transient.set(k, v);
+      }
+      return make_box<obj::persistent_hash_map>(m->meta, transient.persistent());
+    }
+
+    if(m->data.size() * merge_lookup_ratio < other->data.size())
+    {
+      auto transient(other->data.transient());
+      for(auto const &[k, v] : m->data)
+      {
+        if(!other->data.find(k))
+        {
+          transient.set(k, v);
+        }
+      }
+      return make_box<obj::persistent_hash_map>(m->meta, transient.persistent());
+    }
+
+    /* The diff skips every subtree the maps share, so only what other adds or changes is
+     * touched. */
+    auto transient(m->data.transient());
+    auto const set([&](auto const &kv) { transient.set(kv.first, kv.second); });
+    immer::diff(
+      m->data,
+      other->data,
+      set,
+      [](auto const &) {},
+      [&](auto const &, auto const &kv) { set(kv); });
+    return make_box<obj::persistent_hash_map>(m->meta, transient.persistent());
+  }
+
   object_ref merge(object_ref const m, object_ref const other)
   {
+    if(m->type == object_type::persistent_int_map
+       && other->type == object_type::persistent_int_map)
+    {
+      return expect_object<obj::persistent_int_map>(m)->merge(
+        expect_object<obj::persistent_int_map>(other),
+        none);
+    }
+
+    if(m->type == object_type::persistent_hash_map)
+    {
+      auto const typed_m(expect_object<obj::persistent_hash_map>(m));
+      if(other->type == object_type::persistent_hash_map)
+      {
+        return merge_hash_maps(typed_m, expect_object<obj::persistent_hash_map>(other));
+      }
+
+      /* Anything else still goes through a transient, rather than an assoc per entry. */
+      return visit_map_like(
+        [](auto const typed_other, obj::persistent_hash_map_ref const typed_m) -> object_ref {
+          auto transient(typed_m->data.transient());
+          for(auto seq{ typed_other->fresh_seq() }; seq.is_some(); seq = seq->next_in_place())
+          {
+            auto const &e(seq->first());
+            transient.set(e->data[0], e->data[1]);
+          }
+          return make_box<obj::persistent_hash_map>(typed_m->meta, transient.persistent());
+        },
+        other,
+        typed_m);
+    }
+
     return visit_object(
       [](auto const typed_m, object_ref const other) -> object_ref {
         using T = typename jtl::decay_t<decltype(typed_m)>::value_type;
@@ -798,8 +906,55 @@ namespace jank::runtime
     {
       return obj::persistent_vector::empty();
     }
+#ifdef JANK_FLEX_VECTOR
+    /* This shares the tree with the original, rather than copying the slice. */
+    return make_box<obj::persistent_vector>(v->data.take(end).drop(start));
+#else
     return make_box<obj::persistent_vector>(
       detail::native_persistent_vector{ v->data.begin() + start, v->data.begin() + end });
+#endif
+  }
+
+  object_ref concat_vectors(object_ref const l, object_ref const r)
+  {
+    if(l->type == object_type::primitive_vector)
+    {
+      return expect_object<obj::primitive_vector>(l)->conj_all(r);
+    }
+
+    if(l->type == object_type::mapped_vector)
+    {
+      return concat_vectors(expect_object<obj::mapped_vector>(l)->to_persistent(), r);
+    }
+
+    auto const typed_l(try_object<obj::persistent_vector>(l));
+    if(r->type == object_type::primitive_vector || r->type == object_type::mapped_vector)
+    {
+      auto ret(typed_l->data.transient());
+      for_each_item(r, [&](object_ref const e) { ret.push_back(e); });
+      return make_box<obj::persistent_vector>(typed_l->meta, ret.persistent());
+    }
+
+    auto const typed_r(try_object<obj::persistent_vector>(r));
+    if(typed_r->data.empty())
+    {
+      return typed_l;
+    }
+    else if(typed_l->data.empty() && typed_l->meta.is_none())
+    {
+      return typed_r->meta.is_none() ? typed_r : make_box<obj::persistent_vector>(typed_r->data);
+    }
+
+#ifdef JANK_FLEX_VECTOR
+    return make_box<obj::persistent_vector>(typed_l->meta, typed_l->data + typed_r->data);
+#else
+    auto ret(typed_l->data.transient());
+    for(auto const e : typed_r->data)
+    {
+      ret.push_back(e);
+    }
+    return make_box<obj::persistent_vector>(typed_l->meta, ret.persistent());
+#endif
   }
 
   object_ref nth(object_ref const o, object_ref const idx)
@@ -880,6 +1035,27 @@ namespace jank::runtime
       o);
   }
 
+  object_ref nthnext(object_ref const o, i64 const n)
+  {
+    if(o->type == object_type::persistent_vector)
+    {
+      auto const v(expect_object<obj::persistent_vector>(o));
+      auto const start(static_cast<usize>(std::max<i64>(n, 0)));
+      if(v->data.size() <= start)
+      {
+        return jank_nil();
+      }
+      return make_box<obj::persistent_vector_sequence>(v, start);
+    }
+
+    auto ret(seq(o));
+    for(i64 i{}; i < n && ret.is_some(); ++i)
+    {
+      ret = next(ret);
+    }
+    return ret;
+  }
+
   object_ref peek(object_ref const o)
   {
     if(o == jank_nil())
@@ -950,28 +1126,26 @@ namespace jank::runtime
     return runtime::to_string(o);
   }
 
+  /* This is the variadic arity of clojure.core/str, so it's hot for anything which builds
+   * strings. We first walk the args to size the buffer, then write each into it, so there's
+   * only the one allocation in the usual case. */
   jtl::immutable_string str(object_ref const o, object_ref const args)
   {
-    jtl::string_builder buff;
-    buff.reserve(16);
+    auto size(to_string_size(o));
+    for_each_item(args, [&](object_ref const e) { size += to_string_size(e); });
+
+    jtl::string_builder buff{ size + 1 };
     if(!is_nil(o))
     {
       runtime::to_string(o, buff);
     }
-    return visit_seqable(
-      [](auto const typed_args, jtl::string_builder &buff) -> jtl::immutable_string {
-        for(auto const &e : make_sequence_range(typed_args))
-        {
-          if(is_nil(e))
-          {
-            continue;
-          }
-          runtime::to_string(e.erase(), buff);
-        }
-        return buff.release();
-      },
-      args,
-      buff);
+    for_each_item(args, [&](object_ref const e) {
+      if(!is_nil(e))
+      {
+        runtime::to_string(e, buff);
+      }
+    });
+    return buff.release();
   }
 
   obj::persistent_list_ref list(object_ref const s)
@@ -997,6 +1171,32 @@ namespace jank::runtime
     return sequence_length(s, std::numeric_limits<size_t>::max());
   }
 
+  /* Whether we can count what's left of a seq without walking it. */
+  static jtl::option<usize> known_count(object_ref const s)
+  {
+    if(auto const count{ behaviors_of(s).count })
+    {
+      return count(s.data);
+    }
+    if(s->type == object_type::cons)
+    {
+      if(auto const count{ expect_object<obj::cons>(s)->cached_count }; count != 0)
+      {
+        return count;
+      }
+    }
+    else if(s->type == object_type::lazy_sequence)
+    {
+      if(auto const count{
+           expect_object<obj::lazy_sequence>(s)->cached_count.load(std::memory_order_relaxed) };
+         count != 0)
+      {
+        return count;
+      }
+    }
+    return none;
+  }
+
   usize sequence_length(object_ref const s, usize const max)
   {
     if(s.is_nil())
@@ -1004,34 +1204,35 @@ namespace jank::runtime
       return 0;
     }
 
-    return visit_object(
-      [&](auto const typed_s) -> usize {
-        using T = typename jtl::decay_t<decltype(typed_s)>::value_type;
+    if(auto const known{ known_count(s) }; known.is_some())
+    {
+      return known.unwrap();
+    }
 
-        if constexpr(std::same_as<T, obj::nil>)
-        {
-          return 0;
-        }
-        else if constexpr(behavior::countable<T>)
+    /* We walk until something along the way knows how much is left, such as a list, or the
+     * seq of a vector, which a lot of cons and lazy seq chains end with. */
+    usize length{};
+    auto node{ s };
+    while(length < max)
+    {
+      if(auto const known{ known_count(node) }; known.is_some())
+      {
+        length += known.unwrap();
+        if(s->type == object_type::cons)
         {
-          return typed_s->count();
+          expect_object<obj::cons>(s)->cached_count = length;
         }
-        else if constexpr(behavior::seqable<T>)
+        else if(s->type == object_type::lazy_sequence)
         {
-          usize length{ 0 };
-          auto const &r{ make_sequence_range(typed_s) };
-          for(auto i(r.begin()); i != r.end() && length < max; ++i)
-          {
-            ++length;
-          }
-          return length;
+          expect_object<obj::lazy_sequence>(s)->cached_count.store(length,
+                                                                   std::memory_order_relaxed);
         }
-        else
-        {
-          throw std::runtime_error{ util::format("not seqable: {}", typed_s->to_code_string()) };
-        }
-      },
-      s);
+        break;
+      }
+      ++length;
+      node = next(node);
+    }
+    return length;
   }
 
   bool sequence_equal(object_ref const l, object_ref const r)
@@ -1071,23 +1272,194 @@ namespace jank::runtime
   {
     return visit_seqable(
       [](auto const typed_coll, object_ref const f, object_ref const init) -> object_ref {
-        object_ref res{ init };
-        for(auto const &e : make_sequence_range(typed_coll))
+        using T = typename jtl::decay_t<decltype(typed_coll)>::value_type;
+
+        if constexpr(behavior::reducible<T>)
+        {
+          return typed_coll->reduce(f, init);
+        }
+        else
+        {
+          object_ref res{ init };
+          for_each_item(typed_coll, [&](object_ref const e) {
+            res = dynamic_call(f, res, e);
+            return !behavior::detail::unwrap_reduced(res);
+          });
+          return res;
+        }
+      },
+      s,
+      f,
+      init);
+  }
+
+  object_ref reduce_kv(object_ref const f, object_ref const init, object_ref const coll)
+  {
+    if(coll.is_nil())
+    {
+      return init;
+    }
+
+    return visit_object(
+      [](auto const typed_coll, object_ref const f, object_ref const init) -> object_ref {
+        using T = typename jtl::decay_t<decltype(typed_coll)>::value_type;
+
+        if constexpr(behavior::kv_reducible<T>)
+        {
+          return typed_coll->reduce_kv(f, init);
+        }
+        else if constexpr(behavior::seqable<T>)
         {
-          res = dynamic_call(f, res, e);
-          if(res->type == object_type::reduced)
+          object_ref res{ init };
+          for(auto const &e : make_sequence_range(typed_coll))
           {
-            res = expect_object<obj::reduced>(res)->val;
-            break;
+            res = dynamic_call(f, res, first(e), second(e));
+            if(behavior::detail::unwrap_reduced(res))
+            {
+              break;
+            }
           }
+          return res;
+        }
+        else
+        {
+          throw std::runtime_error{ util::format("not kv_reducible: {}",
+                                                 typed_coll->to_code_string()) };
         }
-        return res;
       },
-      s,
+      coll,
       f,
       init);
   }
 
+  object_ref zipmap(object_ref const keys, object_ref const vals)
+  {
+    object_ref ret{ obj::transient_hash_map::empty() };
+    for(auto ks{ seq(keys) }, vs{ seq(vals) }; ks.is_some() && vs.is_some();
+        ks = next(ks), vs = next(vs))
+    {
+      ret = assoc_in_place(ret, first(ks), first(vs));
+    }
+    return persistent(ret);
+  }
+
+  /* Each element is hashed and looked up once, by updating its entry in place, rather than
+   * with a get and then an assoc. */
+  object_ref frequencies(object_ref const coll)
+  {
+    runtime::detail::native_transient_hash_map ret;
+    for_each(coll, [&](object_ref const e) {
+      ret.update(e, [](object_ref const n) -> object_ref {
+        return make_box(n.is_nil() ? 1 : expect_object<obj::integer>(n)->data + 1);
+      });
+    });
+    return make_box<obj::persistent_hash_map>(ret.persistent());
+  }
+
+  object_ref merge_with(object_ref const f, object_ref const m, object_ref const other)
+  {
+    object_ref const base{ m.is_nil() ? obj::persistent_array_map::empty().erase() : m };
+    if(other.is_nil())
+    {
+      return base;
+    }
+
+    /* f has to see every key which both maps have, even where they share structure, so
+     * unlike merge, this can't skip shared subtrees. */
+    if(base->type == object_type::persistent_int_map
+       && other->type == object_type::persistent_int_map)
+    {
+      return expect_object<obj::persistent_int_map>(base)->merge(
+        expect_object<obj::persistent_int_map>(other),
+        f);
+    }
+
+    if(base->type == object_type::persistent_hash_map
+       && other->type == object_type::persistent_hash_map)
+    {
+      auto const typed_base(expect_object<obj::persistent_hash_map>(base));
+      auto transient(typed_base->data.transient());
+      for(auto const &[k, v] : expect_object<obj::persistent_hash_map>(other)->data)
+      {
+        auto const existing(typed_base->data.find(k));
+        transient.set(k, existing ? dynamic_call(f, *existing, v) : v);
+      }
+      return make_box<obj::persistent_hash_map>(typed_base->meta, transient.persistent());
+    }
+
+    return visit_map_like(
+      [&](auto const typed_other) -> object_ref {
+        object_ref ret{ base };
+        for(auto seq{ typed_other->fresh_seq() }; seq.is_some(); seq = seq->next_in_place())
+        {
+          auto const &e(seq->first());
+          auto const k(e->data[0]);
+          auto const v(e->data[1]);
+          ret = assoc(ret, k, contains(ret, k) ? dynamic_call(f, get(ret, k), v) : v);
+        }
+        return ret;
+      },
+      other);
+  }
+
+  object_ref update_vals(object_ref const m, object_ref const f)
+  {
+    if(m->type != object_type::persistent_hash_map)
+    {
+      return jank_nil();
+    }
+
+    /* Every key is already there, so the transient updates each node in place once it
+     * owns it. */
+    auto const typed_m(expect_object<obj::persistent_hash_map>(m));
+    auto transient(typed_m->data.transient());
+    for(auto const &[k, v] : typed_m->data)
+    {
+      transient.set(k, dynamic_call(f, v));
+    }
+    return make_box<obj::persistent_hash_map>(typed_m->meta, transient.persistent());
+  }
+
+  object_ref update_keys(object_ref const m, object_ref const f)
+  {
+    if(m->type != object_type::persistent_hash_map)
+    {
+      return jank_nil();
+    }
+
+    auto const typed_m(expect_object<obj::persistent_hash_map>(m));
+    runtime::detail::native_transient_hash_map transient;
+    for(auto const &[k, v] : typed_m->data)
+    {
+      transient.set(dynamic_call(f, k), v);
+    }
+    return make_box<obj::persistent_hash_map>(typed_m->meta, transient.persistent());
+  }
+
+  /* Groups are built up as transient vectors, so adding to one doesn't copy it, and they're
+   * only made persistent once the whole coll has been grouped. */
+  object_ref group_by(object_ref const f, object_ref const coll)
+  {
+    runtime::detail::native_transient_hash_map groups;
+    for_each(coll, [&](object_ref const e) {
+      groups.update(dynamic_call(f, e), [&](object_ref const group) -> object_ref {
+        if(group.is_nil())
+        {
+          return make_box<obj::transient_vector>()->conj_in_place(e);
+        }
+        return expect_object<obj::transient_vector>(group)->conj_in_place(e);
+      });
+    });
+
+    auto ret(groups.persistent());
+    auto transient(ret.transient());
+    for(auto const &[k, group] : ret)
+    {
+      transient.set(k, expect_object<obj::transient_vector>(group)->to_persistent());
+    }
+    return make_box<obj::persistent_hash_map>(transient.persistent());
+  }
+
   object_ref reduced(object_ref const o)
   {
     return make_box<obj::reduced>(o);
@@ -1188,6 +1560,12 @@ namespace jank::runtime
       o);
   }
 
+  bool is_index_loopable(object_ref const o)
+  {
+    return o->type == object_type::persistent_vector || o->type == object_type::primitive_vector
+      || o->type == object_type::array;
+  }
+
   object_ref iterate(object_ref const fn, object_ref const o)
   {
     return make_box<obj::iterator>(fn, o);
@@ -1203,19 +1581,268 @@ namespace jank::runtime
     return obj::repeat::create(n, val);
   }
 
-  object_ref sort(object_ref const coll)
+  /* Below this many items, a sort isn't worth splitting across the pool. */
+  static constexpr usize parallel_sort_min{ 1 << 14 };
+
+  /* The half of a split sort which is handed off to the pool. */
+  struct sort_fork
   {
-    return visit_seqable(
-      [](auto const typed_coll) -> object_ref {
-        native_vector<object_ref> vec;
-        for(auto const &e : make_sequence_range(typed_coll))
+    std::exception_ptr error{};
+    std::atomic_bool done{};
+  };
+
+  /* Every comparator given to this breaks ties on the items' original index, so std::sort
+   * is as good as a stable sort here. Large ranges are split in half, with the right half
+   * sorted on the pool while this thread sorts the left, and the halves are then merged. */
+  template <typename It, typename Less>
+  static void parallel_sort(It const begin, It const end, Less const &less, usize const depth)
+  {
+    auto const size{ static_cast<usize>(end - begin) };
+    if(depth == 0 || size < parallel_sort_min)
+    {
+      std::sort(begin, end, less);
+      return;
+    }
+
+    auto &pool{ pooled_executor() };
+    auto const mid{ begin + static_cast<std::ptrdiff_t>(size / 2) };
+    /* The worker doesn't write any objects, so the fork can live on our stack, given that
+     * we always join before returning. */
+    sort_fork forked;
+    pool.submit([&forked, &less, mid, end, depth] {
+      try
+      {
+        parallel_sort(mid, end, less, depth - 1);
+      }
+      catch(...)
+      {
+        forked.error = std::current_exception();
+      }
+      forked.done.store(true, std::memory_order_release);
+    });
+
+    std::exception_ptr left_error{};
+    try
+    {
+      parallel_sort(begin, mid, less, depth - 1);
+    }
+    catch(...)
+    {
+      left_error = std::current_exception();
+    }
+
+    while(!forked.done.load(std::memory_order_acquire))
+    {
+      if(!pool.run_pending_task())
+      {
+        std::this_thread::yield();
+      }
+    }
+
+    if(left_error)
+    {
+      std::rethrow_exception(left_error);
+    }
+    if(forked.error)
+    {
+      std::rethrow_exception(forked.error);
+    }
+    std::inplace_merge(begin, mid, end, less);
+  }
+
+  /* How many times a sort of this size should be split, so that each worker gets a part. */
+  static usize parallel_sort_depth(usize const size)
+  {
+    if(size < parallel_sort_min * 2)
+    {
+      return 0;
+    }
+    return static_cast<usize>(std::bit_width(pooled_executor().thread_count()));
+  }
+
+  /* A stable LSD radix sort, a byte at a time. A byte which is the same for every key
+   * doesn't need a pass, so small integers only take a pass or two. */
+  static void radix_sort(native_vector<std::pair<u64, usize>> &keys)
+  {
+    native_vector<std::pair<u64, usize>> scratch(keys.size());
+    for(usize shift{}; shift < 64; shift += 8)
+    {
+      std::array<usize, 257> offsets{};
+      for(auto const &k : keys)
+      {
+        ++offsets[((k.first >> shift) & 0xff) + 1];
+      }
+      if(offsets[((keys.front().first >> shift) & 0xff) + 1] == keys.size())
+      {
+        continue;
+      }
+
+      for(usize i{ 1 }; i < offsets.size(); ++i)
+      {
+        offsets[i] += offsets[i - 1];
+      }
+      for(auto const &k : keys)
+      {
+        scratch[offsets[(k.first >> shift) & 0xff]++] = k;
+      }
+      std::swap(keys, scratch);
+    }
+  }
+
+  enum class sort_key_kind : u8
+  {
+    integer,
+    real,
+    string,
+    keyword,
+    other
+  };
+
+  /* When every key is the same primitive type, they can be compared without going through
+   * compare, and integers don't need comparing at all. NaN has no order, so those are left
+   * to compare, as before. */
+  static sort_key_kind sort_key_kind_of(native_vector<object_ref> const &keys)
+  {
+    auto const type{ keys.front()->type };
+    for(auto const k : keys)
+    {
+      if(k->type != type)
+      {
+        return sort_key_kind::other;
+      }
+    }
+
+    switch(type)
+    {
+      case object_type::integer:
+        return sort_key_kind::integer;
+      case object_type::real:
+        for(auto const k : keys)
         {
-          vec.push_back(e);
+          if(std::isnan(expect_object<obj::real>(k)->data))
+          {
+            return sort_key_kind::other;
+          }
         }
+        return sort_key_kind::real;
+      case object_type::persistent_string:
+        return sort_key_kind::string;
+      case object_type::keyword:
+        return sort_key_kind::keyword;
+      default:
+        return sort_key_kind::other;
+    }
+  }
 
-        std::stable_sort(vec.begin(), vec.end(), [](object_ref const a, object_ref const b) {
-          return runtime::compare(a, b) < 0;
+  /* The indices of the keys, in the order a stable sort by compare would put them. */
+  static native_vector<usize> sorted_order(native_vector<object_ref> const &keys)
+  {
+    native_vector<usize> order(keys.size());
+    if(keys.size() < 2)
+    {
+      std::iota(order.begin(), order.end(), 0);
+      return order;
+    }
+
+    auto const depth{ parallel_sort_depth(keys.size()) };
+    auto const sort_order([&](auto const &compare_keys) {
+      std::iota(order.begin(), order.end(), 0);
+      parallel_sort(
+        order.begin(),
+        order.end(),
+        [&](usize const l, usize const r) {
+          auto const res{ compare_keys(keys[l], keys[r]) };
+          return res < 0 || (res == 0 && l < r);
+        },
+        depth);
+    });
+
+    switch(sort_key_kind_of(keys))
+    {
+      case sort_key_kind::integer:
+        {
+          native_vector<std::pair<u64, usize>> pairs;
+          pairs.reserve(keys.size());
+          for(usize i{}; i < keys.size(); ++i)
+          {
+            /* Flipping the sign bit puts negatives first, when compared unsigned. */
+            auto const n{ expect_object<obj::integer>(keys[i])->data };
+            pairs.emplace_back(static_cast<u64>(n) ^ (u64{ 1 } << 63), i);
+          }
+          radix_sort(pairs);
+          for(usize i{}; i < pairs.size(); ++i)
+          {
+            order[i] = pairs[i].second;
+          }
+          break;
+        }
+      case sort_key_kind::real:
+        {
+          native_vector<std::pair<f64, usize>> pairs;
+          pairs.reserve(keys.size());
+          for(usize i{}; i < keys.size(); ++i)
+          {
+            pairs.emplace_back(expect_object<obj::real>(keys[i])->data, i);
+          }
+          parallel_sort(pairs.begin(), pairs.end(), std::less<>{}, depth);
+          for(usize i{}; i < pairs.size(); ++i)
+          {
+            order[i] = pairs[i].second;
+          }
+          break;
+        }
+      case sort_key_kind::string:
+        sort_order([](object_ref const l, object_ref const r) -> i64 {
+          return expect_object<obj::persistent_string>(l)->data.compare(
+            expect_object<obj::persistent_string>(r)->data);
+        });
+        break;
+      case sort_key_kind::keyword:
+        sort_order([](object_ref const l, object_ref const r) -> i64 {
+          return expect_object<obj::keyword>(l)->compare(*expect_object<obj::keyword>(r));
         });
+        break;
+      case sort_key_kind::other:
+        sort_order([](object_ref const l, object_ref const r) { return runtime::compare(l, r); });
+        break;
+    }
+    return order;
+  }
+
+  /* Whether comp puts l before r. As with Clojure's fns, comp can either give a number,
+   * like compare, or a boolean, like <. */
+  static bool comparator_less(object_ref const comp, object_ref const l, object_ref const r)
+  {
+    auto const res(dynamic_call(comp, l, r));
+    if(res->type == object_type::boolean)
+    {
+      return expect_object<obj::boolean>(res)->data;
+    }
+    return to_int(res) < 0;
+  }
+
+  static native_vector<object_ref> reordered(native_vector<object_ref> const &items,
+                                             native_vector<usize> const &order)
+  {
+    native_vector<object_ref> ret;
+    ret.reserve(order.size());
+    for(auto const i : order)
+    {
+      ret.push_back(items[i]);
+    }
+    return ret;
+  }
+
+  /* Collects the items of coll, has sort_items put them in order, and gives them back as a
+   * seq with the meta of coll. */
+  template <typename F>
+  static object_ref sort_items_of(object_ref const coll, F const &sort_items)
+  {
+    return visit_seqable(
+      [&](auto const typed_coll) -> object_ref {
+        native_vector<object_ref> vec;
+        for_each_item(typed_coll, [&](object_ref const e) { vec.push_back(e); });
+        sort_items(vec);
 
         using T = typename jtl::decay_t<decltype(typed_coll)>::value_type;
 
@@ -1231,6 +1858,55 @@ namespace jank::runtime
       coll);
   }
 
+  object_ref sort(object_ref const coll)
+  {
+    return sort_items_of(coll, [](native_vector<object_ref> &items) {
+      items = reordered(items, sorted_order(items));
+    });
+  }
+
+  object_ref sort(object_ref const comp, object_ref const coll)
+  {
+    return sort_items_of(coll, [=](native_vector<object_ref> &items) {
+      std::stable_sort(items.begin(), items.end(), [=](object_ref const l, object_ref const r) {
+        return comparator_less(comp, l, r);
+      });
+    });
+  }
+
+  /* Each key is found once, up front, rather than on every comparison. */
+  static native_vector<object_ref>
+  sort_keys(object_ref const keyfn, native_vector<object_ref> const &items)
+  {
+    native_vector<object_ref> keys;
+    keys.reserve(items.size());
+    for(auto const e : items)
+    {
+      keys.push_back(dynamic_call(keyfn, e));
+    }
+    return keys;
+  }
+
+  object_ref sort_by(object_ref const keyfn, object_ref const coll)
+  {
+    return sort_items_of(coll, [=](native_vector<object_ref> &items) {
+      items = reordered(items, sorted_order(sort_keys(keyfn, items)));
+    });
+  }
+
+  object_ref sort_by(object_ref const keyfn, object_ref const comp, object_ref const coll)
+  {
+    return sort_items_of(coll, [=](native_vector<object_ref> &items) {
+      auto const keys{ sort_keys(keyfn, items) };
+      native_vector<usize> order(items.size());
+      std::iota(order.begin(), order.end(), 0);
+      std::stable_sort(order.begin(), order.end(), [&](usize const l, usize const r) {
+        return comparator_less(comp, keys[l], keys[r]);
+      });
+      items = reordered(items, order);
+    });
+  }
+
   object_ref shuffle(object_ref const coll)
   {
     return visit_seqable(
@@ -1241,9 +1917,7 @@ namespace jank::runtime
           vec.push_back(e);
         }
 
-        static std::random_device rd;
-        std::mt19937 g(rd());
-        std::shuffle(vec.begin(), vec.end(), g);
+        std::shuffle(vec.begin(), vec.end(), thread_random());
 
         return make_box<obj::persistent_vector>(
           runtime::detail::native_persistent_vector{ vec.begin(), vec.end() });
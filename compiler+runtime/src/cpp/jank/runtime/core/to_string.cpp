@@ -1,8 +1,53 @@
+#include <algorithm>
+
 #include <jank/runtime/core/to_string.hpp>
+#include <jank/runtime/core/math.hpp>
+#include <jank/runtime/context.hpp>
 #include <jank/runtime/visit.hpp>
+#include <jank/runtime/behavior_table.hpp>
 
 namespace jank::runtime
 {
+  namespace detail
+  {
+    print_state &current_print_state()
+    {
+      static thread_local print_state state;
+      return state;
+    }
+  }
+
+  /* Negative limits print nothing at all, like a limit of 0. */
+  static jtl::option<usize> print_limit(var_ref const v)
+  {
+    auto const limit(v->deref());
+    if(limit.is_nil())
+    {
+      return none;
+    }
+    return static_cast<usize>(std::max<i64>(to_int(limit), 0));
+  }
+
+  print_limits_scope::print_limits_scope()
+  {
+    auto &state(detail::current_print_state());
+    previous_length = state.length;
+    previous_level = state.level;
+    previous_depth = state.depth;
+
+    state.length = print_limit(__rt_ctx->print_length_var);
+    state.level = print_limit(__rt_ctx->print_level_var);
+    state.depth = 0;
+  }
+
+  print_limits_scope::~print_limits_scope()
+  {
+    auto &state(detail::current_print_state());
+    state.length = previous_length;
+    state.level = previous_level;
+    state.depth = previous_depth;
+  }
+
   jtl::immutable_string to_string(object_ref const o)
   {
     return visit_object([](auto const typed_o) { return typed_o->to_string(); }, o);
@@ -15,7 +60,28 @@ namespace jank::runtime
 
   void to_string(object_ref const o, jtl::string_builder &buff)
   {
-    visit_object([&](auto const typed_o) { typed_o->to_string(buff); }, o);
+    behaviors_of(o).to_string(o.data, buff);
+  }
+
+  usize to_string_size(object_ref const o)
+  {
+    switch(o->type)
+    {
+      case object_type::nil:
+        return 0;
+      case object_type::persistent_string:
+        return expect_object<obj::persistent_string>(o)->data.size();
+      case object_type::character:
+        return expect_object<obj::character>(o)->data.size();
+      case object_type::boolean:
+        return 5;
+      case object_type::integer:
+        return 20;
+      case object_type::real:
+        return 24;
+      default:
+        return 16;
+    }
   }
 
   jtl::immutable_string to_code_string(object_ref const o)
@@ -25,13 +91,11 @@ namespace jank::runtime
 
   void to_code_string(char const ch, jtl::string_builder &buff)
   {
-    buff(obj::character{ ch }.to_code_string());
+    obj::character{ ch }.to_code_string(buff);
   }
 
   void to_code_string(object_ref const o, jtl::string_builder &buff)
   {
-    auto const value{ visit_object([](auto const typed_o) { return typed_o->to_code_string(); },
-                                   o) };
-    buff(value);
+    behaviors_of(o).to_code_string(o.data, buff);
   }
 }
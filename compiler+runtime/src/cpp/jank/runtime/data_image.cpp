@@ -0,0 +1,513 @@
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include <gc/gc.h>
+
+#include <jank/runtime/data_image.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/io.hpp>
+#include <jank/runtime/visit.hpp>
+#include <jank/runtime/core/equal.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/seq.hpp>
+#include <jank/runtime/core/seq_ext.hpp>
+#include <jank/runtime/core/to_string.hpp>
+#include <jank/runtime/obj/mapped_map.hpp>
+#include <jank/runtime/obj/mapped_vector.hpp>
+#include <jank/util/fmt.hpp>
+#include <jank/util/scope_exit.hpp>
+
+namespace jank::runtime
+{
+  using tag = data_image::tag;
+
+  static constexpr std::array<char, 8> magic{ 'j', 'a', 'n', 'k', 'd', 'a', 't', 'a' };
+  static constexpr u32 version{ 1 };
+  /* The magic, the version, the hash probe, and the offset of the root. */
+  static constexpr usize header_size{ magic.size() + 2 * sizeof(u32) + sizeof(u64) };
+  /* Writing is recursive, so data can't be allowed to nest without bound. */
+  static constexpr usize max_depth{ 512 };
+  /* Nodes bigger than this aren't worth looking for a copy of. */
+  static constexpr usize max_shared_node_size{ 4096 };
+
+  /* Lookups in an image only work if we hash keys exactly as the jank which wrote it did,
+   * so we keep the hash of some known values in the header. */
+  static u32 hash_probe()
+  {
+    return hash::combine(
+      hash::combine(hash::string("jank data image"), hash::integer(static_cast<i64>(-42))),
+      hash::real(1.5));
+  }
+
+  [[noreturn]]
+  static void corrupt(jtl::immutable_string const &path)
+  {
+    throw std::runtime_error{ util::format("corrupt data image: {}", path) };
+  }
+
+  /* Each node is built in its own buffer, so it can be compared with the nodes written
+   * before it. All values are little endian, which is checked when an image is opened. */
+  struct image_writer
+  {
+    static void append_u32(std::string &out, u32 const u)
+    {
+      out.append(reinterpret_cast<char const *>(&u), sizeof(u));
+    }
+
+    static void append_u64(std::string &out, u64 const u)
+    {
+      out.append(reinterpret_cast<char const *>(&u), sizeof(u));
+    }
+
+    static void append_bytes(std::string &out, jtl::immutable_string_view const &s)
+    {
+      append_u64(out, s.size());
+      out.append(s.data(), s.size());
+    }
+
+    u64 emit(std::string &&node)
+    {
+      if(node.size() <= max_shared_node_size)
+      {
+        auto const found(nodes.find(node));
+        if(found != nodes.end())
+        {
+          return found->second;
+        }
+      }
+
+      auto const offset(static_cast<u64>(buffer.size()));
+      buffer.append(node);
+      if(node.size() <= max_shared_node_size)
+      {
+        nodes.emplace(std::move(node), offset);
+      }
+      return offset;
+    }
+
+    static std::string start(tag const t)
+    {
+      std::string ret;
+      ret.push_back(static_cast<char>(t));
+      return ret;
+    }
+
+    u64 write_items(tag const t, object_ref const coll, usize const depth)
+    {
+      native_vector<u64> items;
+      for_each(coll, [&](object_ref const e) { items.emplace_back(write(e, depth + 1)); });
+
+      auto node(start(t));
+      node.reserve(1 + sizeof(u64) * (items.size() + 1));
+      append_u64(node, items.size());
+      for(auto const item : items)
+      {
+        append_u64(node, item);
+      }
+      return emit(std::move(node));
+    }
+
+    u64 write_map(object_ref const m, usize const depth)
+    {
+      struct entry
+      {
+        u32 hash{};
+        u64 key{};
+        u64 value{};
+      };
+
+      native_vector<entry> entries;
+      visit_map_like(
+        [&](auto const typed_m) {
+          entries.reserve(typed_m->count());
+          for(auto const &pair : typed_m->data)
+          {
+            auto const key(write(pair.first, depth + 1));
+            auto const value(write(pair.second, depth + 1));
+            entries.push_back({ hash::visit(pair.first), key, value });
+          }
+        },
+        m);
+      std::ranges::sort(entries, {}, &entry::hash);
+
+      auto node(start(tag::map));
+      node.reserve(1 + sizeof(u64) + entries.size() * data_image::map_entry_size);
+      append_u64(node, entries.size());
+      for(auto const &e : entries)
+      {
+        append_u32(node, e.hash);
+        append_u64(node, e.key);
+        append_u64(node, e.value);
+      }
+      return emit(std::move(node));
+    }
+
+    u64 write(object_ref const o, usize const depth)
+    {
+      if(max_depth <= depth)
+      {
+        throw std::runtime_error{ "data is nested too deeply to be written to a data image" };
+      }
+
+      if(is_map(o))
+      {
+        return write_map(o, depth);
+      }
+      else if(is_set(o))
+      {
+        return write_items(tag::set, o, depth);
+      }
+      else if(is_vector(o))
+      {
+        return write_items(tag::vector, o, depth);
+      }
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wswitch-enum"
+      switch(o->type)
+      {
+        case object_type::nil:
+          return emit(start(tag::nil));
+        case object_type::boolean:
+          return emit(
+            start(expect_object<obj::boolean>(o)->data ? tag::boolean_true : tag::boolean_false));
+        case object_type::integer:
+          {
+            auto node(start(tag::integer));
+            append_u64(node, static_cast<u64>(expect_object<obj::integer>(o)->data));
+            return emit(std::move(node));
+          }
+        case object_type::real:
+          {
+            auto node(start(tag::real));
+            append_u64(node, std::bit_cast<u64>(expect_object<obj::real>(o)->data));
+            return emit(std::move(node));
+          }
+        case object_type::persistent_string:
+          {
+            auto node(start(tag::string));
+            append_bytes(node, expect_object<obj::persistent_string>(o)->data);
+            return emit(std::move(node));
+          }
+        case object_type::character:
+          {
+            auto node(start(tag::character));
+            append_bytes(node, expect_object<obj::character>(o)->data);
+            return emit(std::move(node));
+          }
+        case object_type::keyword:
+          {
+            auto const sym(expect_object<obj::keyword>(o)->sym);
+            auto node(start(tag::keyword));
+            append_bytes(node, sym->ns);
+            append_bytes(node, sym->name);
+            return emit(std::move(node));
+          }
+        case object_type::symbol:
+          {
+            auto const sym(expect_object<obj::symbol>(o));
+            auto node(start(tag::symbol));
+            append_bytes(node, sym->ns);
+            append_bytes(node, sym->name);
+            return emit(std::move(node));
+          }
+        default:
+          if(is_seq(o))
+          {
+            return write_items(tag::list, o, depth);
+          }
+          throw std::runtime_error{ util::format("a {} can't be written to a data image: {}",
+                                                 object_type_str(o->type),
+                                                 runtime::to_code_string(o)) };
+      }
+#pragma clang diagnostic pop
+    }
+
+    std::string buffer;
+    native_unordered_map<std::string, u64> nodes;
+  };
+
+  void write_data_image(jtl::immutable_string const &path, object_ref const o)
+  {
+    image_writer writer;
+    writer.buffer.assign(header_size, '\0');
+    auto const root(writer.write(o, 0));
+
+    auto * const header(writer.buffer.data());
+    std::memcpy(header, magic.data(), magic.size());
+    auto const probe(hash_probe());
+    std::memcpy(header + magic.size(), &version, sizeof(version));
+    std::memcpy(header + magic.size() + sizeof(u32), &probe, sizeof(probe));
+    std::memcpy(header + magic.size() + 2 * sizeof(u32), &root, sizeof(root));
+
+    /* An image which is open somewhere would be cut short if we wrote over it, so the new one
+     * goes next to it and then replaces it. The mappings of the old one keep its pages. */
+    auto const tmp_path(util::format("{}.tmp", path));
+    auto const res(io::spit(tmp_path, writer.buffer, false));
+    if(res.is_err())
+    {
+      throw std::runtime_error{ util::format("unable to write data image {}: {}",
+                                             path,
+                                             res.expect_err()->message) };
+    }
+    if(std::rename(tmp_path.c_str(), path.c_str()) != 0)
+    {
+      auto const error(std::strerror(errno));
+      std::remove(tmp_path.c_str());
+      throw std::runtime_error{ util::format("unable to write data image {}: {}", path, error) };
+    }
+  }
+
+  data_image::data_image(jtl::immutable_string const &path,
+                         char const * const head,
+                         usize const size)
+    : path{ path }
+    , head{ head }
+    , size{ size }
+  {
+  }
+
+  static void GC_CALLBACK unmap_image(void * const p, void *)
+  {
+    auto const image(static_cast<data_image *>(p));
+    munmap(const_cast<char *>(image->head), image->size);
+  }
+
+  object_ref open_data_image(jtl::immutable_string const &path)
+  {
+    if constexpr(std::endian::native != std::endian::little)
+    {
+      throw std::runtime_error{ "data images are only supported on little endian systems" };
+    }
+
+    auto const fd(::open(path.c_str(), O_RDONLY | O_CLOEXEC));
+    if(fd < 0)
+    {
+      throw std::runtime_error{ util::format("unable to open data image {}: {}",
+                                             path,
+                                             std::strerror(errno)) };
+    }
+    util::scope_exit const finally{ [&] { ::close(fd); } };
+
+    struct stat st{};
+    if(fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(header_size))
+    {
+      corrupt(path);
+    }
+    auto const size(static_cast<usize>(st.st_size));
+
+    auto const head(mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0));
+    /* MAP_FAILED is a macro which does a C-style cast. */
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wold-style-cast"
+    /* NOLINTNEXTLINE(cppcoreguidelines-pro-type-cstyle-cast,performance-no-int-to-ptr) */
+    if(head == MAP_FAILED)
+#pragma clang diagnostic pop
+    {
+      throw std::runtime_error{ util::format("unable to map data image {}: {}",
+                                             path,
+                                             std::strerror(errno)) };
+    }
+
+    /* The values from an image only refer to it, not to the mapping, so the mapping goes
+     * once the image is collected. */
+    auto const image(new(GC) data_image{ path, static_cast<char const *>(head), size });
+    GC_register_finalizer(image, &unmap_image, nullptr, nullptr, nullptr);
+
+    if(std::memcmp(image->head, magic.data(), magic.size()) != 0)
+    {
+      corrupt(path);
+    }
+    if(image->u32_at(magic.size()) != version)
+    {
+      throw std::runtime_error{ util::format(
+        "data image {} has version {}, but this jank reads version {}",
+        path,
+        image->u32_at(magic.size()),
+        version) };
+    }
+    if(image->u32_at(magic.size() + sizeof(u32)) != hash_probe())
+    {
+      throw std::runtime_error{ util::format(
+        "data image {} was written by a jank which hashes differently; it needs to be "
+        "written again",
+        path) };
+    }
+    return image->root();
+  }
+
+  void data_image::check(u64 const offset, u64 const length) const
+  {
+    if(size < offset || size - offset < length)
+    {
+      corrupt(path);
+    }
+  }
+
+  tag data_image::tag_at(u64 const offset) const
+  {
+    check(offset, 1);
+    auto const t(static_cast<u8>(head[offset]));
+    if(static_cast<u8>(tag::set) < t)
+    {
+      corrupt(path);
+    }
+    return static_cast<tag>(t);
+  }
+
+  u32 data_image::u32_at(u64 const offset) const
+  {
+    check(offset, sizeof(u32));
+    u32 ret{};
+    std::memcpy(&ret, head + offset, sizeof(ret));
+    return ret;
+  }
+
+  u64 data_image::u64_at(u64 const offset) const
+  {
+    check(offset, sizeof(u64));
+    u64 ret{};
+    std::memcpy(&ret, head + offset, sizeof(ret));
+    return ret;
+  }
+
+  u64 data_image::child_at(u64 const parent, u64 const offset) const
+  {
+    auto const child(u64_at(offset));
+    if(parent <= child || child < header_size)
+    {
+      corrupt(path);
+    }
+    return child;
+  }
+
+  jtl::immutable_string_view data_image::bytes_at(u64 const offset) const
+  {
+    auto const length(u64_at(offset));
+    check(offset + sizeof(u64), length);
+    return { head + offset + sizeof(u64), length };
+  }
+
+  usize data_image::count_at(u64 const offset, usize const item_size) const
+  {
+    auto const count(u64_at(offset + 1));
+    if((size - offset) / item_size < count)
+    {
+      corrupt(path);
+    }
+    check(offset + 1 + sizeof(u64), count * item_size);
+    return count;
+  }
+
+  object_ref data_image::root() const
+  {
+    auto const offset(u64_at(magic.size() + 2 * sizeof(u32)));
+    if(offset < header_size)
+    {
+      corrupt(path);
+    }
+    return read(offset);
+  }
+
+  object_ref data_image::read(u64 const offset) const
+  {
+    switch(tag_at(offset))
+    {
+      case tag::nil:
+        return jank_nil();
+      case tag::boolean_false:
+        return jank_false;
+      case tag::boolean_true:
+        return jank_true;
+      case tag::integer:
+        return make_box(static_cast<i64>(u64_at(offset + 1)));
+      case tag::real:
+        return make_box(std::bit_cast<f64>(u64_at(offset + 1)));
+      case tag::string:
+        return make_box(jtl::immutable_string{ bytes_at(offset + 1) });
+      case tag::character:
+        return make_box<obj::character>(jtl::immutable_string{ bytes_at(offset + 1) });
+      case tag::keyword:
+        {
+          auto const ns(bytes_at(offset + 1));
+          auto const name(bytes_at(offset + 1 + sizeof(u64) + ns.size()));
+          return __rt_ctx
+            ->intern_keyword(jtl::immutable_string{ ns }, jtl::immutable_string{ name }, true)
+            .expect_ok();
+        }
+      case tag::symbol:
+        {
+          auto const ns(bytes_at(offset + 1));
+          auto const name(bytes_at(offset + 1 + sizeof(u64) + ns.size()));
+          return make_box<obj::symbol>(jtl::immutable_string{ ns }, jtl::immutable_string{ name });
+        }
+      case tag::vector:
+        return make_box<obj::mapped_vector>(this, offset);
+      case tag::map:
+        return make_box<obj::mapped_map>(detail::native_mapped_map{ this, offset });
+      case tag::set:
+        {
+          auto const count(count_at(offset, sizeof(u64)));
+          auto const items(offset + 1 + sizeof(u64));
+          detail::native_transient_hash_set ret;
+          for(usize i{}; i < count; ++i)
+          {
+            ret.insert(read(child_at(offset, items + i * sizeof(u64))));
+          }
+          return make_box<obj::persistent_hash_set>(ret.persistent());
+        }
+      case tag::list:
+        {
+          auto const count(count_at(offset, sizeof(u64)));
+          auto const items(offset + 1 + sizeof(u64));
+          native_vector<object_ref> ret;
+          ret.reserve(count);
+          for(usize i{}; i < count; ++i)
+          {
+            ret.emplace_back(read(child_at(offset, items + i * sizeof(u64))));
+          }
+          return make_box<obj::persistent_list>(std::in_place, ret.rbegin(), ret.rend());
+        }
+    }
+    corrupt(path);
+  }
+
+  bool data_image::equal(u64 const offset, object_ref const o) const
+  {
+    auto const t(tag_at(offset));
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wswitch-enum"
+    switch(o->type)
+    {
+      case object_type::keyword:
+        {
+          if(t != tag::keyword)
+          {
+            return false;
+          }
+          auto const sym(expect_object<obj::keyword>(o)->sym);
+          auto const ns(bytes_at(offset + 1));
+          return ns == sym->ns && bytes_at(offset + 1 + sizeof(u64) + ns.size()) == sym->name;
+        }
+      case object_type::persistent_string:
+        return t == tag::string
+          && bytes_at(offset + 1) == expect_object<obj::persistent_string>(o)->data;
+      case object_type::integer:
+        return t == tag::integer
+          && static_cast<i64>(u64_at(offset + 1)) == expect_object<obj::integer>(o)->data;
+      default:
+        return runtime::equal(read(offset), o);
+    }
+#pragma clang diagnostic pop
+  }
+}
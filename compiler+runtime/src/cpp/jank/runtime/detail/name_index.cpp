@@ -0,0 +1,127 @@
+#include <jank/runtime/detail/name_index.hpp>
+#include <jank/runtime/ns.hpp>
+#include <jank/runtime/var.hpp>
+#include <jank/runtime/obj/keyword.hpp>
+#include <jank/runtime/obj/symbol.hpp>
+
+namespace jank::runtime::detail
+{
+  void name_index::add_ns(ns_ref const n)
+  {
+    auto locked{ data.wlock() };
+    locked->namespaces.insert_or_assign(n->name->name, n);
+  }
+
+  void name_index::remove_ns(ns_ref const n)
+  {
+    auto locked{ data.wlock() };
+    auto const found{ locked->namespaces.find(n->name->name) };
+    if(found == locked->namespaces.end() || found->second != n)
+    {
+      return;
+    }
+    locked->namespaces.erase(found);
+
+    auto &qualified{ locked->qualified_vars };
+    auto it{ qualified.lower_bound({ n->name->name, "" }) };
+    while(it != qualified.end() && it->first.first == n->name->name)
+    {
+      locked->vars.erase({ it->first.second, it->first.first });
+      it = qualified.erase(it);
+    }
+  }
+
+  void name_index::add_var(var_ref const v)
+  {
+    auto const &ns_name{ v->n->name->name };
+    auto locked{ data.wlock() };
+    auto const found{ locked->namespaces.find(ns_name) };
+    if(found == locked->namespaces.end() || found->second != v->n)
+    {
+      return;
+    }
+
+    locked->qualified_vars.insert_or_assign({ ns_name, v->name->name }, v);
+    locked->vars.insert_or_assign({ v->name->name, ns_name }, v);
+  }
+
+  void name_index::remove_var(var_ref const v)
+  {
+    auto const &ns_name{ v->n->name->name };
+    auto locked{ data.wlock() };
+    auto const found{ locked->qualified_vars.find({ ns_name, v->name->name }) };
+    if(found == locked->qualified_vars.end() || found->second != v)
+    {
+      return;
+    }
+
+    locked->qualified_vars.erase(found);
+    locked->vars.erase({ v->name->name, ns_name });
+  }
+
+  void name_index::add_keyword(obj::keyword_ref const kw)
+  {
+    auto locked{ data.wlock() };
+    locked->keywords.insert_or_assign(kw->to_string(), kw);
+  }
+
+  native_vector<object_ref> name_index::complete(jtl::immutable_string const &prefix,
+                                                 usize const max,
+                                                 std::function<bool(object_ref)> const &keep) const
+  {
+    native_vector<object_ref> ret;
+    auto const add([&](object_ref const o) {
+      if(!keep || keep(o))
+      {
+        ret.emplace_back(o);
+      }
+    });
+    auto const locked{ data.rlock() };
+
+    if(prefix.starts_with(':'))
+    {
+      for(auto it{ locked->keywords.lower_bound(prefix) };
+          it != locked->keywords.end() && ret.size() < max && it->first.starts_with(prefix);
+          ++it)
+      {
+        add(it->second);
+      }
+      return ret;
+    }
+
+    auto const slash{ prefix.find('/') };
+    if(slash != jtl::immutable_string::npos && 0 < slash)
+    {
+      jtl::immutable_string const ns_name{ prefix.data(), slash };
+      jtl::immutable_string const name{ prefix.data() + slash + 1, prefix.size() - slash - 1 };
+      for(auto it{ locked->qualified_vars.lower_bound({ ns_name, name }) };
+          it != locked->qualified_vars.end() && ret.size() < max && it->first.first == ns_name
+          && it->first.second.starts_with(name);
+          ++it)
+      {
+        add(it->second);
+      }
+      return ret;
+    }
+
+    for(auto it{ locked->namespaces.lower_bound(prefix) };
+        it != locked->namespaces.end() && ret.size() < max && it->first.starts_with(prefix);
+        ++it)
+    {
+      add(it->second);
+    }
+    for(auto it{ locked->vars.lower_bound({ prefix, "" }) };
+        it != locked->vars.end() && ret.size() < max && it->first.first.starts_with(prefix);
+        ++it)
+    {
+      add(it->second);
+    }
+    return ret;
+  }
+
+  usize name_index::size() const
+  {
+    auto const locked{ data.rlock() };
+    return locked->namespaces.size() + locked->qualified_vars.size() + locked->keywords.size();
+  }
+}
@@ -1,3 +1,5 @@
+#include <bit>
+
 #include <jank/runtime/detail/native_array_map.hpp>
 #include <jank/runtime/core/equal.hpp>
 #include <jank/runtime/obj/nil.hpp>
@@ -5,7 +7,6 @@
 
 namespace jank::runtime::detail
 {
-  /* TODO: Int sequence to clean this up? */
   static object_ref *make_next_array(object_ref * const prev,
                                      u8 const cap,
                                      u8 const length,
@@ -19,103 +20,55 @@ namespace jank::runtime::detail
       return prev;
     }
 
-    switch(length)
+    if(native_array_map::max_size * 2 < length + 2)
+    {
+      throw std::runtime_error{ util::format(
+        "Unable to expand array map to size {}. Be sure to check the size prior to insertion and "
+        "promote to hash map if needed.",
+        (length / 2) + 1) };
+    }
+
+    auto const ret(new(GC) object_ref[length + 2]);
+    for(u8 i{}; i < length; ++i)
+    {
+      ret[i] = prev[i];
+    }
+    ret[length] = key;
+    ret[length + 1] = value;
+    return ret;
+  }
+
+  /* Keywords are interned, so they can be compared by pointer alone. This checks every key,
+   * without stopping at a match, and builds a mask of the matches. With no branches in the
+   * loop, the compiler can vectorize it, which is much faster than an early exit for the
+   * handful of keys an array map can hold. Returns the index of the matching key, or the
+   * length if there's none. */
+  static u8 find_identical(object_ref const * const data, u8 const length, object_ref const key)
+  {
+    u64 matches{};
+    for(u8 i{}; i < length; i += 2)
     {
-      case 0:
-        {
-          auto const ret(new(GC) object_ref[2]{ key, value });
-          return ret;
-        }
-      case 2:
-        {
-          auto const ret(new(GC) object_ref[4]{ prev[0], prev[1], key, value });
-          return ret;
-        }
-      case 4:
-        {
-          auto const ret(new(GC) object_ref[6]{ prev[0], prev[1], prev[2], prev[3], key, value });
-          return ret;
-        }
-      case 6:
-        {
-          auto const ret(new(
-            GC) object_ref[8]{ prev[0], prev[1], prev[2], prev[3], prev[4], prev[5], key, value });
-          return ret;
-        }
-      case 8:
-        {
-          auto const ret(new(GC) object_ref[10]{ prev[0],
-                                                 prev[1],
-                                                 prev[2],
-                                                 prev[3],
-                                                 prev[4],
-                                                 prev[5],
-                                                 prev[6],
-                                                 prev[7],
-                                                 key,
-                                                 value });
-          return ret;
-        }
-      case 10:
-        {
-          auto const ret(new(GC) object_ref[12]{ prev[0],
-                                                 prev[1],
-                                                 prev[2],
-                                                 prev[3],
-                                                 prev[4],
-                                                 prev[5],
-                                                 prev[6],
-                                                 prev[7],
-                                                 prev[8],
-                                                 prev[9],
-                                                 key,
-                                                 value });
-          return ret;
-        }
-      case 12:
-        {
-          auto const ret(new(GC) object_ref[14]{ prev[0],
-                                                 prev[1],
-                                                 prev[2],
-                                                 prev[3],
-                                                 prev[4],
-                                                 prev[5],
-                                                 prev[6],
-                                                 prev[7],
-                                                 prev[8],
-                                                 prev[9],
-                                                 prev[10],
-                                                 prev[11],
-                                                 key,
-                                                 value });
-          return ret;
-        }
-      case 14:
-        {
-          auto const ret(new(GC) object_ref[16]{ prev[0],
-                                                 prev[1],
-                                                 prev[2],
-                                                 prev[3],
-                                                 prev[4],
-                                                 prev[5],
-                                                 prev[6],
-                                                 prev[7],
-                                                 prev[8],
-                                                 prev[9],
-                                                 prev[10],
-                                                 prev[11],
-                                                 prev[12],
-                                                 prev[13],
-                                                 key,
-                                                 value });
-          return ret;
-        }
-      default:
-        throw std::runtime_error{ util::format(
-          "Unable to expand array map to size {}. Be sure to check the size prior to insertion and "
-          "promote to hash map if needed.",
-          (length / 2) + 1) };
+      matches |= static_cast<u64>(data[i].data == key.data) << (i / 2);
+    }
+    return matches ? static_cast<u8>(std::countr_zero(matches) * 2) : length;
+  }
+
+  /* Returns the index of the matching key, or the length if there's none. */
+  static u8 find_index(object_ref const * const data, u8 const length, object_ref const key)
+  {
+    if(key->type == runtime::object_type::keyword)
+    {
+      return find_identical(data, length, key);
+    }
+
+    for(u8 i{}; i < length; i += 2)
+    {
+      if(runtime::equal(data[i], key))
+      {
+        return i;
+      }
     }
+    return length;
   }
 
   native_array_map::~native_array_map()
@@ -135,96 +88,42 @@ namespace jank::runtime::detail
 
   void native_array_map::insert_or_assign(object_ref const key, object_ref const val)
   {
-    if(key->type == runtime::object_type::keyword)
-    {
-      for(u8 i{}; i < length; i += 2)
-      {
-        if(data[i] == key)
-        {
-          data[i + 1] = val;
-          hash = 0;
-          return;
-        }
-      }
-    }
-    else
+    auto const i{ find_index(data, length, key) };
+    if(i < length)
     {
-      for(u8 i{}; i < length; i += 2)
-      {
-        if(runtime::equal(data[i], key))
-        {
-          data[i + 1] = val;
-          hash = 0;
-          return;
-        }
-      }
+      data[i + 1] = val;
+      hash = 0;
+      return;
     }
     insert_unique(key, val);
   }
 
   jtl::option<object_ref> native_array_map::find(object_ref const key) const
   {
-    if(key->type == runtime::object_type::keyword)
-    {
-      for(u8 i{}; i < length; i += 2)
-      {
-        if(data[i] == key)
-        {
-          return data[i + 1];
-        }
-      }
-    }
-    else
+    auto const i{ find_index(data, length, key) };
+    if(i < length)
     {
-      for(u8 i{}; i < length; i += 2)
-      {
-        if(runtime::equal(data[i], key))
-        {
-          return data[i + 1];
-        }
-      }
+      return data[i + 1];
     }
     return {};
   }
 
   void native_array_map::erase(object_ref const key)
   {
-    if(key->type == runtime::object_type::keyword)
+    auto const i{ find_index(data, length, key) };
+    if(length <= i)
     {
-      for(u8 i{}; i < length; i += 2)
-      {
-        if(data[i] == key)
-        {
-          for(u8 k(i + 2); k < length; k += 2)
-          {
-            data[k - 2] = data[k];
-            data[k - 1] = data[k + 1];
-          }
-
-          length -= 2;
-          hash = 0;
-          return;
-        }
-      }
+      return;
     }
-    else
+
+    for(u8 k(i + 2); k < length; k += 2)
     {
-      for(u8 i{}; i < length; i += 2)
-      {
-        if(runtime::equal(data[i], key))
-        {
-          for(u8 k(i + 2); k < length; k += 2)
-          {
-            data[k - 2] = data[k];
-            data[k - 1] = data[k + 1];
-          }
-
-          length -= 2;
-          hash = 0;
-          return;
-        }
-      }
+      data[k - 2] = data[k];
+      data[k - 1] = data[k + 1];
     }
+
+    length -= 2;
+    hash = 0;
   }
 
   uhash native_array_map::to_hash() const
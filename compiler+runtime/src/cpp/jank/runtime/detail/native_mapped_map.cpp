@@ -0,0 +1,112 @@
+#include <jank/runtime/detail/native_mapped_map.hpp>
+#include <jank/runtime/data_image.hpp>
+#include <jank/hash.hpp>
+
+namespace jank::runtime::detail
+{
+  /* Past the tag and the count. */
+  static u64 entry_offset(u64 const offset, usize const index)
+  {
+    return offset + 1 + sizeof(u64) + index * data_image::map_entry_size;
+  }
+
+  static object_ref key_of(data_image const * const image, u64 const offset, usize const index)
+  {
+    return image->read(image->child_at(offset, entry_offset(offset, index) + sizeof(u32)));
+  }
+
+  static object_ref
+  value_of(data_image const * const image, u64 const offset, usize const index)
+  {
+    return image->read(
+      image->child_at(offset, entry_offset(offset, index) + sizeof(u32) + sizeof(u64)));
+  }
+
+  native_mapped_map::iterator::value_type native_mapped_map::iterator::operator*() const
+  {
+    return { key_of(image, offset, index), value_of(image, offset, index) };
+  }
+
+  native_mapped_map::iterator &native_mapped_map::iterator::operator++()
+  {
+    ++index;
+    return *this;
+  }
+
+  bool native_mapped_map::iterator::operator==(iterator const &rhs) const
+  {
+    return index == rhs.index;
+  }
+
+  bool native_mapped_map::iterator::operator!=(iterator const &rhs) const
+  {
+    return index != rhs.index;
+  }
+
+  native_mapped_map::native_mapped_map(data_image const * const image, u64 const offset)
+    : image{ image }
+    , offset{ offset }
+    , count{ image->count_at(offset, data_image::map_entry_size) }
+  {
+  }
+
+  jtl::option<object_ref> native_mapped_map::find(object_ref const key) const
+  {
+    auto const hash(hash::visit(key));
+
+    /* The first entry with this hash. Keys with the same hash are next to each other. */
+    usize low{}, high{ count };
+    while(low < high)
+    {
+      auto const mid(low + (high - low) / 2);
+      if(image->u32_at(entry_offset(offset, mid)) < hash)
+      {
+        low = mid + 1;
+      }
+      else
+      {
+        high = mid;
+      }
+    }
+
+    for(auto i(low); i < count && image->u32_at(entry_offset(offset, i)) == hash; ++i)
+    {
+      auto const entry(entry_offset(offset, i));
+      if(image->equal(image->child_at(offset, entry + sizeof(u32)), key))
+      {
+        return image->read(image->child_at(offset, entry + sizeof(u32) + sizeof(u64)));
+      }
+    }
+    return none;
+  }
+
+  object_ref native_mapped_map::key_at(usize const index) const
+  {
+    return key_of(image, offset, index);
+  }
+
+  object_ref native_mapped_map::value_at(usize const index) const
+  {
+    return value_of(image, offset, index);
+  }
+
+  native_mapped_map::const_iterator native_mapped_map::begin() const
+  {
+    return { image, offset, 0 };
+  }
+
+  native_mapped_map::const_iterator native_mapped_map::end() const
+  {
+    return { image, offset, count };
+  }
+
+  usize native_mapped_map::size() const
+  {
+    return count;
+  }
+
+  bool native_mapped_map::empty() const
+  {
+    return count == 0;
+  }
+}
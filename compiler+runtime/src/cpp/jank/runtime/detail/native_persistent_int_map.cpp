@@ -0,0 +1,432 @@
+#include <bit>
+
+#include <jank/runtime/detail/native_persistent_int_map.hpp>
+#include <jank/runtime/detail/native_persistent_sorted_tree.hpp>
+#include <jank/runtime/obj/number.hpp>
+#include <jank/runtime/behavior/callable.hpp>
+
+namespace jank::runtime::detail
+{
+  using node = native_persistent_int_map::node;
+
+  static constexpr u64 sign_bit{ u64{ 1 } << 63 };
+
+  static u64 trie_key(i64 const key)
+  {
+    return static_cast<u64>(key) ^ sign_bit;
+  }
+
+  /* Keeps only the bits above the mask. */
+  static u64 mask_bits(u64 const key, u64 const mask)
+  {
+    return key & ~((mask - 1) | mask);
+  }
+
+  static bool matches(u64 const key, node const * const n)
+  {
+    return mask_bits(key, n->mask) == n->prefix;
+  }
+
+  static bool goes_left(u64 const key, u64 const mask)
+  {
+    return (key & mask) == 0;
+  }
+
+  static node *
+  make_leaf(u64 const key, object_ref const boxed, object_ref const val, u64 const owner)
+  {
+    return new(GC) node{ owner, 1, key, 0, nullptr, nullptr, boxed, val };
+  }
+
+  static node *
+  make_branch(u64 const prefix, u64 const mask, node * const l, node * const r, u64 const owner)
+  {
+    return new(GC) node{ owner, l->size + r->size, prefix, mask, l, r, {}, {} };
+  }
+
+  /* The nodes must have prefixes which don't match each other. */
+  static node *join(node * const a, node * const b, u64 const owner)
+  {
+    auto const mask(u64{ 1 } << (63 - std::countl_zero(a->prefix ^ b->prefix)));
+    auto const prefix(mask_bits(a->prefix, mask));
+    return goes_left(a->prefix, mask) ? make_branch(prefix, mask, a, b, owner)
+                                      : make_branch(prefix, mask, b, a, owner);
+  }
+
+  static node *editable(node * const n, u64 const owner)
+  {
+    if(owner && n->owner == owner)
+    {
+      return n;
+    }
+    auto const ret{ new(GC) node{ *n } };
+    ret->owner = owner;
+    return ret;
+  }
+
+  /* Any node we own only has owned nodes above it, so a child which was updated in place
+   * has a parent we can update in place too. */
+  static node *
+  with_children(node * const n, node * const l, node * const r, u64 const owner)
+  {
+    if(l == n->left && r == n->right && l->size + r->size == n->size)
+    {
+      return n;
+    }
+    auto const ret(editable(n, owner));
+    ret->left = l;
+    ret->right = r;
+    ret->size = l->size + r->size;
+    return ret;
+  }
+
+  static node const *find_leaf(node const *n, u64 const key)
+  {
+    while(n && n->mask != 0)
+    {
+      n = goes_left(key, n->mask) ? n->left : n->right;
+    }
+    return n && n->prefix == key ? n : nullptr;
+  }
+
+  /* Puts the leaf into the trie. When its key is already there, resolve is given the
+   * existing leaf and the new one and returns the value to keep. */
+  template <typename F>
+  static node *insert(node * const n, node * const leaf, u64 const owner, F const &resolve)
+  {
+    if(!n)
+    {
+      return leaf;
+    }
+    else if(n->mask == 0)
+    {
+      if(n->prefix != leaf->prefix)
+      {
+        return join(leaf, n, owner);
+      }
+
+      auto const val(resolve(n, leaf));
+      if(val == n->value)
+      {
+        return n;
+      }
+      else if(val == leaf->value)
+      {
+        return leaf;
+      }
+      auto const ret(editable(n, owner));
+      ret->value = val;
+      return ret;
+    }
+    else if(!matches(leaf->prefix, n))
+    {
+      return join(leaf, n, owner);
+    }
+
+    if(goes_left(leaf->prefix, n->mask))
+    {
+      return with_children(n, insert(n->left, leaf, owner, resolve), n->right, owner);
+    }
+    return with_children(n, n->left, insert(n->right, leaf, owner, resolve), owner);
+  }
+
+  /* The key must be in the trie. */
+  static node *erase(node * const n, u64 const key, u64 const owner)
+  {
+    if(n->mask == 0)
+    {
+      return nullptr;
+    }
+
+    if(goes_left(key, n->mask))
+    {
+      auto const l(erase(n->left, key, owner));
+      return l ? with_children(n, l, n->right, owner) : n->right;
+    }
+    auto const r(erase(n->right, key, owner));
+    return r ? with_children(n, n->left, r, owner) : n->left;
+  }
+
+  template <typename F>
+  static node *merge(node * const l, node * const r, bool const shared_ok, F const &resolve)
+  {
+    if(!l || (shared_ok && l == r))
+    {
+      return r;
+    }
+    else if(!r)
+    {
+      return l;
+    }
+    else if(r->mask == 0)
+    {
+      return insert(l, r, 0, resolve);
+    }
+    else if(l->mask == 0)
+    {
+      return insert(r, l, 0, [&](node const * const existing, node const * const leaf) {
+        return resolve(leaf, existing);
+      });
+    }
+    else if(l->mask == r->mask && l->prefix == r->prefix)
+    {
+      return with_children(l,
+                           merge(l->left, r->left, shared_ok, resolve),
+                           merge(l->right, r->right, shared_ok, resolve),
+                           0);
+    }
+    else if(r->mask < l->mask && matches(r->prefix, l))
+    {
+      return goes_left(r->prefix, l->mask)
+        ? with_children(l, merge(l->left, r, shared_ok, resolve), l->right, 0)
+        : with_children(l, l->left, merge(l->right, r, shared_ok, resolve), 0);
+    }
+    else if(l->mask < r->mask && matches(l->prefix, r))
+    {
+      return goes_left(l->prefix, r->mask)
+        ? with_children(r, merge(l, r->left, shared_ok, resolve), r->right, 0)
+        : with_children(r, r->left, merge(l, r->right, shared_ok, resolve), 0);
+    }
+    return join(l, r, 0);
+  }
+
+  static u64 leaf_key(obj::integer_ref const key)
+  {
+    return trie_key(key->data);
+  }
+
+  native_persistent_int_map::const_iterator::value_type
+  native_persistent_int_map::const_iterator::operator*() const
+  {
+    return { current->key, current->value };
+  }
+
+  native_persistent_int_map::const_iterator &native_persistent_int_map::const_iterator::operator++()
+  {
+    ++index;
+    current = index < root->size ? nth(root, index) : nullptr;
+    return *this;
+  }
+
+  bool native_persistent_int_map::const_iterator::operator==(const_iterator const &rhs) const
+  {
+    return index == rhs.index;
+  }
+
+  bool native_persistent_int_map::const_iterator::operator!=(const_iterator const &rhs) const
+  {
+    return index != rhs.index;
+  }
+
+  node const *native_persistent_int_map::const_iterator::nth(node const *n, usize index)
+  {
+    while(n->mask != 0)
+    {
+      if(index < n->left->size)
+      {
+        n = n->left;
+      }
+      else
+      {
+        index -= n->left->size;
+        n = n->right;
+      }
+    }
+    return n;
+  }
+
+  native_persistent_int_map::native_persistent_int_map(node * const root)
+    : root{ root }
+  {
+  }
+
+  jtl::option<object_ref> native_persistent_int_map::find(i64 const key) const
+  {
+    auto const leaf(find_leaf(root, trie_key(key)));
+    if(leaf)
+    {
+      return leaf->value;
+    }
+    return none;
+  }
+
+  bool native_persistent_int_map::contains(i64 const key) const
+  {
+    return find_leaf(root, trie_key(key)) != nullptr;
+  }
+
+  native_persistent_int_map
+  native_persistent_int_map::set(obj::integer_ref const key, object_ref const val) const
+  {
+    auto const k(leaf_key(key));
+    auto const found(find_leaf(root, k));
+    if(found && found->value == val)
+    {
+      return *this;
+    }
+    return { insert(root, make_leaf(k, key, val, 0), 0, [](auto const, auto const leaf) {
+      return leaf->value;
+    }) };
+  }
+
+  native_persistent_int_map native_persistent_int_map::erase(i64 const key) const
+  {
+    auto const k(trie_key(key));
+    if(!find_leaf(root, k))
+    {
+      return *this;
+    }
+    return { runtime::detail::erase(root, k, 0) };
+  }
+
+  native_persistent_int_map native_persistent_int_map::merge(native_persistent_int_map const &rhs,
+                                                             jtl::option<object_ref> const &f) const
+  {
+    if(f.is_none())
+    {
+      return { runtime::detail::merge(root,
+                                      rhs.root,
+                                      true,
+                                      [](node const * const, node const * const r) {
+                                        return r->value;
+                                      }) };
+    }
+
+    auto const fn(f.unwrap());
+    return { runtime::detail::merge(root,
+                                    rhs.root,
+                                    false,
+                                    [=](node const * const l, node const * const r) {
+                                      return dynamic_call(fn, l->value, r->value);
+                                    }) };
+  }
+
+  native_transient_int_map native_persistent_int_map::transient() const
+  {
+    return { root };
+  }
+
+  native_persistent_int_map::const_iterator native_persistent_int_map::begin() const
+  {
+    if(!root)
+    {
+      return {};
+    }
+    return { root, const_iterator::nth(root, 0), 0 };
+  }
+
+  native_persistent_int_map::const_iterator native_persistent_int_map::end() const
+  {
+    return { root, nullptr, size() };
+  }
+
+  usize native_persistent_int_map::size() const
+  {
+    return root ? root->size : 0;
+  }
+
+  bool native_persistent_int_map::empty() const
+  {
+    return !root;
+  }
+
+  native_transient_int_map::native_transient_int_map()
+    : owner{ next_sorted_tree_owner() }
+  {
+  }
+
+  native_transient_int_map::native_transient_int_map(native_persistent_int_map::node * const root)
+    : root{ root }
+    , owner{ next_sorted_tree_owner() }
+  {
+  }
+
+  native_transient_int_map::native_transient_int_map(native_transient_int_map const &rhs)
+    : root{ rhs.root }
+    , owner{ next_sorted_tree_owner() }
+  {
+  }
+
+  native_transient_int_map::native_transient_int_map(native_transient_int_map &&rhs) noexcept
+    : root{ rhs.root }
+    , owner{ rhs.owner }
+  {
+    rhs.owner = next_sorted_tree_owner();
+  }
+
+  native_transient_int_map &native_transient_int_map::operator=(native_transient_int_map const &rhs)
+  {
+    root = rhs.root;
+    owner = next_sorted_tree_owner();
+    return *this;
+  }
+
+  native_transient_int_map &
+  native_transient_int_map::operator=(native_transient_int_map &&rhs) noexcept
+  {
+    root = rhs.root;
+    owner = rhs.owner;
+    rhs.owner = next_sorted_tree_owner();
+    return *this;
+  }
+
+  jtl::option<object_ref> native_transient_int_map::find(i64 const key) const
+  {
+    return native_persistent_int_map{ root }.find(key);
+  }
+
+  bool native_transient_int_map::contains(i64 const key) const
+  {
+    return find_leaf(root, trie_key(key)) != nullptr;
+  }
+
+  void native_transient_int_map::set(obj::integer_ref const key, object_ref const val)
+  {
+    auto const k(leaf_key(key));
+    auto const found(find_leaf(root, k));
+    if(found && found->value == val)
+    {
+      return;
+    }
+    root = insert(root, make_leaf(k, key, val, owner), owner, [](auto const, auto const leaf) {
+      return leaf->value;
+    });
+  }
+
+  void native_transient_int_map::erase(i64 const key)
+  {
+    auto const k(trie_key(key));
+    if(find_leaf(root, k))
+    {
+      root = runtime::detail::erase(root, k, owner);
+    }
+  }
+
+  /* The nodes we own are now shared, so we take a new owner in case we're updated
+   * again. */
+  native_persistent_int_map native_transient_int_map::persistent()
+  {
+    owner = next_sorted_tree_owner();
+    return { root };
+  }
+
+  native_transient_int_map::const_iterator native_transient_int_map::begin() const
+  {
+    return native_persistent_int_map{ root }.begin();
+  }
+
+  native_transient_int_map::const_iterator native_transient_int_map::end() const
+  {
+    return native_persistent_int_map{ root }.end();
+  }
+
+  usize native_transient_int_map::size() const
+  {
+    return root ? root->size : 0;
+  }
+
+  bool native_transient_int_map::empty() const
+  {
+    return !root;
+  }
+}
@@ -0,0 +1,124 @@
+#include <jank/runtime/detail/native_struct_map.hpp>
+#include <jank/runtime/obj/struct_basis.hpp>
+#include <jank/runtime/core/to_string.hpp>
+#include <jank/util/fmt.hpp>
+
+namespace jank::runtime::detail
+{
+  native_struct_map::native_struct_map(obj::struct_basis_ref const basis)
+    : basis{ basis }
+    , slots{ new(GC) object_ref[basis->keys.size()]{} }
+  {
+  }
+
+  native_struct_map::native_struct_map(obj::struct_basis_ref const basis,
+                                       object_ref * const slots,
+                                       ext_type ext)
+    : basis{ basis }
+    , slots{ slots }
+    , ext{ jtl::move(ext) }
+  {
+  }
+
+  jtl::option<object_ref> native_struct_map::find(object_ref const key) const
+  {
+    auto const slot{ basis->slot(key) };
+    if(slot.is_some())
+    {
+      return slots[slot.unwrap()];
+    }
+
+    if(auto const found{ ext.find(key) })
+    {
+      return *found;
+    }
+    return none;
+  }
+
+  native_struct_map native_struct_map::assoc(object_ref const key, object_ref const val) const
+  {
+    auto const slot{ basis->slot(key) };
+    if(slot.is_none())
+    {
+      return { basis, slots, ext.set(key, val) };
+    }
+
+    auto const count{ slot_count() };
+    auto const copy{ new(GC) object_ref[count] };
+    for(usize i{}; i < count; ++i)
+    {
+      copy[i] = slots[i];
+    }
+    copy[slot.unwrap()] = val;
+    return { basis, copy, ext };
+  }
+
+  native_struct_map native_struct_map::dissoc(object_ref const key) const
+  {
+    if(basis->slot(key).is_some())
+    {
+      throw std::runtime_error{ util::format("can't remove struct key: {}",
+                                             runtime::to_code_string(key)) };
+    }
+    return { basis, slots, ext.erase(key) };
+  }
+
+  native_struct_map::const_iterator native_struct_map::begin() const
+  {
+    return { basis->keys.data(), slots, 0, slot_count(), ext.begin() };
+  }
+
+  native_struct_map::const_iterator native_struct_map::end() const
+  {
+    auto const count{ slot_count() };
+    return { basis->keys.data(), slots, count, count, ext.end() };
+  }
+
+  usize native_struct_map::slot_count() const
+  {
+    return basis->keys.size();
+  }
+
+  usize native_struct_map::size() const
+  {
+    return slot_count() + ext.size();
+  }
+
+  bool native_struct_map::empty() const
+  {
+    return size() == 0;
+  }
+
+  native_struct_map::iterator::value_type native_struct_map::iterator::operator*() const
+  {
+    if(slot < slot_count)
+    {
+      return { keys[slot], slots[slot] };
+    }
+    auto const &entry{ *ext };
+    return { entry.first, entry.second };
+  }
+
+  native_struct_map::iterator &native_struct_map::iterator::operator++()
+  {
+    if(slot < slot_count)
+    {
+      ++slot;
+    }
+    else
+    {
+      ++ext;
+    }
+    return *this;
+  }
+
+  bool native_struct_map::iterator::operator==(iterator const &rhs) const
+  {
+    return slot == rhs.slot && ext == rhs.ext;
+  }
+
+  bool native_struct_map::iterator::operator!=(iterator const &rhs) const
+  {
+    return !(*this == rhs);
+  }
+}
@@ -1,17 +1,47 @@
 #include <jank/runtime/detail/type.hpp>
 #include <jank/runtime/core/equal.hpp>
+#include <jank/runtime/obj/keyword.hpp>
+#include <jank/runtime/obj/number.hpp>
+#include <jank/runtime/obj/persistent_string.hpp>
+#include <jank/runtime/rtti.hpp>
 
 namespace jank::runtime::detail
 {
+  /* Sorted collections almost always have keys of one type, so the common ones are
+   * compared right here, rather than through the dispatch in runtime::compare. These
+   * give the same order as their compare fns. */
   bool object_ref_compare::operator()(object_ref const l, object_ref const r) const
   {
+    if(l->type == r->type)
+    {
+      switch(l->type)
+      {
+        case object_type::integer:
+          return expect_object<obj::integer>(l)->data < expect_object<obj::integer>(r)->data;
+        case object_type::real:
+          return expect_object<obj::real>(l)->data < expect_object<obj::real>(r)->data;
+        case object_type::persistent_string:
+          return expect_object<obj::persistent_string>(l)->data.compare(
+                   expect_object<obj::persistent_string>(r)->data)
+            < 0;
+        case object_type::keyword:
+          return l != r
+            && expect_object<obj::keyword>(l)->compare(*expect_object<obj::keyword>(r)) < 0;
+        default:
+          break;
+      }
+    }
     return runtime::compare(l, r) < 0;
   }
 }
 
 namespace immer
 {
+#ifdef JANK_FLEX_VECTOR
+  template class flex_vector<jank::runtime::object_ref, jank::memory_policy>;
+#else
   template class vector<jank::runtime::object_ref, jank::memory_policy>;
+#endif
   template class set<jank::runtime::object_ref,
                      std::hash<jank::runtime::object_ref>,
                      std::equal_to<jank::runtime::object_ref>,
@@ -0,0 +1,56 @@
+#include <gc/gc.h>
+
+#include <jank/runtime/detail/weak_ref.hpp>
+
+namespace jank::runtime::detail
+{
+  weak_ref::~weak_ref()
+  {
+    reset();
+  }
+
+  void weak_ref::set(object_ref const o)
+  {
+    reset();
+    hidden = GC_HIDE_POINTER(o.data);
+    /* Objects outside of the GC heap, like nil, are never collected, so they don't get a
+     * link. GC_base also gives the start of the object, which the link needs. */
+    if(auto const base{ GC_base(o.data) })
+    {
+      GC_general_register_disappearing_link(reinterpret_cast<void **>(&hidden), base);
+    }
+  }
+
+  void weak_ref::reset()
+  {
+    if(hidden != 0)
+    {
+      GC_unregister_disappearing_link(reinterpret_cast<void **>(&hidden));
+      hidden = 0;
+    }
+  }
+
+  static void *reveal(void * const data)
+  {
+    auto const hidden{ *static_cast<uptr const *>(data) };
+    return hidden == 0 ? nullptr : GC_REVEAL_POINTER(hidden);
+  }
+
+  jtl::option<object_ref> weak_ref::get() const
+  {
+    /* The GC could clear the link between reading it and revealing it, so that's done with
+     * the GC locked. Once it's revealed, the object is on our stack, which keeps it. */
+    auto const o{ static_cast<object *>(
+      GC_call_with_alloc_lock(&reveal, const_cast<uptr *>(&hidden))) };
+    if(!o)
+    {
+      return none;
+    }
+    return object_ref{ o };
+  }
+
+  bool weak_ref::is_cleared() const
+  {
+    return get().is_none();
+  }
+}
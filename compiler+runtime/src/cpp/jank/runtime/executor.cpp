@@ -0,0 +1,442 @@
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#if defined(__linux__)
+  #include <pthread.h>
+  #include <sched.h>
+#endif
+
+#include <gc/gc.h>
+
+#include <jank/runtime/executor.hpp>
+#include <jank/runtime/metrics.hpp>
+#include <jank/util/fmt/print.hpp>
+
+namespace jank::runtime
+{
+  /* The pool a worker belongs to, along with its index in that pool. This is how
+   * submissions from within a worker find their way onto its own deque. */
+  static thread_local work_stealing_executor const *current_pool{};
+  static thread_local usize current_worker_index{};
+
+  static metrics::counter &find_counter(char const * const name, char const * const help)
+  {
+    return *metrics::find_or_create_counter(name, help).expect_ok();
+  }
+
+  /* Looked up once, since these are bumped for every task. */
+  static metrics::counter &submitted_tasks()
+  {
+    static auto &c{ find_counter("jank_executor_tasks_total",
+                                 "The tasks submitted to executors.") };
+    return c;
+  }
+
+  static metrics::counter &stolen_tasks()
+  {
+    static auto &c{ find_counter("jank_executor_steals_total",
+                                 "The tasks taken from another worker's deque.") };
+    return c;
+  }
+
+  static metrics::counter &spawned_threads()
+  {
+    static auto &c{ find_counter("jank_executor_threads_spawned_total",
+                                 "The threads started by the blocking executor.") };
+    return c;
+  }
+
+  static metrics::counter &remote_steals()
+  {
+    static auto &c{ find_counter("jank_executor_remote_steals_total",
+                                 "The tasks taken from a worker on another NUMA node.") };
+    return c;
+  }
+
+  /* Parses a sysfs list of cores, like 0-3,8-11. */
+  static native_vector<u32> parse_cpu_list(std::string const &list)
+  {
+    native_vector<u32> ret;
+    std::stringstream ss{ list };
+    std::string range;
+    while(std::getline(ss, range, ','))
+    {
+      auto const dash{ range.find('-') };
+      auto const first{ static_cast<u32>(std::stoul(range.substr(0, dash))) };
+      auto const last{ dash == std::string::npos
+                         ? first
+                         : static_cast<u32>(std::stoul(range.substr(dash + 1))) };
+      for(auto cpu{ first }; cpu <= last; ++cpu)
+      {
+        ret.emplace_back(cpu);
+      }
+    }
+    return ret;
+  }
+
+  /* The cores of each NUMA node, as Linux gives them in sysfs. Anywhere else, or if
+   * they can't be read, every core is on one node. */
+  static native_vector<native_vector<u32>> numa_nodes()
+  {
+    native_vector<native_vector<u32>> ret;
+    try
+    {
+      std::error_code ec;
+      for(auto const &entry :
+          std::filesystem::directory_iterator{ "/sys/devices/system/node", ec })
+      {
+        auto const name{ entry.path().filename().string() };
+        if(name.size() <= 4 || !name.starts_with("node") || !std::isdigit(name[4]))
+        {
+          continue;
+        }
+
+        std::ifstream file{ entry.path() / "cpulist" };
+        std::string list;
+        if(std::getline(file, list))
+        {
+          auto cpus{ parse_cpu_list(list) };
+          if(!cpus.empty())
+          {
+            ret.emplace_back(std::move(cpus));
+          }
+        }
+      }
+    }
+    catch(std::exception const &)
+    {
+      ret.clear();
+    }
+
+    if(ret.empty())
+    {
+      auto &cpus{ ret.emplace_back() };
+      auto const count{ std::max<u32>(1, std::thread::hardware_concurrency()) };
+      for(u32 i{}; i < count; ++i)
+      {
+        cpus.emplace_back(i);
+      }
+    }
+    return ret;
+  }
+
+  static void pin_thread(native_vector<u32> const &cpus)
+  {
+#if defined(__linux__)
+    if(cpus.empty())
+    {
+      return;
+    }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for(auto const cpu : cpus)
+    {
+      if(cpu < CPU_SETSIZE)
+      {
+        CPU_SET(cpu, &set);
+      }
+    }
+    /* A worker which can't be pinned still works, just on any core, so this isn't fatal. */
+    if(pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0)
+    {
+      util::println(stderr, "Unable to pin executor worker to its cores");
+    }
+#else
+    /* macOS has no way to pin a thread to a core. */
+    static_cast<void>(cpus);
+#endif
+  }
+
+  static void run_task(executor::task const &t)
+  {
+    try
+    {
+      t();
+    }
+    catch(std::exception const &e)
+    {
+      util::println(stderr, "Uncaught exception in executor task: {}", e.what());
+    }
+    catch(...)
+    {
+      util::println(stderr, "Uncaught exception in executor task");
+    }
+  }
+
+  gc_thread_scope::gc_thread_scope()
+  {
+    GC_stack_base sb{};
+    GC_get_stack_base(&sb);
+    GC_register_my_thread(&sb);
+  }
+
+  gc_thread_scope::~gc_thread_scope()
+  {
+    GC_unregister_my_thread();
+  }
+
+  bool executor::run_pending_task()
+  {
+    return false;
+  }
+
+  work_stealing_executor::work_stealing_executor(usize const thread_count)
+    : work_stealing_executor{ thread_count, util::cli::executor_affinity::none }
+  {
+  }
+
+  work_stealing_executor::work_stealing_executor(usize const thread_count,
+                                                 util::cli::executor_affinity const affinity)
+  {
+    using util::cli::executor_affinity;
+
+    /* This needs to happen on a thread the GC already knows about, before any
+     * other threads try to register themselves. */
+    GC_allow_register_threads();
+
+    auto const nodes{ affinity == executor_affinity::none ? native_vector<native_vector<u32>>{}
+                                                          : numa_nodes() };
+    workers.reserve(thread_count);
+    for(usize i{}; i < thread_count; ++i)
+    {
+      auto &w{ *workers.emplace_back(std::make_unique<worker>()) };
+      if(nodes.empty())
+      {
+        continue;
+      }
+
+      w.node = i % nodes.size();
+      auto const &cpus{ nodes[w.node] };
+      if(affinity == executor_affinity::core)
+      {
+        w.cpus.emplace_back(cpus[(i / nodes.size()) % cpus.size()]);
+      }
+      else
+      {
+        w.cpus = cpus;
+      }
+    }
+
+    /* Each worker goes around the ring of its peers from the one after it, same as
+     * without an affinity, but takes those on its node first. */
+    for(usize i{}; i < thread_count; ++i)
+    {
+      auto &w{ *workers[i] };
+      for(auto const same_node : { true, false })
+      {
+        for(usize j{ 1 }; j < thread_count; ++j)
+        {
+          auto const victim{ (i + j) % thread_count };
+          if((workers[victim]->node == w.node) == same_node)
+          {
+            w.victims.emplace_back(victim);
+          }
+        }
+      }
+      w.victims.emplace_back(i);
+    }
+
+    /* Workers can steal from each other as soon as they start, so they all need
+     * to exist before any of them is started. */
+    for(usize i{}; i < thread_count; ++i)
+    {
+      workers[i]->thread = std::thread{ [this, i] { run_worker(i); } };
+    }
+  }
+
+  work_stealing_executor::~work_stealing_executor()
+  {
+    {
+      std::lock_guard<std::mutex> const lock{ sleep_mutex };
+      stopping.store(true);
+    }
+    wake.notify_all();
+
+    for(auto const &w : workers)
+    {
+      if(w->thread.joinable())
+      {
+        w->thread.join();
+      }
+    }
+  }
+
+  void work_stealing_executor::submit(task &&t)
+  {
+    auto const index{ is_worker_thread() ? current_worker_index
+                                         : next_worker.fetch_add(1) % workers.size() };
+    {
+      auto &w{ *workers[index] };
+      std::lock_guard<std::mutex> const lock{ w.mutex };
+      w.tasks.emplace_back(std::move(t));
+    }
+    pending.fetch_add(1);
+    submitted_tasks().add(1);
+
+    /* Taking the lock, even briefly, ensures a worker which just saw no pending work
+     * is either already asleep, so it gets this notification, or hasn't yet checked. */
+    {
+      std::lock_guard<std::mutex> const lock{ sleep_mutex };
+    }
+    wake.notify_one();
+  }
+
+  bool work_stealing_executor::run_pending_task()
+  {
+    task t;
+    auto const index{ is_worker_thread() ? current_worker_index : 0 };
+    if((is_worker_thread() && try_pop(index, t)) || try_steal(index, t))
+    {
+      run_task(t);
+      return true;
+    }
+    return false;
+  }
+
+  usize work_stealing_executor::thread_count() const
+  {
+    return workers.size();
+  }
+
+  bool work_stealing_executor::is_worker_thread() const
+  {
+    return current_pool == this;
+  }
+
+  bool work_stealing_executor::try_pop(usize const index, task &out)
+  {
+    auto &w{ *workers[index] };
+    std::lock_guard<std::mutex> const lock{ w.mutex };
+    if(w.tasks.empty())
+    {
+      return false;
+    }
+
+    out = std::move(w.tasks.back());
+    w.tasks.pop_back();
+    pending.fetch_sub(1);
+    return true;
+  }
+
+  bool work_stealing_executor::try_steal(usize const thief_index, task &out)
+  {
+    auto const &thief{ *workers[thief_index] };
+    for(auto const victim : thief.victims)
+    {
+      auto &w{ *workers[victim] };
+      std::lock_guard<std::mutex> const lock{ w.mutex };
+      if(w.tasks.empty())
+      {
+        continue;
+      }
+
+      out = std::move(w.tasks.front());
+      w.tasks.pop_front();
+      pending.fetch_sub(1);
+      /* The last one looked at is the thief's own deque. */
+      if(victim != thief_index)
+      {
+        stolen_tasks().add(1);
+        if(w.node != thief.node)
+        {
+          remote_steals().add(1);
+        }
+      }
+      return true;
+    }
+    return false;
+  }
+
+  void work_stealing_executor::run_worker(usize const index)
+  {
+    /* This comes first, so that everything the worker allocates is on its own node. */
+    pin_thread(workers[index]->cpus);
+    gc_thread_scope const gc_scope;
+    current_pool = this;
+    current_worker_index = index;
+
+    while(true)
+    {
+      task t;
+      if(try_pop(index, t) || try_steal(index, t))
+      {
+        run_task(t);
+        continue;
+      }
+
+      std::unique_lock<std::mutex> lock{ sleep_mutex };
+      wake.wait(lock, [this] { return stopping.load() || pending.load() != 0; });
+      if(stopping.load() && pending.load() == 0)
+      {
+        break;
+      }
+    }
+  }
+
+  void blocking_executor::submit(task &&t)
+  {
+    std::lock_guard<std::mutex> const lock{ mutex };
+    tasks.emplace_back(std::move(t));
+    submitted_tasks().add(1);
+
+    /* Each idle thread can take one of the queued tasks. Anything beyond that
+     * needs a new thread. */
+    if(idle_threads < tasks.size())
+    {
+      GC_allow_register_threads();
+      spawned_threads().add(1);
+      std::thread{ [this] { run_thread(); } }.detach();
+    }
+    else
+    {
+      wake.notify_one();
+    }
+  }
+
+  void blocking_executor::run_thread()
+  {
+    static constexpr std::chrono::seconds idle_timeout{ 60 };
+
+    gc_thread_scope const gc_scope;
+    std::unique_lock<std::mutex> lock{ mutex };
+    while(true)
+    {
+      ++idle_threads;
+      auto const has_task{ wake.wait_for(lock, idle_timeout, [this] { return !tasks.empty(); }) };
+      --idle_threads;
+      if(!has_task)
+      {
+        return;
+      }
+
+      auto const t{ std::move(tasks.front()) };
+      tasks.pop_front();
+      lock.unlock();
+      run_task(t);
+      lock.lock();
+    }
+  }
+
+  work_stealing_executor &pooled_executor()
+  {
+    /* This is intentionally leaked. Tearing the pool down during static destruction
+     * would mean joining workers which may still be running jank code against a
+     * runtime which is itself being torn down. */
+    static auto * const pool{ new work_stealing_executor{
+      util::cli::opts.executor_threads != 0
+        ? util::cli::opts.executor_threads
+        : std::max<usize>(1, std::thread::hardware_concurrency()),
+      util::cli::opts.executor_affinity } };
+    return *pool;
+  }
+
+  blocking_executor &solo_executor()
+  {
+    static auto * const pool{ new blocking_executor{} };
+    return *pool;
+  }
+}
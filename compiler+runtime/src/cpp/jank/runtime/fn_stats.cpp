@@ -0,0 +1,98 @@
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include <jank/runtime/fn_stats.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
+#include <jank/runtime/obj/persistent_vector.hpp>
+
+namespace jank::runtime::fn_stats
+{
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+  static std::mutex blocks_mutex;
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+  static std::map<std::string, std::unique_ptr<block>, std::less<>> blocks;
+
+  block &find_or_create(jtl::immutable_string const &name)
+  {
+    std::string_view const key{ name.data(), name.size() };
+    std::lock_guard<std::mutex> const lock{ blocks_mutex };
+    auto const found{ blocks.find(key) };
+    if(found != blocks.end())
+    {
+      return *found->second;
+    }
+
+    auto b{ std::make_unique<block>() };
+    b->name = key;
+    auto &ret{ *b };
+    blocks.emplace(key, std::move(b));
+    return ret;
+  }
+
+  object_ref snapshot()
+  {
+    struct entry
+    {
+      block const *b{};
+      usize arity{};
+      u64 calls{};
+      u64 cycles{};
+    };
+
+    native_vector<entry> entries;
+    {
+      std::lock_guard<std::mutex> const lock{ blocks_mutex };
+      for(auto const &[_, b] : blocks)
+      {
+        for(usize i{}; i < max_arity; ++i)
+        {
+          auto const calls{ b->calls[i].load(std::memory_order_relaxed) };
+          if(calls != 0)
+          {
+            entries.push_back({ b.get(), i, calls, b->cycles[i].load(std::memory_order_relaxed) });
+          }
+        }
+      }
+    }
+    std::ranges::sort(entries, [](auto const &l, auto const &r) { return r.calls < l.calls; });
+
+    auto const kw(
+      [](char const * const name) { return __rt_ctx->intern_keyword(name).expect_ok(); });
+    auto const name_kw(kw("name")), arity_kw(kw("arity")), calls_kw(kw("calls")),
+      cycles_kw(kw("cycles"));
+    auto const timing(is_timing());
+
+    runtime::detail::native_transient_vector ret;
+    for(auto const &e : entries)
+    {
+      auto m(obj::persistent_hash_map::create_unique(
+        std::make_pair(name_kw,
+                       make_box(jtl::immutable_string{ e.b->name.data(), e.b->name.size() })),
+        std::make_pair(arity_kw, make_box(static_cast<i64>(e.arity))),
+        std::make_pair(calls_kw, make_box(static_cast<i64>(e.calls)))));
+      if(timing)
+      {
+        m = m->assoc(cycles_kw, make_box(static_cast<i64>(e.cycles)));
+      }
+      ret.push_back(m);
+    }
+    return make_box<obj::persistent_vector>(ret.persistent());
+  }
+
+  void reset()
+  {
+    std::lock_guard<std::mutex> const lock{ blocks_mutex };
+    for(auto const &[_, b] : blocks)
+    {
+      for(usize i{}; i < max_arity; ++i)
+      {
+        b->calls[i].store(0, std::memory_order_relaxed);
+        b->cycles[i].store(0, std::memory_order_relaxed);
+      }
+    }
+  }
+}
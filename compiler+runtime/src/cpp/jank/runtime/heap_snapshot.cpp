@@ -0,0 +1,469 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+#include <jank/runtime/heap_snapshot.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/visit.hpp>
+#include <jank/runtime/sequence_range.hpp>
+#include <jank/runtime/core/seq.hpp>
+#include <jank/runtime/core/to_string.hpp>
+#include <jank/util/fmt/print.hpp>
+
+namespace jank::runtime::heap_snapshot
+{
+  /* The file is the magic, the version, and the node count, followed by each node, and then
+   * the retainers. Nodes are in reverse post order, starting with a root which isn't a real
+   * object, so each node's dominator always comes before it. Everything is in the native
+   * byte order, since snapshots are meant to be read on the machine that wrote them.
+   *
+   *   node:     u8 type, u64 shallow size, u32 dominator
+   *   retainer: u32 node, u32 name size, name bytes */
+  static constexpr char magic[8]{ 'j', 'a', 'n', 'k', 'h', 'e', 'a', 'p' };
+  static constexpr u32 version{ 1 };
+  /* The type of the root. */
+  static constexpr u8 root_type{ 0xff };
+
+  struct node
+  {
+    u8 type{};
+    u64 size{};
+    u32 dominator{};
+  };
+
+  struct named_node
+  {
+    u32 index{};
+    jtl::immutable_string name;
+  };
+
+  template <typename T>
+  static void write_raw(std::ofstream &out, T const &t)
+  {
+    out.write(reinterpret_cast<char const *>(&t), sizeof(T));
+  }
+
+  template <typename T>
+  static bool read_raw(std::ifstream &in, T &t)
+  {
+    return static_cast<bool>(in.read(reinterpret_cast<char *>(&t), sizeof(T)));
+  }
+
+  static usize shallow_size(object_ref const o)
+  {
+    return visit_object(
+      [](auto const typed_o) -> usize {
+        using T = typename jtl::decay_t<decltype(typed_o)>::value_type;
+        usize size{ sizeof(T) };
+
+        if constexpr(T::obj_type == object_type::persistent_string)
+        {
+          /* Small strings are stored inline. */
+          if(typed_o->data.size() > sizeof(jtl::immutable_string))
+          {
+            size += typed_o->data.size() + 1;
+          }
+        }
+        else if constexpr(T::obj_type == object_type::persistent_vector
+                          || T::obj_type == object_type::persistent_list
+                          || T::obj_type == object_type::persistent_hash_set
+                          || T::obj_type == object_type::persistent_sorted_set)
+        {
+          size += typed_o->count() * sizeof(object *);
+        }
+        else if constexpr(T::obj_type == object_type::persistent_array_map
+                          || T::obj_type == object_type::persistent_hash_map
+                          || T::obj_type == object_type::persistent_sorted_map
+                          || T::obj_type == object_type::persistent_int_map)
+        {
+          size += typed_o->count() * 2 * sizeof(object *);
+        }
+
+        return size;
+      },
+      o);
+  }
+
+  /* Calls the function with each object this one points to, as far as we can see. */
+  template <typename F>
+  static void for_each_child(object_ref const o, F const &f)
+  {
+    visit_object(
+      [&](auto const typed_o) {
+        using T = typename jtl::decay_t<decltype(typed_o)>::value_type;
+
+        if constexpr(requires { typed_o->meta.is_some(); })
+        {
+          if(typed_o->meta.is_some())
+          {
+            f(typed_o->meta.unwrap());
+          }
+        }
+
+        if constexpr(T::obj_type == object_type::persistent_vector
+                     || T::obj_type == object_type::persistent_list
+                     || T::obj_type == object_type::persistent_hash_set
+                     || T::obj_type == object_type::persistent_sorted_set)
+        {
+          for(auto const e : make_sequence_range(typed_o))
+          {
+            f(e);
+          }
+        }
+        else if constexpr(T::obj_type == object_type::persistent_array_map
+                          || T::obj_type == object_type::persistent_hash_map
+                          || T::obj_type == object_type::persistent_sorted_map
+                          || T::obj_type == object_type::persistent_int_map
+                          || T::obj_type == object_type::persistent_struct_map)
+        {
+          /* The entries are made as we go, so we skip them and take their keys and values. */
+          for(auto const e : make_sequence_range(typed_o))
+          {
+            f(first(e));
+            f(second(e));
+          }
+        }
+        else if constexpr(T::obj_type == object_type::cons)
+        {
+          f(typed_o->head);
+          f(typed_o->tail);
+        }
+        else if constexpr(T::obj_type == object_type::keyword)
+        {
+          f(typed_o->sym);
+        }
+        else if constexpr(T::obj_type == object_type::var)
+        {
+          f(typed_o->get_root());
+        }
+        else if constexpr(T::obj_type == object_type::atom)
+        {
+          f(typed_o->deref());
+        }
+        else if constexpr(T::obj_type == object_type::volatile_
+                          || T::obj_type == object_type::reduced)
+        {
+          f(typed_o->val);
+        }
+        else if constexpr(T::obj_type == object_type::tagged_literal)
+        {
+          f(typed_o->tag);
+          f(typed_o->form);
+        }
+        else if constexpr(T::obj_type == object_type::ns)
+        {
+          f(*typed_o->vars.rlock());
+        }
+      },
+      o);
+  }
+
+  struct graph
+  {
+    /* Discovery order. The root is 0, with no object. */
+    native_vector<object *> objects;
+    native_vector<node> nodes;
+    /* The successors of node i are succ[succ_start[i]] through succ[succ_start[i + 1]]. */
+    native_vector<u32> succ_start;
+    native_vector<u32> succ;
+    native_vector<named_node> named;
+  };
+
+  static graph discover()
+  {
+    graph g;
+    native_unordered_map<object *, u32> indices;
+
+    auto const index_of([&](object_ref const o) -> u32 {
+      auto const found(indices.find(o.data));
+      if(found != indices.end())
+      {
+        return found->second;
+      }
+      auto const index{ static_cast<u32>(g.objects.size()) };
+      indices.emplace(o.data, index);
+      g.objects.emplace_back(o.data);
+      g.nodes.push_back({ static_cast<u8>(o->type), shallow_size(o), 0 });
+      if(o->type == object_type::ns || o->type == object_type::var)
+      {
+        g.named.push_back({ index, runtime::to_string(o) });
+      }
+      return index;
+    });
+
+    g.objects.emplace_back(nullptr);
+    g.nodes.push_back({ root_type, 0, 0 });
+    g.succ_start.emplace_back(0);
+    __rt_ctx->namespaces.for_each([&](ns_ref const n) { g.succ.emplace_back(index_of(n)); });
+    g.succ_start.emplace_back(static_cast<u32>(g.succ.size()));
+
+    /* Each node is expanded once, in the order it was found, which builds up the
+     * successors in order. */
+    for(usize i{ 1 }; i < g.objects.size(); ++i)
+    {
+      for_each_child(g.objects[i], [&](object_ref const child) {
+        g.succ.emplace_back(index_of(child));
+      });
+      g.succ_start.emplace_back(static_cast<u32>(g.succ.size()));
+    }
+
+    return g;
+  }
+
+  /* Finds the immediate dominators, in reverse post order, using the iterative algorithm
+   * from "A Simple, Fast Dominance Algorithm" by Cooper, Harvey, and Kennedy. */
+  static void compute_dominators(graph &g)
+  {
+    auto const count{ g.nodes.size() };
+
+    /* Post order numbers, from an iterative DFS. */
+    static constexpr u32 unvisited{ std::numeric_limits<u32>::max() };
+    native_vector<u32> post(count, unvisited);
+    native_vector<u32> by_post;
+    by_post.reserve(count);
+    {
+      native_vector<bool> seen(count, false);
+      native_vector<std::pair<u32, u32>> stack{ { 0, g.succ_start[0] } };
+      seen[0] = true;
+      while(!stack.empty())
+      {
+        auto &[n, next]{ stack.back() };
+        if(next < g.succ_start[n + 1])
+        {
+          auto const s{ g.succ[next++] };
+          if(!seen[s])
+          {
+            seen[s] = true;
+            stack.emplace_back(s, g.succ_start[s]);
+          }
+          continue;
+        }
+        post[n] = static_cast<u32>(by_post.size());
+        by_post.emplace_back(n);
+        stack.pop_back();
+      }
+    }
+
+    native_vector<native_vector<u32>> preds(count);
+    for(u32 n{}; n < count; ++n)
+    {
+      for(auto i{ g.succ_start[n] }; i < g.succ_start[n + 1]; ++i)
+      {
+        preds[g.succ[i]].emplace_back(n);
+      }
+    }
+
+    /* Dominators are tracked by post order number, which makes the intersection a walk up
+     * towards the root, which has the highest number. */
+    native_vector<u32> idom(count, unvisited);
+    idom[post[0]] = post[0];
+    auto const intersect([&](u32 a, u32 b) {
+      while(a != b)
+      {
+        while(a < b)
+        {
+          a = idom[a];
+        }
+        while(b < a)
+        {
+          b = idom[b];
+        }
+      }
+      return a;
+    });
+
+    for(bool changed{ true }; changed;)
+    {
+      changed = false;
+      for(auto it{ by_post.rbegin() + 1 }; it != by_post.rend(); ++it)
+      {
+        auto new_idom{ unvisited };
+        for(auto const p : preds[*it])
+        {
+          if(idom[post[p]] == unvisited)
+          {
+            continue;
+          }
+          new_idom = (new_idom == unvisited ? post[p] : intersect(post[p], new_idom));
+        }
+        if(idom[post[*it]] != new_idom)
+        {
+          idom[post[*it]] = new_idom;
+          changed = true;
+        }
+      }
+    }
+
+    /* Renumber everything into reverse post order. */
+    auto const rpo(
+      [&](u32 const post_number) { return static_cast<u32>(count - 1 - post_number); });
+    native_vector<node> nodes(count);
+    for(u32 n{}; n < count; ++n)
+    {
+      auto &out(nodes[rpo(post[n])]);
+      out = g.nodes[n];
+      out.dominator = rpo(idom[post[n]]);
+    }
+    g.nodes = jtl::move(nodes);
+    for(auto &named : g.named)
+    {
+      named.index = rpo(post[named.index]);
+    }
+  }
+
+  static summary summarize(native_vector<node> const &nodes,
+                           native_vector<named_node> const &named)
+  {
+    summary ret;
+
+    native_vector<type_stats> types(object_type_count);
+    for(usize i{}; i < types.size(); ++i)
+    {
+      types[i].type = static_cast<object_type>(i);
+    }
+
+    /* Children always come after their dominators, so going backward adds each retained
+     * size to its dominator after it's complete. */
+    native_vector<usize> retained_bytes(nodes.size()), retained_count(nodes.size());
+    for(auto i{ nodes.size() }; i-- > 1;)
+    {
+      auto const &n(nodes[i]);
+      retained_bytes[i] += n.size;
+      retained_count[i] += 1;
+      retained_bytes[n.dominator] += retained_bytes[i];
+      retained_count[n.dominator] += retained_count[i];
+
+      if(n.type < object_type_count)
+      {
+        ++types[n.type].count;
+        types[n.type].bytes += n.size;
+      }
+      ++ret.count;
+      ret.bytes += n.size;
+    }
+
+    std::erase_if(types, [](auto const &t) { return t.count == 0; });
+    std::ranges::sort(types, [](auto const &l, auto const &r) { return l.bytes > r.bytes; });
+    ret.types = jtl::move(types);
+
+    for(auto const &n : named)
+    {
+      ret.retainers.push_back({ n.name, retained_bytes[n.index], retained_count[n.index] });
+    }
+    std::ranges::sort(ret.retainers, [](auto const &l, auto const &r) {
+      return l.retained_bytes > r.retained_bytes;
+    });
+
+    return ret;
+  }
+
+  jtl::result<summary, jtl::immutable_string> write(jtl::immutable_string const &path)
+  {
+    auto g(discover());
+    compute_dominators(g);
+
+    std::ofstream out{ path.c_str(), std::ios::binary | std::ios::trunc };
+    if(!out)
+    {
+      return err(util::format("Unable to open heap snapshot '{}' for writing.", path));
+    }
+
+    out.write(magic, sizeof(magic));
+    write_raw(out, version);
+    write_raw(out, static_cast<u64>(g.nodes.size()));
+    for(auto const &n : g.nodes)
+    {
+      write_raw(out, n.type);
+      write_raw(out, n.size);
+      write_raw(out, n.dominator);
+    }
+    write_raw(out, static_cast<u32>(g.named.size()));
+    for(auto const &n : g.named)
+    {
+      write_raw(out, n.index);
+      write_raw(out, static_cast<u32>(n.name.size()));
+      out.write(n.name.data(), static_cast<std::streamsize>(n.name.size()));
+    }
+
+    if(!out)
+    {
+      return err(util::format("Unable to write heap snapshot '{}'.", path));
+    }
+    return summarize(g.nodes, g.named);
+  }
+
+  jtl::result<summary, jtl::immutable_string> read(jtl::immutable_string const &path)
+  {
+    std::ifstream in{ path.c_str(), std::ios::binary };
+    if(!in)
+    {
+      return err(util::format("Unable to open heap snapshot '{}'.", path));
+    }
+
+    auto const invalid([&] { return err(util::format("Invalid heap snapshot '{}'.", path)); });
+
+    char file_magic[sizeof(magic)]{};
+    u32 file_version{};
+    u64 count{};
+    if(!in.read(file_magic, sizeof(file_magic))
+       || std::memcmp(file_magic, magic, sizeof(magic)) != 0 || !read_raw(in, file_version)
+       || file_version != version || !read_raw(in, count) || count == 0)
+    {
+      return invalid();
+    }
+
+    native_vector<node> nodes(count);
+    for(usize i{}; i < count; ++i)
+    {
+      auto &n(nodes[i]);
+      if(!read_raw(in, n.type) || !read_raw(in, n.size) || !read_raw(in, n.dominator)
+         || (i != 0 && i <= n.dominator))
+      {
+        return invalid();
+      }
+    }
+
+    u32 named_count{};
+    if(!read_raw(in, named_count))
+    {
+      return invalid();
+    }
+    native_vector<named_node> named(named_count);
+    for(auto &n : named)
+    {
+      u32 size{};
+      if(!read_raw(in, n.index) || n.index >= count || !read_raw(in, size))
+      {
+        return invalid();
+      }
+      native_transient_string name(size, '\0');
+      if(!in.read(name.data(), size))
+      {
+        return invalid();
+      }
+      n.name = jtl::immutable_string{ name.data(), name.size() };
+    }
+
+    return summarize(nodes, named);
+  }
+
+  void print(summary const &s, usize const top)
+  {
+    util::println("{} objects, {} bytes", s.count, s.bytes);
+
+    util::println("\nBy type:");
+    for(usize i{}; i < std::min(top, s.types.size()); ++i)
+    {
+      auto const &t(s.types[i]);
+      util::println("  {} bytes  {} objects  {}", t.bytes, t.count, object_type_str(t.type));
+    }
+
+    util::println("\nBy retained size:");
+    for(usize i{}; i < std::min(top, s.retainers.size()); ++i)
+    {
+      auto const &r(s.retainers[i]);
+      util::println("  {} bytes  {} objects  {}", r.retained_bytes, r.retained_count, r.name);
+    }
+  }
+}
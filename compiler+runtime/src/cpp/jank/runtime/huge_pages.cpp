@@ -0,0 +1,175 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstring>
+
+#include <gc/gc.h>
+
+#include <jank/type.hpp>
+#include <jank/runtime/huge_pages.hpp>
+
+namespace jank::runtime
+{
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  static constexpr uintptr_t huge_page_size{ 2 * 1024 * 1024 };
+
+  struct address_range
+  {
+    uintptr_t start{};
+    uintptr_t end{};
+  };
+
+  /* Enough for a heap which has grown in many places. Past this, the rest of the heap
+   * just isn't advised until the next time it grows. */
+  static constexpr usize max_heap_ranges{ 256 };
+
+  static uintptr_t parse_hex(char const *&p)
+  {
+    uintptr_t ret{};
+    while(true)
+    {
+      auto const c{ *p };
+      if(c >= '0' && c <= '9')
+      {
+        ret = (ret << 4) | static_cast<uintptr_t>(c - '0');
+      }
+      else if(c >= 'a' && c <= 'f')
+      {
+        ret = (ret << 4) | static_cast<uintptr_t>(c - 'a' + 10);
+      }
+      else
+      {
+        return ret;
+      }
+      ++p;
+    }
+  }
+
+  static void skip_field(char const *&p)
+  {
+    while(*p != '\0' && *p != ' ')
+    {
+      ++p;
+    }
+    while(*p == ' ')
+    {
+      ++p;
+    }
+  }
+
+  /* Each line is `start-end perms offset dev inode path`. The heap is private, writable,
+   * and anonymous, which means an inode of 0 and no path. */
+  static void add_heap_ranges(char const *line,
+                              std::array<address_range, max_heap_ranges> &ranges,
+                              usize &range_count)
+  {
+    auto const start{ parse_hex(line) };
+    if(*line++ != '-')
+    {
+      return;
+    }
+    auto const end{ parse_hex(line) };
+    if(std::strncmp(line, " rw-p ", 6) != 0)
+    {
+      return;
+    }
+    line += 6;
+    /* The offset and the device. */
+    skip_field(line);
+    skip_field(line);
+    if(std::strncmp(line, "0 ", 2) != 0 && std::strcmp(line, "0") != 0)
+    {
+      return;
+    }
+    skip_field(line);
+    if(*line != '\0')
+    {
+      return;
+    }
+
+    /* The GC only answers for its own blocks, so each huge page is checked separately,
+     * since a mapping can also cover memory next to the heap. */
+    for(auto page{ (start + huge_page_size - 1) & ~(huge_page_size - 1) };
+        page + huge_page_size <= end;
+        page += huge_page_size)
+    {
+      if(!GC_is_heap_ptr(reinterpret_cast<void *>(page)))
+      {
+        continue;
+      }
+      if(range_count != 0 && ranges[range_count - 1].end == page)
+      {
+        ranges[range_count - 1].end = page + huge_page_size;
+      }
+      else if(range_count < ranges.size())
+      {
+        ranges[range_count++] = { page, page + huge_page_size };
+      }
+    }
+  }
+
+  /* This is called by the GC while it holds its lock, so it mustn't allocate, since that
+   * would need the lock again. Everything is read into fixed buffers with plain syscalls.
+   * The mappings are all read before any are advised, since advising can split them. */
+  static void advise_heap()
+  {
+    auto const fd{ open("/proc/self/maps", O_RDONLY | O_CLOEXEC) };
+    if(fd < 0)
+    {
+      return;
+    }
+
+    std::array<address_range, max_heap_ranges> ranges{};
+    usize range_count{};
+    std::array<char, 4096> buffer{};
+    std::array<char, 512> line{};
+    usize line_size{};
+    ssize_t n{};
+    while((n = read(fd, buffer.data(), buffer.size())) > 0)
+    {
+      for(ssize_t i{}; i < n; ++i)
+      {
+        if(buffer[i] != '\n')
+        {
+          /* Long lines are always for named mappings, which we skip anyway. */
+          if(line_size + 1 < line.size())
+          {
+            line[line_size++] = buffer[i];
+          }
+          continue;
+        }
+        line[line_size] = '\0';
+        add_heap_ranges(line.data(), ranges, range_count);
+        line_size = 0;
+      }
+    }
+    close(fd);
+
+    for(usize i{}; i < range_count; ++i)
+    {
+      madvise(reinterpret_cast<void *>(ranges[i].start),
+              ranges[i].end - ranges[i].start,
+              MADV_HUGEPAGE);
+    }
+  }
+
+  static void GC_CALLBACK on_heap_resize(GC_word const)
+  {
+    advise_heap();
+  }
+
+  bool enable_gc_huge_pages()
+  {
+    GC_set_on_heap_resize(&on_heap_resize);
+    advise_heap();
+    return true;
+  }
+#else
+  bool enable_gc_huge_pages()
+  {
+    return false;
+  }
+#endif
+}
@@ -0,0 +1,330 @@
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#include <jank/runtime/io.hpp>
+#include <jank/error/runtime.hpp>
+#include <jank/error/system.hpp>
+#include <jank/profile/time.hpp>
+#include <jank/util/fmt.hpp>
+#include <jank/util/scope_exit.hpp>
+
+namespace jank::runtime::io
+{
+  static jtl::result<usize, error_ref> read_some(int const fd, char * const out, usize const size)
+  {
+    while(true)
+    {
+      auto const read_size{ ::read(fd, out, size) };
+      if(read_size >= 0)
+      {
+        return ok(static_cast<usize>(read_size));
+      }
+      else if(errno != EINTR)
+      {
+        return error::system_failure(
+          util::format("Unable to read from the file: {}", std::strerror(errno)));
+      }
+    }
+  }
+
+  static jtl::result<void, error_ref> write_all(int const fd, char const *data, usize size)
+  {
+    while(size != 0)
+    {
+      auto const written{ ::write(fd, data, size) };
+      if(written < 0 && errno == EINTR)
+      {
+        continue;
+      }
+      else if(written < 0)
+      {
+        return error::system_failure(
+          util::format("Unable to write to the file: {}", std::strerror(errno)));
+      }
+      data += written;
+      size -= static_cast<usize>(written);
+    }
+    return ok();
+  }
+
+  jtl::result<int, error_ref> open_file(jtl::immutable_string const &path, int const flags)
+  {
+    /* NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) */
+    auto const fd(::open(path.c_str(), flags | O_CLOEXEC, 0666));
+    if(fd < 0)
+    {
+      return error::runtime_unable_to_open_file(
+        util::format("Unable to open '{}': {}", path, std::strerror(errno)));
+    }
+    return ok(fd);
+  }
+
+  /* Each thread reads into one buffer, which it keeps, rather than allocating a new one
+   * for every file. Lots of small files, read from many threads at once, is the case this
+   * is for. Mapping such files would cost more than reading them, since each unmap has to
+   * flush the TLBs of every core running the process. This isn't GC memory, so it's fine
+   * for it to be thread local. */
+  static std::vector<char> &read_buffer()
+  {
+    static thread_local std::vector<char> buffer;
+    return buffer;
+  }
+
+  /* Reads until the end of the fd, into the thread's buffer, starting with room for at
+   * least the given size. */
+  static jtl::result<jtl::immutable_string, error_ref> read_all(int const fd, usize const size)
+  {
+    auto &buffer{ read_buffer() };
+    /* The extra byte is there to see the end without growing, when the size is right. */
+    if(buffer.size() < size + 1)
+    {
+      buffer.resize(size + 1);
+    }
+
+    usize used{};
+    while(true)
+    {
+      if(used == buffer.size())
+      {
+        buffer.resize(buffer.size() * 2);
+      }
+
+      auto const read_size(read_some(fd, buffer.data() + used, buffer.size() - used));
+      if(read_size.is_err())
+      {
+        return read_size.expect_err();
+      }
+      else if(read_size.expect_ok() == 0)
+      {
+        jtl::immutable_string ret{ buffer.data(), used };
+        /* A huge file shouldn't keep its buffer around for the rest of the thread. */
+        if(buffer.size() > small_file_size * 16)
+        {
+          std::vector<char>{}.swap(buffer);
+        }
+        return ok(ret);
+      }
+      used += read_size.expect_ok();
+    }
+  }
+
+  jtl::result<jtl::immutable_string, error_ref> slurp(jtl::immutable_string const &path)
+  {
+    profile::timer const timer{ "io slurp" };
+
+    auto const opened(open_file(path, O_RDONLY));
+    if(opened.is_err())
+    {
+      return opened.expect_err();
+    }
+    auto const fd(opened.expect_ok());
+    util::scope_exit const finally{ [&] { ::close(fd); } };
+
+    /* Files in /proc and the like say they're regular, but have no size, so they're read
+     * like a pipe. */
+    struct stat st{};
+    if(fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+    {
+      auto const size{ static_cast<usize>(st.st_size) };
+      if(size <= small_file_size)
+      {
+        return read_all(fd, size);
+      }
+
+      auto const head(mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0));
+
+      /* MAP_FAILED is a macro which does a C-style cast. */
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wold-style-cast"
+      /* NOLINTNEXTLINE(cppcoreguidelines-pro-type-cstyle-cast,performance-no-int-to-ptr) */
+      if(head != MAP_FAILED)
+#pragma clang diagnostic pop
+      {
+        madvise(head, size, MADV_SEQUENTIAL);
+        jtl::immutable_string ret{ static_cast<char const *>(head), size };
+        munmap(head, size);
+        return ok(ret);
+      }
+    }
+
+    return read_all(fd, default_buffer_size);
+  }
+
+  jtl::result<void, error_ref>
+  spit(jtl::immutable_string const &path, jtl::immutable_string_view const &content, bool append)
+  {
+    profile::timer const timer{ "io spit" };
+
+    auto const opened(open_file(path, O_WRONLY | O_CREAT | (append ? O_APPEND : O_TRUNC)));
+    if(opened.is_err())
+    {
+      return opened.expect_err();
+    }
+    auto const fd(opened.expect_ok());
+    util::scope_exit const finally{ [&] { ::close(fd); } };
+
+    return write_all(fd, content.data(), content.size());
+  }
+
+  buffered_reader::buffered_reader(int const fd, bool const owns_fd, usize const buffer_size)
+    : fd{ fd }
+    , owns_fd{ owns_fd }
+    , buffer(std::max<usize>(buffer_size, 1))
+  {
+  }
+
+  buffered_reader::~buffered_reader()
+  {
+    close();
+  }
+
+  void buffered_reader::close()
+  {
+    if(owns_fd && fd >= 0)
+    {
+      ::close(fd);
+    }
+    fd = -1;
+    at_eof = true;
+  }
+
+  jtl::result<void, error_ref> buffered_reader::refill()
+  {
+    if(head != 0)
+    {
+      std::memmove(buffer.data(), buffer.data() + head, tail - head);
+      tail -= head;
+      head = 0;
+    }
+    if(tail == buffer.size())
+    {
+      buffer.resize(buffer.size() * 2);
+    }
+
+    auto const read_size(read_some(fd, buffer.data() + tail, buffer.size() - tail));
+    if(read_size.is_err())
+    {
+      return read_size.expect_err();
+    }
+    tail += read_size.expect_ok();
+    at_eof = read_size.expect_ok() == 0;
+    return ok();
+  }
+
+  jtl::result<jtl::option<jtl::immutable_string>, error_ref> buffered_reader::read_line()
+  {
+    /* How much of what we have, past the head, we already know has no line break. This
+     * saves us from scanning it again after each refill. */
+    usize scanned{};
+    while(true)
+    {
+      auto const start{ buffer.data() + head };
+      auto const found{ static_cast<char const *>(
+        std::memchr(start + scanned, '\n', tail - head - scanned)) };
+      if(found != nullptr)
+      {
+        auto const next_head{ head + static_cast<usize>(found - start) + 1 };
+        auto size{ static_cast<usize>(found - start) };
+        if(size != 0 && start[size - 1] == '\r')
+        {
+          --size;
+        }
+        head = next_head;
+        return ok(some(jtl::immutable_string{ start, size }));
+      }
+      else if(at_eof)
+      {
+        if(head == tail)
+        {
+          return ok(none);
+        }
+        jtl::immutable_string ret{ start, tail - head };
+        head = tail;
+        return ok(some(ret));
+      }
+
+      scanned = tail - head;
+      auto const refilled(refill());
+      if(refilled.is_err())
+      {
+        return refilled.expect_err();
+      }
+    }
+  }
+
+  buffered_writer::buffered_writer(int const fd, bool const owns_fd, usize const buffer_size)
+    : fd{ fd }
+    , owns_fd{ owns_fd }
+    , capacity{ buffer_size }
+  {
+    buffer.reserve(capacity);
+  }
+
+  buffered_writer::~buffered_writer()
+  {
+    close();
+  }
+
+  jtl::result<void, error_ref> buffered_writer::write(jtl::immutable_string_view const &s)
+  {
+    if(fd < 0)
+    {
+      return error::system_failure("Unable to write to a closed writer.");
+    }
+
+    if(buffer.size() + s.size() > capacity)
+    {
+      auto const flushed(flush());
+      if(flushed.is_err())
+      {
+        return flushed.expect_err();
+      }
+    }
+
+    if(s.size() >= capacity)
+    {
+      return write_all(fd, s.data(), s.size());
+    }
+    buffer.insert(buffer.end(), s.begin(), s.end());
+    return ok();
+  }
+
+  jtl::result<void, error_ref> buffered_writer::flush()
+  {
+    if(buffer.empty())
+    {
+      return ok();
+    }
+    else if(fd < 0)
+    {
+      return error::system_failure("Unable to flush a closed writer.");
+    }
+
+    auto const written(write_all(fd, buffer.data(), buffer.size()));
+    buffer.clear();
+    return written;
+  }
+
+  jtl::result<void, error_ref> buffered_writer::close()
+  {
+    if(fd < 0)
+    {
+      return ok();
+    }
+
+    auto const flushed(flush());
+    if(owns_fd)
+    {
+      ::close(fd);
+    }
+    fd = -1;
+    return flushed;
+  }
+}
@@ -0,0 +1,95 @@
+#include <jank/runtime/isolate.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/obj/atom.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
+#include <jank/runtime/obj/symbol.hpp>
+#include <jank/runtime/behavior/callable.hpp>
+#include <jank/util/fmt.hpp>
+
+namespace jank::runtime
+{
+  /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+  static thread_local isolate *current_isolate{};
+  static std::atomic<u64> next_isolate_id{};
+
+  /* The shared namespaces count from 0, so this leaves each isolate room for far more
+   * generated names than it'll ever use. */
+  static constexpr u64 symbol_counter_shift{ 40 };
+
+  isolate::isolate()
+    : id{ ++next_isolate_id }
+  {
+    auto const user(intern_ns(make_box<obj::symbol>("user")));
+    auto const loaded_libs(
+      try_object<obj::atom>(__rt_ctx->loaded_libs_var->get_root())->deref());
+    bindings = obj::persistent_hash_map::create_unique(
+      std::make_pair(__rt_ctx->current_ns_var, user.erase()),
+      std::make_pair(__rt_ctx->loaded_libs_var, make_box<obj::atom>(loaded_libs).erase()));
+  }
+
+  isolate *isolate::current()
+  {
+    return current_isolate;
+  }
+
+  void isolate::enter()
+  {
+    if(current_isolate)
+    {
+      throw std::runtime_error{ "this thread is already within an isolate" };
+    }
+    if(entered.exchange(true))
+    {
+      throw std::runtime_error{ "isolate is already entered by another thread" };
+    }
+
+    current_isolate = this;
+    binding_depth = context::thread_binding_frames.size();
+    __rt_ctx->push_thread_bindings(bindings).expect_ok();
+
+    if(!referred_core)
+    {
+      referred_core = true;
+      dynamic_call(__rt_ctx->intern_var("clojure.core", "refer").expect_ok()->deref(),
+                   make_box<obj::symbol>("clojure.core"));
+    }
+  }
+
+  void isolate::exit()
+  {
+    if(current_isolate != this)
+    {
+      throw std::runtime_error{ "this thread is not within the isolate" };
+    }
+
+    bindings = obj::persistent_hash_map::create_unique(
+      std::make_pair(__rt_ctx->current_ns_var, __rt_ctx->current_ns_var->deref()),
+      std::make_pair(__rt_ctx->loaded_libs_var, __rt_ctx->loaded_libs_var->deref()));
+    while(context::thread_binding_frames.size() > binding_depth)
+    {
+      __rt_ctx->pop_thread_bindings().expect_ok();
+    }
+
+    current_isolate = nullptr;
+    entered.store(false);
+  }
+
+  ns_ref isolate::find_ns(jtl::immutable_string_view const &name) const
+  {
+    return namespaces.find("", name);
+  }
+
+  ns_ref isolate::intern_ns(obj::symbol_ref const sym)
+  {
+    return namespaces.intern(sym->ns, sym->name, [&] {
+      auto const ret(make_box<ns>(sym));
+      ret->symbol_counter.store(id << symbol_counter_shift);
+      return ret;
+    });
+  }
+
+  ns_ref isolate::remove_ns(obj::symbol_ref const sym)
+  {
+    return namespaces.remove(sym->ns, sym->name);
+  }
+}
@@ -0,0 +1,377 @@
+#include <unistd.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+#include <jank/read/lex.hpp>
+#include <jank/read/parse.hpp>
+#include <jank/runtime/macroexpand_cache.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/visit.hpp>
+#include <jank/runtime/core.hpp>
+#include <jank/runtime/core/meta.hpp>
+#include <jank/runtime/sequence_range.hpp>
+#include <jank/profile/time.hpp>
+
+namespace jank::runtime
+{
+  /* Forms read back from the cache get source meta pointing here, which we then remove,
+   * so they only have the meta they were written with. */
+  static constexpr auto cache_file_marker{ "jank/macroexpand-cache" };
+
+  /* Prints a form such that reading it gives back the same data with the same meta. This
+   * is false if there's anything in it which the reader would give back as another type. */
+  static bool print_form(object_ref const o, jtl::string_builder &sb)
+  {
+    auto const m(meta(o));
+    if(m != jank_nil() && !is_empty(m))
+    {
+      sb('^');
+      if(!print_form(m, sb))
+      {
+        return false;
+      }
+      sb(' ');
+    }
+
+    auto const print_all([&](object_ref const coll) {
+      auto first_form{ true };
+      for(auto const e : make_sequence_range(coll))
+      {
+        if(!first_form)
+        {
+          sb(' ');
+        }
+        first_form = false;
+        if(!print_form(e, sb))
+        {
+          return false;
+        }
+      }
+      return true;
+    });
+
+    switch(o->type)
+    {
+      case object_type::persistent_array_map:
+      case object_type::persistent_hash_map:
+        {
+          sb('{');
+          auto first_entry{ true };
+          for(auto const e : make_sequence_range(o))
+          {
+            if(!first_entry)
+            {
+              sb(' ');
+            }
+            first_entry = false;
+            if(!print_form(first(e), sb))
+            {
+              return false;
+            }
+            sb(' ');
+            if(!print_form(second(e), sb))
+            {
+              return false;
+            }
+          }
+          sb('}');
+          return true;
+        }
+      case object_type::persistent_vector:
+        {
+          sb('[');
+          auto const ret(print_all(o));
+          sb(']');
+          return ret;
+        }
+      case object_type::persistent_hash_set:
+        {
+          sb("#{");
+          auto const ret(print_all(o));
+          sb('}');
+          return ret;
+        }
+      default:
+        if(is_map(o) || is_vector(o) || is_set(o))
+        {
+          return false;
+        }
+        else if(is_seq(o))
+        {
+          sb('(');
+          auto const ret(print_all(o));
+          sb(')');
+          return ret;
+        }
+        sb(to_code_string(o));
+        return true;
+    }
+  }
+
+  static void strip_cache_source(object_ref const o)
+  {
+    visit_object(
+      [](auto const typed_o) {
+        using T = typename jtl::decay_t<decltype(typed_o)>::value_type;
+
+        if constexpr(behavior::metadatable<T>)
+        {
+          if(typed_o->meta.is_none())
+          {
+            return;
+          }
+
+          auto const source(
+            get(typed_o->meta.unwrap(), __rt_ctx->intern_keyword("jank/source").expect_ok()));
+          auto const file(get(source, __rt_ctx->intern_keyword("file").expect_ok()));
+          if(file != jank_nil() && to_string(file) == cache_file_marker)
+          {
+            typed_o->meta = strip_source_from_meta_opt(typed_o->meta);
+          }
+          if(typed_o->meta.is_some())
+          {
+            strip_cache_source(typed_o->meta.unwrap());
+          }
+        }
+      },
+      o);
+
+    if(is_map(o))
+    {
+      for(auto const e : make_sequence_range(o))
+      {
+        strip_cache_source(first(e));
+        strip_cache_source(second(e));
+      }
+    }
+    else if(is_vector(o) || is_set(o) || is_seq(o))
+    {
+      for(auto const e : make_sequence_range(o))
+      {
+        strip_cache_source(e);
+      }
+    }
+  }
+
+  static jtl::option<native_vector<object_ref>> read_forms(jtl::immutable_string_view const code)
+  {
+    context::binding_scope const preserve{ obj::persistent_hash_map::create_unique(
+      std::make_pair(__rt_ctx->current_file_var, make_box(cache_file_marker))) };
+
+    read::lex::processor l_prc{ code };
+    read::parse::processor p_prc{ l_prc.begin(), l_prc.end() };
+
+    native_vector<object_ref> ret;
+    for(auto const &form : p_prc)
+    {
+      if(form.is_err())
+      {
+        return none;
+      }
+      if(form.expect_ok().is_some())
+      {
+        auto const o(form.expect_ok().unwrap().ptr);
+        strip_cache_source(o);
+        ret.emplace_back(o);
+      }
+    }
+    return ret;
+  }
+
+  static jtl::immutable_string cache_path(jtl::immutable_string const &module)
+  {
+    return util::format("{}/macroexpand/{}.expansions", __rt_ctx->binary_cache_dir, module);
+  }
+
+  /* The cache file holds one vector per expansion, of its key, fingerprint, symbol counter,
+   * and printed expansion. A cache file which can't be read is treated as empty. */
+  macroexpand_cache::module_entries &
+  macroexpand_cache::find_module(jtl::immutable_string const &module)
+  {
+    auto const found(modules.find(module));
+    if(found != modules.end())
+    {
+      return found->second;
+    }
+
+    auto &ret(modules[module]);
+    auto const path(cache_path(module));
+    if(!std::filesystem::exists(native_transient_string{ path }))
+    {
+      return ret;
+    }
+
+    auto const file(module::loader::read_file(path));
+    if(file.is_err())
+    {
+      return ret;
+    }
+
+    auto const forms(read_forms(file.expect_ok().view()));
+    if(forms.is_none())
+    {
+      return ret;
+    }
+
+    for(auto const &form : forms.unwrap())
+    {
+      if(!is_vector(form) || sequence_length(form) != 4)
+      {
+        continue;
+      }
+
+      auto const counter(nth(form, make_box(2)));
+      if(counter->type != object_type::integer)
+      {
+        continue;
+      }
+
+      ret.entries.insert_or_assign(to_string(nth(form, make_box(0))),
+                                   entry{ to_string(nth(form, make_box(1))),
+                                          to_string(nth(form, make_box(3))),
+                                          static_cast<u64>(to_int(counter)) });
+    }
+    return ret;
+  }
+
+  /* A macro's expansions depend on the macro and whatever it calls, so we tie them to the
+   * cache key of the macro's module, which covers its source and its dependencies. */
+  jtl::option<jtl::immutable_string> macroexpand_cache::fingerprint(var_ref const macro)
+  {
+    auto const module(macro->n->name->to_string());
+    auto const found(module_keys.find(module));
+    if(found != module_keys.end())
+    {
+      return util::format("{} {}", macro->to_code_string(), found->second);
+    }
+
+    auto const key(__rt_ctx->module_loader.loaded_cache_key(module));
+    if(key.is_err())
+    {
+      return none;
+    }
+
+    /* A module which is still being loaded may require more, which changes its key. */
+    auto const &loading(__rt_ctx->module_loader.loading);
+    if(std::find(loading.begin(), loading.end(), module) == loading.end())
+    {
+      module_keys.emplace(module, key.expect_ok());
+    }
+    return util::format("{} {}", macro->to_code_string(), key.expect_ok());
+  }
+
+  object_ref macroexpand_cache::expand(var_ref const macro,
+                                       object_ref const form,
+                                       std::function<object_ref()> const &expand_fn)
+  {
+    auto const module(runtime::to_string(__rt_ctx->current_module_var->deref()));
+    auto const source(object_source(form));
+    if(module.empty() || source == read::source::unknown()
+       || !std::filesystem::exists(native_transient_string{ source.file }))
+    {
+      return expand_fn();
+    }
+
+    jtl::string_builder key_sb;
+    key_sb(__rt_ctx->current_ns()->name->to_string())(' ');
+    if(!print_form(form, key_sb))
+    {
+      return expand_fn();
+    }
+    auto const key(key_sb.release());
+
+    jtl::immutable_string expected_fingerprint;
+    {
+      std::lock_guard<std::mutex> const lock{ mutex };
+      auto const fp(fingerprint(macro));
+      if(fp.is_none())
+      {
+        return expand_fn();
+      }
+
+      auto const &entries(find_module(module).entries);
+      auto const found(entries.find(key));
+      if(found != entries.end() && found->second.fingerprint == fp.unwrap())
+      {
+        auto const forms(read_forms(found->second.expansion));
+        if(forms.is_some() && forms.unwrap().size() == 1)
+        {
+          profile::timer const timer{ "rt macroexpand cache hit" };
+          auto &counter(__rt_ctx->current_ns()->symbol_counter);
+          auto current(counter.load());
+          while(current < found->second.symbol_counter
+                && !counter.compare_exchange_weak(current, found->second.symbol_counter))
+          {
+          }
+          return forms.unwrap()[0];
+        }
+      }
+      expected_fingerprint = fp.unwrap();
+    }
+
+    auto const expansion(expand_fn());
+
+    jtl::string_builder sb;
+    if(!print_form(expansion, sb))
+    {
+      return expansion;
+    }
+    auto const printed(sb.release());
+
+    /* We only keep what we can read back as the same data. */
+    auto const read_back(read_forms(printed));
+    if(read_back.is_none() || read_back.unwrap().size() != 1
+       || !equal(read_back.unwrap()[0], expansion))
+    {
+      return expansion;
+    }
+
+    std::lock_guard<std::mutex> const lock{ mutex };
+    auto &found(find_module(module));
+    found.entries.insert_or_assign(
+      key,
+      entry{ expected_fingerprint, printed, __rt_ctx->current_ns()->symbol_counter.load() });
+    found.dirty = true;
+    return expansion;
+  }
+
+  void macroexpand_cache::flush()
+  {
+    profile::timer const timer{ "rt macroexpand cache flush" };
+    std::lock_guard<std::mutex> const lock{ mutex };
+    for(auto &module : modules)
+    {
+      if(!module.second.dirty)
+      {
+        continue;
+      }
+
+      std::filesystem::path const path{ cache_path(module.first).c_str() };
+      std::filesystem::create_directories(path.parent_path());
+
+      /* The file is swapped in whole, so another process never reads half of it. */
+      auto tmp_path(path);
+      tmp_path += util::format(".{}", getpid()).c_str();
+      {
+        std::ofstream ofs{ tmp_path };
+        for(auto const &e : module.second.entries)
+        {
+          ofs << '[' << make_box(e.first)->to_code_string() << ' '
+              << make_box(e.second.fingerprint)->to_code_string() << ' ' << e.second.symbol_counter
+              << ' ' << make_box(e.second.expansion)->to_code_string() << "]\n";
+        }
+        if(!ofs)
+        {
+          std::filesystem::remove(tmp_path);
+          continue;
+        }
+      }
+
+      std::error_code ec;
+      std::filesystem::rename(tmp_path, path, ec);
+      module.second.dirty = false;
+    }
+  }
+}
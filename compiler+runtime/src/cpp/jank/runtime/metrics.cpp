@@ -0,0 +1,383 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <variant>
+
+#include <gc/gc.h>
+
+#include <jank/runtime/metrics.hpp>
+#include <jank/runtime/object_pool.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
+#include <jank/jit/stats.hpp>
+#include <jank/util/fmt.hpp>
+
+namespace jank::runtime::metrics
+{
+  /* Threads are given stripes round robin, the first time they record anything. */
+  static usize stripe_index()
+  {
+    static std::atomic<usize> next{};
+    static thread_local usize const index{ next.fetch_add(1, std::memory_order_relaxed) };
+    return index;
+  }
+
+  void counter::add(i64 const n)
+  {
+    stripes[stripe_index() % stripe_count].count.fetch_add(n, std::memory_order_relaxed);
+  }
+
+  i64 counter::value() const
+  {
+    i64 ret{};
+    for(auto const &s : stripes)
+    {
+      ret += s.count.load(std::memory_order_relaxed);
+    }
+    return ret;
+  }
+
+  void gauge::set(f64 const v)
+  {
+    current.store(v, std::memory_order_relaxed);
+  }
+
+  f64 gauge::value() const
+  {
+    return current.load(std::memory_order_relaxed);
+  }
+
+  u64 histogram_summary::percentile(f64 const p) const
+  {
+    if(count == 0)
+    {
+      return 0;
+    }
+
+    auto const rank{ std::max<u64>(
+      1,
+      static_cast<u64>(std::ceil(p / 100.0 * static_cast<f64>(count)))) };
+    u64 seen{};
+    for(usize i{}; i < buckets.size(); ++i)
+    {
+      seen += buckets[i];
+      if(rank <= seen)
+      {
+        return std::clamp(histogram::bucket_max(i), min, max);
+      }
+    }
+    return max;
+  }
+
+  usize histogram::bucket_index(u64 const value)
+  {
+    if(value < sub_bucket_count)
+    {
+      return value;
+    }
+
+    auto const exponent{ static_cast<usize>(std::bit_width(value)) - 1 };
+    if(max_exponent < exponent)
+    {
+      return bucket_count - 1;
+    }
+    auto const sub_bucket{ (value >> (exponent - sub_bucket_bits)) & (sub_bucket_count - 1) };
+    return (exponent - sub_bucket_bits + 1) * sub_bucket_count + sub_bucket;
+  }
+
+  u64 histogram::bucket_max(usize const index)
+  {
+    if(index < sub_bucket_count)
+    {
+      return index;
+    }
+    if(index == bucket_count - 1)
+    {
+      return std::numeric_limits<u64>::max();
+    }
+
+    auto const exponent{ index / sub_bucket_count + sub_bucket_bits - 1 };
+    auto const shift{ exponent - sub_bucket_bits };
+    auto const lowest{ (sub_bucket_count + index % sub_bucket_count) << shift };
+    return lowest + (u64{ 1 } << shift) - 1;
+  }
+
+  /* This doesn't lock or allocate, so it's safe even within the GC's callbacks. */
+  void histogram::record(u64 const value)
+  {
+    auto &s{ stripes[stripe_index() % stripe_count] };
+    s.count.fetch_add(1, std::memory_order_relaxed);
+    s.sum.fetch_add(value, std::memory_order_relaxed);
+    s.buckets[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+
+    auto lowest{ s.min.load(std::memory_order_relaxed) };
+    while(value < lowest
+          && !s.min.compare_exchange_weak(lowest, value, std::memory_order_relaxed))
+    {
+    }
+    auto highest{ s.max.load(std::memory_order_relaxed) };
+    while(highest < value
+          && !s.max.compare_exchange_weak(highest, value, std::memory_order_relaxed))
+    {
+    }
+  }
+
+  /* Values being recorded while this runs may be missing from some of the totals, but
+   * each stripe still adds up on its own. */
+  histogram_summary histogram::summarize() const
+  {
+    histogram_summary ret;
+    ret.min = std::numeric_limits<u64>::max();
+    ret.buckets.resize(bucket_count);
+    for(auto const &s : stripes)
+    {
+      ret.count += s.count.load(std::memory_order_relaxed);
+      ret.sum += s.sum.load(std::memory_order_relaxed);
+      ret.min = std::min(ret.min, s.min.load(std::memory_order_relaxed));
+      ret.max = std::max(ret.max, s.max.load(std::memory_order_relaxed));
+      for(usize i{}; i < bucket_count; ++i)
+      {
+        ret.buckets[i] += s.buckets[i].load(std::memory_order_relaxed);
+      }
+    }
+    if(ret.count == 0)
+    {
+      ret.min = 0;
+    }
+    return ret;
+  }
+
+  struct entry
+  {
+    std::string help;
+    std::variant<std::unique_ptr<counter>, std::unique_ptr<gauge>, std::unique_ptr<histogram>>
+      metric;
+  };
+
+  /* None of this holds GC memory. */
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+  static std::mutex registry_mutex;
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+  static std::map<std::string, entry, std::less<>> registry;
+
+  static bool is_valid_name(jtl::immutable_string const &name)
+  {
+    auto const valid_char([](char const c) {
+      return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || c == ':';
+    });
+    if(name.empty() || !valid_char(name[0]))
+    {
+      return false;
+    }
+    return std::all_of(name.begin(), name.end(), [&](char const c) {
+      return valid_char(c) || (c >= '0' && c <= '9');
+    });
+  }
+
+  static char const *kind_name(entry const &e)
+  {
+    static constexpr std::array<char const *, 3> names{ "counter", "gauge", "histogram" };
+    return names[e.metric.index()];
+  }
+
+  template <typename T>
+  static jtl::result<jtl::ref<T>, jtl::immutable_string>
+  find_or_create(jtl::immutable_string const &name, jtl::immutable_string const &help)
+  {
+    if(!is_valid_name(name))
+    {
+      return err(util::format("Invalid metric name '{}'", name));
+    }
+
+    std::string_view const key{ name.data(), name.size() };
+    std::lock_guard<std::mutex> const lock{ registry_mutex };
+    auto const found{ registry.find(key) };
+    if(found != registry.end())
+    {
+      if(auto const existing{ std::get_if<std::unique_ptr<T>>(&found->second.metric) };
+         existing)
+      {
+        return ok(jtl::ref<T>{ existing->get() });
+      }
+      return err(
+        util::format("The metric '{}' already exists as a {}", name, kind_name(found->second)));
+    }
+
+    auto m{ std::make_unique<T>() };
+    jtl::ref<T> const ret{ m.get() };
+    registry.emplace(key, entry{ { help.data(), help.size() }, std::move(m) });
+    return ok(ret);
+  }
+
+  jtl::result<jtl::ref<counter>, jtl::immutable_string>
+  find_or_create_counter(jtl::immutable_string const &name, jtl::immutable_string const &help)
+  {
+    return find_or_create<counter>(name, help);
+  }
+
+  jtl::result<jtl::ref<gauge>, jtl::immutable_string>
+  find_or_create_gauge(jtl::immutable_string const &name, jtl::immutable_string const &help)
+  {
+    return find_or_create<gauge>(name, help);
+  }
+
+  jtl::result<jtl::ref<histogram>, jtl::immutable_string>
+  find_or_create_histogram(jtl::immutable_string const &name, jtl::immutable_string const &help)
+  {
+    return find_or_create<histogram>(name, help);
+  }
+
+  /* The GC and the JIT already keep their own totals, so they're copied in whenever the
+   * registry is read, rather than recorded twice. */
+  static void publish_runtime_metrics()
+  {
+    auto const set([](char const * const name, char const * const help, auto const v) {
+      find_or_create_gauge(name, help).expect_ok()->set(static_cast<f64>(v));
+    });
+
+    GC_word heap_size{}, free_bytes{}, unmapped_bytes{}, bytes_since_gc{}, total_bytes{};
+    GC_get_heap_usage_safe(&heap_size,
+                           &free_bytes,
+                           &unmapped_bytes,
+                           &bytes_since_gc,
+                           &total_bytes);
+    set("jank_gc_heap_bytes", "The size of the GC heap.", heap_size);
+    set("jank_gc_free_bytes", "The free bytes within the GC heap.", free_bytes);
+    set("jank_gc_allocated_bytes", "The bytes allocated by the GC since start.", total_bytes);
+    set("jank_gc_collections", "The GC collections since start.", GC_get_gc_no());
+
+    auto const pools{ pool_stats() };
+    set("jank_pool_allocations",
+        "The objects taken from the object pools since start.",
+        pools.allocations);
+
+    auto const jit{ jit::stats::totals() };
+    set("jank_jit_cpp_evals", "The C++ sources compiled by the JIT.", jit.jit.cpp_evals);
+    set("jank_jit_clang_parse_ns", "The time spent compiling C++.", jit.jit.clang_parse_ns);
+    set("jank_jit_ir_modules", "The IR modules added to the JIT.", jit.jit.ir_modules);
+    set("jank_jit_llvm_optimize_ns", "The time spent optimizing IR.", jit.jit.llvm_optimize_ns);
+    set("jank_jit_object_bytes", "The bytes of code linked by the JIT.", jit.jit.object_bytes);
+    set("jank_module_cache_hits", "The modules loaded from their binaries.", jit.cache_hits);
+    set("jank_module_cache_misses", "The modules compiled from source.", jit.cache_misses);
+  }
+
+  object_ref snapshot()
+  {
+    publish_runtime_metrics();
+
+    auto const kw(
+      [](char const * const name) { return __rt_ctx->intern_keyword(name).expect_ok(); });
+    runtime::detail::native_transient_hash_map ret;
+    std::lock_guard<std::mutex> const lock{ registry_mutex };
+    for(auto const &[name, e] : registry)
+    {
+      auto m{ obj::persistent_hash_map::create_unique(
+        std::make_pair(kw("type"), kw(kind_name(e))),
+        std::make_pair(kw("help"), make_box(jtl::immutable_string{ e.help.data(), e.help.size() })))
+      };
+
+      if(auto const c{ std::get_if<std::unique_ptr<counter>>(&e.metric) }; c)
+      {
+        m = m->assoc(kw("value"), make_box((*c)->value()));
+      }
+      else if(auto const g{ std::get_if<std::unique_ptr<gauge>>(&e.metric) }; g)
+      {
+        m = m->assoc(kw("value"), make_box((*g)->value()));
+      }
+      else
+      {
+        auto const summary{ std::get<std::unique_ptr<histogram>>(e.metric)->summarize() };
+        auto const mean{ summary.count == 0
+                           ? 0.0
+                           : static_cast<f64>(summary.sum) / static_cast<f64>(summary.count) };
+        auto const p([&](f64 const pct) {
+          return make_box(static_cast<i64>(summary.percentile(pct)));
+        });
+        m = m->assoc(kw("count"), make_box(static_cast<i64>(summary.count)))
+              ->assoc(kw("sum"), make_box(static_cast<i64>(summary.sum)))
+              ->assoc(kw("min"), make_box(static_cast<i64>(summary.min)))
+              ->assoc(kw("max"), make_box(static_cast<i64>(summary.max)))
+              ->assoc(kw("mean"), make_box(mean))
+              ->assoc(kw("percentiles"),
+                      obj::persistent_hash_map::create_unique(
+                        std::make_pair(make_box(50), p(50)),
+                        std::make_pair(make_box(90), p(90)),
+                        std::make_pair(make_box(99), p(99)),
+                        std::make_pair(make_box(99.9), p(99.9))));
+      }
+
+      ret.set(make_box(jtl::immutable_string{ name.data(), name.size() }), m);
+    }
+    return make_box<obj::persistent_hash_map>(ret.persistent());
+  }
+
+  /* Help text can't have raw newlines, so they're escaped, along with backslashes. */
+  static void write_help(jtl::string_builder &buff, std::string const &help)
+  {
+    for(auto const c : help)
+    {
+      if(c == '\\')
+      {
+        buff("\\\\");
+      }
+      else if(c == '\n')
+      {
+        buff("\\n");
+      }
+      else
+      {
+        buff(c);
+      }
+    }
+  }
+
+  jtl::immutable_string prometheus()
+  {
+    publish_runtime_metrics();
+
+    jtl::string_builder buff;
+    std::lock_guard<std::mutex> const lock{ registry_mutex };
+    for(auto const &[name, e] : registry)
+    {
+      if(!e.help.empty())
+      {
+        util::format_to(buff, "# HELP {} ", name);
+        write_help(buff, e.help);
+        buff('\n');
+      }
+
+      if(auto const c{ std::get_if<std::unique_ptr<counter>>(&e.metric) }; c)
+      {
+        util::format_to(buff, "# TYPE {} counter\n{} {}\n", name, name, (*c)->value());
+      }
+      else if(auto const g{ std::get_if<std::unique_ptr<gauge>>(&e.metric) }; g)
+      {
+        util::format_to(buff, "# TYPE {} gauge\n{} {}\n", name, name, (*g)->value());
+      }
+      else
+      {
+        auto const summary{ std::get<std::unique_ptr<histogram>>(e.metric)->summarize() };
+        util::format_to(buff, "# TYPE {} summary\n", name);
+        static constexpr std::array<std::pair<char const *, f64>, 4> quantiles{
+          { { "0.5", 50 }, { "0.9", 90 }, { "0.99", 99 }, { "0.999", 99.9 } }
+        };
+        for(auto const &[label, pct] : quantiles)
+        {
+          util::format_to(buff,
+                          "{}{quantile=\"{}\"} {}\n",
+                          name,
+                          label,
+                          summary.percentile(pct));
+        }
+        util::format_to(buff, "{}_sum {}\n{}_count {}\n", name, summary.sum, name, summary.count);
+      }
+    }
+    return buff.release();
+  }
+}
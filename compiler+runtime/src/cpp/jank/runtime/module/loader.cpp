@@ -2,34 +2,46 @@
 #include <fcntl.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <array>
 #include <filesystem>
+#include <fstream>
+#include <mutex>
 #include <regex>
+#include <sstream>
+#include <thread>
 
 #include <jankzip.h>
 
 #include <jank/type.hpp>
 #include <jank/util/fmt/print.hpp>
 #include <jank/util/path.hpp>
+#include <jank/util/scope_exit.hpp>
+#include <jank/util/sha256.hpp>
 #include <jank/runtime/core.hpp>
 #include <jank/runtime/core/munge.hpp>
 #include <jank/runtime/core/truthy.hpp>
 #include <jank/runtime/obj/persistent_array_map.hpp>
 #include <jank/detail/to_runtime_data.hpp>
 #include <jank/runtime/context.hpp>
+#include <jank/runtime/executor.hpp>
 #include <jank/runtime/obj/atom.hpp>
 #include <jank/runtime/obj/jit_function.hpp>
 #include <jank/runtime/obj/native_function_wrapper.hpp>
 #include <jank/runtime/obj/persistent_sorted_set.hpp>
 #include <jank/runtime/obj/persistent_hash_map.hpp>
 #include <jank/runtime/module/loader.hpp>
+#include <jank/runtime/module/remote_cache.hpp>
 #include <jank/runtime/rtti.hpp>
+#include <jank/util/cli.hpp>
 #include <jank/util/environment.hpp>
 #include <jank/profile/time.hpp>
+#include <jank/jit/stats.hpp>
 #include <jank/error/runtime.hpp>
+#include <jank/read/reparse.hpp>
 
 namespace jank::runtime::module
 {
-  using zip_ptr = std::unique_ptr<zip_t, decltype(&zip_close)>;
   using zip_entry_ptr = std::unique_ptr<zip_t, decltype(&zip_entry_close)>;
 
   /* This turns `foo_bar/spam/meow.cljc` into `foo-bar.spam.meow`. */
@@ -179,21 +191,77 @@ namespace jank::runtime::module
     return sb.release();
   }
 
+  static jtl::result<file_view, error_ref> map_file(jtl::immutable_string const &path);
+
+  /* A jar on the module path. Each one is mapped once, the first time it's needed, and kept
+   * mapped for the life of the process, so reading an entry is only a matter of inflating
+   * it from memory. */
+  struct module_jar
+  {
+    file_view mapping;
+    /* The path of each module file within the jar. This is filled lazily, from the jar's
+     * index file, if it has one. */
+    jtl::option<native_set<jtl::immutable_string>> files;
+  };
+
+  static std::mutex jars_mutex;
+
+  static native_unordered_map<jtl::immutable_string, module_jar> &module_jars()
+  {
+    static native_unordered_map<jtl::immutable_string, module_jar> jars;
+    return jars;
+  }
+
+  static jtl::result<module_jar *, error_ref> open_jar(jtl::immutable_string const &path)
+  {
+    std::lock_guard<std::mutex> const lock{ jars_mutex };
+    auto &jars(module_jars());
+    auto const found(jars.find(path));
+    if(found != jars.end())
+    {
+      return &found->second;
+    }
+
+    auto mapping(map_file(path));
+    if(mapping.is_err())
+    {
+      return mapping.expect_err();
+    }
+    auto const res(jars.emplace(path, module_jar{ jtl::move(mapping.expect_ok()), none }));
+    return &res.first->second;
+  }
+
+  using zip_stream_ptr = std::unique_ptr<zip_t, decltype(&zip_stream_close)>;
+
+  static jtl::result<zip_stream_ptr, error_ref>
+  open_jar_stream(module_jar const &jar, jtl::immutable_string const &path)
+  {
+    zip_stream_ptr zip{ zip_stream_open(jar.mapping.data(), jar.mapping.size(), 0, 'r'),
+                        &zip_stream_close };
+    if(!zip)
+    {
+      return error::internal_runtime_failure(util::format("Failed to open jar '{}'.", path));
+    }
+    return zip;
+  }
+
   template <typename F>
   static jtl::result<void, error_ref> visit_jar_entry(file_entry const &entry, F const &fn)
   {
     auto const &path(entry.archive_path.unwrap());
-
-    int ziperr{};
-    zip_ptr const zip{ zip_openwitherror(path.c_str(), 0, 'r', &ziperr), &zip_close };
-    if(ziperr < 0)
+    auto const jar(open_jar(path));
+    if(jar.is_err())
     {
-      return error::internal_runtime_failure(
-        util::format("Failed to open jar '{}' with error '{}'.", path, zip_strerror(ziperr)));
+      return jar.expect_err();
+    }
+    auto const zip(open_jar_stream(*jar.expect_ok(), path));
+    if(zip.is_err())
+    {
+      return zip.expect_err();
     }
 
-    auto const entry_handle{ open_zip_entry(zip.get(), entry.path.c_str()) };
-    auto const res{ fn(zip.get()) };
+    auto const entry_handle{ open_zip_entry(zip.expect_ok().get(), entry.path.c_str()) };
+    auto const res{ fn(zip.expect_ok().get()) };
     if(res.is_err())
     {
       return res.expect_err();
@@ -202,188 +270,315 @@ namespace jank::runtime::module
     return ok();
   }
 
-  static void register_entry(native_unordered_map<jtl::immutable_string, loader::entry> &entries,
-                             std::filesystem::path const &module_path,
-                             file_entry const &entry)
+  static constexpr std::array<std::pair<module_type, char const *>, 4> module_extensions{
+    { { module_type::o, ".o" },
+      { module_type::cpp, ".cpp" },
+      { module_type::jank, ".jank" },
+      { module_type::cljc, ".cljc" } }
+  };
+
+  static bool is_module_file(jtl::immutable_string const &path)
   {
-    std::filesystem::path const p{ native_transient_string{ entry.path } };
-    auto const ext(p.extension().native());
-    bool registered{};
-    if(ext == ".jank")
-    {
-      registered = true;
-      loader::entry e;
-      e.jank = entry;
-      auto res(entries.insert({ path_to_module(module_path), std::move(e) }));
-      if(!res.second)
-      {
-        res.first->second.jank = entry;
-      }
-    }
-    else if(ext == ".cljc")
+    return std::ranges::any_of(module_extensions,
+                               [&](auto const &ext) { return path.ends_with(ext.second); });
+  }
+
+  static u32 read_u32(char const * const p)
+  {
+    auto const b(reinterpret_cast<u8 const *>(p));
+    return static_cast<u32>(b[0]) | (static_cast<u32>(b[1]) << 8)
+      | (static_cast<u32>(b[2]) << 16) | (static_cast<u32>(b[3]) << 24);
+  }
+
+  /* Jar indices are keyed by the jar's size and a hash of its central directory. The
+   * central directory lists every entry, along with its CRC, so it changes whenever the
+   * contents do, but it's a tiny part of the jar to hash. It's found through the end of
+   * central directory record, which is within the last 64KB. If we can't find it, we hash
+   * that whole tail instead. */
+  static jtl::immutable_string jar_index_key(file_view const &mapping)
+  {
+    static constexpr usize eocd_size{ 22 };
+    static constexpr usize max_comment_size{ 0xffff };
+    static constexpr u32 eocd_signature{ 0x06054b50 };
+
+    auto const data(mapping.data());
+    auto const size(mapping.size());
+    auto const tail_size(std::min(size, eocd_size + max_comment_size));
+    jtl::immutable_string_view directory{ data + size - tail_size, tail_size };
+    for(usize i{ size - eocd_size }; eocd_size <= size && size - i <= tail_size; --i)
     {
-      registered = true;
-      loader::entry e;
-      e.cljc = entry;
-      auto res(entries.insert({ path_to_module(module_path), std::move(e) }));
-      if(!res.second)
+      if(read_u32(data + i) == eocd_signature)
       {
-        res.first->second.cljc = entry;
+        auto const directory_size(read_u32(data + i + 12));
+        auto const directory_offset(read_u32(data + i + 16));
+        if(directory_offset + static_cast<usize>(directory_size) <= i)
+        {
+          directory = { data + directory_offset, directory_size };
+        }
+        break;
       }
-    }
-    else if(ext == ".cpp")
-    {
-      registered = true;
-      loader::entry e;
-      e.cpp = entry;
-      auto res(entries.insert({ path_to_module(module_path), std::move(e) }));
-      if(!res.second)
+      if(i == 0)
       {
-        res.first->second.cpp = entry;
+        break;
       }
     }
-    else if(ext == ".o")
+
+    return util::format("{}-{}",
+                        size,
+                        util::sha256(jtl::immutable_string{ directory.data(), directory.size() }));
+  }
+
+  static constexpr char const *jar_index_header{ "jank jar index 1" };
+
+  static jtl::immutable_string jar_index_path(jtl::immutable_string const &key)
+  {
+    return util::format("{}/jar-index/{}", util::user_cache_dir(util::binary_version()), key);
+  }
+
+  static jtl::option<native_set<jtl::immutable_string>>
+  read_jar_index(jtl::immutable_string const &key)
+  {
+    std::ifstream ifs{ jar_index_path(key).c_str() };
+    std::string line;
+    if(!std::getline(ifs, line) || line != jar_index_header)
     {
-      registered = true;
-      loader::entry e;
-      e.o = entry;
-      auto res(entries.insert({ path_to_module(module_path), std::move(e) }));
-      if(!res.second)
-      {
-        res.first->second.o = entry;
-      }
+      return none;
     }
 
-    if(registered)
+    native_set<jtl::immutable_string> ret;
+    while(std::getline(ifs, line))
     {
-      //util::println("register_entry {} {} {} {}",
-      //              entry.archive_path.unwrap_or("None"),
-      //              entry.path,
-      //              module_path.native(),
-      //              path_to_module(module_path));
+      ret.emplace(line);
     }
+    return ret;
   }
 
+  /* The index is only a cache, so failing to write it, such as when the cache directory
+   * is read only, isn't an error. It's written to a temporary file first, so other
+   * processes never see part of one. */
   static void
-  register_relative_entry(native_unordered_map<jtl::immutable_string, loader::entry> &entries,
-                          std::filesystem::path const &resource_path,
-                          file_entry const &entry)
-  {
-    std::filesystem::path const p{ native_transient_string{ entry.path } };
-    /* We need the file path relative to the module path, since the class
-     * path portion is not included in part of the module name. For example,
-     * the file may live in `src/jank/clojure/core.jank` but the module
-     * should be `clojure.core`, not `src.jank.clojure.core`. */
-    auto const &module_path(p.lexically_relative(resource_path));
-    register_entry(entries, module_path, entry);
-  }
-
-  static void
-  register_directory(native_unordered_map<jtl::immutable_string, loader::entry> &entries,
-                     std::filesystem::path const &path)
+  write_jar_index(jtl::immutable_string const &key, native_set<jtl::immutable_string> const &files)
   {
-    for(auto const &f : std::filesystem::recursive_directory_iterator{ path })
+    std::filesystem::path const path{ jar_index_path(key).c_str() };
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+    auto const tmp_path{ util::format("{}.{}.tmp", path.native(), getpid()) };
     {
-      if(std::filesystem::is_regular_file(f))
+      std::ofstream ofs{ tmp_path.c_str() };
+      ofs << jar_index_header << '\n';
+      for(auto const &file : files)
       {
-        register_relative_entry(entries, path, file_entry{ none, f.path().native() });
+        ofs << file << '\n';
+      }
+      if(!ofs)
+      {
+        std::filesystem::remove(tmp_path.c_str(), ec);
+        return;
       }
     }
+    std::filesystem::rename(tmp_path.c_str(), path, ec);
   }
 
-  static void register_jar(native_unordered_map<jtl::immutable_string, loader::entry> &entries,
-                           jtl::immutable_string const &path)
+  static native_set<jtl::immutable_string> scan_jar(module_jar const &jar,
+                                                    jtl::immutable_string const &path)
   {
-    int ziperr{};
-    zip_ptr const zip{ zip_openwitherror(path.c_str(), 0, 'r', &ziperr), &zip_close };
-    if(ziperr < 0)
+    native_set<jtl::immutable_string> ret;
+    auto const zip(open_jar_stream(jar, path));
+    if(zip.is_err())
     {
-      //util::println(stderr, "Failed to open jar on module path: {}\n", path);
-      return;
+      return ret;
     }
 
-    auto const entry_count{ zip_entries_total(zip.get()) };
+    auto const entry_count{ zip_entries_total(zip.expect_ok().get()) };
     for(ssize i{}; i < entry_count; ++i)
     {
-      auto const entry_handle{ open_zip_entry(zip.get(), i) };
+      auto const entry_handle{ open_zip_entry(zip.expect_ok().get(), i) };
+      if(!zip_entry_isdir(zip.expect_ok().get()))
       {
-        auto const entry_name{ zip_entry_name(zip.get()) };
-        auto const is_dir{ static_cast<bool>(zip_entry_isdir(zip.get())) };
-
-        if(!is_dir)
+        jtl::immutable_string const name{ zip_entry_name(zip.expect_ok().get()) };
+        if(is_module_file(name))
         {
-          register_entry(entries, entry_name, { path, entry_name });
+          ret.emplace(name);
         }
       }
     }
+    return ret;
   }
 
-  static void register_path(native_unordered_map<jtl::immutable_string, loader::entry> &entries,
-                            jtl::immutable_string_view const &path)
+  /* The module files within a jar. With a matching index file, we don't need to look
+   * through the jar at all. */
+  static native_set<jtl::immutable_string> const *jar_files(jtl::immutable_string const &path)
   {
-    /* It's entirely possible to have empty entries in the module path, mainly due to lazy string
-     * concatenation. We just ignore them. This means something like "::::" is valid. */
-    if(path.empty() || !std::filesystem::exists(std::string_view{ path }))
+    auto const jar(open_jar(path));
+    if(jar.is_err())
     {
-      return;
+      return nullptr;
     }
 
-    std::filesystem::path const p{
-      std::filesystem::canonical(std::string_view{ path }).lexically_normal()
-    };
-    if(std::filesystem::is_directory(p))
+    auto &j(*jar.expect_ok());
+    std::lock_guard<std::mutex> const lock{ jars_mutex };
+    if(j.files.is_none())
     {
-      register_directory(entries, p);
-    }
-    else if(p.extension().native() == ".jar")
-    {
-      register_jar(entries, path);
+      auto const key(jar_index_key(j.mapping));
+      j.files = read_jar_index(key);
+      if(j.files.is_none())
+      {
+        j.files = scan_jar(j, path);
+        write_jar_index(key, j.files.unwrap());
+      }
     }
-    /* If it's not a JAR or a directory, we just add it as a direct file entry. I don't think the
-     * JVM supports this, but I like that it allows us to put specific files in the path. */
-    else
+    return &j.files.unwrap();
+  }
+
+  static void set_entry_file(loader::entry &e, module_type const type, file_entry const &file)
+  {
+    switch(type)
     {
-      auto const &module_path(p.native());
-      register_entry(entries, module_path, { none, module_path });
+      case module_type::o:
+        e.o = file;
+        break;
+      case module_type::cpp:
+        e.cpp = file;
+        break;
+      case module_type::jank:
+        e.jank = file;
+        break;
+      case module_type::cljc:
+        e.cljc = file;
+        break;
     }
   }
 
-  static void
-  register_module_path(native_unordered_map<jtl::immutable_string, loader::entry> &entries,
-                       jtl::immutable_string const &paths,
-                       bool const skip_jar)
+  /* Paths which don't exist yet, like the binary cache before anything has been compiled,
+   * are checked again each time they're probed. */
+  static bool resolve_root(loader::module_root &root)
   {
-    usize start{};
-    usize i{ paths.find(loader::module_separator, start) };
+    if(root.type != loader::module_root::kind::unknown)
+    {
+      return true;
+    }
 
-    /* Looks like it's either an empty path list or there's only entry. */
-    if(i == jtl::immutable_string::npos)
+    std::error_code ec;
+    std::filesystem::path const p{ root.path.c_str() };
+    if(!std::filesystem::exists(p, ec))
     {
-      if(!skip_jar || !paths.ends_with(".jar"))
-      {
-        register_path(entries, paths);
-      }
+      return false;
+    }
+
+    auto const canonical(std::filesystem::canonical(p, ec).lexically_normal());
+    if(std::filesystem::is_directory(canonical))
+    {
+      root.type = loader::module_root::kind::directory;
+      root.resolved_path = canonical.native();
+    }
+    else if(canonical.extension().native() == ".jar")
+    {
+      root.type = loader::module_root::kind::jar;
+      root.resolved_path = root.path;
     }
+    /* If it's not a JAR or a directory, we just add it as a direct file entry. I don't think
+     * the JVM supports this, but I like that it allows us to put specific files in the
+     * path. */
     else
     {
-      while(i != jtl::immutable_string::npos)
-      {
-        auto const path(paths.substr(start, i - start));
+      root.type = loader::module_root::kind::file;
+      root.resolved_path = canonical.native();
+      root.module = path_to_module(canonical);
+    }
+    return true;
+  }
 
-        if(!skip_jar || !path.ends_with(".jar"))
+  /* Looks for the module's files in one entry of the module path. Every entry is probed
+   * and later entries replace the files found in earlier ones, which is how the module
+   * path has always been merged. */
+  static bool probe_root(loader::module_root &root,
+                         jtl::immutable_string const &module,
+                         native_vector<jtl::immutable_string> const &relative_paths,
+                         loader::entry &e)
+  {
+    if(!resolve_root(root))
+    {
+      return false;
+    }
+
+    bool found{};
+    switch(root.type)
+    {
+      case loader::module_root::kind::directory:
+        for(auto const &relative : relative_paths)
+        {
+          for(auto const &ext : module_extensions)
+          {
+            auto const path(util::format("{}/{}{}", root.resolved_path, relative, ext.second));
+            std::error_code ec;
+            if(std::filesystem::is_regular_file(path.c_str(), ec))
+            {
+              set_entry_file(e, ext.first, { none, path });
+              found = true;
+            }
+          }
+        }
+        break;
+      case loader::module_root::kind::jar:
         {
-          register_path(entries, path);
+          auto const files(jar_files(root.resolved_path));
+          if(!files)
+          {
+            break;
+          }
+          for(auto const &relative : relative_paths)
+          {
+            for(auto const &ext : module_extensions)
+            {
+              auto const path(util::format("{}{}", relative, ext.second));
+              if(files->contains(path))
+              {
+                set_entry_file(e, ext.first, { root.resolved_path, path });
+                found = true;
+              }
+            }
+          }
         }
+        break;
+      case loader::module_root::kind::file:
+        if(root.module == module)
+        {
+          for(auto const &ext : module_extensions)
+          {
+            if(root.resolved_path.ends_with(ext.second))
+            {
+              set_entry_file(e, ext.first, { none, root.resolved_path });
+              found = true;
+            }
+          }
+        }
+        break;
+      case loader::module_root::kind::unknown:
+        break;
+    }
+    return found;
+  }
 
-        start = i + 1;
-        i = paths.find(loader::module_separator, start);
+  static void add_module_roots(native_vector<loader::module_root> &roots,
+                               jtl::immutable_string const &paths)
+  {
+    usize start{};
+    while(start <= paths.size())
+    {
+      auto i{ paths.find(loader::module_separator, start) };
+      if(i == jtl::immutable_string::npos)
+      {
+        i = paths.size();
       }
 
-      auto const path(paths.substr(start, i - start));
-      if(!skip_jar || !path.ends_with(".jar"))
+      /* It's entirely possible to have empty entries in the module path, mainly due to lazy
+       * string concatenation. We just ignore them. This means something like "::::" is
+       * valid. */
+      if(start < i)
       {
-        register_path(entries, path);
+        roots.push_back({ paths.substr(start, i - start) });
       }
+      start = i + 1;
     }
   }
 
@@ -405,8 +600,8 @@ namespace jank::runtime::module
 
     this->paths = paths;
 
-    //util::println("module paths: {}", paths);
-    register_module_path(entries, paths, false);
+    /* Nothing on the module path is looked at until a module is needed. */
+    add_module_roots(roots, this->paths);
   }
 
   object_ref file_entry::to_runtime_data() const
@@ -560,24 +755,22 @@ namespace jank::runtime::module
       return err(found_module.expect_err());
     }
 
-    int ziperr{};
-    zip_ptr const zip{ zip_openwitherror(jar_path.c_str(), 0, 'r', &ziperr), &zip_close };
-    if(ziperr < 0)
-    {
-      return error::internal_runtime_failure(
-        util::format("Failed to open jar '{}' with error {}, '{}'.",
-                     jar_path,
-                     ziperr,
-                     zip_strerror(ziperr)));
-    }
-
-    auto const entry_handle{ open_zip_entry(zip.get(), file_path) };
-    auto const read_result{ read_zip_entry(zip.get()) };
-    if(read_result.is_err())
+    file_view file;
+    auto const visit_res{ visit_jar_entry(file_entry{ jar_path, file_path },
+                                          [&](zip_t * const zip) -> jtl::result<void, error_ref> {
+                                            auto const read_result{ read_zip_entry(zip) };
+                                            if(read_result.is_err())
+                                            {
+                                              return read_result.expect_err();
+                                            }
+                                            file = file_view{ path, read_result.expect_ok() };
+                                            return ok();
+                                          }) };
+    if(visit_res.is_err())
     {
-      return read_result.expect_err();
+      return visit_res.expect_err();
     }
-    return ok(file_view{ path, read_result.expect_ok() });
+    return ok(jtl::move(file));
   }
 
   static jtl::result<file_view, error_ref> map_file(jtl::immutable_string const &path)
@@ -623,6 +816,34 @@ namespace jank::runtime::module
     return map_file(path);
   }
 
+  static jtl::result<file_view, error_ref> read_entry(file_entry const &entry)
+  {
+    if(entry.archive_path.is_some())
+    {
+      file_view file;
+      auto const visit_res{ visit_jar_entry(entry,
+                                            [&](zip_t * const zip) -> jtl::result<void, error_ref> {
+                                              auto const read_result{ read_zip_entry(zip) };
+                                              if(read_result.is_err())
+                                              {
+                                                return read_result.expect_err();
+                                              }
+                                              file = file_view{ entry.archive_path.unwrap(),
+                                                                read_result.expect_ok() };
+                                              return ok();
+                                            }) };
+      if(visit_res.is_err())
+      {
+        return visit_res.expect_err();
+      }
+      return file;
+    }
+    else
+    {
+      return module::loader::read_file(entry.path);
+    }
+  }
+
   jtl::result<file_view, error_ref> loader::read_module(jtl::immutable_string const &module)
   {
     auto const &found_module{ loader::find(module, origin::source) };
@@ -657,66 +878,660 @@ namespace jank::runtime::module
       return error::internal_runtime_failure(util::format("Unknown type for module '{}'.", module));
     }
 
-    auto const &entry{ res.unwrap() };
-    if(entry.archive_path.is_some())
+    return read_entry(res.unwrap());
+  }
+
+  /* Modules are found by probing the module path for their files, the first time each one
+   * is needed. Only found modules are remembered, so a module which is missing now, but
+   * written later, will still be found. */
+  static jtl::option<loader::entry> find_module(loader &l, jtl::immutable_string const &module)
+  {
+    auto const &cached(l.entries.find(module));
+    if(cached != l.entries.end())
     {
-      file_view file;
-      auto const visit_res{ visit_jar_entry(entry,
-                                            [&](zip_t * const zip) -> jtl::result<void, error_ref> {
-                                              auto const read_result{ read_zip_entry(zip) };
-                                              if(read_result.is_err())
-                                              {
-                                                return read_result.expect_err();
-                                              }
-                                              file = file_view{ entry.archive_path.unwrap(),
-                                                                read_result.expect_ok() };
-                                              return ok();
-                                            }) };
-      if(visit_res.is_err())
+      return cached->second;
+    }
+
+    /* Files are named by munging each part of the module, but we also try the module as
+     * it is, since that's how a file with a - in its name has always been found. */
+    native_vector<jtl::immutable_string> relative_paths{ module_to_path(module) };
+    native_transient_string plain{ module };
+    std::ranges::replace(plain, '.', '/');
+    if(jtl::immutable_string const plain_path{ plain }; plain_path != relative_paths[0])
+    {
+      relative_paths.emplace_back(plain_path);
+    }
+
+    loader::entry e;
+    bool found{};
+    for(auto &root : l.roots)
+    {
+      found = probe_root(root, module, relative_paths, e) || found;
+    }
+    if(!found)
+    {
+      return none;
+    }
+
+    l.entries.emplace(module, e);
+    return e;
+  }
+
+  /* Module entries are registered by their path, so they use - where a module may use _. */
+  static jtl::immutable_string patch_module(jtl::immutable_string const &module)
+  {
+    static std::regex const underscore{ "_" };
+    native_transient_string patched_module{ module };
+    return std::regex_replace(patched_module, underscore, "-");
+  }
+
+  static jtl::immutable_string cache_key_path(jtl::immutable_string const &binary_path)
+  {
+    return util::format("{}.key", binary_path);
+  }
+
+  struct stored_cache_key
+  {
+    jtl::immutable_string key;
+    native_vector<jtl::immutable_string> dependencies;
+  };
+
+  /* The first line is the key. Each line after is a dependency. */
+  static jtl::option<stored_cache_key> read_cache_key(jtl::immutable_string const &binary_path)
+  {
+    std::ifstream ifs{ cache_key_path(binary_path).c_str() };
+    std::string line;
+    if(!std::getline(ifs, line) || line.empty())
+    {
+      return none;
+    }
+
+    stored_cache_key ret{ line, {} };
+    while(std::getline(ifs, line))
+    {
+      if(!line.empty())
       {
-        return visit_res.expect_err();
+        ret.dependencies.emplace_back(line);
       }
-      return file;
+    }
+    return ret;
+  }
+
+  struct binary_source
+  {
+    file_entry entry;
+    module_type type;
+  };
+
+  /* What the remote cache holds for a binary, other than its contents. */
+  struct remote_manifest
+  {
+    jtl::immutable_string key;
+    jtl::immutable_string digest;
+    native_vector<jtl::immutable_string> dependencies;
+  };
+
+  /* The dependencies aren't known until the manifest is fetched, so the manifest is looked
+   * up by everything else which goes into the cache key. The full key is checked after. */
+  static jtl::immutable_string
+  remote_action_key(jtl::immutable_string const &module, jtl::immutable_string const &source_hash)
+  {
+    return util::sha256(util::format("{}\n{}\n{}", util::binary_version(), module, source_hash));
+  }
+
+  /* The first line is the cache key and the second is the SHA256 of the binary. Each line
+   * after is a dependency, just as in a key file. */
+  static jtl::option<remote_manifest>
+  fetch_remote_manifest(loader &l, jtl::immutable_string const &module, file_entry const &source)
+  {
+    auto const remote{ configured_remote_cache() };
+    if(!remote)
+    {
+      return none;
+    }
+
+    auto const hash{ l.source_hash(source) };
+    if(hash.is_err())
+    {
+      return none;
+    }
+    auto const data{
+      remote->get(remote_cache::store::action, remote_action_key(module, hash.expect_ok()))
+    };
+    if(data.is_none())
+    {
+      return none;
+    }
+
+    std::istringstream iss{ std::string{ data.unwrap().data(), data.unwrap().size() } };
+    std::string key, digest, line;
+    if(!std::getline(iss, key) || !std::getline(iss, digest) || key.empty() || digest.empty())
+    {
+      return none;
+    }
+
+    remote_manifest ret{ key, digest, {} };
+    while(std::getline(iss, line))
+    {
+      if(!line.empty())
+      {
+        ret.dependencies.emplace_back(line);
+      }
+    }
+    return ret;
+  }
+
+  /* The source a binary would be compiled from, in order of preference. */
+  static jtl::option<binary_source> find_binary_source(loader::entry const &entry)
+  {
+    if(entry.jank.is_some() && entry.jank.unwrap().exists())
+    {
+      return binary_source{ entry.jank.unwrap(), module_type::jank };
+    }
+    else if(entry.cljc.is_some() && entry.cljc.unwrap().exists())
+    {
+      return binary_source{ entry.cljc.unwrap(), module_type::cljc };
+    }
+    else if(entry.cpp.is_some() && entry.cpp.unwrap().exists())
+    {
+      return binary_source{ entry.cpp.unwrap(), module_type::cpp };
+    }
+    return none;
+  }
+
+  static jtl::result<jtl::immutable_string, error_ref>
+  dependency_cache_key(loader &l, jtl::immutable_string const &module)
+  {
+    auto const cached{ l.cache_keys.find(module) };
+    if(cached != l.cache_keys.end())
+    {
+      return cached->second;
+    }
+
+    auto const found{ find_module(l, patch_module(module)) };
+    if(found.is_none())
+    {
+      return error::runtime_module_not_found(util::format("Unable to find module '{}'.", module));
+    }
+
+    jtl::immutable_string key;
+    auto const &entry{ found.unwrap() };
+    auto const source{ find_binary_source(entry) };
+    if(source.is_none())
+    {
+      /* Without a source, a module can only have been baked into the runtime, which means
+       * it can only change along with the binary version. */
+      key = util::sha256(util::format("{}\n{}", util::binary_version(), module));
     }
     else
     {
-      return module::loader::read_file(entry.path);
+      native_vector<jtl::immutable_string> dependencies;
+      jtl::option<stored_cache_key> stored;
+      if(entry.o.is_some())
+      {
+        stored = read_cache_key(entry.o.unwrap().path);
+      }
+
+      if(stored.is_some())
+      {
+        dependencies = stored.unwrap().dependencies;
+      }
+      /* A dependency which hasn't been fetched yet may still have its binary remotely. */
+      else if(auto const manifest{ fetch_remote_manifest(l, module, source.unwrap().entry) };
+              manifest.is_some())
+      {
+        dependencies = manifest.unwrap().dependencies;
+      }
+
+      auto const res{ l.cache_key(module, source.unwrap().entry, dependencies) };
+      if(res.is_err())
+      {
+        return res.expect_err();
+      }
+      key = res.expect_ok();
+    }
+
+    l.cache_keys.emplace(module, key);
+    return key;
+  }
+
+  jtl::result<jtl::immutable_string, error_ref>
+  loader::cache_key(jtl::immutable_string const &module,
+                    file_entry const &source,
+                    native_vector<jtl::immutable_string> const &dependencies)
+  {
+    auto const hash{ source_hash(source) };
+    if(hash.is_err())
+    {
+      return hash.expect_err();
+    }
+
+    jtl::string_builder sb;
+    sb(util::binary_version())('\n');
+    sb(module)('\n');
+    sb(hash.expect_ok())('\n');
+    for(auto const &dependency : dependencies)
+    {
+      auto const dependency_key{ dependency_cache_key(*this, dependency) };
+      if(dependency_key.is_err())
+      {
+        return dependency_key.expect_err();
+      }
+      sb(dependency)(' ')(dependency_key.expect_ok())('\n');
+    }
+    return util::sha256(sb.release());
+  }
+
+  static jtl::immutable_string source_hash_key(file_entry const &source)
+  {
+    if(source.archive_path.is_some())
+    {
+      return util::format("{}:{}", source.archive_path.unwrap(), source.path);
+    }
+    return source.path;
+  }
+
+  jtl::result<jtl::immutable_string, error_ref> loader::source_hash(file_entry const &source)
+  {
+    auto const key{ source_hash_key(source) };
+    {
+      std::lock_guard<std::mutex> const lock{ source_hashes_mutex };
+      auto const found{ source_hashes.find(key) };
+      if(found != source_hashes.end())
+      {
+        return found->second;
+      }
+    }
+
+    auto const file{ read_entry(source) };
+    if(file.is_err())
+    {
+      return file.expect_err();
+    }
+    auto const view{ file.expect_ok().view() };
+    auto const hash{ util::sha256(jtl::immutable_string{ view.data(), view.size() }) };
+
+    /* Outside of a load, sources may change between any two calls. */
+    if(!loading.empty())
+    {
+      std::lock_guard<std::mutex> const lock{ source_hashes_mutex };
+      source_hashes.insert_or_assign(key, hash);
+    }
+    return hash;
+  }
+
+  void loader::prefetch_source_hashes(jtl::immutable_string const &module)
+  {
+    /* Finding modules and reading key files is quick, and not thread safe, so that's done
+     * here. It's only the reading and hashing of the sources which can take a while. */
+    native_vector<file_entry> sources;
+    native_set<jtl::immutable_string> seen;
+    native_vector<jtl::immutable_string> pending{ module };
+    while(!pending.empty())
+    {
+      auto const next{ pending.back() };
+      pending.pop_back();
+      if(!seen.emplace(next).second || cache_keys.contains(next) || image_binaries.contains(next))
+      {
+        continue;
+      }
+
+      auto const found{ find_module(*this, patch_module(next)) };
+      if(found.is_none() || found.unwrap().o.is_none())
+      {
+        continue;
+      }
+      auto const source{ find_binary_source(found.unwrap()) };
+      auto const stored{ read_cache_key(found.unwrap().o.unwrap().path) };
+      if(source.is_none() || stored.is_none())
+      {
+        continue;
+      }
+
+      sources.emplace_back(source.unwrap().entry);
+      pending.insert(pending.end(),
+                     stored.unwrap().dependencies.begin(),
+                     stored.unwrap().dependencies.end());
+    }
+
+    if(sources.size() < 2)
+    {
+      return;
+    }
+
+    /* The calling thread hashes too, so this still makes progress when every worker is
+     * busy, including when we're on one of them. Failures are left for the load to find
+     * and report, when it hashes the source again. */
+    auto &executor{ pooled_executor() };
+    std::atomic<usize> next_source{};
+    std::atomic<usize> helpers_running{};
+    auto const hash_sources([&] {
+      for(auto i{ next_source++ }; i < sources.size(); i = next_source++)
+      {
+        static_cast<void>(source_hash(sources[i]));
+      }
+    });
+
+    auto const helper_count{ std::min(executor.thread_count(), sources.size() - 1) };
+    helpers_running = helper_count;
+    for(usize i{}; i < helper_count; ++i)
+    {
+      executor.submit([&] {
+        hash_sources();
+        --helpers_running;
+      });
+    }
+
+    hash_sources();
+    while(helpers_running != 0)
+    {
+      if(!executor.run_pending_task())
+      {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  jtl::result<jtl::immutable_string, error_ref>
+  loader::loaded_cache_key(jtl::immutable_string const &module)
+  {
+    auto const found{ find_module(*this, patch_module(module)) };
+    if(found.is_none())
+    {
+      return error::runtime_module_not_found(util::format("Unable to find module '{}'.", module));
+    }
+
+    auto const source{ find_binary_source(found.unwrap()) };
+    if(source.is_none())
+    {
+      return util::sha256(util::format("{}\n{}", util::binary_version(), module));
     }
+    return cache_key(module, source.unwrap().entry, __rt_ctx->module_dependencies[module]);
   }
 
-  static jtl::option<loader::entry>
-  find_module(native_unordered_map<jtl::immutable_string, loader::entry> &entries,
-              jtl::immutable_string const &paths,
-              jtl::immutable_string const &module)
+  bool loader::is_binary_current(jtl::immutable_string const &module,
+                                 file_entry const &source,
+                                 file_entry const &binary)
   {
-    auto const &first_find(entries.find(module));
+    auto const stored{ read_cache_key(binary.path) };
+    if(stored.is_none())
+    {
+      return false;
+    }
+
+    auto const key{ cache_key(module, source, stored.unwrap().dependencies) };
+    return key.is_ok() && key.expect_ok() == stored.unwrap().key;
+  }
 
-    if(first_find != entries.end())
+  static void publish_remote_binary(jtl::immutable_string const &module,
+                                    jtl::immutable_string const &source_hash,
+                                    jtl::immutable_string const &key,
+                                    jtl::immutable_string const &binary_path,
+                                    native_vector<jtl::immutable_string> const &dependencies)
+  {
+    std::ifstream ifs{ binary_path.c_str(), std::ios::binary };
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+    if(!ifs)
     {
-      return first_find->second;
+      return;
     }
+    auto const contents{ ss.str() };
+    jtl::immutable_string const binary{ contents.data(), contents.size() };
+    auto const digest{ util::sha256(binary) };
 
-    /* Skip jars after the initial indexing since we can consider them immutable
-     * for development purposes. */
-    register_module_path(entries, paths, true);
+    jtl::string_builder sb;
+    sb(key)('\n')(digest)('\n');
+    for(auto const &dependency : dependencies)
+    {
+      sb(dependency)('\n');
+    }
+
+    /* The binary goes first, so the manifest never points at something missing. */
+    auto const remote{ configured_remote_cache() };
+    remote->put(remote_cache::store::content, digest, binary);
+    remote->put(remote_cache::store::action,
+                remote_action_key(module, source_hash),
+                sb.release());
+  }
+
+  jtl::result<void, error_ref> loader::write_cache_key(jtl::immutable_string const &module)
+  {
+    auto const binary_path{ __rt_ctx->get_output_module_name(module) };
+    auto const found{ find_module(*this, patch_module(module)) };
+    if(!std::filesystem::exists(native_transient_string{ binary_path }) || found.is_none())
+    {
+      return ok();
+    }
+    auto const source{ find_binary_source(found.unwrap()) };
+    if(source.is_none())
+    {
+      return ok();
+    }
 
-    auto const &second_find(entries.find(module));
+    auto const &dependencies{ __rt_ctx->module_dependencies[module] };
+    auto const key{ cache_key(module, source.unwrap().entry, dependencies) };
+    if(key.is_err())
+    {
+      return key.expect_err();
+    }
+    cache_keys.insert_or_assign(module, key.expect_ok());
 
-    if(second_find != entries.end())
+    std::ofstream ofs{ cache_key_path(binary_path).c_str() };
+    ofs << key.expect_ok() << '\n';
+    for(auto const &dependency : dependencies)
     {
-      return second_find->second;
+      ofs << dependency << '\n';
+    }
+    if(!ofs)
+    {
+      return error::internal_runtime_failure(
+        util::format("Unable to write the cache key for module '{}'.", module));
     }
 
-    return {};
+    if(is_remote_cache_writable())
+    {
+      publish_remote_binary(module,
+                            source_hash(source.unwrap().entry).expect_ok(),
+                            key.expect_ok(),
+                            binary_path,
+                            dependencies);
+    }
+    return ok();
+  }
+
+  jtl::option<file_entry>
+  loader::fetch_remote_binary(jtl::immutable_string const &module, file_entry const &source)
+  {
+    auto const manifest{ fetch_remote_manifest(*this, module, source) };
+    if(manifest.is_none())
+    {
+      return none;
+    }
+
+    /* The manifest was found without the dependency keys, so it's only current if it
+     * was built against the same dependencies as we have. */
+    auto const &m{ manifest.unwrap() };
+    auto const key{ cache_key(module, source, m.dependencies) };
+    if(key.is_err() || key.expect_ok() != m.key)
+    {
+      return none;
+    }
+
+    auto const binary{ configured_remote_cache()->get(remote_cache::store::content, m.digest) };
+    if(binary.is_none() || util::sha256(binary.unwrap()) != m.digest)
+    {
+      return none;
+    }
+
+    /* The binary is written to the side and renamed, so another process can never load
+     * it half written. The key file goes last, since that's what makes the binary current. */
+    auto const binary_path{ __rt_ctx->get_output_module_name(module) };
+    std::filesystem::path const path{ binary_path.c_str() };
+    auto tmp_path{ path };
+    tmp_path += util::format(".tmp-{}", getpid()).c_str();
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+    {
+      std::ofstream ofs{ tmp_path, std::ios::binary | std::ios::trunc };
+      ofs.write(binary.unwrap().data(), static_cast<std::streamsize>(binary.unwrap().size()));
+      if(!ofs)
+      {
+        std::filesystem::remove(tmp_path, ec);
+        return none;
+      }
+    }
+    std::filesystem::rename(tmp_path, path, ec);
+    if(ec)
+    {
+      std::filesystem::remove(tmp_path, ec);
+      return none;
+    }
+
+    std::ofstream ofs{ cache_key_path(binary_path).c_str() };
+    ofs << m.key << '\n';
+    for(auto const &dependency : m.dependencies)
+    {
+      ofs << dependency << '\n';
+    }
+    if(!ofs)
+    {
+      return none;
+    }
+
+    cache_keys.insert_or_assign(module, m.key);
+    return file_entry{ none, binary_path };
+  }
+
+  jtl::result<void, error_ref> loader::write_pending_cache_keys()
+  {
+    util::scope_exit const clear{ [this] {
+      pending_cache_keys.clear();
+      cache_keys.clear();
+      std::lock_guard<std::mutex> const lock{ source_hashes_mutex };
+      source_hashes.clear();
+    } };
+    for(auto const &module : pending_cache_keys)
+    {
+      auto const res{ write_cache_key(module) };
+      if(res.is_err())
+      {
+        return res;
+      }
+    }
+    return ok();
+  }
+
+  static constexpr char const *image_header{ "jank image 1" };
+
+  /* The image starts with a header and the binary version it was saved with. After that,
+   * each line is a module, its cache key, and the path to its binary, which goes last
+   * since it may have spaces. A stale binary, one with a different key, is left out, so
+   * it's found and checked as usual. */
+  jtl::result<void, error_ref> loader::read_image(jtl::immutable_string const &path)
+  {
+    std::ifstream ifs{ path.c_str() };
+    std::string line;
+    if(!std::getline(ifs, line) || line != image_header)
+    {
+      return error::runtime_unable_to_open_file(
+        util::format("'{}' isn't a jank startup image.", path));
+    }
+    if(!std::getline(ifs, line) || line != util::binary_version().c_str())
+    {
+      /* An image from another version of jank isn't an error, but none of its binaries
+       * would be usable. */
+      return ok();
+    }
+
+    while(std::getline(ifs, line))
+    {
+      auto const first_space{ line.find(' ') };
+      auto const second_space{ line.find(' ', first_space + 1) };
+      if(first_space == std::string::npos || second_space == std::string::npos)
+      {
+        continue;
+      }
+
+      jtl::immutable_string const module{ line.substr(0, first_space) };
+      jtl::immutable_string const key{ line.substr(first_space + 1,
+                                                   second_space - first_space - 1) };
+      jtl::immutable_string const binary_path{ line.substr(second_space + 1) };
+      auto const stored{ read_cache_key(binary_path) };
+      if(stored.is_none() || stored.unwrap().key != key)
+      {
+        continue;
+      }
+
+      /* The dependencies are still needed for the cache keys of anything compiled later. */
+      __rt_ctx->module_dependencies[module] = stored.unwrap().dependencies;
+      image_binaries.insert_or_assign(module, file_entry{ none, binary_path });
+    }
+    return ok();
+  }
+
+  jtl::result<void, error_ref> loader::write_image(jtl::immutable_string const &path)
+  {
+    native_deque<jtl::immutable_string> modules;
+    {
+      auto const locked_modules{ __rt_ctx->loaded_modules_in_order.rlock() };
+      modules = *locked_modules;
+    }
+
+    jtl::string_builder sb;
+    sb(image_header)('\n');
+    sb(util::binary_version())('\n');
+    for(auto const &module : modules)
+    {
+      auto const found{ find(module, origin::latest) };
+      if(found.is_err() || found.expect_ok().to_load != module_type::o)
+      {
+        continue;
+      }
+
+      auto const &binary_path{ found.expect_ok().sources.o.unwrap().path };
+      auto const stored{ read_cache_key(binary_path) };
+      if(stored.is_some())
+      {
+        sb(module)(' ')(stored.unwrap().key)(' ')(binary_path)('\n');
+      }
+    }
+
+    auto const contents{ sb.view() };
+    std::ofstream ofs{ path.c_str() };
+    ofs.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+    if(!ofs)
+    {
+      return error::internal_runtime_failure(
+        util::format("Unable to write the startup image '{}'.", path));
+    }
+    return ok();
+  }
+
+  /* Whole program and profile instrumented builds compile modules to objects which the JIT
+   * can't load, since they're bitcode or they need the profile runtime. They're only ever
+   * linked into programs, so those builds always load modules from source. */
+  static bool binaries_are_loadable()
+  {
+    return !util::cli::opts.whole_program && !util::cli::opts.profile_generate;
   }
 
   jtl::result<loader::find_result, error_ref>
   loader::find(jtl::immutable_string const &module, origin const ori)
   {
-    static std::regex const underscore{ "_" };
-    native_transient_string patched_module{ module };
-    patched_module = std::regex_replace(patched_module, underscore, "-");
-    auto const &found(find_module(entries, paths, patched_module));
+    /* Binaries from the startup image were checked against their keys when it was read. */
+    if(ori != origin::source)
+    {
+      auto const image_binary{ image_binaries.find(module) };
+      if(image_binary != image_binaries.end())
+      {
+        entry e;
+        e.o = image_binary->second;
+        return find_result{ e, module_type::o };
+      }
+    }
+
+    auto const &found(find_module(*this, patch_module(module)));
 
     if(found.is_none())
     {
@@ -749,30 +1564,26 @@ namespace jank::runtime::module
        * Portability:
        * Unlike class files, object files are tied to the OS, architecture, C++ stdlib etc,
        * making it hard to share them. */
-      if(entry.o.is_some() && entry.o.unwrap().archive_path.is_none() && entry.o.unwrap().exists()
-         && (entry.jank.is_some() || entry.cljc.is_some() || entry.cpp.is_some()))
+      if(binaries_are_loadable() && entry.o.is_none() && configured_remote_cache())
       {
-        auto const o_file_path{ native_transient_string{ entry.o.unwrap().path } };
-
-        std::time_t source_modified_time{};
-        module_type module_type{};
-
-        if(entry.jank.is_some() && entry.jank.unwrap().exists())
-        {
-          source_modified_time = entry.jank.unwrap().last_modified_at();
-          module_type = module_type::jank;
-        }
-        else if(entry.cljc.is_some() && entry.cljc.unwrap().exists())
+        /* We've never compiled this module, but someone else may have. */
+        auto const source{ find_binary_source(entry) };
+        auto const fetched{ source.is_some() ? fetch_remote_binary(module, source.unwrap().entry)
+                                             : jtl::option<file_entry>{} };
+        if(fetched.is_some())
         {
-          source_modified_time = entry.cljc.unwrap().last_modified_at();
-          module_type = module_type::cljc;
+          auto &registered{ entries[patch_module(module)] };
+          registered.o = fetched.unwrap();
+          return find_result{ registered, module_type::o };
         }
-        else if(entry.cpp.is_some() && entry.cpp.unwrap().exists())
-        {
-          source_modified_time = entry.cpp.unwrap().last_modified_at();
-          module_type = module_type::cpp;
-        }
-        else
+      }
+
+      if(binaries_are_loadable() && entry.o.is_some() && entry.o.unwrap().archive_path.is_none()
+         && entry.o.unwrap().exists()
+         && (entry.jank.is_some() || entry.cljc.is_some() || entry.cpp.is_some()))
+      {
+        auto const source{ find_binary_source(entry) };
+        if(source.is_none())
         {
           return error::runtime_module_binary_without_source(
             util::format("Found a binary '{}' without a source while trying to load module '{}'. "
@@ -782,14 +1593,20 @@ namespace jank::runtime::module
                          module));
         }
 
-        if(std::filesystem::last_write_time(o_file_path).time_since_epoch().count()
-           >= source_modified_time)
+        if(is_binary_current(module, source.unwrap().entry, entry.o.unwrap()))
         {
           return find_result{ entry, module_type::o };
         }
+        else if(auto const fetched{ fetch_remote_binary(module, source.unwrap().entry) };
+                fetched.is_some())
+        {
+          auto &registered{ entries[patch_module(module)] };
+          registered.o = fetched.unwrap();
+          return find_result{ registered, module_type::o };
+        }
         else
         {
-          return find_result{ entry, module_type };
+          return find_result{ entry, source.unwrap().type };
         }
       }
       else if(entry.cpp.is_some())
@@ -911,13 +1728,57 @@ namespace jank::runtime::module
     util::println("Loading module {} from {}", module, path);
   }
 
+  /* Loading a binary is a hit on the module cache, while anything which needs compiling
+   * is a miss. */
+  static jit::stats::module_origin stats_origin(module_type const type)
+  {
+    switch(type)
+    {
+      case module_type::o:
+        return jit::stats::module_origin::binary;
+      case module_type::cpp:
+        return jit::stats::module_origin::cpp;
+      default:
+        return jit::stats::module_origin::source;
+    }
+  }
+
   jtl::result<void, error_ref> loader::load(jtl::immutable_string const &module, origin const ori)
   {
+    /* Even a module which is already loaded is a dependency of whoever required it. */
+    if(!loading.empty())
+    {
+      auto &dependencies{ __rt_ctx->module_dependencies[loading.back()] };
+      if(std::ranges::find(dependencies, module) == dependencies.end())
+      {
+        dependencies.emplace_back(module);
+      }
+    }
+
     if(ori != origin::source && loader::is_loaded(module))
     {
       return ok();
     }
 
+    loading.emplace_back(module);
+    util::scope_exit const finish_loading{ [this] {
+      loading.pop_back();
+      /* Sources may change between top level loads, such as at the REPL, so the keys
+       * are only trusted for the duration of one. */
+      if(loading.empty())
+      {
+        cache_keys.clear();
+        std::lock_guard<std::mutex> const lock{ source_hashes_mutex };
+        source_hashes.clear();
+      }
+    } };
+
+    if(loading.size() == 1 && ori != origin::source && binaries_are_loadable())
+    {
+      prefetch_source_hashes(module);
+    }
+    __rt_ctx->module_dependencies[module].clear();
+
     auto const &found_module{ loader::find(module, ori) };
     if(found_module.is_err())
     {
@@ -931,6 +1792,7 @@ namespace jank::runtime::module
 
     //log_load(module, module_type_to_load, module_sources);
 
+    jit::stats::module_scope const stats_scope{ module, stats_origin(module_type_to_load) };
     switch(module_type_to_load)
     {
       case module_type::jank:
@@ -955,6 +1817,14 @@ namespace jank::runtime::module
       return res;
     }
 
+    /* The object file may still be being written in the background, so the key can't be
+     * written until that's done. */
+    if(module_type_to_load != module_type::o && truthy(__rt_ctx->compile_files_var->deref())
+       && util::cli::opts.output_target == util::cli::compilation_target::object)
+    {
+      pending_cache_keys.emplace_back(module);
+    }
+
     loader::set_is_loaded(module);
     {
       auto const locked_ordered_modules{ __rt_ctx->loaded_modules_in_order.wlock() };
@@ -1067,7 +1937,8 @@ namespace jank::runtime::module
           auto const path{ util::format("{}:{}", entry.archive_path.unwrap(), entry.path) };
           context::binding_scope const preserve{ runtime::obj::persistent_hash_map::create_unique(
             std::make_pair(__rt_ctx->current_file_var, make_box(path))) };
-          __rt_ctx->eval_string(read_result.expect_ok());
+          util::scope_exit const forget{ [&] { read::parse::forget_positions(path); } };
+          __rt_ctx->eval_string(read_result.expect_ok(), true);
           return ok();
         }) };
       if(res.is_err())
@@ -1095,7 +1966,7 @@ namespace jank::runtime::module
     sb(module_separator);
     sb(path);
     paths = sb.release();
-    register_path(entries, path);
+    add_module_roots(roots, path);
   }
 
   object_ref loader::to_runtime_data() const
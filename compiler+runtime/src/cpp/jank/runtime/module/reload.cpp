@@ -0,0 +1,452 @@
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <string_view>
+
+#include <jank/runtime/module/reload.hpp>
+#include <jank/runtime/module/loader.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core.hpp>
+#include <jank/runtime/executor.hpp>
+#include <jank/runtime/obj/persistent_array_map.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
+#include <jank/runtime/obj/persistent_vector.hpp>
+#include <jank/read/lex.hpp>
+#include <jank/read/parse.hpp>
+#include <jank/read/reparse.hpp>
+#include <jank/error/report.hpp>
+#include <jank/error/runtime.hpp>
+#include <jank/util/cli.hpp>
+#include <jank/util/fmt.hpp>
+#include <jank/util/fmt/print.hpp>
+#include <jank/util/scope_exit.hpp>
+
+namespace jank::runtime::module
+{
+  static jtl::option<std::time_t> modified_at(jtl::immutable_string const &path)
+  {
+    std::error_code ec;
+    auto const time{ std::filesystem::last_write_time(native_transient_string{ path }, ec) };
+    if(ec)
+    {
+      return none;
+    }
+    /* NOLINTNEXTLINE(*-narrowing-conversions) */
+    return time.time_since_epoch().count();
+  }
+
+  /* Each top level form is hashed by its source text, so changes to the whitespace and
+   * comments between forms don't count as changes to either of them. */
+  template <typename F>
+  static jtl::result<void, error_ref> visit_forms(jtl::immutable_string_view const &code, F &&f)
+  {
+    read::lex::processor l_prc{ code };
+    read::parse::processor p_prc{ l_prc.begin(), l_prc.end() };
+    for(auto const &form : p_prc)
+    {
+      if(form.is_err())
+      {
+        return form.expect_err();
+      }
+      if(form.expect_ok().is_none())
+      {
+        continue;
+      }
+
+      auto const &info(form.expect_ok().unwrap());
+      auto const start{ std::min(info.start.start.offset, code.size()) };
+      auto const end{ std::clamp(info.end.end.offset, start, code.size()) };
+      auto const hash{ std::hash<std::string_view>{}(
+        std::string_view{ code.data() + start, end - start }) };
+      if(!f(info.ptr, static_cast<usize>(hash)))
+      {
+        break;
+      }
+    }
+    return ok();
+  }
+
+  static bool defines_macro(object_ref const form)
+  {
+    if(!is_seq(form))
+    {
+      return false;
+    }
+    auto const sym{ dyn_cast<obj::symbol>(first(form)) };
+    return sym.is_some() && sym->name == "defmacro"
+      && (sym->ns.empty() || sym->ns == "clojure.core");
+  }
+
+  /* Reading a module's forms needs its ns to be current, for auto-resolved keywords and
+   * syntax quoting, just as evaluating them does. */
+  static obj::persistent_hash_map_ref
+  module_bindings(jtl::immutable_string const &module, jtl::immutable_string const &path)
+  {
+    auto const ns{ __rt_ctx->find_ns(make_box<obj::symbol>(module)) };
+    return obj::persistent_hash_map::create_unique(
+      std::make_pair(__rt_ctx->current_ns_var, ns.is_some() ? ns : __rt_ctx->current_ns()),
+      std::make_pair(__rt_ctx->current_module_var, make_box(module)),
+      std::make_pair(__rt_ctx->current_file_var, make_box(path)));
+  }
+
+  /* Every module which requires one of the given modules, directly or not. */
+  static native_unordered_map<jtl::immutable_string, bool>
+  dependents_of(native_vector<jtl::immutable_string> const &modules)
+  {
+    native_unordered_map<jtl::immutable_string, bool> affected;
+    for(auto const &m : modules)
+    {
+      affected[m] = false;
+    }
+
+    bool grew{ true };
+    while(grew)
+    {
+      grew = false;
+      for(auto const &[module, dependencies] : __rt_ctx->module_dependencies)
+      {
+        if(affected.contains(module))
+        {
+          continue;
+        }
+        for(auto const &d : dependencies)
+        {
+          if(affected.contains(d))
+          {
+            affected[module] = true;
+            grew = true;
+            break;
+          }
+        }
+      }
+    }
+    return affected;
+  }
+
+  object_ref reloader::reload_result::to_runtime_data() const
+  {
+    object_ref patched_map{ obj::persistent_array_map::empty() };
+    for(auto const &[module, count] : patched)
+    {
+      patched_map = assoc(patched_map, make_box<obj::symbol>(module), make_box(count));
+    }
+    object_ref reloaded_vec{ obj::persistent_vector::empty() };
+    for(auto const &module : reloaded)
+    {
+      reloaded_vec = conj(reloaded_vec, make_box<obj::symbol>(module));
+    }
+    return obj::persistent_array_map::create_unique(
+      __rt_ctx->intern_keyword("patched").expect_ok(),
+      patched_map,
+      __rt_ctx->intern_keyword("reloaded").expect_ok(),
+      reloaded_vec);
+  }
+
+  reloader::~reloader()
+  {
+    unwatch();
+  }
+
+  jtl::result<void, error_ref> reloader::track(jtl::immutable_string const &module)
+  {
+    auto const found{ __rt_ctx->module_loader.entries.find(module) };
+    if(found == __rt_ctx->module_loader.entries.end())
+    {
+      return ok();
+    }
+    auto const &source{ found->second.jank.is_some() ? found->second.jank : found->second.cljc };
+    if(source.is_none() || source.unwrap().archive_path.is_some())
+    {
+      return ok();
+    }
+
+    tracked_module tracked{ source.unwrap().path };
+    auto const time{ modified_at(tracked.path) };
+    if(time.is_none())
+    {
+      return ok();
+    }
+    tracked.modified_at = time.unwrap();
+
+    auto const file{ loader::read_file(tracked.path) };
+    if(file.is_err())
+    {
+      return file.expect_err();
+    }
+
+    context::binding_scope const preserve{ module_bindings(module, tracked.path) };
+    util::scope_exit const forget{ [path = tracked.path] { read::parse::forget_positions(path); } };
+    auto const res{ visit_forms(file.expect_ok().view(), [&](object_ref, usize const hash) {
+      tracked.form_hashes.emplace_back(hash);
+      return true;
+    }) };
+    if(res.is_err())
+    {
+      return res;
+    }
+    std::ranges::sort(tracked.form_hashes);
+
+    modules.insert_or_assign(module, jtl::move(tracked));
+    return ok();
+  }
+
+  jtl::result<void, error_ref> reloader::track_loaded_modules()
+  {
+    std::lock_guard<std::recursive_mutex> const lock{ mutex };
+
+    native_vector<jtl::immutable_string> untracked;
+    {
+      auto const locked_modules{ __rt_ctx->loaded_modules_in_order.rlock() };
+      for(auto const &module : *locked_modules)
+      {
+        if(!modules.contains(module) && !is_core_module(module)
+           && std::ranges::find(untracked, module) == untracked.end())
+        {
+          untracked.emplace_back(module);
+        }
+      }
+    }
+
+    for(auto const &module : untracked)
+    {
+      auto const res{ track(module) };
+      if(res.is_err())
+      {
+        return res;
+      }
+    }
+    return ok();
+  }
+
+  /* Evaluates the forms of the module which weren't there before. This gives true if the
+   * module needs to be loaded as a whole instead, in which case it's left as it was. */
+  jtl::result<bool, error_ref> reloader::patch(jtl::immutable_string const &module,
+                                               tracked_module &tracked,
+                                               reload_result &result)
+  {
+    auto const time{ modified_at(tracked.path) };
+    auto const file{ loader::read_file(tracked.path) };
+    if(time.is_none() || file.is_err())
+    {
+      return false;
+    }
+    /* If this fails, we don't want to try again until the source changes again. */
+    tracked.modified_at = time.unwrap();
+
+    context::binding_scope const preserve{ module_bindings(module, tracked.path) };
+    util::scope_exit const forget{ [path = tracked.path] { read::parse::forget_positions(path); } };
+    native_vector<usize> hashes;
+    usize evaluated{};
+    bool whole{};
+    jtl::option<error_ref> failure;
+    auto const res{ visit_forms(file.expect_ok().view(),
+                                [&](object_ref const form, usize const hash) {
+                                  hashes.emplace_back(hash);
+                                  if(std::ranges::binary_search(tracked.form_hashes, hash))
+                                  {
+                                    return true;
+                                  }
+                                  if(defines_macro(form))
+                                  {
+                                    whole = true;
+                                    return false;
+                                  }
+
+                                  try
+                                  {
+                                    __rt_ctx->eval(form);
+                                    ++evaluated;
+                                    return true;
+                                  }
+                                  catch(std::exception const &e)
+                                  {
+                                    failure = error::runtime_unable_to_load_module(e.what());
+                                  }
+                                  catch(object_ref const e)
+                                  {
+                                    failure = error::runtime_unable_to_load_module(
+                                      runtime::to_code_string(e));
+                                  }
+                                  catch(error_ref const e)
+                                  {
+                                    failure = e;
+                                  }
+                                  return false;
+                                }) };
+    if(res.is_err())
+    {
+      return res.expect_err();
+    }
+    if(failure.is_some())
+    {
+      return failure.unwrap();
+    }
+    if(whole)
+    {
+      return true;
+    }
+
+    std::ranges::sort(hashes);
+    tracked.form_hashes = jtl::move(hashes);
+    result.patched.emplace_back(module, evaluated);
+    return false;
+  }
+
+  jtl::result<void, error_ref> reloader::reload_whole(jtl::immutable_string const &module)
+  {
+    /* The binary of a module which depends on a changed source can't be current, since
+     * its cache key covers the sources of its dependencies, so the source is what we'd
+     * load anyway. */
+    auto const res{ __rt_ctx->load_module(util::format("/{}", module), origin::source) };
+    if(res.is_err())
+    {
+      return res;
+    }
+    modules.erase(module);
+    return track(module);
+  }
+
+  jtl::result<reloader::reload_result, error_ref> reloader::reload_changed()
+  {
+    std::lock_guard<std::recursive_mutex> const lock{ mutex };
+
+    auto const tracked_res{ track_loaded_modules() };
+    if(tracked_res.is_err())
+    {
+      return tracked_res.expect_err();
+    }
+
+    /* Modules are reloaded in the order they were first loaded, which has each module
+     * after everything it requires. */
+    native_unordered_map<jtl::immutable_string, usize> load_order;
+    {
+      auto const locked_modules{ __rt_ctx->loaded_modules_in_order.rlock() };
+      for(usize i{}; i < locked_modules->size(); ++i)
+      {
+        load_order.try_emplace((*locked_modules)[i], i);
+      }
+    }
+    auto const by_load_order([&](auto const &l, auto const &r) {
+      return load_order[l] < load_order[r];
+    });
+
+    native_vector<jtl::immutable_string> changed;
+    for(auto const &[module, tracked] : modules)
+    {
+      auto const time{ modified_at(tracked.path) };
+      if(time.is_some() && time.unwrap() != tracked.modified_at)
+      {
+        changed.emplace_back(module);
+      }
+    }
+    std::ranges::sort(changed, by_load_order);
+
+    reload_result result;
+    native_vector<jtl::immutable_string> whole;
+    for(auto const &module : changed)
+    {
+      auto const res{ patch(module, modules[module], result) };
+      if(res.is_err())
+      {
+        return res.expect_err();
+      }
+      if(res.expect_ok())
+      {
+        whole.emplace_back(module);
+      }
+    }
+
+    auto const affected{ dependents_of(util::cli::opts.direct_linking ? changed : whole) };
+    native_vector<jtl::immutable_string> to_reload;
+    for(auto const &[module, is_dependent] : affected)
+    {
+      /* A changed module which was patched needs no more, unless it's also downstream of
+       * one which needs loading as a whole. */
+      if(is_dependent || std::ranges::find(whole, module) != whole.end())
+      {
+        to_reload.emplace_back(module);
+      }
+    }
+    std::ranges::sort(to_reload, by_load_order);
+
+    for(auto const &module : to_reload)
+    {
+      auto const res{ reload_whole(module) };
+      if(res.is_err())
+      {
+        return res.expect_err();
+      }
+      result.reloaded.emplace_back(module);
+    }
+
+    return result;
+  }
+
+  void reloader::watch(i64 const interval_ms, jtl::option<object_ref> const &on_reload)
+  {
+    unwatch();
+
+    std::lock_guard<std::mutex> const lock{ watch_mutex };
+    is_watching = true;
+    watcher = std::thread{ [this, interval_ms, on_reload] {
+      gc_thread_scope const gc_scope;
+      auto const callback{ on_reload };
+      auto const interval{ std::chrono::milliseconds{ std::max<i64>(interval_ms, 1) } };
+
+      while(true)
+      {
+        {
+          std::unique_lock<std::mutex> wait_lock{ watch_mutex };
+          if(watch_cv.wait_for(wait_lock, interval, [this] { return !is_watching; }))
+          {
+            return;
+          }
+        }
+
+        auto const res{ reload_changed() };
+        if(res.is_err())
+        {
+          error::report(res.expect_err());
+          continue;
+        }
+
+        auto const &result{ res.expect_ok() };
+        if(callback.is_some() && (!result.patched.empty() || !result.reloaded.empty()))
+        {
+          try
+          {
+            dynamic_call(callback.unwrap(), result.to_runtime_data());
+          }
+          catch(std::exception const &e)
+          {
+            util::println(stderr, "Uncaught exception in reload callback: {}", e.what());
+          }
+          catch(object_ref const e)
+          {
+            util::println(stderr,
+                          "Uncaught exception in reload callback: {}",
+                          runtime::to_code_string(e));
+          }
+        }
+      }
+    } };
+  }
+
+  void reloader::unwatch()
+  {
+    {
+      std::lock_guard<std::mutex> const lock{ watch_mutex };
+      is_watching = false;
+    }
+    watch_cv.notify_all();
+    /* The callback may stop the watcher it's called from, which can't wait for itself. */
+    if(watcher.joinable() && watcher.get_id() == std::this_thread::get_id())
+    {
+      watcher.detach();
+    }
+    else if(watcher.joinable())
+    {
+      watcher.join();
+    }
+  }
+}
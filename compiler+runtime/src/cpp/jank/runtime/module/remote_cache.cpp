@@ -0,0 +1,462 @@
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include <jank/runtime/module/remote_cache.hpp>
+#include <jank/util/cli.hpp>
+#include <jank/util/environment.hpp>
+#include <jank/util/fmt.hpp>
+#include <jank/util/scope_exit.hpp>
+#include <jank/util/sha256.hpp>
+#include <jank/error/report.hpp>
+
+namespace jank::runtime::module
+{
+  static char const *store_dir(remote_cache::store const s)
+  {
+    return s == remote_cache::store::action ? "ac" : "cas";
+  }
+
+  jtl::option<jtl::immutable_string>
+  remote_cache::get(store const s, jtl::immutable_string const &key)
+  {
+    if(unreachable.load(std::memory_order_relaxed))
+    {
+      return none;
+    }
+
+    auto res{ read(s, key) };
+    if(res.is_err())
+    {
+      fail(res.expect_err());
+      return none;
+    }
+    return res.expect_ok();
+  }
+
+  void remote_cache::put(store const s,
+                         jtl::immutable_string const &key,
+                         jtl::immutable_string const &data)
+  {
+    if(unreachable.load(std::memory_order_relaxed))
+    {
+      return;
+    }
+
+    auto const res{ write(s, key, data) };
+    if(res.is_err())
+    {
+      fail(res.expect_err());
+    }
+  }
+
+  void remote_cache::fail(jtl::immutable_string const &message)
+  {
+    if(!unreachable.exchange(true))
+    {
+      error::warn(
+        util::format("The remote cache won't be used for the rest of this run. {}", message));
+    }
+  }
+
+  static jtl::option<jtl::immutable_string> read_binary_file(std::filesystem::path const &path)
+  {
+    std::ifstream ifs{ path, std::ios::binary };
+    if(!ifs)
+    {
+      return none;
+    }
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+    if(!ifs && !ifs.eof())
+    {
+      return none;
+    }
+    auto const data{ ss.str() };
+    return jtl::immutable_string{ data.data(), data.size() };
+  }
+
+  /* Other processes, possibly on other machines, may be reading the same path, so we
+   * write to the side and then rename, which never shows a partial file. */
+  static bool write_binary_file(std::filesystem::path const &path, jtl::immutable_string const &data)
+  {
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+
+    auto tmp_path{ path };
+    tmp_path += util::format(".tmp-{}", getpid()).c_str();
+    {
+      std::ofstream ofs{ tmp_path, std::ios::binary | std::ios::trunc };
+      ofs.write(data.data(), static_cast<std::streamsize>(data.size()));
+      if(!ofs)
+      {
+        std::filesystem::remove(tmp_path, ec);
+        return false;
+      }
+    }
+    std::filesystem::rename(tmp_path, path, ec);
+    if(ec)
+    {
+      std::filesystem::remove(tmp_path, ec);
+      return false;
+    }
+    return true;
+  }
+
+  struct directory_cache : remote_cache
+  {
+    directory_cache(std::filesystem::path root)
+      : root{ std::move(root) }
+    {
+    }
+
+    jtl::string_result<jtl::option<jtl::immutable_string>>
+    read(store const s, jtl::immutable_string const &key) override
+    {
+      auto const path{ root / store_dir(s) / key.c_str() };
+      if(!std::filesystem::exists(path))
+      {
+        if(!std::filesystem::is_directory(root))
+        {
+          return err(util::format("The directory '{}' doesn't exist.", root.native()));
+        }
+        return ok(none);
+      }
+      return ok(read_binary_file(path));
+    }
+
+    jtl::string_result<void>
+    write(store const s, jtl::immutable_string const &key, jtl::immutable_string const &data)
+      override
+    {
+      if(!write_binary_file(root / store_dir(s) / key.c_str(), data))
+      {
+        return err(util::format("Unable to write to '{}'.", root.native()));
+      }
+      return ok();
+    }
+
+    std::filesystem::path root;
+  };
+
+  /* This speaks just enough HTTP/1.1 for a cache server. There's one connection for each
+   * request, since binaries are only fetched for modules which would otherwise need to be
+   * compiled, which takes far longer than connecting. */
+  struct http_cache : remote_cache
+  {
+    http_cache(jtl::immutable_string host, jtl::immutable_string port, jtl::immutable_string prefix)
+      : host{ std::move(host) }
+      , port{ std::move(port) }
+      , prefix{ std::move(prefix) }
+    {
+    }
+
+    struct response
+    {
+      int status{};
+      jtl::immutable_string body;
+    };
+
+    jtl::string_result<int> connect_to_server() const
+    {
+      addrinfo hints{};
+      hints.ai_family = AF_UNSPEC;
+      hints.ai_socktype = SOCK_STREAM;
+      addrinfo *addresses{};
+      if(auto const res = getaddrinfo(host.c_str(), port.c_str(), &hints, &addresses); res != 0)
+      {
+        return err(util::format("Unable to resolve '{}': {}", host, gai_strerror(res)));
+      }
+      util::scope_exit const free_addresses{ [=] { freeaddrinfo(addresses); } };
+
+      for(auto address{ addresses }; address; address = address->ai_next)
+      {
+        auto const fd{ socket(address->ai_family, address->ai_socktype, address->ai_protocol) };
+        if(fd < 0)
+        {
+          continue;
+        }
+
+        timeval const timeout{ .tv_sec = 30, .tv_usec = 0 };
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        if(connect(fd, address->ai_addr, address->ai_addrlen) == 0)
+        {
+          return ok(fd);
+        }
+        close(fd);
+      }
+      return err(util::format("Unable to connect to {}:{}.", host, port));
+    }
+
+    static bool send_all(int const fd, char const *data, usize size)
+    {
+      while(size != 0)
+      {
+        auto const sent{ send(fd, data, size, MSG_NOSIGNAL) };
+        if(sent <= 0)
+        {
+          return false;
+        }
+        data += sent;
+        size -= static_cast<usize>(sent);
+      }
+      return true;
+    }
+
+    static jtl::option<jtl::immutable_string> decode_chunked(std::string_view body)
+    {
+      std::string ret;
+      while(true)
+      {
+        auto const line_end{ body.find("\r\n") };
+        if(line_end == std::string_view::npos)
+        {
+          return none;
+        }
+        usize size{};
+        std::istringstream{ std::string{ body.substr(0, line_end) } } >> std::hex >> size;
+        body.remove_prefix(line_end + 2);
+        if(size == 0)
+        {
+          return jtl::immutable_string{ ret.data(), ret.size() };
+        }
+        if(body.size() < size + 2)
+        {
+          return none;
+        }
+        ret.append(body.substr(0, size));
+        body.remove_prefix(size + 2);
+      }
+    }
+
+    jtl::string_result<response> request(char const * const method,
+                                          store const s,
+                                          jtl::immutable_string const &key,
+                                          jtl::immutable_string const &body) const
+    {
+      auto const fd{ connect_to_server() };
+      if(fd.is_err())
+      {
+        return err(fd.expect_err());
+      }
+      util::scope_exit const close_fd{ [&] { close(fd.expect_ok()); } };
+
+      auto const head{ util::format("{} {}/{}/{} HTTP/1.1\r\n"
+                                    "Host: {}\r\n"
+                                    "Content-Length: {}\r\n"
+                                    "Connection: close\r\n\r\n",
+                                    method,
+                                    prefix,
+                                    store_dir(s),
+                                    key,
+                                    host,
+                                    body.size()) };
+      if(!send_all(fd.expect_ok(), head.data(), head.size())
+         || !send_all(fd.expect_ok(), body.data(), body.size()))
+      {
+        return err(util::format("Unable to send a request to {}:{}.", host, port));
+      }
+
+      /* We asked the server to close the connection, so the response is everything it
+       * sends until then. */
+      std::string received;
+      std::array<char, 64 * 1024> buffer{};
+      while(true)
+      {
+        auto const n{ recv(fd.expect_ok(), buffer.data(), buffer.size(), 0) };
+        if(n < 0)
+        {
+          return err(util::format("Unable to read a response from {}:{}.", host, port));
+        }
+        if(n == 0)
+        {
+          break;
+        }
+        received.append(buffer.data(), static_cast<usize>(n));
+      }
+
+      auto const header_end{ received.find("\r\n\r\n") };
+      int status{};
+      if(header_end == std::string::npos
+         || std::sscanf(received.c_str(), "HTTP/%*d.%*d %d", &status) != 1)
+      {
+        return err(util::format("Received a malformed response from {}:{}.", host, port));
+      }
+
+      std::string_view const headers{ received.data(), header_end };
+      std::string_view const payload{ received.data() + header_end + 4,
+                                      received.size() - header_end - 4 };
+      std::string lowered_headers{ headers };
+      std::ranges::transform(lowered_headers, lowered_headers.begin(), [](unsigned char const c) {
+        return std::tolower(c);
+      });
+      if(lowered_headers.find("transfer-encoding: chunked") != std::string::npos)
+      {
+        auto const decoded{ decode_chunked(payload) };
+        if(decoded.is_none())
+        {
+          return err(util::format("Received a malformed response from {}:{}.", host, port));
+        }
+        return ok(response{ status, decoded.unwrap() });
+      }
+      return ok(response{ status, jtl::immutable_string{ payload.data(), payload.size() } });
+    }
+
+    jtl::string_result<jtl::option<jtl::immutable_string>>
+    read(store const s, jtl::immutable_string const &key) override
+    {
+      auto const res{ request("GET", s, key, "") };
+      if(res.is_err())
+      {
+        return err(res.expect_err());
+      }
+
+      auto const &r{ res.expect_ok() };
+      if(r.status == 404)
+      {
+        return ok(none);
+      }
+      else if(r.status != 200)
+      {
+        return err(util::format("{}:{} responded with {}.", host, port, r.status));
+      }
+      return ok(r.body);
+    }
+
+    jtl::string_result<void>
+    write(store const s, jtl::immutable_string const &key, jtl::immutable_string const &data)
+      override
+    {
+      auto const res{ request("PUT", s, key, data) };
+      if(res.is_err())
+      {
+        return err(res.expect_err());
+      }
+
+      auto const status{ res.expect_ok().status };
+      if(status < 200 || status >= 300)
+      {
+        return err(util::format("{}:{} responded with {}.", host, port, status));
+      }
+      return ok();
+    }
+
+    jtl::immutable_string host;
+    jtl::immutable_string port;
+    jtl::immutable_string prefix;
+  };
+
+  std::unique_ptr<remote_cache> make_remote_cache(jtl::immutable_string const &url)
+  {
+    static constexpr std::string_view http_scheme{ "http://" };
+    static constexpr std::string_view file_scheme{ "file://" };
+
+    std::string_view rest{ url.data(), url.size() };
+    if(rest.starts_with(http_scheme))
+    {
+      rest.remove_prefix(http_scheme.size());
+      auto const path_start{ std::min(rest.find('/'), rest.size()) };
+      auto const authority{ rest.substr(0, path_start) };
+      auto prefix{ rest.substr(path_start) };
+      while(prefix.ends_with('/'))
+      {
+        prefix.remove_suffix(1);
+      }
+
+      auto const port_start{ authority.rfind(':') };
+      if(port_start == std::string_view::npos)
+      {
+        return std::make_unique<http_cache>(std::string{ authority }, "80", std::string{ prefix });
+      }
+      return std::make_unique<http_cache>(std::string{ authority.substr(0, port_start) },
+                                          std::string{ authority.substr(port_start + 1) },
+                                          std::string{ prefix });
+    }
+
+    if(rest.starts_with(file_scheme))
+    {
+      rest.remove_prefix(file_scheme.size());
+    }
+    return std::make_unique<directory_cache>(std::filesystem::path{ rest });
+  }
+
+  remote_cache *configured_remote_cache()
+  {
+    static auto const cache{ util::cli::opts.remote_cache.empty()
+                               ? nullptr
+                               : make_remote_cache(util::cli::opts.remote_cache) };
+    return cache.get();
+  }
+
+  bool is_remote_cache_writable()
+  {
+    return configured_remote_cache() && !util::cli::opts.remote_cache_read_only;
+  }
+
+  static jtl::immutable_string pch_action_key(jtl::immutable_string const &binary_version)
+  {
+    return util::sha256(util::format("incremental.pch\n{}", binary_version));
+  }
+
+  static std::filesystem::path pch_path(jtl::immutable_string const &binary_version)
+  {
+    return util::format("{}/incremental.pch", util::user_cache_dir(binary_version)).c_str();
+  }
+
+  jtl::option<jtl::immutable_string> fetch_remote_pch(jtl::immutable_string const &binary_version)
+  {
+    auto const remote{ configured_remote_cache() };
+    if(!remote)
+    {
+      return none;
+    }
+
+    auto const digest{ remote->get(remote_cache::store::action, pch_action_key(binary_version)) };
+    if(digest.is_none())
+    {
+      return none;
+    }
+    auto const pch{ remote->get(remote_cache::store::content, digest.unwrap()) };
+    if(pch.is_none() || util::sha256(pch.unwrap()) != digest.unwrap())
+    {
+      return none;
+    }
+
+    auto const path{ pch_path(binary_version) };
+    if(!write_binary_file(path, pch.unwrap()))
+    {
+      return none;
+    }
+    return jtl::immutable_string{ path.c_str() };
+  }
+
+  void publish_remote_pch(jtl::immutable_string const &binary_version,
+                          jtl::immutable_string const &path)
+  {
+    if(!is_remote_cache_writable())
+    {
+      return;
+    }
+
+    auto const pch{ read_binary_file(path.c_str()) };
+    if(pch.is_none())
+    {
+      return;
+    }
+
+    auto const remote{ configured_remote_cache() };
+    auto const digest{ util::sha256(pch.unwrap()) };
+    remote->put(remote_cache::store::content, digest, pch.unwrap());
+    remote->put(remote_cache::store::action, pch_action_key(binary_version), digest);
+  }
+}
@@ -25,7 +25,7 @@ namespace jank::runtime
     obj::symbol_ref unqualified_sym{ sym };
     if(!unqualified_sym->ns.empty())
     {
-      unqualified_sym = make_box<obj::symbol>("", sym->name);
+      unqualified_sym = __rt_ctx->intern_symbol("", sym->name);
     }
 
     /* TODO: Read lock, then upgrade as needed? Benchmark. */
@@ -40,9 +40,41 @@ namespace jank::runtime
     auto const new_var(make_box<var>(this, unqualified_sym));
     *locked_vars
       = make_box<obj::persistent_hash_map>((*locked_vars)->data.set(unqualified_sym, new_var));
+    __rt_ctx->names.add_var(new_var);
     return new_var;
   }
 
+  native_vector<var_ref> ns::intern_vars(native_vector<obj::symbol_ref> const &syms)
+  {
+    native_vector<var_ref> ret;
+    ret.reserve(syms.size());
+
+    auto locked_vars(vars.wlock());
+    auto transient((*locked_vars)->data.transient());
+    for(auto const sym : syms)
+    {
+      obj::symbol_ref unqualified_sym{ sym };
+      if(!unqualified_sym->ns.empty())
+      {
+        unqualified_sym = __rt_ctx->intern_symbol("", sym->name);
+      }
+
+      object_ref const * const found_var(transient.find(unqualified_sym));
+      if(found_var && found_var->is_some())
+      {
+        ret.emplace_back(expect_object<var>(*found_var));
+        continue;
+      }
+
+      auto const new_var(make_box<var>(this, unqualified_sym));
+      transient.set(unqualified_sym, new_var);
+      __rt_ctx->names.add_var(new_var);
+      ret.emplace_back(new_var);
+    }
+    *locked_vars = make_box<obj::persistent_hash_map>(std::move(transient).persistent());
+    return ret;
+  }
+
   var_ref ns::intern_owned_var(jtl::immutable_string_view const &name)
   {
     return intern_owned_var(make_box<obj::symbol>(name));
@@ -64,7 +96,7 @@ namespace jank::runtime
     obj::symbol_ref unqualified_sym{ sym };
     if(!unqualified_sym->ns.empty())
     {
-      unqualified_sym = make_box<obj::symbol>("", sym->name);
+      unqualified_sym = __rt_ctx->intern_symbol("", sym->name);
     }
 
     /* TODO: Read lock, then upgrade as needed? Benchmark. */
@@ -95,6 +127,7 @@ namespace jank::runtime
     }
     *locked_vars
       = make_box<obj::persistent_hash_map>((*locked_vars)->data.set(unqualified_sym, new_var));
+    __rt_ctx->names.add_var(new_var);
     return new_var;
   }
 
@@ -106,6 +139,11 @@ namespace jank::runtime
     }
 
     auto locked_vars(vars.wlock());
+    object_ref const * const found_var((*locked_vars)->data.find(sym));
+    if(found_var && found_var->is_some())
+    {
+      __rt_ctx->names.remove_var(expect_object<var>(*found_var));
+    }
     *locked_vars = make_box<obj::persistent_hash_map>((*locked_vars)->data.erase(sym));
     return ok();
   }
@@ -117,14 +155,58 @@ namespace jank::runtime
       return __rt_ctx->find_var(sym);
     }
 
-    auto const locked_vars(vars.rlock());
-    auto const found((*locked_vars)->data.find(sym));
-    if(!found)
+    var_ref found_var;
+    {
+      auto const locked_vars(vars.rlock());
+      auto const found((*locked_vars)->data.find(sym));
+      if(!found)
+      {
+        return {};
+      }
+      found_var = expect_object<var>(*found);
+    }
+
+    /* The var may have been referred from another ns, so it's that ns's segment which
+     * needs to be loaded. */
+    if(found_var->n->has_segments.load(std::memory_order_acquire)) [[unlikely]]
     {
-      return {};
+      found_var->n->load_segment_of(found_var->name);
     }
+    return found_var;
+  }
+
+  void ns::defer_segment(jtl::immutable_string const &module,
+                         native_vector<obj::symbol_ref> const &syms)
+  {
+    intern_vars(syms);
 
-    return { expect_object<var>(*found) };
+    auto locked_segments(segments.wlock());
+    for(auto const sym : syms)
+    {
+      locked_segments->emplace(__rt_ctx->intern_symbol("", sym->name), module);
+    }
+    has_segments.store(true, std::memory_order_release);
+  }
+
+  /* The segment is taken out before it's loaded, so that resolving its own vars while
+   * it's being loaded doesn't try to load it again. */
+  void ns::load_segment_of(obj::symbol_ref const sym)
+  {
+    jtl::immutable_string segment;
+    {
+      auto locked_segments(segments.wlock());
+      auto const found(locked_segments->find(sym));
+      if(found == locked_segments->end())
+      {
+        return;
+      }
+
+      segment = found->second;
+      std::erase_if(*locked_segments, [&](auto const &entry) { return entry.second == segment; });
+      has_segments.store(!locked_segments->empty(), std::memory_order_release);
+    }
+
+    __rt_ctx->load_module(util::format("/{}", segment), module::origin::latest).expect_ok();
   }
 
   jtl::result<void, jtl::immutable_string>
@@ -194,6 +276,56 @@ namespace jank::runtime
     return *locked_vars;
   }
 
+  native_vector<std::pair<jtl::immutable_string, object_ref>>
+  ns::completions(jtl::immutable_string const &prefix, usize const max) const
+  {
+    native_vector<std::pair<jtl::immutable_string, object_ref>> ret;
+
+    auto const slash(prefix.find('/'));
+    if(!prefix.starts_with(':') && slash != jtl::immutable_string::npos && 0 < slash)
+    {
+      jtl::immutable_string const alias{ prefix.data(), slash };
+      jtl::immutable_string const name{ prefix.data() + slash + 1, prefix.size() - slash - 1 };
+      auto const aliased(find_alias(make_box<obj::symbol>(alias)));
+      auto const target(aliased.is_some() ? aliased->name->name : alias);
+      for(auto const o : __rt_ctx->names.complete(util::format("{}/{}", target, name), max))
+      {
+        ret.emplace_back(util::format("{}/{}", alias, expect_object<var>(o)->name->name), o);
+      }
+      return ret;
+    }
+
+    /* We take a snapshot of the mappings, since the index is locked while it's filtering and
+     * interning a var locks the mappings before the index. */
+    auto const mappings(get_mappings());
+    auto const visible([&](object_ref const o) {
+      if(o->type != object_type::var)
+      {
+        return true;
+      }
+      auto const v(expect_object<var>(o));
+      auto const found(mappings->data.find(v->name));
+      return found && *found == v;
+    });
+
+    for(auto const o : __rt_ctx->names.complete(prefix, max, visible))
+    {
+      switch(o->type)
+      {
+        case object_type::ns:
+          ret.emplace_back(expect_object<ns>(o)->name->name, o);
+          break;
+        case object_type::var:
+          ret.emplace_back(expect_object<var>(o)->name->name, o);
+          break;
+        default:
+          ret.emplace_back(runtime::to_string(o), o);
+          break;
+      }
+    }
+    return ret;
+  }
+
   bool ns::equal(object const &o) const
   {
     if(o.type != object_type::ns)
@@ -215,6 +347,11 @@ namespace jank::runtime
     return to_string();
   }
 
+  void ns::to_code_string(jtl::string_builder &buff) const
+  {
+    to_string(buff);
+  }
+
   void ns::to_string(jtl::string_builder &buff) const
   {
     name->to_string(buff);
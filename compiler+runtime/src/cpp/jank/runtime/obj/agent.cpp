@@ -0,0 +1,391 @@
+#include <thread>
+
+#include <jank/runtime/obj/agent.hpp>
+#include <jank/runtime/obj/cons.hpp>
+#include <jank/runtime/obj/keyword.hpp>
+#include <jank/runtime/behavior/callable.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core.hpp>
+#include <jank/runtime/core/equal.hpp>
+#include <jank/runtime/executor.hpp>
+#include <jank/util/fmt.hpp>
+
+namespace jank::runtime::obj
+{
+  /* The most actions a batch will run before giving its thread back to the executor. */
+  static constexpr usize batch_quantum{ 64 };
+
+  struct pending_send
+  {
+    agent_ref target;
+    agent::action *act{};
+  };
+
+  /* Set while an action is running on this thread, so the sends it makes can be held. */
+  static thread_local native_vector<pending_send> *pending_sends{};
+  static std::atomic_bool is_shutdown{};
+
+  static object_ref fail_keyword()
+  {
+    static auto const ret{ __rt_ctx->intern_keyword("fail").expect_ok() };
+    return ret;
+  }
+
+  static object_ref continue_keyword()
+  {
+    static auto const ret{ __rt_ctx->intern_keyword("continue").expect_ok() };
+    return ret;
+  }
+
+  static var_ref agent_var()
+  {
+    static auto const ret{ __rt_ctx->find_var("clojure.core", "*agent*") };
+    return ret;
+  }
+
+  agent::agent(object_ref const state)
+    : state{ state.data }
+    , error_mode{ fail_keyword() }
+    , watches{ persistent_hash_map::empty() }
+  {
+  }
+
+  bool agent::equal(object const &o) const
+  {
+    return &o == &base;
+  }
+
+  jtl::immutable_string agent::to_string() const
+  {
+    jtl::string_builder buff;
+    to_string(buff);
+    return buff.release();
+  }
+
+  void agent::to_string(jtl::string_builder &buff) const
+  {
+    util::format_to(buff, "#object [{} {}]", object_type_str(base.type), &base);
+  }
+
+  jtl::immutable_string agent::to_code_string() const
+  {
+    return to_string();
+  }
+
+  void agent::to_code_string(jtl::string_builder &buff) const
+  {
+    to_string(buff);
+  }
+
+  uhash agent::to_hash() const
+  {
+    return static_cast<uhash>(reinterpret_cast<uintptr_t>(this));
+  }
+
+  object_ref agent::deref() const
+  {
+    return state.load(std::memory_order_acquire);
+  }
+
+  void agent::add_watch(object_ref const key, object_ref const fn)
+  {
+    auto locked_watches(watches.wlock());
+    *locked_watches = (*locked_watches)->assoc(key, fn);
+  }
+
+  void agent::remove_watch(object_ref const key)
+  {
+    auto locked_watches(watches.wlock());
+    *locked_watches = (*locked_watches)->dissoc(key);
+  }
+
+  void agent::dispatch(object_ref const fn, object_ref const args, executor &e)
+  {
+    if(is_shutdown.load(std::memory_order_relaxed))
+    {
+      throw std::runtime_error{ "Unable to send to an agent after shutdown-agents." };
+    }
+    {
+      std::lock_guard<std::mutex> const lock{ error_mutex };
+      if(error.is_some())
+      {
+        /* This is thrown as an object, so senders can catch it from jank. */
+        throw make_box(
+          util::format("Agent is failed, needs restart: {}", runtime::to_code_string(error)))
+          .erase();
+      }
+    }
+
+    auto const act{ new(GC) action{ fn, args, __rt_ctx->get_thread_bindings(), &e } };
+    if(pending_sends)
+    {
+      pending_sends->emplace_back(pending_send{ this, act });
+      return;
+    }
+    enqueue(act);
+  }
+
+  usize agent::release_pending_sends()
+  {
+    if(!pending_sends)
+    {
+      return 0;
+    }
+
+    native_vector<pending_send> sends;
+    sends.swap(*pending_sends);
+    for(auto const &send : sends)
+    {
+      send.target->enqueue(send.act);
+    }
+    return sends.size();
+  }
+
+  void agent::shutdown()
+  {
+    is_shutdown.store(true);
+  }
+
+  void agent::enqueue(action * const act)
+  {
+    auto head{ incoming.load(std::memory_order_relaxed) };
+    do
+    {
+      act->next = head;
+    }
+    while(!incoming.compare_exchange_weak(head, act));
+    schedule();
+  }
+
+  void agent::schedule()
+  {
+    while(true)
+    {
+      /* Someone else already has a batch going, which will pick up anything new. */
+      if(scheduled.exchange(true))
+      {
+        return;
+      }
+
+      take_incoming();
+      if(backlog != nullptr && !is_failed())
+      {
+        backlog->exec->submit([self = agent_ref{ this }] { self->run_batch(); });
+        return;
+      }
+
+      scheduled.store(false);
+      /* An action may have been pushed after we took them, but before we let go of the
+       * flag, in which case its sender will have seen us holding it and left it to us. */
+      if(incoming.load() == nullptr || is_failed())
+      {
+        return;
+      }
+    }
+  }
+
+  void agent::take_incoming()
+  {
+    auto head{ incoming.exchange(nullptr) };
+    if(head == nullptr)
+    {
+      return;
+    }
+
+    /* The stack is newest first, so we reverse it onto the end of the backlog. */
+    auto const newest{ head };
+    action *oldest{};
+    while(head != nullptr)
+    {
+      auto const next{ head->next };
+      head->next = oldest;
+      oldest = head;
+      head = next;
+    }
+
+    if(backlog_tail == nullptr)
+    {
+      backlog = oldest;
+    }
+    else
+    {
+      backlog_tail->next = oldest;
+    }
+    backlog_tail = newest;
+  }
+
+  void agent::run_batch()
+  {
+    auto const exec{ backlog->exec };
+    for(usize ran{}; ran < batch_quantum && !is_failed(); ++ran)
+    {
+      if(backlog == nullptr)
+      {
+        take_incoming();
+      }
+      /* Actions sent to another executor are left for a batch on that one. */
+      if(backlog == nullptr || backlog->exec != exec)
+      {
+        break;
+      }
+
+      auto const act{ backlog };
+      backlog = act->next;
+      if(backlog == nullptr)
+      {
+        backlog_tail = nullptr;
+      }
+      run_action(*act);
+    }
+
+    scheduled.store(false);
+    schedule();
+  }
+
+  void agent::run_action(action const &act)
+  {
+    native_vector<pending_send> sends;
+    auto const previous_sends{ pending_sends };
+    pending_sends = &sends;
+
+    auto const old_state{ deref() };
+    object_ref new_state{};
+    object_ref err{};
+    try
+    {
+      auto bindings{ act.bindings };
+      if(auto const v = agent_var(); v.is_some())
+      {
+        bindings = bindings->assoc(v, this);
+      }
+      context::binding_scope const scope{ bindings };
+      new_state = apply_to(act.fn, old_state, act.args);
+    }
+    catch(std::exception const &e)
+    {
+      err = make_box(e.what());
+    }
+    catch(object_ref const e)
+    {
+      err = e;
+    }
+    pending_sends = previous_sends;
+
+    if(err.is_some())
+    {
+      /* Sends from a failed action are dropped, as in Clojure. */
+      handle_error(err);
+      return;
+    }
+
+    state.store(new_state.data, std::memory_order_release);
+    {
+      auto const locked_watches(watches.rlock());
+      for(auto const &entry : (*locked_watches)->data)
+      {
+        dynamic_call(entry.second, entry.first, this, old_state, new_state);
+      }
+    }
+
+    for(auto const &send : sends)
+    {
+      send.target->enqueue(send.act);
+    }
+  }
+
+  void agent::handle_error(object_ref const err)
+  {
+    object_ref handler{};
+    {
+      std::lock_guard<std::mutex> const lock{ error_mutex };
+      handler = error_handler;
+      if(runtime::equal(error_mode, fail_keyword()))
+      {
+        error = err;
+      }
+    }
+
+    if(handler.is_some())
+    {
+      try
+      {
+        dynamic_call(handler, this, err);
+      }
+      /* A failing handler has nowhere left to report to. */
+      catch(...)
+      {
+      }
+    }
+  }
+
+  bool agent::is_failed() const
+  {
+    std::lock_guard<std::mutex> const lock{ error_mutex };
+    return error.is_some();
+  }
+
+  object_ref agent::get_error() const
+  {
+    std::lock_guard<std::mutex> const lock{ error_mutex };
+    return error;
+  }
+
+  void agent::restart(object_ref const new_state, bool const clear_actions)
+  {
+    /* We take the scheduled flag, so no batch can be running while we change things.
+     * A failed agent will only ever have it held briefly. */
+    while(scheduled.exchange(true))
+    {
+      std::this_thread::yield();
+    }
+
+    {
+      std::lock_guard<std::mutex> const lock{ error_mutex };
+      if(error.is_nil())
+      {
+        scheduled.store(false);
+        throw std::runtime_error{ "Agent does not need a restart." };
+      }
+      state.store(new_state.data, std::memory_order_release);
+      error = {};
+    }
+
+    if(clear_actions)
+    {
+      incoming.store(nullptr);
+      backlog = backlog_tail = nullptr;
+    }
+
+    scheduled.store(false);
+    schedule();
+  }
+
+  object_ref agent::get_error_handler() const
+  {
+    std::lock_guard<std::mutex> const lock{ error_mutex };
+    return error_handler;
+  }
+
+  void agent::set_error_handler(object_ref const fn)
+  {
+    std::lock_guard<std::mutex> const lock{ error_mutex };
+    error_handler = fn;
+  }
+
+  object_ref agent::get_error_mode() const
+  {
+    std::lock_guard<std::mutex> const lock{ error_mutex };
+    return error_mode;
+  }
+
+  void agent::set_error_mode(object_ref const mode)
+  {
+    if(!runtime::equal(mode, fail_keyword()) && !runtime::equal(mode, continue_keyword()))
+    {
+      throw std::runtime_error{ util::format("Invalid agent error mode: {}",
+                                             runtime::to_code_string(mode)) };
+    }
+    std::lock_guard<std::mutex> const lock{ error_mutex };
+    error_mode = mode;
+  }
+}
@@ -0,0 +1,560 @@
+#include <cstring>
+#include <memory>
+
+#include <gc/gc.h>
+
+#include <jank/runtime/obj/array.hpp>
+#include <jank/runtime/obj/character.hpp>
+#include <jank/runtime/obj/keyword.hpp>
+#include <jank/runtime/obj/symbol.hpp>
+#include <jank/runtime/obj/number.hpp>
+#include <jank/runtime/obj/primitive_vector.hpp>
+#include <jank/runtime/obj/nil.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/math.hpp>
+#include <jank/runtime/core/seq.hpp>
+#include <jank/runtime/core/seq_ext.hpp>
+#include <jank/runtime/core/to_string.hpp>
+#include <jank/runtime/core/truthy.hpp>
+#include <jank/runtime/rtti.hpp>
+#include <jank/util/fmt.hpp>
+
+namespace jank::runtime::obj
+{
+  static char const *element_type_str(array::element_type const element)
+  {
+    switch(element)
+    {
+      case array::element_type::object:
+        return "object";
+      case array::element_type::boolean:
+        return "boolean";
+      case array::element_type::byte:
+        return "byte";
+      case array::element_type::short_:
+        return "short";
+      case array::element_type::char_:
+        return "char";
+      case array::element_type::int_:
+        return "int";
+      case array::element_type::long_:
+        return "long";
+      case array::element_type::float_:
+        return "float";
+      case array::element_type::double_:
+        return "double";
+    }
+    return "unknown";
+  }
+
+  /* Char arrays hold code points, so each element is one character, no matter how many
+   * bytes it takes in UTF-8. */
+  static char32_t decode_char(object_ref const o)
+  {
+    auto const &bytes(try_object<character>(o)->data);
+    auto const lead(static_cast<u8>(bytes[0]));
+    usize extra{};
+    char32_t code{};
+    if(lead < 0x80)
+    {
+      return lead;
+    }
+    else if((lead & 0xE0) == 0xC0)
+    {
+      extra = 1;
+      code = lead & 0x1F;
+    }
+    else if((lead & 0xF0) == 0xE0)
+    {
+      extra = 2;
+      code = lead & 0x0F;
+    }
+    else
+    {
+      extra = 3;
+      code = lead & 0x07;
+    }
+
+    for(usize i{ 1 }; i <= extra && i < bytes.size(); ++i)
+    {
+      code = (code << 6) | (static_cast<u8>(bytes[i]) & 0x3F);
+    }
+    return code;
+  }
+
+  static object_ref encode_char(char32_t const code)
+  {
+    char bytes[4]{};
+    usize size{};
+    if(code < 0x80)
+    {
+      bytes[size++] = static_cast<char>(code);
+    }
+    else if(code < 0x800)
+    {
+      bytes[size++] = static_cast<char>(0xC0 | (code >> 6));
+      bytes[size++] = static_cast<char>(0x80 | (code & 0x3F));
+    }
+    else if(code < 0x10000)
+    {
+      bytes[size++] = static_cast<char>(0xE0 | (code >> 12));
+      bytes[size++] = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+      bytes[size++] = static_cast<char>(0x80 | (code & 0x3F));
+    }
+    else
+    {
+      bytes[size++] = static_cast<char>(0xF0 | (code >> 18));
+      bytes[size++] = static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+      bytes[size++] = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+      bytes[size++] = static_cast<char>(0x80 | (code & 0x3F));
+    }
+    return make_box<character>(jtl::immutable_string{ bytes, size });
+  }
+
+  static usize to_length(object_ref const o)
+  {
+    auto const length(to_int(o));
+    if(length < 0)
+    {
+      throw std::runtime_error{ util::format("negative array size: {}", length) };
+    }
+    return static_cast<usize>(length);
+  }
+
+  static usize to_index(array const &a, object_ref const o)
+  {
+    auto const index(to_int(o));
+    if(index < 0 || a.length <= static_cast<usize>(index))
+    {
+      throw std::runtime_error{ util::format("index {} is out of bounds for an array of length {}",
+                                             index,
+                                             a.length) };
+    }
+    return static_cast<usize>(index);
+  }
+
+  array::array(element_type const element, usize const length)
+    : element{ element }
+    , length{ length }
+  {
+    if(length == 0)
+    {
+      return;
+    }
+
+    if(element == element_type::object)
+    {
+      auto const refs(static_cast<object_ref *>(GC_MALLOC(length * sizeof(object_ref))));
+      std::uninitialized_fill_n(refs, length, jank_nil());
+      data = refs;
+      return;
+    }
+
+    /* The GC only promises 16 byte alignment, so we over allocate and align within that.
+     * Interior pointers keep the whole allocation alive. */
+    auto const size(length * element_size(element));
+    auto const raw(GC_MALLOC_ATOMIC(size + alignment - 1));
+    if(!raw)
+    {
+      throw std::bad_alloc{};
+    }
+    auto const aligned((reinterpret_cast<uintptr_t>(raw) + alignment - 1) & ~(alignment - 1));
+    data = reinterpret_cast<void *>(aligned);
+    std::memset(data, 0, size);
+  }
+
+  array::array(element_type const element, void * const borrowed, usize const length)
+    : element{ element }
+    , length{ length }
+    , data{ borrowed }
+  {
+  }
+
+  array::element_type array::parse_element_type(object_ref const type)
+  {
+    jtl::immutable_string name;
+    if(type->type == object_type::keyword)
+    {
+      name = expect_object<keyword>(type)->sym->name;
+    }
+    else if(type->type == object_type::symbol)
+    {
+      name = expect_object<symbol>(type)->name;
+    }
+
+    if(name == "object")
+    {
+      return element_type::object;
+    }
+    else if(name == "boolean")
+    {
+      return element_type::boolean;
+    }
+    else if(name == "byte")
+    {
+      return element_type::byte;
+    }
+    else if(name == "short")
+    {
+      return element_type::short_;
+    }
+    else if(name == "char")
+    {
+      return element_type::char_;
+    }
+    else if(name == "int")
+    {
+      return element_type::int_;
+    }
+    else if(name == "long")
+    {
+      return element_type::long_;
+    }
+    else if(name == "float")
+    {
+      return element_type::float_;
+    }
+    else if(name == "double")
+    {
+      return element_type::double_;
+    }
+
+    throw std::runtime_error{ util::format("invalid array element type: {}",
+                                           runtime::to_code_string(type)) };
+  }
+
+  usize array::element_size(element_type const element)
+  {
+    switch(element)
+    {
+      case element_type::object:
+        return sizeof(object_ref);
+      case element_type::boolean:
+        return sizeof(bool);
+      case element_type::byte:
+        return sizeof(i8);
+      case element_type::short_:
+        return sizeof(i16);
+      case element_type::char_:
+        return sizeof(char32_t);
+      case element_type::int_:
+        return sizeof(i32);
+      case element_type::long_:
+        return sizeof(i64);
+      case element_type::float_:
+        return sizeof(f32);
+      case element_type::double_:
+        return sizeof(f64);
+    }
+    return 0;
+  }
+
+  static array_ref filled_from_seq(array::element_type const element,
+                                   usize const length,
+                                   object_ref const seq)
+  {
+    auto const ret(make_box<array>(element, length));
+    usize i{};
+    for_each(seq, [&](object_ref const e) {
+      if(i < length)
+      {
+        ret->set(i++, e);
+      }
+    });
+    return ret;
+  }
+
+  array_ref array::create(object_ref const type, object_ref const size_or_seq)
+  {
+    auto const element(parse_element_type(type));
+    if(is_number(size_or_seq))
+    {
+      return make_box<array>(element, to_length(size_or_seq));
+    }
+    if(size_or_seq->type == object_type::primitive_vector)
+    {
+      return expect_object<primitive_vector>(size_or_seq)->to_array(element);
+    }
+    return filled_from_seq(element, sequence_length(size_or_seq), size_or_seq);
+  }
+
+  array_ref array::create_filled(object_ref const type,
+                                 object_ref const size,
+                                 object_ref const init_or_seq)
+  {
+    auto const element(parse_element_type(type));
+    auto const length(to_length(size));
+    if(!init_or_seq.is_nil() && !is_number(init_or_seq) && init_or_seq->type != object_type::boolean
+       && init_or_seq->type != object_type::character && is_seqable(init_or_seq))
+    {
+      return filled_from_seq(element, length, init_or_seq);
+    }
+
+    auto const ret(make_box<array>(element, length));
+    for(usize i{}; i < length; ++i)
+    {
+      ret->set(i, init_or_seq);
+    }
+    return ret;
+  }
+
+  array_ref array::make(object_ref const type, object_ref const dims)
+  {
+    auto const length(to_length(first(dims)));
+    auto const more(next(dims));
+    if(more.is_nil())
+    {
+      return make_box<array>(parse_element_type(type), length);
+    }
+
+    auto const ret(make_box<array>(element_type::object, length));
+    for(usize i{}; i < length; ++i)
+    {
+      ret->data_as<object_ref>()[i] = make(type, more);
+    }
+    return ret;
+  }
+
+  array_ref array::from_seq(object_ref const type, object_ref const coll)
+  {
+    if(coll->type == object_type::primitive_vector)
+    {
+      return expect_object<primitive_vector>(coll)->to_array(parse_element_type(type));
+    }
+    return filled_from_seq(parse_element_type(type), sequence_length(coll), coll);
+  }
+
+  object_ref array::aget(object_ref const a, object_ref const index)
+  {
+    auto const typed_a(try_object<array>(a));
+    return typed_a->get(to_index(*typed_a, index));
+  }
+
+  object_ref array::aset(object_ref const a, object_ref const index, object_ref const val)
+  {
+    auto const typed_a(try_object<array>(a));
+    typed_a->set(to_index(*typed_a, index), val);
+    return val;
+  }
+
+  object_ref array::alength(object_ref const a)
+  {
+    return make_box(static_cast<i64>(try_object<array>(a)->length));
+  }
+
+  array_ref array::aclone(object_ref const a)
+  {
+    auto const typed_a(try_object<array>(a));
+    auto const ret(make_box<array>(typed_a->element, typed_a->length));
+    if(typed_a->length != 0)
+    {
+      std::memcpy(ret->data, typed_a->data, typed_a->length * element_size(typed_a->element));
+    }
+    return ret;
+  }
+
+  bool array::equal(object const &o) const
+  {
+    return &o == &base;
+  }
+
+  jtl::immutable_string array::to_string() const
+  {
+    jtl::string_builder buff;
+    to_string(buff);
+    return buff.release();
+  }
+
+  void array::to_string(jtl::string_builder &buff) const
+  {
+    util::format_to(buff,
+                    "#object [{} {} {}]",
+                    object_type_str(base.type),
+                    element_type_str(element),
+                    &base);
+  }
+
+  jtl::immutable_string array::to_code_string() const
+  {
+    return to_string();
+  }
+
+  uhash array::to_hash() const
+  {
+    return static_cast<uhash>(reinterpret_cast<uintptr_t>(this));
+  }
+
+  native_vector_sequence_ref array::seq() const
+  {
+    return fresh_seq();
+  }
+
+  /* Seqs are a snapshot of the elements, since primitives need to be boxed anyway. */
+  native_vector_sequence_ref array::fresh_seq() const
+  {
+    if(length == 0)
+    {
+      return {};
+    }
+
+    native_vector<object_ref> elements;
+    elements.reserve(length);
+    for(usize i{}; i < length; ++i)
+    {
+      elements.emplace_back(get(i));
+    }
+    return make_box<native_vector_sequence>(jtl::move(elements));
+  }
+
+  usize array::count() const
+  {
+    return length;
+  }
+
+  object_ref array::nth(object_ref const index) const
+  {
+    return get(to_index(*this, index));
+  }
+
+  object_ref array::nth(object_ref const index, object_ref const fallback) const
+  {
+    auto const i(to_int(index));
+    if(i < 0 || length <= static_cast<usize>(i))
+    {
+      return fallback;
+    }
+    return get(static_cast<usize>(i));
+  }
+
+  template <typename T>
+  requires array::is_element<T>
+  object_ref array::box(T const e)
+  {
+    if constexpr(jtl::is_same<T, object_ref>)
+    {
+      return e;
+    }
+    else if constexpr(jtl::is_same<T, bool>)
+    {
+      return make_box(e);
+    }
+    else if constexpr(jtl::is_same<T, char32_t>)
+    {
+      return encode_char(e);
+    }
+    else if constexpr(jtl::is_same<T, f32> || jtl::is_same<T, f64>)
+    {
+      return make_box(static_cast<f64>(e));
+    }
+    else
+    {
+      return make_box(static_cast<i64>(e));
+    }
+  }
+
+  /* Integers are truncated to fit, like Java's narrowing conversions. */
+  template <typename T>
+  requires array::is_element<T>
+  T array::unbox(object_ref const o)
+  {
+    if constexpr(jtl::is_same<T, object_ref>)
+    {
+      return o;
+    }
+    else if constexpr(jtl::is_same<T, bool>)
+    {
+      return truthy(o);
+    }
+    else if constexpr(jtl::is_same<T, char32_t>)
+    {
+      return decode_char(o);
+    }
+    else if constexpr(jtl::is_same<T, f32> || jtl::is_same<T, f64>)
+    {
+      return static_cast<T>(to_real(o));
+    }
+    else
+    {
+      return static_cast<T>(to_int(o));
+    }
+  }
+
+  template object_ref array::box<object_ref>(object_ref);
+  template object_ref array::box<bool>(bool);
+  template object_ref array::box<i8>(i8);
+  template object_ref array::box<i16>(i16);
+  template object_ref array::box<char32_t>(char32_t);
+  template object_ref array::box<i32>(i32);
+  template object_ref array::box<i64>(i64);
+  template object_ref array::box<f32>(f32);
+  template object_ref array::box<f64>(f64);
+  template object_ref array::unbox<object_ref>(object_ref);
+  template bool array::unbox<bool>(object_ref);
+  template i8 array::unbox<i8>(object_ref);
+  template i16 array::unbox<i16>(object_ref);
+  template char32_t array::unbox<char32_t>(object_ref);
+  template i32 array::unbox<i32>(object_ref);
+  template i64 array::unbox<i64>(object_ref);
+  template f32 array::unbox<f32>(object_ref);
+  template f64 array::unbox<f64>(object_ref);
+
+  object_ref array::get(usize const index) const
+  {
+    switch(element)
+    {
+      case element_type::object:
+        return data_as<object_ref>()[index];
+      case element_type::boolean:
+        return box(data_as<bool>()[index]);
+      case element_type::byte:
+        return box(data_as<i8>()[index]);
+      case element_type::short_:
+        return box(data_as<i16>()[index]);
+      case element_type::char_:
+        return box(data_as<char32_t>()[index]);
+      case element_type::int_:
+        return box(data_as<i32>()[index]);
+      case element_type::long_:
+        return box(data_as<i64>()[index]);
+      case element_type::float_:
+        return box(data_as<f32>()[index]);
+      case element_type::double_:
+        return box(data_as<f64>()[index]);
+    }
+    return jank_nil();
+  }
+
+  void array::set(usize const index, object_ref const val)
+  {
+    switch(element)
+    {
+      case element_type::object:
+        data_as<object_ref>()[index] = val;
+        return;
+      case element_type::boolean:
+        data_as<bool>()[index] = unbox<bool>(val);
+        return;
+      case element_type::byte:
+        data_as<i8>()[index] = unbox<i8>(val);
+        return;
+      case element_type::short_:
+        data_as<i16>()[index] = unbox<i16>(val);
+        return;
+      case element_type::char_:
+        data_as<char32_t>()[index] = unbox<char32_t>(val);
+        return;
+      case element_type::int_:
+        data_as<i32>()[index] = unbox<i32>(val);
+        return;
+      case element_type::long_:
+        data_as<i64>()[index] = unbox<i64>(val);
+        return;
+      case element_type::float_:
+        data_as<f32>()[index] = unbox<f32>(val);
+        return;
+      case element_type::double_:
+        data_as<f64>()[index] = unbox<f64>(val);
+        return;
+    }
+  }
+}
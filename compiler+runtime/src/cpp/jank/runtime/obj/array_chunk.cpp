@@ -45,6 +45,11 @@ namespace jank::runtime::obj
     return to_string();
   }
 
+  void array_chunk::to_code_string(jtl::string_builder &buff) const
+  {
+    to_string(buff);
+  }
+
   uhash array_chunk::to_hash() const
   {
     return static_cast<uhash>(reinterpret_cast<uintptr_t>(this));
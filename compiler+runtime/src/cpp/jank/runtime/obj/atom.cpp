@@ -1,9 +1,12 @@
+#include <thread>
+
 #include <jank/runtime/behavior/callable.hpp>
 #include <jank/runtime/core.hpp>
 #include <jank/runtime/obj/atom.hpp>
 #include <jank/runtime/obj/persistent_hash_map.hpp>
 #include <jank/runtime/obj/persistent_vector.hpp>
 #include <jank/util/fmt.hpp>
+#include <jank/util/spin.hpp>
 
 namespace jank::runtime::obj
 {
@@ -35,6 +38,11 @@ namespace jank::runtime::obj
     return to_string();
   }
 
+  void atom::to_code_string(jtl::string_builder &buff) const
+  {
+    to_string(buff);
+  }
+
   uhash atom::to_hash() const
   {
     return static_cast<uhash>(reinterpret_cast<uintptr_t>(this));
@@ -58,6 +66,48 @@ namespace jank::runtime::obj
     }
   }
 
+  /* Contended swaps spin for this many attempts, backing off more each time, before
+   * they start yielding their thread between attempts. */
+  static constexpr u32 spin_attempts{ 8 };
+
+  /* Without a back off, every thread which lost a race retries right away and most of
+   * them lose again, so the atom's cache line just bounces between cores. */
+  static void back_off(u32 const attempt)
+  {
+    if(spin_attempts <= attempt)
+    {
+      std::this_thread::yield();
+      return;
+    }
+    for(u32 i{}; i < (u32{ 1 } << attempt); ++i)
+    {
+      util::spin_pause();
+    }
+  }
+
+  /* Gives the old and new values. The stats are only touched when there was contention,
+   * so an uncontended swap costs nothing extra. */
+  template <typename F>
+  static std::pair<object_ref, object_ref> swap_with(atom &a, F const &f)
+  {
+    for(u32 attempt{};; ++attempt)
+    {
+      auto v(a.val.load());
+      auto const next(f(v));
+      if(a.val.compare_exchange_weak(v, next.data))
+      {
+        if(attempt != 0)
+        {
+          a.contended_swaps.fetch_add(1, std::memory_order_relaxed);
+          a.retries.fetch_add(attempt, std::memory_order_relaxed);
+        }
+        notify_watches(&a, v, next);
+        return { v, next };
+      }
+      back_off(attempt);
+    }
+  }
+
   object_ref atom::reset(object_ref const o)
   {
     jank_debug_assert(o.is_some());
@@ -84,109 +134,54 @@ namespace jank::runtime::obj
   /* NOLINTNEXTLINE(cppcoreguidelines-noexcept-swap,bugprone-exception-escape) */
   object_ref atom::swap(object_ref const fn)
   {
-    while(true)
-    {
-      auto v(val.load());
-      auto const next(dynamic_call(fn, v));
-      if(val.compare_exchange_weak(v, next.data))
-      {
-        notify_watches(this, v, next);
-        return next;
-      }
-    }
+    return swap_with(*this, [&](object_ref const v) { return dynamic_call(fn, v); }).second;
   }
 
   /* NOLINTNEXTLINE(cppcoreguidelines-noexcept-swap,bugprone-exception-escape) */
   object_ref atom::swap(object_ref const fn, object_ref const a1)
   {
-    while(true)
-    {
-      auto v(val.load());
-      auto const next(dynamic_call(fn, v, a1));
-      if(val.compare_exchange_weak(v, next.data))
-      {
-        notify_watches(this, v, next);
-        return next;
-      }
-    }
+    return swap_with(*this, [&](object_ref const v) { return dynamic_call(fn, v, a1); }).second;
   }
 
   /* NOLINTNEXTLINE(cppcoreguidelines-noexcept-swap,bugprone-exception-escape) */
   object_ref atom::swap(object_ref const fn, object_ref const a1, object_ref const a2)
   {
-    while(true)
-    {
-      auto v(val.load());
-      auto const next(dynamic_call(fn, v, a1, a2));
-      if(val.compare_exchange_weak(v, next.data))
-      {
-        notify_watches(this, v, next);
-        return next;
-      }
-    }
+    return swap_with(*this, [&](object_ref const v) { return dynamic_call(fn, v, a1, a2); })
+      .second;
   }
 
   object_ref
   /* NOLINTNEXTLINE(cppcoreguidelines-noexcept-swap,bugprone-exception-escape) */
   atom::swap(object_ref const fn, object_ref const a1, object_ref const a2, object_ref const rest)
   {
-    while(true)
-    {
-      auto v(val.load());
-      auto const args(runtime::cons(v, runtime::cons(a1, runtime::cons(a2, rest))));
-      auto const next(apply_to(fn, args));
-      if(val.compare_exchange_weak(v, next.data))
-      {
-        notify_watches(this, v, next);
-        return next;
-      }
-    }
+    return swap_with(*this,
+                     [&](object_ref const v) {
+                       return apply_to(fn, v, a1, a2, rest);
+                     })
+      .second;
+  }
+
+  static persistent_vector_ref to_vals(std::pair<object_ref, object_ref> const &vals)
+  {
+    return make_box<persistent_vector>(std::in_place, vals.first, vals.second);
   }
 
   persistent_vector_ref atom::swap_vals(object_ref const fn)
   {
-    while(true)
-    {
-      auto v(val.load());
-      auto const next(dynamic_call(fn, v));
-      if(val.compare_exchange_weak(v, next.data))
-      {
-        notify_watches(this, v, next);
-        auto ret{ make_box<persistent_vector>(std::in_place, v, next) };
-        return ret;
-      }
-    }
+    return to_vals(swap_with(*this, [&](object_ref const v) { return dynamic_call(fn, v); }));
   }
 
   persistent_vector_ref atom::swap_vals(object_ref const fn, object_ref const a1)
   {
-    while(true)
-    {
-      auto v(val.load());
-      auto const next(dynamic_call(fn, v, a1));
-      if(val.compare_exchange_weak(v, next.data))
-      {
-        notify_watches(this, v, next);
-        auto ret{ make_box<persistent_vector>(std::in_place, v, next) };
-        return ret;
-      }
-    }
+    return to_vals(
+      swap_with(*this, [&](object_ref const v) { return dynamic_call(fn, v, a1); }));
   }
 
   persistent_vector_ref
   atom::swap_vals(object_ref const fn, object_ref const a1, object_ref const a2)
   {
-    while(true)
-    {
-      auto v(val.load());
-      auto const next(dynamic_call(fn, v, a1, a2));
-      if(val.compare_exchange_weak(v, next.data))
-      {
-        notify_watches(this, v, next);
-        auto ret{ make_box<persistent_vector>(std::in_place, v, next) };
-        return ret;
-      }
-    }
+    return to_vals(
+      swap_with(*this, [&](object_ref const v) { return dynamic_call(fn, v, a1, a2); }));
   }
 
   persistent_vector_ref atom::swap_vals(object_ref const fn,
@@ -194,18 +189,9 @@ namespace jank::runtime::obj
                                         object_ref const a2,
                                         object_ref const rest)
   {
-    while(true)
-    {
-      auto v(val.load());
-      auto const args(runtime::cons(v, runtime::cons(a1, runtime::cons(a2, rest))));
-      auto const next(apply_to(fn, args));
-      if(val.compare_exchange_weak(v, next.data))
-      {
-        notify_watches(this, v, next);
-        auto ret{ make_box<persistent_vector>(std::in_place, v, next) };
-        return ret;
-      }
-    }
+    return to_vals(swap_with(*this, [&](object_ref const v) {
+      return apply_to(fn, v, a1, a2, rest);
+    }));
   }
 
   object_ref atom::compare_and_set(object_ref const old_val, object_ref const new_val)
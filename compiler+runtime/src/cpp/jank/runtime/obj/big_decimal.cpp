@@ -158,6 +158,12 @@ namespace jank::runtime::obj
     return to_string() + 'M';
   }
 
+  void big_decimal::to_code_string(jtl::string_builder &buff) const
+  {
+    to_string(buff);
+    buff('M');
+  }
+
   uhash big_decimal::to_hash() const
   {
     return std::hash<native_big_decimal>{}(data);
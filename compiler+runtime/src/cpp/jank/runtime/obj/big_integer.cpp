@@ -247,6 +247,11 @@ namespace jank::runtime::obj
     return to_string();
   }
 
+  void big_integer::to_code_string(jtl::string_builder &buff) const
+  {
+    to_string(buff);
+  }
+
   template <class T>
   static void hash_combine(std::size_t &seed, T const &v)
   {
@@ -254,8 +259,15 @@ namespace jank::runtime::obj
     seed ^= hasher(v) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
   }
 
+  /* Big integers are equal to integers of the same value, so those which fit in an integer
+   * hash the same way integers do. */
   uhash big_integer::to_hash(native_big_integer const &data)
   {
+    if(i64 small{}; to_small(data, small))
+    {
+      return hash::integer(small);
+    }
+
     auto const &backend{ data.backend() };
 
     auto const *limbs{ backend.limbs() };
@@ -297,8 +309,75 @@ namespace jank::runtime::obj
     return boost::multiprecision::gcd(l, r);
   }
 
+  /* We rely on boost's inline storage holding at least a 128 bit result. */
+  static_assert(native_big_integer::backend_type::internal_limb_count
+                  * boost::multiprecision::limb_bits
+                >= 128);
+
+  bool big_integer::to_small(native_big_integer const &d, i64 &out)
+  {
+    auto const &backend{ d.backend() };
+    if(backend.size() != 1)
+    {
+      return false;
+    }
+
+    u64 const limb{ *backend.limbs() };
+    if(!backend.sign())
+    {
+      if(static_cast<u64>(std::numeric_limits<i64>::max()) < limb)
+      {
+        return false;
+      }
+      out = static_cast<i64>(limb);
+      return true;
+    }
+
+    /* The magnitude of the most negative i64 is one more than the max. */
+    if(static_cast<u64>(std::numeric_limits<i64>::max()) + 1 < limb)
+    {
+      return false;
+    }
+    out = static_cast<i64>(~limb + 1);
+    return true;
+  }
+
+  native_big_integer big_integer::add(native_big_integer const &l, native_big_integer const &r)
+  {
+    i64 small_l{}, small_r{};
+    if(to_small(l, small_l) && to_small(r, small_r))
+    {
+      return native_big_integer{ static_cast<__int128>(small_l) + small_r };
+    }
+    return l + r;
+  }
+
+  native_big_integer big_integer::sub(native_big_integer const &l, native_big_integer const &r)
+  {
+    i64 small_l{}, small_r{};
+    if(to_small(l, small_l) && to_small(r, small_r))
+    {
+      return native_big_integer{ static_cast<__int128>(small_l) - small_r };
+    }
+    return l - r;
+  }
+
+  native_big_integer big_integer::mul(native_big_integer const &l, native_big_integer const &r)
+  {
+    i64 small_l{}, small_r{};
+    if(to_small(l, small_l) && to_small(r, small_r))
+    {
+      return native_big_integer{ static_cast<__int128>(small_l) * small_r };
+    }
+    return l * r;
+  }
+
   i64 big_integer::to_i64(native_big_integer const &d)
   {
+    if(i64 small{}; to_small(d, small))
+    {
+      return small;
+    }
     if(d > std::numeric_limits<i64>::max() || d < std::numeric_limits<i64>::min())
     {
       throw std::runtime_error{ "Value out of range for integer." };
@@ -313,6 +392,13 @@ namespace jank::runtime::obj
 
   f64 big_integer::to_f64(native_big_integer const &data)
   {
+    /* A single limb converts exactly as boost would, without the exception handling. */
+    if(auto const &backend{ data.backend() }; backend.size() == 1)
+    {
+      auto const magnitude{ static_cast<f64>(*backend.limbs()) };
+      return backend.sign() ? -magnitude : magnitude;
+    }
+
     try
     {
       return data.convert_to<f64>();
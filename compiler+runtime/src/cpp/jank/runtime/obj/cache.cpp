@@ -0,0 +1,663 @@
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+#include <gc/gc.h>
+#include <gc/gc_cpp.h>
+
+#include <jank/runtime/obj/cache.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
+#include <jank/runtime/behavior/callable.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core.hpp>
+#include <jank/runtime/core/equal.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/math.hpp>
+#include <jank/runtime/core/seq.hpp>
+#include <jank/runtime/rtti.hpp>
+#include <jank/util/cli.hpp>
+#include <jank/util/fmt.hpp>
+
+namespace jank::runtime
+{
+  /* Bumped each time soft caches need to be cleared. */
+  static std::atomic<u64> pressure_epoch{};
+
+  /* The number of cache locks this thread holds. Soft caches are cleared from a finalizer,
+   * which can run during any allocation, including one made while a cache is locked. So
+   * that code skips clearing whenever this thread already holds a cache lock. */
+  static thread_local usize cache_locks_held{};
+
+  namespace
+  {
+    struct cache_lock
+    {
+      cache_lock(std::mutex &m)
+        : lock{ m }
+      {
+        ++cache_locks_held;
+      }
+
+      ~cache_lock()
+      {
+        --cache_locks_held;
+      }
+
+      std::lock_guard<std::mutex> lock;
+    };
+  }
+}
+
+namespace jank::runtime::obj
+{
+  static i64 now_ns()
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+  }
+
+  /* Gives the args of the key, which are weakly held by an entry for keys within a cache
+   * with weak keys. If any of them have been collected, this gives false. */
+  static bool resolve_args(cache::key const &k,
+                           std::array<object_ref, cache::max_inline_args> &args,
+                           object_ref &rest)
+  {
+    if(!k.refs)
+    {
+      args = k.args;
+      rest = k.rest;
+      return true;
+    }
+
+    if(cache::max_inline_args < k.arity)
+    {
+      auto const found(k.refs->weak_rest.get());
+      if(found.is_none())
+      {
+        return false;
+      }
+      rest = found.unwrap();
+      return true;
+    }
+    for(u8 i{}; i < k.arity; ++i)
+    {
+      auto const found(k.refs->weak_args[i].get());
+      if(found.is_none())
+      {
+        return false;
+      }
+      args[i] = found.unwrap();
+    }
+    return true;
+  }
+
+  bool cache::key::operator==(key const &rhs) const
+  {
+    if(hash != rhs.hash || arity != rhs.arity)
+    {
+      return false;
+    }
+    /* The copy of a key in the LRU list refers to the same entry as the key in the table. */
+    if(refs && refs == rhs.refs)
+    {
+      return true;
+    }
+
+    std::array<object_ref, max_inline_args> lhs_args, rhs_args;
+    object_ref lhs_rest, rhs_rest;
+    if(!resolve_args(*this, lhs_args, lhs_rest) || !resolve_args(rhs, rhs_args, rhs_rest))
+    {
+      return false;
+    }
+
+    if(max_inline_args < arity)
+    {
+      return runtime::equal(lhs_rest, rhs_rest);
+    }
+    for(u8 i{}; i < arity; ++i)
+    {
+      if(!runtime::equal(lhs_args[i], rhs_args[i]))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  cache::cache(usize const max_size, i64 const ttl_ms)
+    : cache{ options{ .max_size = max_size, .ttl_ms = ttl_ms } }
+  {
+  }
+
+  cache::cache(options const &opts)
+    : max_size{ opts.max_size }
+    , ttl_ns{ opts.ttl_ms * 1000000 }
+    , weak_keys{ opts.weak_keys }
+    , weak_values{ opts.weak_values }
+    , soft{ opts.soft }
+    , relieved_epoch{ pressure_epoch.load() }
+  {
+    if(max_size != 0)
+    {
+      shards_in_use = std::clamp<usize>(max_size / min_shard_size, 1, shard_count);
+      max_shard_size = (max_size + shards_in_use - 1) / shards_in_use;
+    }
+  }
+
+  cache::key cache::make_key()
+  {
+    return { .arity = 0, .hash = 0 };
+  }
+
+  cache::key cache::make_key(object_ref const a)
+  {
+    return { .args = { a }, .arity = 1, .hash = hash::combine(1, runtime::to_hash(a)) };
+  }
+
+  cache::key cache::make_key(object_ref const a, object_ref const b)
+  {
+    return { .args = { a, b },
+             .arity = 2,
+             .hash = hash::combine(hash::combine(2, runtime::to_hash(a)), runtime::to_hash(b)) };
+  }
+
+  cache::key cache::make_key(object_ref const a, object_ref const b, object_ref const c)
+  {
+    auto h(hash::combine(3, runtime::to_hash(a)));
+    h = hash::combine(h, runtime::to_hash(b));
+    h = hash::combine(h, runtime::to_hash(c));
+    return { .args = { a, b, c }, .arity = 3, .hash = h };
+  }
+
+  cache::key cache::make_key_rest(object_ref const args)
+  {
+    return { .rest = args,
+             .arity = max_inline_args + 1,
+             .hash = hash::combine(max_inline_args + 1, runtime::to_hash(args)) };
+  }
+
+  bool cache::equal(object const &o) const
+  {
+    return &o == &base;
+  }
+
+  jtl::immutable_string cache::to_string() const
+  {
+    jtl::string_builder buff;
+    to_string(buff);
+    return buff.release();
+  }
+
+  void cache::to_string(jtl::string_builder &buff) const
+  {
+    util::format_to(buff, "#object [{} {}]", object_type_str(base.type), &base);
+  }
+
+  jtl::immutable_string cache::to_code_string() const
+  {
+    return to_string();
+  }
+
+  void cache::to_code_string(jtl::string_builder &buff) const
+  {
+    to_string(buff);
+  }
+
+  uhash cache::to_hash() const
+  {
+    return static_cast<uhash>(reinterpret_cast<uintptr_t>(this));
+  }
+
+  /* The shard tables bucket by the low bits of the hash, so the shard is picked with the
+   * high bits instead, after mixing them. */
+  static cache::shard &shard_for(cache &c, cache::key const &k)
+  {
+    auto const mixed{ static_cast<u32>(k.hash * 0x9e3779b1u) >> 16 };
+    return c.shards[mixed % c.shards_in_use];
+  }
+
+  static void erase_entry(cache const &c,
+                          cache::shard &s,
+                          native_unordered_map<cache::key, cache::entry, cache::key_hash>::iterator
+                            const it)
+  {
+    if(c.max_size != 0)
+    {
+      s.lru.erase(it->second.lru);
+    }
+    s.entries.erase(it);
+  }
+
+  static bool is_collected(cache const &c, cache::key const &k, cache::entry const &e)
+  {
+    if(c.weak_values && e.weak_value.is_cleared())
+    {
+      return true;
+    }
+    if(!c.weak_keys)
+    {
+      return false;
+    }
+    if(cache::max_inline_args < k.arity)
+    {
+      return e.weak_rest.is_cleared();
+    }
+    for(u8 i{}; i < k.arity; ++i)
+    {
+      if(e.weak_args[i].is_cleared())
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /* Entries whose keys have been collected can't be found anymore, so they're only removed
+   * by sweeping. */
+  static void sweep(cache &c, cache::shard &s)
+  {
+    for(auto it(s.entries.begin()); it != s.entries.end();)
+    {
+      auto const next(std::next(it));
+      if(is_collected(c, it->first, it->second))
+      {
+        erase_entry(c, s, it);
+        c.collected.fetch_add(1, std::memory_order_relaxed);
+      }
+      it = next;
+    }
+    s.sweep_at = std::max(cache::min_sweep_size, s.entries.size() * 2);
+  }
+
+  jtl::option<object_ref> cache::find(key const &k)
+  {
+    if(soft)
+    {
+      relieve_pressure();
+    }
+
+    auto &s(shard_for(*this, k));
+    cache_lock const lock{ s.mutex };
+    auto const found(s.entries.find(k));
+    if(found == s.entries.end())
+    {
+      misses.fetch_add(1, std::memory_order_relaxed);
+      return none;
+    }
+
+    if(found->second.expires_at != 0 && found->second.expires_at <= now_ns())
+    {
+      erase_entry(*this, s, found);
+      misses.fetch_add(1, std::memory_order_relaxed);
+      return none;
+    }
+
+    jtl::option<object_ref> value{ found->second.value };
+    if(weak_values)
+    {
+      value = found->second.weak_value.get();
+      if(value.is_none())
+      {
+        erase_entry(*this, s, found);
+        collected.fetch_add(1, std::memory_order_relaxed);
+        misses.fetch_add(1, std::memory_order_relaxed);
+        return none;
+      }
+    }
+
+    if(max_size != 0)
+    {
+      s.lru.splice(s.lru.begin(), s.lru, found->second.lru);
+    }
+    hits.fetch_add(1, std::memory_order_relaxed);
+    return value;
+  }
+
+  void cache::store(key const &k, object_ref const value)
+  {
+    if(soft)
+    {
+      relieve_pressure();
+    }
+
+    auto const expires_at(ttl_ns == 0 ? 0 : now_ns() + ttl_ns);
+    auto &s(shard_for(*this, k));
+    cache_lock const lock{ s.mutex };
+    auto const [it, inserted](s.entries.try_emplace(k));
+    if(weak_values)
+    {
+      it->second.weak_value.set(value);
+    }
+    else
+    {
+      it->second.value = value;
+    }
+    it->second.expires_at = expires_at;
+
+    /* The key in the table is a copy of the one we were given, so it can let go of the
+     * args, leaving them to the entry. */
+    if(inserted && weak_keys)
+    {
+      auto const &stored(it->first);
+      if(max_inline_args < k.arity)
+      {
+        it->second.weak_rest.set(k.rest);
+        stored.rest = {};
+      }
+      else
+      {
+        for(u8 i{}; i < k.arity; ++i)
+        {
+          it->second.weak_args[i].set(k.args[i]);
+          stored.args[i] = {};
+        }
+      }
+      stored.refs = &it->second;
+    }
+
+    if(max_size != 0)
+    {
+      if(!inserted)
+      {
+        s.lru.splice(s.lru.begin(), s.lru, it->second.lru);
+        return;
+      }
+      s.lru.push_front(it->first);
+      it->second.lru = s.lru.begin();
+
+      if(max_shard_size < s.entries.size())
+      {
+        s.entries.erase(s.lru.back());
+        s.lru.pop_back();
+        evictions.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+
+    if(inserted && (weak_keys || weak_values) && s.sweep_at <= s.entries.size())
+    {
+      sweep(*this, s);
+    }
+  }
+
+  bool cache::evict(key const &k)
+  {
+    auto &s(shard_for(*this, k));
+    cache_lock const lock{ s.mutex };
+    auto const found(s.entries.find(k));
+    if(found == s.entries.end())
+    {
+      return false;
+    }
+    erase_entry(*this, s, found);
+    return true;
+  }
+
+  void cache::clear()
+  {
+    for(auto &s : shards)
+    {
+      cache_lock const lock{ s.mutex };
+      s.entries.clear();
+      s.lru.clear();
+    }
+  }
+
+  usize cache::size()
+  {
+    usize ret{};
+    for(auto &s : shards)
+    {
+      cache_lock const lock{ s.mutex };
+      ret += s.entries.size();
+    }
+    return ret;
+  }
+
+  object_ref cache::stats()
+  {
+    auto const kw(
+      [](char const * const name) { return __rt_ctx->intern_keyword(name).expect_ok(); });
+    return persistent_hash_map::create_unique(
+      std::make_pair(kw("hits"), make_box(static_cast<i64>(hits.load()))),
+      std::make_pair(kw("misses"), make_box(static_cast<i64>(misses.load()))),
+      std::make_pair(kw("evictions"), make_box(static_cast<i64>(evictions.load()))),
+      std::make_pair(kw("collected"), make_box(static_cast<i64>(collected.load()))),
+      std::make_pair(kw("cleared"), make_box(static_cast<i64>(cleared.load()))),
+      std::make_pair(kw("size"), make_box(static_cast<i64>(size()))));
+  }
+
+  void cache::relieve_pressure()
+  {
+    auto const epoch(pressure_epoch.load(std::memory_order_acquire));
+    if(relieved_epoch.load(std::memory_order_relaxed) == epoch || cache_locks_held != 0)
+    {
+      return;
+    }
+
+    /* Shards which are in use are left for next time, rather than waiting on them. */
+    bool all_cleared{ true };
+    for(auto &s : shards)
+    {
+      std::unique_lock<std::mutex> lock{ s.mutex, std::try_to_lock };
+      if(!lock.owns_lock())
+      {
+        all_cleared = false;
+        continue;
+      }
+      s.entries.clear();
+      s.lru.clear();
+      s.sweep_at = min_sweep_size;
+    }
+
+    if(all_cleared)
+    {
+      relieved_epoch.store(epoch, std::memory_order_relaxed);
+      cleared.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+}
+
+namespace jank::runtime
+{
+  namespace
+  {
+    /* Every soft cache, held weakly, so the registry doesn't keep them alive. */
+    struct soft_registry
+    {
+      std::mutex mutex;
+      native_list<detail::weak_ref> caches;
+      usize limit{};
+      /* The heap size when soft caches were last cleared for being past the limit. */
+      usize cleared_at{};
+    };
+  }
+
+  static usize default_soft_limit()
+  {
+    auto const max_heap(util::cli::opts.gc_max_heap_size);
+    if(max_heap != 0)
+    {
+      return max_heap / 4 * 3;
+    }
+    auto const pages(sysconf(_SC_PHYS_PAGES));
+    auto const page_size(sysconf(_SC_PAGESIZE));
+    if(pages <= 0 || page_size <= 0)
+    {
+      return std::numeric_limits<usize>::max();
+    }
+    return static_cast<usize>(pages) / 4 * 3 * static_cast<usize>(page_size);
+  }
+
+  static soft_registry &get_soft_registry()
+  {
+    /* This is GC allocated, so the GC sees the entries of its list. */
+    static auto * const r{ new(GC) soft_registry{ .limit = default_soft_limit() } };
+    return *r;
+  }
+
+  static void arm_pressure_check();
+
+  /* This is finalizer of an object which is never reachable, so it runs after every
+   * collection. Finalizers run outside of the GC, so this can lock and allocate, but it
+   * can run during any allocation, so it does nothing if this thread holds a cache lock. */
+  static void GC_CALLBACK check_pressure(void *, void *)
+  {
+    arm_pressure_check();
+    if(cache_locks_held != 0)
+    {
+      return;
+    }
+
+    auto &registry(get_soft_registry());
+    auto const heap_size(GC_get_heap_size());
+    {
+      cache_lock const lock{ registry.mutex };
+      if(heap_size <= registry.limit || heap_size <= registry.cleared_at)
+      {
+        return;
+      }
+      registry.cleared_at = heap_size;
+    }
+    clear_soft_caches();
+  }
+
+  static void arm_pressure_check()
+  {
+    GC_register_finalizer(GC_MALLOC_ATOMIC(1), &check_pressure, nullptr, nullptr, nullptr);
+  }
+
+  static void register_soft_cache(obj::cache_ref const c)
+  {
+    static std::once_flag armed;
+    std::call_once(armed, &arm_pressure_check);
+
+    auto &registry(get_soft_registry());
+    cache_lock const lock{ registry.mutex };
+    registry.caches.emplace_back().set(c);
+  }
+
+  object_ref make_cache(object_ref const opts)
+  {
+    auto const kw(
+      [](char const * const name) { return __rt_ctx->intern_keyword(name).expect_ok(); });
+    auto const max_size(get(opts, kw("max-size")));
+    auto const ttl_ms(get(opts, kw("ttl-ms")));
+    auto const size_bound(max_size.is_nil() ? 0 : to_int(max_size));
+    auto const ttl_bound(ttl_ms.is_nil() ? 0 : to_int(ttl_ms));
+    if(size_bound < 0 || ttl_bound < 0)
+    {
+      throw make_box("A cache's :max-size and :ttl-ms can't be negative").erase();
+    }
+
+    auto const ret(make_box<obj::cache>(
+      obj::cache::options{ .max_size = static_cast<usize>(size_bound),
+                           .ttl_ms = ttl_bound,
+                           .weak_keys = truthy(get(opts, kw("weak-keys"))),
+                           .weak_values = truthy(get(opts, kw("weak-values"))),
+                           .soft = truthy(get(opts, kw("soft"))) }));
+    if(ret->soft)
+    {
+      register_soft_cache(ret);
+    }
+    return ret;
+  }
+
+  usize soft_cache_limit()
+  {
+    auto &registry(get_soft_registry());
+    cache_lock const lock{ registry.mutex };
+    return registry.limit;
+  }
+
+  void set_soft_cache_limit(usize const bytes)
+  {
+    auto &registry(get_soft_registry());
+    cache_lock const lock{ registry.mutex };
+    registry.limit = bytes;
+    registry.cleared_at = 0;
+  }
+
+  void clear_soft_caches()
+  {
+    pressure_epoch.fetch_add(1, std::memory_order_release);
+
+    native_vector<obj::cache_ref> live;
+    {
+      auto &registry(get_soft_registry());
+      cache_lock const lock{ registry.mutex };
+      for(auto it(registry.caches.begin()); it != registry.caches.end();)
+      {
+        auto const c(it->get());
+        if(c.is_none())
+        {
+          it = registry.caches.erase(it);
+          continue;
+        }
+        live.emplace_back(expect_object<obj::cache>(c.unwrap()));
+        ++it;
+      }
+    }
+
+    for(auto const c : live)
+    {
+      c->relieve_pressure();
+    }
+  }
+
+  template <typename... Args>
+  static object_ref call_through(object_ref const c,
+                                 object_ref const f,
+                                 obj::cache::key const &k,
+                                 Args const... args)
+  {
+    auto const typed_c(try_object<obj::cache>(c));
+    if(auto const found(typed_c->find(k)); found.is_some())
+    {
+      return found.unwrap();
+    }
+    auto const ret(dynamic_call(f, args...));
+    typed_c->store(k, ret);
+    return ret;
+  }
+
+  object_ref cache_call(object_ref const c, object_ref const f)
+  {
+    return call_through(c, f, obj::cache::make_key());
+  }
+
+  object_ref cache_call(object_ref const c, object_ref const f, object_ref const a)
+  {
+    return call_through(c, f, obj::cache::make_key(a), a);
+  }
+
+  object_ref
+  cache_call(object_ref const c, object_ref const f, object_ref const a, object_ref const b)
+  {
+    return call_through(c, f, obj::cache::make_key(a, b), a, b);
+  }
+
+  object_ref cache_call(object_ref const c,
+                        object_ref const f,
+                        object_ref const a,
+                        object_ref const b,
+                        object_ref const d)
+  {
+    return call_through(c, f, obj::cache::make_key(a, b, d), a, b, d);
+  }
+
+  object_ref cache_call_rest(object_ref const c, object_ref const f, object_ref const args)
+  {
+    auto const typed_c(try_object<obj::cache>(c));
+    auto const k(obj::cache::make_key_rest(args));
+    if(auto const found(typed_c->find(k)); found.is_some())
+    {
+      return found.unwrap();
+    }
+    auto const ret(apply_to(f, args));
+    typed_c->store(k, ret);
+    return ret;
+  }
+}
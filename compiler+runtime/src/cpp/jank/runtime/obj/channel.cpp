@@ -0,0 +1,322 @@
+#include <jank/runtime/obj/channel.hpp>
+#include <jank/runtime/obj/promise.hpp>
+#include <jank/runtime/obj/persistent_vector.hpp>
+#include <jank/runtime/behavior/callable.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/executor.hpp>
+#include <jank/runtime/rtti.hpp>
+#include <jank/util/fmt.hpp>
+
+namespace jank::runtime::obj
+{
+  enum class commit_result : u8
+  {
+    committed,
+    self_inactive,
+    other_inactive
+  };
+
+  /* The same limits as core.async. Past this many queued ops, a channel is almost
+   * certainly being misused, so we throw rather than grow forever. */
+  static constexpr usize max_queue_size{ 1024 };
+  static constexpr usize max_dirty{ 64 };
+
+  static bool is_active(channel::handler_flag &flag)
+  {
+    std::lock_guard<std::mutex> const lock{ flag.mutex };
+    return flag.active;
+  }
+
+  bool channel::commit(handler_flag &flag)
+  {
+    std::lock_guard<std::mutex> const lock{ flag.mutex };
+    if(!flag.active)
+    {
+      return false;
+    }
+    flag.active = false;
+    return true;
+  }
+
+  /* Uses up both handlers of a match, or neither. */
+  static commit_result commit_both(channel::handler_flag &self, channel::handler_flag &other)
+  {
+    /* An alts! which both puts to and takes from the same channel can't match itself. */
+    if(&self == &other)
+    {
+      return commit_result::other_inactive;
+    }
+
+    std::scoped_lock const lock{ self.mutex, other.mutex };
+    if(!self.active)
+    {
+      return commit_result::self_inactive;
+    }
+    if(!other.active)
+    {
+      return commit_result::other_inactive;
+    }
+    self.active = other.active = false;
+    return commit_result::committed;
+  }
+
+  channel::channel(buffer_kind const kind, usize const capacity)
+    : kind{ kind }
+    , capacity{ capacity }
+  {
+    if(kind != buffer_kind::none && capacity == 0)
+    {
+      throw make_box("A channel buffer needs a size of at least one").erase();
+    }
+  }
+
+  bool channel::equal(object const &o) const
+  {
+    return &o == &base;
+  }
+
+  jtl::immutable_string channel::to_string() const
+  {
+    jtl::string_builder buff;
+    to_string(buff);
+    return buff.release();
+  }
+
+  void channel::to_string(jtl::string_builder &buff) const
+  {
+    util::format_to(buff, "#object [{} {}]", object_type_str(base.type), &base);
+  }
+
+  jtl::immutable_string channel::to_code_string() const
+  {
+    return to_string();
+  }
+
+  void channel::to_code_string(jtl::string_builder &buff) const
+  {
+    to_string(buff);
+  }
+
+  uhash channel::to_hash() const
+  {
+    return static_cast<uhash>(reinterpret_cast<uintptr_t>(this));
+  }
+
+  channel::result channel::put(object_ref const val, handler * const h)
+  {
+    if(val.is_nil())
+    {
+      throw make_box("Can't put nil on a channel").erase();
+    }
+
+    handler *taker{};
+    {
+      std::lock_guard<std::mutex> const lock{ mutex };
+      if(closed)
+      {
+        if(!commit(*h->flag))
+        {
+          return {};
+        }
+        return { true, jank_false };
+      }
+
+      /* Any waiting takes mean the buffer is empty, so the value goes straight across. */
+      while(!takes.empty())
+      {
+        auto const t{ takes.front() };
+        takes.pop_front();
+        auto const res{ commit_both(*h->flag, *t->flag) };
+        if(res == commit_result::committed)
+        {
+          taker = t;
+          break;
+        }
+        if(res == commit_result::self_inactive)
+        {
+          takes.push_front(t);
+          return {};
+        }
+      }
+
+      if(!taker)
+      {
+        if(kind == buffer_kind::none || (kind == buffer_kind::fixed && buffer.size() == capacity))
+        {
+          if(max_dirty < ++dirty_puts)
+          {
+            std::erase_if(puts, [](auto const &p) { return !is_active(*p.second->flag); });
+            dirty_puts = 0;
+          }
+          if(max_queue_size <= puts.size())
+          {
+            throw make_box("No more than 1024 pending puts are allowed on a single channel")
+              .erase();
+          }
+          puts.emplace_back(val, h);
+          return {};
+        }
+
+        if(!commit(*h->flag))
+        {
+          return {};
+        }
+        if(buffer.size() < capacity)
+        {
+          buffer.push_back(val);
+        }
+        else if(kind == buffer_kind::sliding)
+        {
+          buffer.pop_front();
+          buffer.push_back(val);
+        }
+        return { true, jank_true };
+      }
+    }
+
+    fire(*taker, val);
+    return { true, jank_true };
+  }
+
+  channel::result channel::take(handler * const h)
+  {
+    handler *putter{};
+    object_ref val{};
+    {
+      std::lock_guard<std::mutex> const lock{ mutex };
+      if(!buffer.empty())
+      {
+        if(!commit(*h->flag))
+        {
+          return {};
+        }
+        val = buffer.front();
+        buffer.pop_front();
+
+        /* The first waiting put which is still active gets the slot we just freed. */
+        while(!puts.empty())
+        {
+          auto const [pv, ph] = puts.front();
+          puts.pop_front();
+          if(commit(*ph->flag))
+          {
+            buffer.push_back(pv);
+            putter = ph;
+            break;
+          }
+        }
+      }
+      else
+      {
+        while(!puts.empty())
+        {
+          auto const [pv, ph] = puts.front();
+          puts.pop_front();
+          auto const res{ commit_both(*h->flag, *ph->flag) };
+          if(res == commit_result::committed)
+          {
+            val = pv;
+            putter = ph;
+            break;
+          }
+          if(res == commit_result::self_inactive)
+          {
+            puts.emplace_front(pv, ph);
+            return {};
+          }
+        }
+
+        if(!putter)
+        {
+          if(closed)
+          {
+            if(!commit(*h->flag))
+            {
+              return {};
+            }
+            return { true, jank_nil() };
+          }
+          if(max_dirty < ++dirty_takes)
+          {
+            std::erase_if(takes, [](auto const t) { return !is_active(*t->flag); });
+            dirty_takes = 0;
+          }
+          if(max_queue_size <= takes.size())
+          {
+            throw make_box("No more than 1024 pending takes are allowed on a single channel")
+              .erase();
+          }
+          takes.push_back(h);
+          return {};
+        }
+      }
+    }
+
+    if(putter)
+    {
+      fire(*putter, jank_true);
+    }
+    return { true, val };
+  }
+
+  void channel::close()
+  {
+    native_vector<handler *> woken;
+    {
+      std::lock_guard<std::mutex> const lock{ mutex };
+      if(closed)
+      {
+        return;
+      }
+      closed = true;
+
+      /* Waiting takes mean there's nothing buffered and nothing waiting to be put, so
+       * they'll never get anything but nil. Waiting puts can still be taken. */
+      for(auto const t : takes)
+      {
+        if(commit(*t->flag))
+        {
+          woken.push_back(t);
+        }
+      }
+      takes.clear();
+    }
+
+    for(auto const t : woken)
+    {
+      fire(*t, jank_nil());
+    }
+  }
+
+  channel::handler *channel::make_handler(object_ref const callback)
+  {
+    return new(GC) handler{ new(GC) handler_flag{}, callback, jank_nil() };
+  }
+
+  void channel::fire(handler const &h, object_ref const val)
+  {
+    auto const ret{ h.port.is_nil() ? val
+                                    : make_box<persistent_vector>(std::in_place, val, h.port) };
+    if(h.callback.is_nil())
+    {
+      return;
+    }
+    if(h.callback->type == object_type::promise)
+    {
+      expect_object<promise>(h.callback)->deliver(ret);
+      return;
+    }
+
+    /* Callbacks run on the pool, rather than on whichever thread happened to complete
+     * the op, which may be holding up someone else. */
+    pooled_executor().submit([callback = h.callback, ret] {
+      try
+      {
+        dynamic_call(callback, ret);
+      }
+      catch(...)
+      {
+      }
+    });
+  }
+}
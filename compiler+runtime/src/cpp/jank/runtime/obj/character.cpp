@@ -1,3 +1,5 @@
+#include <array>
+
 #include <jank/runtime/obj/character.hpp>
 #include <jank/runtime/rtti.hpp>
 #include <jank/util/escape.hpp>
@@ -69,8 +71,32 @@ namespace jank::runtime::obj
     return get_literal_from_char_bytes(data);
   }
 
+  void character::to_code_string(jtl::string_builder &buff) const
+  {
+    buff(get_literal_from_char_bytes(data));
+  }
+
   uhash character::to_hash() const
   {
     return data.to_hash();
   }
 }
+
+namespace jank::runtime::detail
+{
+  static obj::character *ascii_characters_const()
+  {
+    static auto r([] {
+      std::array<obj::character, ascii_character_count> ret;
+      for(usize i{}; i < ret.size(); ++i)
+      {
+        ret[i].data = jtl::immutable_string{ 1, static_cast<char>(i) };
+      }
+      return ret;
+    }());
+    return r.data();
+  }
+
+  /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+  obj::character *ascii_characters{ ascii_characters_const() };
+}
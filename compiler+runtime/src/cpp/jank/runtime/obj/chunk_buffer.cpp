@@ -44,6 +44,11 @@ namespace jank::runtime::obj
     return to_string();
   }
 
+  void chunk_buffer::to_code_string(jtl::string_builder &buff) const
+  {
+    to_string(buff);
+  }
+
   uhash chunk_buffer::to_hash() const
   {
     return static_cast<uhash>(reinterpret_cast<uintptr_t>(this));
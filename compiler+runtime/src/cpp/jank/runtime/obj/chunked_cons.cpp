@@ -172,6 +172,11 @@ namespace jank::runtime::obj
     return runtime::to_code_string(seq());
   }
 
+  void chunked_cons::to_code_string(jtl::string_builder &buff) const
+  {
+    runtime::to_code_string(seq(), buff);
+  }
+
   uhash chunked_cons::to_hash() const
   {
     return hash::ordered(&base);
@@ -0,0 +1,328 @@
+#include <cstring>
+
+#include <jank/runtime/obj/column_table.hpp>
+#include <jank/runtime/obj/column_table_sequence.hpp>
+#include <jank/runtime/obj/array.hpp>
+#include <jank/runtime/obj/number.hpp>
+#include <jank/runtime/obj/persistent_struct_map.hpp>
+#include <jank/runtime/obj/persistent_vector.hpp>
+#include <jank/runtime/obj/struct_basis.hpp>
+#include <jank/runtime/behavior/reducible.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/math.hpp>
+#include <jank/runtime/core/seq.hpp>
+#include <jank/runtime/core/seq_ext.hpp>
+#include <jank/runtime/core/to_string.hpp>
+#include <jank/runtime/core/truthy.hpp>
+#include <jank/runtime/rtti.hpp>
+#include <jank/util/fmt.hpp>
+
+namespace jank::runtime::obj
+{
+  /* Numbers are only stored unboxed when every value in the column has the same type, so
+   * reading a value back always gives the same object type which went in. */
+  static object_ref make_column(native_vector<object_ref> const &values)
+  {
+    bool all_integers{ !values.empty() }, all_reals{ !values.empty() };
+    for(auto const v : values)
+    {
+      all_integers = all_integers && v->type == object_type::integer;
+      all_reals = all_reals && v->type == object_type::real;
+    }
+
+    if(all_integers)
+    {
+      auto const ret(make_box<array>(array::element_type::long_, values.size()));
+      auto const data(ret->data_as<i64>());
+      for(usize i{}; i < values.size(); ++i)
+      {
+        data[i] = expect_object<integer>(values[i])->data;
+      }
+      return ret;
+    }
+    if(all_reals)
+    {
+      auto const ret(make_box<array>(array::element_type::double_, values.size()));
+      auto const data(ret->data_as<f64>());
+      for(usize i{}; i < values.size(); ++i)
+      {
+        data[i] = expect_object<real>(values[i])->data;
+      }
+      return ret;
+    }
+
+    runtime::detail::native_transient_vector trans;
+    for(auto const v : values)
+    {
+      trans.push_back(v);
+    }
+    return make_box<persistent_vector>(trans.persistent());
+  }
+
+  static object_ref column_value(object_ref const column, usize const index)
+  {
+    if(column->type == object_type::array)
+    {
+      return expect_object<array>(column)->get(index);
+    }
+    return expect_object<persistent_vector>(column)->data[index];
+  }
+
+  static object_ref gather(object_ref const column, native_vector<usize> const &indices)
+  {
+    if(column->type == object_type::array)
+    {
+      auto const a(expect_object<array>(column));
+      auto const ret(make_box<array>(a->element, indices.size()));
+      auto const size(array::element_size(a->element));
+      auto const from(static_cast<char const *>(a->data));
+      auto const to(static_cast<char *>(ret->data));
+      for(usize i{}; i < indices.size(); ++i)
+      {
+        std::memcpy(to + (i * size), from + (indices[i] * size), size);
+      }
+      return ret;
+    }
+
+    auto const &data(expect_object<persistent_vector>(column)->data);
+    runtime::detail::native_transient_vector trans;
+    for(auto const i : indices)
+    {
+      trans.push_back(data[i]);
+    }
+    return make_box<persistent_vector>(trans.persistent());
+  }
+
+  static native_vector<object_ref> rows(column_table const &t)
+  {
+    native_vector<object_ref> ret;
+    ret.reserve(t.length);
+    for(usize i{}; i < t.length; ++i)
+    {
+      ret.emplace_back(t.row(i));
+    }
+    return ret;
+  }
+
+  column_table::column_table(struct_basis_ref const basis,
+                             native_vector<object_ref> &&columns,
+                             usize const length)
+    : basis{ basis }
+    , columns{ jtl::move(columns) }
+    , length{ length }
+  {
+  }
+
+  column_table_ref column_table::create(object_ref const keys, object_ref const rows)
+  {
+    auto const basis(struct_basis::create(keys));
+    auto const column_count(basis->keys.size());
+
+    native_vector<native_vector<object_ref>> values(column_count);
+    usize length{};
+    runtime::for_each(rows, [&](object_ref const row) {
+      for(usize i{}; i < column_count; ++i)
+      {
+        values[i].emplace_back(runtime::get(row, basis->keys[i]));
+      }
+      ++length;
+    });
+
+    native_vector<object_ref> columns;
+    columns.reserve(column_count);
+    for(auto const &v : values)
+    {
+      columns.emplace_back(make_column(v));
+    }
+    return make_box<column_table>(basis, jtl::move(columns), length);
+  }
+
+  bool column_table::equal(object const &o) const
+  {
+    if(&o == &base)
+    {
+      return true;
+    }
+    auto const r(rows(*this));
+    return runtime::equal(o, r.begin(), r.end());
+  }
+
+  jtl::immutable_string column_table::to_string() const
+  {
+    jtl::string_builder buff;
+    to_string(buff);
+    return buff.release();
+  }
+
+  void column_table::to_string(jtl::string_builder &buff) const
+  {
+    auto const r(rows(*this));
+    runtime::to_string(r.begin(), r.end(), "[", ']', buff);
+  }
+
+  jtl::immutable_string column_table::to_code_string() const
+  {
+    jtl::string_builder buff;
+    to_code_string(buff);
+    return buff.release();
+  }
+
+  void column_table::to_code_string(jtl::string_builder &buff) const
+  {
+    auto const r(rows(*this));
+    runtime::to_code_string(r.begin(), r.end(), "[", ']', buff);
+  }
+
+  uhash column_table::to_hash() const
+  {
+    if(hash)
+    {
+      return hash;
+    }
+    auto const r(rows(*this));
+    return hash = hash::ordered(r.begin(), r.end());
+  }
+
+  column_table_sequence_ref column_table::seq() const
+  {
+    return fresh_seq();
+  }
+
+  column_table_sequence_ref column_table::fresh_seq() const
+  {
+    if(length == 0)
+    {
+      return {};
+    }
+    return make_box<column_table_sequence>(const_cast<column_table *>(this), 0);
+  }
+
+  usize column_table::count() const
+  {
+    return length;
+  }
+
+  object_ref column_table::nth(object_ref const index) const
+  {
+    auto const i(to_int(index));
+    if(i < 0 || length <= static_cast<usize>(i))
+    {
+      throw std::runtime_error{
+        util::format("index {} is out of bounds for a table of length {}", i, length)
+      };
+    }
+    return row(static_cast<usize>(i));
+  }
+
+  object_ref column_table::nth(object_ref const index, object_ref const fallback) const
+  {
+    auto const i(to_int(index));
+    if(i < 0 || length <= static_cast<usize>(i))
+    {
+      return fallback;
+    }
+    return row(static_cast<usize>(i));
+  }
+
+  object_ref column_table::reduce(object_ref const f, object_ref const init) const
+  {
+    object_ref res{ init };
+    for(usize i{}; i < length; ++i)
+    {
+      res = dynamic_call(f, res, row(i));
+      if(behavior::detail::unwrap_reduced(res))
+      {
+        break;
+      }
+    }
+    return res;
+  }
+
+  persistent_struct_map_ref column_table::row(usize const index) const
+  {
+    auto const slots(new(GC) object_ref[columns.size()]);
+    for(usize i{}; i < columns.size(); ++i)
+    {
+      slots[i] = column_value(columns[i], index);
+    }
+    return make_box<persistent_struct_map>(runtime::detail::native_struct_map{ basis, slots, {} });
+  }
+
+  static usize column_index(column_table const &t, object_ref const key)
+  {
+    auto const slot(t.basis->slot(key));
+    if(slot.is_none())
+    {
+      throw std::runtime_error{ util::format("{} is not a column of this table",
+                                             runtime::to_code_string(key)) };
+    }
+    return slot.unwrap();
+  }
+
+  object_ref column_table::column(object_ref const key) const
+  {
+    return columns[column_index(*this, key)];
+  }
+
+  object_ref
+  column_table::reduce_column(object_ref const key, object_ref const f, object_ref const init) const
+  {
+    auto const col(column(key));
+    if(col->type == object_type::array)
+    {
+      auto const a(expect_object<array>(col));
+      if(a->element == array::element_type::long_)
+      {
+        auto const data(a->data_as<i64>());
+        return behavior::detail::reduce_range(f, init, data, data + a->length, [](i64 const e) {
+          return make_box(e);
+        });
+      }
+      auto const data(a->data_as<f64>());
+      return behavior::detail::reduce_range(f, init, data, data + a->length, [](f64 const e) {
+        return make_box(e);
+      });
+    }
+
+    auto const &data(expect_object<persistent_vector>(col)->data);
+    return behavior::detail::reduce_range(f, init, data.begin(), data.end(), [](auto const e) {
+      return e;
+    });
+  }
+
+  column_table_ref column_table::map_column(object_ref const key, object_ref const f) const
+  {
+    auto const index(column_index(*this, key));
+    native_vector<object_ref> values;
+    values.reserve(length);
+    for(usize i{}; i < length; ++i)
+    {
+      values.emplace_back(dynamic_call(f, column_value(columns[index], i)));
+    }
+
+    auto copy(columns);
+    copy[index] = make_column(values);
+    return make_box<column_table>(basis, jtl::move(copy), length);
+  }
+
+  column_table_ref column_table::filter_column(object_ref const key, object_ref const pred) const
+  {
+    auto const col(column(key));
+    native_vector<usize> indices;
+    for(usize i{}; i < length; ++i)
+    {
+      if(truthy(dynamic_call(pred, column_value(col, i))))
+      {
+        indices.emplace_back(i);
+      }
+    }
+
+    native_vector<object_ref> filtered;
+    filtered.reserve(columns.size());
+    for(auto const c : columns)
+    {
+      filtered.emplace_back(gather(c, indices));
+    }
+    return make_box<column_table>(basis, jtl::move(filtered), indices.size());
+  }
+}
@@ -0,0 +1,114 @@
+#include <jank/runtime/obj/column_table_sequence.hpp>
+#include <jank/runtime/obj/column_table.hpp>
+#include <jank/runtime/obj/persistent_struct_map.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/to_string.hpp>
+#include <jank/runtime/core/seq_ext.hpp>
+
+namespace jank::runtime::obj
+{
+  column_table_sequence::column_table_sequence(column_table_ref const table, usize const index)
+    : table{ table }
+    , index{ index }
+  {
+    jank_debug_assert(index < table->length);
+  }
+
+  static native_vector<object_ref> rows(column_table_sequence const &s)
+  {
+    native_vector<object_ref> ret;
+    ret.reserve(s.table->length - s.index);
+    for(auto i(s.index); i < s.table->length; ++i)
+    {
+      ret.emplace_back(s.table->row(i));
+    }
+    return ret;
+  }
+
+  /* behavior::object_like */
+  bool column_table_sequence::equal(object const &o) const
+  {
+    auto const r(rows(*this));
+    return runtime::equal(o, r.begin(), r.end());
+  }
+
+  void column_table_sequence::to_string(jtl::string_builder &buff) const
+  {
+    auto const r(rows(*this));
+    runtime::to_string(r.begin(), r.end(), "(", ')', buff);
+  }
+
+  jtl::immutable_string column_table_sequence::to_string() const
+  {
+    jtl::string_builder buff;
+    to_string(buff);
+    return buff.release();
+  }
+
+  jtl::immutable_string column_table_sequence::to_code_string() const
+  {
+    jtl::string_builder buff;
+    to_code_string(buff);
+    return buff.release();
+  }
+
+  void column_table_sequence::to_code_string(jtl::string_builder &buff) const
+  {
+    auto const r(rows(*this));
+    runtime::to_code_string(r.begin(), r.end(), "(", ')', buff);
+  }
+
+  uhash column_table_sequence::to_hash() const
+  {
+    auto const r(rows(*this));
+    return hash::ordered(r.begin(), r.end());
+  }
+
+  /* behavior::seqable */
+  column_table_sequence_ref column_table_sequence::seq()
+  {
+    return this;
+  }
+
+  column_table_sequence_ref column_table_sequence::fresh_seq() const
+  {
+    return make_box<column_table_sequence>(table, index);
+  }
+
+  /* behavior::countable */
+  usize column_table_sequence::count() const
+  {
+    return table->length - index;
+  }
+
+  /* behavior::sequence */
+  object_ref column_table_sequence::first() const
+  {
+    return table->row(index);
+  }
+
+  column_table_sequence_ref column_table_sequence::next() const
+  {
+    auto const n(index + 1);
+    if(table->length <= n)
+    {
+      return {};
+    }
+    return make_box<column_table_sequence>(table, n);
+  }
+
+  column_table_sequence_ref column_table_sequence::next_in_place()
+  {
+    ++index;
+    if(table->length <= index)
+    {
+      return {};
+    }
+    return this;
+  }
+
+  cons_ref column_table_sequence::conj(object_ref const head)
+  {
+    return make_box<cons>(head, this);
+  }
+}
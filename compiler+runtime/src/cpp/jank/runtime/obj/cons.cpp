@@ -56,6 +56,11 @@ namespace jank::runtime::obj
     return runtime::to_code_string(seq());
   }
 
+  void cons::to_code_string(jtl::string_builder &buff) const
+  {
+    runtime::to_code_string(seq(), buff);
+  }
+
   uhash cons::to_hash() const
   {
     if(hash != 0)
@@ -0,0 +1,72 @@
+#include <jank/runtime/obj/counter_atom.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/util/fmt.hpp>
+
+namespace jank::runtime::obj
+{
+  /* Threads are given stripes round robin, the first time they add to any counter. */
+  static usize stripe_index()
+  {
+    static std::atomic<usize> next{};
+    static thread_local usize const index{ next.fetch_add(1, std::memory_order_relaxed)
+                                           % counter_atom::stripe_count };
+    return index;
+  }
+
+  counter_atom::counter_atom(i64 const initial)
+  {
+    stripes[0].count.store(initial, std::memory_order_relaxed);
+  }
+
+  bool counter_atom::equal(object const &o) const
+  {
+    return &o == &base;
+  }
+
+  jtl::immutable_string counter_atom::to_string() const
+  {
+    jtl::string_builder buff;
+    to_string(buff);
+    return buff.release();
+  }
+
+  void counter_atom::to_string(jtl::string_builder &buff) const
+  {
+    util::format_to(buff, "#object [{} {}]", object_type_str(base.type), &base);
+  }
+
+  jtl::immutable_string counter_atom::to_code_string() const
+  {
+    return to_string();
+  }
+
+  void counter_atom::to_code_string(jtl::string_builder &buff) const
+  {
+    to_string(buff);
+  }
+
+  uhash counter_atom::to_hash() const
+  {
+    return static_cast<uhash>(reinterpret_cast<uintptr_t>(this));
+  }
+
+  object_ref counter_atom::deref() const
+  {
+    return make_box(sum());
+  }
+
+  void counter_atom::add(i64 const n)
+  {
+    stripes[stripe_index()].count.fetch_add(n, std::memory_order_relaxed);
+  }
+
+  i64 counter_atom::sum() const
+  {
+    i64 ret{};
+    for(auto const &s : stripes)
+    {
+      ret += s.count.load(std::memory_order_relaxed);
+    }
+    return ret;
+  }
+}
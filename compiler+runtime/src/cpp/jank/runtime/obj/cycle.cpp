@@ -0,0 +1,138 @@
+#include <jank/runtime/obj/cycle.hpp>
+#include <jank/runtime/visit.hpp>
+#include <jank/runtime/sequence_range.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/seq.hpp>
+#include <jank/runtime/behavior/callable.hpp>
+#include <jank/runtime/behavior/metadatable.hpp>
+#include <jank/runtime/behavior/reducible.hpp>
+
+namespace jank::runtime::obj
+{
+  cycle::cycle(object_ref const all)
+    : all{ all }
+    , current{ all }
+  {
+  }
+
+  cycle::cycle(object_ref const all, object_ref const current)
+    : all{ all }
+    , current{ current }
+  {
+  }
+
+  object_ref cycle::create(object_ref const coll)
+  {
+    auto const s(runtime::seq(coll));
+    if(s.is_nil())
+    {
+      return persistent_list::empty();
+    }
+    return make_box<cycle>(s);
+  }
+
+  object_ref cycle::reduce(object_ref const f, object_ref const init) const
+  {
+    object_ref res{ init };
+    auto const step([&](object_ref const o) {
+      res = dynamic_call(f, res, o);
+      return !behavior::detail::unwrap_reduced(res);
+    });
+
+    /* Only a reduced value can end this. */
+    if(!for_each_item(current, step))
+    {
+      return res;
+    }
+    while(for_each_item(all, step))
+    {
+    }
+    return res;
+  }
+
+  cycle_ref cycle::seq()
+  {
+    return this;
+  }
+
+  cycle_ref cycle::fresh_seq() const
+  {
+    return make_box<cycle>(all, current);
+  }
+
+  object_ref cycle::first() const
+  {
+    return runtime::first(current);
+  }
+
+  cycle_ref cycle::next() const
+  {
+    if(cached_next.is_some())
+    {
+      return cached_next;
+    }
+
+    auto const n(runtime::next(current));
+    cached_next = make_box<cycle>(all, n.is_nil() ? all : n);
+    return cached_next;
+  }
+
+  cycle_ref cycle::next_in_place()
+  {
+    if(cached_next.is_some())
+    {
+      current = cached_next->current;
+      cached_next = jank_nil();
+    }
+    else
+    {
+      auto const n(runtime::next(current));
+      current = n.is_nil() ? all : n;
+    }
+
+    return this;
+  }
+
+  cons_ref cycle::conj(object_ref const head) const
+  {
+    return make_box<cons>(head, this);
+  }
+
+  bool cycle::equal(object const &o) const
+  {
+    return runtime::sequence_equal(this, &o);
+  }
+
+  void cycle::to_string(jtl::string_builder &buff)
+  {
+    runtime::to_string(seq(), buff);
+  }
+
+  jtl::immutable_string cycle::to_string()
+  {
+    return runtime::to_string(seq());
+  }
+
+  jtl::immutable_string cycle::to_code_string()
+  {
+    return runtime::to_code_string(seq());
+  }
+
+  void cycle::to_code_string(jtl::string_builder &buff)
+  {
+    runtime::to_code_string(seq(), buff);
+  }
+
+  uhash cycle::to_hash() const
+  {
+    return hash::ordered(&base);
+  }
+
+  cycle_ref cycle::with_meta(object_ref const m) const
+  {
+    auto const meta(behavior::detail::validate_meta(m));
+    auto ret(fresh_seq());
+    ret->meta = meta;
+    return ret;
+  }
+}
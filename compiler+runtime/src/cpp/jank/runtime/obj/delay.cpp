@@ -32,24 +32,43 @@ namespace jank::runtime::obj
     return to_string();
   }
 
+  void delay::to_code_string(jtl::string_builder &buff) const
+  {
+    to_string(buff);
+  }
+
   uhash delay::to_hash() const
   {
     return static_cast<uhash>(reinterpret_cast<uintptr_t>(this));
   }
 
+  static object_ref realized_val(delay const &d)
+  {
+    if(d.error.is_some())
+    {
+      throw d.error;
+    }
+    return d.val;
+  }
+
   object_ref delay::deref()
   {
-    std::lock_guard<std::mutex> const lock{ mutex };
-    if(val.is_some())
+    if(realized.load(std::memory_order_acquire))
     {
-      return val;
+      return realized_val(*this);
     }
 
-    if(error.is_some())
+    std::lock_guard<std::mutex> const lock{ mutex };
+    if(realized.load(std::memory_order_relaxed))
     {
-      throw error;
+      return realized_val(*this);
     }
 
+    /* We won't need the fn again, so the GC can have it. */
+    auto const finish([this] {
+      fn = {};
+      realized.store(true, std::memory_order_release);
+    });
     try
     {
       val = dynamic_call(fn);
@@ -57,13 +76,21 @@ namespace jank::runtime::obj
     catch(std::exception const &e)
     {
       error = make_box(e.what());
+      finish();
       throw;
     }
     catch(object_ref const e)
     {
       error = e;
+      finish();
       throw;
     }
+    finish();
     return val;
   }
+
+  bool delay::is_realized() const
+  {
+    return realized.load(std::memory_order_acquire);
+  }
 }
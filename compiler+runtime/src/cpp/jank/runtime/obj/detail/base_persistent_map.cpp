@@ -1,9 +1,11 @@
 #include <jank/runtime/obj/detail/base_persistent_map.hpp>
 #include <jank/runtime/behavior/associatively_readable.hpp>
 #include <jank/runtime/behavior/map_like.hpp>
+#include <jank/runtime/behavior/reducible.hpp>
 #include <jank/runtime/visit.hpp>
 #include <jank/runtime/core/make_box.hpp>
 #include <jank/runtime/core/seq.hpp>
+#include <jank/runtime/core/to_string.hpp>
 #include <jank/util/fmt.hpp>
 
 namespace jank::runtime::obj::detail
@@ -51,10 +53,24 @@ namespace jank::runtime::obj::detail
                                                       jtl::string_builder &buff,
                                                       bool const to_code)
   {
+    runtime::detail::print_collection_scope const scope;
+    if(scope.too_deep)
+    {
+      buff('#');
+      return;
+    }
+
     auto inserter(std::back_inserter(buff));
     inserter = '{';
-    for(auto i(begin); i != end; ++i)
+    usize printed{};
+    for(auto i(begin); i != end; ++i, ++printed)
     {
+      if(scope.is_too_long(printed))
+      {
+        buff("...");
+        break;
+      }
+
       auto const &pair(*i);
       if(to_code)
       {
@@ -108,11 +124,17 @@ namespace jank::runtime::obj::detail
   jtl::immutable_string base_persistent_map<PT, ST, V>::to_code_string() const
   {
     jtl::string_builder buff;
+    to_code_string(buff);
+    return buff.release();
+  }
+
+  template <typename PT, typename ST, typename V>
+  void base_persistent_map<PT, ST, V>::to_code_string(jtl::string_builder &buff) const
+  {
     to_string_impl(static_cast<PT const *>(this)->data.begin(),
                    static_cast<PT const *>(this)->data.end(),
                    buff,
                    true);
-    return buff.release();
   }
 
   template <typename PT, typename ST, typename V>
@@ -157,6 +179,31 @@ namespace jank::runtime::obj::detail
     return static_cast<PT const *>(this)->data.size();
   }
 
+  template <typename PT, typename ST, typename V>
+  object_ref base_persistent_map<PT, ST, V>::reduce(object_ref const f, object_ref const init) const
+  {
+    return behavior::detail::reduce_range(f,
+                                          init,
+                                          static_cast<PT const *>(this)->data.begin(),
+                                          static_cast<PT const *>(this)->data.end(),
+                                          [](auto const &pair) {
+                                            return make_box<obj::persistent_vector>(
+                                              runtime::detail::native_persistent_vector{
+                                                pair.first,
+                                                pair.second });
+                                          });
+  }
+
+  template <typename PT, typename ST, typename V>
+  object_ref
+  base_persistent_map<PT, ST, V>::reduce_kv(object_ref const f, object_ref const init) const
+  {
+    return behavior::detail::reduce_kv_range(f,
+                                             init,
+                                             static_cast<PT const *>(this)->data.begin(),
+                                             static_cast<PT const *>(this)->data.end());
+  }
+
   template <typename PT, typename ST, typename V>
   object_ref base_persistent_map<PT, ST, V>::conj(object_ref const head) const
   {
@@ -205,4 +252,13 @@ namespace jank::runtime::obj::detail
   template struct base_persistent_map<persistent_sorted_map,
                                       persistent_sorted_map_sequence,
                                       runtime::detail::native_persistent_sorted_map>;
+  template struct base_persistent_map<persistent_int_map,
+                                      persistent_int_map_sequence,
+                                      runtime::detail::native_persistent_int_map>;
+  template struct base_persistent_map<mapped_map,
+                                      mapped_map_sequence,
+                                      runtime::detail::native_mapped_map>;
+  template struct base_persistent_map<persistent_struct_map,
+                                      persistent_struct_map_sequence,
+                                      runtime::detail::native_struct_map>;
 }
@@ -1,6 +1,8 @@
 #include <jank/runtime/obj/detail/base_persistent_map_sequence.hpp>
+#include <jank/runtime/obj/array_chunk.hpp>
 #include <jank/runtime/visit.hpp>
 #include <jank/runtime/core/seq.hpp>
+#include <jank/runtime/core/to_string.hpp>
 
 namespace jank::runtime::obj::detail
 {
@@ -25,9 +27,35 @@ namespace jank::runtime::obj::detail
   void base_persistent_map_sequence<PT, IT>::to_string_impl(jtl::string_builder &buff,
                                                             bool const to_code) const
   {
+    runtime::detail::print_collection_scope const scope;
+    if(scope.too_deep)
+    {
+      buff('#');
+      return;
+    }
+
     buff('(');
-    for(auto i(begin); i != end; ++i)
+    usize printed{};
+    for(auto i(begin); i != end; ++i, ++printed)
     {
+      if(printed != 0)
+      {
+        buff(' ');
+      }
+      if(scope.is_too_long(printed))
+      {
+        buff("...");
+        break;
+      }
+
+      /* Each entry is a vector of its own, so it counts as a level. */
+      runtime::detail::print_collection_scope const entry_scope;
+      if(entry_scope.too_deep)
+      {
+        buff('#');
+        continue;
+      }
+
       buff('[');
       if(to_code)
       {
@@ -47,11 +75,6 @@ namespace jank::runtime::obj::detail
         runtime::to_string((*i).second, buff);
       }
       buff(']');
-      auto n(i);
-      if(++n != end)
-      {
-        buff(' ');
-      }
     }
     buff(')');
   }
@@ -78,6 +101,12 @@ namespace jank::runtime::obj::detail
     return buff.release();
   }
 
+  template <typename PT, typename IT>
+  void base_persistent_map_sequence<PT, IT>::to_code_string(jtl::string_builder &buff) const
+  {
+    to_string_impl(buff, true);
+  }
+
   template <typename PT, typename IT>
   uhash base_persistent_map_sequence<PT, IT>::to_hash() const
   {
@@ -137,6 +166,37 @@ namespace jank::runtime::obj::detail
     return static_cast<PT *>(this);
   }
 
+  template <typename PT, typename IT>
+  obj::array_chunk_ref base_persistent_map_sequence<PT, IT>::chunked_first() const
+  {
+    native_vector<object_ref> buffer;
+    buffer.reserve(chunk_size);
+    for(auto it(begin); it != end && buffer.size() < chunk_size; ++it)
+    {
+      auto const &pair(*it);
+      buffer.emplace_back(make_box<obj::persistent_vector>(
+        runtime::detail::native_persistent_vector{ pair.first, pair.second }));
+    }
+    return make_box<obj::array_chunk>(jtl::move(buffer), static_cast<usize>(0));
+  }
+
+  template <typename PT, typename IT>
+  oref<PT> base_persistent_map_sequence<PT, IT>::chunked_next() const
+  {
+    auto n(begin);
+    for(usize i{}; i < chunk_size && n != end; ++i)
+    {
+      ++n;
+    }
+
+    if(n == end)
+    {
+      return {};
+    }
+
+    return make_box<PT>(coll, n, end);
+  }
+
   template <typename PT, typename IT>
   obj::cons_ref base_persistent_map_sequence<PT, IT>::conj(object_ref const head)
   {
@@ -151,4 +211,12 @@ namespace jank::runtime::obj::detail
   template struct base_persistent_map_sequence<
     persistent_sorted_map_sequence,
     runtime::detail::native_persistent_sorted_map::const_iterator>;
+  template struct base_persistent_map_sequence<
+    persistent_int_map_sequence,
+    runtime::detail::native_persistent_int_map::const_iterator>;
+  template struct base_persistent_map_sequence<
+    mapped_map_sequence,
+    runtime::detail::native_mapped_map::const_iterator>;
+  template struct base_persistent_map_sequence<persistent_struct_map_sequence,
+                                               runtime::detail::native_struct_map::const_iterator>;
 }
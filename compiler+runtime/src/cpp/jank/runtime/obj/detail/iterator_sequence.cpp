@@ -1,4 +1,5 @@
 #include <jank/runtime/obj/detail/iterator_sequence.hpp>
+#include <jank/runtime/obj/array_chunk.hpp>
 #include <jank/runtime/core/seq.hpp>
 #include <jank/runtime/core/to_string.hpp>
 #include <jank/runtime/visit.hpp>
@@ -54,6 +55,12 @@ namespace jank::runtime::obj::detail
     return buff.release();
   }
 
+  template <typename Derived, typename It>
+  void iterator_sequence<Derived, It>::to_code_string(jtl::string_builder &buff) const
+  {
+    runtime::to_code_string(begin, end, "(", ')', buff);
+  }
+
   template <typename Derived, typename It>
   uhash iterator_sequence<Derived, It>::to_hash() const
   {
@@ -95,13 +102,14 @@ namespace jank::runtime::obj::detail
       return {};
     }
 
-    return make_box<Derived>(coll, n, end, size);
+    return make_box<Derived>(coll, n, end, size - 1);
   }
 
   template <typename Derived, typename It>
   oref<Derived> iterator_sequence<Derived, It>::next_in_place()
   {
     ++begin;
+    --size;
 
     if(begin == end)
     {
@@ -111,6 +119,33 @@ namespace jank::runtime::obj::detail
     return static_cast<Derived *>(this);
   }
 
+  template <typename Derived, typename It>
+  obj::array_chunk_ref iterator_sequence<Derived, It>::chunked_first() const
+  {
+    auto const n{ std::min(size, chunk_size) };
+    native_vector<object_ref> buffer;
+    buffer.reserve(n);
+    auto it(begin);
+    for(usize i{}; i < n; ++i, ++it)
+    {
+      buffer.emplace_back(*it);
+    }
+    return make_box<obj::array_chunk>(jtl::move(buffer), static_cast<usize>(0));
+  }
+
+  template <typename Derived, typename It>
+  oref<Derived> iterator_sequence<Derived, It>::chunked_next() const
+  {
+    if(size <= chunk_size)
+    {
+      return {};
+    }
+
+    auto n(begin);
+    std::advance(n, chunk_size);
+    return make_box<Derived>(coll, n, end, size - chunk_size);
+  }
+
   template <typename Derived, typename It>
   obj::cons_ref iterator_sequence<Derived, It>::conj(object_ref const head)
   {
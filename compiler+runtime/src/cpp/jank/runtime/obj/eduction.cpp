@@ -0,0 +1,97 @@
+#include <jank/runtime/obj/eduction.hpp>
+#include <jank/runtime/obj/persistent_vector.hpp>
+#include <jank/runtime/behavior/callable.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core/seq.hpp>
+#include <jank/runtime/core/to_string.hpp>
+#include <jank/hash.hpp>
+
+namespace jank::runtime::obj
+{
+  /* The transducing itself is done by clojure.core, so any transducer works here. */
+  static object_ref core_fn(var_ref const v)
+  {
+    return v->deref();
+  }
+
+  static var_ref transduce_var()
+  {
+    static auto const ret{ __rt_ctx->find_var("clojure.core", "transduce") };
+    return ret;
+  }
+
+  static var_ref completing_var()
+  {
+    static auto const ret{ __rt_ctx->find_var("clojure.core", "completing") };
+    return ret;
+  }
+
+  static var_ref into_var()
+  {
+    static auto const ret{ __rt_ctx->find_var("clojure.core", "into") };
+    return ret;
+  }
+
+  eduction::eduction(object_ref const xform, object_ref const coll)
+    : xform{ xform }
+    , coll{ coll }
+  {
+  }
+
+  bool eduction::equal(object const &o) const
+  {
+    return runtime::sequence_equal(seq(), &o);
+  }
+
+  jtl::immutable_string eduction::to_string() const
+  {
+    return runtime::to_string(seq());
+  }
+
+  void eduction::to_string(jtl::string_builder &buff) const
+  {
+    runtime::to_string(seq(), buff);
+  }
+
+  jtl::immutable_string eduction::to_code_string() const
+  {
+    return runtime::to_code_string(seq());
+  }
+
+  void eduction::to_code_string(jtl::string_builder &buff) const
+  {
+    runtime::to_code_string(seq(), buff);
+  }
+
+  uhash eduction::to_hash() const
+  {
+    auto const s(seq());
+    if(s.is_nil())
+    {
+      return 1;
+    }
+    return hash::ordered(s.data);
+  }
+
+  object_ref eduction::seq() const
+  {
+    return runtime::seq(
+      dynamic_call(core_fn(into_var()), persistent_vector::empty(), xform, coll));
+  }
+
+  object_ref eduction::fresh_seq() const
+  {
+    return seq();
+  }
+
+  object_ref eduction::reduce(object_ref const f, object_ref const init) const
+  {
+    /* The completing wrapper keeps the transducer's completion step from calling f with
+     * just the result, which a plain reducing fn may not support. */
+    return dynamic_call(core_fn(transduce_var()),
+                        xform,
+                        dynamic_call(core_fn(completing_var()), f),
+                        init,
+                        coll);
+  }
+}
@@ -0,0 +1,191 @@
+#include <chrono>
+
+#include <jank/runtime/obj/future.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
+#include <jank/runtime/behavior/callable.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/executor.hpp>
+#include <jank/util/fmt.hpp>
+
+namespace jank::runtime::obj
+{
+  /* How long a worker thread waits on a future before checking for more work to help with. */
+  static constexpr std::chrono::milliseconds help_interval{ 1 };
+
+  future::future(object_ref const fn, persistent_hash_map_ref const bindings)
+    : fn{ fn }
+    , bindings{ bindings }
+  {
+  }
+
+  future_ref future::submit(object_ref const fn, executor &e)
+  {
+    auto const ret{ make_box<future>(fn, __rt_ctx->get_thread_bindings()) };
+    ret->owner = &e;
+    e.submit([ret] { ret->run(); });
+    return ret;
+  }
+
+  bool future::equal(object const &o) const
+  {
+    return &o == &base;
+  }
+
+  jtl::immutable_string future::to_string() const
+  {
+    jtl::string_builder buff;
+    to_string(buff);
+    return buff.release();
+  }
+
+  void future::to_string(jtl::string_builder &buff) const
+  {
+    util::format_to(buff, "#object [{} {}]", object_type_str(base.type), &base);
+  }
+
+  jtl::immutable_string future::to_code_string() const
+  {
+    return to_string();
+  }
+
+  void future::to_code_string(jtl::string_builder &buff) const
+  {
+    to_string(buff);
+  }
+
+  uhash future::to_hash() const
+  {
+    return static_cast<uhash>(reinterpret_cast<uintptr_t>(this));
+  }
+
+  void future::run()
+  {
+    {
+      std::lock_guard<std::mutex> const lock{ mutex };
+      if(current_state != state::pending)
+      {
+        return;
+      }
+      current_state = state::running;
+    }
+
+    object_ref ret{};
+    std::exception_ptr err{};
+    try
+    {
+      /* This conveys the creating thread's bindings, the same as binding-conveyor-fn. */
+      context::binding_scope const scope{ bindings };
+      ret = dynamic_call(fn);
+    }
+    catch(...)
+    {
+      err = std::current_exception();
+    }
+
+    {
+      std::lock_guard<std::mutex> const lock{ mutex };
+      val = ret;
+      error = err;
+      current_state = err ? state::failed : state::done;
+      /* We won't need these again, so let the GC have them. */
+      fn = {};
+      bindings = {};
+    }
+    done_cv.notify_all();
+  }
+
+  static bool is_finished(future::state const s)
+  {
+    return s == future::state::done || s == future::state::failed
+      || s == future::state::cancelled;
+  }
+
+  static object_ref result(future const &f)
+  {
+    switch(f.current_state)
+    {
+      case future::state::failed:
+        std::rethrow_exception(f.error);
+      case future::state::cancelled:
+        throw std::runtime_error{ "Unable to deref a cancelled future." };
+      default:
+        return f.val;
+    }
+  }
+
+  object_ref future::deref()
+  {
+    std::unique_lock<std::mutex> lock{ mutex };
+    while(!is_finished(current_state))
+    {
+      /* If we're on a worker thread of the executor running this future, blocking could
+       * starve the pool, or even deadlock it, if every worker ends up waiting. Instead,
+       * we run other queued tasks until this one is finished. */
+      lock.unlock();
+      auto const helped{ owner && owner->run_pending_task() };
+      lock.lock();
+      if(!helped)
+      {
+        done_cv.wait_for(lock, help_interval);
+      }
+    }
+    return result(*this);
+  }
+
+  object_ref future::deref(i64 const timeout_ms, object_ref const timeout_val)
+  {
+    auto const deadline{ std::chrono::steady_clock::now()
+                         + std::chrono::milliseconds{ std::max<i64>(timeout_ms, 0) } };
+    std::unique_lock<std::mutex> lock{ mutex };
+    while(!is_finished(current_state))
+    {
+      auto const now{ std::chrono::steady_clock::now() };
+      if(deadline <= now)
+      {
+        return timeout_val;
+      }
+
+      lock.unlock();
+      auto const helped{ owner && owner->run_pending_task() };
+      lock.lock();
+      if(!helped)
+      {
+        done_cv.wait_until(lock, std::min(deadline, now + help_interval));
+      }
+    }
+    return result(*this);
+  }
+
+  bool future::is_realized() const
+  {
+    return is_done();
+  }
+
+  bool future::is_done() const
+  {
+    std::lock_guard<std::mutex> const lock{ mutex };
+    return is_finished(current_state);
+  }
+
+  bool future::is_cancelled() const
+  {
+    std::lock_guard<std::mutex> const lock{ mutex };
+    return current_state == state::cancelled;
+  }
+
+  bool future::cancel()
+  {
+    {
+      std::lock_guard<std::mutex> const lock{ mutex };
+      if(current_state != state::pending)
+      {
+        return false;
+      }
+      current_state = state::cancelled;
+      fn = {};
+      bindings = {};
+    }
+    done_cv.notify_all();
+    return true;
+  }
+}
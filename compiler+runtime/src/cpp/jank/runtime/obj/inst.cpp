@@ -93,10 +93,15 @@ namespace jank::runtime::obj
   jtl::immutable_string inst::to_code_string() const
   {
     jtl::string_builder buff;
+    to_code_string(buff);
+    return buff.release();
+  }
+
+  void inst::to_code_string(jtl::string_builder &buff) const
+  {
     buff("#inst \"");
     to_string_impl(value, buff);
     buff("\"");
-    return buff.release();
   }
 
   uhash inst::to_hash() const
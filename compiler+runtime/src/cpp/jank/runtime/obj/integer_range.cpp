@@ -4,6 +4,7 @@
 #include <jank/runtime/core/seq.hpp>
 #include <jank/runtime/visit.hpp>
 #include <jank/runtime/behavior/metadatable.hpp>
+#include <jank/runtime/behavior/reducible.hpp>
 
 namespace jank::runtime::obj
 {
@@ -102,6 +103,22 @@ namespace jank::runtime::obj
     return make_box<integer_range>(start, end, step, bounds_check);
   }
 
+  object_ref integer_range::reduce(object_ref const f, object_ref const init) const
+  {
+    object_ref res{ init };
+    auto const n{ count() };
+    auto val{ start->data };
+    for(usize i{}; i < n; ++i, val += step->data)
+    {
+      res = dynamic_call(f, res, make_box(val));
+      if(behavior::detail::unwrap_reduced(res))
+      {
+        break;
+      }
+    }
+    return res;
+  }
+
   integer_ref integer_range::first() const
   {
     return start;
@@ -151,6 +168,11 @@ namespace jank::runtime::obj
     return runtime::to_code_string(seq());
   }
 
+  void integer_range::to_code_string(jtl::string_builder &buff) const
+  {
+    runtime::to_code_string(seq(), buff);
+  }
+
   uhash integer_range::to_hash() const
   {
     return hash::ordered(&base);
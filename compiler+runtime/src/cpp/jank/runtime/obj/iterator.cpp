@@ -2,6 +2,7 @@
 #include <jank/runtime/behavior/callable.hpp>
 #include <jank/runtime/core.hpp>
 #include <jank/runtime/visit.hpp>
+#include <jank/runtime/behavior/reducible.hpp>
 
 namespace jank::runtime::obj
 {
@@ -21,6 +22,34 @@ namespace jank::runtime::obj
     return make_box<iterator>(fn, current);
   }
 
+  /* Only a reduced value can end this. Whatever has already been realized, by walking
+   * this as a seq, is reused, but past that, no nodes are made. */
+  object_ref iterator::reduce(object_ref const f, object_ref const init) const
+  {
+    object_ref res{ init };
+    iterator const *node{ this };
+    auto val{ current };
+    while(true)
+    {
+      res = dynamic_call(f, res, val);
+      if(behavior::detail::unwrap_reduced(res))
+      {
+        return res;
+      }
+
+      if(node && node->cached_next.is_some())
+      {
+        node = node->cached_next.data;
+        val = node->current;
+      }
+      else
+      {
+        node = nullptr;
+        val = dynamic_call(fn, val);
+      }
+    }
+  }
+
   object_ref iterator::first() const
   {
     return current;
@@ -76,6 +105,11 @@ namespace jank::runtime::obj
     return runtime::to_code_string(seq());
   }
 
+  void iterator::to_code_string(jtl::string_builder &buff)
+  {
+    runtime::to_code_string(seq(), buff);
+  }
+
   uhash iterator::to_hash() const
   {
     return hash::ordered(&base);
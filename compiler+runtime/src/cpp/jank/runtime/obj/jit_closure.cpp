@@ -50,6 +50,11 @@ namespace jank::runtime::obj
     return to_string();
   }
 
+  void jit_closure::to_code_string(jtl::string_builder &buff)
+  {
+    to_string(buff);
+  }
+
   uhash jit_closure::to_hash() const
   {
     return static_cast<uhash>(reinterpret_cast<uintptr_t>(this));
@@ -1,3 +1,5 @@
+#include <atomic>
+
 #include <jank/runtime/obj/jit_function.hpp>
 #include <jank/runtime/obj/native_function_wrapper.hpp>
 #include <jank/runtime/obj/nil.hpp>
@@ -7,6 +9,9 @@
 #include <jank/runtime/core/seq.hpp>
 #include <jank/runtime/context.hpp>
 #include <jank/runtime/rtti.hpp>
+#include <jank/runtime/fn_stats.hpp>
+#include <jank/jit/tiering.hpp>
+#include <jank/util/cli.hpp>
 #include <jank/util/fmt.hpp>
 
 namespace jank::runtime::obj
@@ -21,6 +26,12 @@ namespace jank::runtime::obj
   {
   }
 
+  jit_function::jit_function(object_ref const meta, arity_flag_t const arity_flags)
+    : meta{ meta }
+    , arity_flags{ arity_flags }
+  {
+  }
+
   bool jit_function::equal(object const &rhs) const
   {
     return &base == &rhs;
@@ -49,6 +60,11 @@ namespace jank::runtime::obj
     return to_string();
   }
 
+  void jit_function::to_code_string(jtl::string_builder &buff)
+  {
+    to_string(buff);
+  }
+
   uhash jit_function::to_hash() const
   {
     return static_cast<uhash>(reinterpret_cast<uintptr_t>(this));
@@ -57,44 +73,134 @@ namespace jank::runtime::obj
   jit_function_ref jit_function::with_meta(object_ref const m)
   {
     auto const new_meta(behavior::detail::validate_meta(m));
+    if(is_shared)
+    {
+      auto const ret(clone());
+      ret->is_shared = false;
+      ret->meta = new_meta;
+      return ret;
+    }
     meta = new_meta;
     return this;
   }
 
+  jit_function_ref jit_function::clone() const
+  {
+    return make_box<jit_function>(*this);
+  }
+
+  fn_stats::block &jit_function::get_stats()
+  {
+    std::atomic_ref<fn_stats::block *> const ref{ stats };
+    if(auto const b{ ref.load(std::memory_order_acquire) }; b)
+    {
+      return *b;
+    }
+
+    auto const name(get(meta.unwrap_or(jank_nil()), __rt_ctx->intern_keyword("name").expect_ok()));
+    auto &b(fn_stats::find_or_create(name->type == object_type::nil
+                                       ? jtl::immutable_string{ "unknown" }
+                                       : try_object<persistent_string>(name)->data));
+    ref.store(&b, std::memory_order_release);
+    return b;
+  }
+
+  /* With --fn-stats, this counts a call to the arity. With --fn-timing, it also times
+   * the call, until it returns or throws. */
+  struct call_scope
+  {
+    call_scope(jit_function &fn, usize const arity)
+    {
+      if(!fn_stats::is_enabled())
+      {
+        return;
+      }
+
+      b = &fn.get_stats();
+      index = arity;
+      b->calls[arity].fetch_add(1, std::memory_order_relaxed);
+      if(fn_stats::is_timing())
+      {
+        start = fn_stats::cycles();
+      }
+    }
+
+    call_scope(call_scope const &) = delete;
+    call_scope(call_scope &&) = delete;
+
+    ~call_scope()
+    {
+      if(b && start)
+      {
+        b->cycles[index].fetch_add(fn_stats::cycles() - start, std::memory_order_relaxed);
+      }
+    }
+
+    fn_stats::block *b{};
+    usize index{};
+    u64 start{};
+  };
+
+  template <typename F>
+  F jit_function::load_arity(F &arity, usize const index)
+  {
+    if(jit::tiering::is_enabled())
+    {
+      /* This count is racy, on purpose. Missing the odd call under contention doesn't
+       * matter and it keeps calls cheap. */
+      std::atomic_ref<u32> const count{ call_counts[index] };
+      auto const n{ count.load(std::memory_order_relaxed) + 1 };
+      count.store(n, std::memory_order_relaxed);
+      if(n == util::cli::opts.tier_up_threshold)
+      {
+        jit::tiering::request_tier_up(this);
+      }
+    }
+    return std::atomic_ref<F>{ arity }.load(std::memory_order_acquire);
+  }
+
   object_ref jit_function::call()
   {
-    if(!arity_0)
+    auto const fn{ load_arity(arity_0, 0) };
+    if(!fn)
     {
       throw invalid_arity<0>{ runtime::to_code_string(this_object_ref()) };
     }
-    return arity_0(&base);
+    call_scope const scope{ *this, 0 };
+    return fn(&base);
   }
 
   object_ref jit_function::call(object_ref const a1)
   {
-    if(!arity_1)
+    auto const fn{ load_arity(arity_1, 1) };
+    if(!fn)
     {
       throw invalid_arity<1>{ runtime::to_code_string(this_object_ref()) };
     }
-    return arity_1(&base, a1.data);
+    call_scope const scope{ *this, 1 };
+    return fn(&base, a1.data);
   }
 
   object_ref jit_function::call(object_ref const a1, object_ref const a2)
   {
-    if(!arity_2)
+    auto const fn{ load_arity(arity_2, 2) };
+    if(!fn)
     {
       throw invalid_arity<2>{ runtime::to_code_string(this_object_ref()) };
     }
-    return arity_2(&base, a1.data, a2.data);
+    call_scope const scope{ *this, 2 };
+    return fn(&base, a1.data, a2.data);
   }
 
   object_ref jit_function::call(object_ref const a1, object_ref const a2, object_ref const a3)
   {
-    if(!arity_3)
+    auto const fn{ load_arity(arity_3, 3) };
+    if(!fn)
     {
       throw invalid_arity<3>{ runtime::to_code_string(this_object_ref()) };
     }
-    return arity_3(&base, a1.data, a2.data, a3.data);
+    call_scope const scope{ *this, 3 };
+    return fn(&base, a1.data, a2.data, a3.data);
   }
 
   object_ref jit_function::call(object_ref const a1,
@@ -102,11 +208,13 @@ namespace jank::runtime::obj
                                 object_ref const a3,
                                 object_ref const a4)
   {
-    if(!arity_4)
+    auto const fn{ load_arity(arity_4, 4) };
+    if(!fn)
     {
       throw invalid_arity<4>{ runtime::to_code_string(this_object_ref()) };
     }
-    return arity_4(&base, a1.data, a2.data, a3.data, a4.data);
+    call_scope const scope{ *this, 4 };
+    return fn(&base, a1.data, a2.data, a3.data, a4.data);
   }
 
   object_ref jit_function::call(object_ref const a1,
@@ -115,11 +223,13 @@ namespace jank::runtime::obj
                                 object_ref const a4,
                                 object_ref const a5)
   {
-    if(!arity_5)
+    auto const fn{ load_arity(arity_5, 5) };
+    if(!fn)
     {
       throw invalid_arity<5>{ runtime::to_code_string(this_object_ref()) };
     }
-    return arity_5(&base, a1.data, a2.data, a3.data, a4.data, a5.data);
+    call_scope const scope{ *this, 5 };
+    return fn(&base, a1.data, a2.data, a3.data, a4.data, a5.data);
   }
 
   object_ref jit_function::call(object_ref const a1,
@@ -129,11 +239,13 @@ namespace jank::runtime::obj
                                 object_ref const a5,
                                 object_ref const a6)
   {
-    if(!arity_6)
+    auto const fn{ load_arity(arity_6, 6) };
+    if(!fn)
     {
       throw invalid_arity<6>{ runtime::to_code_string(this_object_ref()) };
     }
-    return arity_6(&base, a1.data, a2.data, a3.data, a4.data, a5.data, a6.data);
+    call_scope const scope{ *this, 6 };
+    return fn(&base, a1.data, a2.data, a3.data, a4.data, a5.data, a6.data);
   }
 
   object_ref jit_function::call(object_ref const a1,
@@ -144,11 +256,13 @@ namespace jank::runtime::obj
                                 object_ref const a6,
                                 object_ref const a7)
   {
-    if(!arity_7)
+    auto const fn{ load_arity(arity_7, 7) };
+    if(!fn)
     {
       throw invalid_arity<7>{ runtime::to_code_string(this_object_ref()) };
     }
-    return arity_7(&base, a1.data, a2.data, a3.data, a4.data, a5.data, a6.data, a7.data);
+    call_scope const scope{ *this, 7 };
+    return fn(&base, a1.data, a2.data, a3.data, a4.data, a5.data, a6.data, a7.data);
   }
 
   object_ref jit_function::call(object_ref const a1,
@@ -160,11 +274,13 @@ namespace jank::runtime::obj
                                 object_ref const a7,
                                 object_ref const a8)
   {
-    if(!arity_8)
+    auto const fn{ load_arity(arity_8, 8) };
+    if(!fn)
     {
       throw invalid_arity<8>{ runtime::to_code_string(this_object_ref()) };
     }
-    return arity_8(&base, a1.data, a2.data, a3.data, a4.data, a5.data, a6.data, a7.data, a8.data);
+    call_scope const scope{ *this, 8 };
+    return fn(&base, a1.data, a2.data, a3.data, a4.data, a5.data, a6.data, a7.data, a8.data);
   }
 
   object_ref jit_function::call(object_ref const a1,
@@ -177,11 +293,13 @@ namespace jank::runtime::obj
                                 object_ref const a8,
                                 object_ref const a9)
   {
-    if(!arity_9)
+    auto const fn{ load_arity(arity_9, 9) };
+    if(!fn)
     {
       throw invalid_arity<9>{ runtime::to_code_string(this_object_ref()) };
     }
-    return arity_9(&base,
+    call_scope const scope{ *this, 9 };
+    return fn(&base,
                    a1.data,
                    a2.data,
                    a3.data,
@@ -204,11 +322,13 @@ namespace jank::runtime::obj
                                 object_ref const a9,
                                 object_ref const a10)
   {
-    if(!arity_10)
+    auto const fn{ load_arity(arity_10, 10) };
+    if(!fn)
     {
       throw invalid_arity<10>{ runtime::to_code_string(this_object_ref()) };
     }
-    return arity_10(&base,
+    call_scope const scope{ *this, 10 };
+    return fn(&base,
                     a1.data,
                     a2.data,
                     a3.data,
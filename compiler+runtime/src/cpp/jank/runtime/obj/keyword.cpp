@@ -1,13 +1,19 @@
 #include <jank/runtime/obj/keyword.hpp>
 #include <jank/runtime/obj/symbol.hpp>
+#include <jank/runtime/obj/nil.hpp>
+#include <jank/runtime/obj/persistent_array_map.hpp>
+#include <jank/runtime/obj/persistent_struct_map.hpp>
+#include <jank/runtime/obj/struct_basis.hpp>
 #include <jank/runtime/rtti.hpp>
 #include <jank/runtime/core/seq.hpp>
+#include <jank/runtime/behavior/callable.hpp>
 
 namespace jank::runtime::obj
 {
   keyword::keyword(runtime::detail::must_be_interned, jtl::immutable_string_view const &s)
     : sym{ make_box<obj::symbol>(s) }
   {
+    hash = static_cast<uhash>(sym->to_hash() + hash_magic);
   }
 
   keyword::keyword(runtime::detail::must_be_interned,
@@ -15,6 +21,7 @@ namespace jank::runtime::obj
                    jtl::immutable_string_view const &n)
     : sym{ make_box<obj::symbol>(ns, n) }
   {
+    hash = static_cast<uhash>(sym->to_hash() + hash_magic);
   }
 
   /* Keywords are interned, so we can always count on identity equality. */
@@ -46,9 +53,14 @@ namespace jank::runtime::obj
     return to_string();
   }
 
+  void keyword::to_code_string(jtl::string_builder &buff) const
+  {
+    to_string(buff);
+  }
+
   uhash keyword::to_hash() const
   {
-    return sym->to_hash() + 0x9e3779b9;
+    return hash;
   }
 
   i64 keyword::compare(object const &o) const
@@ -85,4 +97,86 @@ namespace jank::runtime::obj
   {
     return *sym == *rhs.sym;
   }
+
+  jtl::option<object_ref>
+  keyword_call_site::find(object_ref const kw, object_ref const m, object_ref const fallback)
+  {
+    if(m->type == object_type::persistent_array_map)
+    {
+      auto const &data(expect_object<persistent_array_map>(m)->data);
+      auto const guess(array_index.load(std::memory_order_relaxed));
+      if(guess < data.length && data.data[guess].data == kw.data)
+      {
+        return data.data[guess + 1];
+      }
+
+      /* Keywords are interned, so no other key can be equal to this one. */
+      for(u8 i{}; i < data.length; i += 2)
+      {
+        if(data.data[i].data == kw.data)
+        {
+          array_index.store(i, std::memory_order_relaxed);
+          return data.data[i + 1];
+        }
+      }
+      return fallback;
+    }
+    else if(m->type == object_type::persistent_struct_map)
+    {
+      auto const typed_m(expect_object<persistent_struct_map>(m));
+      auto const &keys(typed_m->data.basis->keys);
+      auto const guess(struct_slot.load(std::memory_order_relaxed));
+      if(guess < keys.size() && keys[guess].data == kw.data)
+      {
+        return typed_m->data.slots[guess];
+      }
+
+      auto const slot(typed_m->data.basis->slot(kw));
+      if(slot.is_some())
+      {
+        struct_slot.store(static_cast<u32>(slot.unwrap()), std::memory_order_relaxed);
+        return typed_m->data.slots[slot.unwrap()];
+      }
+      return typed_m->get(kw, fallback);
+    }
+
+    return none;
+  }
+
+  object_ref keyword_call_site::get(object_ref const kw, object_ref const m)
+  {
+    return get(kw, m, jank_nil());
+  }
+
+  object_ref
+  keyword_call_site::get(object_ref const kw, object_ref const m, object_ref const fallback)
+  {
+    auto const found(find(kw, m, fallback));
+    if(found.is_some())
+    {
+      return found.unwrap();
+    }
+    return runtime::get(m, kw, fallback);
+  }
+
+  object_ref keyword_call_site::call(object_ref const m, object_ref const kw)
+  {
+    auto const found(find(kw, m, jank_nil()));
+    if(found.is_some())
+    {
+      return found.unwrap();
+    }
+    return dynamic_call(m, kw);
+  }
+
+  object_ref
+  keyword_call_site::call(object_ref const m, object_ref const kw, object_ref const fallback)
+  {
+    auto const found(find(kw, m, fallback));
+    if(found.is_some())
+    {
+      return found.unwrap();
+    }
+    return dynamic_call(m, kw, fallback);
+  }
 }
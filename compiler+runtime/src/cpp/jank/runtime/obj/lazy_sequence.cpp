@@ -1,3 +1,5 @@
+#include <thread>
+
 #include <jank/runtime/obj/lazy_sequence.hpp>
 #include <jank/runtime/obj/persistent_list.hpp>
 #include <jank/runtime/obj/nil.hpp>
@@ -20,6 +22,67 @@ namespace jank::runtime::obj
   lazy_sequence::lazy_sequence(object_ref const fn, object_ref const sequence)
     : fn{ fn }
     , s{ sequence }
+    , realized{ fn.is_nil() }
+  {
+  }
+
+  /* The lock is reentrant. A thread realizing a seq may end up back in it before its fn
+   * returns, most often when the fn derefs a future, such as within pmap, and the deref
+   * helps out by running other pool tasks, one of which reads this same seq. Waiting
+   * there would deadlock on ourselves, so the owner just carries on, as it would with a
+   * synchronized method in Clojure. */
+  struct realize_lock
+  {
+    realize_lock(lazy_sequence const &ls)
+      : ls{ ls }
+      , acquired{ ls.owner.load(std::memory_order_relaxed) != std::this_thread::get_id() }
+    {
+      if(!acquired)
+      {
+        return;
+      }
+      while(ls.busy.test_and_set(std::memory_order_acquire))
+      {
+        ls.busy.wait(true, std::memory_order_relaxed);
+      }
+      ls.owner.store(std::this_thread::get_id(), std::memory_order_relaxed);
+    }
+
+    realize_lock(realize_lock const &) = delete;
+    realize_lock(realize_lock &&) = delete;
+
+    ~realize_lock()
+    {
+      if(!acquired)
+      {
+        return;
+      }
+      ls.owner.store({}, std::memory_order_relaxed);
+      ls.busy.clear(std::memory_order_release);
+      ls.busy.notify_all();
+    }
+
+    realize_lock &operator=(realize_lock const &) = delete;
+    realize_lock &operator=(realize_lock &&) = delete;
+
+    lazy_sequence const &ls;
+    /* False when this thread already held the lock further up the stack. */
+    bool const acquired{};
+  };
+
+  lazy_sequence::lazy_sequence(lazy_sequence const &o)
+    : base{ o.base }
+    , meta{ o.meta }
+  {
+    realize_lock const lock{ o };
+    fn = o.fn;
+    sv = o.sv;
+    s = o.s;
+    realized.store(o.realized.load(std::memory_order_relaxed), std::memory_order_relaxed);
+  }
+
+  lazy_sequence::lazy_sequence(lazy_sequence &&o) noexcept
+    : lazy_sequence{ o }
   {
   }
 
@@ -82,6 +145,11 @@ namespace jank::runtime::obj
     return runtime::to_code_string(seq());
   }
 
+  void lazy_sequence::to_code_string(jtl::string_builder &buff) const
+  {
+    runtime::to_code_string(seq(), buff);
+  }
+
   uhash lazy_sequence::to_hash() const
   {
     auto const s(seq());
@@ -99,7 +167,20 @@ namespace jank::runtime::obj
 
   void lazy_sequence::realize() const
   {
-    /* TODO: Lock. */
+    if(realized.load(std::memory_order_acquire))
+    {
+      return;
+    }
+
+    /* If the fn throws, we're left unrealized, so the next access calls it again, the same
+     * as in Clojure. The lazy seqs our fn gives back are unwrapped with their own locks,
+     * taken while we hold ours, which only ever nests outer to inner. */
+    realize_lock const lock{ *this };
+    if(realized.load(std::memory_order_relaxed))
+    {
+      return;
+    }
+
     force();
     if(sv.is_some())
     {
@@ -111,29 +192,34 @@ namespace jank::runtime::obj
       }
       s = runtime::seq(ls);
     }
+    realized.store(true, std::memory_order_release);
   }
 
   void lazy_sequence::force() const
   {
     if(fn.is_some())
     {
-      sv = dynamic_call(fn);
+      auto const ret(dynamic_call(fn));
+      /* A reentrant access may have forced us already, while fn was running. Its result
+       * has already been seen, so it's the one we keep. */
+      if(fn.is_nil() || realized.load(std::memory_order_relaxed))
+      {
+        return;
+      }
+      sv = ret;
       fn = jank_nil();
     }
   }
 
-  void lazy_sequence::lock_and_force() const
-  {
-    /* TODO: Lock */
-    force();
-  }
-
   object_ref lazy_sequence::sval() const
   {
-    if(fn.is_some())
+    if(realized.load(std::memory_order_acquire))
     {
-      lock_and_force();
+      return s;
     }
+
+    realize_lock const lock{ *this };
+    force();
     if(sv.is_some())
     {
       return sv;
@@ -150,6 +236,17 @@ namespace jank::runtime::obj
     return ls;
   }
 
+  bool lazy_sequence::is_realized() const
+  {
+    if(realized.load(std::memory_order_acquire))
+    {
+      return true;
+    }
+
+    realize_lock const lock{ *this };
+    return fn.is_nil();
+  }
+
   lazy_sequence_ref lazy_sequence::with_meta(object_ref const m) const
   {
     auto const ret(make_box<lazy_sequence>(jank_nil(), seq()));
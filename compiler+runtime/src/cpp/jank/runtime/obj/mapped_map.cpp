@@ -0,0 +1,78 @@
+#include <jank/runtime/obj/mapped_map.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
+#include <jank/runtime/obj/persistent_vector.hpp>
+#include <jank/runtime/obj/nil.hpp>
+#include <jank/runtime/rtti.hpp>
+
+namespace jank::runtime::obj
+{
+  mapped_map::mapped_map(value_type const &d)
+    : data{ d }
+  {
+  }
+
+  mapped_map::mapped_map(jtl::option<object_ref> const &meta, value_type const &d)
+    : parent_type{ meta }
+    , data{ d }
+  {
+  }
+
+  persistent_hash_map_ref mapped_map::to_persistent() const
+  {
+    runtime::detail::native_transient_hash_map ret;
+    for(auto const &pair : data)
+    {
+      ret.set(pair.first, pair.second);
+    }
+    return make_box<persistent_hash_map>(meta, ret.persistent());
+  }
+
+  object_ref mapped_map::get(object_ref const key) const
+  {
+    return data.find(key).unwrap_or(jank_nil());
+  }
+
+  object_ref mapped_map::get(object_ref const key, object_ref const fallback) const
+  {
+    return data.find(key).unwrap_or(fallback);
+  }
+
+  object_ref mapped_map::get_entry(object_ref const key) const
+  {
+    auto const res(data.find(key));
+    if(res.is_some())
+    {
+      return make_box<persistent_vector>(std::in_place, key, res.unwrap());
+    }
+    return jank_nil();
+  }
+
+  bool mapped_map::contains(object_ref const key) const
+  {
+    return data.find(key).is_some();
+  }
+
+  object_ref mapped_map::assoc(object_ref const key, object_ref const val) const
+  {
+    return to_persistent()->assoc(key, val);
+  }
+
+  object_ref mapped_map::dissoc(object_ref const key) const
+  {
+    if(!contains(key))
+    {
+      return this;
+    }
+    return to_persistent()->dissoc(key);
+  }
+
+  object_ref mapped_map::call(object_ref const o) const
+  {
+    return get(o);
+  }
+
+  object_ref mapped_map::call(object_ref const o, object_ref const fallback) const
+  {
+    return get(o, fallback);
+  }
+}
@@ -0,0 +1,288 @@
+#include <jank/runtime/obj/mapped_vector.hpp>
+#include <jank/runtime/obj/mapped_vector_sequence.hpp>
+#include <jank/runtime/obj/persistent_vector.hpp>
+#include <jank/runtime/data_image.hpp>
+#include <jank/runtime/visit.hpp>
+#include <jank/runtime/core/equal.hpp>
+#include <jank/runtime/core/seq.hpp>
+#include <jank/runtime/core/seq_ext.hpp>
+#include <jank/runtime/sequence_range.hpp>
+#include <jank/runtime/behavior/metadatable.hpp>
+#include <jank/runtime/behavior/reducible.hpp>
+#include <jank/util/fmt.hpp>
+
+namespace jank::runtime::obj
+{
+  object_ref mapped_vector::boxed_iterator::operator*() const
+  {
+    return vec->at(index);
+  }
+
+  mapped_vector::boxed_iterator &mapped_vector::boxed_iterator::operator++()
+  {
+    ++index;
+    return *this;
+  }
+
+  bool mapped_vector::boxed_iterator::operator==(boxed_iterator const &rhs) const
+  {
+    return index == rhs.index;
+  }
+
+  bool mapped_vector::boxed_iterator::operator!=(boxed_iterator const &rhs) const
+  {
+    return index != rhs.index;
+  }
+
+  mapped_vector::mapped_vector(data_image const * const image, u64 const offset)
+    : image{ image }
+    , offset{ offset }
+    , length{ image->count_at(offset, sizeof(u64)) }
+  {
+  }
+
+  persistent_vector_ref mapped_vector::to_persistent() const
+  {
+    runtime::detail::native_transient_vector ret;
+    for(usize i{}; i < length; ++i)
+    {
+      ret.push_back(at(i));
+    }
+    return make_box<persistent_vector>(meta, ret.persistent());
+  }
+
+  object_ref mapped_vector::at(usize const index) const
+  {
+    /* Past the tag and the count. */
+    return image->read(image->child_at(offset, offset + 1 + sizeof(u64) + index * sizeof(u64)));
+  }
+
+  mapped_vector::boxed_iterator mapped_vector::begin() const
+  {
+    return { this, 0 };
+  }
+
+  mapped_vector::boxed_iterator mapped_vector::end() const
+  {
+    return { this, length };
+  }
+
+  bool mapped_vector::equal(object const &o) const
+  {
+    if(&o == &base)
+    {
+      return true;
+    }
+
+    auto const v{ dyn_cast<mapped_vector>(&o) };
+    if(v.is_some() && v->image == image && v->offset == offset)
+    {
+      return true;
+    }
+    return runtime::equal(o, begin(), end());
+  }
+
+  jtl::immutable_string mapped_vector::to_string() const
+  {
+    jtl::string_builder buff;
+    to_string(buff);
+    return buff.release();
+  }
+
+  void mapped_vector::to_string(jtl::string_builder &buff) const
+  {
+    runtime::to_string(begin(), end(), "[", ']', buff);
+  }
+
+  jtl::immutable_string mapped_vector::to_code_string() const
+  {
+    jtl::string_builder buff;
+    to_code_string(buff);
+    return buff.release();
+  }
+
+  void mapped_vector::to_code_string(jtl::string_builder &buff) const
+  {
+    runtime::to_code_string(begin(), end(), "[", ']', buff);
+  }
+
+  uhash mapped_vector::to_hash() const
+  {
+    if(hash != 0)
+    {
+      return hash;
+    }
+
+    return hash = hash::ordered(begin(), end());
+  }
+
+  mapped_vector_ref mapped_vector::with_meta(object_ref const m) const
+  {
+    auto const meta(behavior::detail::validate_meta(m));
+    auto ret(make_box<mapped_vector>(*this));
+    ret->meta = meta;
+    return ret;
+  }
+
+  mapped_vector_sequence_ref mapped_vector::seq() const
+  {
+    return fresh_seq();
+  }
+
+  mapped_vector_sequence_ref mapped_vector::fresh_seq() const
+  {
+    if(length == 0)
+    {
+      return {};
+    }
+    return make_box<mapped_vector_sequence>(const_cast<mapped_vector *>(this), 0);
+  }
+
+  object_ref mapped_vector::reduce(object_ref const f, object_ref const init) const
+  {
+    return behavior::detail::reduce_range(f, init, begin(), end(), [](object_ref const e) {
+      return e;
+    });
+  }
+
+  object_ref mapped_vector::reduce_kv(object_ref const f, object_ref const init) const
+  {
+    object_ref res{ init };
+    for(usize i{}; i < length; ++i)
+    {
+      res = dynamic_call(f, res, make_box(i), at(i));
+      if(behavior::detail::unwrap_reduced(res))
+      {
+        break;
+      }
+    }
+    return res;
+  }
+
+  usize mapped_vector::count() const
+  {
+    return length;
+  }
+
+  object_ref mapped_vector::get(object_ref const key) const
+  {
+    return get(key, jank_nil());
+  }
+
+  object_ref mapped_vector::get(object_ref const key, object_ref const fallback) const
+  {
+    if(key->type == object_type::integer)
+    {
+      auto const i(expect_object<integer>(key)->data);
+      if(i < 0 || length <= static_cast<usize>(i))
+      {
+        return fallback;
+      }
+      return at(static_cast<usize>(i));
+    }
+    else
+    {
+      return fallback;
+    }
+  }
+
+  object_ref mapped_vector::get_entry(object_ref const key) const
+  {
+    if(key->type == object_type::integer)
+    {
+      auto const i(expect_object<integer>(key)->data);
+      if(i < 0 || length <= static_cast<usize>(i))
+      {
+        return jank_nil();
+      }
+      return make_box<persistent_vector>(std::in_place, key, at(static_cast<usize>(i)));
+    }
+    else
+    {
+      return jank_nil();
+    }
+  }
+
+  bool mapped_vector::contains(object_ref const key) const
+  {
+    if(key->type == object_type::integer)
+    {
+      auto const i(expect_object<integer>(key)->data);
+      return i >= 0 && static_cast<usize>(i) < length;
+    }
+    else
+    {
+      return false;
+    }
+  }
+
+  persistent_vector_ref mapped_vector::assoc(object_ref const key, object_ref const val) const
+  {
+    return to_persistent()->assoc(key, val);
+  }
+
+  persistent_vector_ref mapped_vector::dissoc(object_ref const /*key*/) const
+  {
+    throw std::runtime_error{ "Type 'mapped_vector' does not support 'dissoc'." };
+  }
+
+  persistent_vector_ref mapped_vector::conj(object_ref const head) const
+  {
+    return to_persistent()->conj(head);
+  }
+
+  object_ref mapped_vector::peek() const
+  {
+    if(length == 0)
+    {
+      return jank_nil();
+    }
+
+    return at(length - 1);
+  }
+
+  persistent_vector_ref mapped_vector::pop() const
+  {
+    if(length == 0)
+    {
+      throw std::runtime_error{ "cannot pop an empty vector" };
+    }
+
+    runtime::detail::native_transient_vector ret;
+    for(usize i{}; i + 1 < length; ++i)
+    {
+      ret.push_back(at(i));
+    }
+    return make_box<persistent_vector>(meta, ret.persistent());
+  }
+
+  object_ref mapped_vector::nth(object_ref const index) const
+  {
+    if(index->type == object_type::integer)
+    {
+      auto const i(expect_object<integer>(index)->data);
+      if(i < 0 || length <= static_cast<usize>(i))
+      {
+        throw std::runtime_error{
+          util::format("out of bounds index {}; vector has a size of {}", i, length)
+        };
+      }
+      return at(static_cast<usize>(i));
+    }
+    else
+    {
+      throw std::runtime_error{ util::format("nth on a vector must be an integer; found {}",
+                                             runtime::to_string(index)) };
+    }
+  }
+
+  object_ref mapped_vector::nth(object_ref const index, object_ref const fallback) const
+  {
+    return get(index, fallback);
+  }
+
+  object_ref mapped_vector::call(object_ref const o) const
+  {
+    return get(o);
+  }
+}
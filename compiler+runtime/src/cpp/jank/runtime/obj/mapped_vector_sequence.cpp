@@ -0,0 +1,109 @@
+#include <jank/runtime/obj/mapped_vector_sequence.hpp>
+#include <jank/runtime/obj/mapped_vector.hpp>
+#include <jank/runtime/core.hpp>
+#include <jank/runtime/core/seq_ext.hpp>
+
+namespace jank::runtime::obj
+{
+  mapped_vector_sequence::mapped_vector_sequence(mapped_vector_ref const v,
+                                                       usize const i)
+    : vec{ v }
+    , index{ i }
+  {
+    jank_debug_assert(index < v->count());
+  }
+
+  /* behavior::object_like */
+  bool mapped_vector_sequence::equal(object const &o) const
+  {
+    return runtime::equal(o, mapped_vector::boxed_iterator{ vec.data, index }, vec->end());
+  }
+
+  void mapped_vector_sequence::to_string(jtl::string_builder &buff) const
+  {
+    runtime::to_string(mapped_vector::boxed_iterator{ vec.data, index },
+                       vec->end(),
+                       "(",
+                       ')',
+                       buff);
+  }
+
+  jtl::immutable_string mapped_vector_sequence::to_string() const
+  {
+    jtl::string_builder buff;
+    to_string(buff);
+    return buff.release();
+  }
+
+  jtl::immutable_string mapped_vector_sequence::to_code_string() const
+  {
+    jtl::string_builder buff;
+    to_code_string(buff);
+    return buff.release();
+  }
+
+  void mapped_vector_sequence::to_code_string(jtl::string_builder &buff) const
+  {
+    runtime::to_code_string(mapped_vector::boxed_iterator{ vec.data, index },
+                            vec->end(),
+                            "(",
+                            ')',
+                            buff);
+  }
+
+  uhash mapped_vector_sequence::to_hash() const
+  {
+    return hash::ordered(mapped_vector::boxed_iterator{ vec.data, index }, vec->end());
+  }
+
+  /* behavior::countable */
+  usize mapped_vector_sequence::count() const
+  {
+    return vec->count() - index;
+  }
+
+  /* behavior::seqable */
+  mapped_vector_sequence_ref mapped_vector_sequence::seq()
+  {
+    return this;
+  }
+
+  mapped_vector_sequence_ref mapped_vector_sequence::fresh_seq() const
+  {
+    return make_box<mapped_vector_sequence>(vec, index);
+  }
+
+  /* behavior::sequenceable */
+  object_ref mapped_vector_sequence::first() const
+  {
+    return vec->at(index);
+  }
+
+  mapped_vector_sequence_ref mapped_vector_sequence::next() const
+  {
+    auto const n(index + 1);
+    if(n == vec->count())
+    {
+      return {};
+    }
+
+    return make_box<mapped_vector_sequence>(vec, n);
+  }
+
+  mapped_vector_sequence_ref mapped_vector_sequence::next_in_place()
+  {
+    ++index;
+
+    if(index == vec->count())
+    {
+      return {};
+    }
+
+    return this;
+  }
+
+  cons_ref mapped_vector_sequence::conj(object_ref const head)
+  {
+    return make_box<cons>(head, this);
+  }
+}
@@ -17,8 +17,9 @@ namespace jank::runtime::obj
     , default_dispatch_value{ default_ }
     , hierarchy{ hierarchy }
     , method_table{ persistent_hash_map::empty() }
-    , method_cache{ persistent_hash_map::empty() }
     , prefer_table{ persistent_hash_map::empty() }
+    /* A nil hierarchy won't match the real one, so the first dispatch builds the cache. */
+    , cache{ new(GC) dispatch_cache{ jank_nil(), persistent_hash_map::empty() } }
     , name{ try_object<symbol>(name) }
   {
   }
@@ -49,6 +50,11 @@ namespace jank::runtime::obj
     return to_string();
   }
 
+  void multi_function::to_code_string(jtl::string_builder &buff)
+  {
+    to_string(buff);
+  }
+
   uhash multi_function::to_hash() const
   {
     return static_cast<uhash>(reinterpret_cast<uintptr_t>(this));
@@ -199,17 +205,23 @@ namespace jank::runtime::obj
   multi_function_ref multi_function::reset()
   {
     std::lock_guard<std::recursive_mutex> const locked{ data_lock };
-    cached_hierarchy = jank_nil();
-    method_table = prefer_table = method_cache = persistent_hash_map::empty();
+    method_table = prefer_table = persistent_hash_map::empty();
+    publish_cache(jank_nil(), method_table);
     return this;
   }
 
   persistent_hash_map_ref multi_function::reset_cache()
   {
     std::lock_guard<std::recursive_mutex> const locked{ data_lock };
-    cached_hierarchy = hierarchy;
-    method_cache = method_table;
-    return method_cache;
+    publish_cache(deref(hierarchy), method_table);
+    return method_table;
+  }
+
+  void multi_function::publish_cache(object_ref const hierarchy,
+                                     persistent_hash_map_ref const methods)
+  {
+    /* Readers may still be using the old snapshot, so it's left for the GC. */
+    cache.store(new(GC) dispatch_cache{ hierarchy, methods }, std::memory_order_release);
   }
 
   multi_function_ref
@@ -297,7 +309,8 @@ namespace jank::runtime::obj
                                    object_ref const x,
                                    object_ref const y) const
   {
-    return is_preferred(hierarchy, x, y) || is_a(hierarchy, x, y);
+    /* is_a takes the hierarchy's reference, but is_preferred needs its value. */
+    return is_preferred(deref(hierarchy), x, y) || is_a(hierarchy, x, y);
   }
 
   object_ref multi_function::get_fn(object_ref const dispatch_val)
@@ -314,15 +327,14 @@ namespace jank::runtime::obj
 
   object_ref multi_function::get_method(object_ref const dispatch_val)
   {
-    if(cached_hierarchy != deref(hierarchy))
-    {
-      reset_cache();
-    }
-
-    auto target(method_cache->get(dispatch_val));
-    if(target != jank_nil())
+    auto const snapshot(cache.load(std::memory_order_acquire));
+    if(snapshot->hierarchy == deref(hierarchy))
     {
-      return target;
+      auto const target(snapshot->methods->get(dispatch_val));
+      if(target != jank_nil())
+      {
+        return target;
+      }
     }
 
     return find_and_cache_best_method(dispatch_val);
@@ -330,8 +342,21 @@ namespace jank::runtime::obj
 
   object_ref multi_function::find_and_cache_best_method(object_ref const dispatch_val)
   {
-    /* TODO: Clojure uses a RW lock here for better parallelism. */
     std::lock_guard<std::recursive_mutex> const locked{ data_lock };
+
+    auto const current_hierarchy(deref(hierarchy));
+    auto snapshot(cache.load(std::memory_order_acquire));
+    if(snapshot->hierarchy != current_hierarchy)
+    {
+      publish_cache(current_hierarchy, method_table);
+      snapshot = cache.load(std::memory_order_acquire);
+    }
+    /* Another thread may have cached this while we were waiting for the lock. */
+    else if(auto const cached(snapshot->methods->get(dispatch_val)); cached != jank_nil())
+    {
+      return cached;
+    }
+
     object_ref best_value{ jank_nil() };
     persistent_vector_sequence_ref best_entry{};
 
@@ -340,14 +365,14 @@ namespace jank::runtime::obj
       auto const entry(it->first());
       auto const entry_key(entry->seq()->first());
 
-      if(is_a(cached_hierarchy, dispatch_val, entry_key))
+      if(is_a(hierarchy, dispatch_val, entry_key))
       {
-        if(best_entry.is_nil() || is_dominant(cached_hierarchy, entry_key, best_entry->first()))
+        if(best_entry.is_nil() || is_dominant(hierarchy, entry_key, best_entry->first()))
         {
           best_entry = entry->seq();
         }
 
-        if(!is_dominant(cached_hierarchy, best_entry->first(), entry_key))
+        if(!is_dominant(hierarchy, best_entry->first(), entry_key))
         {
           throw std::runtime_error{ util::format(
             "Multiple methods in multimethod '{}' match dispatch value: {} -> {} and {}, and "
@@ -373,7 +398,7 @@ namespace jank::runtime::obj
       }
     }
 
-    method_cache = method_cache->assoc(dispatch_val, best_value);
+    publish_cache(current_hierarchy, snapshot->methods->assoc(dispatch_val, best_value));
 
     return best_value;
   }
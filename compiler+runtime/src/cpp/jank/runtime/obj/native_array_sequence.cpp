@@ -44,10 +44,15 @@ namespace jank::runtime::obj
   jtl::immutable_string native_array_sequence::to_code_string() const
   {
     jtl::string_builder buff;
-    runtime::to_code_string(arr + index, arr + size, "(", ')', buff);
+    to_code_string(buff);
     return buff.release();
   }
 
+  void native_array_sequence::to_code_string(jtl::string_builder &buff) const
+  {
+    runtime::to_code_string(arr + index, arr + size, "(", ')', buff);
+  }
+
   uhash native_array_sequence::to_hash() const
   {
     return hash::ordered(arr + index, arr + size);
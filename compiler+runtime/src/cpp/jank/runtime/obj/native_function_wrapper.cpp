@@ -47,6 +47,11 @@ namespace jank::runtime::obj
     return to_string();
   }
 
+  void native_function_wrapper::to_code_string(jtl::string_builder &buff) const
+  {
+    to_string(buff);
+  }
+
   uhash native_function_wrapper::to_hash() const
   {
     return static_cast<uhash>(reinterpret_cast<uintptr_t>(this));
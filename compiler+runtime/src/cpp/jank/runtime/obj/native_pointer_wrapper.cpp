@@ -37,6 +37,11 @@ namespace jank::runtime::obj
     return to_string();
   }
 
+  void native_pointer_wrapper::to_code_string(jtl::string_builder &buff) const
+  {
+    to_string(buff);
+  }
+
   uhash native_pointer_wrapper::to_hash() const
   {
     return static_cast<uhash>(reinterpret_cast<uintptr_t>(data));
@@ -1,4 +1,5 @@
 #include <jank/runtime/obj/native_vector_sequence.hpp>
+#include <jank/runtime/obj/array_chunk.hpp>
 #include <jank/runtime/core.hpp>
 #include <jank/runtime/core/seq_ext.hpp>
 
@@ -52,10 +53,15 @@ namespace jank::runtime::obj
   jtl::immutable_string native_vector_sequence::to_code_string() const
   {
     jtl::string_builder buff;
-    runtime::to_code_string(data.begin(), data.end(), "(", ')', buff);
+    to_code_string(buff);
     return buff.release();
   }
 
+  void native_vector_sequence::to_code_string(jtl::string_builder &buff) const
+  {
+    runtime::to_code_string(data.begin(), data.end(), "(", ')', buff);
+  }
+
   uhash native_vector_sequence::to_hash()
   {
     return hash::ordered(data.begin(), data.end());
@@ -111,6 +117,24 @@ namespace jank::runtime::obj
     return this;
   }
 
+  array_chunk_ref native_vector_sequence::chunked_first() const
+  {
+    auto const begin{ data.begin() + index };
+    auto const end{ data.begin() + std::min(index + chunk_size, data.size()) };
+    return make_box<array_chunk>(native_vector<object_ref>{ begin, end }, static_cast<usize>(0));
+  }
+
+  native_vector_sequence_ref native_vector_sequence::chunked_next() const
+  {
+    auto const n{ index + chunk_size };
+    if(data.size() <= n)
+    {
+      return {};
+    }
+
+    return make_box<native_vector_sequence>(data, n);
+  }
+
   cons_ref native_vector_sequence::conj(object_ref const head)
   {
     return make_box<cons>(head, data.empty() ? nullptr : this);
@@ -20,6 +20,11 @@ namespace jank::runtime::obj
     return to_string();
   }
 
+  void nil::to_code_string(jtl::string_builder &buff) const
+  {
+    to_string(buff);
+  }
+
   void nil::to_string(jtl::string_builder &buff) const
   {
     buff("nil");
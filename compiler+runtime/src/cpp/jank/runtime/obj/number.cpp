@@ -1,3 +1,4 @@
+#include <array>
 #include <cmath>
 
 #include <jank/runtime/obj/number.hpp>
@@ -40,6 +41,11 @@ namespace jank::runtime::obj
     return to_string();
   }
 
+  void boolean::to_code_string(jtl::string_builder &buff) const
+  {
+    to_string(buff);
+  }
+
   uhash boolean::to_hash() const
   {
     return data ? 1231 : 1237;
@@ -99,6 +105,11 @@ namespace jank::runtime::obj
     return to_string();
   }
 
+  void integer::to_code_string(jtl::string_builder &buff) const
+  {
+    to_string(buff);
+  }
+
   uhash integer::to_hash() const
   {
     return hash::integer(data);
@@ -182,6 +193,11 @@ namespace jank::runtime::obj
     return to_string();
   }
 
+  void real::to_code_string(jtl::string_builder &buff) const
+  {
+    to_string(buff);
+  }
+
   uhash real::to_hash() const
   {
     return hash::real(data);
@@ -231,4 +247,21 @@ namespace jank::runtime
   obj::boolean_ref jank_true{ true_const() };
   /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
   obj::boolean_ref jank_false{ false_const() };
+
+  namespace detail
+  {
+    static obj::integer *small_integers_const()
+    {
+      /* These are pointer free, so the GC doesn't need to scan them. */
+      static std::array<obj::integer, small_integer_max - small_integer_min + 1> r;
+      for(usize i{}; i < r.size(); ++i)
+      {
+        r[i].data = small_integer_min + static_cast<i64>(i);
+      }
+      return r.data() - small_integer_min;
+    }
+
+    /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+    obj::integer *small_integers{ small_integers_const() };
+  }
 }
@@ -39,6 +39,11 @@ namespace jank::runtime::obj
     return to_string();
   }
 
+  void opaque_box::to_code_string(jtl::string_builder &buff) const
+  {
+    to_string(buff);
+  }
+
   uhash opaque_box::to_hash() const
   {
     return static_cast<uhash>(reinterpret_cast<uintptr_t>(data.data));
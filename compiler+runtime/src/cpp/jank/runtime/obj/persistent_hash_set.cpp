@@ -84,14 +84,23 @@ namespace jank::runtime::obj
   jtl::immutable_string persistent_hash_set::to_code_string() const
   {
     jtl::string_builder buff;
-    runtime::to_code_string(data.begin(), data.end(), "#{", '}', buff);
+    to_code_string(buff);
     return buff.release();
   }
 
-  /* TODO: Cache this. */
+  void persistent_hash_set::to_code_string(jtl::string_builder &buff) const
+  {
+    runtime::to_code_string(data.begin(), data.end(), "#{", '}', buff);
+  }
+
   uhash persistent_hash_set::to_hash() const
   {
-    return hash::unordered(data.begin(), data.end());
+    if(hash != 0)
+    {
+      return hash;
+    }
+
+    return hash = hash::unordered(data.begin(), data.end());
   }
 
   persistent_hash_set_sequence_ref persistent_hash_set::seq() const
@@ -118,6 +127,7 @@ namespace jank::runtime::obj
     auto const meta(behavior::detail::validate_meta(m));
     auto ret(make_box<persistent_hash_set>(data));
     ret->meta = meta;
+    ret->hash = hash;
     return ret;
   }
 
@@ -0,0 +1,138 @@
+#include <jank/runtime/obj/persistent_int_map.hpp>
+#include <jank/runtime/obj/persistent_vector.hpp>
+#include <jank/runtime/obj/transient_int_map.hpp>
+#include <jank/runtime/visit.hpp>
+#include <jank/runtime/core/seq.hpp>
+#include <jank/runtime/sequence_range.hpp>
+#include <jank/util/fmt.hpp>
+
+namespace jank::runtime::obj
+{
+  persistent_int_map::persistent_int_map(value_type &&d)
+    : data{ std::move(d) }
+  {
+  }
+
+  persistent_int_map::persistent_int_map(value_type const &d)
+    : data{ d }
+  {
+  }
+
+  persistent_int_map::persistent_int_map(jtl::option<object_ref> const &meta, value_type &&d)
+    : parent_type{ meta }
+    , data{ std::move(d) }
+  {
+  }
+
+  persistent_int_map_ref persistent_int_map::empty()
+  {
+    static auto const ret(make_box<persistent_int_map>());
+    return ret;
+  }
+
+  persistent_int_map_ref persistent_int_map::create_from_seq(object_ref const seq)
+  {
+    runtime::detail::native_transient_int_map transient;
+    auto const r{ make_sequence_range(seq) };
+    for(auto it{ r.begin() }; it != r.end(); ++it)
+    {
+      auto const key(*it);
+      ++it;
+      if(it == r.end())
+      {
+        throw std::runtime_error{ util::format("Odd number of elements: {}",
+                                               runtime::to_code_string(seq)) };
+      }
+      transient.set(expect_key(key), *it);
+    }
+    return make_box<persistent_int_map>(transient.persistent());
+  }
+
+  obj::integer_ref persistent_int_map::expect_key(object_ref const key)
+  {
+    if(key->type != object_type::integer)
+    {
+      throw std::runtime_error{ util::format("int map keys must be integers; found {}",
+                                             runtime::to_code_string(key)) };
+    }
+    return expect_object<obj::integer>(key);
+  }
+
+  object_ref persistent_int_map::get(object_ref const key) const
+  {
+    return get(key, jank_nil());
+  }
+
+  object_ref persistent_int_map::get(object_ref const key, object_ref const fallback) const
+  {
+    if(key->type != object_type::integer)
+    {
+      return fallback;
+    }
+    auto const res(data.find(expect_object<obj::integer>(key)->data));
+    if(res.is_some())
+    {
+      return res.unwrap();
+    }
+    return fallback;
+  }
+
+  object_ref persistent_int_map::get_entry(object_ref const key) const
+  {
+    if(key->type != object_type::integer)
+    {
+      return jank_nil();
+    }
+    auto const res(data.find(expect_object<obj::integer>(key)->data));
+    if(res.is_some())
+    {
+      return make_box<persistent_vector>(std::in_place, key, res.unwrap());
+    }
+    return jank_nil();
+  }
+
+  bool persistent_int_map::contains(object_ref const key) const
+  {
+    return key->type == object_type::integer
+      && data.contains(expect_object<obj::integer>(key)->data);
+  }
+
+  persistent_int_map_ref
+  persistent_int_map::assoc(object_ref const key, object_ref const val) const
+  {
+    auto copy(data.set(expect_key(key), val));
+    return make_box<persistent_int_map>(meta, std::move(copy));
+  }
+
+  persistent_int_map_ref persistent_int_map::dissoc(object_ref const key) const
+  {
+    if(key->type != object_type::integer)
+    {
+      return this;
+    }
+    auto copy(data.erase(expect_object<obj::integer>(key)->data));
+    return make_box<persistent_int_map>(meta, std::move(copy));
+  }
+
+  object_ref persistent_int_map::call(object_ref const o) const
+  {
+    return get(o);
+  }
+
+  object_ref persistent_int_map::call(object_ref const o, object_ref const fallback) const
+  {
+    return get(o, fallback);
+  }
+
+  transient_int_map_ref persistent_int_map::to_transient() const
+  {
+    return make_box<transient_int_map>(data);
+  }
+
+  persistent_int_map_ref
+  persistent_int_map::merge(persistent_int_map_ref const other,
+                            jtl::option<object_ref> const &f) const
+  {
+    return make_box<persistent_int_map>(meta, data.merge(other->data, f));
+  }
+}
@@ -3,6 +3,7 @@
 #include <jank/runtime/core/seq.hpp>
 #include <jank/runtime/core/seq_ext.hpp>
 #include <jank/util/fmt.hpp>
+#include <jank/runtime/behavior/reducible.hpp>
 
 namespace jank::runtime::obj
 {
@@ -85,14 +86,23 @@ namespace jank::runtime::obj
   jtl::immutable_string persistent_list::to_code_string() const
   {
     jtl::string_builder buff;
-    runtime::to_code_string(data.begin(), data.end(), "(", ')', buff);
+    to_code_string(buff);
     return buff.release();
   }
 
-  /* TODO: Cache this. */
+  void persistent_list::to_code_string(jtl::string_builder &buff) const
+  {
+    runtime::to_code_string(data.begin(), data.end(), "(", ')', buff);
+  }
+
   uhash persistent_list::to_hash() const
   {
-    return hash::ordered(data.begin(), data.end());
+    if(hash != 0)
+    {
+      return hash;
+    }
+
+    return hash = hash::ordered(data.begin(), data.end());
   }
 
   persistent_list_ref persistent_list::seq() const
@@ -109,6 +119,13 @@ namespace jank::runtime::obj
     return make_box<persistent_list>(data);
   }
 
+  object_ref persistent_list::reduce(object_ref const f, object_ref const init) const
+  {
+    return behavior::detail::reduce_range(f, init, data.begin(), data.end(), [](auto const e) {
+      return e;
+    });
+  }
+
   usize persistent_list::count() const
   {
     return data.size();
@@ -148,6 +165,7 @@ namespace jank::runtime::obj
     }
 
     data = data.rest();
+    hash = 0;
     return this;
   }
 
@@ -156,6 +174,7 @@ namespace jank::runtime::obj
     auto const meta(behavior::detail::validate_meta(m));
     auto ret(make_box<persistent_list>(data));
     ret->meta = meta;
+    ret->hash = hash;
     return ret;
   }
 
@@ -56,9 +56,9 @@ namespace jank::runtime::obj
                                                      typed_seq->to_string()) };
             }
             auto const val(*it);
-            transient[key] = val;
+            transient.set(key, val);
           }
-          return transient;
+          return transient.persistent();
         }
         else
         {
@@ -71,9 +71,9 @@ namespace jank::runtime::obj
   object_ref persistent_sorted_map::get(object_ref const key) const
   {
     auto const res(data.find(key));
-    if(res != data.end())
+    if(res)
     {
-      return res->second;
+      return *res;
     }
     return jank_nil();
   }
@@ -81,9 +81,9 @@ namespace jank::runtime::obj
   object_ref persistent_sorted_map::get(object_ref const key, object_ref const fallback) const
   {
     auto const res(data.find(key));
-    if(res != data.end())
+    if(res)
     {
-      return res->second;
+      return *res;
     }
     return fallback;
   }
@@ -91,9 +91,9 @@ namespace jank::runtime::obj
   object_ref persistent_sorted_map::get_entry(object_ref const key) const
   {
     auto const res(data.find(key));
-    if(res != data.end())
+    if(res)
     {
-      return make_box<persistent_vector>(std::in_place, key, res->second);
+      return make_box<persistent_vector>(std::in_place, key, *res);
     }
     return jank_nil();
   }
@@ -106,15 +106,13 @@ namespace jank::runtime::obj
   persistent_sorted_map_ref
   persistent_sorted_map::assoc(object_ref const key, object_ref const val) const
   {
-    auto copy(data);
-    copy[key] = val;
+    auto copy(data.set(key, val));
     return make_box<persistent_sorted_map>(meta, std::move(copy));
   }
 
   persistent_sorted_map_ref persistent_sorted_map::dissoc(object_ref const key) const
   {
-    auto copy(data);
-    copy.erase(key);
+    auto copy(data.erase(key));
     return make_box<persistent_sorted_map>(meta, std::move(copy));
   }
 
@@ -132,4 +130,26 @@ namespace jank::runtime::obj
   {
     return make_box<transient_sorted_map>(data);
   }
+
+  persistent_sorted_map_sequence_ref persistent_sorted_map::sorted_seq(bool const ascending) const
+  {
+    if(data.empty())
+    {
+      return {};
+    }
+    return make_box<persistent_sorted_map_sequence>(this,
+                                                    ascending ? data.begin() : data.rbegin(),
+                                                    data.end());
+  }
+
+  persistent_sorted_map_sequence_ref
+  persistent_sorted_map::sorted_seq_from(object_ref const key, bool const ascending) const
+  {
+    auto const it{ data.seek(key, ascending) };
+    if(it == data.end())
+    {
+      return {};
+    }
+    return make_box<persistent_sorted_map_sequence>(this, it, data.end());
+  }
 }
@@ -43,7 +43,7 @@ namespace jank::runtime::obj
         {
           transient.insert(e);
         }
-        return transient;
+        return transient.persistent();
       },
       seq));
   }
@@ -91,14 +91,23 @@ namespace jank::runtime::obj
   jtl::immutable_string persistent_sorted_set::to_code_string() const
   {
     jtl::string_builder buff;
-    runtime::to_code_string(data.begin(), data.end(), "#{", '}', buff);
+    to_code_string(buff);
     return buff.release();
   }
 
-  /* TODO: Cache this. */
+  void persistent_sorted_set::to_code_string(jtl::string_builder &buff) const
+  {
+    runtime::to_code_string(data.begin(), data.end(), "#{", '}', buff);
+  }
+
   uhash persistent_sorted_set::to_hash() const
   {
-    return hash::unordered(data.begin(), data.end());
+    if(hash != 0)
+    {
+      return hash;
+    }
+
+    return hash = hash::unordered(data.begin(), data.end());
   }
 
   persistent_sorted_set_sequence_ref persistent_sorted_set::seq() const
@@ -125,13 +134,13 @@ namespace jank::runtime::obj
     auto const meta(behavior::detail::validate_meta(m));
     auto ret(make_box<persistent_sorted_set>(data));
     ret->meta = meta;
+    ret->hash = hash;
     return ret;
   }
 
   persistent_sorted_set_ref persistent_sorted_set::conj(object_ref const head) const
   {
-    auto copy(data);
-    copy.insert(head);
+    auto copy(data.insert(head));
     auto ret(make_box<persistent_sorted_set>(meta, std::move(copy)));
     return ret;
   }
@@ -139,7 +148,7 @@ namespace jank::runtime::obj
   object_ref persistent_sorted_set::call(object_ref const o)
   {
     auto const found(data.find(o));
-    if(found != data.end())
+    if(found)
     {
       return *found;
     }
@@ -158,11 +167,33 @@ namespace jank::runtime::obj
 
   persistent_sorted_set_ref persistent_sorted_set::disj(object_ref const o) const
   {
-    auto copy(data);
-    copy.erase(o);
+    auto copy(data.erase(o));
     auto ret(make_box<persistent_sorted_set>(meta, std::move(copy)));
     return ret;
   }
+
+  persistent_sorted_set_sequence_ref persistent_sorted_set::sorted_seq(bool const ascending) const
+  {
+    if(data.empty())
+    {
+      return {};
+    }
+    return make_box<persistent_sorted_set_sequence>(this,
+                                                    ascending ? data.begin() : data.rbegin(),
+                                                    data.end(),
+                                                    data.size());
+  }
+
+  persistent_sorted_set_sequence_ref
+  persistent_sorted_set::sorted_seq_from(object_ref const key, bool const ascending) const
+  {
+    auto const it{ data.seek(key, ascending) };
+    if(it == data.end())
+    {
+      return {};
+    }
+    return make_box<persistent_sorted_set_sequence>(this, it, data.end(), data.remaining(it));
+  }
 }
 
 namespace jank::runtime
@@ -1,3 +1,5 @@
+#include <array>
+
 #include <jank/runtime/obj/persistent_string.hpp>
 #include <jank/runtime/obj/persistent_string_sequence.hpp>
 #include <jank/runtime/rtti.hpp>
@@ -5,6 +7,7 @@
 #include <jank/runtime/core/to_string.hpp>
 #include <jank/util/escape.hpp>
 #include <jank/util/fmt.hpp>
+#include <jank/runtime/behavior/reducible.hpp>
 
 namespace jank::runtime::obj
 {
@@ -41,12 +44,21 @@ namespace jank::runtime::obj
 
   jtl::immutable_string persistent_string::to_code_string() const
   {
-    jtl::string_builder sb;
-    return sb('"')(util::escape(data))('"').release();
+    jtl::string_builder sb{ data.size() + 2 };
+    to_code_string(sb);
+    return sb.release();
+  }
+
+  void persistent_string::to_code_string(jtl::string_builder &buff) const
+  {
+    buff('"');
+    util::escape(data, buff);
+    buff('"');
   }
 
   uhash persistent_string::to_hash() const
   {
+    /* The string caches its own hash, so there's no need for us to also do it. */
     return data.to_hash();
   }
 
@@ -186,4 +198,30 @@ namespace jank::runtime::obj
     }
     return make_box<persistent_string_sequence>(const_cast<persistent_string *>(this));
   }
+
+  object_ref persistent_string::reduce(object_ref const f, object_ref const init) const
+  {
+    return behavior::detail::reduce_range(f, init, data.begin(), data.end(), [](char const c) {
+      return make_box(c);
+    });
+  }
+}
+
+namespace jank::runtime::detail
+{
+  static obj::persistent_string *single_byte_strings_const()
+  {
+    static auto r([] {
+      std::array<obj::persistent_string, single_byte_string_count> ret;
+      for(usize i{}; i < ret.size(); ++i)
+      {
+        ret[i].data = jtl::immutable_string{ 1, static_cast<char>(i) };
+      }
+      return ret;
+    }());
+    return r.data();
+  }
+
+  /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+  obj::persistent_string *single_byte_strings{ single_byte_strings_const() };
 }
@@ -1,5 +1,6 @@
 #include <jank/runtime/obj/persistent_string_sequence.hpp>
 #include <jank/runtime/obj/persistent_string.hpp>
+#include <jank/runtime/obj/array_chunk.hpp>
 #include <jank/runtime/core/seq_ext.hpp>
 #include <jank/runtime/core/make_box.hpp>
 
@@ -40,10 +41,15 @@ namespace jank::runtime::obj
   jtl::immutable_string persistent_string_sequence::to_code_string() const
   {
     jtl::string_builder buff;
-    runtime::to_code_string(str->data.begin() + index, str->data.end(), "(", ')', buff);
+    to_code_string(buff);
     return buff.release();
   }
 
+  void persistent_string_sequence::to_code_string(jtl::string_builder &buff) const
+  {
+    runtime::to_code_string(str->data.begin() + index, str->data.end(), "(", ')', buff);
+  }
+
   uhash persistent_string_sequence::to_hash() const
   {
     return hash::ordered(str->data.begin() + index, str->data.end());
@@ -97,6 +103,29 @@ namespace jank::runtime::obj
     return this;
   }
 
+  array_chunk_ref persistent_string_sequence::chunked_first() const
+  {
+    auto const end{ std::min(index + chunk_size, str->data.size()) };
+    native_vector<object_ref> buffer;
+    buffer.reserve(end - index);
+    for(auto i(index); i < end; ++i)
+    {
+      buffer.emplace_back(make_box(str->data[i]));
+    }
+    return make_box<array_chunk>(jtl::move(buffer), static_cast<usize>(0));
+  }
+
+  persistent_string_sequence_ref persistent_string_sequence::chunked_next() const
+  {
+    auto const n{ index + chunk_size };
+    if(str->data.size() <= n)
+    {
+      return {};
+    }
+
+    return make_box<persistent_string_sequence>(str, n);
+  }
+
   cons_ref persistent_string_sequence::conj(object_ref const head)
   {
     return make_box<cons>(head, this);
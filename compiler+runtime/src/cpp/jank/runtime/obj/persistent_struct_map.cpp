@@ -0,0 +1,144 @@
+#include <jank/runtime/obj/persistent_struct_map.hpp>
+#include <jank/runtime/obj/persistent_vector.hpp>
+#include <jank/runtime/obj/struct_basis.hpp>
+#include <jank/runtime/obj/number.hpp>
+#include <jank/runtime/obj/nil.hpp>
+#include <jank/runtime/core/seq_ext.hpp>
+#include <jank/runtime/core/to_string.hpp>
+#include <jank/runtime/rtti.hpp>
+#include <jank/util/fmt.hpp>
+
+namespace jank::runtime::obj
+{
+  persistent_struct_map::persistent_struct_map(value_type &&d)
+    : data{ std::move(d) }
+  {
+  }
+
+  persistent_struct_map::persistent_struct_map(value_type const &d)
+    : data{ d }
+  {
+  }
+
+  persistent_struct_map::persistent_struct_map(jtl::option<object_ref> const &meta,
+                                               value_type &&d)
+    : parent_type{ meta }
+    , data{ std::move(d) }
+  {
+  }
+
+  persistent_struct_map_ref
+  persistent_struct_map::create(object_ref const basis, object_ref const kvs)
+  {
+    value_type data{ expect_object<struct_basis>(basis) };
+    object_ref key;
+    bool have_key{};
+    runtime::for_each(kvs, [&](object_ref const o) {
+      if(have_key)
+      {
+        data = data.assoc(key, o);
+      }
+      else
+      {
+        key = o;
+      }
+      have_key = !have_key;
+    });
+    if(have_key)
+    {
+      throw std::runtime_error{ util::format("no value supplied for key: {}",
+                                             runtime::to_code_string(key)) };
+    }
+    return make_box<persistent_struct_map>(std::move(data));
+  }
+
+  persistent_struct_map_ref
+  persistent_struct_map::construct(object_ref const basis, object_ref const vals)
+  {
+    value_type data{ expect_object<struct_basis>(basis) };
+    auto const count{ data.slot_count() };
+    usize i{};
+    runtime::for_each(vals, [&](object_ref const o) {
+      if(i == count)
+      {
+        throw std::runtime_error{ util::format("too many values for a struct with {} keys",
+                                               count) };
+      }
+      /* The slots are brand new, so nothing else can see them yet. */
+      data.slots[i++] = o;
+    });
+    return make_box<persistent_struct_map>(std::move(data));
+  }
+
+  object_ref persistent_struct_map::slot_of(object_ref const basis, object_ref const key)
+  {
+    auto const slot{ expect_object<struct_basis>(basis)->slot(key) };
+    if(slot.is_none())
+    {
+      throw std::runtime_error{ util::format("not a field of this struct: {}",
+                                             runtime::to_code_string(key)) };
+    }
+    return make_box(static_cast<i64>(slot.unwrap()));
+  }
+
+  object_ref
+  persistent_struct_map::get_slot(object_ref const m, object_ref const basis, object_ref const slot)
+  {
+    if(m->type == object_type::persistent_struct_map)
+    {
+      auto const typed_m{ expect_object<persistent_struct_map>(m) };
+      if(typed_m->data.basis == basis)
+      {
+        return typed_m->data.slots[expect_object<integer>(slot)->data];
+      }
+    }
+    throw std::runtime_error{ util::format("accessor/struct mismatch: {}",
+                                           runtime::to_code_string(m)) };
+  }
+
+  object_ref persistent_struct_map::get(object_ref const key) const
+  {
+    return data.find(key).unwrap_or(jank_nil());
+  }
+
+  object_ref persistent_struct_map::get(object_ref const key, object_ref const fallback) const
+  {
+    return data.find(key).unwrap_or(fallback);
+  }
+
+  object_ref persistent_struct_map::get_entry(object_ref const key) const
+  {
+    auto const res(data.find(key));
+    if(res.is_some())
+    {
+      return make_box<persistent_vector>(std::in_place, key, res.unwrap());
+    }
+    return jank_nil();
+  }
+
+  bool persistent_struct_map::contains(object_ref const key) const
+  {
+    return data.find(key).is_some();
+  }
+
+  persistent_struct_map_ref
+  persistent_struct_map::assoc(object_ref const key, object_ref const val) const
+  {
+    return make_box<persistent_struct_map>(meta, data.assoc(key, val));
+  }
+
+  persistent_struct_map_ref persistent_struct_map::dissoc(object_ref const key) const
+  {
+    return make_box<persistent_struct_map>(meta, data.dissoc(key));
+  }
+
+  object_ref persistent_struct_map::call(object_ref const o) const
+  {
+    return get(o);
+  }
+
+  object_ref persistent_struct_map::call(object_ref const o, object_ref const fallback) const
+  {
+    return get(o, fallback);
+  }
+}
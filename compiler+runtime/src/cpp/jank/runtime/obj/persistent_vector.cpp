@@ -1,3 +1,5 @@
+#include <immer/algorithm.hpp>
+
 #include <jank/runtime/obj/persistent_vector.hpp>
 #include <jank/runtime/obj/transient_vector.hpp>
 #include <jank/runtime/visit.hpp>
@@ -6,6 +8,7 @@
 #include <jank/runtime/core/seq_ext.hpp>
 #include <jank/runtime/behavior/sequential.hpp>
 #include <jank/util/fmt.hpp>
+#include <jank/runtime/behavior/reducible.hpp>
 
 namespace jank::runtime::obj
 {
@@ -32,25 +35,9 @@ namespace jank::runtime::obj
       return make_box<persistent_vector>();
     }
 
-    return visit_object(
-      [](auto const typed_s) -> persistent_vector_ref {
-        using T = typename decltype(typed_s)::value_type;
-
-        if constexpr(behavior::sequenceable<T>)
-        {
-          runtime::detail::native_transient_vector v;
-          for(auto const e : make_sequence_range(typed_s))
-          {
-            v.push_back(e);
-          }
-          return make_box<persistent_vector>(v.persistent());
-        }
-        else
-        {
-          throw std::runtime_error{ util::format("invalid sequence: {}", typed_s->to_string()) };
-        }
-      },
-      s);
+    runtime::detail::native_transient_vector v;
+    runtime::for_each(s, [&](object_ref const e) { v.push_back(e); });
+    return make_box<persistent_vector>(v.persistent());
   }
 
   persistent_vector_ref persistent_vector::empty()
@@ -104,10 +91,15 @@ namespace jank::runtime::obj
   jtl::immutable_string persistent_vector::to_code_string() const
   {
     jtl::string_builder buff;
-    runtime::to_code_string(data.begin(), data.end(), "[", ']', buff);
+    to_code_string(buff);
     return buff.release();
   }
 
+  void persistent_vector::to_code_string(jtl::string_builder &buff) const
+  {
+    runtime::to_code_string(data.begin(), data.end(), "[", ']', buff);
+  }
+
   uhash persistent_vector::to_hash() const
   {
     if(hash != 0)
@@ -164,11 +156,53 @@ namespace jank::runtime::obj
     return make_box<persistent_vector_sequence>(const_cast<persistent_vector *>(this));
   }
 
+  object_ref persistent_vector::reduce(object_ref const f, object_ref const init) const
+  {
+    return behavior::detail::reduce_range(f, init, data.begin(), data.end(), [](auto const e) {
+      return e;
+    });
+  }
+
+  object_ref persistent_vector::reduce_kv(object_ref const f, object_ref const init) const
+  {
+    object_ref res{ init };
+    for(usize i{}; i < data.size(); ++i)
+    {
+      res = dynamic_call(f, res, make_box(i), data[i]);
+      if(behavior::detail::unwrap_reduced(res))
+      {
+        break;
+      }
+    }
+    return res;
+  }
+
   usize persistent_vector::count() const
   {
     return data.size();
   }
 
+  jtl::option<std::span<object_ref const>> persistent_vector::contiguous_data() const
+  {
+    if(data.empty())
+    {
+      return std::span<object_ref const>{};
+    }
+
+    /* immer hands us each leaf in turn. Only a vector with a single leaf is contiguous. */
+    std::span<object_ref const> ret;
+    usize chunks{};
+    immer::for_each_chunk(data, [&](object_ref const * const first, object_ref const * const last) {
+      ret = { first, last };
+      ++chunks;
+    });
+    if(chunks != 1)
+    {
+      return none;
+    }
+    return ret;
+  }
+
   persistent_vector_ref persistent_vector::conj(object_ref const head) const
   {
     auto vec(data.push_back(head));
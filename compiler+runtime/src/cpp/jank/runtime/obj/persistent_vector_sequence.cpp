@@ -54,13 +54,18 @@ namespace jank::runtime::obj
   jtl::immutable_string persistent_vector_sequence::to_code_string() const
   {
     jtl::string_builder buff;
+    to_code_string(buff);
+    return buff.release();
+  }
+
+  void persistent_vector_sequence::to_code_string(jtl::string_builder &buff) const
+  {
     runtime::to_code_string(
       vec->data.begin() + static_cast<decltype(persistent_vector::data)::difference_type>(index),
       vec->data.end(),
       "(",
       ')',
       buff);
-    return buff.release();
   }
 
   uhash persistent_vector_sequence::to_hash() const
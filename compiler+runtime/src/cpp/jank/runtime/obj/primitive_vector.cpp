@@ -0,0 +1,432 @@
+#include <algorithm>
+
+#include <immer/algorithm.hpp>
+
+#include <jank/runtime/obj/primitive_vector.hpp>
+#include <jank/runtime/obj/primitive_vector_sequence.hpp>
+#include <jank/runtime/obj/persistent_vector.hpp>
+#include <jank/runtime/visit.hpp>
+#include <jank/runtime/core/equal.hpp>
+#include <jank/runtime/core/seq.hpp>
+#include <jank/runtime/core/seq_ext.hpp>
+#include <jank/runtime/sequence_range.hpp>
+#include <jank/runtime/behavior/metadatable.hpp>
+#include <jank/runtime/behavior/reducible.hpp>
+#include <jank/util/fmt.hpp>
+
+namespace jank::runtime::obj
+{
+  object_ref primitive_vector::boxed_iterator::operator*() const
+  {
+    return vec->at(index);
+  }
+
+  primitive_vector::boxed_iterator &primitive_vector::boxed_iterator::operator++()
+  {
+    ++index;
+    return *this;
+  }
+
+  bool primitive_vector::boxed_iterator::operator==(boxed_iterator const &rhs) const
+  {
+    return index == rhs.index;
+  }
+
+  bool primitive_vector::boxed_iterator::operator!=(boxed_iterator const &rhs) const
+  {
+    return index != rhs.index;
+  }
+
+  primitive_vector::primitive_vector(value_type &&d)
+    : data{ std::move(d) }
+  {
+  }
+
+  primitive_vector::primitive_vector(jtl::option<object_ref> const &meta, value_type &&d)
+    : data{ std::move(d) }
+    , meta{ meta }
+  {
+  }
+
+  primitive_vector::value_type primitive_vector::empty_storage(array::element_type const element)
+  {
+    switch(element)
+    {
+      case array::element_type::boolean:
+        return storage<bool>{};
+      case array::element_type::byte:
+        return storage<i8>{};
+      case array::element_type::short_:
+        return storage<i16>{};
+      case array::element_type::char_:
+        return storage<char32_t>{};
+      case array::element_type::int_:
+        return storage<i32>{};
+      case array::element_type::long_:
+        return storage<i64>{};
+      case array::element_type::float_:
+        return storage<f32>{};
+      case array::element_type::double_:
+        return storage<f64>{};
+      case array::element_type::object:
+        break;
+    }
+    throw std::runtime_error{ "vector-of needs a primitive element type, like :long" };
+  }
+
+  template <typename T>
+  static void append(primitive_vector::storage<T> &v, object_ref const coll)
+  {
+    if(coll.is_nil())
+    {
+      return;
+    }
+    if(coll->type == object_type::primitive_vector && v.empty())
+    {
+      auto const pv(expect_object<primitive_vector>(coll));
+      if(auto const other = std::get_if<primitive_vector::storage<T>>(&pv->data))
+      {
+        v = *other;
+        return;
+      }
+    }
+
+    auto t(v.transient());
+    if(coll->type == object_type::array)
+    {
+      auto const a(expect_object<array>(coll));
+      if(a->element == array::element_type_of<T>())
+      {
+        auto const elements(a->data_as<T>());
+        std::for_each(elements, elements + a->length, [&](T const e) { t.push_back(e); });
+        v = t.persistent();
+        return;
+      }
+    }
+    else if(coll->type == object_type::primitive_vector)
+    {
+      auto const pv(expect_object<primitive_vector>(coll));
+      if(auto const other = std::get_if<primitive_vector::storage<T>>(&pv->data))
+      {
+        immer::for_each_chunk(*other, [&](T const * const first, T const * const last) {
+          std::for_each(first, last, [&](T const e) { t.push_back(e); });
+        });
+        v = t.persistent();
+        return;
+      }
+    }
+
+    for_each_item(coll, [&](object_ref const e) { t.push_back(array::unbox<T>(e)); });
+    v = t.persistent();
+  }
+
+  primitive_vector_ref primitive_vector::create(object_ref const type, object_ref const coll)
+  {
+    auto data(empty_storage(array::parse_element_type(type)));
+    std::visit([&](auto &v) { append(v, coll); }, data);
+    return make_box<primitive_vector>(std::move(data));
+  }
+
+  primitive_vector_ref primitive_vector::conj_all(object_ref const coll) const
+  {
+    auto ret(data);
+    std::visit([&](auto &v) { append(v, coll); }, ret);
+    return make_box<primitive_vector>(meta, std::move(ret));
+  }
+
+  array_ref primitive_vector::to_array(array::element_type const element) const
+  {
+    auto const ret(make_box<array>(element, count()));
+    std::visit(
+      [&](auto const &v) {
+        using T = typename jtl::decay_t<decltype(v)>::value_type;
+
+        if(array::element_type_of<T>() == element)
+        {
+          auto out(ret->data_as<T>());
+          immer::for_each_chunk(v, [&](T const * const first, T const * const last) {
+            out = std::copy(first, last, out);
+          });
+          return;
+        }
+
+        usize i{};
+        for(auto const e : v)
+        {
+          ret->set(i++, array::box(e));
+        }
+      },
+      data);
+    return ret;
+  }
+
+  array::element_type primitive_vector::element() const
+  {
+    return static_cast<array::element_type>(data.index() + 1);
+  }
+
+  object_ref primitive_vector::at(usize const index) const
+  {
+    return std::visit([=](auto const &v) { return array::box(v[index]); }, data);
+  }
+
+  primitive_vector::boxed_iterator primitive_vector::begin() const
+  {
+    return { this, 0 };
+  }
+
+  primitive_vector::boxed_iterator primitive_vector::end() const
+  {
+    return { this, count() };
+  }
+
+  bool primitive_vector::equal(object const &o) const
+  {
+    if(&o == &base)
+    {
+      return true;
+    }
+
+    auto const v{ dyn_cast<primitive_vector>(&o) };
+    if(v.is_some() && v->data.index() == data.index())
+    {
+      return v->data == data;
+    }
+    return runtime::equal(o, begin(), end());
+  }
+
+  jtl::immutable_string primitive_vector::to_string() const
+  {
+    jtl::string_builder buff;
+    to_string(buff);
+    return buff.release();
+  }
+
+  void primitive_vector::to_string(jtl::string_builder &buff) const
+  {
+    runtime::to_string(begin(), end(), "[", ']', buff);
+  }
+
+  jtl::immutable_string primitive_vector::to_code_string() const
+  {
+    jtl::string_builder buff;
+    to_code_string(buff);
+    return buff.release();
+  }
+
+  void primitive_vector::to_code_string(jtl::string_builder &buff) const
+  {
+    runtime::to_code_string(begin(), end(), "[", ']', buff);
+  }
+
+  uhash primitive_vector::to_hash() const
+  {
+    if(hash != 0)
+    {
+      return hash;
+    }
+
+    return hash = hash::ordered(begin(), end());
+  }
+
+  primitive_vector_ref primitive_vector::with_meta(object_ref const m) const
+  {
+    auto const meta(behavior::detail::validate_meta(m));
+    auto ret(make_box<primitive_vector>(*this));
+    ret->meta = meta;
+    return ret;
+  }
+
+  primitive_vector_sequence_ref primitive_vector::seq() const
+  {
+    return fresh_seq();
+  }
+
+  primitive_vector_sequence_ref primitive_vector::fresh_seq() const
+  {
+    if(count() == 0)
+    {
+      return {};
+    }
+    return make_box<primitive_vector_sequence>(const_cast<primitive_vector *>(this), 0);
+  }
+
+  object_ref primitive_vector::reduce(object_ref const f, object_ref const init) const
+  {
+    return std::visit(
+      [&](auto const &v) {
+        return behavior::detail::reduce_range(f, init, v.begin(), v.end(), [](auto const e) {
+          return array::box(e);
+        });
+      },
+      data);
+  }
+
+  object_ref primitive_vector::reduce_kv(object_ref const f, object_ref const init) const
+  {
+    object_ref res{ init };
+    auto const size(count());
+    for(usize i{}; i < size; ++i)
+    {
+      res = dynamic_call(f, res, make_box(i), at(i));
+      if(behavior::detail::unwrap_reduced(res))
+      {
+        break;
+      }
+    }
+    return res;
+  }
+
+  usize primitive_vector::count() const
+  {
+    return std::visit([](auto const &v) -> usize { return v.size(); }, data);
+  }
+
+  object_ref primitive_vector::get(object_ref const key) const
+  {
+    return get(key, jank_nil());
+  }
+
+  object_ref primitive_vector::get(object_ref const key, object_ref const fallback) const
+  {
+    if(key->type == object_type::integer)
+    {
+      auto const i(expect_object<integer>(key)->data);
+      if(i < 0 || count() <= static_cast<usize>(i))
+      {
+        return fallback;
+      }
+      return at(static_cast<usize>(i));
+    }
+    else
+    {
+      return fallback;
+    }
+  }
+
+  object_ref primitive_vector::get_entry(object_ref const key) const
+  {
+    if(key->type == object_type::integer)
+    {
+      auto const i(expect_object<integer>(key)->data);
+      if(i < 0 || count() <= static_cast<usize>(i))
+      {
+        return jank_nil();
+      }
+      return make_box<persistent_vector>(std::in_place, key, at(static_cast<usize>(i)));
+    }
+    else
+    {
+      return jank_nil();
+    }
+  }
+
+  bool primitive_vector::contains(object_ref const key) const
+  {
+    if(key->type == object_type::integer)
+    {
+      auto const i(expect_object<integer>(key)->data);
+      return i >= 0 && static_cast<usize>(i) < count();
+    }
+    else
+    {
+      return false;
+    }
+  }
+
+  primitive_vector_ref primitive_vector::assoc(object_ref const key, object_ref const val) const
+  {
+    if(key->type != object_type::integer)
+    {
+      throw std::runtime_error{ "Key must be integer." };
+    }
+
+    auto const i(static_cast<usize>(expect_object<integer>(key)->data));
+    auto const size(count());
+
+    if(i > size)
+    {
+      throw std::runtime_error{ "Index out of bounds." };
+    }
+
+    return std::visit(
+      [&](auto const &v) {
+        using T = typename jtl::decay_t<decltype(v)>::value_type;
+        auto const e(array::unbox<T>(val));
+        return make_box<primitive_vector>(meta,
+                                          value_type{ i == size ? v.push_back(e) : v.set(i, e) });
+      },
+      data);
+  }
+
+  primitive_vector_ref primitive_vector::dissoc(object_ref const /*key*/) const
+  {
+    throw std::runtime_error{ "Type 'primitive_vector' does not support 'dissoc'." };
+  }
+
+  primitive_vector_ref primitive_vector::conj(object_ref const head) const
+  {
+    return std::visit(
+      [&](auto const &v) {
+        using T = typename jtl::decay_t<decltype(v)>::value_type;
+        return make_box<primitive_vector>(meta, value_type{ v.push_back(array::unbox<T>(head)) });
+      },
+      data);
+  }
+
+  object_ref primitive_vector::peek() const
+  {
+    auto const size(count());
+    if(size == 0)
+    {
+      return jank_nil();
+    }
+
+    return at(size - 1);
+  }
+
+  primitive_vector_ref primitive_vector::pop() const
+  {
+    auto const size(count());
+    if(size == 0)
+    {
+      throw std::runtime_error{ "cannot pop an empty vector" };
+    }
+
+    return std::visit(
+      [&](auto const &v) {
+        return make_box<primitive_vector>(meta, value_type{ v.take(size - 1) });
+      },
+      data);
+  }
+
+  object_ref primitive_vector::nth(object_ref const index) const
+  {
+    if(index->type == object_type::integer)
+    {
+      auto const i(expect_object<integer>(index)->data);
+      if(i < 0 || count() <= static_cast<usize>(i))
+      {
+        throw std::runtime_error{
+          util::format("out of bounds index {}; vector has a size of {}", i, count())
+        };
+      }
+      return at(static_cast<usize>(i));
+    }
+    else
+    {
+      throw std::runtime_error{ util::format("nth on a vector must be an integer; found {}",
+                                             runtime::to_string(index)) };
+    }
+  }
+
+  object_ref primitive_vector::nth(object_ref const index, object_ref const fallback) const
+  {
+    return get(index, fallback);
+  }
+
+  object_ref primitive_vector::call(object_ref const o) const
+  {
+    return get(o);
+  }
+}
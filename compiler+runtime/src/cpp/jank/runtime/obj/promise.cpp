@@ -0,0 +1,109 @@
+#include <chrono>
+
+#include <jank/runtime/obj/promise.hpp>
+#include <jank/runtime/behavior/callable.hpp>
+#include <jank/util/fmt.hpp>
+
+namespace jank::runtime::obj
+{
+  bool promise::equal(object const &o) const
+  {
+    return &o == &base;
+  }
+
+  jtl::immutable_string promise::to_string() const
+  {
+    jtl::string_builder buff;
+    to_string(buff);
+    return buff.release();
+  }
+
+  void promise::to_string(jtl::string_builder &buff) const
+  {
+    util::format_to(buff, "#object [{} {}]", object_type_str(base.type), &base);
+  }
+
+  jtl::immutable_string promise::to_code_string() const
+  {
+    return to_string();
+  }
+
+  void promise::to_code_string(jtl::string_builder &buff) const
+  {
+    to_string(buff);
+  }
+
+  uhash promise::to_hash() const
+  {
+    return static_cast<uhash>(reinterpret_cast<uintptr_t>(this));
+  }
+
+  object_ref promise::deref()
+  {
+    if(delivered.load(std::memory_order_acquire))
+    {
+      return val;
+    }
+
+    std::unique_lock<std::mutex> lock{ mutex };
+    delivered_cv.wait(lock, [this] { return delivered.load(std::memory_order_relaxed); });
+    return val;
+  }
+
+  object_ref promise::deref(i64 const timeout_ms, object_ref const timeout_val)
+  {
+    if(delivered.load(std::memory_order_acquire))
+    {
+      return val;
+    }
+
+    std::unique_lock<std::mutex> lock{ mutex };
+    if(!delivered_cv.wait_for(lock,
+                              std::chrono::milliseconds{ std::max<i64>(timeout_ms, 0) },
+                              [this] { return delivered.load(std::memory_order_relaxed); }))
+    {
+      return timeout_val;
+    }
+    return val;
+  }
+
+  bool promise::is_realized() const
+  {
+    return delivered.load(std::memory_order_acquire);
+  }
+
+  bool promise::deliver(object_ref const v)
+  {
+    native_vector<object_ref> pending;
+    {
+      std::lock_guard<std::mutex> const lock{ mutex };
+      if(delivered.load(std::memory_order_relaxed))
+      {
+        return false;
+      }
+      val = v;
+      delivered.store(true, std::memory_order_release);
+      pending.swap(callbacks);
+    }
+    delivered_cv.notify_all();
+
+    for(auto const f : pending)
+    {
+      dynamic_call(f, v);
+    }
+    return true;
+  }
+
+  void promise::on_deliver(object_ref const f)
+  {
+    {
+      std::lock_guard<std::mutex> const lock{ mutex };
+      if(!delivered.load(std::memory_order_relaxed))
+      {
+        callbacks.emplace_back(f);
+        return;
+      }
+    }
+    dynamic_call(f, val);
+  }
+}
@@ -0,0 +1,230 @@
+#include <jank/runtime/obj/protocol.hpp>
+#include <jank/runtime/obj/protocol_method.hpp>
+#include <jank/runtime/obj/persistent_hash_set.hpp>
+#include <jank/runtime/obj/persistent_string.hpp>
+#include <jank/runtime/obj/persistent_vector.hpp>
+#include <jank/runtime/obj/persistent_struct_map.hpp>
+#include <jank/runtime/obj/struct_basis.hpp>
+#include <jank/runtime/obj/keyword.hpp>
+#include <jank/runtime/obj/symbol.hpp>
+#include <jank/runtime/obj/nil.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/seq.hpp>
+#include <jank/runtime/core/seq_ext.hpp>
+#include <jank/runtime/core/to_string.hpp>
+#include <jank/runtime/sequence_range.hpp>
+#include <jank/runtime/rtti.hpp>
+#include <jank/util/fmt.hpp>
+
+namespace jank::runtime::obj
+{
+  /* What a protocol is being extended to. Exactly one of these applies. */
+  struct extension_target
+  {
+    jtl::option<object_type> type;
+    struct_basis_ref basis;
+    bool is_default{};
+  };
+
+  static extension_target resolve_target(object_ref const type)
+  {
+    switch(type->type)
+    {
+      case object_type::nil:
+        return { object_type::nil };
+      case object_type::struct_basis:
+        return { none, expect_object<struct_basis>(type) };
+      case object_type::keyword:
+        if(auto const sym(expect_object<keyword>(type)->sym);
+           sym->ns.empty() && sym->name == "default")
+        {
+          return { none, {}, true };
+        }
+        break;
+      case object_type::persistent_string:
+        {
+          auto const &name(expect_object<persistent_string>(type)->data);
+          for(usize i{}; i < object_type_count; ++i)
+          {
+            auto const t{ static_cast<object_type>(i) };
+            if(name == object_type_str(t))
+            {
+              return { t };
+            }
+          }
+        }
+        break;
+      default:
+        break;
+    }
+
+    throw std::runtime_error{ util::format("unable to extend a protocol to {}; expected nil, "
+                                           "a type name, :default, or a struct basis",
+                                           runtime::to_code_string(type)) };
+  }
+
+  protocol::protocol(object_ref const name)
+    : name{ try_object<symbol>(name) }
+  {
+  }
+
+  protocol_ref protocol::create(object_ref const name, object_ref const method_names)
+  {
+    auto const ret(make_box<protocol>(name));
+    runtime::for_each(method_names, [&](object_ref const method_name) {
+      ret->methods.emplace_back(make_box<protocol_method>(ret, try_object<symbol>(method_name)));
+    });
+    return ret;
+  }
+
+  bool protocol::equal(object const &rhs) const
+  {
+    return &base == &rhs;
+  }
+
+  jtl::immutable_string protocol::to_string() const
+  {
+    jtl::string_builder buff;
+    to_string(buff);
+    return buff.release();
+  }
+
+  void protocol::to_string(jtl::string_builder &buff) const
+  {
+    util::format_to(buff,
+                    "#object [{} {} {}]",
+                    name->to_string(),
+                    object_type_str(base.type),
+                    &base);
+  }
+
+  jtl::immutable_string protocol::to_code_string() const
+  {
+    return to_string();
+  }
+
+  void protocol::to_code_string(jtl::string_builder &buff) const
+  {
+    to_string(buff);
+  }
+
+  uhash protocol::to_hash() const
+  {
+    return static_cast<uhash>(reinterpret_cast<uintptr_t>(this));
+  }
+
+  protocol_ref protocol::extend(object_ref const type, object_ref const impls)
+  {
+    auto const target(resolve_target(type));
+
+    std::lock_guard<std::mutex> const locked{ extend_lock };
+    for(auto const &pair : make_sequence_range(impls))
+    {
+      auto const entry(expect_object<persistent_vector>(pair));
+      auto const method_name(entry->data[0]);
+      auto const method(find_method(method_name));
+      if(method.is_nil())
+      {
+        throw std::runtime_error{ util::format("{} is not a method of protocol {}",
+                                               runtime::to_code_string(method_name),
+                                               name->to_string()) };
+      }
+
+      auto const fn(entry->data[1]);
+      if(target.type.is_some())
+      {
+        method->set_type_impl(target.type.unwrap(), fn);
+      }
+      else if(target.is_default)
+      {
+        method->set_default_impl(fn);
+      }
+      else
+      {
+        method->set_basis_impl(target.basis, fn);
+      }
+    }
+
+    if(target.type.is_some())
+    {
+      extended_types[static_cast<usize>(target.type.unwrap())].store(true,
+                                                                      std::memory_order_release);
+    }
+    else if(target.is_default)
+    {
+      extended_default.store(true, std::memory_order_release);
+    }
+    else
+    {
+      auto const existing(extended_bases.load(std::memory_order_acquire));
+      auto const bases(existing ? expect_object<persistent_hash_set>(existing)
+                                : persistent_hash_set::empty());
+      extended_bases.store(bases->conj(target.basis).data, std::memory_order_release);
+    }
+
+    return this;
+  }
+
+  bool protocol::extends(object_ref const type) const
+  {
+    auto const target(resolve_target(type));
+    if(target.type.is_some())
+    {
+      return extended_types[static_cast<usize>(target.type.unwrap())].load(
+        std::memory_order_acquire);
+    }
+    else if(target.is_default)
+    {
+      return extended_default.load(std::memory_order_acquire);
+    }
+
+    auto const bases(extended_bases.load(std::memory_order_acquire));
+    return bases && expect_object<persistent_hash_set>(bases)->contains(target.basis);
+  }
+
+  bool protocol::satisfies(object_ref const o) const
+  {
+    if(extended_types[static_cast<usize>(o->type)].load(std::memory_order_acquire)
+       || extended_default.load(std::memory_order_acquire))
+    {
+      return true;
+    }
+
+    if(o->type == object_type::persistent_struct_map)
+    {
+      auto const bases(extended_bases.load(std::memory_order_acquire));
+      return bases
+        && expect_object<persistent_hash_set>(bases)->contains(
+          expect_object<persistent_struct_map>(o)->data.basis);
+    }
+    return false;
+  }
+
+  protocol_method_ref protocol::find_method(object_ref const name) const
+  {
+    /* Method names are given as keywords to extend, but are symbols when the protocol is
+     * defined, so we only compare the names. */
+    jtl::immutable_string method_name;
+    if(name->type == object_type::keyword)
+    {
+      method_name = expect_object<keyword>(name)->sym->name;
+    }
+    else if(name->type == object_type::symbol)
+    {
+      method_name = expect_object<symbol>(name)->name;
+    }
+    else
+    {
+      return {};
+    }
+
+    for(auto const &method : methods)
+    {
+      if(method->name->name == method_name)
+      {
+        return method;
+      }
+    }
+    return {};
+  }
+}
@@ -0,0 +1,331 @@
+#include <folly/Synchronized.h>
+
+#include <jank/runtime/obj/protocol_method.hpp>
+#include <jank/runtime/obj/protocol.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
+#include <jank/runtime/obj/persistent_struct_map.hpp>
+#include <jank/runtime/obj/struct_basis.hpp>
+#include <jank/runtime/obj/symbol.hpp>
+#include <jank/runtime/obj/nil.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/to_string.hpp>
+#include <jank/runtime/visit.hpp>
+#include <jank/runtime/var.hpp>
+#include <jank/runtime/rtti.hpp>
+#include <jank/util/fmt.hpp>
+
+namespace jank::runtime::obj
+{
+  protocol_method::protocol_method(protocol_ref const proto, symbol_ref const name)
+    : proto{ proto }
+    , name{ name }
+  {
+  }
+
+  bool protocol_method::equal(object const &rhs) const
+  {
+    return &base == &rhs;
+  }
+
+  jtl::immutable_string protocol_method::to_string() const
+  {
+    jtl::string_builder buff;
+    to_string(buff);
+    return buff.release();
+  }
+
+  void protocol_method::to_string(jtl::string_builder &buff) const
+  {
+    util::format_to(buff,
+                    "#object [{} {} {}]",
+                    name->to_string(),
+                    object_type_str(base.type),
+                    &base);
+  }
+
+  jtl::immutable_string protocol_method::to_code_string() const
+  {
+    return to_string();
+  }
+
+  void protocol_method::to_code_string(jtl::string_builder &buff) const
+  {
+    to_string(buff);
+  }
+
+  uhash protocol_method::to_hash() const
+  {
+    return static_cast<uhash>(reinterpret_cast<uintptr_t>(this));
+  }
+
+  object_ref protocol_method::call()
+  {
+    throw std::runtime_error{ util::format("protocol method {} of {} needs at least one arg",
+                                           name->to_string(),
+                                           proto->name->to_string()) };
+  }
+
+  object_ref protocol_method::call(object_ref const a1)
+  {
+    return dynamic_call(expect_impl(a1), a1);
+  }
+
+  object_ref protocol_method::call(object_ref const a1, object_ref const a2)
+  {
+    return dynamic_call(expect_impl(a1), a1, a2);
+  }
+
+  object_ref protocol_method::call(object_ref const a1, object_ref const a2, object_ref const a3)
+  {
+    return dynamic_call(expect_impl(a1), a1, a2, a3);
+  }
+
+  object_ref protocol_method::call(object_ref const a1,
+                                   object_ref const a2,
+                                   object_ref const a3,
+                                   object_ref const a4)
+  {
+    return dynamic_call(expect_impl(a1), a1, a2, a3, a4);
+  }
+
+  object_ref protocol_method::call(object_ref const a1,
+                                   object_ref const a2,
+                                   object_ref const a3,
+                                   object_ref const a4,
+                                   object_ref const a5)
+  {
+    return dynamic_call(expect_impl(a1), a1, a2, a3, a4, a5);
+  }
+
+  object_ref protocol_method::call(object_ref const a1,
+                                   object_ref const a2,
+                                   object_ref const a3,
+                                   object_ref const a4,
+                                   object_ref const a5,
+                                   object_ref const a6)
+  {
+    return dynamic_call(expect_impl(a1), a1, a2, a3, a4, a5, a6);
+  }
+
+  object_ref protocol_method::call(object_ref const a1,
+                                   object_ref const a2,
+                                   object_ref const a3,
+                                   object_ref const a4,
+                                   object_ref const a5,
+                                   object_ref const a6,
+                                   object_ref const a7)
+  {
+    return dynamic_call(expect_impl(a1), a1, a2, a3, a4, a5, a6, a7);
+  }
+
+  object_ref protocol_method::call(object_ref const a1,
+                                   object_ref const a2,
+                                   object_ref const a3,
+                                   object_ref const a4,
+                                   object_ref const a5,
+                                   object_ref const a6,
+                                   object_ref const a7,
+                                   object_ref const a8)
+  {
+    return dynamic_call(expect_impl(a1), a1, a2, a3, a4, a5, a6, a7, a8);
+  }
+
+  object_ref protocol_method::call(object_ref const a1,
+                                   object_ref const a2,
+                                   object_ref const a3,
+                                   object_ref const a4,
+                                   object_ref const a5,
+                                   object_ref const a6,
+                                   object_ref const a7,
+                                   object_ref const a8,
+                                   object_ref const a9)
+  {
+    return dynamic_call(expect_impl(a1), a1, a2, a3, a4, a5, a6, a7, a8, a9);
+  }
+
+  object_ref protocol_method::call(object_ref const a1,
+                                   object_ref const a2,
+                                   object_ref const a3,
+                                   object_ref const a4,
+                                   object_ref const a5,
+                                   object_ref const a6,
+                                   object_ref const a7,
+                                   object_ref const a8,
+                                   object_ref const a9,
+                                   object_ref const a10)
+  {
+    return dynamic_call(expect_impl(a1), a1, a2, a3, a4, a5, a6, a7, a8, a9, a10);
+  }
+
+  object_ref protocol_method::this_object_ref()
+  {
+    return &this->base;
+  }
+
+  object_ref protocol_method::find_impl(object_ref const o) const
+  {
+    if(o->type == object_type::persistent_struct_map)
+    {
+      if(auto const bases = basis_impls.load(std::memory_order_acquire))
+      {
+        auto const found(expect_object<persistent_hash_map>(bases)->get(
+          expect_object<persistent_struct_map>(o)->data.basis));
+        if(found.is_some())
+        {
+          return found;
+        }
+      }
+    }
+
+    if(auto const impl = impls[static_cast<usize>(o->type)].load(std::memory_order_acquire))
+    {
+      return impl;
+    }
+    if(auto const impl = default_impl.load(std::memory_order_acquire))
+    {
+      return impl;
+    }
+    return {};
+  }
+
+  object_ref protocol_method::expect_impl(object_ref const o) const
+  {
+    auto const impl(find_impl(o));
+    if(impl.is_nil())
+    {
+      throw std::runtime_error{ util::format(
+        "no implementation of method {} of protocol {} found for {}",
+        name->to_string(),
+        proto->name->to_string(),
+        object_type_str(o->type)) };
+    }
+    return impl;
+  }
+
+  bool protocol_method::has_basis_impls() const
+  {
+    return basis_impls.load(std::memory_order_acquire) != nullptr;
+  }
+
+  void protocol_method::set_type_impl(object_type const type, object_ref const fn)
+  {
+    impls[static_cast<usize>(type)].store(fn.data, std::memory_order_release);
+    clear_call_sites();
+  }
+
+  void protocol_method::set_default_impl(object_ref const fn)
+  {
+    default_impl.store(fn.data, std::memory_order_release);
+    clear_call_sites();
+  }
+
+  void protocol_method::set_basis_impl(struct_basis_ref const basis, object_ref const fn)
+  {
+    auto const existing(basis_impls.load(std::memory_order_acquire));
+    auto const bases(existing ? expect_object<persistent_hash_map>(existing)
+                              : persistent_hash_map::empty());
+    basis_impls.store(bases->assoc(basis, fn).data, std::memory_order_release);
+    clear_call_sites();
+  }
+
+  void protocol_method::add_call_site(protocol_call_site * const site)
+  {
+    std::lock_guard<std::mutex> const locked{ call_sites_lock };
+    call_sites.emplace_back(site);
+  }
+
+  void protocol_method::clear_call_sites()
+  {
+    version.fetch_add(1, std::memory_order_acq_rel);
+    std::lock_guard<std::mutex> const locked{ call_sites_lock };
+    for(auto const site : call_sites)
+    {
+      site->clear();
+    }
+  }
+
+  /* Call sites live in memory which the GC doesn't scan, so we keep each one reachable from
+   * here. There's one per call site in compiled code, so this only grows with the code. */
+  /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+  static folly::Synchronized<native_vector<protocol_call_site *>> call_site_roots;
+
+  protocol_call_site::protocol_call_site(var_ref const var,
+                                         protocol_method_ref const method,
+                                         usize const arg_count)
+    : var{ var }
+    , method{ method }
+    , arg_count{ arg_count }
+  {
+  }
+
+  protocol_call_site *protocol_call_site::create(var_ref const var, usize const arg_count)
+  {
+    auto const method(expect_object<protocol_method>(var->get_root()));
+    auto const ret(new(GC) protocol_call_site{ var, method, arg_count });
+    call_site_roots.wlock()->emplace_back(ret);
+    method->add_call_site(ret);
+    return ret;
+  }
+
+  void protocol_call_site::clear()
+  {
+    for(auto &slot : entries)
+    {
+      slot.store(nullptr, std::memory_order_release);
+    }
+  }
+
+  object_ref protocol_call_site::get_root() const
+  {
+    return var->get_root();
+  }
+
+  protocol_call_site::entry const *protocol_call_site::miss(object_ref const o)
+  {
+    /* Struct maps may dispatch on their basis, which the cache doesn't key on. */
+    if(o->type == object_type::persistent_struct_map && method->has_basis_impls())
+    {
+      return nullptr;
+    }
+
+    auto const version(method->version.load(std::memory_order_acquire));
+    auto const fn(method->find_impl(o));
+    if(fn.is_nil())
+    {
+      return nullptr;
+    }
+
+    auto const e(new(GC) entry{ o->type, fn });
+    visit_object(
+      [&](auto const typed_fn) {
+        using T = typename jtl::decay_t<decltype(typed_fn)>::value_type;
+
+        if constexpr(std::is_base_of_v<behavior::callable, T>)
+        {
+          if(behavior::callable::is_fixed_arity_call(typed_fn->get_arity_flags(), arg_count))
+          {
+            e->direct = &*typed_fn;
+          }
+        }
+      },
+      fn);
+
+    for(auto &slot : entries)
+    {
+      entry const *expected{};
+      if(slot.compare_exchange_strong(expected, e, std::memory_order_acq_rel))
+      {
+        /* If the protocol was extended while we were looking up the impl, it may have
+         * cleared the cache before we added to it. */
+        if(method->version.load(std::memory_order_acquire) != version)
+        {
+          clear();
+        }
+        return e;
+      }
+    }
+
+    /* The site is megamorphic, so there's no room to cache this. */
+    return nullptr;
+  }
+}
@@ -5,6 +5,7 @@
 #include <jank/runtime/core/seq.hpp>
 #include <jank/runtime/visit.hpp>
 #include <jank/runtime/behavior/metadatable.hpp>
+#include <jank/runtime/behavior/reducible.hpp>
 
 namespace jank::runtime::obj
 {
@@ -112,6 +113,22 @@ namespace jank::runtime::obj
     return make_box<range>(start, end, step, bounds_check);
   }
 
+  /* Even if this range has been walked in place, start is always its first element, so
+   * we can just count from there, without building any chunks. */
+  object_ref range::reduce(object_ref const f, object_ref const init) const
+  {
+    object_ref res{ init };
+    for(object_ref val{ start }; !bounds_check(val, end); val = add(val, step))
+    {
+      res = dynamic_call(f, res, val);
+      if(behavior::detail::unwrap_reduced(res))
+      {
+        break;
+      }
+    }
+    return res;
+  }
+
   object_ref range::first() const
   {
     return start;
@@ -225,6 +242,11 @@ namespace jank::runtime::obj
     return runtime::to_code_string(seq());
   }
 
+  void range::to_code_string(jtl::string_builder &buff)
+  {
+    runtime::to_code_string(seq(), buff);
+  }
+
   uhash range::to_hash() const
   {
     return hash::ordered(&base);
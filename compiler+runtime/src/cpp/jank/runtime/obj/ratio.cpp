@@ -42,6 +42,127 @@ namespace jank::runtime::obj
     return result;
   }
 
+  /* Most ratios have parts which fit in an i64. For those, we do the math with 128 bit
+   * intermediates, which can't overflow, and normalize with a binary GCD. We only fall
+   * back to big integer math when a part doesn't fit. */
+  using i128 = __int128;
+  using u128 = unsigned __int128;
+
+  static u32 count_trailing_zeros(u128 const n)
+  {
+    auto const low{ static_cast<u64>(n) };
+    if(low != 0)
+    {
+      return __builtin_ctzll(low);
+    }
+    return 64 + __builtin_ctzll(static_cast<u64>(n >> 64));
+  }
+
+  /* Stein's algorithm. */
+  static u64 binary_gcd(u64 l, u64 r)
+  {
+    if(l == 0 || r == 0)
+    {
+      return l | r;
+    }
+
+    auto const shift{ __builtin_ctzll(l | r) };
+    l >>= __builtin_ctzll(l);
+    do
+    {
+      r >>= __builtin_ctzll(r);
+      if(l > r)
+      {
+        std::swap(l, r);
+      }
+      r -= l;
+    }
+    while(r != 0);
+    return l << shift;
+  }
+
+  static u128 binary_gcd(u128 l, u128 r)
+  {
+    if((l | r) >> 64 == 0)
+    {
+      return binary_gcd(static_cast<u64>(l), static_cast<u64>(r));
+    }
+    if(l == 0 || r == 0)
+    {
+      return l | r;
+    }
+
+    auto const shift{ count_trailing_zeros(l | r) };
+    l >>= count_trailing_zeros(l);
+    do
+    {
+      r >>= count_trailing_zeros(r);
+      if(l > r)
+      {
+        std::swap(l, r);
+      }
+      r -= l;
+    }
+    while(r != 0);
+    return l << shift;
+  }
+
+  static u128 magnitude(i128 const n)
+  {
+    return n < 0 ? -static_cast<u128>(n) : static_cast<u128>(n);
+  }
+
+  static bool to_small(ratio_data const &r, i64 &numerator, i64 &denominator)
+  {
+    return big_integer::to_small(r.numerator, numerator)
+      && big_integer::to_small(r.denominator, denominator);
+  }
+
+  /* Each part here came from at most a product, or a sum of two products, of i64s, so
+   * they're well within the range of an i128. */
+  static void normalize(i128 &numerator, i128 &denominator)
+  {
+    if(denominator == 0)
+    {
+      throw std::invalid_argument{ "Ratio denominator cannot be zero." };
+    }
+
+    auto const gcd{ static_cast<i128>(binary_gcd(magnitude(numerator), magnitude(denominator))) };
+    numerator /= gcd;
+    denominator /= gcd;
+
+    if(denominator < 0)
+    {
+      numerator = -numerator;
+      denominator = -denominator;
+    }
+  }
+
+  static ratio_data make_small_ratio_data(i128 numerator, i128 denominator)
+  {
+    normalize(numerator, denominator);
+    return { native_big_integer{ numerator },
+             native_big_integer{ denominator },
+             ratio_data::normalized_tag{} };
+  }
+
+  static object_ref make_small_ratio(i128 numerator, i128 denominator)
+  {
+    normalize(numerator, denominator);
+    if(denominator == 1)
+    {
+      if(std::numeric_limits<i64>::min() <= numerator
+         && numerator <= std::numeric_limits<i64>::max())
+      {
+        return make_box<integer>(static_cast<i64>(numerator));
+      }
+      return make_box<big_integer>(native_big_integer{ numerator });
+    }
+    return make_box<ratio>(ratio_data{ native_big_integer{ numerator },
+                                       native_big_integer{ denominator },
+                                       ratio_data::normalized_tag{} });
+  }
+
   ratio_data::ratio_data(native_big_integer const &numerator, native_big_integer const &denominator)
     : numerator{ numerator }
     , denominator{ denominator }
@@ -50,6 +171,16 @@ namespace jank::runtime::obj
     {
       throw std::invalid_argument{ "Ratio denominator cannot be zero." };
     }
+
+    if(i64 small_num{}, small_denom{}; to_small(*this, small_num, small_denom))
+    {
+      i128 num{ small_num }, denom{ small_denom };
+      normalize(num, denom);
+      this->numerator = native_big_integer{ num };
+      this->denominator = native_big_integer{ denom };
+      return;
+    }
+
     auto const gcd{ big_integer::gcd(numerator, denominator) };
     this->numerator /= gcd;
     this->denominator /= gcd;
@@ -61,13 +192,21 @@ namespace jank::runtime::obj
     }
   }
 
+  ratio_data::ratio_data(native_big_integer const &numerator,
+                         native_big_integer const &denominator,
+                         normalized_tag)
+    : numerator{ numerator }
+    , denominator{ denominator }
+  {
+  }
+
   ratio_data::ratio_data(big_integer const &numerator, big_integer const &denominator)
     : ratio_data(numerator.data, denominator.data)
   {
   }
 
   ratio_data::ratio_data(i64 const numerator, i64 const denominator)
-    : ratio_data(native_big_integer(numerator), native_big_integer(denominator))
+    : ratio_data(make_small_ratio_data(numerator, denominator))
   {
   }
 
@@ -84,6 +223,13 @@ namespace jank::runtime::obj
   object_ref
   ratio::create(native_big_integer const &numerator, native_big_integer const &denominator)
   {
+    i64 small_num{}, small_denom{};
+    if(big_integer::to_small(numerator, small_num)
+       && big_integer::to_small(denominator, small_denom))
+    {
+      return make_small_ratio(small_num, small_denom);
+    }
+
     ratio_data const data{ numerator, denominator };
     if(data.denominator == 1)
     {
@@ -99,7 +245,7 @@ namespace jank::runtime::obj
 
   object_ref ratio::create(i64 const numerator, i64 const denominator)
   {
-    return create(native_big_integer(numerator), native_big_integer(denominator));
+    return make_small_ratio(numerator, denominator);
   }
 
   f64 ratio_data::to_real() const
@@ -139,6 +285,11 @@ namespace jank::runtime::obj
     return to_string();
   }
 
+  void ratio::to_code_string(jtl::string_builder &buff) const
+  {
+    to_string(buff);
+  }
+
   uhash ratio::to_hash() const
   {
     return hash::combine(big_integer::to_hash(data.numerator),
@@ -189,6 +340,12 @@ namespace jank::runtime::obj
 
   object_ref operator+(ratio_data const &l, ratio_data const &r)
   {
+    i64 ln{}, ld{}, rn{}, rd{};
+    if(to_small(l, ln, ld) && to_small(r, rn, rd))
+    {
+      return make_small_ratio((i128{ ln } * rd) + (i128{ rn } * ld), i128{ ld } * rd);
+    }
+
     auto const denom{ l.denominator * r.denominator };
     auto const num{ (l.numerator * r.denominator) + (r.numerator * l.denominator) };
     return ratio::create(num, denom);
@@ -226,6 +383,10 @@ namespace jank::runtime::obj
 
   ratio_ref operator+(ratio_data const &l, i64 const r)
   {
+    if(i64 ln{}, ld{}; to_small(l, ln, ld))
+    {
+      return make_box<ratio>(make_small_ratio_data(ln + (i128{ r } * ld), ld));
+    }
     return make_box<ratio>(ratio_data(l.numerator + (r * l.denominator), l.denominator));
   }
 
@@ -236,6 +397,12 @@ namespace jank::runtime::obj
 
   object_ref operator-(ratio_data const &l, ratio_data const &r)
   {
+    i64 ln{}, ld{}, rn{}, rd{};
+    if(to_small(l, ln, ld) && to_small(r, rn, rd))
+    {
+      return make_small_ratio((i128{ ln } * rd) - (i128{ rn } * ld), i128{ ld } * rd);
+    }
+
     auto const denom{ l.denominator * r.denominator };
     auto const num{ (l.numerator * r.denominator) - (r.numerator * l.denominator) };
     return ratio::create(num, denom);
@@ -273,16 +440,30 @@ namespace jank::runtime::obj
 
   ratio_ref operator-(ratio_data const &l, i64 const r)
   {
+    if(i64 ln{}, ld{}; to_small(l, ln, ld))
+    {
+      return make_box<ratio>(make_small_ratio_data(ln - (i128{ r } * ld), ld));
+    }
     return make_box<ratio>(ratio_data(l.numerator - (r * l.denominator), l.denominator));
   }
 
   ratio_ref operator-(i64 const l, ratio_data const &r)
   {
+    if(i64 rn{}, rd{}; to_small(r, rn, rd))
+    {
+      return make_box<ratio>(make_small_ratio_data((i128{ l } * rd) - rn, rd));
+    }
     return make_box<ratio>(ratio_data((l * r.denominator) - r.numerator, r.denominator));
   }
 
   object_ref operator*(ratio_data const &l, ratio_data const &r)
   {
+    i64 ln{}, ld{}, rn{}, rd{};
+    if(to_small(l, ln, ld) && to_small(r, rn, rd))
+    {
+      return make_small_ratio(i128{ ln } * rn, i128{ ld } * rd);
+    }
+
     return ratio::create(l.numerator * r.numerator, l.denominator * r.denominator);
   }
 
@@ -328,6 +509,12 @@ namespace jank::runtime::obj
 
   object_ref operator/(ratio_data const &l, ratio_data const &r)
   {
+    i64 ln{}, ld{}, rn{}, rd{};
+    if(to_small(l, ln, ld) && to_small(r, rn, rd))
+    {
+      return make_small_ratio(i128{ ln } * rd, i128{ ld } * rn);
+    }
+
     return ratio::create(l.numerator * r.denominator, l.denominator * r.numerator);
   }
 
@@ -363,6 +550,10 @@ namespace jank::runtime::obj
 
   ratio_ref operator/(ratio_data const &l, i64 const r)
   {
+    if(i64 ln{}, ld{}; to_small(l, ln, ld))
+    {
+      return make_box<ratio>(make_small_ratio_data(ln, i128{ ld } * r));
+    }
     return make_box<ratio>(ratio_data(l.numerator, l.denominator * r));
   }
 
@@ -418,11 +609,21 @@ namespace jank::runtime::obj
 
   bool operator<(ratio_data const &l, ratio_data const &r)
   {
+    i64 ln{}, ld{}, rn{}, rd{};
+    if(to_small(l, ln, ld) && to_small(r, rn, rd))
+    {
+      return i128{ ln } * rd < i128{ rn } * ld;
+    }
     return l.numerator * r.denominator < r.numerator * l.denominator;
   }
 
   bool operator<=(ratio_data const &l, ratio_data const &r)
   {
+    i64 ln{}, ld{}, rn{}, rd{};
+    if(to_small(l, ln, ld) && to_small(r, rn, rd))
+    {
+      return i128{ ln } * rd <= i128{ rn } * ld;
+    }
     return l.numerator * r.denominator <= r.numerator * l.denominator;
   }
 
@@ -6,7 +6,7 @@ namespace jank::runtime::obj
 {
   re_matcher::re_matcher(re_pattern_ref const re, jtl::immutable_string const &s)
     : re{ re }
-    , match_input{ s.c_str() }
+    , input{ s }
   {
   }
 
@@ -32,6 +32,11 @@ namespace jank::runtime::obj
     return to_string();
   }
 
+  void re_matcher::to_code_string(jtl::string_builder &buff) const
+  {
+    to_string(buff);
+  }
+
   uhash re_matcher::to_hash() const
   {
     return static_cast<uhash>(reinterpret_cast<uintptr_t>(this));
@@ -3,11 +3,15 @@
 
 namespace jank::runtime::obj
 {
-
   re_pattern::re_pattern(jtl::immutable_string const &s)
     : pattern{ s }
-    , regex{ s.c_str(), std::regex_constants::ECMAScript }
   {
+    auto const compiled(regex::compile(s));
+    if(compiled.is_err())
+    {
+      throw std::runtime_error{ compiled.expect_err().c_str() };
+    }
+    program = compiled.expect_ok();
   }
 
   bool re_pattern::equal(object const &o) const
@@ -28,10 +32,15 @@ namespace jank::runtime::obj
   jtl::immutable_string re_pattern::to_code_string() const
   {
     jtl::string_builder buff;
+    to_code_string(buff);
+    return buff.release();
+  }
+
+  void re_pattern::to_code_string(jtl::string_builder &buff) const
+  {
     buff("#\"");
     buff(pattern);
     buff('"');
-    return buff.release();
   }
 
   uhash re_pattern::to_hash() const
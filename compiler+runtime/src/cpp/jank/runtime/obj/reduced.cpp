@@ -31,6 +31,11 @@ namespace jank::runtime::obj
     return to_string();
   }
 
+  void reduced::to_code_string(jtl::string_builder &buff) const
+  {
+    to_string(buff);
+  }
+
   uhash reduced::to_hash() const
   {
     return static_cast<uhash>(reinterpret_cast<uintptr_t>(this));
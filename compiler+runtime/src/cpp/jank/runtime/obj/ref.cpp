@@ -0,0 +1,142 @@
+#include <mutex>
+
+#include <jank/runtime/obj/ref.hpp>
+#include <jank/runtime/obj/cons.hpp>
+#include <jank/runtime/behavior/callable.hpp>
+#include <jank/runtime/transaction.hpp>
+#include <jank/util/fmt.hpp>
+
+namespace jank::runtime::obj
+{
+  ref::ref(object_ref const val)
+    : current{ val.data }
+    , watches{ persistent_hash_map::empty() }
+  {
+    /* The first value is at point zero, so every transaction can see it. */
+    history.push_front({ val, 0 });
+  }
+
+  bool ref::equal(object const &o) const
+  {
+    return &o == &base;
+  }
+
+  jtl::immutable_string ref::to_string() const
+  {
+    jtl::string_builder buff;
+    to_string(buff);
+    return buff.release();
+  }
+
+  void ref::to_string(jtl::string_builder &buff) const
+  {
+    util::format_to(buff, "#object [{} {}]", object_type_str(base.type), &base);
+  }
+
+  jtl::immutable_string ref::to_code_string() const
+  {
+    return to_string();
+  }
+
+  void ref::to_code_string(jtl::string_builder &buff) const
+  {
+    to_string(buff);
+  }
+
+  uhash ref::to_hash() const
+  {
+    return static_cast<uhash>(reinterpret_cast<uintptr_t>(this));
+  }
+
+  object_ref ref::deref() const
+  {
+    if(is_in_transaction())
+    {
+      return runtime::detail::transaction_read(this);
+    }
+    return current.load(std::memory_order_acquire);
+  }
+
+  void ref::add_watch(object_ref const key, object_ref const fn)
+  {
+    auto locked_watches(watches.wlock());
+    *locked_watches = (*locked_watches)->assoc(key, fn);
+  }
+
+  void ref::remove_watch(object_ref const key)
+  {
+    auto locked_watches(watches.wlock());
+    *locked_watches = (*locked_watches)->dissoc(key);
+  }
+
+  object_ref ref::set(object_ref const val)
+  {
+    return runtime::detail::transaction_set(this, val);
+  }
+
+  object_ref ref::alter(object_ref const fn, object_ref const args)
+  {
+    return runtime::detail::transaction_set(this, apply_to(fn, deref(), args));
+  }
+
+  object_ref ref::commute(object_ref const fn, object_ref const args)
+  {
+    return runtime::detail::transaction_commute(this, fn, args);
+  }
+
+  object_ref ref::ensure()
+  {
+    return runtime::detail::transaction_ensure(this);
+  }
+
+  usize ref::history_count() const
+  {
+    std::shared_lock<std::shared_mutex> const l{ lock };
+    return history.size() - 1;
+  }
+
+  usize ref::get_min_history() const
+  {
+    return min_history.load();
+  }
+
+  ref_ref ref::set_min_history(usize const n)
+  {
+    min_history.store(n);
+    return this;
+  }
+
+  usize ref::get_max_history() const
+  {
+    return max_history.load();
+  }
+
+  ref_ref ref::set_max_history(usize const n)
+  {
+    max_history.store(n);
+    return this;
+  }
+
+  void ref::push_version(object_ref const val, u64 const point)
+  {
+    auto const count{ history.size() - 1 };
+    /* Faults grow the history, until we reach the max. Otherwise, the oldest value makes
+     * room for the new one. */
+    if((0 < faults.load() && count < max_history.load()) || count < min_history.load())
+    {
+      faults.store(0);
+    }
+    else
+    {
+      history.pop_back();
+    }
+    history.push_front({ val, point });
+
+    /* The max may have been lowered since the last commit. */
+    while(max_history.load() + 1 < history.size())
+    {
+      history.pop_back();
+    }
+    current.store(val.data, std::memory_order_release);
+  }
+}
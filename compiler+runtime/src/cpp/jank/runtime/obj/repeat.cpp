@@ -3,6 +3,7 @@
 #include <jank/runtime/core/math.hpp>
 #include <jank/runtime/core/make_box.hpp>
 #include <jank/runtime/core/seq.hpp>
+#include <jank/runtime/behavior/reducible.hpp>
 
 namespace jank::runtime::obj
 {
@@ -37,6 +38,33 @@ namespace jank::runtime::obj
     return make_box<repeat>(count, value);
   }
 
+  object_ref repeat::reduce(object_ref const f, object_ref const init) const
+  {
+    object_ref res{ init };
+    if(runtime::equal(count, make_box(infinite)))
+    {
+      /* Only a reduced value can end this. */
+      while(true)
+      {
+        res = dynamic_call(f, res, value);
+        if(behavior::detail::unwrap_reduced(res))
+        {
+          return res;
+        }
+      }
+    }
+
+    for(i64 i{}, n{ to_int(count) }; i < n; ++i)
+    {
+      res = dynamic_call(f, res, value);
+      if(behavior::detail::unwrap_reduced(res))
+      {
+        break;
+      }
+    }
+    return res;
+  }
+
   repeat_ref repeat::seq()
   {
     return this;
@@ -108,6 +136,11 @@ namespace jank::runtime::obj
     return runtime::to_code_string(seq());
   }
 
+  void repeat::to_code_string(jtl::string_builder &buff)
+  {
+    runtime::to_code_string(seq(), buff);
+  }
+
   uhash repeat::to_hash() const
   {
     return hash::ordered(&base);
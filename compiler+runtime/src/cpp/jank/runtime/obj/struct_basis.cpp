@@ -0,0 +1,90 @@
+#include <jank/runtime/obj/struct_basis.hpp>
+#include <jank/runtime/core/equal.hpp>
+#include <jank/runtime/core/seq_ext.hpp>
+#include <jank/runtime/core/to_string.hpp>
+#include <jank/util/fmt.hpp>
+
+namespace jank::runtime::obj
+{
+  struct_basis::struct_basis(native_vector<object_ref> &&keys)
+    : keys{ jtl::move(keys) }
+  {
+  }
+
+  struct_basis_ref struct_basis::create(object_ref const keys)
+  {
+    native_vector<object_ref> unique;
+    runtime::for_each(keys, [&](object_ref const k) {
+      for(auto const existing : unique)
+      {
+        if(runtime::equal(existing, k))
+        {
+          throw std::runtime_error{ util::format("duplicate struct key: {}",
+                                                 runtime::to_code_string(k)) };
+        }
+      }
+      unique.emplace_back(k);
+    });
+    return make_box<struct_basis>(jtl::move(unique));
+  }
+
+  bool struct_basis::equal(object const &o) const
+  {
+    return &o == &base;
+  }
+
+  jtl::immutable_string struct_basis::to_string() const
+  {
+    jtl::string_builder buff;
+    to_string(buff);
+    return buff.release();
+  }
+
+  void struct_basis::to_string(jtl::string_builder &buff) const
+  {
+    util::format_to(buff, "#object [{} {} ", object_type_str(base.type), &base);
+    runtime::to_code_string(keys.begin(), keys.end(), "[", ']', buff);
+    buff(']');
+  }
+
+  jtl::immutable_string struct_basis::to_code_string() const
+  {
+    return to_string();
+  }
+
+  void struct_basis::to_code_string(jtl::string_builder &buff) const
+  {
+    to_string(buff);
+  }
+
+  uhash struct_basis::to_hash() const
+  {
+    return static_cast<uhash>(reinterpret_cast<uintptr_t>(this));
+  }
+
+  jtl::option<usize> struct_basis::slot(object_ref const key) const
+  {
+    /* Keywords are interned, so they can be compared by pointer. Struct keys are almost
+     * always keywords. */
+    if(key->type == object_type::keyword)
+    {
+      for(usize i{}; i < keys.size(); ++i)
+      {
+        if(keys[i] == key)
+        {
+          return i;
+        }
+      }
+      return none;
+    }
+
+    for(usize i{}; i < keys.size(); ++i)
+    {
+      if(runtime::equal(keys[i], key))
+      {
+        return i;
+      }
+    }
+    return none;
+  }
+}
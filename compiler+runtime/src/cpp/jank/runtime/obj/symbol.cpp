@@ -63,12 +63,21 @@ namespace jank::runtime::obj
       return false;
     }
 
-    auto const s(expect_object<symbol>(&o));
-    return ns == s->ns && name == s->name;
+    return equal(*expect_object<symbol>(&o));
   }
 
+  /* Interned symbols are matched by identity. Otherwise, symbols which have already been
+   * hashed can usually be told apart by that. */
   bool symbol::equal(symbol const &s) const
   {
+    if(this == &s)
+    {
+      return true;
+    }
+    if(hash && s.hash && hash != s.hash)
+    {
+      return false;
+    }
     return ns == s.ns && name == s.name;
   }
 
@@ -134,6 +143,11 @@ namespace jank::runtime::obj
     return to_string();
   }
 
+  void symbol::to_code_string(jtl::string_builder &buff) const
+  {
+    to_string(buff);
+  }
+
   uhash symbol::to_hash() const
   {
     if(hash)
@@ -164,7 +178,7 @@ namespace jank::runtime::obj
 
   bool symbol::operator==(symbol const &rhs) const
   {
-    return ns == rhs.ns && name == rhs.name;
+    return equal(rhs);
   }
 
   bool symbol::operator<(symbol const &rhs) const
@@ -51,6 +51,11 @@ namespace jank::runtime::obj
     return to_string();
   }
 
+  void tagged_literal::to_code_string(jtl::string_builder &buff) const
+  {
+    to_string(buff);
+  }
+
   uhash tagged_literal::to_hash() const
   {
     if(hash)
@@ -49,6 +49,11 @@ namespace jank::runtime::obj
     return to_string();
   }
 
+  void transient_array_map::to_code_string(jtl::string_builder &buff) const
+  {
+    to_string(buff);
+  }
+
   uhash transient_array_map::to_hash() const
   {
     /* Hash is also based only on identity. Clojure uses default hashCode, which does the same. */
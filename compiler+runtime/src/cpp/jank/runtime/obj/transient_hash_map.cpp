@@ -5,6 +5,8 @@
 #include <jank/runtime/rtti.hpp>
 #include <jank/runtime/core/to_string.hpp>
 #include <jank/runtime/core/seq.hpp>
+#include <jank/runtime/core/seq_ext.hpp>
+#include <jank/runtime/visit.hpp>
 #include <jank/runtime/detail/native_array_map.hpp>
 #include <jank/util/fmt.hpp>
 
@@ -61,6 +63,11 @@ namespace jank::runtime::obj
     return to_string();
   }
 
+  void transient_hash_map::to_code_string(jtl::string_builder &buff) const
+  {
+    to_string(buff);
+  }
+
   uhash transient_hash_map::to_hash() const
   {
     /* Hash is also based only on identity. Clojure uses default hashCode, which does the same. */
@@ -156,6 +163,49 @@ namespace jank::runtime::obj
     return this;
   }
 
+  transient_hash_map_ref transient_hash_map::conj_all_in_place(object_ref const coll)
+  {
+    assert_active();
+
+    /* Maps can give us their entries directly, without boxing each into a vector. */
+    auto const merged{ visit_object(
+      [this](auto const typed_coll) -> bool {
+        using T = typename jtl::decay_t<decltype(typed_coll)>::value_type;
+
+        if constexpr(jtl::is_same<T, persistent_array_map> || jtl::is_same<T, persistent_hash_map>
+                     || jtl::is_same<T, persistent_sorted_map>)
+        {
+          for(auto const &pair : typed_coll->data)
+          {
+            data.set(pair.first, pair.second);
+          }
+          return true;
+        }
+        else
+        {
+          return false;
+        }
+      },
+      coll) };
+
+    if(!merged)
+    {
+      runtime::for_each(coll, [this](object_ref const e) { conj_in_place(e); });
+    }
+    return this;
+  }
+
+  transient_hash_map_ref
+  transient_hash_map::conj_all_in_place(native_vector<object_ref> const &elems)
+  {
+    assert_active();
+    for(auto const e : elems)
+    {
+      conj_in_place(e);
+    }
+    return this;
+  }
+
   transient_hash_map::persistent_type_ref transient_hash_map::to_persistent()
   {
     assert_active();
@@ -2,6 +2,7 @@
 #include <jank/runtime/obj/persistent_hash_set.hpp>
 #include <jank/runtime/obj/persistent_vector.hpp>
 #include <jank/runtime/obj/nil.hpp>
+#include <jank/runtime/core/seq_ext.hpp>
 #include <jank/util/fmt.hpp>
 
 namespace jank::runtime::obj
@@ -49,6 +50,11 @@ namespace jank::runtime::obj
     return to_string();
   }
 
+  void transient_hash_set::to_code_string(jtl::string_builder &buff) const
+  {
+    to_string(buff);
+  }
+
   uhash transient_hash_set::to_hash() const
   {
     /* Hash is also based only on identity. Clojure uses default hashCode, which does the same. */
@@ -68,6 +74,24 @@ namespace jank::runtime::obj
     return this;
   }
 
+  transient_hash_set_ref transient_hash_set::conj_all_in_place(object_ref const coll)
+  {
+    assert_active();
+    runtime::for_each(coll, [this](object_ref const e) { data.insert(e); });
+    return this;
+  }
+
+  transient_hash_set_ref
+  transient_hash_set::conj_all_in_place(native_vector<object_ref> const &elems)
+  {
+    assert_active();
+    for(auto const e : elems)
+    {
+      data.insert(e);
+    }
+    return this;
+  }
+
   transient_hash_set::persistent_type_ref transient_hash_set::to_persistent()
   {
     assert_active();
@@ -0,0 +1,180 @@
+#include <jank/runtime/obj/transient_int_map.hpp>
+#include <jank/runtime/obj/persistent_int_map.hpp>
+#include <jank/runtime/obj/persistent_vector.hpp>
+#include <jank/runtime/obj/nil.hpp>
+#include <jank/runtime/obj/number.hpp>
+#include <jank/runtime/core/seq.hpp>
+#include <jank/runtime/core/to_string.hpp>
+#include <jank/runtime/rtti.hpp>
+#include <jank/util/fmt.hpp>
+
+namespace jank::runtime::obj
+{
+  transient_int_map::transient_int_map(runtime::detail::native_persistent_int_map const &d)
+    : data{ d.transient() }
+  {
+  }
+
+  transient_int_map::transient_int_map(value_type &&d)
+    : data{ std::move(d) }
+  {
+  }
+
+  transient_int_map_ref transient_int_map::empty()
+  {
+    return make_box<transient_int_map>();
+  }
+
+  bool transient_int_map::equal(object const &o) const
+  {
+    /* Transient equality, in Clojure, is based solely on identity. */
+    return &base == &o;
+  }
+
+  void transient_int_map::to_string(jtl::string_builder &buff) const
+  {
+    util::format_to(buff, "#object [{} {}]", object_type_str(base.type), &base);
+  }
+
+  jtl::immutable_string transient_int_map::to_string() const
+  {
+    jtl::string_builder buff;
+    to_string(buff);
+    return buff.release();
+  }
+
+  jtl::immutable_string transient_int_map::to_code_string() const
+  {
+    return to_string();
+  }
+
+  void transient_int_map::to_code_string(jtl::string_builder &buff) const
+  {
+    to_string(buff);
+  }
+
+  uhash transient_int_map::to_hash() const
+  {
+    /* Hash is also based only on identity. Clojure uses default hashCode, which does the same. */
+    return static_cast<uhash>(reinterpret_cast<uintptr_t>(this));
+  }
+
+  usize transient_int_map::count() const
+  {
+    assert_active();
+    return data.size();
+  }
+
+  object_ref transient_int_map::get(object_ref const key) const
+  {
+    return get(key, jank_nil());
+  }
+
+  object_ref transient_int_map::get(object_ref const key, object_ref const fallback) const
+  {
+    assert_active();
+    if(key->type != object_type::integer)
+    {
+      return fallback;
+    }
+    auto const res(data.find(expect_object<integer>(key)->data));
+    if(res.is_some())
+    {
+      return res.unwrap();
+    }
+    return fallback;
+  }
+
+  object_ref transient_int_map::get_entry(object_ref const key) const
+  {
+    assert_active();
+    if(key->type != object_type::integer)
+    {
+      return jank_nil();
+    }
+    auto const res(data.find(expect_object<integer>(key)->data));
+    if(res.is_some())
+    {
+      return make_box<persistent_vector>(std::in_place, key, res.unwrap());
+    }
+    return jank_nil();
+  }
+
+  bool transient_int_map::contains(object_ref const key) const
+  {
+    assert_active();
+    return key->type == object_type::integer && data.contains(expect_object<integer>(key)->data);
+  }
+
+  transient_int_map_ref
+  transient_int_map::assoc_in_place(object_ref const key, object_ref const val)
+  {
+    assert_active();
+    data.set(persistent_int_map::expect_key(key), val);
+    return this;
+  }
+
+  transient_int_map_ref transient_int_map::dissoc_in_place(object_ref const key)
+  {
+    assert_active();
+    if(key->type == object_type::integer)
+    {
+      data.erase(expect_object<integer>(key)->data);
+    }
+    return this;
+  }
+
+  transient_int_map_ref transient_int_map::conj_in_place(object_ref const head)
+  {
+    assert_active();
+
+    if(head.is_nil())
+    {
+      return this;
+    }
+
+    if(is_map(head))
+    {
+      return expect_object<transient_int_map>(runtime::merge_in_place(this, head));
+    }
+
+    if(head->type != object_type::persistent_vector)
+    {
+      throw std::runtime_error{ util::format("invalid map entry: {}", runtime::to_string(head)) };
+    }
+
+    auto const vec(expect_object<persistent_vector>(head));
+    if(vec->count() != 2)
+    {
+      throw std::runtime_error{ util::format("invalid map entry: {}", runtime::to_string(head)) };
+    }
+
+    data.set(persistent_int_map::expect_key(vec->data[0]), vec->data[1]);
+    return this;
+  }
+
+  transient_int_map::persistent_type_ref transient_int_map::to_persistent()
+  {
+    assert_active();
+    active = false;
+    return make_box<persistent_int_map>(data.persistent());
+  }
+
+  object_ref transient_int_map::call(object_ref const o) const
+  {
+    return get(o);
+  }
+
+  object_ref transient_int_map::call(object_ref const o, object_ref const fallback) const
+  {
+    return get(o, fallback);
+  }
+
+  void transient_int_map::assert_active() const
+  {
+    if(!active)
+    {
+      throw std::runtime_error{ "transient used after it's been made persistent" };
+    }
+  }
+}
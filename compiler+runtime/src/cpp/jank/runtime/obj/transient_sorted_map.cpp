@@ -10,11 +10,16 @@
 namespace jank::runtime::obj
 {
   transient_sorted_map::transient_sorted_map(runtime::detail::native_persistent_sorted_map const &d)
-    : data{ d }
+    : data{ d.transient() }
   {
   }
 
   transient_sorted_map::transient_sorted_map(runtime::detail::native_persistent_sorted_map &&d)
+    : data{ std::move(d).transient() }
+  {
+  }
+
+  transient_sorted_map::transient_sorted_map(value_type &&d)
     : data{ std::move(d) }
   {
   }
@@ -47,6 +52,11 @@ namespace jank::runtime::obj
     return to_string();
   }
 
+  void transient_sorted_map::to_code_string(jtl::string_builder &buff) const
+  {
+    to_string(buff);
+  }
+
   uhash transient_sorted_map::to_hash() const
   {
     /* Hash is also based only on identity. Clojure uses default hashCode, which does the same. */
@@ -63,9 +73,9 @@ namespace jank::runtime::obj
   {
     assert_active();
     auto const res(data.find(key));
-    if(res != data.end())
+    if(res)
     {
-      return res->second;
+      return *res;
     }
     return jank_nil();
   }
@@ -74,9 +84,9 @@ namespace jank::runtime::obj
   {
     assert_active();
     auto const res(data.find(key));
-    if(res != data.end())
+    if(res)
     {
-      return res->second;
+      return *res;
     }
     return fallback;
   }
@@ -85,9 +95,9 @@ namespace jank::runtime::obj
   {
     assert_active();
     auto const res(data.find(key));
-    if(res != data.end())
+    if(res)
     {
-      return make_box<persistent_vector>(std::in_place, key, res->second);
+      return make_box<persistent_vector>(std::in_place, key, *res);
     }
     return jank_nil();
   }
@@ -102,7 +112,7 @@ namespace jank::runtime::obj
   transient_sorted_map::assoc_in_place(object_ref const key, object_ref const val)
   {
     assert_active();
-    data[key] = val;
+    data.set(key, val);
     return this;
   }
 
@@ -138,7 +148,7 @@ namespace jank::runtime::obj
       throw std::runtime_error{ util::format("invalid map entry: {}", runtime::to_string(head)) };
     }
 
-    data.insert_or_assign(vec->data[0], vec->data[1]);
+    data.set(vec->data[0], vec->data[1]);
     return this;
   }
 
@@ -146,7 +156,7 @@ namespace jank::runtime::obj
   {
     assert_active();
     active = false;
-    return make_box<persistent_sorted_map>(std::move(data));
+    return make_box<persistent_sorted_map>(data.persistent());
   }
 
   object_ref transient_sorted_map::call(object_ref const o) const
@@ -7,11 +7,16 @@
 namespace jank::runtime::obj
 {
   transient_sorted_set::transient_sorted_set(runtime::detail::native_persistent_sorted_set const &d)
-    : data{ d }
+    : data{ d.transient() }
   {
   }
 
   transient_sorted_set::transient_sorted_set(runtime::detail::native_persistent_sorted_set &&d)
+    : data{ std::move(d).transient() }
+  {
+  }
+
+  transient_sorted_set::transient_sorted_set(value_type &&d)
     : data{ std::move(d) }
   {
   }
@@ -44,6 +49,11 @@ namespace jank::runtime::obj
     return to_string();
   }
 
+  void transient_sorted_set::to_code_string(jtl::string_builder &buff) const
+  {
+    to_string(buff);
+  }
+
   uhash transient_sorted_set::to_hash() const
   {
     /* Hash is also based only on identity. Clojure uses default hashCode, which does the same. */
@@ -67,14 +77,14 @@ namespace jank::runtime::obj
   {
     assert_active();
     active = false;
-    return make_box<persistent_sorted_set>(data);
+    return make_box<persistent_sorted_set>(data.persistent());
   }
 
   object_ref transient_sorted_set::call(object_ref const elem)
   {
     assert_active();
     auto const found(data.find(elem));
-    if(found != data.end())
+    if(found)
     {
       return *found;
     }
@@ -85,7 +95,7 @@ namespace jank::runtime::obj
   {
     assert_active();
     auto const found(data.find(elem));
-    if(found != data.end())
+    if(found)
     {
       return *found;
     }
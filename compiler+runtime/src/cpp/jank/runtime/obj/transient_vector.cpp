@@ -3,6 +3,7 @@
 #include <jank/runtime/obj/nil.hpp>
 #include <jank/runtime/obj/number.hpp>
 #include <jank/runtime/core/to_string.hpp>
+#include <jank/runtime/core/seq_ext.hpp>
 #include <jank/runtime/rtti.hpp>
 #include <jank/util/fmt.hpp>
 
@@ -51,6 +52,11 @@ namespace jank::runtime::obj
     return to_string();
   }
 
+  void transient_vector::to_code_string(jtl::string_builder &buff) const
+  {
+    to_string(buff);
+  }
+
   uhash transient_vector::to_hash() const
   {
     /* Hash is also based only on identity. Clojure uses default hashCode, which does the same. */
@@ -70,6 +76,23 @@ namespace jank::runtime::obj
     return this;
   }
 
+  transient_vector_ref transient_vector::conj_all_in_place(object_ref const coll)
+  {
+    assert_active();
+    runtime::for_each(coll, [this](object_ref const e) { data.push_back(e); });
+    return this;
+  }
+
+  transient_vector_ref transient_vector::conj_all_in_place(native_vector<object_ref> const &elems)
+  {
+    assert_active();
+    for(auto const e : elems)
+    {
+      data.push_back(e);
+    }
+    return this;
+  }
+
   transient_vector::persistent_type_ref transient_vector::to_persistent()
   {
     assert_active();
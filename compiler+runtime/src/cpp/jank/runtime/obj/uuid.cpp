@@ -1,18 +1,30 @@
+#include <array>
+
 #include <uuid.h>
 
 #include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/random.hpp>
 #include <jank/runtime/obj/uuid.hpp>
 #include <jank/runtime/rtti.hpp>
 #include <jank/util/fmt/print.hpp>
 
 namespace jank::runtime::obj
 {
+  /* A version 4 uuid, from two numbers of the thread's generator. stduuid's generator would
+   * need a std engine and distribution each time. */
   static jtl::ref<uuids::uuid> random()
   {
-    static std::random_device rd;
-    std::mt19937 g(rd());
-    uuids::uuid_random_generator gen{ g };
-    return jtl::make_ref<uuids::uuid>(gen());
+    auto &gen(thread_random());
+    auto const high{ gen() }, low{ gen() };
+    std::array<uuids::uuid::value_type, 16> bytes{};
+    for(usize i{}; i < 8; ++i)
+    {
+      bytes[i] = static_cast<uuids::uuid::value_type>(high >> (i * 8));
+      bytes[i + 8] = static_cast<uuids::uuid::value_type>(low >> (i * 8));
+    }
+    bytes[6] = (bytes[6] & 0x0f) | 0x40;
+    bytes[8] = (bytes[8] & 0x3f) | 0x80;
+    return jtl::make_ref<uuids::uuid>(bytes);
   }
 
   static jtl::ref<uuids::uuid> from_string(jtl::immutable_string const &s)
@@ -38,6 +50,11 @@ namespace jank::runtime::obj
   {
   }
 
+  uuid::uuid(jtl::ref<uuids::uuid> const value)
+    : value{ value }
+  {
+  }
+
   bool uuid::equal(object const &o) const
   {
     if(o.type != object_type::uuid)
@@ -64,10 +81,15 @@ namespace jank::runtime::obj
   jtl::immutable_string uuid::to_code_string() const
   {
     jtl::string_builder buff;
+    to_code_string(buff);
+    return buff.release();
+  }
+
+  void uuid::to_code_string(jtl::string_builder &buff) const
+  {
     buff("#uuid \"");
     buff(uuids::to_string(*value));
     buff('"');
-    return buff.release();
   }
 
   uhash uuid::to_hash() const
@@ -6,41 +6,11 @@
 
 namespace jank::runtime
 {
-  object::object(object const &rhs) noexcept
-    : type{ rhs.type }
-  {
-  }
-
-  object::object(object &&rhs) noexcept
-    : type{ rhs.type }
-  {
-  }
-
   object::object(object_type const type) noexcept
     : type{ type }
   {
   }
 
-  object &object::operator=(object const &rhs) noexcept
-  {
-    if(this == &rhs)
-    {
-      return *this;
-    }
-    type = rhs.type;
-    return *this;
-  }
-
-  object &object::operator=(object &&rhs) noexcept
-  {
-    if(this == &rhs)
-    {
-      return *this;
-    }
-    type = rhs.type;
-    return *this;
-  }
-
   bool very_equal_to::operator()(object_ref const lhs, object_ref const rhs) const noexcept
   {
     if(lhs->type != rhs->type)
@@ -0,0 +1,103 @@
+#include <mutex>
+#include <new>
+
+#include <gc/gc.h>
+#include <gc/gc_inline.h>
+#include <gc/gc_mark.h>
+
+#include <jank/runtime/object_pool.hpp>
+
+namespace jank::runtime
+{
+  /* Every live pool, so their stats can be summed, along with what's left of the pools for
+   * threads which have exited. */
+  static std::mutex pools_mutex;
+  static native_set<object_pool *> &live_pools()
+  {
+    static native_set<object_pool *> pools;
+    return pools;
+  }
+
+  static object_pool_stats exited_stats;
+
+  /* Owns this thread's pool. When the thread exits, we drop the pool's free lists, so the
+   * GC can collect what was left on them. */
+  struct pool_owner
+  {
+    pool_owner()
+    {
+      pool = new(GC_MALLOC_UNCOLLECTABLE(sizeof(object_pool))) object_pool{};
+      std::lock_guard<std::mutex> const lock{ pools_mutex };
+      live_pools().emplace(pool);
+    }
+
+    pool_owner(pool_owner const &) = delete;
+    pool_owner(pool_owner &&) = delete;
+
+    ~pool_owner()
+    {
+      {
+        std::lock_guard<std::mutex> const lock{ pools_mutex };
+        exited_stats.allocations += pool->allocations.load(std::memory_order_relaxed);
+        exited_stats.refills += pool->refills.load(std::memory_order_relaxed);
+        live_pools().erase(pool);
+      }
+      pool->~object_pool();
+      GC_FREE(pool);
+    }
+
+    pool_owner &operator=(pool_owner const &) = delete;
+    pool_owner &operator=(pool_owner &&) = delete;
+
+    object_pool *pool{};
+  };
+
+  /* The owner only points at the uncollectable pool, so the GC doesn't need to see it. */
+  static object_pool &current_pool()
+  {
+    static thread_local pool_owner owner;
+    return *owner.pool;
+  }
+
+  static void bump(std::atomic<usize> &counter)
+  {
+    /* Only this thread writes to the counter, so this doesn't need to be an atomic
+     * increment. */
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+
+  void *pool_allocate(usize const size)
+  {
+    auto &pool(current_pool());
+    auto const size_class{ (size - 1) / object_pool::granule_size };
+    auto &head(pool.free_lists[size_class]);
+    if(!head) [[unlikely]]
+    {
+      /* This gives us a list of at least one object, all zeroed aside from the link. */
+      GC_generic_malloc_many((size_class + 1) * object_pool::granule_size, GC_I_NORMAL, &head);
+      if(!head)
+      {
+        throw std::bad_alloc{};
+      }
+      bump(pool.refills);
+    }
+
+    auto const ret{ head };
+    head = GC_NEXT(ret);
+    GC_NEXT(ret) = nullptr;
+    bump(pool.allocations);
+    return ret;
+  }
+
+  object_pool_stats pool_stats()
+  {
+    std::lock_guard<std::mutex> const lock{ pools_mutex };
+    auto ret{ exited_stats };
+    for(auto const &pool : live_pools())
+    {
+      ret.allocations += pool->allocations.load(std::memory_order_relaxed);
+      ret.refills += pool->refills.load(std::memory_order_relaxed);
+    }
+    return ret;
+  }
+}
@@ -1,39 +1,130 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+#include <dlfcn.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <gc/gc.h>
+
 #include <nanobench.h>
 
 #include <jank/runtime/perf.hpp>
+#include <jank/runtime/allocation_sites.hpp>
+#include <jank/runtime/metrics.hpp>
+#include <jank/runtime/arena.hpp>
+#include <jank/runtime/object_pool.hpp>
+#include <jank/runtime/heap_snapshot.hpp>
+#include <jank/runtime/fn_stats.hpp>
+#include <jank/runtime/behavior/callable.hpp>
 #include <jank/runtime/visit.hpp>
 #include <jank/runtime/context.hpp>
+#include <jank/runtime/core/equal.hpp>
 #include <jank/runtime/core/seq.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/math.hpp>
+#include <jank/runtime/core/truthy.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
+#include <jank/runtime/obj/persistent_vector.hpp>
+#include <jank/runtime/obj/opaque_box.hpp>
+#include <jank/profile/time.hpp>
+#include <jank/profile/sampler.hpp>
+#include <jank/jit/stats.hpp>
+#include <jank/jit/symbols.hpp>
 #include <jank/util/fmt.hpp>
+#include <jank/util/scope_exit.hpp>
 
 namespace jank::runtime::perf
 {
+  struct time_unit
+  {
+    char const *name{};
+    std::chrono::duration<double> duration{};
+  };
+
+  static time_unit parse_time_unit(object_ref const unit)
+  {
+    static std::array<time_unit, 4> const units{
+      { { "ns", std::chrono::nanoseconds{ 1 } },
+       { "us", std::chrono::microseconds{ 1 } },
+       { "ms", std::chrono::milliseconds{ 1 } },
+       { "s", std::chrono::seconds{ 1 } } }
+    };
+
+    if(unit.is_nil())
+    {
+      return units[2];
+    }
+    for(auto const &u : units)
+    {
+      if(runtime::equal(unit, __rt_ctx->intern_keyword(u.name).expect_ok()))
+      {
+        return u;
+      }
+    }
+    throw make_box(util::format("Invalid benchmark time unit: {}", to_code_string(unit))).erase();
+  }
+
+  static u64 opt_or(object_ref const opts, char const * const name, u64 const fallback)
+  {
+    auto const v(get(opts, __rt_ctx->intern_keyword(name).expect_ok()));
+    if(v.is_nil())
+    {
+      return fallback;
+    }
+    return static_cast<u64>(std::max<i64>(to_int(v), 1));
+  }
+
+  /* Nearest rank, over samples which are already sorted. */
+  static f64 percentile(std::vector<f64> const &sorted, f64 const p)
+  {
+    auto const rank(static_cast<usize>(std::ceil(p / 100.0 * static_cast<f64>(sorted.size()))));
+    return sorted[std::clamp<usize>(rank, 1, sorted.size()) - 1];
+  }
+
+  static f64 median(std::vector<f64> sorted)
+  {
+    std::ranges::sort(sorted);
+    auto const mid(sorted.size() / 2);
+    if(sorted.size() % 2 == 0)
+    {
+      return (sorted[mid - 1] + sorted[mid]) / 2.0;
+    }
+    return sorted[mid];
+  }
+
   object_ref benchmark(object_ref const opts, object_ref const f)
   {
-    auto const label(get(opts, __rt_ctx->intern_keyword("label").expect_ok()));
-    auto const label_str(to_string(label));
+    using measure = ankerl::nanobench::Result::Measure;
+
+    auto const kw(
+      [](char const * const name) { return __rt_ctx->intern_keyword(name).expect_ok(); });
+    auto const label(get(opts, kw("label")));
+    auto const unit(parse_time_unit(get(opts, kw("time-unit"))));
+
+    ankerl::nanobench::Bench bench;
+    bench.output(truthy(get(opts, kw("quiet"))) ? nullptr : &std::cout)
+      .timeUnit(unit.duration, unit.name)
+      .minEpochIterations(opt_or(opts, "min-iterations", 20))
+      .warmup(opt_or(opts, "warmup", 10));
+    if(get(opts, kw("epochs")).is_some())
+    {
+      bench.epochs(opt_or(opts, "epochs", 1));
+    }
+
     visit_object(
-      [](auto const typed_f, jtl::immutable_string const &label) {
+      [&](auto const typed_f) {
         using T = typename jtl::decay_t<decltype(typed_f)>::value_type;
 
         if constexpr(std::is_base_of_v<behavior::callable, T>)
         {
-          ankerl::nanobench::Config config;
-          config.mOut = &std::cout;
-
-          /* Larger things. */
-          config.mTimeUnitName = "ms";
-          config.mTimeUnit = std::chrono::milliseconds{ 1 };
-          config.mMinEpochIterations = 20;
-          config.mWarmup = 10;
-
-          /* Smaller things. */
-          //config.mTimeUnitName = "ns";
-          //config.mTimeUnit = std::chrono::nanoseconds{ 1 };
-          //config.mMinEpochIterations = 1000000;
-          //config.mWarmup = 1000;
-
-          ankerl::nanobench::Bench().config(config).run(static_cast<std::string>(label), [&] {
+          bench.run(static_cast<std::string>(to_string(label)), [&] {
             auto const res(typed_f->call());
             ankerl::nanobench::doNotOptimizeAway(res);
           });
@@ -43,8 +134,483 @@ namespace jank::runtime::perf
           throw std::runtime_error{ util::format("not callable: {}", typed_f->to_string()) };
         }
       },
-      f,
-      label_str);
+      f);
+
+    /* Each sample is one epoch, with its time already divided by its iterations. */
+    auto const &result(bench.results().back());
+    auto const unit_seconds(unit.duration.count());
+    std::vector<f64> samples(result.size());
+    for(usize i{}; i < samples.size(); ++i)
+    {
+      samples[i] = result.get(i, measure::elapsed) / unit_seconds;
+    }
+    std::ranges::sort(samples);
+    auto const med(median(samples));
+    std::vector<f64> deviations(samples.size());
+    for(usize i{}; i < samples.size(); ++i)
+    {
+      deviations[i] = std::abs(samples[i] - med);
+    }
+
+    runtime::detail::native_transient_hash_map stats;
+    stats.set(kw("label"), label);
+    stats.set(kw("time-unit"), kw(unit.name));
+    stats.set(kw("epochs"), make_box(static_cast<i64>(samples.size())));
+    stats.set(kw("iterations"), make_box(static_cast<i64>(result.sum(measure::iterations))));
+    stats.set(kw("median"), make_box(med));
+    stats.set(kw("mad"), make_box(median(deviations)));
+    stats.set(kw("error"), make_box(result.medianAbsolutePercentError(measure::elapsed)));
+    stats.set(kw("mean"), make_box(result.average(measure::elapsed) / unit_seconds));
+    stats.set(kw("min"), make_box(samples.front()));
+    stats.set(kw("max"), make_box(samples.back()));
+    stats.set(kw("percentiles"),
+              obj::persistent_hash_map::create_unique(
+                std::make_pair(make_box(50), make_box(percentile(samples, 50))),
+                std::make_pair(make_box(90), make_box(percentile(samples, 90))),
+                std::make_pair(make_box(95), make_box(percentile(samples, 95))),
+                std::make_pair(make_box(99), make_box(percentile(samples, 99)))));
+
+    /* These are only there when the OS lets us read the CPU's performance counters. */
+    auto const add_counter([&](char const * const name, measure const m) {
+      if(result.has(m))
+      {
+        stats.set(kw(name), make_box(result.median(m)));
+      }
+    });
+    add_counter("cycles", measure::cpucycles);
+    add_counter("instructions", measure::instructions);
+    add_counter("branches", measure::branchinstructions);
+    add_counter("branch-misses", measure::branchmisses);
+
+    /* A ratio above one means we're faster than the baseline, which is a previous result. */
+    if(auto const baseline(get(opts, kw("relative"))); baseline.is_some())
+    {
+      auto const baseline_unit(parse_time_unit(get(baseline, kw("time-unit"))));
+      auto const baseline_median(to_real(get(baseline, kw("median")))
+                                 * baseline_unit.duration.count() / unit_seconds);
+      stats.set(kw("relative"), make_box(baseline_median / med));
+    }
+
+    return make_box<obj::persistent_hash_map>(stats.persistent());
+  }
+
+  object_ref enter_region(object_ref const region)
+  {
+    profile::enter(to_string(region));
+    return jank_nil();
+  }
+
+  object_ref exit_region(object_ref const region)
+  {
+    profile::exit(to_string(region));
     return jank_nil();
   }
+
+  object_ref call_with_arena(object_ref const f)
+  {
+    arena const a;
+    return dynamic_call(f);
+  }
+
+  /* These are only written by the GC's event callback, which is run by whichever thread is
+   * collecting, while it holds the GC lock. */
+  static std::atomic<i64> pause_start_ns{};
+  static std::atomic<i64> total_pause_ns{};
+  static std::atomic<i64> last_pause_ns{};
+  static std::atomic<i64> max_pause_ns{};
+  static metrics::histogram *pause_histogram{};
+
+  static i64 now_ns()
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+  }
+
+  /* The world is stopped in here, so this can't allocate or lock. */
+  static void on_collection_event(GC_EventType const event)
+  {
+    if(event == GC_EVENT_PRE_STOP_WORLD)
+    {
+      pause_start_ns.store(now_ns(), std::memory_order_relaxed);
+    }
+    else if(event == GC_EVENT_POST_START_WORLD)
+    {
+      auto const pause(now_ns() - pause_start_ns.load(std::memory_order_relaxed));
+      total_pause_ns.fetch_add(pause, std::memory_order_relaxed);
+      last_pause_ns.store(pause, std::memory_order_relaxed);
+      if(pause > max_pause_ns.load(std::memory_order_relaxed))
+      {
+        max_pause_ns.store(pause, std::memory_order_relaxed);
+      }
+      pause_histogram->record(static_cast<u64>(std::max<i64>(pause, 0)));
+    }
+  }
+
+  void track_gc_pauses()
+  {
+    pause_histogram = &*metrics::find_or_create_histogram("jank_gc_pause_ns",
+                                                          "The GC's stop the world pauses.")
+                          .expect_ok();
+    GC_set_on_collection_event(&on_collection_event);
+  }
+
+  static object_ref pause_ms(std::atomic<i64> const &ns)
+  {
+    return make_box(static_cast<f64>(ns.load(std::memory_order_relaxed)) / 1'000'000.0);
+  }
+
+#ifdef JANK_PROFILE_GC
+  static std::array<std::atomic<usize>, object_type_count> allocation_counts{};
+  static std::atomic<i64> bytes_until_sample{ allocation_sample_interval };
+
+  static std::mutex samples_mutex;
+  static native_unordered_map<void *, usize> samples;
+
+  /* This is noinline so that the return address is the allocation site, since make_box
+   * is inlined into its caller. */
+  [[gnu::noinline]]
+  void record_allocation(object_type const type, usize const size)
+  {
+    allocation_counts[static_cast<usize>(type)].fetch_add(1, std::memory_order_relaxed);
+
+    auto const remaining(
+      bytes_until_sample.fetch_sub(static_cast<i64>(size), std::memory_order_relaxed));
+    if(remaining > static_cast<i64>(size))
+    {
+      return;
+    }
+    bytes_until_sample.fetch_add(allocation_sample_interval, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> const lock{ samples_mutex };
+    ++samples[__builtin_return_address(0)];
+  }
+#endif
+
+  object_ref gc_stats()
+  {
+    GC_word heap_size{}, free_bytes{}, unmapped_bytes{}, bytes_since_gc{}, total_bytes{};
+    GC_get_heap_usage_safe(&heap_size,
+                           &free_bytes,
+                           &unmapped_bytes,
+                           &bytes_since_gc,
+                           &total_bytes);
+
+    auto const kw(
+      [](char const * const name) { return __rt_ctx->intern_keyword(name).expect_ok(); });
+    runtime::detail::native_transient_hash_map stats;
+    stats.set(kw("heap-size"), make_box(static_cast<i64>(heap_size)));
+    stats.set(kw("free-bytes"), make_box(static_cast<i64>(free_bytes)));
+    stats.set(kw("bytes-since-gc"), make_box(static_cast<i64>(bytes_since_gc)));
+    stats.set(kw("bytes-allocated"), make_box(static_cast<i64>(total_bytes)));
+    stats.set(kw("collections"), make_box(static_cast<i64>(GC_get_gc_no())));
+    stats.set(kw("total-pause-ms"), pause_ms(total_pause_ns));
+    stats.set(kw("last-pause-ms"), pause_ms(last_pause_ns));
+    stats.set(kw("max-pause-ms"), pause_ms(max_pause_ns));
+
+    auto const pools(pool_stats());
+    stats.set(kw("pool-allocations"), make_box(static_cast<i64>(pools.allocations)));
+    stats.set(kw("pool-refills"), make_box(static_cast<i64>(pools.refills)));
+
+#ifdef JANK_PROFILE_GC
+    runtime::detail::native_transient_hash_map allocations;
+    for(usize i{}; i < object_type_count; ++i)
+    {
+      auto const count(allocation_counts[i].load(std::memory_order_relaxed));
+      if(count)
+      {
+        allocations.set(kw(object_type_str(static_cast<object_type>(i))),
+                        make_box(static_cast<i64>(count)));
+      }
+    }
+    stats.set(kw("allocations"), make_box<obj::persistent_hash_map>(allocations.persistent()));
+#endif
+
+    return make_box<obj::persistent_hash_map>(stats.persistent());
+  }
+
+  object_ref memory_stats()
+  {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+
+    auto const kw(
+      [](char const * const name) { return __rt_ctx->intern_keyword(name).expect_ok(); });
+    runtime::detail::native_transient_hash_map stats;
+    /* Linux gives the peak in KB, while macOS gives it in bytes. */
+    auto const maxrss_unit{ jtl::current_platform == jtl::platform::macos_like ? 1 : 1024 };
+    stats.set(kw("peak-rss-bytes"), make_box(static_cast<i64>(usage.ru_maxrss) * maxrss_unit));
+    stats.set(kw("minor-page-faults"), make_box(static_cast<i64>(usage.ru_minflt)));
+    stats.set(kw("major-page-faults"), make_box(static_cast<i64>(usage.ru_majflt)));
+
+    if constexpr(jtl::current_platform == jtl::platform::linux_like)
+    {
+      /* The second field is the resident size, in pages. */
+      std::ifstream statm{ "/proc/self/statm" };
+      i64 size{}, resident{};
+      if(statm >> size >> resident)
+      {
+        stats.set(kw("rss-bytes"), make_box(resident * sysconf(_SC_PAGESIZE)));
+      }
+
+      std::ifstream smaps{ "/proc/self/smaps_rollup" };
+      std::string field;
+      i64 kb{};
+      while(smaps >> field)
+      {
+        if(field == "AnonHugePages:" && smaps >> kb)
+        {
+          stats.set(kw("huge-page-bytes"), make_box(kb * 1024));
+          break;
+        }
+      }
+    }
+
+    return make_box<obj::persistent_hash_map>(stats.persistent());
+  }
+
+  object_ref allocation_samples()
+  {
+    runtime::detail::native_transient_vector ret;
+#ifdef JANK_PROFILE_GC
+    native_vector<std::pair<void *, usize>> sorted;
+    {
+      std::lock_guard<std::mutex> const lock{ samples_mutex };
+      sorted.assign(samples.begin(), samples.end());
+    }
+    std::ranges::sort(sorted, [](auto const &l, auto const &r) { return l.second > r.second; });
+
+    auto const site_kw(__rt_ctx->intern_keyword("site").expect_ok());
+    auto const samples_kw(__rt_ctx->intern_keyword("samples").expect_ok());
+    for(auto const &[address, count] : sorted)
+    {
+      /* JIT compiled code has no symbols for dladdr to find, so we look for it first. */
+      Dl_info info{};
+      auto const jitted(jit::symbols::find(reinterpret_cast<uintptr_t>(address)));
+      auto const site(jitted.is_some() ? jitted.unwrap()
+                      : dladdr(address, &info) && info.dli_sname
+                        ? util::format("{}+{}",
+                                       info.dli_sname,
+                                       static_cast<char const *>(address)
+                                         - static_cast<char const *>(info.dli_saddr))
+                        : util::format("{}", static_cast<void const *>(address)));
+      ret.push_back(obj::persistent_hash_map::create_unique(
+        std::make_pair(site_kw, make_box(site)),
+        std::make_pair(samples_kw, make_box(static_cast<i64>(count)))));
+    }
+#endif
+    return make_box<obj::persistent_vector>(ret.persistent());
+  }
+
+  object_ref heap_snapshot(object_ref const path)
+  {
+    auto const res(heap_snapshot::write(to_string(path)));
+    if(res.is_err())
+    {
+      throw std::runtime_error{ res.expect_err().c_str() };
+    }
+
+    auto const &summary(res.expect_ok());
+    auto const kw(
+      [](char const * const name) { return __rt_ctx->intern_keyword(name).expect_ok(); });
+
+    runtime::detail::native_transient_vector retainers;
+    for(usize i{}; i < std::min<usize>(summary.retainers.size(), 20); ++i)
+    {
+      auto const &r(summary.retainers[i]);
+      retainers.push_back(obj::persistent_hash_map::create_unique(
+        std::make_pair(kw("name"), make_box(r.name)),
+        std::make_pair(kw("retained-bytes"), make_box(static_cast<i64>(r.retained_bytes))),
+        std::make_pair(kw("retained-objects"), make_box(static_cast<i64>(r.retained_count)))));
+    }
+
+    return obj::persistent_hash_map::create_unique(
+      std::make_pair(kw("objects"), make_box(static_cast<i64>(summary.count))),
+      std::make_pair(kw("bytes"), make_box(static_cast<i64>(summary.bytes))),
+      std::make_pair(kw("retainers"), make_box<obj::persistent_vector>(retainers.persistent())));
+  }
+
+  object_ref atom_stats(object_ref const a)
+  {
+    auto const typed_a(try_object<obj::atom>(a));
+    auto const kw(
+      [](char const * const name) { return __rt_ctx->intern_keyword(name).expect_ok(); });
+    return obj::persistent_hash_map::create_unique(
+      std::make_pair(kw("contended-swaps"),
+                     make_box(static_cast<i64>(typed_a->contended_swaps.load()))),
+      std::make_pair(kw("retries"), make_box(static_cast<i64>(typed_a->retries.load()))));
+  }
+
+  object_ref counter_atom(object_ref const initial)
+  {
+    return make_box<obj::counter_atom>(to_int(initial));
+  }
+
+  object_ref counter_add(object_ref const c, object_ref const n)
+  {
+    try_object<obj::counter_atom>(c)->add(to_int(n));
+    return jank_nil();
+  }
+
+  object_ref fn_stats()
+  {
+    return runtime::fn_stats::snapshot();
+  }
+
+  object_ref reset_fn_stats()
+  {
+    runtime::fn_stats::reset();
+    return jank_nil();
+  }
+
+  object_ref jit_stats()
+  {
+    return jit::stats::snapshot();
+  }
+
+  object_ref reset_jit_stats()
+  {
+    jit::stats::reset();
+    return jank_nil();
+  }
+
+  object_ref start_sampling(object_ref const hz)
+  {
+    auto const res(profile::sampler::start(static_cast<u32>(std::max<i64>(to_int(hz), 0))));
+    if(res.is_err())
+    {
+      throw make_box(res.expect_err()).erase();
+    }
+    return jank_nil();
+  }
+
+  object_ref stop_sampling()
+  {
+    auto const res(profile::sampler::stop());
+    auto const kw(
+      [](char const * const name) { return __rt_ctx->intern_keyword(name).expect_ok(); });
+    return obj::persistent_hash_map::create_unique(
+      std::make_pair(kw("samples"), make_box(static_cast<i64>(res.samples))),
+      std::make_pair(kw("dropped"), make_box(static_cast<i64>(res.dropped))),
+      std::make_pair(kw("folded"), make_box(profile::sampler::folded(res))));
+  }
+
+  object_ref start_allocation_tracking(object_ref const interval)
+  {
+    auto const res(
+      allocation_sites::start(static_cast<usize>(std::max<i64>(to_int(interval), 0))));
+    if(res.is_err())
+    {
+      throw make_box(res.expect_err()).erase();
+    }
+    return jank_nil();
+  }
+
+  object_ref stop_allocation_tracking()
+  {
+    auto const res(allocation_sites::stop());
+    auto const kw(
+      [](char const * const name) { return __rt_ctx->intern_keyword(name).expect_ok(); });
+
+    runtime::detail::native_transient_vector sites;
+    for(auto const &s : res.sites)
+    {
+      sites.push_back(obj::persistent_hash_map::create_unique(
+        std::make_pair(kw("fn"), make_box(s.fn)),
+        std::make_pair(kw("type"), kw(object_type_str(s.type))),
+        std::make_pair(kw("samples"), make_box(static_cast<i64>(s.samples))),
+        std::make_pair(kw("bytes"), make_box(static_cast<i64>(s.samples * res.interval))),
+        std::make_pair(kw("sampled-bytes"), make_box(static_cast<i64>(s.sampled_bytes)))));
+    }
+
+    return obj::persistent_hash_map::create_unique(
+      std::make_pair(kw("interval"), make_box(static_cast<i64>(res.interval))),
+      std::make_pair(kw("samples"), make_box(static_cast<i64>(res.samples))),
+      std::make_pair(kw("sites"), make_box<obj::persistent_vector>(sites.persistent())));
+  }
+
+  template <typename T>
+  static object_ref metric_box(jtl::result<jtl::ref<T>, jtl::immutable_string> const &res,
+                               char const * const type)
+  {
+    if(res.is_err())
+    {
+      throw make_box(res.expect_err()).erase();
+    }
+    return make_box<obj::opaque_box>(&*res.expect_ok(), type);
+  }
+
+  template <typename T>
+  static T &unbox_metric(object_ref const m, char const * const type)
+  {
+    auto const box(try_object<obj::opaque_box>(m));
+    if(box->canonical_type != type)
+    {
+      throw make_box(util::format("Expected a {}, but got {}", type, to_code_string(m))).erase();
+    }
+    return *static_cast<T *>(static_cast<void *>(box->data));
+  }
+
+  static constexpr char const *counter_type{ "jank::runtime::metrics::counter" };
+  static constexpr char const *gauge_type{ "jank::runtime::metrics::gauge" };
+  static constexpr char const *histogram_type{ "jank::runtime::metrics::histogram" };
+
+  object_ref metrics_counter(object_ref const name, object_ref const help)
+  {
+    return metric_box(metrics::find_or_create_counter(to_string(name), to_string(help)),
+                      counter_type);
+  }
+
+  object_ref metrics_gauge(object_ref const name, object_ref const help)
+  {
+    return metric_box(metrics::find_or_create_gauge(to_string(name), to_string(help)),
+                      gauge_type);
+  }
+
+  object_ref metrics_histogram(object_ref const name, object_ref const help)
+  {
+    return metric_box(metrics::find_or_create_histogram(to_string(name), to_string(help)),
+                      histogram_type);
+  }
+
+  object_ref inc_counter(object_ref const c, object_ref const n)
+  {
+    unbox_metric<metrics::counter>(c, counter_type).add(to_int(n));
+    return jank_nil();
+  }
+
+  object_ref set_gauge(object_ref const g, object_ref const v)
+  {
+    unbox_metric<metrics::gauge>(g, gauge_type).set(to_real(v));
+    return jank_nil();
+  }
+
+  object_ref record_histogram(object_ref const h, object_ref const v)
+  {
+    unbox_metric<metrics::histogram>(h, histogram_type)
+      .record(static_cast<u64>(std::max<i64>(to_int(v), 0)));
+    return jank_nil();
+  }
+
+  object_ref time_call(object_ref const h, object_ref const f)
+  {
+    auto &typed_h(unbox_metric<metrics::histogram>(h, histogram_type));
+    auto const start(std::chrono::steady_clock::now());
+    util::scope_exit const finally{ [&] {
+      typed_h.record(static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                        std::chrono::steady_clock::now() - start)
+                                        .count()));
+    } };
+    return dynamic_call(f);
+  }
+
+  object_ref metrics_snapshot()
+  {
+    return metrics::snapshot();
+  }
+
+  object_ref prometheus_metrics()
+  {
+    return make_box(metrics::prometheus());
+  }
 }
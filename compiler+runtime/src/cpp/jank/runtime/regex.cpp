@@ -0,0 +1,51 @@
+#include <jank/runtime/regex.hpp>
+#include <jank/runtime/detail/intern_table.hpp>
+
+namespace jank::runtime::regex
+{
+  /* Programs are keyed only on their pattern, so the namespace is always empty. */
+  static runtime::detail::intern_table<program const *> &programs()
+  {
+    static runtime::detail::intern_table<program const *> table;
+    return table;
+  }
+
+  jtl::result<program const *, jtl::immutable_string> compile(jtl::immutable_string const &pattern)
+  {
+    if(auto const found{ programs().find("", pattern) })
+    {
+      return ok(found);
+    }
+
+    /* We compile outside of the table's lock, since compiling can be slow. If another
+     * thread wins the race to intern the same pattern, we just throw ours away. */
+    auto const compiled(detail::compile_program(pattern));
+    if(compiled.is_err())
+    {
+      return compiled;
+    }
+    auto const ours{ compiled.expect_ok() };
+    auto const interned{ programs().intern("", pattern, [&] { return ours; }) };
+    if(interned != ours)
+    {
+      detail::destroy_program(ours);
+    }
+    return ok(interned);
+  }
+
+  usize next_start(jtl::immutable_string const &input, span const &whole)
+  {
+    auto ret{ whole.offset + whole.size };
+    if(whole.size != 0)
+    {
+      return ret;
+    }
+
+    ++ret;
+    while(ret < input.size() && (static_cast<u8>(input[ret]) & 0xc0) == 0x80)
+    {
+      ++ret;
+    }
+    return ret;
+  }
+}
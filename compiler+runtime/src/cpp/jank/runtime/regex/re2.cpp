@@ -0,0 +1,103 @@
+#include <vector>
+
+#include <re2/re2.h>
+
+#include <jank/runtime/regex.hpp>
+
+/* RE2 compiles patterns to automata, so matching takes linear time in the input and never
+ * backtracks. In return, it doesn't support backreferences or lookaround. */
+namespace jank::runtime::regex
+{
+  struct program
+  {
+    program(jtl::immutable_string const &pattern)
+      : regex{ re2::StringPiece{ pattern.data(), pattern.size() }, RE2::Quiet }
+    {
+    }
+
+    RE2 regex;
+  };
+
+  jtl::immutable_string_view backend_name()
+  {
+    return "RE2";
+  }
+
+  namespace detail
+  {
+    jtl::result<program const *, jtl::immutable_string>
+    compile_program(jtl::immutable_string const &pattern)
+    {
+      auto const ret{ new program{ pattern } };
+      if(!ret->regex.ok())
+      {
+        jtl::immutable_string const error{ ret->regex.error() };
+        delete ret;
+        return err(error);
+      }
+      return ok(ret);
+    }
+
+    void destroy_program(program const * const p)
+    {
+      delete p;
+    }
+  }
+
+  usize group_count(program const &p)
+  {
+    return static_cast<usize>(p.regex.NumberOfCapturingGroups());
+  }
+
+  static RE2::Anchor to_re2(anchor const a)
+  {
+    switch(a)
+    {
+      case anchor::none:
+        return RE2::UNANCHORED;
+      case anchor::start:
+        return RE2::ANCHOR_START;
+      case anchor::both:
+        return RE2::ANCHOR_BOTH;
+    }
+    return RE2::UNANCHORED;
+  }
+
+  bool search(program const &p,
+              jtl::immutable_string const &input,
+              usize const start,
+              anchor const a,
+              native_vector<span> &groups)
+  {
+    static thread_local std::vector<re2::StringPiece> submatches;
+
+    auto const size{ group_count(p) + 1 };
+    submatches.resize(size);
+
+    /* We give RE2 the whole input, rather than just what's after start, so it has the
+     * context for things like ^ and \b. */
+    re2::StringPiece const text{ input.data(), input.size() };
+    if(!p.regex.Match(text,
+                      start,
+                      input.size(),
+                      to_re2(a),
+                      submatches.data(),
+                      static_cast<int>(size)))
+    {
+      return false;
+    }
+
+    groups.resize(size);
+    for(usize i{}; i < size; ++i)
+    {
+      auto const &m(submatches[i]);
+      if(m.data() == nullptr)
+      {
+        groups[i] = {};
+        continue;
+      }
+      groups[i] = { static_cast<usize>(m.data() - input.data()), m.size(), true };
+    }
+    return true;
+  }
+}
@@ -0,0 +1,92 @@
+#include <regex>
+
+#include <jank/runtime/regex.hpp>
+
+/* The fallback engine, for when jank isn't built with a faster one. Patterns use the
+ * ECMAScript grammar. */
+namespace jank::runtime::regex
+{
+  struct program
+  {
+    std::regex regex;
+  };
+
+  jtl::immutable_string_view backend_name()
+  {
+    return "std::regex";
+  }
+
+  namespace detail
+  {
+    jtl::result<program const *, jtl::immutable_string>
+    compile_program(jtl::immutable_string const &pattern)
+    {
+      try
+      {
+        /* Programs are interned, so it's worth spending more time compiling for faster
+         * matching. */
+        return ok(new program{ std::regex{ pattern.data(),
+                                           pattern.size(),
+                                           std::regex_constants::ECMAScript
+                                             | std::regex_constants::optimize } });
+      }
+      catch(std::regex_error const &e)
+      {
+        return err(jtl::immutable_string{ e.what() });
+      }
+    }
+
+    void destroy_program(program const * const p)
+    {
+      delete p;
+    }
+  }
+
+  usize group_count(program const &p)
+  {
+    return p.regex.mark_count();
+  }
+
+  bool search(program const &p,
+              jtl::immutable_string const &input,
+              usize const start,
+              anchor const a,
+              native_vector<span> &groups)
+  {
+    /* The match results allocate, so we keep one around per thread. */
+    static thread_local std::cmatch match;
+
+    auto const begin{ input.data() };
+    auto const end{ input.data() + input.size() };
+    auto flags{ start == 0 ? std::regex_constants::match_default
+                           : std::regex_constants::match_prev_avail };
+
+    bool found{};
+    if(a == anchor::both)
+    {
+      found = std::regex_match(begin + start, end, match, p.regex, flags);
+    }
+    else
+    {
+      if(a == anchor::start)
+      {
+        flags |= std::regex_constants::match_continuous;
+      }
+      found = std::regex_search(begin + start, end, match, p.regex, flags);
+    }
+
+    if(!found)
+    {
+      return false;
+    }
+
+    groups.resize(match.size());
+    for(usize i{}; i < match.size(); ++i)
+    {
+      auto const &m(match[i]);
+      groups[i]
+        = { static_cast<usize>(m.first - begin), static_cast<usize>(m.length()), m.matched };
+    }
+    return true;
+  }
+}
@@ -0,0 +1,186 @@
+#include <array>
+#include <atomic>
+#include <mutex>
+
+#include <jank/runtime/tap.hpp>
+#include <jank/runtime/core.hpp>
+#include <jank/runtime/executor.hpp>
+#include <jank/runtime/metrics.hpp>
+#include <jank/runtime/behavior/callable.hpp>
+#include <jank/runtime/obj/persistent_hash_set.hpp>
+
+namespace jank::runtime
+{
+  static_assert((tap_queue_capacity & (tap_queue_capacity - 1)) == 0,
+                "The tap queue's capacity must be a power of two.");
+
+  /* Each cell's sequence says whose turn it is. A producer may fill the cell once the
+   * sequence matches its position, and the consumer may empty it once it's one past. The
+   * consumer then moves it a whole lap ahead, for the next producer to come around. */
+  struct tap_cell
+  {
+    std::atomic<usize> sequence;
+    object *value{};
+  };
+
+  struct tap_queue
+  {
+    tap_queue()
+    {
+      for(usize i{}; i < cells.size(); ++i)
+      {
+        cells[i].sequence.store(i, std::memory_order_relaxed);
+      }
+    }
+
+    std::array<tap_cell, tap_queue_capacity> cells;
+    /* Producers and the consumer are on their own cache lines, so offers don't contend
+     * with the drain. */
+    alignas(64) std::atomic<usize> enqueue_pos{};
+    alignas(64) usize dequeue_pos{};
+    alignas(64) std::atomic_bool is_draining{};
+  };
+
+  /* This is a static, so the GC sees the values sitting in the buffer. */
+  static tap_queue queue;
+
+  static std::mutex taps_mutex;
+  /* A set, once the first tap is added. */
+  static object_ref taps;
+
+  static metrics::counter &dropped_taps()
+  {
+    static auto &c{ *metrics::find_or_create_counter("jank_tap_dropped_total",
+                                                     "The values given to tap> which were "
+                                                     "dropped, since the tap queue was full.")
+                       .expect_ok() };
+    return c;
+  }
+
+  static bool try_enqueue(object_ref const o)
+  {
+    auto pos{ queue.enqueue_pos.load(std::memory_order_relaxed) };
+    while(true)
+    {
+      auto &cell{ queue.cells[pos & (tap_queue_capacity - 1)] };
+      auto const sequence{ cell.sequence.load(std::memory_order_acquire) };
+      auto const diff{ static_cast<i64>(sequence) - static_cast<i64>(pos) };
+      if(diff == 0)
+      {
+        if(queue.enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        {
+          cell.value = o.data;
+          cell.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      }
+      else if(diff < 0)
+      {
+        return false;
+      }
+      else
+      {
+        pos = queue.enqueue_pos.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  static object *try_dequeue()
+  {
+    auto &cell{ queue.cells[queue.dequeue_pos & (tap_queue_capacity - 1)] };
+    auto const sequence{ cell.sequence.load(std::memory_order_acquire) };
+    if(sequence != queue.dequeue_pos + 1)
+    {
+      return nullptr;
+    }
+
+    auto * const ret{ cell.value };
+    cell.value = nullptr;
+    cell.sequence.store(queue.dequeue_pos + tap_queue_capacity, std::memory_order_release);
+    ++queue.dequeue_pos;
+    return ret;
+  }
+
+  static bool is_queue_empty()
+  {
+    auto const &cell{ queue.cells[queue.dequeue_pos & (tap_queue_capacity - 1)] };
+    return cell.sequence.load(std::memory_order_acquire) != queue.dequeue_pos + 1;
+  }
+
+  static void call_taps(object_ref const o)
+  {
+    object_ref current_taps;
+    {
+      std::lock_guard<std::mutex> const lock{ taps_mutex };
+      current_taps = taps;
+    }
+
+    for(auto it(fresh_seq(current_taps)); !it.is_nil(); it = next_in_place(it))
+    {
+      try
+      {
+        dynamic_call(first(it), o);
+      }
+      catch(...)
+      {
+      }
+    }
+  }
+
+  static void drain();
+
+  static void ensure_draining()
+  {
+    if(!queue.is_draining.load(std::memory_order_relaxed)
+       && !queue.is_draining.exchange(true, std::memory_order_acq_rel))
+    {
+      solo_executor().submit(drain);
+    }
+  }
+
+  static void drain()
+  {
+    while(true)
+    {
+      while(auto * const o = try_dequeue())
+      {
+        call_taps(o);
+      }
+
+      /* An offer which came in after the last dequeue, but saw this drain still running,
+       * won't have started another, so it's picked up here. */
+      queue.is_draining.store(false, std::memory_order_release);
+      if(is_queue_empty() || queue.is_draining.exchange(true, std::memory_order_acq_rel))
+      {
+        return;
+      }
+    }
+  }
+
+  bool tap_offer(object_ref const o)
+  {
+    if(!try_enqueue(o))
+    {
+      dropped_taps().add(1);
+      return false;
+    }
+    ensure_draining();
+    return true;
+  }
+
+  void add_tap(object_ref const f)
+  {
+    std::lock_guard<std::mutex> const lock{ taps_mutex };
+    if(taps.is_nil())
+    {
+      taps = obj::persistent_hash_set::empty();
+    }
+    taps = conj(taps, f);
+  }
+
+  void remove_tap(object_ref const f)
+  {
+    std::lock_guard<std::mutex> const lock{ taps_mutex };
+    taps = disj(taps, f);
+  }
+}
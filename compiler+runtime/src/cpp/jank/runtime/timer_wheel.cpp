@@ -0,0 +1,311 @@
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+#include <jank/runtime/timer_wheel.hpp>
+#include <jank/runtime/executor.hpp>
+
+namespace jank::runtime
+{
+  static constexpr u64 slot_mask{ timer_wheel::slot_count - 1 };
+  /* The furthest a deadline can be from now and still have its own slot. */
+  static constexpr u64 max_delta{
+    (u64{ 1 } << (timer_wheel::slot_bits * timer_wheel::level_count)) - 1
+  };
+  static constexpr u64 never{ std::numeric_limits<u64>::max() };
+
+  static usize slot_index(u64 const tick, usize const level_index)
+  {
+    return (tick >> (timer_wheel::slot_bits * level_index)) & slot_mask;
+  }
+
+  timer_wheel::timer_wheel()
+    : epoch{ clock::now() }
+  {
+  }
+
+  timer_wheel::~timer_wheel()
+  {
+    {
+      std::lock_guard<std::mutex> const lock{ mutex };
+      stopping = true;
+    }
+    wake.notify_all();
+    if(thread.joinable())
+    {
+      thread.join();
+    }
+  }
+
+  u64 timer_wheel::now_tick() const
+  {
+    return static_cast<u64>(
+      std::chrono::duration_cast<std::chrono::milliseconds>(clock::now() - epoch).count());
+  }
+
+  void timer_wheel::insert(timer * const t)
+  {
+    /* Anything already due goes into the slot for the current tick, which is next to
+     * be expired. */
+    auto const deadline{ std::max(t->deadline, current_tick) };
+    auto const delta{ deadline - current_tick };
+
+    usize level_index{};
+    while(level_index + 1 < level_count
+          && (u64{ 1 } << (slot_bits * (level_index + 1))) <= delta)
+    {
+      ++level_index;
+    }
+    /* Past the end of the wheel, timers wait in the last slot they can reach and are put
+     * back each time it cascades, until they're close enough. */
+    auto const slot_tick{ delta <= max_delta ? deadline : current_tick + max_delta };
+    auto const slot{ slot_index(slot_tick, level_index) };
+
+    auto &l{ levels[level_index] };
+    t->level = static_cast<u8>(level_index);
+    t->slot = static_cast<u8>(slot);
+    t->prev = nullptr;
+    t->next = l.heads[slot];
+    if(t->next)
+    {
+      t->next->prev = t;
+    }
+    l.heads[slot] = t;
+    l.occupied[slot / 64] |= u64{ 1 } << (slot % 64);
+    ++l.count;
+    ++count;
+    t->is_pending = true;
+  }
+
+  void timer_wheel::unlink(timer * const t)
+  {
+    auto &l{ levels[t->level] };
+    if(t->prev)
+    {
+      t->prev->next = t->next;
+    }
+    else
+    {
+      l.heads[t->slot] = t->next;
+      if(!t->next)
+      {
+        l.occupied[t->slot / 64] &= ~(u64{ 1 } << (t->slot % 64));
+      }
+    }
+    if(t->next)
+    {
+      t->next->prev = t->prev;
+    }
+    t->prev = t->next = nullptr;
+    --l.count;
+    --count;
+    t->is_pending = false;
+  }
+
+  timer_wheel::timer *timer_wheel::take_slot(level &l, usize const slot)
+  {
+    auto * const head{ l.heads[slot] };
+    l.heads[slot] = nullptr;
+    l.occupied[slot / 64] &= ~(u64{ 1 } << (slot % 64));
+    return head;
+  }
+
+  void timer_wheel::cascade(usize const level_index, u64 const tick)
+  {
+    auto &l{ levels[level_index] };
+    auto *t{ take_slot(l, slot_index(tick, level_index)) };
+    while(t)
+    {
+      auto * const next{ t->next };
+      --l.count;
+      --count;
+      insert(t);
+      t = next;
+    }
+  }
+
+  void timer_wheel::expire(u64 const tick, native_vector<timer *> &due)
+  {
+    /* At the start of each slot of a level, the timers in the matching slot of the level
+     * above are moved down. The level above that only needs to cascade once the whole
+     * level wraps around. */
+    if(slot_index(tick, 0) == 0)
+    {
+      for(usize i{ 1 }; i < level_count; ++i)
+      {
+        cascade(i, tick);
+        if(slot_index(tick, i) != 0)
+        {
+          break;
+        }
+      }
+    }
+
+    auto &l{ levels[0] };
+    auto *t{ take_slot(l, slot_index(tick, 0)) };
+    current_tick = tick + 1;
+    while(t)
+    {
+      auto * const next{ t->next };
+      --l.count;
+      --count;
+      t->prev = t->next = nullptr;
+      t->is_pending = false;
+      due.emplace_back(t);
+
+      /* Periodic timers go back in before they run, so that cancelling one while it's
+       * running stops it from running again. */
+      if(t->period != 0)
+      {
+        t->deadline += t->period;
+        insert(t);
+      }
+      t = next;
+    }
+  }
+
+  jtl::option<u64> timer_wheel::next_event_tick() const
+  {
+    if(count == 0)
+    {
+      return none;
+    }
+
+    auto ret{ never };
+    auto const &l{ levels[0] };
+    if(l.count != 0)
+    {
+      /* The first level only holds timers for the next slot_count ticks, so its slots are
+       * searched in order from the current one, wrapping around once. */
+      auto const start{ slot_index(current_tick, 0) };
+      for(usize i{}; i <= l.occupied.size(); ++i)
+      {
+        auto const word_index{ (start / 64 + i) % l.occupied.size() };
+        auto word{ l.occupied[word_index] };
+        if(i == 0)
+        {
+          word &= ~u64{} << (start % 64);
+        }
+        else if(i == l.occupied.size())
+        {
+          word &= (u64{ 1 } << (start % 64)) - 1;
+        }
+        if(word != 0)
+        {
+          auto const slot{ word_index * 64 + static_cast<usize>(std::countr_zero(word)) };
+          ret = current_tick + ((slot - start) & slot_mask);
+          break;
+        }
+      }
+    }
+
+    if(l.count != count)
+    {
+      auto const boundary{ (current_tick + slot_mask) & ~slot_mask };
+      ret = std::min(ret, boundary);
+    }
+    return ret;
+  }
+
+  timer_wheel::timer *timer_wheel::schedule(std::chrono::milliseconds const delay,
+                                            std::chrono::milliseconds const period,
+                                            task &&t)
+  {
+    auto * const ret{ new(GC) timer{} };
+    ret->period = static_cast<u64>(std::max<i64>(period.count(), 0));
+    ret->fn = std::move(t);
+
+    bool needs_wake{};
+    {
+      std::lock_guard<std::mutex> const lock{ mutex };
+      auto const now{ now_tick() };
+      /* With nothing pending, the wheel doesn't keep up with the clock, so it's caught
+       * up here. Timers then don't start out further up the wheel than they need to. */
+      if(count == 0)
+      {
+        current_tick = std::max(current_tick, now);
+      }
+      ret->deadline = now + static_cast<u64>(std::max<i64>(delay.count(), 0));
+      insert(ret);
+
+      if(!thread.joinable())
+      {
+        wake_tick = never;
+        thread = std::thread{ [this] { run(); } };
+      }
+      needs_wake = ret->deadline < wake_tick;
+    }
+    if(needs_wake)
+    {
+      wake.notify_one();
+    }
+    return ret;
+  }
+
+  bool timer_wheel::cancel(timer * const t)
+  {
+    std::lock_guard<std::mutex> const lock{ mutex };
+    if(!t->is_pending)
+    {
+      return false;
+    }
+    unlink(t);
+    return true;
+  }
+
+  usize timer_wheel::pending_count()
+  {
+    std::lock_guard<std::mutex> const lock{ mutex };
+    return count;
+  }
+
+  void timer_wheel::run()
+  {
+    gc_thread_scope const scope;
+    native_vector<timer *> due;
+    std::unique_lock<std::mutex> lock{ mutex };
+    while(!stopping)
+    {
+      auto const now{ now_tick() };
+      auto next{ next_event_tick() };
+      while(next.is_some() && next.unwrap() <= now)
+      {
+        /* The ticks in between have nothing in them, so they're skipped. */
+        expire(next.unwrap(), due);
+        next = next_event_tick();
+      }
+
+      if(!due.empty())
+      {
+        lock.unlock();
+        for(auto * const t : due)
+        {
+          t->fn();
+        }
+        due.clear();
+        lock.lock();
+        continue;
+      }
+
+      if(next.is_none())
+      {
+        wake_tick = never;
+        wake.wait(lock);
+      }
+      else
+      {
+        wake_tick = next.unwrap();
+        wake.wait_until(lock, epoch + std::chrono::milliseconds{ wake_tick });
+      }
+      wake_tick = 0;
+    }
+  }
+
+  timer_wheel &scheduler()
+  {
+    /* This is intentionally leaked, as the executors are. It's in GC memory, since the
+     * timers are only referenced from it. */
+    static auto * const wheel{ new(GC) timer_wheel{} };
+    return *wheel;
+  }
+}
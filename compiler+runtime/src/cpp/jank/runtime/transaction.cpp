@@ -0,0 +1,244 @@
+#include <chrono>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <jank/runtime/transaction.hpp>
+#include <jank/runtime/obj/ref.hpp>
+#include <jank/runtime/obj/cons.hpp>
+#include <jank/runtime/behavior/callable.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/util/fmt.hpp>
+
+namespace jank::runtime
+{
+  /* The same as Clojure's. */
+  static constexpr usize retry_limit{ 10'000 };
+
+  /* Every commit takes the next point. Transactions read as of the point they started at. */
+  static std::atomic<u64> clock{};
+
+  /* Thrown to unwind a transaction which needs to start over. This isn't an object, so
+   * catch forms in jank won't get in the way. */
+  struct retry_transaction
+  {
+  };
+
+  struct transaction
+  {
+    struct entry
+    {
+      /* The in transaction value, once the ref has been set, altered, or commuted. */
+      jtl::option<object_ref> val;
+      bool is_set{};
+      bool is_ensured{};
+      native_vector<std::pair<object_ref, object_ref>> commutes;
+    };
+
+    object_ref read(obj::ref * const r);
+    bool commit();
+
+    u64 read_point{};
+    /* Ordered by address, which gives us our lock order for commits. */
+    native_map<obj::ref *, entry> touched;
+  };
+
+  static thread_local transaction *current_transaction{};
+
+  static transaction &current_or_throw()
+  {
+    if(!current_transaction)
+    {
+      throw make_box("No transaction running").erase();
+    }
+    return *current_transaction;
+  }
+
+  object_ref transaction::read(obj::ref * const r)
+  {
+    auto const found(touched.find(r));
+    if(found != touched.end() && found->second.val.is_some())
+    {
+      return found->second.val.unwrap();
+    }
+
+    std::shared_lock<std::shared_mutex> const lock{ r->lock };
+    for(auto const &v : r->history)
+    {
+      if(v.point <= read_point)
+      {
+        return v.val;
+      }
+    }
+
+    ++r->faults;
+    throw retry_transaction{};
+  }
+
+  bool transaction::commit()
+  {
+    struct notice
+    {
+      obj::ref *r{};
+      object_ref old_val;
+      object_ref new_val;
+    };
+
+    /* The locks are released when these go out of scope, including if a commute throws. */
+    std::vector<std::unique_lock<std::shared_mutex>> locks;
+    for(auto &[r, e] : touched)
+    {
+      if(!e.is_set && !e.is_ensured && e.commutes.empty())
+      {
+        continue;
+      }
+
+      locks.emplace_back(r->lock);
+      if((e.is_set || e.is_ensured) && read_point < r->history.front().point)
+      {
+        return false;
+      }
+    }
+
+    for(auto &[r, e] : touched)
+    {
+      if(e.is_set || e.commutes.empty())
+      {
+        continue;
+      }
+
+      auto val{ r->history.front().val };
+      for(auto const &[f, args] : e.commutes)
+      {
+        val = apply_to(f, val, args);
+      }
+      e.val = val;
+    }
+
+    auto const point{ clock.fetch_add(1) + 1 };
+    native_vector<notice> notices;
+    for(auto &[r, e] : touched)
+    {
+      if(e.val.is_none())
+      {
+        continue;
+      }
+
+      auto const old_val{ r->history.front().val };
+      r->push_version(e.val.unwrap(), point);
+      notices.push_back({ r, old_val, e.val.unwrap() });
+    }
+    locks.clear();
+
+    for(auto const &n : notices)
+    {
+      auto const locked_watches(n.r->watches.rlock());
+      for(auto const &watch : (*locked_watches)->data)
+      {
+        dynamic_call(watch.second, watch.first, n.r, n.old_val, n.new_val);
+      }
+    }
+    return true;
+  }
+
+  static void back_off(usize const attempt)
+  {
+    if(attempt < 4)
+    {
+      std::this_thread::yield();
+      return;
+    }
+
+    static thread_local std::minstd_rand rng{ std::random_device{}() };
+    auto const cap{ usize{ 1 } << std::min<usize>(attempt, 14) };
+    std::this_thread::sleep_for(
+      std::chrono::microseconds{ std::uniform_int_distribution<usize>{ 0, cap }(rng) });
+  }
+
+  object_ref run_in_transaction(object_ref const fn)
+  {
+    if(current_transaction)
+    {
+      return dynamic_call(fn);
+    }
+
+    transaction tx;
+    current_transaction = &tx;
+    struct scope_exit
+    {
+      ~scope_exit()
+      {
+        current_transaction = nullptr;
+      }
+    } const exit;
+
+    for(usize attempt{}; attempt < retry_limit; ++attempt)
+    {
+      tx.touched.clear();
+      tx.read_point = clock.load();
+      try
+      {
+        auto const ret{ dynamic_call(fn) };
+        if(tx.commit())
+        {
+          return ret;
+        }
+      }
+      catch(retry_transaction const &)
+      {
+      }
+      back_off(attempt);
+    }
+
+    throw make_box("Transaction failed after reaching retry limit").erase();
+  }
+
+  bool is_in_transaction()
+  {
+    return current_transaction != nullptr;
+  }
+
+  namespace detail
+  {
+    object_ref transaction_read(obj::ref_ref const r)
+    {
+      return current_or_throw().read(r.data);
+    }
+
+    object_ref transaction_set(obj::ref_ref const r, object_ref const val)
+    {
+      auto &e{ current_or_throw().touched[r.data] };
+      if(!e.commutes.empty())
+      {
+        throw make_box("Can't set after commute").erase();
+      }
+      e.val = val;
+      e.is_set = true;
+      return val;
+    }
+
+    object_ref transaction_commute(obj::ref_ref const r, object_ref const f, object_ref const args)
+    {
+      auto &tx{ current_or_throw() };
+      auto const val{ apply_to(f, tx.read(r.data), args) };
+      auto &e{ tx.touched[r.data] };
+      e.val = val;
+      /* Once a ref has been set, it's already in conflict, so a commute on it is just
+       * an alter. */
+      if(!e.is_set)
+      {
+        e.commutes.emplace_back(f, args);
+      }
+      return val;
+    }
+
+    object_ref transaction_ensure(obj::ref_ref const r)
+    {
+      auto &tx{ current_or_throw() };
+      auto const val{ tx.read(r.data) };
+      tx.touched[r.data].is_ensured = true;
+      return val;
+    }
+  }
+}
@@ -1,3 +1,7 @@
+#include <array>
+#include <cstddef>
+#include <mutex>
+
 #include <jank/runtime/var.hpp>
 #include <jank/runtime/ns.hpp>
 #include <jank/runtime/behavior/metadatable.hpp>
@@ -10,20 +14,21 @@
 #include <jank/runtime/obj/persistent_hash_map.hpp>
 #include <jank/profile/time.hpp>
 #include <jank/util/fmt.hpp>
+#include <jank/util/scope_exit.hpp>
 
 namespace jank::runtime
 {
   var::var(ns_ref const n, obj::symbol_ref const name)
     : n{ n }
     , name{ name }
-    , root{ make_box<var_unbound_root>(this) }
+    , root{ make_box<var_unbound_root>(this).erase().data }
   {
   }
 
   var::var(ns_ref const n, obj::symbol_ref const name, object_ref const root)
     : n{ n }
     , name{ name }
-    , root{ root }
+    , root{ root.data }
   {
   }
 
@@ -34,7 +39,7 @@ namespace jank::runtime
            bool const thread_bound)
     : n{ n }
     , name{ name }
-    , root{ root }
+    , root{ root.data }
     , dynamic{ dynamic }
     , thread_bound{ thread_bound }
   {
@@ -77,6 +82,11 @@ namespace jank::runtime
     return to_string();
   }
 
+  void var::to_code_string(jtl::string_builder &buff) const
+  {
+    to_string(buff);
+  }
+
   uhash var::to_hash() const
   {
     if(hash)
@@ -100,22 +110,81 @@ namespace jank::runtime
 
   object_ref var::get_root() const
   {
-    profile::timer const timer{ "var get_root" };
-    return *root.rlock();
+    auto const r(root.load(std::memory_order_acquire));
+    if(!r) [[unlikely]]
+    {
+      return initialize_lazy_root();
+    }
+    return r;
+  }
+
+  u64 var::get_root_version() const
+  {
+    return root_version.load(std::memory_order_acquire);
+  }
+
+  usize var::root_version_offset()
+  {
+    static_assert(sizeof(std::atomic<u64>) == sizeof(u64));
+    return offsetof(var, root_version) - offsetof(var, base);
   }
 
   var_ref var::bind_root(object_ref const r)
   {
     profile::timer const timer{ "var bind_root" };
-    *root.wlock() = r;
+    std::lock_guard<std::mutex> const lock{ root_mutex };
+    root.store(r.data, std::memory_order_release);
+    root_version.fetch_add(1, std::memory_order_release);
     return this;
   }
 
+  /* All lazy roots share one lock, since the initializer of one may need to read another,
+   * on any thread. Each root is only initialized once, so it's not contended for long. */
+  static std::recursive_mutex &lazy_root_mutex()
+  {
+    static std::recursive_mutex mutex;
+    return mutex;
+  }
+
+  var_ref var::bind_lazy_root(object *(*init)())
+  {
+    std::lock_guard<std::recursive_mutex> const lazy_lock{ lazy_root_mutex() };
+    std::lock_guard<std::mutex> const lock{ root_mutex };
+    lazy_init = init;
+    root.store(nullptr, std::memory_order_release);
+    root_version.fetch_add(1, std::memory_order_release);
+    return this;
+  }
+
+  object_ref var::initialize_lazy_root() const
+  {
+    std::lock_guard<std::recursive_mutex> const lock{ lazy_root_mutex() };
+    if(auto const r = root.load(std::memory_order_acquire))
+    {
+      return r;
+    }
+    if(lazy_initializing)
+    {
+      throw std::runtime_error{ util::format("{} needs its own value to be initialized.",
+                                             to_string()) };
+    }
+
+    lazy_initializing = true;
+    util::scope_exit const finally{ [this] { lazy_initializing = false; } };
+    object_ref const value{ lazy_init() };
+    const_cast<var *>(this)->bind_root(value);
+    return value;
+  }
+
   object_ref var::alter_root(object_ref const f, object_ref const args)
   {
-    auto locked_root(root.wlock());
-    *locked_root = apply_to(f, cons(*locked_root, args));
-    return *locked_root;
+    /* A lazy root must be initialized before we lock, since initializing binds it. */
+    get_root();
+    std::lock_guard<std::mutex> const lock{ root_mutex };
+    object_ref const ret{ apply_to(f, root.load(std::memory_order_acquire), args) };
+    root.store(ret.data, std::memory_order_release);
+    root_version.fetch_add(1, std::memory_order_release);
+    return ret;
   }
 
   jtl::string_result<void> var::set(object_ref const r) const
@@ -148,9 +217,25 @@ namespace jank::runtime
     return make_box<runtime::obj::symbol>(n->name->name, name->name);
   }
 
+  /* A small, direct mapped cache of this thread's binding lookups. Each entry is only good
+   * for the frame version it was filled against, so pushing or popping a frame invalidates
+   * all of them at once. A binding's value may still change in place, through var::set, but
+   * the binding object itself stays the same for the life of the frame. We don't need to
+   * root the cached bindings, since the current frame already holds onto them. */
+  struct thread_binding_cache_entry
+  {
+    var const *var{};
+    u64 frame_version{};
+    var_thread_binding_ref binding;
+  };
+
+  static constexpr usize thread_binding_cache_size{ 32 };
+  static thread_local std::array<thread_binding_cache_entry, thread_binding_cache_size>
+    thread_binding_cache{};
+
   var_thread_binding_ref var::get_thread_binding() const
   {
-    if(!thread_bound.load())
+    if(!thread_bound.load(std::memory_order_relaxed))
     {
       return {};
     }
@@ -161,14 +246,26 @@ namespace jank::runtime
       return {};
     }
 
-    auto const found(tbfs.front().bindings->get_entry(this));
-    if(found.is_nil())
+    /* Vars are at least 16 byte aligned, so the low bits of the address carry nothing. */
+    auto const version{ runtime::context::thread_binding_frame_version };
+    auto &cached(
+      thread_binding_cache[(reinterpret_cast<uintptr_t>(this) >> 4) % thread_binding_cache_size]);
+    if(cached.var == this && cached.frame_version == version)
     {
-      return {};
+      return cached.binding;
     }
 
-    auto const ret(expect_object<obj::persistent_vector>(found)->data[1]);
-    return expect_object<var_thread_binding>(ret);
+    /* Looking in the map directly, rather than through get_entry, means we don't need to
+     * allocate an entry vector just to read the value back out of it. */
+    auto const found(tbfs.front().bindings->data.find(const_cast<var *>(this)));
+    var_thread_binding_ref ret;
+    if(found)
+    {
+      ret = expect_object<var_thread_binding>(*found);
+    }
+
+    cached = { this, version, ret };
+    return ret;
   }
 
   object_ref var::deref() const
@@ -178,7 +275,7 @@ namespace jank::runtime
     {
       return binding->value;
     }
-    return *root.rlock();
+    return get_root();
   }
 
   var_ref var::clone() const
@@ -207,6 +304,11 @@ namespace jank::runtime
     return var_thread_binding::to_string();
   }
 
+  void var_thread_binding::to_code_string(jtl::string_builder &buff) const
+  {
+    to_string(buff);
+  }
+
   void var_thread_binding::to_string(jtl::string_builder &buff) const
   {
     runtime::to_string(value, buff);
@@ -244,6 +346,11 @@ namespace jank::runtime
     return var_unbound_root::to_string();
   }
 
+  void var_unbound_root::to_code_string(jtl::string_builder &buff) const
+  {
+    to_string(buff);
+  }
+
   uhash var_unbound_root::to_hash() const
   {
     return static_cast<uhash>(reinterpret_cast<uintptr_t>(this));
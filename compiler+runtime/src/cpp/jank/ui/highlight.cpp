@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include <ftxui/dom/elements.hpp>
 
 #include <jank/ui/highlight.hpp>
@@ -163,4 +165,243 @@ namespace jank::ui
 
     return lines;
   }
+
+  /* The lexer looks at most a couple of codepoints past the end of a token, so a state is
+   * only trusted when the first change is further along than this. */
+  static constexpr usize max_lookahead{ 8 };
+
+  static usize count_lines(std::string_view const code)
+  {
+    return static_cast<usize>(std::ranges::count(code, '\n')) + 1;
+  }
+
+  void incremental_highlighter::update(jtl::immutable_string_view const &new_code_view)
+  {
+    std::string_view const new_code{ new_code_view.data(), new_code_view.size() };
+    relexed_lines = 0;
+    if(!lines.empty() && new_code == code)
+    {
+      return;
+    }
+
+    /* The edit is whatever lies between the prefix and the suffix the old and new code
+     * have in common. */
+    auto const min_size{ std::min(code.size(), new_code.size()) };
+    usize prefix{};
+    while(prefix < min_size && code[prefix] == new_code[prefix])
+    {
+      ++prefix;
+    }
+    usize suffix{};
+    while(suffix < min_size - prefix
+          && code[code.size() - 1 - suffix] == new_code[new_code.size() - 1 - suffix])
+    {
+      ++suffix;
+    }
+    auto const new_suffix_start{ new_code.size() - suffix };
+    auto const delta{ static_cast<i64>(new_code.size()) - static_cast<i64>(code.size()) };
+    auto const line_delta{ static_cast<i64>(count_lines(new_code))
+                           - static_cast<i64>(lines.empty() ? 1 : lines.size()) };
+
+    /* Lexing starts again from the last line, up to the first change, whose checkpoint
+     * doesn't depend on anything which changed. The very start always works. */
+    usize restart{};
+    if(!lines.empty())
+    {
+      auto const changed{ std::ranges::upper_bound(lines, prefix, {}, &line::offset) };
+      restart = static_cast<usize>(changed - lines.begin()) - 1;
+      while(restart != 0 && prefix < lines[restart].checkpoint.pos.offset + max_lookahead)
+      {
+        --restart;
+      }
+    }
+    auto const checkpoint{ restart == 0 ? read::lex::processor::state{}
+                                        : lines[restart].checkpoint };
+
+    auto old_lines{ std::move(lines) };
+    lines.clear();
+    for(usize i{}; i < restart; ++i)
+    {
+      lines.emplace_back(std::move(old_lines[i]));
+    }
+    /* Tokens from the checkpoint on are lexed again, including the parts of them on lines
+     * before the restart. */
+    for(auto i{ lines.size() }; i-- > 0;)
+    {
+      auto &l{ lines[i] };
+      std::erase_if(l.segments, [&](segment const &s) {
+        return checkpoint.pos.offset <= l.offset + s.start;
+      });
+      l.element = nullptr;
+      if(l.offset <= checkpoint.pos.offset)
+      {
+        break;
+      }
+    }
+    code = new_code;
+
+    auto const line_end([&](usize const index) {
+      if(index + 1 < lines.size())
+      {
+        return lines[index + 1].offset - 1;
+      }
+      auto const newline{ code.find('\n', lines[index].offset) };
+      return newline == std::string::npos ? code.size() : newline;
+    });
+
+    /* The next line which needs a checkpoint, if there are any left. */
+    jtl::option<usize> next_line_offset{ restart == 0 ? 0 : old_lines[restart].offset };
+    jtl::option<usize> converged_at;
+    usize converged_offset{};
+    read::lex::processor l_prc{ new_code_view, checkpoint };
+    while(true)
+    {
+      auto const before{ l_prc.save() };
+      auto const result{ l_prc.next() };
+      auto const is_eof{ result.is_ok()
+                         && result.expect_ok().kind == read::lex::token_kind::eof };
+      if(converged_at.is_some()
+         && (is_eof || (result.is_ok() && converged_offset <= result.expect_ok().start.offset)))
+      {
+        break;
+      }
+
+      /* Every line which starts before the end of this token gets the state from before
+       * it, unless we've found that the rest of the lines are the same as they were. */
+      while(converged_at.is_none() && next_line_offset.is_some()
+            && (is_eof || next_line_offset.unwrap() < l_prc.pos.offset))
+      {
+        auto const offset{ next_line_offset.unwrap() };
+        auto const old_index{ static_cast<i64>(lines.size()) - line_delta };
+        /* From a state in the unchanged suffix, the lexer gives the same tokens it gave
+         * before, so the rest of the lines are too. */
+        if(new_suffix_start <= before.pos.offset && static_cast<i64>(restart) <= old_index
+           && static_cast<usize>(old_index) < old_lines.size())
+        {
+          auto const &old{ old_lines[static_cast<usize>(old_index)] };
+          auto shifted{ before };
+          shifted.pos.offset = static_cast<usize>(static_cast<i64>(shifted.pos.offset) - delta);
+          shifted.pos.line = static_cast<usize>(static_cast<i64>(shifted.pos.line) - line_delta);
+          if(old.checkpoint == shifted
+             && static_cast<i64>(old.offset) + delta == static_cast<i64>(offset))
+          {
+            converged_at = lines.size();
+            converged_offset = offset;
+            break;
+          }
+        }
+
+        lines.push_back({ offset, before, {}, nullptr });
+        auto const newline{ code.find('\n', offset) };
+        next_line_offset = newline == std::string::npos ? jtl::option<usize>{} : newline + 1;
+      }
+
+      if(is_eof)
+      {
+        break;
+      }
+      if(result.is_err())
+      {
+        /* Anything which doesn't lex is shown without any color. */
+        continue;
+      }
+
+      auto const &token(result.expect_ok());
+      auto const start{ token.start.offset };
+      auto const end{ start + std::max(token.end.offset - token.start.offset, 1llu) };
+      auto const token_decorator{ token_color(token) };
+      auto index{ lines.size() - 1 };
+      while(index != 0 && start < lines[index].offset)
+      {
+        --index;
+      }
+      auto const last_index{ converged_at.is_some() ? converged_at.unwrap() : lines.size() };
+      for(; index < last_index && lines[index].offset < end; ++index)
+      {
+        auto &l{ lines[index] };
+        auto const piece_start{ std::max(start, l.offset) };
+        auto const piece_end{ std::min(end, line_end(index)) };
+        if(piece_start < piece_end)
+        {
+          l.segments.push_back(
+            { piece_start - l.offset, piece_end - l.offset, token_decorator });
+          l.element = nullptr;
+        }
+      }
+    }
+
+    if(converged_at.is_none())
+    {
+      relexed_lines = lines.size() - restart;
+      return;
+    }
+
+    relexed_lines = converged_at.unwrap() - restart;
+    for(auto i{ static_cast<usize>(static_cast<i64>(converged_at.unwrap()) - line_delta) };
+        i < old_lines.size();
+        ++i)
+    {
+      auto &l{ old_lines[i] };
+      l.offset = static_cast<usize>(static_cast<i64>(l.offset) + delta);
+      l.checkpoint.pos.offset
+        = static_cast<usize>(static_cast<i64>(l.checkpoint.pos.offset) + delta);
+      l.checkpoint.pos.line
+        = static_cast<usize>(static_cast<i64>(l.checkpoint.pos.line) + line_delta);
+      lines.emplace_back(std::move(l));
+    }
+  }
+
+  Element incremental_highlighter::render(usize const index)
+  {
+    static auto const config{ FlexboxConfig().SetGap(0, 0) };
+    auto &l{ lines[index] };
+    if(l.element)
+    {
+      return l.element;
+    }
+
+    auto const end{ index + 1 < lines.size() ? lines[index + 1].offset - 1 : code.size() };
+    std::string_view const text_view{ code.data() + l.offset, end - l.offset };
+    std::vector<Element> parts;
+    usize pos{};
+    for(auto const &s : l.segments)
+    {
+      if(pos < s.start)
+      {
+        parts.emplace_back(text(std::string{ text_view.substr(pos, s.start - pos) }));
+      }
+      parts.emplace_back(text(std::string{ text_view.substr(s.start, s.end - s.start) })
+                         | s.color);
+      pos = s.end;
+    }
+    if(pos < text_view.size())
+    {
+      parts.emplace_back(text(std::string{ text_view.substr(pos) }));
+    }
+
+    l.element = flexbox(std::move(parts), config);
+    return l.element;
+  }
+
+  std::map<usize, Element>
+  incremental_highlighter::highlight(usize const line_start, usize const line_end)
+  {
+    std::map<usize, Element> ret;
+    for(auto line{ std::max<usize>(line_start, 1) }; line <= line_end && line <= lines.size();
+        ++line)
+    {
+      ret.emplace(line, render(line - 1));
+    }
+    return ret;
+  }
+
+  usize incremental_highlighter::line_count() const
+  {
+    return lines.size();
+  }
+
+  usize incremental_highlighter::relexed_line_count() const
+  {
+    return relexed_lines;
+  }
 }
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 
@@ -15,6 +16,7 @@
 #include <llvm/Support/VirtualFileSystem.h>
 
 #include <jank/util/clang.hpp>
+#include <jank/util/cli.hpp>
 #include <jank/util/environment.hpp>
 #include <jank/util/fmt/print.hpp>
 #include <jank/util/scope_exit.hpp>
@@ -258,10 +260,10 @@ namespace jank::util
           "Note: Looks like your first run with these flags. Building pre-compiled header… ");
 
     std::filesystem::path const jank_path{ process_dir().c_str() };
-    auto include_path{ jank_path / "../include/cpp/jank/prelude.hpp" };
+    auto include_path{ jank_path / "../include/cpp/jank/prelude/core.hpp" };
     if(!std::filesystem::exists(include_path))
     {
-      auto const install_path{ util::resource_dir() + "/include/jank/prelude.hpp" };
+      auto const install_path{ util::resource_dir() + "/include/jank/prelude/core.hpp" };
       if(!std::filesystem::exists(install_path.c_str()))
       {
         println(stderr, "failed!");
@@ -324,4 +326,73 @@ namespace jank::util
     return result
       = runtime::__rt_ctx->jit_prc.interpreter->getExecutionEngine()->getTargetTriple().str();
   }
+
+  jtl::immutable_string target_cpu()
+  {
+    if(!cli::opts.target_cpu.empty())
+    {
+      return cli::opts.target_cpu;
+    }
+    if(cli::opts.command == cli::command::compile
+       || aot::find_resource("incremental.pch").is_some())
+    {
+      return "generic";
+    }
+    return "native";
+  }
+
+  jtl::option<jtl::immutable_string> target_cpu_flag()
+  {
+    auto const cpu{ target_cpu() };
+    if(cpu == "generic")
+    {
+      return none;
+    }
+    /* On x86, -march picks the features and -mcpu is only an alias for -mtune. Elsewhere,
+     * -mcpu does both. */
+#if defined(__x86_64__) || defined(__i386__)
+    return format("-march={}", cpu);
+#else
+    return format("-mcpu={}", cpu);
+#endif
+  }
+
+  jtl::immutable_string target_cpu_name()
+  {
+    auto const cpu{ target_cpu() };
+    if(cpu == "native")
+    {
+      return llvm::sys::getHostCPUName().str();
+    }
+    return cpu;
+  }
+
+  /* A host CPU's name alone isn't enough, since VMs and some CPU models, such as those
+   * with AVX-512 fused off, don't have every feature the name implies. */
+  jtl::immutable_string target_cpu_features()
+  {
+    if(target_cpu() != "native")
+    {
+      return "";
+    }
+
+    native_vector<std::string> features;
+    for(auto const &feature : llvm::sys::getHostCPUFeatures())
+    {
+      features.emplace_back(
+        util::format("{}{}", feature.second ? '+' : '-', feature.first().str()).c_str());
+    }
+    std::ranges::sort(features);
+
+    jtl::string_builder sb;
+    for(auto const &feature : features)
+    {
+      if(sb.size() != 0)
+      {
+        sb(',');
+      }
+      sb(feature);
+    }
+    return sb.release();
+  }
 }
@@ -1,3 +1,7 @@
+#include <charconv>
+#include <limits>
+#include <string_view>
+
 #include <jank/util/cli.hpp>
 #include <jank/util/fmt/print.hpp>
 #include <jank/runtime/module/loader.hpp>
@@ -61,6 +65,59 @@ namespace jank::util::cli
     return check_flag(it, end, out, "", long_flag, needs_value);
   }
 
+  static u32 parse_count(jtl::immutable_string const &value, char const * const what)
+  {
+    u32 count{};
+    auto const value_end{ value.data() + value.size() };
+    auto const parsed{ std::from_chars(value.data(), value_end, count) };
+    if(parsed.ec != std::errc{} || parsed.ptr != value_end || count == 0)
+    {
+      throw util::format("Invalid {} '{}'.", what, value);
+    }
+    return count;
+  }
+
+  /* Sizes are in bytes, but they can have a K, M, or G suffix. */
+  static usize parse_size(jtl::immutable_string const &value, char const * const what)
+  {
+    usize size{};
+    auto const value_end{ value.data() + value.size() };
+    auto const parsed{ std::from_chars(value.data(), value_end, size) };
+    usize scale{ 1 };
+    if(parsed.ec == std::errc{} && parsed.ptr + 1 == value_end)
+    {
+      switch(*parsed.ptr)
+      {
+        case 'k':
+        case 'K':
+          scale = 1024;
+          break;
+        case 'm':
+        case 'M':
+          scale = 1024 * 1024;
+          break;
+        case 'g':
+        case 'G':
+          scale = 1024 * 1024 * 1024;
+          break;
+        default:
+          scale = 0;
+          break;
+      }
+    }
+    else if(parsed.ptr != value_end)
+    {
+      scale = 0;
+    }
+
+    if(parsed.ec != std::errc{} || scale == 0 || size == 0
+       || size > std::numeric_limits<usize>::max() / scale)
+    {
+      throw util::format("Invalid {} '{}'.", what, value);
+    }
+    return size * scale;
+  }
+
   static jtl::immutable_string
   get_positional_arg(jtl::immutable_string const &command,
                      jtl::immutable_string const &name,
@@ -111,6 +168,10 @@ COMMANDS
   compile                     Ahead of time compile project with entrypoint module containing
                               -main.
   check-health                Provide a status report on the jank installation.
+  heap-summary                Summarize a snapshot from jank.perf/heap-snapshot.
+  bench-compile               Load a module from source and report the time and allocations
+                              of each compiler phase, along with the slowest forms.
+  test                        Run the clojure.test tests in the given namespaces.
 
 OPTIONS
   -h,     --help              Print this help message and exit.
@@ -119,15 +180,115 @@ OPTIONS
                               to search for modules.
           --profile           Enable compiler and runtime profiling.
           --profile-output <path> [default: jank.profile]
-                              The file to write profile entries (will be overwritten).
-          --perf              Enable Linux perf event sampling.
+                              The file to write profile entries (will be overwritten). This
+                              is a Chrome trace, which can be opened with Perfetto.
+          --perf              Enable Linux perf event sampling. JIT compiled code is
+                              written to a jitdump, with line tables for IR codegen which
+                              point at the jank source, for use with `perf inject --jit`.
+          --frame-pointers    Keep frame pointers in JIT compiled code, so that
+                              jank.perf/profile can see the jank fns in each stack.
+          --binary-cache-dir <path> [default: target]
+                              The directory to store compiled modules in. Binaries are
+                              validated by content, so this can be shared across checkouts.
+          --image <path>      Load modules straight from the binaries listed in a startup
+                              image, without checking their sources, as long as each binary
+                              still has the key it was saved with.
+          --save-image <path> Write a startup image of the modules loaded from binaries,
+                              once the run or run-main command is done.
+          --remote-cache <url>
+                              Share compiled modules and the PCH through a cache at an
+                              http:// URL or a directory. The layout matches bazel-remote,
+                              which needs --disable_http_ac_validation.
+          --remote-cache-read-only
+                              Fetch from the remote cache, but don't add to it.
+          --target-cpu <cpu>  The CPU to build code for, such as native, x86-64-v3, or
+                              neoverse-v2. The JIT defaults to native, while AOT
+                              programs default to a generic CPU of the target triple.
           --gc-incremental    Enable incremental GC collection.
+          --gc-generational   Only collect young objects, plus any written to since the last
+                              collection, most of the time. Dirty pages are tracked with
+                              soft-dirty bits where the kernel has them, else mprotect.
+          --gc-full-freq <count> [default: 19]
+                              The number of young collections between full collections, for
+                              --gc-incremental and --gc-generational.
+          --gc-markers <count>
+                              The number of threads to mark with in parallel, including the
+                              one which started the collection. Defaults to the core count.
+          --gc-initial-heap <size>
+                              The heap size to start with, in bytes, with an optional K, M,
+                              or G suffix. Starting bigger avoids early collections.
+          --gc-max-heap <size>
+                              The most the heap may grow to, in bytes, with an optional K, M,
+                              or G suffix. Allocating past it is an out of memory error.
+          --gc-huge-pages     Back the heap with transparent huge pages, to cut down on TLB
+                              misses with big heaps. Linux only, with THP set to madvise
+                              or always.
+          --gc-free-space-divisor <count> [default: 3]
+                              Higher values collect more often, with a smaller heap. Lower
+                              values collect less often, with a bigger heap.
+          --executor-threads <count>
+                              The number of workers for futures, agents, and pmap. Defaults
+                              to the core count.
+          --executor-affinity <none, core, node> [default: none]
+                              Pin each of those workers to a core, or to the cores of a NUMA
+                              node. Workers are spread evenly across nodes and steal work
+                              from their own node first.
           --debug             Enable debug symbol generation for generated code.
           --direct-call       Elides the dereferencing of vars for improved performance.
+          --direct-linking    Links calls to non-dynamic vars directly to their fns. Redefining
+                              such a var won't affect existing callers, unless it's ^:redef.
+          --lazy-defs         In compiled modules, initialize defs of fns and literals on
+                              their first deref, rather than when the module is loaded.
+          --fold-constants    Evaluate calls to pure clojure.core fns with literal args, and ifs
+                              with literal conditions, at compile time.
+          --fn-stats          Count the calls to each fn arity, for jank.perf/fn-stats.
+          --fn-timing         Like --fn-stats, but also time each call, in CPU cycles.
+          --tiered-compilation
+                              JIT compile fns without optimizations, then recompile hot fns
+                              with optimizations in the background. Requires llvm-ir codegen.
+          --tier-up-threshold <count> [default: 1000]
+                              The number of calls to an arity before its fn is optimized.
+          --interpret         Interpret fns, rather than JIT compiling them, until they're
+                              hot. Fns which use C++ interop, or whose var is ^:jit, are
+                              always JIT compiled.
+          --jit-threshold <count> [default: 100]
+                              The number of calls to an interpreted fn before it's JIT
+                              compiled. Closures are always interpreted.
+          --batch-jit         When loading a file, JIT compile each run of top-level fn defs
+                              into one module, rather than one module per def.
+          --macroexpand-cache
+                              Cache macro expansions of forms read from files on disk, to
+                              reuse when unchanged modules are loaded from source again.
+          --intern-symbols    Intern the symbols in data which is read, such as by
+                              read-string, so equal symbols share one object.
+          --reclaim-jit-code  Unload the JIT compiled code of eval'd fns once they're no
+                              longer reachable, such as after being redefined. Requires
+                              llvm-ir codegen, without --tiered-compilation.
+          --cache-eval-objects
+                              Cache the object code of eval'd forms on disk, so the same
+                              forms skip optimization and codegen, even after a restart.
+                              Requires llvm-ir codegen, without --tiered-compilation or
+                              --reclaim-jit-code.
+          --no-stack-traces   Don't capture stack traces for errors, so throwing them is
+                              cheaper, but they're reported without one.
   -O,     --optimization <0 - 3>
                               The optimization level to use for AOT compilation.
-          --codegen <llvm-ir, cpp> [default: cpp]
-                              The type of code generation to use.
+          --whole-program     For the compile command, link only the modules the entrypoint
+                              depends on, with ThinLTO and unused sections dropped. The
+                              program can't eval code at run time.
+          --profile-generate  For the compile command, instrument the program to write an
+                              LLVM profile when it runs. Merge the raw profiles with
+                              llvm-profdata for --profile-use.
+          --profile-use <path>
+                              Optimize compiled modules with a merged LLVM profile from a
+                              --profile-generate build of the same sources.
+          --codegen <llvm-ir, cpp> [default: llvm-ir]
+                              The type of code generation to use. C++ output targets use
+                              cpp, unless this is given.
+  -j,     --jobs <count> [default: 1]
+                              The number of object files to emit in parallel when compiling
+                              modules. For the test command, the number of tests to run at
+                              once. Tests with ^:serial metadata always run on their own.
   -I,     --include-dir <path>
                               Absolute or relative path to the directory for includes
                               resolution. Can be specified multiple times.
@@ -154,7 +315,10 @@ OPTIONS
       {       "cpp-repl",       command::cpp_repl },
       { "compile-module", command::compile_module },
       {        "compile",        command::compile },
-      {   "check-health",   command::check_health }
+      {   "check-health",   command::check_health },
+      {   "heap-summary",   command::heap_summary },
+      {  "bench-compile",  command::bench_compile },
+      {           "test",           command::test }
     };
 
     /* The flow of this is broken into the following steps.
@@ -203,10 +367,149 @@ OPTIONS
         {
           opts.perf_profiling_enabled = true;
         }
+        else if(check_flag(it, end, value, "--frame-pointers", false))
+        {
+          opts.frame_pointers = true;
+        }
+        else if(check_flag(it, end, value, "--binary-cache-dir", true))
+        {
+          opts.binary_cache_dir = value;
+        }
+        else if(check_flag(it, end, value, "--image", true))
+        {
+          opts.image_file = value;
+        }
+        else if(check_flag(it, end, value, "--save-image", true))
+        {
+          opts.save_image_file = value;
+        }
+        else if(check_flag(it, end, value, "--remote-cache", true))
+        {
+          opts.remote_cache = value;
+        }
+        else if(check_flag(it, end, value, "--remote-cache-read-only", false))
+        {
+          opts.remote_cache_read_only = true;
+        }
+        else if(check_flag(it, end, value, "--target-cpu", true))
+        {
+          opts.target_cpu = value;
+        }
+        else if(check_flag(it, end, value, "--gc-generational", false))
+        {
+          opts.gc_generational = true;
+        }
+        else if(check_flag(it, end, value, "--gc-full-freq", true))
+        {
+          opts.gc_full_freq = parse_count(value, "GC full collection frequency");
+        }
+        else if(check_flag(it, end, value, "--gc-markers", true))
+        {
+          opts.gc_markers = parse_count(value, "GC marker count");
+        }
+        else if(check_flag(it, end, value, "--gc-initial-heap", true))
+        {
+          opts.gc_initial_heap_size = parse_size(value, "GC initial heap size");
+        }
+        else if(check_flag(it, end, value, "--gc-max-heap", true))
+        {
+          opts.gc_max_heap_size = parse_size(value, "GC max heap size");
+        }
+        else if(check_flag(it, end, value, "--gc-huge-pages", false))
+        {
+          opts.gc_huge_pages = true;
+        }
+        else if(check_flag(it, end, value, "--gc-free-space-divisor", true))
+        {
+          opts.gc_free_space_divisor = parse_count(value, "GC free space divisor");
+        }
+        else if(check_flag(it, end, value, "--executor-threads", true))
+        {
+          opts.executor_threads = parse_count(value, "executor thread count");
+        }
+        else if(check_flag(it, end, value, "--executor-affinity", true))
+        {
+          if(value == "none")
+          {
+            opts.executor_affinity = executor_affinity::none;
+          }
+          else if(value == "core")
+          {
+            opts.executor_affinity = executor_affinity::core;
+          }
+          else if(value == "node")
+          {
+            opts.executor_affinity = executor_affinity::node;
+          }
+          else
+          {
+            throw util::format("Invalid executor affinity '{}'.", value);
+          }
+        }
         else if(check_flag(it, end, value, "--direct-call", false))
         {
           opts.direct_call = true;
         }
+        else if(check_flag(it, end, value, "--direct-linking", false))
+        {
+          opts.direct_linking = true;
+        }
+        else if(check_flag(it, end, value, "--lazy-defs", false))
+        {
+          opts.lazy_defs = true;
+        }
+        else if(check_flag(it, end, value, "--fold-constants", false))
+        {
+          opts.fold_constants = true;
+        }
+        else if(check_flag(it, end, value, "--fn-stats", false))
+        {
+          opts.fn_stats = true;
+        }
+        else if(check_flag(it, end, value, "--fn-timing", false))
+        {
+          opts.fn_timing = true;
+        }
+        else if(check_flag(it, end, value, "--tiered-compilation", false))
+        {
+          opts.tiered_compilation = true;
+        }
+        else if(check_flag(it, end, value, "--tier-up-threshold", true))
+        {
+          opts.tier_up_threshold = parse_count(value, "tier up threshold");
+        }
+        else if(check_flag(it, end, value, "--interpret", false))
+        {
+          opts.interpret = true;
+        }
+        else if(check_flag(it, end, value, "--jit-threshold", true))
+        {
+          opts.jit_threshold = parse_count(value, "JIT threshold");
+        }
+        else if(check_flag(it, end, value, "--batch-jit", false))
+        {
+          opts.batch_jit = true;
+        }
+        else if(check_flag(it, end, value, "--macroexpand-cache", false))
+        {
+          opts.macroexpand_cache = true;
+        }
+        else if(check_flag(it, end, value, "--intern-symbols", false))
+        {
+          opts.intern_symbols = true;
+        }
+        else if(check_flag(it, end, value, "--reclaim-jit-code", false))
+        {
+          opts.reclaim_jit_code = true;
+        }
+        else if(check_flag(it, end, value, "--cache-eval-objects", false))
+        {
+          opts.cache_eval_objects = true;
+        }
+        else if(check_flag(it, end, value, "--no-stack-traces", false))
+        {
+          opts.no_stack_traces = true;
+        }
         else if(check_flag(it, end, value, "-O", "--optimization", true))
         {
           if(value == "0")
@@ -230,8 +533,13 @@ OPTIONS
             throw util::format("Invalid optimization level '{}'.", value);
           }
         }
+        else if(check_flag(it, end, value, "-j", "--jobs", true))
+        {
+          opts.jobs = parse_count(value, "job count");
+        }
         else if(check_flag(it, end, value, "--codegen", true))
         {
+          opts.codegen_specified = true;
           if(value == "cpp")
           {
             opts.codegen = codegen_type::cpp;
@@ -275,6 +583,18 @@ OPTIONS
         {
           pending_flags["--runtime"] = value;
         }
+        else if(check_flag(it, end, value, "--whole-program", false))
+        {
+          pending_flags["--whole-program"] = "";
+        }
+        else if(check_flag(it, end, value, "--profile-generate", false))
+        {
+          pending_flags["--profile-generate"] = "";
+        }
+        else if(check_flag(it, end, value, "--profile-use", true))
+        {
+          pending_flags["--profile-use"] = value;
+        }
         else if(command.empty())
         {
           command = *it;
@@ -297,14 +617,24 @@ OPTIONS
       }
 
       /* Now process all pending flags, depending on our command. */
-      if(command == "run")
+      if(command == "run" || command == "heap-summary")
       {
         opts.target_file = get_positional_arg(command, "file", pending_positional_args);
       }
-      else if(command == "run-main")
+      else if(command == "run-main" || command == "bench-compile")
       {
         opts.target_module = get_positional_arg(command, "module", pending_positional_args);
       }
+      else if(command == "test")
+      {
+        opts.test_modules.emplace_back(
+          get_positional_arg(command, "namespace", pending_positional_args));
+        while(!pending_positional_args.empty())
+        {
+          opts.test_modules.emplace_back(
+            get_positional_arg(command, "namespace", pending_positional_args));
+        }
+      }
       else if(command == "repl")
       {
         if(!pending_positional_args.empty())
@@ -349,6 +679,25 @@ OPTIONS
         {
           opts.target_file = value;
         }
+        if(command == "compile" && check_pending_flag("--whole-program", value, pending_flags))
+        {
+          opts.whole_program = true;
+        }
+        /* Instrumented code needs the profile runtime, which only gets linked into programs. */
+        if(command == "compile"
+           && check_pending_flag("--profile-generate", value, pending_flags))
+        {
+          opts.profile_generate = true;
+        }
+        if(check_pending_flag("--profile-use", value, pending_flags))
+        {
+          opts.profile_use_file = value;
+        }
+
+        if(opts.profile_generate && !opts.profile_use_file.empty())
+        {
+          throw util::format("--profile-generate and --profile-use can't be used together.");
+        }
 
         if(command == "compile" && opts.output_target == compilation_target::unspecified)
         {
@@ -391,6 +740,27 @@ OPTIONS
     return ok();
   }
 
+  u32 parse_gc_markers(int const argc, char const **argv)
+  {
+    for(int i{ 1 }; i + 1 < argc; ++i)
+    {
+      std::string_view const flag{ argv[i] };
+      if(flag == "--")
+      {
+        break;
+      }
+      if(flag == "--gc-markers")
+      {
+        std::string_view const value{ argv[i + 1] };
+        u32 count{};
+        auto const parsed{ std::from_chars(value.data(), value.data() + value.size(), count) };
+        /* Invalid values are reported when the rest of the args are parsed. */
+        return parsed.ec == std::errc{} ? count : 0;
+      }
+    }
+    return 0;
+  }
+
   native_vector<jtl::immutable_string> parse_into_vector(int const argc, char const **argv)
   {
     native_vector<jtl::immutable_string> ret;
@@ -15,6 +15,7 @@
 #include <jank/util/environment.hpp>
 #include <jank/util/sha256.hpp>
 #include <jank/util/cli.hpp>
+#include <jank/util/clang.hpp>
 #include <jank/util/fmt.hpp>
 #include <jank/error/system.hpp>
 
@@ -80,7 +81,7 @@ namespace jank::util
       return res;
     }
 
-    return res = util::format("target/{}", binary_version);
+    return res = util::format("{}/{}", util::cli::opts.binary_cache_dir, binary_version);
   }
 
   /* The binary version is composed of two things:
@@ -115,12 +116,24 @@ namespace jank::util
       sb(def);
     }
 
-    auto const input(util::format("{}.{}.{}.{}.{}.{}",
+    /* Direct calls and direct linking change the code we generate, so binaries compiled
+     * with and without them can't be mixed. Whole program builds emit LLVM bitcode, rather
+     * than native objects, which the JIT can't load. Profile instrumentation and profile
+     * use also change what we emit. So does the target CPU, which is resolved, so that
+     * hosts with different CPUs never share binaries built for native. */
+    auto const input(util::format("{}.{}.{}.{}.{}.{}.{}.{}.{}.{}.{}.{}.{}",
                                   JANK_VERSION,
                                   clang::getClangRevision(),
                                   JANK_JIT_FLAGS,
                                   util::cli::opts.optimization_level,
                                   static_cast<int>(util::cli::opts.codegen),
+                                  util::cli::opts.direct_call,
+                                  util::cli::opts.direct_linking,
+                                  util::cli::opts.whole_program,
+                                  util::cli::opts.profile_generate,
+                                  util::cli::opts.profile_use_file,
+                                  util::target_cpu_name(),
+                                  util::target_cpu_features(),
                                   sb.release()));
     /* TODO: Actual target triple. */
     res = util::format("{}-{}", llvm::sys::getDefaultTargetTriple(), util::sha256(input));
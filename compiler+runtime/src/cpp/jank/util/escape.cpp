@@ -76,7 +76,12 @@ namespace jank::util
      * I'm not going to guess at the stats, to predict a better allocation, until this shows
      * up in the profiler, though. */
     jtl::string_builder sb{ input.size() };
+    escape(input, sb);
+    return sb.release();
+  }
 
+  void escape(jtl::immutable_string const &input, jtl::string_builder &sb)
+  {
     for(auto const c : input)
     {
       switch(c)
@@ -121,7 +126,5 @@ namespace jank::util
           sb(c);
       }
     }
-
-    return sb.release();
   }
 }
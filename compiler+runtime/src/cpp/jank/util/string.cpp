@@ -1,15 +1,486 @@
 #include <algorithm>
+#include <bit>
+#include <cstring>
 #include <locale>
 #include <codecvt>
 #include <cwctype>
 #include <ranges>
 
+#if defined(__SSE2__)
+  #include <immintrin.h>
+#elif defined(__ARM_NEON)
+  #include <arm_neon.h>
+#endif
+
+/* Baseline x86_64 builds only have SSE2 blocks, but nearly every machine running them has
+ * AVX2, so substring search also gets an AVX2 version which is picked at runtime. That
+ * needs ifunc style CPU detection, which is only on ELF. */
+#if defined(__x86_64__) && defined(__ELF__) && !defined(__AVX2__)
+  #define JANK_STRING_AVX2_DISPATCH
+#endif
+
 #include <jtl/immutable_string.hpp>
 
 #include <jank/util/string.hpp>
 
 namespace jank::util
 {
+  namespace
+  {
+    /* The string kernels below are written once against this block of bytes, which is as
+     * wide as the best vector registers we have. Masks have a set bit for each byte which
+     * passed the comparison, except on NEON, which has no movemask, so each byte gets a
+     * nibble instead. Without any vector registers, a block is just one byte, and the
+     * kernels become plain loops. */
+    struct byte_block
+    {
+#if defined(__AVX2__)
+      using mask_type = u32;
+      static constexpr usize width{ 32 };
+      static constexpr mask_type full_mask{ 0xffffffff };
+
+      static byte_block load(char const * const p)
+      {
+        return { _mm256_loadu_si256(reinterpret_cast<__m256i const *>(p)) };
+      }
+
+      static byte_block splat(char const c)
+      {
+        return { _mm256_set1_epi8(c) };
+      }
+
+      void store(char * const p) const
+      {
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), data);
+      }
+
+      byte_block operator==(byte_block const o) const
+      {
+        return { _mm256_cmpeq_epi8(data, o.data) };
+      }
+
+      byte_block operator&(byte_block const o) const
+      {
+        return { _mm256_and_si256(data, o.data) };
+      }
+
+      byte_block operator|(byte_block const o) const
+      {
+        return { _mm256_or_si256(data, o.data) };
+      }
+
+      byte_block operator^(byte_block const o) const
+      {
+        return { _mm256_xor_si256(data, o.data) };
+      }
+
+      /* The comparison is signed, so this only works for ASCII bounds. Non-ASCII bytes are
+       * negative, so they're never in range. */
+      byte_block in_range(char const low, char const high) const
+      {
+        return { _mm256_and_si256(
+          _mm256_cmpgt_epi8(data, _mm256_set1_epi8(static_cast<char>(low - 1))),
+          _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(high + 1)), data)) };
+      }
+
+      byte_block non_ascii() const
+      {
+        return { _mm256_cmpgt_epi8(_mm256_setzero_si256(), data) };
+      }
+
+      mask_type mask() const
+      {
+        return static_cast<mask_type>(_mm256_movemask_epi8(data));
+      }
+
+      __m256i data;
+#elif defined(__SSE2__)
+      using mask_type = u32;
+      static constexpr usize width{ 16 };
+      static constexpr mask_type full_mask{ 0xffff };
+
+      static byte_block load(char const * const p)
+      {
+        return { _mm_loadu_si128(reinterpret_cast<__m128i const *>(p)) };
+      }
+
+      static byte_block splat(char const c)
+      {
+        return { _mm_set1_epi8(c) };
+      }
+
+      void store(char * const p) const
+      {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(p), data);
+      }
+
+      byte_block operator==(byte_block const o) const
+      {
+        return { _mm_cmpeq_epi8(data, o.data) };
+      }
+
+      byte_block operator&(byte_block const o) const
+      {
+        return { _mm_and_si128(data, o.data) };
+      }
+
+      byte_block operator|(byte_block const o) const
+      {
+        return { _mm_or_si128(data, o.data) };
+      }
+
+      byte_block operator^(byte_block const o) const
+      {
+        return { _mm_xor_si128(data, o.data) };
+      }
+
+      /* The comparison is signed, so this only works for ASCII bounds. Non-ASCII bytes are
+       * negative, so they're never in range. */
+      byte_block in_range(char const low, char const high) const
+      {
+        return { _mm_and_si128(_mm_cmpgt_epi8(data, _mm_set1_epi8(static_cast<char>(low - 1))),
+                               _mm_cmpgt_epi8(_mm_set1_epi8(static_cast<char>(high + 1)), data)) };
+      }
+
+      byte_block non_ascii() const
+      {
+        return { _mm_cmplt_epi8(data, _mm_setzero_si128()) };
+      }
+
+      mask_type mask() const
+      {
+        return static_cast<mask_type>(_mm_movemask_epi8(data));
+      }
+
+      __m128i data;
+#elif defined(__ARM_NEON)
+      using mask_type = u64;
+      static constexpr usize width{ 16 };
+      static constexpr mask_type full_mask{ ~mask_type{} };
+
+      static byte_block load(char const * const p)
+      {
+        return { vld1q_u8(reinterpret_cast<u8 const *>(p)) };
+      }
+
+      static byte_block splat(char const c)
+      {
+        return { vdupq_n_u8(static_cast<u8>(c)) };
+      }
+
+      void store(char * const p) const
+      {
+        vst1q_u8(reinterpret_cast<u8 *>(p), data);
+      }
+
+      byte_block operator==(byte_block const o) const
+      {
+        return { vceqq_u8(data, o.data) };
+      }
+
+      byte_block operator&(byte_block const o) const
+      {
+        return { vandq_u8(data, o.data) };
+      }
+
+      byte_block operator|(byte_block const o) const
+      {
+        return { vorrq_u8(data, o.data) };
+      }
+
+      byte_block operator^(byte_block const o) const
+      {
+        return { veorq_u8(data, o.data) };
+      }
+
+      byte_block in_range(char const low, char const high) const
+      {
+        return { vandq_u8(vcgeq_u8(data, vdupq_n_u8(static_cast<u8>(low))),
+                          vcleq_u8(data, vdupq_n_u8(static_cast<u8>(high)))) };
+      }
+
+      byte_block non_ascii() const
+      {
+        return { vcgeq_u8(data, vdupq_n_u8(0x80)) };
+      }
+
+      mask_type mask() const
+      {
+        return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(data), 4)), 0);
+      }
+
+      uint8x16_t data;
+#else
+      using mask_type = u32;
+      static constexpr usize width{ 1 };
+      static constexpr mask_type full_mask{ 1 };
+
+      static byte_block load(char const * const p)
+      {
+        return { static_cast<u8>(*p) };
+      }
+
+      static byte_block splat(char const c)
+      {
+        return { static_cast<u8>(c) };
+      }
+
+      void store(char * const p) const
+      {
+        *p = static_cast<char>(data);
+      }
+
+      byte_block operator==(byte_block const o) const
+      {
+        return { static_cast<u8>(data == o.data ? 0xff : 0) };
+      }
+
+      byte_block operator&(byte_block const o) const
+      {
+        return { static_cast<u8>(data & o.data) };
+      }
+
+      byte_block operator|(byte_block const o) const
+      {
+        return { static_cast<u8>(data | o.data) };
+      }
+
+      byte_block operator^(byte_block const o) const
+      {
+        return { static_cast<u8>(data ^ o.data) };
+      }
+
+      byte_block in_range(char const low, char const high) const
+      {
+        return { static_cast<u8>(
+          data >= static_cast<u8>(low) && data <= static_cast<u8>(high) ? 0xff : 0) };
+      }
+
+      byte_block non_ascii() const
+      {
+        return { static_cast<u8>(data >= 0x80 ? 0xff : 0) };
+      }
+
+      mask_type mask() const
+      {
+        return data >> 7;
+      }
+
+      u8 data;
+#endif
+
+      static constexpr usize bits_per_byte{ std::bit_width(full_mask) / width };
+
+      /* The offset of the first byte in the mask. */
+      static usize first(mask_type const m)
+      {
+        return static_cast<usize>(std::countr_zero(m)) / bits_per_byte;
+      }
+
+      /* The offset of the last byte in the mask. */
+      static usize last(mask_type const m)
+      {
+        return (static_cast<usize>(std::bit_width(m)) - 1) / bits_per_byte;
+      }
+
+      static mask_type drop_first(mask_type const m)
+      {
+        return m & ~(((mask_type{ 1 } << bits_per_byte) - 1) << (first(m) * bits_per_byte));
+      }
+    };
+
+#if defined(JANK_STRING_AVX2_DISPATCH)
+    /* The block loop of find, with AVX2 blocks. On a match, this gives back true, with pos
+     * at the match. Otherwise, pos is left where the blocks ran out. */
+    [[gnu::target("avx2")]]
+    bool find_blocks_avx2(char const * const h,
+                          usize const size,
+                          char const * const nd,
+                          usize const n,
+                          usize &pos)
+    {
+      static constexpr usize width{ 32 };
+      auto const first{ _mm256_set1_epi8(nd[0]) };
+      auto const last{ _mm256_set1_epi8(nd[n - 1]) };
+      for(; pos + n - 1 + width <= size; pos += width)
+      {
+        auto const block_first{ _mm256_loadu_si256(reinterpret_cast<__m256i const *>(h + pos)) };
+        auto const block_last{ _mm256_loadu_si256(
+          reinterpret_cast<__m256i const *>(h + pos + n - 1)) };
+        auto candidates{ static_cast<u32>(
+          _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(block_first, first),
+                                                _mm256_cmpeq_epi8(block_last, last)))) };
+        for(; candidates != 0; candidates &= candidates - 1)
+        {
+          auto const i{ pos + static_cast<usize>(std::countr_zero(candidates)) };
+          if(std::memcmp(h + i + 1, nd + 1, n - 2) == 0)
+          {
+            pos = i;
+            return true;
+          }
+        }
+      }
+      return false;
+    }
+#endif
+  }
+
+  static bool is_space(char const c)
+  {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+  }
+
+  static byte_block::mask_type non_space_mask(byte_block const b)
+  {
+    return ~((b == byte_block::splat(' ')) | b.in_range('\t', '\r')).mask()
+      & byte_block::full_mask;
+  }
+
+  /* Upper and lower case ASCII letters only differ by this one bit. */
+  static bool ascii_flip_case(jtl::immutable_string_view const &input,
+                              char * const output,
+                              char const low,
+                              char const high)
+  {
+    auto const in{ input.data() };
+    auto const size{ input.size() };
+    auto const case_bit{ byte_block::splat(0x20) };
+
+    usize i{};
+    for(; i + byte_block::width <= size; i += byte_block::width)
+    {
+      auto const b{ byte_block::load(in + i) };
+      if(b.non_ascii().mask() != 0)
+      {
+        return false;
+      }
+      (b ^ (b.in_range(low, high) & case_bit)).store(output + i);
+    }
+
+    for(; i < size; ++i)
+    {
+      auto const c{ in[i] };
+      if(static_cast<u8>(c) >= 0x80)
+      {
+        return false;
+      }
+      output[i] = (c >= low && c <= high) ? static_cast<char>(c ^ 0x20) : c;
+    }
+    return true;
+  }
+
+  /* For needles of two or more bytes, this compares the needle's first and last bytes
+   * against a whole block of candidate positions at once. Only positions where both match
+   * are compared in full, which is rare enough for real text that it's close to a memchr. */
+  usize find(jtl::immutable_string_view const &haystack,
+             jtl::immutable_string_view const &needle,
+             usize pos)
+  {
+    auto const size{ haystack.size() };
+    auto const n{ needle.size() };
+    if(n == 0)
+    {
+      return pos <= size ? pos : jtl::immutable_string_view::npos;
+    }
+    if(pos >= size || size - pos < n)
+    {
+      return jtl::immutable_string_view::npos;
+    }
+
+    auto const h{ haystack.data() };
+    auto const nd{ needle.data() };
+    if(n == 1)
+    {
+      auto const found{ static_cast<char const *>(std::memchr(h + pos, nd[0], size - pos)) };
+      return found ? static_cast<usize>(found - h) : jtl::immutable_string_view::npos;
+    }
+
+#if defined(JANK_STRING_AVX2_DISPATCH)
+    static bool const has_avx2{ __builtin_cpu_supports("avx2") != 0 };
+    if(has_avx2 && find_blocks_avx2(h, size, nd, n, pos))
+    {
+      return pos;
+    }
+#endif
+
+    auto const first{ byte_block::splat(nd[0]) };
+    auto const last{ byte_block::splat(nd[n - 1]) };
+    for(; pos + n - 1 + byte_block::width <= size; pos += byte_block::width)
+    {
+      auto candidates{ ((byte_block::load(h + pos) == first)
+                        & (byte_block::load(h + pos + n - 1) == last))
+                         .mask() };
+      for(; candidates != 0; candidates = byte_block::drop_first(candidates))
+      {
+        auto const i{ pos + byte_block::first(candidates) };
+        if(std::memcmp(h + i + 1, nd + 1, n - 2) == 0)
+        {
+          return i;
+        }
+      }
+    }
+
+    for(; pos + n <= size; ++pos)
+    {
+      if(h[pos] == nd[0] && std::memcmp(h + pos, nd, n) == 0)
+      {
+        return pos;
+      }
+    }
+    return jtl::immutable_string_view::npos;
+  }
+
+  usize find_non_space(jtl::immutable_string_view const &s)
+  {
+    auto const data{ s.data() };
+    auto const size{ s.size() };
+
+    usize i{};
+    for(; i + byte_block::width <= size; i += byte_block::width)
+    {
+      auto const non_space{ non_space_mask(byte_block::load(data + i)) };
+      if(non_space != 0)
+      {
+        return i + byte_block::first(non_space);
+      }
+    }
+
+    for(; i < size && is_space(data[i]); ++i)
+    {
+    }
+    return i;
+  }
+
+  usize rfind_non_space(jtl::immutable_string_view const &s)
+  {
+    auto const data{ s.data() };
+
+    auto i{ s.size() };
+    for(; i >= byte_block::width; i -= byte_block::width)
+    {
+      auto const non_space{ non_space_mask(byte_block::load(data + i - byte_block::width)) };
+      if(non_space != 0)
+      {
+        return i - byte_block::width + byte_block::last(non_space) + 1;
+      }
+    }
+
+    for(; i > 0 && is_space(data[i - 1]); --i)
+    {
+    }
+    return i;
+  }
+
+  bool ascii_to_lowercase(jtl::immutable_string_view const &input, char * const output)
+  {
+    return ascii_flip_case(input, output, 'A', 'Z');
+  }
+
+  bool ascii_to_uppercase(jtl::immutable_string_view const &input, char * const output)
+  {
+    return ascii_flip_case(input, output, 'a', 'z');
+  }
+
   std::string to_lowercase(std::string const &s)
   {
     std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
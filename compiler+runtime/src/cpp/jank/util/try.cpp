@@ -3,7 +3,10 @@
 #include <cpptrace/from_current.hpp>
 #include <cpptrace/formatting.hpp>
 
+#include <jtl/option.hpp>
+
 #include <jank/util/try.hpp>
+#include <jank/util/cli.hpp>
 #include <jank/util/fmt/print.hpp>
 #include <jank/runtime/core/to_string.hpp>
 #include <jank/error.hpp>
@@ -72,14 +75,41 @@ namespace jank::util
                                  .filtered_frame_placeholders(false)
                                  .filter(&filter_frame) };
 
+  /* Unset until a thread changes it, in which case the CLI option decides. */
+  static thread_local jtl::option<bool> thread_capturing_stack_traces;
+
+  bool capturing_stack_traces()
+  {
+    if(thread_capturing_stack_traces.is_some())
+    {
+      return thread_capturing_stack_traces.unwrap();
+    }
+    return !cli::opts.no_stack_traces;
+  }
+
+  void set_capturing_stack_traces(bool const capture)
+  {
+    thread_capturing_stack_traces = capture;
+  }
+
+  cpptrace::raw_trace const *current_exception_trace()
+  {
+    if(!capturing_stack_traces())
+    {
+      return nullptr;
+    }
+    return &cpptrace::raw_trace_from_current_exception();
+  }
+
   static void print_exception_stack_trace()
   {
     formatter.print(cpptrace::from_current_exception());
   }
 
-  static void print_exception_stack_trace(cpptrace::stacktrace const &trace)
+  /* This is where the frames are finally symbolized, filtered, and stripped. */
+  static void print_exception_stack_trace(cpptrace::raw_trace const &trace)
   {
-    formatter.print(trace);
+    formatter.print(trace.resolve());
   }
 
   void print_exception(std::exception const &e)
@@ -119,7 +149,7 @@ namespace jank::util
      * compiler error output cleaner, since the stack trace isn't
      * actually going to provide any useful info. */
     jtl::ptr<error::base> original{ e };
-    cpptrace::stacktrace const *deepest_trace{ original->trace.get() };
+    cpptrace::raw_trace const *deepest_trace{ original->trace.get() };
     while(original->cause)
     {
       original = original->cause;
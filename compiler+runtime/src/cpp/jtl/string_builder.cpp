@@ -12,14 +12,14 @@ namespace jtl
   using allocator_type = jank::native_allocator<string_builder::value_type>;
   using allocator_traits = std::allocator_traits<allocator_type>;
 
+  /* The buffer becomes the released string's memory, so it's atomic GC memory, just like
+   * immutable_string allocates. */
   static void realloc(string_builder &sb, usize const required)
   {
     auto const new_capacity{ std::bit_ceil(required) };
-    /* NOLINTNEXTLINE(cppcoreguidelines-no-malloc) */
-    auto const new_data{ reinterpret_cast<char *>(malloc(new_capacity)) };
+    auto const new_data{ static_cast<char *>(GC_MALLOC_ATOMIC(new_capacity)) };
     string_builder::traits_type::copy(new_data, sb.buffer, sb.pos);
-    /* NOLINTNEXTLINE(cppcoreguidelines-no-malloc) */
-    free(sb.buffer);
+    GC_FREE(sb.buffer);
     sb.buffer = new_data;
     sb.capacity = new_capacity;
   }
@@ -101,8 +101,7 @@ namespace jtl
 
   string_builder::~string_builder()
   {
-    /* NOLINTNEXTLINE(cppcoreguidelines-no-malloc) */
-    free(buffer);
+    GC_FREE(buffer);
   }
 
   string_builder &string_builder::operator()(bool const d) &
@@ -292,6 +291,16 @@ namespace jtl
     return *this;
   }
 
+  string_builder &string_builder::operator()(jtl::immutable_string_view const &d) &
+  {
+    auto const required{ d.size() };
+    maybe_realloc(*this, required);
+
+    write(*this, d.data(), required);
+
+    return *this;
+  }
+
   string_builder &string_builder::operator()(terminal_style const s) &
   {
     return (*this)(style(s));
@@ -377,6 +386,11 @@ namespace jtl
     (*this)(d);
   }
 
+  void string_builder::push_back(jtl::immutable_string_view const &d) &
+  {
+    (*this)(d);
+  }
+
   void string_builder::reserve(usize const new_capacity)
   {
     if(capacity < new_capacity)
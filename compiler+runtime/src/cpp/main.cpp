@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 
@@ -11,6 +13,7 @@
 #include <jank/runtime/context.hpp>
 #include <jank/runtime/behavior/callable.hpp>
 #include <jank/runtime/core/to_string.hpp>
+#include <jank/runtime/core/truthy.hpp>
 #include <jank/runtime/obj/persistent_hash_map.hpp>
 #include <jank/runtime/obj/persistent_string.hpp>
 #include <jank/runtime/obj/persistent_vector.hpp>
@@ -20,16 +23,27 @@
 #include <jank/jit/processor.hpp>
 #include <jank/aot/processor.hpp>
 #include <jank/profile/time.hpp>
+#include <jank/profile/phase.hpp>
 #include <jank/util/scope_exit.hpp>
 #include <jank/util/string.hpp>
 #include <jank/util/fmt/print.hpp>
 #include <jank/util/try.hpp>
 #include <jank/error/report.hpp>
 #include <jank/environment/check_health.hpp>
+#include <jank/runtime/heap_snapshot.hpp>
+#include <jank/runtime/huge_pages.hpp>
 #include <jank/runtime/convert/builtin.hpp>
 
 #include <jank/compiler_native.hpp>
 #include <jank/perf_native.hpp>
+#include <jank/math_native.hpp>
+#include <jank/columnar_native.hpp>
+#include <jank/async_native.hpp>
+#include <jank/cache_native.hpp>
+#include <jank/binary_native.hpp>
+#include <jank/mapped_native.hpp>
+#include <jank/reload_native.hpp>
+#include <jank/io_async_native.hpp>
 #include <clojure/core_native.hpp>
 #include <clojure/string_native.hpp>
 
@@ -159,6 +173,10 @@ namespace jank
       }
     }
 
+    if(opts.output_target == util::cli::compilation_target::cpp && !opts.codegen_specified)
+    {
+      opts.codegen = util::cli::codegen_type::cpp;
+    }
     if(opts.output_target == util::cli::compilation_target::cpp
        && opts.codegen != util::cli::codegen_type::cpp)
     {
@@ -231,7 +249,25 @@ namespace jank
       std::make_pair(third_res_var, jank_nil()),
       std::make_pair(error_var, jank_nil())) };
 
-    /* TODO: Completion. */
+    le.setListCompleter([](llvm::StringRef const buffer, size_t const pos) {
+      /* The prefix is whatever has been typed of the symbol or keyword before the cursor. */
+      auto start(pos);
+      while(0 < start && !std::strchr(" \t\n,;()[]{}\"'`@~^", buffer[start - 1]))
+      {
+        --start;
+      }
+      jtl::immutable_string const prefix{ buffer.data() + start, pos - start };
+
+      std::vector<llvm::LineEditor::Completion> ret;
+      for(auto const &completion : __rt_ctx->current_ns()->completions(prefix, 100))
+      {
+        auto const &name(completion.first);
+        ret.emplace_back(std::string{ name.data() + prefix.size(), name.size() - prefix.size() },
+                         std::string{ name.data(), name.size() });
+      }
+      return ret;
+    });
+
     /* TODO: Syntax highlighting. */
     while(auto buf = le.readLine())
     {
@@ -346,6 +382,135 @@ namespace jank
     jank::aot::processor const aot_prc{};
     aot_prc.build_executable(opts.target_module).expect_ok();
   }
+
+  /* Runs the tests of each namespace with clojure.test, giving back the exit code. */
+  static int run_tests()
+  {
+    using namespace jank;
+    using namespace jank::runtime;
+
+    __rt_ctx->load_module("/clojure.core", module::origin::latest).expect_ok();
+    __rt_ctx->load_module("/clojure.test", module::origin::latest).expect_ok();
+
+    runtime::detail::native_transient_vector namespaces;
+    for(auto const &module : opts.test_modules)
+    {
+      __rt_ctx->load_module("/" + module, module::origin::latest).expect_ok();
+      namespaces.push_back(make_box<obj::symbol>(module));
+    }
+
+    auto const jobs_var{ __rt_ctx->find_var("clojure.test", "*test-jobs*") };
+    auto const run_tests_var{ __rt_ctx->find_var("clojure.test", "run-tests") };
+    auto const successful_var{ __rt_ctx->find_var("clojure.test", "successful?") };
+
+    context::binding_scope const scope{ obj::persistent_hash_map::create_unique(
+      std::make_pair(jobs_var, make_box(static_cast<i64>(opts.jobs)))) };
+
+    auto const summary(apply_to(run_tests_var->deref(),
+                                make_box<obj::persistent_vector>(namespaces.persistent())));
+    return truthy(dynamic_call(successful_var->deref(), summary)) ? 0 : 1;
+  }
+
+  /* Loads the module from its source, so that it goes through the whole compiler, and
+   * reports where the time and allocations went. Every phase is only charged for its own
+   * share, so the phases add up to the total, less whatever happened outside of them. */
+  static void bench_compile()
+  {
+    using namespace jank;
+    using namespace jank::runtime;
+
+    if(opts.target_module != "clojure.core")
+    {
+      __rt_ctx->load_module("/clojure.core", module::origin::latest).expect_ok();
+    }
+
+    profile::enable_phases();
+    auto const start{ profile::phase_now() };
+    __rt_ctx->load_module("/" + opts.target_module, module::origin::source).expect_ok();
+    auto const end{ profile::phase_now() };
+
+    auto const total_us{ (end.ns - start.ns) / 1000 };
+    auto const total_kb{ (end.bytes - start.bytes) / 1024 };
+    util::println("{}: {} us, {} KB allocated", opts.target_module, total_us, total_kb);
+
+    util::println("\nBy phase:");
+    auto const phases{ profile::phase_totals() };
+    i64 phases_ns{};
+    for(usize i{}; i < phases.size(); ++i)
+    {
+      auto const &p(phases[i]);
+      phases_ns += p.self_ns;
+      util::println("  {} us  {} KB  {} times  {}",
+                    p.self_ns / 1000,
+                    p.self_bytes / 1024,
+                    p.count,
+                    profile::phase_str(static_cast<profile::phase>(i)));
+    }
+    util::println("  {} us  other", std::max<i64>(end.ns - start.ns - phases_ns, 0) / 1000);
+
+    auto forms{ profile::form_totals() };
+    std::ranges::sort(forms, [](auto const &l, auto const &r) { return r.ns < l.ns; });
+    util::println("\nSlowest forms:");
+    for(usize i{}; i < std::min<usize>(20, forms.size()); ++i)
+    {
+      auto const &f(forms[i]);
+      util::println("  {} us  {} KB  {}", f.ns / 1000, f.bytes / 1024, f.label);
+    }
+  }
+
+  /* Everything but the marker count can be changed once the GC is running. */
+  static void save_image()
+  {
+    if(opts.save_image_file.empty())
+    {
+      return;
+    }
+
+    auto const res(__rt_ctx->module_loader.write_image(opts.save_image_file));
+    if(res.is_err())
+    {
+      error::report(res.expect_err());
+    }
+  }
+
+  static void configure_gc()
+  {
+    auto const &opts(util::cli::opts);
+    if(opts.gc_generational)
+    {
+      /* Incremental mode spreads each collection out over many small steps, which has a
+       * lot of overhead. Without a limit on how long each step can take, it's just
+       * generational, which is where the benefit is, since most of our boxes die young. */
+      GC_set_time_limit(GC_TIME_UNLIMITED);
+      GC_enable_incremental();
+    }
+    else if(opts.gc_incremental)
+    {
+      GC_enable_incremental();
+    }
+    if(opts.gc_full_freq)
+    {
+      GC_set_full_freq(static_cast<int>(opts.gc_full_freq));
+    }
+    if(opts.gc_free_space_divisor)
+    {
+      GC_set_free_space_divisor(opts.gc_free_space_divisor);
+    }
+    if(opts.gc_max_heap_size)
+    {
+      GC_set_max_heap_size(opts.gc_max_heap_size);
+    }
+    /* This goes before the initial heap is grown, so that's advised too. */
+    if(opts.gc_huge_pages && !runtime::enable_gc_huge_pages())
+    {
+      error::warn("Huge pages for the GC heap aren't supported on this platform.");
+    }
+    auto const heap_size{ GC_get_heap_size() };
+    if(opts.gc_initial_heap_size > heap_size)
+    {
+      GC_expand_hp(opts.gc_initial_heap_size - heap_size);
+    }
+  }
 }
 
 // NOLINTNEXTLINE(bugprone-exception-escape): This can only happen if we fail to report an error.
@@ -357,6 +522,10 @@ int main(int const argc, char const **argv)
   using namespace jank;
   using namespace jank::runtime;
 
+  /* This needs to be set before the GC is initialized, which is before we parse the rest
+   * of the args. 0 leaves it up to the GC, which also checks the GC_MARKERS env var. */
+  GC_set_markers_count(util::cli::parse_gc_markers(argc, argv));
+
   return jank_init(argc, argv, /*init_default_ctx=*/false, [](int const argc, char const **argv) {
     auto const parse_result(util::cli::parse_opts(argc, argv));
     if(parse_result.is_err())
@@ -364,10 +533,7 @@ int main(int const argc, char const **argv)
       return parse_result.expect_err();
     }
 
-    if(jank::util::cli::opts.gc_incremental)
-    {
-      GC_enable_incremental();
-    }
+    configure_gc();
 
     profile::configure();
     profile::timer const timer{ "main" };
@@ -376,12 +542,31 @@ int main(int const argc, char const **argv)
     {
       return jank::environment::check_health() ? 0 : 1;
     }
+    if(util::cli::opts.command == util::cli::command::heap_summary)
+    {
+      auto const res(runtime::heap_snapshot::read(util::cli::opts.target_file));
+      if(res.is_err())
+      {
+        util::println(stderr, "{}", res.expect_err());
+        return 1;
+      }
+      runtime::heap_snapshot::print(res.expect_ok(), 20);
+      return 0;
+    }
 
     __rt_ctx = new(GC) runtime::context{};
 
     jank_load_clojure_core_native();
     jank_load_jank_compiler_native();
     jank_load_jank_perf_native();
+    jank_load_jank_math_native();
+    jank_load_jank_columnar_native();
+    jank_load_jank_async_native();
+    jank_load_jank_cache_native();
+    jank_load_jank_binary_native();
+    jank_load_jank_mapped_native();
+    jank_load_jank_reload_native();
+    jank_load_jank_io_async_native();
 
 #ifdef JANK_PHASE_2
     jank_load_clojure_core();
@@ -390,10 +575,21 @@ int main(int const argc, char const **argv)
 
     Cpp::EnableDebugOutput(false);
 
+    if(!util::cli::opts.image_file.empty())
+    {
+      profile::timer const timer{ "read startup image" };
+      auto const res(__rt_ctx->module_loader.read_image(util::cli::opts.image_file));
+      if(res.is_err())
+      {
+        error::report(res.expect_err());
+      }
+    }
+
     switch(jank::util::cli::opts.command)
     {
       case util::cli::command::run:
         run();
+        save_image();
         break;
       case util::cli::command::compile_module:
         compile_module();
@@ -406,11 +602,18 @@ int main(int const argc, char const **argv)
         break;
       case util::cli::command::run_main:
         run_main();
+        save_image();
         break;
       case util::cli::command::compile:
         compile();
         break;
+      case util::cli::command::bench_compile:
+        bench_compile();
+        break;
+      case util::cli::command::test:
+        return run_tests();
       case util::cli::command::check_health:
+      case util::cli::command::heap_summary:
         break;
     }
     return 0;
@@ -0,0 +1,62 @@
+#include <jank/runtime/context.hpp>
+#include <jank/analyze/arena.hpp>
+#include <jank/analyze/processor.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::analyze
+{
+  using namespace jank::runtime;
+
+  static expression_ref analyze_one(processor &an_prc, jtl::immutable_string const &code)
+  {
+    return an_prc.analyze(__rt_ctx->read_string(code), expression_position::statement)
+      .expect_ok();
+  }
+
+  TEST_SUITE("analyze::node_arena")
+  {
+    TEST_CASE("Nodes come from the current arena")
+    {
+      processor an_prc;
+      auto const outside(analyze_one(an_prc, "(def arena-outside 1)"));
+      CHECK(node_arena::current() == nullptr);
+
+      {
+        node_arena const nodes;
+        CHECK(node_arena::current() == &nodes);
+
+        auto const inside(analyze_one(an_prc, "(def arena-inside (fn [a] [a 1]))"));
+        CHECK(nodes.owns(inside.data));
+        CHECK(!nodes.owns(inside->frame.data));
+        CHECK(!nodes.owns(outside.data));
+
+        /* The fn for the var is remembered across compilations, which needs to go before
+         * the arena frees it. */
+        auto const var(__rt_ctx->find_var("user", "arena-inside"));
+        REQUIRE(var.is_some());
+        CHECK(processor::var_values().rlock()->contains(var));
+        processor::forget_nodes(nodes);
+        CHECK(!processor::var_values().rlock()->contains(var));
+        CHECK(processor::var_values().rlock()->contains(
+          __rt_ctx->find_var("user", "arena-outside")));
+      }
+      CHECK(node_arena::current() == nullptr);
+
+      /* Analysis still works as normal after the arena is gone. */
+      CHECK(analyze_one(an_prc, "(fn [b] b)").data != nullptr);
+    }
+
+    TEST_CASE("Big nodes get their own chunk")
+    {
+      node_arena nodes;
+      auto const small(nodes.allocate(16));
+      auto const big(nodes.allocate(node_arena::chunk_size + 1));
+      CHECK(nodes.chunks.size() == 2);
+      CHECK(nodes.owns(small));
+      CHECK(nodes.owns(big));
+      CHECK(nodes.allocate(16) != big);
+    }
+  }
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core/seq.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/util/fmt.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+/* Helpers shared by the analysis tests. */
+namespace jank::analyze::test
+{
+  /* Analyzes code which is one form, without evaluating it. */
+  inline expression_ref analyze_one(jtl::immutable_string const &code)
+  {
+    auto const res(__rt_ctx->analyze_string(code, false));
+    REQUIRE_EQ(res.size(), 1);
+    return res[0];
+  }
+
+  /* Looks up a path, given as a vector of jank code, in the data of the analyzed code. */
+  inline runtime::object_ref
+  analyze_in(jtl::immutable_string const &code, jtl::immutable_string const &path)
+  {
+    return runtime::get_in(analyze_one(code)->to_runtime_data(),
+                           __rt_ctx->eval_string(path).unwrap());
+  }
+
+  /* A field of the first expression in the body of a top-level let. */
+  inline runtime::object_ref
+  body_field(jtl::immutable_string const &code, jtl::immutable_string const &field)
+  {
+    return analyze_in(code, util::format(R"(["body" "body" 0 "{}"])", field));
+  }
+
+  inline runtime::object_ref body_kind(jtl::immutable_string const &code)
+  {
+    return body_field(code, "kind");
+  }
+}
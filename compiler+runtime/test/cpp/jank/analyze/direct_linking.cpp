@@ -0,0 +1,75 @@
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core/seq.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/equal.hpp>
+#include <jank/util/cli.hpp>
+#include <jank/util/scope_exit.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::analyze
+{
+  using namespace jank::runtime;
+
+  TEST_SUITE("analyze::direct_linking")
+  {
+    TEST_CASE("Direct linked calls")
+    {
+      util::cli::opts.direct_linking = true;
+      util::scope_exit const finally{ [] { util::cli::opts.direct_linking = false; } };
+
+      SUBCASE("Static var")
+      {
+        __rt_ctx->eval_string("(defn direct-link-target [a] a)");
+        auto const res(__rt_ctx->analyze_string("(direct-link-target 1)", false));
+        CHECK_EQ(res.size(), 1);
+        CHECK(equal(runtime::get(res[0]->to_runtime_data(), make_box("is_direct_linked")),
+                    make_box(true)));
+      }
+
+      SUBCASE("Redefinition doesn't affect linked callers")
+      {
+        auto const old_codegen{ util::cli::opts.codegen };
+        util::scope_exit const restore{ [=] { util::cli::opts.codegen = old_codegen; } };
+
+        /* Both backends link while compiling the caller, rather than when it's first run. */
+        for(auto const codegen : { util::cli::codegen_type::cpp, util::cli::codegen_type::llvm_ir })
+        {
+          CAPTURE(util::cli::codegen_type_str(codegen));
+          util::cli::opts.codegen = codegen;
+          __rt_ctx->eval_string("(defn direct-link-a [] 1)");
+          __rt_ctx->eval_string("(defn direct-link-b [] (direct-link-a))");
+          __rt_ctx->eval_string("(defn direct-link-a [] 2)");
+          CHECK(equal(__rt_ctx->eval_string("(direct-link-b)").unwrap(), make_box(1)));
+        }
+      }
+
+      SUBCASE("^:redef opts out")
+      {
+        __rt_ctx->eval_string("(defn ^:redef direct-link-c [] 1)");
+        __rt_ctx->eval_string("(defn direct-link-d [] (direct-link-c))");
+        __rt_ctx->eval_string("(defn ^:redef direct-link-c [] 2)");
+        CHECK(equal(__rt_ctx->eval_string("(direct-link-d)").unwrap(), make_box(2)));
+      }
+
+      SUBCASE("Dynamic var")
+      {
+        __rt_ctx->eval_string("(defn ^:dynamic *direct-link-dynamic* [a] a)");
+        auto const res(__rt_ctx->analyze_string("(*direct-link-dynamic* 1)", false));
+        CHECK_EQ(res.size(), 1);
+        CHECK(equal(runtime::get(res[0]->to_runtime_data(), make_box("is_direct_linked")),
+                    make_box(false)));
+      }
+
+      SUBCASE("Variadic arity")
+      {
+        __rt_ctx->eval_string("(defn direct-link-variadic [a & args] args)");
+        auto const res(__rt_ctx->analyze_string("(direct-link-variadic 1 2)", false));
+        CHECK_EQ(res.size(), 1);
+        CHECK(equal(runtime::get(res[0]->to_runtime_data(), make_box("is_direct_linked")),
+                    make_box(false)));
+      }
+    }
+  }
+}
@@ -0,0 +1,71 @@
+#include <jank/runtime/core/equal.hpp>
+
+#include "common.hpp"
+
+namespace jank::analyze
+{
+  using namespace jank::runtime;
+
+  /* Whether the fn bound by the nth pair of the top-level let gets a stack context. */
+  static object_ref stack_context(jtl::immutable_string const &code, i64 const pair)
+  {
+    return test::analyze_in(code, util::format(R"(["pairs" {} 1 "has_stack_context"])", pair));
+  }
+
+  TEST_SUITE("analyze::escape_analysis")
+  {
+    TEST_CASE("Closures which don't escape")
+    {
+      CHECK(equal(stack_context("(let* [n 1 f (fn* [x] (+ x n))] (f 2))", 1), make_box(true)));
+      CHECK(equal(stack_context("(let* [n 1 f (fn* [] n)] [(f) (f)])", 1), make_box(true)));
+    }
+
+    TEST_CASE("Closures which escape")
+    {
+      SUBCASE("Returned")
+      {
+        CHECK(equal(stack_context("(let* [n 1 f (fn* [] n)] f)", 1), make_box(false)));
+      }
+
+      SUBCASE("Passed along")
+      {
+        CHECK(equal(stack_context("(let* [n 1 f (fn* [] n)] (vector f))", 1), make_box(false)));
+      }
+
+      SUBCASE("Captured")
+      {
+        auto const code("(let* [n 1 f (fn* [] n) g (fn* [] (f))] (g))");
+        CHECK(equal(stack_context(code, 1), make_box(false)));
+        CHECK(equal(stack_context(code, 2), make_box(true)));
+      }
+
+      SUBCASE("Named recursion")
+      {
+        CHECK(equal(stack_context("(let* [n 1 f (fn* self [] [n self])] (f))", 1),
+                    make_box(false)));
+      }
+
+      SUBCASE("Shadowed within the same let")
+      {
+        auto const code("(let* [n 1 f (fn* [] n) f (fn* [] n)] (vector f))");
+        CHECK(equal(stack_context(code, 1), make_box(false)));
+        CHECK(equal(stack_context(code, 2), make_box(false)));
+      }
+    }
+
+    TEST_CASE("Fns without captures have no context")
+    {
+      CHECK(equal(stack_context("(let* [f (fn* [] 1)] (f))", 0), make_box(false)));
+    }
+
+    TEST_CASE("Stack contexts within loops")
+    {
+      CHECK(equal(__rt_ctx
+                    ->eval_string(R"((loop* [i 0 acc []]
+                                       (let* [f (fn* [] i)]
+                                         (if (< i 3) (recur (inc i) (conj acc (f))) acc))))")
+                    .unwrap(),
+                  __rt_ctx->eval_string("[0 1 2]").unwrap()));
+    }
+  }
+}
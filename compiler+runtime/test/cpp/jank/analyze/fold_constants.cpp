@@ -0,0 +1,73 @@
+#include <jank/runtime/core/equal.hpp>
+#include <jank/util/cli.hpp>
+#include <jank/util/scope_exit.hpp>
+
+#include "common.hpp"
+
+namespace jank::analyze
+{
+  using namespace jank::runtime;
+
+  static object_ref analyze_field(jtl::immutable_string const &code,
+                                  jtl::immutable_string const &field)
+  {
+    return get(test::analyze_one(code)->to_runtime_data(), make_box(field));
+  }
+
+  static bool is_folded_to(jtl::immutable_string const &code, jtl::immutable_string const &value)
+  {
+    return equal(analyze_field(code, "kind"), make_box("primitive_literal"))
+      && equal(analyze_field(code, "data"), __rt_ctx->eval_string(value).unwrap());
+  }
+
+  TEST_SUITE("analyze::fold_constants")
+  {
+    TEST_CASE("Literal maps")
+    {
+      CHECK(is_folded_to("{:a 1 :b [2 3]}", "{:a 1 :b [2 3]}"));
+      CHECK(equal(analyze_field("(let* [a 1] {:a a})", "kind"), make_box("let")));
+    }
+
+    TEST_CASE("Folding")
+    {
+      util::cli::opts.fold_constants = true;
+      util::scope_exit const finally{ [] { util::cli::opts.fold_constants = false; } };
+
+      SUBCASE("Arithmetic")
+      {
+        CHECK(is_folded_to("(+ 1 2)", "3"));
+        CHECK(is_folded_to("(* (inc 2) (- 10 4))", "18"));
+        CHECK(is_folded_to("(/ 1 3)", "1/3"));
+      }
+
+      SUBCASE("Nested in collections")
+      {
+        CHECK(is_folded_to("[1 (+ 1 1) {:a (str \"a\" :b)}]", "[1 2 {:a \"a:b\"}]"));
+        CHECK(is_folded_to("(get {:port 80 :host \"x\"} :port)", "80"));
+        CHECK(is_folded_to("(count [1 2 3])", "3"));
+        CHECK(is_folded_to("(keyword \"a\" \"b\")", ":a/b"));
+      }
+
+      SUBCASE("if")
+      {
+        CHECK(is_folded_to("(if (= 1 1) :yes :no)", ":yes"));
+        CHECK(is_folded_to("(if nil :yes)", "nil"));
+      }
+
+      SUBCASE("Not folded")
+      {
+        /* Throws, so it's left to throw at runtime. */
+        CHECK(equal(analyze_field("(/ 1 0)", "kind"), make_box("call")));
+        /* Not pure. */
+        CHECK(equal(analyze_field("(println 1)", "kind"), make_box("call")));
+        CHECK(equal(analyze_field("(let* [a 1] (+ a 2))", "kind"), make_box("let")));
+      }
+    }
+
+    TEST_CASE("Disabled")
+    {
+      CHECK(equal(analyze_field("(+ 1 2)", "kind"), make_box("call")));
+      CHECK(equal(analyze_field("(if true 1 2)", "kind"), make_box("if_")));
+    }
+  }
+}
@@ -0,0 +1,49 @@
+#include <jank/runtime/core/equal.hpp>
+
+#include "common.hpp"
+
+namespace jank::analyze
+{
+  using namespace jank::runtime;
+
+  using test::body_kind;
+
+  TEST_SUITE("analyze::inline")
+  {
+    TEST_CASE("C++ inliners")
+    {
+      SUBCASE("Matching arity")
+      {
+        CHECK(equal(body_kind("(let* [a [1 2]] (first a))"), make_box("cpp_call")));
+        CHECK(equal(body_kind("(let* [a {}] (get a :k 0))"), make_box("cpp_call")));
+      }
+
+      SUBCASE("Other arities are normal calls")
+      {
+        CHECK(equal(body_kind("(let* [a []] (conj a 1 2))"), make_box("call")));
+      }
+
+      SUBCASE("Results are unchanged")
+      {
+        CHECK(equal(__rt_ctx->eval_string("(let* [a [1 2]] [(first a) (count a) (nil? a)])")
+                      .unwrap(),
+                    __rt_ctx->eval_string("[1 2 false]").unwrap()));
+      }
+    }
+
+    TEST_CASE("definline")
+    {
+      __rt_ctx->eval_string("(definline jank-test-inline-one [x] 1)").unwrap();
+      CHECK(equal(body_kind("(let* [a 2] (jank-test-inline-one a))"),
+                  make_box("primitive_literal")));
+      CHECK(equal(__rt_ctx->eval_string("(map jank-test-inline-one [5])").unwrap(),
+                  __rt_ctx->eval_string("[1]").unwrap()));
+    }
+
+    TEST_CASE("Redefinable vars aren't inlined")
+    {
+      __rt_ctx->eval_string("(definline ^:redef jank-test-inline-redef [x] 1)").unwrap();
+      CHECK(equal(body_kind("(let* [a 2] (jank-test-inline-redef a))"), make_box("call")));
+    }
+  }
+}
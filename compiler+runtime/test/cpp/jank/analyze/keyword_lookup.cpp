@@ -0,0 +1,65 @@
+#include <jank/runtime/core/equal.hpp>
+
+#include "common.hpp"
+
+namespace jank::analyze
+{
+  using namespace jank::runtime;
+
+  static object_ref eval_string(jtl::immutable_string const &code)
+  {
+    return __rt_ctx->eval_string(code).unwrap();
+  }
+
+  static object_ref is_keyword_lookup(jtl::immutable_string const &code)
+  {
+    return test::body_field(code, "is_keyword_lookup");
+  }
+
+  TEST_SUITE("analyze::keyword_lookup")
+  {
+    TEST_CASE("Lookups")
+    {
+      CHECK(equal(is_keyword_lookup("(let* [m {}] (:a m))"), make_box(true)));
+      CHECK(equal(is_keyword_lookup("(let* [m {}] (:a m 1))"), make_box(true)));
+      CHECK(equal(is_keyword_lookup("(let* [m {}] (m :a))"), make_box(true)));
+      CHECK(equal(is_keyword_lookup("(let* [m {}] (m :a 1))"), make_box(true)));
+    }
+
+    TEST_CASE("Other calls")
+    {
+      CHECK(equal(is_keyword_lookup("(let* [m {}] (:a))"), make_box(false)));
+      CHECK(equal(is_keyword_lookup("(let* [m {}] (:a m 1 2))"), make_box(false)));
+      CHECK(equal(is_keyword_lookup("(let* [m {}] (m 'a))"), make_box(false)));
+      CHECK(equal(is_keyword_lookup("(let* [m {}] (str :a))"), make_box(false)));
+    }
+
+    TEST_CASE("Maps of different shapes at the same site")
+    {
+      eval_string("(defn keyword-lookup-all [m] [(:a m) (:b m :none) (m :a) (m :c :none)])");
+      eval_string("(def keyword-lookup-basis (create-struct :b :a))");
+
+      CHECK(equal(eval_string("(keyword-lookup-all {:a 1 :b 2})"),
+                  eval_string("[1 2 1 :none]")));
+      CHECK(equal(eval_string("(keyword-lookup-all {:a 1 :b 2})"),
+                  eval_string("[1 2 1 :none]")));
+      CHECK(equal(eval_string("(keyword-lookup-all {:b 3 :a 4 :c 5})"),
+                  eval_string("[4 3 4 5]")));
+      CHECK(equal(eval_string("(keyword-lookup-all {:a 6})"), eval_string("[6 :none 6 :none]")));
+      CHECK(equal(eval_string("(keyword-lookup-all (struct keyword-lookup-basis 7 8))"),
+                  eval_string("[8 7 8 :none]")));
+      CHECK(equal(eval_string("(keyword-lookup-all (struct-map keyword-lookup-basis :c 9))"),
+                  eval_string("[nil nil nil 9]")));
+      CHECK(equal(eval_string("(keyword-lookup-all (zipmap (range 20) (range 20)))"),
+                  eval_string("[nil :none nil :none]")));
+    }
+
+    TEST_CASE("Non-maps")
+    {
+      eval_string("(defn keyword-lookup-call [m] (m :a))");
+      CHECK(equal(eval_string("(keyword-lookup-call identity)"), eval_string(":a")));
+      CHECK(equal(eval_string("(keyword-lookup-call #{:a})"), eval_string(":a")));
+      CHECK(equal(eval_string("(:a nil)"), eval_string("nil")));
+    }
+  }
+}
@@ -0,0 +1,77 @@
+#include <jank/analyze/pass/walk.hpp>
+#include <jank/analyze/rtti.hpp>
+#include <jank/analyze/expr/function.hpp>
+
+#include "common.hpp"
+
+namespace jank::analyze
+{
+  using namespace jank::runtime;
+
+  /* Whether each variadic arity in the code, in walk order, can have its rest args packed
+   * on the caller's stack. */
+  static native_vector<bool> local_rest_args(jtl::immutable_string const &code)
+  {
+    native_vector<bool> ret;
+    pass::prewalk(test::analyze_one(code), [&](expression_ref const e) {
+      if(auto const fn = llvm::dyn_cast<expr::function>(e.data))
+      {
+        for(auto const &arity : fn->arities)
+        {
+          if(arity.fn_ctx->is_variadic)
+          {
+            ret.emplace_back(arity.fn_ctx->has_local_rest);
+          }
+        }
+      }
+    });
+    return ret;
+  }
+
+  TEST_SUITE("analyze::local_rest_args")
+  {
+    TEST_CASE("Rest args which are only read")
+    {
+      CHECK_EQ(local_rest_args("(fn* [& r] (first r))"), native_vector<bool>{ true });
+      CHECK_EQ(local_rest_args("(fn* [a & r] (if (empty? r) a (count r)))"),
+               native_vector<bool>{ true });
+      CHECK_EQ(local_rest_args("(fn* [& r] (let* [n (next r)] (if n (first n) 0)))"),
+               native_vector<bool>{ true });
+      CHECK_EQ(local_rest_args("(fn* [x & r] (if r (recur (+ x (first r)) (next r)) x))"),
+               native_vector<bool>{ true });
+      CHECK_EQ(
+        local_rest_args("(fn* [& r] (loop* [s r n 0] (if s (recur (next s) (inc n)) n)))"),
+        native_vector<bool>{ true });
+    }
+
+    TEST_CASE("Rest args which escape")
+    {
+      SUBCASE("Returned")
+      {
+        CHECK_EQ(local_rest_args("(fn* [& r] r)"), native_vector<bool>{ false });
+        CHECK_EQ(local_rest_args("(fn* [& r] (next r))"), native_vector<bool>{ false });
+        CHECK_EQ(local_rest_args("(fn* [a & r] (if a r nil))"), native_vector<bool>{ false });
+      }
+
+      SUBCASE("Passed along")
+      {
+        CHECK_EQ(local_rest_args("(fn* [& r] (vector r))"), native_vector<bool>{ false });
+        CHECK_EQ(local_rest_args("(fn* [f & r] (apply f r))"), native_vector<bool>{ false });
+      }
+
+      SUBCASE("Through a local")
+      {
+        CHECK_EQ(local_rest_args("(fn* [& r] (let* [s (rest r)] [s]))"),
+                 native_vector<bool>{ false });
+        CHECK_EQ(local_rest_args("(fn* [& r] (loop* [s r] (if (first s) (recur (next s)) s)))"),
+                 native_vector<bool>{ false });
+      }
+
+      SUBCASE("Captured")
+      {
+        CHECK_EQ(local_rest_args("(fn* [& r] (fn* [] (first r)))"),
+                 native_vector<bool>{ false });
+      }
+    }
+  }
+}
@@ -0,0 +1,58 @@
+#include <jank/runtime/core/equal.hpp>
+
+#include "common.hpp"
+
+namespace jank::analyze
+{
+  using namespace jank::runtime;
+
+  using test::body_kind;
+
+  TEST_SUITE("analyze::native_arithmetic")
+  {
+    TEST_CASE("Native inputs")
+    {
+      SUBCASE("Integer")
+      {
+        CHECK(equal(body_kind("(let* [a (cpp/long 1)] (+ a a))"),
+                    make_box("cpp_builtin_operator_call")));
+      }
+
+      SUBCASE("Mixed with a literal")
+      {
+        CHECK(equal(body_kind("(let* [a (cpp/double 1.0)] (* a 2))"),
+                    make_box("cpp_builtin_operator_call")));
+      }
+
+      SUBCASE("Comparison")
+      {
+        CHECK(equal(body_kind("(let* [a (cpp/long 1)] (< a 2))"),
+                    make_box("cpp_builtin_operator_call")));
+      }
+
+      SUBCASE("Unary")
+      {
+        CHECK(equal(body_kind("(let* [a (cpp/long 1)] (inc a))"),
+                    make_box("cpp_builtin_operator_call")));
+      }
+    }
+
+    TEST_CASE("Boxed inputs")
+    {
+      SUBCASE("Only literals")
+      {
+        CHECK(equal(body_kind("(let* [a 1] (+ a 2))"), make_box("call")));
+      }
+
+      SUBCASE("Integer division")
+      {
+        CHECK(equal(body_kind("(let* [a (cpp/long 1)] (/ a 2))"), make_box("call")));
+      }
+
+      SUBCASE("Non-number")
+      {
+        CHECK(equal(body_kind("(let* [a (cpp/long 1)] (+ a :b))"), make_box("call")));
+      }
+    }
+  }
+}
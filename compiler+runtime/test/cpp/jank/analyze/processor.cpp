@@ -0,0 +1,99 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <gc/gc.h>
+
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/executor.hpp>
+#include <jank/analyze/processor.hpp>
+#include <jank/analyze/local_frame.hpp>
+#include <jank/analyze/expr/function.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::analyze
+{
+  using namespace jank::runtime;
+
+  TEST_SUITE("analyze::processor")
+  {
+    TEST_CASE("Special forms are shared")
+    {
+      CHECK(processor::is_special(make_box<obj::symbol>("fn*")));
+      CHECK(processor::is_special(make_box<obj::symbol>("catch")));
+      CHECK(!processor::is_special(make_box<obj::symbol>("map")));
+      CHECK(!processor::is_special(make_box(1)));
+    }
+
+    TEST_CASE("Locals are resolved through nested frames")
+    {
+      auto const x{ make_box<obj::symbol>("x") };
+      auto const y{ make_box<obj::symbol>("y") };
+      auto const root{ jtl::make_ref<local_frame>(local_frame::frame_type::root, none) };
+      root->add_local(x, local_binding{ x, x->name, none, root });
+
+      local_frame_ptr frame{ root };
+      for(usize i{}; i < 100; ++i)
+      {
+        frame = jtl::make_ref<local_frame>(local_frame::frame_type::let, frame);
+      }
+      auto const fn{ jtl::make_ref<local_frame>(local_frame::frame_type::fn, frame) };
+      auto const inner{ jtl::make_ref<local_frame>(local_frame::frame_type::let, fn) };
+      inner->add_local(y, local_binding{ y, y->name, none, inner });
+
+      auto const found_x(inner->find_local_or_capture(x));
+      REQUIRE(found_x.is_some());
+      CHECK(found_x.unwrap().binding == &root->locals.find(x)->second);
+      REQUIRE(found_x.unwrap().crossed_fns.size() == 1);
+      CHECK(found_x.unwrap().crossed_fns[0] == fn);
+      CHECK(inner->find_local_or_capture(y).unwrap().crossed_fns.empty());
+      CHECK(inner->find_local_or_capture(make_box<obj::symbol>("z")).is_none());
+      CHECK(&local_frame::find_closest_fn_frame(*inner) == fn.data);
+
+      /* Once it's captured, the capture is found instead, without crossing the fn. */
+      local_frame::register_captures(found_x.unwrap());
+      auto const captured(inner->find_local_or_capture(x));
+      REQUIRE(captured.is_some());
+      CHECK(captured.unwrap().binding == &fn->captures.find(x)->second);
+      CHECK(captured.unwrap().crossed_fns.empty());
+      CHECK(inner->find_originating_local(x).unwrap().binding == &root->locals.find(x)->second);
+    }
+
+    TEST_CASE("Analyzing on many threads at once")
+    {
+      static constexpr usize thread_count{ 4 };
+      static constexpr usize forms{ 200 };
+
+      /* Each thread has its own processor, but they all resolve the same vars. */
+      auto const form(__rt_ctx->read_string("(fn* [x] (let* [y (inc x)] (if (pos? y) y x)))"));
+
+      GC_allow_register_threads();
+      std::atomic<usize> failures{};
+      std::vector<std::thread> threads;
+      for(usize i{}; i < thread_count; ++i)
+      {
+        threads.emplace_back([&] {
+          gc_thread_scope const scope;
+          for(usize n{}; n < forms; ++n)
+          {
+            processor an_prc;
+            auto const res(an_prc.analyze(form, expression_position::value));
+            if(res.is_err() || res.expect_ok()->kind != expression_kind::function)
+            {
+              ++failures;
+            }
+          }
+        });
+      }
+
+      for(auto &t : threads)
+      {
+        t.join();
+      }
+
+      CHECK(failures.load() == 0);
+    }
+  }
+}
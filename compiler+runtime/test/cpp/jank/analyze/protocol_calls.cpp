@@ -0,0 +1,77 @@
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core/seq.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/equal.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::analyze
+{
+  using namespace jank::runtime;
+
+  TEST_SUITE("analyze::protocol_calls")
+  {
+    TEST_CASE("Protocol calls")
+    {
+      __rt_ctx->eval_string("(defprotocol ProtocolCallShape (protocol-call-area [s]))");
+
+      SUBCASE("Static var")
+      {
+        auto const res(__rt_ctx->analyze_string("(protocol-call-area 1)", false));
+        CHECK_EQ(res.size(), 1);
+        CHECK(equal(runtime::get(res[0]->to_runtime_data(), make_box("is_protocol_call")),
+                    make_box(true)));
+      }
+
+      SUBCASE("Plain fn")
+      {
+        __rt_ctx->eval_string("(defn protocol-call-plain [a] a)");
+        auto const res(__rt_ctx->analyze_string("(protocol-call-plain 1)", false));
+        CHECK_EQ(res.size(), 1);
+        CHECK(equal(runtime::get(res[0]->to_runtime_data(), make_box("is_protocol_call")),
+                    make_box(false)));
+      }
+
+      SUBCASE("Extending after the cache is filled")
+      {
+        __rt_ctx->eval_string(R"((extend-protocol ProtocolCallShape
+                                   "integer" (protocol-call-area [s] (* s s))
+                                   :default (protocol-call-area [s] :none)))");
+        __rt_ctx->eval_string("(defn protocol-call-caller [s] (protocol-call-area s))");
+        CHECK(equal(__rt_ctx->eval_string("(protocol-call-caller 3)").unwrap(), make_box(9)));
+        CHECK(equal(__rt_ctx->eval_string("(protocol-call-caller \"a\")").unwrap(),
+                    __rt_ctx->intern_keyword("none").expect_ok()));
+
+        __rt_ctx->eval_string(R"((extend-protocol ProtocolCallShape
+                                   "integer" (protocol-call-area [s] (+ s s))))");
+        CHECK(equal(__rt_ctx->eval_string("(protocol-call-caller 3)").unwrap(), make_box(6)));
+      }
+
+      SUBCASE("Megamorphic call sites")
+      {
+        __rt_ctx->eval_string(R"((extend-protocol ProtocolCallShape
+                                   :default (protocol-call-area [s] (count (str s)))))");
+        __rt_ctx->eval_string("(defn protocol-call-many [s] (protocol-call-area s))");
+        CHECK(equal(__rt_ctx->eval_string(R"((mapv protocol-call-many
+                                                  [:a "bb" [1] 'ccc {} #{} 1.5 nil]))")
+                      .unwrap(),
+                    __rt_ctx->eval_string("[2 2 3 3 2 3 3 0]").unwrap()));
+      }
+
+      SUBCASE("Redefining the var")
+      {
+        __rt_ctx->eval_string("(defprotocol ProtocolCallRedef (protocol-call-redef [s]))");
+        __rt_ctx->eval_string(R"((extend-type :default
+                                   ProtocolCallRedef
+                                   (protocol-call-redef [s] 1)))");
+        __rt_ctx->eval_string("(defn protocol-call-redef-caller [s] (protocol-call-redef s))");
+        CHECK(equal(__rt_ctx->eval_string("(protocol-call-redef-caller 0)").unwrap(),
+                    make_box(1)));
+        __rt_ctx->eval_string("(defn protocol-call-redef [s] 2)");
+        CHECK(equal(__rt_ctx->eval_string("(protocol-call-redef-caller 0)").unwrap(),
+                    make_box(2)));
+      }
+    }
+  }
+}
@@ -0,0 +1,66 @@
+#include <jank/analyze/pass/walk.hpp>
+#include <jank/analyze/rtti.hpp>
+#include <jank/analyze/expr/named_recursion.hpp>
+#include <jank/analyze/expr/recur.hpp>
+
+#include "common.hpp"
+
+namespace jank::analyze
+{
+  using namespace jank::runtime;
+
+  /* Whether each recur or named recursion in the code, in walk order, is a self tail call. */
+  static native_vector<bool> self_tail_calls(jtl::immutable_string const &code)
+  {
+    native_vector<bool> ret;
+    pass::prewalk(test::analyze_one(code), [&](expression_ref const e) {
+      if(auto const named = llvm::dyn_cast<expr::named_recursion>(e.data))
+      {
+        ret.emplace_back(named->is_self_tail_call);
+      }
+      else if(auto const recur = llvm::dyn_cast<expr::recur>(e.data))
+      {
+        ret.emplace_back(recur->is_self_tail_call);
+      }
+    });
+    return ret;
+  }
+
+  TEST_SUITE("analyze::self_tail_calls")
+  {
+    TEST_CASE("Tail calls into the same arity")
+    {
+      CHECK_EQ(self_tail_calls("(fn* f [n] (if (zero? n) n (f (dec n))))"),
+               native_vector<bool>{ true });
+      CHECK_EQ(self_tail_calls("(fn* [n] (if (zero? n) n (recur (dec n))))"),
+               native_vector<bool>{ true });
+      CHECK_EQ(self_tail_calls("(fn* f [a & r] (if a (f nil r) r))"),
+               native_vector<bool>{ false });
+    }
+
+    TEST_CASE("Calls which aren't self tail calls")
+    {
+      SUBCASE("Not in tail position")
+      {
+        CHECK_EQ(self_tail_calls("(fn* f [n] (if (zero? n) 1 (* n (f (dec n)))))"),
+                 native_vector<bool>{ false });
+      }
+
+      SUBCASE("Another arity")
+      {
+        CHECK_EQ(self_tail_calls("(fn* f ([] (f 1)) ([n] n))"), native_vector<bool>{ false });
+      }
+
+      SUBCASE("Across a fn")
+      {
+        CHECK_EQ(self_tail_calls("(fn* f [n] (fn* [] (f n)))"), native_vector<bool>{ false });
+      }
+
+      SUBCASE("Within a try")
+      {
+        CHECK_EQ(self_tail_calls("(fn* f [n] (try (f n) (catch e e)))"),
+                 native_vector<bool>{ false });
+      }
+    }
+  }
+}
@@ -0,0 +1,69 @@
+#include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
+#include <llvm/IR/DebugInfoMetadata.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Verifier.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
+#include <jank/runtime/var.hpp>
+#include <jank/analyze/processor.hpp>
+#include <jank/analyze/expr/function.hpp>
+#include <jank/codegen/llvm_processor.hpp>
+#include <jank/util/cli.hpp>
+#include <jank/util/scope_exit.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::codegen
+{
+  using namespace jank::runtime;
+
+  TEST_SUITE("codegen::llvm_processor")
+  {
+    TEST_CASE("Debug info points calls at their jank lines")
+    {
+      util::cli::opts.debug = true;
+      util::scope_exit const finally{ [] { util::cli::opts.debug = false; } };
+
+      context::binding_scope const file{ obj::persistent_hash_map::create_unique(
+        std::make_pair(__rt_ctx->current_file_var, make_box("debug_info.jank"))) };
+      analyze::processor an_prc;
+      auto const expr(an_prc
+                        .analyze(__rt_ctx->read_string("(fn* [a]\n  (str a\n       (str a)))"),
+                                 analyze::expression_position::value)
+                        .expect_ok());
+      REQUIRE(expr->kind == analyze::expression_kind::function);
+
+      llvm_processor const cg_prc{ jtl::static_ref_cast<analyze::expr::function>(expr),
+                                   "jank.test.llvm-codegen",
+                                   compilation_target::eval };
+      cg_prc.gen().expect_ok();
+
+      auto const &module(*cg_prc.get_module().getModuleUnlocked());
+      CHECK(!llvm::verifyModule(module, &llvm::errs()));
+
+      native_set<unsigned> lines;
+      for(auto const &fn : module)
+      {
+        if(!fn.getSubprogram())
+        {
+          continue;
+        }
+        CHECK(fn.getSubprogram()->getFilename() == "debug_info.jank");
+        for(auto const &block : fn)
+        {
+          for(auto const &inst : block)
+          {
+            REQUIRE(inst.getDebugLoc());
+            lines.insert(inst.getDebugLoc().getLine());
+          }
+        }
+      }
+      CHECK(lines.contains(2));
+      CHECK(lines.contains(3));
+    }
+  }
+}
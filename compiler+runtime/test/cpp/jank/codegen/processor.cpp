@@ -0,0 +1,49 @@
+#include <string_view>
+
+#include <jank/runtime/context.hpp>
+#include <jank/analyze/processor.hpp>
+#include <jank/analyze/expr/function.hpp>
+#include <jank/codegen/processor.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::codegen
+{
+  using namespace jank::runtime;
+
+  static jtl::immutable_string gen_declaration(jtl::immutable_string const &code)
+  {
+    analyze::processor an_prc;
+    auto const expr(
+      an_prc.analyze(__rt_ctx->read_string(code), analyze::expression_position::value)
+        .expect_ok());
+    REQUIRE(expr->kind == analyze::expression_kind::function);
+    processor cg_prc{ jtl::static_ref_cast<analyze::expr::function>(expr),
+                      "jank.test.codegen",
+                      compilation_target::eval };
+    return cg_prc.declaration_str();
+  }
+
+  static usize count(jtl::immutable_string const &s, std::string_view const needle)
+  {
+    std::string_view const haystack{ s.data(), s.size() };
+    usize ret{};
+    for(auto pos(haystack.find(needle)); pos != std::string_view::npos;
+        pos = haystack.find(needle, pos + needle.size()))
+    {
+      ++ret;
+    }
+    return ret;
+  }
+
+  TEST_SUITE("codegen::processor")
+  {
+    TEST_CASE("Nested fns share lifted constants")
+    {
+      auto const code(gen_declaration(
+        "(fn* [] [(fn* [] :jank-test-status) (fn* [] :jank-test-status) :jank-test-status])"));
+      CHECK(count(code, R"(intern_keyword("", "jank-test-status")") == 1);
+    }
+  }
+}
@@ -0,0 +1,144 @@
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/equal.hpp>
+#include <jank/runtime/obj/jit_closure.hpp>
+#include <jank/runtime/obj/jit_function.hpp>
+#include <jank/runtime/rtti.hpp>
+#include <jank/util/cli.hpp>
+#include <jank/util/scope_exit.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::evaluate
+{
+  using namespace jank::runtime;
+
+  static object_ref eval_string(jtl::immutable_string const &code)
+  {
+    return __rt_ctx->eval_string(code).unwrap();
+  }
+
+  TEST_SUITE("evaluate")
+  {
+    TEST_CASE("Interpreter")
+    {
+      static constexpr u32 threshold{ 10 };
+
+      auto const old_threshold{ util::cli::opts.jit_threshold };
+      util::cli::opts.interpret = true;
+      util::cli::opts.jit_threshold = threshold;
+      util::scope_exit const finally{ [=] {
+        util::cli::opts.interpret = false;
+        util::cli::opts.jit_threshold = old_threshold;
+      } };
+
+      SUBCASE("Fns are interpreted")
+      {
+        eval_string("(defn interpret-add [a b] (+ a b))");
+        CHECK(eval_string("interpret-add")->type == object_type::jit_closure);
+        CHECK(equal(eval_string("(interpret-add 1 2)"), make_box(3)));
+      }
+
+      SUBCASE("Locals, closures, and shadowing")
+      {
+        CHECK(equal(eval_string("(let [a 1 b (+ a 1) a (* b 10)] [a b])"),
+                    eval_string("[20 2]")));
+        CHECK(equal(eval_string("(let [a 1 f (fn [] a) a 2] [(f) a])"), eval_string("[1 2]")));
+        eval_string("(defn interpret-adder [n] (fn [x] (+ x n)))");
+        CHECK(equal(eval_string("((interpret-adder 5) 10)"), make_box(15)));
+      }
+
+      SUBCASE("Variadic and multi-arity fns")
+      {
+        eval_string("(defn interpret-arities ([] :none) ([a] [a]) ([a b & more] [a b more]))");
+        CHECK(equal(eval_string("(interpret-arities)"), eval_string(":none")));
+        CHECK(equal(eval_string("(interpret-arities 1)"), eval_string("[1]")));
+        CHECK(equal(eval_string("(interpret-arities 1 2)"), eval_string("[1 2 nil]")));
+        CHECK(equal(eval_string("(interpret-arities 1 2 3 4)"), eval_string("[1 2 (3 4)]")));
+        CHECK(equal(eval_string("(apply interpret-arities (range 12))"),
+                    eval_string("[0 1 (2 3 4 5 6 7 8 9 10 11)]")));
+      }
+
+      SUBCASE("loop, recur, and named recursion")
+      {
+        CHECK(equal(eval_string(R"((loop [i 0 acc []]
+                                     (if (< i 3) (recur (inc i) (conj acc i)) acc)))"),
+                    eval_string("[0 1 2]")));
+        eval_string("(defn interpret-count-down [n] (if (pos? n) (recur (dec n)) :done))");
+        CHECK(equal(eval_string("(interpret-count-down 10000)"), eval_string(":done")));
+        eval_string("(def interpret-fact (fn fact [n] (if (< n 2) 1 (* n (fact (dec n))))))");
+        CHECK(equal(eval_string("(interpret-fact 5)"), make_box(120)));
+        CHECK(eval_string("((fn self [] self))")->type == object_type::jit_closure);
+        /* Closures made on each iteration see that iteration's locals. */
+        CHECK(equal(eval_string(R"((loop [i 0 fs []]
+                                     (if (< i 3)
+                                       (recur (inc i) (conj fs (fn [] i)))
+                                       (mapv #(%) fs))))"),
+                    eval_string("[0 1 2]")));
+      }
+
+      SUBCASE("letfn")
+      {
+        CHECK(equal(eval_string(R"((letfn [(ev? [n] (if (zero? n) true (od? (dec n))))
+                                           (od? [n] (if (zero? n) false (ev? (dec n))))]
+                                     [(ev? 10) (od? 7)]))"),
+                    eval_string("[true true]")));
+      }
+
+      SUBCASE("try and case")
+      {
+        CHECK(equal(eval_string("(let [x :oops] (try (throw x) (catch e [e x])))"),
+                    eval_string("[:oops :oops]")));
+        eval_string("(def interpret-finally (atom 0))");
+        eval_string("(let [n 5] (try n (finally (reset! interpret-finally n))))");
+        CHECK(equal(eval_string("@interpret-finally"), make_box(5)));
+        eval_string("(defn interpret-case [x] (case x 1 :one :two :kw (a b) :sym :default))");
+        CHECK(equal(eval_string("(interpret-case 1)"), eval_string(":one")));
+        CHECK(equal(eval_string("(interpret-case :two)"), eval_string(":kw")));
+        CHECK(equal(eval_string("(interpret-case 'b)"), eval_string(":sym")));
+        CHECK(equal(eval_string("(interpret-case 3)"), eval_string(":default")));
+      }
+
+      SUBCASE("Hot fns are JIT compiled")
+      {
+        eval_string("(defn interpret-hot [a] (* a 2))");
+        for(u32 i{}; i < threshold * 2; ++i)
+        {
+          CHECK(equal(eval_string("(interpret-hot 21)"), make_box(42)));
+        }
+      }
+
+      SUBCASE("Fns which can't be interpreted are JIT compiled")
+      {
+        eval_string("(defn interpret-interop [] (cpp/int 1))");
+        CHECK(eval_string("interpret-interop")->type == object_type::jit_function);
+        eval_string("(defn ^:jit interpret-hinted [] 1)");
+        CHECK(eval_string("interpret-hinted")->type == object_type::jit_function);
+        CHECK(equal(eval_string("(interpret-hinted)"), make_box(1)));
+      }
+    }
+
+    TEST_CASE("Batch JIT")
+    {
+      util::cli::opts.batch_jit = true;
+      util::scope_exit const finally{ [] { util::cli::opts.batch_jit = false; } };
+
+      auto const res(__rt_ctx->eval_string(R"(
+        (defn batch-double [x] (* x 2))
+        (defn- batch-quadruple [x] (batch-double (batch-double x)))
+        (def batch-value (batch-quadruple 2))
+        (defn batch-helper [x] (* x 10))
+        (defmacro batch-macro [x] (batch-helper x))
+        (defmacro batch-later-macro [x] (batch-later-helper x))
+        (defn batch-later-helper [x] (* x 100))
+        (defn batch-uses-macros [] [(batch-macro 1) (batch-later-macro 1)])
+        batch-value)",
+                                           true));
+      CHECK(equal(res.unwrap(), make_box(8)));
+      CHECK(equal(eval_string("(batch-uses-macros)"), eval_string("[10 100]")));
+      CHECK(equal(eval_string("(batch-quadruple 3)"), make_box(12)));
+    }
+  }
+}
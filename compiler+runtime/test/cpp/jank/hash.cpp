@@ -0,0 +1,65 @@
+#include <string>
+
+#include <jank/hash.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/obj/persistent_vector.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::hash
+{
+  /* The plain, one block at a time, murmur3 which our string hashing must match. */
+  static u32 reference_string(std::string const &input)
+  {
+    auto const length(input.size());
+    u32 h1{};
+    for(usize i{ 1 }; i < length; i += 2)
+    {
+      h1 = mix_h1(h1, mix_k1(static_cast<u32>(input[i - 1] | (input[i] << 16))));
+    }
+    if((length & 1) == 1)
+    {
+      h1 ^= mix_k1(static_cast<u32>(static_cast<u8>(input[length - 1])));
+    }
+    return fmix(h1, 2 * length);
+  }
+
+  TEST_SUITE("hash")
+  {
+    TEST_CASE("Strings")
+    {
+      std::string data;
+      for(usize length{}; length < 40; ++length)
+      {
+        CHECK_EQ(string(jtl::immutable_string_view{ data.data(), data.size() }),
+                 reference_string(data));
+        data.push_back(static_cast<char>(0x41 + (length * 13) % 60));
+      }
+    }
+
+    TEST_CASE("Ordered collections")
+    {
+      using namespace runtime;
+
+      for(i64 length{}; length < 11; ++length)
+      {
+        native_vector<object_ref> items;
+        obj::persistent_vector::value_type data;
+        u32 expected{ 1 };
+        for(i64 i{}; i < length; ++i)
+        {
+          items.emplace_back(make_box(i * 7));
+          data = data.push_back(items.back());
+          expected = (31 * expected) + visit(items.back());
+        }
+        expected = mix_collection_hash(expected, static_cast<u32>(length));
+
+        CHECK_EQ(ordered(items.begin(), items.end()), expected);
+        auto const v(make_box<obj::persistent_vector>(std::move(data)));
+        CHECK_EQ(v->to_hash(), expected);
+        CHECK_EQ(ordered(v.erase().data), expected);
+      }
+    }
+  }
+}
@@ -0,0 +1,80 @@
+#include <filesystem>
+
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/Support/MemoryBuffer.h>
+
+#include <jank/jit/object_cache.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::jit
+{
+  static std::unique_ptr<llvm::Module>
+  make_module(llvm::LLVMContext &ctx, std::string const &name, u32 const ret)
+  {
+    auto m{ std::make_unique<llvm::Module>(name, ctx) };
+    llvm::IRBuilder<> builder{ ctx };
+    auto const fn{ llvm::Function::Create(llvm::FunctionType::get(builder.getInt32Ty(), false),
+                                          llvm::Function::ExternalLinkage,
+                                          "object_cache_fn",
+                                          *m) };
+    builder.SetInsertPoint(llvm::BasicBlock::Create(ctx, "entry", fn));
+    builder.CreateRet(builder.getInt32(ret));
+    return m;
+  }
+
+  /* The JIT names each object after its module, like this. */
+  static std::unique_ptr<llvm::MemoryBuffer>
+  make_object(std::string const &module_name, std::string const &contents)
+  {
+    return llvm::MemoryBuffer::getMemBufferCopy(contents, module_name + "-jitted-objectbuffer");
+  }
+
+  TEST_SUITE("jit::object_cache")
+  {
+    TEST_CASE("find and compiled")
+    {
+      auto const dir{ std::filesystem::temp_directory_path() / "jank-test-object-cache" };
+      std::filesystem::remove_all(dir);
+      object_cache cache{ dir.c_str() };
+      llvm::LLVMContext ctx;
+
+      auto const m{ make_module(ctx, "object_cache_a", 1) };
+      CHECK(cache.find(*m) == nullptr);
+      cache.compiled(*make_object("object_cache_a", "object for a"));
+
+      auto const found{ cache.find(*make_module(ctx, "object_cache_a", 1)) };
+      REQUIRE(found != nullptr);
+      CHECK(found->getBuffer() == "object for a");
+
+      SUBCASE("different IR misses")
+      {
+        CHECK(cache.find(*make_module(ctx, "object_cache_a", 2)) == nullptr);
+        CHECK(cache.find(*make_module(ctx, "object_cache_b", 1)) == nullptr);
+      }
+
+      SUBCASE("objects for modules which didn't miss aren't cached")
+      {
+        cache.compiled(*make_object("object_cache_c", "object for c"));
+        cache.compiled(*llvm::MemoryBuffer::getMemBufferCopy("loaded", "/some/module.o"));
+        usize files{};
+        for(auto const &entry : std::filesystem::directory_iterator{ dir })
+        {
+          files += entry.is_regular_file();
+        }
+        CHECK(files == 1);
+      }
+
+      SUBCASE("another cache in the same dir sees it")
+      {
+        object_cache other{ dir.c_str() };
+        CHECK(other.find(*make_module(ctx, "object_cache_a", 1)) != nullptr);
+      }
+
+      std::filesystem::remove_all(dir);
+    }
+  }
+}
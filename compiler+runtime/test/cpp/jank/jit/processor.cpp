@@ -20,6 +20,7 @@
 #include <jank/runtime/core/equal.hpp>
 #include <jank/analyze/processor.hpp>
 #include <jank/jit/processor.hpp>
+#include <jank/util/cli.hpp>
 
 /* This must go last; doctest and glog both define CHECK and family. */
 #include <doctest/doctest.h>
@@ -216,5 +217,46 @@ namespace jank::jit
                   failures.size(),
                   jtl::terminal_style::reset);
     }
+
+    TEST_CASE("interpreter is created lazily")
+    {
+      processor const prc{ __rt_ctx->binary_version };
+      CHECK(!prc.interpreter.is_created());
+      CHECK(prc.find_dynamic_lib("jank-no-such-lib").is_none());
+      CHECK(!prc.interpreter.is_created());
+    }
+
+    TEST_CASE("codegen parity")
+    {
+      auto const old_codegen{ util::cli::opts.codegen };
+      util::scope_exit const finally{ [=] { util::cli::opts.codegen = old_codegen; } };
+
+      /* Each of these compiles a fn, so both backends are used for each. */
+      native_vector<jtl::immutable_string> const forms{
+        "((fn* [a b] (if (= a b) [a b] {:a a :b b})) 1 2)",
+        "((fn* [xs] (loop* [xs xs acc 0] (if (seq xs) (recur (next xs) (+ acc (first xs))) acc))) "
+        "[1 2 3])",
+        "((fn* [] (try (throw (ex-info \"x\" {:n 1})) (catch e (:n (ex-data e))))))",
+        "((fn* [n] (case n 1 :one 2 :two :many)) 2)",
+        "((fn* [] (= 3 (cpp/+ (cpp/int. 1) (cpp/int. 2)))))"
+      };
+
+      for(auto const &form : forms)
+      {
+        util::cli::opts.codegen = util::cli::codegen_type::cpp;
+        auto const cpp_result(__rt_ctx->eval_string(form));
+        util::cli::opts.codegen = util::cli::codegen_type::llvm_ir;
+        auto const ir_result(__rt_ctx->eval_string(form));
+        CHECK_MESSAGE(runtime::equal(cpp_result, ir_result), form);
+      }
+    }
+
+    TEST_CASE("header groups are included once")
+    {
+      __rt_ctx->jit_prc.require_header_group(header_group::interop);
+      __rt_ctx->jit_prc.require_header_group(header_group::interop);
+      CHECK_NOTHROW(__rt_ctx->jit_prc.eval_string(
+        "static_assert(sizeof(jank::runtime::convert<jank::runtime::object_ref>) > 0);"));
+    }
   }
 }
@@ -0,0 +1,94 @@
+#include <jank/jit/stats.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core.hpp>
+#include <jank/runtime/core/equal.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/seq.hpp>
+#include <jank/runtime/core/seq_ext.hpp>
+#include <jank/util/scope_exit.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::jit::stats
+{
+  static runtime::object_ref kw(char const * const name)
+  {
+    return runtime::__rt_ctx->intern_keyword(name).expect_ok();
+  }
+
+  TEST_SUITE("jit stats")
+  {
+    TEST_CASE("work is charged to the innermost module")
+    {
+      reset();
+      util::scope_exit const finally{ [] { reset(); } };
+
+      {
+        module_scope const outer{ "stats.outer", module_origin::source };
+        record_cpp(100, 10);
+        {
+          module_scope const inner{ "stats.inner", module_origin::binary };
+          record_link(64, 3);
+        }
+        record_ir(7);
+      }
+
+      /* Background compiles only count towards the totals, so they may have added more. */
+      auto const t{ totals() };
+      CHECK(1 <= t.jit.cpp_evals);
+      CHECK(100 <= t.jit.cpp_bytes);
+      CHECK(7 <= t.jit.ir_instructions);
+      CHECK(64 <= t.jit.object_bytes);
+      CHECK(3 <= t.jit.symbols);
+      CHECK(t.cache_hits == 1);
+      CHECK(t.cache_misses == 1);
+
+      auto const snap{ snapshot() };
+      auto const modules{ runtime::get(snap, kw("modules")) };
+      REQUIRE(runtime::sequence_length(modules) == 2);
+      runtime::for_each(modules, [&](runtime::object_ref const m) {
+        if(runtime::equal(runtime::get(m, kw("name")), runtime::make_box("stats.inner")))
+        {
+          CHECK(runtime::equal(runtime::get(m, kw("origin")), kw("binary")));
+          CHECK(runtime::equal(runtime::get(m, kw("symbols")), runtime::make_box(3)));
+          CHECK(runtime::equal(runtime::get(m, kw("cpp-bytes")), runtime::make_box(0)));
+        }
+        else
+        {
+          CHECK(runtime::equal(runtime::get(m, kw("origin")), kw("source")));
+          CHECK(runtime::equal(runtime::get(m, kw("cpp-bytes")), runtime::make_box(100)));
+          CHECK(runtime::equal(runtime::get(m, kw("symbols")), runtime::make_box(0)));
+        }
+      });
+    }
+
+    TEST_CASE("only the outermost eval is recorded")
+    {
+      reset();
+      util::scope_exit const finally{ [] { reset(); } };
+
+      {
+        eval_scope outer;
+        CHECK(outer.is_active());
+        outer.set_label("(def x");
+        {
+          eval_scope const inner;
+          CHECK(!inner.is_active());
+          record_cpp(10, 1);
+        }
+      }
+      {
+        module_scope const m{ "stats.module", module_origin::source };
+        eval_scope const within;
+        CHECK(!within.is_active());
+      }
+
+      auto const evals{ runtime::get(snapshot(), kw("evals")) };
+      REQUIRE(runtime::sequence_length(evals) == 1);
+      auto const e{ runtime::first(evals) };
+      CHECK(runtime::equal(runtime::get(e, kw("form")), runtime::make_box("(def x")));
+      CHECK(runtime::equal(runtime::get(e, kw("cpp-bytes")), runtime::make_box(10)));
+    }
+  }
+}
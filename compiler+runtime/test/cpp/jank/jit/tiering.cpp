@@ -0,0 +1,131 @@
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/equal.hpp>
+#include <jank/runtime/obj/jit_function.hpp>
+#include <jank/runtime/rtti.hpp>
+#include <jank/jit/tiering.hpp>
+#include <jank/util/cli.hpp>
+#include <jank/util/fmt.hpp>
+#include <jank/util/scope_exit.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::jit
+{
+  using namespace jank::runtime;
+
+  TEST_SUITE("jit::tiering")
+  {
+    TEST_CASE("Tiered compilation")
+    {
+      static constexpr u32 threshold{ 10 };
+
+      auto const old_codegen{ util::cli::opts.codegen };
+      auto const old_threshold{ util::cli::opts.tier_up_threshold };
+      util::cli::opts.codegen = util::cli::codegen_type::llvm_ir;
+      util::cli::opts.tiered_compilation = true;
+      util::cli::opts.tier_up_threshold = threshold;
+      util::scope_exit const finally{ [=] {
+        util::cli::opts.codegen = old_codegen;
+        util::cli::opts.tiered_compilation = false;
+        util::cli::opts.tier_up_threshold = old_threshold;
+      } };
+
+      SUBCASE("Hot fns are swapped to optimized code")
+      {
+        __rt_ctx->eval_string("(defn tiering-sum [a b] (+ a b))");
+        auto const fn{
+          expect_object<obj::jit_function>(__rt_ctx->eval_string("tiering-sum").unwrap())
+        };
+        auto const tier0{ fn->arity_2 };
+
+        for(u32 i{}; i < threshold - 1; ++i)
+        {
+          CHECK(equal(fn->call(make_box(1), make_box(2)), make_box(3)));
+        }
+        wait_for_pending();
+        CHECK(fn->arity_2 == tier0);
+
+        CHECK(equal(fn->call(make_box(1), make_box(2)), make_box(3)));
+        wait_for_pending();
+        CHECK(fn->arity_2 != tier0);
+        CHECK(equal(fn->call(make_box(40), make_box(2)), make_box(42)));
+      }
+
+      SUBCASE("Only the hot arity needs to reach the threshold")
+      {
+        __rt_ctx->eval_string("(defn tiering-multi ([] 0) ([a] a))");
+        auto const fn{
+          expect_object<obj::jit_function>(__rt_ctx->eval_string("tiering-multi").unwrap())
+        };
+        auto const tier0_0{ fn->arity_0 };
+        auto const tier0_1{ fn->arity_1 };
+
+        for(u32 i{}; i < threshold; ++i)
+        {
+          fn->call(make_box(1));
+        }
+        wait_for_pending();
+
+        /* The whole module is optimized, so every arity is swapped. */
+        CHECK(fn->arity_0 != tier0_0);
+        CHECK(fn->arity_1 != tier0_1);
+        CHECK(equal(fn->call(), make_box(0)));
+        CHECK(equal(fn->call(make_box(7)), make_box(7)));
+      }
+
+      SUBCASE("Speculated arithmetic falls back to the generic call")
+      {
+        __rt_ctx->eval_string("(defn tiering-speculate [a b] (if (< a b) (+ a b) (* a b)))");
+        auto const fn{
+          expect_object<obj::jit_function>(__rt_ctx->eval_string("tiering-speculate").unwrap())
+        };
+        auto const tier0{ fn->arity_2 };
+
+        for(u32 i{}; i < threshold; ++i)
+        {
+          CHECK(equal(fn->call(make_box(1), make_box(2)), make_box(3)));
+        }
+        wait_for_pending();
+        CHECK(fn->arity_2 != tier0);
+
+        CHECK(equal(fn->call(make_box(3), make_box(2)), make_box(6)));
+        CHECK(equal(fn->call(make_box(1.5), make_box(2)), make_box(3.5)));
+      }
+
+      SUBCASE("Long running loops are replaced on the stack")
+      {
+        /* We can't tell when the loop switches over, but it will have checked for optimized
+         * code several times by the time it's done, and it must give the same result. */
+        auto const n{ osr_interval * 8 };
+        auto const expected{ make_box(static_cast<i64>(n * (n - 1) / 2)) };
+        auto const loop{ util::format(
+          "(loop [i 0 acc 0] (if (< i {}) (recur (inc i) (+ acc i)) acc))",
+          n) };
+        CHECK(equal(__rt_ctx->eval_string(loop).unwrap(), expected));
+        wait_for_pending();
+        CHECK(equal(__rt_ctx->eval_string(util::format("(let [r {}] [r])", loop)).unwrap(),
+                    __rt_ctx->eval_string(util::format("[{}]", expected->data)).unwrap()));
+      }
+
+      SUBCASE("Fns loaded before tiering was enabled are left alone")
+      {
+        util::cli::opts.tiered_compilation = false;
+        __rt_ctx->eval_string("(defn tiering-untracked [] 1)");
+        util::cli::opts.tiered_compilation = true;
+
+        auto const fn{
+          expect_object<obj::jit_function>(__rt_ctx->eval_string("tiering-untracked").unwrap())
+        };
+        auto const arity{ fn->arity_0 };
+        for(u32 i{}; i < threshold; ++i)
+        {
+          fn->call();
+        }
+        wait_for_pending();
+        CHECK(fn->arity_0 == arity);
+      }
+    }
+  }
+}
@@ -0,0 +1,42 @@
+#include <thread>
+
+#include <jank/profile/phase.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::profile
+{
+  TEST_SUITE("profile phase")
+  {
+    TEST_CASE("nested phases are only charged for their own time")
+    {
+      enable_phases();
+      auto const before{ phase_totals() };
+      auto const start{ phase_now() };
+      {
+        phase_timer const outer{ phase::analyze };
+        {
+          phase_timer const inner{ phase::macroexpand };
+          std::this_thread::sleep_for(std::chrono::milliseconds{ 20 });
+        }
+      }
+      record_form("(def x", start);
+      auto const after{ phase_totals() };
+
+      auto const &analyze_before(before[static_cast<usize>(phase::analyze)]);
+      auto const &analyze_after(after[static_cast<usize>(phase::analyze)]);
+      auto const &expand_before(before[static_cast<usize>(phase::macroexpand)]);
+      auto const &expand_after(after[static_cast<usize>(phase::macroexpand)]);
+      CHECK(analyze_after.count == analyze_before.count + 1);
+      CHECK(expand_after.count == expand_before.count + 1);
+      CHECK(20'000'000 <= expand_after.self_ns - expand_before.self_ns);
+      CHECK(analyze_after.self_ns - analyze_before.self_ns < 20'000'000);
+
+      auto const forms{ form_totals() };
+      REQUIRE(!forms.empty());
+      CHECK(forms.back().label == "(def x");
+      CHECK(20'000'000 <= forms.back().ns);
+    }
+  }
+}
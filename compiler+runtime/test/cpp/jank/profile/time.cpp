@@ -0,0 +1,58 @@
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include <jank/profile/time.hpp>
+#include <jank/util/cli.hpp>
+#include <jank/util/scope_exit.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::profile
+{
+  TEST_SUITE("profile")
+  {
+    TEST_CASE("trace output")
+    {
+      auto const path{ std::filesystem::temp_directory_path() / "jank-test-profile.json" };
+      util::cli::opts.profiler_enabled = true;
+      util::cli::opts.profiler_file = path.c_str();
+      util::scope_exit const reset{ [] {
+        util::cli::opts.profiler_enabled = false;
+        util::cli::opts.profiler_file = "jank.profile";
+      } };
+
+      configure();
+      {
+        timer const outer{ "outer" };
+        {
+          timer const inner{ "inner \"quoted\"" };
+        }
+        outer.report("boundary");
+        std::thread{ [] { timer const other{ "other thread" }; } }.join();
+      }
+      finish();
+
+      std::ifstream ifs{ path };
+      std::stringstream ss;
+      ss << ifs.rdbuf();
+      auto const trace{ ss.str() };
+      std::filesystem::remove(path);
+
+      CHECK(trace.starts_with(R"({"displayTimeUnit":"ns","traceEvents":[)"));
+      CHECK(trace.find(R"({"name":"outer","ph":"B")") != std::string::npos);
+      CHECK(trace.find(R"({"name":"outer","ph":"E")") != std::string::npos);
+      CHECK(trace.find(R"({"name":"inner \"quoted\"","ph":"B")") != std::string::npos);
+      CHECK(trace.find(R"({"name":"boundary","ph":"i")") != std::string::npos);
+      CHECK(trace.find(R"("outer":{"count":1,)") != std::string::npos);
+      CHECK(trace.find(R"("other thread":{"count":1,)") != std::string::npos);
+
+      /* Each thread gets its own id. */
+      auto const outer_tid{ trace.find(R"("tid":)", trace.find(R"("name":"outer")")) };
+      auto const other_tid{ trace.find(R"("tid":)", trace.find(R"("name":"other thread")")) };
+      CHECK(trace.substr(outer_tid, 8) != trace.substr(other_tid, 8));
+    }
+  }
+}
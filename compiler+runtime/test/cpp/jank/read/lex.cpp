@@ -259,6 +259,19 @@ namespace jank::read::lex
                 { { { 9, 2, 1 } }, { { 10, 2, 2 } }, token_kind::integer,       2ll }
         }));
       }
+
+      SUBCASE("Long with Unicode")
+      {
+        processor p{ "; xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxé yyyyyyyyyyyyyyyyyyyy\nfoo" };
+        native_vector<jtl::result<token, error_ref>> const tokens(p.begin(), p.end());
+        CHECK(tokens
+              == make_tokens({
+                {  { { 0, 1, 1 } }, { { 55, 1, 56 } },
+                 token_kind::comment,
+                 " xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxé yyyyyyyyyyyyyyyyyyyy"sv },
+                { { { 56, 2, 1 } },  { { 59, 2, 4 } }, token_kind::symbol, "foo"sv }
+        }));
+      }
     }
 
     TEST_CASE("List")
@@ -1662,6 +1675,17 @@ namespace jank::read::lex
         }));
       }
 
+      SUBCASE("Long with Unicode")
+      {
+        processor p{ "abcdefghijklmnopqrstuvwxyz-é-0123456789 a" };
+        native_vector<jtl::result<token, error_ref>> const tokens(p.begin(), p.end());
+        CHECK(tokens
+              == make_results({
+                token{  0, 40, token_kind::symbol, "abcdefghijklmnopqrstuvwxyz-é-0123456789"sv },
+                token{ 41,  1, token_kind::symbol,                                      "a"sv },
+        }));
+      }
+
       //TODO: https://github.com/jank-lang/jank/issues/223
       //SUBCASE("Negative no leading digit")
       //{
@@ -1990,6 +2014,30 @@ namespace jank::read::lex
                 make_error(kind::lex_unterminated_string, 0, 5),
               }));
       }
+
+      SUBCASE("Long with line breaks, escapes, and Unicode")
+      {
+        processor p{
+          "\"aaaaaaaaaaaaaaaaaaaa\nbbbbbbbbbbbbbbbbbbbb\\\"ccccccccccccccccccccéddddd\"" };
+        native_vector<jtl::result<token, error_ref>> const tokens(p.begin(), p.end());
+        CHECK(tokens
+              == make_tokens({
+                { { { 0, 1, 1 } },
+                 { { 72, 2, 51 } },
+                 token_kind::escaped_string,
+                 "aaaaaaaaaaaaaaaaaaaa\nbbbbbbbbbbbbbbbbbbbb\\\"ccccccccccccccccccccéddddd"sv }
+        }));
+      }
+
+      SUBCASE("Long unterminated")
+      {
+        processor p{ "\"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa" };
+        native_vector<jtl::result<token, error_ref>> const tokens(p.begin(), p.end());
+        CHECK(tokens
+              == make_results({
+                make_error(kind::lex_unterminated_string, 0, 41),
+              }));
+      }
     }
 
     TEST_CASE("Meta hint")
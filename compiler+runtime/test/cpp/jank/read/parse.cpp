@@ -1,5 +1,7 @@
 #include <unistd.h>
 
+#include <algorithm>
+
 #include <jank/read/lex.hpp>
 #include <jank/read/parse.hpp>
 #include <jank/runtime/rtti.hpp>
@@ -1275,6 +1277,47 @@ namespace jank::read::parse
                       make_box<obj::persistent_hash_set>(std::in_place, make_box(1))));
         }
 
+        SUBCASE("Other branches aren't built")
+        {
+          /* The duplicate keys would be an error, if the map were built. */
+          lex::processor lp{
+            "[#?(:clj {:a 1 :a 2} :cljs ^:m #_ x (y [z] #inst \"2020\" ##Inf) :jank 7) 9]"
+          };
+          processor p{ lp.begin(), lp.end() };
+          auto const r(p.next());
+          CHECK(equal(r.expect_ok().unwrap().ptr,
+                      make_box<obj::persistent_vector>(std::in_place, make_box(7), make_box(9))));
+        }
+
+        SUBCASE("Tagged literals in other branches")
+        {
+          lex::processor lp{
+            "[#?(:clj #inst \"2020\" :cljs #uuid \"00000000-0000-0000-0000-000000000000\" "
+            ":jank 7) 9]"
+          };
+          processor p{ lp.begin(), lp.end() };
+          auto const r(p.next());
+          REQUIRE(r.is_ok());
+          CHECK(equal(r.expect_ok().unwrap().ptr,
+                      make_box<obj::persistent_vector>(std::in_place, make_box(7), make_box(9))));
+        }
+
+        SUBCASE("Branches after a match are skipped")
+        {
+          lex::processor lp{ "[#?(:jank 1 :default {:a 1 :a 2}) 2]" };
+          processor p{ lp.begin(), lp.end() };
+          auto const r(p.next());
+          CHECK(equal(r.expect_ok().unwrap().ptr,
+                      make_box<obj::persistent_vector>(std::in_place, make_box(1), make_box(2))));
+        }
+
+        SUBCASE("Odd number of forms")
+        {
+          lex::processor lp{ "#?(:clj 0 :jank)" };
+          processor p{ lp.begin(), lp.end() };
+          CHECK(p.next().is_err());
+        }
+
         SUBCASE("Splice")
         {
           SUBCASE("Not seqable")
@@ -1401,5 +1444,163 @@ namespace jank::read::parse
         CHECK(r.expect_ok().unwrap().end == r.expect_ok().unwrap().start);
       }
     }
+
+    TEST_CASE("Data")
+    {
+      auto const has_note_at([](error_ref const e, usize const offset) {
+        return std::ranges::any_of(e->notes, [&](error::note const &n) {
+          return n.source.start.offset == offset;
+        });
+      });
+
+      SUBCASE("Same as code, without source")
+      {
+        auto const code{ R"([{:a 1 :b (sym "str")} #{1 2} 'quoted \c 1.5 nil])" };
+        auto const r(read_data(code));
+        REQUIRE(r.is_ok());
+        CHECK(equal(r.expect_ok(), __rt_ctx->read_string(code)));
+
+        CHECK(meta(r.expect_ok()) == jank_nil());
+        auto const m(first(r.expect_ok()));
+        CHECK(meta(m) == jank_nil());
+        auto const list(get(m, __rt_ctx->intern_keyword("b").expect_ok()));
+        CHECK(meta(list) == jank_nil());
+        CHECK(meta(first(list)) == jank_nil());
+      }
+
+      SUBCASE("Empty")
+      {
+        auto const r(read_data(""));
+        CHECK(r.expect_ok() == jank_nil());
+      }
+
+      SUBCASE("Only the first form")
+      {
+        auto const r(read_data("1 2"));
+        CHECK(equal(r.expect_ok(), make_box(1)));
+      }
+
+      SUBCASE("Keywords are interned")
+      {
+        auto const r(read_data("[:a :a :ns/b]"));
+        CHECK(nth(r.expect_ok(), make_box(0)) == __rt_ctx->intern_keyword("a").expect_ok());
+        CHECK(nth(r.expect_ok(), make_box(1)) == __rt_ctx->intern_keyword("a").expect_ok());
+        CHECK(nth(r.expect_ok(), make_box(2))
+              == __rt_ctx->intern_keyword("ns", "b").expect_ok());
+      }
+
+      SUBCASE("Duplicate map keys")
+      {
+        auto const r(read_data("{:a 1 :b 2 :a 3}"));
+        REQUIRE(r.is_err());
+        CHECK(r.expect_err()->kind == error::kind::parse_duplicate_keys_in_map);
+        CHECK(r.expect_err()->source.start.offset == 11);
+        CHECK(has_note_at(r.expect_err(), 1));
+      }
+
+      SUBCASE("Duplicate set items")
+      {
+        auto const r(read_data("#{1 2 1}"));
+        REQUIRE(r.is_err());
+        CHECK(r.expect_err()->kind == error::kind::parse_duplicate_items_in_set);
+        CHECK(r.expect_err()->source.start.offset == 6);
+        CHECK(has_note_at(r.expect_err(), 2));
+      }
+
+      SUBCASE("All forms")
+      {
+        auto const r(read_all_data("1 :a [2] ; c\n #_ x \"s\""));
+        REQUIRE(r.is_ok());
+        CHECK(equal(r.expect_ok(),
+                    make_box<obj::persistent_vector>(
+                      std::in_place,
+                      make_box(1),
+                      __rt_ctx->intern_keyword("a").expect_ok(),
+                      make_box<obj::persistent_vector>(std::in_place, make_box(2)),
+                      make_box("s"))));
+
+        CHECK(equal(read_all_data("").expect_ok(), obj::persistent_vector::empty()));
+      }
+
+      SUBCASE("All forms, in chunks")
+      {
+        /* Big enough to be split, with the things which could trip up finding where each
+         * form ends. */
+        static constexpr usize form_count{ 20000 };
+        jtl::string_builder sb;
+        for(usize i{}; i < form_count; ++i)
+        {
+          util::format_to(sb,
+                          "{:id {} :s \"a ) ; \\\" [\" :c \\( :l '(x y)} #_ {:skipped \"]\"}\n"
+                          "^:m [{} \\) #{1 2} #inst \"2020-01-01\"] ; comment )\n",
+                          i,
+                          i);
+        }
+        auto const code(sb.release());
+        REQUIRE(1024 * 1024 < code.size());
+
+        auto const r(read_all_data(code));
+        REQUIRE(r.is_ok());
+        REQUIRE(sequence_length(r.expect_ok()) == form_count * 2);
+        auto const id(__rt_ctx->intern_keyword("id").expect_ok());
+        for(usize i{}; i < form_count; ++i)
+        {
+          auto const m(nth(r.expect_ok(), make_box(i * 2)));
+          auto const v(nth(r.expect_ok(), make_box(i * 2 + 1)));
+          CHECK(equal(get(m, id), make_box(i)));
+          CHECK(equal(first(v), make_box(i)));
+        }
+      }
+
+      SUBCASE("All forms, with an error in a chunk")
+      {
+        jtl::string_builder sb;
+        for(usize i{}; i < 200000; ++i)
+        {
+          sb("[1 2 3] ");
+        }
+        auto const offset(sb.size());
+        sb("{:a 1 :a 2}");
+        auto const code(sb.release());
+
+        auto const r(read_all_data(code));
+        REQUIRE(r.is_err());
+        CHECK(r.expect_err()->kind == error::kind::parse_duplicate_keys_in_map);
+        CHECK(r.expect_err()->source.start.offset == offset + 6);
+      }
+    }
+
+    TEST_CASE("Form positions")
+    {
+      SUBCASE("Recorded positions are found by index")
+      {
+        record_positions(
+          "pos_test.jank",
+          file_positions{ { 10, { { 11, 1, 12, 14, 1, 15 }, { 16, 1, 17, 16, 1, 17 } } } });
+        auto const second(find_position("pos_test.jank", 10, 1));
+        REQUIRE(second.is_some());
+        CHECK_EQ(second.unwrap().start_offset, 16);
+        CHECK(find_position("pos_test.jank", 10, 2).is_none());
+        CHECK(find_position("pos_test.jank", 11, 0).is_none());
+        CHECK(find_position("other.jank", 10, 0).is_none());
+      }
+
+      SUBCASE("Recording again replaces what was there")
+      {
+        record_positions("pos_test.jank", file_positions{ { 20, { { 21, 2, 1, 22, 2, 2 } } } });
+        record_positions("pos_test.jank", file_positions{ { 20, { { 23, 2, 3, 24, 2, 4 } } } });
+        CHECK_EQ(find_position("pos_test.jank", 20, 0).unwrap().start_offset, 23);
+      }
+
+      SUBCASE("Forgetting a file only drops its positions")
+      {
+        record_positions("pos_test.jank", file_positions{ { 30, { { 31, 3, 1, 32, 3, 2 } } } });
+        record_positions("kept.jank", file_positions{ { 30, { { 31, 3, 1, 32, 3, 2 } } } });
+        forget_positions("pos_test.jank");
+        CHECK(find_position("pos_test.jank", 30, 0).is_none());
+        CHECK(find_position("kept.jank", 30, 0).is_some());
+        forget_positions("kept.jank");
+      }
+    }
   }
 }
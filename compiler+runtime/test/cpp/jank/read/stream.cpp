@@ -0,0 +1,131 @@
+#include <unistd.h>
+
+#include <cstdio>
+
+#include <jtl/string_builder.hpp>
+
+#include <jank/read/stream.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core.hpp>
+#include <jank/runtime/core/equal.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/meta.hpp>
+#include <jank/runtime/obj/symbol.hpp>
+#include <jank/util/scope_exit.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::read
+{
+  using namespace jank::runtime;
+
+  /* Files are read in chunks, just like pipes, but we can write as much as we want to them
+   * up front without blocking. */
+  static FILE *make_file(jtl::immutable_string const &code)
+  {
+    auto const file{ std::tmpfile() };
+    std::fwrite(code.data(), 1, code.size(), file);
+    std::rewind(file);
+    return file;
+  }
+
+  TEST_SUITE("stream_reader")
+  {
+    TEST_CASE("Pipe")
+    {
+      int fds[2]{};
+      REQUIRE(pipe(fds) == 0);
+      util::scope_exit const finally{ [&] { ::close(fds[0]); } };
+
+      jtl::immutable_string const code{ "(+ 1 2)\n[a b] :kw\n123 \"str\" foo" };
+      REQUIRE(write(fds[1], code.data(), code.size()) == static_cast<ssize_t>(code.size()));
+      ::close(fds[1]);
+
+      stream_reader reader{ fds[0], false };
+      for(auto const expected : { "(+ 1 2)", "[a b]", ":kw", "123", "\"str\"", "foo" })
+      {
+        auto const form(reader.next().expect_ok());
+        REQUIRE(form.is_some());
+        CHECK(equal(form.unwrap(), __rt_ctx->read_string(expected)));
+      }
+      CHECK(reader.next().expect_ok().is_none());
+      CHECK(reader.next().expect_ok().is_none());
+    }
+
+    TEST_CASE("Lines carry over between forms")
+    {
+      auto const file{ make_file("(a)\n\n  (b)") };
+      util::scope_exit const finally{ [&] { std::fclose(file); } };
+
+      stream_reader reader{ fileno(file), false };
+      CHECK(object_source(reader.next().expect_ok().unwrap()).start.line == 1);
+      auto const second(object_source(reader.next().expect_ok().unwrap()));
+      CHECK(second.start.line == 3);
+      CHECK(second.start.col == 3);
+    }
+
+    TEST_CASE("Forms which span chunks")
+    {
+      jtl::string_builder sb;
+      sb('[');
+      for(usize i{}; i < 50'000; ++i)
+      {
+        sb(i)(' ');
+      }
+      sb(']');
+
+      auto const file{ make_file(sb.release()) };
+      util::scope_exit const finally{ [&] { std::fclose(file); } };
+
+      stream_reader reader{ fileno(file), false };
+      auto const vec(reader.next().expect_ok());
+      REQUIRE(vec.is_some());
+      CHECK(sequence_length(vec.unwrap()) == 50'000);
+      CHECK(reader.next().expect_ok().is_none());
+    }
+
+    TEST_CASE("Symbols which span chunks")
+    {
+      /* The first chunk ends with the start of this symbol, which we can't take as a symbol
+       * of its own. */
+      jtl::string_builder sb;
+      for(usize i{}; i < stream_reader::chunk_size - 3; ++i)
+      {
+        sb(' ');
+      }
+      sb("symbol-on-the-boundary");
+
+      auto const file{ make_file(sb.release()) };
+      util::scope_exit const finally{ [&] { std::fclose(file); } };
+
+      stream_reader reader{ fileno(file), false };
+      auto const sym(reader.next().expect_ok());
+      REQUIRE(sym.is_some());
+      CHECK(equal(sym.unwrap(), make_box<obj::symbol>("symbol-on-the-boundary")));
+      CHECK(reader.next().expect_ok().is_none());
+    }
+
+    TEST_CASE("Reading goes on after an error")
+    {
+      auto const file{ make_file(") (c)") };
+      util::scope_exit const finally{ [&] { std::fclose(file); } };
+
+      stream_reader reader{ fileno(file), false };
+      CHECK(reader.next().is_err());
+      auto const form(reader.next().expect_ok());
+      REQUIRE(form.is_some());
+      CHECK(equal(form.unwrap(), __rt_ctx->read_string("(c)")));
+    }
+
+    TEST_CASE("Unterminated")
+    {
+      auto const file{ make_file("(a (b)") };
+      util::scope_exit const finally{ [&] { std::fclose(file); } };
+
+      stream_reader reader{ fileno(file), false };
+      CHECK(reader.next().is_err());
+      CHECK(reader.next().expect_ok().is_none());
+    }
+  }
+}
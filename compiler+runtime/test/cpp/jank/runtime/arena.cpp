@@ -0,0 +1,67 @@
+#include <gc/gc.h>
+
+#include <jank/runtime/arena.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/obj/number.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::runtime
+{
+  TEST_SUITE("arena")
+  {
+    TEST_CASE("Boxes come from the current arena")
+    {
+      CHECK(arena::current() == nullptr);
+
+      obj::real *a{}, *b{};
+      {
+        arena const outer;
+        CHECK(arena::current() == &outer);
+
+        a = make_box(1.0).data;
+        b = make_box(2.0).data;
+        CHECK(reinterpret_cast<char *>(b) - reinterpret_cast<char *>(a) == sizeof(obj::real));
+
+        {
+          arena const inner;
+          CHECK(arena::current() == &inner);
+        }
+        CHECK(arena::current() == &outer);
+      }
+      CHECK(arena::current() == nullptr);
+      CHECK(detail::active_arenas.load() == 0);
+
+      /* Escaping objects keep their chunk alive. */
+      GC_gcollect();
+      CHECK(a->data == 1.0);
+      CHECK(b->data == 2.0);
+      CHECK(GC_base(a) != nullptr);
+    }
+
+    TEST_CASE("Big allocations skip the chunk")
+    {
+      arena a;
+      auto const first(a.allocate(8));
+      auto const second(a.allocate(8));
+      auto const remaining(a.remaining);
+      auto const big(a.allocate(arena::max_object_size + 1));
+      CHECK(a.remaining == remaining);
+      CHECK(GC_base(big) == big);
+      CHECK(GC_base(second) == first);
+    }
+
+    TEST_CASE("Chunks are refilled")
+    {
+      arena a;
+      a.allocate(8);
+      auto const first_chunk(GC_base(a.chunk));
+      for(usize i{}; i < arena::chunk_size / arena::max_object_size; ++i)
+      {
+        a.allocate(arena::max_object_size);
+      }
+      CHECK(GC_base(a.chunk) != first_chunk);
+    }
+  }
+}
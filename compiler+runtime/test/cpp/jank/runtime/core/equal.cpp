@@ -0,0 +1,63 @@
+#include <jank/runtime/core/equal.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/obj/persistent_vector.hpp>
+#include <jank/runtime/obj/persistent_list.hpp>
+#include <jank/runtime/obj/persistent_hash_set.hpp>
+#include <jank/runtime/obj/big_integer.hpp>
+#include <jank/runtime/obj/number.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::runtime
+{
+  TEST_SUITE("core runtime for equal")
+  {
+    TEST_CASE("Identical objects")
+    {
+      auto const v(make_box<obj::persistent_vector>(std::in_place, make_box(1), make_box(2)));
+      CHECK(equal(v, v));
+      CHECK(equal(jank_nil(), jank_nil()));
+      CHECK(!equal(jank_nil(), v));
+      CHECK(!equal(v, jank_nil()));
+    }
+
+    TEST_CASE("Interned and unique values")
+    {
+      auto const a(__rt_ctx->intern_keyword("a").expect_ok());
+      auto const b(__rt_ctx->intern_keyword("b").expect_ok());
+      CHECK(equal(a, __rt_ctx->intern_keyword("a").expect_ok()));
+      CHECK(!equal(a, b));
+      CHECK(equal(jank_true, make_box(true)));
+      CHECK(!equal(jank_true, jank_false));
+      CHECK(!equal(jank_true, a));
+    }
+
+    TEST_CASE("Hashed collections")
+    {
+      auto const v(make_box<obj::persistent_vector>(std::in_place, make_box(1), make_box(2)));
+      auto const l(make_box<obj::persistent_list>(std::in_place, make_box(1), make_box(2)));
+      auto const other(make_box<obj::persistent_vector>(std::in_place, make_box(1), make_box(3)));
+      v->to_hash();
+      l->to_hash();
+      other->to_hash();
+      CHECK(equal(v, l));
+      CHECK(equal(l, v));
+      CHECK(!equal(v, other));
+
+      SUBCASE("Big integers hash like integers")
+      {
+        auto const big(make_box<obj::persistent_vector>(
+          std::in_place,
+          make_box(1),
+          make_box<obj::big_integer>(native_big_integer{ 2 })));
+        big->to_hash();
+        CHECK(equal(v, big));
+        CHECK_EQ(to_hash(make_box(2)),
+                 to_hash(make_box<obj::big_integer>(native_big_integer{ 2 })));
+      }
+    }
+  }
+}
@@ -0,0 +1,101 @@
+#include <jank/runtime/core/fold.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/equal.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/obj/persistent_vector.hpp>
+#include <jank/runtime/obj/persistent_list.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
+#include <jank/runtime/obj/number.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::runtime
+{
+  static constexpr i64 element_count{ 100'000 };
+  /* The sum of [0, element_count). */
+  static constexpr i64 expected_sum{ element_count * (element_count - 1) / 2 };
+
+  static obj::persistent_vector_ref make_range_vector(i64 const count)
+  {
+    runtime::detail::native_transient_vector trans;
+    for(i64 i{}; i < count; ++i)
+    {
+      trans.push_back(make_box(i));
+    }
+    return make_box<obj::persistent_vector>(trans.persistent());
+  }
+
+  TEST_SUITE("fold")
+  {
+    TEST_CASE("persistent_vector")
+    {
+      auto const plus{ __rt_ctx->find_var("clojure.core", "+")->deref() };
+      auto const v{ make_range_vector(element_count) };
+
+      SUBCASE("small groups")
+      {
+        CHECK(equal(fold(make_box(64), plus, plus, v), make_box(expected_sum)));
+      }
+
+      SUBCASE("one group")
+      {
+        CHECK(equal(fold(make_box(element_count), plus, plus, v), make_box(expected_sum)));
+      }
+
+      SUBCASE("empty")
+      {
+        CHECK(equal(fold(make_box(64), plus, plus, make_box<obj::persistent_vector>()),
+                    make_box(0)));
+      }
+
+      SUBCASE("order is preserved")
+      {
+        auto const conj{ __rt_ctx->eval_string("(fn ([] []) ([a b] (conj a b)))").unwrap() };
+        auto const into{ __rt_ctx->eval_string("(fn ([] []) ([a b] (into a b)))").unwrap() };
+        auto const small{ make_range_vector(1'000) };
+        CHECK(equal(fold(make_box(7), into, conj, small), small));
+      }
+
+      SUBCASE("reduced only stops its own group")
+      {
+        /* Each group of 10 stops after its first element, so we're left with one per group. */
+        auto const first{ __rt_ctx->eval_string("(fn [acc x] (reduced (+ acc 1)))").unwrap() };
+        CHECK(equal(fold(make_box(10), plus, first, make_range_vector(80)), make_box(8)));
+      }
+
+      SUBCASE("exceptions propagate")
+      {
+        auto const thrower{ __rt_ctx->eval_string("(fn [acc x] (if (= x 777) (throw :bad) acc))")
+                              .unwrap() };
+        CHECK_THROWS(fold(make_box(16), plus, thrower, make_range_vector(1'000)));
+      }
+    }
+
+    TEST_CASE("persistent_hash_map")
+    {
+      auto const plus{ __rt_ctx->find_var("clojure.core", "+")->deref() };
+      auto const sum_vals{ __rt_ctx->eval_string("(fn [acc k v] (+ acc v))").unwrap() };
+
+      runtime::detail::native_transient_hash_map trans;
+      for(i64 i{}; i < element_count; ++i)
+      {
+        trans.set(make_box(i), make_box(i));
+      }
+      auto const m{ make_box<obj::persistent_hash_map>(trans.persistent()) };
+
+      CHECK(equal(fold(make_box(64), plus, sum_vals, m), make_box(expected_sum)));
+      CHECK(equal(fold(make_box(element_count), plus, sum_vals, m), make_box(expected_sum)));
+    }
+
+    TEST_CASE("sequential fallback")
+    {
+      auto const plus{ __rt_ctx->find_var("clojure.core", "+")->deref() };
+      auto const l{ make_box<obj::persistent_list>(std::in_place,
+                                                   make_box(1),
+                                                   make_box(2),
+                                                   make_box(3)) };
+      CHECK(equal(fold(make_box(1), plus, plus, l), make_box(6)));
+    }
+  }
+}
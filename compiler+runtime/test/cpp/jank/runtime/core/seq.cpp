@@ -1,7 +1,14 @@
 #include <jank/runtime/core/seq.hpp>
 #include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/math.hpp>
+#include <jank/runtime/object_pool.hpp>
+#include <jank/runtime/sequence_range.hpp>
 #include <jank/runtime/obj/persistent_vector.hpp>
 #include <jank/runtime/obj/persistent_list.hpp>
+#include <jank/runtime/obj/native_vector_sequence.hpp>
+#include <jank/runtime/obj/array_chunk.hpp>
+#include <jank/runtime/obj/number.hpp>
+#include <jank/runtime/rtti.hpp>
 
 /* This must go last; doctest and glog both define CHECK and family. */
 #include <doctest/doctest.h>
@@ -32,5 +39,64 @@ namespace jank::runtime::core
         make_box<obj::persistent_vector>(std::in_place, make_box('f'), make_box('g')),
         make_box<obj::persistent_list>(std::in_place, make_box('g'))));
     }
+
+    TEST_CASE("chunked native_vector_sequence")
+    {
+      native_vector<object_ref> data;
+      for(i64 i{}; i < 70; ++i)
+      {
+        data.emplace_back(make_box(i));
+      }
+      auto const s{ make_box<obj::native_vector_sequence>(jtl::move(data)) };
+      CHECK(is_chunked_seq(s));
+
+      i64 expected{};
+      object_ref rest{ s };
+      while(!rest.is_nil())
+      {
+        auto const chunk{ expect_object<obj::array_chunk>(chunk_first(rest)) };
+        CHECK(chunk->count() == (expected < 64 ? 32 : 6));
+        for(usize i{}; i < chunk->count(); ++i, ++expected)
+        {
+          CHECK(expect_object<obj::integer>(chunk->nth(make_box(i)))->data == expected);
+        }
+        rest = chunk_next(rest);
+      }
+      CHECK(expected == 70);
+    }
+
+    TEST_CASE("for_each_item")
+    {
+      auto const v{ make_box<obj::persistent_vector>(std::in_place,
+                                                     make_box<obj::integer>(1),
+                                                     make_box<obj::integer>(2),
+                                                     make_box<obj::integer>(3)) };
+
+      /* Sequence objects are pooled, so the pool counts tell us whether we made any. */
+      auto const before(pool_stats().allocations);
+      i64 sum{};
+      CHECK(for_each_item(v, [&](object_ref const o) { sum += to_int(o); }));
+      CHECK(for_each_item(v->seq(), [&](object_ref const o) { sum += to_int(o); }));
+      CHECK(sum == 12);
+      CHECK(pool_stats().allocations == before + 1);
+
+      usize seen{};
+      CHECK(!for_each_item(v, [&](object_ref) { return ++seen < 2; }));
+      CHECK(seen == 2);
+      CHECK(for_each_item(jank_nil(), [](object_ref) { return false; }));
+    }
+
+    TEST_CASE("next steps a fresh seq in place")
+    {
+      auto const v{ make_box<obj::persistent_vector>(std::in_place,
+                                                     make_box<obj::integer>(1),
+                                                     make_box<obj::integer>(2)) };
+      auto const before(pool_stats().allocations);
+      auto const n(next(v));
+      CHECK(pool_stats().allocations == before + 1);
+      CHECK(to_int(first(n)) == 2);
+      CHECK(next(n).is_nil());
+      CHECK(to_int(first(rest(v))) == 2);
+    }
   }
 }
@@ -0,0 +1,98 @@
+#include <jank/runtime/core/to_string.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/obj/persistent_vector.hpp>
+#include <jank/runtime/obj/persistent_list.hpp>
+#include <jank/runtime/obj/persistent_array_map.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
+#include <jank/runtime/obj/persistent_string.hpp>
+#include <jank/runtime/obj/number.hpp>
+#include <jank/runtime/obj/repeat.hpp>
+#include <jank/util/scope_exit.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::runtime::core
+{
+  static void with_limits(object_ref const length, object_ref const level, auto const &fn)
+  {
+    __rt_ctx
+      ->push_thread_bindings(
+        obj::persistent_hash_map::create_unique(std::make_pair(__rt_ctx->print_length_var, length),
+                                                std::make_pair(__rt_ctx->print_level_var, level)))
+      .expect_ok();
+    util::scope_exit const finally{ [] { __rt_ctx->pop_thread_bindings().expect_ok(); } };
+    fn();
+  }
+
+  static object_ref nested()
+  {
+    return make_box<obj::persistent_vector>(
+      std::in_place,
+      make_box(1),
+      make_box("two\n"),
+      make_box<obj::persistent_list>(std::in_place,
+                                     make_box('c'),
+                                     make_box<obj::persistent_vector>(std::in_place, make_box(4))));
+  }
+
+  TEST_SUITE("core runtime for to_string")
+  {
+    TEST_CASE("Nested")
+    {
+      CHECK(to_code_string(nested()) == R"([1 "two\n" (\c [4])])");
+      CHECK(to_string(nested()) == "[1 two\n (c [4])]");
+
+      jtl::string_builder buff;
+      buff("x ");
+      to_code_string(nested(), buff);
+      CHECK(buff.release() == R"(x [1 "two\n" (\c [4])])");
+    }
+
+    TEST_CASE("Print length")
+    {
+      with_limits(make_box(2), jank_nil(), [] {
+        /* Only the printing fns follow the limits. */
+        CHECK(to_code_string(nested()) == R"([1 "two\n" (\c [4])])");
+
+        auto const args(make_box<obj::persistent_list>(std::in_place, nested()));
+        CHECK(pr_str(args) == R"([1 "two\n" ...])");
+        CHECK(print_str(args) == "[1 two\n ...]");
+
+        auto const infinite(
+          make_box<obj::persistent_list>(std::in_place, make_box<obj::repeat>(make_box(0))));
+        CHECK(pr_str(infinite) == "(0 0 ...)");
+
+        auto const map(make_box<obj::persistent_list>(
+          std::in_place,
+          obj::persistent_array_map::create_unique(make_box(1), make_box(2))));
+        CHECK(pr_str(map) == "{1 2}");
+      });
+
+      with_limits(make_box(0), jank_nil(), [] {
+        CHECK(pr_str(make_box<obj::persistent_list>(std::in_place, nested())) == "[...]");
+      });
+    }
+
+    TEST_CASE("Print level")
+    {
+      with_limits(jank_nil(), make_box(1), [] {
+        CHECK(pr_str(make_box<obj::persistent_list>(std::in_place, nested()))
+              == R"([1 "two\n" #])");
+      });
+
+      with_limits(jank_nil(), make_box(2), [] {
+        CHECK(pr_str(make_box<obj::persistent_list>(std::in_place, nested()))
+              == R"([1 "two\n" (\c #)])");
+      });
+
+      with_limits(jank_nil(), make_box(0), [] {
+        CHECK(pr_str(make_box<obj::persistent_list>(std::in_place, nested())) == "#");
+        /* Only collections are cut off. */
+        CHECK(pr_str(make_box<obj::persistent_list>(std::in_place, make_box(1))) == "1");
+      });
+    }
+  }
+}
@@ -0,0 +1,124 @@
+#include <atomic>
+#include <thread>
+
+#include <jank/runtime/detail/intern_table.hpp>
+#include <jank/runtime/executor.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/obj/keyword.hpp>
+#include <jank/runtime/obj/number.hpp>
+#include <jank/util/fmt.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::runtime::detail
+{
+  TEST_SUITE("intern_table")
+  {
+    TEST_CASE("intern and find")
+    {
+      intern_table<obj::integer_ref> table;
+      CHECK(table.find("foo", "bar").is_nil());
+
+      auto const first{ table.intern("foo", "bar", [] { return make_box(1); }) };
+      CHECK(first->data == 1);
+      CHECK(table.intern("foo", "bar", [] { return make_box(2); }) == first);
+      CHECK(table.find("foo", "bar") == first);
+
+      SUBCASE("the ns and name are separate")
+      {
+        CHECK(table.find("", "foo/bar").is_nil());
+        CHECK(table.find("foob", "ar").is_nil());
+      }
+
+      SUBCASE("remove")
+      {
+        CHECK(table.remove("foo", "bar") == first);
+        CHECK(table.find("foo", "bar").is_nil());
+        CHECK(table.remove("foo", "bar").is_nil());
+        CHECK(table.intern("foo", "bar", [] { return make_box(3); })->data == 3);
+      }
+    }
+
+    TEST_CASE("grows")
+    {
+      static constexpr i64 count{ 10'000 };
+      intern_table<obj::integer_ref> table;
+      for(i64 i{}; i < count; ++i)
+      {
+        auto const name{ util::format("name-{}", i) };
+        table.intern("", name, [=] { return make_box(i); });
+        if(i % 3 == 0)
+        {
+          table.remove("", name);
+        }
+      }
+
+      for(i64 i{}; i < count; ++i)
+      {
+        auto const found{ table.find("", util::format("name-{}", i)) };
+        if(i % 3 == 0)
+        {
+          CHECK(found.is_nil());
+        }
+        else
+        {
+          CHECK(found->data == i);
+        }
+      }
+    }
+
+    TEST_CASE("concurrent interning")
+    {
+      static constexpr usize task_count{ 64 };
+      static constexpr i64 name_count{ 500 };
+      work_stealing_executor pool{ 4 };
+      std::atomic<usize> done{};
+      std::atomic<usize> made{};
+      std::atomic<usize> mismatched{};
+      intern_table<obj::integer_ref> table;
+
+      for(usize t{}; t < task_count; ++t)
+      {
+        pool.submit([&] {
+          for(i64 i{}; i < name_count; ++i)
+          {
+            auto const name{ util::format("{}", i) };
+            auto const interned{ table.intern("ns", name, [&] {
+              ++made;
+              return make_box(i);
+            }) };
+            if(interned != table.find("ns", name) || interned->data != i)
+            {
+              ++mismatched;
+            }
+          }
+          ++done;
+        });
+      }
+
+      while(done.load() != task_count)
+      {
+        if(!pool.run_pending_task())
+        {
+          std::this_thread::yield();
+        }
+      }
+      CHECK(made.load() == name_count);
+      CHECK(mismatched.load() == 0);
+    }
+
+    TEST_CASE("keywords")
+    {
+      auto const qualified{ __rt_ctx->intern_keyword("jank.test.intern/kw").expect_ok() };
+      CHECK(__rt_ctx->intern_keyword("jank.test.intern", "kw", true).expect_ok() == qualified);
+      CHECK(qualified->get_namespace() == "jank.test.intern");
+      CHECK(qualified->get_name() == "kw");
+
+      auto const unqualified{ __rt_ctx->intern_keyword("kw").expect_ok() };
+      CHECK(unqualified != qualified);
+      CHECK(__rt_ctx->intern_keyword("", "kw", true).expect_ok() == unqualified);
+    }
+  }
+}
@@ -0,0 +1,141 @@
+#include <jank/runtime/detail/name_index.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/to_string.hpp>
+#include <jank/runtime/obj/keyword.hpp>
+#include <jank/runtime/obj/symbol.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::runtime::detail
+{
+  static native_vector<jtl::immutable_string> names_of(native_vector<object_ref> const &found)
+  {
+    native_vector<jtl::immutable_string> ret;
+    for(auto const o : found)
+    {
+      ret.emplace_back(runtime::to_string(o));
+    }
+    return ret;
+  }
+
+  static var_ref make_var(ns_ref const n, jtl::immutable_string const &name)
+  {
+    return make_box<var>(n, make_box<obj::symbol>(name));
+  }
+
+  TEST_SUITE("name_index")
+  {
+    TEST_CASE("complete")
+    {
+      name_index index;
+      auto const core{ make_box<ns>(make_box<obj::symbol>("index.core")) };
+      auto const str{ make_box<ns>(make_box<obj::symbol>("index.string")) };
+      index.add_ns(core);
+      index.add_ns(str);
+
+      auto const map{ make_var(core, "map") };
+      auto const mapv{ make_var(core, "mapv") };
+      auto const join{ make_var(str, "join") };
+      auto const str_map{ make_var(str, "map-chars") };
+      for(auto const v : { map, mapv, join, str_map })
+      {
+        index.add_var(v);
+      }
+      index.add_keyword(__rt_ctx->intern_keyword("", "index-key", true).expect_ok());
+      index.add_keyword(__rt_ctx->intern_keyword("index", "other", true).expect_ok());
+
+      SUBCASE("by name")
+      {
+        CHECK(names_of(index.complete("map", 10))
+              == native_vector<jtl::immutable_string>{ "#'index.core/map",
+                                                       "#'index.string/map-chars",
+                                                       "#'index.core/mapv" });
+        CHECK(index.complete("map", 1).size() == 1);
+        CHECK(index.complete("nothing", 10).empty());
+      }
+
+      SUBCASE("namespaces come first")
+      {
+        auto const found{ index.complete("index", 10) };
+        REQUIRE(found.size() == 2);
+        CHECK(found[0] == core);
+        CHECK(found[1] == str);
+      }
+
+      SUBCASE("qualified")
+      {
+        CHECK(names_of(index.complete("index.core/ma", 10))
+              == native_vector<jtl::immutable_string>{ "#'index.core/map", "#'index.core/mapv" });
+        CHECK(names_of(index.complete("index.string/", 10))
+              == native_vector<jtl::immutable_string>{ "#'index.string/join",
+                                                       "#'index.string/map-chars" });
+        CHECK(index.complete("index.cor/ma", 10).empty());
+      }
+
+      SUBCASE("keywords")
+      {
+        CHECK(names_of(index.complete(":index", 10))
+              == native_vector<jtl::immutable_string>{ ":index-key", ":index/other" });
+        CHECK(names_of(index.complete(":index/", 10))
+              == native_vector<jtl::immutable_string>{ ":index/other" });
+      }
+
+      SUBCASE("keep")
+      {
+        auto const found{
+          index.complete("map", 1, [&](object_ref const o) { return o != map; })
+        };
+        REQUIRE(found.size() == 1);
+        CHECK(found[0] == str_map);
+      }
+
+      SUBCASE("remove var")
+      {
+        index.remove_var(mapv);
+        CHECK(names_of(index.complete("index.core/", 10))
+              == native_vector<jtl::immutable_string>{ "#'index.core/map" });
+
+        /* A var which isn't the indexed one, with the same name, is left alone. */
+        index.remove_var(make_var(core, "map"));
+        CHECK(index.complete("index.core/", 10).size() == 1);
+      }
+
+      SUBCASE("remove ns")
+      {
+        auto const size{ index.size() };
+        index.remove_ns(str);
+        CHECK(index.size() == size - 3);
+        CHECK(index.complete("index.string", 10).empty());
+        CHECK(index.complete("join", 10).empty());
+        CHECK(names_of(index.complete("map", 10))
+              == native_vector<jtl::immutable_string>{ "#'index.core/map",
+                                                       "#'index.core/mapv" });
+      }
+
+      SUBCASE("vars of namespaces which aren't indexed")
+      {
+        auto const other{ make_box<ns>(make_box<obj::symbol>("index.other")) };
+        index.add_var(make_var(other, "mapcat"));
+        CHECK(index.complete("mapc", 10).empty());
+      }
+    }
+
+    TEST_CASE("runtime namespaces")
+    {
+      auto const n{ __rt_ctx->intern_ns("index.runtime") };
+      n->intern_var("index-runtime-fn");
+      CHECK(__rt_ctx->names.complete("index.runtime/", 10).size() == 1);
+      CHECK(__rt_ctx->names.complete("index-runtime-", 10).size() == 1);
+
+      n->unmap(make_box<obj::symbol>("index-runtime-fn")).expect_ok();
+      CHECK(__rt_ctx->names.complete("index-runtime-", 10).empty());
+
+      n->intern_var("index-runtime-fn");
+      __rt_ctx->remove_ns(make_box<obj::symbol>("index.runtime"));
+      CHECK(__rt_ctx->names.complete("index.runtime", 10).empty());
+      CHECK(__rt_ctx->names.complete("index-runtime-", 10).empty());
+    }
+  }
+}
@@ -0,0 +1,189 @@
+#include <jank/runtime/detail/type.hpp>
+#include <jank/runtime/obj/number.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/rtti.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::runtime::detail
+{
+  static i64 value_of(object_ref const o)
+  {
+    return expect_object<obj::integer>(o)->data;
+  }
+
+  /* Enough entries to need a few levels of branches. */
+  static constexpr i64 entry_count{ 2000 };
+
+  /* Every odd number in [1, entry_count * 2), inserted out of order. */
+  static native_persistent_sorted_set make_odd_set()
+  {
+    native_persistent_sorted_set s;
+    for(i64 i{}; i < entry_count; ++i)
+    {
+      s = s.insert(make_box((i * 7919 % entry_count) * 2 + 1));
+    }
+    return s;
+  }
+
+  TEST_SUITE("native_persistent_sorted_tree")
+  {
+    TEST_CASE("Empty")
+    {
+      native_persistent_sorted_set const s;
+      CHECK(s.empty());
+      CHECK(s.size() == 0);
+      CHECK(s.begin() == s.end());
+      CHECK(s.rbegin() == s.end());
+      CHECK(s.find(make_box(1)) == nullptr);
+    }
+
+    TEST_CASE("Insert")
+    {
+      auto const s{ make_odd_set() };
+      CHECK(s.size() == entry_count);
+
+      i64 expected{ 1 };
+      for(auto const e : s)
+      {
+        CHECK(value_of(e) == expected);
+        expected += 2;
+      }
+      CHECK(expected == entry_count * 2 + 1);
+
+      CHECK(s.contains(make_box(1)));
+      CHECK(s.contains(make_box(entry_count * 2 - 1)));
+      CHECK(!s.contains(make_box(2)));
+      CHECK(s.insert(make_box(1)).size() == entry_count);
+    }
+
+    TEST_CASE("Reverse iteration")
+    {
+      auto const s{ make_odd_set() };
+      i64 expected{ entry_count * 2 - 1 };
+      for(auto it{ s.rbegin() }; it != s.end(); ++it)
+      {
+        CHECK(value_of(*it) == expected);
+        expected -= 2;
+      }
+      CHECK(expected == -1);
+    }
+
+    TEST_CASE("Erase")
+    {
+      auto const full{ make_odd_set() };
+      auto s{ full };
+      for(i64 i{ 1 }; i < entry_count * 2; i += 4)
+      {
+        s = s.erase(make_box(i));
+      }
+      s = s.erase(make_box(2));
+
+      CHECK(s.size() == entry_count / 2);
+      i64 expected{ 3 };
+      for(auto const e : s)
+      {
+        CHECK(value_of(e) == expected);
+        expected += 4;
+      }
+
+      SUBCASE("leaves the original intact")
+      {
+        CHECK(full.size() == entry_count);
+        CHECK(full.contains(make_box(1)));
+      }
+
+      SUBCASE("down to nothing")
+      {
+        for(i64 i{ 3 }; i < entry_count * 2; i += 4)
+        {
+          s = s.erase(make_box(i));
+        }
+        CHECK(s.empty());
+        CHECK(s.begin() == s.end());
+      }
+    }
+
+    TEST_CASE("Map")
+    {
+      native_persistent_sorted_map m;
+      for(i64 i{}; i < entry_count; ++i)
+      {
+        m = m.set(make_box(i % 100), make_box(i));
+      }
+      CHECK(m.size() == 100);
+      CHECK(value_of(*m.find(make_box(5))) == entry_count - 95);
+
+      auto const updated{ m.set(make_box(5), make_box(-1)) };
+      CHECK(value_of(*updated.find(make_box(5))) == -1);
+      CHECK(value_of(*m.find(make_box(5))) == entry_count - 95);
+
+      i64 expected{};
+      for(auto const &e : m)
+      {
+        CHECK(value_of(e.first) == expected);
+        ++expected;
+      }
+    }
+
+    TEST_CASE("Transient")
+    {
+      auto const s{ make_odd_set() };
+      auto t{ s.transient() };
+      for(i64 i{}; i < entry_count * 2; i += 2)
+      {
+        t.insert(make_box(i));
+      }
+      t.erase(make_box(1));
+      auto const p{ t.persistent() };
+
+      CHECK(p.size() == entry_count * 2 - 1);
+      CHECK(!p.contains(make_box(1)));
+      CHECK(s.size() == entry_count);
+      CHECK(s.contains(make_box(1)));
+      CHECK(!s.contains(make_box(0)));
+
+      SUBCASE("further updates don't leak into the persistent")
+      {
+        t.erase(make_box(3));
+        CHECK(p.contains(make_box(3)));
+        CHECK(!t.contains(make_box(3)));
+      }
+    }
+
+    TEST_CASE("Seek")
+    {
+      auto const s{ make_odd_set() };
+
+      SUBCASE("ascending")
+      {
+        auto const exact{ s.seek(make_box(11), true) };
+        CHECK(value_of(*exact) == 11);
+        CHECK(s.remaining(exact) == entry_count - 5);
+
+        auto const between{ s.seek(make_box(12), true) };
+        CHECK(value_of(*between) == 13);
+        CHECK(s.remaining(between) == entry_count - 6);
+
+        CHECK(value_of(*s.seek(make_box(-5), true)) == 1);
+        CHECK(s.seek(make_box(entry_count * 2), true) == s.end());
+      }
+
+      SUBCASE("descending")
+      {
+        auto const exact{ s.seek(make_box(11), false) };
+        CHECK(value_of(*exact) == 11);
+        CHECK(s.remaining(exact) == 6);
+
+        auto it{ s.seek(make_box(12), false) };
+        CHECK(value_of(*it) == 11);
+        ++it;
+        CHECK(value_of(*it) == 9);
+
+        CHECK(value_of(*s.seek(make_box(entry_count * 3), false)) == entry_count * 2 - 1);
+        CHECK(s.seek(make_box(0), false) == s.end());
+      }
+    }
+  }
+}
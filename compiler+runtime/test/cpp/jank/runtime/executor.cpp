@@ -0,0 +1,166 @@
+#include <atomic>
+#include <thread>
+
+#include <jank/runtime/executor.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/equal.hpp>
+#include <jank/runtime/obj/future.hpp>
+#include <jank/runtime/obj/number.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::runtime
+{
+  /* Runs queued work on the calling thread until the condition is met. */
+  template <typename F>
+  static void help_until(executor &e, F const &done)
+  {
+    while(!done())
+    {
+      if(!e.run_pending_task())
+      {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  TEST_SUITE("executor")
+  {
+    TEST_CASE("work_stealing_executor")
+    {
+      work_stealing_executor pool{ 4 };
+      CHECK(pool.thread_count() == 4);
+      CHECK(!pool.is_worker_thread());
+
+      SUBCASE("runs every task")
+      {
+        static constexpr usize task_count{ 10'000 };
+        std::atomic<usize> ran{};
+        for(usize i{}; i < task_count; ++i)
+        {
+          pool.submit([&] { ++ran; });
+        }
+        help_until(pool, [&] { return ran.load() == task_count; });
+        CHECK(ran.load() == task_count);
+      }
+
+      SUBCASE("tasks can submit more tasks")
+      {
+        static constexpr usize fan_out{ 64 };
+        std::atomic<usize> ran{};
+        std::atomic<usize> on_worker{};
+        for(usize i{}; i < fan_out; ++i)
+        {
+          pool.submit([&] {
+            for(usize j{}; j < fan_out; ++j)
+            {
+              pool.submit([&] {
+                if(pool.is_worker_thread())
+                {
+                  ++on_worker;
+                }
+                ++ran;
+              });
+            }
+          });
+        }
+        help_until(pool, [&] { return ran.load() == fan_out * fan_out; });
+        CHECK(ran.load() == fan_out * fan_out);
+        CHECK(on_worker.load() > 0);
+      }
+
+      SUBCASE("exceptions don't kill workers")
+      {
+        std::atomic_bool ran{};
+        pool.submit([] { throw std::runtime_error{ "expected" }; });
+        pool.submit([&] { ran.store(true); });
+        help_until(pool, [&] { return ran.load(); });
+        CHECK(ran.load());
+      }
+    }
+
+    TEST_CASE("work_stealing_executor with affinity")
+    {
+      /* Pinning may not be allowed here, but the pool needs to run everything either way. */
+      for(auto const affinity : { util::cli::executor_affinity::core,
+                                  util::cli::executor_affinity::node })
+      {
+        static constexpr usize task_count{ 1'000 };
+        work_stealing_executor pool{ 4, affinity };
+        std::atomic<usize> ran{};
+        for(usize i{}; i < task_count; ++i)
+        {
+          pool.submit([&] { ++ran; });
+        }
+        help_until(pool, [&] { return ran.load() == task_count; });
+        CHECK(ran.load() == task_count);
+      }
+    }
+
+    TEST_CASE("blocking_executor")
+    {
+      static constexpr usize task_count{ 32 };
+      blocking_executor pool;
+      std::atomic<usize> ran{};
+      std::atomic<usize> waiting{};
+
+      /* Every task blocks until all of them have started, which only works if none of
+       * them have to wait for a thread. */
+      for(usize i{}; i < task_count; ++i)
+      {
+        pool.submit([&] {
+          ++waiting;
+          while(waiting.load() < task_count)
+          {
+            std::this_thread::yield();
+          }
+          ++ran;
+        });
+      }
+      while(ran.load() < task_count)
+      {
+        std::this_thread::yield();
+      }
+      CHECK(ran.load() == task_count);
+    }
+
+    TEST_CASE("future")
+    {
+      auto const inc{ __rt_ctx->find_var("clojure.core", "inc")->deref() };
+      auto const partial{ __rt_ctx->find_var("clojure.core", "partial")->deref() };
+
+      SUBCASE("deref")
+      {
+        auto const f{ future_call(dynamic_call(partial, inc, make_box(41))) };
+        CHECK(is_future(f));
+        CHECK(equal(deref(f), make_box(42)));
+        CHECK(is_future_done(f));
+        CHECK(!future_cancel(f));
+        CHECK(!is_future_cancelled(f));
+      }
+
+      SUBCASE("cancel before running")
+      {
+        auto const f{ make_box<obj::future>(inc, obj::persistent_hash_map_ref{}) };
+        CHECK(f->cancel());
+        CHECK(f->is_cancelled());
+        CHECK(f->is_done());
+        CHECK_THROWS(f->deref());
+
+        /* A cancelled future never runs, even if the executor gets to it. */
+        f->run();
+        CHECK(f->is_cancelled());
+      }
+
+      SUBCASE("timeout")
+      {
+        auto const f{ make_box<obj::future>(inc, obj::persistent_hash_map_ref{}) };
+        CHECK(equal(f->deref(0, make_box(-1)), make_box(-1)));
+        CHECK(!f->is_done());
+      }
+    }
+  }
+}
@@ -0,0 +1,53 @@
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/seq.hpp>
+#include <jank/runtime/fn_stats.hpp>
+#include <jank/runtime/obj/jit_function.hpp>
+#include <jank/runtime/rtti.hpp>
+#include <jank/util/cli.hpp>
+#include <jank/util/scope_exit.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::runtime::fn_stats
+{
+  TEST_SUITE("fn_stats")
+  {
+    TEST_CASE("Calls are counted by name and arity")
+    {
+      util::cli::opts.fn_timing = true;
+      util::scope_exit const finally{ [] {
+        util::cli::opts.fn_timing = false;
+        reset();
+      } };
+
+      __rt_ctx->eval_string("(defn fn-stats-multi ([] 0) ([a] a))");
+      auto const fn{ expect_object<obj::jit_function>(
+        __rt_ctx->eval_string("fn-stats-multi").unwrap()) };
+      for(usize i{}; i < 5; ++i)
+      {
+        fn->call(make_box(1));
+      }
+      fn->call();
+
+      auto const &b(fn->get_stats());
+      CHECK(&b == &find_or_create(b.name));
+      CHECK(b.calls[0].load() == 1);
+      CHECK(b.calls[1].load() == 5);
+      CHECK(0 < b.cycles[1].load());
+
+      /* A second fn object of the same name adds into the same block. */
+      obj::jit_function copy{ *fn };
+      copy.stats = nullptr;
+      copy.call(make_box(2));
+      CHECK(&copy.get_stats() == &b);
+      CHECK(b.calls[1].load() == 6);
+
+      auto const stats(snapshot());
+      CHECK(2 <= sequence_length(stats));
+      reset();
+      CHECK(b.calls[1].load() == 0);
+    }
+  }
+}
@@ -0,0 +1,70 @@
+#include <filesystem>
+#include <fstream>
+
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/heap_snapshot.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::runtime::heap_snapshot
+{
+  static jtl::option<retainer> find_retainer(summary const &s, jtl::immutable_string const &name)
+  {
+    for(auto const &r : s.retainers)
+    {
+      if(r.name == name)
+      {
+        return r;
+      }
+    }
+    return none;
+  }
+
+  TEST_SUITE("heap_snapshot")
+  {
+    TEST_CASE("Round trip")
+    {
+      __rt_ctx->eval_string(R"((def heap-snapshot-big (vec (map str (range 10000))))
+                               (def heap-snapshot-small [1 2])
+                               (def heap-snapshot-shared heap-snapshot-big))");
+
+      auto const path{ std::filesystem::temp_directory_path() / "jank-heap-snapshot-test" };
+      auto const written(write(path.c_str()));
+      REQUIRE(written.is_ok());
+      auto const read_back(read(path.c_str()));
+      std::filesystem::remove(path);
+      REQUIRE(read_back.is_ok());
+
+      auto const &w(written.expect_ok());
+      auto const &r(read_back.expect_ok());
+      CHECK(w.count == r.count);
+      CHECK(w.bytes == r.bytes);
+      CHECK(w.types.size() == r.types.size());
+      CHECK(w.retainers.size() == r.retainers.size());
+
+      auto const small(find_retainer(r, "#'user/heap-snapshot-small"));
+      REQUIRE(small.is_some());
+      CHECK(small.unwrap().retained_count >= 1);
+
+      /* The vector is held by two vars, so neither of them retains it alone, but their
+       * namespace does. */
+      auto const big(find_retainer(r, "#'user/heap-snapshot-big"));
+      REQUIRE(big.is_some());
+      CHECK(big.unwrap().retained_count < 10000);
+      auto const user(find_retainer(r, "user"));
+      REQUIRE(user.is_some());
+      CHECK(user.unwrap().retained_count > 10000);
+    }
+
+    TEST_CASE("Invalid snapshots")
+    {
+      CHECK(read("/this/does/not/exist").is_err());
+
+      auto const path{ std::filesystem::temp_directory_path() / "jank-heap-snapshot-invalid" };
+      std::ofstream{ path } << "not a snapshot";
+      CHECK(read(path.c_str()).is_err());
+      std::filesystem::remove(path);
+    }
+  }
+}
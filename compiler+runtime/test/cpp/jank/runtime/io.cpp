@@ -0,0 +1,131 @@
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <filesystem>
+
+#include <jtl/string_builder.hpp>
+
+#include <jank/runtime/io.hpp>
+#include <jank/util/fmt.hpp>
+#include <jank/util/scope_exit.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::runtime::io
+{
+  static jtl::immutable_string temp_path(char const * const name)
+  {
+    return (std::filesystem::temp_directory_path() / name).c_str();
+  }
+
+  TEST_SUITE("io")
+  {
+    TEST_CASE("slurp and spit")
+    {
+      auto const path{ temp_path("jank-test-io-slurp") };
+      util::scope_exit const finally{ [&] { std::filesystem::remove(path.c_str()); } };
+
+      SUBCASE("Round trip")
+      {
+        REQUIRE(spit(path, "one\ntwo", false).is_ok());
+        CHECK(slurp(path).expect_ok() == "one\ntwo");
+      }
+
+      SUBCASE("Append")
+      {
+        REQUIRE(spit(path, "one", false).is_ok());
+        REQUIRE(spit(path, " two", true).is_ok());
+        CHECK(slurp(path).expect_ok() == "one two");
+      }
+
+      SUBCASE("Empty")
+      {
+        REQUIRE(spit(path, "", false).is_ok());
+        CHECK(slurp(path).expect_ok().empty());
+      }
+
+      SUBCASE("Missing")
+      {
+        CHECK(slurp(temp_path("jank-test-io-missing")).is_err());
+      }
+    }
+
+    TEST_CASE("slurp a pipe")
+    {
+      int fds[2]{};
+      REQUIRE(pipe(fds) == 0);
+      util::scope_exit const finally{ [&] { ::close(fds[0]); } };
+      REQUIRE(write(fds[1], "piped", 5) == 5);
+      ::close(fds[1]);
+
+      CHECK(slurp(util::format("/dev/fd/{}", fds[0])).expect_ok() == "piped");
+    }
+
+    TEST_CASE("buffered_reader")
+    {
+      auto const path{ temp_path("jank-test-io-reader") };
+      util::scope_exit const finally{ [&] { std::filesystem::remove(path.c_str()); } };
+
+      SUBCASE("Lines")
+      {
+        REQUIRE(spit(path, "one\r\ntwo\n\nthree", false).is_ok());
+        buffered_reader r{ open_file(path, O_RDONLY).expect_ok(), true, default_buffer_size };
+        for(auto const expected : { "one", "two", "", "three" })
+        {
+          auto const line(r.read_line().expect_ok());
+          REQUIRE(line.is_some());
+          CHECK(line.unwrap() == expected);
+        }
+        CHECK(r.read_line().expect_ok().is_none());
+        CHECK(r.read_line().expect_ok().is_none());
+      }
+
+      SUBCASE("Lines longer than the buffer")
+      {
+        jtl::string_builder sb;
+        for(usize i{}; i < 1000; ++i)
+        {
+          sb(i);
+        }
+        auto const long_line(sb.release());
+        REQUIRE(spit(path, util::format("{}\nshort\n{}\n", long_line, long_line), false).is_ok());
+
+        buffered_reader r{ open_file(path, O_RDONLY).expect_ok(), true, 7 };
+        CHECK(r.read_line().expect_ok().unwrap() == long_line);
+        CHECK(r.read_line().expect_ok().unwrap() == "short");
+        CHECK(r.read_line().expect_ok().unwrap() == long_line);
+        CHECK(r.read_line().expect_ok().is_none());
+      }
+    }
+
+    TEST_CASE("buffered_writer")
+    {
+      auto const path{ temp_path("jank-test-io-writer") };
+      util::scope_exit const finally{ [&] { std::filesystem::remove(path.c_str()); } };
+
+      SUBCASE("Held until flushed")
+      {
+        buffered_writer w{ open_file(path, O_WRONLY | O_CREAT | O_TRUNC).expect_ok(), true, 64 };
+        REQUIRE(w.write("held").is_ok());
+        CHECK(slurp(path).expect_ok().empty());
+        REQUIRE(w.flush().is_ok());
+        CHECK(slurp(path).expect_ok() == "held");
+        REQUIRE(w.close().is_ok());
+        CHECK(w.write("closed").is_err());
+      }
+
+      SUBCASE("Writes larger than the buffer")
+      {
+        buffered_writer w{ open_file(path, O_WRONLY | O_CREAT | O_TRUNC).expect_ok(), true, 4 };
+        REQUIRE(w.write("ab").is_ok());
+        REQUIRE(w.write("cdefgh").is_ok());
+        CHECK(slurp(path).expect_ok() == "abcdefgh");
+        REQUIRE(w.write("ij").is_ok());
+        REQUIRE(w.close().is_ok());
+        CHECK(slurp(path).expect_ok() == "abcdefghij");
+      }
+    }
+  }
+}
@@ -0,0 +1,91 @@
+#include <thread>
+
+#include <jank/runtime/isolate.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/equal.hpp>
+#include <jank/runtime/obj/number.hpp>
+#include <jank/runtime/obj/symbol.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::runtime
+{
+  TEST_SUITE("isolate")
+  {
+    TEST_CASE("namespaces")
+    {
+      auto const sym{ make_box<obj::symbol>("jank.test.isolate") };
+      isolate a, b;
+
+      a.enter();
+      auto const a_ns{ __rt_ctx->intern_ns(sym) };
+      CHECK(__rt_ctx->find_ns(sym).data == a_ns.data);
+      CHECK(__rt_ctx->find_ns(make_box<obj::symbol>("clojure.core")).is_some());
+      a.exit();
+
+      CHECK(__rt_ctx->find_ns(sym).is_nil());
+
+      b.enter();
+      CHECK(__rt_ctx->find_ns(sym).is_nil());
+      CHECK(__rt_ctx->intern_ns(sym).data != a_ns.data);
+      b.exit();
+    }
+
+    TEST_CASE("vars")
+    {
+      isolate a, b;
+
+      a.enter();
+      __rt_ctx->eval_string("(def x 1)");
+      CHECK(__rt_ctx->current_ns()->name->name == "user");
+      a.exit();
+
+      b.enter();
+      __rt_ctx->eval_string("(def x 2)");
+      b.exit();
+
+      a.enter();
+      CHECK(equal(__rt_ctx->eval_string("x").unwrap(), make_box(1)));
+      a.exit();
+
+      b.enter();
+      CHECK(equal(__rt_ctx->eval_string("x").unwrap(), make_box(2)));
+      b.exit();
+    }
+
+    TEST_CASE("current ns is kept")
+    {
+      isolate a;
+
+      a.enter();
+      __rt_ctx->eval_string("(in-ns 'jank.test.isolate.kept)");
+      a.exit();
+
+      a.enter();
+      CHECK(__rt_ctx->current_ns()->name->name == "jank.test.isolate.kept");
+      a.exit();
+    }
+
+    TEST_CASE("shared namespaces can't be changed")
+    {
+      isolate a;
+
+      a.enter();
+      CHECK(__rt_ctx->intern_owned_var("clojure.core", "jank-test-isolate").is_err());
+      a.exit();
+    }
+
+    TEST_CASE("one thread at a time")
+    {
+      isolate a, b;
+
+      a.enter();
+      CHECK_THROWS(b.enter());
+      std::thread{ [&] { CHECK_THROWS(a.enter()); } }.join();
+      a.exit();
+      CHECK_THROWS(a.exit());
+    }
+  }
+}
@@ -0,0 +1,47 @@
+#include <filesystem>
+#include <fstream>
+
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core/equal.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
+#include <jank/util/cli.hpp>
+#include <jank/util/fmt.hpp>
+#include <jank/util/scope_exit.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::runtime
+{
+  TEST_SUITE("macroexpand_cache")
+  {
+    TEST_CASE("Expansions are reused")
+    {
+      util::cli::opts.macroexpand_cache = true;
+      util::scope_exit const finally{ [] { util::cli::opts.macroexpand_cache = false; } };
+
+      auto const dir{ std::filesystem::temp_directory_path() / "jank-test-macroexpand-cache" };
+      std::filesystem::remove_all(dir);
+      std::filesystem::create_directories(dir);
+      auto const path{ dir / "expand.jank" };
+      {
+        std::ofstream ofs{ path };
+        ofs << "(let [a (and true 1) b (or nil 2)] (when (< a b) [a b]))";
+      }
+
+      static constexpr auto module{ "jank.test.macroexpand-cache" };
+      context::binding_scope const preserve{ obj::persistent_hash_map::create_unique(
+        std::make_pair(__rt_ctx->current_module_var, make_box(module))) };
+
+      auto const expected(__rt_ctx->eval_string("[1 2]").unwrap());
+      CHECK(equal(__rt_ctx->eval_file(path.c_str()).unwrap(), expected));
+      CHECK_FALSE(__rt_ctx->macro_cache.find_module(module).entries.empty());
+
+      /* The second time around, every expansion comes from the cache. */
+      CHECK(equal(__rt_ctx->eval_file(path.c_str()).unwrap(), expected));
+      CHECK(std::filesystem::exists(
+        util::format("{}/macroexpand/{}.expansions", __rt_ctx->binary_cache_dir, module).c_str()));
+    }
+  }
+}
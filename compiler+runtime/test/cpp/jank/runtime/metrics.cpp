@@ -0,0 +1,96 @@
+#include <thread>
+#include <vector>
+
+#include <jank/runtime/metrics.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core.hpp>
+#include <jank/runtime/core/equal.hpp>
+#include <jank/runtime/core/make_box.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::runtime::metrics
+{
+  TEST_SUITE("metrics")
+  {
+    TEST_CASE("histogram buckets cover every value")
+    {
+      for(u64 v{}; v < 100'000; ++v)
+      {
+        auto const index{ histogram::bucket_index(v) };
+        REQUIRE(v <= histogram::bucket_max(index));
+        if(index != 0)
+        {
+          REQUIRE(histogram::bucket_max(index - 1) < v);
+        }
+      }
+      CHECK(histogram::bucket_index(std::numeric_limits<u64>::max())
+            == histogram::bucket_count - 1);
+    }
+
+    TEST_CASE("histogram percentiles are within the precision")
+    {
+      auto const h{ find_or_create_histogram("jank_test_latency_ns", "").expect_ok() };
+      for(u64 v{ 1 }; v <= 10'000; ++v)
+      {
+        h->record(v * 1000);
+      }
+
+      auto const summary{ h->summarize() };
+      CHECK(summary.count == 10'000);
+      CHECK(summary.min == 1000);
+      CHECK(summary.max == 10'000'000);
+      CHECK(summary.percentile(100) == 10'000'000);
+      auto const p50{ static_cast<f64>(summary.percentile(50)) };
+      CHECK(5'000'000.0 <= p50);
+      CHECK(p50 <= 5'000'000.0 * 1.04);
+    }
+
+    TEST_CASE("counters add up across threads")
+    {
+      auto const c{ find_or_create_counter("jank_test_requests_total", "").expect_ok() };
+      std::vector<std::thread> threads;
+      for(usize i{}; i < 8; ++i)
+      {
+        threads.emplace_back([c] {
+          for(usize j{}; j < 1000; ++j)
+          {
+            c->add(1);
+          }
+        });
+      }
+      for(auto &t : threads)
+      {
+        t.join();
+      }
+      CHECK(c->value() == 8000);
+    }
+
+    TEST_CASE("names are unique by kind")
+    {
+      CHECK(find_or_create_gauge("jank_test_queue_depth", "").is_ok());
+      CHECK(find_or_create_gauge("jank_test_queue_depth", "").is_ok());
+      CHECK(find_or_create_counter("jank_test_queue_depth", "").is_err());
+      CHECK(find_or_create_counter("0_invalid", "").is_err());
+      CHECK(find_or_create_counter("invalid-name", "").is_err());
+    }
+
+    TEST_CASE("snapshots and prometheus text have every metric")
+    {
+      find_or_create_gauge("jank_test_temperature", "Line one\nline two")
+        .expect_ok()
+        ->set(21.5);
+
+      auto const m{ get(snapshot(), make_box("jank_test_temperature")) };
+      CHECK(equal(get(m, __rt_ctx->intern_keyword("value").expect_ok()), make_box(21.5)));
+      CHECK(get(snapshot(), make_box("jank_gc_heap_bytes")).is_some());
+
+      std::string const text{ prometheus().c_str() };
+      CHECK(text.find("# HELP jank_test_temperature Line one\\nline two\n") != std::string::npos);
+      CHECK(text.find("# TYPE jank_test_temperature gauge\n") != std::string::npos);
+      CHECK(text.find("# TYPE jank_test_latency_ns summary\n") != std::string::npos);
+      CHECK(text.find("jank_test_latency_ns_count 10000\n") != std::string::npos);
+    }
+  }
+}
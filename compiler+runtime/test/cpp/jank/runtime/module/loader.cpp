@@ -0,0 +1,219 @@
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+#include <jankzip.h>
+
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/module/loader.hpp>
+#include <jank/runtime/module/remote_cache.hpp>
+#include <jank/util/environment.hpp>
+#include <jank/util/fmt.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::runtime::module
+{
+  static void write_file(std::filesystem::path const &path, char const * const contents)
+  {
+    std::ofstream ofs{ path };
+    ofs << contents;
+  }
+
+  TEST_SUITE("module::loader")
+  {
+    TEST_CASE("cache keys")
+    {
+      auto const dir{ std::filesystem::temp_directory_path() / "jank-test-cache-keys" };
+      std::filesystem::remove_all(dir);
+      std::filesystem::create_directories(dir);
+
+      auto const source_path{ dir / "foo.jank" };
+      auto const binary_path{ dir / "foo.o" };
+      write_file(source_path, "(ns foo)");
+      write_file(binary_path, "");
+      file_entry const source{ none, source_path.c_str() };
+      file_entry const binary{ none, binary_path.c_str() };
+      auto &loader{ __rt_ctx->module_loader };
+
+      SUBCASE("depends on the source, not its timestamp")
+      {
+        auto const key{ loader.cache_key("foo", source, {}).expect_ok() };
+        CHECK_EQ(key, loader.cache_key("foo", source, {}).expect_ok());
+
+        std::filesystem::last_write_time(source_path,
+                                         std::filesystem::last_write_time(binary_path)
+                                           + std::chrono::hours{ 1 });
+        CHECK_EQ(key, loader.cache_key("foo", source, {}).expect_ok());
+
+        write_file(source_path, "(ns foo) (def bar 1)");
+        CHECK_NE(key, loader.cache_key("foo", source, {}).expect_ok());
+      }
+
+      SUBCASE("depends on the module name")
+      {
+        CHECK_NE(loader.cache_key("foo", source, {}).expect_ok(),
+                 loader.cache_key("bar", source, {}).expect_ok());
+      }
+
+      SUBCASE("missing dependencies are an error")
+      {
+        CHECK(loader.cache_key("foo", source, { "jank.test.missing-module" }).is_err());
+      }
+
+      SUBCASE("binaries are only current with a matching key")
+      {
+        CHECK(!loader.is_binary_current("foo", source, binary));
+
+        auto const key{ loader.cache_key("foo", source, {}).expect_ok() };
+        write_file(dir / "foo.o.key", util::format("{}\n", key).c_str());
+        CHECK(loader.is_binary_current("foo", source, binary));
+
+        write_file(source_path, "(ns foo) (def bar 2)");
+        CHECK(!loader.is_binary_current("foo", source, binary));
+      }
+
+      std::filesystem::remove_all(dir);
+    }
+
+    TEST_CASE("startup images")
+    {
+      auto const dir{ std::filesystem::temp_directory_path() / "jank-test-image" };
+      std::filesystem::remove_all(dir);
+      std::filesystem::create_directories(dir);
+      auto &loader{ __rt_ctx->module_loader };
+
+      auto const image_path{ dir / "app.image" };
+      write_file(dir / "current.o", "");
+      write_file(dir / "current.o.key", "abc\nclojure.core\n");
+      write_file(dir / "stale.o", "");
+      write_file(dir / "stale.o.key", "def\n");
+      write_file(image_path,
+                 util::format("jank image 1\n{}\nimage.current abc {}\nimage.stale xyz {}\n",
+                              util::binary_version(),
+                              (dir / "current.o").native(),
+                              (dir / "stale.o").native())
+                   .c_str());
+      REQUIRE(loader.read_image(image_path.c_str()).is_ok());
+
+      auto const current{ loader.find("image.current", origin::latest) };
+      REQUIRE(current.is_ok());
+      CHECK(current.expect_ok().to_load.unwrap() == module_type::o);
+      CHECK(current.expect_ok().sources.o.unwrap().path == (dir / "current.o").c_str());
+      CHECK(__rt_ctx->module_dependencies["image.current"].size() == 1);
+
+      /* Only the source is wanted here, so the image doesn't apply. */
+      CHECK(loader.find("image.current", origin::source).is_err());
+      CHECK(loader.find("image.stale", origin::latest).is_err());
+
+      write_file(image_path, "not an image\n");
+      CHECK(loader.read_image(image_path.c_str()).is_err());
+
+      loader.image_binaries.clear();
+      std::filesystem::remove_all(dir);
+    }
+
+    TEST_CASE("modules are found lazily")
+    {
+      auto const dir{ std::filesystem::temp_directory_path() / "jank-test-lazy-modules" };
+      std::filesystem::remove_all(dir);
+      std::filesystem::create_directories(dir / "lazy_dir");
+      auto &loader{ __rt_ctx->module_loader };
+      loader.add_path(dir.c_str());
+
+      CHECK(loader.find("lazy-dir.later", origin::source).is_err());
+      write_file(dir / "lazy_dir" / "later.jank", "(ns lazy-dir.later)");
+      auto const found{ loader.find("lazy-dir.later", origin::source) };
+      REQUIRE(found.is_ok());
+      CHECK(found.expect_ok().to_load.unwrap() == module_type::jank);
+
+      auto const jar_path{ dir / "lazy.jar" };
+      {
+        auto const zip{ zip_open(jar_path.c_str(), ZIP_DEFAULT_COMPRESSION_LEVEL, 'w') };
+        REQUIRE(zip);
+        zip_entry_open(zip, "lazy_jar/core.cljc");
+        char const contents[]{ "(ns lazy-jar.core)" };
+        zip_entry_write(zip, contents, sizeof(contents) - 1);
+        zip_entry_close(zip);
+        zip_close(zip);
+      }
+      loader.add_path(jar_path.c_str());
+
+      auto const in_jar{ loader.find("lazy-jar.core", origin::source) };
+      REQUIRE(in_jar.is_ok());
+      auto const &cljc{ in_jar.expect_ok().sources.cljc };
+      REQUIRE(cljc.is_some());
+      CHECK(cljc.unwrap().archive_path.unwrap() == jar_path.c_str());
+      auto const file{ loader.read_module("lazy-jar.core") };
+      REQUIRE(file.is_ok());
+      auto const view{ file.expect_ok().view() };
+      CHECK(jtl::immutable_string{ view.data(), view.size() } == "(ns lazy-jar.core)");
+
+      std::filesystem::remove_all(dir);
+    }
+
+    TEST_CASE("source hashes are prefetched")
+    {
+      auto const dir{ std::filesystem::temp_directory_path() / "jank-test-prefetch" };
+      std::filesystem::remove_all(dir);
+      std::filesystem::create_directories(dir / "prefetch");
+      auto &loader{ __rt_ctx->module_loader };
+      loader.add_path(dir.c_str());
+
+      write_file(dir / "prefetch" / "a.jank", "(ns prefetch.a (:require prefetch.b))");
+      write_file(dir / "prefetch" / "a.o", "");
+      write_file(dir / "prefetch" / "a.o.key", "abc\nprefetch.b\n");
+      write_file(dir / "prefetch" / "b.jank", "(ns prefetch.b)");
+      write_file(dir / "prefetch" / "b.o", "");
+      write_file(dir / "prefetch" / "b.o.key", "def\n");
+
+      loader.loading.emplace_back("prefetch.a");
+      loader.prefetch_source_hashes("prefetch.a");
+      CHECK(loader.source_hashes.size() == 2);
+
+      /* Within a load, the prefetched hash is used, even if the source has changed. */
+      file_entry const b{ none, (dir / "prefetch" / "b.jank").c_str() };
+      auto const hash{ loader.source_hash(b).expect_ok() };
+      write_file(dir / "prefetch" / "b.jank", "(ns prefetch.b) (def changed 1)");
+      CHECK(loader.source_hash(b).expect_ok() == hash);
+
+      loader.loading.pop_back();
+      loader.source_hashes.clear();
+      CHECK(loader.source_hash(b).expect_ok() != hash);
+      CHECK(loader.source_hashes.empty());
+
+      std::filesystem::remove_all(dir);
+    }
+
+    TEST_CASE("directory remote cache")
+    {
+      auto const dir{ std::filesystem::temp_directory_path() / "jank-test-remote-cache" };
+      std::filesystem::remove_all(dir);
+      std::filesystem::create_directories(dir);
+
+      auto const remote{ make_remote_cache(util::format("file://{}", dir.native())) };
+      CHECK(remote->get(remote_cache::store::content, "abc").is_none());
+
+      /* Binaries aren't text, so a put must keep every byte. */
+      jtl::immutable_string const binary{ "a\0b\nc", 5 };
+      remote->put(remote_cache::store::content, "abc", binary);
+      remote->put(remote_cache::store::action, "abc", "manifest");
+      CHECK(remote->get(remote_cache::store::content, "abc").unwrap() == binary);
+      CHECK(remote->get(remote_cache::store::action, "abc").unwrap() == "manifest");
+      CHECK(std::filesystem::exists(dir / "cas" / "abc"));
+      CHECK(std::filesystem::exists(dir / "ac" / "abc"));
+
+      SUBCASE("An unreachable cache is given up on")
+      {
+        std::filesystem::remove_all(dir);
+        CHECK(remote->get(remote_cache::store::content, "abc").is_none());
+        std::filesystem::create_directories(dir / "cas");
+        write_file(dir / "cas" / "abc", "back");
+        CHECK(remote->get(remote_cache::store::content, "abc").is_none());
+      }
+
+      std::filesystem::remove_all(dir);
+    }
+  }
+}
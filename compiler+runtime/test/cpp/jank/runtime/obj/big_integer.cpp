@@ -8,6 +8,7 @@
 #include <jank/runtime/obj/number.hpp>
 #include <jank/runtime/obj/ratio.hpp>
 #include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/math.hpp>
 #include <jank/runtime/rtti.hpp>
 
 /* This must go last; doctest and glog both define CHECK and family. */
@@ -420,5 +421,28 @@ namespace jank::runtime::obj
         CHECK_EQ(big_integer("0", 36, false).data, cpp_int(0));
       }
     }
+
+    TEST_CASE("small value fast paths")
+    {
+      CHECK_EQ(big_integer::add(nbi(2), nbi(3)), nbi(5));
+      CHECK_EQ(big_integer::sub(nbi(2), nbi(3)), nbi(-1));
+      CHECK_EQ(big_integer::mul(nbi(std::numeric_limits<i64>::max()), nbi(2)),
+               nbi("18446744073709551614"));
+      CHECK_EQ(big_integer::mul(nbi(std::numeric_limits<i64>::min()), nbi(-1)),
+               nbi("9223372036854775808"));
+      CHECK_EQ(big_integer::add(nbi("100000000000000000000"), nbi(1)),
+               nbi("100000000000000000001"));
+
+      i64 small{};
+      CHECK(big_integer::to_small(nbi(std::numeric_limits<i64>::min()), small));
+      CHECK_EQ(small, std::numeric_limits<i64>::min());
+      CHECK(big_integer::to_small(nbi(0), small));
+      CHECK_EQ(small, 0);
+      CHECK_FALSE(big_integer::to_small(nbi("9223372036854775808"), small));
+      CHECK_FALSE(big_integer::to_small(nbi("-9223372036854775809"), small));
+
+      CHECK_EQ(big_integer::to_f64(nbi(-42)), -42.0);
+      CHECK_EQ(big_integer::to_f64(nbi("18446744073709551615")), 18446744073709551615.0);
+    }
   }
 }
@@ -0,0 +1,77 @@
+#include <gc/gc_mark.h>
+
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/math.hpp>
+#include <jank/runtime/core/equal.hpp>
+#include <jank/runtime/rtti.hpp>
+#include <jank/runtime/obj/persistent_vector.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::runtime
+{
+  TEST_SUITE("obj::integer")
+  {
+    TEST_CASE("Small integer cache")
+    {
+      SUBCASE("Boxes within range are shared")
+      {
+        CHECK_EQ(make_box(0).erase(), make_box(0).erase());
+        CHECK_EQ(make_box(detail::small_integer_min).erase(),
+                 make_box(detail::small_integer_min).erase());
+        CHECK_EQ(make_box(detail::small_integer_max).erase(),
+                 make_box(detail::small_integer_max).erase());
+        CHECK_EQ(make_box(static_cast<usize>(7)).erase(), make_box(7ll).erase());
+      }
+
+      SUBCASE("Boxes outside of range are allocated")
+      {
+        CHECK_NE(make_box(detail::small_integer_min - 1).erase(),
+                 make_box(detail::small_integer_min - 1).erase());
+        CHECK_NE(make_box(detail::small_integer_max + 1).erase(),
+                 make_box(detail::small_integer_max + 1).erase());
+      }
+
+      SUBCASE("Cached boxes hold their value")
+      {
+        for(auto i{ detail::small_integer_min }; i <= detail::small_integer_max; ++i)
+        {
+          CHECK_EQ(make_box(i)->data, i);
+        }
+      }
+
+      SUBCASE("Arithmetic")
+      {
+        object_ref const one{ make_box(1) }, two{ make_box(2) };
+        CHECK_EQ(add(one, two), make_box(3).erase());
+        CHECK_EQ(promoting_inc(make_box(-1)), make_box(0).erase());
+        CHECK(equal(add(make_box(detail::small_integer_max).erase(), one),
+                    make_box(detail::small_integer_max + 1)));
+      }
+
+      SUBCASE("Evaluated results are shared")
+      {
+        CHECK_EQ(__rt_ctx->eval_string("(reduce + (range 10))").unwrap(), make_box(45).erase());
+      }
+    }
+
+    TEST_CASE("Pointer free allocations")
+    {
+      usize size{};
+
+      /* Integers hold no pointers, so the collector doesn't need to scan them. */
+      auto const i(make_box(detail::small_integer_max + 1));
+      CHECK_EQ(GC_get_kind_and_size(i.data, &size), GC_I_PTRFREE);
+
+      /* Nor do the bytes of a string. */
+      jtl::immutable_string const s(64, 'x');
+      CHECK_EQ(GC_get_kind_and_size(s.data(), &size), GC_I_PTRFREE);
+
+      /* Collections hold onto other objects, so they need to be scanned. */
+      auto const v(make_box<obj::persistent_vector>());
+      CHECK_EQ(GC_get_kind_and_size(v.data, &size), GC_I_NORMAL);
+    }
+  }
+}
@@ -0,0 +1,30 @@
+#include <jank/runtime/obj/keyword.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/hash.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::runtime
+{
+  TEST_SUITE("obj::keyword")
+  {
+    TEST_CASE("Hashing")
+    {
+      SUBCASE("The hash is kept from interning")
+      {
+        auto const k(__rt_ctx->intern_keyword("foo", "bar").expect_ok());
+        CHECK_EQ(k->hash, static_cast<uhash>(k->sym->to_hash() + obj::keyword::hash_magic));
+        CHECK_EQ(k->to_hash(), k->hash);
+        CHECK_EQ(hash::visit(k), k->hash);
+      }
+
+      SUBCASE("Keywords and symbols of the same name differ")
+      {
+        auto const k(__rt_ctx->intern_keyword("baz").expect_ok());
+        CHECK_NE(k->hash, make_box<obj::symbol>("baz")->to_hash());
+      }
+    }
+  }
+}
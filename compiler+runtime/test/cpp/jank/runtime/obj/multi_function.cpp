@@ -0,0 +1,108 @@
+#include <atomic>
+#include <thread>
+
+#include <gc/gc.h>
+
+#include <jank/runtime/obj/multi_function.hpp>
+#include <jank/runtime/obj/keyword.hpp>
+#include <jank/runtime/obj/number.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core.hpp>
+#include <jank/runtime/executor.hpp>
+#include <jank/runtime/core/equal.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/rtti.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::runtime::obj
+{
+  static multi_function_ref eval_multi(jtl::immutable_string const &code)
+  {
+    return expect_object<multi_function>(deref(__rt_ctx->eval_string(code).unwrap()));
+  }
+
+  TEST_SUITE("multi_function")
+  {
+    TEST_CASE("cache follows method changes")
+    {
+      auto const mm{ eval_multi(R"((do
+                                     (defmulti jank-test-mm-area :shape)
+                                     (defmethod jank-test-mm-area :square [m] (* (:n m) (:n m)))
+                                     #'jank-test-mm-area))") };
+      auto const square{ __rt_ctx->eval_string("{:shape :square :n 3}").unwrap() };
+      auto const circle{ __rt_ctx->eval_string("{:shape :circle :n 3}").unwrap() };
+
+      CHECK(equal(mm->call(square), make_box(9)));
+      /* Now it's cached. */
+      CHECK(equal(mm->call(square), make_box(9)));
+      CHECK_THROWS(mm->call(circle));
+
+      __rt_ctx->eval_string("(defmethod jank-test-mm-area :square [m] 0)").unwrap();
+      __rt_ctx->eval_string("(defmethod jank-test-mm-area :circle [m] 1)").unwrap();
+      CHECK(equal(mm->call(square), make_box(0)));
+      CHECK(equal(mm->call(circle), make_box(1)));
+
+      __rt_ctx->eval_string("(remove-method jank-test-mm-area :circle)").unwrap();
+      CHECK_THROWS(mm->call(circle));
+    }
+
+    TEST_CASE("cache follows hierarchy changes")
+    {
+      auto const mm{ eval_multi(R"((do
+                                     (defmulti jank-test-mm-kind identity)
+                                     (defmethod jank-test-mm-kind :jank.test/animal [_] :animal)
+                                     (defmethod jank-test-mm-kind :default [_] :unknown)
+                                     #'jank-test-mm-kind))") };
+      auto const dog{ __rt_ctx->intern_keyword("jank.test", "dog").expect_ok() };
+
+      CHECK(equal(mm->call(dog), __rt_ctx->intern_keyword("unknown").expect_ok()));
+      __rt_ctx->eval_string("(derive :jank.test/dog :jank.test/animal)").unwrap();
+      CHECK(equal(mm->call(dog), __rt_ctx->intern_keyword("animal").expect_ok()));
+    }
+
+    TEST_CASE("concurrent dispatch while adding methods")
+    {
+      static constexpr usize thread_count{ 4 };
+      static constexpr usize calls{ 10'000 };
+
+      auto const mm{ eval_multi(R"((do
+                                     (defmulti jank-test-mm-concurrent identity)
+                                     (defmethod jank-test-mm-concurrent 0 [x] x)
+                                     #'jank-test-mm-concurrent))") };
+
+      GC_allow_register_threads();
+      std::atomic<usize> bad_calls{};
+      std::vector<std::thread> threads;
+      for(usize i{}; i < thread_count; ++i)
+      {
+        threads.emplace_back([&] {
+          gc_thread_scope const scope;
+          auto const zero{ make_box(0) };
+          for(usize n{}; n < calls; ++n)
+          {
+            if(!equal(mm->call(zero), zero))
+            {
+              ++bad_calls;
+            }
+          }
+        });
+      }
+
+      /* Each of these throws away the cache which the threads are reading. */
+      for(i64 i{ 1 }; i < 100; ++i)
+      {
+        mm->add_method(make_box(i), __rt_ctx->eval_string("identity").unwrap());
+      }
+
+      for(auto &t : threads)
+      {
+        t.join();
+      }
+
+      CHECK(bad_calls.load() == 0);
+      CHECK(equal(mm->call(make_box(42)), make_box(42)));
+    }
+  }
+}
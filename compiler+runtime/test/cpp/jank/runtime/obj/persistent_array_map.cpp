@@ -1,6 +1,11 @@
 #include <jank/runtime/obj/persistent_array_map.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
 #include <jank/runtime/obj/persistent_vector.hpp>
+#include <jank/runtime/obj/number.hpp>
+#include <jank/runtime/context.hpp>
 #include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/seq.hpp>
+#include <jank/runtime/rtti.hpp>
 
 /* This must go last; doctest and glog both define CHECK and family. */
 #include <doctest/doctest.h>
@@ -55,5 +60,64 @@ namespace jank::runtime::obj
 
       CHECK(pv->type == object_type::persistent_hash_map);
     }
+
+    TEST_CASE("lookups")
+    {
+      auto const a{ __rt_ctx->intern_keyword("jank.test.array-map/a").expect_ok() };
+      auto const b{ __rt_ctx->intern_keyword("jank.test.array-map/b").expect_ok() };
+      auto const c{ __rt_ctx->intern_keyword("jank.test.array-map/c").expect_ok() };
+
+      jank::runtime::detail::native_array_map data{};
+      data.insert_unique(a, make_box(1));
+      data.insert_unique(make_box(2), make_box(2));
+      data.insert_unique(b, make_box(3));
+      data.insert_unique(make_box<persistent_string>("d"), make_box(4));
+
+      CHECK(expect_object<integer>(data.find(a).unwrap())->data == 1);
+      CHECK(expect_object<integer>(data.find(b).unwrap())->data == 3);
+      CHECK(data.find(c).is_none());
+      CHECK(expect_object<integer>(data.find(make_box(2)).unwrap())->data == 2);
+      CHECK(expect_object<integer>(data.find(make_box<persistent_string>("d")).unwrap())->data
+            == 4);
+      CHECK(data.find(make_box(3)).is_none());
+
+      SUBCASE("insert_or_assign")
+      {
+        data.insert_or_assign(b, make_box(5));
+        data.insert_or_assign(make_box(2), make_box(6));
+        data.insert_or_assign(c, make_box(7));
+        CHECK(data.size() == 5);
+        CHECK(expect_object<integer>(data.find(b).unwrap())->data == 5);
+        CHECK(expect_object<integer>(data.find(make_box(2)).unwrap())->data == 6);
+        CHECK(expect_object<integer>(data.find(c).unwrap())->data == 7);
+      }
+
+      SUBCASE("erase")
+      {
+        data.erase(a);
+        data.erase(c);
+        CHECK(data.size() == 3);
+        CHECK(data.find(a).is_none());
+        CHECK(expect_object<integer>(data.find(b).unwrap())->data == 3);
+
+        data.erase(make_box(2));
+        CHECK(data.size() == 2);
+        CHECK(data.find(make_box(2)).is_none());
+        CHECK(expect_object<integer>(data.find(make_box<persistent_string>("d")).unwrap())->data
+              == 4);
+      }
+    }
+
+    TEST_CASE("promotion at max_size")
+    {
+      object_ref m{ persistent_array_map::empty() };
+      for(usize i{}; i < persistent_array_map::max_size; ++i)
+      {
+        m = runtime::assoc(m, make_box(i), make_box(i));
+      }
+      CHECK(m->type == object_type::persistent_array_map);
+      m = runtime::assoc(m, make_box(-1), make_box(-1));
+      CHECK(m->type == object_type::persistent_hash_map);
+    }
   }
 }
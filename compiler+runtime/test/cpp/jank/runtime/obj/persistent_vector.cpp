@@ -1,6 +1,9 @@
+#include <array>
+
 #include <jank/runtime/obj/persistent_vector.hpp>
 #include <jank/runtime/core/make_box.hpp>
 #include <jank/runtime/core/equal.hpp>
+#include <jank/runtime/convert/builtin.hpp>
 
 /* This must go last; doctest and glog both define CHECK and family. */
 #include <doctest/doctest.h>
@@ -81,5 +84,42 @@ namespace jank::runtime::obj
       CHECK(!equal(make_box<persistent_vector>(std::in_place, make_box('f'), make_box('o')).erase(),
                    make_box<persistent_vector>(std::in_place, make_box('f')).erase()));
     }
+
+    TEST_CASE("contiguous_data")
+    {
+      auto const small(v->contiguous_data());
+      REQUIRE(small.is_some());
+      CHECK_EQ(small.unwrap().size(), 7);
+      CHECK(equal(small.unwrap()[0], min_char));
+
+      persistent_vector::value_type big;
+      for(i64 i{}; i < 100; ++i)
+      {
+        big = big.push_back(make_box(i));
+      }
+      CHECK(make_box<persistent_vector>(std::move(big))->contiguous_data().is_none());
+    }
+
+    TEST_CASE("span views")
+    {
+      SUBCASE("vector to span")
+      {
+        auto const span(convert<std::span<object_ref const>>::from_object(v));
+        CHECK_EQ(span.data(), v->contiguous_data().unwrap().data());
+      }
+
+      SUBCASE("span to array and back")
+      {
+        std::array<i64, 4> buffer{ 1, 2, 3, 4 };
+        auto const o(convert<std::span<i64>>::into_object(buffer));
+        auto const a(expect_object<array>(o));
+        CHECK_EQ(a->data, buffer.data());
+
+        a->set(0, make_box(10));
+        CHECK_EQ(buffer[0], 10);
+        CHECK_EQ(convert<std::span<i64>>::from_object(o).data(), buffer.data());
+        CHECK_THROWS(convert<std::span<f64>>::from_object(o));
+      }
+    }
   }
 }
@@ -1,4 +1,5 @@
 #include <stdexcept>
+#include <limits>
 #include <cmath>
 
 #include <jank/runtime/obj/ratio.hpp>
@@ -305,6 +306,56 @@ namespace jank::runtime
       }
     }
 
+    TEST_CASE("Small parts promote on overflow")
+    {
+      auto const max{ std::numeric_limits<i64>::max() };
+      auto const min{ std::numeric_limits<i64>::min() };
+      obj::ratio_data const a{ max, 2 }, b{ max, 3 };
+
+      SUBCASE("Addition")
+      {
+        auto const result{ expect_object<obj::ratio>(a + b) };
+        CHECK_EQ(result->data.numerator, native_big_integer{ max } * 5);
+        CHECK_EQ(result->data.denominator, 6);
+      }
+      SUBCASE("Subtraction")
+      {
+        auto const result{ expect_object<obj::ratio>(obj::ratio_data{ min, 3 } - a) };
+        CHECK_EQ(result->data.numerator,
+                 (native_big_integer{ min } * 2) - (native_big_integer{ max } * 3));
+        CHECK_EQ(result->data.denominator, 6);
+      }
+      SUBCASE("Multiplication")
+      {
+        auto const result{ expect_object<obj::ratio>(a * b) };
+        CHECK_EQ(result->data.numerator, native_big_integer{ max } * max);
+        CHECK_EQ(result->data.denominator, 6);
+      }
+      SUBCASE("Division to integer")
+      {
+        auto const result{ a / obj::ratio_data{ 1, 2 } };
+        CHECK_EQ(result->type, object_type::integer);
+        CHECK_EQ(expect_object<obj::integer>(result)->data, max);
+      }
+      SUBCASE("Negating the min")
+      {
+        auto const result{ obj::ratio::create(min, -1) };
+        CHECK_EQ(result->type, object_type::big_integer);
+        CHECK_EQ(expect_object<obj::big_integer>(result)->data, -native_big_integer{ min });
+      }
+      SUBCASE("Comparison")
+      {
+        CHECK(b < a);
+        CHECK(obj::ratio_data(min, max) < obj::ratio_data(min + 1, max));
+      }
+      SUBCASE("Normalizing with even parts")
+      {
+        obj::ratio_data const ratio{ 1ll << 40, -(1ll << 62) };
+        CHECK_EQ(ratio.numerator, -1);
+        CHECK_EQ(ratio.denominator, 1ll << 22);
+      }
+    }
+
     TEST_CASE("Constructor")
     {
       auto const a{ expect_object<obj::ratio>(obj::ratio::create(3, 4)) };
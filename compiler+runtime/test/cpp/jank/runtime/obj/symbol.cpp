@@ -0,0 +1,56 @@
+#include <jank/runtime/obj/symbol.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/equal.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::runtime
+{
+  TEST_SUITE("obj::symbol")
+  {
+    TEST_CASE("Interning")
+    {
+      SUBCASE("Equal symbols share one object")
+      {
+        auto const a(__rt_ctx->intern_symbol("foo", "bar"));
+        auto const b(__rt_ctx->intern_symbol("foo/bar"));
+        CHECK_EQ(a.data, b.data);
+        CHECK(a->meta.is_none());
+        CHECK(a->equal(*make_box<obj::symbol>("foo", "bar")));
+      }
+
+      SUBCASE("Unqualified")
+      {
+        auto const a(__rt_ctx->intern_symbol("", "baz"));
+        CHECK_EQ(a.data, __rt_ctx->intern_symbol("baz").data);
+        CHECK(a->ns.empty());
+        CHECK_NE(a.data, __rt_ctx->intern_symbol("foo", "baz").data);
+      }
+
+      SUBCASE("Only a slash is a name")
+      {
+        auto const a(__rt_ctx->intern_symbol("/"));
+        CHECK(a->ns.empty());
+        CHECK_EQ(a->name, "/");
+      }
+    }
+
+    TEST_CASE("Equality")
+    {
+      auto const a(make_box<obj::symbol>("foo", "bar"));
+      auto const b(make_box<obj::symbol>("foo", "bar"));
+      auto const c(make_box<obj::symbol>("foo", "baz"));
+
+      /* Once hashed, unequal hashes are a quick no. */
+      a->to_hash();
+      c->to_hash();
+      CHECK(equal(a, b));
+      CHECK(equal(b, a));
+      CHECK(!equal(a, c));
+      CHECK(equal(a, a));
+      CHECK(*a == *b);
+    }
+  }
+}
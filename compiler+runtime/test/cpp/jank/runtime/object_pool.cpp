@@ -0,0 +1,56 @@
+#include <gc/gc.h>
+#include <gc/gc_mark.h>
+
+#include <jank/runtime/object_pool.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/obj/cons.hpp>
+#include <jank/runtime/obj/number.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::runtime
+{
+  TEST_SUITE("object_pool")
+  {
+    TEST_CASE("Pooled boxes come from the thread's free lists")
+    {
+      auto const before(pool_stats());
+
+      obj::cons *first{};
+      for(usize i{}; i < 1'000; ++i)
+      {
+        auto const c(make_box<obj::cons>(make_box(static_cast<i64>(i)), jank_nil()));
+        if(!first)
+        {
+          first = c.data;
+        }
+        int kind{};
+        GC_get_kind_and_size(c.data, &kind);
+        CHECK(kind == GC_I_NORMAL);
+      }
+
+      auto const after(pool_stats());
+      CHECK(after.allocations - before.allocations == 1'000);
+      /* Each refill brings in a whole batch, so most allocations are hits. */
+      CHECK(after.refills - before.refills < 100);
+
+      /* Pooled objects are still collected like any other, so anything reachable stays
+       * put. */
+      GC_gcollect();
+      CHECK(first->head->type == object_type::integer);
+    }
+
+    TEST_CASE("Pooled memory is zeroed")
+    {
+      for(usize i{}; i < 100; ++i)
+      {
+        auto const p(static_cast<char *>(pool_allocate(sizeof(obj::cons))));
+        for(usize b{}; b < sizeof(obj::cons); ++b)
+        {
+          CHECK(p[b] == 0);
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,72 @@
+#include <jank/runtime/regex.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::runtime::regex
+{
+  static program const &compile_ok(jtl::immutable_string const &pattern)
+  {
+    auto const res(compile(pattern));
+    REQUIRE(res.is_ok());
+    return *res.expect_ok();
+  }
+
+  TEST_SUITE("regex")
+  {
+    TEST_CASE("Compiling")
+    {
+      CHECK(compile("(unclosed").is_err());
+      CHECK(group_count(compile_ok("a(b)(c)?")) == 2);
+
+      /* The same pattern gives the same program. */
+      CHECK(compile("x+y").expect_ok() == compile("x+y").expect_ok());
+      CHECK(compile("x+y").expect_ok() != compile("x+z").expect_ok());
+    }
+
+    TEST_CASE("Searching")
+    {
+      auto const &p(compile_ok("(\\d+)(px)?"));
+      native_vector<span> groups;
+
+      CHECK(!search(p, "no digits", 0, anchor::none, groups));
+
+      REQUIRE(search(p, "at 12em and 7px", 0, anchor::none, groups));
+      REQUIRE(groups.size() == 3);
+      CHECK(groups[0].offset == 3);
+      CHECK(groups[0].size == 2);
+      CHECK(groups[1].matched);
+      CHECK(!groups[2].matched);
+
+      REQUIRE(search(p, "at 12em and 7px", 5, anchor::none, groups));
+      CHECK(groups[0].offset == 12);
+      CHECK(groups[0].size == 3);
+      CHECK(groups[2].matched);
+      CHECK(groups[2].offset == 13);
+    }
+
+    TEST_CASE("Context before the start")
+    {
+      auto const &p(compile_ok("\\bb"));
+      native_vector<span> groups;
+
+      /* The b at 1 isn't at a word boundary, even though we start looking there. */
+      CHECK(!search(p, "ab", 1, anchor::none, groups));
+      CHECK(search(p, "a b", 1, anchor::none, groups));
+    }
+
+    TEST_CASE("Anchors")
+    {
+      auto const &p(compile_ok("\\d+"));
+      native_vector<span> groups;
+
+      CHECK(search(p, "a12", 0, anchor::none, groups));
+      CHECK(!search(p, "a12", 0, anchor::start, groups));
+      CHECK(search(p, "a12", 1, anchor::start, groups));
+      CHECK(!search(p, "12a", 0, anchor::both, groups));
+      REQUIRE(search(p, "a12", 1, anchor::both, groups));
+      CHECK(groups[0].offset == 1);
+      CHECK(groups[0].size == 2);
+    }
+  }
+}
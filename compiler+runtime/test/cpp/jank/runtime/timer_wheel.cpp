@@ -0,0 +1,102 @@
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include <jank/runtime/timer_wheel.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::runtime
+{
+  using namespace std::chrono_literals;
+
+  template <typename F>
+  static bool wait_until(F const &done)
+  {
+    auto const until{ std::chrono::steady_clock::now() + 10s };
+    while(!done())
+    {
+      if(until < std::chrono::steady_clock::now())
+      {
+        return false;
+      }
+      std::this_thread::sleep_for(1ms);
+    }
+    return true;
+  }
+
+  TEST_SUITE("timer_wheel")
+  {
+    TEST_CASE("runs timers once they're due")
+    {
+      timer_wheel wheel;
+      std::atomic<usize> ran{};
+      auto const start{ std::chrono::steady_clock::now() };
+      std::atomic<std::chrono::steady_clock::duration> elapsed{};
+      wheel.schedule(20ms, 0ms, [&] {
+        elapsed = std::chrono::steady_clock::now() - start;
+        ++ran;
+      });
+      CHECK(wait_until([&] { return ran.load() == 1; }));
+      CHECK(20ms <= elapsed.load());
+      CHECK(wheel.pending_count() == 0);
+    }
+
+    TEST_CASE("runs timers in deadline order, across levels")
+    {
+      timer_wheel wheel;
+      std::mutex mutex;
+      native_vector<int> order;
+      /* 300ms is past the first level, so it's cascaded before it runs. */
+      for(auto const [delay, id] : { std::pair{ 300ms, 3 }, { 5ms, 1 }, { 40ms, 2 } })
+      {
+        wheel.schedule(delay, 0ms, [&, id] {
+          std::lock_guard<std::mutex> const lock{ mutex };
+          order.emplace_back(id);
+        });
+      }
+      CHECK(wait_until([&] {
+        std::lock_guard<std::mutex> const lock{ mutex };
+        return order.size() == 3;
+      }));
+      CHECK(order == native_vector<int>{ 1, 2, 3 });
+    }
+
+    TEST_CASE("cancelled timers don't run")
+    {
+      timer_wheel wheel;
+      std::atomic<usize> ran{};
+      native_vector<timer_wheel::timer *> timers;
+      static constexpr usize timer_count{ 100'000 };
+      for(usize i{}; i < timer_count; ++i)
+      {
+        timers.emplace_back(wheel.schedule(std::chrono::milliseconds{ 50 + i % 1000 }, 0ms, [&] {
+          ++ran;
+        }));
+      }
+      CHECK(wheel.pending_count() == timer_count);
+      for(usize i{}; i < timer_count; i += 2)
+      {
+        CHECK(wheel.cancel(timers[i]));
+      }
+      CHECK(!wheel.cancel(timers[0]));
+      CHECK(wait_until([&] { return ran.load() == timer_count / 2; }));
+      CHECK(wheel.pending_count() == 0);
+    }
+
+    TEST_CASE("periodic timers run until cancelled")
+    {
+      timer_wheel wheel;
+      std::atomic<usize> ran{};
+      auto * const t{ wheel.schedule(0ms, 5ms, [&] { ++ran; }) };
+      CHECK(wait_until([&] { return 3 <= ran.load(); }));
+      CHECK(wheel.cancel(t));
+      auto const after_cancel{ ran.load() };
+      std::this_thread::sleep_for(30ms);
+      CHECK(ran.load() <= after_cancel + 1);
+      CHECK(wheel.pending_count() == 0);
+    }
+  }
+}
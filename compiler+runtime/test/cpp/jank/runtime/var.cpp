@@ -0,0 +1,170 @@
+#include <thread>
+
+#include <jank/runtime/var.hpp>
+#include <jank/runtime/ns.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/equal.hpp>
+#include <jank/runtime/rtti.hpp>
+#include <jank/runtime/obj/number.hpp>
+#include <jank/runtime/obj/nil.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
+#include <jank/runtime/obj/symbol.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::runtime
+{
+  TEST_SUITE("var")
+  {
+    TEST_CASE("bind_root")
+    {
+      auto const v{ __rt_ctx->intern_var("jank.test.var", "bind-root").expect_ok() };
+      auto const version{ v->get_root_version() };
+
+      v->bind_root(make_box(1));
+      CHECK(equal(v->deref(), make_box(1)));
+      CHECK(equal(v->get_root(), make_box(1)));
+      CHECK(v->get_root_version() == version + 1);
+
+      v->bind_root(make_box(2));
+      CHECK(equal(v->deref(), make_box(2)));
+      CHECK(v->get_root_version() == version + 2);
+    }
+
+    TEST_CASE("alter_root")
+    {
+      auto const v{ __rt_ctx->intern_var("jank.test.var", "alter-root").expect_ok() };
+      auto const inc{ __rt_ctx->find_var("clojure.core", "inc") };
+      v->bind_root(make_box(41));
+      auto const version{ v->get_root_version() };
+
+      CHECK(equal(v->alter_root(inc->deref(), jank_nil()), make_box(42)));
+      CHECK(equal(v->deref(), make_box(42)));
+      CHECK(v->get_root_version() == version + 1);
+    }
+
+    TEST_CASE("bind_lazy_root")
+    {
+      static int inits{};
+      inits = 0;
+      auto const v{ __rt_ctx->intern_var("jank.test.var", "lazy-root").expect_ok() };
+      v->bind_lazy_root([]() -> object * {
+        ++inits;
+        return make_box(42).erase().data;
+      });
+      CHECK(inits == 0);
+
+      CHECK(equal(v->deref(), make_box(42)));
+      CHECK(equal(v->get_root(), make_box(42)));
+      CHECK(v->is_bound());
+      CHECK(inits == 1);
+
+      SUBCASE("Altering initializes first")
+      {
+        auto const inc{ __rt_ctx->find_var("clojure.core", "inc") };
+        v->bind_lazy_root([]() -> object * {
+          ++inits;
+          return make_box(1).erase().data;
+        });
+        CHECK(equal(v->alter_root(inc->deref(), jank_nil()), make_box(2)));
+        CHECK(inits == 2);
+      }
+    }
+
+    TEST_CASE("intern_vars")
+    {
+      auto const ns{ __rt_ctx->intern_ns("jank.test.var") };
+      auto const existing{ ns->intern_var("interned-before") };
+      auto const vars{ ns->intern_vars({ make_box<obj::symbol>("", "interned-a"),
+                                         make_box<obj::symbol>("jank.test.var", "interned-b"),
+                                         make_box<obj::symbol>("", "interned-before") }) };
+
+      REQUIRE(vars.size() == 3);
+      CHECK(vars[0] == ns->find_var(make_box<obj::symbol>("", "interned-a")));
+      CHECK(vars[1] == ns->find_var(make_box<obj::symbol>("", "interned-b")));
+      CHECK(vars[2] == existing);
+      CHECK(vars[1]->n == ns);
+    }
+
+    TEST_CASE("thread bindings")
+    {
+      auto const v{ __rt_ctx->intern_var("jank.test.var", "thread-bound").expect_ok() };
+      v->bind_root(make_box(0));
+      v->set_dynamic(true);
+
+      __rt_ctx
+        ->push_thread_bindings(
+          obj::persistent_hash_map::create_unique(std::make_pair(v, make_box(1))))
+        .expect_ok();
+      CHECK(equal(v->deref(), make_box(1)));
+      /* Setting changes the binding in place, so the cached lookup must still see it. */
+      CHECK(v->set(make_box(2)).is_ok());
+      CHECK(equal(v->deref(), make_box(2)));
+
+      __rt_ctx
+        ->push_thread_bindings(
+          obj::persistent_hash_map::create_unique(std::make_pair(v, make_box(3))))
+        .expect_ok();
+      CHECK(equal(v->deref(), make_box(3)));
+      __rt_ctx->pop_thread_bindings().expect_ok();
+      CHECK(equal(v->deref(), make_box(2)));
+
+      __rt_ctx->pop_thread_bindings().expect_ok();
+      CHECK(equal(v->deref(), make_box(0)));
+      CHECK(v->get_thread_binding().is_nil());
+    }
+
+    TEST_CASE("concurrent deref while rebinding")
+    {
+      static constexpr i64 writes{ 10'000 };
+      static constexpr usize reader_count{ 4 };
+
+      auto const v{ __rt_ctx->intern_var("jank.test.var", "concurrent").expect_ok() };
+      v->bind_root(make_box(0));
+
+      /* The readers aren't registered with the GC, so we keep every root alive up front. */
+      native_vector<object_ref> roots;
+      roots.reserve(writes + 1);
+      for(i64 i{}; i <= writes; ++i)
+      {
+        roots.emplace_back(make_box(i));
+      }
+
+      std::atomic_bool done{};
+      std::atomic<usize> bad_reads{};
+      std::vector<std::thread> readers;
+      for(usize i{}; i < reader_count; ++i)
+      {
+        readers.emplace_back([&] {
+          i64 last{};
+          while(!done.load())
+          {
+            /* Roots are only ever increasing, so a reader must never see one go backward. */
+            auto const current{ expect_object<obj::integer>(v->deref())->data };
+            if(current < last)
+            {
+              ++bad_reads;
+            }
+            last = current;
+          }
+        });
+      }
+
+      for(i64 i{ 1 }; i <= writes; ++i)
+      {
+        v->bind_root(roots[i]);
+      }
+      done.store(true);
+
+      for(auto &reader : readers)
+      {
+        reader.join();
+      }
+
+      CHECK(bad_reads.load() == 0);
+      CHECK(equal(v->deref(), make_box(writes)));
+    }
+  }
+}
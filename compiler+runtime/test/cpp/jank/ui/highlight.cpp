@@ -0,0 +1,90 @@
+#include <string>
+
+#include <ftxui/dom/node.hpp>
+
+#include <jank/ui/highlight.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::ui
+{
+  static std::string numbered_forms(usize const count)
+  {
+    std::string ret;
+    for(usize i{}; i < count; ++i)
+    {
+      ret += "(def value-" + std::to_string(i) + " {:n " + std::to_string(i) + "})\n";
+    }
+    return ret;
+  }
+
+  static void update(incremental_highlighter &h, std::string const &code)
+  {
+    h.update({ code.data(), code.size() });
+  }
+
+  TEST_SUITE("incremental_highlighter")
+  {
+    TEST_CASE("first update lexes everything")
+    {
+      incremental_highlighter h;
+      auto const code{ numbered_forms(50) };
+      update(h, code);
+      /* The last line is the empty one after the final new line. */
+      CHECK(h.line_count() == 51);
+      CHECK(h.relexed_line_count() == 51);
+      CHECK(h.highlight(1, 100).size() == 51);
+      CHECK(h.highlight(10, 12).size() == 3);
+    }
+
+    TEST_CASE("edits only lex until the state is the same")
+    {
+      incremental_highlighter h;
+      auto code{ numbered_forms(50) };
+      update(h, code);
+
+      SUBCASE("within a line")
+      {
+        code.insert(code.find(":n 20") + 3, "2");
+        update(h, code);
+        CHECK(h.line_count() == 51);
+        CHECK(h.relexed_line_count() <= 2);
+      }
+
+      SUBCASE("adding a line")
+      {
+        auto const at{ code.find("(def value-30") };
+        code.insert(at, "(def extra 1)\n");
+        update(h, code);
+        CHECK(h.line_count() == 52);
+        CHECK(h.relexed_line_count() <= 3);
+        CHECK(h.highlight(52, 52).size() == 1);
+      }
+
+      SUBCASE("removing a line")
+      {
+        auto const at{ code.find("(def value-30") };
+        code.erase(at, code.find('\n', at) + 1 - at);
+        update(h, code);
+        CHECK(h.line_count() == 50);
+        CHECK(h.relexed_line_count() <= 2);
+      }
+
+      SUBCASE("opening a string changes everything after it")
+      {
+        code.insert(code.find("(def value-40"), "\"");
+        code += "\"";
+        update(h, code);
+        CHECK(h.line_count() == 51);
+        CHECK(11 <= h.relexed_line_count());
+      }
+
+      SUBCASE("nothing changed")
+      {
+        update(h, code);
+        CHECK(h.relexed_line_count() == 0);
+      }
+    }
+  }
+}
@@ -0,0 +1,71 @@
+#include <string>
+
+#include <jank/util/string.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::util
+{
+  /* Long enough that each kernel goes through a few vector blocks and then a scalar tail. */
+  static std::string const long_input{
+    "   \t\n  The quick brown fox jumps over the lazy dog, then naps by the river bank.  \r\n "
+  };
+
+  TEST_SUITE("util::string")
+  {
+    TEST_CASE("find")
+    {
+      std::string const haystack{ long_input };
+      for(auto const needle : { "", "T", "fox", "dog, then", "bank.", "bank!", "  \r\n " })
+      {
+        std::string const n{ needle };
+        for(usize pos{}; pos <= haystack.size() + 1; ++pos)
+        {
+          CAPTURE(needle);
+          CAPTURE(pos);
+          auto const expected(haystack.find(n, pos));
+          CHECK_EQ(expected == std::string::npos ? jtl::immutable_string_view::npos : expected,
+                   util::find(haystack, n, pos));
+        }
+      }
+    }
+
+    TEST_CASE("find_non_space")
+    {
+      CHECK_EQ(0, find_non_space(std::string{ "" }));
+      CHECK_EQ(3, find_non_space(std::string{ " \t\n" }));
+      CHECK_EQ(0, find_non_space(std::string{ "x  " }));
+      CHECK_EQ(7, find_non_space(long_input));
+      CHECK_EQ(40, find_non_space(std::string(40, ' ') + "\xc3\xa9"));
+    }
+
+    TEST_CASE("rfind_non_space")
+    {
+      CHECK_EQ(0, rfind_non_space(std::string{ "" }));
+      CHECK_EQ(0, rfind_non_space(std::string{ " \t\n" }));
+      CHECK_EQ(1, rfind_non_space(std::string{ "x  " }));
+      CHECK_EQ(long_input.size() - 5, rfind_non_space(long_input));
+      CHECK_EQ(2, rfind_non_space(std::string{ "\xc3\xa9" } + std::string(40, '\v')));
+    }
+
+    TEST_CASE("ASCII case")
+    {
+      std::string out(long_input.size(), '\0');
+      REQUIRE(ascii_to_uppercase(long_input, out.data()));
+      CHECK_EQ(
+        "   \t\n  THE QUICK BROWN FOX JUMPS OVER THE LAZY DOG, THEN NAPS BY THE RIVER BANK.  \r\n ",
+        out);
+      REQUIRE(ascii_to_lowercase(out, out.data()));
+      CHECK_EQ(
+        "   \t\n  the quick brown fox jumps over the lazy dog, then naps by the river bank.  \r\n ",
+        out);
+
+      /* Anything outside of ASCII isn't ours to convert. */
+      std::string const unicode{ long_input + "\xc3\xa9" };
+      std::string unicode_out(unicode.size(), '\0');
+      CHECK(!ascii_to_lowercase(unicode, unicode_out.data()));
+      CHECK(!ascii_to_uppercase(std::string{ "\xc3\xa9" } + long_input, unicode_out.data()));
+    }
+  }
+}
@@ -1,4 +1,7 @@
+#include <string>
+
 #include <jtl/immutable_string.hpp>
+#include <jank/hash.hpp>
 
 /* This must go last; doctest and glog both define CHECK and family. */
 #include <doctest/doctest.h>
@@ -200,6 +203,76 @@ TEST_CASE("Substring")
       CHECK_EQ(sub, "o b");
     }
   }
+
+  SUBCASE("Sharing")
+  {
+    jtl::immutable_string const s{ 4096, 'x' };
+
+    SUBCASE("Large slice")
+    {
+      auto const sub(s.substr(1024, 1024));
+      CHECK_EQ(sub.size(), 1024);
+      CHECK_EQ(sub.data(), s.data() + 1024);
+    }
+
+    SUBCASE("Tiny slice")
+    {
+      auto const sub(s.substr(1024, 100));
+      CHECK_EQ(sub.size(), 100);
+      CHECK_NE(sub.data(), s.data() + 1024);
+    }
+
+    SUBCASE("Tiny shared slice")
+    {
+      auto const sub(s.shared_substr(1024, 100));
+      CHECK_EQ(sub.size(), 100);
+      CHECK_EQ(sub.data(), s.data() + 1024);
+      CHECK_EQ(sub, jtl::immutable_string{ 100, 'x' });
+    }
+  }
+}
+
+TEST_CASE("Hash")
+{
+  SUBCASE("Small")
+  {
+    jtl::immutable_string const s{ "foo bar" };
+    CHECK_EQ(s.to_hash(), jtl::immutable_string{ "foo bar" }.to_hash());
+    CHECK_EQ(s.to_hash(), s.to_hash());
+    CHECK_NE(s.to_hash(), jtl::immutable_string{ "foo baz" }.to_hash());
+  }
+
+  SUBCASE("Long")
+  {
+    jtl::immutable_string const s{ "foo bar spam meow foo bar spam meow" };
+    auto const hash(s.to_hash());
+    jtl::immutable_string const copy{ s };
+    CHECK_EQ(copy.to_hash(), hash);
+    CHECK_EQ(jtl::immutable_string{ "foo bar spam meow foo bar spam meow" }.to_hash(), hash);
+  }
+
+  SUBCASE("Substring of a hashed string")
+  {
+    jtl::immutable_string const s{ "foo bar spam meow foo bar spam meow" };
+    s.to_hash();
+    auto const sub(s.substr(4));
+    CHECK_EQ(sub.to_hash(), jtl::immutable_string{ "bar spam meow foo bar spam meow" }.to_hash());
+  }
+
+  SUBCASE("Same as one byte at a time")
+  {
+    std::string data;
+    for(usize length{}; length < 40; ++length)
+    {
+      uhash expected{};
+      for(auto const c : data)
+      {
+        expected = (31 * expected) + (c & 0xff);
+      }
+      CHECK_EQ(jtl::immutable_string{ data }.to_hash(), jank::hash::integer(expected));
+      data.push_back(static_cast<char>(0x61 + (length * 37) % 150));
+    }
+  }
 }
 }
 ;
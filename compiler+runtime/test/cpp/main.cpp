@@ -14,6 +14,15 @@
 #include <jank/runtime/core/to_string.hpp>
 #include <jank/util/fmt/print.hpp>
 #include <jank/error/report.hpp>
+#include <jank/perf_native.hpp>
+#include <jank/math_native.hpp>
+#include <jank/columnar_native.hpp>
+#include <jank/async_native.hpp>
+#include <jank/cache_native.hpp>
+#include <jank/binary_native.hpp>
+#include <jank/mapped_native.hpp>
+#include <jank/reload_native.hpp>
+#include <jank/io_async_native.hpp>
 #include <clojure/core_native.hpp>
 
 #ifdef JANK_PHASE_2
@@ -30,6 +39,15 @@ try
     context.setOption("no-breaks", true);
 
     jank_load_clojure_core_native();
+    jank_load_jank_perf_native();
+    jank_load_jank_math_native();
+    jank_load_jank_columnar_native();
+    jank_load_jank_async_native();
+    jank_load_jank_cache_native();
+    jank_load_jank_binary_native();
+    jank_load_jank_mapped_native();
+    jank_load_jank_reload_native();
+    jank_load_jank_io_async_native();
 
 #ifdef JANK_PHASE_2
     jank_load_clojure_core();
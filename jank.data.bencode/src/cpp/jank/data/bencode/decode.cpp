@@ -1,4 +1,13 @@
-#include <stack>
+#include <jtl/immutable_string.hpp>
+
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/convert/function.hpp>
+#include <jank/runtime/core.hpp>
+#include <jank/runtime/obj/opaque_box.hpp>
+#include <jank/runtime/obj/persistent_array_map.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
+#include <jank/runtime/obj/persistent_vector.hpp>
+#include <jank/util/fmt.hpp>
 
 /* https://wiki.theory.org/BitTorrentSpecification#Bencoding */
 namespace jank::data::bencode::decode
@@ -14,250 +23,436 @@ namespace jank::data::bencode::decode
 
   struct decode_error
   {
-    native_persistent_string message;
+    jtl::immutable_string message;
     decode_error_reason reason{};
   };
 
-  using decode_result = result<std::pair<object_ptr, size_t>, decode_error>;
-
-  struct partially_decoded_list
-  {
-    obj::transient_vector_ptr data;
-  };
-
-  struct partially_decoded_dictionary
+  /* Dictionary keys like "op", "id", and "session" show up in every nREPL message, so we
+   * keep one string for each short key and hand it out each time we see that key again.
+   * The table is bounded, so a client sending unique keys can't grow it forever. */
+  static constexpr usize max_interned_key_size{ 32 };
+  static constexpr usize max_interned_keys{ 1024 };
+
+  /* The size of a string comes from the client, so we don't trust it when reserving room
+   * for a string which spans chunks. */
+  static constexpr usize max_string_reserve{ 16 * 1024 * 1024 };
+
+  /* Decodes a stream of bencoded messages, which can come in chunks of any size, such as
+   * from each async_read_some on a socket. The decoder keeps its state between chunks, so
+   * no chunk is read twice and only the bytes of a string which is cut off are held on to.
+   *
+   * Each string is built directly from the chunk it's in, without going through any buffer
+   * of ours. This isn't thread safe. */
+  struct decoder
   {
-    obj::transient_hash_map_ptr data;
-    object_ptr next_key{};
-  };
+    enum class state : u8
+    {
+      /* Between values, expecting the start of the next one. */
+      value,
+      integer,
+      string_size,
+      string_body
+    };
 
-  using partially_decoded_collection
-    = boost::variant<partially_decoded_list, partially_decoded_dictionary>;
+    /* A list or dictionary which we're still reading. Dictionaries keep their keys and
+     * values one after the other. */
+    struct frame
+    {
+      native_vector<object_ref> items;
+      bool is_dictionary{};
+    };
 
-  template <typename T>
-  result<void, decode_error> append(partially_decoded_collection &coll, T const o)
-  {
-    if(coll.which() == 0)
+    decoder(bool const intern_keys)
+      : intern_keys{ intern_keys }
     {
-      auto &list(boost::get<partially_decoded_list>(coll));
-      list.data = list.data->cons_in_place(o);
-      return ok();
     }
-    else
+
+    /* Decodes all of the chunk, pushing each message which it completes onto the end of
+     * messages. After an error, the decoder is reset, since we can't tell where the next
+     * message would start. */
+    jtl::result<void, decode_error>
+    feed(jtl::immutable_string_view const &chunk, native_vector<object_ref> &messages)
     {
-      auto &dict(boost::get<partially_decoded_dictionary>(coll));
-      if constexpr(std::same_as<T, obj::persistent_string_ptr>)
-      {
-        if(!dict.next_key)
-        {
-          dict.next_key = o;
-          return ok();
-        }
-      }
-      else
+      auto const res(feed_chunk(chunk, messages));
+      if(res.is_err())
       {
-        if(!dict.next_key)
-        {
-          return decode_error{ "non-string dict key", decode_error_reason::invalid_data };
-        }
+        reset();
       }
-
-      dict.data = dict.data->assoc_in_place(dict.next_key, o);
-      dict.next_key = nullptr;
-      return ok();
+      return res;
     }
-  }
 
-  result<object_ptr, decode_error> finish(partially_decoded_collection &coll)
-  {
-    if(coll.which() == 0)
+    /* Whether we're between messages, with nothing partially read. */
+    bool is_idle() const
     {
-      auto &list(boost::get<partially_decoded_list>(coll));
-      return ok(list.data->to_persistent());
+      return current_state == state::value && stack.empty();
     }
-    else
+
+    void reset()
     {
-      auto &dict(boost::get<partially_decoded_dictionary>(coll));
-      if(dict.next_key)
-      {
-        return decode_error{ "odd number of dict fields", decode_error_reason::invalid_data };
-      }
-      return ok(dict.data->to_persistent());
+      current_state = state::value;
+      stack.clear();
+      pending.clear();
+      number = 0;
+      digits = 0;
+      negative = false;
     }
-  }
 
-  decode_result decode_some(object_ptr const str_obj)
-  {
-    auto const &str(runtime::detail::to_string(str_obj));
-    auto const str_len(str.size());
-    size_t consumed_bytes{};
-
-    enum class collection_type
+    jtl::result<void, decode_error>
+    feed_chunk(jtl::immutable_string_view const &chunk, native_vector<object_ref> &messages)
     {
-      list,
-      dictionary
-    };
-
-    std::stack<partially_decoded_collection> stack;
+      auto const data(chunk.data());
+      auto const size(chunk.size());
+      usize pos{};
 
-    while(consumed_bytes < str_len)
-    {
-      switch(str[consumed_bytes])
+      while(pos < size)
       {
-        case 'i':
-          {
-            ++consumed_bytes;
-            auto const end(str.find('e', consumed_bytes));
-            if(end == native_persistent_string::npos)
+        switch(current_state)
+        {
+          case state::value:
             {
-              return decode_error{ "EOF while reading int", decode_error_reason::incomplete_data };
+              auto const c(data[pos]);
+              ++pos;
+              switch(c)
+              {
+                case 'i':
+                  current_state = state::integer;
+                  break;
+                case 'l':
+                  stack.emplace_back(frame{ {}, false });
+                  break;
+                case 'd':
+                  stack.emplace_back(frame{ {}, true });
+                  break;
+                case 'e':
+                  {
+                    if(stack.empty())
+                    {
+                      return decode_error{ "extraneous 'e' found",
+                                           decode_error_reason::invalid_data };
+                    }
+                    auto const res(finish(stack.back()));
+                    if(res.is_err())
+                    {
+                      return res.expect_err();
+                    }
+                    stack.pop_back();
+                    auto const append_res(append(res.expect_ok(), messages));
+                    if(append_res.is_err())
+                    {
+                      return append_res.expect_err();
+                    }
+                  }
+                  break;
+                case '0' ... '9':
+                  current_state = state::string_size;
+                  number = c - '0';
+                  digits = 1;
+                  break;
+                default:
+                  return decode_error{ "unsupported character",
+                                       decode_error_reason::invalid_data };
+              }
             }
+            break;
 
-            auto const data(str.data());
-            native_integer i{};
-            auto const res(std::from_chars(data + consumed_bytes, data + end, i));
-            if(res.ec != std::errc{} || res.ptr != data + end)
+          case state::integer:
             {
-              /* TODO: Use ec value for better message. */
-              return decode_error{ "unable to parse int", decode_error_reason::invalid_data };
+              auto const res(read_digits(data, size, pos, 'e'));
+              if(res.is_err())
+              {
+                return res.expect_err();
+              }
+              else if(!res.expect_ok())
+              {
+                break;
+              }
+
+              auto const i(negative ? -number : number);
+              number = 0;
+              digits = 0;
+              negative = false;
+              current_state = state::value;
+
+              auto const append_res(append(make_box(i), messages));
+              if(append_res.is_err())
+              {
+                return append_res.expect_err();
+              }
             }
-            consumed_bytes += (end - consumed_bytes) + 1;
+            break;
 
-            if(stack.empty())
+          case state::string_size:
             {
-              return std::make_pair(make_box(i), consumed_bytes);
+              auto const res(read_digits(data, size, pos, ':'));
+              if(res.is_err())
+              {
+                return res.expect_err();
+              }
+              else if(!res.expect_ok())
+              {
+                break;
+              }
+
+              string_size = static_cast<usize>(number);
+              number = 0;
+              digits = 0;
+
+              /* The common case is that the whole string is in this chunk, in which case we
+               * build it right from the chunk. */
+              if(size - pos >= string_size)
+              {
+                auto const s(make_string(jtl::immutable_string_view{ data + pos, string_size }));
+                pos += string_size;
+                current_state = state::value;
+                auto const append_res(append(s, messages));
+                if(append_res.is_err())
+                {
+                  return append_res.expect_err();
+                }
+                break;
+              }
+
+              pending.reserve(std::min(string_size, max_string_reserve));
+              pending.append(data + pos, size - pos);
+              pos = size;
+              current_state = state::string_body;
             }
+            break;
 
-            auto const append_res(append(stack.top(), make_box(i)));
-            if(append_res.is_err())
+          case state::string_body:
             {
-              return append_res.expect_err();
+              auto const needed(std::min(string_size - pending.size(), size - pos));
+              pending.append(data + pos, needed);
+              pos += needed;
+              if(pending.size() < string_size)
+              {
+                break;
+              }
+
+              auto const s(make_string({ pending.data(), pending.size() }));
+              pending.clear();
+              current_state = state::value;
+              auto const append_res(append(s, messages));
+              if(append_res.is_err())
+              {
+                return append_res.expect_err();
+              }
             }
-          }
-          break;
+            break;
+        }
+      }
 
-        case 'l':
-          {
-            ++consumed_bytes;
-            stack.emplace(partially_decoded_list{ obj::transient_vector::empty() });
-          }
-          break;
+      return ok();
+    }
 
-        case 'd':
+    /* Reads the digits of an integer or string size, which may be split across chunks,
+     * until we find the terminator. Gives false if the chunk ran out first. */
+    jtl::result<bool, decode_error>
+    read_digits(char const * const data, usize const size, usize &pos, char const terminator)
+    {
+      for(; pos < size; ++pos)
+      {
+        auto const c(data[pos]);
+        if(c == terminator)
+        {
+          ++pos;
+          if(digits == 0)
           {
-            ++consumed_bytes;
-            stack.emplace(partially_decoded_dictionary{ obj::transient_hash_map::empty() });
+            return decode_error{ "missing digits", decode_error_reason::invalid_data };
           }
-          break;
+          return ok(true);
+        }
+        else if(c == '-' && terminator == 'e' && digits == 0 && !negative)
+        {
+          negative = true;
+          continue;
+        }
+        else if(c < '0' || '9' < c)
+        {
+          return decode_error{ terminator == 'e' ? "unable to parse int"
+                                                 : "unable to parse string size",
+                               decode_error_reason::invalid_data };
+        }
 
-        case 'e':
-          {
-            ++consumed_bytes;
-            if(stack.empty())
-            {
-              return decode_error{ "extraneous 'e' found", decode_error_reason::invalid_data };
-            }
+        if(__builtin_mul_overflow(number, 10, &number)
+           || __builtin_add_overflow(number, c - '0', &number))
+        {
+          return decode_error{ "integer out of range", decode_error_reason::invalid_data };
+        }
+        ++digits;
+      }
+      return ok(false);
+    }
 
-            auto const res(finish(stack.top()));
-            if(res.is_err())
-            {
-              return res.expect_err();
-            }
+    bool is_next_key() const
+    {
+      return !stack.empty() && stack.back().is_dictionary && stack.back().items.size() % 2 == 0;
+    }
 
-            if(stack.size() == 1)
-            {
-              return std::make_pair(res.expect_ok(), consumed_bytes);
-            }
-            stack.pop();
+    object_ref make_string(jtl::immutable_string_view const &s)
+    {
+      if(!intern_keys || !is_next_key() || s.size() > max_interned_key_size)
+      {
+        return make_box(s);
+      }
 
-            auto const append_res(append(stack.top(), res.expect_ok()));
-            if(append_res.is_err())
-            {
-              return append_res.expect_err();
-            }
-          }
-          break;
+      /* Keys this short fit in the string's small buffer, so looking them up doesn't
+       * allocate. */
+      jtl::immutable_string key{ s };
+      auto const found(interned_keys.find(key));
+      if(found != interned_keys.end())
+      {
+        return found->second;
+      }
 
-        case '0' ... '9':
-          {
-            auto const end(str.find(':', consumed_bytes));
-            if(end == native_persistent_string::npos)
-            {
-              return decode_error{ "EOF while reading string",
-                                   decode_error_reason::incomplete_data };
-            }
+      auto const ret(make_box<obj::persistent_string>(key));
+      if(interned_keys.size() < max_interned_keys)
+      {
+        interned_keys.emplace(key, ret);
+      }
+      return ret;
+    }
 
-            auto const data(str.data());
-            native_integer size{};
-            auto const res(std::from_chars(data + consumed_bytes, data + end, size));
-            if(res.ec != std::errc{} || res.ptr != data + end)
-            {
-              /* TODO: Use ec value for better message. */
-              return decode_error{ "unable to parse string size",
-                                   decode_error_reason::invalid_data };
-            }
-            consumed_bytes += (end - consumed_bytes) + 1;
+    /* Adds a finished value to the innermost collection, or gives it as a message if we're
+     * not within one. */
+    jtl::result<void, decode_error> append(object_ref const o, native_vector<object_ref> &messages)
+    {
+      if(stack.empty())
+      {
+        messages.emplace_back(o);
+        return ok();
+      }
 
-            if(size < 0 || size > str.size() - consumed_bytes)
-            {
-              return decode_error{ "invalid string size", decode_error_reason::invalid_data };
-            }
-            native_persistent_string_view s{ data + consumed_bytes, data + consumed_bytes + size };
+      auto &top(stack.back());
+      if(top.is_dictionary && top.items.size() % 2 == 0
+         && o->type != object_type::persistent_string)
+      {
+        return decode_error{ "non-string dict key", decode_error_reason::invalid_data };
+      }
+      top.items.emplace_back(o);
+      return ok();
+    }
 
-            consumed_bytes += size;
+    static jtl::result<object_ref, decode_error> finish(frame &f)
+    {
+      if(!f.is_dictionary)
+      {
+        return ok(make_box<obj::persistent_vector>(
+          runtime::detail::native_persistent_vector{ f.items.begin(), f.items.end() }));
+      }
 
-            if(stack.empty())
-            {
-              return std::make_pair(make_box(s), consumed_bytes);
-            }
+      if(f.items.size() % 2)
+      {
+        return decode_error{ "odd number of dict fields", decode_error_reason::invalid_data };
+      }
 
-            auto const append_res(append(stack.top(), make_box(s)));
-            if(append_res.is_err())
-            {
-              return append_res.expect_err();
-            }
-          }
-          break;
+      if(f.items.size() / 2 <= runtime::detail::native_array_map::max_size)
+      {
+        runtime::detail::native_array_map map{};
+        map.reserve(f.items.size() / 2);
+        for(usize i{}; i < f.items.size(); i += 2)
+        {
+          map.insert_or_assign(f.items[i], f.items[i + 1]);
+        }
+        return ok(make_box<obj::persistent_array_map>(jtl::option<object_ref>{}, jtl::move(map)));
+      }
 
-        default:
-          return decode_error{ "unsupported character", decode_error_reason::invalid_data };
+      runtime::detail::native_transient_hash_map map{};
+      for(usize i{}; i < f.items.size(); i += 2)
+      {
+        map.set(f.items[i], f.items[i + 1]);
       }
+      return ok(make_box<obj::persistent_hash_map>(jtl::option<object_ref>{}, map.persistent()));
     }
 
-    if(!stack.empty())
+    bool intern_keys{};
+    state current_state{ state::value };
+    native_vector<frame> stack;
+
+    /* The integer or string size being read. */
+    i64 number{};
+    usize digits{};
+    bool negative{};
+
+    /* The string being read, once it has been split across chunks. */
+    usize string_size{};
+    native_transient_string pending;
+
+    native_unordered_map<jtl::immutable_string, object_ref> interned_keys;
+  };
+
+  static constexpr auto decoder_type{ "jank::data::bencode::decode::decoder *" };
+
+  static decoder &to_decoder(object_ref const o)
+  {
+    auto const box{ try_object<obj::opaque_box>(o) };
+    if(box->canonical_type != decoder_type)
     {
-      return decode_error{ "unexpected EOF", decode_error_reason::incomplete_data };
+      throw std::runtime_error{ util::format("{} is not a bencode decoder",
+                                             runtime::to_code_string(o)) };
     }
+    return *static_cast<decoder *>(box->data.data);
+  }
 
-    return std::make_pair(obj::nil::nil_const(), consumed_bytes);
+  static object_ref make_decoder(object_ref const intern_keys)
+  {
+    return make_box<obj::opaque_box>(new(GC) decoder{ truthy(intern_keys) }, decoder_type);
   }
 
-  object_ptr decode(object_ptr const str)
+  /* Gives a vector of each message which this chunk completes, which may be empty if the
+   * chunk only has part of a message. */
+  static object_ref feed(object_ref const d, object_ref const chunk)
   {
-    auto const res(decode_some(str));
+    native_vector<object_ref> messages;
+    auto const res(to_decoder(d).feed(runtime::to_string(chunk), messages));
     if(res.is_err())
     {
-      /* TODO: fmt details once fmt can be linked JIT */
-      auto const err("bencode decode error: " + res.expect_err().message);
-      throw std::runtime_error{ err.c_str() };
+      throw std::runtime_error{ util::format("bencode decode error: {}",
+                                             res.expect_err().message) };
     }
-    return res.expect_ok().first;
+    return make_box<obj::persistent_vector>(
+      runtime::detail::native_persistent_vector{ messages.begin(), messages.end() });
   }
 
-  /* TODO: Make base class for ns which does this_object_ptr */
-  struct __ns : behavior::callable
+  /* Decodes a single, whole message. */
+  static object_ref decode(object_ref const str)
   {
-    /* TODO: Remove const from all of these. */
-    object_ptr call() const override
+    decoder d{ false };
+    native_vector<object_ref> messages;
+    auto const res(d.feed(runtime::to_string(str), messages));
+    if(res.is_err())
     {
-      auto const ns(__rt_ctx->intern_ns("jank.data.bencode.decode"));
-      ns->intern_var("decode")->bind_root(make_box<obj::native_function_wrapper>(&decode));
-      return obj::nil::nil_const();
+      throw std::runtime_error{ util::format("bencode decode error: {}",
+                                             res.expect_err().message) };
     }
-
-    object_ptr this_object_ptr() const override
+    else if(messages.empty())
     {
-      return obj::nil::nil_const();
+      throw std::runtime_error{ "bencode decode error: unexpected EOF" };
     }
-  };
+    return messages[0];
+  }
+}
+
+extern "C" void jank_load_jank_data_bencode_decode()
+{
+  using namespace jank;
+  using namespace jank::runtime;
+  using namespace jank::data::bencode::decode;
+
+  auto const ns_name{ "jank.data.bencode.decode" };
+  auto const ns(__rt_ctx->intern_ns(ns_name));
+
+  auto const intern_fn([=](jtl::immutable_string const &name, auto const fn) {
+    ns->intern_var(name)->bind_root(
+      make_box<obj::native_function_wrapper>(convert_function(fn))
+        ->with_meta(obj::persistent_hash_map::create_unique(std::make_pair(
+          __rt_ctx->intern_keyword("name").expect_ok(),
+          make_box(obj::symbol{ ns_name, name }.to_string())))));
+  });
+
+  intern_fn("decode", &decode);
+  intern_fn("decoder", &make_decoder);
+  intern_fn("feed!", &feed);
+
+  __rt_ctx->module_loader.set_is_loaded(ns_name);
 }
@@ -1,9 +0,0 @@
-namespace jank::data::bencode::decode
-{
-  struct __ns__init
-  {
-    static void __init()
-    {
-    }
-  };
-}
@@ -0,0 +1,210 @@
+#include <algorithm>
+#include <charconv>
+#include <string_view>
+
+#include <jtl/immutable_string.hpp>
+
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/convert/function.hpp>
+#include <jank/runtime/core.hpp>
+#include <jank/runtime/obj/opaque_box.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
+#include <jank/runtime/sequence_range.hpp>
+#include <jank/util/fmt.hpp>
+
+/* https://wiki.theory.org/BitTorrentSpecification#Bencoding */
+namespace jank::data::bencode::encode
+{
+  using namespace jank;
+  using namespace jank::runtime;
+
+  /* Encodes messages straight into a buffer which is kept between messages, so once the
+   * buffer has grown to fit the largest message, encoding doesn't allocate for it. The
+   * encoded message is valid until the next one is encoded.
+   *
+   * Keywords and symbols are encoded as strings, without the colon, and nil is an empty
+   * list, like nREPL does. Dictionary keys are sorted by their bytes, as bencode requires.
+   * This isn't thread safe. */
+  struct encoder
+  {
+    jtl::result<jtl::immutable_string_view, jtl::immutable_string> encode(object_ref const o)
+    {
+      buffer.clear();
+      auto const res(write(o));
+      if(res.is_err())
+      {
+        return err(res.expect_err());
+      }
+      return ok(jtl::immutable_string_view{ buffer.data(), buffer.size() });
+    }
+
+    void write_integer(i64 const i)
+    {
+      char digits[24]{};
+      auto const res(std::to_chars(digits, digits + sizeof(digits), i));
+      buffer.append(digits, res.ptr);
+    }
+
+    void write_string(jtl::immutable_string_view const &s)
+    {
+      write_integer(static_cast<i64>(s.size()));
+      buffer.push_back(':');
+      buffer.append(s.data(), s.size());
+    }
+
+    /* Dictionary keys have to be strings, so we can only tell how to sort them once we
+     * have their bytes. */
+    static jtl::option<jtl::immutable_string> key_string(object_ref const o)
+    {
+      switch(o->type)
+      {
+        case object_type::persistent_string:
+          return expect_object<obj::persistent_string>(o)->data;
+        case object_type::keyword:
+          return expect_object<obj::keyword>(o)->sym->to_string();
+        case object_type::symbol:
+          return expect_object<obj::symbol>(o)->to_string();
+        default:
+          return none;
+      }
+    }
+
+    jtl::result<void, jtl::immutable_string> write(object_ref const o)
+    {
+      switch(o->type)
+      {
+        case object_type::nil:
+          buffer.append("le");
+          return ok();
+        case object_type::boolean:
+          write_string(truthy(o) ? "true" : "false");
+          return ok();
+        case object_type::integer:
+          buffer.push_back('i');
+          write_integer(expect_object<obj::integer>(o)->data);
+          buffer.push_back('e');
+          return ok();
+        case object_type::persistent_string:
+        case object_type::keyword:
+        case object_type::symbol:
+          write_string(key_string(o).unwrap());
+          return ok();
+        default:
+          break;
+      }
+
+      if(is_map(o))
+      {
+        native_vector<std::pair<jtl::immutable_string, object_ref>> entries;
+        for(auto const e : make_sequence_range(o))
+        {
+          auto const key(key_string(first(e)));
+          if(key.is_none())
+          {
+            return err(
+              util::format("unable to encode dict key {}", runtime::to_code_string(first(e))));
+          }
+          entries.emplace_back(key.unwrap(), second(e));
+        }
+        std::ranges::sort(entries, [](auto const &l, auto const &r) {
+          return std::string_view{ l.first.data(), l.first.size() }
+          < std::string_view{ r.first.data(), r.first.size() };
+        });
+
+        buffer.push_back('d');
+        for(auto const &e : entries)
+        {
+          write_string(e.first);
+          auto const res(write(e.second));
+          if(res.is_err())
+          {
+            return res;
+          }
+        }
+        buffer.push_back('e');
+        return ok();
+      }
+      else if(is_seqable(o) && !is_set(o))
+      {
+        buffer.push_back('l');
+        for(auto const e : make_sequence_range(o))
+        {
+          auto const res(write(e));
+          if(res.is_err())
+          {
+            return res;
+          }
+        }
+        buffer.push_back('e');
+        return ok();
+      }
+
+      return err(util::format("unable to encode {}", runtime::to_code_string(o)));
+    }
+
+    native_transient_string buffer;
+  };
+
+  static constexpr auto encoder_type{ "jank::data::bencode::encode::encoder *" };
+
+  static encoder &to_encoder(object_ref const o)
+  {
+    auto const box{ try_object<obj::opaque_box>(o) };
+    if(box->canonical_type != encoder_type)
+    {
+      throw std::runtime_error{ util::format("{} is not a bencode encoder",
+                                             runtime::to_code_string(o)) };
+    }
+    return *static_cast<encoder *>(box->data.data);
+  }
+
+  static object_ref make_encoder()
+  {
+    return make_box<obj::opaque_box>(new(GC) encoder{}, encoder_type);
+  }
+
+  static object_ref encode_with(object_ref const e, object_ref const o)
+  {
+    auto const res(to_encoder(e).encode(o));
+    if(res.is_err())
+    {
+      throw std::runtime_error{ util::format("bencode encode error: {}", res.expect_err()) };
+    }
+    return make_box(res.expect_ok());
+  }
+
+  static object_ref encode(object_ref const o)
+  {
+    encoder e;
+    auto const res(e.encode(o));
+    if(res.is_err())
+    {
+      throw std::runtime_error{ util::format("bencode encode error: {}", res.expect_err()) };
+    }
+    return make_box(res.expect_ok());
+  }
+}
+
+extern "C" void jank_load_jank_data_bencode_encode()
+{
+  using namespace jank;
+  using namespace jank::runtime;
+  using namespace jank::data::bencode::encode;
+
+  auto const ns_name{ "jank.data.bencode.encode" };
+  auto const ns(__rt_ctx->intern_ns(ns_name));
+
+  auto const intern_fn([=](jtl::immutable_string const &name, auto const fn) {
+    ns->intern_var(name)->bind_root(
+      make_box<obj::native_function_wrapper>(convert_function(fn))
+        ->with_meta(obj::persistent_hash_map::create_unique(std::make_pair(
+          __rt_ctx->intern_keyword("name").expect_ok(),
+          make_box(obj::symbol{ ns_name, name }.to_string())))));
+  });
+
+  intern_fn("encode", &encode);
+  intern_fn("encoder", &make_encoder);
+  intern_fn("encode-with", &encode_with);
+
+  __rt_ctx->module_loader.set_is_loaded(ns_name);
+}
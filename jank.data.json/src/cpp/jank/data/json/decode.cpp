@@ -0,0 +1,843 @@
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <limits>
+
+#include <jtl/immutable_string.hpp>
+
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/convert/function.hpp>
+#include <jank/runtime/core.hpp>
+#include <jank/runtime/obj/big_integer.hpp>
+#include <jank/runtime/obj/persistent_array_map.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
+#include <jank/runtime/obj/persistent_vector.hpp>
+#include <jank/runtime/sequence_range.hpp>
+#include <jank/util/fmt.hpp>
+#include <jank/data/json/detail/swar.hpp>
+
+/* https://www.rfc-editor.org/rfc/rfc8259 */
+namespace jank::data::json::decode
+{
+  using namespace jank;
+  using namespace jank::runtime;
+
+  /* Values are read recursively, so untrusted input can't nest without bound. */
+  static constexpr usize max_depth{ 512 };
+
+  /* Object keys repeat across every object of an API response, so we keep one key for each
+   * short one and hand it out each time we see it again, like bencode does. */
+  static constexpr usize max_interned_key_size{ 32 };
+  static constexpr usize max_interned_keys{ 1024 };
+
+  using jank::data::json::detail::has_special_byte;
+  using jank::data::json::detail::load_word;
+
+  static void append_utf8(native_transient_string &out, u32 const cp)
+  {
+    if(cp < 0x80)
+    {
+      out.push_back(static_cast<char>(cp));
+    }
+    else if(cp < 0x800)
+    {
+      out.push_back(static_cast<char>(0xc0 | (cp >> 6)));
+      out.push_back(static_cast<char>(0x80 | (cp & 0x3f)));
+    }
+    else if(cp < 0x10000)
+    {
+      out.push_back(static_cast<char>(0xe0 | (cp >> 12)));
+      out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3f)));
+      out.push_back(static_cast<char>(0x80 | (cp & 0x3f)));
+    }
+    else
+    {
+      out.push_back(static_cast<char>(0xf0 | (cp >> 18)));
+      out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3f)));
+      out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3f)));
+      out.push_back(static_cast<char>(0x80 | (cp & 0x3f)));
+    }
+  }
+
+  /* Decodes one whole JSON document, in a single pass, with no tokens in between. The
+   * items of each array and object are gathered on one stack which is shared by all of
+   * them, then built into their collection once it's closed. Objects which fit are built
+   * straight into an array map, and larger ones through a transient.
+   *
+   * Strings without escapes are built right from the input. Only strings with escapes are
+   * copied through a scratch buffer, which is reused. */
+  struct decoder
+  {
+    decoder(jtl::immutable_string_view const &s, bool const keywordize)
+      : begin{ s.data() }
+      , pos{ s.data() }
+      , end{ s.data() + s.size() }
+      , keywordize{ keywordize }
+    {
+    }
+
+    jtl::immutable_string error(char const * const message) const
+    {
+      return util::format("{} at offset {}", message, pos - begin);
+    }
+
+    jtl::result<object_ref, jtl::immutable_string> decode_all()
+    {
+      auto const res(read_value(0));
+      if(res.is_err())
+      {
+        return res;
+      }
+      skip_whitespace();
+      if(pos != end)
+      {
+        return err(error("trailing data"));
+      }
+      return res;
+    }
+
+    /* Reads only the value at the path of keys and indices, skipping over everything
+     * else without building it. The parts which are skipped are only checked for being
+     * balanced. Gives nil if there's nothing at the path. */
+    jtl::result<object_ref, jtl::immutable_string> decode_in(object_ref const path)
+    {
+      for(auto const step : make_sequence_range(path))
+      {
+        auto const res(find(step));
+        if(res.is_err())
+        {
+          return err(res.expect_err());
+        }
+        if(!res.expect_ok())
+        {
+          return ok(jank_nil());
+        }
+      }
+      return read_value(0);
+    }
+
+    void skip_whitespace()
+    {
+      while(pos != end && (*pos == ' ' || *pos == '\n' || *pos == '\r' || *pos == '\t'))
+      {
+        ++pos;
+      }
+    }
+
+    jtl::result<object_ref, jtl::immutable_string> read_value(usize const depth)
+    {
+      if(max_depth < depth)
+      {
+        return err(error("nested too deeply"));
+      }
+
+      skip_whitespace();
+      if(pos == end)
+      {
+        return err(error("unexpected end of input"));
+      }
+
+      switch(*pos)
+      {
+        case '{':
+          return read_object(depth);
+        case '[':
+          return read_array(depth);
+        case '"':
+          {
+            auto const res(read_string());
+            if(res.is_err())
+            {
+              return err(res.expect_err());
+            }
+            return ok(make_box(res.expect_ok()));
+          }
+        case 't':
+          return read_literal("true", jank_true);
+        case 'f':
+          return read_literal("false", jank_false);
+        case 'n':
+          return read_literal("null", jank_nil());
+        case '-':
+        case '0':
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9':
+          return read_number();
+        default:
+          return err(error("unexpected character"));
+      }
+    }
+
+    template <usize N>
+    jtl::result<object_ref, jtl::immutable_string>
+    read_literal(char const (&word)[N], object_ref const value)
+    {
+      auto const size(N - 1);
+      if(static_cast<usize>(end - pos) < size || std::memcmp(pos, word, size) != 0)
+      {
+        return err(error("unexpected character"));
+      }
+      pos += size;
+      return ok(value);
+    }
+
+    jtl::result<object_ref, jtl::immutable_string> read_number()
+    {
+      auto const start(pos);
+      auto const digits([&] {
+        auto const first(pos);
+        while(pos != end && '0' <= *pos && *pos <= '9')
+        {
+          ++pos;
+        }
+        return pos != first;
+      });
+
+      if(*pos == '-')
+      {
+        ++pos;
+      }
+      if(pos != end && *pos == '0')
+      {
+        ++pos;
+      }
+      else if(!digits())
+      {
+        return err(error("invalid number"));
+      }
+
+      bool integral{ true };
+      if(pos != end && *pos == '.')
+      {
+        ++pos;
+        integral = false;
+        if(!digits())
+        {
+          return err(error("invalid number"));
+        }
+      }
+      if(pos != end && (*pos == 'e' || *pos == 'E'))
+      {
+        ++pos;
+        integral = false;
+        if(pos != end && (*pos == '+' || *pos == '-'))
+        {
+          ++pos;
+        }
+        if(!digits())
+        {
+          return err(error("invalid number"));
+        }
+      }
+
+      auto const size(static_cast<usize>(pos - start));
+      if(integral)
+      {
+        i64 i{};
+        auto const res(std::from_chars(start, pos, i));
+        if(res.ec == std::errc::result_out_of_range)
+        {
+          return ok(make_box<obj::big_integer>(jtl::immutable_string{ start, size }));
+        }
+        return ok(make_box(i));
+      }
+
+      /* This doesn't depend on the locale, unlike strtod, and doesn't need the number to
+       * be terminated. The number has already been checked, so only its range can fail. */
+      f64 d{};
+      auto const res(std::from_chars(start, pos, d));
+      if(res.ec == std::errc::result_out_of_range)
+      {
+        /* Like strtod, a number too big becomes infinity and one too small becomes zero.
+         * It's too small when its exponent is negative, or when it has none and its whole
+         * part is zero. */
+        auto const negative(*start == '-');
+        auto const digits_start(start + negative);
+        auto const e(std::find_if(start, pos, [](char const c) { return c == 'e' || c == 'E'; }));
+        auto const tiny(e == pos ? *digits_start == '0' : e[1] == '-');
+        d = tiny ? 0.0 : std::numeric_limits<f64>::infinity();
+        return ok(make_box(negative ? -d : d));
+      }
+      return ok(make_box(d));
+    }
+
+    /* Gives a view of the string, which is only valid until the next one is read, since it
+     * may be in our scratch buffer. */
+    jtl::result<jtl::immutable_string_view, jtl::immutable_string> read_string()
+    {
+      ++pos;
+      auto run(pos);
+      bool escaped{};
+      while(true)
+      {
+        while(8 <= end - pos && !has_special_byte(load_word(pos)))
+        {
+          pos += 8;
+        }
+        if(pos == end)
+        {
+          return err(error("unterminated string"));
+        }
+
+        auto const c(*pos);
+        if(c == '"')
+        {
+          ++pos;
+          if(!escaped)
+          {
+            return ok(jtl::immutable_string_view{ run, static_cast<usize>(pos - 1 - run) });
+          }
+          scratch.append(run, pos - 1);
+          return ok(jtl::immutable_string_view{ scratch.data(), scratch.size() });
+        }
+        else if(c == '\\')
+        {
+          if(!escaped)
+          {
+            scratch.clear();
+            escaped = true;
+          }
+          scratch.append(run, pos);
+          auto const res(read_escape());
+          if(res.is_err())
+          {
+            return err(res.expect_err());
+          }
+          run = pos;
+        }
+        else if(static_cast<u8>(c) < 0x20)
+        {
+          return err(error("control character in string"));
+        }
+        else
+        {
+          ++pos;
+        }
+      }
+    }
+
+    jtl::result<u32, jtl::immutable_string> read_hex()
+    {
+      if(end - pos < 4)
+      {
+        return err(error("unterminated string"));
+      }
+      u32 ret{};
+      auto const res(std::from_chars(pos, pos + 4, ret, 16));
+      if(res.ptr != pos + 4)
+      {
+        return err(error("invalid unicode escape"));
+      }
+      pos += 4;
+      return ok(ret);
+    }
+
+    jtl::result<void, jtl::immutable_string> read_escape()
+    {
+      ++pos;
+      if(pos == end)
+      {
+        return err(error("unterminated string"));
+      }
+
+      auto const c(*pos);
+      ++pos;
+      switch(c)
+      {
+        case '"':
+        case '\\':
+        case '/':
+          scratch.push_back(c);
+          return ok();
+        case 'b':
+          scratch.push_back('\b');
+          return ok();
+        case 'f':
+          scratch.push_back('\f');
+          return ok();
+        case 'n':
+          scratch.push_back('\n');
+          return ok();
+        case 'r':
+          scratch.push_back('\r');
+          return ok();
+        case 't':
+          scratch.push_back('\t');
+          return ok();
+        case 'u':
+          {
+            auto const high(read_hex());
+            if(high.is_err())
+            {
+              return err(high.expect_err());
+            }
+            auto cp(high.expect_ok());
+            if(0xd800 <= cp && cp <= 0xdbff && 6 <= end - pos && pos[0] == '\\' && pos[1] == 'u')
+            {
+              pos += 2;
+              auto const low(read_hex());
+              if(low.is_err())
+              {
+                return err(low.expect_err());
+              }
+              if(0xdc00 <= low.expect_ok() && low.expect_ok() <= 0xdfff)
+              {
+                cp = 0x10000 + ((cp - 0xd800) << 10) + (low.expect_ok() - 0xdc00);
+              }
+              else
+              {
+                append_utf8(scratch, 0xfffd);
+                cp = low.expect_ok();
+              }
+            }
+            /* A lone surrogate can't be encoded as UTF-8. */
+            if(0xd800 <= cp && cp <= 0xdfff)
+            {
+              cp = 0xfffd;
+            }
+            append_utf8(scratch, cp);
+            return ok();
+          }
+        default:
+          return err(error("invalid escape"));
+      }
+    }
+
+    object_ref make_key(jtl::immutable_string_view const &s)
+    {
+      if(max_interned_key_size < s.size())
+      {
+        return key_for(s);
+      }
+
+      /* Keys this short fit in the string's small buffer, so looking them up doesn't
+       * allocate. */
+      jtl::immutable_string key{ s };
+      auto const found(interned_keys.find(key));
+      if(found != interned_keys.end())
+      {
+        return found->second;
+      }
+
+      auto const ret(key_for(key));
+      if(interned_keys.size() < max_interned_keys)
+      {
+        interned_keys.emplace(key, ret);
+      }
+      return ret;
+    }
+
+    /* Keys which can't be keywords are kept as strings. */
+    object_ref key_for(jtl::immutable_string_view const &s) const
+    {
+      if(keywordize && !s.empty())
+      {
+        auto const kw(__rt_ctx->intern_keyword(jtl::immutable_string{ s }));
+        if(kw.is_ok())
+        {
+          return kw.expect_ok();
+        }
+      }
+      return make_box(s);
+    }
+
+    jtl::result<object_ref, jtl::immutable_string> read_array(usize const depth)
+    {
+      ++pos;
+      auto const start(stack.size());
+      skip_whitespace();
+      if(pos != end && *pos == ']')
+      {
+        ++pos;
+        return ok(obj::persistent_vector::empty());
+      }
+
+      while(true)
+      {
+        auto const res(read_value(depth + 1));
+        if(res.is_err())
+        {
+          return res;
+        }
+        stack.push_back(res.expect_ok());
+
+        skip_whitespace();
+        if(pos == end)
+        {
+          return err(error("unterminated array"));
+        }
+        else if(*pos == ',')
+        {
+          ++pos;
+        }
+        else if(*pos == ']')
+        {
+          ++pos;
+          break;
+        }
+        else
+        {
+          return err(error("expected ',' or ']'"));
+        }
+      }
+
+      auto const items(stack.begin() + static_cast<std::ptrdiff_t>(start));
+      auto const ret(make_box<obj::persistent_vector>(
+        runtime::detail::native_persistent_vector{ items, stack.end() }));
+      stack.resize(start);
+      return ok(ret);
+    }
+
+    jtl::result<object_ref, jtl::immutable_string> read_object(usize const depth)
+    {
+      ++pos;
+      auto const start(stack.size());
+      skip_whitespace();
+      if(pos != end && *pos == '}')
+      {
+        ++pos;
+        return ok(obj::persistent_array_map::empty());
+      }
+
+      while(true)
+      {
+        skip_whitespace();
+        if(pos == end || *pos != '"')
+        {
+          return err(error("expected a string key"));
+        }
+        auto const key(read_string());
+        if(key.is_err())
+        {
+          return err(key.expect_err());
+        }
+        stack.push_back(make_key(key.expect_ok()));
+
+        skip_whitespace();
+        if(pos == end || *pos != ':')
+        {
+          return err(error("expected ':'"));
+        }
+        ++pos;
+
+        auto const res(read_value(depth + 1));
+        if(res.is_err())
+        {
+          return res;
+        }
+        stack.push_back(res.expect_ok());
+
+        skip_whitespace();
+        if(pos == end)
+        {
+          return err(error("unterminated object"));
+        }
+        else if(*pos == ',')
+        {
+          ++pos;
+        }
+        else if(*pos == '}')
+        {
+          ++pos;
+          break;
+        }
+        else
+        {
+          return err(error("expected ',' or '}'"));
+        }
+      }
+
+      auto const size(stack.size() - start);
+      object_ref ret;
+      if(size / 2 <= runtime::detail::native_array_map::max_size)
+      {
+        runtime::detail::native_array_map map{};
+        map.reserve(static_cast<u8>(size / 2));
+        for(auto i(start); i < stack.size(); i += 2)
+        {
+          map.insert_or_assign(stack[i], stack[i + 1]);
+        }
+        ret = make_box<obj::persistent_array_map>(jtl::option<object_ref>{}, jtl::move(map));
+      }
+      else
+      {
+        runtime::detail::native_transient_hash_map map{};
+        for(auto i(start); i < stack.size(); i += 2)
+        {
+          map.set(stack[i], stack[i + 1]);
+        }
+        ret = make_box<obj::persistent_hash_map>(jtl::option<object_ref>{}, map.persistent());
+      }
+      stack.resize(start);
+      return ok(ret);
+    }
+
+    jtl::result<void, jtl::immutable_string> skip_string()
+    {
+      ++pos;
+      while(true)
+      {
+        while(8 <= end - pos && !has_special_byte(load_word(pos)))
+        {
+          pos += 8;
+        }
+        if(pos == end)
+        {
+          return err(error("unterminated string"));
+        }
+        if(*pos == '"')
+        {
+          ++pos;
+          return ok();
+        }
+        if(*pos == '\\')
+        {
+          if(end - pos < 2)
+          {
+            return err(error("unterminated string"));
+          }
+          ++pos;
+        }
+        ++pos;
+      }
+    }
+
+    jtl::result<void, jtl::immutable_string> skip_value()
+    {
+      skip_whitespace();
+      if(pos == end)
+      {
+        return err(error("unexpected end of input"));
+      }
+      if(*pos == '"')
+      {
+        return skip_string();
+      }
+      if(*pos != '{' && *pos != '[')
+      {
+        auto const res(read_value(0));
+        if(res.is_err())
+        {
+          return err(res.expect_err());
+        }
+        return ok();
+      }
+
+      usize nesting{};
+      do
+      {
+        if(end <= pos)
+        {
+          return err(error("unexpected end of input"));
+        }
+        switch(*pos)
+        {
+          case '"':
+            {
+              auto const res(skip_string());
+              if(res.is_err())
+              {
+                return res;
+              }
+              continue;
+            }
+          case '{':
+          case '[':
+            ++nesting;
+            break;
+          case '}':
+          case ']':
+            --nesting;
+            break;
+          default:
+            break;
+        }
+        ++pos;
+      } while(nesting != 0);
+      return ok();
+    }
+
+    static jtl::option<jtl::immutable_string> step_key(object_ref const step)
+    {
+      switch(step->type)
+      {
+        case object_type::persistent_string:
+          return expect_object<obj::persistent_string>(step)->data;
+        case object_type::keyword:
+          return expect_object<obj::keyword>(step)->sym->to_string();
+        case object_type::symbol:
+          return expect_object<obj::symbol>(step)->to_string();
+        default:
+          return none;
+      }
+    }
+
+    /* Moves to the value at one step of a path. Gives false if there isn't one. */
+    jtl::result<bool, jtl::immutable_string> find(object_ref const step)
+    {
+      skip_whitespace();
+      if(pos == end)
+      {
+        return err(error("unexpected end of input"));
+      }
+
+      if(*pos == '{')
+      {
+        auto const key(step_key(step));
+        if(key.is_none())
+        {
+          return ok(false);
+        }
+
+        ++pos;
+        skip_whitespace();
+        if(pos != end && *pos == '}')
+        {
+          return ok(false);
+        }
+        while(true)
+        {
+          skip_whitespace();
+          if(pos == end || *pos != '"')
+          {
+            return err(error("expected a string key"));
+          }
+          auto const k(read_string());
+          if(k.is_err())
+          {
+            return err(k.expect_err());
+          }
+          auto const found(k.expect_ok() == key.unwrap());
+
+          skip_whitespace();
+          if(pos == end || *pos != ':')
+          {
+            return err(error("expected ':'"));
+          }
+          ++pos;
+          if(found)
+          {
+            return ok(true);
+          }
+
+          auto const res(skip_value());
+          if(res.is_err())
+          {
+            return err(res.expect_err());
+          }
+          skip_whitespace();
+          if(pos == end || (*pos != ',' && *pos != '}'))
+          {
+            return err(error("expected ',' or '}'"));
+          }
+          if(*pos == '}')
+          {
+            return ok(false);
+          }
+          ++pos;
+        }
+      }
+      else if(*pos == '[')
+      {
+        if(step->type != object_type::integer)
+        {
+          return ok(false);
+        }
+        auto const index(expect_object<obj::integer>(step)->data);
+
+        ++pos;
+        skip_whitespace();
+        if(index < 0 || (pos != end && *pos == ']'))
+        {
+          return ok(false);
+        }
+        for(i64 i{}; i < index; ++i)
+        {
+          auto const res(skip_value());
+          if(res.is_err())
+          {
+            return err(res.expect_err());
+          }
+          skip_whitespace();
+          if(pos == end || (*pos != ',' && *pos != ']'))
+          {
+            return err(error("expected ',' or ']'"));
+          }
+          if(*pos == ']')
+          {
+            return ok(false);
+          }
+          ++pos;
+        }
+        return ok(true);
+      }
+
+      return ok(false);
+    }
+
+    char const *begin{};
+    char const *pos{};
+    char const *end{};
+    bool keywordize{};
+
+    native_vector<object_ref> stack;
+    native_transient_string scratch;
+    native_unordered_map<jtl::immutable_string, object_ref> interned_keys;
+  };
+
+  /* Decodes a whole JSON document. Object keys are keywords, unless keywordize is false. */
+  static object_ref decode(object_ref const str, object_ref const keywordize)
+  {
+    auto const s(runtime::to_string(str));
+    decoder d{ s, truthy(keywordize) };
+    auto const res(d.decode_all());
+    if(res.is_err())
+    {
+      throw std::runtime_error{ util::format("json decode error: {}", res.expect_err()) };
+    }
+    return res.expect_ok();
+  }
+
+  static object_ref
+  decode_in(object_ref const str, object_ref const path, object_ref const keywordize)
+  {
+    auto const s(runtime::to_string(str));
+    decoder d{ s, truthy(keywordize) };
+    auto const res(d.decode_in(path));
+    if(res.is_err())
+    {
+      throw std::runtime_error{ util::format("json decode error: {}", res.expect_err()) };
+    }
+    return res.expect_ok();
+  }
+}
+
+extern "C" void jank_load_jank_data_json_decode()
+{
+  using namespace jank;
+  using namespace jank::runtime;
+  using namespace jank::data::json::decode;
+
+  auto const ns_name{ "jank.data.json.decode" };
+  auto const ns(__rt_ctx->intern_ns(ns_name));
+
+  auto const intern_fn([=](jtl::immutable_string const &name, auto const fn) {
+    ns->intern_var(name)->bind_root(
+      make_box<obj::native_function_wrapper>(convert_function(fn))
+        ->with_meta(obj::persistent_hash_map::create_unique(std::make_pair(
+          __rt_ctx->intern_keyword("name").expect_ok(),
+          make_box(obj::symbol{ ns_name, name }.to_string())))));
+  });
+
+  intern_fn("decode", &decode);
+  intern_fn("decode-in", &decode_in);
+
+  __rt_ctx->module_loader.set_is_loaded(ns_name);
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstring>
+
+/* Word at a time (SWAR) scanning, which the decoder and encoder share for skipping over
+ * the plain bytes of a string. */
+namespace jank::data::json::detail
+{
+  static constexpr u64 low_bytes{ 0x0101010101010101 };
+  static constexpr u64 high_bits{ 0x8080808080808080 };
+
+  inline u64 load_word(char const * const p)
+  {
+    u64 ret{};
+    std::memcpy(&ret, p, sizeof(ret));
+    return ret;
+  }
+
+  /* Whether any byte of the word is a quote, a backslash, or a control character, which
+   * are the only bytes which need handling within a JSON string. */
+  inline bool has_special_byte(u64 const w)
+  {
+    auto const has_zero([](u64 const x) { return (x - low_bytes) & ~x & high_bits; });
+    auto const below_space((w - low_bytes * 0x20) & ~w & high_bits);
+    return (has_zero(w ^ (low_bytes * '"')) | has_zero(w ^ (low_bytes * '\\')) | below_space)
+      != 0;
+  }
+}
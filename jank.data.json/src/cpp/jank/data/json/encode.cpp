@@ -0,0 +1,318 @@
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+#include <jtl/immutable_string.hpp>
+#include <jtl/string_builder.hpp>
+
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/convert/function.hpp>
+#include <jank/runtime/core.hpp>
+#include <jank/runtime/obj/big_decimal.hpp>
+#include <jank/runtime/obj/big_integer.hpp>
+#include <jank/runtime/obj/character.hpp>
+#include <jank/runtime/obj/persistent_array_map.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
+#include <jank/runtime/obj/persistent_int_map.hpp>
+#include <jank/runtime/obj/persistent_sorted_map.hpp>
+#include <jank/runtime/obj/persistent_vector.hpp>
+#include <jank/runtime/obj/ratio.hpp>
+#include <jank/runtime/sequence_range.hpp>
+#include <jank/util/fmt.hpp>
+#include <jank/data/json/detail/swar.hpp>
+
+/* https://www.rfc-editor.org/rfc/rfc8259 */
+namespace jank::data::json::encode
+{
+  using namespace jank;
+  using namespace jank::runtime;
+
+  static constexpr usize max_depth{ 512 };
+
+  using jank::data::json::detail::has_special_byte;
+  using jank::data::json::detail::load_word;
+
+  /* Writes JSON straight into a string builder, with no intermediate strings for the
+   * values within it. Strings are scanned eight bytes at a time, and each run of bytes
+   * which needs no escaping is copied in one go. Anything other than ASCII is written as
+   * is, since JSON is UTF-8.
+   *
+   * Keywords and symbols are written as strings, without the colon, much like
+   * clojure.data.json does. Any map is an object, with string, keyword, symbol, or number
+   * keys, and any other seqable is an array. */
+  struct encoder
+  {
+    void write_string(jtl::immutable_string_view const &s)
+    {
+      buff('"');
+      auto const end(s.data() + s.size());
+      auto run(s.data());
+      auto pos(run);
+      while(true)
+      {
+        while(8 <= end - pos && !has_special_byte(load_word(pos)))
+        {
+          pos += 8;
+        }
+        if(pos == end)
+        {
+          break;
+        }
+
+        auto const c(*pos);
+        if(c != '"' && c != '\\' && 0x20 <= static_cast<u8>(c))
+        {
+          ++pos;
+          continue;
+        }
+
+        buff(jtl::immutable_string_view{ run, static_cast<usize>(pos - run) });
+        write_escape(c);
+        ++pos;
+        run = pos;
+      }
+      buff(jtl::immutable_string_view{ run, static_cast<usize>(end - run) });
+      buff('"');
+    }
+
+    void write_escape(char const c)
+    {
+      switch(c)
+      {
+        case '"':
+          buff(R"(\")");
+          return;
+        case '\\':
+          buff(R"(\\)");
+          return;
+        case '\n':
+          buff(R"(\n)");
+          return;
+        case '\r':
+          buff(R"(\r)");
+          return;
+        case '\t':
+          buff(R"(\t)");
+          return;
+        case '\b':
+          buff(R"(\b)");
+          return;
+        case '\f':
+          buff(R"(\f)");
+          return;
+        default:
+          {
+            static constexpr char hex[]{ "0123456789abcdef" };
+            buff(R"(\u00)");
+            buff(hex[static_cast<u8>(c) >> 4]);
+            buff(hex[static_cast<u8>(c) & 0xf]);
+          }
+      }
+    }
+
+    jtl::result<void, jtl::immutable_string> write_real(f64 const d)
+    {
+      if(!std::isfinite(d))
+      {
+        return err(util::format("unable to encode {}", d));
+      }
+
+      std::array<char, 32> digits{};
+      auto const res(std::to_chars(digits.data(), digits.data() + digits.size(), d));
+      buff(
+        jtl::immutable_string_view{ digits.data(), static_cast<usize>(res.ptr - digits.data()) });
+      /* The shortest form of a whole number has no point, which would read back as an
+       * integer. */
+      if(std::strpbrk(digits.data(), ".e") == nullptr)
+      {
+        buff(".0");
+      }
+      return ok();
+    }
+
+    static jtl::option<jtl::immutable_string> key_string(object_ref const o)
+    {
+      switch(o->type)
+      {
+        case object_type::persistent_string:
+          return expect_object<obj::persistent_string>(o)->data;
+        case object_type::keyword:
+          return expect_object<obj::keyword>(o)->sym->to_string();
+        case object_type::symbol:
+          return expect_object<obj::symbol>(o)->to_string();
+        case object_type::integer:
+          return util::format("{}", expect_object<obj::integer>(o)->data);
+        case object_type::big_integer:
+          return jtl::immutable_string{ expect_object<obj::big_integer>(o)->data.str() };
+        default:
+          return none;
+      }
+    }
+
+    jtl::result<void, jtl::immutable_string>
+    write_entry(object_ref const key, object_ref const value, bool &first, usize const depth)
+    {
+      auto const k(key_string(key));
+      if(k.is_none())
+      {
+        return err(util::format("unable to encode object key {}", runtime::to_code_string(key)));
+      }
+      if(!first)
+      {
+        buff(',');
+      }
+      first = false;
+      write_string(k.unwrap());
+      buff(':');
+      return write(value, depth + 1);
+    }
+
+    template <typename M>
+    jtl::result<void, jtl::immutable_string> write_object(M const &data, usize const depth)
+    {
+      buff('{');
+      bool first{ true };
+      for(auto const &kv : data)
+      {
+        auto const res(write_entry(kv.first, kv.second, first, depth));
+        if(res.is_err())
+        {
+          return res;
+        }
+      }
+      buff('}');
+      return ok();
+    }
+
+    jtl::result<void, jtl::immutable_string> write(object_ref const o, usize const depth)
+    {
+      if(max_depth < depth)
+      {
+        return err(jtl::immutable_string{ "data is nested too deeply" });
+      }
+
+      switch(o->type)
+      {
+        case object_type::nil:
+          buff("null");
+          return ok();
+        case object_type::boolean:
+          buff(truthy(o) ? "true" : "false");
+          return ok();
+        case object_type::integer:
+          buff(static_cast<long long>(expect_object<obj::integer>(o)->data));
+          return ok();
+        case object_type::big_integer:
+          buff(expect_object<obj::big_integer>(o)->data);
+          return ok();
+        case object_type::real:
+          return write_real(expect_object<obj::real>(o)->data);
+        case object_type::ratio:
+          return write_real(expect_object<obj::ratio>(o)->data.to_real());
+        case object_type::big_decimal:
+          buff(expect_object<obj::big_decimal>(o)->data.str());
+          return ok();
+        case object_type::persistent_string:
+          write_string(expect_object<obj::persistent_string>(o)->data);
+          return ok();
+        case object_type::keyword:
+          write_string(expect_object<obj::keyword>(o)->sym->to_string());
+          return ok();
+        case object_type::symbol:
+          write_string(expect_object<obj::symbol>(o)->to_string());
+          return ok();
+        case object_type::character:
+          write_string(expect_object<obj::character>(o)->data);
+          return ok();
+        case object_type::uuid:
+          write_string(runtime::to_string(o));
+          return ok();
+        case object_type::persistent_array_map:
+          return write_object(expect_object<obj::persistent_array_map>(o)->data, depth);
+        case object_type::persistent_hash_map:
+          return write_object(expect_object<obj::persistent_hash_map>(o)->data, depth);
+        case object_type::persistent_sorted_map:
+          return write_object(expect_object<obj::persistent_sorted_map>(o)->data, depth);
+        case object_type::persistent_int_map:
+          return write_object(expect_object<obj::persistent_int_map>(o)->data, depth);
+        default:
+          break;
+      }
+
+      if(is_map(o))
+      {
+        buff('{');
+        bool first{ true };
+        for(auto const e : make_sequence_range(o))
+        {
+          auto const res(write_entry(runtime::first(e), runtime::second(e), first, depth));
+          if(res.is_err())
+          {
+            return res;
+          }
+        }
+        buff('}');
+        return ok();
+      }
+      else if(is_seqable(o))
+      {
+        buff('[');
+        bool first{ true };
+        jtl::result<void, jtl::immutable_string> res{ ok() };
+        for_each_item(o, [&](object_ref const e) {
+          if(!first)
+          {
+            buff(',');
+          }
+          first = false;
+          res = write(e, depth + 1);
+          return res.is_ok();
+        });
+        if(res.is_err())
+        {
+          return res;
+        }
+        buff(']');
+        return ok();
+      }
+
+      return err(util::format("unable to encode {}", runtime::to_code_string(o)));
+    }
+
+    jtl::string_builder buff;
+  };
+
+  static object_ref encode(object_ref const o)
+  {
+    encoder e;
+    auto const res(e.write(o, 0));
+    if(res.is_err())
+    {
+      throw std::runtime_error{ util::format("json encode error: {}", res.expect_err()) };
+    }
+    return make_box<obj::persistent_string>(e.buff.release());
+  }
+}
+
+extern "C" void jank_load_jank_data_json_encode()
+{
+  using namespace jank;
+  using namespace jank::runtime;
+  using namespace jank::data::json::encode;
+
+  auto const ns_name{ "jank.data.json.encode" };
+  auto const ns(__rt_ctx->intern_ns(ns_name));
+
+  auto const intern_fn([=](jtl::immutable_string const &name, auto const fn) {
+    ns->intern_var(name)->bind_root(
+      make_box<obj::native_function_wrapper>(convert_function(fn))
+        ->with_meta(obj::persistent_hash_map::create_unique(std::make_pair(
+          __rt_ctx->intern_keyword("name").expect_ok(),
+          make_box(obj::symbol{ ns_name, name }.to_string())))));
+  });
+
+  intern_fn("encode", &encode);
+
+  __rt_ctx->module_loader.set_is_loaded(ns_name);
+}
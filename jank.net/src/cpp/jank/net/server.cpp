@@ -0,0 +1,959 @@
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <boost/asio.hpp>
+
+#include <gc/gc.h>
+#include <gc/gc_allocator.h>
+
+#include <jtl/immutable_string.hpp>
+
+#include <jank/runtime/behavior/callable.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/convert/function.hpp>
+#include <jank/runtime/core.hpp>
+#include <jank/runtime/executor.hpp>
+#include <jank/runtime/obj/array.hpp>
+#include <jank/runtime/obj/native_function_wrapper.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
+#include <jank/runtime/obj/persistent_string.hpp>
+#include <jank/runtime/sequence_range.hpp>
+#include <jank/util/fmt.hpp>
+#include <jank/util/fmt/print.hpp>
+
+namespace jank::net::server
+{
+  using namespace jank;
+  using namespace jank::runtime;
+  using boost::asio::ip::tcp;
+
+  /* Each read gets at least this much room. */
+  static constexpr usize min_read_room{ 16 * 1024 };
+  /* A new receive buffer is at least this big. */
+  static constexpr usize receive_buffer_size{ 64 * 1024 };
+  /* A request whose head is bigger than this is turned away. */
+  static constexpr usize max_head_size{ 64 * 1024 };
+  static constexpr usize default_max_body_size{ 16 * 1024 * 1024 };
+  /* Once this much output is waiting to be written to a connection, sending more to it
+   * waits until some of it is written. */
+  static constexpr usize max_pending_output{ 8 * 1024 * 1024 };
+
+  /* Connections and servers are owned by asio's handlers and the executor's tasks, which
+   * the GC can't see into, but they hold jank objects. So they're allocated such that the
+   * GC scans them, but only shared_ptr frees them. */
+  template <typename T, typename... Args>
+  static std::shared_ptr<T> make_traced(Args &&...args)
+  {
+    return std::allocate_shared<T>(traceable_allocator<T>{}, std::forward<Args>(args)...);
+  }
+
+  static object_ref keyword(char const * const name)
+  {
+    return __rt_ctx->intern_keyword(name).expect_ok();
+  }
+
+  static bool iequals(std::string_view const l, std::string_view const r)
+  {
+    return l.size() == r.size() && std::equal(l.begin(), l.end(), r.begin(), [](auto a, auto b) {
+             return std::tolower(static_cast<unsigned char>(a))
+               == std::tolower(static_cast<unsigned char>(b));
+           });
+  }
+
+  static std::string lower(std::string_view const s)
+  {
+    std::string ret{ s };
+    std::ranges::transform(ret, ret.begin(), [](unsigned char const c) {
+      return static_cast<char>(std::tolower(c));
+    });
+    return ret;
+  }
+
+  static std::string_view trim(std::string_view s)
+  {
+    auto const first{ s.find_first_not_of(" \t") };
+    if(first == std::string_view::npos)
+    {
+      return {};
+    }
+    s.remove_prefix(first);
+    return s.substr(0, s.find_last_not_of(" \t") + 1);
+  }
+
+  /* What's been read from a socket. Bytes are never written over once they're read, so byte
+   * views into them stay valid for as long as anybody holds them. Each read goes after the
+   * bytes before it, until there's too little room left, and then a new buffer is started.
+   * The buffers are pointer free GC memory, which the views keep alive, since each view
+   * points into its buffer. */
+  struct receive_buffer
+  {
+    /* Makes room for at least n more bytes after the end, keeping the bytes which haven't
+     * been used up yet together. */
+    void reserve(usize const n)
+    {
+      if(capacity - end >= n)
+      {
+        return;
+      }
+
+      auto const kept{ end - start };
+      auto const size{ std::max(receive_buffer_size, kept + n) };
+      auto const fresh{ static_cast<char *>(GC_MALLOC_ATOMIC(size)) };
+      if(!fresh)
+      {
+        throw std::bad_alloc{};
+      }
+      std::memcpy(fresh, data + start, kept);
+      data = fresh;
+      capacity = size;
+      start = 0;
+      end = kept;
+    }
+
+    std::string_view unused() const
+    {
+      return { data + start, end - start };
+    }
+
+    char *data{};
+    usize capacity{};
+    /* What's between these has been read, but not yet used up. */
+    usize start{}, end{};
+  };
+
+  enum class parse_result : u8
+  {
+    complete,
+    incomplete,
+    invalid
+  };
+
+  struct http_header
+  {
+    std::string_view name, value;
+  };
+
+  /* Everything here points into the receive buffer. */
+  struct request_head
+  {
+    std::string_view method, target, protocol;
+    std::vector<http_header> headers;
+    /* Up to and including the blank line which ends the head. */
+    usize size{};
+    usize content_length{};
+    bool keep_alive{ true };
+    bool chunked{};
+  };
+
+  /* Parses the request line and headers of an HTTP/1.x request, in the manner of
+   * picohttpparser. Nothing is copied. This gives incomplete until the whole head is
+   * there. */
+  static parse_result parse_head(std::string_view in, request_head &out)
+  {
+    /* Clients may send blank lines between requests. */
+    while(in.starts_with("\r\n"))
+    {
+      in.remove_prefix(2);
+      out.size += 2;
+    }
+
+    auto const end{ in.find("\r\n\r\n") };
+    if(end == std::string_view::npos)
+    {
+      return in.size() > max_head_size ? parse_result::invalid : parse_result::incomplete;
+    }
+    out.size += end + 4;
+
+    auto lines{ in.substr(0, end + 2) };
+    auto const next_line([&] {
+      auto const eol{ lines.find("\r\n") };
+      auto const line{ lines.substr(0, eol) };
+      lines.remove_prefix(eol + 2);
+      return line;
+    });
+
+    auto const request_line{ next_line() };
+    auto const method_end{ request_line.find(' ') };
+    auto const target_end{ request_line.rfind(' ') };
+    if(method_end == std::string_view::npos || method_end == 0 || target_end <= method_end + 1)
+    {
+      return parse_result::invalid;
+    }
+    out.method = request_line.substr(0, method_end);
+    out.target = request_line.substr(method_end + 1, target_end - method_end - 1);
+    out.protocol = request_line.substr(target_end + 1);
+    if(out.protocol == "HTTP/1.0")
+    {
+      out.keep_alive = false;
+    }
+    else if(out.protocol != "HTTP/1.1")
+    {
+      return parse_result::invalid;
+    }
+
+    while(!lines.empty())
+    {
+      auto const line{ next_line() };
+      auto const colon{ line.find(':') };
+      if(colon == std::string_view::npos || colon == 0)
+      {
+        return parse_result::invalid;
+      }
+
+      auto const name{ line.substr(0, colon) };
+      auto const value{ trim(line.substr(colon + 1)) };
+      if(name.find_first_of(" \t") != std::string_view::npos)
+      {
+        return parse_result::invalid;
+      }
+
+      if(iequals(name, "content-length"))
+      {
+        auto const res{
+          std::from_chars(value.data(), value.data() + value.size(), out.content_length)
+        };
+        if(value.empty() || res.ec != std::errc{} || res.ptr != value.data() + value.size())
+        {
+          return parse_result::invalid;
+        }
+      }
+      else if(iequals(name, "transfer-encoding"))
+      {
+        out.chunked = !iequals(value, "identity");
+      }
+      else if(iequals(name, "connection"))
+      {
+        if(iequals(value, "close"))
+        {
+          out.keep_alive = false;
+        }
+        else if(iequals(value, "keep-alive"))
+        {
+          out.keep_alive = true;
+        }
+      }
+      out.headers.push_back({ name, value });
+    }
+    return parse_result::complete;
+  }
+
+  static char const *reason_phrase(i64 const status)
+  {
+    switch(status)
+    {
+      case 200:
+        return "OK";
+      case 201:
+        return "Created";
+      case 202:
+        return "Accepted";
+      case 204:
+        return "No Content";
+      case 301:
+        return "Moved Permanently";
+      case 302:
+        return "Found";
+      case 303:
+        return "See Other";
+      case 304:
+        return "Not Modified";
+      case 307:
+        return "Temporary Redirect";
+      case 308:
+        return "Permanent Redirect";
+      case 400:
+        return "Bad Request";
+      case 401:
+        return "Unauthorized";
+      case 403:
+        return "Forbidden";
+      case 404:
+        return "Not Found";
+      case 405:
+        return "Method Not Allowed";
+      case 409:
+        return "Conflict";
+      case 413:
+        return "Content Too Large";
+      case 429:
+        return "Too Many Requests";
+      case 431:
+        return "Request Header Fields Too Large";
+      case 500:
+        return "Internal Server Error";
+      case 501:
+        return "Not Implemented";
+      case 502:
+        return "Bad Gateway";
+      case 503:
+        return "Service Unavailable";
+      default:
+        return "";
+    }
+  }
+
+  static object_ref error_response(i64 const status, jtl::immutable_string const &message)
+  {
+    return obj::persistent_hash_map::create_unique(
+      std::make_pair(keyword("status"), make_box(status)),
+      std::make_pair(keyword("headers"),
+                     obj::persistent_hash_map::create_unique(
+                       std::make_pair(make_box("content-type"), make_box("text/plain")))),
+      std::make_pair(keyword("body"), make_box(message)));
+  }
+
+  /* Strings and byte arrays are written as they are. Anything else is written as its
+   * string. */
+  static object_ref as_piece(object_ref const o)
+  {
+    if(o->type == object_type::persistent_string)
+    {
+      return o;
+    }
+    else if(o->type == object_type::array)
+    {
+      if(expect_object<obj::array>(o)->element != obj::array::element_type::byte)
+      {
+        throw std::runtime_error{ "only byte arrays can be written to a connection" };
+      }
+      return o;
+    }
+    return make_box(runtime::to_string(o));
+  }
+
+  static boost::asio::const_buffer buffer_of(object_ref const piece)
+  {
+    if(piece->type == object_type::array)
+    {
+      auto const a{ expect_object<obj::array>(piece) };
+      return { a->data, a->length };
+    }
+    auto const &s{ expect_object<obj::persistent_string>(piece)->data };
+    return { s.data(), s.size() };
+  }
+
+  struct server
+  {
+    server(object_ref const handler, bool const http, usize const max_body_size)
+      : handler{ handler }
+      , http{ http }
+      , max_body_size{ max_body_size }
+    {
+    }
+
+    void stop()
+    {
+      if(!stopping.exchange(true))
+      {
+        io_context.stop();
+        for(auto &t : threads)
+        {
+          if(t.joinable())
+          {
+            t.join();
+          }
+        }
+        {
+          std::lock_guard<std::mutex> const lock{ mutex };
+          stopped = true;
+        }
+        stopped_cv.notify_all();
+      }
+    }
+
+    void join()
+    {
+      std::unique_lock<std::mutex> lock{ mutex };
+      stopped_cv.wait(lock, [this] { return stopped; });
+    }
+
+    object_ref handler;
+    bool http{};
+    usize max_body_size{};
+    boost::asio::io_context io_context;
+    std::unique_ptr<tcp::acceptor> acceptor;
+    std::vector<std::thread> threads;
+    std::atomic_bool stopping{};
+    std::mutex mutex;
+    std::condition_variable stopped_cv;
+    bool stopped{};
+  };
+
+  /* All socket work for a connection happens on its strand. Handlers run on the pooled
+   * executor, one at a time for each connection, so HTTP responses go out in the order
+   * their requests came in. Output can be queued from any thread. Whatever has built up
+   * by the time the last write is done goes out in a single scatter-gather write, straight
+   * from the strings and byte arrays it was given. */
+  struct connection : std::enable_shared_from_this<connection>
+  {
+    connection(std::shared_ptr<server> const &srv, tcp::socket &&socket)
+      : srv{ srv }
+      , socket{ std::move(socket) }
+    {
+      boost::system::error_code ec;
+      auto const endpoint{ this->socket.remote_endpoint(ec) };
+      if(!ec)
+      {
+        remote_addr = endpoint.address().to_string();
+      }
+    }
+
+    void start()
+    {
+      if(!srv->http)
+      {
+        std::weak_ptr<connection> const weak{ shared_from_this() };
+        send_fn = make_box<obj::native_function_wrapper>(
+          std::function<object_ref(object_ref const)>{ [weak](object_ref const o) {
+            if(auto const self = weak.lock())
+            {
+              o.is_nil() ? self->close_after_writes() : self->send(as_piece(o));
+            }
+            return jank_nil();
+          } });
+      }
+      read_more();
+    }
+
+    void read_more()
+    {
+      input.reserve(min_read_room);
+      socket.async_read_some(
+        boost::asio::buffer(input.data + input.end, input.capacity - input.end),
+        [self = shared_from_this()](boost::system::error_code const ec, usize const length) {
+          if(ec)
+          {
+            self->srv->http ? self->close() : self->run_tcp_handler(jank_nil());
+            return;
+          }
+          self->input.end += length;
+          self->srv->http ? self->parse_requests() : self->read_chunk();
+        });
+    }
+
+    /* HTTP. Runs on the strand, once the last response is written. */
+    void parse_requests()
+    {
+      request_head head;
+      switch(parse_head(input.unused(), head))
+      {
+        case parse_result::incomplete:
+          read_more();
+          return;
+        case parse_result::invalid:
+          respond_and_close(input.unused().size() > max_head_size ? 431 : 400,
+                            "invalid request");
+          return;
+        case parse_result::complete:
+          break;
+      }
+
+      if(head.chunked)
+      {
+        respond_and_close(501, "chunked request bodies aren't supported");
+        return;
+      }
+      if(head.content_length > srv->max_body_size)
+      {
+        respond_and_close(413, "request body is too large");
+        return;
+      }
+
+      auto const size{ head.size + head.content_length };
+      if(input.unused().size() < size)
+      {
+        /* The head points into the buffer, which this may replace, so it has to be parsed
+         * again once the rest is in. */
+        input.reserve(size - input.unused().size());
+        read_more();
+        return;
+      }
+
+      keep_alive = head.keep_alive;
+      head_request = head.method == "HEAD";
+      pending = make_request(head);
+      input.start += size;
+      run_http_handler();
+    }
+
+    object_ref make_request(request_head const &head) const
+    {
+      auto headers{ obj::persistent_hash_map::empty() };
+      for(auto const &h : head.headers)
+      {
+        /* As with Ring, header names are lower case and repeated headers are joined. */
+        auto const name{ make_box(jtl::immutable_string{ lower(h.name) }) };
+        auto const existing{ headers->get(name) };
+        auto const value{ make_box(jtl::immutable_string{ h.value.data(), h.value.size() }) };
+        headers = headers->assoc(name,
+                                 existing.is_nil() ? object_ref{ value }
+                                                   : make_box(util::format("{},{}",
+                                                                           to_string(existing),
+                                                                           to_string(value))));
+      }
+
+      auto const query{ head.target.find('?') };
+      auto const uri{ head.target.substr(0, query) };
+      object_ref query_string{ jank_nil() };
+      if(query != std::string_view::npos)
+      {
+        auto const q{ head.target.substr(query + 1) };
+        query_string = make_box(jtl::immutable_string{ q.data(), q.size() });
+      }
+
+      object_ref body{ jank_nil() };
+      if(head.content_length != 0)
+      {
+        body = make_box<obj::array>(obj::array::element_type::byte,
+                                    input.data + input.start + head.size,
+                                    head.content_length);
+      }
+
+      return obj::persistent_hash_map::create_unique(
+        std::make_pair(keyword("request-method"),
+                       __rt_ctx->intern_keyword(jtl::immutable_string{ lower(head.method) })
+                         .expect_ok()),
+        std::make_pair(keyword("uri"), make_box(jtl::immutable_string{ uri.data(), uri.size() })),
+        std::make_pair(keyword("query-string"), query_string),
+        std::make_pair(keyword("protocol"),
+                       make_box(jtl::immutable_string{ head.protocol.data(),
+                                                       head.protocol.size() })),
+        std::make_pair(keyword("headers"), headers),
+        std::make_pair(keyword("body"), body),
+        std::make_pair(keyword("remote-addr"), make_box(jtl::immutable_string{ remote_addr })),
+        std::make_pair(keyword("scheme"), keyword("http")));
+    }
+
+    void run_http_handler()
+    {
+      pooled_executor().submit([self = shared_from_this()] {
+        auto const request{ self->pending };
+        self->pending = jank_nil();
+
+        object_ref response;
+        try
+        {
+          response = dynamic_call(self->srv->handler, request);
+        }
+        catch(std::exception const &e)
+        {
+          response = error_response(500, e.what());
+        }
+        catch(object_ref const e)
+        {
+          response = error_response(500, runtime::to_code_string(e));
+        }
+        catch(...)
+        {
+          response = error_response(500, "unknown error");
+        }
+
+        try
+        {
+          self->respond(response);
+        }
+        catch(std::exception const &e)
+        {
+          self->respond(error_response(500, e.what()));
+        }
+      });
+    }
+
+    void respond_and_close(i64 const status, jtl::immutable_string const &message)
+    {
+      keep_alive = false;
+      head_request = false;
+      respond(error_response(status, message));
+    }
+
+    /* Builds the head and queues it with the pieces of the body, all at once, so none of
+     * them are written until the whole response is queued. */
+    void respond(object_ref const response)
+    {
+      auto const status_obj{ get(response, keyword("status")) };
+      auto const status{ status_obj.is_nil() ? 200 : to_int(status_obj) };
+      std::string head{ util::format("HTTP/1.1 {} {}\r\n", status, reason_phrase(status)) };
+      bool has_length{}, closing{ !keep_alive || srv->stopping.load() };
+
+      auto const headers{ get(response, keyword("headers")) };
+      if(!headers.is_nil())
+      {
+        for_each_item(headers, [&](object_ref const entry) {
+          auto const name{ to_string(first(entry)) };
+          auto const values{ second(entry) };
+          auto const add([&](object_ref const v) {
+            auto const value{ to_string(v) };
+            head.append(name.data(), name.size()).append(": ");
+            head.append(value.data(), value.size()).append("\r\n");
+            has_length |= iequals({ name.data(), name.size() }, "content-length");
+            closing |= iequals({ name.data(), name.size() }, "connection")
+              && iequals({ value.data(), value.size() }, "close");
+          });
+          if(values->type == object_type::persistent_string)
+          {
+            add(values);
+          }
+          else
+          {
+            for_each_item(values, add);
+          }
+        });
+      }
+
+      std::vector<object_ref> pieces;
+      usize body_size{};
+      auto const add_piece([&](object_ref const o) {
+        auto const piece{ as_piece(o) };
+        body_size += buffer_of(piece).size();
+        pieces.emplace_back(piece);
+      });
+      auto const body{ get(response, keyword("body")) };
+      if(body->type == object_type::persistent_string || body->type == object_type::array)
+      {
+        add_piece(body);
+      }
+      else if(!body.is_nil())
+      {
+        for_each_item(body, add_piece);
+      }
+
+      if(!has_length)
+      {
+        head.append(util::format("Content-Length: {}\r\n", body_size));
+      }
+      if(closing)
+      {
+        head.append("Connection: close\r\n");
+      }
+      head.append("\r\n");
+
+      if(head_request)
+      {
+        pieces.clear();
+      }
+      pieces.insert(pieces.begin(), make_box(jtl::immutable_string{ head }));
+      send_all(pieces, closing);
+    }
+
+    /* TCP. Runs on the strand, after each read. */
+    void read_chunk()
+    {
+      auto const bytes{ make_box<obj::array>(obj::array::element_type::byte,
+                                             input.data + input.start,
+                                             input.end - input.start) };
+      input.start = input.end;
+      run_tcp_handler(bytes);
+    }
+
+    /* The handler is given nil, once, when the other side is done sending. */
+    void run_tcp_handler(object_ref const bytes)
+    {
+      pending = bytes;
+      pooled_executor().submit([self = shared_from_this()] {
+        auto const bytes{ self->pending };
+        self->pending = jank_nil();
+
+        try
+        {
+          dynamic_call(self->srv->handler, bytes, self->send_fn);
+        }
+        catch(std::exception const &e)
+        {
+          util::println(stderr, "Uncaught exception in connection handler: {}", e.what());
+          self->close_after_writes();
+        }
+        catch(object_ref const e)
+        {
+          util::println(stderr,
+                        "Uncaught exception in connection handler: {}",
+                        runtime::to_code_string(e));
+          self->close_after_writes();
+        }
+
+        if(bytes.is_nil())
+        {
+          self->close_after_writes();
+        }
+        else
+        {
+          boost::asio::post(self->socket.get_executor(), [self] {
+            if(!self->closing_after_writes && !self->is_closed())
+            {
+              self->read_more();
+            }
+          });
+        }
+      });
+    }
+
+    /* Queues a piece of output. Sending waits while too much is already queued, so a
+     * handler can't run away from a slow client. */
+    void send(object_ref const piece)
+    {
+      bool start_write{};
+      {
+        std::unique_lock<std::mutex> lock{ mutex };
+        output_drained.wait(lock, [&] { return closed || queued_bytes < max_pending_output; });
+        if(closed)
+        {
+          return;
+        }
+        queued_bytes += buffer_of(piece).size();
+        queued.emplace_back(piece);
+        start_write = !write_in_flight;
+        write_in_flight = true;
+      }
+      if(start_write)
+      {
+        boost::asio::post(socket.get_executor(),
+                          [self = shared_from_this()] { self->write_queued(); });
+      }
+    }
+
+    /* Queues every piece together and then, once they're all written, either closes the
+     * connection or goes on to the next request. */
+    void send_all(std::vector<object_ref> const &pieces, bool const close_when_done)
+    {
+      {
+        std::lock_guard<std::mutex> const lock{ mutex };
+        if(closed)
+        {
+          return;
+        }
+        for(auto const piece : pieces)
+        {
+          queued_bytes += buffer_of(piece).size();
+          queued.emplace_back(piece);
+        }
+        response_queued = true;
+        closing_after_writes = close_when_done;
+        write_in_flight = true;
+      }
+      boost::asio::post(socket.get_executor(),
+                        [self = shared_from_this()] { self->write_queued(); });
+    }
+
+    void close_after_writes()
+    {
+      {
+        std::lock_guard<std::mutex> const lock{ mutex };
+        closing_after_writes = true;
+        if(write_in_flight)
+        {
+          return;
+        }
+      }
+      boost::asio::post(socket.get_executor(), [self = shared_from_this()] { self->close(); });
+    }
+
+    void write_queued()
+    {
+      {
+        std::lock_guard<std::mutex> const lock{ mutex };
+        writing.clear();
+        std::swap(writing, queued);
+      }
+
+      buffers.clear();
+      for(auto const piece : writing)
+      {
+        buffers.emplace_back(buffer_of(piece));
+      }
+
+      boost::asio::async_write(
+        socket,
+        buffers,
+        [self = shared_from_this()](boost::system::error_code const ec, usize const length) {
+          if(ec)
+          {
+            self->close();
+            return;
+          }
+
+          bool more{}, response_done{}, close_now{};
+          {
+            std::lock_guard<std::mutex> const lock{ self->mutex };
+            self->queued_bytes -= length;
+            more = !self->queued.empty();
+            self->write_in_flight = more;
+            if(!more)
+            {
+              response_done = std::exchange(self->response_queued, false);
+              close_now = self->closing_after_writes;
+            }
+          }
+          self->output_drained.notify_all();
+
+          if(more)
+          {
+            self->write_queued();
+          }
+          else if(close_now)
+          {
+            self->close();
+          }
+          else if(response_done)
+          {
+            self->parse_requests();
+          }
+        });
+    }
+
+    bool is_closed()
+    {
+      std::lock_guard<std::mutex> const lock{ mutex };
+      return closed;
+    }
+
+    void close()
+    {
+      {
+        std::lock_guard<std::mutex> const lock{ mutex };
+        if(closed)
+        {
+          return;
+        }
+        closed = true;
+        queued.clear();
+      }
+      output_drained.notify_all();
+
+      boost::system::error_code ec;
+      socket.close(ec);
+    }
+
+    std::shared_ptr<server> srv;
+    tcp::socket socket;
+    std::string remote_addr;
+    receive_buffer input;
+    /* The request, or the bytes, for the handler which is about to run. */
+    object_ref pending{};
+    /* For TCP handlers, to send output, or nil to close once it's all written. */
+    object_ref send_fn{};
+    /* Only touched on the strand, or by the handler, while the strand waits on it. */
+    bool keep_alive{ true };
+    bool head_request{};
+
+    std::mutex mutex;
+    std::condition_variable output_drained;
+    std::deque<object_ref, traceable_allocator<object_ref>> queued;
+    usize queued_bytes{};
+    bool write_in_flight{};
+    bool response_queued{};
+    bool closing_after_writes{};
+    bool closed{};
+    /* Only touched on the strand. */
+    std::deque<object_ref, traceable_allocator<object_ref>> writing;
+    std::vector<boost::asio::const_buffer> buffers;
+  };
+
+  static void accept_connection(std::shared_ptr<server> const &srv)
+  {
+    srv->acceptor->async_accept(boost::asio::make_strand(srv->io_context),
+                                [srv](boost::system::error_code const ec, tcp::socket socket) {
+                                  if(!ec)
+                                  {
+                                    socket.set_option(tcp::no_delay{ true });
+                                    make_traced<connection>(srv, std::move(socket))->start();
+                                  }
+                                  if(!srv->stopping.load())
+                                  {
+                                    accept_connection(srv);
+                                  }
+                                });
+  }
+
+  /* Starts serving on its own threads and gives back right away. */
+  static object_ref serve(object_ref const opts, object_ref const handler, bool const http)
+  {
+    auto const port_obj{ get(opts, keyword("port")) };
+    auto const threads_obj{ get(opts, keyword("threads")) };
+    auto const max_body_obj{ get(opts, keyword("max-body-size")) };
+    auto const port{ static_cast<u16>(port_obj.is_nil() ? 0 : to_int(port_obj)) };
+    auto const thread_count{ threads_obj.is_nil()
+                               ? std::max<usize>(1, std::thread::hardware_concurrency())
+                               : static_cast<usize>(to_int(threads_obj)) };
+    auto const max_body_size{ max_body_obj.is_nil() ? default_max_body_size
+                                                    : static_cast<usize>(to_int(max_body_obj)) };
+
+    auto const srv{ make_traced<server>(handler, http, max_body_size) };
+    srv->acceptor
+      = std::make_unique<tcp::acceptor>(srv->io_context, tcp::endpoint(tcp::v4(), port));
+    accept_connection(srv);
+
+    /* This needs to happen on a thread the GC already knows about, before any other
+     * threads try to register themselves. */
+    GC_allow_register_threads();
+    srv->threads.reserve(thread_count);
+    for(usize i{}; i < thread_count; ++i)
+    {
+      srv->threads.emplace_back([srv] {
+        gc_thread_scope const gc_scope;
+        srv->io_context.run();
+      });
+    }
+
+    auto const fn([](auto const &f) {
+      return make_box<obj::native_function_wrapper>(std::function<object_ref()>{ f });
+    });
+    std::weak_ptr<server> const weak{ srv };
+    return obj::persistent_hash_map::create_unique(
+      std::make_pair(keyword("port"),
+                     make_box(static_cast<i64>(srv->acceptor->local_endpoint().port()))),
+      std::make_pair(keyword("stop"), fn([srv] {
+                       srv->stop();
+                       return jank_nil();
+                     })),
+      std::make_pair(keyword("join"), fn([weak] {
+                       if(auto const srv = weak.lock())
+                       {
+                         srv->join();
+                       }
+                       return jank_nil();
+                     })));
+  }
+
+  object_ref serve_http(object_ref const opts, object_ref const handler)
+  {
+    return serve(opts, handler, true);
+  }
+
+  object_ref serve_tcp(object_ref const opts, object_ref const handler)
+  {
+    return serve(opts, handler, false);
+  }
+}
+
+extern "C" void jank_load_jank_net_server()
+{
+  using namespace jank;
+  using namespace jank::runtime;
+  using namespace jank::net::server;
+
+  auto const ns_name{ "jank.net.server" };
+  auto const ns(__rt_ctx->intern_ns(ns_name));
+
+  auto const intern_fn([=](jtl::immutable_string const &name, auto const fn) {
+    ns->intern_var(name)->bind_root(
+      make_box<obj::native_function_wrapper>(convert_function(fn))
+        ->with_meta(obj::persistent_hash_map::create_unique(std::make_pair(
+          __rt_ctx->intern_keyword("name").expect_ok(),
+          make_box(obj::symbol{ ns_name, name }.to_string())))));
+  });
+
+  intern_fn("serve-http", &serve_http);
+  intern_fn("serve-tcp", &serve_tcp);
+
+  __rt_ctx->module_loader.set_is_loaded(ns_name);
+}
@@ -8,6 +8,8 @@
   :jank {:include-paths []
          :includes []}
   :source-paths ["src/jank"
-                 "src/cpp"]
+                 "src/cpp"
+                 "../jank.data.bencode/src/jank"
+                 "../jank.data.bencode/src/cpp"]
   :profiles {:uberjar {:aot :all
                        :jvm-opts ["-Dclojure.compiler.direct-linking=true"]}})
@@ -1,95 +1,541 @@
-#include <boost/asio/ts/buffer.hpp>
-#include <boost/asio/ts/internet.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include <boost/asio.hpp>
+
+#include <gc/gc.h>
+#include <gc/gc_allocator.h>
+
+#include <jtl/immutable_string.hpp>
+
+#include <jank/runtime/behavior/callable.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/convert/function.hpp>
+#include <jank/runtime/core.hpp>
+#include <jank/runtime/core/equal.hpp>
+#include <jank/runtime/executor.hpp>
+#include <jank/runtime/obj/native_function_wrapper.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
+#include <jank/runtime/obj/persistent_vector.hpp>
+#include <jank/runtime/sequence_range.hpp>
+#include <jank/util/fmt.hpp>
+#include <jank/util/fmt/print.hpp>
 
 namespace jank::nrepl_server::asio
 {
+  using namespace jank;
   using namespace jank::runtime;
   using boost::asio::ip::tcp;
 
-  struct connection : public std::enable_shared_from_this<connection>
+  /* How much we read from a socket at once. */
+  static constexpr usize read_size{ 64 * 1024 };
+  /* Once this many messages from one connection are waiting on evaluation, we stop reading
+   * from it until some of them are done. */
+  static constexpr usize max_queued_messages{ 64 };
+  /* Likewise, once this much output is waiting to be written to a connection, we stop
+   * reading from it, and anything evaluating for it waits before sending more. */
+  static constexpr usize max_pending_output{ 8 * 1024 * 1024 };
+
+  struct server_metrics
+  {
+    std::atomic<u64> open_connections{};
+    std::atomic<u64> total_connections{};
+    std::atomic<u64> queued_evals{};
+    std::atomic<u64> running_evals{};
+    std::atomic<u64> completed_evals{};
+    std::atomic<u64> failed_evals{};
+    std::atomic<u64> bytes_read{};
+    std::atomic<u64> bytes_written{};
+  };
+
+  static server_metrics metrics;
+
+  /* Connections and sessions are owned by asio's handlers and the executor's tasks, which
+   * the GC can't see into, but they hold jank objects. So they're allocated such that the
+   * GC scans them, but only shared_ptr frees them. The same goes for the server. */
+  template <typename T, typename... Args>
+  static std::shared_ptr<T> make_traced(Args &&...args)
+  {
+    return std::allocate_shared<T>(traceable_allocator<T>{}, std::forward<Args>(args)...);
+  }
+
+  struct server
+  {
+    server(object_ref const handler)
+      : handler{ handler }
+      , feed{ __rt_ctx->find_var("jank.data.bencode", "feed!") }
+      , decoder{ __rt_ctx->find_var("jank.data.bencode", "decoder") }
+      , encode{ __rt_ctx->find_var("jank.data.bencode", "encode") }
+    {
+    }
+
+    object_ref handler;
+    var_ref feed, decoder, encode;
+    boost::asio::io_context io_context;
+    std::unique_ptr<tcp::acceptor> acceptor;
+  };
+
+  static std::shared_ptr<server> current_server;
+
+  struct connection;
+
+  struct pending_message
+  {
+    std::shared_ptr<connection> conn;
+    object_ref message;
+  };
+
+  /* The messages of a session are evaluated one after the other, in the order they came
+   * in, but separate sessions are evaluated in parallel, so one slow eval doesn't hold up
+   * the rest. An eval may block for as long as it likes, so this runs on the solo executor
+   * rather than on the threads doing IO. */
+  struct session_queue : std::enable_shared_from_this<session_queue>
+  {
+    void submit(pending_message &&m);
+    void drain();
+
+    std::mutex mutex;
+    std::deque<pending_message, traceable_allocator<pending_message>> messages;
+    bool running{};
+  };
+
+  /* Sessions can be used from any connection, like with nREPL. */
+  static std::mutex sessions_mutex;
+  static std::unordered_map<std::string, std::shared_ptr<session_queue>> sessions;
+
+  static std::shared_ptr<session_queue> find_session(std::string const &id)
+  {
+    std::lock_guard<std::mutex> const lock{ sessions_mutex };
+    auto &ret(sessions[id]);
+    if(!ret)
+    {
+      ret = make_traced<session_queue>();
+    }
+    return ret;
+  }
+
+  static void remove_session(std::string const &id)
+  {
+    std::lock_guard<std::mutex> const lock{ sessions_mutex };
+    sessions.erase(id);
+  }
+
+  /* All socket work for a connection happens on its strand. Responses can be sent from any
+   * thread, though. They're added onto the output buffer and whatever has built up by the
+   * time the last write is done goes out in a single write, which keeps streamed output
+   * from turning into a write per message. */
+  struct connection : std::enable_shared_from_this<connection>
   {
     connection(tcp::socket &&socket)
-      : socket_(std::move(socket))
+      : socket{ std::move(socket) }
+      , buffer{ std::make_unique<char[]>(read_size) }
+      , decoder{ dynamic_call(current_server->decoder->deref()) }
+      , default_session{ make_traced<session_queue>() }
     {
+    }
+
+    void start()
+    {
+      ++metrics.open_connections;
+      ++metrics.total_connections;
       do_read();
     }
 
     void do_read()
     {
-      auto self(shared_from_this());
-      socket_.async_read_some(boost::asio::buffer(data_, max_length),
-                              [this, self](boost::system::error_code ec, std::size_t length) {
-                                if(!ec)
-                                {
-                                  do_write(length);
-                                }
-                              });
+      socket.async_read_some(
+        boost::asio::buffer(buffer.get(), read_size),
+        [self = shared_from_this()](boost::system::error_code const ec, usize const length) {
+          if(ec)
+          {
+            self->close();
+            return;
+          }
+          metrics.bytes_read += length;
+          self->on_read(length);
+        });
+    }
+
+    void on_read(usize const length)
+    {
+      object_ref messages{ jank_nil() };
+      try
+      {
+        messages = dynamic_call(current_server->feed->deref(),
+                                decoder,
+                                make_box(jtl::immutable_string_view{ buffer.get(), length }));
+      }
+      catch(std::exception const &e)
+      {
+        /* Once the stream is broken, we can't tell where the next message starts. */
+        util::println(stderr, "nREPL connection closed: {}", e.what());
+        close();
+        return;
+      }
+
+      for(auto const message : make_sequence_range(messages))
+      {
+        dispatch(message);
+      }
+
+      {
+        std::lock_guard<std::mutex> const lock{ mutex };
+        if(is_backed_up())
+        {
+          read_paused = true;
+          return;
+        }
+      }
+      do_read();
     }
 
-    void do_write(std::size_t length)
+    void dispatch(object_ref const message)
     {
-      auto self(shared_from_this());
-      boost::asio::async_write(socket_,
-                               boost::asio::buffer(data_, length),
-                               [this, self](boost::system::error_code ec, std::size_t /*length*/) {
-                                 if(!ec)
-                                 {
-                                   do_read();
-                                 }
-                               });
+      auto const session_id(optional_string(get(message, make_box("session"))));
+      auto const queue(session_id.empty() ? default_session : find_session(session_id));
+      {
+        std::lock_guard<std::mutex> const lock{ mutex };
+        ++queued_messages;
+      }
+      ++metrics.queued_evals;
+      queue->submit({ shared_from_this(), message });
     }
 
-    static constexpr size_t max_length = 1024;
+    /* Runs on the solo executor. */
+    void handle(object_ref const message)
+    {
+      --metrics.queued_evals;
+      ++metrics.running_evals;
+
+      /* The send function may be held on to after the message is handled, so it keeps its
+       * own copies of what it needs and doesn't keep the connection around. */
+      auto const id(optional_string(get(message, make_box("id"))));
+      auto const session(optional_string(get(message, make_box("session"))));
+      std::weak_ptr<connection> const weak{ shared_from_this() };
+      auto const send_fn(make_box<obj::native_function_wrapper>(
+        std::function<object_ref(object_ref const)>{ [weak, id, session](object_ref const r) {
+          if(auto const self = weak.lock())
+          {
+            self->send(r, id, session);
+          }
+          return jank_nil();
+        } }));
+
+      bool failed{ true };
+      jtl::immutable_string failure;
+      try
+      {
+        dynamic_call(current_server->handler, message, send_fn);
+        failed = false;
+      }
+      catch(std::exception const &e)
+      {
+        failure = e.what();
+      }
+      catch(object_ref const e)
+      {
+        failure = runtime::to_code_string(e);
+      }
+      catch(...)
+      {
+        failure = "unknown error";
+      }
 
-    tcp::socket socket_;
-    char data_[max_length]{};
+      --metrics.running_evals;
+      if(failed)
+      {
+        ++metrics.failed_evals;
+        send(obj::persistent_hash_map::create_unique(
+               std::make_pair(make_box("err"), make_box(failure)),
+               std::make_pair(make_box("status"),
+                              make_box<obj::persistent_vector>(std::in_place,
+                                                               make_box("eval-error"),
+                                                               make_box("done")))),
+             id,
+             session);
+      }
+      else
+      {
+        ++metrics.completed_evals;
+      }
+
+      if(!session.empty() && equal(get(message, make_box("op")), make_box("close")))
+      {
+        remove_session(session);
+      }
+
+      {
+        std::lock_guard<std::mutex> const lock{ mutex };
+        --queued_messages;
+      }
+      resume_reading();
+    }
+
+    static std::string optional_string(object_ref const o)
+    {
+      if(o->type != object_type::persistent_string)
+      {
+        return {};
+      }
+      auto const s(to_string(o));
+      return { s.data(), s.size() };
+    }
+
+    /* Encodes the response, with the id and session of its request, and queues it up to
+     * be written. This can be called from any thread. */
+    void send(object_ref response, std::string const &id, std::string const &session)
+    {
+      for(auto const &field : { std::make_pair("id", &id), std::make_pair("session", &session) })
+      {
+        auto const key(make_box(field.first));
+        if(!field.second->empty() && !contains(response, key))
+        {
+          response = assoc(response, key, make_box(field.second->c_str()));
+        }
+      }
+      auto const encoded(to_string(dynamic_call(current_server->encode->deref(), response)));
+
+      bool start_write{};
+      {
+        std::unique_lock<std::mutex> lock{ mutex };
+        output_drained.wait(lock, [&] { return closed || output.size() < max_pending_output; });
+        if(closed)
+        {
+          return;
+        }
+        output.append(encoded.data(), encoded.size());
+        start_write = !write_in_flight;
+        write_in_flight = true;
+      }
+
+      if(start_write)
+      {
+        boost::asio::post(socket.get_executor(),
+                          [self = shared_from_this()] { self->write_pending(); });
+      }
+    }
+
+    void write_pending()
+    {
+      {
+        std::lock_guard<std::mutex> const lock{ mutex };
+        writing.clear();
+        std::swap(writing, output);
+      }
+      output_drained.notify_all();
+
+      boost::asio::async_write(
+        socket,
+        boost::asio::buffer(writing),
+        [self = shared_from_this()](boost::system::error_code const ec, usize const length) {
+          if(ec)
+          {
+            self->close();
+            return;
+          }
+          metrics.bytes_written += length;
+
+          bool more{};
+          {
+            std::lock_guard<std::mutex> const lock{ self->mutex };
+            more = !self->output.empty();
+            self->write_in_flight = more;
+          }
+          if(more)
+          {
+            self->write_pending();
+          }
+          else
+          {
+            self->resume_reading();
+          }
+        });
+    }
+
+    /* Picks reading back up, if it was paused and we've caught up. This can be called
+     * from any thread. */
+    void resume_reading()
+    {
+      boost::asio::post(socket.get_executor(), [self = shared_from_this()] {
+        {
+          std::lock_guard<std::mutex> const lock{ self->mutex };
+          if(!self->read_paused || self->closed || self->is_backed_up())
+          {
+            return;
+          }
+          self->read_paused = false;
+        }
+        self->do_read();
+      });
+    }
+
+    /* The mutex must be held. */
+    bool is_backed_up() const
+    {
+      return queued_messages >= max_queued_messages || output.size() >= max_pending_output;
+    }
+
+    void close()
+    {
+      {
+        std::lock_guard<std::mutex> const lock{ mutex };
+        if(closed)
+        {
+          return;
+        }
+        closed = true;
+        output.clear();
+      }
+      output_drained.notify_all();
+
+      boost::system::error_code ec;
+      socket.close(ec);
+      --metrics.open_connections;
+    }
+
+    tcp::socket socket;
+    /* This isn't within the connection, since the GC would otherwise scan it. */
+    std::unique_ptr<char[]> buffer;
+    object_ref decoder;
+    /* Messages without a session are evaluated in order with each other. */
+    std::shared_ptr<session_queue> default_session;
+
+    std::mutex mutex;
+    std::condition_variable output_drained;
+    native_transient_string output;
+    /* Only touched on the strand. */
+    native_transient_string writing;
+    bool write_in_flight{};
+    bool read_paused{};
+    bool closed{};
+    usize queued_messages{};
   };
 
-  boost::asio::io_context io_context;
-  std::unique_ptr<tcp::acceptor> acceptor;
-  std::unique_ptr<tcp::socket> socket;
+  void session_queue::submit(pending_message &&m)
+  {
+    {
+      std::lock_guard<std::mutex> const lock{ mutex };
+      messages.emplace_back(std::move(m));
+      if(running)
+      {
+        return;
+      }
+      running = true;
+    }
+    solo_executor().submit([self = shared_from_this()] { self->drain(); });
+  }
 
-  void accept_connection()
+  void session_queue::drain()
   {
-    std::cout << "waiting for a new connection...\n";
-    acceptor->async_accept(*socket, [](boost::system::error_code const ec) {
-      if(!ec)
+    while(true)
+    {
+      std::unique_lock<std::mutex> lock{ mutex };
+      if(messages.empty())
       {
-        std::cout << "new connection accepted\n";
-        std::make_shared<connection>(std::move(*socket));
+        running = false;
+        return;
       }
+      auto const m(std::move(messages.front()));
+      messages.pop_front();
+      lock.unlock();
 
-      accept_connection();
-    });
+      m.conn->handle(m.message);
+    }
   }
 
-  object_ptr run_server(object_ptr const port, object_ptr const callback)
+  static void accept_connection()
   {
-    auto const p(to_int(port));
-    acceptor = std::make_unique<tcp::acceptor>(io_context, tcp::endpoint(tcp::v4(), p));
-    socket = std::make_unique<tcp::socket>(io_context);
+    auto &acceptor(*current_server->acceptor);
+    acceptor.async_accept(boost::asio::make_strand(current_server->io_context),
+                          [](boost::system::error_code const ec, tcp::socket socket) {
+                            if(!ec)
+                            {
+                              make_traced<connection>(std::move(socket))->start();
+                            }
+                            accept_connection();
+                          });
+  }
 
+  /* Serves on the port until the process ends. Each message, as a map, is passed to the
+   * handler along with a function to send a response map for it, which can be called any
+   * number of times. The id and session of the message are added to each response. */
+  object_ref run_server(object_ref const port, object_ref const handler)
+  {
+    auto const p(static_cast<u16>(to_int(port)));
+    current_server = make_traced<server>(handler);
+    current_server->acceptor
+      = std::make_unique<tcp::acceptor>(current_server->io_context, tcp::endpoint(tcp::v4(), p));
     accept_connection();
 
-    /* This blocks. */
-    io_context.run();
-    return obj::nil::nil_const();
-  }
+    /* This needs to happen on a thread the GC already knows about, before any other
+     * threads try to register themselves. */
+    GC_allow_register_threads();
 
-  /* TODO: Make base class for ns which does this_object_ptr */
-  struct __ns : behavior::callable
-  {
-    /* TODO: Remove const from all of these. */
-    object_ptr call() const override
+    auto const thread_count(std::max(std::thread::hardware_concurrency(), 2u));
+    std::vector<std::thread> threads;
+    threads.reserve(thread_count - 1);
+    for(usize i{ 1 }; i < thread_count; ++i)
     {
-      auto const ns(__rt_ctx->intern_ns("jank.nrepl-server.asio"));
-      ns->intern_var("run!")->bind_root(make_box<obj::native_function_wrapper>(&run_server));
-      return obj::nil::nil_const();
+      threads.emplace_back([] {
+        gc_thread_scope const gc_scope;
+        current_server->io_context.run();
+      });
     }
 
-    object_ptr this_object_ptr() const override
+    util::println("nREPL server listening on port {}", p);
+
+    /* This blocks. */
+    current_server->io_context.run();
+    for(auto &t : threads)
     {
-      return obj::nil::nil_const();
+      t.join();
     }
-  };
+    return jank_nil();
+  }
+
+  object_ref server_metrics_map()
+  {
+    auto const entry([](char const * const name, std::atomic<u64> const &value) {
+      return std::make_pair(__rt_ctx->intern_keyword(name).expect_ok(),
+                            make_box(static_cast<i64>(value.load())));
+    });
+
+    return obj::persistent_hash_map::create_unique(
+      entry("open-connections", metrics.open_connections),
+      entry("total-connections", metrics.total_connections),
+      entry("queued-evals", metrics.queued_evals),
+      entry("running-evals", metrics.running_evals),
+      entry("completed-evals", metrics.completed_evals),
+      entry("failed-evals", metrics.failed_evals),
+      entry("bytes-read", metrics.bytes_read),
+      entry("bytes-written", metrics.bytes_written));
+  }
+}
+
+extern "C" void jank_load_jank_nrepl_server_asio()
+{
+  using namespace jank;
+  using namespace jank::runtime;
+  using namespace jank::nrepl_server::asio;
+
+  auto const ns_name{ "jank.nrepl-server.asio" };
+  auto const ns(__rt_ctx->intern_ns(ns_name));
+
+  auto const intern_fn([=](jtl::immutable_string const &name, auto const fn) {
+    ns->intern_var(name)->bind_root(
+      make_box<obj::native_function_wrapper>(convert_function(fn))
+        ->with_meta(obj::persistent_hash_map::create_unique(std::make_pair(
+          __rt_ctx->intern_keyword("name").expect_ok(),
+          make_box(obj::symbol{ ns_name, name }.to_string())))));
+  });
+
+  intern_fn("run!", &run_server);
+  intern_fn("metrics", &server_metrics_map);
+
+  __rt_ctx->module_loader.set_is_loaded(ns_name);
 }
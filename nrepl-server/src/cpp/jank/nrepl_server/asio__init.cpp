@@ -1,9 +0,0 @@
-namespace jank::nrepl_server::asio
-{
-  struct __ns__init
-  {
-    static void __init()
-    {
-    }
-  };
-}